@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+
+#include "alternator/change_buffer.hh"
+#include "schema.hh"
+
+namespace alternator {
+
+// Compares as the timeuuid clustering key of the CDC log does.
+static std::strong_ordering compare_timeuuids(const utils::UUID& a, const utils::UUID& b) {
+    std::array<int8_t, 16> ba, bb;
+    auto ia = ba.data();
+    auto ib = bb.data();
+    a.serialize(ia);
+    b.serialize(ib);
+    return utils::timeuuid_tri_compare(bytes_view(ba.data(), ba.size()), bytes_view(bb.data(), bb.size()));
+}
+
+bool stream_position::contains(const utils::UUID& ts) const {
+    auto c = compare_timeuuids(threshold, ts);
+    return c < 0 || (c == 0 && inclusive);
+}
+
+std::strong_ordering stream_position::operator<=>(const stream_position& o) const {
+    auto c = compare_timeuuids(threshold, o.threshold);
+    if (c != 0) {
+        return c;
+    }
+    // At or after a timestamp comes before just after it.
+    return o.inclusive <=> inclusive;
+}
+
+void change_buffer::drop(std::map<key_type, entry>::iterator it) {
+    _records -= it->second.records.size();
+    _streams.erase(it);
+}
+
+std::map<change_buffer::key_type, change_buffer::entry>::iterator
+change_buffer::find(const schema& log_schema, const schema& base_schema, const cdc::stream_id& stream) {
+    auto it = _streams.find(key_type(log_schema.id(), stream));
+    if (it != _streams.end() && (it->second.log_version != log_schema.version() || it->second.base_version != base_schema.version())) {
+        // The records are described with the columns of the old schemas.
+        drop(it);
+        return _streams.end();
+    }
+    return it;
+}
+
+std::optional<change_buffer::lookup_result> change_buffer::get(const schema& log_schema, const schema& base_schema,
+        const cdc::stream_id& stream, const stream_position& pos, size_t limit) {
+    auto it = find(log_schema, base_schema, stream);
+    if (it == _streams.end()) {
+        return std::nullopt;
+    }
+    auto& e = it->second;
+    if (pos < e.begin || e.end < pos) {
+        return std::nullopt;
+    }
+    e.lru_link.unlink();
+    _lru.push_front(e);
+
+    lookup_result ret{{}, e.end};
+    auto i = std::partition_point(e.records.begin(), e.records.end(), [&] (const record& r) {
+        return !pos.contains(r.timestamp);
+    });
+    for (; i != e.records.end() && ret.records.size() < limit; ++i) {
+        ret.records.push_back(record{i->timestamp, rjson::copy(i->value)});
+    }
+    if (i != e.records.end()) {
+        ret.end = stream_position{ret.records.back().timestamp, false};
+    }
+    return ret;
+}
+
+void change_buffer::put(const schema& log_schema, const schema& base_schema, const cdc::stream_id& stream,
+        const stream_position& from, std::vector<record> records, const stream_position& end, bool caught_up,
+        size_t max_records) {
+    auto it = find(log_schema, base_schema, stream);
+    if (it == _streams.end() || it->second.end != from) {
+        if (!caught_up) {
+            return;
+        }
+        if (it != _streams.end()) {
+            drop(it);
+        }
+        auto key = key_type(log_schema.id(), stream);
+        it = _streams.emplace(key, entry{key, log_schema.version(), base_schema.version(), from, from, {}, {}}).first;
+    }
+    auto& e = it->second;
+    for (auto& r : records) {
+        e.records.push_back(std::move(r));
+    }
+    _records += records.size();
+    e.end = end;
+    while (e.records.size() > max_records_per_stream) {
+        e.begin = stream_position{e.records.front().timestamp, false};
+        e.records.pop_front();
+        --_records;
+    }
+    e.lru_link.unlink();
+    _lru.push_front(e);
+
+    while (_records > max_records && !_lru.empty()) {
+        drop(_streams.find(_lru.back().key));
+    }
+}
+
+void change_buffer::clear() noexcept {
+    _streams.clear();
+    _records = 0;
+}
+
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <compare>
+#include <deque>
+#include <map>
+#include <optional>
+#include <vector>
+#include <boost/intrusive/list.hpp>
+
+#include "cdc/generation.hh"
+#include "schema_fwd.hh"
+#include "utils/UUID.hh"
+#include "utils/rjson.hh"
+
+namespace alternator {
+
+// Where a stream shard is read from: the records with a timestamp after
+// threshold, or also at it if inclusive, like a shard iterator.
+struct stream_position {
+    utils::UUID threshold;
+    bool inclusive;
+
+    // Whether the record of timestamp ts is at or after the position.
+    bool contains(const utils::UUID& ts) const;
+
+    std::strong_ordering operator<=>(const stream_position& o) const;
+    bool operator==(const stream_position& o) const {
+        return (*this <=> o) == 0;
+    }
+};
+
+/// \brief The recent records of Alternator Streams, kept in memory by the
+/// shard owning the CDC log partition of their stream shard.
+///
+/// GetRecords only returns records older than the confidence window, which
+/// don't change anymore, so the records it read from the log table once can
+/// be served again from memory. Once a reader of a stream shard has caught up
+/// with the confidence window, the buffer keeps the records of the interval
+/// it read, up to max_records_per_stream of the latest of them, and extends
+/// it with what the following reads find in the table. Consumers tailing the
+/// stream then get what they missed from memory, and only read the log table
+/// from where the buffer ends, a range which is usually empty.
+///
+/// At most max_records records are kept on each shard; the stream shards
+/// read least recently are dropped first.
+class change_buffer {
+public:
+    struct record {
+        utils::UUID timestamp;
+        rjson::value value;
+    };
+
+    static constexpr size_t max_records_per_stream = 1000;
+
+    struct lookup_result {
+        // Copies of the records, in the order of the stream.
+        std::vector<record> records;
+        // Where the records which follow have to be read from.
+        stream_position end;
+    };
+private:
+    using key_type = std::pair<utils::UUID, cdc::stream_id>;
+    using lru_link_type = boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+
+    struct entry {
+        key_type key;
+        utils::UUID log_version;
+        utils::UUID base_version;
+        // The buffer has all the records in [begin, end).
+        stream_position begin;
+        stream_position end;
+        std::deque<record> records;
+        lru_link_type lru_link;
+    };
+
+    std::map<key_type, entry> _streams;
+    // Most recently used first.
+    boost::intrusive::list<entry,
+        boost::intrusive::member_hook<entry, lru_link_type, &entry::lru_link>,
+        boost::intrusive::constant_time_size<false>> _lru;
+    size_t _records = 0;
+
+    void drop(std::map<key_type, entry>::iterator it);
+    std::map<key_type, entry>::iterator find(const schema& log_schema, const schema& base_schema, const cdc::stream_id& stream);
+public:
+    /// Returns the records of the stream from pos on, at most limit of them,
+    /// or std::nullopt if pos isn't within what the buffer has of the stream.
+    std::optional<lookup_result> get(const schema& log_schema, const schema& base_schema, const cdc::stream_id& stream,
+            const stream_position& pos, size_t limit);
+
+    /// Adds the records of the stream read from the log table, all those in
+    /// [from, end). They're appended to what the buffer has of the stream if
+    /// it ends at from. Otherwise, they replace it, but only if the read caught
+    /// up with the confidence window.
+    void put(const schema& log_schema, const schema& base_schema, const cdc::stream_id& stream,
+            const stream_position& from, std::vector<record> records, const stream_position& end, bool caught_up,
+            size_t max_records);
+
+    void clear() noexcept;
+
+    size_t size() const noexcept {
+        return _records;
+    }
+};
+
+}
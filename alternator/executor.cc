@@ -69,6 +69,31 @@ static const column_definition& attrs_column(const schema& schema) {
     return *cdef;
 }
 
+static bytes promoted_column_name(std::string_view attr_name) {
+    return to_bytes(std::string(executor::PROMOTED_ATTRIBUTE_PREFIX).append(attr_name));
+}
+
+const column_definition* executor::promoted_attribute_column(const schema& schema, std::string_view attr_name) {
+    // Avoid building the column name for the usual tables, whose only
+    // regular column is the attribute map.
+    if (schema.regular_columns_count() <= 1) {
+        return nullptr;
+    }
+    const column_definition* cdef = schema.get_column_definition(promoted_column_name(attr_name));
+    return cdef && cdef->is_regular() ? cdef : nullptr;
+}
+
+std::optional<std::string_view> executor::promoted_attribute_name(const column_definition& cdef) {
+    if (!cdef.is_regular()) {
+        return std::nullopt;
+    }
+    std::string_view name = to_sstring_view(cdef.name());
+    if (!name.starts_with(PROMOTED_ATTRIBUTE_PREFIX)) {
+        return std::nullopt;
+    }
+    return name.substr(PROMOTED_ATTRIBUTE_PREFIX.size());
+}
+
 make_jsonable::make_jsonable(rjson::value&& value)
     : _value(std::move(value))
 {}
@@ -671,6 +696,7 @@ static const std::unordered_set<std::string_view> allowed_write_isolation_values
     "a", "always", "always_use_lwt",
     "o", "only_rmw_uses_lwt",
     "u", "unsafe", "unsafe_rmw",
+    "l", "local", "local_rmw",
 };
 
 static void validate_tags(const std::map<sstring, sstring>& tags) {
@@ -695,6 +721,8 @@ static rmw_operation::write_isolation parse_write_isolation(std::string_view val
             return rmw_operation::write_isolation::LWT_RMW_ONLY;
         case 'u':
             return rmw_operation::write_isolation::UNSAFE_RMW;
+        case 'l':
+            return rmw_operation::write_isolation::LOCAL_RMW;
         }
     }
     // Shouldn't happen as validate_tags() / set_default_write_isolation()
@@ -721,6 +749,41 @@ void rmw_operation::set_default_write_isolation(std::string_view value) {
     default_write_isolation = parse_write_isolation(value);
 }
 
+// The attributes promoted to columns of their own are chosen when the table
+// is created. Changing them later would leave the existing items with the
+// attributes in the wrong place, so tagging can't touch this tag.
+static void verify_promoted_attributes_unchanged(const std::map<sstring, sstring>& old_tags, const std::map<sstring, sstring>& new_tags) {
+    auto old_it = old_tags.find(executor::PROMOTED_ATTRIBUTES_TAG_KEY);
+    auto new_it = new_tags.find(executor::PROMOTED_ATTRIBUTES_TAG_KEY);
+    bool old_exists = old_it != old_tags.end();
+    bool new_exists = new_it != new_tags.end();
+    if (old_exists != new_exists || (old_exists && old_it->second != new_it->second)) {
+        throw api_error::validation(format("Tag {} can only be set when creating the table", executor::PROMOTED_ATTRIBUTES_TAG_KEY));
+    }
+}
+
+// Adds a column of its own for each attribute named (space-separated) in the
+// PROMOTED_ATTRIBUTES_TAG_KEY tag. Attributes which already have a column -
+// the table's and its indexes' key attributes - can't be promoted.
+static void add_promoted_attribute_columns(schema_builder& builder, std::string_view names) {
+    while (!names.empty()) {
+        auto end = names.find(' ');
+        std::string_view name = names.substr(0, end);
+        names.remove_prefix(end == std::string_view::npos ? names.size() : end + 1);
+        if (name.empty()) {
+            continue;
+        }
+        if (builder.has_column(cql3::column_identifier(sstring(name), true))) {
+            throw api_error::validation(format("Attribute {} in tag {} already has a column of its own",
+                    name, executor::PROMOTED_ATTRIBUTES_TAG_KEY));
+        }
+        bytes column_name = promoted_column_name(name);
+        if (!builder.has_column(cql3::column_identifier(column_name, bytes_type))) {
+            builder.with_column(std::move(column_name), bytes_type, column_kind::regular_column);
+        }
+    }
+}
+
 enum class update_tags_action { add_tags, delete_tags };
 static void update_tags_map(const rjson::value& tags, std::map<sstring, sstring>& tags_map, update_tags_action action) {
     if (action == update_tags_action::add_tags) {
@@ -784,6 +847,7 @@ future<executor::request_return_type> executor::tag_resource(client_state& clien
         co_return api_error::validation("The number of tags must be at least 1") ;
     }
     update_tags_map(*tags, tags_map,  update_tags_action::add_tags);
+    verify_promoted_attributes_unchanged(get_tags_of_table(schema), tags_map);
     co_await update_tags(_mm, schema, std::move(tags_map));
     co_return json_string("");
 }
@@ -804,6 +868,7 @@ future<executor::request_return_type> executor::untag_resource(client_state& cli
 
     std::map<sstring, sstring> tags_map = get_tags_of_table(schema);
     update_tags_map(*tags, tags_map, update_tags_action::delete_tags);
+    verify_promoted_attributes_unchanged(get_tags_of_table(schema), tags_map);
     co_await update_tags(_mm, schema, std::move(tags_map));
     co_return json_string("");
 }
@@ -1024,6 +1089,15 @@ static future<executor::request_return_type> create_table_on_shard0(tracing::tra
     if (tags && tags->IsArray()) {
         update_tags_map(*tags, tags_map, update_tags_action::add_tags);
     }
+    auto promoted_attributes = tags_map.find(executor::PROMOTED_ATTRIBUTES_TAG_KEY);
+    if (promoted_attributes != tags_map.end()) {
+        // Nodes which don't know about promoted attributes would neither
+        // write them to their columns nor read them back from there.
+        if (!sp.features().cluster_supports_alternator_promoted_attributes()) {
+            co_return api_error::validation(format("Tag {} is not supported until all nodes are upgraded", executor::PROMOTED_ATTRIBUTES_TAG_KEY));
+        }
+        add_promoted_attribute_columns(builder, promoted_attributes->second);
+    }
     builder.add_extension(tags_extension::NAME, ::make_shared<tags_extension>(tags_map));
 
     schema_ptr schema = builder.build();
@@ -1278,7 +1352,11 @@ put_or_delete_item::put_or_delete_item(const rjson::value& item, schema_ptr sche
         validate_value(it->value, "PutItem");
         const column_definition* cdef = schema->get_column_definition(column_name);
         if (!cdef) {
-            bytes value = serialize_item(it->value);
+            // A promoted attribute keeps the serialized value the attribute
+            // map would have, in its own column. build() puts it there.
+            if (const column_definition* promoted = executor::promoted_attribute_column(*schema, it->name.GetString())) {
+                column_name = promoted->name();
+            }
             _cells->push_back({std::move(column_name), serialize_item(it->value)});
         } else if (!cdef->is_primary_key()) {
             // Fixed-type regular column can be used for GSI key
@@ -1443,8 +1521,9 @@ rmw_operation::write_isolation rmw_operation::get_write_isolation_for_schema(sch
 
 // shard_for_execute() checks whether execute() must be called on a specific
 // other shard. Running execute() on a specific shard is necessary only if it
-// will use LWT (storage_proxy::cas()). This is because cas() can only be
-// called on the specific shard owning (as per cas_shard()) _pk's token.
+// will use LWT (storage_proxy::cas()), or the local item lock of LOCAL_RMW.
+// This is because cas() can only be called on the specific shard owning (as
+// per cas_shard()) _pk's token, and the lock is held on the same shard.
 // Knowing if execute() will call cas() or not may depend on whether there is
 // a read-before-write, but not just on it - depending on configuration,
 // execute() may unconditionally use cas() for every write. Unfortunately,
@@ -1501,12 +1580,54 @@ static future<std::unique_ptr<rjson::value>> get_previous_item(
     });
 }
 
+// The locks of the items written in the LOCAL_RMW write isolation mode, held
+// on the shard owning the item (see shard_for_execute()). Items are locked by
+// their token, two items rarely share one, and then they just wait for each other.
+class item_lock_map {
+    using semaphore = basic_semaphore<semaphore_default_exception_factory, db::timeout_clock>;
+    std::unordered_map<dht::token, semaphore> _locks;
+public:
+    template <typename Func>
+    futurize_t<std::invoke_result_t<Func>> with_locked_item(const dht::token& token, db::timeout_clock::time_point timeout, Func func) {
+        auto& sem = _locks.try_emplace(token, 1).first->second;
+        return with_semaphore(sem, 1, timeout - db::timeout_clock::now(), std::move(func)).finally([this, token] {
+            auto it = _locks.find(token);
+            if (it != _locks.end() && it->second.waiters() == 0 && it->second.available_units() == 1) {
+                _locks.erase(it);
+            }
+        });
+    }
+};
+
+static thread_local item_lock_map local_rmw_locks;
+
 future<executor::request_return_type> rmw_operation::execute(service::storage_proxy& proxy,
         service::client_state& client_state,
         tracing::trace_state_ptr trace_state,
         service_permit permit,
         bool needs_read_before_write,
         stats& stats) {
+    if (_write_isolation == write_isolation::LOCAL_RMW) {
+        // Like UNSAFE_RMW, but writes of the item coordinated by this node,
+        // with or without a read, are serialized.
+        stats.write_using_local_lock++;
+        auto token = dht::get_token(*schema(), _pk);
+        return local_rmw_locks.with_locked_item(token, executor::default_timeout(),
+                [this, &proxy, &client_state, &stats, trace_state, permit = std::move(permit), needs_read_before_write] () mutable {
+            auto previous_item = needs_read_before_write
+                    ? get_previous_item(proxy, client_state, schema(), _pk, _ck, permit, stats)
+                    : make_ready_future<std::unique_ptr<rjson::value>>();
+            return previous_item.then([this, &proxy, trace_state, permit = std::move(permit)] (std::unique_ptr<rjson::value> previous_item) mutable {
+                std::optional<mutation> m = apply(std::move(previous_item), api::new_timestamp());
+                if (!m) {
+                    return make_ready_future<executor::request_return_type>(api_error::conditional_check_failed("Failed condition."));
+                }
+                return proxy.mutate(std::vector<mutation>{std::move(*m)}, db::consistency_level::LOCAL_QUORUM, executor::default_timeout(), trace_state, std::move(permit)).then([this] () mutable {
+                    return rmw_operation_return(std::move(_return_attributes));
+                });
+            });
+        });
+    }
     if (needs_read_before_write) {
         if (_write_isolation == write_isolation::FORBID_RMW) {
             throw api_error::validation("Read-modify-write operations are disabled by 'forbid_rmw' write isolation policy. Refer to https://github.com/scylladb/scylla/blob/master/docs/alternator/alternator.md#write-isolation-policies for more information.");
@@ -1864,11 +1985,21 @@ static future<> do_batch_write(service::storage_proxy& proxy,
     });
     if (!needs_lwt) {
         // Do a normal write, without LWT:
+        // Items of the same partition are joined into one mutation, so the
+        // partition is written once rather than once per item.
         std::vector<mutation> mutations;
         mutations.reserve(mutation_builders.size());
+        std::unordered_map<schema_decorated_key, size_t, schema_decorated_key_hash, schema_decorated_key_equal>
+            key_mutations(1, schema_decorated_key_hash{}, schema_decorated_key_equal{});
         api::timestamp_type now = api::new_timestamp();
         for (auto& b : mutation_builders) {
-            mutations.push_back(b.second.build(b.first, now));
+            auto m = b.second.build(b.first, now);
+            auto [it, added] = key_mutations.try_emplace(schema_decorated_key{b.first, m.decorated_key()}, mutations.size());
+            if (added) {
+                mutations.push_back(std::move(m));
+            } else {
+                mutations[it->second].apply(std::move(m));
+            }
         }
         return proxy.mutate(std::move(mutations),
                 db::consistency_level::LOCAL_QUORUM,
@@ -2217,7 +2348,15 @@ void executor::describe_single_item(const cql3::selection::selection& selection,
     auto column_it = columns.begin();
     for (const bytes_opt& cell : result_row) {
         std::string column_name = (*column_it)->name_as_text();
-        if (cell && column_name != executor::ATTRS_COLUMN_NAME) {
+        if (auto attr_name = promoted_attribute_name(**column_it)) {
+            if (cell && (include_all_embedded_attributes || attrs_to_get.empty() || attrs_to_get.contains(std::string(*attr_name)))) {
+                rjson::value v = deserialize_item(*cell);
+                auto it = attrs_to_get.find(std::string(*attr_name));
+                if (it == attrs_to_get.end() || hierarchy_filter(v, it->second)) {
+                    rjson::add_with_string_name(item, *attr_name, std::move(v));
+                }
+            }
+        } else if (cell && column_name != executor::ATTRS_COLUMN_NAME) {
             if (attrs_to_get.empty() || attrs_to_get.contains(column_name)) {
                 // item is expected to start empty, and column_name are unique
                 // so add() makes sense
@@ -2275,6 +2414,24 @@ std::optional<rjson::value> executor::describe_single_item(schema_ptr schema,
     return item;
 }
 
+std::vector<rjson::value> executor::describe_multi_item(schema_ptr schema,
+        const query::partition_slice& slice,
+        const cql3::selection::selection& selection,
+        const query::result& query_result,
+        const attrs_to_get& attrs_to_get) {
+    cql3::selection::result_set_builder builder(selection, gc_clock::now(), cql_serialization_format::latest());
+    query::result_view::consume(query_result, slice, cql3::selection::result_set_builder::visitor(builder, *schema, selection));
+    auto result_set = builder.build();
+    std::vector<rjson::value> ret;
+    ret.reserve(result_set->rows().size());
+    for (auto& result_row : result_set->rows()) {
+        rjson::value item = rjson::empty_object();
+        describe_single_item(selection, result_row, attrs_to_get, item);
+        ret.push_back(std::move(item));
+    }
+    return ret;
+}
+
 static bool check_needs_read_before_write(const parsed::value& v) {
     return std::visit(overloaded_functor {
         [&] (const parsed::constant& c) -> bool {
@@ -2681,6 +2838,8 @@ update_item_operation::apply(std::unique_ptr<rjson::value> previous_item, api::t
         if (cdef) {
             bytes column_value = get_key_from_typed_value(json_value, *cdef);
             row.cells().apply(*cdef, atomic_cell::make_live(*cdef->type, ts, column_value));
+        } else if (const column_definition* promoted = executor::promoted_attribute_column(*_schema, to_sstring_view(column_name))) {
+            row.cells().apply(*promoted, atomic_cell::make_live(*promoted->type, ts, serialize_item(json_value)));
         } else {
             attrs_collector.put(std::move(column_name), serialize_item(json_value), ts);
         }
@@ -2700,6 +2859,9 @@ update_item_operation::apply(std::unique_ptr<rjson::value> previous_item, api::t
             }
         }
         const column_definition* cdef = _schema->get_column_definition(column_name);
+        if (!cdef) {
+            cdef = executor::promoted_attribute_column(*_schema, to_sstring_view(column_name));
+        }
         if (cdef) {
             row.cells().apply(*cdef, atomic_cell::make_dead(ts, gc_clock::now()));
         } else {
@@ -2961,6 +3123,50 @@ static rjson::value describe_item(schema_ptr schema,
     return item_descr;
 }
 
+// The regular columns to read to return attrs_to_get, and the selection of
+// them. That's normally the whole item, but when all the attributes asked for
+// are key attributes or attributes promoted to columns of their own, only
+// their columns are read - not the attribute map with all the others.
+static std::pair<query::column_id_vector, ::shared_ptr<cql3::selection::selection>>
+columns_to_read(const schema_ptr& schema, const attrs_to_get& attrs_to_get) {
+    if (!attrs_to_get.empty() && schema->regular_columns_count() > 1) {
+        std::vector<const column_definition*> regular;
+        bool all_in_columns = true;
+        for (const auto& [attr_name, node] : attrs_to_get) {
+            const column_definition* cdef = schema->get_column_definition(to_bytes(attr_name));
+            if (!cdef) {
+                cdef = executor::promoted_attribute_column(*schema, attr_name);
+            }
+            if (!cdef) {
+                all_in_columns = false;
+                break;
+            }
+            if (cdef->is_regular()) {
+                regular.push_back(cdef);
+            }
+        }
+        if (all_in_columns) {
+            std::sort(regular.begin(), regular.end(), [] (const column_definition* a, const column_definition* b) { return a->id < b->id; });
+            std::vector<const column_definition*> columns;
+            for (const column_definition& cdef : schema->partition_key_columns()) {
+                columns.push_back(&cdef);
+            }
+            for (const column_definition& cdef : schema->clustering_key_columns()) {
+                columns.push_back(&cdef);
+            }
+            query::column_id_vector regular_columns;
+            for (const column_definition* cdef : regular) {
+                columns.push_back(cdef);
+                regular_columns.push_back(cdef->id);
+            }
+            return {std::move(regular_columns), cql3::selection::selection::for_columns(schema, std::move(columns))};
+        }
+    }
+    auto regular_columns = boost::copy_range<query::column_id_vector>(
+            schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+    return {std::move(regular_columns), cql3::selection::selection::wildcard(schema)};
+}
+
 future<executor::request_return_type> executor::get_item(client_state& client_state, tracing::trace_state_ptr trace_state, service_permit permit, rjson::value request) {
     _stats.api_operations.get_item++;
     auto start_time = std::chrono::steady_clock::now();
@@ -2985,19 +3191,16 @@ future<executor::request_return_type> executor::get_item(client_state& client_st
     }
     check_key(query_key, schema);
 
-    //TODO(sarna): It would be better to fetch only some attributes of the map, not all
-    auto regular_columns = boost::copy_range<query::column_id_vector>(
-            schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+    std::unordered_set<std::string> used_attribute_names;
+    auto attrs_to_get = calculate_attrs_to_get(request, used_attribute_names);
+    verify_all_are_used(request, "ExpressionAttributeNames", used_attribute_names, "GetItem");
 
-    auto selection = cql3::selection::selection::wildcard(schema);
+    //TODO(sarna): It would be better to fetch only some attributes of the map, not all
+    auto [regular_columns, selection] = columns_to_read(schema, attrs_to_get);
 
     auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
     auto command = ::make_lw_shared<query::read_command>(schema->id(), schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice));
 
-    std::unordered_set<std::string> used_attribute_names;
-    auto attrs_to_get = calculate_attrs_to_get(request, used_attribute_names);
-    verify_all_are_used(request, "ExpressionAttributeNames", used_attribute_names, "GetItem");
-
     return _proxy.query(schema, std::move(command), std::move(partition_ranges), cl,
             service::storage_proxy::coordinator_query_options(executor::default_timeout(), std::move(permit), client_state, trace_state)).then(
             [this, schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = std::move(attrs_to_get), start_time = std::move(start_time)] (service::storage_proxy::coordinator_query_result qr) mutable {
@@ -3081,15 +3284,19 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
     // We need to validate all the parameters before starting any asynchronous
     // query, and fail the entire request on any parse error. So we parse all
     // the input into our own vector "requests".
+    // The keys of a table are grouped by partition, the items of a
+    // partition being read by a single query.
     struct table_requests {
         schema_ptr schema;
         db::consistency_level cl;
         ::shared_ptr<const alternator::attrs_to_get> attrs_to_get;
-        struct single_request {
+        struct partition_request {
             partition_key pk;
-            clustering_key ck;
+            std::vector<clustering_key> cks;
+            // The positions of the keys of the partition in the request's "Keys".
+            std::vector<rapidjson::SizeType> key_indexes;
         };
-        std::vector<single_request> requests;
+        std::vector<partition_request> requests;
     };
     std::vector<table_requests> requests;
 
@@ -3102,45 +3309,65 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
         rs.attrs_to_get = ::make_shared<const attrs_to_get>(calculate_attrs_to_get(it->value, used_attribute_names));
         verify_all_are_used(request, "ExpressionAttributeNames", used_attribute_names, "GetItem");
         auto& keys = (it->value)["Keys"];
-        for (const rjson::value& key : keys.GetArray()) {
-            rs.requests.push_back({pk_from_json(key, rs.schema), ck_from_json(key, rs.schema)});
+        std::unordered_map<partition_key, size_t, partition_key::hashing, partition_key::equality>
+            partition_requests(1, partition_key::hashing(*rs.schema), partition_key::equality(*rs.schema));
+        for (rapidjson::SizeType i = 0; i < keys.Size(); ++i) {
+            const rjson::value& key = keys[i];
+            auto pk = pk_from_json(key, rs.schema);
+            auto ck = ck_from_json(key, rs.schema);
             check_key(key, rs.schema);
+            auto [pit, added] = partition_requests.try_emplace(pk, rs.requests.size());
+            if (added) {
+                rs.requests.push_back({std::move(pk), {}, {}});
+            }
+            rs.requests[pit->second].cks.push_back(std::move(ck));
+            rs.requests[pit->second].key_indexes.push_back(i);
         }
         requests.emplace_back(std::move(rs));
     }
 
     // If got here, all "requests" are valid, so let's start them all
     // in parallel. The requests object are then immediately destroyed.
-    std::vector<future<std::tuple<std::string, std::optional<rjson::value>>>> response_futures;
-    for (const auto& rs : requests) {
-        for (const auto &r : rs.requests) {
+    // The position of the table in the request and of the keys in its "Keys",
+    // for each response.
+    using response_type = std::tuple<std::string, std::vector<rjson::value>>;
+    std::vector<future<response_type>> response_futures;
+    std::vector<std::pair<size_t, std::vector<rapidjson::SizeType>>> response_keys;
+    for (size_t table_index = 0; table_index < requests.size(); ++table_index) {
+        auto& rs = requests[table_index];
+        for (auto& r : rs.requests) {
             dht::partition_range_vector partition_ranges{dht::partition_range(dht::decorate_key(*rs.schema, std::move(r.pk)))};
             std::vector<query::clustering_range> bounds;
             if (rs.schema->clustering_key_size() == 0) {
                 bounds.push_back(query::clustering_range::make_open_ended_both_sides());
             } else {
-                bounds.push_back(query::clustering_range::make_singular(std::move(r.ck)));
+                // The ranges of a slice have to be sorted and not overlap.
+                auto ck_less = clustering_key::less_compare(*rs.schema);
+                auto ck_eq = clustering_key::equality(*rs.schema);
+                std::sort(r.cks.begin(), r.cks.end(), ck_less);
+                r.cks.erase(std::unique(r.cks.begin(), r.cks.end(), ck_eq), r.cks.end());
+                for (auto& ck : r.cks) {
+                    bounds.push_back(query::clustering_range::make_singular(std::move(ck)));
+                }
             }
-            auto regular_columns = boost::copy_range<query::column_id_vector>(
-                    rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
-            auto selection = cql3::selection::selection::wildcard(rs.schema);
+            auto [regular_columns, selection] = columns_to_read(rs.schema, *rs.attrs_to_get);
             auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
             auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice));
-            future<std::tuple<std::string, std::optional<rjson::value>>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
+            future<response_type> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
                     service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
                     [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
                 utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
-                std::optional<rjson::value> json = describe_single_item(schema, partition_slice, *selection, *qr.query_result, *attrs_to_get);
-                return make_ready_future<std::tuple<std::string, std::optional<rjson::value>>>(
-                        std::make_tuple(schema->cf_name(), std::move(json)));
+                std::vector<rjson::value> jsons = describe_multi_item(schema, partition_slice, *selection, *qr.query_result, *attrs_to_get);
+                return make_ready_future<response_type>(std::make_tuple(schema->cf_name(), std::move(jsons)));
             });
             response_futures.push_back(std::move(f));
+            response_keys.emplace_back(table_index, std::move(r.key_indexes));
         }
     }
 
     // Wait for all requests to complete, and then return the response.
     return when_all(response_futures.begin(), response_futures.end()).then(
-            [request_items = std::move(request_items)] (std::vector<future<std::tuple<std::string, std::optional<rjson::value>>>> responses) mutable {
+            [request_items = std::move(request_items), response_keys = std::move(response_keys)] (std::vector<future<response_type>> responses) mutable {
         rjson::value response = rjson::empty_object();
         rjson::add(response, "Responses", rjson::empty_object());
         rjson::add(response, "UnprocessedKeys", rjson::empty_object());
@@ -3148,16 +3375,14 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
         // from one of the operations will be returned.
         bool some_succeeded = false;
         std::exception_ptr eptr;
-        // These iterators are used to match keys from the requests with their corresponding responses.
-        // If any of the responses failed, the key iterator will be used to insert
-        // an entry into the UnprocessedKeys object, which will ultimately be returned
-        // to the user in case of partial success of BatchGetItem operation.
-        rjson::value::MemberIterator table_items_it = request_items.MemberBegin();
-        rjson::value::ValueIterator key_it = table_items_it->value["Keys"].Begin();
-
-        for (auto& fut : responses) {
+        // If any of the responses failed, its keys are inserted into the
+        // UnprocessedKeys object, which will ultimately be returned to the
+        // user in case of partial success of BatchGetItem operation.
+        for (size_t i = 0; i < responses.size(); ++i) {
+            auto& fut = responses[i];
             if (fut.failed()) {
                 eptr = fut.get_exception();
+                auto table_items_it = request_items.MemberBegin() + response_keys[i].first;
                 if (!response["UnprocessedKeys"].HasMember(table_items_it->name)) {
                     rjson::add_with_string_name(response["UnprocessedKeys"], rjson::to_string_view(table_items_it->name), rjson::empty_object());
                     rjson::value& unprocessed_item = response["UnprocessedKeys"][table_items_it->name];
@@ -3168,22 +3393,17 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
                     }
                     rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
                 }
-                rjson::push_back(response["UnprocessedKeys"][table_items_it->name]["Keys"], std::move(*key_it));
+                for (auto key_index : response_keys[i].second) {
+                    rjson::push_back(response["UnprocessedKeys"][table_items_it->name]["Keys"], std::move(table_items_it->value["Keys"][key_index]));
+                }
             } else {
                 auto t = fut.get();
                 some_succeeded = true;
                 if (!response["Responses"].HasMember(std::get<0>(t).c_str())) {
                     rjson::add_with_string_name(response["Responses"], std::get<0>(t), rjson::empty_array());
                 }
-                if (std::get<1>(t)) {
-                    rjson::push_back(response["Responses"][std::get<0>(t)], std::move(*std::get<1>(t)));
-                }
-            }
-            key_it++;
-            if (key_it == table_items_it->value["Keys"].End()) {
-                table_items_it++;
-                if (table_items_it != request_items.MemberEnd()) {
-                    key_it = table_items_it->value["Keys"].Begin();
+                for (auto& item : std::get<1>(t)) {
+                    rjson::push_back(response["Responses"][std::get<0>(t)], std::move(item));
                 }
             }
         }
@@ -3377,7 +3597,14 @@ class describe_items_visitor {
         }
         result_bytes_view->with_linearized([this] (bytes_view bv) {
             std::string column_name = (*_column_it)->name_as_text();
-            if (column_name != executor::ATTRS_COLUMN_NAME) {
+            if (auto promoted_name = executor::promoted_attribute_name(**_column_it)) {
+                std::string attr_name(*promoted_name);
+                if (_attrs_to_get.empty() || _attrs_to_get.contains(attr_name) || _extra_filter_attrs.contains(attr_name)) {
+                    // As for the attribute map below, the whole attribute is
+                    // kept until after item filtering.
+                    rjson::add_with_string_name(_item, attr_name, deserialize_item(bv));
+                }
+            } else if (column_name != executor::ATTRS_COLUMN_NAME) {
                 if (_attrs_to_get.empty() || _attrs_to_get.contains(column_name) || _extra_filter_attrs.contains(column_name)) {
                     if (!_item.HasMember(column_name.c_str())) {
                         rjson::add_with_string_name(_item, column_name, rjson::empty_object());
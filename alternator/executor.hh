@@ -21,6 +21,7 @@
 
 #include "alternator/error.hh"
 #include "stats.hh"
+#include "alternator/change_buffer.hh"
 #include "utils/rjson.hh"
 
 namespace db {
@@ -156,6 +157,8 @@ class executor : public peering_sharded_service<executor> {
     // An smp_service_group to be used for limiting the concurrency when
     // forwarding Alternator request between shards - if necessary for LWT.
     smp_service_group _ssg;
+    // Recent stream records of the CDC log partitions this shard owns.
+    change_buffer _change_buffer;
 
 public:
     using client_state = service::client_state;
@@ -164,6 +167,12 @@ class executor : public peering_sharded_service<executor> {
     static constexpr auto ATTRS_COLUMN_NAME = ":attrs";
     static constexpr auto KEYSPACE_NAME_PREFIX = "alternator_";
     static constexpr std::string_view INTERNAL_TABLE_PREFIX = ".scylla.alternator.";
+    // The attributes named (space-separated) in this CreateTable tag are
+    // each stored in a column of its own, named PROMOTED_ATTRIBUTE_PREFIX
+    // followed by the attribute name, instead of in the ATTRS_COLUMN_NAME
+    // map. The column holds the same serialized value the map would.
+    static constexpr auto PROMOTED_ATTRIBUTES_TAG_KEY = "system:promoted_attributes";
+    static constexpr std::string_view PROMOTED_ATTRIBUTE_PREFIX = ":attr:";
 
     executor(gms::gossiper& gossiper, service::storage_proxy& proxy, service::migration_manager& mm, db::system_distributed_keyspace& sdks, cdc::metadata& cdc_metadata, smp_service_group ssg)
         : _gossiper(gossiper), _proxy(proxy), _mm(mm), _sdks(sdks), _cdc_metadata(cdc_metadata), _ssg(ssg) {}
@@ -218,12 +227,26 @@ class executor : public peering_sharded_service<executor> {
         const query::result&,
         const attrs_to_get&);
 
+    // Like describe_single_item(), for a result of several items: one per row.
+    static std::vector<rjson::value> describe_multi_item(schema_ptr schema,
+        const query::partition_slice& slice,
+        const cql3::selection::selection& selection,
+        const query::result& query_result,
+        const attrs_to_get& attrs_to_get);
+
     static void describe_single_item(const cql3::selection::selection&,
         const std::vector<bytes_opt>&,
         const attrs_to_get&,
         rjson::value&,
         bool = false);
 
+    // The column holding the given attribute if it was promoted to a column
+    // of its own (see PROMOTED_ATTRIBUTES_TAG_KEY), or nullptr.
+    static const column_definition* promoted_attribute_column(const schema& schema, std::string_view attr_name);
+    // The name of the attribute held by a promoted attribute column, or
+    // std::nullopt if the column isn't one.
+    static std::optional<std::string_view> promoted_attribute_name(const column_definition& cdef);
+
     static void add_stream_options(const rjson::value& stream_spec, schema_builder&, service::storage_proxy& sp);
     static void supplement_table_info(rjson::value& descr, const schema& schema, service::storage_proxy& sp);
     static void supplement_table_stream_info(rjson::value& descr, const schema& schema, service::storage_proxy& sp);
@@ -42,8 +42,13 @@ class rmw_operation : public service::cas_request, public enable_shared_from_thi
     // * The UNSAFE_RMW option does read-modify-write operations as separate
     //   read and write. It is unsafe - concurrent RMW operations are not
     //   isolated at all. This option will likely be removed in the future.
+    // * The LOCAL_RMW option does read-modify-write operations as separate
+    //   read and write, under a lock local to the coordinating node. Writes
+    //   of single items are isolated from each other only if they are all
+    //   coordinated by the same node, e.g., a single writer node, or the
+    //   only replica of the item.
     enum class write_isolation {
-        FORBID_RMW, LWT_ALWAYS, LWT_RMW_ONLY, UNSAFE_RMW
+        FORBID_RMW, LWT_ALWAYS, LWT_RMW_ONLY, UNSAFE_RMW, LOCAL_RMW
     };
     static constexpr auto WRITE_ISOLATION_TAG_KEY = "system:write_isolation";
 
@@ -82,6 +82,10 @@ stats::stats() : api_operations{} {
                     seastar::metrics::description("number of writes that used LWT")),
             seastar::metrics::make_total_operations("shard_bounce_for_lwt", shard_bounce_for_lwt,
                     seastar::metrics::description("number writes that had to be bounced from this shard because of LWT requirements")),
+            seastar::metrics::make_total_operations("get_records_from_buffer", get_records_from_buffer,
+                    seastar::metrics::description("number of GetRecords served from the in-memory buffer of recent stream records, without reading the CDC log")),
+            seastar::metrics::make_total_operations("write_using_local_lock", write_using_local_lock,
+                    seastar::metrics::description("number of writes that used the local item lock of the local_rmw write isolation policy")),
             seastar::metrics::make_total_operations("requests_blocked_memory", requests_blocked_memory,
                     seastar::metrics::description("Counts a number of requests blocked due to memory pressure.")),
             seastar::metrics::make_total_operations("requests_shed", requests_shed,
@@ -817,17 +817,59 @@ future<executor::request_return_type> executor::get_records(client_state& client
 
     db::consistency_level cl = db::consistency_level::LOCAL_QUORUM;
     partition_key pk = iter.shard.id.to_partition_key(*schema);
+    auto dk = dht::decorate_key(*schema, pk);
+
+    size_t buffer_records = db.get_config().alternator_streams_buffer_records();
+    if (!buffer_records) {
+        _change_buffer.clear();
+    } else if (auto shard = dht::shard_of(*schema, dk.token()); shard != this_shard_id()) {
+        // The records of a stream shard are buffered by the shard owning its
+        // partition, so that all its readers find them.
+        _stats.api_operations.get_records--; // uncount on this shard, will be counted in other shard
+        return container().invoke_on(shard, _ssg,
+                [request = std::move(request), cs = client_state.move_to_other_shard(), gt = tracing::global_trace_state_ptr(trace_state)]
+                (executor& e) mutable {
+            return do_with(cs.get(), [&e, request = std::move(request), trace_state = tracing::trace_state_ptr(gt)]
+                                     (service::client_state& client_state) mutable {
+                // See the FIXME in put_item() about the permit.
+                return e.get_records(client_state, std::move(trace_state), empty_service_permit(), std::move(request));
+            });
+        });
+    }
+
+    stream_position from{iter.threshold, iter.inclusive};
+    std::vector<change_buffer::record> buffered;
+    if (buffer_records) {
+        if (auto r = _change_buffer.get(*schema, *base, iter.shard.id, from, limit)) {
+            buffered = std::move(r->records);
+            from = r->end;
+        }
+    }
+    if (buffered.size() == limit) {
+        _stats.get_records_from_buffer++;
+        auto records = rjson::empty_array();
+        for (auto& r : buffered) {
+            rjson::push_back(records, std::move(r.value));
+        }
+        auto ret = rjson::empty_object();
+        rjson::add(ret, "Records", std::move(records));
+        shard_iterator next_iter(iter.table, iter.shard, buffered.back().timestamp, false);
+        rjson::add(ret, "NextShardIterator", next_iter);
+        _stats.api_operations.get_records_latency.add(std::chrono::steady_clock::now() - start_time);
+        return make_ready_future<executor::request_return_type>(make_jsonable(std::move(ret)));
+    }
+    limit -= buffered.size();
 
-    dht::partition_range_vector partition_ranges{ dht::partition_range::make_singular(dht::decorate_key(*schema, pk)) };
+    dht::partition_range_vector partition_ranges{ dht::partition_range::make_singular(std::move(dk)) };
 
     auto high_ts = db_clock::now() - confidence_interval(db);
     auto high_uuid = utils::UUID_gen::min_time_UUID(high_ts.time_since_epoch());
-    auto lo = clustering_key_prefix::from_exploded(*schema, { iter.threshold.serialize() });
+    auto lo = clustering_key_prefix::from_exploded(*schema, { from.threshold.serialize() });
     auto hi = clustering_key_prefix::from_exploded(*schema, { high_uuid.serialize() });
 
     std::vector<query::clustering_range> bounds;
     using bound = typename query::clustering_range::bound;
-    bounds.push_back(query::clustering_range::make(bound(lo, iter.inclusive), bound(hi, false)));
+    bounds.push_back(query::clustering_range::make(bound(lo, from.inclusive), bound(hi, false)));
 
     static const bytes timestamp_column_name = cdc::log_meta_column_name_bytes("time");
     static const bytes op_column_name = cdc::log_meta_column_name_bytes("operation");
@@ -876,16 +918,24 @@ future<executor::request_return_type> executor::get_records(client_state& client
     if (opts.postimage()) {
         ++mul;
     }
+    uint64_t row_limit = limit * mul;
     auto command = ::make_lw_shared<query::read_command>(schema->id(), schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
-            query::row_limit(limit * mul));
+            query::row_limit(row_limit));
 
     return _proxy.query(schema, std::move(command), std::move(partition_ranges), cl, service::storage_proxy::coordinator_query_options(default_timeout(), std::move(permit), client_state)).then(
-            [this, schema, partition_slice = std::move(partition_slice), selection = std::move(selection), start_time = std::move(start_time), limit, key_names = std::move(key_names), attr_names = std::move(attr_names), type, iter, high_ts] (service::storage_proxy::coordinator_query_result qr) mutable {       
+            [this, schema, base, partition_slice = std::move(partition_slice), selection = std::move(selection), start_time = std::move(start_time), limit, row_limit, key_names = std::move(key_names), attr_names = std::move(attr_names), type, iter, high_ts, high_uuid, from, buffered = std::move(buffered), buffer_records] (service::storage_proxy::coordinator_query_result qr) mutable {       
         cql3::selection::result_set_builder builder(*selection, gc_clock::now(), cql_serialization_format::latest());
         query::result_view::consume(*qr.query_result, partition_slice, cql3::selection::result_set_builder::visitor(builder, *schema, *selection));
 
         auto result_set = builder.build();
         auto records = rjson::empty_array();
+        std::optional<utils::UUID> last_timestamp;
+        for (auto& r : buffered) {
+            last_timestamp = r.timestamp;
+            rjson::push_back(records, std::move(r.value));
+        }
+        // The records read from the table, for the buffer.
+        std::vector<change_buffer::record> new_records;
 
         auto& metadata = result_set->get_metadata();
 
@@ -911,7 +961,7 @@ future<executor::request_return_type> executor::get_records(client_state& client
 
         using op_utype = std::underlying_type_t<cdc::operation>;
 
-        auto maybe_add_record = [&] {
+        auto maybe_add_record = [&] (const utils::UUID& ts) {
             if (!dynamodb.ObjectEmpty()) {
                 rjson::add(record, "dynamodb", std::move(dynamodb));
                 dynamodb = rjson::empty_object();
@@ -920,8 +970,12 @@ future<executor::request_return_type> executor::get_records(client_state& client
                 // TODO: awsRegion?
                 rjson::add(record, "eventID", event_id(iter.shard.id, *timestamp));
                 rjson::add(record, "eventSource", "scylladb:alternator");
+                if (buffer_records) {
+                    new_records.push_back(change_buffer::record{ts, rjson::copy(record)});
+                }
                 rjson::push_back(records, std::move(record));
                 record = rjson::empty_object();
+                last_timestamp = ts;
                 --limit;
             }
         };
@@ -983,7 +1037,7 @@ future<executor::request_return_type> executor::get_records(client_state& client
                 break;
             }
             if (eor) {
-                maybe_add_record();
+                maybe_add_record(ts);
                 timestamp = ts;
                 if (limit == 0) {
                     break;
@@ -991,13 +1045,24 @@ future<executor::request_return_type> executor::get_records(client_state& client
             }
         }
 
+        if (buffer_records) {
+            // Unless cut short, the read got all the records up to high_ts.
+            bool caught_up = !qr.query_result->is_short_read() && result_set->rows().size() < row_limit && limit != 0;
+            if (caught_up) {
+                _change_buffer.put(*schema, *base, iter.shard.id, from, std::move(new_records), stream_position{high_uuid, true}, true, buffer_records);
+            } else if (!new_records.empty()) {
+                auto end = stream_position{new_records.back().timestamp, false};
+                _change_buffer.put(*schema, *base, iter.shard.id, from, std::move(new_records), end, false, buffer_records);
+            }
+        }
+
         auto ret = rjson::empty_object();
         auto nrecords = records.Size();
         rjson::add(ret, "Records", std::move(records));
 
         if (nrecords != 0) {
             // #9642. Set next iterators threshold to > last
-            shard_iterator next_iter(iter.table, iter.shard, *timestamp, false);
+            shard_iterator next_iter(iter.table, iter.shard, *last_timestamp, false);
             // Note that here we unconditionally return NextShardIterator,
             // without checking if maybe we reached the end-of-shard. If the
             // shard did end, then the next read will have nrecords == 0 and
@@ -30,6 +30,8 @@
 #include "service/pager/query_pagers.hh"
 #include "gms/feature_service.hh"
 #include "sstables/types.hh"
+#include "sstables/sstables.hh"
+#include "collection_mutation.hh"
 #include "mutation.hh"
 #include "types.hh"
 #include "types/map.hh"
@@ -146,7 +148,8 @@ future<executor::request_return_type> executor::describe_time_to_live(client_sta
 // The expiration-time "attribute" can be either an actual Scylla column
 // (must be numeric) or an Alternator "attribute" - i.e., an element in
 // the ATTRS_COLUMN_NAME map<utf8,bytes> column where the numeric expiration
-// time is encoded in DynamoDB's JSON encoding inside the bytes value.
+// time is encoded in DynamoDB's JSON encoding inside the bytes value (or a
+// bytes column of its own, encoded the same way, if it was promoted).
 // To avoid scanning the same items RF times in RF replicas, only one node is
 // responsible for scanning a token range at a time. Normally, this is the
 // node owning this range as a "primary range" (the first node in the ring
@@ -235,6 +238,81 @@ static bool is_expired(const rjson::value& expiration_time, gc_clock::time_point
     return n && is_expired(*n, now);
 }
 
+static gc_clock::time_point to_expiration_time(const big_decimal& expiration_time) {
+    unsigned long t = std::min<unsigned long>(bigdecimal_to_ul(expiration_time), std::numeric_limits<gc_clock::rep>::max());
+    return gc_clock::time_point(gc_clock::duration(std::chrono::seconds(t)));
+}
+
+static std::optional<gc_clock::time_point> to_expiration_time(const rjson::value& expiration_time) {
+    std::optional<big_decimal> n = try_unwrap_number(expiration_time);
+    if (!n) {
+        return std::nullopt;
+    }
+    return to_expiration_time(*n);
+}
+
+// Gives the sstable writer the expiration times of the items of the tables
+// with TTL enabled, taken from the same places the scanner below reads them
+// from. The scanner skips the token ranges of which no sstable may have an
+// expired item.
+class ttl_row_expiration_extension : public sstables::row_expiration_extension {
+public:
+    std::optional<sstables::row_expiration> get_row_expiration(const schema& s) const override {
+        std::optional<std::string> attribute_name = find_tag(s, TTL_TAG_KEY);
+        if (!attribute_name) {
+            return std::nullopt;
+        }
+        const column_definition* cdef = s.get_column_definition(to_bytes(*attribute_name));
+        if (!cdef) {
+            cdef = executor::promoted_attribute_column(s, *attribute_name);
+        }
+        if (cdef && cdef->is_regular() && cdef->type->get_kind() == abstract_type::kind::decimal) {
+            return sstables::row_expiration{*attribute_name, [cdef] (const row& cells) -> std::optional<gc_clock::time_point> {
+                auto* c = cells.find_cell(cdef->id);
+                if (!c || !c->as_atomic_cell(*cdef).is_live()) {
+                    return std::nullopt;
+                }
+                auto v = cdef->type->deserialize(c->as_atomic_cell(*cdef).value().linearize());
+                return to_expiration_time(value_cast<big_decimal>(v));
+            }};
+        }
+        if (cdef && executor::promoted_attribute_name(*cdef)) {
+            return sstables::row_expiration{*attribute_name, [cdef] (const row& cells) -> std::optional<gc_clock::time_point> {
+                auto* c = cells.find_cell(cdef->id);
+                if (!c || !c->as_atomic_cell(*cdef).is_live()) {
+                    return std::nullopt;
+                }
+                return to_expiration_time(deserialize_item(c->as_atomic_cell(*cdef).value().linearize()));
+            }};
+        }
+        const column_definition* attrs = cdef ? nullptr : s.get_column_definition(bytes(executor::ATTRS_COLUMN_NAME));
+        if (!attrs || attrs->type->get_kind() != abstract_type::kind::map) {
+            return std::nullopt;
+        }
+        return sstables::row_expiration{*attribute_name, [attrs, member = to_bytes(*attribute_name)] (const row& cells) -> std::optional<gc_clock::time_point> {
+            auto* c = cells.find_cell(attrs->id);
+            if (!c) {
+                return std::nullopt;
+            }
+            return c->as_collection_mutation().with_deserialized(*attrs->type, [&] (collection_mutation_view_description mut) -> std::optional<gc_clock::time_point> {
+                for (auto& [key, cell] : mut.cells) {
+                    if (key == bytes_view(member)) {
+                        if (!cell.is_live()) {
+                            return std::nullopt;
+                        }
+                        return to_expiration_time(deserialize_item(cell.value().linearize()));
+                    }
+                }
+                return std::nullopt;
+            });
+        }};
+    }
+};
+
+std::unique_ptr<sstables::row_expiration_extension> make_row_expiration_extension() {
+    return std::make_unique<ttl_row_expiration_extension>();
+}
+
 // expire_item() expires an item - i.e., deletes it as appropriate for
 // expiration - with CL=QUORUM and (FIXME!) in a way Alternator Streams
 // understands it is an expiration event - not a user-initiated deletion.
@@ -587,6 +665,10 @@ static future<> scan_table_ranges(
                         break;
                     }
                 }
+            } else if (meta[*expiration_column]->type->get_kind() == abstract_type::kind::bytes) {
+                // An attribute promoted to a column of its own, serialized
+                // as it would be in the map.
+                expired = is_expired(deserialize_item(*cell), now);
             } else {
                 // For a real column to contain an expiration time, it
                 // must be a numeric type.
@@ -656,6 +738,15 @@ static future<bool> scan_table(
     const column_definition *cd = s->get_column_definition(column_name);
     std::optional<std::string> member;
     if (!cd) {
+        cd = executor::promoted_attribute_column(*s, *attribute_name);
+        if (cd) {
+            column_name = cd->name();
+        }
+    }
+    bool serialized = cd && executor::promoted_attribute_name(*cd);
+    if (serialized) {
+        tlogger.info("table {} TTL enabled with attribute {} in {}", s->cf_name(), *attribute_name, cd->name_as_text());
+    } else if (!cd) {
         member = std::move(attribute_name);
         column_name = bytes(executor::ATTRS_COLUMN_NAME);
         cd = s->get_column_definition(column_name);
@@ -674,16 +765,37 @@ static future<bool> scan_table(
     // nothing can get expired in this table, and it's pointless to
     // scan it.
     if ((member && column_type->get_kind() != abstract_type::kind::map) ||
-        (!member && column_type->get_kind() != abstract_type::kind::decimal)) {
+        (serialized && column_type->get_kind() != abstract_type::kind::bytes) ||
+        (!member && !serialized && column_type->get_kind() != abstract_type::kind::decimal)) {
         tlogger.info("table {} TTL column has unsupported type, not scanning", s->cf_name());
         co_return false;
     }
     // FIXME: need to pace the scan, not do it all at once.
     // FIXME: consider if we should ask the scan without caching?
     // can we use cache but not fill it?
+    // The sstables of a token range written since TTL was enabled record the
+    // earliest and latest expiration times of their items (see
+    // ttl_row_expiration_extension), so ranges in which none may have an
+    // expired item are skipped. The items still in memtables are found once
+    // they are flushed.
+    auto expiration_source = *find_tag(*s, TTL_TAG_KEY);
+    replica::table& table = db.real_database().find_column_family(s);
+    auto may_have_expired_items = [&] (const dht::partition_range& range) {
+        auto now = gc_clock::now();
+        auto from = now - std::chrono::years(5);
+        for (auto& sst : table.select_sstables(range)) {
+            if (sst->may_have_rows_expiring(expiration_source, from, now)) {
+                return true;
+            }
+        }
+        return false;
+    };
     scan_ranges_context scan_ctx{s, proxy, std::move(column_name), std::move(member)};
     token_ranges_owned_by_this_shard<primary> my_ranges(db.real_database(), s);
     while (std::optional<dht::partition_range> range = my_ranges.next_partition_range()) {
+        if (!may_have_expired_items(*range)) {
+            continue;
+        }
         // Note that because of issue #9167 we need to run a separate
         // query on each partition range, and can't pass several of
         // them into one partition_range_vector.
@@ -704,6 +816,9 @@ static future<bool> scan_table(
     // on its *secondary* ranges - but only those whose primary owner is down.
     token_ranges_owned_by_this_shard<secondary> my_secondary_ranges(db.real_database(), s);
     while (std::optional<dht::partition_range> range = my_secondary_ranges.next_partition_range()) {
+        if (!may_have_expired_items(*range)) {
+            continue;
+        }
         dht::partition_range_vector partition_ranges;
         partition_ranges.push_back(std::move(*range));
         co_await scan_table_ranges(proxy, scan_ctx, std::move(partition_ranges), abort_source, page_sem);
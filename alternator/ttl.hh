@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include "seastarx.hh"
 #include <seastar/core/sharded.hh>
 #include <seastar/core/abort_source.hh>
@@ -21,6 +22,10 @@ namespace service {
     class storage_proxy;
 }
 
+namespace sstables {
+class row_expiration_extension;
+}
+
 namespace alternator {
 
 // expiration_service is a sharded service responsible for cleaning up expired
@@ -53,4 +58,10 @@ class expiration_service final : public seastar::peering_sharded_service<expirat
     future<> stop();
 };
 
+// Lets the sstables writer record the expiration times of the items of
+// tables with TTL enabled, so the expiration_service scanner can skip the
+// parts of the tables which can't have expired items. To be registered in
+// db::extensions.
+std::unique_ptr<sstables::row_expiration_extension> make_row_expiration_extension();
+
 } // namespace alternator
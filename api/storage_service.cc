@@ -358,10 +358,26 @@ void set_sstables_loader(http_context& ctx, routes& r, sharded<sstables_loader>&
             return make_ready_future<json::json_return_type>(json_void());
         });
     });
+
+    ss::bulk_load.set(r, [&ctx, &sst_loader](std::unique_ptr<request> req) -> future<json::json_return_type> {
+        auto ks = validate_keyspace(ctx, req->param);
+        auto cf = req->get_query_param("cf");
+        try {
+            auto rows = co_await sst_loader.local().bulk_load(std::move(ks), std::move(cf), std::move(req->content), ctx.sp.local());
+            co_return json::json_return_type(rows);
+        } catch (const bulk_load_error& e) {
+            throw bad_param_exception(e.what());
+        } catch (const replica::no_such_column_family& e) {
+            throw bad_param_exception(e.what());
+        } catch (...) {
+            throw httpd::server_error_exception(fmt::format("Failed to bulk load: {}", std::current_exception()));
+        }
+    });
 }
 
 void unset_sstables_loader(http_context& ctx, routes& r) {
     ss::load_new_ss_tables.unset(r);
+    ss::bulk_load.unset(r);
 }
 
 void set_view_builder(http_context& ctx, routes& r, sharded<db::view::view_builder>& vb) {
@@ -669,6 +685,30 @@ void set_storage_service(http_context& ctx, routes& r, sharded<service::storage_
         });
     }));
 
+    ss::garbage_collect.set(r, wrap_ks_cf(ctx, [] (http_context& ctx, std::unique_ptr<request> req, sstring keyspace, std::vector<sstring> column_families) {
+        return ctx.db.invoke_on_all([=] (replica::database& db) {
+            return do_for_each(column_families, [=, &db](sstring cfname) {
+                auto& cm = db.get_compaction_manager();
+                auto& cf = db.find_column_family(keyspace, cfname);
+                return cm.perform_garbage_collection(&cf);
+            });
+        }).then([]{
+            return make_ready_future<json::json_return_type>(0);
+        });
+    }));
+
+    ss::offload.set(r, wrap_ks_cf(ctx, [] (http_context& ctx, std::unique_ptr<request> req, sstring keyspace, std::vector<sstring> column_families) {
+        return ctx.db.invoke_on_all([=] (replica::database& db) {
+            return do_for_each(column_families, [=, &db](sstring cfname) {
+                auto& cm = db.get_compaction_manager();
+                auto& cf = db.find_column_family(keyspace, cfname);
+                return cm.perform_offload(&cf);
+            });
+        }).then([]{
+            return make_ready_future<json::json_return_type>(0);
+        });
+    }));
+
     ss::force_keyspace_flush.set(r, [&ctx](std::unique_ptr<request> req) {
         auto keyspace = validate_keyspace(ctx, req->param);
         auto column_families = parse_tables(keyspace, ctx, req->query_parameters, "cf");
@@ -1320,6 +1360,15 @@ void set_snapshot(http_context& ctx, routes& r, sharded<db::snapshot_ctl>& snap_
         });
     });
 
+    ss::backup_snapshot.set(r, [&snap_ctl](std::unique_ptr<request> req) {
+        auto tag = req->get_query_param("tag");
+        auto destination = req->get_query_param("destination");
+        std::vector<sstring> keynames = split(req->get_query_param("kn"), ",");
+        return snap_ctl.local().backup_snapshot(tag, keynames, destination).then([] (db::snapshot_ctl::backup_stats stats) {
+            return make_ready_future<json::json_return_type>(stats.bytes_uploaded);
+        });
+    });
+
     ss::true_snapshots_size.set(r, [&snap_ctl](std::unique_ptr<request> req) {
         return snap_ctl.local().true_snapshots_size().then([] (int64_t size) {
             return make_ready_future<json::json_return_type>(size);
@@ -1389,6 +1438,7 @@ void unset_snapshot(http_context& ctx, routes& r) {
     ss::get_snapshot_details.unset(r);
     ss::take_snapshot.unset(r);
     ss::del_snapshot.unset(r);
+    ss::backup_snapshot.unset(r);
     ss::true_snapshots_size.unset(r);
     ss::scrub.unset(r);
 }
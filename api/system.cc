@@ -13,6 +13,7 @@
 #include <seastar/http/exception.hh>
 #include "log.hh"
 #include "replica/database.hh"
+#include "utils/cpu_profiler.hh"
 
 extern logging::logger apilog;
 
@@ -61,6 +62,41 @@ void set_system(http_context& ctx, routes& r) {
         return json::json_void();
     });
 
+    hs::get_cpu_profiler_samples.set(r, [&ctx](std::unique_ptr<request> req) {
+        const auto reset = req->get_query_param("reset") == "true";
+        using stacks_map = std::unordered_map<sstring, uint64_t>;
+        return ctx.db.map_reduce0([reset] (replica::database&) {
+            return utils::cpu_profiler::folded_stacks(reset);
+        }, stacks_map(), [] (stacks_map res, std::vector<std::pair<sstring, uint64_t>> stacks) {
+            for (auto& [stack, count] : stacks) {
+                res[stack] += count;
+            }
+            return res;
+        }).then([] (stacks_map stacks) {
+            std::vector<sstring> ret;
+            ret.reserve(stacks.size());
+            for (auto& [stack, count] : stacks) {
+                ret.push_back(format("{} {}", stack, count));
+            }
+            return make_ready_future<json::json_return_type>(std::move(ret));
+        });
+    });
+
+    hs::set_cpu_profiler_frequency.set(r, [&ctx](std::unique_ptr<request> req) {
+        unsigned frequency;
+        try {
+            frequency = boost::lexical_cast<unsigned>(std::string(req->get_query_param("frequency")));
+        } catch (boost::bad_lexical_cast& e) {
+            throw bad_param_exception("Invalid frequency " + req->get_query_param("frequency"));
+        }
+        apilog.info("Setting CPU profiler frequency to {} Hz", frequency);
+        return ctx.db.invoke_on_all([frequency] (replica::database&) {
+            utils::cpu_profiler::set_frequency(frequency);
+        }).then([] {
+            return json::json_return_type(json::json_void());
+        });
+    });
+
     hs::drop_sstable_caches.set(r, [&ctx](std::unique_ptr<request> req) {
         apilog.info("Dropping sstable caches");
         return ctx.db.invoke_on_all([] (replica::database& db) {
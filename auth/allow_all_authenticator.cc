@@ -20,6 +20,7 @@ static const class_registrator<
         authenticator,
         allow_all_authenticator,
         cql3::query_processor&,
-        ::service::migration_manager&> registration("org.apache.cassandra.auth.AllowAllAuthenticator");
+        ::service::migration_manager&,
+        utils::alien_worker&> registration("org.apache.cassandra.auth.AllowAllAuthenticator");
 
 }
@@ -22,13 +22,17 @@ namespace service {
 class migration_manager;
 }
 
+namespace utils {
+class alien_worker;
+}
+
 namespace auth {
 
 extern const std::string_view allow_all_authenticator_name;
 
 class allow_all_authenticator final : public authenticator {
 public:
-    allow_all_authenticator(cql3::query_processor&, ::service::migration_manager&) {
+    allow_all_authenticator(cql3::query_processor&, ::service::migration_manager&, utils::alien_worker&) {
     }
 
     virtual future<> start() override {
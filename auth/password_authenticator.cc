@@ -29,6 +29,7 @@
 #include "cql3/untyped_result_set.hh"
 #include "log.hh"
 #include "service/migration_manager.hh"
+#include "utils/alien_worker.hh"
 #include "utils/class_registrator.hh"
 #include "replica/database.hh"
 #include "cql3/query_processor.hh"
@@ -49,16 +50,18 @@ static const class_registrator<
         authenticator,
         password_authenticator,
         cql3::query_processor&,
-        ::service::migration_manager&> password_auth_reg("org.apache.cassandra.auth.PasswordAuthenticator");
+        ::service::migration_manager&,
+        utils::alien_worker&> password_auth_reg("org.apache.cassandra.auth.PasswordAuthenticator");
 
 static thread_local auto rng_for_salt = std::default_random_engine(std::random_device{}());
 
 password_authenticator::~password_authenticator() {
 }
 
-password_authenticator::password_authenticator(cql3::query_processor& qp, ::service::migration_manager& mm)
+password_authenticator::password_authenticator(cql3::query_processor& qp, ::service::migration_manager& mm, utils::alien_worker& hashing_worker)
     : _qp(qp)
     , _migration_manager(mm)
+    , _hashing_worker(hashing_worker)
     , _stopped(make_ready_future<>()) {
 }
 
@@ -212,14 +215,22 @@ future<authenticated_user> password_authenticator::authenticate(
                 internal_distributed_query_state(),
                 {username},
                 true);
-    }).then_wrapped([=](future<::shared_ptr<cql3::untyped_result_set>> f) {
+    }).then([password](::shared_ptr<cql3::untyped_result_set> res) {
+        auto salted_hash = std::optional<sstring>();
+        if (!res->empty()) {
+            salted_hash = res->one().get_opt<sstring>(SALTED_HASH);
+        }
+        if (!salted_hash) {
+            return make_ready_future<bool>(false);
+        }
+        // Hashing takes milliseconds by design, which would stall the reactor
+        // for all other requests during a storm of logins.
+        return _hashing_worker.submit<bool>([password, salted_hash = std::move(*salted_hash)] {
+            return passwords::check(password, salted_hash);
+        });
+    }).then_wrapped([=](future<bool> f) {
         try {
-            auto res = f.get0();
-            auto salted_hash = std::optional<sstring>();
-            if (!res->empty()) {
-                salted_hash = res->one().get_opt<sstring>(SALTED_HASH);
-            }
-            if (!salted_hash || !passwords::check(password, *salted_hash)) {
+            if (!f.get0()) {
                 throw exceptions::authentication_exception("Username and/or password are incorrect");
             }
             return make_ready_future<authenticated_user>(username);
@@ -27,6 +27,10 @@ namespace service {
 class migration_manager;
 }
 
+namespace utils {
+class alien_worker;
+}
+
 namespace auth {
 
 extern const std::string_view password_authenticator_name;
@@ -34,13 +38,14 @@ extern const std::string_view password_authenticator_name;
 class password_authenticator : public authenticator {
     cql3::query_processor& _qp;
     ::service::migration_manager& _migration_manager;
+    utils::alien_worker& _hashing_worker;
     future<> _stopped;
     seastar::abort_source _as;
 
 public:
     static db::consistency_level consistency_for_user(std::string_view role_name);
 
-    password_authenticator(cql3::query_processor&, ::service::migration_manager&);
+    password_authenticator(cql3::query_processor&, ::service::migration_manager&, utils::alien_worker&);
 
     ~password_authenticator();
 
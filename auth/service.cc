@@ -120,13 +120,14 @@ service::service(
         cql3::query_processor& qp,
         ::service::migration_notifier& mn,
         ::service::migration_manager& mm,
+        utils::alien_worker& hashing_worker,
         const service_config& sc)
             : service(
                       std::move(c),
                       qp,
                       mn,
                       create_object<authorizer>(sc.authorizer_java_name, qp, mm),
-                      create_object<authenticator>(sc.authenticator_java_name, qp, mm),
+                      create_object<authenticator>(sc.authenticator_java_name, qp, mm, hashing_worker),
                       create_object<role_manager>(sc.role_manager_java_name, qp, mm)) {
 }
 
@@ -34,6 +34,10 @@ class migration_notifier;
 class migration_listener;
 }
 
+namespace utils {
+class alien_worker;
+}
+
 namespace auth {
 
 class role_or_anonymous;
@@ -103,6 +107,7 @@ class service final : public seastar::peering_sharded_service<service> {
             cql3::query_processor&,
             ::service::migration_notifier&,
             ::service::migration_manager&,
+            utils::alien_worker&,
             const service_config&);
 
     future<> start(::service::migration_manager&);
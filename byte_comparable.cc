@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "byte_comparable.hh"
+#include "types.hh"
+#include "schema.hh"
+#include "dht/i_partitioner.hh"
+#include "utils/fragment_range.hh"
+#include "bytes_ostream.hh"
+
+namespace byte_comparable {
+
+static constexpr int8_t empty_value_header = 0x3f;
+static constexpr int8_t value_header = 0x40;
+static constexpr int8_t reversed_empty_value_header = 0x41;
+
+static constexpr int8_t escape_byte = int8_t(0xff);
+
+bool is_byte_comparable(const abstract_type& t) {
+    switch (t.get_kind()) {
+    case abstract_type::kind::ascii:
+    case abstract_type::kind::boolean:
+    case abstract_type::kind::byte:
+    case abstract_type::kind::bytes:
+    case abstract_type::kind::date:
+    case abstract_type::kind::double_kind:
+    case abstract_type::kind::duration:
+    case abstract_type::kind::float_kind:
+    case abstract_type::kind::inet:
+    case abstract_type::kind::int32:
+    case abstract_type::kind::long_kind:
+    case abstract_type::kind::short_kind:
+    case abstract_type::kind::simple_date:
+    case abstract_type::kind::time:
+    case abstract_type::kind::timestamp:
+    case abstract_type::kind::utf8:
+        return true;
+    case abstract_type::kind::reversed:
+        return is_byte_comparable(*t.underlying_type());
+    default:
+        return false;
+    }
+}
+
+bool is_clustering_key_byte_comparable(const schema& s) {
+    return std::all_of(s.clustering_key_type()->types().begin(), s.clustering_key_type()->types().end(), [] (const data_type& t) {
+        return is_byte_comparable(*t);
+    });
+}
+
+// Appends the big-endian value, with the sign bit flipped if is_signed.
+static void encode_fixed(bytes_ostream& out, bytes_view v, bool is_signed) {
+    if (!is_signed) {
+        return out.write(v);
+    }
+    bytes b(v);
+    b[0] ^= int8_t(0x80);
+    out.write(b);
+}
+
+template <typename T>
+static void encode_floating(bytes_ostream& out, bytes_view v) {
+    using uint_type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    if (v.size() != sizeof(T)) {
+        throw std::invalid_argument(format("byte_comparable: invalid floating point value size {}", v.size()));
+    }
+    auto bits = read_be<uint_type>(reinterpret_cast<const char*>(v.data()));
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    constexpr uint_type sign = uint_type(1) << (sizeof(T) * 8 - 1);
+    if (std::isnan(value)) {
+        bits = ~uint_type(0);
+    } else if (bits & sign) {
+        bits = ~bits;
+    } else {
+        bits ^= sign;
+    }
+    bytes b(bytes::initialized_later(), sizeof(T));
+    write_be<uint_type>(reinterpret_cast<char*>(b.begin()), bits);
+    out.write(b);
+}
+
+static void encode_escaped(bytes_ostream& out, bytes_view v) {
+    while (!v.empty()) {
+        auto zero = v.find(int8_t(0));
+        if (zero == bytes_view::npos) {
+            out.write(v);
+            break;
+        }
+        out.write(v.substr(0, zero + 1));
+        out.write(bytes_view(&escape_byte, 1));
+        v.remove_prefix(zero + 1);
+    }
+    static const int8_t terminator[] = {0, 0};
+    out.write(bytes_view(terminator, sizeof(terminator)));
+}
+
+// Appends the prefix-free encoding of a non-empty value.
+static void encode_value(bytes_ostream& out, const abstract_type& t, bytes_view v) {
+    switch (t.get_kind()) {
+    case abstract_type::kind::byte:
+    case abstract_type::kind::short_kind:
+    case abstract_type::kind::int32:
+    case abstract_type::kind::long_kind:
+    case abstract_type::kind::time:
+    case abstract_type::kind::timestamp:
+        return encode_fixed(out, v, true);
+    case abstract_type::kind::simple_date:
+        return encode_fixed(out, v, false);
+    case abstract_type::kind::boolean: {
+        int8_t b = v[0] != 0;
+        return out.write(bytes_view(&b, 1));
+    }
+    case abstract_type::kind::float_kind:
+        return encode_floating<float>(out, v);
+    case abstract_type::kind::double_kind:
+        return encode_floating<double>(out, v);
+    case abstract_type::kind::ascii:
+    case abstract_type::kind::bytes:
+    case abstract_type::kind::date:
+    case abstract_type::kind::duration:
+    case abstract_type::kind::inet:
+    case abstract_type::kind::utf8:
+        return encode_escaped(out, v);
+    case abstract_type::kind::reversed: {
+        bytes_ostream underlying;
+        encode_value(underlying, *t.underlying_type(), v);
+        bytes b(underlying.linearize());
+        for (auto& c : b) {
+            c = ~c;
+        }
+        return out.write(b);
+    }
+    default:
+        throw std::invalid_argument(format("byte_comparable: type {} is not byte-comparable", t.name()));
+    }
+}
+
+bytes encode(const schema& s, clustering_key_prefix_view ckp) {
+    if (!is_clustering_key_byte_comparable(s)) {
+        throw std::invalid_argument(format("byte_comparable: clustering key of {}.{} is not byte-comparable", s.ks_name(), s.cf_name()));
+    }
+    bytes_ostream out;
+    auto& types = s.clustering_key_type()->types();
+    auto type_it = types.begin();
+    for (managed_bytes_view component : ckp.components(s)) {
+        const abstract_type& t = **type_it++;
+        if (component.empty()) {
+            auto header = t.is_reversed() ? reversed_empty_value_header : empty_value_header;
+            out.write(bytes_view(&header, 1));
+            continue;
+        }
+        out.write(bytes_view(&value_header, 1));
+        with_linearized(component, [&] (bytes_view v) {
+            encode_value(out, t, v);
+        });
+    }
+    return bytes(out.linearize());
+}
+
+bytes encode(const dht::token& t) {
+    assert(t._kind == dht::token::kind::key);
+    bytes b(bytes::initialized_later(), sizeof(int64_t));
+    write_be<uint64_t>(reinterpret_cast<char*>(b.begin()), uint64_t(t.raw()) ^ (uint64_t(1) << 63));
+    return b;
+}
+
+bytes encode(const schema& s, const dht::decorated_key& dk) {
+    auto legacy = dk.key().legacy_form(s);
+    bytes b(bytes::initialized_later(), sizeof(int64_t) + legacy.size());
+    auto token = encode(dk.token());
+    auto out = std::copy(token.begin(), token.end(), b.begin());
+    std::copy(legacy.begin(), legacy.end(), out);
+    return b;
+}
+
+} // namespace byte_comparable
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "bytes.hh"
+#include "keys.hh"
+#include "schema_fwd.hh"
+
+namespace dht {
+class token;
+class decorated_key;
+}
+
+class abstract_type;
+
+// Byte-comparable ("memcmp-able") encoding of keys.
+//
+// The encoding maps a key to a byte string such that comparing two encoded
+// keys with compare_unsigned() gives the same result as comparing the
+// original keys with the schema-aware comparators:
+//
+//   compare_unsigned(encode(s, k1), encode(s, k2)) <=> clustering_key_prefix::tri_compare(s)(k1, k2)
+//   compare_unsigned(encode(s, dk1), encode(s, dk2)) <=> dk1.tri_compare(s, dk2)
+//
+// This lets hot comparison paths (index lookups, tries, merging) compare
+// keys without deserializing their components one by one.
+//
+// Clustering prefixes
+// -------------------
+//
+// Each component is preceded by a one-byte header:
+//
+//   0x3f  - empty value (sorts before any non-empty value)
+//   0x40  - non-empty value follows
+//   0x41  - empty value of a reversed type (sorts after any non-empty value)
+//
+// A prefix just ends after its last component, so a prefix sorts before all
+// keys it is a prefix of, as it does with clustering_key_prefix::tri_compare.
+//
+// Component values are encoded in a prefix-free way:
+//
+//   - signed integers, timestamp, time: big-endian with the sign bit flipped,
+//   - simple_date: big-endian (it's compared unsigned),
+//   - boolean: one byte, 0 or 1,
+//   - float, double: IEEE 754 with the sign bit flipped for non-negative
+//     values and all bits flipped for negative values; NaNs, which compare
+//     equal and greater than anything else, are encoded as all ones,
+//   - blob, ascii, text, inet, date, duration: the raw bytes with every 0x00
+//     escaped as 0x00 0xff, terminated with 0x00 0x00,
+//   - reversed<T>: the encoding of T with all bits flipped.
+//
+// Other types (collections, tuples, UDTs, uuid, timeuuid, decimal, varint,
+// counter) are not supported; use is_byte_comparable() to check a schema
+// before relying on the encoding.
+//
+// Decorated keys
+// --------------
+//
+// The token is encoded as a big-endian integer with the sign bit flipped,
+// followed by the legacy (Origin-compatible) form of the partition key, which
+// is what decorated_key::tri_compare() compares lexicographically for equal
+// tokens.
+
+namespace byte_comparable {
+
+// Returns true iff values of the type can be encoded.
+bool is_byte_comparable(const abstract_type& t);
+
+// Returns true iff all clustering key columns of the schema can be encoded.
+bool is_clustering_key_byte_comparable(const schema& s);
+
+// Encodes the clustering prefix.
+// Throws std::invalid_argument if !is_clustering_key_byte_comparable(s).
+bytes encode(const schema& s, clustering_key_prefix_view ckp);
+
+// Encodes the token (which must be a key token) as 8 bytes.
+bytes encode(const dht::token& t);
+
+// Encodes the decorated key.
+bytes encode(const schema& s, const dht::decorated_key& dk);
+
+// Orders encoded keys.
+struct tri_compare {
+    std::strong_ordering operator()(bytes_view a, bytes_view b) const {
+        return compare_unsigned(a, b);
+    }
+};
+
+struct less_compare {
+    bool operator()(bytes_view a, bytes_view b) const {
+        return compare_unsigned(a, b) < 0;
+    }
+};
+
+} // namespace byte_comparable
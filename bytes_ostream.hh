@@ -177,6 +177,13 @@ class bytes_ostream {
 
     bytes_ostream() noexcept : bytes_ostream(default_chunk_size) {}
 
+    // Returns an empty stream whose first chunk can hold size bytes, so that
+    // writing that much data into it leaves it linearized, as long as size
+    // does not exceed max_chunk_size().
+    static bytes_ostream with_capacity(size_t size) noexcept {
+        return bytes_ostream(std::min<size_t>(size + sizeof(chunk), max_alloc_size()));
+    }
+
     bytes_ostream(bytes_ostream&& o) noexcept
         : _begin(std::move(o._begin))
         , _current(o._current)
@@ -328,6 +335,39 @@ class bytes_ostream {
         }
     }
 
+    // Appends the contents of o which follow its first skip bytes. The chunks
+    // of o are taken over rather than copied, except for the one the appended
+    // data starts in.
+    void splice(bytes_ostream&& o, size_type skip = 0) {
+        auto c = std::move(o._begin);
+        o._current = nullptr;
+        o._size = 0;
+        while (c && skip >= c->offset) {
+            skip -= c->offset;
+            c = std::move(c->next);
+        }
+        if (!c) {
+            return;
+        }
+        write(bytes_view(c->data + skip, c->offset - skip));
+        auto rest = std::move(c->next);
+        if (!rest) {
+            return;
+        }
+        auto last = rest.get();
+        _size += last->offset;
+        while (last->next) {
+            last = last->next.get();
+            _size += last->offset;
+        }
+        if (_current) {
+            _current->next = std::move(rest);
+        } else {
+            _begin = std::move(rest);
+        }
+        _current = last;
+    }
+
     // Removes n bytes from the end of the bytes_ostream.
     // Beware of O(n) algorithm.
     void remove_suffix(size_t n) {
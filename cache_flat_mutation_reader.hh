@@ -119,6 +119,20 @@ class cache_flat_mutation_reader final : public flat_mutation_reader::impl {
     void start_reading_from_underlying();
     bool after_current_range(position_in_partition_view position);
     bool can_populate() const;
+    // Rows populated by probationary reads, or into partitions which are over the
+    // partition row budget, go to the probationary segment of the LRU, unless the
+    // partition has older versions, which must be evicted before the latest one.
+    cache_tracker::probationary probationary_population() const {
+        return cache_tracker::probationary((_read_context.is_probationary() || over_row_budget()) && _snp->at_oldest_version());
+    }
+    bool over_row_budget() const {
+        auto budget = _snp->tracker()->partition_row_budget();
+        return budget && _snp->at_latest_version() && entry().populated_rows() >= budget;
+    }
+    // Valid only when _snp->at_latest_version().
+    cache_entry& entry() const {
+        return cache_entry::container_of(partition_entry::container_of(*_snp->version()));
+    }
     // Marks the range between _last_row (exclusive) and _next_row (exclusive) as continuous,
     // provided that the underlying reader still matches the latest version of the partition.
     // Invalidates _last_row.
@@ -145,6 +159,11 @@ class cache_flat_mutation_reader final : public flat_mutation_reader::impl {
         return _snp->schema();
     }
     void touch_partition();
+    void touch_next_row() {
+        if (!_read_context.is_probationary()) {
+            _next_row.touch();
+        }
+    }
 
     position_in_partition_view to_table_domain(position_in_partition_view query_domain_pos) {
         if (!_read_context.is_reversed()) [[likely]] {
@@ -234,6 +253,7 @@ inline
 future<> cache_flat_mutation_reader::process_static_row() {
     if (_snp->static_row_continuous()) {
         _read_context.cache().on_row_hit();
+        ++_permit.stats().cache_row_hits;
         static_row sr = _lsa_manager.run_in_read_section([this] {
             return _snp->static_row(_read_context.digest_requested());
         });
@@ -243,6 +263,7 @@ future<> cache_flat_mutation_reader::process_static_row() {
         return make_ready_future<>();
     } else {
         _read_context.cache().on_row_miss();
+        ++_permit.stats().cache_row_misses;
         return ensure_underlying().then([this] {
             return (*_underlying)().then([this] (mutation_fragment_opt&& sr) {
                 if (sr) {
@@ -258,7 +279,10 @@ future<> cache_flat_mutation_reader::process_static_row() {
 
 inline
 void cache_flat_mutation_reader::touch_partition() {
-    _snp->touch();
+    // Probationary reads leave the LRU order as it is.
+    if (!_read_context.is_probationary()) {
+        _snp->touch();
+    }
 }
 
 inline
@@ -365,6 +389,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
         [this] { return _state != state::reading_from_underlying || is_buffer_full(); },
         [this] (mutation_fragment mf) {
             _read_context.cache().on_row_miss();
+            ++_permit.stats().cache_row_misses;
             maybe_add_to_cache(mf);
             add_to_buffer(std::move(mf));
         },
@@ -402,7 +427,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     auto it = insert_result.first;
-                                    _snp->tracker()->insert(*it);
+                                    _snp->tracker()->insert(*it, probationary_population());
                                     auto next = std::next(it);
                                     // Also works in reverse read mode.
                                     // It preserves the continuity of the range the entry falls into.
@@ -418,7 +443,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     clogger.trace("csm {}: inserted dummy at {}", fmt::ptr(this), _upper_bound);
-                                    _snp->tracker()->insert(*insert_result.first);
+                                    _snp->tracker()->insert(*insert_result.first, probationary_population());
                                 }
                                 if (_read_context.is_reversed()) [[unlikely]] {
                                     clogger.trace("csm {}: set_continuous({})", fmt::ptr(this), _last_row.position());
@@ -467,7 +492,7 @@ bool cache_flat_mutation_reader::ensure_population_lower_bound() {
             if (insert_result.second) {
                 auto it = insert_result.first;
                 clogger.trace("csm {}: inserted lower bound dummy at {}", fmt::ptr(this), it->position());
-                _snp->tracker()->insert(*it);
+                _snp->tracker()->insert(*it, probationary_population());
             }
             _last_row.set_latest(insert_result.first);
         });
@@ -529,7 +554,11 @@ void cache_flat_mutation_reader::maybe_add_to_cache(const clustering_row& cr) {
         auto insert_result = mp.mutable_clustered_rows().insert_before_hint(it, std::move(new_entry), cmp);
         it = insert_result.first;
         if (insert_result.second) {
-            _snp->tracker()->insert(*it);
+            if (over_row_budget() && _snp->at_oldest_version()) {
+                _snp->tracker()->on_row_over_partition_budget();
+            }
+            _snp->tracker()->insert(*it, probationary_population());
+            entry().on_row_populated();
         }
 
         rows_entry& e = *it;
@@ -561,13 +590,13 @@ inline
 void cache_flat_mutation_reader::start_reading_from_underlying() {
     clogger.trace("csm {}: start_reading_from_underlying(), range=[{}, {})", fmt::ptr(this), _lower_bound, _next_row_in_range ? _next_row.position() : _upper_bound);
     _state = state::move_to_underlying;
-    _next_row.touch();
+    touch_next_row();
 }
 
 inline
 void cache_flat_mutation_reader::copy_from_cache_to_buffer() {
     clogger.trace("csm {}: copy_from_cache, next={}, next_row_in_range={}", fmt::ptr(this), _next_row.position(), _next_row_in_range);
-    _next_row.touch();
+    touch_next_row();
     position_in_partition_view next_lower_bound = _next_row.dummy() ? _next_row.position() : position_in_partition_view::after_key(_next_row.key());
     auto upper_bound = _next_row_in_range ? next_lower_bound : _upper_bound;
     if (_snp->range_tombstones(_lower_bound, upper_bound, [&] (range_tombstone rts) {
@@ -639,7 +668,7 @@ void cache_flat_mutation_reader::move_to_range(query::clustering_row_ranges::con
                 });
                 auto it = insert_result.first;
                 if (insert_result.second) {
-                    _snp->tracker()->insert(*it);
+                    _snp->tracker()->insert(*it, probationary_population());
                 }
                 _last_row = partition_snapshot_row_weakref(*_snp, it, true);
             } else {
@@ -721,10 +750,14 @@ inline
 void cache_flat_mutation_reader::add_to_buffer(const partition_snapshot_row_cursor& row) {
     if (!row.dummy()) {
         _read_context.cache().on_row_hit();
+        ++_permit.stats().cache_row_hits;
         if (_read_context.digest_requested()) {
             row.latest_row().cells().prepare_hash(table_schema(), column_kind::regular_column);
         }
-        add_clustering_row_to_buffer(mutation_fragment(*_schema, _permit, row.row()));
+        // Rows are copied out of the cache, don't copy the values of the columns which aren't selected.
+        auto& values_needed = _read_context.regular_column_values_needed();
+        add_clustering_row_to_buffer(mutation_fragment(*_schema, _permit,
+                values_needed.empty() ? row.row() : row.row(values_needed)));
     } else {
         position_in_partition::less_compare less(*_schema);
         if (less(_lower_bound, row.position())) {
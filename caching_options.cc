@@ -12,11 +12,15 @@
 #include "exceptions/exceptions.hh"
 #include "utils/rjson.hh"
 
-caching_options::caching_options(sstring k, sstring r, bool enabled)
-        : _key_cache(k), _row_cache(r), _enabled(enabled) {
+caching_options::caching_options(sstring k, sstring r, bool enabled, bool admission_filter, bool pinned)
+        : _key_cache(k), _row_cache(r), _enabled(enabled), _admission_filter(admission_filter), _pinned(pinned) {
     if ((k != "ALL") && (k != "NONE")) {
         throw exceptions::configuration_exception("Invalid key value: " + k); 
     }
+    // A pinned table has to be cached whole.
+    if (pinned && (!enabled || admission_filter)) {
+        throw exceptions::configuration_exception("Caching option pinned can't be combined with enabled: false or admission_filter: true");
+    }
 
     if ((r == "ALL") || (r == "NONE")) {
         return;
@@ -40,6 +44,12 @@ caching_options::to_map() const {
     if (!_enabled) {
         res.insert({"enabled", "false"});
     }
+    if (_admission_filter) {
+        res.insert({"admission_filter", "true"});
+    }
+    if (_pinned) {
+        res.insert({"pinned", "true"});
+    }
     return res;
 }
 
@@ -58,6 +68,8 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
     sstring k = default_key;
     sstring r = default_row;
     bool e = true;
+    bool a = false;
+    bool pinned = false;
 
     for (auto& p : map) {
         if (p.first == "keys") {
@@ -66,11 +78,15 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
             r = p.second;
         } else if (p.first == "enabled") {
             e = p.second == "true";
+        } else if (p.first == "admission_filter") {
+            a = p.second == "true";
+        } else if (p.first == "pinned") {
+            pinned = p.second == "true";
         } else {
             throw exceptions::configuration_exception(format("Invalid caching option: {}", p.first));
         }
     }
-    return caching_options(k, r, e);
+    return caching_options(k, r, e, a, pinned);
 }
 
 caching_options
@@ -81,7 +97,8 @@ caching_options::from_sstring(const sstring& str) {
 bool
 caching_options::operator==(const caching_options& other) const {
     return _key_cache == other._key_cache && _row_cache == other._row_cache
-        && _enabled == other._enabled;
+        && _enabled == other._enabled && _admission_filter == other._admission_filter
+        && _pinned == other._pinned;
 }
 
 bool
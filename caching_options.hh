@@ -25,7 +25,13 @@ class caching_options {
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled);
+    // When set, the cache admits partitions populated by reads only if they are
+    // likely to be accessed more often than the partitions they would evict.
+    bool _admission_filter = false;
+    // When set, the table's partitions are kept in a cache of their own, which
+    // isn't evicted, so that reads are always served from memory.
+    bool _pinned = false;
+    caching_options(sstring k, sstring r, bool enabled, bool admission_filter = false, bool pinned = false);
 
     friend class schema;
     caching_options();
@@ -34,6 +40,14 @@ class caching_options {
         return _enabled;
     }
 
+    bool admission_filter() const {
+        return _admission_filter;
+    }
+
+    bool pinned() const {
+        return _pinned;
+    }
+
     std::map<sstring, sstring> to_map() const;
 
     sstring to_sstring() const;
@@ -8,6 +8,7 @@
 
 #include <utility>
 #include <algorithm>
+#include <unordered_map>
 
 #include <boost/range/irange.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -1440,7 +1441,12 @@ class transformer final : public change_processor {
     // DON'T move the transformer after this
     void begin_timestamp(api::timestamp_type ts, bool is_last) override {
         const auto stream_id = _ctx._cdc_metadata.get_stream(ts, _dk.token());
-        _result_mutations.emplace_back(_log_schema, stream_id.to_partition_key(*_log_schema));
+        auto log_pk = stream_id.to_partition_key(*_log_schema);
+        // The timestamps of a split mutation usually map to the same stream, keep
+        // their rows in one log mutation so that they are written together.
+        if (_result_mutations.empty() || !_result_mutations.back().key().equal(*_log_schema, log_pk)) {
+            _result_mutations.emplace_back(_log_schema, std::move(log_pk));
+        }
         _builder.emplace(_result_mutations.back(), ts, _dk.key(), *_schema);
         _enable_updating_state = _schema->cdc_options().postimage() || (!is_last && _schema->cdc_options().preimage());
     }
@@ -1719,6 +1725,32 @@ class transformer final : public change_processor {
     }
 };
 
+// Merges the log mutations, starting from first_log_mutation, which belong to
+// the same log partition. The mutations of a batch to partitions which map to
+// the same stream produce such mutations, and each would be written separately.
+static void merge_log_mutations(std::vector<mutation>& mutations, size_t first_log_mutation) {
+    std::unordered_multimap<dht::token, size_t> log_mutations;
+    auto out = first_log_mutation;
+    for (auto i = first_log_mutation; i < mutations.size(); ++i) {
+        auto& m = mutations[i];
+        auto [begin, end] = log_mutations.equal_range(m.token());
+        auto it = std::find_if(begin, end, [&] (const auto& e) {
+            const auto& o = mutations[e.second];
+            return o.schema() == m.schema() && o.decorated_key().equal(*o.schema(), m.decorated_key());
+        });
+        if (it != end) {
+            mutations[it->second].apply(std::move(m));
+            continue;
+        }
+        if (out != i) {
+            mutations[out] = std::move(m);
+        }
+        log_mutations.emplace(mutations[out].token(), out);
+        ++out;
+    }
+    mutations.erase(mutations.begin() + out, mutations.end());
+}
+
 template <typename Func>
 future<std::vector<mutation>>
 transform_mutations(std::vector<mutation>& muts, decltype(muts.size()) batch_size, Func&& f) {
@@ -1743,10 +1775,11 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
     }
 
     tracing::trace(tr_state, "CDC: Started generating mutations for log rows");
+    const auto base_mutations = mutations.size();
     mutations.reserve(2 * mutations.size());
 
     return do_with(std::move(mutations), service::query_state(service::client_state::for_internal_calls(), empty_service_permit()), operation_details{},
-            [this, timeout, i, tr_state = std::move(tr_state), write_cl] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details) {
+            [this, timeout, i, tr_state = std::move(tr_state), write_cl, base_mutations] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details) {
         return transform_mutations(mutations, 1, [this, &mutations, timeout, &qs, tr_state = tr_state, &details, write_cl] (int idx) mutable {
             auto& m = mutations[idx];
             auto s = m.schema();
@@ -1806,7 +1839,8 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
                 tracing::trace(tr_state, "CDC: Generated {} log mutations from {}", generated_count, mutations[idx].decorated_key());
                 details.touched_parts.add(touched_parts);
             });
-        }).then([this, tr_state, &details](std::vector<mutation> mutations) {
+        }).then([this, tr_state, &details, base_mutations](std::vector<mutation> mutations) {
+            merge_log_mutations(mutations, base_mutations);
             tracing::trace(tr_state, "CDC: Finished generating all log mutations");
             auto tracker = make_lw_shared<cdc::operation_result_tracker>(_ctxt._proxy.get_cdc_stats(), details);
             return make_ready_future<std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>>(std::make_tuple(std::move(mutations), std::move(tracker)));
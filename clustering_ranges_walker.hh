@@ -273,6 +273,17 @@ class clustering_ranges_walker {
         _tombstone = t;
     }
 
+    // Returns true if the row with the given key is the last position contained in the ranges,
+    // that is the current range is the last one and it ends inclusively at key.
+    // Nothing after such a row can be contained.
+    bool is_last_row(const clustering_key_prefix& key) const {
+        if (!_in_current || _current_range.size() != 1) {
+            return false;
+        }
+        auto& end = _current_range.front().end();
+        return end && end->is_inclusive() && end->value().is_full(_schema) && end->value().equal(_schema, key);
+    }
+
     // Returns true if advanced past all contained positions. Any later advance_to() until reset() will return false.
     bool out_of_range() const {
         return !_in_current && !_current_range;
@@ -33,6 +33,7 @@
 #include "sstables/sstables_manager.hh"
 #include "compaction.hh"
 #include "compaction_manager.hh"
+#include "purge_index.hh"
 #include "mutation_reader.hh"
 #include "schema.hh"
 #include "db/system_keyspace.hh"
@@ -67,6 +68,8 @@ static const std::unordered_map<compaction_type, sstring> compaction_types = {
     { compaction_type::Reshard, "RESHARD" },
     { compaction_type::Upgrade, "UPGRADE" },
     { compaction_type::Reshape, "RESHAPE" },
+    { compaction_type::GarbageCollection, "GARBAGE_COLLECTION" },
+    { compaction_type::Offload, "OFFLOAD" },
 };
 
 sstring compaction_name(compaction_type type) {
@@ -96,6 +99,8 @@ static std::string_view to_string(compaction_type type) {
     case compaction_type::Reshard: return "Reshard";
     case compaction_type::Upgrade: return "Upgrade";
     case compaction_type::Reshape: return "Reshape";
+    case compaction_type::GarbageCollection: return "Garbage_collect";
+    case compaction_type::Offload: return "Offload";
     }
     on_internal_error_noexcept(clogger, format("Invalid compaction type {}", int(type)));
     return "(invalid)";
@@ -162,12 +167,12 @@ std::ostream& operator<<(std::ostream& os, pretty_printed_throughput tp) {
 }
 
 static api::timestamp_type get_max_purgeable_timestamp(const table_state& table_s, sstable_set::incremental_selector& selector,
-        const std::unordered_set<shared_sstable>& compacting_set, const dht::decorated_key& dk) {
+        const purge_index& index, const std::unordered_set<shared_sstable>& compacting_set, const dht::decorated_key& dk) {
     auto timestamp = table_s.min_memtable_timestamp();
     std::optional<utils::hashed_key> hk;
-    for (auto&& sst : boost::range::join(selector.select(dk).sstables, table_s.compacted_undeleted_sstables())) {
-        if (compacting_set.contains(sst)) {
-            continue;
+    auto check = [&] (const shared_sstable& sst) {
+        if (compacting_set.contains(sst) || sst->get_stats_metadata().min_timestamp >= timestamp) {
+            return;
         }
         if (!hk) {
             hk = sstables::sstable::make_hashed_key(*table_s.schema(), dk.key());
@@ -175,6 +180,16 @@ static api::timestamp_type get_max_purgeable_timestamp(const table_state& table_
         if (sst->filter_has_key(*hk)) {
             timestamp = std::min(timestamp, sst->get_stats_metadata().min_timestamp);
         }
+    };
+    // The index holds all uncompacted sstables of the selector's set, so
+    // their filters need to be probed only if one of them could lower the timestamp.
+    if (index.min_timestamp(dk.token()) < timestamp) {
+        for (auto&& sst : selector.select(dk).sstables) {
+            check(sst);
+        }
+    }
+    for (auto&& sst : table_s.compacted_undeleted_sstables()) {
+        check(sst);
     }
     return timestamp;
 }
@@ -453,13 +468,20 @@ class compaction {
     // optional clone of sstable set to be used for expiration purposes, so it will be set if expiration is enabled.
     std::optional<sstable_set> _sstable_set;
     // used to incrementally calculate max purgeable timestamp, as we iterate through decorated keys.
-    std::optional<sstable_set::incremental_selector> _selector;
+    // Selectors have to be fed monotonic positions, so there is one for each reader created by
+    // max_purgeable_func().
+    std::vector<lw_shared_ptr<std::optional<sstable_set::incremental_selector>>> _selectors;
     std::unordered_set<shared_sstable> _compacting_for_max_purgeable_func;
+    // Minimum timestamps of the sstables of _sstable_set which are not in
+    // _compacting_for_max_purgeable_func, built by the first max_purgeable_func().
+    std::optional<purge_index> _purge_index;
     // Garbage collected sstables that are sealed but were not added to SSTable set yet.
     std::vector<shared_sstable> _unused_garbage_collected_sstables;
     // Garbage collected sstables that were added to SSTable set and should be eventually removed from it.
     std::vector<shared_sstable> _used_garbage_collected_sstables;
     utils::observable<> _stop_request_observable;
+    // Token sub-ranges compacted concurrently, see compaction_descriptor::sub_ranges.
+    dht::partition_range_vector _sub_ranges;
 private:
     compaction_data& init_compaction_data(compaction_data& cdata, const compaction_descriptor& descriptor) const {
         cdata.compaction_fan_in = descriptor.fan_in();
@@ -480,8 +502,8 @@ class compaction {
         , _run_identifier(descriptor.run_identifier)
         , _io_priority(descriptor.io_priority)
         , _sstable_set(std::move(descriptor.all_sstables_snapshot))
-        , _selector(_sstable_set ? _sstable_set->make_incremental_selector() : std::optional<sstable_set::incremental_selector>{})
         , _compacting_for_max_purgeable_func(std::unordered_set<shared_sstable>(_sstables.begin(), _sstables.end()))
+        , _sub_ranges(dht::to_partition_ranges(descriptor.sub_ranges))
     {
         for (auto& sst : _sstables) {
             _stats_collector.update(sst->get_encoding_stats_for_compaction());
@@ -495,7 +517,8 @@ class compaction {
     virtual uint64_t partitions_per_sstable() const {
         // some tests use _max_sstable_size == 0 for force many one partition per sstable
         auto max_sstable_size = std::max<uint64_t>(_max_sstable_size, 1);
-        uint64_t estimated_sstables = std::max(1UL, uint64_t(ceil(double(_start_size) / max_sstable_size)));
+        // Each sub-range writes sstables of its own.
+        uint64_t estimated_sstables = std::max<uint64_t>(sub_range_count(), ceil(double(_start_size) / max_sstable_size));
         return std::min(uint64_t(ceil(double(_estimated_partitions) / estimated_sstables)),
                         _table_s.get_compaction_strategy().adjust_partition_estimate(_ms_metadata, _estimated_partitions));
     }
@@ -607,7 +630,24 @@ class compaction {
     }
 private:
     // Default range sstable reader that will only return mutation that belongs to current shard.
-    virtual flat_mutation_reader_v2 make_sstable_reader() const = 0;
+    // Readers which don't support sub-ranges ignore the range and read everything.
+    virtual flat_mutation_reader_v2 make_sstable_reader(const dht::partition_range& range) const = 0;
+
+    // Whether the compaction can be split into the sub-ranges of the descriptor.
+    virtual bool supports_sub_ranges() const {
+        return false;
+    }
+
+    // Incremental replacement of exhausted sstables and the garbage collected writer
+    // depend on the output advancing through the token ring in order, so they rule
+    // out compacting the sub-ranges concurrently.
+    bool is_split_into_sub_ranges() const {
+        return _sub_ranges.size() > 1 && supports_sub_ranges() && !enable_garbage_collected_sstable_writer();
+    }
+
+    size_t sub_range_count() const {
+        return is_split_into_sub_ranges() ? _sub_ranges.size() : 1;
+    }
 
     virtual sstables::sstable_set make_sstable_set_for_input() const {
         return _table_s.get_compaction_strategy().make_sstable_set(_schema);
@@ -667,7 +707,7 @@ class compaction {
     // This consumer will perform mutation compaction on producer side using
     // compacting_reader. It's useful for allowing data from different buckets
     // to be compacted together.
-    future<> consume_without_gc_writer(gc_clock::time_point compaction_time) {
+    future<> consume_without_gc_writer(const dht::partition_range& range, gc_clock::time_point compaction_time) {
         auto consumer = make_interposer_consumer([this] (flat_mutation_reader_v2 reader) mutable {
             return seastar::async([this, reader = downgrade_to_v1(std::move(reader))] () mutable {
                 auto close_reader = deferred_close(reader);
@@ -675,16 +715,29 @@ class compaction {
                 reader.consume_in_thread(std::move(cfc));
             });
         });
-        return consumer(upgrade_to_v2(make_compacting_reader(make_sstable_reader(), compaction_time, max_purgeable_func())));
+        return consumer(upgrade_to_v2(make_compacting_reader(make_sstable_reader(range), compaction_time, max_purgeable_func())));
     }
 
+    // Runs one reader-to-writer pipeline for each sub-range, concurrently.
+    // The outputs of all pipelines share the run identifier, and since the
+    // sub-ranges are disjoint, they form a single sstable run.
     future<> consume() {
         auto now = gc_clock::now();
+        if (!is_split_into_sub_ranges()) {
+            return consume(query::full_partition_range, now);
+        }
+        log_debug("Compacting {} sub-ranges concurrently", _sub_ranges.size());
+        return parallel_for_each(_sub_ranges, [this, now] (const dht::partition_range& range) {
+            return consume(range, now);
+        });
+    }
+
+    future<> consume(const dht::partition_range& range, gc_clock::time_point now) {
         // consume_without_gc_writer(), which uses compacting_reader, is ~3% slower.
         // let's only use it when GC writer is disabled and interposer consumer is enabled, as we
         // wouldn't like others to pay the penalty for something they don't need.
         if (!enable_garbage_collected_sstable_writer() && use_interposer_consumer()) {
-            return consume_without_gc_writer(now);
+            return consume_without_gc_writer(range, now);
         }
         auto consumer = make_interposer_consumer([this, now] (flat_mutation_reader_v2 reader) mutable
         {
@@ -709,7 +762,7 @@ class compaction {
                 reader.consume_in_thread(std::move(cfc));
             });
         });
-        return consumer(make_sstable_reader());
+        return consumer(make_sstable_reader(range));
     }
 
     virtual reader_consumer_v2 make_interposer_consumer(reader_consumer_v2 end_consumer) {
@@ -752,14 +805,27 @@ class compaction {
     virtual std::string_view report_start_desc() const = 0;
     virtual std::string_view report_finish_desc() const = 0;
 
+    void build_purge_index() {
+        _purge_index.emplace();
+        _sstable_set->for_each_sstable([this] (const shared_sstable& sst) {
+            if (!_compacting_for_max_purgeable_func.contains(sst)) {
+                _purge_index->add(*sst);
+            }
+        });
+    }
+
     std::function<api::timestamp_type(const dht::decorated_key&)> max_purgeable_func() {
         if (!tombstone_expiration_enabled()) {
             return [] (const dht::decorated_key& dk) {
                 return api::min_timestamp;
             };
         }
-        return [this] (const dht::decorated_key& dk) {
-            return get_max_purgeable_timestamp(_table_s, *_selector, _compacting_for_max_purgeable_func, dk);
+        if (!_purge_index) {
+            build_purge_index();
+        }
+        auto selector = _selectors.emplace_back(make_lw_shared<std::optional<sstable_set::incremental_selector>>(_sstable_set->make_incremental_selector()));
+        return [this, selector = std::move(selector)] (const dht::decorated_key& dk) {
+            return get_max_purgeable_timestamp(_table_s, **selector, *_purge_index, _compacting_for_max_purgeable_func, dk);
         };
     }
 
@@ -891,10 +957,10 @@ class reshape_compaction : public compaction {
         return sstables::make_partitioned_sstable_set(_schema, make_lw_shared<sstable_list>(sstable_list{}), false);
     }
 
-    flat_mutation_reader_v2 make_sstable_reader() const override {
+    flat_mutation_reader_v2 make_sstable_reader(const dht::partition_range& range) const override {
         return _compacting->make_local_shard_sstable_reader(_schema,
                 _permit,
-                query::full_partition_range,
+                range,
                 _schema->full_slice(),
                 _io_priority,
                 tracing::trace_state_ptr(),
@@ -903,6 +969,10 @@ class reshape_compaction : public compaction {
                 default_read_monitor_generator());
     }
 
+    bool supports_sub_ranges() const override {
+        return true;
+    }
+
     std::string_view report_start_desc() const override {
         return "Reshaping";
     }
@@ -937,10 +1007,10 @@ class regular_compaction : public compaction {
     {
     }
 
-    flat_mutation_reader_v2 make_sstable_reader() const override {
+    flat_mutation_reader_v2 make_sstable_reader(const dht::partition_range& range) const override {
         return _compacting->make_local_shard_sstable_reader(_schema,
                 _permit,
-                query::full_partition_range,
+                range,
                 _schema->full_slice(),
                 _io_priority,
                 tracing::trace_state_ptr(),
@@ -949,6 +1019,10 @@ class regular_compaction : public compaction {
                 _monitor_generator);
     }
 
+    bool supports_sub_ranges() const override {
+        return true;
+    }
+
     std::string_view report_start_desc() const override {
         return "Compacting";
     }
@@ -999,7 +1073,9 @@ class regular_compaction : public compaction {
             // The goal is that exhausted sstables will be deleted as soon as possible,
             // so we need to release reference to them.
             std::for_each(exhausted, _sstables.end(), [this] (shared_sstable& sst) {
-                _compacting_for_max_purgeable_func.erase(sst);
+                if (_compacting_for_max_purgeable_func.erase(sst) && _purge_index) {
+                    _purge_index->add(*sst);
+                }
                 // Fully expired sstable is not actually compacted, therefore it's not present in the compacting set.
                 _compacting->erase(sst);
             });
@@ -1053,7 +1129,13 @@ class regular_compaction : public compaction {
                 _sstable_set->insert(sst);
             }
         }
-        _selector.emplace(_sstable_set->make_incremental_selector());
+        for (auto& selector : _selectors) {
+            selector->emplace(_sstable_set->make_incremental_selector());
+        }
+        // Entries can't be removed from the index, so it's rebuilt from the updated set.
+        if (_purge_index) {
+            build_purge_index();
+        }
         _cdata.pending_replacements.clear();
     }
 };
@@ -1132,8 +1214,8 @@ class cleanup_compaction final : public regular_compaction {
     cleanup_compaction(table_state& table_s, compaction_descriptor descriptor, compaction_data& cdata, compaction_type_options::upgrade opts)
         : cleanup_compaction(table_s, std::move(descriptor), cdata, std::move(opts.owned_ranges)) {}
 
-    flat_mutation_reader_v2 make_sstable_reader() const override {
-        return make_filtering_reader(regular_compaction::make_sstable_reader(), make_partition_filter());
+    flat_mutation_reader_v2 make_sstable_reader(const dht::partition_range& range) const override {
+        return make_filtering_reader(regular_compaction::make_sstable_reader(range), make_partition_filter());
     }
 
     std::string_view report_start_desc() const override {
@@ -1423,11 +1505,16 @@ class scrub_compaction final : public regular_compaction {
         return _scrub_finish_description;
     }
 
-    flat_mutation_reader_v2 make_sstable_reader() const override {
+    flat_mutation_reader_v2 make_sstable_reader(const dht::partition_range&) const override {
         auto crawling_reader = _compacting->make_crawling_reader(_schema, _permit, _io_priority, nullptr);
         return make_flat_mutation_reader_v2<reader>(std::move(crawling_reader), _options.operation_mode);
     }
 
+    // The crawling reader reads the sstables sequentially, disregarding ranges.
+    bool supports_sub_ranges() const override {
+        return false;
+    }
+
     uint64_t partitions_per_sstable() const override {
         const auto original_estimate = compaction::partitions_per_sstable();
         if (_bucket_count <= 1) {
@@ -1510,7 +1597,7 @@ class resharding_compaction final : public compaction {
     ~resharding_compaction() { }
 
     // Use reader that makes sure no non-local mutation will not be filtered out.
-    flat_mutation_reader_v2 make_sstable_reader() const override {
+    flat_mutation_reader_v2 make_sstable_reader(const dht::partition_range&) const override {
         return _compacting->make_range_sstable_reader(_schema,
                 _permit,
                 query::full_partition_range,
@@ -1585,6 +1672,8 @@ compaction_type compaction_type_options::type() const {
         compaction_type::Scrub,
         compaction_type::Reshard,
         compaction_type::Reshape,
+        compaction_type::GarbageCollection,
+        compaction_type::Offload,
     };
     static_assert(std::variant_size_v<compaction_type_options::options_variant> == std::size(index_to_type));
     return index_to_type[_options.index()];
@@ -1614,6 +1703,14 @@ static std::unique_ptr<compaction> make_compaction(table_state& table_s, sstable
         std::unique_ptr<compaction> operator()(compaction_type_options::scrub scrub_options) {
             return std::make_unique<scrub_compaction>(table_s, std::move(descriptor), cdata, scrub_options);
         }
+        std::unique_ptr<compaction> operator()(compaction_type_options::garbage_collection) {
+            // Purging is all regular compaction does to a single sstable.
+            return std::make_unique<regular_compaction>(table_s, std::move(descriptor), cdata);
+        }
+        std::unique_ptr<compaction> operator()(compaction_type_options::offload) {
+            // Only the location of the output differs, which is up to the creator.
+            return std::make_unique<regular_compaction>(table_s, std::move(descriptor), cdata);
+        }
     } visitor_factory{table_s, std::move(descriptor), cdata};
 
     return descriptor.options.visit(visitor_factory);
@@ -1782,6 +1879,51 @@ get_fully_expired_sstables(const table_state& table_s, const std::vector<sstable
     return candidates;
 }
 
+dht::token_range_vector split_into_sub_ranges(const std::vector<sstables::shared_sstable>& sstables, unsigned count) {
+    // Bounds the cost of sorting the samples of big sstables.
+    static constexpr size_t max_samples_per_sstable = 256;
+
+    // Summary entries sample the partitions evenly, so each sample taken
+    // from an sstable weighs an equal part of its data.
+    std::vector<std::pair<dht::token, double>> samples;
+    double total = 0;
+    for (auto& sst : sstables) {
+        auto& entries = sst->get_summary().entries;
+        if (entries.empty()) {
+            continue;
+        }
+        auto step = std::max<size_t>(1, entries.size() / max_samples_per_sstable);
+        auto weight = double(sst->data_size()) / ((entries.size() + step - 1) / step);
+        for (size_t i = 0; i < entries.size(); i += step) {
+            samples.emplace_back(entries[i].token, weight);
+            total += weight;
+        }
+    }
+    if (count <= 1 || samples.empty()) {
+        return {};
+    }
+    std::sort(samples.begin(), samples.end(), [] (const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    dht::token_range_vector ranges;
+    std::optional<dht::token_range::bound> start;
+    double accumulated = 0;
+    for (auto& [token, weight] : samples) {
+        accumulated += weight;
+        if (ranges.size() + 1 == count) {
+            break;
+        }
+        if (accumulated < total * (ranges.size() + 1) / count || (start && start->value() == token)) {
+            continue;
+        }
+        ranges.emplace_back(start, dht::token_range::bound(token, true));
+        start = dht::token_range::bound(token, false);
+    }
+    ranges.emplace_back(start, std::nullopt);
+    return ranges;
+}
+
 unsigned compaction_descriptor::fan_in() const {
     return boost::copy_range<std::unordered_set<utils::UUID>>(sstables | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::run_identifier))).size();
 }
@@ -94,6 +94,12 @@ future<compaction_result> compact_sstables(sstables::compaction_descriptor descr
 std::unordered_set<sstables::shared_sstable>
 get_fully_expired_sstables(const table_state& table_s, const std::vector<sstables::shared_sstable>& compacting, gc_clock::time_point gc_before);
 
+// Splits the token ring into at most count contiguous ranges, each holding
+// about the same amount of the data of the sstables, as estimated from their
+// summaries. Meant for compaction_descriptor::sub_ranges.
+// Returns an empty vector if count <= 1.
+dht::token_range_vector split_into_sub_ranges(const std::vector<sstables::shared_sstable>& sstables, unsigned count);
+
 // For tests, can drop after we virtualize sstables.
 flat_mutation_reader_v2 make_scrubbing_reader(flat_mutation_reader_v2 rd, compaction_type_options::scrub::mode scrub_mode);
 
@@ -31,6 +31,8 @@ enum class compaction_type {
     Reshard = 5,
     Upgrade = 6,
     Reshape = 7,
+    GarbageCollection = 8, // Rewrites each sstable on its own, only to purge expired data
+    Offload = 9, // Rewrites each cold sstable on its own into the cold storage directory
 };
 
 std::ostream& operator<<(std::ostream& os, compaction_type type);
@@ -79,8 +81,12 @@ class compaction_type_options {
     };
     struct reshape {
     };
+    struct garbage_collection {
+    };
+    struct offload {
+    };
 private:
-    using options_variant = std::variant<regular, cleanup, upgrade, scrub, reshard, reshape>;
+    using options_variant = std::variant<regular, cleanup, upgrade, scrub, reshard, reshape, garbage_collection, offload>;
 
 private:
     options_variant _options;
@@ -114,6 +120,14 @@ class compaction_type_options {
         return compaction_type_options(scrub{mode});
     }
 
+    static compaction_type_options make_garbage_collection() {
+        return compaction_type_options(garbage_collection{});
+    }
+
+    static compaction_type_options make_offload() {
+        return compaction_type_options(offload{});
+    }
+
     template <typename... Visitor>
     auto visit(Visitor&&... visitor) const {
         return std::visit(std::forward<Visitor>(visitor)..., _options);
@@ -159,6 +173,14 @@ struct compaction_descriptor {
     // Denotes if this compaction task is comprised solely of completely expired SSTables
     sstables::has_only_fully_expired has_only_fully_expired = has_only_fully_expired::no;
 
+    // If there is more than one, the compaction is split into concurrent compactions
+    // of these token ranges, whose output sstables form a single run. The ranges have
+    // to be disjoint and to cover the whole ring.
+    // Ignored by compactions which can't be split, e.g. scrub and resharding, and by
+    // incremental compaction, i.e. when compacting multi-fragment runs into sstables
+    // of limited size.
+    dht::token_range_vector sub_ranges;
+
     compaction_descriptor() = default;
 
     static constexpr int default_level = 0;
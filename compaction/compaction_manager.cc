@@ -14,12 +14,14 @@
 #include "replica/database.hh"
 #include <seastar/core/metrics.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/seastar.hh>
 #include "sstables/exceptions.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "utils/fb_utilities.hh"
 #include "utils/UUID_gen.hh"
 #include <cmath>
 #include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/range/adaptor/map.hpp>
 
 static logging::logger cmlog("compaction_manager");
 using namespace std::chrono_literals;
@@ -137,6 +139,29 @@ static inline int calculate_weight(const sstables::compaction_descriptor& descri
     return calculate_weight(boost::accumulate(descriptor.sstables | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0)));
 }
 
+// How much a compaction job is expected to reduce the read amplification of
+// its table, per byte it rewrites. Tables share the compaction bandwidth, so
+// it should go first to the jobs which spare reads the most sstable lookups.
+//
+// Merging fan_in sstables into one saves up to fan_in - 1 sstable lookups to
+// the reads which touch all of them. The share of the table's reads which do
+// is estimated from the number of sstables its reads touch on average, out of
+// its live sstables, and weighted by its recent read rate. Tables which aren't
+// read still compare by the reduction of their sstable count.
+static double compaction_priority(const replica::table& t, const sstables::compaction_descriptor& descriptor) {
+    auto fan_in = descriptor.fan_in();
+    if (fan_in <= 1) {
+        return 0;
+    }
+    auto& stats = t.get_stats();
+    double read_rate = stats.reads.met.rate().rates[0];
+    double sstables_per_read = stats.estimated_sstable_per_read.count() ? std::max(stats.estimated_sstable_per_read.mean(), int64_t(1)) : 1;
+    double reduction = sstables_per_read * (fan_in - 1) / std::max(uint64_t(stats.live_sstable_count), uint64_t(fan_in));
+    uint64_t input_size = boost::accumulate(descriptor.sstables | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0));
+    // Sizes are counted in MB, so tiny inputs don't get an outsized priority.
+    return (read_rate + 1) * reduction / (double(input_size) / (1024*1024) + 1);
+}
+
 unsigned compaction_manager::current_compaction_fan_in_threshold() const {
     if (_tasks.empty()) {
         return 0;
@@ -149,7 +174,7 @@ unsigned compaction_manager::current_compaction_fan_in_threshold() const {
     return std::min(unsigned(32), largest_fan_in);
 }
 
-bool compaction_manager::can_register_compaction(replica::table* t, int weight, unsigned fan_in) const {
+bool compaction_manager::can_register_compaction(replica::table* t, int weight, unsigned fan_in, double priority) const {
     // Only one weight is allowed if parallel compaction is disabled.
     if (!t->get_compaction_strategy().parallel_compaction() && has_table_ongoing_compaction(t)) {
         return false;
@@ -169,6 +194,14 @@ bool compaction_manager::can_register_compaction(replica::table* t, int weight,
     if (fan_in < current_compaction_fan_in_threshold()) {
         return false;
     }
+    // Leave the weight to a similar-sized job of another table which waits for it and is expected to do
+    // more for reads, unless that table cannot compact anyway until its ongoing compaction is done.
+    for (auto& [other, p] : _postponed) {
+        if (other != t && p.weight == weight && p.priority > priority
+                && (other->get_compaction_strategy().parallel_compaction() || !has_table_ongoing_compaction(other))) {
+            return false;
+        }
+    }
     return true;
 }
 
@@ -273,6 +306,7 @@ future<> compaction_manager::perform_major_compaction(replica::table* t) {
             // those are eligible for major compaction.
             sstables::compaction_strategy cs = t->get_compaction_strategy();
             sstables::compaction_descriptor descriptor = cs.get_major_compaction_job(t->as_table_state(), get_candidates(*t));
+            descriptor.sub_ranges = sstables::split_into_sub_ranges(descriptor.sstables, t->get_config().major_compaction_parallelism());
             auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
             descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted_sstables) {
                 compacting->release_compacting(exhausted_sstables);
@@ -478,7 +512,7 @@ void compaction_manager::register_metrics() {
 void compaction_manager::enable() {
     assert(_state == state::none || _state == state::disabled);
     _state = state::enabled;
-    _compaction_submission_timer.arm(periodic_compaction_submission_interval());
+    _compaction_submission_timer.arm_periodic(periodic_compaction_submission_interval());
     postponed_compactions_reevaluation();
 }
 
@@ -492,6 +526,16 @@ std::function<void()> compaction_manager::compaction_submission_callback() {
     return [this] () mutable {
         for (auto& e: _compaction_state) {
             submit(e.first);
+            auto* t = e.first;
+            if (!t->cold_dir().empty() && !t->async_gate().is_closed()) {
+                // In the background, under the table's gate, so that the table
+                // isn't stopped and destroyed while its sstables are offloaded.
+                (void)with_gate(t->async_gate(), [this, t] {
+                    return perform_offload(t);
+                }).handle_exception([s = t->schema()] (std::exception_ptr ep) {
+                    cmlog.warn("Offload of {}.{} failed: {}", s->ks_name(), s->cf_name(), ep);
+                });
+            }
         }
     };
 }
@@ -504,8 +548,14 @@ void compaction_manager::postponed_compactions_reevaluation() {
                 return stop_iteration::yes;
             }
             auto postponed = std::move(_postponed);
+            // Submit the tables whose jobs are expected to do the most for reads first, so they get
+            // the weights which were released.
+            auto tables = boost::copy_range<std::vector<replica::table*>>(postponed | boost::adaptors::map_keys);
+            std::ranges::sort(tables, std::greater<>(), [&postponed] (replica::table* t) {
+                return postponed.at(t).priority;
+            });
             try {
-                for (auto& t : postponed) {
+                for (auto& t : tables) {
                     submit(t);
                 }
             } catch (...) {
@@ -520,8 +570,8 @@ void compaction_manager::reevaluate_postponed_compactions() {
     _postponed_reevaluation.signal();
 }
 
-void compaction_manager::postpone_compaction_for_table(replica::table* t) {
-    _postponed.insert(t);
+void compaction_manager::postpone_compaction_for_table(replica::table* t, int weight, double priority) {
+    _postponed.insert_or_assign(t, postponed_compaction{weight, priority});
 }
 
 future<> compaction_manager::stop_tasks(std::vector<lw_shared_ptr<task>> tasks, sstring reason) {
@@ -675,11 +725,12 @@ void compaction_manager::submit(replica::table* t) {
                 _stats.pending_tasks--;
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
             }
-            if (!can_register_compaction(&t, weight, descriptor.fan_in())) {
+            double priority = compaction_priority(t, descriptor);
+            if (!can_register_compaction(&t, weight, descriptor.fan_in(), priority)) {
                 _stats.pending_tasks--;
-                cmlog.debug("Refused compaction job ({} sstable(s)) of weight {} for {}.{}, postponing it...",
-                    descriptor.sstables.size(), weight, t.schema()->ks_name(), t.schema()->cf_name());
-                postpone_compaction_for_table(&t);
+                cmlog.debug("Refused compaction job ({} sstable(s)) of weight {} and priority {} for {}.{}, postponing it...",
+                    descriptor.sstables.size(), weight, priority, t.schema()->ks_name(), t.schema()->cf_name());
+                postpone_compaction_for_table(&t, weight, priority);
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
             }
             auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
@@ -772,18 +823,22 @@ future<> compaction_manager::perform_offstrategy(replica::table* t) {
     return task->compaction_done.get_future().finally([task] {});
 }
 
-future<> compaction_manager::rewrite_sstables(replica::table* t, sstables::compaction_type_options options, get_candidates_func get_func, can_purge_tombstones can_purge) {
+future<> compaction_manager::rewrite_sstables(replica::table* t, sstables::compaction_type_options options, get_candidates_func get_func, can_purge_tombstones can_purge, size_t concurrency) {
     auto task = make_lw_shared<compaction_manager::task>(t, options.type(), get_compaction_state(t));
     _tasks.push_back(task);
     cmlog.debug("{} task {} table={}: started", options.type(), fmt::ptr(task.get()), fmt::ptr(task->compacting_table));
 
     std::vector<sstables::shared_sstable> sstables;
     std::optional<compacting_sstable_registration> compacting;
+    // Each of the concurrent rewrites runs in its own task, the first one being task.
+    std::vector<lw_shared_ptr<compaction_manager::task>> tasks = { task };
 
-    auto task_completion = defer([this, &task, &sstables, &options] {
+    auto task_completion = defer([this, &tasks, &sstables, &options] {
         _stats.pending_tasks -= sstables.size();
-        _tasks.remove(task);
-        cmlog.debug("{} task {} table={}: done", options.type(), fmt::ptr(task.get()), fmt::ptr(task->compacting_table));
+        for (auto& task : tasks) {
+            _tasks.remove(task);
+            cmlog.debug("{} task {} table={}: done", options.type(), fmt::ptr(task.get()), fmt::ptr(task->compacting_table));
+        }
     });
 
     // since we might potentially have ongoing compactions, and we
@@ -803,7 +858,7 @@ future<> compaction_manager::rewrite_sstables(replica::table* t, sstables::compa
 
     _stats.pending_tasks += sstables.size();
 
-    auto rewrite_sstable = [this, &task, &options, &compacting, can_purge] (const sstables::shared_sstable& sst) mutable -> future<>  {
+    auto rewrite_sstable = [this, &options, &compacting, can_purge, concurrency] (lw_shared_ptr<compaction_manager::task> task, const sstables::shared_sstable& sst) mutable -> future<>  {
         stop_iteration completed = stop_iteration::no;
         do {
             replica::table& t = *task->compacting_table;
@@ -819,9 +874,15 @@ future<> compaction_manager::rewrite_sstables(replica::table* t, sstables::compa
                 compacting->release_compacting(exhausted_sstables);
             };
 
-            auto maintenance_permit = co_await seastar::get_units(_maintenance_ops_sem, 1);
+            std::optional<seastar::semaphore_units<>> maintenance_permit;
+            if (concurrency == 1) {
+                maintenance_permit = co_await seastar::get_units(_maintenance_ops_sem, 1);
+            }
             // Take write lock for table to serialize cleanup/upgrade sstables/scrub with major compaction/reshape/reshard.
-            auto write_lock_holder = co_await _compaction_state[&t].lock.hold_write_lock();
+            // Concurrent rewrites cannot exclude each other, so they take the read lock, like regular compaction,
+            // which is enough to serialize them with major compaction/reshape/reshard, and they only touch the
+            // sstables they registered as compacting.
+            auto lock_holder = co_await (concurrency == 1 ? _compaction_state[&t].lock.hold_write_lock() : _compaction_state[&t].lock.hold_read_lock());
 
             _stats.pending_tasks--;
             _stats.active_tasks++;
@@ -859,12 +920,28 @@ future<> compaction_manager::rewrite_sstables(replica::table* t, sstables::compa
 
     shared_promise<> p;
     task->compaction_done = p.get_shared_future();
+    for (size_t i = 1; i < std::min(concurrency, sstables.size()); i++) {
+        auto extra = make_lw_shared<compaction_manager::task>(t, options.type(), get_compaction_state(t));
+        extra->compaction_done = p.get_shared_future();
+        _tasks.push_back(extra);
+        tasks.push_back(std::move(extra));
+    }
     try {
-        while (!sstables.empty() && can_proceed(task)) {
-            auto sst = sstables.back();
-            sstables.pop_back();
-            co_await rewrite_sstable(sst);
+        // Concurrent rewrites hold a single maintenance permit for the whole job.
+        std::optional<seastar::semaphore_units<>> maintenance_permit;
+        if (concurrency > 1) {
+            maintenance_permit = co_await seastar::get_units(_maintenance_ops_sem, 1);
         }
+        auto rewrite_sstables_in_task = [&] (lw_shared_ptr<compaction_manager::task> task) -> future<> {
+            while (!sstables.empty() && can_proceed(task)) {
+                auto sst = sstables.back();
+                sstables.pop_back();
+                co_await rewrite_sstable(task, sst);
+            }
+        };
+        co_await parallel_for_each(tasks, [&] (lw_shared_ptr<compaction_manager::task> task) {
+            return rewrite_sstables_in_task(std::move(task));
+        });
         p.set_value();
     } catch (...) {
         p.set_exception(std::current_exception());
@@ -1002,6 +1079,54 @@ future<> compaction_manager::perform_sstable_upgrade(replica::database& db, repl
     return rewrite_sstables(t, sstables::compaction_type_options::make_upgrade(db.get_keyspace_local_ranges(t->schema()->ks_name())), std::move(get_sstables));
 }
 
+// Returns false if the statistics of the sstable tell it has no tombstones
+// or expired cells which are old enough to be purged.
+static bool may_have_purgeable_data(const sstables::shared_sstable& sst, gc_clock::time_point compaction_time) {
+    auto gc_before = sst->get_gc_before_for_drop_estimation(compaction_time);
+    auto& stats = sst->get_stats_metadata();
+    if (sst->get_version() >= sstables::sstable_version_types::mc
+            && gc_clock::time_point(gc_clock::duration(stats.min_local_deletion_time)) >= gc_before) {
+        return false;
+    }
+    return sst->estimate_droppable_tombstone_ratio(gc_before) > 0;
+}
+
+future<> compaction_manager::perform_garbage_collection(replica::table* t) {
+    auto get_sstables = [this, t] {
+        auto compaction_time = gc_clock::now();
+        std::vector<sstables::shared_sstable> sstables;
+        for (auto& sst : get_candidates(*t)) {
+            if (may_have_purgeable_data(sst, compaction_time)) {
+                sstables.push_back(sst);
+            }
+        }
+        cmlog.debug("Garbage collection of {}.{}: {} sstables may have purgeable data", t->schema()->ks_name(), t->schema()->cf_name(), sstables.size());
+        return make_ready_future<std::vector<sstables::shared_sstable>>(std::move(sstables));
+    };
+    return rewrite_sstables(t, sstables::compaction_type_options::make_garbage_collection(), std::move(get_sstables),
+            can_purge_tombstones::yes, garbage_collection_concurrency);
+}
+
+future<> compaction_manager::perform_offload(replica::table* t) {
+    if (t->cold_dir().empty()) {
+        return make_ready_future<>();
+    }
+    auto get_sstables = [this, t] {
+        auto candidates = get_candidates(*t);
+        std::erase_if(candidates, std::mem_fn(&sstables::sstable::in_cold_storage));
+        auto sstables = t->get_compaction_strategy().get_cold_sstables(std::move(candidates), gc_clock::now());
+        cmlog.debug("Offload of {}.{}: {} sstables are cold", t->schema()->ks_name(), t->schema()->cf_name(), sstables.size());
+        if (sstables.empty()) {
+            return make_ready_future<std::vector<sstables::shared_sstable>>(std::move(sstables));
+        }
+        return recursive_touch_directory(t->cold_dir()).then([sstables = std::move(sstables)] () mutable {
+            return std::move(sstables);
+        });
+    };
+    return rewrite_sstables(t, sstables::compaction_type_options::make_offload(), std::move(get_sstables),
+            can_purge_tombstones::yes, offload_concurrency);
+}
+
 // Submit a table to be scrubbed and wait for its termination.
 future<> compaction_manager::perform_sstable_scrub(replica::table* t, sstables::compaction_type_options::scrub opts) {
     auto scrub_mode = opts.operation_mode;
@@ -135,8 +135,14 @@ class compaction_manager {
 
     future<> _waiting_reevalution = make_ready_future<>();
     condition_variable _postponed_reevaluation;
-    // tables that wait for compaction but had its submission postponed due to ongoing compaction.
-    std::unordered_set<replica::table*> _postponed;
+    struct postponed_compaction {
+        int weight;
+        // See compaction_priority().
+        double priority;
+    };
+    // tables that wait for compaction but had its submission postponed due to ongoing compaction,
+    // with the weight and priority of the job that was refused.
+    std::unordered_map<replica::table*, postponed_compaction> _postponed;
     // tracks taken weights of ongoing compactions, only one compaction per weight is allowed.
     // weight is value assigned to a compaction job that is log base N of total size of all input sstables.
     std::unordered_set<int> _weight_tracker;
@@ -169,7 +175,7 @@ class compaction_manager {
     unsigned current_compaction_fan_in_threshold() const;
 
     // Return true if compaction can be initiated
-    bool can_register_compaction(replica::table* t, int weight, unsigned fan_in) const;
+    bool can_register_compaction(replica::table* t, int weight, unsigned fan_in, double priority) const;
     // Register weight for a table. Do that only if can_register_weight()
     // returned true.
     void register_weight(int weight);
@@ -200,7 +206,7 @@ class compaction_manager {
     void reevaluate_postponed_compactions();
     // Postpone compaction for a table that couldn't be executed due to ongoing
     // similar-sized compaction.
-    void postpone_compaction_for_table(replica::table* t);
+    void postpone_compaction_for_table(replica::table* t, int weight, double priority);
 
     future<> perform_sstable_scrub_validate_mode(replica::table* t);
 
@@ -208,7 +214,10 @@ class compaction_manager {
     class can_purge_tombstones_tag;
     using can_purge_tombstones = bool_class<can_purge_tombstones_tag>;
 
-    future<> rewrite_sstables(replica::table* t, sstables::compaction_type_options options, get_candidates_func, can_purge_tombstones can_purge = can_purge_tombstones::yes);
+    // Rewrites the sstables returned by get_candidates_func one by one, each on its own.
+    // Up to concurrency sstables are rewritten at a time, each in its own task.
+    future<> rewrite_sstables(replica::table* t, sstables::compaction_type_options options, get_candidates_func, can_purge_tombstones can_purge = can_purge_tombstones::yes,
+            size_t concurrency = 1);
 public:
     compaction_manager(compaction_scheduling_group csg, maintenance_scheduling_group msg, size_t available_memory, abort_source& as);
     compaction_manager(compaction_scheduling_group csg, maintenance_scheduling_group msg, size_t available_memory, uint64_t shares, abort_source& as);
@@ -252,6 +261,26 @@ class compaction_manager {
     // Submit a table to be upgraded and wait for its termination.
     future<> perform_sstable_upgrade(replica::database& db, replica::table* t, bool exclude_current_version);
 
+    // Number of sstables rewritten at a time by garbage collection.
+    static constexpr size_t garbage_collection_concurrency = 4;
+
+    // Submit a table for garbage collection and wait for its termination.
+    // Every sstable of the table which may have purgeable data, according to its
+    // statistics, is rewritten on its own, without being merged with other sstables,
+    // dropping the expired data and the tombstones which can be purged.
+    future<> perform_garbage_collection(replica::table* t);
+
+    // Number of sstables rewritten at a time by offload. Like garbage collection, a
+    // concurrent rewrite only takes the table's read lock, so the slow writes to cold
+    // storage don't hold back regular compaction.
+    static constexpr size_t offload_concurrency = 2;
+
+    // Submit a table to offload its cold sstables and wait for its termination.
+    // Every sstable whose data is old enough, according to the compaction strategy,
+    // is rewritten on its own into the cold storage directory of the table.
+    // Also done periodically for the tables which have a cold storage directory.
+    future<> perform_offload(replica::table* t);
+
     // Submit a table to be scrubbed and wait for its termination.
     future<> perform_sstable_scrub(replica::table* t, sstables::compaction_type_options::scrub opts);
 
@@ -307,6 +336,13 @@ class compaction_manager {
         return _backlog_manager.backlog();
     }
 
+    // The backlog last computed by the compaction controller, normalized by the
+    // available memory like the controller does it. Cheap, so it can be checked on
+    // the write path. Stays at 0 if compaction shares are static.
+    double normalized_backlog() const noexcept {
+        return _last_backlog / _available_memory;
+    }
+
     void register_backlog_tracker(compaction_backlog_tracker& backlog_tracker) {
         _backlog_manager.register_backlog_tracker(backlog_tracker);
     }
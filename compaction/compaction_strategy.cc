@@ -26,6 +26,7 @@
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "backlog_controller.hh"
 #include "compaction_backlog_manager.hh"
 #include "size_tiered_backlog_tracker.hh"
@@ -643,10 +644,18 @@ reader_consumer_v2 compaction_strategy::make_interposer_consumer(const mutation_
     return _compaction_strategy_impl->make_interposer_consumer(ms_meta, std::move(end_consumer));
 }
 
+reader_consumer_v2 compaction_strategy::make_offstrategy_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) {
+    return _compaction_strategy_impl->make_offstrategy_interposer_consumer(ms_meta, std::move(end_consumer));
+}
+
 bool compaction_strategy::use_interposer_consumer() const {
     return _compaction_strategy_impl->use_interposer_consumer();
 }
 
+std::vector<shared_sstable> compaction_strategy::get_cold_sstables(std::vector<shared_sstable> candidates, gc_clock::time_point now) const {
+    return _compaction_strategy_impl->get_cold_sstables(std::move(candidates), now);
+}
+
 compaction_strategy make_compaction_strategy(compaction_strategy_type strategy, const std::map<sstring, sstring>& options) {
     ::shared_ptr<compaction_strategy_impl> impl;
 
@@ -666,6 +675,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
@@ -16,6 +16,7 @@
 #include "sstables/shared_sstable.hh"
 #include "exceptions/exceptions.hh"
 #include "compaction_strategy_type.hh"
+#include "gc_clock.hh"
 #include "flat_mutation_reader.hh"
 #include "table_state.hh"
 #include "strategy_control.hh"
@@ -74,6 +75,8 @@ class compaction_strategy {
             return "DateTieredCompactionStrategy";
         case compaction_strategy_type::time_window:
             return "TimeWindowCompactionStrategy";
+        case compaction_strategy_type::incremental:
+            return "IncrementalCompactionStrategy";
         default:
             throw std::runtime_error("Invalid Compaction Strategy");
         }
@@ -92,6 +95,8 @@ class compaction_strategy {
             return compaction_strategy_type::date_tiered;
         } else if (short_name == "TimeWindowCompactionStrategy") {
             return compaction_strategy_type::time_window;
+        } else if (short_name == "IncrementalCompactionStrategy") {
+            return compaction_strategy_type::incremental;
         } else {
             throw exceptions::configuration_exception(format("Unable to find compaction strategy class '{}'", name));
         }
@@ -111,6 +116,10 @@ class compaction_strategy {
 
     reader_consumer_v2 make_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer);
 
+    // Interposer for data written into the maintenance set, by streaming and repair
+    // with off-strategy compaction enabled.
+    reader_consumer_v2 make_offstrategy_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer);
+
     // Returns whether or not interposer consumer is used by a given strategy.
     bool use_interposer_consumer() const;
 
@@ -127,6 +136,9 @@ class compaction_strategy {
     // SSTables that can be added into a single job.
     compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode);
 
+    // Returns the sstables among candidates whose data is old enough to be
+    // moved to the cold storage directory, see compaction_type::Offload.
+    std::vector<shared_sstable> get_cold_sstables(std::vector<shared_sstable> candidates, gc_clock::time_point now) const;
 };
 
 // Creates a compaction_strategy object from one of the strategies available.
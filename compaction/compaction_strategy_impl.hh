@@ -69,10 +69,21 @@ class compaction_strategy_impl {
 
     virtual reader_consumer_v2 make_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer);
 
+    // Interposer for data written into the maintenance set, i.e. data that will go
+    // through off-strategy compaction. By default, data segregation is postponed to it.
+    virtual reader_consumer_v2 make_offstrategy_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) {
+        return end_consumer;
+    }
+
     virtual bool use_interposer_consumer() const {
         return false;
     }
 
     virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode);
+
+    // Sstables old enough to be offloaded to cold storage. None by default.
+    virtual std::vector<shared_sstable> get_cold_sstables(std::vector<shared_sstable> candidates, gc_clock::time_point now) const {
+        return {};
+    }
 };
 }
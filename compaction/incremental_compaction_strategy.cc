@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "incremental_compaction_strategy.hh"
+#include "sstables/sstables.hh"
+#include "exceptions/exceptions.hh"
+
+#include <cmath>
+
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/algorithm.hpp>
+#include <boost/range/numeric.hpp>
+
+namespace sstables {
+
+incremental_compaction_strategy_options::incremental_compaction_strategy_options(const std::map<sstring, sstring>& options) {
+    using namespace cql3::statements;
+
+    auto tmp_value = compaction_strategy_impl::get_value(options, FRAGMENT_SIZE_KEY);
+    auto fragment_size_in_mb = property_definitions::to_long(FRAGMENT_SIZE_KEY, tmp_value, DEFAULT_FRAGMENT_SIZE_IN_MB);
+    if (fragment_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} must be greater than 0, but was {}", FRAGMENT_SIZE_KEY, fragment_size_in_mb));
+    }
+    fragment_size = uint64_t(fragment_size_in_mb) * 1024 * 1024;
+
+    tmp_value = compaction_strategy_impl::get_value(options, SPACE_AMPLIFICATION_GOAL_KEY);
+    if (tmp_value) {
+        auto goal = property_definitions::to_double(SPACE_AMPLIFICATION_GOAL_KEY, tmp_value, 0);
+        if (goal <= 1) {
+            throw exceptions::configuration_exception(format("{} must be greater than 1, but was {}", SPACE_AMPLIFICATION_GOAL_KEY, goal));
+        }
+        space_amplification_goal = goal;
+    }
+}
+
+// The backlog of size-tiered compaction, see size_tiered_backlog_tracker, with runs
+// in place of sstables.
+//
+// Fragments are added and removed one at a time, so the tracker keeps the size of
+// every run and updates the contribution of a run whenever one of its fragments
+// comes or goes. Fragments being written count towards the run they will belong to.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    int64_t _total_bytes = 0;
+    double _runs_backlog_contribution = 0.0f;
+    std::unordered_map<utils::UUID, uint64_t> _run_sizes;
+
+    static double log4(double x) {
+        double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+
+    static double contribution(uint64_t run_size) {
+        return run_size ? run_size * log4(run_size) : 0;
+    }
+
+    uint64_t run_size(const utils::UUID& run_id) const {
+        auto it = _run_sizes.find(run_id);
+        return it != _run_sizes.end() ? it->second : 0;
+    }
+
+    void update_run(const utils::UUID& run_id, int64_t delta) {
+        auto& size = _run_sizes[run_id];
+        _runs_backlog_contribution -= contribution(size);
+        size += delta;
+        _runs_backlog_contribution += contribution(size);
+        _total_bytes += delta;
+        if (!size) {
+            _run_sizes.erase(run_id);
+        }
+    }
+public:
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
+        if (_total_bytes == 0) {
+            return 0;
+        }
+        std::unordered_map<utils::UUID, uint64_t> partial_runs;
+        for (auto const& swp : ow) {
+            partial_runs[swp.first->run_identifier()] += swp.second->written();
+        }
+        int64_t partial_bytes = 0;
+        double partial_contribution = 0;
+        for (auto& [run_id, written] : partial_runs) {
+            auto size = run_size(run_id);
+            partial_bytes += written;
+            partial_contribution += contribution(size + written) - contribution(size);
+        }
+        int64_t compacted_bytes = 0;
+        double compacted_contribution = 0;
+        for (auto const& crp : oc) {
+            auto compacted = crp.second->compacted();
+            compacted_bytes += compacted;
+            compacted_contribution += compacted * log4(std::max<uint64_t>(run_size(crp.first->run_identifier()), 1));
+        }
+
+        auto effective_total_size = _total_bytes + partial_bytes - compacted_bytes;
+        if (effective_total_size <= 0) {
+            return 0;
+        }
+        auto runs_contribution = _runs_backlog_contribution + partial_contribution - compacted_contribution;
+        auto b = (effective_total_size * log4(_total_bytes)) - runs_contribution;
+        return b > 0 ? b : 0;
+    }
+
+    virtual void add_sstable(sstables::shared_sstable sst) override {
+        if (sst->data_size() > 0) {
+            update_run(sst->run_identifier(), sst->data_size());
+        }
+    }
+
+    virtual void remove_sstable(sstables::shared_sstable sst) override {
+        if (sst->data_size() > 0) {
+            update_run(sst->run_identifier(), -int64_t(sst->data_size()));
+        }
+    }
+};
+
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _options(options)
+    , _stcs_options(options)
+    , _backlog_tracker(std::make_unique<incremental_backlog_tracker>())
+{}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::get_runs(const table_state& table_s, const std::vector<shared_sstable>& candidates) {
+    std::unordered_set<shared_sstable> candidate_set(candidates.begin(), candidates.end());
+    auto runs = table_s.get_sstable_set().select_sstable_runs(candidates);
+    // A run some of whose fragments are being compacted, or are not in the sstable set
+    // yet, is left for later.
+    std::erase_if(runs, [&] (const sstable_run& run) {
+        return boost::algorithm::any_of(run.all(), [&] (const shared_sstable& sst) {
+            return !candidate_set.contains(sst);
+        });
+    });
+    return runs;
+}
+
+std::vector<std::vector<sstable_run>>
+incremental_compaction_strategy::get_buckets(std::vector<sstable_run> runs) const {
+    std::vector<std::pair<sstable_run, uint64_t>> sorted_runs;
+    sorted_runs.reserve(runs.size());
+    for (auto& run : runs) {
+        auto size = run.data_size();
+        sorted_runs.emplace_back(std::move(run), size);
+    }
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
+        return i.second < j.second;
+    });
+
+    // Same as size_tiered_compaction_strategy::get_buckets(), see there.
+    std::vector<std::vector<sstable_run>> bucket_list;
+    std::vector<double> bucket_average_size_list;
+    std::vector<uint64_t> bucket_smallest_size_list;
+
+    for (auto& [run, size] : sorted_runs) {
+        if (!bucket_list.empty()) {
+            auto& bucket_average_size = bucket_average_size_list.back();
+
+            if ((size > (bucket_average_size * _stcs_options.bucket_low) && size < (bucket_average_size * _stcs_options.bucket_high)) ||
+                    (size < _stcs_options.min_sstable_size && bucket_average_size < _stcs_options.min_sstable_size)) {
+                auto& bucket = bucket_list.back();
+                auto total_size = bucket.size() * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                if (size < _stcs_options.min_sstable_size || bucket_smallest_size_list.back() > new_average_size * _stcs_options.bucket_low) {
+                    bucket.push_back(std::move(run));
+                    bucket_average_size = new_average_size;
+                    continue;
+                }
+            }
+        }
+
+        bucket_list.push_back({std::move(run)});
+        bucket_average_size_list.push_back(size);
+        bucket_smallest_size_list.push_back(size);
+    }
+
+    return bucket_list;
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold) {
+    std::vector<sstable_run>* most_interesting = nullptr;
+    for (auto& bucket : buckets) {
+        bucket.resize(std::min(bucket.size(), max_threshold));
+        if (bucket.size() >= min_threshold && (!most_interesting || bucket.size() > most_interesting->size())) {
+            most_interesting = &bucket;
+        }
+    }
+    return most_interesting ? std::move(*most_interesting) : std::vector<sstable_run>();
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::find_space_amplification_job(const std::vector<std::vector<sstable_run>>& buckets) const {
+    if (!_options.space_amplification_goal || buckets.size() < 2) {
+        return {};
+    }
+    auto bucket_size = [] (const std::vector<sstable_run>& bucket) {
+        return boost::accumulate(bucket | boost::adaptors::transformed(std::mem_fn(&sstable_run::data_size)), uint64_t(0));
+    };
+    uint64_t total_size = 0;
+    for (auto& bucket : buckets) {
+        total_size += bucket_size(bucket);
+    }
+    auto& largest = buckets.back();
+    auto& second_largest = buckets[buckets.size() - 2];
+    if (total_size <= *_options.space_amplification_goal * bucket_size(largest)) {
+        return {};
+    }
+    std::vector<sstable_run> runs = second_largest;
+    runs.insert(runs.end(), largest.begin(), largest.end());
+    return runs;
+}
+
+bool incremental_compaction_strategy::is_run_worth_dropping_tombstones(const sstable_run& run, gc_clock::time_point compaction_time) const {
+    if (_disable_tombstone_compaction || run.all().empty()) {
+        return false;
+    }
+    // See compaction_strategy_impl::worth_dropping_tombstones().
+    auto recently_written = boost::algorithm::any_of(run.all(), [this] (const shared_sstable& sst) {
+        return db_clock::now() - _tombstone_compaction_interval < sst->data_file_write_time();
+    });
+    if (recently_written) {
+        return false;
+    }
+    auto gc_before = (*run.all().begin())->get_gc_before_for_drop_estimation(compaction_time);
+    return run.estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::make_descriptor(table_state& table_s, const std::vector<sstable_run>& runs) const {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return sstables::compaction_descriptor(std::move(sstables), table_s.get_sstable_set(), service::get_local_compaction_priority(),
+            compaction_descriptor::default_level, _options.fragment_size);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto compaction_time = gc_clock::now();
+
+    auto buckets = get_buckets(get_runs(table_s, candidates));
+
+    if (auto runs = most_interesting_bucket(buckets, min_threshold, max_threshold); !runs.empty()) {
+        return make_descriptor(table_s, runs);
+    }
+
+    // If we are not enforcing min_threshold explicitly, try any pair of runs in the same tier.
+    if (!table_s.compaction_enforce_min_threshold()) {
+        if (auto runs = most_interesting_bucket(buckets, 2, max_threshold); !runs.empty()) {
+            return make_descriptor(table_s, runs);
+        }
+    }
+
+    if (auto runs = find_space_amplification_job(buckets); !runs.empty()) {
+        return make_descriptor(table_s, runs);
+    }
+
+    // Prefer runs of the largest tiers for tombstone compaction, as with STCS.
+    for (auto& bucket : buckets | boost::adaptors::reversed) {
+        for (auto& run : bucket) {
+            if (is_run_worth_dropping_tombstones(run, compaction_time)) {
+                return make_descriptor(table_s, {run});
+            }
+        }
+    }
+    return sstables::compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
+    return sstables::compaction_descriptor(std::move(candidates), table_s.get_sstable_set(), service::get_local_compaction_priority(),
+            compaction_descriptor::default_level, _options.fragment_size);
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto all_sstables = table_s.get_sstable_set().all();
+    auto buckets = get_buckets(table_s.get_sstable_set().select_sstable_runs(boost::copy_range<std::vector<shared_sstable>>(*all_sstables)));
+
+    int64_t n = 0;
+    for (auto& bucket : buckets) {
+        if (bucket.size() >= min_threshold) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    if (!find_space_amplification_job(buckets).empty()) {
+        n++;
+    }
+    return n;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+    // Off-strategy sstables (e.g. from streaming or a restart) are usually not part of runs,
+    // so reshape them as size-tiered does, but write runs of fragments.
+    auto desc = size_tiered_compaction_strategy(_stcs_options).get_reshaping_job(std::move(input), std::move(schema), iop, mode);
+    if (!desc.sstables.empty()) {
+        desc.max_sstable_bytes = _options.fragment_size;
+    }
+    return desc;
+}
+
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <map>
+
+#include <seastar/core/sstring.hh>
+
+#include "compaction_strategy_impl.hh"
+#include "compaction_backlog_manager.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstables/sstable_set.hh"
+#include "sstables/shared_sstable.hh"
+
+namespace sstables {
+
+class sstable_set_impl;
+
+class incremental_compaction_strategy_options {
+    static constexpr uint64_t DEFAULT_FRAGMENT_SIZE_IN_MB = 1000;
+    const sstring FRAGMENT_SIZE_KEY = "sstable_size_in_mb";
+    const sstring SPACE_AMPLIFICATION_GOAL_KEY = "space_amplification_goal";
+
+    // Maximum size of the fragments, i.e. sstables, of runs written by compaction.
+    uint64_t fragment_size = DEFAULT_FRAGMENT_SIZE_IN_MB * 1024 * 1024;
+    // If set, tiers are compacted together once the data would shrink by more than
+    // this factor if it was all compacted into the largest tier.
+    std::optional<double> space_amplification_goal;
+public:
+    incremental_compaction_strategy_options(const std::map<sstring, sstring>& options);
+
+    incremental_compaction_strategy_options() = default;
+
+    friend class incremental_compaction_strategy;
+};
+
+// Incremental compaction strategy is size-tiered compaction over sstable runs.
+//
+// Compaction writes its output as a run of fragments of at most sstable_size_in_mb,
+// and runs, rather than sstables, are bucketed into tiers of similar size. Since
+// the inputs of compactions are runs, the compaction releases every input fragment
+// as soon as the output has gone past its end, so the temporary space overhead of
+// a compaction is in the order of the fragment size times the number of input runs,
+// instead of the size of the entire input, the way it is with STCS.
+//
+// To bound space amplification, which under pure size-tiering can reach the number
+// of tiers, space_amplification_goal makes the strategy compact the two largest tiers
+// together whenever the total size of all tiers exceeds the goal times the size of
+// the largest tier.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    incremental_compaction_strategy_options _options;
+    size_tiered_compaction_strategy_options _stcs_options;
+    compaction_backlog_tracker _backlog_tracker;
+private:
+    // Returns the runs made only of sstables among candidates.
+    static std::vector<sstable_run> get_runs(const table_state& table_s, const std::vector<shared_sstable>& candidates);
+
+    // Groups runs of similar size into buckets, smallest runs first.
+    std::vector<std::vector<sstable_run>> get_buckets(std::vector<sstable_run> runs) const;
+
+    // Returns the bucket with the most runs, trimmed to max_threshold, if there is any with at least min_threshold runs.
+    static std::vector<sstable_run> most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold);
+
+    // Returns the runs of the two largest tiers, if they exceed the space amplification goal.
+    std::vector<sstable_run> find_space_amplification_job(const std::vector<std::vector<sstable_run>>& buckets) const;
+
+    bool is_run_worth_dropping_tombstones(const sstable_run& run, gc_clock::time_point compaction_time) const;
+
+    compaction_descriptor make_descriptor(table_state& table_s, const std::vector<sstable_run>& runs) const;
+public:
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual std::unique_ptr<sstable_set_impl> make_sstable_set(schema_ptr schema) const override;
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+
+    uint64_t fragment_size() const {
+        return _options.fragment_size;
+    }
+};
+
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "compaction/purge_index.hh"
+#include "sstables/sstables.hh"
+
+namespace sstables {
+
+std::map<purge_index::position, api::timestamp_type>::iterator purge_index::split(position pos) {
+    auto it = _segments.lower_bound(pos);
+    if (it != _segments.end() && it->first == pos) {
+        return it;
+    }
+    // The new segment starts off with the timestamp of the one it splits.
+    auto ts = it == _segments.begin() ? api::max_timestamp : std::prev(it)->second;
+    return _segments.emplace_hint(it, std::move(pos), ts);
+}
+
+void purge_index::add(const sstable& sst) {
+    auto ts = sst.get_stats_metadata().min_timestamp;
+    auto start = split(position(sst.get_first_decorated_key().token(), false));
+    auto end = split(position(sst.get_last_decorated_key().token(), true));
+    for (auto it = start; it != end; ++it) {
+        it->second = std::min(it->second, ts);
+    }
+}
+
+api::timestamp_type purge_index::min_timestamp(const dht::token& t) const {
+    auto it = _segments.upper_bound(position(t, false));
+    if (it == _segments.begin()) {
+        return api::max_timestamp;
+    }
+    return std::prev(it)->second;
+}
+
+}
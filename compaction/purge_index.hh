@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+#include <utility>
+
+#include "dht/token.hh"
+#include "timestamp.hh"
+#include "sstables/shared_sstable.hh"
+
+namespace sstables {
+
+// Maps token ranges to the minimum timestamp of the sstables which overlap them.
+//
+// Used by compaction to find out cheaply whether any sstable outside of the
+// compaction may hold data older than a tombstone: only if the minimum
+// timestamp for the partition is lower than what was already established
+// does the caller need to probe bloom filters to get the exact answer.
+// Lookups are by token, so the index is conservative: an sstable overlaps
+// all partitions of the tokens between its first and its last key.
+class purge_index {
+    // The position just before, or just after, all partitions of a token.
+    using position = std::pair<dht::token, bool>;
+    // Each entry holds the minimum timestamp from its position up to the
+    // position of the next entry. Positions which precede the first entry
+    // or follow the last one aren't overlapped by any sstable.
+    std::map<position, api::timestamp_type> _segments;
+private:
+    // Makes sure there is a segment starting at pos and returns it.
+    std::map<position, api::timestamp_type>::iterator split(position pos);
+public:
+    // Accounts for an sstable, until the index is destroyed.
+    void add(const sstable& sst);
+
+    // Returns the minimum timestamp of sstables overlapping the token,
+    // or api::max_timestamp if there is no such sstable.
+    api::timestamp_type min_timestamp(const dht::token& t) const;
+
+    bool empty() const noexcept {
+        return _segments.empty();
+    }
+};
+
+}
@@ -62,6 +62,18 @@ time_window_compaction_strategy_options::time_window_compaction_strategy_options
             timestamp_resolution = valid_timestamp_resolutions.at(it->second);
         }
     }
+
+    it = options.find(COLD_STORAGE_AFTER_SECONDS_KEY);
+    if (it != options.end()) {
+        try {
+            cold_storage_after = std::chrono::seconds(std::stol(it->second));
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(sstring("Invalid long value ") + it->second + " for " + COLD_STORAGE_AFTER_SECONDS_KEY);
+        }
+        if (cold_storage_after->count() <= 0) {
+            throw exceptions::configuration_exception(format("{} must be greater than 0, but was {}", COLD_STORAGE_AFTER_SECONDS_KEY, it->second));
+        }
+    }
 }
 
 time_window_compaction_strategy_options::time_window_compaction_strategy_options(time_window_compaction_strategy_options&&) = default;
@@ -212,6 +224,18 @@ time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
     return compaction_descriptor();
 }
 
+std::vector<shared_sstable>
+time_window_compaction_strategy::get_cold_sstables(std::vector<shared_sstable> candidates, gc_clock::time_point now) const {
+    if (!_options.cold_storage_after) {
+        return {};
+    }
+    auto cutoff = timestamp_type(std::chrono::duration_cast<std::chrono::microseconds>((now - *_options.cold_storage_after).time_since_epoch()).count());
+    std::erase_if(candidates, [this, cutoff] (const shared_sstable& sst) {
+        return to_timestamp_type(_options.timestamp_resolution, sst->get_stats_metadata().max_timestamp) >= cutoff;
+    });
+    return candidates;
+}
+
 compaction_descriptor
 time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidates) {
     auto compaction_time = gc_clock::now();
@@ -39,6 +39,7 @@ class time_window_compaction_strategy_options {
     static constexpr auto COMPACTION_WINDOW_UNIT_KEY = "compaction_window_unit";
     static constexpr auto COMPACTION_WINDOW_SIZE_KEY = "compaction_window_size";
     static constexpr auto EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS_KEY = "expired_sstable_check_frequency_seconds";
+    static constexpr auto COLD_STORAGE_AFTER_SECONDS_KEY = "cold_storage_after_seconds";
 private:
     const std::unordered_map<sstring, std::chrono::seconds> valid_window_units = { { "MINUTES", 60s }, { "HOURS", 3600s }, { "DAYS", 86400s } };
 
@@ -54,6 +55,8 @@ class time_window_compaction_strategy_options {
     std::chrono::seconds sstable_window_size = DEFAULT_COMPACTION_WINDOW_UNIT * DEFAULT_COMPACTION_WINDOW_SIZE;
     db_clock::duration expired_sstable_check_frequency = DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS();
     timestamp_resolutions timestamp_resolution = timestamp_resolutions::microsecond;
+    // Sstables whose newest data is older than this are offloaded to cold storage.
+    std::optional<std::chrono::seconds> cold_storage_after;
 public:
     time_window_compaction_strategy_options(const time_window_compaction_strategy_options&);
     time_window_compaction_strategy_options(time_window_compaction_strategy_options&&);
@@ -165,11 +168,21 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
 
     virtual reader_consumer_v2 make_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) override;
 
+    // Segregating by window on the first write keeps multi-window sstables out of the
+    // maintenance set, so off-strategy compaction only merges sstables within each
+    // window, rather than rewriting all data once to segregate it and then again to
+    // merge the sstables it produced.
+    virtual reader_consumer_v2 make_offstrategy_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) override {
+        return make_interposer_consumer(ms_meta, std::move(end_consumer));
+    }
+
     virtual bool use_interposer_consumer() const override {
         return true;
     }
 
     virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+
+    virtual std::vector<shared_sstable> get_cold_sstables(std::vector<shared_sstable> candidates, gc_clock::time_point now) const override;
 };
 
 }
@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <cstring>
+
 #include <lz4.h>
 #include <zlib.h>
 #include <snappy-c.h>
@@ -15,6 +17,38 @@
 
 const sstring compressor::namespace_prefix = "org.apache.cassandra.io.compress.";
 
+class lz4_dictionary : public compression_dictionary {
+    struct stream_deleter {
+        void operator()(LZ4_stream_t* s) const noexcept {
+            LZ4_freeStream(s);
+        }
+    };
+    // The compression state with the dictionary loaded. Loading a dictionary
+    // hashes all of it, so it's done once and the state is then copied for
+    // every chunk.
+    std::unique_ptr<LZ4_stream_t, stream_deleter> _stream;
+public:
+    explicit lz4_dictionary(bytes raw);
+
+    const LZ4_stream_t& stream() const {
+        return *_stream;
+    }
+};
+
+class lz4_dictionary_processor : public compressor {
+    std::shared_ptr<const lz4_dictionary> _dict;
+    // Scratch copy of the dictionary's stream, reset before every chunk.
+    std::unique_ptr<LZ4_stream_t> _stream;
+public:
+    lz4_dictionary_processor(sstring name, std::shared_ptr<const lz4_dictionary> dict);
+
+    size_t uncompress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress(const char* input, size_t input_len, char* output,
+                    size_t output_len) const override;
+    size_t compress_max_size(size_t input_len) const override;
+};
+
 class lz4_processor: public compressor {
 public:
     using compressor::compressor;
@@ -24,6 +58,10 @@ class lz4_processor: public compressor {
     size_t compress(const char* input, size_t input_len, char* output,
                     size_t output_len) const override;
     size_t compress_max_size(size_t input_len) const override;
+
+    bool supports_dictionaries() const override;
+    compression_dictionary_ptr prepare_dictionary(bytes raw) const override;
+    compressor_ptr with_dictionary(compression_dictionary_ptr dict) const override;
 };
 
 class snappy_processor: public compressor {
@@ -60,6 +98,18 @@ std::map<sstring, sstring> compressor::options() const {
     return {};
 }
 
+bool compressor::supports_dictionaries() const {
+    return false;
+}
+
+compression_dictionary_ptr compressor::prepare_dictionary(bytes raw) const {
+    throw std::logic_error(format("{} does not support dictionaries", name()));
+}
+
+compressor_ptr compressor::with_dictionary(compression_dictionary_ptr dict) const {
+    throw std::logic_error(format("{} does not support dictionaries", name()));
+}
+
 compressor::ptr_type compressor::create(const sstring& name, const opt_getter& opts) {
     if (name.empty()) {
         return {};
@@ -249,6 +299,77 @@ size_t lz4_processor::compress_max_size(size_t input_len) const {
     return LZ4_COMPRESSBOUND(input_len) + 4;
 }
 
+bool lz4_processor::supports_dictionaries() const {
+    return true;
+}
+
+compression_dictionary_ptr lz4_processor::prepare_dictionary(bytes raw) const {
+    return std::make_shared<const lz4_dictionary>(std::move(raw));
+}
+
+compressor_ptr lz4_processor::with_dictionary(compression_dictionary_ptr dict) const {
+    auto d = std::dynamic_pointer_cast<const lz4_dictionary>(std::move(dict));
+    if (!d) {
+        throw std::invalid_argument("LZ4 compressor requires a dictionary prepared by LZ4");
+    }
+    return ::make_shared<lz4_dictionary_processor>(name(), std::move(d));
+}
+
+lz4_dictionary::lz4_dictionary(bytes raw)
+    : compression_dictionary(std::move(raw))
+    , _stream(LZ4_createStream())
+{
+    if (!_stream) {
+        throw std::bad_alloc();
+    }
+    // LZ4 only looks at the last 64KB of the dictionary.
+    LZ4_loadDict(_stream.get(), reinterpret_cast<const char*>(this->raw().data()), this->raw().size());
+}
+
+lz4_dictionary_processor::lz4_dictionary_processor(sstring name, std::shared_ptr<const lz4_dictionary> dict)
+    : compressor(std::move(name))
+    , _dict(std::move(dict))
+    , _stream(std::make_unique<LZ4_stream_t>())
+{}
+
+size_t lz4_dictionary_processor::uncompress(const char* input, size_t input_len,
+                char* output, size_t output_len) const {
+    // Same framing as lz4_processor: skip the 4-byte uncompressed length.
+    input += 4;
+    input_len -= 4;
+
+    auto dict = _dict->raw();
+    auto ret = LZ4_decompress_safe_usingDict(input, output, input_len, output_len,
+            reinterpret_cast<const char*>(dict.data()), dict.size());
+    if (ret < 0) {
+        throw std::runtime_error("LZ4 uncompression failure");
+    }
+    return ret;
+}
+
+size_t lz4_dictionary_processor::compress(const char* input, size_t input_len,
+                char* output, size_t output_len) const {
+    if (output_len < LZ4_COMPRESSBOUND(input_len) + 4) {
+        throw std::runtime_error("LZ4 compression failure: length of output is too small");
+    }
+    output[0] = input_len & 0xFF;
+    output[1] = (input_len >> 8) & 0xFF;
+    output[2] = (input_len >> 16) & 0xFF;
+    output[3] = (input_len >> 24) & 0xFF;
+    // Every chunk is compressed independently against the dictionary only,
+    // so start from a fresh copy of the dictionary's state.
+    std::memcpy(_stream.get(), &_dict->stream(), sizeof(LZ4_stream_t));
+    auto ret = LZ4_compress_fast_continue(_stream.get(), input, output + 4, input_len, LZ4_compressBound(input_len), 1);
+    if (ret == 0) {
+        throw std::runtime_error("LZ4 compression failure: LZ4_compress_fast_continue() failed");
+    }
+    return ret + 4;
+}
+
+size_t lz4_dictionary_processor::compress_max_size(size_t input_len) const {
+    return LZ4_COMPRESSBOUND(input_len) + 4;
+}
+
 size_t deflate_processor::uncompress(const char* input,
                 size_t input_len, char* output, size_t output_len) const {
     z_stream zs;
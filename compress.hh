@@ -9,13 +9,38 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
 
 #include "exceptions/exceptions.hh"
+#include "bytes.hh"
+
+/**
+ * A dictionary trained on samples of the data, shared by all chunks
+ * compressed with it. It lets small chunks compress almost as well as
+ * large ones.
+ *
+ * Instances are created by compressor::prepare_dictionary(), which digests
+ * the raw dictionary into whatever form the algorithm needs. They are
+ * immutable, so a single instance can be used from all shards.
+ */
+class compression_dictionary {
+    bytes _raw;
+public:
+    explicit compression_dictionary(bytes raw) : _raw(std::move(raw)) {}
+    virtual ~compression_dictionary() {}
+
+    bytes_view raw() const {
+        return _raw;
+    }
+};
+
+using compression_dictionary_ptr = std::shared_ptr<const compression_dictionary>;
 
 
 class compressor {
@@ -51,6 +76,29 @@ class compressor {
      */
     virtual std::map<sstring, sstring> options() const;
 
+    /**
+     * Returns true if the compressor can compress with a dictionary.
+     */
+    virtual bool supports_dictionaries() const;
+    /**
+     * Digests a raw dictionary (see train_dictionary()) for use with this
+     * compressor. Must only be called if supports_dictionaries().
+     */
+    virtual compression_dictionary_ptr prepare_dictionary(bytes raw) const;
+    /**
+     * Returns a compressor with the same options which compresses and
+     * uncompresses using the dictionary. The dictionary must have been
+     * prepared by a compressor of the same class.
+     */
+    virtual shared_ptr<compressor> with_dictionary(compression_dictionary_ptr dict) const;
+
+    /**
+     * Trains a dictionary of at most max_size bytes from the samples.
+     * Returns an empty dictionary if the samples are too few or too small
+     * to train a useful one.
+     */
+    static bytes train_dictionary(const std::vector<bytes_view>& samples, size_t max_size);
+
     /**
      * Compressor class name.
      */
@@ -367,9 +367,11 @@ scylla_tests = set([
     'test/boost/auth_test',
     'test/boost/batchlog_manager_test',
     'test/boost/big_decimal_test',
+    'test/boost/bloom_filter_test',
     'test/boost/broken_sstable_test',
     'test/boost/bytes_ostream_test',
     'test/boost/cache_flat_mutation_reader_test',
+    'test/boost/cache_saver_test',
     'test/boost/cached_file_test',
     'test/boost/caching_options_test',
     'test/boost/canonical_mutation_test',
@@ -391,6 +393,8 @@ scylla_tests = set([
     'test/boost/cql_auth_query_test',
     'test/boost/cql_auth_syntax_test',
     'test/boost/cql_query_test',
+    'test/boost/cql_segment_test',
+    'test/boost/cql_fast_parser_test',
     'test/boost/cql_query_large_test',
     'test/boost/cql_query_like_test',
     'test/boost/cql_query_group_test',
@@ -398,6 +402,7 @@ scylla_tests = set([
     'test/boost/crc_test',
     'test/boost/data_listeners_test',
     'test/boost/database_test',
+    'test/boost/direct_failure_detector_test',
     'test/boost/double_decker_test',
     'test/boost/duration_test',
     'test/boost/dynamic_bitset_test',
@@ -405,9 +410,11 @@ scylla_tests = set([
     'test/boost/enum_set_test',
     'test/boost/extensions_test',
     'test/boost/error_injection_test',
+    'test/boost/failure_detector_test',
     'test/boost/filtering_test',
     'test/boost/flat_mutation_reader_test',
     'test/boost/flush_queue_test',
+    'test/boost/forward_request_test',
     'test/boost/fragmented_temporary_buffer_test',
     'test/boost/frozen_mutation_test',
     'test/boost/gossiping_property_file_snitch_test',
@@ -427,6 +434,7 @@ scylla_tests = set([
     'test/boost/log_heap_test',
     'test/boost/estimated_histogram_test',
     'test/boost/logalloc_test',
+    'test/boost/lru_test',
     'test/boost/managed_vector_test',
     'test/boost/managed_bytes_test',
     'test/boost/intrusive_array_test',
@@ -449,7 +457,10 @@ scylla_tests = set([
     'test/boost/query_processor_test',
     'test/boost/range_test',
     'test/boost/range_tombstone_list_test',
+    'test/boost/repair_range_hash_cache_test',
     'test/boost/reusable_buffer_test',
+    'test/boost/replica_scorer_test',
+    'test/boost/rpc_dictionary_compressor_test',
     'test/boost/restrictions_test',
     'test/boost/role_manager_test',
     'test/boost/row_cache_test',
@@ -475,6 +486,7 @@ scylla_tests = set([
     'test/boost/sstable_move_test',
     'test/boost/statement_restrictions_test',
     'test/boost/storage_proxy_test',
+    'test/boost/stream_sstable_files_test',
     'test/boost/top_k_test',
     'test/boost/transport_test',
     'test/boost/types_test',
@@ -486,6 +498,7 @@ scylla_tests = set([
     'test/boost/view_schema_test',
     'test/boost/view_schema_pkey_test',
     'test/boost/view_schema_ckey_test',
+    'test/boost/view_update_coalescer_test',
     'test/boost/vint_serialization_test',
     'test/boost/virtual_reader_test',
     'test/boost/virtual_table_mutation_source_test',
@@ -516,6 +529,8 @@ scylla_tests = set([
     'test/manual/sstable_scan_footprint_test',
     'test/perf/memory_footprint_test',
     'test/perf/perf_cache_eviction',
+    'test/perf/perf_commitlog',
+    'test/perf/perf_cql_filtering',
     'test/perf/perf_cql_parser',
     'test/perf/perf_fast_forward',
     'test/perf/perf_hash',
@@ -545,6 +560,7 @@ perf_tests = set([
     'test/perf/perf_mutation_fragment',
     'test/perf/perf_idl',
     'test/perf/perf_vint',
+    'test/perf/perf_coordinator',
     'test/perf/perf_big_decimal',
 ])
 
@@ -662,6 +678,7 @@ scylla_raft_core = [
 scylla_core = (['replica/database.cc',
                 'replica/table.cc',
                 'replica/distributed_loader.cc',
+                'replica/sstable_placement.cc',
                 'absl-flat_hash_map.cc',
                 'atomic_cell.cc',
                 'caching_options.cc',
@@ -684,7 +701,9 @@ scylla_core = (['replica/database.cc',
                 'generic_server.cc',
                 'utils/array-search.cc',
                 'utils/base64.cc',
+                'utils/alien_worker.cc',
                 'utils/logalloc.cc',
+                'utils/cpu_profiler.cc',
                 'utils/large_bitset.cc',
                 'utils/buffer_input_stream.cc',
                 'utils/limiting_data_source.cc',
@@ -692,6 +711,7 @@ scylla_core = (['replica/database.cc',
                 'utils/directories.cc',
                 'utils/generation-number.cc',
                 'utils/rjson.cc',
+                'utils/spill_file.cc',
                 'utils/human_readable.cc',
                 'mutation_partition.cc',
                 'mutation_partition_view.cc',
@@ -701,12 +721,16 @@ scylla_core = (['replica/database.cc',
                 'flat_mutation_reader.cc',
                 'mutation_query.cc',
                 'keys.cc',
+                'byte_comparable.cc',
                 'counters.cc',
                 'compress.cc',
                 'zstd.cc',
                 'sstables/sstables.cc',
+                'sstables/component_io_stats.cc',
+                'sstables/read_ahead.cc',
                 'sstables/sstables_manager.cc',
                 'sstables/sstable_set.cc',
+                'sstables/sstable_segment.cc',
                 'sstables/mx/partition_reversing_data_source.cc',
                 'sstables/mx/reader.cc',
                 'sstables/mx/writer.cc',
@@ -719,6 +743,8 @@ scylla_core = (['replica/database.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
                 'compaction/time_window_compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
+                'compaction/purge_index.cc',
                 'compaction/compaction_manager.cc',
                 'sstables/integrity_checked_file_impl.cc',
                 'sstables/prepended_input_stream.cc',
@@ -730,6 +756,7 @@ scylla_core = (['replica/database.cc',
                 'transport/cql_protocol_extension.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
+                'transport/segment.cc',
                 'transport/server.cc',
                 'transport/controller.cc',
                 'transport/messages/result_message.cc',
@@ -751,7 +778,9 @@ scylla_core = (['replica/database.cc',
                 'cql3/maps.cc',
                 'cql3/values.cc',
                 'cql3/expr/expression.cc',
+                'cql3/expr/compiled_restriction.cc',
                 'cql3/expr/prepare_expr.cc',
+                'cql3/fast_parser.cc',
                 'cql3/functions/user_function.cc',
                 'cql3/functions/functions.cc',
                 'cql3/functions/aggregate_fcts.cc',
@@ -899,6 +928,7 @@ scylla_core = (['replica/database.cc',
                 'gms/gossiper.cc',
                 'gms/feature_service.cc',
                 'gms/failure_detector.cc',
+                'gms/direct_failure_detector.cc',
                 'gms/gossip_digest_syn.cc',
                 'gms/gossip_digest_ack.cc',
                 'gms/gossip_digest_ack2.cc',
@@ -929,12 +959,15 @@ scylla_core = (['replica/database.cc',
                 'locator/ec2_multi_region_snitch.cc',
                 'locator/gce_snitch.cc',
                 'message/messaging_service.cc',
+                'message/dictionary_compressor.cc',
                 'service/client_state.cc',
                 'service/storage_service.cc',
                 'service/misc_services.cc',
+                'service/cache_saver.cc',
                 'service/pager/paging_state.cc',
                 'service/pager/query_pagers.cc',
                 'service/qos/qos_common.cc',
+                'service/qos/request_admission_controller.cc',
                 'service/qos/service_level_controller.cc',
                 'service/qos/standard_service_level_distributed_data_accessor.cc',
                 'streaming/stream_task.cc',
@@ -1069,6 +1102,7 @@ alternator = [
        'alternator/conditions.cc',
        'alternator/auth.cc',
        'alternator/streams.cc',
+       'alternator/change_buffer.cc',
        'alternator/ttl.cc',
 ]
 
@@ -1146,7 +1180,7 @@ scylla_tests_dependencies = scylla_core + idls + scylla_tests_generic_dependenci
 
 scylla_raft_dependencies = scylla_raft_core + ['utils/uuid.cc']
 
-scylla_tools = ['tools/scylla-types.cc', 'tools/scylla-sstable.cc', 'tools/schema_loader.cc', 'tools/utils.cc']
+scylla_tools = ['tools/scylla-types.cc', 'tools/scylla-sstable.cc', 'tools/scylla-compaction-simulator.cc', 'tools/schema_loader.cc', 'tools/utils.cc']
 
 deps = {
     'scylla': idls + ['main.cc'] + scylla_core + api + alternator + redis + scylla_tools,
@@ -1195,6 +1229,7 @@ tests_not_using_seastar_test_framework = set([
     'test/manual/message',
     'test/perf/memory_footprint_test',
     'test/perf/perf_cache_eviction',
+    'test/perf/perf_commitlog',
     'test/perf/perf_cql_parser',
     'test/perf/perf_hash',
     'test/perf/perf_mutation',
@@ -1257,6 +1292,8 @@ deps['test/perf/perf_fast_forward'] += ['test/perf/linux-perf-event.cc']
 deps['test/perf/perf_simple_query'] += ['test/perf/perf.cc', 'test/perf/linux-perf-event.cc', 'test/lib/alternator_test_env.cc'] + alternator
 deps['test/perf/perf_row_cache_reads'] += ['test/perf/perf.cc', 'test/perf/linux-perf-event.cc']
 deps['test/perf/perf_row_cache_update'] += ['test/perf/perf.cc', 'test/perf/linux-perf-event.cc']
+deps['test/perf/perf_sstable'] += ['test/perf/perf.cc', 'test/perf/linux-perf-event.cc']
+deps['test/perf/perf_commitlog'] += ['test/perf/perf.cc', 'test/perf/linux-perf-event.cc']
 deps['test/boost/reusable_buffer_test'] = [
     "test/boost/reusable_buffer_test.cc",
     "test/lib/log.cc",
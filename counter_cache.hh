@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <boost/intrusive/list.hpp>
+
+#include "counters.hh"
+#include "frozen_mutation.hh"
+#include "mutation.hh"
+#include "mutation_partition_view.hh"
+
+// Shared by the counter caches of all the tables of a shard.
+struct counter_cache_stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    // The memory used by all the counter caches of the shard, which is what
+    // their memory budget bounds.
+    size_t memory_usage = 0;
+};
+
+// Keeps the local shards of recently updated counter cells, so that a counter
+// update whose cells are all cached doesn't have to read them before writing.
+//
+// Only the counter update path of this node modifies the local shards, and it
+// does so holding the cell locks, during which it keeps the cache up to date.
+// Anything else which changes what reading a local shard would return
+// (deletions, sstables brought in from outside, truncation, schema changes)
+// has to invalidate the cache. An update which started before an
+// invalidation isn't allowed to populate the cache, see generation().
+class counter_cache {
+    struct cell_entry {
+        std::optional<clustering_key> ck; // Disengaged for static cells.
+        column_id id;
+        counter_shard shard;
+    };
+
+    struct partition_entry {
+        boost::intrusive::list_member_hook<> lru_link;
+        const dht::decorated_key* key = nullptr;
+        std::vector<cell_entry> cells;
+        size_t memory = 0;
+    };
+
+    using lru_type = boost::intrusive::list<partition_entry,
+            boost::intrusive::member_hook<partition_entry, boost::intrusive::list_member_hook<>, &partition_entry::lru_link>,
+            boost::intrusive::constant_time_size<false>>;
+    using partitions_type = std::unordered_map<dht::decorated_key, partition_entry,
+            std::hash<dht::decorated_key>, dht::decorated_key_equals_comparator>;
+
+    static constexpr size_t max_cells_per_partition = 128;
+    static constexpr size_t partition_overhead = sizeof(partitions_type::value_type) + 2 * sizeof(void*);
+
+    // The partition map's equality comparator keeps a reference to the
+    // original schema, we must ensure that it doesn't die.
+    schema_ptr _original_schema;
+    partitions_type _partitions;
+    lru_type _lru;
+    size_t _memory = 0;
+    size_t _max_memory;
+    uint64_t _generation = 0;
+    counter_cache_stats& _stats;
+private:
+    static size_t memory_of(const cell_entry& ce) {
+        return sizeof(cell_entry) + (ce.ck ? ce.ck->representation().size() : 0);
+    }
+
+    template<typename Func>
+    static void for_each_live_cell(const schema& s, const mutation_partition& mp, Func&& func) {
+        mp.static_row().for_each_cell([&] (column_id id, const atomic_cell_or_collection& ac_o_c) {
+            auto acv = ac_o_c.as_atomic_cell(s.static_column_at(id));
+            if (acv.is_live()) {
+                func(nullptr, id, acv);
+            }
+        });
+        for (auto&& cr : mp.clustered_rows()) {
+            cr.row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& ac_o_c) {
+                auto acv = ac_o_c.as_atomic_cell(s.regular_column_at(id));
+                if (acv.is_live()) {
+                    func(&cr.key(), id, acv);
+                }
+            });
+        }
+    }
+
+    cell_entry* find_cell(partition_entry& pe, const clustering_key* ck, column_id id, const schema& s) {
+        clustering_key::equality eq(s);
+        for (auto& ce : pe.cells) {
+            if (ce.id == id && bool(ce.ck) == bool(ck) && (!ck || eq(*ce.ck, *ck))) {
+                return &ce;
+            }
+        }
+        return nullptr;
+    }
+
+    void add_memory(ssize_t delta) {
+        _memory += delta;
+        _stats.memory_usage += delta;
+    }
+
+    void erase(partitions_type::iterator it) {
+        add_memory(-ssize_t(it->second.memory));
+        _lru.erase(_lru.iterator_to(it->second));
+        _partitions.erase(it);
+    }
+
+    // Once the counter caches of the shard exceed their budget, the cache
+    // which grows evicts its own least recently used partitions.
+    void evict() {
+        while (_stats.memory_usage > _max_memory && !_lru.empty()) {
+            erase(_partitions.find(*_lru.back().key));
+            ++_stats.evictions;
+        }
+    }
+public:
+    // max_memory is the budget of all the counter caches sharing stats.
+    counter_cache(schema_ptr s, size_t max_memory, counter_cache_stats& stats)
+        : _original_schema(std::move(s))
+        , _partitions(0, std::hash<dht::decorated_key>(), dht::decorated_key_equals_comparator(*_original_schema))
+        , _max_memory(max_memory)
+        , _stats(stats)
+    { }
+
+    counter_cache(const counter_cache&) = delete;
+    counter_cache& operator=(const counter_cache&) = delete;
+
+    ~counter_cache() {
+        clear();
+    }
+
+    // Changes whenever the cache is invalidated. An update has to pass the
+    // generation read before it looked at the cache or read the counters to
+    // update().
+    uint64_t generation() const {
+        return _generation;
+    }
+
+    size_t memory_usage() const {
+        return _memory;
+    }
+
+    static bool has_tombstones(const mutation& m) {
+        auto& s = *m.schema();
+        auto& mp = m.partition();
+        if (mp.partition_tombstone() || !mp.row_tombstones().empty()) {
+            return true;
+        }
+        bool found = false;
+        mp.static_row().for_each_cell([&] (column_id id, const atomic_cell_or_collection& ac_o_c) {
+            found |= !ac_o_c.as_atomic_cell(s.static_column_at(id)).is_live();
+        });
+        for (auto&& cr : mp.clustered_rows()) {
+            found |= bool(cr.row().deleted_at());
+            cr.row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& ac_o_c) {
+                found |= !ac_o_c.as_atomic_cell(s.regular_column_at(id)).is_live();
+            });
+        }
+        return found;
+    }
+
+    static bool has_tombstones(const frozen_mutation& fm, const schema& s) {
+        struct visitor final : public mutation_partition_view_virtual_visitor {
+            bool found = false;
+            virtual void accept_partition_tombstone(tombstone t) override { found |= bool(t); }
+            virtual void accept_static_cell(column_id, atomic_cell ac) override { found |= !ac.is_live(); }
+            virtual void accept_static_cell(column_id, collection_mutation_view) override { }
+            virtual void accept_row_tombstone(range_tombstone) override { found = true; }
+            virtual void accept_row(position_in_partition_view, row_tombstone deleted_at, row_marker, is_dummy, is_continuous) override {
+                found |= bool(deleted_at);
+            }
+            virtual void accept_row_cell(column_id, atomic_cell ac) override { found |= !ac.is_live(); }
+            virtual void accept_row_cell(column_id, collection_mutation_view) override { }
+        } v;
+        fm.partition().accept(s.get_column_mapping(), v);
+        return v.found;
+    }
+
+    // Returns the cached local shards of all cells updated by m, as a
+    // mutation suitable for transform_counter_updates_to_shards(), or a
+    // disengaged optional if any of them is missing.
+    mutation_opt get(const mutation& m, counter_id local_id) {
+        auto& s = *m.schema();
+        auto it = _partitions.find(m.decorated_key());
+        if (it == _partitions.end() || has_tombstones(m)) {
+            ++_stats.misses;
+            return {};
+        }
+        auto& pe = it->second;
+        mutation state(m.schema(), m.decorated_key());
+        bool complete = true;
+        for_each_live_cell(s, m.partition(), [&] (const clustering_key* ck, column_id id, atomic_cell_view) {
+            auto* ce = complete ? find_cell(pe, ck, id, s) : nullptr;
+            if (!ce) {
+                complete = false;
+                return;
+            }
+            auto cell = counter_cell_builder::from_single_shard(api::min_timestamp, counter_shard(local_id, ce->shard.value(), ce->shard.logical_clock()));
+            if (ck) {
+                state.set_clustered_cell(*ck, s.regular_column_at(id), std::move(cell));
+            } else {
+                state.set_static_cell(s.static_column_at(id), std::move(cell));
+            }
+        });
+        if (!complete) {
+            ++_stats.misses;
+            return {};
+        }
+        ++_stats.hits;
+        _lru.erase(_lru.iterator_to(pe));
+        _lru.push_front(pe);
+        return state;
+    }
+
+    // Stores the local shards of the cells of m, already transformed to
+    // shards and successfully applied, unless the cache was invalidated since
+    // the update began.
+    void update(const mutation& m, counter_id local_id, uint64_t generation) {
+        if (generation != _generation || !_max_memory || has_tombstones(m)) {
+            return;
+        }
+        auto& s = *m.schema();
+        auto [it, inserted] = _partitions.try_emplace(m.decorated_key());
+        auto& pe = it->second;
+        if (inserted) {
+            pe.key = &it->first;
+            pe.memory = partition_overhead + it->first.key().representation().size();
+            add_memory(pe.memory);
+        } else {
+            _lru.erase(_lru.iterator_to(pe));
+        }
+        _lru.push_front(pe);
+        for_each_live_cell(s, m.partition(), [&] (const clustering_key* ck, column_id id, atomic_cell_view acv) {
+            auto shard = counter_cell_view(acv).get_shard(local_id);
+            if (!shard) {
+                return;
+            }
+            if (auto* ce = find_cell(pe, ck, id, s)) {
+                ce->shard = counter_shard(*shard);
+            } else if (pe.cells.size() < max_cells_per_partition) {
+                pe.cells.push_back(cell_entry{ck ? std::make_optional(*ck) : std::nullopt, id, counter_shard(*shard)});
+                auto memory = memory_of(pe.cells.back());
+                pe.memory += memory;
+                add_memory(memory);
+            }
+        });
+        evict();
+    }
+
+    void invalidate(const dht::decorated_key& dk) {
+        ++_generation;
+        auto it = _partitions.find(dk);
+        if (it != _partitions.end()) {
+            erase(it);
+        }
+    }
+
+    void clear() {
+        ++_generation;
+        _lru.clear();
+        _partitions.clear();
+        add_memory(-ssize_t(_memory));
+    }
+};
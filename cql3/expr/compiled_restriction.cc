@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "compiled_restriction.hh"
+
+#include <algorithm>
+#include <fmt/ostream.h>
+
+#include "cql3/query_options.hh"
+#include "schema.hh"
+#include "types.hh"
+
+namespace cql3 {
+namespace expr {
+
+namespace {
+
+/// Appends the atoms of restr to atoms.  Returns false if restr isn't a conjunction of binary operators.
+bool collect_atoms(const expression& restr, std::vector<const binary_operator*>& atoms) {
+    if (auto conj = as_if<conjunction>(&restr)) {
+        return std::ranges::all_of(conj->children, [&] (const expression& child) { return collect_atoms(child, atoms); });
+    }
+    if (auto binop = as_if<binary_operator>(&restr)) {
+        atoms.push_back(binop);
+        return true;
+    }
+    return false;
+}
+
+bool is_compiled(oper_t op) {
+    return op == oper_t::EQ || op == oper_t::NEQ || is_slice(op) || op == oper_t::IN;
+}
+
+} // anonymous namespace
+
+compiled_restriction::compiled_restriction(const column_definition& column)
+    : _column(&column)
+    , _type(&column.type->without_reversed())
+    , _byte_order_equal(_type->is_byte_order_equal())
+{ }
+
+std::optional<compiled_restriction> compiled_restriction::compile(const expression& restr, const query_options& options) {
+    std::vector<const binary_operator*> atoms;
+    if (!collect_atoms(restr, atoms) || atoms.empty()) {
+        return std::nullopt;
+    }
+    const column_definition* column = nullptr;
+    for (auto atom : atoms) {
+        auto cv = as_if<column_value>(&atom->lhs);
+        if (!cv || cv->sub || (column && cv->col != column) || !is_compiled(atom->op) || atom->order != comparison_order::cql) {
+            return std::nullopt;
+        }
+        column = cv->col;
+    }
+    if (column->type->is_multi_cell()) {
+        return std::nullopt;
+    }
+
+    compiled_restriction ret(*column);
+    ret._comparisons.reserve(atoms.size());
+    for (auto atom : atoms) {
+        comparison c{atom->op, {}};
+        if (atom->op == oper_t::IN) {
+            const constant in_list = evaluate_IN_list(atom->rhs, options);
+            if (in_list.is_null() || !in_list.type->without_reversed().is_list()) {
+                // Let the interpreter complain about it, for every row.
+                return std::nullopt;
+            }
+            for (const managed_bytes& v : get_list_elements(in_list)) {
+                c.values.emplace_back(to_bytes(v));
+            }
+            if (ret._byte_order_equal) {
+                std::sort(c.values.begin(), c.values.end(), [] (const bytes_opt& a, const bytes_opt& b) {
+                    return compare_unsigned(*a, *b) < 0;
+                });
+            }
+        } else {
+            auto value = evaluate(atom->rhs, options).value.to_managed_bytes_opt();
+            c.values.push_back(value ? bytes_opt(to_bytes(*value)) : std::nullopt);
+        }
+        ret._comparisons.push_back(std::move(c));
+    }
+    return ret;
+}
+
+bool compiled_restriction::equal(bytes_view a, bytes_view b) const {
+    return _byte_order_equal ? a == b : _type->equal(a, b);
+}
+
+bool compiled_restriction::is_one_of(bytes_view value, const std::vector<bytes_opt>& values) const {
+    if (_byte_order_equal) {
+        auto it = std::lower_bound(values.begin(), values.end(), value, [] (const bytes_opt& a, bytes_view b) {
+            return compare_unsigned(*a, b) < 0;
+        });
+        return it != values.end() && bytes_view(**it) == value;
+    }
+    return std::ranges::any_of(values, [&] (const bytes_opt& v) { return equal(value, *v); });
+}
+
+bool compiled_restriction::is_satisfied_by(const comparison& c, const std::optional<bytes_view>& value) const {
+    switch (c.op) {
+    case oper_t::EQ:
+        return value && c.values.front() && equal(*value, *c.values.front());
+    case oper_t::NEQ:
+        return !(value && c.values.front() && equal(*value, *c.values.front()));
+    case oper_t::IN:
+        return value && is_one_of(*value, c.values);
+    default:
+        break;
+    }
+    if (!value || !c.values.front()) {
+        return false;
+    }
+    const auto cmp = _type->compare(*value, *c.values.front());
+    switch (c.op) {
+    case oper_t::LT:
+        return cmp < 0;
+    case oper_t::LTE:
+        return cmp <= 0;
+    case oper_t::GT:
+        return cmp > 0;
+    case oper_t::GTE:
+        return cmp >= 0;
+    default:
+        throw std::logic_error(format("compiled_restriction: unexpected operator {}", c.op));
+    }
+}
+
+bool compiled_restriction::is_satisfied_by(std::optional<bytes_view> value) const {
+    return std::ranges::all_of(_comparisons, [&] (const comparison& c) { return is_satisfied_by(c, value); });
+}
+
+} // namespace expr
+} // namespace cql3
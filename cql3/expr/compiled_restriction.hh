@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "bytes.hh"
+#include "cql3/expr/expression.hh"
+#include "utils/fragment_range.hh"
+
+class column_definition;
+class abstract_type;
+
+namespace cql3 {
+
+class query_options;
+
+namespace expr {
+
+/// A restriction on a single column, compiled for filtering the rows of one query.
+///
+/// is_satisfied_by(const expression&, ...) interprets a restriction for every row: it walks the expression
+/// tree, evaluates (and validates) its right-hand sides, and looks the column up in the selection.  A
+/// compiled restriction evaluates the right-hand sides once, for the query's options, and checks a value
+/// against a flat list of comparisons specialized for the column's type.
+///
+/// Only restrictions which are conjunctions of comparisons (=, !=, <, <=, >, >=) and IN with a column,
+/// not subscripted, on the left-hand side can be compiled.  Everything else (CONTAINS, LIKE, multi-column
+/// restrictions, ...) is left to the interpreter.
+class compiled_restriction {
+    struct comparison {
+        oper_t op;
+        /// The right-hand side: a single value (disengaged if null) for everything but IN, the (sorted, if
+        /// _byte_order_equal) list of values for IN.
+        std::vector<bytes_opt> values;
+    };
+
+    const column_definition* _column;
+    const abstract_type* _type;
+    bool _byte_order_equal;
+    std::vector<comparison> _comparisons;
+private:
+    compiled_restriction(const column_definition& column);
+
+    bool equal(bytes_view a, bytes_view b) const;
+    bool is_one_of(bytes_view value, const std::vector<bytes_opt>& values) const;
+    bool is_satisfied_by(const comparison& c, const std::optional<bytes_view>& value) const;
+public:
+    /// Compiles restr, a restriction on a single column, with the values bound in options.  Returns
+    /// std::nullopt if restr can't be compiled.
+    static std::optional<compiled_restriction> compile(const expression& restr, const query_options& options);
+
+    const column_definition& column() const {
+        return *_column;
+    }
+
+    /// True iff the restriction is satisfied by value, the column's value, disengaged if it is null.
+    bool is_satisfied_by(std::optional<bytes_view> value) const;
+
+    template <FragmentedView View>
+    bool is_satisfied_by(const std::optional<View>& value) const {
+        if (!value) {
+            return is_satisfied_by(std::optional<bytes_view>());
+        }
+        return with_linearized(*value, [this] (bytes_view v) {
+            return is_satisfied_by(std::optional<bytes_view>(v));
+        });
+    }
+};
+
+} // namespace expr
+} // namespace cql3
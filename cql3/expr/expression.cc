@@ -25,6 +25,7 @@
 #include "cql3/selection/selection.hh"
 #include "index/secondary_index_manager.hh"
 #include "types/list.hh"
+#include "types/listlike_partial_deserializing_iterator.hh"
 #include "types/map.hh"
 #include "types/set.hh"
 #include "utils/like_matcher.hh"
@@ -93,6 +94,26 @@ struct column_value_eval_bag {
     row_data_from_partition_slice row_data;
 };
 
+/// Returns the value of key in the serialized map, or null if it has none. The entries are looked at in place, so
+/// unlike deserializing the map, this allocates only the returned value. If sorted, the search stops at the first key
+/// greater than key.
+managed_bytes_opt find_in_serialized_map(managed_bytes_view map, managed_bytes_view key, const abstract_type& key_type,
+        bool sorted) {
+    const auto sf = cql_serialization_format::internal();
+    for (int n = read_collection_size(map, sf); n > 0; --n) {
+        const auto k = read_collection_value(map, sf);
+        const auto v = read_collection_value(map, sf);
+        const auto cmp = key_type.compare(k, key);
+        if (cmp == 0) {
+            return managed_bytes(v);
+        }
+        if (sorted && cmp > 0) {
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
 /// Returns col's value from queried data.
 managed_bytes_opt get_value(const column_value& col, const column_value_eval_bag& bag) {
     auto cdef = col.col;
@@ -109,17 +130,15 @@ managed_bytes_opt get_value(const column_value& col, const column_value_eval_bag
                     format("Column definition {} does not match any column in the query selection",
                     cdef->name_as_text()));
         }
-        const auto deserialized = cdef->type->deserialize(managed_bytes_view(*data.other_columns[index]));
-        const auto& data_map = value_cast<map_type_impl::native_type>(deserialized);
+        if (!data.other_columns[index]) {
+            return std::nullopt;
+        }
         const auto key = evaluate(*col.sub, options);
-        auto&& key_type = col_type->name_comparator();
-        const auto found = key.view().with_linearized([&] (bytes_view key_bv) {
-            using entry = std::pair<data_value, data_value>;
-            return std::find_if(data_map.cbegin(), data_map.cend(), [&] (const entry& element) {
-                return key_type->compare(element.first.serialize_nonnull(), key_bv) == 0;
-            });
+        // Entries of a non-frozen map come from its cells, so they are sorted by key.
+        return key.view().with_linearized([&] (bytes_view key_bv) {
+            return find_in_serialized_map(managed_bytes_view(*data.other_columns[index]), managed_bytes_view(key_bv),
+                    *col_type->name_comparator(), col_type->is_multi_cell());
         });
-        return found == data_map.cend() ? std::nullopt : managed_bytes_opt(found->second.serialize_nonnull());
     } else {
         switch (cdef->kind) {
         case column_kind::partition_key:
@@ -383,11 +402,18 @@ bool like(const column_value& cv, const raw_value_view& pattern, const column_va
                 format("LIKE is allowed only on string types, which {} is not", cv.col->name_as_text()));
     }
     auto value = get_value(cv, bag);
-    // TODO: reuse matchers.
     if (pattern && value) {
         return value->with_linearized([&pattern] (bytes_view linearized_value) {
             return pattern.with_linearized([linearized_value] (bytes_view linearized_pattern) {
-                return like_matcher(linearized_pattern)(linearized_value);
+                // Filtering evaluates the same pattern on row after row, so
+                // keep the last one compiled.
+                static thread_local std::optional<like_matcher> matcher;
+                if (matcher) {
+                    matcher->reset(linearized_pattern);
+                } else {
+                    matcher.emplace(linearized_pattern);
+                }
+                return (*matcher)(linearized_value);
             });
         });
     } else {
@@ -0,0 +1,741 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "cql3/fast_parser.hh"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+#include "cql3/attributes.hh"
+#include "cql3/cf_name.hh"
+#include "cql3/column_identifier.hh"
+#include "cql3/expr/expression.hh"
+#include "cql3/operation_impl.hh"
+#include "cql3/selection/raw_selector.hh"
+#include "cql3/single_column_relation.hh"
+#include "cql3/statements/raw/delete_statement.hh"
+#include "cql3/statements/raw/insert_statement.hh"
+#include "cql3/statements/raw/select_statement.hh"
+#include "cql3/statements/raw/update_statement.hh"
+
+namespace cql3 {
+
+using namespace statements;
+using expr::expression;
+using bind_shape = expr::bind_variable::shape_type;
+using operations_type = std::vector<std::pair<::shared_ptr<column_identifier::raw>, std::unique_ptr<operation::raw_update>>>;
+
+namespace {
+
+// Thrown when the statement isn't one of the shapes recognized here, or isn't valid, to leave it to the grammar.
+struct unsupported_statement {};
+
+enum class token_kind {
+    word,           // IDENT or a keyword
+    quoted_name,    // QUOTED_NAME, without the quotes
+    string,         // STRING_LITERAL, without the quotes
+    integer,
+    floating_point,
+    hex,
+    qmark,
+    punctuation,
+    end,
+};
+
+struct token {
+    token_kind kind;
+    std::string_view text;
+    // Whether text, of a quoted name or a string, contains doubled quotes.
+    bool escaped = false;
+};
+
+// The keywords of Cql.g which can't be used as unquoted identifiers, plus the names of the native types,
+// which can but are canonicalized by the grammar (e.g. varchar is turned into text).
+const std::unordered_set<std::string_view> non_identifier_keywords = {
+    "add", "allow", "alter", "and", "apply", "asc", "ascii", "authorize", "batch", "begin", "bigint", "blob",
+    "boolean", "by", "cast", "columnfamily", "counter", "create", "date", "decimal", "default", "delete", "desc",
+    "describe", "double", "drop", "duration", "empty", "entries", "false", "float", "from", "full", "grant",
+    "if", "in", "index", "inet", "infinity", "insert", "int", "into", "is", "keyspace", "limit", "materialized",
+    "modify", "nan", "norecursive", "not", "null", "of", "on", "or", "order", "primary", "rename", "replace",
+    "revoke", "schema", "scylla_clustering_bound", "scylla_counter_shard_list", "scylla_timeuuid_list_index",
+    "select", "set", "smallint", "table", "text", "time", "timestamp", "timeuuid", "tinyint", "to", "token",
+    "true", "truncate", "unlogged", "unset", "update", "use", "using", "uuid", "varchar", "varint", "view",
+    "where", "with",
+};
+
+constexpr size_t max_keyword_size = 32;
+
+bool is_letter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool is_hex(char c) {
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool is_word_char(char c) {
+    return is_letter(c) || is_digit(c) || c == '_';
+}
+
+char ascii_to_lower(char c) {
+    return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+/// keyword is in lower case.
+bool equals_keyword(std::string_view word, std::string_view keyword) {
+    if (word.size() != keyword.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < word.size(); ++i) {
+        if (ascii_to_lower(word[i]) != keyword[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_identifier(std::string_view word) {
+    if (word.size() > max_keyword_size) {
+        return true;
+    }
+    char lower[max_keyword_size];
+    std::transform(word.begin(), word.end(), lower, ascii_to_lower);
+    return !non_identifier_keywords.contains(std::string_view(lower, word.size()));
+}
+
+/// Splits query into tokens as Cql.g's lexer would.  Returns false on anything the lexer could treat
+/// differently from the simple rules below: comments, durations, UUIDs, exponents, pg-style strings,
+/// non-ASCII text and characters which don't appear in the statements recognized here.
+bool tokenize(std::string_view query, std::vector<token>& tokens) {
+    auto at = [&] (size_t i) {
+        return i < query.size() ? query[i] : '\0';
+    };
+    size_t i = 0;
+    while (i < query.size()) {
+        const char c = query[i];
+        const size_t start = i;
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            ++i;
+        } else if (is_letter(c)) {
+            // A 'P' alone or followed by a digit or a 'T' is a DURATION.
+            if (c == 'P' && (is_digit(at(i + 1)) || at(i + 1) == 'T' || !is_word_char(at(i + 1)))) {
+                return false;
+            }
+            while (is_word_char(at(i))) {
+                ++i;
+            }
+            // Hex digits followed by a dash start a UUID.
+            if (at(i) == '-') {
+                return false;
+            }
+            tokens.push_back({token_kind::word, query.substr(start, i - start)});
+        } else if (is_digit(c) || (c == '-' && is_digit(at(i + 1)))) {
+            auto kind = token_kind::integer;
+            if (c == '0' && (at(i + 1) == 'x' || at(i + 1) == 'X')) {
+                kind = token_kind::hex;
+                i += 2;
+                while (is_hex(at(i))) {
+                    ++i;
+                }
+            } else {
+                ++i;
+                while (is_digit(at(i))) {
+                    ++i;
+                }
+                if (at(i) == '.') {
+                    kind = token_kind::floating_point;
+                    ++i;
+                    while (is_digit(at(i))) {
+                        ++i;
+                    }
+                }
+            }
+            if (is_word_char(at(i)) || at(i) == '.' || at(i) == '-') {
+                return false;
+            }
+            tokens.push_back({kind, query.substr(start, i - start)});
+        } else if (c == '\'' || c == '"') {
+            bool escaped = false;
+            ++i;
+            for (;;) {
+                if (i == query.size() || uint8_t(query[i]) >= 0x80) {
+                    return false;
+                }
+                if (query[i] == c) {
+                    if (at(i + 1) != c) {
+                        break;
+                    }
+                    escaped = true;
+                    ++i;
+                }
+                ++i;
+            }
+            auto text = query.substr(start + 1, i - start - 1);
+            ++i;
+            if (c == '"' && text.empty()) {
+                return false;
+            }
+            tokens.push_back({c == '"' ? token_kind::quoted_name : token_kind::string, text, escaped});
+        } else if (c == '?') {
+            ++i;
+            tokens.push_back({token_kind::qmark, query.substr(start, 1)});
+        } else {
+            switch (c) {
+            case '(': case ')': case ',': case ';': case '.': case '*': case '=': case ':': case '+':
+                ++i;
+                break;
+            case '<': case '>':
+                i += at(i + 1) == '=' ? 2 : 1;
+                break;
+            case '!':
+                if (at(i + 1) != '=') {
+                    return false;
+                }
+                i += 2;
+                break;
+            case '-':
+                // "--" starts a comment.
+                if (at(i + 1) == '-') {
+                    return false;
+                }
+                ++i;
+                break;
+            default:
+                return false;
+            }
+            tokens.push_back({token_kind::punctuation, query.substr(start, i - start)});
+        }
+    }
+    tokens.push_back({token_kind::end, {}});
+    return true;
+}
+
+sstring unescape(const token& t, char quote) {
+    if (!t.escaped) {
+        return sstring(t.text);
+    }
+    std::string ret;
+    ret.reserve(t.text.size());
+    for (size_t i = 0; i < t.text.size(); ++i) {
+        ret.push_back(t.text[i]);
+        if (t.text[i] == quote) {
+            ++i;
+        }
+    }
+    return sstring(ret);
+}
+
+/// Recursive-descent parser for the statements below, following the rules of Cql.g and building the same
+/// raw statements.
+///
+///   SELECT (* | <column> (, <column>)*) FROM [<ks>.]<cf>
+///       [WHERE <relation> (AND <relation>)*] [ORDER BY <column> [ASC | DESC] (, ...)*]
+///       [PER PARTITION LIMIT <int>] [LIMIT <int>] [ALLOW FILTERING] [BYPASS CACHE] [USING ...]
+///   INSERT INTO [<ks>.]<cf> (<column>, ...) VALUES (<term>, ...) [IF NOT EXISTS] [USING ...]
+///   UPDATE [<ks>.]<cf> [USING ...] SET <column> = (<term> | <column> (+ | -) <term>), ...
+///       WHERE <relation> (AND <relation>)* [IF EXISTS]
+///   DELETE [<column>, ...] FROM [<ks>.]<cf> [USING ...] WHERE <relation> (AND <relation>)* [IF EXISTS]
+///
+/// where a relation is <column> (= | < | <= | > | >= | !=) <term>, <column> IN (<term>, ...) or
+/// <column> IN <marker>, and a term is a string, integer, float, boolean or hex constant, NULL or a marker.
+class fast_parser {
+    std::vector<token> _tokens;
+    size_t _pos = 0;
+    std::vector<::shared_ptr<column_identifier>> _bind_variables;
+    // When normalizing, the constants which were turned into bind markers.
+    std::vector<expr::untyped_constant>* _constants;
+public:
+    explicit fast_parser(std::vector<token> tokens, std::vector<expr::untyped_constant>* constants = nullptr)
+        : _tokens(std::move(tokens))
+        , _constants(constants)
+    { }
+
+    std::unique_ptr<raw::parsed_statement> parse() {
+        std::unique_ptr<raw::parsed_statement> statement;
+        const auto& first = next();
+        if (is_keyword(first, "select")) {
+            statement = select_statement();
+        } else if (is_keyword(first, "insert")) {
+            statement = insert_statement();
+        } else if (is_keyword(first, "update")) {
+            statement = update_statement();
+        } else if (is_keyword(first, "delete")) {
+            statement = delete_statement();
+        } else {
+            return nullptr;
+        }
+        while (accept(";")) { }
+        if (peek().kind != token_kind::end) {
+            unsupported();
+        }
+        statement->set_bound_variables(_bind_variables);
+        return statement;
+    }
+
+    /// The text of the parsed statement, normalized as described by normalized_statement::text.
+    sstring normalized_text() const {
+        std::string text;
+        for (auto&& t : _tokens) {
+            if (t.kind == token_kind::end) {
+                break;
+            }
+            if (!text.empty()) {
+                text.push_back(' ');
+            }
+            switch (t.kind) {
+            case token_kind::word:
+                std::transform(t.text.begin(), t.text.end(), std::back_inserter(text), ascii_to_lower);
+                break;
+            case token_kind::quoted_name:
+                text.push_back('"');
+                text.append(t.text);
+                text.push_back('"');
+                break;
+            case token_kind::string:
+                text.push_back('\'');
+                text.append(t.text);
+                text.push_back('\'');
+                break;
+            default:
+                text.append(t.text);
+                break;
+            }
+        }
+        return sstring(text);
+    }
+private:
+    [[noreturn]] static void unsupported() {
+        throw unsupported_statement();
+    }
+
+    const token& peek(size_t ahead = 0) const {
+        return _tokens[std::min(_pos + ahead, _tokens.size() - 1)];
+    }
+
+    const token& next() {
+        const auto& t = peek();
+        _pos = std::min(_pos + 1, _tokens.size() - 1);
+        return t;
+    }
+
+    static bool is_keyword(const token& t, std::string_view keyword) {
+        return t.kind == token_kind::word && equals_keyword(t.text, keyword);
+    }
+
+    bool accept_keyword(std::string_view keyword) {
+        if (!is_keyword(peek(), keyword)) {
+            return false;
+        }
+        next();
+        return true;
+    }
+
+    void expect_keyword(std::string_view keyword) {
+        if (!accept_keyword(keyword)) {
+            unsupported();
+        }
+    }
+
+    static bool is_punctuation(const token& t, std::string_view p) {
+        return t.kind == token_kind::punctuation && t.text == p;
+    }
+
+    bool accept(std::string_view p) {
+        if (!is_punctuation(peek(), p)) {
+            return false;
+        }
+        next();
+        return true;
+    }
+
+    void expect(std::string_view p) {
+        if (!accept(p)) {
+            unsupported();
+        }
+    }
+
+    static bool is_name(const token& t) {
+        return (t.kind == token_kind::word && is_identifier(t.text)) || t.kind == token_kind::quoted_name;
+    }
+
+    /// An IDENT, QUOTED_NAME or unreserved_keyword: the text of the name and whether its case is kept.
+    std::pair<sstring, bool> name() {
+        const auto& t = next();
+        if (!is_name(t)) {
+            unsupported();
+        }
+        if (t.kind == token_kind::quoted_name) {
+            return {unescape(t, '"'), true};
+        }
+        return {sstring(t.text), false};
+    }
+
+    ::shared_ptr<column_identifier::raw> cident() {
+        auto [text, keep_case] = name();
+        return ::make_shared<column_identifier::raw>(std::move(text), keep_case);
+    }
+
+    ::shared_ptr<column_identifier> ident() {
+        auto [text, keep_case] = name();
+        return ::make_shared<column_identifier>(std::move(text), keep_case);
+    }
+
+    cf_name column_family_name() {
+        cf_name cf;
+        auto [first, first_keep_case] = name();
+        if (accept(".")) {
+            cf.set_keyspace(first, first_keep_case);
+            auto [second, second_keep_case] = name();
+            cf.set_column_family(second, second_keep_case);
+        } else {
+            cf.set_column_family(first, first_keep_case);
+        }
+        return cf;
+    }
+
+    expression new_bind_variable(bind_shape shape, ::shared_ptr<column_identifier> name) {
+        auto marker = expr::bind_variable{shape, int32_t(_bind_variables.size())};
+        _bind_variables.push_back(std::move(name));
+        return marker;
+    }
+
+    /// QMARK or ':' ident, if it comes next.
+    std::optional<expression> marker(bind_shape shape) {
+        if (peek().kind == token_kind::qmark) {
+            if (_constants) {
+                unsupported();
+            }
+            next();
+            return new_bind_variable(shape, nullptr);
+        }
+        if (accept(":")) {
+            if (_constants) {
+                unsupported();
+            }
+            auto name = ident();
+            return new_bind_variable(shape, std::move(name));
+        }
+        return std::nullopt;
+    }
+
+    /// The constant just read, or the bind marker replacing it when normalizing.
+    expression constant(expr::untyped_constant::type_class type, sstring text) {
+        if (!_constants) {
+            return expr::untyped_constant{type, std::move(text)};
+        }
+        _constants->push_back(expr::untyped_constant{type, std::move(text)});
+        _tokens[_pos - 1] = token{token_kind::qmark, "?"};
+        return new_bind_variable(bind_shape::scalar, nullptr);
+    }
+
+    expression term() {
+        if (auto m = marker(bind_shape::scalar)) {
+            return std::move(*m);
+        }
+        const auto& t = next();
+        switch (t.kind) {
+        case token_kind::string:
+            return constant(expr::untyped_constant::string, unescape(t, '\''));
+        case token_kind::integer:
+            return constant(expr::untyped_constant::integer, sstring(t.text));
+        case token_kind::floating_point:
+            return constant(expr::untyped_constant::floating_point, sstring(t.text));
+        case token_kind::hex:
+            return constant(expr::untyped_constant::hex, sstring(t.text));
+        case token_kind::word:
+            if (equals_keyword(t.text, "true") || equals_keyword(t.text, "false")) {
+                return constant(expr::untyped_constant::boolean, sstring(t.text));
+            }
+            if (equals_keyword(t.text, "null")) {
+                return expr::null();
+            }
+            break;
+        default:
+            break;
+        }
+        unsupported();
+    }
+
+    expression int_value() {
+        if (auto m = marker(bind_shape::scalar)) {
+            return std::move(*m);
+        }
+        const auto& t = next();
+        if (t.kind != token_kind::integer) {
+            unsupported();
+        }
+        return constant(expr::untyped_constant::integer, sstring(t.text));
+    }
+
+    expr::oper_t relation_type() {
+        const auto& t = next();
+        if (t.kind == token_kind::punctuation) {
+            if (t.text == "=") {
+                return expr::oper_t::EQ;
+            } else if (t.text == "<") {
+                return expr::oper_t::LT;
+            } else if (t.text == "<=") {
+                return expr::oper_t::LTE;
+            } else if (t.text == ">") {
+                return expr::oper_t::GT;
+            } else if (t.text == ">=") {
+                return expr::oper_t::GTE;
+            } else if (t.text == "!=") {
+                return expr::oper_t::NEQ;
+            }
+        }
+        unsupported();
+    }
+
+    void relation(std::vector<relation_ptr>& clauses) {
+        auto name = cident();
+        if (accept_keyword("in")) {
+            if (auto m = marker(bind_shape::scalar_in)) {
+                clauses.emplace_back(::make_shared<single_column_relation>(std::move(name), expr::oper_t::IN, std::move(*m)));
+                return;
+            }
+            expect("(");
+            std::vector<expression> values;
+            if (!accept(")")) {
+                do {
+                    values.push_back(term());
+                } while (accept(","));
+                expect(")");
+            }
+            clauses.emplace_back(single_column_relation::create_in_relation(std::move(name), std::move(values)));
+            return;
+        }
+        auto op = relation_type();
+        auto value = term();
+        clauses.emplace_back(::make_shared<single_column_relation>(std::move(name), op, std::move(value)));
+    }
+
+    std::vector<relation_ptr> where_clause() {
+        std::vector<relation_ptr> clauses;
+        do {
+            relation(clauses);
+        } while (accept_keyword("and"));
+        return clauses;
+    }
+
+    void using_clause(attributes::raw& attrs) {
+        do {
+            if (accept_keyword("timestamp")) {
+                attrs.timestamp = int_value();
+            } else if (accept_keyword("ttl")) {
+                attrs.time_to_live = int_value();
+            } else if (accept_keyword("timeout")) {
+                attrs.timeout = term();
+            } else {
+                unsupported();
+            }
+        } while (accept_keyword("and"));
+    }
+
+    std::unique_ptr<attributes::raw> maybe_using_clause() {
+        auto attrs = std::make_unique<attributes::raw>();
+        if (accept_keyword("using")) {
+            using_clause(*attrs);
+        }
+        return attrs;
+    }
+
+    std::unique_ptr<raw::select_statement> select_statement() {
+        // Whether these are keywords or column names depends on what follows, leave them to the grammar.
+        if (is_keyword(peek(), "json") || is_keyword(peek(), "distinct")) {
+            unsupported();
+        }
+        std::vector<::shared_ptr<selection::raw_selector>> selectors;
+        if (!accept("*")) {
+            do {
+                selectors.push_back(::make_shared<selection::raw_selector>(expr::unresolved_identifier{cident()}, nullptr));
+            } while (accept(","));
+        }
+        expect_keyword("from");
+        auto cf = column_family_name();
+        std::vector<relation_ptr> where;
+        if (accept_keyword("where")) {
+            where = where_clause();
+        }
+        raw::select_statement::parameters::orderings_type orderings;
+        if (accept_keyword("order")) {
+            expect_keyword("by");
+            do {
+                auto column = cident();
+                auto ordering = raw::select_statement::ordering::ascending;
+                if (accept_keyword("desc")) {
+                    ordering = raw::select_statement::ordering::descending;
+                } else {
+                    accept_keyword("asc");
+                }
+                orderings.emplace_back(std::move(column), ordering);
+            } while (accept(","));
+        }
+        std::optional<expression> per_partition_limit;
+        if (accept_keyword("per")) {
+            expect_keyword("partition");
+            expect_keyword("limit");
+            per_partition_limit = int_value();
+        }
+        std::optional<expression> limit;
+        if (accept_keyword("limit")) {
+            limit = int_value();
+        }
+        bool allow_filtering = false;
+        if (accept_keyword("allow")) {
+            expect_keyword("filtering");
+            allow_filtering = true;
+        }
+        bool bypass_cache = false;
+        if (accept_keyword("bypass")) {
+            expect_keyword("cache");
+            bypass_cache = true;
+        }
+        auto attrs = maybe_using_clause();
+        auto params = make_lw_shared<raw::select_statement::parameters>(std::move(orderings), false, allow_filtering, false, bypass_cache);
+        return std::make_unique<raw::select_statement>(std::move(cf), std::move(params), std::move(selectors), std::move(where),
+                std::move(limit), std::move(per_partition_limit), std::vector<::shared_ptr<column_identifier::raw>>(), std::move(attrs));
+    }
+
+    std::unique_ptr<raw::insert_statement> insert_statement() {
+        expect_keyword("into");
+        auto cf = column_family_name();
+        std::vector<::shared_ptr<column_identifier::raw>> column_names;
+        expect("(");
+        do {
+            column_names.push_back(cident());
+        } while (accept(","));
+        expect(")");
+        expect_keyword("values");
+        std::vector<expression> values;
+        expect("(");
+        do {
+            values.push_back(term());
+        } while (accept(","));
+        expect(")");
+        bool if_not_exists = false;
+        if (accept_keyword("if")) {
+            expect_keyword("not");
+            expect_keyword("exists");
+            if_not_exists = true;
+        }
+        auto attrs = maybe_using_clause();
+        return std::make_unique<raw::insert_statement>(std::move(cf), std::move(attrs), std::move(column_names), std::move(values), if_not_exists);
+    }
+
+    void column_operation(operations_type& operations) {
+        auto key = cident();
+        expect("=");
+        std::unique_ptr<operation::raw_update> update;
+        if (is_name(peek()) && (is_punctuation(peek(1), "+") || is_punctuation(peek(1), "-"))) {
+            auto column = cident();
+            if (*column != *key) {
+                unsupported();
+            }
+            const bool add = next().text == "+";
+            auto value = term();
+            if (add) {
+                update = std::make_unique<operation::addition>(std::move(value));
+            } else {
+                update = std::make_unique<operation::subtraction>(std::move(value));
+            }
+        } else {
+            update = std::make_unique<operation::set_value>(term());
+        }
+        // The grammar rejects the incompatible ones of several updates of a column.
+        for (auto&& p : operations) {
+            if (*p.first == *key) {
+                unsupported();
+            }
+        }
+        operations.emplace_back(std::move(key), std::move(update));
+    }
+
+    std::unique_ptr<raw::update_statement> update_statement() {
+        auto cf = column_family_name();
+        auto attrs = maybe_using_clause();
+        expect_keyword("set");
+        operations_type operations;
+        do {
+            column_operation(operations);
+        } while (accept(","));
+        expect_keyword("where");
+        auto where = where_clause();
+        bool if_exists = false;
+        if (accept_keyword("if")) {
+            expect_keyword("exists");
+            if_exists = true;
+        }
+        return std::make_unique<raw::update_statement>(std::move(cf), std::move(attrs), std::move(operations), std::move(where),
+                raw::modification_statement::conditions_vector(), if_exists);
+    }
+
+    std::unique_ptr<raw::delete_statement> delete_statement() {
+        std::vector<std::unique_ptr<operation::raw_deletion>> deletions;
+        if (!is_keyword(peek(), "from")) {
+            do {
+                deletions.push_back(std::make_unique<operation::column_deletion>(cident()));
+            } while (accept(","));
+        }
+        expect_keyword("from");
+        auto cf = column_family_name();
+        auto attrs = maybe_using_clause();
+        expect_keyword("where");
+        auto where = where_clause();
+        bool if_exists = false;
+        if (accept_keyword("if")) {
+            expect_keyword("exists");
+            if_exists = true;
+        }
+        return std::make_unique<raw::delete_statement>(std::move(cf), std::move(attrs), std::move(deletions), std::move(where),
+                raw::modification_statement::conditions_vector(), if_exists);
+    }
+};
+
+}
+
+std::unique_ptr<raw::parsed_statement> fast_parse_statement(std::string_view query) {
+    std::vector<token> tokens;
+    tokens.reserve(32);
+    if (!tokenize(query, tokens)) {
+        return nullptr;
+    }
+    try {
+        return fast_parser(std::move(tokens)).parse();
+    } catch (const unsupported_statement&) {
+        return nullptr;
+    }
+}
+
+std::optional<normalized_statement> normalize_statement(std::string_view query) {
+    std::vector<token> tokens;
+    tokens.reserve(32);
+    if (!tokenize(query, tokens)) {
+        return std::nullopt;
+    }
+    normalized_statement ret;
+    try {
+        fast_parser parser(std::move(tokens), &ret.constants);
+        ret.statement = parser.parse();
+        if (!ret.statement) {
+            return std::nullopt;
+        }
+        ret.text = parser.normalized_text();
+    } catch (const unsupported_statement&) {
+        return std::nullopt;
+    }
+    return ret;
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <seastar/core/sstring.hh>
+
+#include "cql3/expr/expression.hh"
+
+namespace cql3 {
+
+namespace statements::raw {
+class parsed_statement;
+}
+
+/// Parses the most common shapes of SELECT, INSERT, UPDATE and DELETE statements without going through
+/// the ANTLR grammar (Cql.g), which is expensive per statement and is paid on every request by clients
+/// which don't use prepared statements.
+///
+/// The statement is built exactly as the grammar would build it.  Anything beyond the shapes recognized
+/// here (function calls, collections, conditions, JSON, comments, keywords used as identifiers, ...) and
+/// anything which isn't valid CQL makes this return nullptr, and the statement must then be parsed by the
+/// grammar, which also reports the syntax errors.
+std::unique_ptr<statements::raw::parsed_statement> fast_parse_statement(std::string_view query);
+
+/// A statement recognized by fast_parse_statement() with its constants taken out as if they were bind markers.
+struct normalized_statement {
+    /// The text of the statement, with each constant replaced by a '?' and keywords and unquoted names
+    /// in lower case, so that statements which differ only in their constants have the same text.
+    sstring text;
+    /// The statement parsed from text.
+    std::unique_ptr<statements::raw::parsed_statement> statement;
+    /// The constants, in the order of the bind markers which replaced them.
+    std::vector<expr::untyped_constant> constants;
+};
+
+/// Normalizes the statements recognized by fast_parse_statement() which don't have bind markers of their
+/// own, and returns std::nullopt for all the others.  NULL is left in the statement, as it can't always
+/// be replaced by a marker.
+std::optional<normalized_statement> normalize_statement(std::string_view query);
+
+}
@@ -91,6 +91,10 @@ class impl_user_aggregate : public aggregate_function::aggregate {
     ::shared_ptr<scalar_function> _finalfunc;
     const bytes_opt _initcond;
     bytes_opt _acc;
+    // The arguments of the state function, the accumulator followed by the
+    // input values. Kept between rows so that adding a row only copies its
+    // values into the existing slots.
+    std::vector<bytes_opt> _args;
 public:
     impl_user_aggregate(bytes_opt initcond, ::shared_ptr<scalar_function> sfunc, ::shared_ptr<scalar_function> finalfunc)
             : _sfunc(std::move(sfunc))
@@ -105,9 +109,10 @@ class impl_user_aggregate : public aggregate_function::aggregate {
         return _finalfunc->execute(sf, std::vector<bytes_opt>{_acc});
     }
     virtual void add_input(cql_serialization_format sf, const std::vector<opt_bytes>& values) override {
-        std::vector<bytes_opt> args{_acc};
-        args.insert(args.end(), values.begin(), values.end());
-        _acc = _sfunc->execute(sf, args);
+        _args.resize(values.size() + 1);
+        _args[0] = std::move(_acc);
+        std::copy(values.begin(), values.end(), _args.begin() + 1);
+        _acc = _sfunc->execute(sf, _args);
     }
 };
 
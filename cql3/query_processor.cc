@@ -18,13 +18,16 @@
 #include "service/storage_proxy.hh"
 #include "cql3/CqlParser.hpp"
 #include "cql3/error_collector.hh"
+#include "cql3/fast_parser.hh"
 #include "cql3/statements/batch_statement.hh"
 #include "cql3/statements/modification_statement.hh"
+#include "cql3/statements/select_statement.hh"
 #include "cql3/util.hh"
 #include "cql3/untyped_result_set.hh"
 #include "db/config.hh"
 #include "data_dictionary/data_dictionary.hh"
 #include "hashers.hh"
+#include "db/system_keyspace.hh"
 
 namespace cql3 {
 
@@ -34,6 +37,7 @@ using namespace cql_transport::messages;
 logging::logger log("query_processor");
 logging::logger prep_cache_log("prepared_statements_cache");
 logging::logger authorized_prepared_statements_cache_log("authorized_prepared_statements_cache");
+logging::logger unprep_cache_log("unprepared_statements_cache");
 
 const sstring query_processor::CQL_VERSION = "3.3.1";
 
@@ -71,7 +75,9 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
         , _authorized_prepared_cache(std::min(std::chrono::milliseconds(_db.get_config().permissions_validity_in_ms()),
                                               std::chrono::duration_cast<std::chrono::milliseconds>(prepared_statements_cache::entry_expiry)),
                                      std::chrono::milliseconds(_db.get_config().permissions_update_interval_in_ms()),
-                                     mcfg.authorized_prepared_cache_size, authorized_prepared_statements_cache_log) {
+                                     mcfg.authorized_prepared_cache_size, authorized_prepared_statements_cache_log)
+        , _unprepared_cache(unprep_cache_log, mcfg.unprepared_statement_cache_size)
+        , _remembered_statements_max_size(mcfg.prepared_statment_cache_size) {
     namespace sm = seastar::metrics;
     namespace stm = statements;
     using clevel = db::consistency_level;
@@ -337,6 +343,31 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
                             [this] { return _prepared_cache.memory_footprint(); },
                             sm::description("Size (in bytes) of the prepared statements cache.")),
 
+                    sm::make_derive(
+                            "unprepared_cache_hits",
+                            [] { return unprepared_statements_cache::shard_stats().hits; },
+                            sm::description("Counts the number of statements executed without being prepared which reused the cached plan of a statement differing only in its constants.")),
+
+                    sm::make_derive(
+                            "unprepared_cache_misses",
+                            [] { return unprepared_statements_cache::shard_stats().misses; },
+                            sm::description("Counts the number of statements executed without being prepared which had to be prepared and cached. A high ratio of misses to hits suggests the statements differ in more than their constants.")),
+
+                    sm::make_derive(
+                            "unprepared_cache_evictions",
+                            [] { return unprepared_statements_cache::shard_stats().evictions; },
+                            sm::description("Counts the number of unprepared statements cache entries evictions.")),
+
+                    sm::make_gauge(
+                            "unprepared_cache_size",
+                            [this] { return _unprepared_cache.size(); },
+                            sm::description("A number of entries in the unprepared statements cache.")),
+
+                    sm::make_gauge(
+                            "unprepared_cache_memory_footprint",
+                            [this] { return _unprepared_cache.memory_footprint(); },
+                            sm::description("Size (in bytes) of the unprepared statements cache.")),
+
                     sm::make_derive(
                             "secondary_index_creates",
                             _cql_stats.secondary_index_creates,
@@ -457,7 +488,164 @@ query_processor::~query_processor() {
 
 future<> query_processor::stop() {
     return _mnotifier.unregister_listener(_migration_subscriber.get()).then([this] {
-        return _authorized_prepared_cache.stop().finally([this] { return _prepared_cache.stop(); });
+        return _authorized_prepared_cache.stop().finally([this] {
+            return _prepared_cache.stop();
+        }).finally([this] {
+            return _unprepared_cache.stop();
+        });
+    });
+}
+
+static size_t remembered_statement_size(const cql_prepared_id_type& id, const sstring& query_string, const sstring& keyspace) {
+    return id.size() + query_string.size() + keyspace.size();
+}
+
+// The tables the statement reads or writes, or std::nullopt if it isn't
+// a read or a write of tables.
+static std::optional<std::vector<std::pair<sstring, sstring>>> statement_tables(cql_statement& stmt) {
+    if (auto select = dynamic_cast<statements::select_statement*>(&stmt)) {
+        return std::vector<std::pair<sstring, sstring>>{{select->keyspace(), select->column_family()}};
+    }
+    if (auto modification = dynamic_cast<statements::modification_statement*>(&stmt)) {
+        return std::vector<std::pair<sstring, sstring>>{{modification->keyspace(), modification->column_family()}};
+    }
+    if (auto batch = dynamic_cast<statements::batch_statement*>(&stmt)) {
+        std::vector<std::pair<sstring, sstring>> tables;
+        for (auto& s : batch->get_statements()) {
+            tables.emplace_back(s.statement->keyspace(), s.statement->column_family());
+        }
+        return tables;
+    }
+    return std::nullopt;
+}
+
+std::vector<cql_prepared_id_type>
+query_processor::do_remember_prepared(const cql_prepared_id_type& id, remembered_statement stmt) {
+    std::vector<cql_prepared_id_type> forgotten;
+    auto size = remembered_statement_size(id, stmt.query_string, stmt.keyspace);
+    auto [it, inserted] = _remembered_statements.emplace(id, std::move(stmt));
+    if (!inserted) {
+        return forgotten;
+    }
+    it->second.lru_it = _remembered_statements_lru.insert(_remembered_statements_lru.end(), id);
+    _remembered_statements_size += size;
+    while (_remembered_statements_size > _remembered_statements_max_size && _remembered_statements_lru.size() > 1) {
+        auto victim = _remembered_statements.find(_remembered_statements_lru.front());
+        _remembered_statements_size -= remembered_statement_size(victim->first, victim->second.query_string, victim->second.keyspace);
+        _remembered_statements.erase(victim);
+        forgotten.push_back(std::move(_remembered_statements_lru.front()));
+        _remembered_statements_lru.pop_front();
+    }
+    return forgotten;
+}
+
+future<> query_processor::forget_remembered(cql_prepared_id_type id) {
+    return container().invoke_on(0, [id = std::move(id)] (query_processor& qp) {
+        auto it = qp._remembered_statements.find(id);
+        if (it == qp._remembered_statements.end()) {
+            return make_ready_future<>();
+        }
+        qp._remembered_statements_size -= remembered_statement_size(it->first, it->second.query_string, it->second.keyspace);
+        qp._remembered_statements_lru.erase(it->second.lru_it);
+        qp._remembered_statements.erase(it);
+        return db::system_keyspace::remove_prepared_statement(id).handle_exception([] (std::exception_ptr ep) {
+            log.warn("Failed to remove a prepared statement: {}", ep);
+        });
+    });
+}
+
+future<> query_processor::remember_prepared(prepared_cache_key_type key, sstring query_string, sstring keyspace) {
+    auto prepared = get_prepared(key);
+    if (!prepared) {
+        return make_ready_future<>();
+    }
+    auto tables = statement_tables(*prepared->statement);
+    if (!tables) {
+        return make_ready_future<>();
+    }
+    std::unordered_map<utils::UUID, utils::UUID> schema_versions;
+    for (auto& [ks, cf] : *tables) {
+        auto t = _db.try_find_table(ks, cf);
+        if (!t) {
+            return make_ready_future<>();
+        }
+        schema_versions.emplace(t->schema()->id(), t->schema()->version());
+    }
+    return container().invoke_on(0, [key = std::move(key), stmt = remembered_statement{std::move(keyspace), std::move(query_string), std::move(schema_versions)}] (query_processor& qp) mutable {
+        auto& id = prepared_cache_key_type::cql_id(key);
+        if (qp._remembered_statements.contains(id)) {
+            return make_ready_future<>();
+        }
+        auto keyspace = stmt.keyspace;
+        auto query_string = stmt.query_string;
+        auto schema_versions = stmt.schema_versions;
+        auto forgotten = qp.do_remember_prepared(id, std::move(stmt));
+        return db::system_keyspace::save_prepared_statement(id, std::move(keyspace), std::move(query_string), std::move(schema_versions)).then([forgotten = std::move(forgotten)] {
+            return parallel_for_each(forgotten, [] (const cql_prepared_id_type& id) {
+                return db::system_keyspace::remove_prepared_statement(id);
+            });
+        }).handle_exception([] (std::exception_ptr ep) {
+            log.warn("Failed to save a prepared statement: {}", ep);
+        });
+    });
+}
+
+future<bool> query_processor::prepare_remembered(prepared_cache_key_type key) {
+    return container().invoke_on(0, [id = prepared_cache_key_type::cql_id(key)] (query_processor& qp) -> std::optional<remembered_statement> {
+        auto it = qp._remembered_statements.find(id);
+        if (it == qp._remembered_statements.end()) {
+            return std::nullopt;
+        }
+        qp._remembered_statements_lru.splice(qp._remembered_statements_lru.end(), qp._remembered_statements_lru, it->second.lru_it);
+        return it->second;
+    }).then([this, key = std::move(key)] (std::optional<remembered_statement> stmt) mutable {
+        if (!stmt) {
+            return make_ready_future<bool>(false);
+        }
+        for (auto& [table_id, version] : stmt->schema_versions) {
+            auto t = _db.try_find_table(table_id);
+            if (!t || t->schema()->version() != version) {
+                log.debug("Forgetting the remembered statement \"{}\", the schema of its tables changed", stmt->query_string);
+                return forget_remembered(prepared_cache_key_type::cql_id(key)).then([] {
+                    return false;
+                });
+            }
+        }
+        return do_with(std::move(key), std::move(*stmt), [this] (const prepared_cache_key_type& key, const remembered_statement& stmt) {
+            return _prepared_cache.get(key, [this, &stmt] {
+                return futurize_invoke([this, &stmt] {
+                    service::client_state client_state(service::client_state::internal_tag{});
+                    client_state.set_raw_keyspace(stmt.keyspace);
+                    return get_statement(stmt.query_string, client_state);
+                });
+            }).then([] (statements::prepared_statement::checked_weak_ptr) {
+                return true;
+            }).handle_exception([&stmt] (std::exception_ptr ep) {
+                log.debug("Failed to prepare the remembered statement \"{}\": {}", stmt.query_string, ep);
+                return false;
+            });
+        });
+    });
+}
+
+future<> query_processor::load_remembered_statements() {
+    return db::system_keyspace::load_prepared_statements().then([this] (std::vector<db::system_keyspace::prepared_statement_entry> entries) {
+        return container().invoke_on(0, [entries = std::move(entries)] (query_processor& qp) mutable {
+            std::vector<cql_prepared_id_type> forgotten;
+            for (auto& e : entries) {
+                if (e.schema_versions.empty()) {
+                    // Saved without the versions of its schemas, which can't be checked.
+                    forgotten.push_back(std::move(e.id));
+                    continue;
+                }
+                auto f = qp.do_remember_prepared(e.id, remembered_statement{std::move(e.keyspace), std::move(e.query_string), std::move(e.schema_versions)});
+                std::move(f.begin(), f.end(), std::back_inserter(forgotten));
+            }
+            log.info("Loaded {} prepared statements", qp._remembered_statements.size());
+            return parallel_for_each(forgotten, [] (const cql_prepared_id_type& id) {
+                return db::system_keyspace::remove_prepared_statement(id);
+            });
+        });
     });
 }
 
@@ -465,6 +653,14 @@ future<::shared_ptr<result_message>>
 query_processor::execute_direct_without_checking_exception_message(const sstring_view& query_string, service::query_state& query_state, query_options& options) {
     log.trace("execute_direct: \"{}\"", query_string);
     tracing::trace(query_state.get_trace_state(), "Parsing a statement");
+    if (options.get_values_count() == 0) {
+        if (auto normalized = normalize_statement(query_string)) {
+            // The cached plan is shared with the statements which differ from this one only in their
+            // constants, and so is its text, so trace the statement as the client sent it.
+            tracing::trace(query_state.get_trace_state(), "Executing \"{}\" with the plan cached for its normalized form", query_string);
+            return execute_normalized(std::move(*normalized), query_state, options);
+        }
+    }
     auto p = get_statement(query_string, query_state.get_client_state());
     auto cql_statement = p->statement;
     const auto warnings = std::move(p->warnings);
@@ -494,6 +690,60 @@ query_processor::execute_direct_without_checking_exception_message(const sstring
     });
 }
 
+future<::shared_ptr<result_message>>
+query_processor::execute_normalized(normalized_statement normalized, service::query_state& query_state, query_options& options) {
+    auto& client_state = query_state.get_client_state();
+    unprepared_statements_cache::key_type key{client_state.get_raw_keyspace(), std::move(normalized.text)};
+    if (auto prepared = _unprepared_cache.find(key)) {
+        return execute_normalized(std::move(prepared), std::move(normalized.constants), query_state, options);
+    }
+
+    auto cf_stmt = dynamic_cast<raw::cf_statement*>(normalized.statement.get());
+    if (cf_stmt) {
+        cf_stmt->prepare_keyspace(client_state);
+    }
+    ++_stats.prepare_invocations;
+    auto p = normalized.statement->prepare(_db, _cql_stats);
+    p->statement->raw_cql_statement = key.text;
+    return _unprepared_cache.get(key, [p = std::move(p)] () mutable {
+        return make_ready_future<prepared_cache_entry>(std::move(p));
+    }).then([this, constants = std::move(normalized.constants), &query_state, &options] (statements::prepared_statement::checked_weak_ptr prepared) mutable {
+        return execute_normalized(std::move(prepared), std::move(constants), query_state, options);
+    });
+}
+
+future<::shared_ptr<result_message>>
+query_processor::execute_normalized(statements::prepared_statement::checked_weak_ptr prepared, std::vector<expr::untyped_constant> constants,
+        service::query_state& query_state, query_options& options) {
+    // The constants are prepared for the markers which replaced them just as the statement would have prepared
+    // them, so an invalid constant fails the statement with the same error.
+    std::vector<cql3::raw_value> values;
+    values.reserve(constants.size());
+    for (size_t i = 0; i < constants.size(); ++i) {
+        const auto& receiver = prepared->bound_names[i];
+        values.push_back(expr::evaluate(expr::prepare_expression(constants[i], _db, receiver->ks_name, receiver), query_options::DEFAULT).value);
+    }
+    query_options normalized_options(options.get_cql_config(), options.get_consistency(), std::nullopt, std::move(values),
+            options.skip_metadata(), options.get_specific_options(), options.get_cql_serialization_format());
+    normalized_options.set_cached_pk_function_calls(options.take_cached_pk_function_calls());
+
+    auto cql_statement = prepared->statement;
+    auto warnings = prepared->warnings;
+    tracing::trace(query_state.get_trace_state(), "Processing a statement");
+    return do_with(std::move(normalized_options), [this, cql_statement = std::move(cql_statement), &query_state, warnings = std::move(warnings)] (query_options& options) mutable {
+        return cql_statement->check_access(*this, query_state.get_client_state()).then(
+                [this, cql_statement, &query_state, &options, warnings = std::move(warnings)] () mutable {
+            return process_authorized_statement(std::move(cql_statement), query_state, options).then(
+                    [warnings = std::move(warnings)] (::shared_ptr<result_message> m) {
+                        for (const auto& w : warnings) {
+                            m->add_warning(w);
+                        }
+                        return make_ready_future<::shared_ptr<result_message>>(m);
+                    });
+        });
+    });
+}
+
 future<::shared_ptr<result_message>>
 query_processor::execute_prepared_without_checking_exception_message(
         statements::prepared_statement::checked_weak_ptr prepared,
@@ -599,6 +849,9 @@ query_processor::get_statement(const sstring_view& query, const service::client_
 std::unique_ptr<raw::parsed_statement>
 query_processor::parse_statement(const sstring_view& query) {
     try {
+        if (auto statement = fast_parse_statement(query)) {
+            return statement;
+        }
         auto statement = util::do_with_parser(query,  std::mem_fn(&cql3_parser::CqlParser::query));
         if (!statement) {
             throw exceptions::syntax_exception("Parsing failed");
@@ -953,6 +1206,9 @@ void query_processor::migration_subscriber::remove_invalid_prepared_statements(
     _qp->_prepared_cache.remove_if([&] (::shared_ptr<cql_statement> stmt) {
         return this->should_invalidate(ks_name, cf_name, stmt);
     });
+    _qp->_unprepared_cache.remove_if([&] (::shared_ptr<cql_statement> stmt) {
+        return this->should_invalidate(ks_name, cf_name, stmt);
+    });
 }
 
 bool query_processor::migration_subscriber::should_invalidate(
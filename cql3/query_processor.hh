@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <list>
 #include <string_view>
 #include <unordered_map>
 
@@ -22,6 +23,7 @@
 
 #include "cql3/prepared_statements_cache.hh"
 #include "cql3/authorized_prepared_statements_cache.hh"
+#include "cql3/unprepared_statements_cache.hh"
 #include "cql3/statements/prepared_statement.hh"
 #include "exceptions/exceptions.hh"
 #include "service/migration_listener.hh"
@@ -37,6 +39,10 @@ class query_state;
 
 namespace cql3 {
 
+namespace expr {
+struct untyped_constant;
+}
+
 namespace statements {
 class batch_statement;
 
@@ -49,6 +55,7 @@ class parsed_statement;
 
 class untyped_result_set;
 class untyped_result_set_row;
+struct normalized_statement;
 
 /*!
  * \brief to allow paging, holds
@@ -87,6 +94,7 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     struct memory_config {
         size_t prepared_statment_cache_size = 0;
         size_t authorized_prepared_cache_size = 0;
+        size_t unprepared_statement_cache_size = 0;
     };
 
 private:
@@ -112,11 +120,35 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
 
     prepared_statements_cache _prepared_cache;
     authorized_prepared_statements_cache _authorized_prepared_cache;
+    // The plans of statements executed without being prepared, see execute_normalized().
+    unprepared_statements_cache _unprepared_cache;
 
     // A map for prepared statements used internally (which we don't want to mix with user statement, in particular we
     // don't bother with expiration on those.
     std::unordered_map<sstring, std::unique_ptr<statements::prepared_statement>> _internal_statements;
 
+    // The query strings of the statements prepared by clients, only kept by
+    // shard 0, see remember_prepared().
+    struct remembered_statement {
+        sstring keyspace;
+        sstring query_string;
+        // The ids of the tables the statement uses, and the versions of their
+        // schemas when it was prepared. If any of them changed since, the
+        // statement mustn't be prepared again behind the client's back.
+        std::unordered_map<utils::UUID, utils::UUID> schema_versions;
+        std::list<cql_prepared_id_type>::iterator lru_it;
+    };
+    std::unordered_map<cql_prepared_id_type, remembered_statement> _remembered_statements;
+    // The keys of _remembered_statements, least recently used first.
+    std::list<cql_prepared_id_type> _remembered_statements_lru;
+    size_t _remembered_statements_size = 0;
+    size_t _remembered_statements_max_size;
+
+    // Returns the ids of the statements forgotten to make room for this one.
+    std::vector<cql_prepared_id_type> do_remember_prepared(const cql_prepared_id_type& id, remembered_statement stmt);
+    // Forgets the statement, on shard 0, and removes it from system.prepared_statements.
+    future<> forget_remembered(cql_prepared_id_type id);
+
 public:
     static const sstring CQL_VERSION;
 
@@ -330,6 +362,27 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
 
     future<> stop();
 
+    /// Statements prepared by clients are only prepared on the shard which
+    /// receives the PREPARE. Their query strings are remembered, node-wide, by
+    /// shard 0 and saved in system.prepared_statements, so that the other
+    /// shards, and the node after a restart, can prepare them when they are
+    /// first executed instead of failing with an UNPREPARED error.
+    ///
+    /// Only reads and writes of tables are remembered: other statements, in
+    /// particular those which may hold credentials, are never saved. The
+    /// statement must be prepared on this shard.
+    future<> remember_prepared(prepared_cache_key_type key, sstring query_string, sstring keyspace);
+
+    /// Prepares the remembered statement with the given key on this shard.
+    /// Resolves to false if the statement isn't remembered, or can't be
+    /// prepared anymore, or if the schema of one of its tables changed since
+    /// it was remembered: the client has to prepare it again then, to learn
+    /// the new metadata of its results.
+    future<bool> prepare_remembered(prepared_cache_key_type key);
+
+    /// Remembers the statements saved by the previous run of the node.
+    future<> load_remembered_statements();
+
     inline
     future<::shared_ptr<cql_transport::messages::result_message>>
     execute_batch(
@@ -363,6 +416,21 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
     shared_ptr<cql_transport::messages::result_message> bounce_to_shard(unsigned shard, cql3::computed_function_values cached_fn_calls);
 
 private:
+    // Executes a statement normalized by normalize_statement(), reusing the plan of the statements which
+    // differ from it only in their constants.
+    future<::shared_ptr<cql_transport::messages::result_message>>
+    execute_normalized(
+            normalized_statement normalized,
+            service::query_state& query_state,
+            query_options& options);
+
+    future<::shared_ptr<cql_transport::messages::result_message>>
+    execute_normalized(
+            statements::prepared_statement::checked_weak_ptr prepared,
+            std::vector<expr::untyped_constant> constants,
+            service::query_state& query_state,
+            query_options& options);
+
     query_options make_internal_options(
             const statements::prepared_statement::checked_weak_ptr& p,
             const std::initializer_list<data_value>&,
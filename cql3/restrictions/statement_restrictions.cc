@@ -141,6 +141,30 @@ void with_current_binary_operator(
 }
 
 /// Every token, or if no tokens, an EQ/IN of every single PK column.
+/// Returns the bind variables of the partition columns, in schema order, if each element of partition_range is
+/// a single `column = ?`.  Returns an empty vector otherwise.
+static std::vector<expr::bind_variable> extract_partition_key_bind_variables(
+        const std::vector<expr::expression>& partition_range, const schema& schema) {
+    using namespace expr;
+    if (partition_range.size() != schema.partition_key_size()) {
+        return {};
+    }
+    std::vector<bind_variable> bind_variables(schema.partition_key_size());
+    for (const auto& e : partition_range) {
+        const auto* binop = as_if<binary_operator>(&e);
+        if (!binop || binop->op != oper_t::EQ) {
+            return {};
+        }
+        const auto* cv = as_if<column_value>(&binop->lhs);
+        const auto* bv = as_if<bind_variable>(&binop->rhs);
+        if (!cv || !bv || bv->shape != bind_variable::shape_type::scalar) {
+            return {};
+        }
+        bind_variables[schema.position(*cv->col)] = *bv;
+    }
+    return bind_variables;
+}
+
 static std::vector<expr::expression> extract_partition_range(
         const expr::expression& where_clause, schema_ptr schema) {
     using namespace expr;
@@ -432,6 +456,7 @@ statement_restrictions::statement_restrictions(data_dictionary::database db,
     if (_where.has_value()) {
         _clustering_prefix_restrictions = extract_clustering_prefix_restrictions(*_where, _schema);
         _partition_range_restrictions = extract_partition_range(*_where, _schema);
+        _partition_key_bind_variables = extract_partition_key_bind_variables(_partition_range_restrictions, *_schema);
     }
     auto cf = db.find_column_family(schema);
     auto& sim = cf.get_index_manager();
@@ -777,8 +802,19 @@ dht::partition_range_vector partition_ranges_from_singles(
         }
     }
     cartesian_product cp(column_values);
-    dht::partition_range_vector ranges(product_size);
-    std::transform(cp.begin(), cp.end(), ranges.begin(), std::bind_front(range_from_bytes, std::ref(schema)));
+    std::vector<partition_key> keys;
+    keys.reserve(product_size);
+    std::transform(cp.begin(), cp.end(), std::back_inserter(keys), [] (const std::vector<managed_bytes>& pk) {
+        return partition_key::from_exploded(pk);
+    });
+    // The tokens of the IN values are computed together, which is faster for many keys.
+    std::vector<partition_key_view> views(keys.begin(), keys.end());
+    auto tokens = dht::get_tokens(schema, views);
+    dht::partition_range_vector ranges;
+    ranges.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ranges.push_back(dht::partition_range::make_singular(query::ring_position(std::move(tokens[i]), std::move(keys[i]))));
+    }
     return ranges;
 }
 
@@ -811,6 +847,19 @@ dht::partition_range_vector statement_restrictions::get_partition_key_ranges(con
                     format("Unexpected size of token restrictions: {}", _partition_range_restrictions.size()));
         }
         return partition_ranges_from_token(_partition_range_restrictions[0], options);
+    } else if (!_partition_key_bind_variables.empty()) {
+        // The common case of a prepared single-partition query: build the key straight from the bound values.
+        std::vector<managed_bytes> pk_value;
+        pk_value.reserve(_partition_key_bind_variables.size());
+        for (const auto& bv : _partition_key_bind_variables) {
+            auto val = expr::evaluate(bv, options);
+            if (val.is_null() || val.is_unset_value()) {
+                // Let the general path deal with it.
+                return partition_ranges_from_EQs(_partition_range_restrictions, options, *_schema);
+            }
+            pk_value.push_back(std::move(val.value).to_managed_bytes());
+        }
+        return {range_from_bytes(*_schema, pk_value)};
     } else if (_partition_range_is_simple) {
         // Special case to avoid extra allocations required for a Cartesian product.
         return partition_ranges_from_EQs(_partition_range_restrictions, options, *_schema);
@@ -1131,6 +1180,10 @@ std::vector<query::clustering_range> get_single_column_clustering_bounds(
                 return {};
             }
             prior_column_values.push_back(*list);
+            // Values are sorted in ascending order, put them in clustering order.
+            if (schema.clustering_column_at(i).type->is_reversed()) {
+                std::reverse(prior_column_values.back().begin(), prior_column_values.back().end());
+            }
             product_size *= list->size();
             error_if_exceeds(product_size, size_limit);
         } else if (auto last_range = std::get_if<nonwrapping_interval<managed_bytes>>(&values)) {
@@ -1166,16 +1219,20 @@ std::vector<query::clustering_range> get_single_column_clustering_bounds(
                     ck_ranges.push_back(reverse_if_reqd({new_start, new_end}, *schema.clustering_column_at(i).type));
                 }
             }
-            sort(ck_ranges.begin(), ck_ranges.end(), range_less{schema});
+            // Already sorted, see below.
             return ck_ranges;
         }
     }
     // All prefix columns are restricted by EQ or IN.  The resulting CK ranges are just singular ranges of corresponding
     // prior_column_values.
-    std::vector<query::clustering_range> ck_ranges(product_size);
+    //
+    // Each column's values are in clustering order, and the Cartesian product varies the last column fastest, so the
+    // product is generated in clustering order, and doesn't need sorting.
+    // Sorting would compare O(n log n) pairs of compound keys, more than generating them, for large INs.
+    std::vector<query::clustering_range> ck_ranges;
+    ck_ranges.reserve(product_size);
     cartesian_product cp(prior_column_values);
-    std::transform(cp.begin(), cp.end(), ck_ranges.begin(), std::bind_front(query::clustering_range::make_singular));
-    sort(ck_ranges.begin(), ck_ranges.end(), range_less{schema});
+    std::transform(cp.begin(), cp.end(), std::back_inserter(ck_ranges), std::bind_front(query::clustering_range::make_singular));
     return ck_ranges;
 }
 
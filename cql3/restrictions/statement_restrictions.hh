@@ -113,6 +113,11 @@ class statement_restrictions {
 
     bool _partition_range_is_simple; ///< False iff _partition_range_restrictions imply a Cartesian product.
 
+    /// The bind variables of the partition columns, in schema order, when each of them is restricted by nothing
+    /// but a single `= ?`, so that the partition range can be built from the bound values without evaluating
+    /// _partition_range_restrictions.  Empty otherwise.
+    std::vector<expr::bind_variable> _partition_key_bind_variables;
+
 public:
     /**
      * Creates a new empty <code>StatementRestrictions</code>.
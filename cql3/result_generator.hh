@@ -25,13 +25,25 @@ class result_generator {
     template<typename Visitor>
     class query_result_visitor {
         const schema& _schema;
-        std::vector<bytes> _partition_key;
-        std::vector<bytes> _clustering_key;
+        // Views of the components of the keys of the current partition and
+        // row, valid while they are visited. Unlike exploding the keys, it
+        // doesn't allocate for every row.
+        std::vector<managed_bytes_view> _partition_key;
+        std::vector<managed_bytes_view> _clustering_key;
         uint64_t _partition_row_count = 0;
         uint64_t _total_row_count = 0;
         Visitor& _visitor;
         const selection::selection& _selection;
     private:
+        void accept_key_component(managed_bytes_view component) {
+            if (component.current_fragment().size() == component.size()) {
+                _visitor.accept_value(query::result_bytes_view(component.current_fragment()));
+            } else {
+                auto linearized = component.linearize();
+                _visitor.accept_value(query::result_bytes_view(bytes_view(linearized)));
+            }
+        }
+
         void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
             if (def.is_multi_cell()) {
                 _visitor.accept_value(i.next_collection_cell());
@@ -45,7 +57,10 @@ class result_generator {
             : _schema(s), _visitor(visitor), _selection(select) { }
 
         void accept_new_partition(const partition_key& key, uint64_t row_count) {
-            _partition_key = key.explode(_schema);
+            _partition_key.clear();
+            for (managed_bytes_view component : key.components(_schema)) {
+                _partition_key.push_back(component);
+            }
             accept_new_partition(row_count);
         }
         void accept_new_partition(uint64_t row_count) {
@@ -55,8 +70,11 @@ class result_generator {
 
         void accept_new_row(const clustering_key& key, query::result_row_view static_row,
                             query::result_row_view row) {
-            _clustering_key = key.explode(_schema);
+            for (managed_bytes_view component : key.components(_schema)) {
+                _clustering_key.push_back(component);
+            }
             accept_new_row(static_row, row);
+            _clustering_key.clear();
         }
         void accept_new_row(query::result_row_view static_row, query::result_row_view row) {
             auto static_row_iterator = static_row.iterator();
@@ -65,11 +83,11 @@ class result_generator {
             for (auto&& def : _selection.get_columns()) {
                 switch (def->kind) {
                 case column_kind::partition_key:
-                    _visitor.accept_value(query::result_bytes_view(bytes_view(_partition_key[def->component_index()])));
+                    accept_key_component(_partition_key[def->component_index()]);
                     break;
                 case column_kind::clustering_key:
                     if (_clustering_key.size() > def->component_index()) {
-                        _visitor.accept_value(query::result_bytes_view(bytes_view(_clustering_key[def->component_index()])));
+                        accept_key_component(_clustering_key[def->component_index()]);
                     } else {
                         _visitor.accept_value(std::nullopt);
                     }
@@ -92,7 +110,7 @@ class result_generator {
                 auto static_row_iterator = static_row.iterator();
                 for (auto&& def : _selection.get_columns()) {
                     if (def->is_partition_key()) {
-                        _visitor.accept_value(query::result_bytes_view(bytes_view(_partition_key[def->component_index()])));
+                        accept_key_component(_partition_key[def->component_index()]);
                     } else if (def->is_static()) {
                         accept_cell_value(*def, static_row_iterator);
                     } else {
@@ -101,6 +119,7 @@ class result_generator {
                 }
                 _visitor.end_row();
             }
+            _partition_key.clear();
         }
 
         uint64_t rows_read() const { return _total_row_count; }
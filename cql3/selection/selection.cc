@@ -397,6 +397,7 @@ std::unique_ptr<result_set> result_set_builder::build() {
 }
 
 result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<restrictions::statement_restrictions> restrictions,
+        const selection& selection,
         const query_options& options,
         uint64_t remaining,
         schema_ptr schema,
@@ -413,86 +414,132 @@ result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<restri
     , _per_partition_remaining(_per_partition_limit)
     , _rows_fetched_for_last_partition(rows_fetched_for_last_partition)
     , _last_pkey(std::move(last_pkey))
-{ }
+{
+    if (dynamic_pointer_cast<cql3::restrictions::multi_column_restriction>(_restrictions->get_clustering_columns_restrictions())) {
+        _multi_column_clustering_restrictions = true;
+        return;
+    }
+    // Compile the restrictions once, instead of interpreting them for every row.
+    const auto& columns = selection.get_columns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const column_definition* cdef = columns[i];
+        const restrictions::single_column_restrictions::restrictions_map* restrictions_map = nullptr;
+        switch (cdef->kind) {
+        case column_kind::static_column:
+            // fallthrough
+        case column_kind::regular_column:
+            restrictions_map = &_restrictions->get_non_pk_restriction();
+            break;
+        case column_kind::partition_key:
+            if (!_skip_pk_restrictions) {
+                restrictions_map = &_restrictions->get_single_column_partition_key_restrictions();
+            }
+            break;
+        case column_kind::clustering_key:
+            if (!_skip_ck_restrictions) {
+                restrictions_map = &_restrictions->get_single_column_clustering_key_restrictions();
+            }
+            break;
+        default:
+            break;
+        }
+        if (!restrictions_map) {
+            continue;
+        }
+        auto restr_it = restrictions_map->find(cdef);
+        if (restr_it == restrictions_map->end()) {
+            continue;
+        }
+        const expr::expression& restriction = restr_it->second->expression;
+        auto& step = _steps.emplace_back(filter_step{cdef, i, expr::compiled_restriction::compile(restriction, _options), &restriction});
+        _needs_non_pk_values |= step.compiled && !cdef->is_primary_key();
+    }
+}
+
+void result_set_builder::restrictions_filter::read_non_pk_values(const selection& selection,
+                                                                 const query::result_row_view& static_row,
+                                                                 const query::result_row_view* row) const {
+    const auto& columns = selection.get_columns();
+    _non_pk_values.assign(columns.size(), std::nullopt);
+    auto static_row_iterator = static_row.iterator();
+    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
+    auto next_value = [] (query::result_row_view::iterator_type& iter, const column_definition* cdef) -> std::optional<query::result_bytes_view> {
+        if (cdef->type->is_multi_cell()) {
+            return iter.next_collection_cell();
+        }
+        auto cell = iter.next_atomic_cell();
+        if (!cell) {
+            return std::nullopt;
+        }
+        return cell->value();
+    };
+    for (size_t i = 0; i < columns.size(); ++i) {
+        switch (columns[i]->kind) {
+        case column_kind::static_column:
+            _non_pk_values[i] = next_value(static_row_iterator, columns[i]);
+            break;
+        case column_kind::regular_column:
+            if (row_iterator) {
+                _non_pk_values[i] = next_value(*row_iterator, columns[i]);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
 
 bool result_set_builder::restrictions_filter::do_filter(const selection& selection,
                                                          const std::vector<bytes>& partition_key,
                                                          const std::vector<bytes>& clustering_key,
                                                          const query::result_row_view& static_row,
                                                          const query::result_row_view* row) const {
-    static logging::logger rlogger("restrictions_filter");
-
     if (_current_partition_key_does_not_match || _current_static_row_does_not_match || _remaining == 0 || _per_partition_remaining == 0) {
         return false;
     }
 
-    auto clustering_columns_restrictions = _restrictions->get_clustering_columns_restrictions();
-    if (dynamic_pointer_cast<cql3::restrictions::multi_column_restriction>(clustering_columns_restrictions)) {
-        clustering_key_prefix ckey = clustering_key_prefix::from_exploded(clustering_key);
+    if (_multi_column_clustering_restrictions) {
         return expr::is_satisfied_by(
-                clustering_columns_restrictions->expression,
+                _restrictions->get_clustering_columns_restrictions()->expression,
                 partition_key, clustering_key, static_row, row, selection, _options);
     }
 
-    auto static_row_iterator = static_row.iterator();
-    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
-    auto non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
-    for (auto&& cdef : selection.get_columns()) {
+    if (_needs_non_pk_values) {
+        read_non_pk_values(selection, static_row, row);
+    }
+    auto is_satisfied = [&] (const filter_step& step, auto&& value) {
+        if (step.compiled) {
+            return step.compiled->is_satisfied_by(value);
+        }
+        return expr::is_satisfied_by(*step.restriction, partition_key, clustering_key, static_row, row, selection, _options);
+    };
+    for (const auto& step : _steps) {
+        const column_definition* cdef = step.column;
         switch (cdef->kind) {
         case column_kind::static_column:
             // fallthrough
-        case column_kind::regular_column: {
-            if (cdef->kind == column_kind::regular_column && !row_iterator) {
+        case column_kind::regular_column:
+            if (cdef->kind == column_kind::regular_column && !row) {
                 continue;
             }
-            auto restr_it = non_pk_restrictions_map.find(cdef);
-            if (restr_it == non_pk_restrictions_map.end()) {
-                continue;
-            }
-            restrictions::single_column_restriction& restriction = *restr_it->second;
-            bool regular_restriction_matches = expr::is_satisfied_by(
-                    restriction.expression, partition_key, clustering_key, static_row, row, selection, _options);
-            if (!regular_restriction_matches) {
+            if (!is_satisfied(step, _non_pk_values.empty() ? std::nullopt : _non_pk_values[step.selection_index])) {
                 _current_static_row_does_not_match = (cdef->kind == column_kind::static_column);
                 return false;
             }
-            }
             break;
-        case column_kind::partition_key: {
-            if (_skip_pk_restrictions) {
-                continue;
-            }
-            auto partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
-            auto restr_it = partition_key_restrictions_map.find(cdef);
-            if (restr_it == partition_key_restrictions_map.end()) {
-                continue;
-            }
-            restrictions::single_column_restriction& restriction = *restr_it->second;
-            if (!expr::is_satisfied_by(
-                        restriction.expression, partition_key, clustering_key, static_row, row, selection, _options)) {
+        case column_kind::partition_key:
+            if (!is_satisfied(step, std::optional<bytes_view>(partition_key[cdef->id]))) {
                 _current_partition_key_does_not_match = true;
                 return false;
             }
-            }
             break;
-        case column_kind::clustering_key: {
-            if (_skip_ck_restrictions) {
-                continue;
-            }
-            auto clustering_key_restrictions_map = _restrictions->get_single_column_clustering_key_restrictions();
-            auto restr_it = clustering_key_restrictions_map.find(cdef);
-            if (restr_it == clustering_key_restrictions_map.end()) {
-                continue;
-            }
+        case column_kind::clustering_key:
             if (clustering_key.empty()) {
                 return false;
             }
-            restrictions::single_column_restriction& restriction = *restr_it->second;
-            if (!expr::is_satisfied_by(
-                        restriction.expression, partition_key, clustering_key, static_row, row, selection, _options)) {
+            if (!is_satisfied(step, cdef->id < clustering_key.size() ? std::optional<bytes_view>(clustering_key[cdef->id]) : std::nullopt)) {
                 return false;
             }
-            }
             break;
         default:
             break;
@@ -18,6 +18,7 @@
 #include "query-result-reader.hh"
 #include "cql3/column_specification.hh"
 #include "cql3/selection/selector.hh"
+#include "cql3/expr/compiled_restriction.hh"
 #include "exceptions/exceptions.hh"
 #include "unimplemented.hh"
 #include <seastar/core/thread.hh>
@@ -214,10 +215,25 @@ class result_set_builder {
         }
     };
     class restrictions_filter {
+        // A restriction on one of the selected columns.
+        struct filter_step {
+            const column_definition* column;
+            size_t selection_index;
+            std::optional<expr::compiled_restriction> compiled;
+            // Interpreted when it couldn't be compiled.
+            const expr::expression* restriction;
+        };
+
         ::shared_ptr<restrictions::statement_restrictions> _restrictions;
         const query_options& _options;
         const bool _skip_pk_restrictions;
         const bool _skip_ck_restrictions;
+        bool _multi_column_clustering_restrictions = false;
+        std::vector<filter_step> _steps;
+        bool _needs_non_pk_values = false;
+        // Values of the selected static and regular columns of the row being filtered,
+        // by their index in the selection.
+        mutable std::vector<std::optional<query::result_bytes_view>> _non_pk_values;
         mutable bool _current_partition_key_does_not_match = false;
         mutable bool _current_static_row_does_not_match = false;
         mutable uint64_t _rows_dropped = 0;
@@ -230,6 +246,7 @@ class result_set_builder {
         mutable bool _is_first_partition_on_page = true;
     public:
         explicit restrictions_filter(::shared_ptr<restrictions::statement_restrictions> restrictions,
+                const selection& selection,
                 const query_options& options,
                 uint64_t remaining,
                 schema_ptr schema,
@@ -243,6 +260,7 @@ class result_set_builder {
         }
     private:
         bool do_filter(const selection& selection, const std::vector<bytes>& pk, const std::vector<bytes>& ck, const query::result_row_view& static_row, const query::result_row_view* row) const;
+        void read_non_pk_values(const selection& selection, const query::result_row_view& static_row, const query::result_row_view* row) const;
     };
 
     result_set_builder(const selection& s, gc_clock::time_point now, cql_serialization_format sf,
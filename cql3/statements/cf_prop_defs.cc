@@ -105,6 +105,11 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
         }
         _compaction_strategy_class = sstables::compaction_strategy::type(strategy->second);
         remove_from_map_if_exists(KW_COMPACTION, COMPACTION_STRATEGY_CLASS_KEY);
+        if (*_compaction_strategy_class == sstables::compaction_strategy_type::incremental
+                && !db.features().cluster_supports_incremental_compaction_strategy()) {
+            throw exceptions::configuration_exception(sstring("The ") + KW_COMPACTION + " strategy "
+                    + sstables::compaction_strategy::name(*_compaction_strategy_class) + " can't be used unless whole cluster supports it");
+        }
 
 #if 0
        CFMetaData.validateCompactionOptions(compactionStrategyClass, compactionOptions);
@@ -124,6 +129,12 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
     if (auto caching_options = get_caching_options(); caching_options && !caching_options->enabled() && !db.features().cluster_supports_per_table_caching()) {
         throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'enabled':false\" unless whole cluster supports it");
     }
+    if (auto caching_options = get_caching_options(); caching_options && caching_options->admission_filter() && !db.features().cluster_supports_cache_admission_filter()) {
+        throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'admission_filter':true\" unless whole cluster supports it");
+    }
+    if (auto caching_options = get_caching_options(); caching_options && caching_options->pinned() && !db.features().cluster_supports_cache_pinned_tables()) {
+        throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'pinned':true\" unless whole cluster supports it");
+    }
 
     auto cdc_options = get_cdc_options(schema_extensions);
     if (cdc_options && cdc_options->enabled() && !db.features().cluster_supports_cdc()) {
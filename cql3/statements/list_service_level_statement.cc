@@ -51,7 +51,9 @@ list_service_level_statement::execute(query_processor& qp,
 
     static thread_local const std::vector<lw_shared_ptr<column_specification>> metadata({make_column("service_level", utf8_type),
         make_column("timeout", duration_type),
-        make_column("workload_type", utf8_type)
+        make_column("workload_type", utf8_type),
+        make_column("max_requests_per_second", long_type),
+        make_column("shares", int32_type)
     });
 
     return make_ready_future().then([this, &state] () {
@@ -81,10 +83,20 @@ list_service_level_statement::execute(query_processor& qp,
                     bytes_opt workload = slo.workload == qos::service_level_options::workload_type::unspecified
                             ? bytes_opt()
                             : utf8_type->decompose(qos::service_level_options::to_string(slo.workload));
+                    bytes_opt max_requests_per_second = std::visit(overloaded_functor {
+                        [&] (uint64_t v) -> bytes_opt { return long_type->decompose(int64_t(v)); },
+                        [&] (const auto&) { return bytes_opt(); },
+                    }, slo.max_requests_per_second);
+                    bytes_opt shares = std::visit(overloaded_functor {
+                        [&] (int32_t v) -> bytes_opt { return int32_type->decompose(v); },
+                        [&] (const auto&) { return bytes_opt(); },
+                    }, slo.shares);
                     rs->add_row(std::vector<bytes_opt>{
                             utf8_type->decompose(sl_name),
                             d(slo.timeout),
-                            workload});
+                            workload,
+                            max_requests_per_second,
+                            shares});
                 }
 
                 auto rows = ::make_shared<cql_transport::messages::result_message::rows>(result(std::move(std::move(rs))));
@@ -20,6 +20,7 @@
 #include "cql3/selection/selection.hh"
 #include "cql3/util.hh"
 #include "cql3/restrictions/single_column_primary_key_restrictions.hh"
+#include "cql3/restrictions/multi_column_restriction.hh"
 #include "cql3/restrictions/statement_restrictions.hh"
 #include "cql3/selection/selector_factories.hh"
 #include "validation.hh"
@@ -40,6 +41,9 @@
 #include "test/lib/select_statement_utils.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include "gms/feature_service.hh"
+#include "cql3/functions/aggregate_fcts.hh"
+#include "cql3/functions/functions.hh"
+#include "db/system_keyspace.hh"
 
 bool is_internal_keyspace(std::string_view name);
 
@@ -139,6 +143,14 @@ select_statement::select_statement(schema_ptr schema,
     _opts.set_if<query::partition_slice::option::bypass_cache>(_parameters->bypass_cache());
     _opts.set_if<query::partition_slice::option::distinct>(_parameters->is_distinct());
     _opts.set_if<query::partition_slice::option::reversed>(_is_reversed);
+
+    for (auto&& col : _selection->get_columns()) {
+        if (col->is_static()) {
+            _static_columns.push_back(col->id);
+        } else if (col->is_regular()) {
+            _regular_columns.push_back(col->id);
+        }
+    }
 }
 
 db::timeout_clock::duration select_statement::get_timeout(const service::client_state& state, const query_options& options) const {
@@ -189,26 +201,9 @@ const sstring& select_statement::column_family() const {
 query::partition_slice
 select_statement::make_partition_slice(const query_options& options) const
 {
-    query::column_id_vector static_columns;
-    query::column_id_vector regular_columns;
-
-    if (_selection->contains_static_columns()) {
-        static_columns.reserve(_selection->get_column_count());
-    }
-
-    regular_columns.reserve(_selection->get_column_count());
-
-    for (auto&& col : _selection->get_columns()) {
-        if (col->is_static()) {
-            static_columns.push_back(col->id);
-        } else if (col->is_regular()) {
-            regular_columns.push_back(col->id);
-        }
-    }
-
     if (_parameters->is_distinct()) {
         return query::partition_slice({ query::clustering_range::make_open_ended_both_sides() },
-            std::move(static_columns), {}, _opts, nullptr, options.get_cql_serialization_format());
+            _static_columns, {}, _opts, nullptr, options.get_cql_serialization_format());
     }
 
     auto bounds =_restrictions->get_clustering_bounds(options);
@@ -224,7 +219,77 @@ select_statement::make_partition_slice(const query_options& options) const
         ++_stats.reverse_queries;
     }
     return query::partition_slice(std::move(bounds),
-        std::move(static_columns), std::move(regular_columns), _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
+        _static_columns, _regular_columns, _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
+}
+
+// Appends the binary operators among the conjuncts of e to binops.
+static void collect_binary_operators(const expr::expression& e, std::vector<const expr::binary_operator*>& binops) {
+    if (auto conj = expr::as_if<expr::conjunction>(&e)) {
+        for (auto& child : conj->children) {
+            collect_binary_operators(child, binops);
+        }
+    } else if (auto binop = expr::as_if<expr::binary_operator>(&e)) {
+        binops.push_back(binop);
+    }
+}
+
+static std::optional<query::column_filter::op> to_column_filter_op(expr::oper_t op) {
+    switch (op) {
+    case expr::oper_t::EQ: return query::column_filter::op::eq;
+    case expr::oper_t::LT: return query::column_filter::op::lt;
+    case expr::oper_t::LTE: return query::column_filter::op::lte;
+    case expr::oper_t::GT: return query::column_filter::op::gt;
+    case expr::oper_t::GTE: return query::column_filter::op::gte;
+    case expr::oper_t::IN: return query::column_filter::op::in;
+    default: return std::nullopt;
+    }
+}
+
+std::vector<query::column_filter>
+select_statement::make_column_filters(query_processor& qp, const query_options& options) const {
+    std::vector<query::column_filter> filters;
+    // The filters must be a subset of what restrictions_filter checks, which
+    // gives up on everything with multi-column clustering restrictions.
+    if (!_restrictions_need_filtering
+            || dynamic_pointer_cast<restrictions::multi_column_restriction>(_restrictions->get_clustering_columns_restrictions())
+            || !qp.db().features().cluster_supports_slice_column_filters()) {
+        return filters;
+    }
+    for (auto&& [cdef, restriction] : _restrictions->get_non_pk_restriction()) {
+        if (!cdef->is_regular() || !cdef->is_atomic() || cdef->is_counter()
+                || std::find(_regular_columns.begin(), _regular_columns.end(), cdef->id) == _regular_columns.end()) {
+            continue;
+        }
+        // Any subset of the conjuncts will do: the filters only skip rows the
+        // coordinator would drop anyway.
+        std::vector<const expr::binary_operator*> binops;
+        collect_binary_operators(restriction->expression, binops);
+        for (const expr::binary_operator* binop : binops) {
+            auto cv = expr::as_if<expr::column_value>(&binop->lhs);
+            auto op = to_column_filter_op(binop->op);
+            if (!cv || cv->sub || cv->col != cdef || !op || binop->order != expr::comparison_order::cql) {
+                continue;
+            }
+            query::column_filter f{cdef->id, *op, {}};
+            if (*op == query::column_filter::op::in) {
+                const expr::constant in_list = expr::evaluate_IN_list(binop->rhs, options);
+                if (in_list.is_null() || !in_list.type->without_reversed().is_list()) {
+                    continue;
+                }
+                for (const managed_bytes& v : expr::get_list_elements(in_list)) {
+                    f.values.push_back(to_bytes(v));
+                }
+            } else {
+                auto value = expr::evaluate(binop->rhs, options).value.to_managed_bytes_opt();
+                if (!value) {
+                    continue;
+                }
+                f.values.push_back(to_bytes(*value));
+            }
+            filters.push_back(std::move(f));
+        }
+    }
+    return filters;
 }
 
 uint64_t select_statement::do_get_limit(const query_options& options,
@@ -302,6 +367,7 @@ select_statement::do_execute(query_processor& qp,
     _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
 
     auto slice = make_partition_slice(options);
+    slice.filters = make_column_filters(qp, options);
     auto max_result_size = qp.proxy().get_max_result_size(slice);
     auto command = ::make_lw_shared<query::read_command>(
             _schema->id(),
@@ -467,6 +533,7 @@ lw_shared_ptr<query::read_command>
 indexed_table_select_statement::prepare_command_for_base_query(query_processor& qp, const query_options& options,
         service::query_state& state, gc_clock::time_point now, bool use_paging) const {
     auto slice = make_partition_slice(options);
+    slice.filters = make_column_filters(qp, options);
     if (use_paging) {
         slice.options.set<query::partition_slice::option::allow_short_read>();
         slice.options.set<query::partition_slice::option::send_partition_key>();
@@ -591,6 +658,42 @@ indexed_table_select_statement::execute_base_query(
     });
 }
 
+std::vector<indexed_table_select_statement::base_query_keys>
+indexed_table_select_statement::group_base_query_keys(std::vector<primary_key>::const_iterator begin, std::vector<primary_key>::const_iterator end) const {
+    std::vector<base_query_keys> groups;
+    auto pk_eq = partition_key::equality(*_schema);
+    auto ck_less = clustering_key_prefix::less_compare(*_schema);
+    const partition_key* last_pk = nullptr;
+    for (auto it = begin; it != end;) {
+        // The keys come from the index in the order of the base table, so the
+        // rows of a partition are adjacent: read them with a single query.
+        base_query_keys keys;
+        keys.partition_ranges.push_back(dht::partition_range::make_singular(it->partition));
+        const clustering_key_prefix* last_clustering = nullptr;
+        const partition_key& pk = it->partition.key();
+        for (; it != end && pk_eq(it->partition.key(), pk); ++it) {
+            if (!it->clustering) {
+                continue;
+            }
+            // A duplicate key is read by a query of its own, as it always was.
+            if (last_clustering && !ck_less(*last_clustering, it->clustering)) {
+                break;
+            }
+            keys.row_ranges.push_back(query::clustering_range::make_singular(it->clustering));
+            last_clustering = &it->clustering;
+        }
+        // Partitions read whole, as when the table has no clustering key,
+        // don't need queries of their own either.
+        if (!groups.empty() && groups.back().row_ranges.empty() && keys.row_ranges.empty() && !pk_eq(*last_pk, pk)) {
+            groups.back().partition_ranges.push_back(std::move(keys.partition_ranges.front()));
+        } else {
+            groups.push_back(std::move(keys));
+        }
+        last_pk = &pk;
+    }
+    return groups;
+}
+
 future<std::tuple<foreign_ptr<lw_shared_ptr<query::result>>, lw_shared_ptr<query::read_command>>>
 indexed_table_select_statement::do_execute_base_query(
         query_processor& qp,
@@ -640,19 +743,16 @@ indexed_table_select_statement::do_execute_base_query(
             auto command = ::make_lw_shared<query::read_command>(*cmd);
 
             query::result_merger oneshot_merger(cmd->get_row_limit(), query::max_partitions);
-            return map_reduce(key_it, key_it_end, [this, &qp, &state, &options, cmd, timeout] (auto& key) {
-                auto command = ::make_lw_shared<query::read_command>(*cmd);
-                // for each partition, read just one clustering row (TODO: can
-                // get all needed rows of one partition at once.)
-                command->slice._row_ranges.clear();
-                if (key.clustering) {
-                    command->slice._row_ranges.push_back(query::clustering_range::make_singular(key.clustering));
-                }
-                return qp.proxy().query(_schema, command, {dht::partition_range::make_singular(key.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
-                .then([] (service::storage_proxy::coordinator_query_result qr) {
-                    return std::move(qr.query_result);
-                });
-            }, std::move(oneshot_merger)).then([is_paged, &previous_result_size, &key_it, key_it_end = std::move(key_it_end), &keys, &merger] (foreign_ptr<lw_shared_ptr<query::result>> result) {
+            return do_with(group_base_query_keys(key_it, key_it_end), [this, &qp, &state, &options, cmd, timeout, oneshot_merger = std::move(oneshot_merger)] (std::vector<base_query_keys>& groups) mutable {
+                return map_reduce(groups.begin(), groups.end(), [this, &qp, &state, &options, cmd, timeout] (base_query_keys& keys) {
+                    auto command = ::make_lw_shared<query::read_command>(*cmd);
+                    command->slice._row_ranges = std::move(keys.row_ranges);
+                    return qp.proxy().query(_schema, command, std::move(keys.partition_ranges), options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
+                    .then([] (service::storage_proxy::coordinator_query_result qr) {
+                        return std::move(qr.query_result);
+                    });
+                }, std::move(oneshot_merger));
+            }).then([is_paged, &previous_result_size, &key_it, key_it_end = std::move(key_it_end), &keys, &merger] (foreign_ptr<lw_shared_ptr<query::result>> result) {
                 auto is_short_read = result->is_short_read();
                 // Results larger than 1MB should be shipped to the client immediately
                 const bool page_limit_reached = is_paged && result->buf().size() >= query::result_memory_limiter::maximum_result_size;
@@ -761,7 +861,7 @@ select_statement::process_results(foreign_ptr<lw_shared_ptr<query::result>> resu
                 _stats.filtered_rows_read_total += *results->row_count();
                 query::result_view::consume(*results, cmd->slice,
                         cql3::selection::result_set_builder::visitor(builder, *_schema,
-                                *_selection, cql3::selection::result_set_builder::restrictions_filter(_restrictions, options, cmd->get_row_limit(), _schema, cmd->slice.partition_row_limit())));
+                                *_selection, cql3::selection::result_set_builder::restrictions_filter(_restrictions, *_selection, options, cmd->get_row_limit(), _schema, cmd->slice.partition_row_limit())));
             } else {
                 query::result_view::consume(*results, cmd->slice,
                         cql3::selection::result_set_builder::visitor(builder, *_schema,
@@ -1054,7 +1154,7 @@ indexed_table_select_statement::do_execute(query_processor& qp,
                     if (_restrictions_need_filtering) {
                         _stats.filtered_rows_read_total += *results->row_count();
                         query::result_view::consume(*results, cmd->slice, cql3::selection::result_set_builder::visitor(builder, *_schema, *_selection,
-                                cql3::selection::result_set_builder::restrictions_filter(_restrictions, options, cmd->get_row_limit(), _schema, cmd->slice.partition_row_limit())));
+                                cql3::selection::result_set_builder::restrictions_filter(_restrictions, *_selection, options, cmd->get_row_limit(), _schema, cmd->slice.partition_row_limit())));
                     } else {
                         query::result_view::consume(*results, cmd->slice, cql3::selection::result_set_builder::visitor(builder, *_schema, *_selection));
                     }
@@ -1293,8 +1393,12 @@ indexed_table_select_statement::find_index_clustering_rows(query_processor& qp,
 
 
 class parallelized_select_statement : public select_statement {
+    std::vector<query::forward_request::reduction_type> _reduction_types;
+    std::optional<std::vector<query::forward_request::aggregation_info>> _aggregation_infos;
 public:
     static ::shared_ptr<cql3::statements::select_statement> prepare(
+        std::vector<query::forward_request::reduction_type> reduction_types,
+        std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos,
         schema_ptr schema,
         uint32_t bound_terms,
         lw_shared_ptr<const parameters> parameters,
@@ -1310,6 +1414,8 @@ class parallelized_select_statement : public select_statement {
     );
 
     parallelized_select_statement(
+        std::vector<query::forward_request::reduction_type> reduction_types,
+        std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos,
         schema_ptr schema,
         uint32_t bound_terms,
         lw_shared_ptr<const parameters> parameters,
@@ -1333,6 +1439,8 @@ class parallelized_select_statement : public select_statement {
 };
 
 ::shared_ptr<cql3::statements::select_statement> parallelized_select_statement::prepare(
+    std::vector<query::forward_request::reduction_type> reduction_types,
+    std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos,
     schema_ptr schema,
     uint32_t bound_terms,
     lw_shared_ptr<const select_statement::parameters> parameters,
@@ -1347,6 +1455,8 @@ ::shared_ptr<cql3::statements::select_statement> parallelized_select_statement::
     std::unique_ptr<cql3::attributes> attrs
 ) {
     return ::make_shared<cql3::statements::parallelized_select_statement>(
+        std::move(reduction_types),
+        std::move(aggregation_infos),
         schema,
         bound_terms,
         std::move(parameters),
@@ -1363,6 +1473,8 @@ ::shared_ptr<cql3::statements::select_statement> parallelized_select_statement::
 }
 
 parallelized_select_statement::parallelized_select_statement(
+    std::vector<query::forward_request::reduction_type> reduction_types,
+    std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos,
     schema_ptr schema,
     uint32_t bound_terms,
     lw_shared_ptr<const parallelized_select_statement::parameters> parameters,
@@ -1388,7 +1500,10 @@ parallelized_select_statement::parallelized_select_statement(
     std::move(per_partition_limit),
     stats,
     std::move(attrs)
-) {
+)
+, _reduction_types(std::move(reduction_types))
+, _aggregation_infos(std::move(aggregation_infos))
+{
 }
 
 future<::shared_ptr<cql_transport::messages::result_message>>
@@ -1441,18 +1556,21 @@ parallelized_select_statement::do_execute(
     auto timeout = db::timeout_clock::now() + timeout_duration;
 
     query::forward_request req = {
-        .reduction_types = {query::forward_request::reduction_type::count},
+        .reduction_types = _reduction_types,
         .cmd = *command,
         .pr = std::move(key_ranges),
         .cl = options.get_consistency(),
         .timeout = timeout,
+        .aggregation_infos = _aggregation_infos,
     };
 
     // dispatch execution of this statement to other nodes
     return qp.forwarder().dispatch(req, state.get_trace_state()).then([this] (query::forward_result res) {
         auto meta = make_shared<metadata>(*_selection->get_result_metadata());
         auto rs = std::make_unique<result_set>(std::move(meta));
-        rs->add_column_value(*res.query_results[0]);
+        for (auto& value : res.query_results) {
+            rs->add_column_value(std::move(value));
+        }
         update_stats_rows_read(rs->size());
         return shared_ptr<cql_transport::messages::result_message>(
             make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)))
@@ -1462,6 +1580,44 @@ parallelized_select_statement::do_execute(
 
 namespace raw {
 
+// Checks whether each selector is either count(*), or one of the count, min,
+// max and sum native aggregates applied to a column, which forward_service
+// can compute on the replicas and merge. Returns std::nullopt if not, and
+// otherwise the description of each selector (std::nullopt for count(*)).
+static std::optional<std::vector<std::optional<query::forward_request::aggregation_info>>>
+get_forwardable_aggregations(const schema& schema, const std::vector<::shared_ptr<selection::raw_selector>>& select_clause) {
+    static const std::unordered_set<sstring> forwardable_functions = {"count", "min", "max", "sum"};
+
+    std::vector<std::optional<query::forward_request::aggregation_info>> ret;
+    for (auto& raw : select_clause) {
+        auto* fc = expr::as_if<expr::function_call>(&raw->selectable_);
+        if (!fc) {
+            return std::nullopt;
+        }
+        auto* name = std::get_if<functions::function_name>(&fc->func);
+        if (!name || (name->has_keyspace() && name->keyspace != db::system_keyspace::NAME)) {
+            return std::nullopt;
+        }
+        if (name->name == functions::aggregate_fcts::COUNT_ROWS_FUNCTION_NAME && fc->args.empty()) {
+            ret.emplace_back(std::nullopt);
+            continue;
+        }
+        if (!forwardable_functions.contains(name->name) || fc->args.size() != 1) {
+            return std::nullopt;
+        }
+        auto* arg = expr::as_if<expr::unresolved_identifier>(&fc->args[0]);
+        if (!arg) {
+            return std::nullopt;
+        }
+        auto* def = get_column_definition(schema, *arg->ident->prepare_column_identifier(schema));
+        if (!def || !functions::functions::find(name->as_native_function(), {def->type})) {
+            return std::nullopt;
+        }
+        ret.emplace_back(query::forward_request::aggregation_info{name->name, {def->name_as_text()}});
+    }
+    return ret;
+}
+
 static void validate_attrs(const cql3::attributes::raw& attrs) {
     if (attrs.timestamp) {
         throw exceptions::invalid_request_exception("Specifying TIMESTAMP is not legal for SELECT statement");
@@ -1570,14 +1726,37 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
 
     // Used to determine if an execution of this statement can be parallelized
     // using `forward_service`.
+    std::vector<query::forward_request::reduction_type> reduction_types;
+    std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos;
     auto can_be_forwarded = [&] {
-        return selection->is_aggregate()        // Aggregation only
-            && selection->is_count()            // Only count(*) selection is supported.
-            && !restrictions->need_filtering()  // No filtering
-            && group_by_cell_indices->empty()   // No GROUP BY
+        if (!selection->is_aggregate()          // Aggregation only
+            || restrictions->need_filtering()   // No filtering
+            || !group_by_cell_indices->empty()  // No GROUP BY
             // All potential intermediate coordinators must support forwarding
-            && db.features().cluster_supports_parallelized_aggregation()
-            && db.get_config().enable_parallelized_aggregation();
+            || !db.features().cluster_supports_parallelized_aggregation()
+            || !db.get_config().enable_parallelized_aggregation()) {
+            return false;
+        }
+        auto aggregations = get_forwardable_aggregations(*schema, _select_clause);
+        if (!aggregations) {
+            return false;
+        }
+        bool only_count = true;
+        for (auto& a : *aggregations) {
+            only_count &= !a;
+            reduction_types.push_back(a ? query::forward_request::reduction_type::aggregate : query::forward_request::reduction_type::count);
+        }
+        if (!only_count) {
+            // Older nodes only know how to count.
+            if (!db.features().cluster_supports_parallelized_native_aggregates()) {
+                return false;
+            }
+            aggregation_infos.emplace();
+            for (auto& a : *aggregations) {
+                aggregation_infos->push_back(a.value_or(query::forward_request::aggregation_info{}));
+            }
+        }
+        return true;
     };
 
     if (restrictions->uses_secondary_indexing()) {
@@ -1597,6 +1776,8 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
                 std::move(prepared_attrs));
     } else if (can_be_forwarded()) {
         stmt = parallelized_select_statement::prepare(
+            std::move(reduction_types),
+            std::move(aggregation_infos),
             schema,
             ctx.bound_variables_size(),
             _parameters,
@@ -73,6 +73,9 @@ class select_statement : public cql_statement {
     ordering_comparator_type _ordering_comparator;
 
     query::partition_slice::option_set _opts;
+    // The columns read by every query, see make_partition_slice().
+    query::column_id_vector _static_columns;
+    query::column_id_vector _regular_columns;
     cql_stats& _stats;
     const ks_selector _ks_sel;
     bool _range_scan = false;
@@ -124,6 +127,10 @@ protected :
 
     query::partition_slice make_partition_slice(const query_options& options) const;
 
+    // The restrictions the rows of the query are filtered with which the
+    // replicas can check, see query::partition_slice::filters.
+    std::vector<query::column_filter> make_column_filters(query_processor& qp, const query_options& options) const;
+
     ::shared_ptr<restrictions::statement_restrictions> get_restrictions() const;
 
     bool has_group_by() const { return _group_by_cell_indices && !_group_by_cell_indices->empty(); }
@@ -244,14 +251,27 @@ class indexed_table_select_statement : public select_statement {
             gc_clock::time_point now,
             lw_shared_ptr<const service::pager::paging_state> paging_state) const;
 
+    // The keys of a base table query of the rows in a list of clustering rows:
+    // the partitions and the rows to read from each of them.
+    struct base_query_keys {
+        dht::partition_range_vector partition_ranges;
+        query::clustering_row_ranges row_ranges;
+    };
+
+    // Groups the keys into as few queries as the read_command allows: all the
+    // rows of a partition are read by the same query, and so are all the partitions
+    // which are read whole.
+    std::vector<base_query_keys> group_base_query_keys(std::vector<primary_key>::const_iterator begin,
+            std::vector<primary_key>::const_iterator end) const;
+
     // Function for fetching the selected columns from a list of clustering rows.
     // It is currently used only in our Secondary Index implementation - ordinary
     // CQL SELECT statements do not have the syntax to request a list of rows.
-    // FIXME: The current implementation is very inefficient - it requests each
-    // row separately (and, incrementally, in parallel). Even multiple rows from a single
-    // partition are requested separately. This last case can be easily improved,
-    // but to implement the general case (multiple rows from multiple partitions)
-    // efficiently, we will need more support from other layers.
+    // FIXME: Rows of different partitions are requested separately (and,
+    // incrementally, in parallel). To implement the general case (multiple rows
+    // from multiple partitions) efficiently, we will need more support from other
+    // layers, as a read_command can only have the row ranges of one partition
+    // specific to it.
     // Keys are ordered in token order (see #3423)
     future<std::tuple<foreign_ptr<lw_shared_ptr<query::result>>, lw_shared_ptr<query::read_command>>>
     do_execute_base_query(
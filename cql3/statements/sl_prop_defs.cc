@@ -10,6 +10,7 @@
 #include "data_dictionary/data_dictionary.hh"
 #include "duration.hh"
 #include "concrete_types.hh"
+#include "utils/overloaded_functor.hh"
 #include <boost/algorithm/string/predicate.hpp>
 
 namespace cql3 {
@@ -18,7 +19,7 @@ namespace statements {
 
 void sl_prop_defs::validate() {
     static std::set<sstring> timeout_props {
-        "timeout", "workload_type"
+        "timeout", "workload_type", "max_requests_per_second", "shares"
     };
     auto get_duration = [&] (const std::optional<sstring>& repr) -> qos::service_level_options::timeout_type {
         if (!repr) {
@@ -56,6 +57,28 @@ void sl_prop_defs::validate() {
             _slo.workload = qos::service_level_options::workload_type::delete_marker;
         }
     }
+    auto get_limit = [&] (const sstring& name, int64_t min, int64_t max) -> std::variant<qos::service_level_options::unset_marker, qos::service_level_options::delete_marker, int64_t> {
+        auto repr = get_simple(name);
+        if (!repr) {
+            return qos::service_level_options::unset_marker{};
+        }
+        if (boost::algorithm::iequals(*repr, "null")) {
+            return qos::service_level_options::delete_marker{};
+        }
+        auto value = to_long(name, *repr, 0);
+        if (value < min || value > max) {
+            throw exceptions::invalid_request_exception(format("{} must be between {} and {}", name, min, max));
+        }
+        return value;
+    };
+    std::visit(overloaded_functor {
+        [&] (int64_t v) { _slo.max_requests_per_second = uint64_t(v); },
+        [&] (auto marker) { _slo.max_requests_per_second = marker; },
+    }, get_limit("max_requests_per_second", 1, std::numeric_limits<int64_t>::max()));
+    std::visit(overloaded_functor {
+        [&] (int64_t v) { _slo.shares = int32_t(v); },
+        [&] (auto marker) { _slo.shares = marker; },
+    }, get_limit("shares", qos::service_level_options::min_shares, qos::service_level_options::max_shares));
 }
 
 qos::service_level_options sl_prop_defs::get_service_level_options() const {
@@ -36,40 +36,56 @@ namespace json_helpers {
  * should be treated as case-sensitive, while regular strings should be
  * case-insensitive.
  */
-static std::unordered_map<sstring, rjson::value> handle_case_sensitivity(rjson::value&& value_map) {
-    std::unordered_map<sstring, rjson::value> case_sensitive_map;
-    for (auto it = value_map.MemberBegin(); it != value_map.MemberEnd(); ++it) {
-        sstring name(rjson::to_string_view(it->name));
-        if (name.size() > 1 && *name.begin() == '"' && name.back() == '"') {
-            case_sensitive_map.emplace(name.substr(1, name.size() - 2), std::move(it->value));
-        } else {
-            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-            case_sensitive_map.emplace(std::move(name), std::move(it->value));
-        }
+static bool is_case_sensitive(std::string_view json_name) {
+    return json_name.size() > 1 && json_name.front() == '"' && json_name.back() == '"';
+}
+
+static sstring cql_name(std::string_view json_name) {
+    if (is_case_sensitive(json_name)) {
+        return sstring(json_name.substr(1, json_name.size() - 2));
+    }
+    sstring name(json_name);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    return name;
+}
+
+static bool json_name_matches(std::string_view json_name, const column_definition& def) {
+    const bytes& name = def.name();
+    if (is_case_sensitive(json_name)) {
+        json_name = json_name.substr(1, json_name.size() - 2);
+        return std::equal(json_name.begin(), json_name.end(), name.begin(), name.end(),
+                [] (char a, int8_t b) { return a == char(b); });
     }
-    return case_sensitive_map;
+    return std::equal(json_name.begin(), json_name.end(), name.begin(), name.end(),
+            [] (char a, int8_t b) { return char(::tolower(static_cast<unsigned char>(a))) == char(b); });
 }
 
 std::unordered_map<sstring, bytes_opt>
 parse(const sstring& json_string, const std::vector<column_definition>& expected_receivers, cql_serialization_format sf) {
     std::unordered_map<sstring, bytes_opt> json_map;
-    auto prepared_map = handle_case_sensitivity(rjson::parse(json_string));
-    for (const auto& def : expected_receivers) {
-        sstring cql_name = def.name_as_text();
-        auto value_it = prepared_map.find(cql_name);
-        if (value_it == prepared_map.end()) {
+    auto value_map = rjson::parse(json_string);
+    // Each value is converted straight from the parsed document to its
+    // column's type. When a column appears several times, the first one wins.
+    std::vector<bool> bound(expected_receivers.size());
+    for (auto it = value_map.MemberBegin(); it != value_map.MemberEnd(); ++it) {
+        auto json_name = rjson::to_string_view(it->name);
+        auto def = std::find_if(expected_receivers.begin(), expected_receivers.end(), [&] (const column_definition& def) {
+            return json_name_matches(json_name, def);
+        });
+        if (def == expected_receivers.end()) {
+            throw exceptions::invalid_request_exception(format("JSON values map contains unrecognized column: {}", cql_name(json_name)));
+        }
+        auto i = def - expected_receivers.begin();
+        if (bound[i]) {
             continue;
-        } else if (value_it->second.IsNull()) {
-            json_map.emplace(std::move(cql_name), bytes_opt{});
-            prepared_map.erase(value_it);
+        }
+        bound[i] = true;
+        if (it->value.IsNull()) {
+            json_map.emplace(def->name_as_text(), bytes_opt{});
         } else {
-            json_map.emplace(std::move(cql_name), from_json_object(*def.type, std::move(value_it->second), sf));
-            prepared_map.erase(value_it);
+            json_map.emplace(def->name_as_text(), from_json_object(*def->type, it->value, sf));
         }
     }
-    if (!prepared_map.empty()) {
-        throw exceptions::invalid_request_exception(format("JSON values map contains unrecognized column: {}", prepared_map.begin()->first));
-    }
     return json_map;
 }
 
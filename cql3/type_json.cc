@@ -23,52 +23,40 @@ static inline bool is_control_char(char c) {
     return c >= 0 && c <= 0x1F;
 }
 
-static inline bool needs_escaping(const sstring& s) {
-    return std::any_of(s.begin(), s.end(), [](char c) {return is_control_char(c) || c == '"' || c == '\\';});
-}
-
-
-static sstring quote_json_string(const sstring& value) {
-    if (!needs_escaping(value)) {
-        return format("\"{}\"", value);
-    }
-    std::ostringstream oss;
-    oss << std::hex << std::uppercase << std::setfill('0');
-    oss.put('"');
-    for (char c : value) {
+static void write_json_quoted(std::string_view value, bytes_ostream& out) {
+    static constexpr char hex_digits[] = "0123456789ABCDEF";
+    out.write("\"", 1);
+    // Runs of characters which need no escaping are written at once.
+    size_t run_start = 0;
+    auto escape = [&] (size_t i, std::string_view escaped) {
+        out.write(value.data() + run_start, i - run_start);
+        out.write(escaped.data(), escaped.size());
+        run_start = i + 1;
+    };
+    for (size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
         switch (c) {
-        case '"':
-            oss.put('\\').put('"');
-            break;
-        case '\\':
-            oss.put('\\').put('\\');
-            break;
-        case '\b':
-            oss.put('\\').put('b');
-            break;
-        case '\f':
-            oss.put('\\').put('f');
-            break;
-        case '\n':
-            oss.put('\\').put('n');
-            break;
-        case '\r':
-            oss.put('\\').put('r');
-            break;
-        case '\t':
-            oss.put('\\').put('t');
-            break;
+        case '"': escape(i, "\\\""); break;
+        case '\\': escape(i, "\\\\"); break;
+        case '\b': escape(i, "\\b"); break;
+        case '\f': escape(i, "\\f"); break;
+        case '\n': escape(i, "\\n"); break;
+        case '\r': escape(i, "\\r"); break;
+        case '\t': escape(i, "\\t"); break;
         default:
             if (is_control_char(c)) {
-                oss.put('\\').put('u') << std::setw(4) << static_cast<int>(c);
-            } else {
-                oss.put(c);
+                const char u[] = {'\\', 'u', '0', '0', hex_digits[(c >> 4) & 0xf], hex_digits[c & 0xf]};
+                escape(i, std::string_view(u, sizeof(u)));
             }
             break;
         }
     }
-    oss.put('"');
-    return oss.str();
+    out.write(value.data() + run_start, value.size() - run_start);
+    out.write("\"", 1);
+}
+
+static void write_json_raw(std::string_view value, bytes_ostream& out) {
+    out.write(value.data(), value.size());
 }
 
 static int64_t to_int64_t(const rjson::value& value) {
@@ -283,189 +271,193 @@ template <typename T> static T compose_value(const integer_type_impl<T>& t, byte
     return read_be<T>(reinterpret_cast<const char*>(bv.data()));
 }
 
-static sstring to_json_string_aux(const map_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
+static void write_json_aux(const map_type_impl& t, bytes_view bv, bytes_ostream& out) {
     auto sf = cql_serialization_format::internal();
 
-    out << '{';
+    write_json_raw("{", out);
     auto size = read_collection_size(bv, sf);
     for (int i = 0; i < size; ++i) {
         auto kb = read_collection_value(bv, sf);
         auto vb = read_collection_value(bv, sf);
 
         if (i > 0) {
-            out << ", ";
+            write_json_raw(", ", out);
         }
 
         // Valid keys in JSON map must be quoted strings
         sstring string_key = to_json_string(*t.get_keys_type(), kb);
         bool is_unquoted = string_key.empty() || string_key[0] != '"';
         if (is_unquoted) {
-            out << '"';
+            write_json_raw("\"", out);
         }
-        out << string_key;
+        write_json_raw(string_key, out);
         if (is_unquoted) {
-            out << '"';
+            write_json_raw("\"", out);
         }
-        out << ": ";
-        out << to_json_string(*t.get_values_type(), vb);
+        write_json_raw(": ", out);
+        write_json(*t.get_values_type(), vb, out);
     }
-    out << '}';
-    return out.str();
-}
-
-static sstring to_json_string_aux(const set_type_impl& t, bytes_view bv) {
-    using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
-    bool first = true;
-    auto sf = cql_serialization_format::internal();
-    out << '[';
-    managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv, sf), llpdi::end(mbv, sf), [&first, &out, &t] (const managed_bytes_view& e) {
-        if (first) {
-            first = false;
-        } else {
-            out << ", ";
-        }
-        out << to_json_string(*t.get_elements_type(), e);
-    });
-    out << ']';
-    return out.str();
+    write_json_raw("}", out);
 }
 
-static sstring to_json_string_aux(const list_type_impl& t, bytes_view bv) {
+static void write_json_listlike(const abstract_type& elements_type, bytes_view bv, bytes_ostream& out) {
     using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
     bool first = true;
     auto sf = cql_serialization_format::internal();
-    out << '[';
+    write_json_raw("[", out);
     managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv, sf), llpdi::end(mbv, sf), [&first, &out, &t] (const managed_bytes_view& e) {
+    std::for_each(llpdi::begin(mbv, sf), llpdi::end(mbv, sf), [&first, &out, &elements_type] (const managed_bytes_view& e) {
         if (first) {
             first = false;
         } else {
-            out << ", ";
+            write_json_raw(", ", out);
         }
-        out << to_json_string(*t.get_elements_type(), e);
+        write_json(elements_type, e, out);
     });
-    out << ']';
-    return out.str();
+    write_json_raw("]", out);
 }
 
-static sstring to_json_string_aux(const tuple_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '[';
+static void write_json_aux(const tuple_type_impl& t, bytes_view bv, bytes_ostream& out) {
+    write_json_raw("[", out);
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            write_json_raw(", ", out);
         }
         if (*vi) {
-            // TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(**ti, **vi, out);
         } else {
-            out << "null";
+            write_json_raw("null", out);
         }
         ++ti;
         ++vi;
     }
 
-    out << ']';
-    return out.str();
+    write_json_raw("]", out);
 }
 
-static sstring to_json_string_aux(const user_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '{';
+static void write_json_aux(const user_type_impl& t, bytes_view bv, bytes_ostream& out) {
+    write_json_raw("{", out);
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     int i = 0;
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            write_json_raw(", ", out);
         }
-        out << quote_json_string(t.field_name_as_string(i)) << ": ";
+        write_json_quoted(t.field_name_as_string(i), out);
+        write_json_raw(": ", out);
         if (*vi) {
-            //TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(**ti, **vi, out);
         } else {
-            out << "null";
+            write_json_raw("null", out);
         }
         ++ti;
         ++i;
         ++vi;
     }
 
-    out << '}';
-    return out.str();
+    write_json_raw("}", out);
 }
 
 namespace {
-struct to_json_string_visitor {
+struct write_json_visitor {
     bytes_view bv;
-    sstring operator()(const reversed_type_impl& t) { return to_json_string(*t.underlying_type(), bv); }
-    template <typename T> sstring operator()(const integer_type_impl<T>& t) { return to_sstring(compose_value(t, bv)); }
-    template <typename T> sstring operator()(const floating_type_impl<T>& t) {
+    bytes_ostream& out;
+
+    void quoted(const sstring& s) { write_json_quoted(s, out); }
+    void raw(const sstring& s) { write_json_raw(s, out); }
+
+    void operator()(const reversed_type_impl& t) { write_json(*t.underlying_type(), bv, out); }
+    template <typename T> void operator()(const integer_type_impl<T>& t) { raw(to_sstring(compose_value(t, bv))); }
+    template <typename T> void operator()(const floating_type_impl<T>& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
         T d = value_cast<T>(v);
         if (std::isnan(d) || std::isinf(d)) {
-            return "null";
+            write_json_raw("null", out);
+            return;
         }
-        return to_sstring(d);
-    }
-    sstring operator()(const uuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const inet_addr_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const string_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const bytes_type_impl& t) { return quote_json_string("0x" + t.to_string(bv)); }
-    sstring operator()(const boolean_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const timestamp_date_base_class& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const timeuuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const map_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const set_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const list_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const tuple_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const user_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const simple_date_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const time_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const empty_type_impl& t) { return "null"; }
-    sstring operator()(const duration_type_impl& t) {
+        raw(to_sstring(d));
+    }
+    void operator()(const uuid_type_impl& t) { quoted(t.to_string(bv)); }
+    void operator()(const inet_addr_type_impl& t) { quoted(t.to_string(bv)); }
+    // Strings are written straight from the cell.
+    void operator()(const string_type_impl& t) {
+        write_json_quoted(std::string_view(reinterpret_cast<const char*>(bv.data()), bv.size()), out);
+    }
+    void operator()(const bytes_type_impl& t) { quoted("0x" + to_hex(bv)); }
+    void operator()(const boolean_type_impl& t) { raw(t.to_string(bv)); }
+    void operator()(const timestamp_date_base_class& t) { quoted(t.to_string(bv)); }
+    void operator()(const timeuuid_type_impl& t) { quoted(t.to_string(bv)); }
+    void operator()(const map_type_impl& t) { write_json_aux(t, bv, out); }
+    void operator()(const set_type_impl& t) { write_json_listlike(*t.get_elements_type(), bv, out); }
+    void operator()(const list_type_impl& t) { write_json_listlike(*t.get_elements_type(), bv, out); }
+    void operator()(const tuple_type_impl& t) { write_json_aux(t, bv, out); }
+    void operator()(const user_type_impl& t) { write_json_aux(t, bv, out); }
+    void operator()(const simple_date_type_impl& t) { quoted(t.to_string(bv)); }
+    void operator()(const time_type_impl& t) { raw(t.to_string(bv)); }
+    void operator()(const empty_type_impl& t) { write_json_raw("null", out); }
+    void operator()(const duration_type_impl& t) {
         auto v = t.deserialize(bv);
         if (v.is_null()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
-        return quote_json_string(t.to_string(bv));
+        quoted(t.to_string(bv));
     }
-    sstring operator()(const counter_type_impl& t) {
+    void operator()(const counter_type_impl& t) {
         // It will be called only from cql3 layer while processing query results.
-        return to_json_string(*counter_cell_view::total_value_type(), bv);
+        write_json(*counter_cell_view::total_value_type(), bv, out);
     }
-    sstring operator()(const decimal_type_impl& t) {
+    void operator()(const decimal_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<big_decimal>(v).to_string();
+        raw(value_cast<big_decimal>(v).to_string());
     }
-    sstring operator()(const varint_type_impl& t) {
+    void operator()(const varint_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<utils::multiprecision_int>(v).str();
+        raw(value_cast<utils::multiprecision_int>(v).str());
     }
 };
 }
 
+void write_json(const abstract_type& t, bytes_view bv, bytes_ostream& out) {
+    visit(t, write_json_visitor{bv, out});
+}
+
+void write_json(const abstract_type& t, const managed_bytes_view& mbv, bytes_ostream& out) {
+    with_linearized(mbv, [&] (bytes_view bv) {
+        write_json(t, bv, out);
+    });
+}
+
+static sstring to_json_sstring(const bytes_ostream& out) {
+    sstring ret(sstring::initialized_later(), out.size());
+    auto p = ret.begin();
+    for (bytes_view frag : out.fragments()) {
+        p = std::copy(frag.begin(), frag.end(), p);
+    }
+    return ret;
+}
+
 sstring to_json_string(const abstract_type& t, bytes_view bv) {
-    return visit(t, to_json_string_visitor{bv});
+    bytes_ostream out;
+    write_json(t, bv, out);
+    return to_json_sstring(out);
 }
 
 sstring to_json_string(const abstract_type& t, const managed_bytes_view& mbv) {
-    return visit(t, to_json_string_visitor{linearized(mbv)});
+    bytes_ostream out;
+    write_json(t, mbv, out);
+    return to_json_sstring(out);
 }
@@ -10,8 +10,14 @@
 
 #include "types.hh"
 #include "utils/rjson.hh"
+#include "bytes_ostream.hh"
 
 bytes from_json_object(const abstract_type &t, const rjson::value& value, cql_serialization_format sf);
+// Appends the JSON representation of the value to out. Nested values are
+// written straight to out, without intermediate strings.
+void write_json(const abstract_type& t, bytes_view bv, bytes_ostream& out);
+void write_json(const abstract_type& t, const managed_bytes_view& bv, bytes_ostream& out);
+
 sstring to_json_string(const abstract_type &t, bytes_view bv);
 sstring to_json_string(const abstract_type &t, const managed_bytes_view& bv);
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "utils/loading_cache.hh"
+#include "utils/hash.hh"
+#include "cql3/prepared_statements_cache.hh"
+
+namespace cql3 {
+
+/// \brief The key of the unprepared statements cache
+///
+/// The normalized text of the statement (see normalize_statement()) and the keyspace of the client, which
+/// unqualified table names are resolved in.
+struct unprepared_cache_key_type {
+    sstring keyspace;
+    sstring text;
+
+    bool operator==(const unprepared_cache_key_type&) const = default;
+};
+
+/// \brief Caches the plans of statements executed without being prepared
+///
+/// Statements which differ only in their constants are normalized to the same text, with the constants turned
+/// into bind markers, and share the prepared statement cached here.  The cache is bounded in size and evicts the
+/// least recently used plans first, like prepared_statements_cache.
+class unprepared_statements_cache {
+public:
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    static stats& shard_stats() {
+        static thread_local stats _stats;
+        return _stats;
+    }
+
+    struct unprepared_cache_stats_updater {
+        static void inc_hits() noexcept {}
+        static void inc_misses() noexcept {}
+        static void inc_blocks() noexcept {}
+        static void inc_evictions() noexcept {
+            ++shard_stats().evictions;
+        }
+        static void inc_unprivileged_on_cache_size_eviction() noexcept {}
+    };
+
+private:
+    struct key_hash {
+        size_t operator()(const unprepared_cache_key_type& k) const {
+            return utils::hash_combine(std::hash<sstring>()(k.keyspace), std::hash<sstring>()(k.text));
+        }
+    };
+
+    // Every plan is accessed once in the cache when it's inserted, keep it in the "unprivileged" section
+    // till the statement is executed again, so that one-off statements are evicted first.
+    using cache_type = utils::loading_cache<unprepared_cache_key_type, prepared_cache_entry, 1, utils::loading_cache_reload_enabled::no, prepared_cache_entry_size, key_hash, std::equal_to<unprepared_cache_key_type>, unprepared_cache_stats_updater, unprepared_cache_stats_updater>;
+    using cache_value_ptr = typename cache_type::value_ptr;
+    using checked_weak_ptr = typename statements::prepared_statement::checked_weak_ptr;
+
+public:
+    using key_type = unprepared_cache_key_type;
+    using value_type = checked_weak_ptr;
+
+private:
+    cache_type _cache;
+
+public:
+    unprepared_statements_cache(logging::logger& logger, size_t size)
+        : _cache(size, prepared_statements_cache::entry_expiry, logger)
+    {}
+
+    template <typename LoadFunc>
+    future<value_type> get(const key_type& key, LoadFunc&& load) {
+        return _cache.get_ptr(key, [load = std::forward<LoadFunc>(load)] (const key_type&) mutable { return load(); }).then([] (cache_value_ptr v_ptr) {
+            return make_ready_future<value_type>((*v_ptr)->checked_weak_from_this());
+        });
+    }
+
+    value_type find(const key_type& key) {
+        cache_value_ptr vp = _cache.find(key);
+        if (vp) {
+            ++shard_stats().hits;
+            return (*vp)->checked_weak_from_this();
+        }
+        ++shard_stats().misses;
+        return value_type();
+    }
+
+    template <typename Pred>
+    void remove_if(Pred&& pred) {
+        static_assert(std::is_same<bool, std::result_of_t<Pred(::shared_ptr<cql_statement>)>>::value, "Bad Pred signature");
+
+        _cache.remove_if([&pred] (const prepared_cache_entry& e) {
+            return pred(e->statement);
+        });
+    }
+
+    size_t size() const {
+        return _cache.size();
+    }
+
+    size_t memory_footprint() const {
+        return _cache.memory_footprint();
+    }
+
+    future<> stop() {
+        return _cache.stop();
+    }
+};
+}
+
+namespace std { // for unprepared_statements_cache log printouts
+inline std::ostream& operator<<(std::ostream& os, const cql3::unprepared_cache_key_type& k) {
+    os << "{keyspace: " << k.keyspace << ", text: " << k.text << "}";
+    return os;
+}
+}
@@ -10,6 +10,7 @@
  * SPDX-License-Identifier: (AGPL-3.0-or-later and Apache-2.0)
  */
 
+#include <algorithm>
 #include <chrono>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/do_with.hh>
@@ -47,7 +48,10 @@
 static logging::logger blogger("batchlog_manager");
 
 const uint32_t db::batchlog_manager::replay_interval;
-const uint32_t db::batchlog_manager::page_size;
+const uint32_t db::batchlog_manager::initial_page_size;
+const uint32_t db::batchlog_manager::min_page_size;
+const uint32_t db::batchlog_manager::max_page_size;
+const size_t db::batchlog_manager::page_memory;
 
 db::batchlog_manager::batchlog_manager(cql3::query_processor& qp, batchlog_manager_config config)
         : _qp(qp)
@@ -151,6 +155,13 @@ db_clock::duration db::batchlog_manager::get_batch_log_timeout() const {
     return _write_request_timeout * 2;
 }
 
+uint32_t db::batchlog_manager::next_page_size(uint64_t batches, uint64_t bytes) {
+    if (!bytes) {
+        return initial_page_size;
+    }
+    return std::clamp<uint64_t>(page_memory * batches / bytes, min_page_size, max_page_size);
+}
+
 future<> db::batchlog_manager::replay_all_failed_batches() {
     typedef db_clock::rep clock_type;
 
@@ -272,24 +283,35 @@ future<> db::batchlog_manager::replay_all_failed_batches() {
         blogger.debug("Started replayAllFailedBatches (cpu {})", this_shard_id());
 
         typedef ::shared_ptr<cql3::untyped_result_set> page_ptr;
-        sstring query = format("SELECT id, data, written_at, version FROM {}.{} LIMIT {:d}", system_keyspace::NAME, system_keyspace::BATCHLOG, page_size);
+        struct replay_state {
+            page_ptr page;
+            uint32_t page_size = initial_page_size;
+            uint64_t batches = 0;
+            uint64_t bytes = 0;
+        };
+        sstring query = format("SELECT id, data, written_at, version FROM {}.{} LIMIT {:d}", system_keyspace::NAME, system_keyspace::BATCHLOG, initial_page_size);
         return _qp.execute_internal(query).then([this, batch = std::move(batch)](page_ptr page) {
-            return do_with(std::move(page), [this, batch = std::move(batch)](page_ptr & page) mutable {
-                return repeat([this, &page, batch = std::move(batch)]() mutable {
-                    if (page->empty()) {
+            return do_with(replay_state{std::move(page)}, [this, batch = std::move(batch)](replay_state& st) mutable {
+                return repeat([this, &st, batch = std::move(batch)]() mutable {
+                    if (st.page->empty()) {
                         return make_ready_future<stop_iteration>(stop_iteration::yes);
                     }
-                    auto id = page->back().get_as<utils::UUID>("id");
-                    return parallel_for_each(*page, batch).then([this, &page, id]() {
-                        if (page->size() < page_size) {
+                    auto id = st.page->back().get_as<utils::UUID>("id");
+                    for (auto& row : *st.page) {
+                        st.bytes += row.has("data") ? row.get_view("data").size_bytes() : 0;
+                    }
+                    st.batches += st.page->size();
+                    return parallel_for_each(*st.page, batch).then([this, &st, id]() {
+                        if (st.page->size() < st.page_size) {
                             return make_ready_future<stop_iteration>(stop_iteration::yes); // we've exhausted the batchlog, next query would be empty.
                         }
+                        st.page_size = next_page_size(st.batches, st.bytes);
                         sstring query = format("SELECT id, data, written_at, version FROM {}.{} WHERE token(id) > token(?) LIMIT {:d}",
                                 system_keyspace::NAME,
                                 system_keyspace::BATCHLOG,
-                                page_size);
-                        return _qp.execute_internal(query, {id}).then([&page](auto res) {
-                                    page = std::move(res);
+                                st.page_size);
+                        return _qp.execute_internal(query, {id}).then([&st](auto res) {
+                                    st.page = std::move(res);
                                     return make_ready_future<stop_iteration>(stop_iteration::no);
                                 });
                     });
@@ -46,7 +46,12 @@ struct batchlog_manager_config {
 class batchlog_manager : public peering_sharded_service<batchlog_manager> {
 private:
     static constexpr uint32_t replay_interval = 60 * 1000; // milliseconds
-    static constexpr uint32_t page_size = 128; // same as HHOM, for now, w/out using any heuristics. TODO: set based on avg batch size.
+    // The first page of a replay has initial_page_size batches, the next ones
+    // as many batches of the mean size seen so far as fit in page_memory.
+    static constexpr uint32_t initial_page_size = 128;
+    static constexpr uint32_t min_page_size = 16;
+    static constexpr uint32_t max_page_size = 4096;
+    static constexpr size_t page_memory = 4 << 20;
 
     using clock_type = lowres_clock;
 
@@ -88,6 +93,7 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
     db_clock::duration get_batch_log_timeout() const;
 private:
     future<> batchlog_replay_loop();
+    static uint32_t next_page_size(uint64_t batches, uint64_t bytes);
 };
 
 }
@@ -9,9 +9,11 @@
 #pragma once
 
 #include "utils/lru.hh"
+#include "utils/frequency_sketch.hh"
 #include "utils/logalloc.hh"
 #include "partition_version.hh"
 #include "mutation_cleaner.hh"
+#include "utils/updateable_value.hh"
 
 #include <seastar/core/metrics_registration.hh>
 
@@ -44,6 +46,8 @@ class cache_tracker final {
         uint64_t row_misses;
         uint64_t partition_insertions;
         uint64_t row_insertions;
+        uint64_t probationary_row_insertions;
+        uint64_t rows_over_partition_budget;
         uint64_t static_row_insertions;
         uint64_t concurrent_misses_same_key;
         uint64_t partition_merges;
@@ -66,6 +70,9 @@ class cache_tracker final {
         uint64_t pinned_dirty_memory_overload;
         uint64_t range_tombstone_reads;
         uint64_t row_tombstone_reads;
+        uint64_t partition_admission_rejections;
+        uint64_t partition_compressions;
+        uint64_t partition_expansions;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -78,19 +85,34 @@ class cache_tracker final {
     lru _lru;
     mutation_cleaner _garbage;
     mutation_cleaner _memtable_cleaner;
+    // Access frequencies of partitions of tables with the cache admission filter
+    // enabled, allocated on first use.
+    std::unique_ptr<utils::frequency_sketch> _admission_sketch;
+    // Hash of the partition evicted last among such tables. It approximates
+    // the partition an admitted one would evict.
+    std::optional<uint64_t> _admission_victim;
+    utils::updateable_value<bool> _range_scans_probationary{false};
+    utils::updateable_value<uint32_t> _partition_row_budget{0};
+    // See set_pinned().
+    std::optional<utils::updateable_value<double>> _pinned_memory_fraction;
 private:
     void setup_metrics();
+    static uint64_t admission_hash(const dht::decorated_key& key) noexcept {
+        return key.token().raw();
+    }
 public:
     using register_metrics = bool_class<class register_metrics_tag>;
+    // Whether entries go to the probationary segment of the LRU, see lru.
+    using probationary = bool_class<class probationary_tag>;
     cache_tracker(mutation_application_stats&, register_metrics);
     cache_tracker(register_metrics = register_metrics::no);
     ~cache_tracker();
     void clear();
     void touch(rows_entry&);
-    void insert(cache_entry&);
-    void insert(partition_entry&) noexcept;
-    void insert(partition_version&) noexcept;
-    void insert(rows_entry&) noexcept;
+    void insert(cache_entry&, probationary = probationary::no);
+    void insert(partition_entry&, probationary = probationary::no) noexcept;
+    void insert(partition_version&, probationary = probationary::no) noexcept;
+    void insert(rows_entry&, probationary = probationary::no) noexcept;
     void on_remove() noexcept;
     void clear_continuity(cache_entry& ce) noexcept;
     void on_partition_erase() noexcept;
@@ -104,6 +126,14 @@ class cache_tracker final {
     void on_row_miss() noexcept;
     void on_miss_already_populated() noexcept;
     void on_mispopulate() noexcept;
+    // Admission filter, see caching_options::admission_filter().
+    // Records an access to a partition of a table with the admission filter enabled.
+    void on_partition_access(const dht::decorated_key& key);
+    // Called when such a partition is evicted from the cache.
+    void on_admission_victim(const dht::decorated_key& key) noexcept;
+    // Returns true iff the partition, which is missing in cache, is accessed more
+    // often than the last evicted one, so it's worth populating.
+    bool should_admit(const dht::decorated_key& key) noexcept;
     void on_row_processed_from_memtable() noexcept { ++_stats.rows_processed_from_memtable; }
     void on_row_dropped_from_memtable() noexcept { ++_stats.rows_dropped_from_memtable; }
     void on_row_merged_from_memtable() noexcept { ++_stats.rows_merged_from_memtable; }
@@ -118,6 +148,21 @@ class cache_tracker final {
     uint64_t partitions() const noexcept { return _stats.partitions; }
     const stats& get_stats() const noexcept { return _stats; }
     void set_compaction_scheduling_group(seastar::scheduling_group);
+    // When set, range scans populate the cache with probationary entries, which
+    // are evicted before all others, unless they are read again by other reads.
+    void set_range_scans_probationary(utils::updateable_value<bool> v) { _range_scans_probationary = std::move(v); }
+    bool range_scans_probationary() const noexcept { return _range_scans_probationary(); }
+    // When non-zero, rows which reads populate into a partition beyond that many
+    // are probationary, so that the cold parts of very wide partitions are evicted
+    // before their hot clustering ranges. See cache_entry::populated_rows().
+    void set_partition_row_budget(utils::updateable_value<uint32_t> v) { _partition_row_budget = std::move(v); }
+    uint32_t partition_row_budget() const noexcept { return _partition_row_budget(); }
+    void on_row_over_partition_budget() noexcept { ++_stats.rows_over_partition_budget; }
+    // Makes the tracker evict nothing under memory pressure, as long as its
+    // entries occupy at most the given fraction of the shard's memory. Beyond
+    // that, they are evicted as usual.
+    void set_pinned(utils::updateable_value<double> memory_fraction) { _pinned_memory_fraction = std::move(memory_fraction); }
+    bool is_pinned() const noexcept { return bool(_pinned_memory_fraction); }
     lru& get_lru() { return _lru; }
 };
 
@@ -128,22 +173,27 @@ void cache_tracker::on_remove() noexcept {
 }
 
 inline
-void cache_tracker::insert(rows_entry& entry) noexcept {
+void cache_tracker::insert(rows_entry& entry, probationary p) noexcept {
     ++_stats.row_insertions;
     ++_stats.rows;
-    _lru.add(entry);
+    if (p) {
+        ++_stats.probationary_row_insertions;
+        _lru.add_probationary(entry);
+    } else {
+        _lru.add(entry, lru_kind::rows);
+    }
 }
 
 inline
-void cache_tracker::insert(partition_version& pv) noexcept {
+void cache_tracker::insert(partition_version& pv, probationary p) noexcept {
     for (rows_entry& row : pv.partition().clustered_rows()) {
-        insert(row);
+        insert(row, p);
     }
 }
 
 inline
-void cache_tracker::insert(partition_entry& pe) noexcept {
+void cache_tracker::insert(partition_entry& pe, probationary p) noexcept {
     for (partition_version& pv : pe.versions_from_oldest()) {
-        insert(pv);
+        insert(pv, p);
     }
 }
@@ -49,11 +49,14 @@
 #include "utils/crc.hh"
 #include "utils/runtime.hh"
 #include "utils/flush_queue.hh"
+#include "utils/estimated_histogram.hh"
 #include "log.hh"
 #include "commitlog_entry.hh"
 #include "commitlog_extensions.hh"
 #include "service/priority_manager.hh"
 #include "serializer.hh"
+#include "compress.hh"
+#include "utils/buffer_input_stream.hh"
 
 #include <boost/range/numeric.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -91,6 +94,36 @@ class crc32_nbo {
     }
 };
 
+// The compression algorithm of a chunk in a segment_version_3 segment.
+enum class chunk_compression : uint32_t {
+    none = 0,
+    lz4 = 1,
+    zstd = 2,
+};
+
+static chunk_compression chunk_compression_from_name(const sstring& name) {
+    if (name.empty() || name == "none") {
+        return chunk_compression::none;
+    } else if (name == "lz4") {
+        return chunk_compression::lz4;
+    } else if (name == "zstd") {
+        return chunk_compression::zstd;
+    }
+    throw std::invalid_argument(format("Invalid commitlog compression: {}, expected lz4, zstd or none", name));
+}
+
+static compressor_ptr make_chunk_compressor(chunk_compression c) {
+    switch (c) {
+    case chunk_compression::none:
+        return {};
+    case chunk_compression::lz4:
+        return compressor::lz4;
+    case chunk_compression::zstd:
+        return compressor::create("ZstdCompressor", [] (const sstring&) -> compressor::opt_string { return std::nullopt; });
+    }
+    throw std::invalid_argument(format("Unknown commitlog chunk compression: {}", uint32_t(c)));
+}
+
 class db::cf_holder {
 public:
     virtual ~cf_holder() {};
@@ -101,6 +134,7 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     config c;
 
     c.commit_log_location = cfg.commitlog_directory();
+    c.overflow_location = cfg.commitlog_overflow_directory();
     c.metrics_category_name = "commitlog";
     c.commitlog_total_space_in_mb = cfg.commitlog_total_space_in_mb() >= 0 ? cfg.commitlog_total_space_in_mb() : (shard_available_memory * smp::count) >> 20;
     c.commitlog_segment_size_in_mb = cfg.commitlog_segment_size_in_mb();
@@ -110,6 +144,8 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.reuse_segments = cfg.commitlog_reuse_segments();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
     c.allow_going_over_size_limit = !cfg.commitlog_use_hard_size_limit();
+    c.compression = cfg.commitlog_compression();
+    c.group_commit_max_window_in_us = cfg.commitlog_group_commit_max_window_in_us();
 
     return c;
 }
@@ -230,6 +266,9 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     // we distribute stuff more or less equally across shards.
     const uint64_t max_disk_size; // per-shard
     const uint64_t disk_usage_threshold;
+    const chunk_compression compression;
+    // Null if compression is none.
+    const compressor_ptr chunk_compressor;
 
     bool _shutdown = false;
     std::optional<shared_promise<>> _shutdown_promise = {};
@@ -295,10 +334,28 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         // size allocated on disk - i.e. files created (new, reserve, recycled)
         uint64_t total_size_on_disk = 0;
         uint64_t requests_blocked_memory = 0;
+        // bytes of chunk data passed to the compressor, and bytes of it written to disk
+        uint64_t compression_input_bytes = 0;
+        uint64_t compression_output_bytes = 0;
+        uint64_t compression_time_ns = 0;
+        uint64_t uncompressible_chunks = 0;
+        uint64_t group_commits = 0;
+        uint64_t segments_moved_to_overflow = 0;
     };
 
     stats totals;
 
+    // Group commit in BATCH mode, see segment::batch_cycle().
+    // Exponential moving averages of the writers per sync, and of the sync latency.
+    double _group_commit_writers = 1;
+    double _sync_latency_us = 0;
+    // The number of writers per sync, and the latency of syncs including the group commit window.
+    utils::estimated_histogram _group_commit_writers_histogram;
+    utils::estimated_histogram _group_commit_latency_histogram;
+
+    std::chrono::microseconds group_commit_window() const;
+    void on_group_commit(uint64_t writers, std::chrono::steady_clock::duration sync_latency, std::chrono::steady_clock::duration latency);
+
     size_t pending_allocations() const {
         return _request_controller.waiters();
     }
@@ -357,6 +414,11 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
 
     future<> do_pending_deletes();
 
+    bool is_overflow_file(const sstring& filename) const {
+        return !cfg.overflow_location.empty() && std::string_view(filename).starts_with(cfg.overflow_location + "/");
+    }
+    future<> move_to_overflow(sseg_ptr);
+
     future<> delete_segments(std::vector<sstring>);
     future<> delete_file(const sstring&);
 
@@ -509,6 +571,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     utils::flush_queue<replay_position, std::less<replay_position>, clock_type> _pending_ops;
 
     uint64_t _num_allocs = 0;
+    // Resolves at the end of the current group commit window, see batch_cycle().
+    std::optional<shared_future<>> _group_commit_window;
+    std::chrono::steady_clock::time_point _group_commit_start;
 
     std::unordered_set<table_schema_version> _known_schema_versions;
 
@@ -546,6 +611,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     static constexpr size_t descriptor_header_size = 5 * sizeof(uint32_t);
     static constexpr uint32_t segment_magic = ('S'<<24) |('C'<< 16) | ('L' << 8) | 'C';
     static constexpr uint32_t multi_entry_size_magic = 0xffffffff;
+    // The chunk compression header size in segment_version_3 segments (int: algorithm + int: compressed size + int: checksum)
+    static constexpr size_t chunk_compression_header_size = 3 * sizeof(uint32_t);
+    // Larger chunks are written uncompressed, to bound the time the compression stalls the reactor.
+    static constexpr size_t max_compressed_chunk_size = 1024 * 1024;
 
     // The commit log (chained) sync marker/header size in bytes (int: length + int: checksum [segmentId, position])
     static constexpr size_t sync_marker_size = 2 * sizeof(uint32_t);
@@ -616,7 +685,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
      */
     future<sseg_ptr> finish_and_get_new(db::timeout_clock::time_point timeout) {
         //FIXME: discarded future.
-        (void)close();
+        (void)close().then([] (sseg_ptr s) {
+            return s->_segment_manager->move_to_overflow(std::move(s));
+        });
         return _segment_manager->active_segment(timeout);
     }
     void reset_sync_time() {
@@ -739,7 +810,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     void new_buffer(size_t s) {
         assert(_buffer.empty());
 
-        auto overhead = segment_overhead_size;
+        auto overhead = chunk_overhead_size();
         if (_file_pos == 0) {
             overhead += descriptor_header_size;
         }
@@ -754,9 +825,79 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         _segment_manager->totals.buffer_list_bytes += _buffer.size_bytes();
     }
 
+    size_t chunk_overhead_size() const {
+        return segment_overhead_size + (_desc.ver >= descriptor::segment_version_3 ? chunk_compression_header_size : 0);
+    }
+
     bool buffer_is_empty() const {
-        return buffer_position() <= segment_overhead_size
-                        || (_file_pos == 0 && buffer_position() <= (segment_overhead_size + descriptor_header_size));
+        return buffer_position() <= chunk_overhead_size()
+                        || (_file_pos == 0 && buffer_position() <= (chunk_overhead_size() + descriptor_header_size));
+    }
+
+    /**
+     * Writes the compression header of a segment_version_3 chunk to out, which
+     * follows the chunk header in buf. The entries of the chunk are in buf between
+     * data_offset and size.
+     *
+     * If compressing the entries saves disk blocks, returns the buffer to write
+     * instead of buf: the headers followed by the compressed entries. The chunk
+     * still spans size bytes of the file, so that replay positions are the same
+     * as in an uncompressed chunk, but only the compressed prefix is written.
+     */
+    std::optional<fragmented_temporary_buffer> compress_chunk(const fragmented_temporary_buffer& buf, fragmented_temporary_buffer::ostream& out, size_t data_offset, size_t size) {
+        auto& totals = _segment_manager->totals;
+        auto& compressor = _segment_manager->chunk_compressor;
+        auto data_size = size - data_offset;
+
+        auto algorithm = chunk_compression::none;
+        uint32_t compressed_size = 0;
+        temporary_buffer<char> compressed;
+
+        if (compressor && data_size <= max_compressed_chunk_size) {
+            auto start = std::chrono::steady_clock::now();
+            auto data = fragmented_temporary_buffer::view(buf);
+            data.remove_prefix(data_offset);
+            data.remove_suffix(buf.size_bytes() - size);
+            compressed = _segment_manager->allocate_single_buffer(align_up(data_offset + compressor->compress_max_size(data_size), _alignment), _alignment);
+            auto len = with_linearized(data, [&] (bytes_view v) {
+                return compressor->compress(reinterpret_cast<const char*>(v.data()), v.size(), compressed.get_write() + data_offset, compressed.size() - data_offset);
+            });
+            totals.compression_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            totals.compression_input_bytes += data_size;
+            if (align_up(data_offset + len, _alignment) < size) {
+                algorithm = _segment_manager->compression;
+                compressed_size = len;
+                totals.compression_output_bytes += len;
+            } else {
+                totals.compression_output_bytes += data_size;
+                ++totals.uncompressible_chunks;
+            }
+        }
+
+        crc32_nbo crc;
+        crc.process(uint32_t(algorithm));
+        crc.process(compressed_size);
+        if (compressed_size) {
+            crc.process_bytes(compressed.get() + data_offset, compressed_size);
+        }
+        write(out, uint32_t(algorithm));
+        write(out, compressed_size);
+        write(out, crc.checksum());
+
+        if (!compressed_size) {
+            return std::nullopt;
+        }
+
+        auto compressed_end = data_offset + compressed_size;
+        auto write_size = align_up(compressed_end, _alignment);
+        auto headers = *fragmented_temporary_buffer::view(buf).begin();
+        std::copy_n(headers.data(), data_offset, compressed.get_write());
+        std::fill(compressed.get_write() + compressed_end, compressed.get_write() + write_size, '\0');
+        compressed.trim(write_size);
+
+        std::vector<temporary_buffer<char>> fragments;
+        fragments.push_back(std::move(compressed));
+        return fragmented_temporary_buffer(std::move(fragments), write_size);
     }
     /**
      * Send any buffer contents to disk and get a new tmp buffer
@@ -787,6 +928,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         auto out = buf.get_ostream();
 
         auto header_size = 0;
+        std::optional<fragmented_temporary_buffer> compressed;
 
         if (off == 0) {
             // first block. write file header.
@@ -811,6 +953,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             write(out, uint32_t(_file_pos));
             write(out, crc.checksum());
 
+            if (_desc.ver >= descriptor::segment_version_3) {
+                compressed = compress_chunk(buf, out, header_size + chunk_overhead_size(), size);
+            }
+
             forget_schema_versions();
 
             clogger.trace("Writing {} entries, {} k in {} -> {}", num, size, off, off + size);
@@ -826,9 +972,11 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         // The write will be allowed to start now, but flush (below) must wait for not only this,
         // but all previous write/flush pairs.
         co_await _pending_ops.run_with_ordered_post_op(rp, [&]() -> future<> {
-            auto view = fragmented_temporary_buffer::view(buf);
-            view.remove_suffix(buf.size_bytes() - size);
-            assert(size == view.size_bytes());
+            auto& data = compressed ? *compressed : buf;
+            auto write_size = compressed ? compressed->size_bytes() : size;
+            auto view = fragmented_temporary_buffer::view(data);
+            view.remove_suffix(data.size_bytes() - write_size);
+            assert(write_size == view.size_bytes());
 
             if (view.empty()) {
                 co_return;
@@ -853,7 +1001,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                     _segment_manager->totals.active_size_on_disk += bytes;
                     ++_segment_manager->totals.cycle_count;
                     if (bytes == view.size_bytes()) {
-                        clogger.trace("Final write of {} to {}: {}/{} bytes at {}", bytes, *this, size, size, off);
+                        // A compressed chunk still occupies its uncompressed size in the file.
+                        _segment_manager->totals.active_size_on_disk += size - write_size;
+                        clogger.trace("Final write of {} to {}: {}/{} bytes at {}", bytes, *this, write_size, size, off);
                         break;
                     }
                     // gah, partial write. should always get here with dma chunk sized
@@ -861,7 +1011,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                     bytes = align_down(bytes, _alignment);
                     off += bytes;
                     view.remove_prefix(bytes);
-                    clogger.trace("Partial write of {} to {}: {}/{} bytes at at {}", bytes, *this, size - view.size_bytes(), size, off - bytes);
+                    clogger.trace("Partial write of {} to {}: {}/{} bytes at at {}", bytes, *this, write_size - view.size_bytes(), write_size, off - bytes);
                     continue;
                     // TODO: retry/ignore/fail/stop - optional behaviour in origin.
                     // we fast-fail the whole commit.
@@ -892,6 +1042,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         auto fp = _file_pos;
         try {
             co_await _pending_ops.wait_for_pending(timeout);
+            if (fp == _file_pos) {
+                co_await wait_for_group_commit(timeout);
+            }
             if (fp != _file_pos) {
                 // some other request already wrote this buffer.
                 // If so, wait for the operation at our intended file offset
@@ -910,7 +1063,12 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             } else {
                 // It is ok to leave the sync behind on timeout because there will be at most one
                 // such sync, all later allocations will block on _pending_ops until it is done.
+                auto writers = _num_allocs;
+                auto start = std::chrono::steady_clock::now();
+                auto group_start = _group_commit_window ? _group_commit_start : start;
                 co_await with_timeout(timeout, sync());
+                auto end = std::chrono::steady_clock::now();
+                _segment_manager->on_group_commit(writers, end - start, end - group_start);
             }
         } catch (...) {
             // If we get an IO exception (which we assume this is)
@@ -923,6 +1081,30 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         co_return me;
     }
 
+    /**
+     * Group commit: when a batch mode write is about to sync the buffer, it
+     * first waits for a short window, so that concurrent writes join the
+     * buffer and share the write and the sync. All the writes arriving during
+     * the window wait for the same window, and the first one to resume syncs.
+     */
+    future<> wait_for_group_commit(timeout_clock::time_point timeout) {
+        if (_group_commit_window && _group_commit_window->available()) {
+            _group_commit_window.reset();
+        }
+        if (!_group_commit_window) {
+            auto window = _segment_manager->group_commit_window();
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(timeout - timeout_clock::now());
+            window = std::min(window, remaining);
+            // A full buffer is worth writing right away.
+            if (window.count() <= 0 || buffer_position() >= default_size) {
+                co_return;
+            }
+            _group_commit_start = std::chrono::steady_clock::now();
+            _group_commit_window.emplace(seastar::sleep(window));
+        }
+        co_await _group_commit_window->get_future();
+    }
+
     void background_cycle() {
         //FIXME: discarded future
         (void)cycle().discard_result().handle_exception([] (auto ex) {
@@ -1110,6 +1292,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     sstring get_segment_name() const {
         return _desc.filename();
     }
+    const sstring& get_file_name() const {
+        return _file_name;
+    }
 };
 
 template<typename T, typename R>
@@ -1175,6 +1360,13 @@ db::commitlog::segment_manager::segment_manager(config c)
         }
         cfg.max_active_flushes = std::max(uint64_t(1), cfg.max_active_flushes / smp::count);
 
+        if (!cfg.overflow_location.empty() && cfg.extensions && !cfg.extensions->commitlog_file_extensions().empty()) {
+            // Moving a segment copies the file contents, which file extensions may
+            // tie to the file they were written to.
+            clogger.warn("Commitlog file extensions are in use, ignoring overflow directory {}", cfg.overflow_location);
+            cfg.overflow_location = {};
+        }
+
         if (!cfg.base_segment_id) {
             cfg.base_segment_id = std::chrono::duration_cast<std::chrono::milliseconds>(runtime::get_boot_time().time_since_epoch()).count() + 1;
         }
@@ -1190,6 +1382,8 @@ db::commitlog::segment_manager::segment_manager(config c)
         : (max_disk_size -
             (max_disk_size >= (max_size*2) ? max_size
                 : (max_disk_size > (max_size/2) ? (max_size/2) : max_disk_size/3))))
+    , compression(chunk_compression_from_name(cfg.compression))
+    , chunk_compressor(make_chunk_compressor(compression))
     , _flush_semaphore(cfg.max_active_flushes)
     // That is enough concurrency to allow for our largest mutation (max_mutation_size), plus
     // an existing in-flight buffer. Since we'll force the cycling() of any buffer that is bigger
@@ -1292,6 +1486,22 @@ future<> db::commitlog::segment_manager::init() {
         _segments_to_replay.push_back(cfg.commit_log_location + "/" + d.filename());
     }
 
+    if (!cfg.overflow_location.empty()) {
+        auto names = boost::copy_range<std::unordered_set<sstring>>(descs | boost::adaptors::transformed(std::mem_fn(&descriptor::filename)));
+        for (auto& d : co_await list_descriptors(cfg.overflow_location)) {
+            auto path = cfg.overflow_location + "/" + d.filename();
+            if (names.contains(d.filename())) {
+                // A move to the overflow directory was interrupted before the
+                // original was removed. The original is complete, the copy might not be.
+                clogger.info("Removing partial copy {} of an overflow segment", path);
+                co_await seastar::remove_file(path);
+                continue;
+            }
+            id = std::max(id, replay_position(d.id).base_id());
+            _segments_to_replay.push_back(std::move(path));
+        }
+    }
+
     // base id counter is [ <shard> | <base> ]
     _ids = replay_position(this_shard_id(), id).id;
     // always run the timer now, since we need to handle segment pre-alloc etc as well.
@@ -1304,6 +1514,26 @@ future<> db::commitlog::segment_manager::init() {
     arm(delay);
 }
 
+std::chrono::microseconds db::commitlog::segment_manager::group_commit_window() const {
+    // Waiting only pays off if other writes are likely to arrive during the
+    // window, which is when recent syncs were shared by several writes. Then
+    // waiting for a fraction of the sync latency adds at most that much to the
+    // latency of the writes, and lets many more of them share each sync.
+    if (cfg.mode != sync_mode::BATCH || _group_commit_writers < 2) {
+        return std::chrono::microseconds(0);
+    }
+    return std::min(std::chrono::microseconds(cfg.group_commit_max_window_in_us), std::chrono::microseconds(uint64_t(_sync_latency_us / 2)));
+}
+
+void db::commitlog::segment_manager::on_group_commit(uint64_t writers, std::chrono::steady_clock::duration sync_latency, std::chrono::steady_clock::duration latency) {
+    static constexpr double alpha = 0.1;
+    _group_commit_writers += (double(writers) - _group_commit_writers) * alpha;
+    _sync_latency_us += (std::chrono::duration<double, std::micro>(sync_latency).count() - _sync_latency_us) * alpha;
+    _group_commit_writers_histogram.add(writers);
+    _group_commit_latency_histogram.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    ++totals.group_commits;
+}
+
 void db::commitlog::segment_manager::create_counters(const sstring& metrics_category_name) {
     namespace sm = seastar::metrics;
 
@@ -1367,6 +1597,34 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
 
         sm::make_gauge("memory_buffer_bytes", totals.buffer_list_bytes,
                        sm::description("Holds the total number of bytes in internal memory buffers.")),
+
+        sm::make_derive("compression_input_bytes", totals.compression_input_bytes,
+                       sm::description("Counts a number of bytes of chunk data passed to the compressor. "
+                                       "Divide compression_output_bytes by this value to get the compression ratio.")),
+
+        sm::make_derive("compression_output_bytes", totals.compression_output_bytes,
+                       sm::description("Counts a number of bytes written to the disk for the chunk data passed to the compressor.")),
+
+        sm::make_derive("compression_time_us", [this] { return totals.compression_time_ns / 1000; },
+                       sm::description("Counts the time in microseconds spent compressing chunks.")),
+
+        sm::make_derive("uncompressible_chunks", totals.uncompressible_chunks,
+                       sm::description("Counts a number of chunks written uncompressed because compression would not save any disk blocks.")),
+
+        sm::make_derive("segments_moved_to_overflow", totals.segments_moved_to_overflow,
+                       sm::description("Counts a number of segments moved to the overflow directory while still holding unflushed data.")),
+
+        sm::make_derive("group_commits", totals.group_commits,
+                       sm::description("Counts a number of syncs done for batch mode writes, each shared by all the writes in the buffer.")),
+
+        sm::make_gauge("group_commit_window_us", [this] { return group_commit_window().count(); },
+                       sm::description("Holds the current time in microseconds a batch mode sync waits for concurrent writes to join it.")),
+
+        sm::make_histogram("group_commit_writers", sm::description("Histogram of the number of writes sharing a batch mode sync."),
+                       [this] { return _group_commit_writers_histogram.get_histogram(1, 12); }),
+
+        sm::make_histogram("group_commit_latency", sm::description("Histogram of the latency in microseconds of batch mode syncs, including the time waiting for concurrent writes."),
+                       [this] { return _group_commit_latency_histogram.get_histogram(16, 16); }),
     });
 }
 
@@ -1546,7 +1804,7 @@ future<> db::commitlog::segment_manager::rename_file(sstring from, sstring to) c
 
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment() {
     for (;;) {
-        descriptor d(next_id(), cfg.fname_prefix);
+        descriptor d(next_id(), cfg.fname_prefix, compression != chunk_compression::none ? descriptor::segment_version_3 : descriptor::segment_version_2);
         auto dst = filename(d);
         auto flags = open_flags::wo;
         if (cfg.use_o_dsync) {
@@ -1875,7 +2133,9 @@ future<> db::commitlog::segment_manager::delete_segments(std::vector<sstring> fi
             }
 
             // We allow reuse of the segment if the current disk size is less than shard max.
-            if (cfg.reuse_segments) {
+            // Segments in the overflow directory are not reused, since new segments
+            // are always created in the commitlog directory.
+            if (cfg.reuse_segments && !is_overflow_file(filename)) {
                 auto usage = totals.total_size_on_disk;
                 auto recycle = usage <= max_disk_size;
 
@@ -2021,6 +2281,93 @@ future<> db::commitlog::segment_manager::do_pending_deletes() {
     co_await delete_segments(boost::copy_range<std::vector<sstring>>(ftd | boost::adaptors::map_keys));
 }
 
+/*
+ * Moves a closed segment that still holds unflushed data from the commitlog
+ * directory to the overflow directory, so that only the active and reserve
+ * segments need room in the (fast) commitlog directory.
+ *
+ * The contents are copied and synced before the original is removed, so
+ * a crash in between leaves a complete original, and init() drops the copy.
+ */
+future<> db::commitlog::segment_manager::move_to_overflow(sseg_ptr s) {
+    if (cfg.overflow_location.empty() || _shutdown || _gate.is_closed() || s->is_clean()) {
+        co_return;
+    }
+    // Holding the gate keeps shutdown from touching the segment file until we are done.
+    auto holder = _gate.hold();
+
+    auto src = s->_file_name;
+    auto dst = cfg.overflow_location + "/" + s->_desc.filename();
+    uint64_t size = 0;
+    auto& pc = service::get_local_commitlog_priority();
+
+    clogger.debug("Moving segment {} to {}", src, dst);
+
+    file in;
+    file out;
+    std::exception_ptr ep;
+    try {
+        in = co_await open_file_dma(src, open_flags::ro);
+        out = co_await open_file_dma(dst, open_flags::wo | open_flags::create | open_flags::truncate);
+        // The overflow directory can be on a device with a larger block size.
+        size = align_up<uint64_t>(s->file_position(), std::max<uint64_t>(s->_alignment, out.disk_write_dma_alignment()));
+
+        static constexpr size_t max_read = 128 * 1024;
+        uint64_t pos = 0;
+        while (pos < size) {
+            auto buf = co_await in.dma_read_exactly<char>(pos, std::min<uint64_t>(max_read, size - pos), pc);
+            auto n = co_await out.dma_write(pos, buf.get(), buf.size(), pc);
+            if (!n) [[unlikely]] {
+                on_internal_error(clogger, format("dma_write returned 0: pos={} size={}", pos, size));
+            }
+            pos += n;
+        }
+        co_await out.flush();
+        co_await seastar::sync_directory(cfg.overflow_location);
+    } catch (...) {
+        ep = std::current_exception();
+    }
+    if (in) {
+        co_await in.close();
+    }
+
+    if (!ep && !s->is_clean()) {
+        try {
+            auto old = std::exchange(s->_file, make_checked_file(commit_error_handler, std::move(out)));
+            s->_file_name = std::move(dst);
+            co_await old.close();
+            co_await seastar::remove_file(src);
+            co_await seastar::sync_directory(cfg.commit_log_location);
+
+            // The copy is only as large as the data written to the segment.
+            totals.total_size_on_disk -= s->_size_on_disk - size;
+            totals.wasted_size_on_disk -= s->_waste;
+            s->_size_on_disk = size;
+            s->_waste = size - s->file_position();
+            totals.wasted_size_on_disk += s->_waste;
+            ++totals.segments_moved_to_overflow;
+            co_return;
+        } catch (...) {
+            // Both the original and the copy are complete at this point,
+            // and deleting the segment will delete the one we point to.
+            clogger.warn("Could not remove segment {} after moving it to {}: {}", src, s->_file_name, std::current_exception());
+            co_return;
+        }
+    }
+
+    if (out) {
+        co_await out.close();
+    }
+    if (ep) {
+        clogger.warn("Could not move segment {} to {}, keeping it in place: {}", src, dst, ep);
+    }
+    try {
+        co_await seastar::remove_file(dst);
+    } catch (...) {
+        clogger.debug("Could not remove {}: {}", dst, std::current_exception());
+    }
+}
+
 future<> db::commitlog::segment_manager::orphan_all() {
     _segments.clear();
     return clear_reserve_segments();
@@ -2085,7 +2432,7 @@ std::vector<sstring> db::commitlog::segment_manager::get_active_names() const {
     for (auto i: _segments) {
         if (!i->is_unused()) {
             // Each shared is located in its own directory
-            res.push_back(cfg.commit_log_location + "/" + i->get_segment_name());
+            res.push_back(i->get_file_name());
         }
     }
     return res;
@@ -2371,6 +2718,10 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
         commit_load_reader_func func;
         input_stream<char> fin;
         input_stream<char> r;
+        // The decompressed entries of the current chunk, if it is compressed.
+        std::optional<input_stream<char>> chunk_in;
+        chunk_compression decompressor_type = chunk_compression::none;
+        compressor_ptr decompressor;
         uint64_t id = 0;
         size_t pos = 0;
         size_t next = 0;
@@ -2406,7 +2757,11 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 eof = true;
                 pos = file_size;
             }
-            return fin.skip(bytes);
+            return stream().skip(bytes);
+        }
+        // The stream the entries of the current chunk are read from.
+        input_stream<char>& stream() {
+            return chunk_in ? *chunk_in : fin;
         }
         void stop() {
             eof = true;
@@ -2494,10 +2849,103 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 co_return co_await skip(next - pos);
             }
 
+            if (d.ver >= descriptor::segment_version_3) {
+                co_return co_await read_compressed_chunk(start);
+            }
+
             while (!end_of_chunk()) {
                 co_await read_entry();
             }
         }
+        future<> read_compressed_chunk(size_t start) {
+            auto broken_header = [&] () -> future<> {
+                clogger.debug("Segment chunk at {} has broken compression header. Skipping to next chunk ({} bytes)", start, next - start);
+                corrupt_size += next - start;
+                return skip(next - pos);
+            };
+
+            if (pos + segment::chunk_compression_header_size > next) {
+                co_return co_await broken_header();
+            }
+
+            fragmented_temporary_buffer buf = co_await frag_reader.read_exactly(fin, segment::chunk_compression_header_size);
+            if (!advance(buf)) {
+                co_return;
+            }
+
+            auto in = buf.get_istream();
+            auto algorithm = read<uint32_t>(in);
+            auto compressed_size = read<uint32_t>(in);
+            auto checksum = read<uint32_t>(in);
+
+            auto data_pos = pos;
+            if ((algorithm == uint32_t(chunk_compression::none)) != (compressed_size == 0) || compressed_size >= next - data_pos) {
+                co_return co_await broken_header();
+            }
+
+            crc32_nbo crc;
+            crc.process(algorithm);
+            crc.process(compressed_size);
+
+            fragmented_temporary_buffer compressed;
+            if (compressed_size) {
+                compressed = co_await frag_reader.read_exactly(fin, compressed_size);
+                if (!advance(compressed)) {
+                    co_return;
+                }
+                crc.process_fragmented(fragmented_temporary_buffer::view(compressed));
+            }
+            if (compressed.size_bytes() != compressed_size || crc.checksum() != checksum) {
+                co_return co_await broken_header();
+            }
+
+            if (!compressed_size) {
+                while (!end_of_chunk()) {
+                    co_await read_entry();
+                }
+                co_return;
+            }
+
+            if (algorithm > uint32_t(chunk_compression::zstd)) {
+                throw invalid_segment_format();
+            }
+            if (!decompressor || decompressor_type != chunk_compression(algorithm)) {
+                decompressor_type = chunk_compression(algorithm);
+                decompressor = make_chunk_compressor(decompressor_type);
+            }
+
+            temporary_buffer<char> data(next - data_pos);
+            auto len = with_linearized(fragmented_temporary_buffer::view(compressed), [&] (bytes_view v) {
+                return decompressor->uncompress(reinterpret_cast<const char*>(v.data()), v.size(), data.get_write(), data.size());
+            });
+            if (len != data.size()) {
+                co_return co_await broken_header();
+            }
+
+            // Entries are read from the decompressed data, at the positions
+            // they would have in an uncompressed chunk.
+            auto compressed_end = pos;
+            pos = data_pos;
+            chunk_in.emplace(make_buffer_input_stream(std::move(data)));
+            std::exception_ptr ex;
+            try {
+                while (!end_of_chunk()) {
+                    co_await read_entry();
+                }
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            chunk_in.reset();
+            if (ex) {
+                std::rethrow_exception(std::move(ex));
+            }
+            if (eof) {
+                co_return;
+            }
+
+            pos = compressed_end;
+            co_await skip(next - pos);
+        }
 
         using produce_func = std::function<future<>(buffer_and_replay_position, uint32_t)>;
 
@@ -2528,7 +2976,7 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 co_return;
             }
 
-            auto buf = co_await frag_reader.read_exactly(fin, entry_header_size);
+            auto buf = co_await frag_reader.read_exactly(stream(), entry_header_size);
 
             replay_position rp(id, position_type(pos));
 
@@ -2550,7 +2998,7 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
 
                 assert(end <= next);
                 // really small read...
-                buf = co_await frag_reader.read_exactly(fin, sizeof(uint32_t));
+                buf = co_await frag_reader.read_exactly(stream(), sizeof(uint32_t));
                 in = buf.get_istream();
                 checksum = read<uint32_t>(in);
 
@@ -2578,7 +3026,7 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                     });
                 }
                 // and verify crc.
-                buf = co_await frag_reader.read_exactly(fin, sizeof(uint32_t)); 
+                buf = co_await frag_reader.read_exactly(stream(), sizeof(uint32_t)); 
                 in = buf.get_istream();
                 checksum = read<uint32_t>(in);
 
@@ -2612,7 +3060,7 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 co_return;
             }
 
-            buf = co_await frag_reader.read_exactly(fin, size - entry_header_size);
+            buf = co_await frag_reader.read_exactly(stream(), size - entry_header_size);
 
             advance(buf);
 
@@ -2755,7 +3203,12 @@ future<std::vector<db::commitlog::descriptor>> db::commitlog::list_existing_desc
 }
 
 future<std::vector<sstring>> db::commitlog::list_existing_segments() const {
-    return list_existing_segments(active_config().commit_log_location);
+    auto segments = co_await list_existing_segments(active_config().commit_log_location);
+    if (!active_config().overflow_location.empty()) {
+        auto overflow = co_await list_existing_segments(active_config().overflow_location);
+        segments.insert(segments.end(), std::make_move_iterator(overflow.begin()), std::make_move_iterator(overflow.end()));
+    }
+    co_return segments;
 }
 
 future<std::vector<sstring>> db::commitlog::list_existing_segments(const sstring& dir) const {
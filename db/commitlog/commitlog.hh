@@ -93,6 +93,10 @@ class commitlog {
         static config from_db_config(const db::config&, size_t shard_available_memory);
 
         sstring commit_log_location;
+        // If set, segments closed while still holding unflushed data are
+        // moved here, so that commit_log_location, which can then be on a
+        // small, fast device, only holds the active and reserve segments.
+        sstring overflow_location;
         sstring metrics_category_name;
         uint64_t commitlog_total_space_in_mb = 0;
         std::optional<uint64_t> commitlog_flush_threshold_in_mb = {};
@@ -114,6 +118,16 @@ class commitlog {
         bool warn_about_segments_left_on_disk_after_shutdown = true;
         bool allow_going_over_size_limit = true;
 
+        // In BATCH mode, the maximum time a sync waits for concurrent writes
+        // to join it. The wait adapts to the observed sync latency, and is
+        // only used when writes are concurrent. Zero disables it.
+        uint64_t group_commit_max_window_in_us = 0;
+
+        // Compression of the chunks written to new segments: "lz4", "zstd",
+        // or empty for none. Segments with compressed chunks are written
+        // in the segment_version_3 format.
+        sstring compression;
+
         // The base segment ID to use.
         // The segment IDs of newly allocated segments will be issued sequentially
         // and will start _right after_ this parameter.
@@ -137,6 +151,8 @@ class commitlog {
 
         static inline constexpr uint32_t segment_version_1 = 1u;
         static inline constexpr uint32_t segment_version_2 = 2u;
+        // Every chunk carries a compression header after the chunk header.
+        static inline constexpr uint32_t segment_version_3 = 3u;
 
         descriptor(descriptor&&) noexcept = default;
         descriptor(const descriptor&) = default;
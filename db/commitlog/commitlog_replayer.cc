@@ -18,6 +18,11 @@
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/semaphore.hh>
 
 #include "commitlog.hh"
 #include "commitlog_replayer.hh"
@@ -49,6 +54,21 @@ class db::commitlog_replayer::impl {
     // not modify content), but...
     mutable seastar::sharded<column_mappings> _column_mappings;
 
+    // Replay progress of this shard, exported as metrics while the replay runs.
+    struct replay_progress {
+        uint64_t bytes = 0;
+        uint64_t applied_mutations = 0;
+        seastar::metrics::metric_groups metrics;
+
+        replay_progress();
+        future<> stop() {
+            metrics.clear();
+            return make_ready_future<>();
+        }
+    };
+
+    mutable seastar::sharded<replay_progress> _progress;
+
     friend class db::commitlog_replayer;
 public:
     impl(seastar::sharded<replica::database>& db);
@@ -60,12 +80,14 @@ class db::commitlog_replayer::impl {
         uint64_t skipped_mutations = 0;
         uint64_t applied_mutations = 0;
         uint64_t corrupt_bytes = 0;
+        uint64_t bytes = 0;
 
         stats& operator+=(const stats& s) {
             invalid_mutations += s.invalid_mutations;
             skipped_mutations += s.skipped_mutations;
             applied_mutations += s.applied_mutations;
             corrupt_bytes += s.corrupt_bytes;
+            bytes += s.bytes;
             return *this;
         }
         stats operator+(const stats& s) const {
@@ -78,15 +100,33 @@ class db::commitlog_replayer::impl {
     // move start/stop of the thread local bookkeep to "top level"
     // and also make sure to assert on it actually being started.
     future<> start() {
-        return _column_mappings.start();
+        return _column_mappings.start().then([this] {
+            return _progress.start();
+        });
     }
     future<> stop() {
-        return _column_mappings.stop();
+        return _progress.stop().then([this] {
+            return _column_mappings.stop();
+        });
     }
 
-    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp) const;
+    // An entry read from a segment, to be applied on the shard which owns it.
+    struct replay_entry {
+        commitlog_entry_reader cer;
+        // The column mapping of the entry's schema version, owned by the reading shard.
+        const column_mapping* cm;
+        replay_position rp;
+    };
+
+    class shard_batches;
+
+    future<> process(stats*, shard_batches&, commitlog::buffer_and_replay_position buf_rp) const;
     future<stats> recover(sstring file, const sstring& fname_prefix) const;
 
+    // Applies entries owned by this shard.
+    future<stats> apply(replica::database& db, std::vector<replay_entry> entries) const;
+    future<> apply(replica::database& db, replay_entry& e) const;
+
     typedef std::unordered_map<utils::UUID, replay_position> rp_map;
     typedef std::unordered_map<unsigned, rp_map> shard_rpm_map;
     typedef std::unordered_map<unsigned, replay_position> shard_rp_map;
@@ -112,6 +152,87 @@ class db::commitlog_replayer::impl {
         _min_pos;
 };
 
+// Groups the entries read from a segment by the shard which owns them, so that
+// they are sent there in batches, rather than with a cross-shard call per entry.
+// The batches are applied in the background while the segment is read, with at
+// most max_pending_batches in flight per destination shard.
+class db::commitlog_replayer::impl::shard_batches {
+    static constexpr size_t max_batch_entries = 128;
+    static constexpr size_t max_batch_bytes = 1024 * 1024;
+    static constexpr size_t max_pending_batches = 2;
+
+    struct batch {
+        std::vector<replay_entry> entries;
+        size_t bytes = 0;
+        seastar::semaphore pending{max_pending_batches};
+    };
+
+    const impl& _impl;
+    stats& _stats;
+    std::vector<batch> _batches;
+    seastar::gate _pending;
+public:
+    shard_batches(const impl& i, stats& s)
+        : _impl(i)
+        , _stats(s)
+        , _batches(smp::count)
+    {}
+
+    future<> add(unsigned shard, replay_entry e, size_t bytes) {
+        auto& b = _batches[shard];
+        b.entries.push_back(std::move(e));
+        b.bytes += bytes;
+        if (b.entries.size() >= max_batch_entries || b.bytes >= max_batch_bytes) {
+            return send(shard);
+        }
+        return make_ready_future<>();
+    }
+
+    // Sends the remaining entries and waits until all the batches are applied.
+    future<> flush() {
+        for (unsigned shard = 0; shard < _batches.size(); ++shard) {
+            if (!_batches[shard].entries.empty()) {
+                co_await send(shard);
+            }
+        }
+        co_await _pending.close();
+    }
+private:
+    future<> send(unsigned shard) {
+        auto& b = _batches[shard];
+        auto entries = std::exchange(b.entries, {});
+        b.bytes = 0;
+        auto units = co_await get_units(b.pending, 1);
+        // flush() waits for the batch.
+        (void)with_gate(_pending, [this, shard, entries = std::move(entries), units = std::move(units)] () mutable {
+            auto count = entries.size();
+            return _impl._db.invoke_on(shard, [this, entries = std::move(entries)] (replica::database& db) mutable {
+                return _impl.apply(db, std::move(entries));
+            }).then_wrapped([this, count, units = std::move(units)] (future<stats> f) {
+                try {
+                    auto s = f.get0();
+                    _impl._progress.local().applied_mutations += s.applied_mutations;
+                    _stats += s;
+                } catch (...) {
+                    _stats.invalid_mutations += count;
+                    rlogger.warn("error replaying: {}", std::current_exception());
+                }
+            });
+        });
+    }
+};
+
+db::commitlog_replayer::impl::replay_progress::replay_progress() {
+    namespace sm = seastar::metrics;
+    metrics.add_group("commitlog_replay", {
+        sm::make_derive("bytes", bytes,
+                sm::description("Counts the bytes of commitlog entries read by this shard during the commitlog replay. "
+                                "Its rate is the replay throughput.")),
+        sm::make_derive("applied_mutations", applied_mutations,
+                sm::description("Counts the mutations read by this shard and applied during the commitlog replay.")),
+    });
+}
+
 db::commitlog_replayer::impl::impl(seastar::sharded<replica::database>& db)
     : _db(db)
 {}
@@ -188,34 +309,43 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
 
     if (rp.id < gp.id) {
         rlogger.debug("skipping replay of fully-flushed {}", file);
-        return make_ready_future<stats>();
+        co_return stats();
     }
     position_type p = 0;
     if (rp.id == gp.id) {
         p = gp.pos;
     }
 
-    auto s = make_lw_shared<stats>();
+    stats s;
+    shard_batches batches(*this, s);
     auto& exts = _db.local().extensions();
 
-    return db::commitlog::read_log_file(file, fname_prefix, service::get_local_commitlog_priority(),
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1),
-            p, &exts).then_wrapped([s](future<> f) {
-        try {
-            f.get();
-        } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
-        } catch (...) {
-            throw;
-        }
-        return make_ready_future<stats>(*s);
-    });
+    std::exception_ptr ex;
+    try {
+        co_await db::commitlog::read_log_file(file, fname_prefix, service::get_local_commitlog_priority(),
+                [this, &s, &batches] (commitlog::buffer_and_replay_position buf_rp) {
+                    return process(&s, batches, std::move(buf_rp));
+                }, p, &exts);
+    } catch (commitlog::segment_data_corruption_error& e) {
+        s.corrupt_bytes += e.bytes();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    // The batches refer to s, so they must be applied even if reading failed.
+    co_await batches.flush();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return s;
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
+future<> db::commitlog_replayer::impl::process(stats* s, shard_batches& batches, commitlog::buffer_and_replay_position buf_rp) const {
     auto&& buf = buf_rp.buffer;
     auto&& rp = buf_rp.position;
     try {
+        auto bytes = buf.size_bytes();
+        s->bytes += bytes;
+        _progress.local().bytes += bytes;
 
         commitlog_entry_reader cer(buf);
         auto& fm = cer.mutation();
@@ -247,51 +377,7 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
         }
 
         auto shard = _db.local().shard_of(fm);
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp, shard, s] (replica::database& db) mutable -> future<> {
-            auto& fm = cer.mutation();
-            // TODO: might need better verification that the deserialized mutation
-            // is schema compatible. My guess is that just applying the mutation
-            // will not do this.
-            auto& cf = db.find_column_family(fm.column_family_id());
-
-            if (rlogger.is_enabled(logging::log_level::debug)) {
-                rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
-                        cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
-            }
-            if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
-                throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
-                        fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
-            }
-            // Removed forwarding "new" RP. Instead give none/empty.
-            // This is what origin does, and it should be fine.
-            // The end result should be that once sstables are flushed out
-            // their "replay_position" attribute will be empty, which is
-            // lower than anything the new session will produce.
-            if (cf.schema()->version() != fm.schema_version()) {
-                auto& local_cm = _column_mappings.local().map;
-                auto cm_it = local_cm.try_emplace(fm.schema_version(), src_cm).first;
-                const column_mapping& cm = cm_it->second;
-                mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
-                converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
-                fm.partition().accept(cm, v);
-                return do_with(std::move(m), [&db, &cf] (const mutation& m) {
-                    return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
-                });
-            } else {
-                return do_with(std::move(cer).mutation(), [&](const frozen_mutation& m) {
-                    return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
-                });
-            }
-        }).then_wrapped([s] (future<> f) {
-            try {
-                f.get();
-                s->applied_mutations++;
-            } catch (...) {
-                s->invalid_mutations++;
-                // TODO: write mutation to file like origin.
-                rlogger.warn("error replaying: {}", std::current_exception());
-            }
-        });
+        return batches.add(shard, replay_entry{std::move(cer), &src_cm, rp}, bytes);
     } catch (replica::no_such_column_family&) {
         // No such CF now? Origin just ignores this.
     } catch (...) {
@@ -303,6 +389,58 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
     return make_ready_future<>();
 }
 
+future<db::commitlog_replayer::impl::stats> db::commitlog_replayer::impl::apply(replica::database& db, std::vector<replay_entry> entries) const {
+    // Mutations commute, so the entries of a batch can be applied concurrently.
+    static constexpr size_t concurrency = 16;
+
+    stats s;
+    co_await max_concurrent_for_each(entries, concurrency, [this, &db, &s] (replay_entry& e) -> future<> {
+        try {
+            co_await apply(db, e);
+            s.applied_mutations++;
+        } catch (...) {
+            s.invalid_mutations++;
+            // TODO: write mutation to file like origin.
+            rlogger.warn("error replaying: {}", std::current_exception());
+        }
+    });
+    co_return s;
+}
+
+future<> db::commitlog_replayer::impl::apply(replica::database& db, replay_entry& e) const {
+    auto& fm = e.cer.mutation();
+    auto& rp = e.rp;
+    // TODO: might need better verification that the deserialized mutation
+    // is schema compatible. My guess is that just applying the mutation
+    // will not do this.
+    auto& cf = db.find_column_family(fm.column_family_id());
+
+    if (rlogger.is_enabled(logging::log_level::debug)) {
+        rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
+                cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
+    }
+    if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
+        throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
+                fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
+    }
+    // Removed forwarding "new" RP. Instead give none/empty.
+    // This is what origin does, and it should be fine.
+    // The end result should be that once sstables are flushed out
+    // their "replay_position" attribute will be empty, which is
+    // lower than anything the new session will produce.
+    if (cf.schema()->version() != fm.schema_version()) {
+        auto& local_cm = _column_mappings.local().map;
+        auto cm_it = local_cm.try_emplace(fm.schema_version(), *e.cm).first;
+        const column_mapping& cm = cm_it->second;
+        mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
+        converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
+        fm.partition().accept(cm, v);
+        co_await db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
+    } else {
+        co_await db.apply_in_memory(fm, cf.schema(), db::rp_handle(), db::no_timeout);
+    }
+}
+
 db::commitlog_replayer::commitlog_replayer(seastar::sharded<replica::database>& db)
     : _impl(std::make_unique<impl>(db))
 {}
@@ -328,22 +466,25 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
 
     rlogger.info("Replaying {}", join(", ", files));
 
-    // pre-compute work per shard already.
+    // pre-compute work per shard already. The segments are spread evenly
+    // over all shards rather than by the shard which wrote them, so that all
+    // shards read and parse segments even if the shard count has changed.
+    // Entries are applied on the shard which owns them anyway.
     auto map = ::make_lw_shared<shard_file_map>();
+    unsigned next_shard = 0;
     for (auto& f : files) {
-        commitlog::descriptor d(f, fname_prefix);
-        replay_position p = d;
-        map->emplace(p.shard_id() % smp::count, std::move(f));
+        map->emplace(next_shard++ % smp::count, std::move(f));
     }
+    auto start = std::chrono::steady_clock::now();
 
     return do_with(std::move(fname_prefix), [this, map] (sstring& fname_prefix) {
         return _impl->start().then([this, map, &fname_prefix] {
             return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
                 return smp::submit_to(id, [this, id, map, &fname_prefix] () {
                     auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
+                    // Segments are read one at a time per shard, to reduce mutation
+                    // congestion, but their entries are applied in batches on the
+                    // owning shards while the segment is still being read.
                     auto range = map->equal_range(id);
                     return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
                         auto&f = p.second;
@@ -364,11 +505,15 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
                         return make_ready_future<impl::stats>(*total);
                     });
                 });
-            }, impl::stats(), std::plus<impl::stats>()).then([](impl::stats totals) {
-                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped)"
+            }, impl::stats(), std::plus<impl::stats>()).then([start](impl::stats totals) {
+                auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped) in {:.2f} s ({:.2f} MB/s, {:.0f} mutations/s)"
                                 , totals.applied_mutations
                                 , totals.invalid_mutations
                                 , totals.skipped_mutations
+                                , seconds
+                                , seconds > 0 ? totals.bytes / seconds / (1024 * 1024) : 0
+                                , seconds > 0 ? totals.applied_mutations / seconds : 0
                 );
             });
         }).finally([this] {
@@ -282,6 +282,18 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , major_compaction_parallelism(this, "major_compaction_parallelism", liveness::LiveUpdate, value_status::Used, 1,
+        "The number of token ranges a major compaction of a table is split into on each shard. The ranges are compacted concurrently and their output forms a single sstable run. 1 (default) disables splitting.")
+    , compaction_index_cache_prewarm_keys(this, "compaction_index_cache_prewarm_keys", liveness::LiveUpdate, value_status::Used, 0,
+        "The maximum number of partitions present in the row cache whose index entries are loaded into the index caches of each sstable written by compaction, in the background once it replaced its inputs, as a maintenance read. Keeps reads of hot partitions from going to disk for the index after a compaction. 0 (default) disables prewarming.")
+    , compaction_backlog_write_delay_threshold(this, "compaction_backlog_write_delay_threshold", liveness::LiveUpdate, value_status::Used, 0,
+        "Writes to user tables (other than materialized view updates and hints) are delayed while the normalized compaction backlog of the shard, as seen by the compaction controller, is above this value. The delay grows with the backlog up to compaction_backlog_max_write_delay_in_ms. Has no effect with compaction_static_shares. 0 (default) disables delaying.")
+    , compaction_backlog_write_reject_threshold(this, "compaction_backlog_write_reject_threshold", liveness::LiveUpdate, value_status::Used, 0,
+        "Writes to user tables (other than materialized view updates and hints) are rejected as overloaded while the normalized compaction backlog of the shard is above this value. Has no effect with compaction_static_shares. 0 (default) disables rejecting.")
+    , compaction_backlog_max_write_delay_in_ms(this, "compaction_backlog_max_write_delay_in_ms", liveness::LiveUpdate, value_status::Used, 100,
+        "The longest delay of a write due to compaction backlog, see compaction_backlog_write_delay_threshold.")
+    , stream_receive_backlog_delay_threshold(this, "stream_receive_backlog_delay_threshold", liveness::LiveUpdate, value_status::Used, 0,
+        "Receiving streamed data which isn't written off-strategy (all but bootstrap and replace) is paused before each partition while the normalized compaction backlog of the shard is above this value, slowing the sender down. The pause grows with the backlog up to compaction_backlog_max_write_delay_in_ms. Has no effect with compaction_static_shares. 0 (default) disables pausing.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -302,14 +314,28 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory in which Scylla will put all its subdirectories. The location of individual subdirs can be overriden by the respective *_directory options.")
     , commitlog_directory(this, "commitlog_directory", value_status::Used, "",
         "The directory where the commit log is stored. For optimal write performance, it is recommended the commit log be on a separate disk partition (ideally, a separate physical device) from the data file directories.")
+    , commitlog_overflow_directory(this, "commitlog_overflow_directory", value_status::Used, "",
+        "If set, commit log segments which are no longer written to, but still hold data not yet flushed to SSTables, are moved from commitlog_directory to this directory. This allows commitlog_directory to be on a small, very fast device, which then only needs room for the active and reserve segments, with this directory on the bulk data disk. commitlog_total_space_in_mb applies to both directories together.")
     , data_file_directories(this, "data_file_directories", "datadir", value_status::Used, { },
         "The directory location where table data (SSTables) is stored")
+    , cold_storage_directory(this, "cold_storage_directory", value_status::Used, "",
+        "If set, the directory where the sstables of tables using TimeWindowCompactionStrategy with cold_storage_after_seconds are moved once all their data is older than that. Meant for a mount of a cheaper, slower storage, such as an S3-compatible object store. The data file of the sstables there is read through the in-memory page cache.")
+    , cold_storage_page_cache_size_in_mb(this, "cold_storage_page_cache_size_in_mb", value_status::Used, 256,
+        "The memory, split among the shards, holding the pages read from the data files of the sstables in cold_storage_directory. It is separate from the row cache, so that scans of cold data don't evict the cache of the hot data.")
     , hints_directory(this, "hints_directory", value_status::Used, "",
         "The directory where hints files are stored if hinted handoff is enabled.")
     , view_hints_directory(this, "view_hints_directory", value_status::Used, "",
         "The directory where materialized-view updates are stored while a view replica is unreachable.")
-    , saved_caches_directory(this, "saved_caches_directory", value_status::Unused, "",
+    , saved_caches_directory(this, "saved_caches_directory", value_status::Used, "",
         "The directory location where table key and row caches are stored.")
+    , reader_spill_directory(this, "reader_spill_directory", value_status::Used, "",
+        "The directory where reads write the state they build in memory, e.g. the rows of reversed partitions, when it grows beyond max_memory_for_unlimited_query_soft_limit. "
+        "Such reads get slower instead of failing when reaching max_memory_for_unlimited_query_hard_limit. Only used when enable_reader_spilling is set.")
+    , enable_reader_spilling(this, "enable_reader_spilling", value_status::Used, false,
+        "Let reads write the state they can't keep in memory to the reader_spill_directory, see there.")
+    , reader_spill_max_disk_size_in_mb(this, "reader_spill_max_disk_size_in_mb", value_status::Used, 1024,
+        "The maximum disk space, in megabytes, the files in reader_spill_directory may take, split evenly among shards. Reads which would go over it keep their state in memory, "
+        "and fail when reaching max_memory_for_unlimited_query_hard_limit.")
     /* Commonly used properties */
     /* Properties most frequently used when configuring Scylla. */
     /* Before starting a node for the first time, you should carefully evaluate your requirements. */
@@ -373,6 +399,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , compaction_throughput_mb_per_sec(this, "compaction_throughput_mb_per_sec", value_status::Unused, 16,
         "Throttles compaction to the specified total throughput across the entire system. The faster you insert data, the faster you need to compact in order to keep the SSTable count down. The recommended Value is 16 to 32 times the rate of write throughput (in MBs/second). Setting the value to 0 disables compaction throttling.\n"
         "Related information: Configuring compaction")
+    , backup_throughput_mb_per_sec(this, "backup_throughput_mb_per_sec", liveness::LiveUpdate, value_status::Used, 0,
+        "Throttles the upload of snapshots by the backup API to the specified total throughput across all shards of the node. Setting the value to 0 disables throttling.")
     , compaction_large_partition_warning_threshold_mb(this, "compaction_large_partition_warning_threshold_mb", value_status::Used, 1000,
         "Log a warning when writing partitions larger than this value")
     , compaction_large_row_warning_threshold_mb(this, "compaction_large_row_warning_threshold_mb", value_status::Used, 10,
@@ -403,6 +431,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Adjusts the sensitivity of the failure detector on an exponential scale. Generally this setting never needs adjusting.\n"
         "Related information: Failure detection and recovery")
     , failure_detector_timeout_in_ms(this, "failure_detector_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 20 * 1000, "Maximum time between two successful echo message before gossip mark a node down in milliseconds.\n")
+    , direct_failure_detector_ping_interval_in_ms(this, "direct_failure_detector_ping_interval_in_ms", liveness::LiveUpdate, value_status::Used, 100,
+        "Interval between two pings of the direct failure detector to each live node, in milliseconds. Coordinators avoid reading from the nodes it suspects. Set to 0 to disable.")
+    , direct_failure_detector_phi_convict_threshold(this, "direct_failure_detector_phi_convict_threshold", liveness::LiveUpdate, value_status::Used, 4,
+        "The phi above which the direct failure detector suspects a node. The phi grows by one every 2.3 mean intervals between the node's answers to pings.")
     /* Performance tuning properties */
     /* Tuning performance and system reso   urce utilization, including commit log, compaction, memory, disk I/O, CPU, reads, and writes. */
     /* Commit log settings */
@@ -430,6 +462,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
     , commitlog_use_hard_size_limit(this, "commitlog_use_hard_size_limit", value_status::Used, false,
         "Whether or not to use a hard size limit for commitlog disk usage. Default is false. Enabling this can cause latency spikes, whereas the default can lead to occasional disk usage peaks.\n")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, "",
+        "Compression of commitlog segment chunks: lz4, zstd, or empty for none. Compressing reduces the commitlog write bandwidth at the cost of CPU. Existing segments are read regardless of the setting.\n")
+    , commitlog_group_commit_max_window_in_us(this, "commitlog_group_commit_max_window_in_us", value_status::Used, 1000,
+        "In batch mode, the maximum time in microseconds a commitlog sync waits for concurrent writes to join it, so that they share one write and sync. The wait adapts to the observed sync latency, and is only used when writes are concurrent. 0 disables it.\n")
     /* Compaction settings */
     /* Related information: Configuring compaction */
     , compaction_preheat_key_cache(this, "compaction_preheat_key_cache", value_status::Unused, true,
@@ -456,8 +492,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , memtable_flush_queue_size(this, "memtable_flush_queue_size", value_status::Unused, 4,
         "The number of full memtables to allow pending flush (memtables waiting for a write thread). At a minimum, set to the maximum number of indexes created on a single table.\n"
         "Related information: Flushing data from the memtable")
-    , memtable_flush_writers(this, "memtable_flush_writers", value_status::Invalid, 1,
-        "Sets the number of memtable flush writer threads. These threads are blocked by disk I/O, and each one holds a memtable in memory while blocked. If you have a large Java heap size and many data directories, you can increase the value for better flush performance.")
+    , memtable_flush_writers(this, "memtable_flush_writers", liveness::LiveUpdate, value_status::Used, 1,
+        "Maximum number of sstables a single memtable is flushed to concurrently, per shard. A large memtable is split by token range into that many parts, of at least 256MB each, "
+        "which are written concurrently as a single sstable run, so the flush isn't limited by the speed of a single sstable writer. 1 (default) flushes each memtable to a single sstable.")
     , memtable_heap_space_in_mb(this, "memtable_heap_space_in_mb", value_status::Unused, 0,
         "Total permitted memory to use for memtables. Triggers a flush based on memtable_cleanup_threshold. Cassandra stops accepting writes when the limit is exceeded until a flush completes. If unset, sets to default.")
     , memtable_offheap_space_in_mb(this, "memtable_offheap_space_in_mb", value_status::Unused, 0,
@@ -525,12 +562,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , key_cache_size_in_mb(this, "key_cache_size_in_mb", value_status::Unused, 100,
         "A global cache setting for tables. It is the maximum size of the key cache in memory. To disable set to 0.\n"
         "Related information: nodetool setcachecapacity.")
-    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Unused, 0,
-        "Number of keys from the row cache to save.")
+    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Used, 0,
+        "Number of keys from the row cache to save, per table and shard. (0: all)")
     , row_cache_size_in_mb(this, "row_cache_size_in_mb", value_status::Unused, 0,
         "Maximum size of the row cache in memory. Row cache can save more time than key_cache_size_in_mb, but is space-intensive because it contains the entire row. Use the row cache only for hot rows or static rows. If you reduce the size, you may not get you hottest keys loaded on start up.")
-    , row_cache_save_period(this, "row_cache_save_period", value_status::Unused, 0,
-        "Duration in seconds that rows are saved in cache. Caches are saved to saved_caches_directory.")
+    , row_cache_save_period(this, "row_cache_save_period", value_status::Used, 0,
+        "Interval in seconds at which keys of partitions in row cache are saved to saved_caches_directory, to warm up the cache after a restart. (0: disabled)")
     , memory_allocator(this, "memory_allocator", value_status::Invalid, "NativeAllocator",
         "The off-heap memory allocator. In addition to caches, this property affects storage engine meta data. Supported values:\n"
         "\tNativeAllocator\n"
@@ -540,12 +577,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Counter caches properties */
     /* Counter cache helps to reduce counter locks' contention for hot counter cells. In case of RF = 1 a counter cache hit will cause Cassandra to skip the read before write entirely. With RF > 1 a counter cache hit will still help to reduce the duration of the lock hold, helping with hot counter cell updates, but will not allow skipping the read entirely. Only the local (clock, count) tuple of a counter cell is kept in memory, not the whole counter, so it's relatively cheap. */
     /* Note: Reducing the size counter cache may result in not getting the hottest keys loaded on start-up. */
-    , counter_cache_size_in_mb(this, "counter_cache_size_in_mb", value_status::Unused, 0,
-        "When no value is specified a minimum of 2.5% of Heap or 50MB. If you perform counter deletes and rely on low gc_grace_seconds, you should disable the counter cache. To disable, set to 0")
+    , counter_cache_size_in_mb(this, "counter_cache_size_in_mb", value_status::Used, 0,
+        "Memory used to cache the local shards of recently updated counter cells, split among shards and shared by all the counter tables; a counter update whose cells are all cached doesn't need to read them first. 0 (default) disables the cache.")
     , counter_cache_save_period(this, "counter_cache_save_period", value_status::Unused, 7200,
         "Duration after which Cassandra should save the counter cache (keys only). Caches are saved to saved_caches_directory.")
     , counter_cache_keys_to_save(this, "counter_cache_keys_to_save", value_status::Unused, 0,
         "Number of keys from the counter cache to save. When disabled all keys are saved.")
+    , digest_cache_size_in_mb(this, "digest_cache_size_in_mb", value_status::Used, 0,
+        "Memory used to cache the digests of recent digest-only reads of single partitions, split among shards and shared by all the tables; a replica asked for the digest of a partition which didn't change since doesn't need to read it again. Mostly useful for read-mostly tables read at a consistency level which requires digests from several replicas. Set to 0 to disable.")
     /* Tombstone settings */
     /* When executing a scan, within or across a partition, tombstones must be kept in memory to allow returning them to the coordinator. The coordinator uses them to ensure other replicas know about the deleted rows. Workloads that generate numerous tombstones may cause performance problems and exhaust the server heap. See Cassandra anti-patterns: Queues and queue-like datasets. Adjust these thresholds only if you understand the impact and want to scan more tombstones. Additionally, you can adjust these thresholds at runtime using the StorageServiceMBean. */
     /* Related information: Cassandra anti-patterns: Queues and queue-like datasets */
@@ -562,11 +601,23 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The time that the coordinator waits for counter writes to complete.")
     , cas_contention_timeout_in_ms(this, "cas_contention_timeout_in_ms", value_status::Used, 1000,
         "The time that the coordinator continues to retry a CAS (compare and set) operation that contends with other proposals for the same row.")
+    , enable_lwt_background_learn(this, "enable_lwt_background_learn", liveness::LiveUpdate, value_status::Used, false,
+        "Answer an uncontended lightweight transaction as soon as a quorum has accepted its proposal, and commit it to the base table in the background. This saves a round trip, but a non-serial read right after the transaction may not see its effects yet. Serial reads and later transactions on the same key always do.")
     , truncate_request_timeout_in_ms(this, "truncate_request_timeout_in_ms", value_status::Used, 60000,
         "The time that the coordinator waits for truncates (remove all data from a table) to complete. The long default value allows for a snapshot to be taken before removing the data. If auto_snapshot is disabled (not recommended), you can reduce this time.")
     , write_request_timeout_in_ms(this, "write_request_timeout_in_ms", value_status::Used, 2000,
         "The time in milliseconds that the coordinator waits for write operations to complete.\n"
         "Related information: About hinted handoff writes")
+    , enable_cross_shard_write_batching(this, "enable_cross_shard_write_batching", liveness::LiveUpdate, value_status::Used, true,
+        "Send the mutations a write request applies on other shards of this node in one message per shard, instead of one message per mutation. This mostly helps batches with many small mutations.")
+    , write_ack_batching_window_in_us(this, "write_ack_batching_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+        "The time in microseconds a replica may hold the acknowledgement of a write, so that it is sent in one message together with the other acknowledgements to the same coordinator shard. "
+        "Helps clusters taking very high rates of small writes, at the cost of adding up to this much latency to each write. Writes close to their timeout are acknowledged immediately. 0 (default) disables it.")
+    , async_read_repair(this, "async_read_repair", liveness::LiveUpdate, value_status::Used, false,
+        "Return the result of a read which found inconsistent replicas as soon as it is reconciled, and write the repairs to the replicas in the background, batched with those of other reads. "
+        "This avoids the latency spikes of reads after a node outage, but a read at QUORUM may then return a newer value than a later read, if the later one reaches replicas which weren't repaired yet.")
+    , async_read_repair_memory_limit_in_mb(this, "async_read_repair_memory_limit_in_mb", liveness::LiveUpdate, value_status::Used, 8,
+        "Memory per shard for read repairs queued or being written in the background, see async_read_repair. Reads whose repair doesn't fit wait for it to be written.")
     , request_timeout_in_ms(this, "request_timeout_in_ms", value_status::Used, 10000,
         "The default timeout for other, miscellaneous operations.\n"
         "Related information: About hinted handoff writes")
@@ -591,10 +642,17 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tall: All traffic is compressed.\n"
         "\tdc : Traffic between data centers is compressed.\n"
         "\tnone : No compression.")
+    , internode_compression_dictionaries(this, "internode_compression_dictionaries", value_status::Used, false,
+        "Compress traffic between nodes with zstd, against dictionaries trained on the traffic of each connection, when the other node supports it. "
+        "Trades some CPU for considerably smaller messages, which is useful when inter-DC bandwidth is expensive. Only has an effect on connections internode_compression applies to.")
+    , internode_compression_dictionary_refresh_period_in_s(this, "internode_compression_dictionary_refresh_period_in_s", value_status::Used, 600,
+        "The minimum time in seconds between training two compression dictionaries for an internode connection, see internode_compression_dictionaries.")
     , inter_dc_tcp_nodelay(this, "inter_dc_tcp_nodelay", value_status::Used, false,
         "Enable or disable tcp_nodelay for inter-data center communication. When disabled larger, but fewer, network packets are sent. This reduces overhead from the TCP protocol itself. However, if cross data-center responses are blocked, it will increase latency.")
     , streaming_socket_timeout_in_ms(this, "streaming_socket_timeout_in_ms", value_status::Unused, 0,
         "Enable or disable socket timeout for streaming operations. When a timeout occurs during streaming, streaming is retried from the start of the current file. Avoid setting this value too low, as it can result in a significant amount of data re-streaming.")
+    , stream_entire_sstables(this, "stream_entire_sstables", liveness::LiveUpdate, value_status::Used, false,
+        "When bootstrapping, decommissioning, removing or replacing a node, or rebuilding, send sstables which are entirely within the streamed token ranges as raw files, instead of as a stream of mutation fragments. When bootstrapping or replacing a node, the parts of other sstables which fall within the streamed ranges are sent as raw files too. Only used when all nodes support it.")
     /* Native transport (CQL Binary Protocol) */
     , start_native_transport(this, "start_native_transport", value_status::Used, true,
         "Enable or disable the native transport server. Uses the same address as the rpc_address, but the port is different from the rpc_port. See native_transport_port.")
@@ -646,10 +704,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "This boolean controls whether the replicas for read query will be choosen based on cache hit ratio")
     /* Advanced fault detection settings */
     /* Settings to handle poorly performing or failing nodes. */
-    , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", value_status::Unused, 0,
-        "Sets the performance threshold for dynamically routing requests away from a poorly performing node. A value of 0.2 means Cassandra continues to prefer the static snitch values until the node response time is 20% worse than the best performing node. Until the threshold is reached, incoming client requests are statically routed to the closest replica (as determined by the snitch). Having requests consistently routed to a given replica can help keep a working set of data hot when read repair is less than 1.")
-    , dynamic_snitch_reset_interval_in_ms(this, "dynamic_snitch_reset_interval_in_ms", value_status::Unused, 60000,
-        "Time interval in milliseconds to reset all node scores, which allows a bad node to recover.")
+    , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", liveness::LiveUpdate, value_status::Used, 0,
+        "Sets the performance threshold for dynamically routing reads away from a poorly performing replica. Replicas are scored by the latency of their recent responses and the number of requests to them still in flight. A value of 0.2 means the static snitch order is preferred until a replica's score is 20% worse than the best performing replica's. Until the threshold is reached, reads are statically routed to the closest replica (as determined by the snitch). Having requests consistently routed to a given replica can help keep a working set of data hot when read repair is less than 1. 0 disables dynamic routing.")
+    , dynamic_snitch_reset_interval_in_ms(this, "dynamic_snitch_reset_interval_in_ms", liveness::LiveUpdate, value_status::Used, 60000,
+        "Time interval in milliseconds after which the score of a replica which wasn't queried is forgotten, which allows a bad replica to recover.")
     , dynamic_snitch_update_interval_in_ms(this, "dynamic_snitch_update_interval_in_ms", value_status::Unused, 100,
         "The time interval for how often the snitch calculates node scores. Because score calculation is CPU intensive, be careful when reducing this interval.")
     , hinted_handoff_enabled(this, "hinted_handoff_enabled", value_status::Used, db::config::hinted_handoff_enabled_type(db::config::hinted_handoff_enabled_type::enabled_for_all_tag()),
@@ -782,6 +840,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , override_decommission(this, "override_decommission", value_status::Used, false, "Set true to force a decommissioned node to join the cluster")
     , enable_repair_based_node_ops(this, "enable_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, true, "Set true to use enable repair based node operations instead of streaming based")
     , allowed_repair_based_node_ops(this, "allowed_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, "replace", "A comma separated list of node operations which are allowed to enable repair based node operations. The operations can be bootstrap, replace, removenode, decommission and rebuild")
+    , repair_skip_unchanged_ranges(this, "repair_skip_unchanged_ranges", liveness::LiveUpdate, value_status::Used, false,
+        "Make row level repair remember the hash of the data of each range it read in full, with the sstables holding that data, and skip the ranges "
+        "for which all the replicas remember the same hash of the same sstables, i.e. whose data didn't change since the previous repair. Takes effect only when all the replicas enable it.")
     , ring_delay_ms(this, "ring_delay_ms", value_status::Used, 30 * 1000, "Time a node waits to hear from other nodes before joining the ring in milliseconds. Same as -Dcassandra.ring_delay_ms in cassandra.")
     , shadow_round_ms(this, "shadow_round_ms", value_status::Used, 300 * 1000, "The maximum gossip shadow round time. Can be used to reduce the gossip feature check time during node boot up.")
     , fd_max_interval_ms(this, "fd_max_interval_ms", value_status::Used, 2 * 1000, "The maximum failure_detector interval time in milliseconds. Interval larger than the maximum will be ignored. Larger cluster may need to increase the default.")
@@ -793,6 +854,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , experimental(this, "experimental", value_status::Used, false, "[Deprecated] Set to true to unlock all experimental features (except 'raft' feature, which should be enabled explicitly via 'experimental-features' option). Please use 'experimental-features', instead.")
     , experimental_features(this, "experimental_features", value_status::Used, {}, experimental_features_help_string())
     , lsa_reclamation_step(this, "lsa_reclamation_step", value_status::Used, 1, "Minimum number of segments to reclaim in a single step")
+    , lsa_hugepage_segment_chunks(this, "lsa_hugepage_segment_chunks", value_status::Used, false,
+            "Allocate memory for the cache and memtables in 2MB chunks backed by transparent huge pages, which reduces TLB misses on large memory nodes. "
+            "Memory is then returned to the general purpose allocator in such chunks only, which can make reclaiming it more expensive.")
+    , lsa_defragmentation_target_occupancy(this, "lsa_defragmentation_target_occupancy", value_status::Used, 0,
+            "When set to a fraction between 0 and 1, memory of the cache and memtables which is occupied below it is compacted in the background, "
+            "ahead of allocations which would otherwise have to compact it while allocating. 0 disables background defragmentation.")
+    , lsa_defragmentation_cpu_budget(this, "lsa_defragmentation_cpu_budget", value_status::Used, 0.05,
+            "Maximum fraction of CPU time spent on background defragmentation of memory, see lsa_defragmentation_target_occupancy.")
     , prometheus_port(this, "prometheus_port", value_status::Used, 9180, "Prometheus port, set to zero to disable")
     , prometheus_address(this, "prometheus_address", value_status::Used, {/* listen_address */}, "Prometheus listening address, defaulting to listen_address if not explicitly set")
     , prometheus_prefix(this, "prometheus_prefix", value_status::Used, "scylla", "Set the prefix of the exported Prometheus metrics. Changing this will break Scylla's dashboard compatibility, do not change unless you know what you are doing.")
@@ -808,6 +877,11 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , enable_sstable_key_validation(this, "enable_sstable_key_validation", value_status::Used, ENABLE_SSTABLE_KEY_VALIDATION, "Enable validation of partition and clustering keys monotonicity"
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
+    , enable_sstable_split_block_bloom_filter(this, "enable_sstable_split_block_bloom_filter", value_status::Used, false, "Write sstable bloom filters in the split block format, which needs a single cache line access per lookup."
+        " Uses about 20% more memory for the same false positive chance. Takes effect once all nodes in the cluster support the format; SSTables written this way can't be read by older versions.")
+    , enable_sstable_compression_dictionaries(this, "enable_sstable_compression_dictionaries", value_status::Used, false, "Compress sstables written with LZ4 or Zstd against a dictionary trained from the first chunks of their data,"
+        " which keeps the compression ratio of small chunks close to that of large ones. Takes effect once all nodes in the cluster support the CompressionDictionary component;"
+        " SSTables written this way can't be read by older versions.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
@@ -816,8 +890,16 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
         " It is not enough to have ever since upgraded to newer versions of Cassandra. If you EVER used a version earlier than 2.1 in the cluster where these SSTables come from, DO NOT TURN ON THIS OPTION! You will corrupt your data. You have been warned.")
     , enable_shard_aware_drivers(this, "enable_shard_aware_drivers", value_status::Used, true, "Enable native transport drivers to use connection-per-shard for better performance")
+    , native_transport_enable_protocol_v5(this, "native_transport_enable_protocol_v5", value_status::Used, false,
+        "Let clients connect with version 5 of the native protocol, which frames messages in checksummed segments and compresses many of them together. "
+        "Drivers negotiate down to version 4 when it's disabled.")
+    , forward_requests_to_owning_shard(this, "forward_requests_to_owning_shard", liveness::LiveUpdate, value_status::Used, false,
+        "Execute prepared single-partition statements received on a shard which doesn't own the partition on the owning shard, like shard-aware drivers would have sent them")
     , enable_ipv6_dns_lookup(this, "enable_ipv6_dns_lookup", value_status::Used, false, "Use IPv6 address resolution")
     , abort_on_internal_error(this, "abort_on_internal_error", liveness::LiveUpdate, value_status::Used, false, "Abort the server instead of throwing exception when internal invariants are violated")
+    , cpu_profiler_frequency(this, "cpu_profiler_frequency", value_status::Used, 0,
+        "Sample the stacks of each shard this many times per second of CPU time (at most 1000), for the /system/cpu_profiler REST API. "
+        "A low frequency is cheap enough to keep on in production. 0 disables it. Can also be changed at runtime through the REST API.")
     , max_partition_key_restrictions_per_query(this, "max_partition_key_restrictions_per_query", liveness::LiveUpdate, value_status::Used, 100,
             "Maximum number of distinct partition keys restrictions per query. This limit places a bound on the size of IN tuples, "
             "especially when multiple partition key columns have IN restrictions. Increasing this value can result in server instability.")
@@ -830,6 +912,13 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , max_memory_for_unlimited_query_hard_limit(this, "max_memory_for_unlimited_query_hard_limit", "max_memory_for_unlimited_query", liveness::LiveUpdate, value_status::Used, (uint64_t(100) << 20),
             "Maximum amount of memory a query, whose memory consumption is not naturally limited, is allowed to consume, e.g. non-paged and reverse queries. "
             "This is the hard limit, queries violating this limit will be aborted.")
+    , hot_partitions_sample_period(this, "hot_partitions_sample_period", liveness::LiveUpdate, value_status::Used, 100,
+            "Track the hottest partitions of each shard by looking at one in every this many reads and writes. "
+            "The results are available in the system.hot_partitions table and in metrics. Set to 0 to disable.")
+    , hot_partitions_tracking_capacity(this, "hot_partitions_tracking_capacity", value_status::Used, 256,
+            "Maximum number of partitions tracked per shard for finding the hottest ones, separately for reads and writes.")
+    , hot_partitions_window_in_s(this, "hot_partitions_window_in_s", value_status::Used, 60,
+            "The period over which the accesses to the hottest partitions are counted, the counts of the last complete period are reported.")
     , initial_sstable_loading_concurrency(this, "initial_sstable_loading_concurrency", value_status::Used, 4u,
             "Maximum amount of sstables to load in parallel during initialization. A higher number can lead to more memory consumption. You should not need to touch this")
     , enable_3_1_0_compatibility_mode(this, "enable_3_1_0_compatibility_mode", value_status::Used, false,
@@ -844,11 +933,63 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Time period in seconds after which unused schema versions will be evicted from the local schema registry cache. Default is 1 second.")
     , max_concurrent_requests_per_shard(this, "max_concurrent_requests_per_shard",liveness::LiveUpdate, value_status::Used, std::numeric_limits<uint32_t>::max(),
         "Maximum number of concurrent requests a single shard can handle before it starts shedding extra load. By default, no requests will be shed.")
+    , service_levels_fair_queue_concurrency(this, "service_levels_fair_queue_concurrency", liveness::LiveUpdate, value_status::Used, 0,
+        "Maximum number of CQL queries, executions and batches a single shard processes at once. Further requests wait, and are admitted in proportion to the shares of their service levels, so that one service level can't starve the others. 0 (default) admits all requests immediately.")
+    , max_concurrent_connection_setups_per_shard(this, "max_concurrent_connection_setups_per_shard", value_status::Used, 0,
+        "Maximum number of new CQL connections a single shard sets up at once, that is, negotiates TLS, STARTUP and authentication for. Further new connections wait, so that a storm of reconnecting clients doesn't stall the established connections. 0 (default) doesn't limit them.")
+    , connection_setup_timeout_in_ms(this, "connection_setup_timeout_in_ms", value_status::Used, 10000,
+        "When max_concurrent_connection_setups_per_shard limits the new CQL connections being set up, new connections which aren't set up within this time are closed, so that they don't keep the others waiting.")
     , cdc_dont_rewrite_streams(this, "cdc_dont_rewrite_streams", value_status::Used, false,
             "Disable rewriting streams from cdc_streams_descriptions to cdc_streams_descriptions_v2. Should not be necessary, but the procedure is expensive and prone to failures; this config option is left as a backdoor in case some user requires manual intervention.")
     , strict_allow_filtering(this, "strict_allow_filtering", liveness::LiveUpdate, value_status::Used, strict_allow_filtering_default(), "Match Cassandra in requiring ALLOW FILTERING on slow queries. Can be true, false, or warn. When false, Scylla accepts some slow queries even without ALLOW FILTERING that Cassandra rejects. Warn is same as false, but with warning.")
     , reversed_reads_auto_bypass_cache(this, "reversed_reads_auto_bypass_cache", liveness::LiveUpdate, value_status::Used, false,
             "Bypass in-memory data cache (the row cache) when performing reversed queries.")
+    , large_partitions_reversed_reads_bypass_cache(this, "large_partitions_reversed_reads_bypass_cache", liveness::LiveUpdate, value_status::Used, true,
+            "Bypass in-memory data cache (the row cache) when performing reversed queries of a single partition which was recently written as a large partition, "
+            "see compaction_large_partition_warning_threshold_mb and compaction_rows_count_warning_threshold.")
+    , range_scans_probationary_cache_population(this, "range_scans_probationary_cache_population", liveness::LiveUpdate, value_status::Used, false,
+            "Make range scans populate the in-memory data cache (the row cache) with probationary entries, which are evicted before all others, "
+            "unless they are read again by single partition reads. Protects the cached working set of single partition reads from scans, without the need to use BYPASS CACHE.")
+    , max_range_read_concurrency_per_node(this, "max_range_read_concurrency_per_node", liveness::LiveUpdate, value_status::Used, 0,
+            "Maximum number of vnode ranges a range scan reads concurrently, per node in the cluster. A range scan reads more ranges "
+            "at once as long as they return fewer rows than it needs, and carries that concurrency over to its next page. 0 (default) means no limit.")
+    , cache_partition_row_budget(this, "cache_partition_row_budget", liveness::LiveUpdate, value_status::Used, 0,
+            "The number of rows reads can populate into a partition in the in-memory data cache (the row cache) as regular entries. "
+            "Rows populated beyond that are probationary, and evicted before all others unless they are read again, so that only "
+            "the hot clustering ranges of very wide partitions stay cached. 0 means no limit.")
+    , cache_eviction_by_hits_per_byte(this, "cache_eviction_by_hits_per_byte", value_status::Used, true,
+            "Evict from the kind of entry sharing the cache memory (rows, partition index pages and sstable file pages) which has the "
+            "fewest recent hits per byte. When false, all entries are evicted in plain least-recently-used order.")
+    , cache_cold_entry_compression_period_in_s(this, "cache_cold_entry_compression_period_in_s", liveness::LiveUpdate, value_status::Used, 0,
+            "Period of the passes over the in-memory data cache (the row cache) which compress partitions not read since the previous pass, "
+            "so that more partitions fit in memory. Compressed partitions are expanded back when read. 0 disables the compression.")
+    , reader_concurrency_estimate_read_cost(this, "reader_concurrency_estimate_read_cost", liveness::LiveUpdate, value_status::Used, false,
+            "Admit user reads by an estimate of the memory they will consume, from the number of sstables they read and the memory past reads "
+            "of the same table consumed, instead of the same fixed cost for every read.")
+    , pinned_tables_cache_memory_fraction(this, "pinned_tables_cache_memory_fraction", liveness::LiveUpdate, value_status::Used, 0.1,
+            "The fraction of the memory of each shard which the in-memory data cache of tables with caching = {'pinned': 'true'} may occupy. "
+            "Up to it, the data of these tables is never evicted, and reads of them are served from memory. Beyond it, it is evicted like the data of other tables.")
+    , reader_concurrency_adaptive_limit(this, "reader_concurrency_adaptive_limit", value_status::Used, false,
+            "Tune the number of user and streaming reads admitted concurrently on each shard from their latency: decrease it when reads take longer "
+            "than without contention, increase it when reads wait for admission while their latency is steady. Between a tenth and four times the default.")
+    , querier_cache_read_ahead(this, "querier_cache_read_ahead", value_status::Used, true,
+            "Make the readers of paged range scans keep reading between pages, into their buffer, while the client processes the page, "
+            "so that the next page can be served from the buffer right away.")
+    , multishard_scan_parallel_read_ahead(this, "multishard_scan_parallel_read_ahead", liveness::LiveUpdate, value_status::Used, false,
+            "Make paged range scans read ahead on all the shards of the node at once, from their second page on, instead of moving from shard to shard, "
+            "so that a scan from a single client can use all the cores of the node. Each shard buffers at most one reader buffer ahead.")
+    , sstable_skip_shadowed_rows(this, "sstable_skip_shadowed_rows", liveness::LiveUpdate, value_status::Used, false,
+            "Make sstable reads skip the rows shadowed by a partition or range tombstone which is at least as recent as all the other "
+            "data of the sstable, instead of reading them only for them to be dropped later, which speeds up reads of queue-like "
+            "and TTL'd time series tables. Readers then don't return the shadowed rows.")
+    , view_update_coalescing_window_in_us(this, "view_update_coalescing_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+            "How long view updates bound for a remote view replica are held back to be merged with the other updates of the same "
+            "view partition bound for the same replica, so that writes to many base partitions (e.g. batches) send fewer, larger "
+            "view updates. 0, the default, sends every update right away.")
+    , view_update_skip_read_for_new_partitions(this, "view_update_skip_read_for_new_partitions", liveness::LiveUpdate, value_status::Used, true,
+            "Skip reading the existing base row when generating the view updates of a write to a partition which is in none of the "
+            "memtables of the base table and is ruled out by the bloom filters of all its sstables, so that inserting new partitions "
+            "(e.g. into event logs) into a table with views costs no read.")
     , enable_optimized_reversed_reads(this, "enable_optimized_reversed_reads", liveness::LiveUpdate, value_status::Used, true,
             "Use a new optimized algorithm for performing reversed reads.")
     , enable_cql_config_updates(this, "enable_cql_config_updates", liveness::LiveUpdate, value_status::Used, true,
@@ -861,6 +1002,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , alternator_enforce_authorization(this, "alternator_enforce_authorization", value_status::Used, false, "Enforce checking the authorization header for every request in Alternator")
     , alternator_write_isolation(this, "alternator_write_isolation", value_status::Used, "", "Default write isolation policy for Alternator")
     , alternator_streams_time_window_s(this, "alternator_streams_time_window_s", value_status::Used, 10, "CDC query confidence window for alternator streams")
+    , alternator_streams_buffer_records(this, "alternator_streams_buffer_records", liveness::LiveUpdate, value_status::Used, 10000,
+        "The number of recent Alternator Streams records each shard keeps in memory, to serve GetRecords of consumers tailing the streams without reading the CDC log. 0 disables the buffer.")
     , alternator_timeout_in_ms(this, "alternator_timeout_in_ms", value_status::Used, 10000,
         "The server-side timeout for completing Alternator API requests.")
     , abort_on_ebadf(this, "abort_on_ebadf", value_status::Used, true, "Abort the server on incorrect file descriptor access. Throws exception when disabled.")
@@ -908,6 +1051,7 @@ void db::config::setup_directories() {
     maybe_in_workdir(hints_directory, "hints");
     maybe_in_workdir(view_hints_directory, "view_hints");
     maybe_in_workdir(saved_caches_directory, "saved_caches");
+    maybe_in_workdir(reader_spill_directory, "spill");
 }
 
 void db::config::maybe_in_workdir(named_value<sstring>& to, const char* sub) {
@@ -136,16 +136,28 @@ class config : public utils::config_file {
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> major_compaction_parallelism;
+    named_value<uint32_t> compaction_index_cache_prewarm_keys;
+    named_value<float> compaction_backlog_write_delay_threshold;
+    named_value<float> compaction_backlog_write_reject_threshold;
+    named_value<uint32_t> compaction_backlog_max_write_delay_in_ms;
+    named_value<float> stream_receive_backlog_delay_threshold;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
     named_value<bool> listen_interface_prefer_ipv6;
     named_value<sstring> work_directory;
     named_value<sstring> commitlog_directory;
+    named_value<sstring> commitlog_overflow_directory;
     named_value<string_list> data_file_directories;
+    named_value<sstring> cold_storage_directory;
+    named_value<uint32_t> cold_storage_page_cache_size_in_mb;
     named_value<sstring> hints_directory;
     named_value<sstring> view_hints_directory;
     named_value<sstring> saved_caches_directory;
+    named_value<sstring> reader_spill_directory;
+    named_value<bool> enable_reader_spilling;
+    named_value<uint64_t> reader_spill_max_disk_size_in_mb;
     named_value<sstring> commit_failure_policy;
     named_value<sstring> disk_failure_policy;
     named_value<sstring> endpoint_snitch;
@@ -154,6 +166,7 @@ class config : public utils::config_file {
     named_value<bool> rpc_interface_prefer_ipv6;
     named_value<seed_provider_type> seed_provider;
     named_value<uint32_t> compaction_throughput_mb_per_sec;
+    named_value<uint32_t> backup_throughput_mb_per_sec;
     named_value<uint32_t> compaction_large_partition_warning_threshold_mb;
     named_value<uint32_t> compaction_large_row_warning_threshold_mb;
     named_value<uint32_t> compaction_large_cell_warning_threshold_mb;
@@ -166,6 +179,8 @@ class config : public utils::config_file {
     named_value<bool> snapshot_before_compaction;
     named_value<uint32_t> phi_convict_threshold;
     named_value<uint32_t> failure_detector_timeout_in_ms;
+    named_value<uint32_t> direct_failure_detector_ping_interval_in_ms;
+    named_value<double> direct_failure_detector_phi_convict_threshold;
     named_value<sstring> commitlog_sync;
     named_value<uint32_t> commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
@@ -174,6 +189,8 @@ class config : public utils::config_file {
     named_value<bool> commitlog_reuse_segments;
     named_value<bool> commitlog_use_o_dsync;
     named_value<bool> commitlog_use_hard_size_limit;
+    named_value<sstring> commitlog_compression;
+    named_value<uint32_t> commitlog_group_commit_max_window_in_us;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -216,21 +233,30 @@ class config : public utils::config_file {
     named_value<uint32_t> counter_cache_size_in_mb;
     named_value<uint32_t> counter_cache_save_period;
     named_value<uint32_t> counter_cache_keys_to_save;
+    named_value<uint32_t> digest_cache_size_in_mb;
     named_value<uint32_t> tombstone_warn_threshold;
     named_value<uint32_t> tombstone_failure_threshold;
     named_value<uint32_t> range_request_timeout_in_ms;
     named_value<uint32_t> read_request_timeout_in_ms;
     named_value<uint32_t> counter_write_request_timeout_in_ms;
     named_value<uint32_t> cas_contention_timeout_in_ms;
+    named_value<bool> enable_lwt_background_learn;
     named_value<uint32_t> truncate_request_timeout_in_ms;
     named_value<uint32_t> write_request_timeout_in_ms;
+    named_value<bool> enable_cross_shard_write_batching;
+    named_value<uint32_t> write_ack_batching_window_in_us;
+    named_value<bool> async_read_repair;
+    named_value<uint32_t> async_read_repair_memory_limit_in_mb;
     named_value<uint32_t> request_timeout_in_ms;
     named_value<bool> cross_node_timeout;
     named_value<uint32_t> internode_send_buff_size_in_bytes;
     named_value<uint32_t> internode_recv_buff_size_in_bytes;
     named_value<sstring> internode_compression;
+    named_value<bool> internode_compression_dictionaries;
+    named_value<uint32_t> internode_compression_dictionary_refresh_period_in_s;
     named_value<bool> inter_dc_tcp_nodelay;
     named_value<uint32_t> streaming_socket_timeout_in_ms;
+    named_value<bool> stream_entire_sstables;
     named_value<bool> start_native_transport;
     named_value<uint16_t> native_transport_port;
     named_value<uint16_t> native_transport_port_ssl;
@@ -291,6 +317,7 @@ class config : public utils::config_file {
     named_value<bool> override_decommission;
     named_value<bool> enable_repair_based_node_ops;
     named_value<sstring> allowed_repair_based_node_ops;
+    named_value<bool> repair_skip_unchanged_ranges;
     named_value<uint32_t> ring_delay_ms;
     named_value<uint32_t> shadow_round_ms;
     named_value<uint32_t> fd_max_interval_ms;
@@ -302,6 +329,9 @@ class config : public utils::config_file {
     named_value<bool> experimental;
     named_value<std::vector<enum_option<experimental_features_t>>> experimental_features;
     named_value<size_t> lsa_reclamation_step;
+    named_value<bool> lsa_hugepage_segment_chunks;
+    named_value<double> lsa_defragmentation_target_occupancy;
+    named_value<double> lsa_defragmentation_cpu_budget;
     named_value<uint16_t> prometheus_port;
     named_value<sstring> prometheus_address;
     named_value<sstring> prometheus_prefix;
@@ -314,6 +344,8 @@ class config : public utils::config_file {
     named_value<bool> enable_keyspace_column_family_metrics;
     named_value<bool> enable_sstable_data_integrity_check;
     named_value<bool> enable_sstable_key_validation;
+    named_value<bool> enable_sstable_split_block_bloom_filter;
+    named_value<bool> enable_sstable_compression_dictionaries;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
     named_value<bool> enable_sstables_mc_format;
@@ -321,12 +353,18 @@ class config : public utils::config_file {
     named_value<sstring> sstable_format;
     named_value<bool> enable_dangerous_direct_import_of_cassandra_counters;
     named_value<bool> enable_shard_aware_drivers;
+    named_value<bool> native_transport_enable_protocol_v5;
+    named_value<bool> forward_requests_to_owning_shard;
     named_value<bool> enable_ipv6_dns_lookup;
     named_value<bool> abort_on_internal_error;
+    named_value<uint32_t> cpu_profiler_frequency;
     named_value<uint32_t> max_partition_key_restrictions_per_query;
     named_value<uint32_t> max_clustering_key_restrictions_per_query;
     named_value<uint64_t> max_memory_for_unlimited_query_soft_limit;
     named_value<uint64_t> max_memory_for_unlimited_query_hard_limit;
+    named_value<uint32_t> hot_partitions_sample_period;
+    named_value<uint32_t> hot_partitions_tracking_capacity;
+    named_value<uint32_t> hot_partitions_window_in_s;
     named_value<unsigned> initial_sstable_loading_concurrency;
     named_value<bool> enable_3_1_0_compatibility_mode;
     named_value<bool> enable_user_defined_functions;
@@ -335,9 +373,26 @@ class config : public utils::config_file {
     named_value<unsigned> user_defined_function_contiguous_allocation_limit_bytes;
     named_value<uint32_t> schema_registry_grace_period;
     named_value<uint32_t> max_concurrent_requests_per_shard;
+    named_value<uint32_t> service_levels_fair_queue_concurrency;
+    named_value<uint32_t> max_concurrent_connection_setups_per_shard;
+    named_value<uint32_t> connection_setup_timeout_in_ms;
     named_value<bool> cdc_dont_rewrite_streams;
     named_value<tri_mode_restriction> strict_allow_filtering;
     named_value<bool> reversed_reads_auto_bypass_cache;
+    named_value<bool> large_partitions_reversed_reads_bypass_cache;
+    named_value<bool> range_scans_probationary_cache_population;
+    named_value<uint32_t> max_range_read_concurrency_per_node;
+    named_value<uint32_t> cache_partition_row_budget;
+    named_value<bool> cache_eviction_by_hits_per_byte;
+    named_value<uint32_t> cache_cold_entry_compression_period_in_s;
+    named_value<bool> reader_concurrency_estimate_read_cost;
+    named_value<double> pinned_tables_cache_memory_fraction;
+    named_value<bool> reader_concurrency_adaptive_limit;
+    named_value<bool> querier_cache_read_ahead;
+    named_value<bool> multishard_scan_parallel_read_ahead;
+    named_value<bool> sstable_skip_shadowed_rows;
+    named_value<uint32_t> view_update_coalescing_window_in_us;
+    named_value<bool> view_update_skip_read_for_new_partitions;
     named_value<bool> enable_optimized_reversed_reads;
     named_value<bool> enable_cql_config_updates;
     named_value<bool> enable_parallelized_aggregation;
@@ -348,6 +403,7 @@ class config : public utils::config_file {
     named_value<bool> alternator_enforce_authorization;
     named_value<sstring> alternator_write_isolation;
     named_value<uint32_t> alternator_streams_time_window_s;
+    named_value<uint32_t> alternator_streams_buffer_records;
     named_value<uint32_t> alternator_timeout_in_ms;
 
     named_value<bool> abort_on_ebadf;
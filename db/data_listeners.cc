@@ -9,6 +9,9 @@
 #include "db/data_listeners.hh"
 #include "replica/database.hh"
 #include "db_clock.hh"
+#include "db/config.hh"
+
+#include <seastar/core/metrics.hh>
 
 #include <tuple>
 
@@ -153,4 +156,92 @@ future<toppartitions_query::results> toppartitions_query::gather(unsigned res_si
         });
 }
 
+hot_partitions_tracker::hot_partitions_tracker(replica::database& db, size_t capacity, std::chrono::seconds window)
+        : _db(db)
+        , _capacity(capacity)
+        , _current_reads(capacity)
+        , _current_writes(capacity)
+        , _last_reads(capacity)
+        , _last_writes(capacity)
+        , _rotate_timer([this] { rotate(); }) {
+    _db.data_listeners().install(this);
+    _rotate_timer.arm_periodic(window);
+    setup_metrics();
+}
+
+hot_partitions_tracker::~hot_partitions_tracker() {
+    _db.data_listeners().uninstall(this);
+}
+
+unsigned hot_partitions_tracker::sample_period() const {
+    return _db.get_config().hot_partitions_sample_period();
+}
+
+void hot_partitions_tracker::rotate() {
+    _last_reads = std::exchange(_current_reads, top_k(_capacity));
+    _last_writes = std::exchange(_current_writes, top_k(_capacity));
+}
+
+void hot_partitions_tracker::count(top_k& tk, toppartitions_item_key key, unsigned n) noexcept {
+    // Failing to count must not fail the operation. The top_k is left invalid
+    // and ignores further appends, it's replaced at the end of the window.
+    try {
+        tk.append(std::move(key), n);
+    } catch (...) {
+        dblog.debug("hot_partitions_tracker: failed to count access: {}", std::current_exception());
+    }
+}
+
+hot_partitions_tracker::top_k::results hot_partitions_tracker::top(const top_k& tk, unsigned k) {
+    return tk.valid() ? tk.top(k) : top_k::results();
+}
+
+unsigned hot_partitions_tracker::hottest(const top_k& tk) {
+    auto top = hot_partitions_tracker::top(tk, 1);
+    return top.empty() ? 0 : top.front().count;
+}
+
+void hot_partitions_tracker::setup_metrics() {
+    namespace sm = seastar::metrics;
+
+    _metrics.add_group("hot_partitions", {
+        sm::make_derive("sampled_reads", _sampled_reads,
+                       sm::description("Counts the reads which were sampled for finding the hottest partitions.")),
+
+        sm::make_derive("sampled_writes", _sampled_writes,
+                       sm::description("Counts the writes which were sampled for finding the hottest partitions.")),
+
+        sm::make_gauge("hottest_partition_reads", [this] { return hottest(_last_reads); },
+                       sm::description("Holds the estimated number of reads of the most read partition of the shard in the last window.")),
+
+        sm::make_gauge("hottest_partition_writes", [this] { return hottest(_last_writes); },
+                       sm::description("Holds the estimated number of writes of the most written partition of the shard in the last window.")),
+    });
+}
+
+flat_mutation_reader_v2 hot_partitions_tracker::on_read(const schema_ptr& s, const dht::partition_range& range,
+        const query::partition_slice& slice, flat_mutation_reader_v2&& rd) {
+    const auto period = sample_period();
+    if (!period || ++_reads % period) {
+        return std::move(rd);
+    }
+    ++_sampled_reads;
+    return make_filtering_reader(std::move(rd), [zis = this->weak_from_this(), s, period] (const dht::decorated_key& dk) {
+        // The reader may outlive the tracker, see toppartitions_data_listener::on_read()
+        if (zis) {
+            zis->count(zis->_current_reads, toppartitions_item_key{s, dk}, period);
+        }
+        return true;
+    });
+}
+
+void hot_partitions_tracker::on_write(const schema_ptr& s, const frozen_mutation& m) {
+    const auto period = sample_period();
+    if (!period || ++_writes % period) {
+        return;
+    }
+    ++_sampled_writes;
+    count(_current_writes, toppartitions_item_key{s, m.decorated_key(*s)}, period);
+}
+
 } // namespace db
@@ -12,6 +12,9 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
 
 #include "utils/hash.hh"
 #include "schema_fwd.hh"
@@ -167,4 +170,49 @@ class toppartitions_query {
     future<results> gather(unsigned results_size = 256);
 };
 
+// Always-on tracking of the hottest partitions of the shard, of all the tables.
+//
+// Unlike toppartitions_query, it has to be cheap enough to run all the time,
+// so only one in every `sample_period` reads and writes is looked at, and
+// counted as `sample_period` accesses. The counts are restarted every
+// `window`, and the ones of the last complete window are the ones reported.
+class hot_partitions_tracker : public data_listener, public weakly_referencable<hot_partitions_tracker> {
+public:
+    using top_k = toppartitions_data_listener::top_k;
+private:
+    replica::database& _db;
+    const size_t _capacity;
+    uint64_t _reads = 0;
+    uint64_t _writes = 0;
+    uint64_t _sampled_reads = 0;
+    uint64_t _sampled_writes = 0;
+    top_k _current_reads;
+    top_k _current_writes;
+    top_k _last_reads;
+    top_k _last_writes;
+    timer<lowres_clock> _rotate_timer;
+    seastar::metrics::metric_groups _metrics;
+private:
+    unsigned sample_period() const;
+    void setup_metrics();
+    static void count(top_k& tk, toppartitions_item_key key, unsigned n) noexcept;
+    static top_k::results top(const top_k& tk, unsigned k);
+    static unsigned hottest(const top_k& tk);
+public:
+    hot_partitions_tracker(replica::database& db, size_t capacity, std::chrono::seconds window);
+    ~hot_partitions_tracker();
+
+    virtual flat_mutation_reader_v2 on_read(const schema_ptr& s, const dht::partition_range& range,
+            const query::partition_slice& slice, flat_mutation_reader_v2&& rd) override;
+
+    virtual void on_write(const schema_ptr& s, const frozen_mutation& m) override;
+
+    // Ends the current window. Called by the timer, public for tests.
+    void rotate();
+
+    // The hottest partitions of the last complete window.
+    top_k::results top_reads(unsigned k) const { return top(_last_reads, k); }
+    top_k::results top_writes(unsigned k) const { return top(_last_writes, k); }
+};
+
 } // namespace db
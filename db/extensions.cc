@@ -37,6 +37,15 @@ db::extensions::commitlog_file_extensions() const {
             | boost::adaptors::transformed(std::mem_fn(&std::unique_ptr<etype>::get)));
 }
 
+std::vector<sstables::row_expiration_extension*>
+db::extensions::row_expiration_extensions() const {
+    using etype = sstables::row_expiration_extension;
+    return boost::copy_range<std::vector<etype*>>(
+            _row_expiration_extensions
+            | boost::adaptors::map_values
+            | boost::adaptors::transformed(std::mem_fn(&std::unique_ptr<etype>::get)));
+}
+
 std::set<sstring>
 db::extensions::schema_extension_keywords() const {
     return boost::copy_range<std::set<sstring>>(
@@ -51,6 +60,10 @@ void db::extensions::add_commitlog_file_extension(sstring n, commitlog_file_exte
     _commitlog_file_extensions[n] = std::move(f);
 }
 
+void db::extensions::add_row_expiration_extension(sstring n, row_expiration_extension_ptr f) {
+    _row_expiration_extensions[n] = std::move(f);
+}
+
 void db::extensions::add_extension_to_schema(schema_ptr s, const sstring& name, shared_ptr<schema_extension> ext) {
     const_cast<schema *>(s.get())->extensions()[name] = std::move(ext);
 }
@@ -26,6 +26,7 @@
 
 namespace sstables {
 class file_io_extension;
+class row_expiration_extension;
 }
 
 namespace db {
@@ -41,6 +42,7 @@ class extensions {
     using schema_ext_create_func = std::function<seastar::shared_ptr<schema_extension>(schema_ext_config)>;
     using sstable_file_io_extension = std::unique_ptr<sstables::file_io_extension>;
     using commitlog_file_extension_ptr = std::unique_ptr<db::commitlog_file_extension>;
+    using row_expiration_extension_ptr = std::unique_ptr<sstables::row_expiration_extension>;
 
     /**
      * Registered extensions
@@ -60,6 +62,12 @@ class extensions {
      */
     std::vector<db::commitlog_file_extension*> commitlog_file_extensions() const;
 
+    /**
+     * Returns iterable range of registered row expiration extensions (see sstables.hh#row_expiration_extension)
+     * For sstable writers to record the expiration times of the rows they write...
+     */
+    std::vector<sstables::row_expiration_extension*> row_expiration_extensions() const;
+
     /**
      * Registered extensions keywords, i.e. custom properties/propery sets
      * for schema extensions
@@ -92,6 +100,10 @@ class extensions {
      * Init time method to add sstable extension
      */
     void add_commitlog_file_extension(sstring n, commitlog_file_extension_ptr);
+    /**
+     * Init time method to add row expiration extension
+     */
+    void add_row_expiration_extension(sstring n, row_expiration_extension_ptr);
 
     /**
      * Allows forcible modification of schema extensions of a schema. This should
@@ -104,5 +116,6 @@ class extensions {
     std::map<sstring, schema_ext_create_func> _schema_extensions;
     std::map<sstring, sstable_file_io_extension> _sstable_file_io_extensions;
     std::map<sstring, commitlog_file_extension_ptr> _commitlog_file_extensions;
+    std::map<sstring, row_expiration_extension_ptr> _row_expiration_extensions;
 };
 }
@@ -752,6 +752,7 @@ manager::end_point_hints_manager::sender::sender(end_point_hints_manager& parent
     , _hints_cpu_sched_group(_db.get_streaming_scheduling_group())
     , _gossiper(local_gossiper)
     , _file_update_mutex(_ep_manager.file_update_mutex())
+    , _send_window(_resource_manager.per_shard_concurrency_limit())
 {}
 
 manager::end_point_hints_manager::sender::sender(const sender& other, end_point_hints_manager& parent) noexcept
@@ -765,6 +766,7 @@ manager::end_point_hints_manager::sender::sender(const sender& other, end_point_
     , _hints_cpu_sched_group(other._hints_cpu_sched_group)
     , _gossiper(other._gossiper)
     , _file_update_mutex(_ep_manager.file_update_mutex())
+    , _send_window(_resource_manager.per_shard_concurrency_limit())
 {}
 
 manager::end_point_hints_manager::sender::~sender() {
@@ -859,7 +861,11 @@ future<> manager::end_point_hints_manager::sender::send_one_mutation(frozen_muta
 }
 
 future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
+    return _send_window.wait().then([this, buf_size = buf.size_bytes()] (auto window_units) {
+        return _resource_manager.get_send_units_for(buf_size).then([window_units = std::move(window_units)] (auto units) mutable {
+            return make_ready_future<std::tuple<semaphore_units<>, decltype(units)>>(std::move(window_units), std::move(units));
+        });
+    }).then_unpack([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto window_units, auto units) mutable {
         ctx_ptr->mark_hint_as_in_progress(rp);
 
         // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
@@ -899,10 +905,11 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
                 return make_exception_future<>(std::move(eptr));
             }
             return make_ready_future<>();
-        }).then_wrapped([this, units = std::move(units), rp, ctx_ptr] (future<>&& f) {
+        }).then_wrapped([this, window_units = std::move(window_units), units = std::move(units), rp, ctx_ptr] (future<>&& f) {
             // Information about the error was already printed somewhere higher.
             // We just need to account in the ctx that sending of this hint has failed.
             if (!f.failed()) {
+                _send_window.on_success(_proxy.get_backlog_of(end_point_key()).relative_size());
                 ctx_ptr->on_hint_send_success(rp);
                 auto new_bound = ctx_ptr->get_replayed_bound();
                 // Segments from other shards are replayed first and are considered to be "before" replay position 0.
@@ -912,6 +919,7 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
                     notify_replay_waiters();
                 }
             } else {
+                _send_window.on_failure();
                 ctx_ptr->on_hint_send_failure(rp);
             }
             f.ignore_ready_future();
@@ -1032,6 +1040,7 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
     timespec last_mod = get_last_file_modification(fname).get0();
     gc_clock::duration secs_since_file_mod = std::chrono::seconds(last_mod.tv_sec);
     lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(_last_schema_ver_to_column_mapping);
+    _send_window.set_max_size(_resource_manager.per_shard_concurrency_limit());
 
     try {
         commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_priority(), [this, secs_since_file_mod, &fname, ctx_ptr] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
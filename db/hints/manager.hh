@@ -149,6 +149,7 @@ class manager {
             seastar::scheduling_group _hints_cpu_sched_group;
             gms::gossiper& _gossiper;
             seastar::shared_mutex& _file_update_mutex;
+            send_window _send_window;
 
             std::multimap<db::replay_position, lw_shared_ptr<std::optional<promise<>>>> _replay_waiters;
 
@@ -233,6 +234,7 @@ class manager {
 
             /// \brief Try to send one hint read from the file.
             ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of hints "in the air".
+            ///  - Limit the number of hints "in the air" to this destination to what it can take, see \ref send_window.
             ///  - Discard the hints that are older than the grace seconds value of the corresponding table.
             ///
             /// If sending fails we are going to set the state::segment_replay_failed in the _state and _first_failed_rp will be updated to min(_first_failed_rp, \ref rp).
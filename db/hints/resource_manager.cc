@@ -39,14 +39,38 @@ future<bool> is_mountpoint(const fs::path& path) {
     });
 }
 
+void send_window::resize(size_t size) noexcept {
+    size = std::clamp(size, min_size, _max_size);
+    if (size > _size) {
+        _sem.signal(size - _size);
+    } else if (size < _size) {
+        // May leave the semaphore in debt until enough hints in flight complete.
+        _sem.consume(_size - size);
+    }
+    _size = size;
+}
+
+void send_window::set_max_size(size_t max_size) noexcept {
+    _max_size = std::max(max_size, min_size);
+    resize(_size);
+}
+
+void send_window::on_success(float backlog) noexcept {
+    if (backlog > backlog_threshold) {
+        resize(_size - 1);
+    } else {
+        resize(_size + 1);
+    }
+}
+
+void send_window::on_failure() noexcept {
+    resize(_size / 2);
+}
+
 future<semaphore_units<named_semaphore::exception_factory>> resource_manager::get_send_units_for(size_t buf_size) {
     // In order to impose a limit on the number of hints being sent concurrently,
     // require each hint to reserve at least 1/(max concurrency) of the shard budget
-    const size_t per_node_concurrency_limit = _max_hints_send_queue_length();
-    const size_t per_shard_concurrency_limit = (per_node_concurrency_limit > 0)
-            ? div_ceil(per_node_concurrency_limit, smp::count)
-            : default_per_shard_concurrency_limit;
-    const size_t min_send_hint_budget = _max_send_in_flight_memory / per_shard_concurrency_limit;
+    const size_t min_send_hint_budget = _max_send_in_flight_memory / per_shard_concurrency_limit();
     // Let's approximate the memory size the mutation is going to consume by the size of its serialized form
     size_t hint_memory_budget = std::max(min_send_hint_budget, buf_size);
     // Allow a very big mutation to be sent out by consuming the whole shard budget
@@ -55,6 +79,13 @@ future<semaphore_units<named_semaphore::exception_factory>> resource_manager::ge
     return get_units(_send_limiter, hint_memory_budget);
 }
 
+size_t resource_manager::per_shard_concurrency_limit() const noexcept {
+    const size_t per_node_concurrency_limit = _max_hints_send_queue_length();
+    return (per_node_concurrency_limit > 0)
+            ? div_ceil(per_node_concurrency_limit, smp::count)
+            : default_per_shard_concurrency_limit;
+}
+
 size_t resource_manager::sending_queue_length() const {
     return _send_limiter.waiters();
 }
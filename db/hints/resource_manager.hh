@@ -115,6 +115,47 @@ class space_watchdog {
     future<> scan_one_ep_dir(fs::path path, manager& shard_manager, ep_key_type ep_key);
 };
 
+/// \brief Limits the number of hints in flight to a single destination.
+///
+/// The limit adapts to how fast the destination takes the hints: it grows by
+/// one with every hint that is sent successfully, stops growing and shrinks by
+/// one while the destination reports that it falls behind on its backlog, and
+/// is halved when sending fails (e.g. times out). This lets the replay of a
+/// large backlog of hints ramp up to the destination's capacity without
+/// drowning the client traffic it serves at the same time.
+class send_window {
+public:
+    static constexpr size_t min_size = 1;
+    // Relative backlog of the destination above which we back off.
+    static constexpr float backlog_threshold = 0.5;
+private:
+    size_t _size = min_size;
+    size_t _max_size;
+    seastar::semaphore _sem{min_size};
+public:
+    explicit send_window(size_t max_size) noexcept
+        : _max_size(std::max(max_size, min_size))
+    {}
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    /// \brief Waits until one more hint may be sent to the destination.
+    future<semaphore_units<>> wait() {
+        return get_units(_sem, 1);
+    }
+
+    void set_max_size(size_t max_size) noexcept;
+
+    /// \param backlog relative backlog reported by the destination
+    void on_success(float backlog) noexcept;
+
+    void on_failure() noexcept;
+private:
+    void resize(size_t size) noexcept;
+};
+
 class resource_manager {
     const size_t _max_send_in_flight_memory;
     utils::updateable_value<uint32_t> _max_hints_send_queue_length;
@@ -180,6 +221,9 @@ class resource_manager {
     future<semaphore_units<named_semaphore::exception_factory>> get_send_units_for(size_t buf_size);
     size_t sending_queue_length() const;
 
+    /// \brief The maximum number of hints sent concurrently by a shard.
+    size_t per_shard_concurrency_limit() const noexcept;
+
     future<> start(shared_ptr<service::storage_proxy> proxy_ptr, shared_ptr<gms::gossiper> gossiper_ptr);
     future<> stop() noexcept;
 
@@ -11,6 +11,7 @@
 #include "db/system_keyspace.hh"
 #include "db/large_data_handler.hh"
 #include "sstables/sstables.hh"
+#include "dht/i_partitioner.hh"
 
 static logging::logger large_data_logger("large_data");
 
@@ -40,6 +41,12 @@ future<large_data_handler::partition_above_threshold> large_data_handler::maybe_
         ++_stats.partitions_bigger_than_threshold;
     }
     if (above_threshold.size || above_threshold.rows) [[unlikely]] {
+        try {
+            const auto& s = *sst.get_schema();
+            _large_partitions.record(s, key.to_partition_key(s), partition_size, rows);
+        } catch (...) {
+            large_data_logger.warn("Failed to track a large partition: {}", std::current_exception());
+        }
         return with_sem([&sst, &key, partition_size, rows, this] {
             return record_large_partitions(sst, key, partition_size, rows);
         }).then([above_threshold] {
@@ -49,6 +56,56 @@ future<large_data_handler::partition_above_threshold> large_data_handler::maybe_
     return make_ready_future<partition_above_threshold>();
 }
 
+void large_partitions_tracker::record(const schema& s, const partition_key& pk, uint64_t partition_size, uint64_t rows) {
+    auto k = key(s.id(), dht::get_token(s, pk));
+    auto now = db_clock::now();
+    auto it = _partitions.find(k);
+    if (it != _partitions.end()) {
+        auto& e = it->second;
+        e.size = std::max(e.size, partition_size);
+        e.rows = std::max(e.rows, rows);
+        e.last_seen = now;
+        return;
+    }
+    if (_partitions.size() >= _capacity) {
+        auto smallest = std::min_element(_partitions.begin(), _partitions.end(), [] (const auto& a, const auto& b) {
+            return a.second.size < b.second.size;
+        });
+        if (smallest->second.size >= partition_size) {
+            return;
+        }
+        _partitions.erase(smallest);
+    }
+    std::ostringstream oss;
+    oss << pk.with_schema(s);
+    _partitions.emplace(std::move(k), entry{
+        .ks_name = s.ks_name(),
+        .cf_name = s.cf_name(),
+        .partition_key = oss.str(),
+        .size = partition_size,
+        .rows = rows,
+        .first_size = partition_size,
+        .first_seen = now,
+        .last_seen = now,
+    });
+}
+
+large_partitions_tracker::entry* large_partitions_tracker::find(const utils::UUID& table, const dht::token& t) noexcept {
+    auto it = _partitions.find(key(table, t));
+    return it != _partitions.end() ? &it->second : nullptr;
+}
+
+const large_partitions_tracker::entry* large_partitions_tracker::find(const utils::UUID& table, const dht::token& t) const noexcept {
+    return const_cast<large_partitions_tracker*>(this)->find(table, t);
+}
+
+void large_partitions_tracker::forget(const utils::UUID& table) noexcept {
+    auto it = _partitions.lower_bound(key(table, dht::minimum_token()));
+    while (it != _partitions.end() && it->first.first == table) {
+        it = _partitions.erase(it);
+    }
+}
+
 void large_data_handler::start() {
     _running = true;
 }
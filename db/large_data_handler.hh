@@ -9,9 +9,12 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include "schema_fwd.hh"
 #include "system_keyspace.hh"
 #include "sstables/shared_sstable.hh"
+#include "dht/token.hh"
+#include "db_clock.hh"
 
 namespace sstables {
 class sstable;
@@ -20,12 +23,65 @@ class key;
 
 namespace db {
 
+// The largest partitions the shard wrote recently, of all the tables, as
+// recorded by large_data_handler when writing sstables. Unlike
+// system.large_partitions, it's kept in memory, so that reads can find out
+// cheaply whether they are about to read a large partition.
+//
+// Partitions are identified by their table and token: a rare collision
+// of tokens only makes a read of a small partition be treated as large.
+class large_partitions_tracker {
+public:
+    struct entry {
+        sstring ks_name;
+        sstring cf_name;
+        sstring partition_key;
+        // The largest size and row count any sstable was written with.
+        uint64_t size;
+        uint64_t rows;
+        // The size when first recorded, to tell the growth rate.
+        uint64_t first_size;
+        db_clock::time_point first_seen;
+        db_clock::time_point last_seen;
+        // Single-partition reads of it, since it was first recorded.
+        uint64_t reads = 0;
+    };
+    using key = std::pair<utils::UUID, dht::token>;
+private:
+    const size_t _capacity;
+    std::map<key, entry> _partitions;
+    uint64_t _reads = 0;
+public:
+    explicit large_partitions_tracker(size_t capacity) : _capacity(capacity) {}
+
+    // Records a partition written with partition_size bytes and rows rows.
+    // Once at capacity, the smallest partition is forgotten.
+    void record(const schema& s, const partition_key& pk, uint64_t partition_size, uint64_t rows);
+    // Looks up the partition of the token.
+    entry* find(const utils::UUID& table, const dht::token& t) noexcept;
+    const entry* find(const utils::UUID& table, const dht::token& t) const noexcept;
+    // Counts a single-partition read of a tracked partition.
+    void count_read(entry& e) noexcept {
+        ++_reads;
+        ++e.reads;
+    }
+    // Forgets the partitions of the table, e.g. once it's dropped or truncated.
+    void forget(const utils::UUID& table) noexcept;
+
+    bool empty() const noexcept { return _partitions.empty(); }
+    const std::map<key, entry>& partitions() const noexcept { return _partitions; }
+    // Single-partition reads of tracked partitions.
+    uint64_t reads() const noexcept { return _reads; }
+};
+
 class large_data_handler {
 public:
     struct stats {
         int64_t partitions_bigger_than_threshold = 0; // number of large partition updates exceeding threshold_bytes
     };
 
+    static constexpr size_t large_partitions_capacity = 1000;
+
 private:
     // Assuming:
     // * there is at most one log entry every 1MB
@@ -55,6 +111,7 @@ class large_data_handler {
     uint64_t _cell_threshold_bytes;
     uint64_t _rows_count_threshold;
     mutable large_data_handler::stats _stats;
+    large_partitions_tracker _large_partitions{large_partitions_capacity};
 
 public:
     explicit large_data_handler(uint64_t partition_threshold_bytes, uint64_t row_threshold_bytes, uint64_t cell_threshold_bytes, uint64_t rows_count_threshold);
@@ -101,6 +158,9 @@ class large_data_handler {
 
     const large_data_handler::stats& stats() const { return _stats; }
 
+    large_partitions_tracker& large_partitions() noexcept { return _large_partitions; }
+    const large_partitions_tracker& large_partitions() const noexcept { return _large_partitions; }
+
     uint64_t get_partition_threshold_bytes() const noexcept {
         return _partition_threshold_bytes;
     }
@@ -156,7 +156,7 @@ static future<user_types_to_drop> merge_types(distributed<service::storage_proxy
 static future<> merge_functions(distributed<service::storage_proxy>& proxy, schema_result before, schema_result after);
 static future<> merge_aggregates(distributed<service::storage_proxy>& proxy, schema_result before, schema_result after);
 
-static future<> do_merge_schema(distributed<service::storage_proxy>&, std::vector<mutation>, bool do_flush);
+static future<std::set<sstring>> do_merge_schema(distributed<service::storage_proxy>&, std::vector<mutation>, bool do_flush);
 
 using computed_columns_map = std::unordered_map<bytes, column_computation_ptr>;
 static computed_columns_map get_computed_columns(const schema_mutations& sm);
@@ -857,9 +857,161 @@ static future<> with_merge_lock(noncopyable_function<future<> ()> func) {
     }
 }
 
+// Records the data fed to it, so that it can be fed to another hasher later.
+class recording_hasher : public hasher {
+    bytes_ostream _data;
+    bool _failed = false;
+public:
+    void update(const char* ptr, size_t size) noexcept override {
+        try {
+            _data.write(ptr, size);
+        } catch (...) {
+            _failed = true;
+        }
+    }
+
+    bytes get() && {
+        if (_failed) {
+            throw std::bad_alloc();
+        }
+        return bytes(_data.linearize());
+    }
+};
+
+// The data fed into the schema digest by each partition of the schema tables, so that
+// a merge only has to re-read the keyspaces it changed to recalculate the schema version,
+// instead of all of the schema.  The schema digest is a single MD5 over all of the
+// partitions, in the order of the tables and then of the ring, and it must stay the
+// same on all the nodes, so it can't be calculated from per-keyspace digests.
+//
+// Lives on shard 0 and is only accessed under the merge lock.
+class schema_digest_cache {
+    using partition_digest_data = std::pair<dht::decorated_key, bytes>;
+
+    // Engaged when the cache is filled.
+    std::optional<schema_features::mask_type> _features;
+    // For each of all_table_names(), the data of its non-empty partitions, in ring order.
+    std::vector<std::vector<partition_digest_data>> _tables;
+public:
+    void clear() noexcept {
+        _features.reset();
+        _tables.clear();
+    }
+
+    bool valid_for(schema_features features) const noexcept {
+        return _features == features.mask();
+    }
+
+    future<> fill(distributed<service::storage_proxy>& proxy, schema_features features) {
+        clear();
+        std::vector<std::vector<partition_digest_data>> tables;
+        for (auto& table : all_table_names(features)) {
+            auto rs = co_await db::system_keyspace::query_mutations(proxy, NAME, table);
+            auto s = proxy.local().get_db().local().find_schema(NAME, table);
+            std::vector<partition_digest_data> partitions;
+            for (auto&& p : rs->partitions()) {
+                auto mut = p.mut().unfreeze(s);
+                auto partition_key = value_cast<sstring>(utf8_type->deserialize(mut.key().get_component(*s, 0)));
+                if (is_system_keyspace(partition_key)) {
+                    continue;
+                }
+                auto data = digest_data(mut, features);
+                if (!data.empty()) {
+                    partitions.emplace_back(mut.decorated_key(), std::move(data));
+                }
+            }
+            tables.push_back(std::move(partitions));
+        }
+        _tables = std::move(tables);
+        _features = features.mask();
+    }
+
+    // Re-reads the partitions of the given keyspaces.
+    future<> refresh(distributed<service::storage_proxy>& proxy, schema_features features, const std::set<sstring>& keyspaces) {
+        assert(valid_for(features));
+        auto table_names = all_table_names(features);
+        try {
+            for (size_t i = 0; i < table_names.size(); ++i) {
+                auto s = proxy.local().get_db().local().find_schema(NAME, table_names[i]);
+                auto& partitions = _tables[i];
+                for (auto& keyspace_name : keyspaces) {
+                    if (is_system_keyspace(keyspace_name)) {
+                        continue;
+                    }
+                    auto key = partition_key::from_singular(*s, keyspace_name);
+                    auto slice = s->full_slice();
+                    auto cmd = make_lw_shared<query::read_command>(s->id(), s->version(), std::move(slice), proxy.local().get_max_result_size(slice));
+                    auto mut = co_await query_partition_mutation(proxy.local(), s, std::move(cmd), std::move(key));
+                    auto data = digest_data(mut, features);
+                    auto less = dht::decorated_key::less_comparator(s);
+                    auto it = std::lower_bound(partitions.begin(), partitions.end(), mut.decorated_key(), [&] (const partition_digest_data& p, const dht::decorated_key& dk) {
+                        return less(p.first, dk);
+                    });
+                    bool present = it != partitions.end() && it->first.equal(*s, mut.decorated_key());
+                    if (data.empty()) {
+                        if (present) {
+                            partitions.erase(it);
+                        }
+                    } else if (present) {
+                        it->second = std::move(data);
+                    } else {
+                        partitions.emplace(it, mut.decorated_key(), std::move(data));
+                    }
+                }
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    utils::UUID digest() const {
+        assert(_features);
+        auto hash = md5_hasher();
+        for (auto& partitions : _tables) {
+            for (auto& p : partitions) {
+                hash.update(reinterpret_cast<const char*>(p.second.data()), p.second.size());
+            }
+        }
+        return utils::UUID_gen::get_name_UUID(hash.finalize());
+    }
+private:
+    static bytes digest_data(const mutation& m, schema_features features) {
+        recording_hasher h;
+        feed_hash_for_schema_digest(h, redact_columns_for_missing_features(m, features), features);
+        return std::move(h).get();
+    }
+};
+
+static thread_local schema_digest_cache the_schema_digest_cache;
+
+static future<> invalidate_schema_digest_cache() {
+    return smp::submit_to(0, [] {
+        the_schema_digest_cache.clear();
+    });
+}
+
+// Calculates the same digest as calculate_schema_digest(), re-reading only the given
+// keyspaces if the digest was calculated before, or all of them if changed_keyspaces is
+// std::nullopt.
+static future<utils::UUID> calculate_schema_digest_incrementally(distributed<service::storage_proxy>& proxy, schema_features features, std::optional<std::set<sstring>> changed_keyspaces) {
+    // Partitions which compact to nothing may only be left out of the digest with this feature.
+    if (this_shard_id() != 0 || !features.contains<schema_feature::DIGEST_INSENSITIVE_TO_EXPIRY>()) {
+        co_await invalidate_schema_digest_cache();
+        co_return co_await calculate_schema_digest(proxy, features);
+    }
+    auto& cache = the_schema_digest_cache;
+    if (changed_keyspaces && cache.valid_for(features)) {
+        co_await cache.refresh(proxy, features, *changed_keyspaces);
+    } else {
+        co_await cache.fill(proxy, features);
+    }
+    co_return cache.digest();
+}
+
 static
-future<> update_schema_version_and_announce(distributed<service::storage_proxy>& proxy, schema_features features) {
-    auto uuid = co_await calculate_schema_digest(proxy, features);
+future<> update_schema_version_and_announce(distributed<service::storage_proxy>& proxy, schema_features features, std::optional<std::set<sstring>> changed_keyspaces) {
+    auto uuid = co_await calculate_schema_digest_incrementally(proxy, features, std::move(changed_keyspaces));
     co_await db::system_keyspace::update_schema_version(uuid);
     co_await proxy.local().get_db().invoke_on_all([uuid] (replica::database& db) {
         db.update_version(uuid);
@@ -880,14 +1032,25 @@ future<> merge_schema(distributed<service::storage_proxy>& proxy, gms::feature_s
 {
     co_await with_merge_lock([&] () mutable -> future<> {
         bool flush_schema = proxy.local().get_db().local().get_config().flush_schema_tables_after_modification();
-        co_await do_merge_schema(proxy, std::move(mutations), flush_schema);
-        co_await update_schema_version_and_announce(proxy, feat.cluster_schema_features());
+        std::set<sstring> keyspaces;
+        std::exception_ptr ep;
+        try {
+            keyspaces = co_await do_merge_schema(proxy, std::move(mutations), flush_schema);
+        } catch (...) {
+            ep = std::current_exception();
+        }
+        if (ep) {
+            // The merge may have been applied only in part, we don't know what changed.
+            co_await invalidate_schema_digest_cache();
+            std::rethrow_exception(std::move(ep));
+        }
+        co_await update_schema_version_and_announce(proxy, feat.cluster_schema_features(), std::move(keyspaces));
     });
 }
 
 future<> recalculate_schema_version(distributed<service::storage_proxy>& proxy, gms::feature_service& feat) {
     co_await with_merge_lock([&] () -> future<> {
-        co_await update_schema_version_and_announce(proxy, feat.cluster_schema_features());
+        co_await update_schema_version_and_announce(proxy, feat.cluster_schema_features(), std::nullopt);
     });
 }
 
@@ -1016,7 +1179,7 @@ future<> store_column_mapping(distributed<service::storage_proxy>& proxy, schema
     co_await proxy.local().mutate_locally(std::move(muts), tracing::trace_state_ptr());
 }
 
-static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std::vector<mutation> mutations, bool do_flush)
+static future<std::set<sstring>> do_merge_schema(distributed<service::storage_proxy>& proxy, std::vector<mutation> mutations, bool do_flush)
 {
     slogger.trace("do_merge_schema: {}", mutations);
     schema_ptr s = keyspaces();
@@ -1075,6 +1238,8 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std:
             co_await db.get_notifier().drop_keyspace(keyspace_to_drop);
         }
     });
+
+    co_return keyspaces;
 }
 
 future<std::set<sstring>> merge_keyspaces(distributed<service::storage_proxy>& proxy, schema_result&& before, schema_result&& after)
@@ -1154,6 +1319,17 @@ enum class schema_diff_side {
     right, // new, after
 };
 
+// Returns the schema of the table the database has if it's of the given version,
+// and nullptr otherwise. Saves rebuilding the old schema of altered tables from
+// their mutations, as it's almost always the one in use.
+static schema_ptr current_schema_of_version(const replica::database& db, const utils::UUID& id, table_schema_version version) {
+    if (!db.column_family_exists(id)) {
+        return nullptr;
+    }
+    auto s = db.find_schema(id);
+    return s->version() == version ? s : nullptr;
+}
+
 static schema_diff diff_table_or_view(distributed<service::storage_proxy>& proxy,
     std::map<utils::UUID, schema_mutations>&& before,
     std::map<utils::UUID, schema_mutations>&& after,
@@ -1172,7 +1348,10 @@ static schema_diff diff_table_or_view(distributed<service::storage_proxy>& proxy
         d.created.emplace_back(s);
     }
     for (auto&& key : diff.entries_differing) {
-        auto s_before = create_schema(std::move(before.at(key)), schema_diff_side::left);
+        auto s_before = current_schema_of_version(proxy.local().get_db().local(), key, before.at(key).digest());
+        if (!s_before) {
+            s_before = create_schema(std::move(before.at(key)), schema_diff_side::left);
+        }
         auto s = create_schema(std::move(after.at(key)), schema_diff_side::right);
         slogger.info("Altering {}.{} id={} version={}", s->ks_name(), s->cf_name(), s->id(), s->version());
         d.altered.emplace_back(schema_diff::altered_schema{s_before, s});
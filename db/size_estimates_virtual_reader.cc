@@ -175,7 +175,8 @@ static system_keyspace::range_estimates estimate(const replica::column_family& c
     for (auto&& r : ranges) {
         auto rp_range = as_ring_position_range(r);
         for (auto&& sstable : cf.select_sstables(rp_range)) {
-            count += sstable->estimated_keys_for_range(r);
+            auto counts = sstable->estimated_counts_for_range(r);
+            count += counts ? counts->partitions : sstable->estimated_keys_for_range(r);
             hist.merge(sstable->get_stats_metadata().estimated_partition_size);
         }
     }
@@ -12,12 +12,22 @@
 
 #include <boost/range/adaptors.hpp>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include "db/snapshot-ctl.hh"
+#include "db/config.hh"
 #include "replica/database.hh"
+#include "sstables/sstables.hh"
+#include "service/priority_manager.hh"
+#include "utils/rate_limiter.hh"
+#include "lister.hh"
+#include "log.hh"
 
 namespace db {
 
+static logging::logger snap_log("snapshots");
+
 future<> snapshot_ctl::check_snapshot_not_exist(sstring ks_name, sstring name, std::optional<std::vector<sstring>> filter) {
     auto& ks = _db.local().find_keyspace(ks_name);
     return parallel_for_each(ks.metadata()->cf_meta_data(), [this, ks_name = std::move(ks_name), name = std::move(name), filter = std::move(filter)] (auto& pair) {
@@ -116,6 +126,154 @@ future<> snapshot_ctl::clear_snapshot(sstring tag, std::vector<sstring> keyspace
     });
 }
 
+namespace {
+
+struct backup_file {
+    sstring source;
+    sstring destination_dir;
+    sstring name;
+};
+
+}
+
+// Copies the file through a temporary one, renamed into place once complete, so
+// an interrupted upload is not mistaken for an uploaded file by the next one.
+// Returns the number of bytes uploaded, or nothing if the file was already uploaded.
+static future<std::optional<uint64_t>> upload_file(const backup_file& f, utils::rate_limiter& limiter) {
+    auto destination = f.destination_dir + "/" + f.name;
+    auto size = co_await file_size(f.source);
+    if (co_await file_exists(destination) && co_await file_size(destination) == size) {
+        co_return std::nullopt;
+    }
+    auto tmp = destination + ".tmp";
+    auto& pc = service::get_local_streaming_priority();
+
+    auto src = co_await open_file_dma(f.source, open_flags::ro);
+    file_input_stream_options in_opts;
+    in_opts.buffer_size = 128 * 1024;
+    in_opts.read_ahead = 2;
+    in_opts.io_priority_class = pc;
+    auto in = make_file_input_stream(std::move(src), 0, size, std::move(in_opts));
+
+    std::exception_ptr ex;
+    try {
+        auto dst = co_await open_file_dma(tmp, open_flags::wo | open_flags::create | open_flags::truncate);
+        file_output_stream_options out_opts;
+        out_opts.buffer_size = 128 * 1024;
+        out_opts.io_priority_class = pc;
+        auto out = co_await make_file_output_stream(std::move(dst), std::move(out_opts));
+        try {
+            for (;;) {
+                auto buf = co_await in.read();
+                if (buf.empty()) {
+                    break;
+                }
+                co_await limiter.reserve(buf.size());
+                co_await out.write(buf.get(), buf.size());
+            }
+            co_await out.flush();
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        // Closing the stream syncs the file.
+        co_await out.close();
+    } catch (...) {
+        ex = ex ? ex : std::current_exception();
+    }
+    co_await in.close();
+    if (ex) {
+        co_await remove_file(tmp).handle_exception([] (std::exception_ptr) {});
+        std::rethrow_exception(ex);
+    }
+    co_await rename_file(tmp, destination);
+    co_return size;
+}
+
+future<snapshot_ctl::backup_stats> snapshot_ctl::backup_snapshot(sstring tag, std::vector<sstring> keyspace_names, sstring destination) {
+    if (tag.empty()) {
+        throw std::runtime_error("You must supply a snapshot name.");
+    }
+    if (destination.empty()) {
+        throw std::runtime_error("You must supply a destination directory.");
+    }
+
+    if (keyspace_names.size() == 0) {
+        boost::copy(_db.local().get_keyspaces() | boost::adaptors::map_keys, std::back_inserter(keyspace_names));
+    }
+
+    // Holding the lock for read keeps the snapshot from being cleared while it's uploaded.
+    return run_snapshot_list_operation([this, tag = std::move(tag), keyspace_names = std::move(keyspace_names), destination = std::move(destination)] {
+        return do_backup_snapshot(tag, keyspace_names, destination);
+    });
+}
+
+// Each shard uploads every smp::count-th file.
+static future<snapshot_ctl::backup_stats> upload_files(const std::vector<backup_file>& files, size_t rate) {
+    snapshot_ctl::backup_stats stats;
+    utils::rate_limiter limiter(rate);
+    for (size_t i = this_shard_id(); i < files.size(); i += smp::count) {
+        if (auto bytes = co_await upload_file(files[i], limiter)) {
+            stats.files_uploaded++;
+            stats.bytes_uploaded += *bytes;
+        } else {
+            stats.files_skipped++;
+        }
+    }
+    co_return stats;
+}
+
+future<snapshot_ctl::backup_stats> snapshot_ctl::do_backup_snapshot(sstring tag, std::vector<sstring> keyspace_names, sstring destination) {
+    auto& db = _db.local();
+    std::vector<backup_file> files;
+    for (auto& ks_name : keyspace_names) {
+        auto& ks = db.find_keyspace(ks_name);
+        for (auto& [cf_name, schema] : ks.metadata()->cf_meta_data()) {
+            auto& cf = db.find_column_family(schema);
+            auto table_destination = format("{}/{}/{}", destination, ks_name, fs::path(cf.dir()).filename().native());
+            auto manifest_destination = format("{}/{}/{}", table_destination, sstables::snapshots_dir, tag);
+            for (auto& dir : cf.snapshot_dirs(tag)) {
+                if (!co_await file_exists(dir)) {
+                    continue;
+                }
+                co_await lister::scan_dir(dir, { directory_entry_type::regular }, [&] (fs::path parent, directory_entry de) {
+                    bool is_sstable_component = de.name != "manifest.json" && de.name != "schema.cql";
+                    files.push_back(backup_file{(parent / de.name).native(), is_sstable_component ? table_destination : manifest_destination, de.name});
+                    return make_ready_future<>();
+                });
+            }
+        }
+    }
+    if (files.empty()) {
+        throw std::runtime_error(format("Snapshot {} not found", tag));
+    }
+
+    std::set<sstring> dirs;
+    for (auto& f : files) {
+        dirs.insert(f.destination_dir);
+    }
+    for (auto& dir : dirs) {
+        co_await recursive_touch_directory(dir);
+    }
+
+    // Each shard gets its share of the throughput.
+    size_t rate = size_t(db.get_config().backup_throughput_mb_per_sec()) * 1024 * 1024 / smp::count;
+    snap_log.info("Uploading {} files of snapshot {} to {}", files.size(), tag, destination);
+    auto stats = co_await _db.map_reduce0([&files, rate] (replica::database& db) {
+        return with_scheduling_group(db.get_streaming_scheduling_group(), [&files, rate] {
+            return upload_files(files, rate);
+        });
+    }, backup_stats(), [] (backup_stats a, const backup_stats& b) {
+        return a += b;
+    });
+
+    for (auto& dir : dirs) {
+        co_await sync_directory(dir);
+    }
+    snap_log.info("Uploaded snapshot {} to {}: {} files ({} bytes) uploaded, {} already there", tag, destination,
+            stats.files_uploaded, stats.bytes_uploaded, stats.files_skipped);
+    co_return stats;
+}
+
 future<std::unordered_map<sstring, std::vector<snapshot_ctl::snapshot_details>>>
 snapshot_ctl::get_snapshot_details() {
     using snapshot_map = std::unordered_map<sstring, std::vector<snapshot_ctl::snapshot_details>>;
@@ -36,6 +36,19 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
 
         bool operator==(const snapshot_details&) const = default;
     };
+
+    struct backup_stats {
+        uint64_t files_uploaded = 0;
+        uint64_t bytes_uploaded = 0;
+        uint64_t files_skipped = 0;
+
+        backup_stats& operator+=(const backup_stats& o) noexcept {
+            files_uploaded += o.files_uploaded;
+            bytes_uploaded += o.bytes_uploaded;
+            files_skipped += o.files_skipped;
+            return *this;
+        }
+    };
     explicit snapshot_ctl(sharded<replica::database>& db) : _db(db) {}
 
     future<> stop() {
@@ -84,6 +97,23 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
      */
     future<> clear_snapshot(sstring tag, std::vector<sstring> keyspace_names, sstring cf_name);
 
+    /**
+     * Copies the snapshot with the given name of the given keyspaces to the destination
+     * directory, typically a mount of an object store. The sstables of each table go to
+     * <destination>/<keyspace>/<table directory>/, shared by all the snapshots uploaded
+     * there, and the manifest and schema to the snapshots/<tag> directory under it.
+     *
+     * Sstable files are immutable, so those already at the destination, with the same
+     * size, are skipped: only the sstables sealed since the last uploaded snapshot are
+     * copied. All shards upload in parallel, in the streaming scheduling group, within
+     * backup_throughput_mb_per_sec.
+     *
+     * @param tag the name of the snapshot; may not be null or empty
+     * @param keyspace_names the keyspaces to upload; empty means "all."
+     * @param destination the directory to upload to
+     */
+    future<backup_stats> backup_snapshot(sstring tag, std::vector<sstring> keyspace_names, sstring destination);
+
     future<std::unordered_map<sstring, std::vector<snapshot_details>>> get_snapshot_details();
 
     future<int64_t> true_snapshots_size();
@@ -92,6 +122,8 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
     seastar::rwlock _lock;
     seastar::gate _ops;
 
+    future<backup_stats> do_backup_snapshot(sstring tag, std::vector<sstring> keyspace_names, sstring destination);
+
     future<> check_snapshot_not_exist(sstring ks_name, sstring name, std::optional<std::vector<sstring>> filter = {});
 
     template <typename Func>
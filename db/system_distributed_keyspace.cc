@@ -189,7 +189,9 @@ system_distributed_keyspace::system_distributed_keyspace(cql3::query_processor&
 
 static thread_local std::pair<std::string_view, data_type> new_columns[] {
     {"timeout", duration_type},
-    {"workload_type", utf8_type}
+    {"workload_type", utf8_type},
+    {"max_requests_per_second", long_type},
+    {"shares", int32_type}
 };
 
 static bool has_missing_columns(data_dictionary::database db) noexcept {
@@ -793,6 +795,22 @@ static qos::service_level_options::timeout_type get_duration(const cql3::untyped
     return std::chrono::duration_cast<lowres_clock::duration>(std::chrono::nanoseconds(dur_opt->nanoseconds));
 };
 
+static qos::service_level_options::rate_limit_type get_rate_limit(const cql3::untyped_result_set_row& row, std::string_view col_name) {
+    auto v = row.get_opt<int64_t>(col_name);
+    if (!v) {
+        return qos::service_level_options::unset_marker{};
+    }
+    return uint64_t(*v);
+}
+
+static qos::service_level_options::shares_type get_shares(const cql3::untyped_result_set_row& row, std::string_view col_name) {
+    auto v = row.get_opt<int32_t>(col_name);
+    if (!v) {
+        return qos::service_level_options::unset_marker{};
+    }
+    return *v;
+}
+
 future<qos::service_levels_info> system_distributed_keyspace::get_service_levels() const {
     static sstring prepared_query = format("SELECT * FROM {}.{};", NAME, SERVICE_LEVELS);
 
@@ -805,6 +823,8 @@ future<qos::service_levels_info> system_distributed_keyspace::get_service_levels
                 qos::service_level_options slo{
                     .timeout = get_duration(row, "timeout"),
                     .workload = workload.value_or(qos::service_level_options::workload_type::unspecified),
+                    .max_requests_per_second = get_rate_limit(row, "max_requests_per_second"),
+                    .shares = get_shares(row, "shares"),
                 };
                 service_levels.emplace(service_level_name, slo);
             } catch (...) {
@@ -827,6 +847,8 @@ future<qos::service_levels_info> system_distributed_keyspace::get_service_level(
                 qos::service_level_options slo{
                     .timeout = get_duration(row, "timeout"),
                     .workload = workload.value_or(qos::service_level_options::workload_type::unspecified),
+                    .max_requests_per_second = get_rate_limit(row, "max_requests_per_second"),
+                    .shares = get_shares(row, "shares"),
                 };
                 service_levels.emplace(service_level_name, slo);
             } catch (...) {
@@ -858,11 +880,21 @@ future<> system_distributed_keyspace::set_service_level(sstring service_level_na
     data_value workload = slo.workload == qos::service_level_options::workload_type::unspecified
             ? data_value::make_null(utf8_type)
             : data_value(qos::service_level_options::to_string(slo.workload));
-    co_await _qp.execute_internal(format("UPDATE {}.{} SET timeout = ?, workload_type = ? WHERE service_level = ?;", NAME, SERVICE_LEVELS),
+    auto max_requests_per_second = std::visit(overloaded_functor {
+        [&] (uint64_t v) { return data_value(int64_t(v)); },
+        [&] (const auto&) { return data_value::make_null(long_type); },
+    }, slo.max_requests_per_second);
+    auto shares = std::visit(overloaded_functor {
+        [&] (int32_t v) { return data_value(v); },
+        [&] (const auto&) { return data_value::make_null(int32_type); },
+    }, slo.shares);
+    co_await _qp.execute_internal(format("UPDATE {}.{} SET timeout = ?, workload_type = ?, max_requests_per_second = ?, shares = ? WHERE service_level = ?;", NAME, SERVICE_LEVELS),
                 db::consistency_level::ONE,
                 internal_distributed_query_state(),
                 {to_data_value(slo.timeout),
                     workload,
+                    max_requests_per_second,
+                    shares,
                     service_level_name});
 }
 
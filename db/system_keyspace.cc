@@ -52,11 +52,14 @@
 #include "db/size_estimates_virtual_reader.hh"
 #include "db/timeout_clock.hh"
 #include "sstables/sstables.hh"
+#include "sstables/sstables_manager.hh"
+#include "db/large_data_handler.hh"
 #include "db/view/build_progress_virtual_reader.hh"
 #include "db/schema_tables.hh"
 #include "index/built_indexes_virtual_reader.hh"
 #include "utils/generation-number.hh"
 #include "db/virtual_table.hh"
+#include "db/data_listeners.hh"
 #include "service/storage_service.hh"
 #include "gms/gossiper.hh"
 #include "service/paxos/paxos_state.hh"
@@ -207,7 +210,10 @@ schema_ptr system_keyspace::raft() {
             .with_column("commit_idx", long_type, column_kind::static_column)
 
             .set_comment("Persisted RAFT log, votes and snapshot info")
-            .with_version(generate_schema_version(id))
+            // The table is local, the tombstones left by log truncation
+            // don't have to wait for repair to be purged.
+            .set_gc_grace_seconds(0)
+            .with_version(generate_schema_version(id, 1))
             .set_wait_for_sync_to_commitlog(true)
             .with_null_sharder()
             .build();
@@ -281,6 +287,23 @@ schema_ptr system_keyspace::repair_history() {
     return schema;
 }
 
+schema_ptr system_keyspace::prepared_statements() {
+    static thread_local auto schema = [] {
+        auto id = generate_legacy_id(NAME, PREPARED_STATEMENTS);
+        return schema_builder(NAME, PREPARED_STATEMENTS, std::optional(id))
+            .with_column("prepared_id", bytes_type, column_kind::partition_key)
+            // Empty if the statement was prepared without a current keyspace
+            .with_column("logged_keyspace", utf8_type)
+            .with_column("query_string", utf8_type)
+            // The versions of the schemas of the tables the statement uses, by table id
+            .with_column("schema_versions", map_type_impl::get_instance(uuid_type, uuid_type, true))
+            .set_comment("Statements prepared by clients")
+            .with_version(generate_schema_version(id))
+            .build();
+    }();
+    return schema;
+}
+
 schema_ptr system_keyspace::built_indexes() {
     static thread_local auto built_indexes = [] {
         schema_builder builder(generate_legacy_id(NAME, BUILT_INDEXES), NAME, BUILT_INDEXES,
@@ -2403,6 +2426,315 @@ class versions_table : public memtable_filling_virtual_table {
     }
 };
 
+class hot_partitions_table : public memtable_filling_virtual_table {
+    distributed<replica::database>& _db;
+
+    struct hot_partition {
+        sstring keyspace_name;
+        sstring table_name;
+        int32_t shard;
+        sstring operation;
+        sstring key;
+        int64_t count;
+        int64_t error;
+    };
+public:
+    explicit hot_partitions_table(distributed<replica::database>& db)
+        : memtable_filling_virtual_table(build_schema())
+        , _db(db) {
+        _shard_aware = false;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "hot_partitions");
+        return schema_builder(system_keyspace::NAME, "hot_partitions", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("shard", int32_type, column_kind::clustering_key)
+            .with_column("operation", utf8_type, column_kind::clustering_key)
+            .with_column("partition_key", utf8_type, column_kind::clustering_key)
+            .with_column("count", long_type)
+            .with_column("error", long_type)
+            .set_comment("The hottest partitions of each shard in the last window, see hot_partitions_sample_period.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        auto hot_partitions = co_await _db.map_reduce0([] (replica::database& db) {
+            // The tracked keys hold schema_ptrs, which can't leave their shard.
+            std::vector<hot_partition> ret;
+            const auto& tracker = db.hot_partitions();
+            auto add = [&] (const sstring& operation, const db::hot_partitions_tracker::top_k::results& top) {
+                for (auto& r : top) {
+                    ret.push_back({r.item.schema->ks_name(), r.item.schema->cf_name(), int32_t(this_shard_id()), operation, sstring(r.item), r.count, r.error});
+                }
+            };
+            const auto k = db.get_config().hot_partitions_tracking_capacity();
+            add("read", tracker.top_reads(k));
+            add("write", tracker.top_writes(k));
+            return ret;
+        }, std::vector<hot_partition>(), [] (std::vector<hot_partition> a, std::vector<hot_partition> b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        });
+
+        std::map<sstring, mutation> mutations;
+        for (auto& hp : hot_partitions) {
+            auto it = mutations.find(hp.keyspace_name);
+            if (it == mutations.end()) {
+                it = mutations.emplace(hp.keyspace_name, mutation(schema(), partition_key::from_single_value(*schema(), data_value(hp.keyspace_name).serialize_nonnull()))).first;
+            }
+            auto ck = clustering_key::from_exploded(*schema(), {
+                data_value(hp.table_name).serialize_nonnull(),
+                data_value(hp.shard).serialize_nonnull(),
+                data_value(hp.operation).serialize_nonnull(),
+                data_value(hp.key).serialize_nonnull()
+            });
+            row& cr = it->second.partition().clustered_row(*schema(), std::move(ck)).cells();
+            set_cell(cr, "count", hp.count);
+            set_cell(cr, "error", hp.error);
+        }
+        for (auto& [_, m] : mutations) {
+            mutation_sink(std::move(m));
+        }
+    }
+};
+
+class large_partitions_tracked_table : public memtable_filling_virtual_table {
+    distributed<replica::database>& _db;
+
+    struct tracked_partition {
+        int32_t shard;
+        large_partitions_tracker::entry entry;
+    };
+public:
+    explicit large_partitions_tracked_table(distributed<replica::database>& db)
+        : memtable_filling_virtual_table(build_schema())
+        , _db(db) {
+        _shard_aware = false;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "large_partitions_tracked");
+        return schema_builder(system_keyspace::NAME, "large_partitions_tracked", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("shard", int32_type, column_kind::clustering_key)
+            .with_column("partition_key", utf8_type, column_kind::clustering_key)
+            .with_column("partition_size", long_type)
+            .with_column("rows", long_type)
+            .with_column("first_seen", timestamp_type)
+            .with_column("last_seen", timestamp_type)
+            .with_column("growth_bytes_per_hour", long_type)
+            .with_column("reads", long_type)
+            .set_comment("The large partitions each shard recently wrote, as reads see them.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        auto tracked = co_await _db.map_reduce0([] (replica::database& db) {
+            std::vector<tracked_partition> ret;
+            for (auto& [_, e] : db.get_user_sstables_manager().get_large_data_handler().large_partitions().partitions()) {
+                ret.push_back({int32_t(this_shard_id()), e});
+            }
+            return ret;
+        }, std::vector<tracked_partition>(), [] (std::vector<tracked_partition> a, std::vector<tracked_partition> b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        });
+
+        std::map<sstring, mutation> mutations;
+        for (auto& [shard, e] : tracked) {
+            auto it = mutations.find(e.ks_name);
+            if (it == mutations.end()) {
+                it = mutations.emplace(e.ks_name, mutation(schema(), partition_key::from_single_value(*schema(), data_value(e.ks_name).serialize_nonnull()))).first;
+            }
+            auto ck = clustering_key::from_exploded(*schema(), {
+                data_value(e.cf_name).serialize_nonnull(),
+                data_value(shard).serialize_nonnull(),
+                data_value(e.partition_key).serialize_nonnull()
+            });
+            row& cr = it->second.partition().clustered_row(*schema(), std::move(ck)).cells();
+            set_cell(cr, "partition_size", int64_t(e.size));
+            set_cell(cr, "rows", int64_t(e.rows));
+            set_cell(cr, "first_seen", e.first_seen);
+            set_cell(cr, "last_seen", e.last_seen);
+            auto hours = std::chrono::duration<double, std::ratio<3600>>(e.last_seen - e.first_seen).count();
+            if (hours > 0) {
+                set_cell(cr, "growth_bytes_per_hour", int64_t((e.size - e.first_size) / hours));
+            }
+            set_cell(cr, "reads", int64_t(e.reads));
+        }
+        for (auto& [_, m] : mutations) {
+            mutation_sink(std::move(m));
+        }
+    }
+};
+
+class table_latency_breakdown_table : public memtable_filling_virtual_table {
+    distributed<replica::database>& _db;
+
+    using table_latencies = std::map<std::pair<sstring, sstring>, replica::latency_breakdown>;
+public:
+    explicit table_latency_breakdown_table(distributed<replica::database>& db)
+        : memtable_filling_virtual_table(build_schema())
+        , _db(db) {
+        _shard_aware = false;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "table_latency_breakdown");
+        return schema_builder(system_keyspace::NAME, "table_latency_breakdown", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("stage", utf8_type, column_kind::clustering_key)
+            .with_column("count", long_type)
+            .with_column("total_us", long_type)
+            .with_column("mean_us", double_type)
+            .with_column("max_us", long_type)
+            .set_comment("The read and write latency of each table on the node, broken down by stage.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        auto latencies = co_await _db.map_reduce0([] (replica::database& db) {
+            table_latencies ret;
+            for (auto& [_, table] : db.get_column_families()) {
+                auto& s = *table->schema();
+                ret.emplace(std::pair(s.ks_name(), s.cf_name()), table->get_stats().latencies);
+            }
+            return ret;
+        }, table_latencies(), [] (table_latencies a, table_latencies b) {
+            for (auto& [name, lb] : b) {
+                auto& total = a[name];
+                for (size_t i = 0; i < replica::latency_breakdown::nr_stages; ++i) {
+                    total.stages[i] += lb.stages[i];
+                }
+            }
+            return a;
+        });
+
+        std::map<sstring, mutation> mutations;
+        for (auto& [name, lb] : latencies) {
+            auto& [ks_name, cf_name] = name;
+            auto it = mutations.find(ks_name);
+            if (it == mutations.end()) {
+                it = mutations.emplace(ks_name, mutation(schema(), partition_key::from_single_value(*schema(), data_value(ks_name).serialize_nonnull()))).first;
+            }
+            for (size_t i = 0; i < replica::latency_breakdown::nr_stages; ++i) {
+                const auto& st = lb.stages[i];
+                auto ck = clustering_key::from_exploded(*schema(), {
+                    data_value(cf_name).serialize_nonnull(),
+                    data_value(sstring(replica::latency_breakdown::name(replica::latency_breakdown::stage(i)))).serialize_nonnull()
+                });
+                row& cr = it->second.partition().clustered_row(*schema(), std::move(ck)).cells();
+                set_cell(cr, "count", int64_t(st.count));
+                set_cell(cr, "total_us", int64_t(st.total_us));
+                set_cell(cr, "mean_us", st.count ? double(st.total_us) / st.count : 0.0);
+                set_cell(cr, "max_us", int64_t(st.max_us));
+            }
+        }
+        for (auto& [_, m] : mutations) {
+            mutation_sink(std::move(m));
+        }
+    }
+};
+
+class sstable_component_io_table : public memtable_filling_virtual_table {
+    distributed<replica::database>& _db;
+
+    struct table_io {
+        sstables::component_io_stats stats;
+        uint64_t bytes_returned = 0;
+    };
+    using tables_io = std::map<std::pair<sstring, sstring>, table_io>;
+public:
+    explicit sstable_component_io_table(distributed<replica::database>& db)
+        : memtable_filling_virtual_table(build_schema())
+        , _db(db) {
+        _shard_aware = false;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "sstable_component_io");
+        return schema_builder(system_keyspace::NAME, "sstable_component_io", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("component", utf8_type, column_kind::clustering_key)
+            .with_column("read_ops", long_type)
+            .with_column("bytes_read", long_type)
+            .with_column("mean_read_size", double_type)
+            .with_column("read_amplification", double_type)
+            .with_column("cache_hit_ratio", double_type)
+            .set_comment("The reads of each component of the sstables of each table on the node.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    future<> execute(std::function<void(mutation)> mutation_sink) override {
+        auto tables = co_await _db.map_reduce0([] (replica::database& db) {
+            tables_io ret;
+            auto add = [&] (const utils::UUID& id, const sstables::component_io_stats& stats) {
+                if (!db.column_family_exists(id)) {
+                    return;
+                }
+                auto& table = db.find_column_family(id);
+                auto& s = *table.schema();
+                auto& tio = ret[std::pair(s.ks_name(), s.cf_name())];
+                tio.stats += stats;
+                tio.bytes_returned = table.get_stats().query_bytes_returned;
+            };
+            db.get_user_sstables_manager().for_each_io_stats(add);
+            db.get_system_sstables_manager().for_each_io_stats(add);
+            return ret;
+        }, tables_io(), [] (tables_io a, tables_io b) {
+            for (auto& [name, tio] : b) {
+                auto& total = a[name];
+                total.stats += tio.stats;
+                total.bytes_returned += tio.bytes_returned;
+            }
+            return a;
+        });
+
+        using component = sstables::component_io_stats::component;
+        std::map<sstring, mutation> mutations;
+        for (auto& [name, tio] : tables) {
+            auto& [ks_name, cf_name] = name;
+            auto it = mutations.find(ks_name);
+            if (it == mutations.end()) {
+                it = mutations.emplace(ks_name, mutation(schema(), partition_key::from_single_value(*schema(), data_value(ks_name).serialize_nonnull()))).first;
+            }
+            for (size_t i = 0; i < sstables::component_io_stats::nr_components; ++i) {
+                const auto c = component(i);
+                const auto& cnt = tio.stats[c];
+                auto ck = clustering_key::from_exploded(*schema(), {
+                    data_value(cf_name).serialize_nonnull(),
+                    data_value(sstring(sstables::component_io_stats::name(c))).serialize_nonnull()
+                });
+                row& cr = it->second.partition().clustered_row(*schema(), std::move(ck)).cells();
+                set_cell(cr, "read_ops", int64_t(cnt.read_ops));
+                set_cell(cr, "bytes_read", int64_t(cnt.bytes_read));
+                set_cell(cr, "mean_read_size", cnt.read_ops ? double(cnt.bytes_read) / cnt.read_ops : 0.0);
+                if (tio.bytes_returned) {
+                    set_cell(cr, "read_amplification", double(cnt.bytes_read) / tio.bytes_returned);
+                }
+                // Only the index goes through a cache of its own. Its misses
+                // are what reaches the file.
+                const auto& requested = tio.stats.index_cache_requests;
+                if (c == component::index && requested.bytes_read) {
+                    set_cell(cr, "cache_hit_ratio", std::max(0.0, 1.0 - double(cnt.bytes_read) / requested.bytes_read));
+                }
+            }
+        }
+        for (auto& [_, m] : mutations) {
+            mutation_sink(std::move(m));
+        }
+    }
+};
+
 class db_config_table final : public streaming_virtual_table {
     db::config& _cfg;
 
@@ -2522,6 +2854,10 @@ void register_virtual_tables(distributed<replica::database>& dist_db, distribute
     add_table(std::make_unique<runtime_info_table>(dist_db, ss));
     add_table(std::make_unique<versions_table>());
     add_table(std::make_unique<db_config_table>(cfg));
+    add_table(std::make_unique<hot_partitions_table>(dist_db));
+    add_table(std::make_unique<large_partitions_tracked_table>(dist_db));
+    add_table(std::make_unique<table_latency_breakdown_table>(dist_db));
+    add_table(std::make_unique<sstable_component_io_table>(dist_db));
 }
 
 std::vector<schema_ptr> system_keyspace::all_tables(const db::config& cfg) {
@@ -2533,7 +2869,7 @@ std::vector<schema_ptr> system_keyspace::all_tables(const db::config& cfg) {
                     compactions_in_progress(), compaction_history(),
                     sstable_activity(), clients(), size_estimates(), large_partitions(), large_rows(), large_cells(),
                     scylla_local(), db::schema_tables::scylla_table_schema_history(),
-                    repair_history(),
+                    repair_history(), prepared_statements(),
                     v3::views_builds_in_progress(), v3::built_views(),
                     v3::scylla_views_builds_in_progress(),
                     v3::truncated(),
@@ -2744,6 +3080,38 @@ future<> system_keyspace::get_compaction_history(compaction_history_consumer&& f
     });
 }
 
+future<> system_keyspace::save_prepared_statement(bytes id, sstring keyspace, sstring query_string, std::unordered_map<utils::UUID, utils::UUID> schema_versions) {
+    sstring req = format("INSERT INTO system.{} (prepared_id, logged_keyspace, query_string, schema_versions) VALUES (?, ?, ?, ?)", PREPARED_STATEMENTS);
+    auto map_type = map_type_impl::get_instance(uuid_type, uuid_type, true);
+    std::vector<std::pair<data_value, data_value>> versions;
+    for (auto& [table_id, version] : schema_versions) {
+        versions.emplace_back(data_value(table_id), data_value(version));
+    }
+    return qctx->execute_cql(req, std::move(id), std::move(keyspace), std::move(query_string), make_map_value(map_type, std::move(versions))).discard_result();
+}
+
+future<> system_keyspace::remove_prepared_statement(bytes id) {
+    sstring req = format("DELETE FROM system.{} WHERE prepared_id = ?", PREPARED_STATEMENTS);
+    return qctx->execute_cql(req, std::move(id)).discard_result();
+}
+
+future<std::vector<system_keyspace::prepared_statement_entry>> system_keyspace::load_prepared_statements() {
+    sstring req = format("SELECT prepared_id, logged_keyspace, query_string, schema_versions FROM system.{}", PREPARED_STATEMENTS);
+    return qctx->execute_cql(req).then([] (::shared_ptr<cql3::untyped_result_set> rs) {
+        std::vector<prepared_statement_entry> entries;
+        entries.reserve(rs->size());
+        for (auto& row : *rs) {
+            entries.push_back(prepared_statement_entry{
+                row.get_blob("prepared_id"),
+                row.get_or<sstring>("logged_keyspace", sstring()),
+                row.get_as<sstring>("query_string"),
+                row.has("schema_versions") ? row.get_map<utils::UUID, utils::UUID>("schema_versions") : std::unordered_map<utils::UUID, utils::UUID>(),
+            });
+        }
+        return entries;
+    });
+}
+
 future<int> system_keyspace::increment_and_get_generation() {
     auto req = format("SELECT gossip_generation FROM system.{} WHERE key='{}'", LOCAL, LOCAL);
     return qctx->qp().execute_internal(req).then([] (auto rs) {
@@ -123,6 +123,7 @@ class system_keyspace {
     static constexpr auto RAFT_CONFIG = "raft_config";
     static constexpr auto REPAIR_HISTORY = "repair_history";
     static constexpr auto GROUP0_HISTORY = "group0_history";
+    static constexpr auto PREPARED_STATEMENTS = "prepared_statements";
     static const char *const CLIENTS;
 
     struct v3 {
@@ -206,6 +207,7 @@ class system_keyspace {
     static schema_ptr raft_snapshots();
     static schema_ptr repair_history();
     static schema_ptr group0_history();
+    static schema_ptr prepared_statements();
 
     static table_schema_version generate_schema_version(utils::UUID table_id, uint16_t offset = 0);
 
@@ -296,6 +298,18 @@ class system_keyspace {
     using compaction_history_consumer = noncopyable_function<future<>(const compaction_history_entry&)>;
     static future<> get_compaction_history(compaction_history_consumer&& f);
 
+    // The statements prepared by clients, see query_processor::remember_prepared().
+    struct prepared_statement_entry {
+        bytes id;
+        sstring keyspace;
+        sstring query_string;
+        std::unordered_map<utils::UUID, utils::UUID> schema_versions;
+    };
+
+    static future<> save_prepared_statement(bytes id, sstring keyspace, sstring query_string, std::unordered_map<utils::UUID, utils::UUID> schema_versions);
+    static future<> remove_prepared_statement(bytes id);
+    static future<std::vector<prepared_statement_entry>> load_prepared_statements();
+
     typedef std::vector<db::replay_position> replay_positions;
 
     static future<> save_truncation_record(utils::UUID, db_clock::time_point truncated_at, db::replay_position);
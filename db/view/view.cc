@@ -14,6 +14,7 @@
 #include <deque>
 #include <functional>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -36,6 +37,7 @@
 #include "cql3/restrictions/statement_restrictions.hh"
 #include "db/view/view.hh"
 #include "db/view/view_builder.hh"
+#include "db/view/view_update_coalescer.hh"
 #include "db/view/view_updating_consumer.hh"
 #include "db/system_keyspace_view_types.hh"
 #include "db/system_keyspace.hh"
@@ -55,6 +57,7 @@
 #include "utils/error_injection.hh"
 #include "utils/exponential_backoff_retry.hh"
 #include "utils/fb_utilities.hh"
+#include "utils/hash.hh"
 #include "query-result-writer.hh"
 
 using namespace std::chrono_literals;
@@ -1235,6 +1238,75 @@ static future<> apply_to_remote_endpoints(gms::inet_address target, inet_address
             allow_hints);
 }
 
+size_t view_update_coalescer::key_hash::operator()(const key& k) const {
+    return utils::hash_combine(utils::hash_combine(std::hash<gms::inet_address>()(k.endpoint), std::hash<utils::UUID>()(k.version)),
+            std::hash<dht::token>()(k.token));
+}
+
+view_update_coalescer::view_update_coalescer(send_func send)
+    : _send(std::move(send))
+    , _flush_timer([this] { flush(); })
+{ }
+
+void view_update_coalescer::add(gms::inet_address endpoint, frozen_mutation_and_schema mut, dht::token base_token, dht::token view_token,
+        service::allow_hints allow_hints, tracing::trace_state_ptr tr_state, db::view::stats& stats, replica::cf_stats& cf_stats,
+        db::timeout_semaphore_units units, std::chrono::microseconds window) {
+    _pending_bytes += mut.fm.representation().size();
+    auto m = mut.fm.unfreeze(mut.s);
+    auto k = key{endpoint, mut.s->version(), view_token, m.key().representation()};
+    auto it = _pending.find(k);
+    if (it != _pending.end()) {
+        tracing::trace(tr_state, "Merging view update for {}.{} into the one pending for {}; view token = {}",
+                mut.s->ks_name(), mut.s->cf_name(), endpoint, view_token);
+        it->second.mut.apply(std::move(m));
+        it->second.units.adopt(std::move(units));
+        ++it->second.updates;
+    } else {
+        _pending.emplace(std::move(k), pending_update{mut.s, std::move(m), base_token, view_token, allow_hints, std::move(tr_state),
+                stats, cf_stats, std::move(units)});
+    }
+    if (_pending_bytes >= max_pending_bytes) {
+        flush();
+    } else if (!_flush_timer.armed()) {
+        _flush_timer.arm(window);
+    }
+}
+
+void view_update_coalescer::flush() {
+    _flush_timer.cancel();
+    _pending_bytes = 0;
+    for (auto&& [k, u] : std::exchange(_pending, {})) {
+        auto endpoint = k.endpoint;
+        u.stats.view_updates_pushed_remote += 1;
+        u.cf_stats.total_view_updates_pushed_remote += 1;
+        tracing::trace(u.tr_state, "Sending view update coalesced from {} updates for {}.{} to {}; base token = {}; view token = {}",
+                u.updates, u.s->ks_name(), u.s->cf_name(), endpoint, u.base_token, u.view_token);
+        // The send is in the background, like all coalesced updates, its parallelism is limited by
+        // the view update concurrency semaphore.
+        (void)with_gate(_gate, [this, endpoint, u = std::move(u)] () mutable {
+            return _send(endpoint, frozen_mutation_and_schema{freeze(u.mut), u.s}, u.allow_hints, u.tr_state).then_wrapped(
+                    [s = u.s, &stats = u.stats, &cf_stats = u.cf_stats, tr_state = u.tr_state, endpoint, base_token = u.base_token,
+                            view_token = u.view_token, updates = u.updates, units = std::move(u.units)] (future<>&& f) {
+                if (f.failed()) {
+                    stats.view_updates_failed_remote += 1;
+                    cf_stats.total_view_updates_failed_remote += 1;
+                    auto ep = f.get_exception();
+                    tracing::trace(tr_state, "Failed to apply view update coalesced from {} updates for {}", updates, endpoint);
+                    vlogger.error("Error applying view update to {} (view: {}.{}, base token: {}, view token: {}): {}",
+                            endpoint, s->ks_name(), s->cf_name(), base_token, view_token, ep);
+                    return;
+                }
+                tracing::trace(tr_state, "Successfully applied view update coalesced from {} updates for {}", updates, endpoint);
+            });
+        });
+    }
+}
+
+future<> view_update_coalescer::stop() {
+    flush();
+    return _gate.close();
+}
+
 // Take the view mutations generated by generate_view_updates(), which pertain
 // to a modification of a single base partition, and apply them to the
 // appropriate paired replicas. This is done asynchronously - we do not wait
@@ -1325,7 +1397,15 @@ future<> mutate_MV(
         // If target_endpoint is engaged by this point, then either the update
         // is not local, or the local update was already applied but we still
         // have pending endpoints to send to.
-        if (target_endpoint) {
+        const auto coalescing_window = std::chrono::microseconds(
+                service::get_local_storage_proxy().get_db().local().get_config().view_update_coalescing_window_in_us());
+        auto& coalescer = service::get_local_storage_proxy().get_view_update_coalescer();
+        if (target_endpoint && remote_endpoints.empty() && !wait_for_all && coalescing_window.count() && coalescer.accepts_updates()) {
+            tracing::trace(tr_state, "Holding back view update for {}.{} to {} to coalesce it; base token = {}; view token = {}",
+                    mut.s->ks_name(), mut.s->cf_name(), *target_endpoint, base_token, view_token);
+            coalescer.add(*target_endpoint, std::move(mut), base_token, view_token, allow_hints, tr_state,
+                    stats, cf_stats, sem_units.split(sem_units.count()), coalescing_window);
+        } else if (target_endpoint) {
             size_t updates_pushed_remote = remote_endpoints.size() + 1;
             stats.view_updates_pushed_remote += updates_pushed_remote;
             cf_stats.total_view_updates_pushed_remote += updates_pushed_remote;
@@ -1894,6 +1974,18 @@ class view_builder::consumer {
     // used to build it, and we cannot allow its serialized size to grow
     // beyond our limit on mutation size (by default 32 MB).
     size_t _fragments_memory_usage = 0;
+    // The batches whose view updates are being propagated in the background,
+    // in token order, each with the partition it was read from.
+    struct population {
+        dht::decorated_key key;
+        future<> done;
+    };
+    std::vector<population> _populations;
+
+    static future<> populate_views(lw_shared_ptr<replica::column_family> base, std::vector<view_and_base> views, dht::token token,
+            flat_mutation_reader reader, gc_clock::time_point now, semaphore_units<> units) {
+        co_await base->populate_views(std::move(views), token, std::move(reader), now);
+    }
 public:
     consumer(view_builder& builder, build_step& step, gc_clock::time_point now)
             : _builder(builder)
@@ -1905,6 +1997,42 @@ class view_builder::consumer {
         }
     }
 
+    consumer(consumer&&) = default;
+
+    ~consumer() {
+        // Only when the step failed, the results don't matter then.
+        for (auto& p : _populations) {
+            p.done.wait();
+            p.done.ignore_ready_future();
+        }
+    }
+
+    // Waits for the views to be populated with all the rows read so far. If that
+    // failed, the step is rewound to the first partition whose updates failed, so
+    // that it's read again when the step is retried.
+    void wait_for_populations() {
+        std::exception_ptr ex;
+        for (auto& p : _populations) {
+            try {
+                p.done.get();
+            } catch (...) {
+                if (!ex) {
+                    ex = std::current_exception();
+                    _step.current_key = p.key;
+                    for (auto& vs : _step.build_status) {
+                        if (vs.next_token && *vs.next_token > p.key.token()) {
+                            vs.next_token = p.key.token();
+                        }
+                    }
+                }
+            }
+        }
+        _populations.clear();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+
     void load_views_to_build() {
         inject_failure("view_builder_load_views");
         for (auto&& vs : _step.build_status) {
@@ -1985,17 +2113,21 @@ class view_builder::consumer {
         _builder._as.check();
         if (!_fragments.empty()) {
             _fragments.emplace_front(*_step.reader.schema(), _builder._permit, partition_start(_step.current_key, tombstone()));
+            auto units = get_units(_builder._populate_sem, 1).get0();
             auto base_schema = _step.base->schema();
             auto views = with_base_info_snapshot(_views_to_build);
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), _builder._permit, std::move(_fragments));
             auto close_reader = defer([&reader] { reader.close().get(); });
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
+            _populations.reserve(_populations.size() + 1);
+            close_reader.cancel();
+            _populations.push_back(population{_step.current_key, populate_views(
+                    _step.base,
                     std::move(views),
                     _step.current_token(),
                     std::move(reader),
-                    _now).get();
-            close_reader.cancel();
+                    _now,
+                    std::move(units))});
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -2010,6 +2142,7 @@ class view_builder::consumer {
     // Must be called in a seastar thread.
     built_views consume_end_of_stream() {
         inject_failure("view_builder_consume_end_of_stream");
+        wait_for_populations();
         if (vlogger.is_enabled(log_level::debug)) {
             auto view_names = boost::copy_range<std::vector<sstring>>(
                     _views_to_build | boost::adaptors::transformed([](auto v) {
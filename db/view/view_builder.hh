@@ -63,6 +63,11 @@ namespace db::view {
  * from one reader. We also strive for fairness, in that each build step inserts entries for
  * the views of a different base. Each build step reads and generates updates for batch_size rows.
  *
+ * While a build step reads, the view updates generated from the rows it has already read are
+ * propagated in the background, up to max_concurrent_populations batches at a time, so that reading
+ * the base table doesn't wait for the view replicas. The progress of a step is only recorded once
+ * all of its updates have been propagated.
+ *
  * We lack a controller, which could potentially allow us to go faster (to execute multiple steps at
  * the same time, or consume more rows per batch), and also which would apply backpressure, so we
  * could, for example, delay executing a build step.
@@ -157,6 +162,8 @@ class view_builder final : public service::migration_listener::only_view_notific
     // a build step we don't consider newly added or removed views. This simplifies
     // the algorithms. Also synchronizes an operation wrt. a call to stop().
     seastar::named_semaphore _sem{1, named_semaphore_exception_factory{"view builder"}};
+    // Bounds the batches of view updates propagated in the background by a build step.
+    seastar::semaphore _populate_sem{max_concurrent_populations};
     seastar::abort_source _as;
     future<> _started = make_ready_future<>();
     // Used to coordinate between shards the conclusion of the build process for a particular view.
@@ -183,6 +190,9 @@ class view_builder final : public service::migration_listener::only_view_notific
     // collected batch_memory_max bytes, we can process the rows read so far.
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
+    // The number of batches whose view updates may be propagated while the
+    // build step keeps reading the base table.
+    static constexpr size_t max_concurrent_populations = 4;
 
 public:
     view_builder(replica::database&, db::system_distributed_keyspace&, service::migration_notifier&);
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <unordered_map>
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "db/timeout_clock.hh"
+#include "frozen_mutation.hh"
+#include "gms/inet_address.hh"
+#include "mutation.hh"
+#include "tracing/trace_state.hh"
+
+namespace replica {
+struct cf_stats;
+}
+
+namespace service {
+struct allow_hints_tag;
+using allow_hints = bool_class<allow_hints_tag>;
+}
+
+namespace db::view {
+
+struct stats;
+
+// Holds back the view updates bound for a remote view replica for a short
+// window, merging those to the same view partition of the same replica, so
+// that a write to many base partitions sends one update per view partition
+// rather than one per base partition. Only updates which are sent in the
+// background, to a single replica, are coalesced. The memory of the held
+// back updates stays accounted in the view update concurrency semaphore,
+// so they count towards the view update backlog like any other.
+//
+// Owned by storage_proxy, which stops it when draining.
+class view_update_coalescer {
+public:
+    // Sends a view update to its view replica.
+    using send_func = noncopyable_function<future<> (gms::inet_address, frozen_mutation_and_schema, service::allow_hints, tracing::trace_state_ptr)>;
+private:
+    // Flush right away when the held back updates grow above this.
+    static constexpr size_t max_pending_bytes = 1 * 1024 * 1024;
+
+    struct key {
+        gms::inet_address endpoint;
+        table_schema_version version;
+        dht::token token;
+        managed_bytes pk;
+
+        bool operator==(const key&) const = default;
+    };
+
+    struct key_hash {
+        size_t operator()(const key& k) const;
+    };
+
+    struct pending_update {
+        schema_ptr s;
+        mutation mut;
+        dht::token base_token;
+        dht::token view_token;
+        service::allow_hints allow_hints;
+        tracing::trace_state_ptr tr_state;
+        db::view::stats& stats;
+        replica::cf_stats& cf_stats;
+        db::timeout_semaphore_units units;
+        size_t updates = 1;
+    };
+
+    send_func _send;
+    std::unordered_map<key, pending_update, key_hash> _pending;
+    size_t _pending_bytes = 0;
+    timer<> _flush_timer;
+    // Held by the updates being sent.
+    gate _gate;
+public:
+    explicit view_update_coalescer(send_func send);
+
+    // False once stop() was called, after which updates must be sent directly.
+    bool accepts_updates() const noexcept {
+        return !_gate.is_closed();
+    }
+
+    // Holds back the update for at most window, unless it pushes the held
+    // back updates above max_pending_bytes.
+    void add(gms::inet_address endpoint, frozen_mutation_and_schema mut, dht::token base_token, dht::token view_token,
+            service::allow_hints allow_hints, tracing::trace_state_ptr tr_state, db::view::stats& stats, replica::cf_stats& cf_stats,
+            db::timeout_semaphore_units units, std::chrono::microseconds window);
+
+    // Sends the held back updates, in the background.
+    void flush();
+
+    // Sends the held back updates, and waits for all updates being sent.
+    future<> stop();
+};
+
+}
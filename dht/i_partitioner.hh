@@ -19,6 +19,7 @@
 #include "utils/managed_bytes.hh"
 #include <memory>
 #include <random>
+#include <span>
 #include <utility>
 #include <vector>
 #include <compare>
@@ -151,6 +152,12 @@ class i_partitioner {
     virtual token get_token(const schema& s, partition_key_view key) const = 0;
     virtual token get_token(const sstables::key_view& key) const = 0;
 
+    /**
+     * @return the tokens of keys, in the same order. Equivalent to get_token()
+     * of each key, but partitioners may compute many tokens faster at once.
+     */
+    virtual std::vector<token> get_tokens(const schema& s, std::span<const partition_key_view> keys) const;
+
     // FIXME: token.tokenFactory
     //virtual token.tokenFactory gettokenFactory() = 0;
 
@@ -633,6 +640,10 @@ inline token get_token(const schema& s, partition_key_view key) {
     return s.get_partitioner().get_token(s, key);
 }
 
+inline std::vector<token> get_tokens(const schema& s, std::span<const partition_key_view> keys) {
+    return s.get_partitioner().get_tokens(s, keys);
+}
+
 dht::partition_range to_partition_range(dht::token_range);
 dht::partition_range_vector to_partition_ranges(const dht::token_range_vector& ranges, utils::can_yield can_yield = utils::can_yield::no);
 
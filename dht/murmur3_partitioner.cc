@@ -10,6 +10,7 @@
 #include "utils/murmur_hash.hh"
 #include "sstables/key.hh"
 #include "utils/class_registrator.hh"
+#include "schema.hh"
 #include <boost/lexical_cast.hpp>
 #include <boost/range/irange.hpp>
 
@@ -45,6 +46,32 @@ murmur3_partitioner::get_token(const schema& s, partition_key_view key) const {
     return get_token(hash[0]);
 }
 
+std::vector<token>
+murmur3_partitioner::get_tokens(const schema& s, std::span<const partition_key_view> keys) const {
+    // The legacy form of a single-column key is the column's value, so keys
+    // can be hashed in place, if they're not fragmented.
+    if (!s.partition_key_type()->is_singular()) {
+        return i_partitioner::get_tokens(s, keys);
+    }
+    std::vector<bytes_view> values;
+    values.reserve(keys.size());
+    for (auto& key : keys) {
+        auto value = *key.begin();
+        if (value.current_fragment().size() != value.size()) {
+            return i_partitioner::get_tokens(s, keys);
+        }
+        values.push_back(value.current_fragment());
+    }
+    std::vector<std::array<uint64_t, 2>> hashes(values.size());
+    utils::murmur_hash::hash3_x64_128(values, 0, hashes);
+    std::vector<token> tokens;
+    tokens.reserve(hashes.size());
+    for (auto& hash : hashes) {
+        tokens.push_back(get_token(hash[0]));
+    }
+    return tokens;
+}
+
 using registry = class_registrator<i_partitioner, murmur3_partitioner>;
 static registry registrator("org.apache.cassandra.dht.Murmur3Partitioner");
 static registry registrator_short_name("Murmur3Partitioner");
@@ -20,6 +20,7 @@ class murmur3_partitioner final : public i_partitioner {
     virtual const sstring name() const override { return "org.apache.cassandra.dht.Murmur3Partitioner"; }
     virtual token get_token(const schema& s, partition_key_view key) const override;
     virtual token get_token(const sstables::key_view& key) const override;
+    virtual std::vector<token> get_tokens(const schema& s, std::span<const partition_key_view> keys) const override;
 private:
     token get_token(bytes_view key) const;
     token get_token(uint64_t value) const;
@@ -21,6 +21,7 @@
 #include "db/config.hh"
 #include <seastar/core/semaphore.hh>
 #include <boost/range/adaptors.hpp>
+#include <boost/range/irange.hpp>
 #include "locator/abstract_replication_strategy.hh"
 
 namespace dht {
@@ -290,9 +291,11 @@ future<> range_streamer::do_stream_async() {
                 unsigned sp_index = 0;
                 unsigned nr_ranges_streamed = 0;
                 size_t nr_ranges_total = range_vec.size();
-                size_t nr_ranges_per_stream_plan = nr_ranges_total / 10;
-                dht::token_range_vector ranges_to_stream;
-                auto do_streaming = [&] {
+                // Many small stream plans, a few of them in flight at a time, so that
+                // a plan waiting for its slowest shard doesn't hold back the others.
+                size_t nr_ranges_per_stream_plan = std::max(size_t(1), nr_ranges_total / (10 * _nr_stream_plans_per_node));
+                bool failed = false;
+                auto do_streaming = [&] (const dht::token_range_vector& ranges_to_stream) {
                     auto sp = stream_plan(_stream_manager.local(), format("{}-{}-index-{:d}", description, keyspace, sp_index++), _reason);
                     auto abort_listener = _abort_source.subscribe([&] () noexcept { sp.abort(); });
                     _abort_source.check();
@@ -306,25 +309,33 @@ future<> range_streamer::do_stream_async() {
                         sp.transfer_ranges(source, keyspace, ranges_to_stream);
                     }
                     sp.execute().discard_result().get();
-                    ranges_to_stream.clear();
                 };
-                try {
-                    for (auto it = range_vec.begin(); it < range_vec.end();) {
-                        ranges_to_stream.push_back(*it);
-                        it = range_vec.erase(it);
-                        if (ranges_to_stream.size() < nr_ranges_per_stream_plan) {
-                            continue;
-                        } else {
-                            do_streaming();
+                // Each worker takes the next ranges to stream from range_vec, until there are none left
+                auto worker = [&] {
+                    return seastar::async([&] {
+                        dht::token_range_vector ranges_to_stream;
+                        try {
+                            while (!range_vec.empty() && !failed) {
+                                auto n = std::min(nr_ranges_per_stream_plan, range_vec.size());
+                                ranges_to_stream.assign(range_vec.begin(), range_vec.begin() + n);
+                                range_vec.erase(range_vec.begin(), range_vec.begin() + n);
+                                do_streaming(ranges_to_stream);
+                                ranges_to_stream.clear();
+                            }
+                        } catch (...) {
+                            failed = true;
+                            for (auto& range : ranges_to_stream) {
+                                range_vec.push_back(range);
+                            }
+                            throw;
                         }
-                    }
-                    if (ranges_to_stream.size() > 0) {
-                        do_streaming();
-                    }
+                    });
+                };
+                try {
+                    parallel_for_each(boost::irange(0u, _nr_stream_plans_per_node), [&] (unsigned) {
+                        return worker();
+                    }).get();
                 } catch (...) {
-                    for (auto& range : ranges_to_stream) {
-                        range_vec.push_back(range);
-                    }
                     auto t = std::chrono::duration_cast<std::chrono::duration<float>>(lowres_clock::now() - start_time).count();
                     logger.warn("{} with {} for keyspace={} failed, took {} seconds: {}", description, source, keyspace, t, std::current_exception());
                     throw;
@@ -163,6 +163,8 @@ class range_streamer {
     unsigned _nr_rx_added = 0;
     // Limit the number of nodes to stream in parallel to reduce memory pressure with large cluster.
     seastar::semaphore _limiter{16};
+    // The number of stream plans in flight with each node
+    unsigned _nr_stream_plans_per_node = 4;
 };
 
 } // dht
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <boost/intrusive/list.hpp>
+#include <seastar/core/lowres_clock.hh>
+
+#include "dht/i_partitioner.hh"
+#include "query-request.hh"
+#include "query-result.hh"
+
+// Shared by the digest caches of all the tables of a shard.
+struct digest_cache_stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    // The memory used by all the digest caches of the shard, which is what
+    // their memory budget bounds.
+    size_t memory_usage = 0;
+};
+
+// Keeps the digests of recent digest-only reads of single partitions, so that
+// the replicas asked for a digest by a coordinator don't have to read and hash
+// the same result again while the partition doesn't change.
+//
+// A digest is cached per partition and per query: the slice, limits, schema
+// version and digest algorithm have to be the same for the cached digest to be
+// used. Every write to a partition invalidates its digests, and anything which
+// changes the table's data without a write (sstables brought in from outside,
+// truncation, schema changes) clears the cache. A read which started before an
+// invalidation isn't allowed to populate the cache, see generation().
+//
+// The result of a query also depends on the query time, through expiring
+// cells and tombstones, so digests are only used for max_age after they were
+// computed. A stale digest can only cause a digest mismatch, which is resolved
+// by reading the data from all replicas, never a wrong result.
+class digest_cache {
+public:
+    using clock_type = lowres_clock;
+    static constexpr clock_type::duration max_age = std::chrono::seconds(10);
+
+    struct cached_digest {
+        query::result_digest digest;
+        api::timestamp_type last_modified;
+        uint64_t row_count;
+        std::optional<uint32_t> partition_count;
+    };
+private:
+    struct query_entry {
+        query::partition_slice slice;
+        table_schema_version schema_version;
+        uint64_t row_limit;
+        uint32_t partition_limit;
+        query::digest_algorithm digest_algo;
+        cached_digest value;
+        clock_type::time_point cached_at;
+        size_t memory;
+    };
+
+    struct partition_entry {
+        boost::intrusive::list_member_hook<> lru_link;
+        const dht::decorated_key* key = nullptr;
+        std::vector<query_entry> queries;
+        size_t memory = 0;
+    };
+
+    using lru_type = boost::intrusive::list<partition_entry,
+            boost::intrusive::member_hook<partition_entry, boost::intrusive::list_member_hook<>, &partition_entry::lru_link>,
+            boost::intrusive::constant_time_size<false>>;
+    using partitions_type = std::unordered_map<dht::decorated_key, partition_entry,
+            std::hash<dht::decorated_key>, dht::decorated_key_equals_comparator>;
+
+    static constexpr size_t max_queries_per_partition = 8;
+    static constexpr size_t partition_overhead = sizeof(partitions_type::value_type) + 2 * sizeof(void*);
+
+    // The partition map's equality comparator keeps a reference to the
+    // original schema, we must ensure that it doesn't die.
+    schema_ptr _original_schema;
+    partitions_type _partitions;
+    lru_type _lru;
+    size_t _memory = 0;
+    size_t _max_memory;
+    uint64_t _generation = 0;
+    digest_cache_stats& _stats;
+private:
+    static size_t memory_of(const query::partition_slice& slice) {
+        size_t memory = sizeof(query_entry)
+                + (slice.static_columns.size() + slice.regular_columns.size()) * sizeof(column_id);
+        for (auto& f : slice.filters) {
+            memory += sizeof(f);
+            for (auto& v : f.values) {
+                memory += v.size();
+            }
+        }
+        for (auto& r : slice.default_row_ranges()) {
+            memory += sizeof(r);
+            if (r.start()) {
+                memory += r.start()->value().representation().size();
+            }
+            if (r.end() && !r.is_singular()) {
+                memory += r.end()->value().representation().size();
+            }
+        }
+        return memory;
+    }
+
+    static bool equal(const schema& s, const query::partition_slice& a, const query::partition_slice& b) {
+        if (a.options.mask() != b.options.mask()
+                || a.cql_format() != b.cql_format()
+                || a.partition_row_limit() != b.partition_row_limit()
+                || a.static_columns != b.static_columns
+                || a.regular_columns != b.regular_columns
+                || a.filters != b.filters
+                || a.default_row_ranges().size() != b.default_row_ranges().size()) {
+            return false;
+        }
+        auto cmp = clustering_key_prefix::tri_compare(s);
+        return std::equal(a.default_row_ranges().begin(), a.default_row_ranges().end(), b.default_row_ranges().begin(),
+                [&] (const query::clustering_range& x, const query::clustering_range& y) {
+            return x.equal(y, cmp);
+        });
+    }
+
+    query_entry* find_query(partition_entry& pe, const query::read_command& cmd, query::digest_algorithm digest_algo) {
+        for (auto& qe : pe.queries) {
+            if (qe.schema_version == cmd.schema_version
+                    && qe.row_limit == cmd.get_row_limit()
+                    && qe.partition_limit == cmd.partition_limit
+                    && qe.digest_algo == digest_algo
+                    && equal(*_original_schema, qe.slice, cmd.slice)) {
+                return &qe;
+            }
+        }
+        return nullptr;
+    }
+
+    void add_memory(ssize_t delta) {
+        _memory += delta;
+        _stats.memory_usage += delta;
+    }
+
+    void erase(partitions_type::iterator it) {
+        add_memory(-ssize_t(it->second.memory));
+        _lru.erase(_lru.iterator_to(it->second));
+        _partitions.erase(it);
+    }
+
+    // Once the digest caches of the shard exceed their budget, the cache
+    // which grows evicts its own least recently used partitions.
+    void evict() {
+        while (_stats.memory_usage > _max_memory && !_lru.empty()) {
+            erase(_partitions.find(*_lru.back().key));
+            ++_stats.evictions;
+        }
+    }
+public:
+    // max_memory is the budget of all the digest caches sharing stats.
+    digest_cache(schema_ptr s, size_t max_memory, digest_cache_stats& stats)
+        : _original_schema(std::move(s))
+        , _partitions(0, std::hash<dht::decorated_key>(), dht::decorated_key_equals_comparator(*_original_schema))
+        , _max_memory(max_memory)
+        , _stats(stats)
+    { }
+
+    digest_cache(const digest_cache&) = delete;
+    digest_cache& operator=(const digest_cache&) = delete;
+
+    ~digest_cache() {
+        clear();
+    }
+
+    // Returns the partition read by the query if its digest can be cached:
+    // a digest-only, unpaged read of a single partition.
+    static std::optional<dht::decorated_key> cacheable_key(const query::read_command& cmd, const query::result_options& opts,
+            const dht::partition_range_vector& ranges) {
+        if (opts.request != query::result_request::only_digest
+                || opts.digest_algo == query::digest_algorithm::none
+                || ranges.size() != 1
+                || !query::is_single_partition(ranges.front())
+                || cmd.slice.get_specific_ranges()
+                || (cmd.query_uuid != utils::UUID{} && !cmd.is_first_page)) {
+            return std::nullopt;
+        }
+        auto& pos = ranges.front().start()->value();
+        return dht::decorated_key{pos.token(), *pos.key()};
+    }
+
+    // Changes whenever the cache is invalidated. A read has to pass the
+    // generation read before it started to put().
+    uint64_t generation() const {
+        return _generation;
+    }
+
+    size_t memory_usage() const {
+        return _memory;
+    }
+
+    std::optional<cached_digest> get(const dht::decorated_key& dk, const query::read_command& cmd, query::digest_algorithm digest_algo) {
+        auto it = _partitions.find(dk);
+        auto* qe = it != _partitions.end() ? find_query(it->second, cmd, digest_algo) : nullptr;
+        if (!qe || clock_type::now() - qe->cached_at > max_age) {
+            ++_stats.misses;
+            return std::nullopt;
+        }
+        ++_stats.hits;
+        _lru.erase(_lru.iterator_to(it->second));
+        _lru.push_front(it->second);
+        return qe->value;
+    }
+
+    // Stores the digest of a complete (not short) result of the query, unless
+    // the cache was invalidated since the read began.
+    void put(const dht::decorated_key& dk, const query::read_command& cmd, query::digest_algorithm digest_algo,
+            const query::result& result, uint64_t generation) {
+        if (generation != _generation || !_max_memory || result.is_short_read() || !result.digest()) {
+            return;
+        }
+        auto [it, inserted] = _partitions.try_emplace(dk);
+        auto& pe = it->second;
+        if (inserted) {
+            pe.key = &it->first;
+            pe.memory = partition_overhead + it->first.key().representation().size();
+            add_memory(pe.memory);
+        } else {
+            _lru.erase(_lru.iterator_to(pe));
+        }
+        _lru.push_front(pe);
+        auto value = cached_digest{*result.digest(), result.last_modified(), result.row_count().value_or(0), result.partition_count()};
+        if (auto* qe = find_query(pe, cmd, digest_algo)) {
+            qe->value = value;
+            qe->cached_at = clock_type::now();
+        } else if (pe.queries.size() < max_queries_per_partition) {
+            auto memory = memory_of(cmd.slice);
+            pe.queries.push_back(query_entry{cmd.slice, cmd.schema_version, cmd.get_row_limit(), cmd.partition_limit,
+                    digest_algo, value, clock_type::now(), memory});
+            pe.memory += memory;
+            add_memory(memory);
+        }
+        evict();
+    }
+
+    void invalidate(const dht::decorated_key& dk) {
+        ++_generation;
+        auto it = _partitions.find(dk);
+        if (it != _partitions.end()) {
+            erase(it);
+        }
+    }
+
+    void clear() {
+        ++_generation;
+        _lru.clear();
+        _partitions.clear();
+        add_memory(-ssize_t(_memory));
+    }
+};
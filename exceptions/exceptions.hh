@@ -15,6 +15,7 @@
 
 #include "db/consistency_level_type.hh"
 #include "db/write_type.hh"
+#include "gms/inet_address.hh"
 #include <stdexcept>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/print.hh>
@@ -155,12 +156,20 @@ struct mutation_write_timeout_exception : public request_timeout_exception {
     { }
 };
 
+// Why a replica failed a request, as reported to clients since v5 of the
+// native protocol.
+enum class request_failure_reason : uint16_t {
+    unknown = 0x0000,
+};
+
 class request_failure_exception : public cassandra_exception {
 public:
     db::consistency_level consistency;
     int32_t received;
     int32_t failures;
     int32_t block_for;
+    // The replicas which failed, when known.
+    std::unordered_map<gms::inet_address, request_failure_reason> failure_reasons;
 
 protected:
     request_failure_exception(exception_code code, const sstring& ks, const sstring& cf, db::consistency_level consistency_, int32_t received_, int32_t failures_, int32_t block_for_) noexcept
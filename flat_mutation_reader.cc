@@ -16,7 +16,7 @@
 #include "clustering_ranges_walker.hh"
 #include "schema_upgrader.hh"
 #include <algorithm>
-#include <stack>
+#include <deque>
 
 #include <boost/range/adaptor/transformed.hpp>
 #include <seastar/util/defer.hh>
@@ -28,6 +28,11 @@
 #include <seastar/core/coroutine.hh>
 
 #include "clustering_key_filter.hh"
+#include "frozen_mutation.hh"
+#include "reader_concurrency_semaphore.hh"
+#include "utils/spill_file.hh"
+#include "service/priority_manager.hh"
+#include <seastar/core/byteorder.hh>
 
 logging::logger fmr_logger("flat_mutation_reader");
 
@@ -83,15 +88,27 @@ void flat_mutation_reader::impl::clear_buffer_to_next_partition() {
 }
 
 flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query::max_result_size max_size, std::unique_ptr<query::partition_slice> slice) {
+    // Rows of partitions which don't fit in max_size.soft_limit are written
+    // to a spill file (if the semaphore has a spill directory), in runs of
+    // at most soft_limit bytes, and read back run-by-run, last run first,
+    // when the partition is emitted.
     class partition_reversing_mutation_reader final : public flat_mutation_reader::impl {
+        // The spill file is written in records of about this size, to keep
+        // the buffers needed to read them back small.
+        static constexpr size_t spill_record_size = 128 * 1024;
+
         flat_mutation_reader _source;
         range_tombstone_list _range_tombstones;
-        std::stack<mutation_fragment> _mutation_fragments;
+        // In source order, the back is emitted first.
+        std::deque<mutation_fragment> _mutation_fragments;
         mutation_fragment_opt _partition_end;
         size_t _stack_size = 0;
         const query::max_result_size _max_size;
         bool _below_soft_limit = true;
         std::unique_ptr<query::partition_slice> _slice; // only stored, not used
+        std::optional<utils::spill_file> _spill_file;
+        // The positions the spilled runs of the current partition start at.
+        std::vector<uint64_t> _spilled_runs;
     private:
         stop_iteration emit_partition() {
             auto emit_range_tombstone = [&] {
@@ -101,15 +118,19 @@ flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query:
             };
             position_in_partition::tri_compare cmp(*_schema);
             while (!_mutation_fragments.empty() && !is_buffer_full()) {
-                auto& mf = _mutation_fragments.top();
+                auto& mf = _mutation_fragments.back();
                 if (!_range_tombstones.empty() && cmp(_range_tombstones.begin()->position(), mf.position()) <= 0) {
                     emit_range_tombstone();
                 } else {
                     _stack_size -= mf.memory_usage();
                     push_mutation_fragment(std::move(mf));
-                    _mutation_fragments.pop();
+                    _mutation_fragments.pop_back();
                 }
             }
+            if (!_spilled_runs.empty() && !is_buffer_full()) {
+                // The rest of the rows have to be read back first, see fill_buffer().
+                return stop_iteration::no;
+            }
             while (!_range_tombstones.empty() && !is_buffer_full()) {
                 emit_range_tombstone();
             }
@@ -119,6 +140,57 @@ flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query:
             push_mutation_fragment(std::move(*std::exchange(_partition_end, std::nullopt)));
             return stop_iteration::no;
         }
+        bool can_spill() {
+            // The in-memory size of the rows is an upper bound of their serialized size.
+            return !_permit.semaphore().spill_directory().empty() && _permit.semaphore().spill_budget().has_room(_stack_size);
+        }
+        future<> spill() {
+            if (!_spill_file) {
+                _spill_file = co_await utils::spill_file::create(_permit.semaphore().spill_directory(),
+                        _permit.semaphore().spill_budget(), service::get_local_reader_spill_priority());
+            }
+            _spilled_runs.push_back(_spill_file->size());
+            bytes_ostream record;
+            while (!_mutation_fragments.empty()) {
+                auto frozen = freeze(*_schema, _mutation_fragments.front());
+                std::array<char, sizeof(uint32_t)> size;
+                write_le<uint32_t>(size.data(), frozen.representation().size());
+                record.write(size.data(), size.size());
+                record.append(frozen.representation());
+                _stack_size -= _mutation_fragments.front().memory_usage();
+                _mutation_fragments.pop_front();
+                if (record.size() >= spill_record_size || _mutation_fragments.empty()) {
+                    _permit.semaphore().get_stats().spilled_bytes += record.size();
+                    co_await _spill_file->write(record);
+                    record = bytes_ostream();
+                }
+            }
+        }
+        future<> unspill() {
+            const auto run_start = _spilled_runs.back();
+            const auto run_end = _spill_file->size();
+            for (auto pos = run_start; pos != run_end;) {
+                auto record = co_await _spill_file->read(pos);
+                for (auto data = std::string_view(record.data.get(), record.data.size()); !data.empty();) {
+                    const auto size = read_le<uint32_t>(data.data());
+                    data.remove_prefix(sizeof(uint32_t));
+                    bytes_ostream frozen;
+                    frozen.write(data.data(), size);
+                    data.remove_prefix(size);
+                    _mutation_fragments.emplace_back(frozen_mutation_fragment(std::move(frozen)).unfreeze(*_schema, _permit));
+                    _stack_size += _mutation_fragments.back().memory_usage();
+                }
+                pos = record.next_pos;
+            }
+            _spilled_runs.pop_back();
+            _spill_file->truncate(run_start);
+        }
+        void clear_spilled_runs() noexcept {
+            _spilled_runs.clear();
+            if (_spill_file) {
+                _spill_file->truncate(0);
+            }
+        }
         future<stop_iteration> consume_partition_from_source() {
             if (_source.is_buffer_empty()) {
                 if (_source.is_end_of_stream()) {
@@ -132,17 +204,19 @@ flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query:
                 if (mf.is_partition_start() || mf.is_static_row()) {
                     push_mutation_fragment(std::move(mf));
                 } else if (mf.is_end_of_partition()) {
+                    // Emitted by fill_buffer().
                     _partition_end = std::move(mf);
-                    if (emit_partition()) {
-                        return make_ready_future<stop_iteration>(stop_iteration::yes);
-                    }
+                    return make_ready_future<stop_iteration>(stop_iteration::no);
                 } else if (mf.is_range_tombstone()) {
                     auto&& rt = std::move(mf).as_range_tombstone();
                     rt.reverse();
                     _range_tombstones.apply(*_schema, std::move(rt));
                 } else {
-                    _mutation_fragments.emplace(std::move(mf));
-                    _stack_size += _mutation_fragments.top().memory_usage();
+                    _mutation_fragments.emplace_back(std::move(mf));
+                    _stack_size += _mutation_fragments.back().memory_usage();
+                    if (_stack_size > _max_size.soft_limit && can_spill()) {
+                        return spill().then([] { return stop_iteration::no; });
+                    }
                     if (_stack_size > _max_size.hard_limit || (_stack_size > _max_size.soft_limit && _below_soft_limit)) {
                         const partition_key* key = nullptr;
                         auto it = buffer().end();
@@ -189,6 +263,9 @@ flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query:
                     if (stop) {
                         return make_ready_future<stop_iteration>(stop_iteration::yes);
                     }
+                    if (_partition_end) {
+                        return unspill().then([] { return stop_iteration::no; });
+                    }
                 }
                 return consume_partition_from_source();
             });
@@ -198,9 +275,10 @@ flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query:
             clear_buffer_to_next_partition();
             if (is_buffer_empty() && !is_end_of_stream()) {
                 while (!_mutation_fragments.empty()) {
-                    _stack_size -= _mutation_fragments.top().memory_usage();
-                    _mutation_fragments.pop();
+                    _stack_size -= _mutation_fragments.back().memory_usage();
+                    _mutation_fragments.pop_back();
                 }
+                clear_spilled_runs();
                 _range_tombstones.clear();
                 _partition_end = std::nullopt;
                 return _source.next_partition();
@@ -210,9 +288,8 @@ flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query:
 
         virtual future<> fast_forward_to(const dht::partition_range& pr) override {
             clear_buffer();
-            while (!_mutation_fragments.empty()) {
-                _mutation_fragments.pop();
-            }
+            _mutation_fragments.clear();
+            clear_spilled_runs();
             _stack_size = 0;
             _partition_end = std::nullopt;
             _end_of_stream = false;
@@ -224,7 +301,9 @@ flat_mutation_reader make_reversing_reader(flat_mutation_reader original, query:
         }
 
         virtual future<> close() noexcept override {
-            return _source.close();
+            return _source.close().finally([this] {
+                return _spill_file ? _spill_file->close() : make_ready_future<>();
+            });
         }
     };
 
@@ -25,6 +25,7 @@
 #include "reader_permit.hh"
 
 #include <deque>
+#include <boost/range/iterator_range.hpp>
 
 using seastar::future;
 
@@ -130,6 +131,17 @@ class flat_mutation_reader_v2 final {
 public:
     using tracked_buffer = circular_buffer<mutation_fragment_v2, tracking_allocator<mutation_fragment_v2>>;
 
+    // A run of fragments at the front of the buffer of a reader, handed to
+    // batch consumers, see impl::consume_batch_pausable().
+    using fragment_batch = boost::iterator_range<tracked_buffer::iterator>;
+
+    // What a batch consumer did with a batch: the number of fragments it
+    // consumed, from the front of the batch, and whether to stop.
+    struct consumed_fragments {
+        size_t count;
+        stop_iteration stop;
+    };
+
     class impl {
     private:
         tracked_buffer _buffer;
@@ -190,6 +202,22 @@ class flat_mutation_reader_v2 final {
             _buffer_size += memory_usage;
         }
 
+        // Drops the first n fragments of the buffer, which were consumed (moved
+        // from) in place. Draining the whole buffer, which is the common case,
+        // doesn't have to look at each fragment to account for its memory.
+        void pop_consumed_fragments(size_t n) noexcept {
+            if (n == _buffer.size()) {
+                _buffer.clear();
+                _buffer_size = 0;
+                return;
+            }
+            _buffer.erase(_buffer.begin(), _buffer.begin() + n);
+            _buffer_size = 0;
+            for (const auto& mf : _buffer) {
+                _buffer_size += mf.memory_usage();
+            }
+        }
+
         future<mutation_fragment_v2_opt> operator()() {
             if (is_buffer_empty()) {
                 if (is_end_of_stream()) {
@@ -225,6 +253,38 @@ class flat_mutation_reader_v2 final {
             });
         }
 
+        template<typename Consumer>
+        requires std::same_as<std::invoke_result_t<Consumer&, fragment_batch>, consumed_fragments>
+        // A variant of consume_pausable() which hands the consumer all the
+        // buffered fragments at once, instead of popping them one by one.
+        // The consumer consumes (moves from) the fragments it wants in place,
+        // from the front of the batch, and returns how many it consumed. The
+        // others are handed to it again in the next batch. It should stop
+        // early when need_preempt() is true. If it throws, the whole batch is
+        // dropped, as it can't tell which fragments it consumed.
+        // Stops when consumer returns stop_iteration::yes or end of stream is reached.
+        future<> consume_batch_pausable(Consumer consumer) {
+            return repeat([this, consumer = std::move(consumer)] () mutable {
+                if (is_buffer_empty()) {
+                    if (is_end_of_stream()) {
+                        return make_ready_future<stop_iteration>(stop_iteration::yes);
+                    }
+                    return fill_buffer().then([] {
+                        return make_ready_future<stop_iteration>(stop_iteration::no);
+                    });
+                }
+                auto res = consumed_fragments{0, stop_iteration::no};
+                try {
+                    res = consumer(fragment_batch(_buffer.begin(), _buffer.end()));
+                } catch (...) {
+                    pop_consumed_fragments(_buffer.size());
+                    throw;
+                }
+                pop_consumed_fragments(res.count);
+                return make_ready_future<stop_iteration>(res.stop);
+            });
+        }
+
         template<typename Consumer, typename Filter>
         requires FlatMutationReaderConsumerV2<Consumer> && FlattenedConsumerFilterV2<Filter>
         // A variant of consume_pausable() that expects to be run in
@@ -308,6 +368,67 @@ class flat_mutation_reader_v2 final {
                 return make_ready_future<stop_iteration>(stop_iteration::no);
             }
         };
+
+        // Feeds whole batches of fragments to a consumer whose methods are all
+        // synchronous, saving the future and the pop of each fragment.
+        template<typename Consumer>
+        struct batch_consumer_adapter {
+            std::optional<dht::decorated_key> _decorated_key;
+            Consumer _consumer;
+            // Set when the consumer stopped in the middle of a partition and
+            // asked for the next one, which the reader has to skip to.
+            bool _skip_to_next_partition = false;
+            // The fragments of the current batch consumed so far, including
+            // the one being consumed, which is lost if the consumer throws,
+            // like a popped one would be.
+            size_t _consumed = 0;
+
+            explicit batch_consumer_adapter(Consumer c) : _consumer(std::move(c)) { }
+
+            consumed_fragments operator()(fragment_batch batch) {
+                _consumed = 0;
+                for (auto& mf : batch) {
+                    ++_consumed;
+                    if (std::move(mf).consume(*this) == stop_iteration::yes) {
+                        return {_consumed, stop_iteration::yes};
+                    }
+                    if (_skip_to_next_partition || need_preempt()) {
+                        break;
+                    }
+                }
+                return {_consumed, stop_iteration::no};
+            }
+            stop_iteration consume(static_row&& sr) {
+                return handle_result(_consumer.consume(std::move(sr)));
+            }
+            stop_iteration consume(clustering_row&& cr) {
+                return handle_result(_consumer.consume(std::move(cr)));
+            }
+            stop_iteration consume(range_tombstone_change&& rt) {
+                return handle_result(_consumer.consume(std::move(rt)));
+            }
+            stop_iteration consume(partition_start&& ps) {
+                _decorated_key.emplace(std::move(ps.key()));
+                _consumer.consume_new_partition(*_decorated_key);
+                if (ps.partition_tombstone()) {
+                    _consumer.consume(ps.partition_tombstone());
+                }
+                return stop_iteration::no;
+            }
+            stop_iteration consume(partition_end&& pe) {
+                return _consumer.consume_end_of_partition();
+            }
+        private:
+            stop_iteration handle_result(stop_iteration si) {
+                if (si) {
+                    if (_consumer.consume_end_of_partition()) {
+                        return stop_iteration::yes;
+                    }
+                    _skip_to_next_partition = true;
+                }
+                return stop_iteration::no;
+            }
+        };
     public:
         template<typename Consumer>
         requires FlattenedConsumerV2<Consumer>
@@ -324,11 +445,44 @@ class flat_mutation_reader_v2 final {
         //
         // This method returns whatever is returned from Consumer::consume_end_of_stream().S
         auto consume(Consumer consumer) {
-            return do_with(consumer_adapter<Consumer>(*this, std::move(consumer)), [this] (consumer_adapter<Consumer>& adapter) {
-                return consume_pausable(std::ref(adapter)).then([this, &adapter] {
-                    return adapter._consumer.consume_end_of_stream();
+            if constexpr (std::is_same_v<decltype(consumer.consume_end_of_partition()), stop_iteration>) {
+                return do_with(batch_consumer_adapter<Consumer>(std::move(consumer)), [this] (batch_consumer_adapter<Consumer>& adapter) {
+                    return repeat([this, &adapter] {
+                        if (is_buffer_empty()) {
+                            if (is_end_of_stream()) {
+                                return make_ready_future<stop_iteration>(stop_iteration::yes);
+                            }
+                            return fill_buffer().then([] {
+                                return make_ready_future<stop_iteration>(stop_iteration::no);
+                            });
+                        }
+                        auto res = consumed_fragments{0, stop_iteration::no};
+                        try {
+                            res = adapter(fragment_batch(_buffer.begin(), _buffer.end()));
+                        } catch (...) {
+                            pop_consumed_fragments(adapter._consumed);
+                            throw;
+                        }
+                        pop_consumed_fragments(res.count);
+                        // The rest of the partition the consumer stopped in is
+                        // skipped once its consumed fragments are dropped.
+                        if (std::exchange(adapter._skip_to_next_partition, false)) {
+                            return next_partition().then([] {
+                                return make_ready_future<stop_iteration>(stop_iteration::no);
+                            });
+                        }
+                        return make_ready_future<stop_iteration>(res.stop);
+                    }).then([&adapter] {
+                        return adapter._consumer.consume_end_of_stream();
+                    });
                 });
-            });
+            } else {
+                return do_with(consumer_adapter<Consumer>(*this, std::move(consumer)), [this] (consumer_adapter<Consumer>& adapter) {
+                    return consume_pausable(std::ref(adapter)).then([this, &adapter] {
+                        return adapter._consumer.consume_end_of_stream();
+                    });
+                });
+            }
         }
 
         template<typename Consumer, typename Filter>
@@ -433,6 +587,12 @@ class flat_mutation_reader_v2 final {
         return _impl->consume_pausable(std::move(consumer));
     }
 
+    template <typename Consumer>
+    requires std::same_as<std::invoke_result_t<Consumer&, fragment_batch>, consumed_fragments>
+    auto consume_batch_pausable(Consumer consumer) {
+        return _impl->consume_batch_pausable(std::move(consumer));
+    }
+
     template <typename Consumer>
     requires FlattenedConsumerV2<Consumer>
     auto consume(Consumer consumer) {
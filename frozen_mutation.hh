@@ -116,6 +116,9 @@ class frozen_mutation_fragment {
 
     mutation_fragment unfreeze(const schema& s, reader_permit permit);
 
+    // The key of the partition if this is a partition_start, without unfreezing the fragment
+    std::optional<partition_key> partition_start_key() const;
+
     future<> clear_gently() noexcept {
         return _bytes.clear_gently();
     }
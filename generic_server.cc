@@ -20,6 +20,12 @@ connection::connection(server& server, connected_socket&& fd)
     , _fd{std::move(fd)}
     , _read_buf(_fd.input())
     , _write_buf(_fd.output())
+    , _setup_timer([this] {
+        ++_server._connection_setups_timed_out;
+        _server._logger.debug("closing connection not set up within {} ms",
+                std::chrono::duration_cast<std::chrono::milliseconds>(*_server._connection_setup_timeout).count());
+        (void)shutdown();
+    })
 {
     ++_server._total_connections;
     ++_server._current_connections;
@@ -46,14 +52,28 @@ static bool is_broken_pipe_or_connection_reset(std::exception_ptr ep) {
 future<> connection::process()
 {
     return with_gate(_pending_requests_gate, [this] {
-        return do_until([this] {
-            return _read_buf.eof();
-        }, [this] {
-            return process_request();
+        if (_server._connection_setups.waiters() || _server._connection_setups.available_units() <= 0) {
+            ++_server._connection_setups_blocked;
+        }
+        return get_units(_server._connection_setups, 1).then([this] (semaphore_units<> units) {
+            _setup_units = std::move(units);
+            if (_server._connection_setup_timeout) {
+                _setup_timer.arm(*_server._connection_setup_timeout);
+            }
+            return do_until([this] {
+                return _read_buf.eof();
+            }, [this] {
+                return process_request().then([this] {
+                    if (is_established()) {
+                        setup_done();
+                    }
+                });
+            });
         }).then_wrapped([this] (future<> f) {
             handle_error(std::move(f));
         });
     }).finally([this] {
+        setup_done();
         return _pending_requests_gate.close().then([this] {
             on_connection_close();
             return _ready_to_respond.handle_exception([] (std::exception_ptr ep) {
@@ -83,10 +103,15 @@ future<> connection::shutdown()
     return make_ready_future<>();
 }
 
-server::server(const sstring& server_name, logging::logger& logger)
+server::server(const sstring& server_name, logging::logger& logger, size_t max_concurrent_connection_setups,
+        lowres_clock::duration connection_setup_timeout)
     : _server_name{server_name}
     , _logger{logger}
+    , _connection_setups(max_concurrent_connection_setups ? max_concurrent_connection_setups : semaphore::max_counter())
 {
+    if (max_concurrent_connection_setups) {
+        _connection_setup_timeout = connection_setup_timeout;
+    }
 }
 
 server::~server()
@@ -95,6 +120,8 @@ server::~server()
 
 future<> server::stop() {
     _stopping = true;
+    // Connections waiting to be set up won't be.
+    _connection_setups.broken();
     size_t nr = 0;
     size_t nr_total = _listeners.size();
     _logger.debug("abort accept nr_total={}", nr_total);
@@ -14,6 +14,9 @@
 
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
 #include <seastar/net/api.hh>
 #include <seastar/net/tls.hh>
 
@@ -39,6 +42,10 @@ class connection : public boost::intrusive::list_base_hook<> {
     output_stream<char> _write_buf;
     future<> _ready_to_respond = make_ready_future<>();
     seastar::gate _pending_requests_gate;
+    // Held while the connection is being set up, see server::_connection_setups.
+    std::optional<semaphore_units<>> _setup_units;
+    // Closes the connection if it holds _setup_units for too long.
+    timer<lowres_clock> _setup_timer;
 
 public:
     connection(server& server, connected_socket&& fd);
@@ -50,6 +57,20 @@ class connection : public boost::intrusive::list_base_hook<> {
 
     virtual future<> process_request() = 0;
 
+    // Whether the connection is set up and serves regular requests. Until
+    // then, it counts towards the server's concurrent connection setups.
+    // By default, the first request completes the setup.
+    virtual bool is_established() const { return true; }
+
+protected:
+    // Lets the next connection waiting to be set up proceed.
+    void setup_done() noexcept {
+        _setup_timer.cancel();
+        _setup_units.reset();
+    }
+
+public:
+
     virtual void on_connection_close();
 
     virtual future<> shutdown();
@@ -82,9 +103,22 @@ class server {
     future<> _stopped = _all_connections_stopped.get_future();
     boost::intrusive::list<connection> _connections_list;
     std::vector<server_socket> _listeners;
+    // Bounds the connections being set up at once, e.g. in a TLS handshake or
+    // authenticating, so that a storm of reconnecting clients doesn't starve
+    // the established connections. The others wait before reading anything.
+    semaphore _connection_setups;
+    // How long a connection may take to be set up, when their number is
+    // bounded, so that stalled or malicious clients can't hold on to all
+    // the setup slots.
+    std::optional<lowres_clock::duration> _connection_setup_timeout;
+    uint64_t _connection_setups_blocked = 0;
+    uint64_t _connection_setups_timed_out = 0;
 
 public:
-    server(const sstring& server_name, logging::logger& logger);
+    // A max_concurrent_connection_setups of 0 doesn't limit them. Otherwise,
+    // connections not set up within connection_setup_timeout are closed.
+    server(const sstring& server_name, logging::logger& logger, size_t max_concurrent_connection_setups = 0,
+            lowres_clock::duration connection_setup_timeout = std::chrono::seconds(10));
 
     virtual ~server();
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/sleep.hh>
+
+#include "gms/direct_failure_detector.hh"
+#include "gms/feature_service.hh"
+#include "gms/gossiper.hh"
+#include "message/messaging_service.hh"
+#include "utils/fb_utilities.hh"
+#include "db/config.hh"
+#include "log.hh"
+
+namespace gms {
+
+static logging::logger dfdlog("direct_failure_detector");
+
+using clk = arrival_window::clk;
+
+// See failure_detector::PHI_FACTOR.
+static constexpr double phi_factor = M_LOG10El;
+
+static constexpr int sample_size = 100;
+
+ping_liveness::ping_liveness(inet_address ep, std::chrono::milliseconds ping_interval, clk::time_point now)
+    : _ep(ep)
+    , _window(sample_size, ping_interval, ping_interval * 20, std::chrono::milliseconds(0))
+{
+    _window.add(now, _ep);
+}
+
+void ping_liveness::answered(clk::time_point now) {
+    _window.add(now, _ep);
+}
+
+bool ping_liveness::update(clk::time_point now, double phi_convict_threshold) {
+    bool suspected = _window.phi(now) * phi_factor > phi_convict_threshold;
+    return std::exchange(_suspected, suspected) != suspected;
+}
+
+direct_failure_detector::direct_failure_detector(gossiper& g, netw::messaging_service& ms, feature_service& features, const db::config& cfg)
+    : _gossiper(g)
+    , _messaging(ms)
+    , _features(features)
+    , _cfg(cfg)
+{ }
+
+future<> direct_failure_detector::start() {
+    _messaging.register_direct_fd_ping([] {
+        return make_ready_future<>();
+    });
+    if (this_shard_id() == 0) {
+        _done = run();
+    }
+    return make_ready_future<>();
+}
+
+future<> direct_failure_detector::stop() {
+    _as.request_abort();
+    co_await std::exchange(_done, make_ready_future<>());
+    co_await _pings.close();
+    co_await _messaging.unregister_direct_fd_ping();
+}
+
+future<> direct_failure_detector::ping(inet_address ep) {
+    // A ping which doesn't get an answer within the time it takes to suspect
+    // the node is of no use.
+    auto interval = std::chrono::milliseconds(_cfg.direct_failure_detector_ping_interval_in_ms());
+    auto timeout = std::max(interval * 10, std::chrono::milliseconds(100));
+    try {
+        co_await _messaging.send_direct_fd_ping(netw::msg_addr(ep), timeout);
+        if (auto it = _nodes.find(ep); it != _nodes.end()) {
+            it->second.liveness.answered(clk::now());
+        }
+    } catch (...) {
+        dfdlog.debug("Ping to {} failed: {}", ep, std::current_exception());
+    }
+    if (auto it = _nodes.find(ep); it != _nodes.end()) {
+        it->second.pinging = false;
+    }
+}
+
+future<> direct_failure_detector::set_suspected(inet_address ep, bool suspected) {
+    if (suspected) {
+        dfdlog.info("Node {} doesn't answer pings, coordinators will avoid it", ep);
+    } else {
+        dfdlog.info("Node {} answers pings again", ep);
+    }
+    return container().invoke_on_all([ep, suspected] (direct_failure_detector& fd) {
+        if (suspected) {
+            fd._suspected.insert(ep);
+        } else {
+            fd._suspected.erase(ep);
+        }
+    });
+}
+
+future<> direct_failure_detector::run() {
+    while (!_as.abort_requested()) {
+        auto interval = std::chrono::milliseconds(_cfg.direct_failure_detector_ping_interval_in_ms());
+        bool enabled = interval.count() && _features.cluster_supports_direct_failure_detector_ping();
+        auto live = enabled ? _gossiper.get_live_members() : std::set<inet_address>();
+        live.erase(utils::fb_utilities::get_broadcast_address());
+
+        // Forget the nodes gossip doesn't consider alive anymore.
+        std::vector<inet_address> dead;
+        for (auto& [ep, n] : _nodes) {
+            if (!live.contains(ep)) {
+                dead.push_back(ep);
+            }
+        }
+        for (auto& ep : dead) {
+            bool suspected = _nodes.at(ep).liveness.suspected();
+            _nodes.erase(ep);
+            if (suspected) {
+                co_await set_suspected(ep, false);
+            }
+        }
+
+        auto now = clk::now();
+        auto threshold = _cfg.direct_failure_detector_phi_convict_threshold();
+        for (auto& ep : live) {
+            auto& n = _nodes.try_emplace(ep, node_state{ping_liveness(ep, interval, now)}).first->second;
+            if (!n.pinging && !_pings.is_closed()) {
+                n.pinging = true;
+                (void)with_gate(_pings, [this, ep] {
+                    return ping(ep);
+                });
+            }
+            if (n.liveness.update(now, threshold)) {
+                co_await set_suspected(ep, n.liveness.suspected());
+            }
+        }
+
+        try {
+            co_await sleep_abortable(enabled ? interval : std::chrono::milliseconds(1000), _as);
+        } catch (const sleep_aborted&) {
+            break;
+        }
+    }
+}
+
+}
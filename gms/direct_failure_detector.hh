@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/sharded.hh>
+
+#include "gms/failure_detector.hh"
+#include "gms/inet_address.hh"
+#include "seastarx.hh"
+
+namespace db {
+class config;
+}
+
+namespace netw {
+class messaging_service;
+}
+
+namespace gms {
+
+class gossiper;
+class feature_service;
+
+/// \brief Whether a node is suspected to have failed, from the arrival times
+/// of its answers to pings sent every ping_interval.
+class ping_liveness {
+public:
+    using clk = arrival_window::clk;
+private:
+    inet_address _ep;
+    arrival_window _window;
+    bool _suspected = false;
+public:
+    /// Starts as if the node answered at now.
+    ping_liveness(inet_address ep, std::chrono::milliseconds ping_interval, clk::time_point now);
+
+    void answered(clk::time_point now);
+
+    /// Updates whether the node is suspected, which it is when its phi at now
+    /// exceeds phi_convict_threshold. Returns true if that changed.
+    bool update(clk::time_point now, double phi_convict_threshold);
+
+    bool suspected() const noexcept {
+        return _suspected;
+    }
+};
+
+/// \brief Detects failures of the other nodes by pinging them directly.
+///
+/// Gossip only marks a node down after failure_detector_timeout_in_ms without
+/// an answer to its echoes, and meanwhile coordinators keep sending requests
+/// to it which time out.
+///
+/// Shard 0 pings each node gossip considers alive every
+/// direct_failure_detector_ping_interval_in_ms, with the DIRECT_FD_PING verb,
+/// which has a connection of its own, so pings don't wait behind other
+/// messages. From the arrival times of the answers, it computes the phi of
+/// each node as failure_detector does, and suspects the nodes whose phi
+/// exceeds direct_failure_detector_phi_convict_threshold. Suspicion is
+/// propagated to all shards, and is lifted as soon as the node answers again.
+///
+/// Suspected nodes are only avoided by the coordinators: gossip stays the
+/// authority on which nodes are down.
+class direct_failure_detector : public seastar::peering_sharded_service<direct_failure_detector> {
+    gossiper& _gossiper;
+    netw::messaging_service& _messaging;
+    feature_service& _features;
+    const db::config& _cfg;
+
+    // Shard 0 only.
+    struct node_state {
+        ping_liveness liveness;
+        bool pinging = false;
+    };
+    std::unordered_map<inet_address, node_state> _nodes;
+    seastar::abort_source _as;
+    seastar::gate _pings;
+    future<> _done = make_ready_future<>();
+
+    std::unordered_set<inet_address> _suspected;
+
+    future<> run();
+    future<> ping(inet_address ep);
+    future<> set_suspected(inet_address ep, bool suspected);
+public:
+    direct_failure_detector(gossiper& g, netw::messaging_service& ms, feature_service& features, const db::config& cfg);
+
+    future<> start();
+    future<> stop();
+
+    // Whether the node stopped answering pings. Gossip may still consider it
+    // alive.
+    bool is_suspected(inet_address ep) const noexcept {
+        return _suspected.contains(ep);
+    }
+};
+
+}
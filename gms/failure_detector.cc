@@ -41,7 +41,7 @@ void arrival_window::add(clk::time_point value, const gms::inet_address& ep) {
         // We use a very large initial interval since the "right" average depends on the cluster size
         // and it's better to err high (false negatives, which will be corrected by waiting a bit longer)
         // than low (false positives, which cause "flapping").
-        _arrival_intervals.add(_initial.count());
+        _arrival_intervals.add(std::chrono::duration_cast<clk::duration>(_initial).count());
     }
     _tlast = value;
 }
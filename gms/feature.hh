@@ -141,6 +141,19 @@ extern const std::string_view SUPPORTS_RAFT_CLUSTER_MANAGEMENT;
 extern const std::string_view USES_RAFT_CLUSTER_MANAGEMENT;
 extern const std::string_view TOMBSTONE_GC_OPTIONS;
 extern const std::string_view PARALLELIZED_AGGREGATION;
+extern const std::string_view SPLIT_BLOCK_BLOOM_FILTER;
+extern const std::string_view SSTABLE_COMPRESSION_DICTIONARIES;
+extern const std::string_view STREAM_SSTABLE_FILES;
+extern const std::string_view INCREMENTAL_COMPACTION_STRATEGY;
+extern const std::string_view CACHE_ADMISSION_FILTER;
+extern const std::string_view PARALLELIZED_NATIVE_AGGREGATES;
+extern const std::string_view WRITE_ACK_BATCHING;
+extern const std::string_view SLICE_COLUMN_FILTERS;
+extern const std::string_view ALTERNATOR_PROMOTED_ATTRIBUTES;
+extern const std::string_view BATCHLOG_REMOVAL_BATCHING;
+extern const std::string_view XXH3_DIGEST;
+extern const std::string_view CACHE_PINNED_TABLES;
+extern const std::string_view DIRECT_FAILURE_DETECTOR_PING;
 
 }
 
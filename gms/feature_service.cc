@@ -66,6 +66,19 @@ constexpr std::string_view features::SUPPORTS_RAFT_CLUSTER_MANAGEMENT = "SUPPORT
 constexpr std::string_view features::USES_RAFT_CLUSTER_MANAGEMENT = "USES_RAFT_CLUSTER_MANAGEMENT";
 constexpr std::string_view features::TOMBSTONE_GC_OPTIONS = "TOMBSTONE_GC_OPTIONS";
 constexpr std::string_view features::PARALLELIZED_AGGREGATION = "PARALLELIZED_AGGREGATION";
+constexpr std::string_view features::SPLIT_BLOCK_BLOOM_FILTER = "SPLIT_BLOCK_BLOOM_FILTER";
+constexpr std::string_view features::SSTABLE_COMPRESSION_DICTIONARIES = "SSTABLE_COMPRESSION_DICTIONARIES";
+constexpr std::string_view features::STREAM_SSTABLE_FILES = "STREAM_SSTABLE_FILES";
+constexpr std::string_view features::INCREMENTAL_COMPACTION_STRATEGY = "INCREMENTAL_COMPACTION_STRATEGY";
+constexpr std::string_view features::CACHE_ADMISSION_FILTER = "CACHE_ADMISSION_FILTER";
+constexpr std::string_view features::PARALLELIZED_NATIVE_AGGREGATES = "PARALLELIZED_NATIVE_AGGREGATES";
+constexpr std::string_view features::WRITE_ACK_BATCHING = "WRITE_ACK_BATCHING";
+constexpr std::string_view features::SLICE_COLUMN_FILTERS = "SLICE_COLUMN_FILTERS";
+constexpr std::string_view features::ALTERNATOR_PROMOTED_ATTRIBUTES = "ALTERNATOR_PROMOTED_ATTRIBUTES";
+constexpr std::string_view features::BATCHLOG_REMOVAL_BATCHING = "BATCHLOG_REMOVAL_BATCHING";
+constexpr std::string_view features::XXH3_DIGEST = "XXH3_DIGEST";
+constexpr std::string_view features::CACHE_PINNED_TABLES = "CACHE_PINNED_TABLES";
+constexpr std::string_view features::DIRECT_FAILURE_DETECTOR_PING = "DIRECT_FAILURE_DETECTOR_PING";
 
 static logging::logger logger("features");
 
@@ -97,6 +110,19 @@ feature_service::feature_service(feature_config cfg) : _config(cfg)
         , _uses_raft_cluster_mgmt(*this, features::USES_RAFT_CLUSTER_MANAGEMENT)
         , _tombstone_gc_options(*this, features::TOMBSTONE_GC_OPTIONS)
         , _parallelized_aggregation(*this, features::PARALLELIZED_AGGREGATION)
+        , _split_block_bloom_filter(*this, features::SPLIT_BLOCK_BLOOM_FILTER)
+        , _sstable_compression_dictionaries(*this, features::SSTABLE_COMPRESSION_DICTIONARIES)
+        , _stream_sstable_files(*this, features::STREAM_SSTABLE_FILES)
+        , _incremental_compaction_strategy(*this, features::INCREMENTAL_COMPACTION_STRATEGY)
+        , _cache_admission_filter(*this, features::CACHE_ADMISSION_FILTER)
+        , _parallelized_native_aggregates(*this, features::PARALLELIZED_NATIVE_AGGREGATES)
+        , _write_ack_batching(*this, features::WRITE_ACK_BATCHING)
+        , _slice_column_filters(*this, features::SLICE_COLUMN_FILTERS)
+        , _alternator_promoted_attributes(*this, features::ALTERNATOR_PROMOTED_ATTRIBUTES)
+        , _batchlog_removal_batching(*this, features::BATCHLOG_REMOVAL_BATCHING)
+        , _xxh3_digest(*this, features::XXH3_DIGEST)
+        , _cache_pinned_tables(*this, features::CACHE_PINNED_TABLES)
+        , _direct_failure_detector_ping(*this, features::DIRECT_FAILURE_DETECTOR_PING)
         , _raft_support_listener(_supports_raft_cluster_mgmt.when_enabled([this] {
             // When the cluster fully supports raft-based cluster management,
             // we can re-enable support for the second gossip feature to trigger
@@ -233,6 +259,19 @@ std::set<std::string_view> feature_service::known_feature_set() {
         gms::features::USES_RAFT_CLUSTER_MANAGEMENT,
         gms::features::TOMBSTONE_GC_OPTIONS,
         gms::features::PARALLELIZED_AGGREGATION,
+        gms::features::SPLIT_BLOCK_BLOOM_FILTER,
+        gms::features::SSTABLE_COMPRESSION_DICTIONARIES,
+        gms::features::STREAM_SSTABLE_FILES,
+        gms::features::INCREMENTAL_COMPACTION_STRATEGY,
+        gms::features::CACHE_ADMISSION_FILTER,
+        gms::features::PARALLELIZED_NATIVE_AGGREGATES,
+        gms::features::WRITE_ACK_BATCHING,
+        gms::features::SLICE_COLUMN_FILTERS,
+        gms::features::ALTERNATOR_PROMOTED_ATTRIBUTES,
+        gms::features::BATCHLOG_REMOVAL_BATCHING,
+        gms::features::XXH3_DIGEST,
+        gms::features::CACHE_PINNED_TABLES,
+        gms::features::DIRECT_FAILURE_DETECTOR_PING,
     };
 
     for (const sstring& s : _config._disabled_features) {
@@ -344,6 +383,19 @@ void feature_service::enable(const std::set<std::string_view>& list) {
         std::ref(_uses_raft_cluster_mgmt),
         std::ref(_tombstone_gc_options),
         std::ref(_parallelized_aggregation),
+        std::ref(_split_block_bloom_filter),
+        std::ref(_sstable_compression_dictionaries),
+        std::ref(_stream_sstable_files),
+        std::ref(_incremental_compaction_strategy),
+        std::ref(_cache_admission_filter),
+        std::ref(_parallelized_native_aggregates),
+        std::ref(_write_ack_batching),
+        std::ref(_slice_column_filters),
+        std::ref(_alternator_promoted_attributes),
+        std::ref(_batchlog_removal_batching),
+        std::ref(_xxh3_digest),
+        std::ref(_cache_pinned_tables),
+        std::ref(_direct_failure_detector_ping),
     })
     {
         if (list.contains(f.name())) {
@@ -93,6 +93,19 @@ class feature_service final {
     gms::feature _uses_raft_cluster_mgmt;
     gms::feature _tombstone_gc_options;
     gms::feature _parallelized_aggregation;
+    gms::feature _split_block_bloom_filter;
+    gms::feature _sstable_compression_dictionaries;
+    gms::feature _stream_sstable_files;
+    gms::feature _incremental_compaction_strategy;
+    gms::feature _cache_admission_filter;
+    gms::feature _parallelized_native_aggregates;
+    gms::feature _write_ack_batching;
+    gms::feature _slice_column_filters;
+    gms::feature _alternator_promoted_attributes;
+    gms::feature _batchlog_removal_batching;
+    gms::feature _xxh3_digest;
+    gms::feature _cache_pinned_tables;
+    gms::feature _direct_failure_detector_ping;
 
     gms::feature::listener_registration _raft_support_listener;
 
@@ -201,6 +214,71 @@ class feature_service final {
         return bool(_parallelized_aggregation);
     }
 
+    // Nodes can read sstables with split block bloom filters.
+    bool cluster_supports_split_block_bloom_filter() const {
+        return bool(_split_block_bloom_filter);
+    }
+
+    // Nodes can read sstables compressed against a CompressionDictionary component.
+    bool cluster_supports_sstable_compression_dictionaries() const {
+        return bool(_sstable_compression_dictionaries);
+    }
+
+    // Replicas can acknowledge several writes with one MUTATION_DONE_BATCH verb.
+    bool cluster_supports_write_ack_batching() const {
+        return bool(_write_ack_batching);
+    }
+
+    // Replicas skip the cells of the rows which fail partition_slice::filters.
+    bool cluster_supports_slice_column_filters() const {
+        return bool(_slice_column_filters);
+    }
+
+    // Streaming can send sstables which are entirely within the streamed
+    // ranges as raw component files (STREAM_SSTABLE_FILES verb).
+    bool cluster_supports_stream_sstable_files() const {
+        return bool(_stream_sstable_files);
+    }
+
+    // Nodes know IncrementalCompactionStrategy, and can load tables using it.
+    bool cluster_supports_incremental_compaction_strategy() const {
+        return bool(_incremental_compaction_strategy);
+    }
+
+    bool cluster_supports_cache_admission_filter() const {
+        return bool(_cache_admission_filter);
+    }
+
+    // Parallelized aggregation can compute count, min, max and sum of a
+    // column, besides count(*).
+    bool cluster_supports_parallelized_native_aggregates() const {
+        return bool(_parallelized_native_aggregates);
+    }
+
+    // Nodes store and read alternator attributes promoted to their own columns.
+    bool cluster_supports_alternator_promoted_attributes() const {
+        return bool(_alternator_promoted_attributes);
+    }
+
+    // Nodes remove several batches from their batchlog with one REMOVE_FROM_BATCHLOG verb.
+    bool cluster_supports_batchlog_removal_batching() const {
+        return bool(_batchlog_removal_batching);
+    }
+
+    // Read digests and row-level repair can hash with XXH3.
+    bool cluster_supports_xxh3_digest() const {
+        return bool(_xxh3_digest);
+    }
+
+    bool cluster_supports_cache_pinned_tables() const {
+        return bool(_cache_pinned_tables);
+    }
+
+    // Nodes answer the DIRECT_FD_PING verb.
+    bool cluster_supports_direct_failure_detector_ping() const {
+        return bool(_direct_failure_detector_ping);
+    }
+
     static std::set<sstring> to_feature_set(sstring features_string);
     // Persist enabled feature in the `system.scylla_local` table under the "enabled_features" key.
     // The key itself is maintained as an `unordered_set<string>` and serialized via `to_string`
@@ -1069,7 +1069,7 @@ std::set<inet_address> gossiper::get_unreachable_members() {
     return ret;
 }
 
-int gossiper::get_max_endpoint_state_version(endpoint_state state) const noexcept {
+int gossiper::get_max_endpoint_state_version(const endpoint_state& state) const noexcept {
     int max_version = state.get_heart_beat_state().get_heart_beat_version();
     for (auto& entry : state.get_application_state_map()) {
         auto& value = entry.second;
@@ -1680,8 +1680,13 @@ void gossiper::apply_new_states(inet_address addr, endpoint_state& local_state,
     // Exceptions during replication will cause abort because node's state
     // would be inconsistent across shards. Changes listeners depend on state
     // being replicated to all shards.
+    //
+    // Most updates carry only a newer heart beat, which isn't replicated,
+    // don't bother the other shards with them.
     auto replicate_changes = seastar::defer([&] () noexcept {
-        replicate(addr, remote_map, changed).get();
+        if (!changed.empty()) {
+            replicate(addr, remote_map, changed).get();
+        }
     });
 
     // we need to make two loops here, one to apply, then another to notify,
@@ -1731,7 +1736,7 @@ void gossiper::send_all(gossip_digest& g_digest,
     logger.trace("send_all(): ep={}, version > {}", ep, max_remote_version);
     auto local_ep_state_ptr = get_state_for_version_bigger_than(ep, max_remote_version);
     if (local_ep_state_ptr) {
-        delta_ep_state_map[ep] = *local_ep_state_ptr;
+        delta_ep_state_map[ep] = std::move(*local_ep_state_ptr);
     }
 }
 
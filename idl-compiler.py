@@ -283,6 +283,20 @@ class ClassDef(ASTBase):
     def __repr__(self):
         return self.__str__()
 
+    def fixed_serialized_size(self):
+        '''The size of the serialized form of the class if it's the same for
+        all of its values, i.e. if it's a final class made only of members of
+        fixed size, None otherwise.'''
+        if not self.final or self.template_params or self.parent_template_params:
+            return None
+        members = get_members(self)
+        if not members or any(m.attribute for m in members):
+            return None
+        sizes = [fixed_serialized_size(m.type) for m in members]
+        if None in sizes:
+            return None
+        return sum(sizes)
+
     def serializer_write_impl(self, cout):
         name = self.ns_qualified_name()
         full_name = name + self.template_param_names_str
@@ -291,6 +305,11 @@ class ClassDef(ASTBase):
 {self.template_declaration}
 template <typename Output>
 void serializer<{full_name}>::write(Output& buf, const {full_name}& obj) {{""")
+        # The members of fixed size classes are written to a buffer on the
+        # stack, and from there to the output with a single write.
+        fixed_size = self.fixed_serialized_size()
+        if fixed_size is not None:
+            fprintln(cout, """  serialize_fixed_size<fixed_size>(buf, [&obj] (auto& buf) {""")
         if not self.final:
             fprintln(cout, f"""  {SETSIZE}(buf, obj);""")
         for member in self.members:
@@ -298,6 +317,8 @@ void serializer<{full_name}>::write(Output& buf, const {full_name}& obj) {{""")
                 continue
             fprintln(cout, f"""  static_assert(is_equivalent<decltype(obj.{member.name}), {param_type(member.type)}>::value, "member value has a wrong type");
   {SERIALIZER}(buf, obj.{member.name});""")
+        if fixed_size is not None:
+            fprintln(cout, """  });""")
         fprintln(cout, "}")
 
 
@@ -354,6 +375,8 @@ void serializer<{name}{self.template_param_names_str}>::skip(Input& buf) {{
         if not self.final:
             fprintln(cout, f"""  {SIZETYPE} size = {DESERIALIZER}(buf, boost::type<{SIZETYPE}>());
   buf.skip(size - sizeof({SIZETYPE}));""")
+        elif self.fixed_serialized_size() is not None:
+            fprintln(cout, """  buf.skip(fixed_size);""")
         else:
             for m in get_members(self):
                 full_type = param_view_type(m.type)
@@ -771,10 +794,11 @@ def parse_file(file_name):
     return rt.parseFile(file_name, parseAll=True)
 
 
-def declare_methods(hout, name, template_param=""):
+def declare_methods(hout, name, template_param="", fixed_size=None):
+    fixed_size_decl = f"\n  static constexpr size_t fixed_size = {fixed_size};\n" if fixed_size is not None else ""
     fprintln(hout, f"""
 template <{template_param}>
-struct serializer<{name}> {{
+struct serializer<{name}> {{{fixed_size_decl}
   template <typename Output>
   static void write(Output& buf, const {name}& v);
 
@@ -803,7 +827,11 @@ def handle_enum(enum, hout, cout):
     '''Generate serializer declarations and definitions for an IDL enum'''
     temp_def = template_params_str(enum.parent_template_params)
     name = enum.ns_qualified_name()
-    declare_methods(hout, name, temp_def)
+    fixed_size = None
+    if not enum.parent_template_params:
+        fixed_size = fixed_serialized_size(BasicType(enum.underlying_type))
+        register_fixed_size_type(enum, fixed_size)
+    declare_methods(hout, name, temp_def, fixed_size)
 
     enum.serializer_write_impl(cout)
     enum.serializer_read_impl(cout)
@@ -830,6 +858,30 @@ def flat_type(t):
 local_types = {}
 local_writable_types = {}
 rpc_verbs = {}
+# Types which are serialized to the same number of bytes whatever their
+# value: the integers, and the enums and the final classes of such types
+# defined in the current IDL file, see register_fixed_size_type().
+fixed_size_types = {
+    'bool': 1,
+    'int8_t': 1, 'uint8_t': 1,
+    'int16_t': 2, 'uint16_t': 2,
+    'int32_t': 4, 'uint32_t': 4,
+    'int64_t': 8, 'uint64_t': 8,
+}
+
+
+def fixed_serialized_size(t):
+    if isinstance(t, BasicType):
+        return fixed_size_types.get(t.name)
+    return None
+
+
+def register_fixed_size_type(obj, size):
+    if size is None:
+        return
+    # Members may refer to the type with or without its namespace.
+    fixed_size_types[obj.name] = size
+    fixed_size_types[obj.ns_qualified_name()] = size
 
 
 def resolve_basic_type_ref(type: BasicType):
@@ -1503,7 +1555,9 @@ def handle_class(cls, hout, cout):
             handle_class(member, hout, cout)
         elif isinstance(member, EnumDef):
             handle_enum(member, hout, cout)
-    declare_methods(hout, full_name, template_params)
+    fixed_size = cls.fixed_serialized_size()
+    register_fixed_size_type(cls, fixed_size)
+    declare_methods(hout, full_name, template_params, fixed_size)
 
     cls.serializer_write_impl(cout)
     cls.serializer_read_impl(cout)
@@ -2,6 +2,11 @@ namespace query {
 struct forward_request {
     enum class reduction_type : uint8_t {
         count,
+        aggregate,
+    };
+    struct aggregation_info {
+        sstring function_name;
+        std::vector<sstring> column_names;
     };
     std::vector<query::forward_request::reduction_type> reduction_types;
 
@@ -10,6 +15,7 @@ struct forward_request {
 
     db::consistency_level cl;
     lowres_clock::time_point timeout;
+    std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos [[version 5.1]];
 };
 
 struct forward_result {
@@ -70,6 +70,23 @@ struct empty_struct { };
 
 struct empty_final_struct final { };
 
+enum class fixed_size_kind : uint16_t {
+    first,
+    second,
+};
+
+struct fixed_size_final_struct final {
+    uint32_t foo;
+    int64_t bar;
+    fixed_size_kind kind;
+    bool flag;
+};
+
+struct fixed_size_final_wrapper final {
+    fixed_size_final_struct x;
+    uint8_t y;
+};
+
 struct just_a_variant stub [[writable]] {
     std::variant<writable_simple_compound, simple_compound> variant;
 };
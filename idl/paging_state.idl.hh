@@ -18,6 +18,7 @@ class paging_state {
     uint32_t get_rows_fetched_for_last_partition_low_bits() [[version 3.1]] = 0;
     uint32_t get_remaining_high_bits() [[version 4.3]] = 0;
     uint32_t get_rows_fetched_for_last_partition_high_bits() [[version 4.3]] = 0;
+    uint32_t get_range_read_concurrency() [[version 5.1]] = 0;
 };
 }
 }
@@ -52,6 +52,11 @@ enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set_rpc_stream,
 };
 
+enum class repair_hash_algorithm : uint8_t {
+    xxhash64,
+    xxh3,
+};
+
 enum class repair_stream_cmd : uint8_t {
     error,
     hash_data,
@@ -78,8 +83,14 @@ enum class repair_row_level_start_status: uint8_t {
     no_such_column_family,
 };
 
+struct cached_range_hash {
+    uint64_t seed;
+    repair_hash hash;
+};
+
 struct repair_row_level_start_response {
     repair_row_level_start_status status;
+    std::optional<cached_range_hash> range_hash [[version 5.2]];
 };
 
 enum class node_ops_cmd : uint32_t {
@@ -17,6 +17,20 @@ class specific_ranges {
     std::vector<nonwrapping_range<clustering_key_prefix>> ranges();
 };
 
+struct column_filter {
+    enum class op : uint8_t {
+        eq,
+        lt,
+        lte,
+        gt,
+        gte,
+        in,
+    };
+    uint32_t column;
+    query::column_filter::op oper;
+    std::vector<bytes> values;
+};
+
 // COMPATIBILITY NOTE: the partition-slice for reverse queries has two different
 // format:
 // * legacy format
@@ -32,6 +46,7 @@ class partition_slice {
     cql_serialization_format cql_format();
     uint32_t partition_row_limit_low_bits() [[version 1.3]] = std::numeric_limits<uint32_t>::max();
     uint32_t partition_row_limit_high_bits() [[version 4.3]] = 0;
+    std::vector<query::column_filter> filters [[version 5.2]];
 };
 
 struct max_result_size {
@@ -52,6 +67,8 @@ class read_command {
     query::is_first_page is_first_page [[version 2.2]] = query::is_first_page::no;
     std::optional<query::max_result_size> max_result_size [[version 4.3]] = std::nullopt;
     uint32_t row_limit_high_bits [[version 4.3]] = 0;
+    sstring service_level [[version 5.1]] = sstring();
+    int32_t service_level_shares [[version 5.1]] = 0;
 };
 
 }
@@ -45,4 +45,11 @@ enum class stream_mutation_fragments_cmd : uint8_t {
     end_of_stream,
 };
 
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    component_start,
+    component_data,
+    end_of_stream,
+};
+
 }
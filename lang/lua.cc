@@ -13,6 +13,7 @@
 #include "utils/ascii.hh"
 #include "utils/date.h"
 #include <seastar/core/align.hh>
+#include <map>
 #include <lua.hpp>
 #include "db/config.hh"
 
@@ -57,6 +58,9 @@ class lua_slice_state {
         : a_state(std::move(a_state))
         , _l(std::move(l)) {}
     operator lua_State*() { return _l.get(); }
+    bool has_limits_of(const lua::runtime_config& cfg) const {
+        return a_state->max == cfg.max_bytes() && a_state->max_contiguous == cfg.max_contiguous();
+    }
 };
 }
 
@@ -410,6 +414,11 @@ static const struct luaL_Reg decimal_methods[] {
     {nullptr, nullptr}
 };
 
+// Where load_script_l() keeps the script and the metatable of the
+// environments of its calls, in the registry.
+static const char scylla_udf_registry_key[] = "Scylla.udf";
+static const char scylla_udf_env_metatable_registry_key[] = "Scylla.udf_env";
+
 static int load_script_l(lua_State* l) {
     const auto& bitcode = *reinterpret_cast<lua::bitcode_view*>(lua_touserdata(l, 1));
     const auto& binary = bitcode.bitcode;
@@ -427,10 +436,32 @@ static int load_script_l(lua_State* l) {
     if (luaL_loadbufferx(l, binary.data(), binary.size(), "<internal>", "b")) {
         lua_error(l);
     }
+    lua_pushvalue(l, -1);
+    lua_setfield(l, LUA_REGISTRYINDEX, scylla_udf_registry_key);
+
+    lua_createtable(l, 0, 1);
+    lua_pushglobaltable(l);
+    lua_setfield(l, -2, "__index");
+    lua_setfield(l, LUA_REGISTRYINDEX, scylla_udf_env_metatable_registry_key);
 
     return 1;
 }
 
+// Pushes the script, with a fresh environment of its own for globals, so
+// that whatever a call leaves in the globals isn't seen by the next call
+// in the same state. The libraries are still reached through the
+// environment, which falls back to the global table.
+static int prepare_call_l(lua_State* l) {
+    lua_getfield(l, LUA_REGISTRYINDEX, scylla_udf_registry_key);
+    lua_createtable(l, 0, 0);
+    luaL_setmetatable(l, scylla_udf_env_metatable_registry_key);
+    // The environment is the only upvalue of a main chunk
+    if (!lua_setupvalue(l, -2, 1)) {
+        luaL_error(l, "could not set the environment of the script");
+    }
+    return 1;
+}
+
 static lua_slice_state load_script(const lua::runtime_config& cfg, lua::bitcode_view binary) {
     lua_slice_state l = new_lua(cfg);
 
@@ -443,9 +474,48 @@ static lua_slice_state load_script(const lua::runtime_config& cfg, lua::bitcode_
         throw std::runtime_error(std::string("could not initiate: ") + lua_tostring(l, -1));
     }
 
+    lua_settop(l, 0);
     return l;
 }
 
+// Lua states with a script loaded, ready to be called again. Creating a
+// state and loading the script into it costs much more than running most
+// scripts, which are called once per row.
+static constexpr size_t max_pooled_states_per_script = 4;
+static constexpr size_t max_pooled_scripts = 128;
+static thread_local std::map<std::string, std::vector<lua_slice_state>, std::less<>> pooled_states;
+
+static lua_slice_state get_state(const lua::runtime_config& cfg, lua::bitcode_view binary) {
+    auto it = pooled_states.find(binary.bitcode);
+    // The limits of a state are set when it's created, don't use the ones
+    // which were created before the limits were changed.
+    while (it != pooled_states.end() && !it->second.empty()) {
+        auto l = std::move(it->second.back());
+        it->second.pop_back();
+        if (l.has_limits_of(cfg)) {
+            return l;
+        }
+    }
+    return load_script(cfg, binary);
+}
+
+// Puts back a state which completed a call, so the next call of the
+// script can use it. States whose call failed are not put back, as they
+// may be left in any state.
+static void put_state(lua::bitcode_view binary, lua_slice_state l) {
+    auto it = pooled_states.find(binary.bitcode);
+    if (it == pooled_states.end()) {
+        if (pooled_states.size() >= max_pooled_scripts) {
+            pooled_states.erase(pooled_states.begin());
+        }
+        it = pooled_states.emplace(std::string(binary.bitcode), std::vector<lua_slice_state>()).first;
+    }
+    if (it->second.size() < max_pooled_states_per_script) {
+        lua_settop(l, 0);
+        it->second.push_back(std::move(l));
+    }
+}
+
 using millisecond = std::chrono::duration<double, std::milli>;
 static auto now() { return std::chrono::system_clock::now(); }
 
@@ -1070,7 +1140,11 @@ lua::runtime_config lua::make_runtime_config(const db::config& config) {
 
 // run the script for at most max_instructions
 future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
-    lua_slice_state l = load_script(cfg, bitcode);
+    lua_slice_state l = get_state(cfg, bitcode);
+    lua_pushcfunction(l, prepare_call_l);
+    if (lua_pcall(l, 0, 1, 0)) {
+        throw std::runtime_error(std::string("could not initiate: ") + lua_tostring(l, -1));
+    }
     unsigned nargs = values.size();
     if (!lua_checkstack(l, nargs)) {
         throw std::runtime_error("could push args to the stack");
@@ -1084,7 +1158,7 @@ future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<d
     using duration = std::chrono::system_clock::duration;
     duration elapsed{0};
     duration timeout = std::chrono::duration_cast<duration>(millisecond(cfg.timeout_in_ms));
-    return repeat_until_value([l = std::move(l), elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
+    return repeat_until_value([l = std::move(l), bitcode, elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
         // Set the hook before resuming. We have to do it here since the hook can reset itself
         // if it detects we are spending too much time in C.
         // The hook will be called after 1000 instructions.
@@ -1092,8 +1166,11 @@ future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<d
         auto start = ::now();
         LUA_504_PLUS(int nresults;)
         switch (lua_resume(l, nullptr, nargs LUA_504_PLUS(, &nresults))) {
-        case LUA_OK:
-            return make_ready_future<std::optional<bytes_opt>>(convert_return(l, return_type));
+        case LUA_OK: {
+            auto ret = convert_return(l, return_type);
+            put_state(bitcode, std::move(l));
+            return make_ready_future<std::optional<bytes_opt>>(std::move(ret));
+        }
         case LUA_YIELD: {
             nargs = 0;
             elapsed += ::now() - start;
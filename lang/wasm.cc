@@ -25,13 +25,26 @@ namespace wasm {
 context::context(wasm::engine* engine_ptr, std::string name) : engine_ptr(engine_ptr), function_name(name) {
 }
 
-static std::pair<wasmtime::Instance, wasmtime::Func> create_instance_and_func(context& ctx, wasmtime::Store& store) {
+static std::optional<size_t> exported_memory_size(wasmtime::Store& store, wasmtime::Instance& instance) {
+    auto memory_export = instance.get(store, "memory");
+    if (!memory_export) {
+        return std::nullopt;
+    }
+    auto* memory = std::get_if<wasmtime::Memory>(&*memory_export);
+    if (!memory) {
+        return std::nullopt;
+    }
+    return memory->size(store);
+}
+
+static instance create_instance(context& ctx) {
+    wasmtime::Store store(ctx.engine_ptr->get());
     auto instance_res = wasmtime::Instance::create(store, *ctx.module, {});
     if (!instance_res) {
       throw wasm::exception(format("Creating a wasm runtime instance failed: {}", instance_res.err().message()));
     }
-    auto instance = instance_res.unwrap();
-    auto function_obj = instance.get(store, ctx.function_name);
+    auto inst = instance_res.unwrap();
+    auto function_obj = inst.get(store, ctx.function_name);
     if (!function_obj) {
         throw wasm::exception(format("Function {} was not found in given wasm source code", ctx.function_name));
     }
@@ -39,19 +52,54 @@ static std::pair<wasmtime::Instance, wasmtime::Func> create_instance_and_func(co
     if (!func) {
         throw wasm::exception(format("Exported object {} is not a function", ctx.function_name));
     }
-    return std::make_pair(std::move(instance), std::move(*func));
+    // Replenish the store with initial amount of fuel
+    auto added = store.context().add_fuel(ctx.engine_ptr->initial_fuel_amount());
+    if (!added) {
+        throw wasm::exception(added.err().message());
+    }
+    auto memory_size = exported_memory_size(store, inst);
+    return instance{std::move(store), std::move(inst), std::move(*func), memory_size};
+}
+
+static instance acquire_instance(context& ctx) {
+    if (ctx.instances.empty()) {
+        return create_instance(ctx);
+    }
+    auto inst = std::move(ctx.instances.back());
+    ctx.instances.pop_back();
+    return inst;
+}
+
+// Puts an instance which completed a call back to the pool of the function,
+// along with the fuel the call consumed. Memory can't be shrunk, so an
+// instance whose memory grew during the call (all arguments passed through
+// memory grow it) is dropped instead, to keep the footprint of the pool
+// bounded.
+static void release_instance(context& ctx, instance inst, uint64_t consumed_fuel) {
+    if (ctx.instances.size() >= context::max_pooled_instances
+            || exported_memory_size(inst.store, inst.instance) != inst.memory_size
+            || !inst.store.context().add_fuel(consumed_fuel)) {
+        return;
+    }
+    ctx.instances.push_back(std::move(inst));
 }
 
 void compile(context& ctx, const std::vector<sstring>& arg_names, std::string script) {
-    wasm_logger.debug("Compiling script {}", script);
-    auto module = wasmtime::Module::compile(ctx.engine_ptr->get(), script);
-    if (!module) {
-        throw wasm::exception(format("Compilation failed: {}", module.err().message()));
+    if (auto module = ctx.engine_ptr->find_module(script)) {
+        wasm_logger.debug("Found compiled script {}", script);
+        ctx.module = std::move(*module);
+    } else {
+        wasm_logger.debug("Compiling script {}", script);
+        auto compiled = wasmtime::Module::compile(ctx.engine_ptr->get(), script);
+        if (!compiled) {
+            throw wasm::exception(format("Compilation failed: {}", compiled.err().message()));
+        }
+        ctx.module = compiled.unwrap();
     }
-    ctx.module = module.unwrap();
-    // Create the instance and extract function definition for validation purposes only
-    wasmtime::Store store(ctx.engine_ptr->get());
-    create_instance_and_func(ctx, store);
+    // Create an instance and extract the function for validation, and keep it for the first call
+    ctx.instances.clear();
+    ctx.instances.push_back(create_instance(ctx));
+    ctx.engine_ptr->cache_module(script, *ctx.module);
 }
 
 struct init_arg_visitor {
@@ -239,14 +287,12 @@ struct from_val_visitor {
 seastar::future<bytes_opt> run_script(context& ctx, const std::vector<data_type>& arg_types, const std::vector<bytes_opt>& params, data_type return_type, bool allow_null_input) {
     wasm_logger.debug("Running function {}", ctx.function_name);
 
-    auto store = wasmtime::Store(ctx.engine_ptr->get());
-    // Replenish the store with initial amount of fuel
-    auto added = store.context().add_fuel(ctx.engine_ptr->initial_fuel_amount());
-    if (!added) {
-        co_return coroutine::make_exception(wasm::exception(added.err().message()));
-    }
-    auto [instance, func] = create_instance_and_func(ctx, store);
+    auto inst = acquire_instance(ctx);
+    auto& store = inst.store;
+    auto& instance = inst.instance;
+    auto& func = inst.func;
     std::vector<wasmtime::Val> argv;
+    argv.reserve(arg_types.size());
     for (size_t i = 0; i < arg_types.size(); ++i) {
         const abstract_type& type = *arg_types[i];
         const bytes_opt& param = params[i];
@@ -288,13 +334,16 @@ seastar::future<bytes_opt> run_script(context& ctx, const std::vector<data_type>
     // wrappers for a few languages (C++, C, Rust), and see whether the ABI makes it easy
     // to interact with - we want to avoid poor user experience, and it's hard to judge it
     // before we actually have helper libraries.
+    bytes_opt ret;
     if (allow_null_input) {
         // Force calling the default method for abstract_type, which checks for nulls
         // and expects a serialized input
-        co_return from_val_visitor{result_vec[0], store, instance}(static_cast<const abstract_type&>(*return_type));
+        ret = from_val_visitor{result_vec[0], store, instance}(static_cast<const abstract_type&>(*return_type));
     } else {
-        co_return visit(*return_type, from_val_visitor{result_vec[0], store, instance});
+        ret = visit(*return_type, from_val_visitor{result_vec[0], store, instance});
     }
+    release_instance(ctx, std::move(inst), consumed);
+    co_return ret;
 }
 
 }
@@ -25,10 +25,26 @@ struct exception : public std::exception {
 
 #ifdef SCYLLA_ENABLE_WASMTIME
 
+// An instance of the module of a function, with the store it lives in.
+struct instance {
+    wasmtime::Store store;
+    wasmtime::Instance instance;
+    wasmtime::Func func;
+    // The size of the exported memory when the instance was created, if it exports one.
+    std::optional<size_t> memory_size;
+};
+
 struct context {
     wasm::engine* engine_ptr;
     std::optional<wasmtime::Module> module;
     std::string function_name;
+    // Instances left by previous calls, ready to be called again.
+    std::vector<instance> instances;
+
+    // Creating an instance costs much more than most calls, but an instance
+    // is only reused if its memory didn't grow, so the number of instances
+    // kept around doesn't need to be large.
+    static constexpr size_t max_pooled_instances = 4;
 
     context(wasm::engine* engine_ptr, std::string name);
 };
@@ -13,6 +13,9 @@
 
 #ifdef SCYLLA_ENABLE_WASMTIME
 
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include "wasmtime.hh"
 
 namespace wasm {
@@ -33,13 +36,34 @@ constexpr uint64_t default_initial_fuel_amount = 20*1024;
 class engine {
     wasmtime::Engine _engine;
     uint64_t _initial_fuel_amount;
+    // Modules compiled on this shard, by source. Functions are created again
+    // from their source whenever the schema is reloaded, the cache spares
+    // compiling them each time.
+    std::unordered_map<std::string, wasmtime::Module> _modules;
 public:
+    static constexpr size_t max_cached_modules = 128;
+
     engine(uint64_t initial_fuel_amount = default_initial_fuel_amount)
             : _engine(make_config())
             , _initial_fuel_amount(initial_fuel_amount)
         {}
     wasmtime::Engine& get() { return _engine; }
     uint64_t initial_fuel_amount() { return _initial_fuel_amount; };
+
+    std::optional<wasmtime::Module> find_module(const std::string& source) const {
+        auto it = _modules.find(source);
+        if (it == _modules.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    void cache_module(const std::string& source, const wasmtime::Module& module) {
+        if (_modules.size() >= max_cached_modules) {
+            _modules.erase(_modules.begin());
+        }
+        _modules.insert_or_assign(source, module);
+    }
 private:
     wasmtime::Config make_config() {
         wasmtime::Config cfg;
@@ -13,6 +13,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include "utils/stall_free.hh"
+#include "utils/hash.hh"
 
 namespace locator {
 
@@ -67,9 +68,54 @@ sstring abstract_replication_strategy::to_qualified_class_name(std::string_view
 }
 
 inet_address_vector_replica_set abstract_replication_strategy::get_natural_endpoints(const token& search_token, const effective_replication_map& erm) const {
-    const token& key_token = erm.get_token_metadata_ptr()->first_token(search_token);
-    auto res = erm.get_replication_map().find(key_token);
-    return res->second;
+    return erm.get_replication_map().get_replica_set(erm.get_token_metadata_ptr()->first_token_index(search_token));
+}
+
+replication_map::builder::builder(size_t tokens_count) {
+    _token_replica_sets.reserve(tokens_count);
+}
+
+void replication_map::builder::add(inet_address_vector_replica_set replica_set) {
+    size_t h = 0;
+    for (auto& ep : replica_set) {
+        h = utils::hash_combine(h, std::hash<inet_address>()(ep));
+    }
+    auto [begin, end] = _replica_set_ids.equal_range(h);
+    for (auto it = begin; it != end; ++it) {
+        if (_replica_sets[it->second] == replica_set) {
+            _token_replica_sets.push_back(it->second);
+            return;
+        }
+    }
+    auto id = replica_set_id(_replica_sets.size());
+    _replica_sets.push_back(std::move(replica_set));
+    _replica_set_ids.emplace(h, id);
+    _token_replica_sets.push_back(id);
+}
+
+replication_map replication_map::builder::build() && {
+    return replication_map(std::move(_replica_sets), std::move(_token_replica_sets));
+}
+
+future<replication_map> replication_map::clone_gently() const {
+    std::vector<inet_address_vector_replica_set> replica_sets;
+    replica_sets.reserve(_replica_sets.size());
+    for (auto& rs : _replica_sets) {
+        replica_sets.push_back(rs);
+        co_await coroutine::maybe_yield();
+    }
+    std::vector<replica_set_id> token_replica_sets;
+    token_replica_sets.reserve(_token_replica_sets.size());
+    for (auto id : _token_replica_sets) {
+        token_replica_sets.push_back(id);
+        co_await coroutine::maybe_yield();
+    }
+    co_return replication_map(std::move(replica_sets), std::move(token_replica_sets));
+}
+
+future<> replication_map::clear_gently() noexcept {
+    co_await utils::clear_gently(_replica_sets);
+    _token_replica_sets = {};
 }
 
 inet_address_vector_replica_set effective_replication_map::get_natural_endpoints_without_node_being_replaced(const token& search_token) const {
@@ -302,25 +348,19 @@ abstract_replication_strategy::get_pending_address_ranges(const token_metadata_p
 }
 
 future<mutable_effective_replication_map_ptr> calculate_effective_replication_map(abstract_replication_strategy::ptr_type rs, token_metadata_ptr tmptr) {
-    replication_map replication_map;
+    const auto& sorted_tokens = tmptr->sorted_tokens();
+    replication_map::builder builder(sorted_tokens.size());
 
-    for (const auto &t : tmptr->sorted_tokens()) {
-        replication_map.emplace(t, co_await rs->calculate_natural_endpoints(t, *tmptr));
+    for (const auto &t : sorted_tokens) {
+        builder.add(co_await rs->calculate_natural_endpoints(t, *tmptr));
     }
 
     auto rf = rs->get_replication_factor(*tmptr);
-    co_return make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(replication_map), rf);
+    co_return make_effective_replication_map(std::move(rs), std::move(tmptr), std::move(builder).build(), rf);
 }
 
 future<replication_map> effective_replication_map::clone_endpoints_gently() const {
-    replication_map cloned_endpoints;
-
-    for (auto& i : _replication_map) {
-        cloned_endpoints.emplace(i.first, i.second);
-        co_await coroutine::maybe_yield();
-    }
-
-    co_return cloned_endpoints;
+    return _replication_map.clone_gently();
 }
 
 inet_address_vector_replica_set effective_replication_map::get_natural_endpoints(const token& search_token) const {
@@ -42,7 +42,54 @@ using can_yield = utils::can_yield;
 
 using replication_strategy_config_options = std::map<sstring, sstring>;
 
-using replication_map = std::unordered_map<token, inet_address_vector_replica_set>;
+// The replica sets of all the tokens of the ring, indexed by the position of
+// the token in token_metadata::sorted_tokens(), so that finding the replicas of
+// a token is a binary search in the sorted tokens and an index into an array.
+//
+// Most tokens share their replica set with many other tokens, so each distinct
+// replica set is stored once and the tokens hold the id of theirs.
+class replication_map {
+public:
+    using replica_set_id = uint32_t;
+private:
+    std::vector<inet_address_vector_replica_set> _replica_sets;
+    std::vector<replica_set_id> _token_replica_sets;
+public:
+    replication_map() = default;
+    replication_map(std::vector<inet_address_vector_replica_set> replica_sets, std::vector<replica_set_id> token_replica_sets) noexcept
+        : _replica_sets(std::move(replica_sets))
+        , _token_replica_sets(std::move(token_replica_sets))
+    { }
+
+    // Returns the replica set of the token at the given position in the sorted tokens.
+    const inet_address_vector_replica_set& get_replica_set(size_t token_index) const noexcept {
+        return _replica_sets[_token_replica_sets[token_index]];
+    }
+
+    size_t size() const noexcept {
+        return _token_replica_sets.size();
+    }
+
+    size_t replica_sets_count() const noexcept {
+        return _replica_sets.size();
+    }
+
+    future<replication_map> clone_gently() const;
+    future<> clear_gently() noexcept;
+
+    class builder;
+};
+
+// Builds a replication_map by adding the replica sets of the sorted tokens, in order.
+class replication_map::builder {
+    std::vector<inet_address_vector_replica_set> _replica_sets;
+    std::vector<replica_set_id> _token_replica_sets;
+    std::unordered_multimap<size_t, replica_set_id> _replica_set_ids;
+public:
+    explicit builder(size_t tokens_count);
+    void add(inet_address_vector_replica_set replica_set);
+    replication_map build() &&;
+};
 
 class effective_replication_map;
 class effective_replication_map_factory;
@@ -60,7 +60,11 @@ class token_metadata_impl final {
 
     std::unordered_map<sstring, boost::icl::interval_map<token, std::unordered_set<inet_address>>> _pending_ranges_interval_map;
 
-    std::vector<token> _sorted_tokens;
+    // The sorted tokens are never modified in place, a new vector replaces
+    // them on every change, so that clones made on the same shard can share
+    // them instead of copying all the tokens of the ring.
+    lw_shared_ptr<std::vector<token>> _sorted_tokens;
+    unsigned _sorted_tokens_shard = this_shard_id();
 
     topology _topology;
 
@@ -71,6 +75,10 @@ class token_metadata_impl final {
     // clone_async() must be updated to copy that member.
 
     void sort_tokens();
+    void set_sorted_tokens(std::vector<token> sorted);
+    // Updates the sorted tokens with the tokens added to and removed from _token_to_endpoint_map
+    // by merging them in, instead of sorting all of them again.
+    future<> merge_sorted_tokens(std::vector<token> added, const std::unordered_set<token>& removed);
 
 public:
     token_metadata_impl() noexcept {};
@@ -365,10 +373,22 @@ future<token_metadata_impl> token_metadata_impl::clone_only_token_map(bool clone
         }).then([this, &ret] {
             ret._topology = _topology;
         }).then([this, &ret, clone_sorted_tokens] {
-            if (clone_sorted_tokens) {
+            if (!clone_sorted_tokens || !_sorted_tokens) {
+                return make_ready_future<token_metadata_impl>(std::move(ret));
+            }
+            if (_sorted_tokens_shard == this_shard_id()) {
                 ret._sorted_tokens = _sorted_tokens;
+                return make_ready_future<token_metadata_impl>(std::move(ret));
             }
-            return make_ready_future<token_metadata_impl>(std::move(ret));
+            // lw_shared_ptr can't be shared across shards, copy the tokens.
+            auto sorted = make_lw_shared<std::vector<token>>();
+            sorted->reserve(_sorted_tokens->size());
+            return do_for_each(*_sorted_tokens, [sorted] (const token& t) {
+                sorted->push_back(t);
+            }).then([&ret, sorted] {
+                ret._sorted_tokens = std::move(sorted);
+                return make_ready_future<token_metadata_impl>(std::move(ret));
+            });
         });
     });
 }
@@ -380,7 +400,10 @@ future<> token_metadata_impl::clear_gently() noexcept {
     co_await utils::clear_gently(_leaving_endpoints);
     co_await utils::clear_gently(_replacing_endpoints);
     co_await utils::clear_gently(_pending_ranges_interval_map);
-    co_await utils::clear_gently(_sorted_tokens);
+    if (_sorted_tokens && _sorted_tokens.owned()) {
+        co_await utils::clear_gently(*_sorted_tokens);
+    }
+    _sorted_tokens = nullptr;
     co_await _topology.clear_gently();
     co_return;
 }
@@ -395,11 +418,37 @@ void token_metadata_impl::sort_tokens() {
 
     std::sort(sorted.begin(), sorted.end());
 
-    _sorted_tokens = std::move(sorted);
+    set_sorted_tokens(std::move(sorted));
+}
+
+void token_metadata_impl::set_sorted_tokens(std::vector<token> sorted) {
+    _sorted_tokens = make_lw_shared<std::vector<token>>(std::move(sorted));
+    _sorted_tokens_shard = this_shard_id();
+}
+
+future<> token_metadata_impl::merge_sorted_tokens(std::vector<token> added, const std::unordered_set<token>& removed) {
+    auto old_tokens_ptr = _sorted_tokens; // keeps them alive across yields
+    const auto& old_tokens = sorted_tokens();
+    std::sort(added.begin(), added.end());
+    std::vector<token> sorted;
+    sorted.reserve(old_tokens.size() + added.size() - std::min(removed.size(), old_tokens.size()));
+    auto a = added.begin();
+    for (const token& t : old_tokens) {
+        co_await coroutine::maybe_yield();
+        while (a != added.end() && *a < t) {
+            sorted.push_back(*a++);
+        }
+        if (!removed.contains(t)) {
+            sorted.push_back(t);
+        }
+    }
+    sorted.insert(sorted.end(), a, added.end());
+    set_sorted_tokens(std::move(sorted));
 }
 
 const std::vector<token>& token_metadata_impl::sorted_tokens() const {
-    return _sorted_tokens;
+    static const thread_local std::vector<token> empty_tokens;
+    return _sorted_tokens ? *_sorted_tokens : empty_tokens;
 }
 
 std::vector<token> token_metadata_impl::get_tokens(const inet_address& addr) const {
@@ -426,7 +475,12 @@ future<> token_metadata_impl::update_normal_tokens(const std::unordered_map<inet
         co_return;
     }
 
-    bool should_sort_tokens = false;
+    // The sorted tokens can be merged with the changes only if they are up to date,
+    // they aren't after remove_endpoint(), till the tokens are sorted again.
+    const bool sorted_tokens_in_sync = sorted_tokens().size() == _token_to_endpoint_map.size();
+    // Tokens which are new to _token_to_endpoint_map and tokens which are gone from it.
+    std::unordered_set<token> added_tokens;
+    std::unordered_set<token> removed_tokens;
     for (auto&& i : endpoint_tokens) {
         inet_address endpoint = i.first;
         auto tokens = i.second;
@@ -444,6 +498,9 @@ future<> token_metadata_impl::update_normal_tokens(const std::unordered_map<inet
                 auto tokit = tokens.find(it->first);
                 if (tokit == tokens.end()) {
                     // token no longer owned by endpoint
+                    if (!added_tokens.erase(it->first)) {
+                        removed_tokens.insert(it->first);
+                    }
                     it = _token_to_endpoint_map.erase(it);
                     continue;
                 }
@@ -458,7 +515,7 @@ future<> token_metadata_impl::update_normal_tokens(const std::unordered_map<inet
         // a. Add the endpoint to _topology if needed.
         // b. update pending _bootstrap_tokens and _leaving_endpoints
         // c. update _token_to_endpoint_map with the new endpoint->token mappings
-        //    - set `should_sort_tokens` if new tokens were added
+        //    - record the tokens which were added
         _topology.add_endpoint(endpoint);
         remove_by_value(_bootstrap_tokens, endpoint);
         _leaving_endpoints.erase(endpoint);
@@ -467,7 +524,12 @@ future<> token_metadata_impl::update_normal_tokens(const std::unordered_map<inet
         {
             co_await coroutine::maybe_yield();
             auto prev = _token_to_endpoint_map.insert(std::pair<token, inet_address>(t, endpoint));
-            should_sort_tokens |= prev.second; // new token inserted -> sort
+            if (prev.second) {
+                // new token inserted, unless it was removed above
+                if (!removed_tokens.erase(t)) {
+                    added_tokens.insert(t);
+                }
+            }
             if (prev.first->second != endpoint) {
                 tlogger.debug("Token {} changing ownership from {} to {}", t, prev.first->second, endpoint);
                 prev.first->second = endpoint;
@@ -475,30 +537,31 @@ future<> token_metadata_impl::update_normal_tokens(const std::unordered_map<inet
         }
     }
 
-    // New tokens were added to _token_to_endpoint_map
-    // so re-sort all tokens.
-    if (should_sort_tokens) {
+    if (!sorted_tokens_in_sync) {
         sort_tokens();
+    } else if (!added_tokens.empty() || !removed_tokens.empty()) {
+        co_await merge_sorted_tokens(std::vector<token>(added_tokens.begin(), added_tokens.end()), removed_tokens);
     }
     co_return;
 }
 
 size_t token_metadata_impl::first_token_index(const token& start) const {
-    if (_sorted_tokens.empty()) {
+    const auto& sorted = sorted_tokens();
+    if (sorted.empty()) {
         auto msg = format("sorted_tokens is empty in first_token_index!");
         tlogger.error("{}", msg);
         throw std::runtime_error(msg);
     }
-    auto it = std::lower_bound(_sorted_tokens.begin(), _sorted_tokens.end(), start);
-    if (it == _sorted_tokens.end()) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), start);
+    if (it == sorted.end()) {
         return 0;
     } else {
-        return std::distance(_sorted_tokens.begin(), it);
+        return std::distance(sorted.begin(), it);
     }
 }
 
 const token& token_metadata_impl::first_token(const token& start) const {
-    return _sorted_tokens[first_token_index(start)];
+    return sorted_tokens()[first_token_index(start)];
 }
 
 std::optional<inet_address> token_metadata_impl::get_endpoint(const token& token) const {
@@ -522,7 +585,7 @@ void token_metadata_impl::debug_show() const {
             fmt::print("inet_address={}, uuid={}\n", x.first, x.second);
         }
         fmt::print("Sorted Token\n");
-        for (auto x : _sorted_tokens) {
+        for (auto x : sorted_tokens()) {
             fmt::print("token={}\n", x);
         }
     });
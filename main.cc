@@ -37,6 +37,8 @@
 #include "utils/runtime.hh"
 #include "log.hh"
 #include "utils/directories.hh"
+#include "utils/cpu_profiler.hh"
+#include "utils/alien_worker.hh"
 #include "debug.hh"
 #include "auth/common.hh"
 #include "init.hh"
@@ -60,9 +62,11 @@
 
 #include "db/view/view_update_generator.hh"
 #include "service/cache_hitrate_calculator.hh"
+#include "service/cache_saver.hh"
 #include "compaction/compaction_manager.hh"
 #include "sstables/sstables.hh"
 #include "gms/feature_service.hh"
+#include "gms/direct_failure_detector.hh"
 #include "replica/distributed_loader.hh"
 #include "sstables_loader.hh"
 #include "cql3/cql_config.hh"
@@ -427,6 +431,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     ext->add_schema_extension<cdc::cdc_extension>(cdc::cdc_extension::NAME);
     ext->add_schema_extension<db::paxos_grace_seconds_extension>(db::paxos_grace_seconds_extension::NAME);
     ext->add_schema_extension<tombstone_gc_extension>(tombstone_gc_extension::NAME);
+    ext->add_row_expiration_extension("alternator_ttl", alternator::make_row_expiration_extension());
 
     auto cfg = make_lw_shared<db::config>(ext);
     auto init = app.get_options_description().add_options();
@@ -469,6 +474,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
         fmt::print(
                 "types - a command-line tool to examine values belonging to scylla types\n"
                 "sstable - a multifunctional command-line tool to examine the content of sstables\n"
+                "compaction-simulator - a command-line tool to simulate compaction strategies over a synthetic or recorded workload\n"
         );
         return 0;
     }
@@ -481,6 +487,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     sharded<service::endpoint_lifecycle_notifier> lifecycle_notifier;
     distributed<replica::database> db;
     seastar::sharded<service::cache_hitrate_calculator> cf_cache_hitrate_calculator;
+    seastar::sharded<service::cache_saver> cache_saver;
     service::load_meter load_meter;
     auto& proxy = service::get_storage_proxy();
     sharded<service::storage_service> ss;
@@ -498,6 +505,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     sharded<service::memory_limiter> service_memory_limiter;
     sharded<repair_service> repair;
     sharded<sstables_loader> sst_loader;
+    sharded<gms::direct_failure_detector> direct_fd;
     sharded<streaming::stream_manager> stream_manager;
     sharded<service::forward_service> forward_service;
 
@@ -554,7 +562,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 sighup_handler.stop().get();
             });
 
-            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
+            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory(), cfg->lsa_hugepage_segment_chunks()).get();
             logging::apply_settings(cfg->logging_settings(app.options().log_opts));
 
             startlog.info(startup_msg, scylla_version(), get_build_id());
@@ -603,15 +611,19 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 }
             };
             auto background_reclaim_scheduling_group = make_sched_group("background_reclaim", 50);
+            auto background_defragmentation_scheduling_group = make_sched_group("background_defragmentation", 50);
             auto maintenance_scheduling_group = make_sched_group("streaming", 200);
 
-            smp::invoke_on_all([&cfg, background_reclaim_scheduling_group] {
+            smp::invoke_on_all([&cfg, background_reclaim_scheduling_group, background_defragmentation_scheduling_group] {
                 logalloc::tracker::config st_cfg;
                 st_cfg.defragment_on_idle = cfg->defragment_memory_on_idle();
                 st_cfg.abort_on_lsa_bad_alloc = cfg->abort_on_lsa_bad_alloc();
                 st_cfg.lsa_reclamation_step = cfg->lsa_reclamation_step();
                 st_cfg.background_reclaim_sched_group = background_reclaim_scheduling_group;
                 st_cfg.sanitizer_report_backtrace = cfg->sanitizer_report_backtrace();
+                st_cfg.defragmentation_target_occupancy = cfg->lsa_defragmentation_target_occupancy();
+                st_cfg.defragmentation_cpu_budget = cfg->lsa_defragmentation_cpu_budget();
+                st_cfg.background_defragmentation_sched_group = background_defragmentation_scheduling_group;
                 logalloc::shard_tracker().configure(st_cfg);
             }).get();
 
@@ -678,6 +690,10 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             });
             set_abort_on_internal_error(cfg->abort_on_internal_error());
 
+            smp::invoke_on_all([frequency = cfg->cpu_profiler_frequency()] {
+                utils::cpu_profiler::set_frequency(frequency);
+            }).get();
+
             supervisor::notify("starting tokens manager");
             token_metadata.start([] () noexcept { return db::schema_tables::hold_merge_lock(); }).get();
             // storage_proxy holds a reference on it and is not yet stopped.
@@ -746,7 +762,16 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             dbcfg.gossip_scheduling_group = make_sched_group("gossip", 1000);
             dbcfg.available_memory = memory::stats().total_memory();
 
+            // Runs the CPU-heavy work which would stall the reactors, like
+            // training compression dictionaries and hashing passwords.
+            // Shared by all shards, so its threads bound that work node-wide.
+            // Destroyed, which waits for the work it still has, when this
+            // function returns, before the reactors stop.
+            utils::alien_worker alien_worker(std::max(1u, smp::count / 4), 10);
+            dbcfg.alien_worker = &alien_worker;
+
             netw::messaging_service::config mscfg;
+            mscfg.alien_worker = &alien_worker;
 
             mscfg.ip = utils::resolve(cfg->listen_address, family).get0();
             mscfg.port = cfg->storage_port();
@@ -771,6 +796,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             } else if (compress_what == "dc") {
                 mscfg.compress = netw::messaging_service::compress_what::dc;
             }
+            mscfg.compression_dictionaries = cfg->internode_compression_dictionaries();
+            mscfg.compression_dictionary_refresh_period = std::chrono::seconds(cfg->internode_compression_dictionary_refresh_period_in_s());
 
             if (!cfg->inter_dc_tcp_nodelay()) {
                 mscfg.tcp_nodelay = netw::messaging_service::tcp_nodelay_what::local;
@@ -871,6 +898,12 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             utils::directories::set dir_set;
             dir_set.add(cfg->data_file_directories());
             dir_set.add(cfg->commitlog_directory());
+            if (!cfg->commitlog_overflow_directory().empty()) {
+                dir_set.add(cfg->commitlog_overflow_directory());
+            }
+            if (cfg->enable_reader_spilling()) {
+                dir_set.add(cfg->reader_spill_directory());
+            }
             dirs.emplace(cfg->developer_mode());
             dirs->create_and_verify(std::move(dir_set)).get();
 
@@ -949,7 +982,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 mm.stop().get();
             });
             supervisor::notify("starting query processor");
-            cql3::query_processor::memory_config qp_mcfg = {memory::stats().total_memory() / 256, memory::stats().total_memory() / 2560};
+            cql3::query_processor::memory_config qp_mcfg = {memory::stats().total_memory() / 256, memory::stats().total_memory() / 2560, memory::stats().total_memory() / 2560};
             debug::the_query_processor = &qp;
             auto local_data_dict = seastar::sharded_parameter([] (const replica::database& db) { return db.as_data_dictionary(); }, std::ref(db));
             qp.start(std::ref(proxy), std::ref(forward_service), std::move(local_data_dict), std::ref(mm_notifier), std::ref(mm), qp_mcfg, std::ref(cql_config)).get();
@@ -1194,6 +1227,22 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
              */
             db.local().enable_autocompaction_toggle();
 
+            // Before listening, so that the nodes which see this one alive
+            // once it joins get answers to their pings. Pinging only starts
+            // once the cluster features are known.
+            supervisor::notify("starting direct failure detector");
+            direct_fd.start(std::ref(gossiper), std::ref(messaging), std::ref(feature_service), std::ref(*cfg)).get();
+            auto stop_direct_fd = defer_verbose_shutdown("direct failure detector", [&direct_fd, &proxy] {
+                proxy.invoke_on_all([] (service::storage_proxy& local_proxy) {
+                    local_proxy.set_direct_failure_detector(nullptr);
+                }).get();
+                direct_fd.stop().get();
+            });
+            direct_fd.invoke_on_all(&gms::direct_failure_detector::start).get();
+            proxy.invoke_on_all([&direct_fd] (service::storage_proxy& local_proxy) {
+                local_proxy.set_direct_failure_detector(&direct_fd.local());
+            }).get();
+
             with_scheduling_group(maintenance_scheduling_group, [&] {
                 return messaging.invoke_on_all(&netw::messaging_service::start_listen);
             }).get();
@@ -1243,7 +1292,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             auth_config.authenticator_java_name = qualified_authenticator_name;
             auth_config.role_manager_java_name = qualified_role_manager_name;
 
-            auth_service.start(perm_cache_config, std::ref(qp), std::ref(mm_notifier), std::ref(mm), auth_config).get();
+            auth_service.start(perm_cache_config, std::ref(qp), std::ref(mm_notifier), std::ref(mm), std::ref(alien_worker), auth_config).get();
 
             auth_service.invoke_on_all([&mm] (auth::service& auth) {
                 return auth.start(mm.local());
@@ -1287,6 +1336,18 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             );
             cf_cache_hitrate_calculator.local().run_on(this_shard_id());
 
+            supervisor::notify("starting cache saver");
+            cache_saver.start(std::ref(db), service::cache_saver::config{
+                .directory = cfg->saved_caches_directory(),
+                .save_period = std::chrono::seconds(cfg->row_cache_save_period()),
+                .keys_to_save = cfg->row_cache_keys_to_save(),
+                .sched_group = maintenance_scheduling_group,
+            }).get();
+            auto stop_cache_saver = defer_verbose_shutdown("cache saver", [&cache_saver] {
+                cache_saver.stop().get();
+            });
+            cache_saver.invoke_on_all(&service::cache_saver::start).get();
+
             supervisor::notify("starting view update backlog broker");
             static sharded<service::view_update_backlog_broker> view_backlog_broker;
             view_backlog_broker.start(std::ref(proxy), std::ref(gms::get_gossiper())).get();
@@ -1342,6 +1403,9 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 db.revert_initial_system_read_concurrency_boost();
             }).get();
 
+            supervisor::notify("loading prepared statements");
+            qp.local().load_remembered_statements().get();
+
             cql_transport::controller cql_server_ctl(auth_service, mm_notifier, gossiper, qp, service_memory_limiter, sl_controller, lifecycle_notifier, *cfg);
 
             ss.local().register_protocol_server(cql_server_ctl);
@@ -1495,6 +1559,8 @@ int main(int ac, char** av) {
         main_func = tools::scylla_types_main;
     } else if (exec_name == "sstable") {
         main_func = tools::scylla_sstable_main;
+    } else if (exec_name == "compaction-simulator") {
+        main_func = tools::scylla_compaction_simulator_main;
     } else if (exec_name.empty() || exec_name[0] == '-') {
         main_func = scylla_main;
         recognized = false;
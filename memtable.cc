@@ -110,6 +110,75 @@ void memtable::memtable_encoding_stats_collector::update(const ::schema& s, cons
     }
 }
 
+// Builds a write of the memtable's schema to a partition already in the
+// memtable, like partition_builder, but leaves out the cells which lose to
+// those of the latest version of the entry, since merging would drop them
+// anyway. So rows which are overwritten with older data over and over don't
+// have it copied into the memtable.
+//
+// The write is still built in a separate mutation_partition, which is then
+// merged into the entry with strong exception guarantees, so a failed write
+// leaves no trace in the memtable.
+class memtable::overwrite_builder final : public mutation_partition_visitor {
+    const schema& _s;
+    const mutation_partition& _existing;
+    mutation_partition& _p;
+    const row* _existing_row = nullptr;
+    deletable_row* _current_row = nullptr;
+
+    bool is_shadowed(const row* existing, const column_definition& def, atomic_cell_view cell) const {
+        if (!existing || def.is_counter()) {
+            return false;
+        }
+        auto* c = existing->find_cell(def.id);
+        return c && compare_atomic_cell_for_merge(c->as_atomic_cell(def), cell) >= 0;
+    }
+public:
+    overwrite_builder(const schema& s, const mutation_partition& existing, mutation_partition& p)
+        : _s(s)
+        , _existing(existing)
+        , _p(p)
+    { }
+
+    virtual void accept_partition_tombstone(tombstone t) override {
+        _p.apply(t);
+    }
+
+    virtual void accept_static_cell(column_id id, atomic_cell_view cell) override {
+        auto& def = _s.static_column_at(id);
+        if (!is_shadowed(&_existing.static_row().get(), def, cell)) {
+            _p.static_row().maybe_create().append_cell(id, atomic_cell_or_collection(atomic_cell(*def.type, cell)));
+        }
+    }
+
+    virtual void accept_static_cell(column_id id, collection_mutation_view collection) override {
+        _p.static_row().maybe_create().append_cell(id, collection_mutation(*_s.static_column_at(id).type, std::move(collection)));
+    }
+
+    virtual void accept_row_tombstone(const range_tombstone& rt) override {
+        _p.apply_row_tombstone(_s, rt);
+    }
+
+    virtual void accept_row(position_in_partition_view key, const row_tombstone& deleted_at, const row_marker& rm, is_dummy dummy, is_continuous continuous) override {
+        deletable_row& r = _p.append_clustered_row(_s, key, dummy, continuous);
+        r.apply(rm);
+        r.apply(deleted_at);
+        _current_row = &r;
+        _existing_row = dummy ? nullptr : _existing.find_row(_s, key.key());
+    }
+
+    virtual void accept_row_cell(column_id id, atomic_cell_view cell) override {
+        auto& def = _s.regular_column_at(id);
+        if (!is_shadowed(_existing_row, def, cell)) {
+            _current_row->cells().append_cell(id, atomic_cell_or_collection(atomic_cell(*def.type, cell)));
+        }
+    }
+
+    virtual void accept_row_cell(column_id id, collection_mutation_view collection) override {
+        _current_row->cells().append_cell(id, collection_mutation(*_s.regular_column_at(id).type, std::move(collection)));
+    }
+};
+
 memtable::memtable(schema_ptr schema, dirty_memory_manager& dmm, replica::table_stats& table_stats,
     memtable_list* memtable_list, seastar::scheduling_group compaction_scheduling_group)
         : logalloc::region(dmm.region_group())
@@ -232,6 +301,10 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
     return i->partition();
 }
 
+bool memtable::contains_partition(const dht::decorated_key& key) const {
+    return !slice(dht::partition_range::make_singular(key)).empty();
+}
+
 boost::iterator_range<memtable::partitions_type::const_iterator>
 memtable::slice(const dht::partition_range& range) const {
     if (query::is_single_partition(range)) {
@@ -574,14 +647,16 @@ class partition_snapshot_flush_accounter {
 
     void operator()(const partition_end& eop) {}
 
-    void operator()(const clustering_row& cr) {
-        // Every clustering row is stored in a rows_entry object, and that has some significant
-        // overhead - so add it here. We will be a bit short on our estimate because we can't know
-        // what is the size in the allocator for this rows_entry object: we may have many snapshots,
-        // and we don't know which one(s) contributed to the generation of this mutation fragment.
-        //
-        // We will add the size of the struct here, and that should be good enough.
-        _accounter.update_bytes_read(sizeof(rows_entry) + cr.minimal_external_memory_usage(_schema));
+    // Clustering rows are accounted in on_rows_read() instead.
+    void operator()(const clustering_row& cr) {}
+
+    // Called with the memory footprint of the rows_entry objects, from all the versions
+    // of the snapshot, which were merged into the clustering rows read so far. Each
+    // rows_entry is visited exactly once, so the memory of a large partition is released
+    // to the dirty memory manager row by row, as it is written, and close to its real
+    // size, rather than in a lump when the flush of the whole memtable completes.
+    void on_rows_read(uint64_t delta) {
+        _accounter.update_bytes_read(delta);
     }
 };
 
@@ -613,9 +688,9 @@ class flush_reader final : public flat_mutation_reader::impl, private iterator_r
     flat_mutation_reader_opt _partition_reader;
     flush_memory_accounter _flushed_memory;
 public:
-    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m)
+    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m, const dht::partition_range& range)
         : impl(s, std::move(permit))
-        , iterator_reader(std::move(s), m, query::full_partition_range)
+        , iterator_reader(std::move(s), m, range)
         , _flushed_memory(*m)
     {}
     flush_reader(const flush_reader&) = delete;
@@ -739,15 +814,48 @@ memtable::make_flat_reader(schema_ptr s,
 
 flat_mutation_reader
 memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc) {
+    return make_flush_reader(std::move(s), std::move(permit), pc, query::full_partition_range);
+}
+
+flat_mutation_reader
+memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc, const dht::partition_range& range) {
     if (group()) {
-        return make_flat_mutation_reader<flush_reader>(std::move(s), std::move(permit), shared_from_this());
+        return make_flat_mutation_reader<flush_reader>(std::move(s), std::move(permit), shared_from_this(), range);
     } else {
         auto& full_slice = s->full_slice();
         return make_flat_mutation_reader<scanning_reader>(std::move(s), shared_from_this(), std::move(permit),
-            query::full_partition_range, full_slice, pc, mutation_reader::forwarding::no);
+            range, full_slice, pc, mutation_reader::forwarding::no);
     }
 }
 
+dht::partition_range_vector
+memtable::split_for_flush(unsigned n) const {
+    dht::partition_range_vector ranges;
+    if (n <= 1 || partitions.empty()) {
+        ranges.push_back(query::full_partition_range);
+        return ranges;
+    }
+    auto last_it = partitions.end();
+    --last_it;
+    int64_t first = dht::token::to_int64(partitions.begin()->key().token());
+    int64_t last = dht::token::to_int64(last_it->key().token());
+
+    std::optional<dht::partition_range::bound> start;
+    std::optional<int64_t> prev;
+    for (unsigned i = 1; i < n; ++i) {
+        auto split = first + int64_t((__int128(last) - first) * i / n);
+        if (split == last || split == prev) {
+            continue;
+        }
+        auto t = dht::token::from_int64(split);
+        ranges.emplace_back(std::move(start), dht::partition_range::bound(dht::ring_position::ending_at(t), true));
+        start = dht::partition_range::bound(dht::ring_position::ending_at(t), false);
+        prev = split;
+    }
+    ranges.emplace_back(std::move(start), std::nullopt);
+    return ranges;
+}
+
 void
 memtable::update(db::rp_handle&& h) {
     db::replay_position rp = h;
@@ -784,9 +892,21 @@ memtable::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_han
     with_allocator(allocator(), [this, &m, &m_schema] {
         _allocating_section(*this, [&, this] {
             auto& p = find_or_create_partition_slow(m.key());
+            // Most writes are to partitions which aren't in the memtable yet, build
+            // those in place rather than merging a copy into the empty entry.
+            if (m_schema->version() == _schema->version() && p.is_empty_and_unshared()) {
+                p.build(*_schema, m.partition(), _table_stats.memtable_app_stats);
+                _stats_collector.update(*_schema, p.version()->partition());
+                return;
+            }
             mutation_partition mp(m_schema);
-            partition_builder pb(*m_schema, mp);
-            m.partition().accept(*m_schema, pb);
+            if (m_schema->version() == _schema->version()) {
+                overwrite_builder ob(*_schema, p.version()->partition(), mp);
+                m.partition().accept(*_schema, ob);
+            } else {
+                partition_builder pb(*m_schema, mp);
+                m.partition().accept(*m_schema, pb);
+            }
             _stats_collector.update(*m_schema, mp);
             p.apply(*_schema, std::move(mp), *m_schema, _table_stats.memtable_app_stats);
         });
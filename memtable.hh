@@ -152,6 +152,8 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
         }
     } _stats_collector;
 
+    class overwrite_builder;
+
     void update(db::rp_handle&&);
     friend class row_cache;
     friend class memtable_entry;
@@ -225,6 +227,7 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
     }
 
     size_t partition_count() const { return nr_partitions; }
+    bool contains_partition(const dht::decorated_key& key) const;
     logalloc::occupancy_stats occupancy() const;
 
     // Creates a reader of data in this memtable for given partition range.
@@ -253,9 +256,23 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
 
     flat_mutation_reader make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc);
 
+    // Creates a flush reader of the partitions in the given range only, so a
+    // memtable can be flushed by several readers, each of a disjoint range.
+    //
+    // The 'range' parameter must be live as long as the reader is being used.
+    flat_mutation_reader make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc, const dht::partition_range& range);
+
+    // Splits the ring into at most n disjoint ranges which together cover all
+    // partitions of the memtable, by dividing the tokens between its first and
+    // last partitions evenly. Tokens are uniformly distributed, so the ranges
+    // hold similar numbers of partitions.
+    dht::partition_range_vector split_for_flush(unsigned n) const;
+
     mutation_source as_data_source();
 
     bool empty() const { return partitions.empty(); }
+    // Whether the memtable has partitions in the range.
+    bool has_partitions_in(const dht::partition_range& r) const { return !slice(r).empty(); }
     void mark_flushed(mutation_source) noexcept;
     bool is_flushed() const;
     void on_detach_from_region_group() noexcept;
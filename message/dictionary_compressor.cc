@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/do_with.hh>
+#include <zstd.h>
+
+#include "message/dictionary_compressor.hh"
+#include "compress.hh"
+#include "bytes.hh"
+#include "log.hh"
+#include "utils/alien_worker.hh"
+
+namespace netw {
+
+static logging::logger dclogger("dictionary_compressor");
+
+const sstring dictionary_compressor_factory::name = "ZSTD_DICT";
+
+namespace {
+
+enum class frame_flags : uint8_t {
+    none = 0,
+    // The frame starts with the dictionary it (and all frames after it) is
+    // compressed with, as a 32-bit little endian length followed by the
+    // raw dictionary.
+    new_dictionary = 1,
+};
+
+struct zstd_deleter {
+    void operator()(ZSTD_CCtx* p) const noexcept { ZSTD_freeCCtx(p); }
+    void operator()(ZSTD_DCtx* p) const noexcept { ZSTD_freeDCtx(p); }
+    void operator()(ZSTD_CDict* p) const noexcept { ZSTD_freeCDict(p); }
+    void operator()(ZSTD_DDict* p) const noexcept { ZSTD_freeDDict(p); }
+};
+
+template <typename T>
+using zstd_ptr = std::unique_ptr<T, zstd_deleter>;
+
+void check_zstd(size_t ret, const char* what) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("RPC {} failure: {}", what, ZSTD_getErrorName(ret)));
+    }
+}
+
+// Calls func for the contents of each fragment of an RPC buffer.
+template <typename Buf, typename Func>
+void for_each_fragment(const Buf& buf, Func&& func) {
+    size_t remaining = buf.size;
+    auto visit = [&] (const temporary_buffer<char>& b) {
+        auto n = std::min(remaining, b.size());
+        if (n) {
+            func(std::string_view(b.get(), n));
+        }
+        remaining -= n;
+    };
+    if (auto* b = std::get_if<temporary_buffer<char>>(&buf.bufs)) {
+        visit(*b);
+    } else {
+        for (auto& b : std::get<std::vector<temporary_buffer<char>>>(buf.bufs)) {
+            visit(b);
+        }
+    }
+}
+
+// Collects the output of a zstd stream into RPC-sized fragments.
+class fragmented_output {
+    std::vector<temporary_buffer<char>> _bufs;
+    temporary_buffer<char> _current;
+    ZSTD_outBuffer _out = {nullptr, 0, 0};
+    size_t _size = 0;
+public:
+    explicit fragmented_output(size_t first_size)
+        : _current(first_size)
+        , _out{_current.get_write(), _current.size(), 0}
+    {}
+
+    ZSTD_outBuffer& out() {
+        if (_out.pos == _out.size) {
+            finish_current();
+            _current = temporary_buffer<char>(rpc::snd_buf::chunk_size);
+            _out = {_current.get_write(), _current.size(), 0};
+        }
+        return _out;
+    }
+
+    // For writing the frame header, which fits in the first fragment.
+    char* skip(size_t n) {
+        auto p = _current.get_write() + _out.pos;
+        _out.pos += n;
+        return p;
+    }
+
+    template <typename Buf>
+    Buf finish() && {
+        finish_current();
+        if (_bufs.size() == 1) {
+            return Buf(std::move(_bufs.front()));
+        }
+        return Buf(std::move(_bufs), _size);
+    }
+private:
+    void finish_current() {
+        _current.trim(_out.pos);
+        _size += _out.pos;
+        _bufs.push_back(std::move(_current));
+    }
+};
+
+// Reads the beginning of a received frame, which may span fragments.
+class fragmented_input {
+    std::vector<std::string_view> _fragments;
+    size_t _idx = 0;
+public:
+    explicit fragmented_input(const rpc::rcv_buf& buf) {
+        for_each_fragment(buf, [&] (std::string_view f) {
+            _fragments.push_back(f);
+        });
+    }
+
+    void read(char* out, size_t n) {
+        while (n) {
+            if (_idx == _fragments.size()) {
+                throw std::runtime_error("RPC decompression failure: truncated frame");
+            }
+            auto& f = _fragments[_idx];
+            auto k = std::min(n, f.size());
+            out = std::copy_n(f.data(), k, out);
+            f.remove_prefix(k);
+            n -= k;
+            if (f.empty()) {
+                ++_idx;
+            }
+        }
+    }
+
+    template <typename Func>
+    void for_each_remaining(Func&& func) {
+        for (; _idx < _fragments.size(); ++_idx) {
+            func(_fragments[_idx]);
+        }
+    }
+};
+
+// The samples of a sending direction, and the dictionary trained from them.
+// Shared with the training, which may outlive the connection.
+struct training_state {
+    const dictionary_compressor_factory& factory;
+    std::vector<bytes> samples;
+    size_t samples_size = 0;
+    bool training = false;
+    bytes unsent_dictionary;
+
+    explicit training_state(const dictionary_compressor_factory& f) : factory(f) {}
+    ~training_state() {
+        release_samples();
+    }
+
+    void release_samples() noexcept {
+        factory.release_samples(samples_size);
+        samples.clear();
+        samples_size = 0;
+    }
+};
+
+class dictionary_compressor final : public rpc::compressor {
+    const dictionary_compressor_factory& _factory;
+    const dictionary_compressor_factory::config& _cfg;
+
+    // Sending direction.
+    zstd_ptr<ZSTD_CCtx> _cctx;
+    zstd_ptr<ZSTD_CDict> _cdict;
+    lw_shared_ptr<training_state> _training;
+    lowres_clock::time_point _last_training;
+    bool _trained = false;
+
+    // Receiving direction.
+    zstd_ptr<ZSTD_DCtx> _dctx;
+    zstd_ptr<ZSTD_DDict> _ddict;
+public:
+    explicit dictionary_compressor(const dictionary_compressor_factory& factory)
+        : _factory(factory)
+        , _cfg(factory.get_config())
+        , _cctx(ZSTD_createCCtx())
+        , _training(make_lw_shared<training_state>(factory))
+        , _dctx(ZSTD_createDCtx())
+    {
+        if (!_cctx || !_dctx) {
+            throw std::bad_alloc();
+        }
+        check_zstd(ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_compressionLevel, _cfg.compression_level), "compression");
+    }
+
+    virtual rpc::snd_buf compress(size_t head_space, rpc::snd_buf data) override {
+        sample(data);
+        maybe_train();
+
+        auto dict = std::exchange(_training->unsent_dictionary, bytes());
+        if (!dict.empty()) {
+            _cdict.reset(ZSTD_createCDict(dict.data(), dict.size(), _cfg.compression_level));
+            if (!_cdict) {
+                throw std::bad_alloc();
+            }
+        }
+        size_t header_size = 1 + (dict.empty() ? 0 : sizeof(uint32_t) + dict.size());
+        fragmented_output output(head_space + header_size + rpc::snd_buf::chunk_size);
+        output.skip(head_space);
+        auto p = output.skip(header_size);
+        *p++ = char(dict.empty() ? frame_flags::none : frame_flags::new_dictionary);
+        if (!dict.empty()) {
+            write_le<uint32_t>(p, dict.size());
+            std::copy(dict.begin(), dict.end(), p + sizeof(uint32_t));
+        }
+
+        check_zstd(ZSTD_CCtx_reset(_cctx.get(), ZSTD_reset_session_only), "compression");
+        check_zstd(ZSTD_CCtx_refCDict(_cctx.get(), _cdict.get()), "compression");
+        check_zstd(ZSTD_CCtx_setPledgedSrcSize(_cctx.get(), data.size), "compression");
+        for_each_fragment(data, [&] (std::string_view f) {
+            ZSTD_inBuffer in = {f.data(), f.size(), 0};
+            while (in.pos < in.size) {
+                check_zstd(ZSTD_compressStream2(_cctx.get(), &output.out(), &in, ZSTD_e_continue), "compression");
+            }
+        });
+        ZSTD_inBuffer empty = {nullptr, 0, 0};
+        size_t ret;
+        do {
+            ret = ZSTD_compressStream2(_cctx.get(), &output.out(), &empty, ZSTD_e_end);
+            check_zstd(ret, "compression");
+        } while (ret);
+        return std::move(output).finish<rpc::snd_buf>();
+    }
+
+    virtual rpc::rcv_buf decompress(rpc::rcv_buf data) override {
+        fragmented_input input(data);
+        char flags;
+        input.read(&flags, 1);
+        if (frame_flags(flags) == frame_flags::new_dictionary) {
+            char len[sizeof(uint32_t)];
+            input.read(len, sizeof(len));
+            bytes dict(bytes::initialized_later(), read_le<uint32_t>(len));
+            input.read(reinterpret_cast<char*>(dict.data()), dict.size());
+            _ddict.reset(ZSTD_createDDict(dict.data(), dict.size()));
+            if (!_ddict) {
+                throw std::bad_alloc();
+            }
+        } else if (frame_flags(flags) != frame_flags::none) {
+            throw std::runtime_error(format("RPC decompression failure: unknown frame flags {}", int(flags)));
+        }
+
+        check_zstd(ZSTD_DCtx_reset(_dctx.get(), ZSTD_reset_session_only), "decompression");
+        check_zstd(ZSTD_DCtx_refDDict(_dctx.get(), _ddict.get()), "decompression");
+        fragmented_output output(rpc::snd_buf::chunk_size);
+        size_t ret = 1;
+        input.for_each_remaining([&] (std::string_view f) {
+            ZSTD_inBuffer in = {f.data(), f.size(), 0};
+            while (in.pos < in.size) {
+                ret = ZSTD_decompressStream(_dctx.get(), &output.out(), &in);
+                check_zstd(ret, "decompression");
+            }
+        });
+        // The decompressor may hold back output which didn't fit.
+        while (ret) {
+            auto& out = output.out();
+            auto pos = out.pos;
+            ZSTD_inBuffer empty = {nullptr, 0, 0};
+            ret = ZSTD_decompressStream(_dctx.get(), &out, &empty);
+            check_zstd(ret, "decompression");
+            if (ret && out.pos == pos) {
+                throw std::runtime_error("RPC decompression failure: truncated frame");
+            }
+        }
+        return std::move(output).finish<rpc::rcv_buf>();
+    }
+
+    virtual sstring name() const override {
+        return dictionary_compressor_factory::name;
+    }
+private:
+    bool training_due() const {
+        return !_trained || lowres_clock::now() - _last_training >= _cfg.refresh_period;
+    }
+
+    void sample(const rpc::snd_buf& data) {
+        auto& t = *_training;
+        // Sample only when a dictionary is due, so that it reflects the data
+        // sent just before it is trained, and the samples don't take memory
+        // in the meantime.
+        if (!data.size || t.training || t.samples_size >= _cfg.max_samples_size || !training_due()) {
+            return;
+        }
+        auto size = std::min<size_t>(data.size, _cfg.max_sample_size);
+        if (!_factory.try_reserve_samples(size)) {
+            return;
+        }
+        bytes s(bytes::initialized_later(), size);
+        auto out = s.begin();
+        for_each_fragment(data, [&] (std::string_view f) {
+            auto n = std::min<size_t>(f.size(), s.end() - out);
+            out = std::copy_n(reinterpret_cast<const int8_t*>(f.data()), n, out);
+        });
+        t.samples_size += s.size();
+        t.samples.push_back(std::move(s));
+    }
+
+    void maybe_train() {
+        auto& t = *_training;
+        if (t.training || t.samples_size < _cfg.max_samples_size) {
+            return;
+        }
+        // If another connection is training, keep the samples and try again
+        // with the next frame.
+        auto started = _factory.try_train(std::vector<bytes_view>(t.samples.begin(), t.samples.end()), [t = _training] (future<bytes> f) {
+            t->training = false;
+            t->release_samples();
+            if (f.failed()) {
+                dclogger.warn("Failed to train an RPC compression dictionary: {}", f.get_exception());
+                return;
+            }
+            auto dict = f.get();
+            if (!dict.empty()) {
+                t->unsent_dictionary = std::move(dict);
+            }
+        });
+        if (started) {
+            t.training = true;
+            _last_training = lowres_clock::now();
+            _trained = true;
+        }
+    }
+};
+
+}
+
+dictionary_compressor_factory::dictionary_compressor_factory(utils::alien_worker& worker, config cfg)
+    : _worker(worker)
+    , _cfg(std::move(cfg))
+{}
+
+const sstring& dictionary_compressor_factory::supported() const {
+    return name;
+}
+
+std::unique_ptr<rpc::compressor> dictionary_compressor_factory::negotiate(sstring feature, bool is_server) const {
+    return feature == name ? make_compressor() : nullptr;
+}
+
+std::unique_ptr<rpc::compressor> dictionary_compressor_factory::make_compressor() const {
+    return std::make_unique<dictionary_compressor>(*this);
+}
+
+future<> dictionary_compressor_factory::stop() {
+    return _gate.close();
+}
+
+bool dictionary_compressor_factory::try_reserve_samples(size_t size) const noexcept {
+    if (_samples_size + size > _cfg.max_shard_samples_size) {
+        return false;
+    }
+    _samples_size += size;
+    return true;
+}
+
+void dictionary_compressor_factory::release_samples(size_t size) const noexcept {
+    _samples_size -= size;
+}
+
+bool dictionary_compressor_factory::try_train(std::vector<bytes_view> samples, noncopyable_function<void (future<bytes>)> done) const {
+    if (_gate.is_closed()) {
+        return false;
+    }
+    auto units = try_get_units(_trainings, 1);
+    if (!units) {
+        return false;
+    }
+    // The samples are only read by the worker; they stay on this shard.
+    (void)with_gate(_gate, [&worker = _worker, max_size = _cfg.max_dictionary_size, samples = std::move(samples), done = std::move(done)] () mutable {
+        return do_with(std::move(samples), [&worker, max_size] (const std::vector<bytes_view>& samples) {
+            return worker.submit<bytes>([max_size, &samples] {
+                return ::compressor::train_dictionary(samples, max_size);
+            });
+        }).then_wrapped(std::move(done));
+    }).finally([units = std::move(*units)] {});
+    return true;
+}
+
+}
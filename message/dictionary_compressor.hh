@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/rpc/rpc_types.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "bytes.hh"
+#include "seastarx.hh"
+
+namespace utils {
+class alien_worker;
+}
+
+namespace netw {
+
+// An RPC compressor which compresses each frame with zstd against a
+// dictionary trained on the frames previously sent on the same connection.
+//
+// Frames exchanged between nodes are mostly small mutations and results
+// encoded with the same few schemas, which compress poorly on their own but
+// very well against a dictionary of their common substrings.
+//
+// Each direction of a connection has its own dictionary. The sender samples
+// its outgoing frames, trains a dictionary from them once it has enough
+// samples (and then again each refresh_period, to follow changes in the
+// workload), and sends the new dictionary in-band, in front of the first
+// frame compressed with it. Frames are decompressed in the order they were
+// compressed, so the receiver always knows which dictionary a frame needs,
+// and both sides never have to agree on anything beyond this compressor's
+// name, which the RPC layer negotiates when connecting.
+//
+// Training runs on a worker thread, off the reactor; the frames sent in the
+// meantime use the previous dictionary. The connections of a shard share a
+// budget for their samples, and train one at a time.
+class dictionary_compressor_factory : public rpc::compressor::factory {
+public:
+    struct config {
+        // Minimum time between training two dictionaries for a connection.
+        std::chrono::seconds refresh_period = std::chrono::seconds(600);
+        // How much of the data sent on a connection is sampled for training.
+        size_t max_samples_size = 256 * 1024;
+        // How much memory the samples of all connections of a shard may take.
+        size_t max_shard_samples_size = 4 << 20;
+        size_t max_sample_size = 4096;
+        size_t max_dictionary_size = 64 * 1024;
+        int compression_level = 3;
+    };
+    static const sstring name;
+private:
+    utils::alien_worker& _worker;
+    config _cfg;
+    // Shared by the compressors of this shard, which the RPC layer creates
+    // through the const interface.
+    mutable size_t _samples_size = 0;
+    mutable semaphore _trainings{1};
+    mutable gate _gate;
+public:
+    // Dictionaries are trained on worker.
+    explicit dictionary_compressor_factory(utils::alien_worker& worker, config cfg = {});
+
+    // Waits for the dictionaries being trained.
+    future<> stop();
+
+    const config& get_config() const noexcept { return _cfg; }
+
+    // Takes size bytes of the shard's sample budget, if there are as many left.
+    bool try_reserve_samples(size_t size) const noexcept;
+    void release_samples(size_t size) const noexcept;
+
+    // Trains a dictionary from samples in the background, and passes it to
+    // done, unless another connection of this shard is training one already
+    // or the factory is stopping. The samples must stay alive until done
+    // is called.
+    bool try_train(std::vector<bytes_view> samples, noncopyable_function<void (future<bytes>)> done) const;
+
+    virtual const sstring& supported() const override;
+    virtual std::unique_ptr<rpc::compressor> negotiate(sstring feature, bool is_server) const override;
+
+    std::unique_ptr<rpc::compressor> make_compressor() const;
+};
+
+}
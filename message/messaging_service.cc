@@ -84,6 +84,7 @@
 #include <seastar/rpc/lz4_compressor.hh>
 #include <seastar/rpc/lz4_fragmented_compressor.hh>
 #include <seastar/rpc/multi_algo_compressor_factory.hh>
+#include "message/dictionary_compressor.hh"
 #include "partition_range_compat.hh"
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/indirected.hpp>
@@ -91,6 +92,7 @@
 #include "flat_mutation_reader.hh"
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "locator/snitch_base.hh"
 #include "idl/partition_checksum.dist.impl.hh"
 #include "idl/forward_request.dist.hh"
@@ -113,7 +115,7 @@ using namespace std::chrono_literals;
 
 static rpc::lz4_fragmented_compressor::factory lz4_fragmented_compressor_factory;
 static rpc::lz4_compressor::factory lz4_compressor_factory;
-static rpc::multi_algo_compressor_factory compressor_factory {
+static rpc::multi_algo_compressor_factory default_compressor_factory {
     &lz4_fragmented_compressor_factory,
     &lz4_compressor_factory,
 };
@@ -123,7 +125,7 @@ struct messaging_service::rpc_protocol_server_wrapper : public rpc_protocol::ser
 constexpr int32_t messaging_service::current_version;
 
 // Count of connection types that are not associated with any tenant
-const size_t PER_SHARD_CONNECTION_COUNT = 2;
+const size_t PER_SHARD_CONNECTION_COUNT = 3;
 // Counts per tenant connection types
 const size_t PER_TENANT_CONNECTION_COUNT = 3;
 
@@ -237,7 +239,7 @@ void messaging_service::do_start_listen() {
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != utils::fb_utilities::get_broadcast_address();
     rpc::server_options so;
     if (_cfg.compress != compress_what::none) {
-        so.compressor_factory = &compressor_factory;
+        so.compressor_factory = compressor_factory();
     }
     so.load_balancing_algorithm = server_socket::load_balancing_algorithm::port;
 
@@ -335,6 +337,18 @@ messaging_service::messaging_service(config cfg, scheduling_config scfg, std::sh
 {
     _rpc->set_logger(&rpc_logger);
 
+    if (_cfg.compression_dictionaries) {
+        dictionary_compressor_factory::config dcfg;
+        dcfg.refresh_period = _cfg.compression_dictionary_refresh_period;
+        _dictionary_compressor_factory = std::make_unique<dictionary_compressor_factory>(*_cfg.alien_worker, dcfg);
+        // Nodes which don't know about dictionaries negotiate LZ4.
+        _compressor_factory_with_dictionaries = std::make_unique<rpc::multi_algo_compressor_factory>(std::vector<const rpc::compressor::factory*>{
+            _dictionary_compressor_factory.get(),
+            &lz4_fragmented_compressor_factory,
+            &lz4_compressor_factory,
+        });
+    }
+
     // this initialization should be done before any handler registration
     // this is because register_handler calls to: scheduling_group_for_verb
     // which in turn relies on _connection_index_for_tenant to be initialized.
@@ -360,6 +374,13 @@ msg_addr messaging_service::get_source(const rpc::client_info& cinfo) {
 
 messaging_service::~messaging_service() = default;
 
+const rpc::compressor::factory* messaging_service::compressor_factory() const {
+    if (_compressor_factory_with_dictionaries) {
+        return _compressor_factory_with_dictionaries.get();
+    }
+    return &default_compressor_factory;
+}
+
 uint16_t messaging_service::port() {
     return _cfg.port;
 }
@@ -418,7 +439,7 @@ future<> messaging_service::stop() {
             std::abort();
         }
 
-        return make_ready_future<>();
+        return _dictionary_compressor_factory ? _dictionary_compressor_factory->stop() : make_ready_future<>();
     });
 }
 
@@ -454,6 +475,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPLICATION_FINISHED:
     case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE:
     case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
@@ -472,6 +494,10 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::NODE_OPS_CMD:
     case messaging_verb::HINT_MUTATION:
         return 1;
+    // Pings of the direct failure detector have a connection of their own,
+    // so they don't wait behind gossip or data messages.
+    case messaging_verb::DIRECT_FD_PING:
+        return 2;
     case messaging_verb::CLIENT_ID:
     case messaging_verb::MUTATION:
     case messaging_verb::READ_DATA:
@@ -482,6 +508,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::MIGRATION_REQUEST:
     case messaging_verb::SCHEMA_CHECK:
     case messaging_verb::COUNTER_MUTATION:
+    case messaging_verb::REMOVE_FROM_BATCHLOG:
     // Use the same RPC client for light weight transaction
     // protocol steps as for standard mutations and read requests.
     case messaging_verb::PAXOS_PREPARE:
@@ -499,12 +526,13 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::RAFT_EXECUTE_READ_BARRIER_ON_LEADER:
     case messaging_verb::RAFT_ADD_ENTRY:
     case messaging_verb::RAFT_MODIFY_CONFIG:
-        return 2;
+        return 3;
     case messaging_verb::MUTATION_DONE:
+    case messaging_verb::MUTATION_DONE_BATCH:
     case messaging_verb::MUTATION_FAILED:
-        return 3;
-    case messaging_verb::FORWARD_REQUEST:
         return 4;
+    case messaging_verb::FORWARD_REQUEST:
+        return 5;
     case messaging_verb::LAST:
         return -1; // should never happen
     }
@@ -553,6 +581,7 @@ messaging_service::initial_scheduling_info() const {
     auto sched_infos = std::vector<scheduling_info_for_connection_index>({
         { _scheduling_config.gossip, "gossip" },
         { _scheduling_config.streaming, "streaming", },
+        { _scheduling_config.gossip, "direct-fd" },
     });
 
     sched_infos.reserve(sched_infos.size() +
@@ -718,6 +747,9 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
         if (idx == 1) {
             return true; // gossip
         }
+        if (idx == 2) {
+            return true; // direct failure detector pings
+        }
         if (_cfg.tcp_nodelay == tcp_nodelay_what::local) {
             auto& snitch_ptr = locator::i_endpoint_snitch::get_local_snitch_ptr();
             return snitch_ptr->get_datacenter(id.addr)
@@ -732,7 +764,7 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
     // send keepalive messages each minute if connection is idle, drop connection after 10 failures
     opts.keepalive = std::optional<net::tcp_keepalive_params>({60s, 60s, 10});
     if (must_compress) {
-        opts.compressor_factory = &compressor_factory;
+        opts.compressor_factory = compressor_factory();
     }
     opts.tcp_nodelay = must_tcp_nodelay;
     opts.reuseaddr = true;
@@ -831,6 +863,36 @@ future<> messaging_service::unregister_stream_mutation_fragments() {
     return unregister_handler(messaging_verb::STREAM_MUTATION_FRAGMENTS);
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_files_cmd, bytes>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, bytes>, rpc::source<int32_t>>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, sstring sstable_version, sstring sstable_format, streaming::stream_reason reason,
+        unsigned shard_count, unsigned sharding_ignore_msb, msg_addr id) {
+    using value_type = std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, bytes>, rpc::source<int32_t>>;
+    if (is_shutting_down()) {
+        return make_exception_future<value_type>(rpc::closed_error());
+    }
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    return rpc_client->make_stream_sink<netw::serializer, streaming::stream_sstable_files_cmd, bytes>().then([this, plan_id, schema_id, cf_id, sstable_version, sstable_format, reason, shard_count, sharding_ignore_msb, rpc_client] (rpc::sink<streaming::stream_sstable_files_cmd, bytes> sink) mutable {
+        auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (utils::UUID, utils::UUID, utils::UUID, sstring, sstring, streaming::stream_reason, unsigned, unsigned, rpc::sink<streaming::stream_sstable_files_cmd, bytes>)>(messaging_verb::STREAM_SSTABLE_FILES);
+        return rpc_handler(*rpc_client , plan_id, schema_id, cf_id, sstable_version, sstable_format, reason, shard_count, sharding_ignore_msb, sink).then_wrapped([sink, rpc_client] (future<rpc::source<int32_t>> source) mutable {
+            return (source.failed() ? sink.close() : make_ready_future<>()).then([sink = std::move(sink), source = std::move(source)] () mutable {
+                return make_ready_future<value_type>(value_type(std::move(sink), source.get0()));
+            });
+        });
+    });
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring sstable_version, sstring sstable_format, streaming::stream_reason reason, unsigned shard_count, unsigned sharding_ignore_msb, rpc::source<streaming::stream_sstable_files_cmd, bytes> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
+future<> messaging_service::unregister_stream_sstable_files() {
+    return unregister_handler(messaging_verb::STREAM_SSTABLE_FILES);
+}
+
 template<class SinkType, class SourceType>
 future<std::tuple<rpc::sink<SinkType>, rpc::source<SourceType>>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
@@ -979,6 +1041,16 @@ future<> messaging_service::send_gossip_echo(msg_addr id, int64_t generation_num
     return send_message_timeout<void>(this, messaging_verb::GOSSIP_ECHO, std::move(id), timeout, generation_number);
 }
 
+void messaging_service::register_direct_fd_ping(std::function<future<> ()>&& func) {
+    register_handler(this, messaging_verb::DIRECT_FD_PING, std::move(func));
+}
+future<> messaging_service::unregister_direct_fd_ping() {
+    return unregister_handler(netw::messaging_verb::DIRECT_FD_PING);
+}
+future<> messaging_service::send_direct_fd_ping(msg_addr id, std::chrono::milliseconds timeout) {
+    return send_message_timeout<void>(this, messaging_verb::DIRECT_FD_PING, std::move(id), timeout);
+}
+
 void messaging_service::register_gossip_shutdown(std::function<rpc::no_wait_type (inet_address from, rpc::optional<int64_t> generation_number)>&& func) {
     register_handler(this, messaging_verb::GOSSIP_SHUTDOWN, std::move(func));
 }
@@ -1089,25 +1161,25 @@ future<> messaging_service::send_replication_finished(msg_addr id, inet_address
 }
 
 // Wrapper for REPAIR_GET_FULL_ROW_HASHES
-void messaging_service::register_repair_get_full_row_hashes(std::function<future<repair_hash_set> (const rpc::client_info& cinfo, uint32_t repair_meta_id)>&& func) {
+void messaging_service::register_repair_get_full_row_hashes(std::function<future<repair_hash_set> (const rpc::client_info& cinfo, uint32_t repair_meta_id, rpc::optional<std::vector<uint32_t>> buckets)>&& func) {
     register_handler(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES, std::move(func));
 }
 future<> messaging_service::unregister_repair_get_full_row_hashes() {
     return unregister_handler(messaging_verb::REPAIR_GET_FULL_ROW_HASHES);
 }
-future<repair_hash_set> messaging_service::send_repair_get_full_row_hashes(msg_addr id, uint32_t repair_meta_id) {
-    return send_message<future<repair_hash_set>>(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES, std::move(id), repair_meta_id);
+future<repair_hash_set> messaging_service::send_repair_get_full_row_hashes(msg_addr id, uint32_t repair_meta_id, std::optional<std::vector<uint32_t>> buckets) {
+    return send_message<future<repair_hash_set>>(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES, std::move(id), repair_meta_id, std::move(buckets));
 }
 
 // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
-void messaging_service::register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func) {
+void messaging_service::register_repair_get_combined_row_hash(std::function<future<rpc::tuple<get_combined_row_hash_response, repair_hash_sketch>> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func) {
     register_handler(this, messaging_verb::REPAIR_GET_COMBINED_ROW_HASH, std::move(func));
 }
 future<> messaging_service::unregister_repair_get_combined_row_hash() {
     return unregister_handler(messaging_verb::REPAIR_GET_COMBINED_ROW_HASH);
 }
-future<get_combined_row_hash_response> messaging_service::send_repair_get_combined_row_hash(msg_addr id, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary) {
-    return send_message<future<get_combined_row_hash_response>>(this, messaging_verb::REPAIR_GET_COMBINED_ROW_HASH, std::move(id), repair_meta_id, std::move(common_sync_boundary));
+future<rpc::tuple<get_combined_row_hash_response, rpc::optional<repair_hash_sketch>>> messaging_service::send_repair_get_combined_row_hash(msg_addr id, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary) {
+    return send_message<future<rpc::tuple<get_combined_row_hash_response, rpc::optional<repair_hash_sketch>>>>(this, messaging_verb::REPAIR_GET_COMBINED_ROW_HASH, std::move(id), repair_meta_id, std::move(common_sync_boundary));
 }
 
 void messaging_service::register_repair_get_sync_boundary(std::function<future<get_sync_boundary_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> skipped_sync_boundary)>&& func) {
@@ -1143,14 +1215,14 @@ future<> messaging_service::send_repair_put_row_diff(msg_addr id, uint32_t repai
 }
 
 // Wrapper for REPAIR_ROW_LEVEL_START
-void messaging_service::register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason)>&& func) {
+void messaging_service::register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason, rpc::optional<repair_hash_algorithm> hash_algo)>&& func) {
     register_handler(this, messaging_verb::REPAIR_ROW_LEVEL_START, std::move(func));
 }
 future<> messaging_service::unregister_repair_row_level_start() {
     return unregister_handler(messaging_verb::REPAIR_ROW_LEVEL_START);
 }
-future<rpc::optional<repair_row_level_start_response>> messaging_service::send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason) {
-    return send_message<rpc::optional<repair_row_level_start_response>>(this, messaging_verb::REPAIR_ROW_LEVEL_START, std::move(id), repair_meta_id, std::move(keyspace_name), std::move(cf_name), std::move(range), algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, std::move(remote_partitioner_name), std::move(schema_version), reason);
+future<rpc::optional<repair_row_level_start_response>> messaging_service::send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason, repair_hash_algorithm hash_algo) {
+    return send_message<rpc::optional<repair_row_level_start_response>>(this, messaging_verb::REPAIR_ROW_LEVEL_START, std::move(id), repair_meta_id, std::move(keyspace_name), std::move(cf_name), std::move(range), algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, std::move(remote_partitioner_name), std::move(schema_version), reason, hash_algo);
 }
 
 // Wrapper for REPAIR_ROW_LEVEL_STOP
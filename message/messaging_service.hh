@@ -25,6 +25,7 @@
 #include "digest_algorithm.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "cache_temperature.hh"
 #include "service/paxos/prepare_response.hh"
 #include "raft/raft.hh"
@@ -50,6 +51,7 @@ namespace gms {
 
 namespace utils {
     class UUID;
+    class alien_worker;
 }
 
 namespace db {
@@ -151,7 +153,11 @@ enum class messaging_verb : int32_t {
     REPAIR_UPDATE_SYSTEM_TABLE = 59,
     REPAIR_FLUSH_HINTS_BATCHLOG = 60,
     FORWARD_REQUEST = 61,
-    LAST = 62,
+    STREAM_SSTABLE_FILES = 62,
+    MUTATION_DONE_BATCH = 63,
+    REMOVE_FROM_BATCHLOG = 64,
+    DIRECT_FD_PING = 65,
+    LAST = 66,
 };
 
 } // namespace netw
@@ -170,6 +176,8 @@ namespace netw {
 
 struct serializer {};
 
+class dictionary_compressor_factory;
+
 struct schema_pull_options {
     bool remote_supports_canonical_mutation_retval = true;
 
@@ -239,6 +247,12 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         tcp_nodelay_what tcp_nodelay = tcp_nodelay_what::all;
         bool listen_on_broadcast_address = false;
         size_t rpc_memory_limit = 1'000'000;
+        // Prefer compressing with dictionaries trained on the traffic of
+        // each connection, if the other side supports it. The dictionaries
+        // are trained on alien_worker, which must then be set.
+        bool compression_dictionaries = false;
+        std::chrono::seconds compression_dictionary_refresh_period = std::chrono::seconds(600);
+        utils::alien_worker* alien_worker = nullptr;
     };
 
     struct scheduling_config {
@@ -271,6 +285,8 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     // map: Node broadcast address -> Node internal IP, and the reversed mapping, for communication within the same data center
     std::unordered_map<gms::inet_address, gms::inet_address> _preferred_ip_cache, _preferred_to_endpoint;
     std::unique_ptr<rpc_protocol_wrapper> _rpc;
+    std::unique_ptr<dictionary_compressor_factory> _dictionary_compressor_factory;
+    std::unique_ptr<rpc::compressor::factory> _compressor_factory_with_dictionaries;
     std::array<std::unique_ptr<rpc_protocol_server_wrapper>, 2> _server;
     ::shared_ptr<seastar::tls::server_credentials> _credentials;
     std::unique_ptr<seastar::tls::credentials_builder> _credentials_builder;
@@ -327,6 +343,20 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment, rpc::optional<streaming::stream_mutation_fragments_cmd>>& source);
     future<std::tuple<rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_mutation_fragments(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // Sends all component files of a single sstable, written on a shard of the sender with the given
+    // sharding. Before the sender sends anything, the receiver replies 0 if it accepts the sstable,
+    // or 1 if it declines it (e.g. because its sharding differs, and the sstable could be owned by
+    // more than one of its shards), in which case the contents must be streamed as mutation fragments
+    // instead. After accepting, the receiver replies with the final status: 0 means the sstable
+    // was added, -1 means error and 1 that the sstable was declined after all. -1 may also be the
+    // first reply.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring sstable_version, sstring sstable_format, streaming::stream_reason reason, unsigned shard_count, unsigned sharding_ignore_msb, rpc::source<streaming::stream_sstable_files_cmd, bytes> source)>&& func);
+    future<> unregister_stream_sstable_files();
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_files_cmd, bytes>& source);
+    future<std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, bytes>, rpc::source<int32_t>>> make_sink_and_source_for_stream_sstable_files(utils::UUID schema_id, utils::UUID plan_id, utils::UUID cf_id, sstring sstable_version, sstring sstable_format, streaming::stream_reason reason,
+            unsigned shard_count, unsigned sharding_ignore_msb, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<std::tuple<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
@@ -354,14 +384,14 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_complete_message();
 
     // Wrapper for REPAIR_GET_FULL_ROW_HASHES
-    void register_repair_get_full_row_hashes(std::function<future<repair_hash_set> (const rpc::client_info& cinfo, uint32_t repair_meta_id)>&& func);
+    void register_repair_get_full_row_hashes(std::function<future<repair_hash_set> (const rpc::client_info& cinfo, uint32_t repair_meta_id, rpc::optional<std::vector<uint32_t>> buckets)>&& func);
     future<> unregister_repair_get_full_row_hashes();
-    future<repair_hash_set> send_repair_get_full_row_hashes(msg_addr id, uint32_t repair_meta_id);
+    future<repair_hash_set> send_repair_get_full_row_hashes(msg_addr id, uint32_t repair_meta_id, std::optional<std::vector<uint32_t>> buckets);
 
     // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
-    void register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func);
+    void register_repair_get_combined_row_hash(std::function<future<rpc::tuple<get_combined_row_hash_response, repair_hash_sketch>> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func);
     future<> unregister_repair_get_combined_row_hash();
-    future<get_combined_row_hash_response> send_repair_get_combined_row_hash(msg_addr id, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary);
+    future<rpc::tuple<get_combined_row_hash_response, rpc::optional<repair_hash_sketch>>> send_repair_get_combined_row_hash(msg_addr id, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary);
 
     // Wrapper for REPAIR_GET_SYNC_BOUNDARY
     void register_repair_get_sync_boundary(std::function<future<get_sync_boundary_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> skipped_sync_boundary)>&& func);
@@ -379,9 +409,9 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> send_repair_put_row_diff(msg_addr id, uint32_t repair_meta_id, repair_rows_on_wire row_diff);
 
     // Wrapper for REPAIR_ROW_LEVEL_START
-    void register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason)>&& func);
+    void register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason, rpc::optional<repair_hash_algorithm> hash_algo)>&& func);
     future<> unregister_repair_row_level_start();
-    future<rpc::optional<repair_row_level_start_response>> send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason);
+    future<rpc::optional<repair_row_level_start_response>> send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason, repair_hash_algorithm hash_algo);
 
     // Wrapper for REPAIR_ROW_LEVEL_STOP
     void register_repair_row_level_stop(std::function<future<> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range)>&& func);
@@ -413,6 +443,11 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_gossip_echo();
     future<> send_gossip_echo(msg_addr id, int64_t generation_number, std::chrono::milliseconds timeout);
 
+    // Wrapper for DIRECT_FD_PING verb
+    void register_direct_fd_ping(std::function<future<> ()>&& func);
+    future<> unregister_direct_fd_ping();
+    future<> send_direct_fd_ping(msg_addr id, std::chrono::milliseconds timeout);
+
     // Wrapper for GOSSIP_SHUTDOWN
     void register_gossip_shutdown(std::function<rpc::no_wait_type (inet_address from, rpc::optional<int64_t> generation_number)>&& func);
     future<> unregister_gossip_shutdown();
@@ -488,6 +523,7 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         return _connection_dropped.connect(slot);
     }
     std::unique_ptr<rpc_protocol_wrapper>& rpc();
+    const rpc::compressor::factory* compressor_factory() const;
     static msg_addr get_source(const rpc::client_info& client);
     scheduling_group scheduling_group_for_verb(messaging_verb verb) const;
     scheduling_group scheduling_group_for_isolation_cookie(const sstring& isolation_cookie) const;
@@ -703,8 +703,14 @@ future<page_consume_result<ResultBuilder>> read_page(
     auto compaction_state = make_lw_shared<compact_for_result_state<ResultBuilder>>(*s, cmd.timestamp, cmd.slice, cmd.get_row_limit(),
             cmd.partition_limit);
 
+    // Only for scans which go on to a second page: the first page of most
+    // scans (e.g. with a small LIMIT) is filled from a shard or two, and
+    // reading ahead on all the others would be wasted.
+    const auto parallel_read_ahead = multishard_parallel_read_ahead(ctx->db().local().get_config().multishard_scan_parallel_read_ahead()
+            && cmd.query_uuid != utils::UUID{} && !cmd.is_first_page);
     auto reader = make_multishard_combining_reader_v2(ctx, s, ctx->permit(), ranges.front(), cmd.slice,
-            service::get_local_sstable_query_read_priority(), trace_state, mutation_reader::forwarding(ranges.size() > 1));
+            service::get_local_sstable_query_read_priority(cmd.service_level, cmd.service_level_shares), trace_state,
+            mutation_reader::forwarding(ranges.size() > 1), parallel_read_ahead);
     if (ranges.size() > 1) {
         reader = make_flat_mutation_reader_v2<multi_range_reader>(s, ctx->permit(), std::move(reader), ranges);
     }
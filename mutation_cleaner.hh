@@ -15,15 +15,40 @@
 
 class mutation_cleaner;
 
+struct mutation_cleaner_stats {
+    // Number of snapshots released to the cleaner and the sum of the lengths
+    // of the version chains they were released from.
+    uint64_t released_snapshots = 0;
+    uint64_t released_snapshot_version_chain_length = 0;
+    // Number of snapshots released from chains longer than the eager merge threshold.
+    uint64_t long_version_chains = 0;
+    // Number of merge steps done eagerly, rather than by the background worker, on those chains.
+    uint64_t eager_version_merges = 0;
+
+    mutation_cleaner_stats& operator+=(const mutation_cleaner_stats& o) {
+        released_snapshots += o.released_snapshots;
+        released_snapshot_version_chain_length += o.released_snapshot_version_chain_length;
+        long_version_chains += o.long_version_chains;
+        eager_version_merges += o.eager_version_merges;
+        return *this;
+    }
+};
+
 class mutation_cleaner_impl final {
-    using snapshot_list = boost::intrusive::slist<partition_snapshot,
-        boost::intrusive::member_hook<partition_snapshot, boost::intrusive::slist_member_hook<>, &partition_snapshot::_cleaner_hook>>;
+    using snapshot_list = boost::intrusive::list<partition_snapshot,
+        boost::intrusive::member_hook<partition_snapshot, boost::intrusive::list_member_hook<>, &partition_snapshot::_cleaner_hook>>;
     struct worker {
         condition_variable cv;
         snapshot_list snapshots;
         logalloc::allocating_section alloc_section;
         bool done = false; // true means the worker was abandoned and cannot access the mutation_cleaner_impl instance.
     };
+public:
+    // When a snapshot is released from a version chain longer than this, the snapshots
+    // of the chain which still await merging are merged a bit right away, instead of
+    // leaving it all to the background worker, so that the chains of hot partitions,
+    // which reads have to walk, stay short under heavy overwrite load.
+    static constexpr unsigned eager_merge_version_chain_length = 4;
 private:
     logalloc::region& _region;
     cache_tracker* _tracker;
@@ -31,10 +56,12 @@ class mutation_cleaner_impl final {
     partition_version_list _versions;
     lw_shared_ptr<worker> _worker_state;
     mutation_application_stats& _app_stats;
+    mutation_cleaner_stats _stats;
     seastar::scheduling_group _scheduling_group;
 private:
     stop_iteration merge_some(partition_snapshot& snp) noexcept;
     stop_iteration merge_some() noexcept;
+    void merge_eagerly(partition_version& v) noexcept;
     void start_worker();
 public:
     mutation_cleaner_impl(logalloc::region& r, cache_tracker* t, mutation_cleaner* cleaner,
@@ -62,6 +89,8 @@ class mutation_cleaner_impl final {
         _scheduling_group = sg;
         _worker_state->cv.broadcast();
     }
+    const mutation_cleaner_stats& stats() const noexcept { return _stats; }
+    size_t pending_snapshots() const noexcept { return _worker_state->snapshots.size(); }
 };
 
 inline
@@ -80,6 +109,11 @@ void mutation_cleaner_impl::destroy_gently(partition_version& v) noexcept {
 
 inline
 void mutation_cleaner_impl::merge_and_destroy(partition_snapshot& ps) noexcept {
+    auto chain_length = ps.version()->version_chain_length();
+    ++_stats.released_snapshots;
+    _stats.released_snapshot_version_chain_length += chain_length;
+    bool long_chain = chain_length > eager_merge_version_chain_length;
+    _stats.long_version_chains += long_chain;
     if (ps.slide_to_oldest() == stop_iteration::yes || merge_some(ps) == stop_iteration::yes) {
         lw_shared_ptr<partition_snapshot>::dispose(&ps);
     } else {
@@ -88,6 +122,9 @@ void mutation_cleaner_impl::merge_and_destroy(partition_snapshot& ps) noexcept {
         ps.migrate(&_region, _cleaner);
         _worker_state->snapshots.push_front(ps);
         _worker_state->cv.signal();
+        if (long_chain) {
+            merge_eagerly(*ps.version());
+        }
     }
 }
 
@@ -165,6 +202,15 @@ class mutation_cleaner final {
         return _impl->drain();
     }
 
+    const mutation_cleaner_stats& stats() const noexcept {
+        return _impl->stats();
+    }
+
+    // Returns the number of released snapshots whose versions are waiting to be merged.
+    size_t pending_snapshots() const noexcept {
+        return _impl->pending_snapshots();
+    }
+
     // Will merge given snapshot using partition_snapshot::merge_partition_versions() and then destroys it
     // using destroy_from_this(), possibly deferring in between.
     // This instance becomes the sole owner of the partition_snapshot object, the caller should not destroy it
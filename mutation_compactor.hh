@@ -139,6 +139,7 @@ template<emit_only_live_rows OnlyLive, compact_for_sstables SSTableCompaction>
 class compact_mutation_state {
     const schema& _schema;
     gc_clock::time_point _query_time;
+    gc_before_cursor _gc_before_cursor;
     std::function<api::timestamp_type(const dht::decorated_key&)> _get_max_purgeable;
     can_gc_fn _can_gc;
     api::timestamp_type _max_purgeable = api::missing_timestamp;
@@ -226,12 +227,15 @@ class compact_mutation_state {
         }
     }
 
+    // gc_before is checked first, since it is cheaper to get than the max
+    // purgeable timestamp, and it rules out most tombstones which are either
+    // recent or, with tombstone_gc mode repair, in ranges not repaired yet.
     bool can_purge_tombstone(const tombstone& t) {
-        return can_gc(t) && t.deletion_time < get_gc_before();
+        return t.deletion_time < get_gc_before() && can_gc(t);
     };
 
     bool can_purge_tombstone(const row_tombstone& t) {
-        return can_gc(t.tomb()) && t.max_deletion_time() < get_gc_before();
+        return t.max_deletion_time() < get_gc_before() && can_gc(t.tomb());
     };
 
     gc_clock::time_point get_gc_before() {
@@ -239,7 +243,7 @@ class compact_mutation_state {
             return _gc_before.value();
         } else {
             if (_dk) {
-                _gc_before = ::get_gc_before_for_key(_schema.shared_from_this(), *_dk, _query_time);
+                _gc_before = _gc_before_cursor.get(*_dk);
                 return _gc_before.value();
             } else {
                 return gc_clock::time_point::min();
@@ -272,6 +276,7 @@ class compact_mutation_state {
               uint32_t partition_limit)
         : _schema(s)
         , _query_time(query_time)
+        , _gc_before_cursor(s, query_time)
         , _can_gc(always_gc)
         , _slice(slice)
         , _row_limit(limit)
@@ -287,6 +292,7 @@ class compact_mutation_state {
             std::function<api::timestamp_type(const dht::decorated_key&)> get_max_purgeable)
         : _schema(s)
         , _query_time(compaction_time)
+        , _gc_before_cursor(s, compaction_time)
         , _get_max_purgeable(std::move(get_max_purgeable))
         , _can_gc([this] (tombstone t) { return can_gc(t); })
         , _slice(s.full_slice())
@@ -513,7 +519,10 @@ class compact_mutation_state {
         _partition_limit = partition_limit;
         _rows_in_current_partition = 0;
         _current_partition_limit = std::min(_row_limit, _partition_row_limit);
-        _query_time = query_time;
+        if (query_time != _query_time) {
+            _query_time = query_time;
+            _gc_before_cursor.set_query_time(query_time);
+        }
         _stats = {};
 
         noop_compacted_fragments_consumer nc;
@@ -757,7 +757,8 @@ void appending_hash<row>::operator()(Hasher& h, const row& cells, const schema&
                 if (cell_and_hash->hash) {
                     feed_hash(h, *cell_and_hash->hash);
                 } else {
-                    Hasher cellh;
+                    // Must match the cached hashes, see row::prepare_hash().
+                    query::default_hasher cellh;
                     feed_hash(cellh, cell_and_hash->cell.as_atomic_cell(def), def);
                     feed_hash(h, cellh.finalize_uint64());
                 }
@@ -771,7 +772,7 @@ void appending_hash<row>::operator()(Hasher& h, const row& cells, const schema&
                 if (cell_and_hash->hash) {
                     feed_hash(h, *cell_and_hash->hash);
                 } else {
-                    Hasher cellh;
+                    query::default_hasher cellh;
                     feed_hash(cellh, cm, def);
                     feed_hash(h, cellh.finalize_uint64());
                 }
@@ -783,6 +784,7 @@ void appending_hash<row>::operator()(Hasher& h, const row& cells, const schema&
 }
 // Instantiation for mutation_test.cc
 template void appending_hash<row>::operator()<xx_hasher>(xx_hasher& h, const row& cells, const schema& s, column_kind kind, const query::column_id_vector& columns, max_timestamp& max_ts) const;
+template void appending_hash<row>::operator()<xxh3_hasher>(xxh3_hasher& h, const row& cells, const schema& s, column_kind kind, const query::column_id_vector& columns, max_timestamp& max_ts) const;
 
 template<>
 void appending_hash<row>::operator()<legacy_xx_hasher_without_null_digest>(legacy_xx_hasher_without_null_digest& h, const row& cells, const schema& s, column_kind kind, const query::column_id_vector& columns, max_timestamp& max_ts) const {
@@ -1469,6 +1471,25 @@ row::row(const schema& s, column_kind kind, const row& o) : _size(o._size)
     _cells.clone_from(o._cells, clone_cell_and_hash);
 }
 
+row::row(const schema& s, column_kind kind, const row& o, const std::vector<bool>& values_needed) : _size(o._size)
+{
+    auto clone_cell_and_hash = [&s, &kind, &values_needed] (column_id id, const cell_and_hash& cah) {
+        auto& cdef = s.column_at(kind, id);
+        if (id < values_needed.size() && !values_needed[id] && cdef.is_atomic() && !cdef.is_counter()) {
+            auto acv = cah.cell.as_atomic_cell(cdef);
+            if (acv.is_live()) {
+                auto ac = acv.is_live_and_has_ttl()
+                        ? atomic_cell::make_live(*cdef.type, acv.timestamp(), bytes_view(), acv.expiry(), acv.ttl())
+                        : atomic_cell::make_live(*cdef.type, acv.timestamp(), bytes_view());
+                return cell_and_hash(std::move(ac), cell_hash_opt());
+            }
+        }
+        return cell_and_hash(cah.cell.copy(*cdef.type), cah.hash);
+    };
+
+    _cells.clone_from(o._cells, clone_cell_and_hash);
+}
+
 row::~row() {
 }
 
@@ -1864,10 +1885,38 @@ void mutation_querier::prepare_writers() {
     }
 }
 
+// Whether the compacted cells of a clustering row satisfy the filters of the
+// slice. Filters on columns which can't be filtered here are ignored, the
+// coordinator will apply them.
+static bool satisfies_filters(const schema& s, const query::partition_slice& slice, const row& cells) {
+    for (const query::column_filter& f : slice.filters) {
+        if (f.column >= s.regular_columns_count()) {
+            continue;
+        }
+        auto&& def = s.regular_column_at(f.column);
+        if (!def.is_atomic() || def.is_counter()) {
+            continue;
+        }
+        const atomic_cell_or_collection* cell = cells.find_cell(f.column);
+        if (!cell) {
+            return false;
+        }
+        auto c = cell->as_atomic_cell(def);
+        if (!c.is_live() || !f.is_satisfied_by(*def.type, c.value())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone current_tombstone) {
     prepare_writers();
 
     const query::partition_slice& slice = _pw.slice();
+    // Rows which don't satisfy the filters are still written, so that they
+    // are counted like any other, but without cells: the coordinator would
+    // only throw them away.
+    const bool filtered_out = !slice.filters.empty() && !satisfies_filters(_schema, slice, cr.cells());
 
     if (_pw.requested_digest()) {
         _pw.digest().feed_hash(cr.key(), _schema);
@@ -1886,7 +1935,13 @@ stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone curr
                 return rows_writer.add().skip_key().start_cells().start_cells();
             }
         }();
-        get_compacted_row_slice(_schema, slice, column_kind::regular_column, cr.cells(), slice.regular_columns, cells_wr);
+        if (filtered_out) {
+            for (size_t i = 0; i < slice.regular_columns.size(); ++i) {
+                cells_wr.add().skip();
+            }
+        } else {
+            get_compacted_row_slice(_schema, slice, column_kind::regular_column, cr.cells(), slice.regular_columns, cells_wr);
+        }
         std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
     };
 
@@ -2342,6 +2397,7 @@ memory::reclaiming_result mutation_cleaner_impl::clear_some() noexcept {
 }
 
 void mutation_cleaner_impl::merge(mutation_cleaner_impl& r) noexcept {
+    _stats += std::exchange(r._stats, {});
     _versions.splice(r._versions);
     for (partition_snapshot& snp : r._worker_state->snapshots) {
         snp.migrate(&_region, _cleaner);
@@ -2399,6 +2455,35 @@ stop_iteration mutation_cleaner_impl::merge_some(partition_snapshot& snp) noexce
     });
 }
 
+void mutation_cleaner_impl::merge_eagerly(partition_version& v) noexcept {
+    // Merging destroys versions of the chain, but not snapshots, so find the snapshots first.
+    std::array<partition_snapshot*, eager_merge_version_chain_length> pending;
+    unsigned count = 0;
+    auto collect = [&] (partition_version& v) {
+        // Versions other than the latest one can only be referenced by snapshots.
+        if (count < pending.size() && v.prev() && v.is_referenced()) {
+            auto& snp = partition_snapshot::container_of(&v.back_reference());
+            if (snp._cleaner_hook.is_linked() && snp._cleaner == _cleaner) {
+                pending[count++] = &snp;
+            }
+        }
+    };
+    for (auto p = &v; p; p = p->prev()) {
+        collect(*p);
+    }
+    for (auto p = v.next(); p; p = p->next()) {
+        collect(*p);
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        partition_snapshot& snp = *pending[i];
+        ++_stats.eager_version_merges;
+        if (merge_some(snp) == stop_iteration::yes) {
+            _worker_state->snapshots.erase(snapshot_list::s_iterator_to(snp));
+            lw_shared_ptr<partition_snapshot>::dispose(&snp);
+        }
+    }
+}
+
 stop_iteration mutation_cleaner_impl::merge_some() noexcept {
     if (_worker_state->snapshots.empty()) {
         return stop_iteration::yes;
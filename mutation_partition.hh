@@ -96,6 +96,11 @@ class row {
     row();
     ~row();
     row(const schema&, column_kind, const row&);
+    // Copies o, except for the values of the live cells of the atomic, non-counter
+    // columns whose entry in values_needed (indexed by column id) is false, which are
+    // left empty. For readers whose users only look at some of the columns, but
+    // still need all the cells to tell whether the row is live.
+    row(const schema&, column_kind, const row& o, const std::vector<bool>& values_needed);
     row(row&& other) noexcept;
     row& operator=(row&& other) noexcept;
     size_t size() const { return _size; }
@@ -346,3 +346,17 @@ mutation_fragment frozen_mutation_fragment::unfreeze(const schema& s, reader_per
         }
     );
 }
+
+std::optional<partition_key> frozen_mutation_fragment::partition_start_key() const
+{
+    auto in = ser::as_input_stream(_bytes);
+    auto view = ser::deserialize(in, boost::type<ser::mutation_fragment_view>());
+    return seastar::visit(view.fragment(),
+        [] (ser::partition_start_view ps) -> std::optional<partition_key> {
+            return ps.key();
+        },
+        [] (auto&&) -> std::optional<partition_key> {
+            return std::nullopt;
+        }
+    );
+}
@@ -208,6 +208,29 @@ class mutation_fragment_merger {
         });
     }
 
+    // Passes fragments which need no merging straight to consume, in bulk, if
+    // the producer can provide them, see mutation_reader_merger::consume_single_reader_buffer().
+    // A partition may be emitted partly by operator()() and partly by this
+    // method, so range tombstone changes still go through the tombstone
+    // merger, to keep its state in sync with the stream.
+    template <typename Consumer>
+    requires std::is_invocable_r_v<stop_iteration, Consumer, mutation_fragment_v2>
+    void consume_unmerged(Consumer&& consume) {
+        auto merge_and_consume = [this, &consume] (mutation_fragment_v2 mf, stream_id_t stream_id) {
+            if (!mf.is_range_tombstone_change()) {
+                return consume(std::move(mf));
+            }
+            _tombstone_merger.apply(stream_id, mf.as_range_tombstone_change().tombstone());
+            if (auto tomb_opt = _tombstone_merger.get()) {
+                return consume(mutation_fragment_v2(*_schema, _permit, range_tombstone_change(mf.position(), *tomb_opt)));
+            }
+            return stop_iteration::no;
+        };
+        if constexpr (requires { _producer.consume_single_reader_buffer(merge_and_consume); }) {
+            _producer.consume_single_reader_buffer(merge_and_consume);
+        }
+    }
+
     future<> next_partition() {
         _tombstone_merger.clear();
         return _producer.next_partition();
@@ -232,7 +255,10 @@ class mutation_fragment_merger {
 // stream of mutation-fragments.
 class mutation_reader_merger {
 public:
-    using reader_iterator = std::list<flat_mutation_reader_v2>::iterator;
+    // The readers are allocated from the arena of the permit, they are
+    // temporaries of the read, added once and dropped with it.
+    using reader_list = std::pmr::list<flat_mutation_reader_v2>;
+    using reader_iterator = reader_list::iterator;
 
     struct reader_and_fragment {
         reader_iterator reader{};
@@ -272,10 +298,10 @@ class mutation_reader_merger {
     std::unique_ptr<reader_selector> _selector;
     // We need a list because we need stable addresses across additions
     // and removals.
-    std::list<flat_mutation_reader_v2> _all_readers;
+    reader_list _all_readers;
     // We remove unneeded readers in batches. Until it is their time they
     // are kept in _to_remove.
-    std::list<flat_mutation_reader_v2> _to_remove;
+    reader_list _to_remove;
     // Readers positioned at a partition, different from the one we are
     // reading from now. For these readers the attached fragment is
     // always partition_start. Used to pick the next partition.
@@ -318,12 +344,32 @@ class mutation_reader_merger {
     void prepare_forwardable_readers();
 public:
     mutation_reader_merger(schema_ptr schema,
+            reader_permit permit,
             std::unique_ptr<reader_selector> selector,
             streamed_mutation::forwarding fwd_sm,
             mutation_reader::forwarding fwd_mr);
     // Produces the next batch of mutation-fragments of the same
     // position.
     future<mutation_fragment_batch> operator()();
+    // Batch-oriented alternative to operator()() for when a single reader owns
+    // the current partition: passes the fragments already buffered by that reader
+    // to consume, along with the stream they come from, bypassing the heaps, until
+    // consume returns stop_iteration::yes, the partition ends or the buffer runs out.
+    template <typename Consumer>
+    requires std::is_invocable_r_v<stop_iteration, Consumer, mutation_fragment_v2, stream_id_t>
+    void consume_single_reader_buffer(Consumer& consume) {
+        while (_single_reader.reader != reader_iterator{} && !_single_reader.reader->is_buffer_empty()) {
+            stream_id_t stream_id = &*_single_reader.reader;
+            auto mf = _single_reader.reader->pop_mutation_fragment();
+            _single_reader.last_kind = mf.mutation_fragment_kind();
+            if (mf.is_end_of_partition()) {
+                _next.emplace_back(std::exchange(_single_reader.reader, {}), mutation_fragment_v2::kind::partition_end);
+            }
+            if (consume(std::move(mf), stream_id) == stop_iteration::yes) {
+                return;
+            }
+        }
+    }
     future<> next_partition();
     future<> fast_forward_to(const dht::partition_range& pr);
     future<> fast_forward_to(position_range pr);
@@ -537,10 +583,13 @@ void mutation_reader_merger::prepare_forwardable_readers() {
 }
 
 mutation_reader_merger::mutation_reader_merger(schema_ptr schema,
+        reader_permit permit,
         std::unique_ptr<reader_selector> selector,
         streamed_mutation::forwarding fwd_sm,
         mutation_reader::forwarding fwd_mr)
     : _selector(std::move(selector))
+    , _all_readers(&permit.arena())
+    , _to_remove(&permit.arena())
     , _schema(std::move(schema))
     , _fwd_sm(fwd_sm)
     , _fwd_mr(fwd_mr) {
@@ -695,6 +744,13 @@ future<> mutation_reader_merger::close() noexcept {
 template <FragmentProducer P>
 future<> merging_reader<P>::fill_buffer() {
     return repeat([this] {
+        _merger.consume_unmerged([this] (mutation_fragment_v2 mf) {
+            push_mutation_fragment(std::move(mf));
+            return stop_iteration(is_buffer_full());
+        });
+        if (is_buffer_full()) {
+            return make_ready_future<stop_iteration>(stop_iteration::yes);
+        }
         return _merger().then([this] (mutation_fragment_v2_opt mfo) {
             if (!mfo) {
                 _end_of_stream = true;
@@ -754,10 +810,11 @@ flat_mutation_reader_v2 make_combined_reader(schema_ptr schema,
         std::unique_ptr<reader_selector> selector,
         streamed_mutation::forwarding fwd_sm,
         mutation_reader::forwarding fwd_mr) {
+    auto merger = mutation_reader_merger(schema, permit, std::move(selector), fwd_sm, fwd_mr);
     return make_flat_mutation_reader_v2<merging_reader<mutation_reader_merger>>(schema,
             std::move(permit),
             fwd_sm,
-            mutation_reader_merger(schema, std::move(selector), fwd_sm, fwd_mr));
+            std::move(merger));
 }
 
 flat_mutation_reader_v2 make_combined_reader(schema_ptr schema,
@@ -2534,10 +2591,12 @@ class multishard_combining_reader : public flat_mutation_reader::impl {
     std::vector<shard_and_token> _shard_selection_min_heap;
     unsigned _current_shard;
     bool _crossed_shards;
+    multishard_parallel_read_ahead _parallel_read_ahead;
     unsigned _concurrency = 1;
 
     void on_partition_range_change(const dht::partition_range& pr);
     bool maybe_move_to_next_shard(const dht::token* const t = nullptr);
+    void read_ahead_on_next_shards();
     future<> handle_empty_reader_buffer();
 
 public:
@@ -2550,7 +2609,8 @@ class multishard_combining_reader : public flat_mutation_reader::impl {
             const query::partition_slice& ps,
             const io_priority_class& pc,
             tracing::trace_state_ptr trace_state,
-            mutation_reader::forwarding fwd_mr);
+            mutation_reader::forwarding fwd_mr,
+            multishard_parallel_read_ahead parallel_read_ahead);
 
     // this is captured.
     multishard_combining_reader(const multishard_combining_reader&) = delete;
@@ -2604,6 +2664,20 @@ bool multishard_combining_reader::maybe_move_to_next_shard(const dht::token* con
     return true;
 }
 
+void multishard_combining_reader::read_ahead_on_next_shards() {
+    // Read ahead shouldn't change the min selection heap so we work on a local copy.
+    auto shard_selection_min_heap_copy = _shard_selection_min_heap;
+
+    // We kick-off concurrency-1 read-aheads in the background. They will be
+    // brought to the foreground when we move to their respective shard.
+    for (unsigned i = 1; i < _concurrency && !shard_selection_min_heap_copy.empty(); ++i) {
+        boost::pop_heap(shard_selection_min_heap_copy);
+        const auto next_shard = shard_selection_min_heap_copy.back().shard;
+        shard_selection_min_heap_copy.pop_back();
+        _shard_readers[next_shard]->read_ahead();
+    }
+}
+
 future<> multishard_combining_reader::handle_empty_reader_buffer() {
     auto& reader = *_shard_readers[_current_shard];
 
@@ -2620,21 +2694,11 @@ future<> multishard_combining_reader::handle_empty_reader_buffer() {
         // If we crossed shards and the next reader has an empty buffer we
         // double concurrency so the next time we cross shards we will have
         // more chances of hitting the reader's buffer.
-        if (_crossed_shards) {
+        // In parallel mode the concurrency is already at its maximum and the
+        // next shards are kept busy each time the current one is refilled.
+        if (_crossed_shards || _parallel_read_ahead) {
             _concurrency = std::min(_concurrency * 2, _sharder.shard_count());
-
-            // Read ahead shouldn't change the min selection heap so we work on a local copy.
-            auto shard_selection_min_heap_copy = _shard_selection_min_heap;
-
-            // If concurrency > 1 we kick-off concurrency-1 read-aheads in the
-            // background. They will be brought to the foreground when we move
-            // to their respective shard.
-            for (unsigned i = 1; i < _concurrency && !shard_selection_min_heap_copy.empty(); ++i) {
-                boost::pop_heap(shard_selection_min_heap_copy);
-                const auto next_shard = shard_selection_min_heap_copy.back().shard;
-                shard_selection_min_heap_copy.pop_back();
-                _shard_readers[next_shard]->read_ahead();
-            }
+            read_ahead_on_next_shards();
         }
         return reader.fill_buffer();
     }
@@ -2649,8 +2713,12 @@ multishard_combining_reader::multishard_combining_reader(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr)
-    : impl(std::move(s), std::move(permit)), _sharder(sharder) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_parallel_read_ahead parallel_read_ahead)
+    : impl(std::move(s), std::move(permit))
+    , _sharder(sharder)
+    , _parallel_read_ahead(parallel_read_ahead)
+    , _concurrency(_parallel_read_ahead ? _sharder.shard_count() : 1) {
 
     on_partition_range_change(pr);
 
@@ -2662,6 +2730,9 @@ multishard_combining_reader::multishard_combining_reader(
 
 future<> multishard_combining_reader::fill_buffer() {
     _crossed_shards = false;
+    if (_parallel_read_ahead) {
+        read_ahead_on_next_shards();
+    }
     return do_until([this] { return is_buffer_full() || is_end_of_stream(); }, [this] {
         auto& reader = *_shard_readers[_current_shard];
 
@@ -2714,10 +2785,11 @@ flat_mutation_reader make_multishard_combining_reader(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_parallel_read_ahead parallel_read_ahead) {
     const dht::sharder& sharder = schema->get_sharder();
     return make_flat_mutation_reader<multishard_combining_reader>(sharder, std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, pc,
-            std::move(trace_state), fwd_mr);
+            std::move(trace_state), fwd_mr, parallel_read_ahead);
 }
 
 flat_mutation_reader make_multishard_combining_reader_for_tests(
@@ -2729,9 +2801,10 @@ flat_mutation_reader make_multishard_combining_reader_for_tests(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_parallel_read_ahead parallel_read_ahead) {
     return make_flat_mutation_reader<multishard_combining_reader>(sharder, std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, pc,
-            std::move(trace_state), fwd_mr);
+            std::move(trace_state), fwd_mr, parallel_read_ahead);
 }
 
 // See make_multishard_combining_reader() for description.
@@ -2754,10 +2827,12 @@ class multishard_combining_reader_v2 : public flat_mutation_reader_v2::impl {
     std::vector<shard_and_token> _shard_selection_min_heap;
     unsigned _current_shard;
     bool _crossed_shards;
+    multishard_parallel_read_ahead _parallel_read_ahead;
     unsigned _concurrency = 1;
 
     void on_partition_range_change(const dht::partition_range& pr);
     bool maybe_move_to_next_shard(const dht::token* const t = nullptr);
+    void read_ahead_on_next_shards();
     future<> handle_empty_reader_buffer();
 
 public:
@@ -2770,7 +2845,8 @@ class multishard_combining_reader_v2 : public flat_mutation_reader_v2::impl {
             const query::partition_slice& ps,
             const io_priority_class& pc,
             tracing::trace_state_ptr trace_state,
-            mutation_reader::forwarding fwd_mr);
+            mutation_reader::forwarding fwd_mr,
+            multishard_parallel_read_ahead parallel_read_ahead);
 
     // this is captured.
     multishard_combining_reader_v2(const multishard_combining_reader_v2&) = delete;
@@ -2824,6 +2900,20 @@ bool multishard_combining_reader_v2::maybe_move_to_next_shard(const dht::token*
     return true;
 }
 
+void multishard_combining_reader_v2::read_ahead_on_next_shards() {
+    // Read ahead shouldn't change the min selection heap so we work on a local copy.
+    auto shard_selection_min_heap_copy = _shard_selection_min_heap;
+
+    // We kick-off concurrency-1 read-aheads in the background. They will be
+    // brought to the foreground when we move to their respective shard.
+    for (unsigned i = 1; i < _concurrency && !shard_selection_min_heap_copy.empty(); ++i) {
+        boost::pop_heap(shard_selection_min_heap_copy);
+        const auto next_shard = shard_selection_min_heap_copy.back().shard;
+        shard_selection_min_heap_copy.pop_back();
+        _shard_readers[next_shard]->read_ahead();
+    }
+}
+
 future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
     auto& reader = *_shard_readers[_current_shard];
 
@@ -2840,21 +2930,11 @@ future<> multishard_combining_reader_v2::handle_empty_reader_buffer() {
         // If we crossed shards and the next reader has an empty buffer we
         // double concurrency so the next time we cross shards we will have
         // more chances of hitting the reader's buffer.
-        if (_crossed_shards) {
+        // In parallel mode the concurrency is already at its maximum and the
+        // next shards are kept busy each time the current one is refilled.
+        if (_crossed_shards || _parallel_read_ahead) {
             _concurrency = std::min(_concurrency * 2, _sharder.shard_count());
-
-            // Read ahead shouldn't change the min selection heap so we work on a local copy.
-            auto shard_selection_min_heap_copy = _shard_selection_min_heap;
-
-            // If concurrency > 1 we kick-off concurrency-1 read-aheads in the
-            // background. They will be brought to the foreground when we move
-            // to their respective shard.
-            for (unsigned i = 1; i < _concurrency && !shard_selection_min_heap_copy.empty(); ++i) {
-                boost::pop_heap(shard_selection_min_heap_copy);
-                const auto next_shard = shard_selection_min_heap_copy.back().shard;
-                shard_selection_min_heap_copy.pop_back();
-                _shard_readers[next_shard]->read_ahead();
-            }
+            read_ahead_on_next_shards();
         }
         return reader.fill_buffer();
     }
@@ -2869,8 +2949,12 @@ multishard_combining_reader_v2::multishard_combining_reader_v2(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr)
-    : impl(std::move(s), std::move(permit)), _sharder(sharder) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_parallel_read_ahead parallel_read_ahead)
+    : impl(std::move(s), std::move(permit))
+    , _sharder(sharder)
+    , _parallel_read_ahead(parallel_read_ahead)
+    , _concurrency(_parallel_read_ahead ? _sharder.shard_count() : 1) {
 
     on_partition_range_change(pr);
 
@@ -2882,6 +2966,9 @@ multishard_combining_reader_v2::multishard_combining_reader_v2(
 
 future<> multishard_combining_reader_v2::fill_buffer() {
     _crossed_shards = false;
+    if (_parallel_read_ahead) {
+        read_ahead_on_next_shards();
+    }
     return do_until([this] { return is_buffer_full() || is_end_of_stream(); }, [this] {
         auto& reader = *_shard_readers[_current_shard];
 
@@ -2934,10 +3021,11 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_parallel_read_ahead parallel_read_ahead) {
     const dht::sharder& sharder = schema->get_sharder();
     return make_flat_mutation_reader_v2<multishard_combining_reader_v2>(sharder, std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, pc,
-            std::move(trace_state), fwd_mr);
+            std::move(trace_state), fwd_mr, parallel_read_ahead);
 }
 
 flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
@@ -2949,9 +3037,10 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_parallel_read_ahead parallel_read_ahead) {
     return make_flat_mutation_reader_v2<multishard_combining_reader_v2>(sharder, std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, pc,
-            std::move(trace_state), fwd_mr);
+            std::move(trace_state), fwd_mr, parallel_read_ahead);
 }
 
 class queue_reader final : public flat_mutation_reader::impl {
@@ -3578,6 +3667,9 @@ class clustering_order_reader_merger {
     // reader in order to enter gallop mode. Must be greater than one.
     static constexpr int _gallop_mode_entering_threshold = 3;
 
+    // Readers are read ahead only while fewer than this many readers are open.
+    static constexpr size_t _max_open_readers_for_read_ahead = 4;
+
     bool in_gallop_mode() const {
         return _gallop_mode_hits >= _gallop_mode_entering_threshold;
     }
@@ -3777,6 +3869,17 @@ class clustering_order_reader_merger {
                 : _peeked_readers.front()->reader.peek_buffer().position();
         if (!_reader_queue->empty(next_peeked_pos)) {
             auto rs = _reader_queue->pop(next_peeked_pos);
+            // Read ahead: also open the next batch of readers which may return fragments from the current
+            // position range, so that their first buffers are filled in parallel with the buffers
+            // of the readers we need now, rather than only once we get to their lower bounds.
+            // Opening readers early is safe, since they are peeked and merged like all others.
+            // We read ahead a single batch and only while few readers are open, so that the merger
+            // still keeps a small number of readers open at a time.
+            auto read_ahead_pos = _partition_start_fetched ? _pr_end : position_in_partition_view::after_all_clustered_rows();
+            if (_all_readers.size() + rs.size() < _max_open_readers_for_read_ahead && !_reader_queue->empty(read_ahead_pos)) {
+                auto ahead = _reader_queue->pop(read_ahead_pos);
+                std::move(ahead.begin(), ahead.end(), std::back_inserter(rs));
+            }
             for (auto& r: rs) {
                 _all_readers.push_front(std::move(r));
                 _unpeeked_readers.push_back(_all_readers.begin());
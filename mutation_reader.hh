@@ -644,6 +644,8 @@ class reader_lifecycle_policy_v2 {
     virtual future<reader_permit> obtain_reader_permit(schema_ptr schema, const char* const description, db::timeout_clock::time_point timeout) = 0;
 };
 
+using multishard_parallel_read_ahead = bool_class<class multishard_parallel_read_ahead_tag>;
+
 /// Make a multishard_combining_reader.
 ///
 /// multishard_combining_reader takes care of reading a range from all shards
@@ -661,6 +663,12 @@ class reader_lifecycle_policy_v2 {
 /// For dense tables (where we rarely cross shards) we rely on the
 /// foreign_reader to issue sufficient read-aheads on its own to avoid blocking.
 ///
+/// With `parallel_read_ahead` the read starts with the maximum concurrency
+/// instead, and keeps a read-ahead in flight on each of the next shards whose
+/// buffer is empty, whenever it fills its own buffer, so that all shards read
+/// at the same time. The output is still merged in token order and each shard
+/// buffers at most one buffer of its reader ahead of the merge.
+///
 /// The readers' life-cycles are managed through the supplied lifecycle policy.
 flat_mutation_reader make_multishard_combining_reader(
         shared_ptr<reader_lifecycle_policy> lifecycle_policy,
@@ -670,7 +678,8 @@ flat_mutation_reader make_multishard_combining_reader(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state = nullptr,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+        multishard_parallel_read_ahead parallel_read_ahead = multishard_parallel_read_ahead::no);
 
 flat_mutation_reader make_multishard_combining_reader_for_tests(
         const dht::sharder& sharder,
@@ -681,7 +690,8 @@ flat_mutation_reader make_multishard_combining_reader_for_tests(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state = nullptr,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+        multishard_parallel_read_ahead parallel_read_ahead = multishard_parallel_read_ahead::no);
 
 /// Make a multishard_combining_reader.
 ///
@@ -700,6 +710,12 @@ flat_mutation_reader make_multishard_combining_reader_for_tests(
 /// For dense tables (where we rarely cross shards) we rely on the
 /// foreign_reader to issue sufficient read-aheads on its own to avoid blocking.
 ///
+/// With `parallel_read_ahead` the read starts with the maximum concurrency
+/// instead, and keeps a read-ahead in flight on each of the next shards whose
+/// buffer is empty, whenever it fills its own buffer, so that all shards read
+/// at the same time. The output is still merged in token order and each shard
+/// buffers at most one buffer of its reader ahead of the merge.
+///
 /// The readers' life-cycles are managed through the supplied lifecycle policy.
 flat_mutation_reader_v2 make_multishard_combining_reader_v2(
         shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
@@ -709,7 +725,8 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state = nullptr,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+        multishard_parallel_read_ahead parallel_read_ahead = multishard_parallel_read_ahead::no);
 
 flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
         const dht::sharder& sharder,
@@ -720,7 +737,8 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state = nullptr,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+        multishard_parallel_read_ahead parallel_read_ahead = multishard_parallel_read_ahead::no);
 
 class queue_reader;
 
@@ -14,6 +14,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/queue.hh>
 #include <seastar/core/smp.hh>
+#include <seastar/core/coroutine.hh>
 
 namespace mutation_writer {
 
@@ -205,6 +206,170 @@ future<uint64_t> distribute_reader_and_consume_on_shards(schema_ptr s,
     });
 }
 
+// Forwards batches of frozen fragments to the shards owning their
+// partitions, through a bounded queue per shard living on the producer's
+// shard. The consuming shards unfreeze the fragments straight from the
+// producer's memory, and the batches are freed back on the producer's shard.
+class frozen_fragment_distributor {
+    using batch = std::vector<frozen_mutation_fragment>;
+    // A null batch marks the end of the stream.
+    using foreign_batch = foreign_ptr<std::unique_ptr<batch>>;
+
+    static constexpr size_t max_batch_size = 32 * 1024;
+    static constexpr size_t max_queued_batches = 2;
+
+    struct shard_queue {
+        std::unique_ptr<batch> pending = std::make_unique<batch>();
+        size_t pending_size = 0;
+        seastar::queue<foreign_batch> queue{max_queued_batches};
+        future<> consumed = make_ready_future<>();
+    };
+
+    // Consumes the batches of a queue on the shard owning their partitions.
+    class shard_source {
+        schema_ptr _s;
+        reader_permit _permit;
+        unsigned _owner;
+        seastar::queue<foreign_batch>* _queue;
+        foreign_batch _batch;
+        size_t _pos = 0;
+    public:
+        shard_source(schema_ptr s, reader_permit permit, unsigned owner, seastar::queue<foreign_batch>* queue)
+            : _s(std::move(s)), _permit(std::move(permit)), _owner(owner), _queue(queue) { }
+
+        future<mutation_fragment_opt> next() {
+            while (!_batch || _pos == _batch->size()) {
+                _batch = co_await smp::submit_to(_owner, [q = _queue] { return q->pop_eventually(); });
+                _pos = 0;
+                if (!_batch) {
+                    co_return mutation_fragment_opt();
+                }
+            }
+            co_return (*_batch)[_pos++].unfreeze(*_s, _permit);
+        }
+    };
+
+    schema_ptr _s;
+    frozen_fragment_producer _producer;
+    std::function<future<> (flat_mutation_reader)> _consumer;
+    std::vector<std::unique_ptr<shard_queue>> _queues;
+    unsigned _current_shard = -1;
+    uint64_t _consumed_partitions = 0;
+
+private:
+    static future<> consume_on_shard(global_schema_ptr gs, std::function<future<> (flat_mutation_reader)> consumer, unsigned owner, seastar::queue<foreign_batch>* queue) {
+        auto s = gs.get();
+        auto semaphore = std::make_unique<reader_concurrency_semaphore>(reader_concurrency_semaphore::no_limits{}, "frozen_fragment_distributor");
+        auto permit = semaphore->make_tracking_only_permit(s.get(), "frozen-fragment-distributor", db::no_timeout);
+        auto source = make_lw_shared<shard_source>(s, permit, owner, queue);
+        auto reader = make_generating_reader(s, permit, [source] { return source->next(); });
+        std::exception_ptr ex;
+        try {
+            if (co_await reader.peek()) {
+                co_await consumer(std::move(reader));
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await reader.close();
+        co_await semaphore->stop();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    }
+
+    void start_consumer(unsigned shard) {
+        auto& q = *_queues[shard];
+        q.consumed = smp::submit_to(shard, [gs = global_schema_ptr(_s), consumer = _consumer, owner = this_shard_id(), queue = &q.queue] () mutable {
+            return consume_on_shard(std::move(gs), std::move(consumer), owner, queue);
+        }).handle_exception([&q] (std::exception_ptr ep) {
+            // Unblock the producer
+            q.queue.abort(ep);
+            return make_exception_future<>(std::move(ep));
+        });
+    }
+
+    future<> flush(unsigned shard) {
+        auto& q = *_queues[shard];
+        if (q.pending->empty()) {
+            return make_ready_future<>();
+        }
+        q.pending_size = 0;
+        return q.queue.push_eventually(make_foreign(std::exchange(q.pending, std::make_unique<batch>())));
+    }
+
+    future<> push(frozen_mutation_fragment fmf) {
+        if (auto key = fmf.partition_start_key()) {
+            ++_consumed_partitions;
+            auto shard = _s->get_sharder().shard_of(dht::get_token(*_s, *key));
+            if (shard != _current_shard) {
+                if (_current_shard != -1u) {
+                    co_await flush(_current_shard);
+                }
+                _current_shard = shard;
+                if (!_queues[shard]) {
+                    _queues[shard] = std::make_unique<shard_queue>();
+                    start_consumer(shard);
+                }
+            }
+        }
+        if (_current_shard == -1u) {
+            throw std::runtime_error("Got a mutation fragment before the first partition_start");
+        }
+        auto& q = *_queues[_current_shard];
+        q.pending_size += fmf.representation().size();
+        q.pending->push_back(std::move(fmf));
+        if (q.pending_size >= max_batch_size) {
+            co_await flush(_current_shard);
+        }
+    }
+
+public:
+    frozen_fragment_distributor(schema_ptr s, frozen_fragment_producer producer, std::function<future<> (flat_mutation_reader)> consumer)
+        : _s(std::move(s))
+        , _producer(std::move(producer))
+        , _consumer(std::move(consumer))
+        , _queues(_s->get_sharder().shard_count())
+    { }
+
+    future<uint64_t> operator()() {
+        std::exception_ptr ex;
+        try {
+            while (auto fmf = co_await _producer()) {
+                co_await push(std::move(*fmf));
+            }
+            for (unsigned shard = 0; shard < _queues.size(); ++shard) {
+                if (_queues[shard]) {
+                    co_await flush(shard);
+                    co_await _queues[shard]->queue.push_eventually(foreign_batch());
+                }
+            }
+        } catch (...) {
+            ex = std::current_exception();
+            for (auto& q : _queues) {
+                if (q) {
+                    q->queue.abort(ex);
+                }
+            }
+        }
+        for (auto& q : _queues) {
+            if (q) {
+                try {
+                    co_await std::move(q->consumed);
+                } catch (...) {
+                    if (!ex) {
+                        ex = std::current_exception();
+                    }
+                }
+            }
+        }
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+        co_return _consumed_partitions;
+    }
+};
+
 future<> multishard_writer::close() noexcept {
     return _producer.close().then([this] {
         return parallel_for_each(boost::irange(size_t(0), _shard_writers.size()), [this] (auto shard) {
@@ -218,4 +383,14 @@ future<> multishard_writer::close() noexcept {
     });
 }
 
+future<uint64_t> distribute_frozen_fragments_and_consume_on_shards(schema_ptr s,
+    frozen_fragment_producer producer,
+    std::function<future<> (flat_mutation_reader)> consumer,
+    utils::phased_barrier::operation&& op) {
+    return do_with(frozen_fragment_distributor(std::move(s), std::move(producer), std::move(consumer)), std::move(op),
+            [] (frozen_fragment_distributor& distributor, utils::phased_barrier::operation&) {
+        return distributor();
+    });
+}
+
 } // namespace mutation_writer
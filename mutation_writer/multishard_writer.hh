@@ -12,6 +12,7 @@
 #include "flat_mutation_reader.hh"
 #include "dht/i_partitioner.hh"
 #include "utils/phased_barrier.hh"
+#include "frozen_mutation.hh"
 
 namespace mutation_writer {
 
@@ -23,4 +24,16 @@ future<uint64_t> distribute_reader_and_consume_on_shards(schema_ptr s,
     std::function<future<> (flat_mutation_reader)> consumer,
     utils::phased_barrier::operation&& op = {});
 
+// Returns the next fragment, or std::nullopt at the end of the stream.
+using frozen_fragment_producer = noncopyable_function<future<std::optional<frozen_mutation_fragment>> ()>;
+
+// Like distribute_reader_and_consume_on_shards(), for fragments received
+// frozen. The fragments are forwarded frozen and only unfrozen on the shard
+// which consumes them, instead of being unfrozen on the receiving shard and
+// copied again to the consuming one.
+future<uint64_t> distribute_frozen_fragments_and_consume_on_shards(schema_ptr s,
+    frozen_fragment_producer producer,
+    std::function<future<> (flat_mutation_reader)> consumer,
+    utils::phased_barrier::operation&& op = {});
+
 } // namespace mutation_writer
@@ -14,6 +14,7 @@
 #include <seastar/core/shared_mutex.hh>
 
 #include "mutation_reader.hh"
+#include "dht/token-sharding.hh"
 
 namespace mutation_writer {
 
@@ -23,6 +24,7 @@ class shard_based_splitting_mutation_writer {
 private:
     schema_ptr _schema;
     reader_permit _permit;
+    const dht::sharder& _sharder;
     reader_consumer_v2 _consumer;
     unsigned _current_shard;
     std::vector<std::optional<shard_writer>> _shards;
@@ -32,15 +34,16 @@ class shard_based_splitting_mutation_writer {
         return writer.consume(std::move(mf));
     }
 public:
-    shard_based_splitting_mutation_writer(schema_ptr schema, reader_permit permit, reader_consumer_v2 consumer)
+    shard_based_splitting_mutation_writer(schema_ptr schema, reader_permit permit, const dht::sharder& sharder, reader_consumer_v2 consumer)
         : _schema(std::move(schema))
         , _permit(std::move(permit))
+        , _sharder(sharder)
         , _consumer(std::move(consumer))
-        , _shards(smp::count)
+        , _shards(_sharder.shard_count())
     {}
 
     future<> consume(partition_start&& ps) {
-        _current_shard = dht::shard_of(*_schema, ps.key().token());
+        _current_shard = _sharder.shard_of(ps.key().token());
         if (!_shards[_current_shard]) {
             _shards[_current_shard] = shard_writer(_schema, _permit, _consumer);
         }
@@ -84,11 +87,16 @@ class shard_based_splitting_mutation_writer {
     }
 };
 
-future<> segregate_by_shard(flat_mutation_reader_v2 producer, reader_consumer_v2 consumer) {
+future<> segregate_by_shard(flat_mutation_reader_v2 producer, const dht::sharder& sharder, reader_consumer_v2 consumer) {
     auto schema = producer.schema();
     auto permit = producer.permit();
     return feed_writer(
         std::move(producer),
-        shard_based_splitting_mutation_writer(std::move(schema), std::move(permit), std::move(consumer)));
+        shard_based_splitting_mutation_writer(std::move(schema), std::move(permit), sharder, std::move(consumer)));
+}
+
+future<> segregate_by_shard(flat_mutation_reader_v2 producer, reader_consumer_v2 consumer) {
+    const auto& sharder = producer.schema()->get_sharder();
+    return segregate_by_shard(std::move(producer), sharder, std::move(consumer));
 }
 } // namespace mutation_writer
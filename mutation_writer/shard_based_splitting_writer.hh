@@ -12,6 +12,10 @@
 
 #include "feed_writers.hh"
 
+namespace dht {
+class sharder;
+}
+
 namespace mutation_writer {
 
 // Given a producer that may contain data for all shards, consume it in a per-shard
@@ -20,4 +24,10 @@ namespace mutation_writer {
 // owners.
 future<> segregate_by_shard(flat_mutation_reader_v2 producer, reader_consumer_v2 consumer);
 
+// Like the above, but splits by the shards of the given sharder instead of
+// those of the producer's schema. Allows splitting data for a node with a
+// different shard count than the local one. The sharder has to outlive the
+// returned future.
+future<> segregate_by_shard(flat_mutation_reader_v2 producer, const dht::sharder& sharder, reader_consumer_v2 consumer);
+
 } // namespace mutation_writer
@@ -19,6 +19,7 @@ partition_slice_builder::partition_slice_builder(const schema& schema, query::pa
     , _specific_ranges(std::move(slice._specific_ranges))
     , _schema(schema)
     , _options(std::move(slice.options))
+    , _filters(std::move(slice.filters))
 {
 }
 
@@ -63,7 +64,9 @@ partition_slice_builder::build() {
         std::move(_options),
         std::move(_specific_ranges),
         cql_serialization_format::internal(),
-        _partition_row_limit,
+        static_cast<uint32_t>(_partition_row_limit),
+        static_cast<uint32_t>(_partition_row_limit >> 32),
+        std::move(_filters),
     };
 }
 
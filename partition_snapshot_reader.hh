@@ -16,6 +16,10 @@
 
 template <bool Reversing, typename Accounter>
 class partition_snapshot_flat_reader : public flat_mutation_reader::impl, public Accounter {
+    // Accounters which define on_rows_read(size_t) are also told the memory footprint
+    // of the rows_entry objects each clustering row was read from.
+    static constexpr bool accounts_rows_memory = requires (Accounter& a) { a.on_rows_read(size_t(0)); };
+
     using rows_iter_type = std::conditional_t<Reversing,
           mutation_partition::rows_type::const_reverse_iterator,
           mutation_partition::rows_type::const_iterator>;
@@ -257,13 +261,23 @@ class partition_snapshot_flat_reader : public flat_mutation_reader::impl, public
         // tombstones.
         mutation_fragment_opt next_row(const query::clustering_range& ck_range_snapshot,
                                        const std::optional<position_in_partition>& last_row,
-                                       const std::optional<position_in_partition>& last_rts) {
-            return in_alloc_section([&] () -> mutation_fragment_opt {
+                                       const std::optional<position_in_partition>& last_rts,
+                                       Accounter& accounter) {
+            // The section may be retried, so only account the rows of the successful attempt.
+            size_t rows_memory = 0;
+            auto account = [&] (const rows_entry& e) {
+                if constexpr (accounts_rows_memory) {
+                    rows_memory += e.memory_usage(_query_schema);
+                }
+            };
+            auto mf = in_alloc_section([&] () -> mutation_fragment_opt {
+                rows_memory = 0;
                 maybe_refresh_state(ck_range_snapshot, last_row, last_rts);
 
                 position_in_partition::equal_compare rows_eq(_query_schema);
                 while (has_more_rows()) {
                     const rows_entry& e = pop_clustering_row();
+                    account(e);
                     if (e.dummy()) {
                         continue;
                     }
@@ -274,6 +288,7 @@ class partition_snapshot_flat_reader : public flat_mutation_reader::impl, public
                     // TODO: Ideally this should be position() or position().reversed(), depending on Reversing.
                     while (has_more_rows() && rows_eq(peek_row().position(), result.as_clustering_row().position())) {
                         const rows_entry& e = pop_clustering_row();
+                        account(e);
                         if (_digest_requested) {
                             e.row().cells().prepare_hash(_query_schema, column_kind::regular_column);
                         }
@@ -285,6 +300,10 @@ class partition_snapshot_flat_reader : public flat_mutation_reader::impl, public
                 }
                 return { };
             });
+            if constexpr (accounts_rows_memory) {
+                accounter.on_rows_read(rows_memory);
+            }
+            return mf;
         }
 
         mutation_fragment_opt next_range_tombstone(const query::clustering_range& ck_range_snapshot,
@@ -372,7 +391,7 @@ class partition_snapshot_flat_reader : public flat_mutation_reader::impl, public
         const auto& ck_range_query = opt_reversed_range ? *opt_reversed_range : ck_range_snapshot;
 
         if (!_next_row && !_no_more_rows_in_current_range) {
-            _next_row = _reader.next_row(ck_range_snapshot, _last_entry, _last_rts);
+            _next_row = _reader.next_row(ck_range_snapshot, _last_entry, _last_rts, accounter());
         }
 
         if (_next_row) {
@@ -480,6 +480,18 @@ class partition_snapshot_row_cursor final {
         return cr;
     }
 
+    // Like row(), but the live cells of the atomic columns whose entry in values_needed
+    // is false have an empty value, see row::row().
+    // Can be called only when cursor is valid and pointing at a row.
+    clustering_row row(const std::vector<bool>& values_needed) const {
+        clustering_row cr(key());
+        consume_row([&] (const deletable_row& row) {
+            cr.apply(_schema, clustering_row(key(), row.deleted_at(), row.marker(),
+                    ::row(_schema, column_kind::regular_column, row.cells(), values_needed)));
+        });
+        return cr;
+    }
+
     // Can be called only when cursor is valid and pointing at a row.
     deletable_row& latest_row() const noexcept {
         return _current_row[0].it->row();
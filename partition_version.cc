@@ -13,6 +13,8 @@
 #include "partition_snapshot_row_cursor.hh"
 #include "utils/coroutine.hh"
 #include "real_dirty_memory_accounter.hh"
+#include "partition_builder.hh"
+#include "mutation_partition_view.hh"
 
 static void remove_or_mark_as_unique_owner(partition_version* current, mutation_cleaner* cleaner)
 {
@@ -353,6 +355,23 @@ void partition_entry::apply(const schema& s, mutation_partition&& mp, const sche
     app_stats.row_writes += new_version->partition().row_count();
 }
 
+bool partition_entry::is_empty_and_unshared() const noexcept {
+    return !_snapshot && !_version->next() && _version->partition().empty();
+}
+
+void partition_entry::build(const schema& s, mutation_partition_view mpv, mutation_application_stats& app_stats) {
+    auto& mp = _version->partition();
+    mutation_partition empty(s.shared_from_this());
+    try {
+        partition_builder pb(s, mp);
+        mpv.accept(s, pb);
+    } catch (...) {
+        mp = std::move(empty);
+        throw;
+    }
+    app_stats.row_writes += mp.row_count();
+}
+
 utils::coroutine partition_entry::apply_to_incomplete(const schema& s,
     partition_entry&& pe,
     mutation_cleaner& pe_cleaner,
@@ -15,7 +15,7 @@
 #include "utils/chunked_vector.hh"
 
 #include <boost/intrusive/parent_from_member.hpp>
-#include <boost/intrusive/slist.hpp>
+#include <boost/intrusive/list.hpp>
 
 class static_row;
 
@@ -165,6 +165,9 @@ class partition_version : public anchorless_list_base_hook<partition_version> {
     bool is_referenced_from_entry() const;
     partition_version_ref& back_reference() { return *_backref; }
 
+    // Returns the number of versions in the version chain this version belongs to.
+    unsigned version_chain_length() const noexcept;
+
     size_t size_in_allocator(const schema& s, allocation_strategy& allocator) const;
 };
 
@@ -242,6 +245,18 @@ bool partition_version::is_referenced_from_entry() const {
     return !prev() && _backref && !_backref->is_unique_owner();
 }
 
+inline
+unsigned partition_version::version_chain_length() const noexcept {
+    unsigned length = 1;
+    for (auto v = prev(); v; v = v->prev()) {
+        ++length;
+    }
+    for (auto v = next(); v; v = v->next()) {
+        ++length;
+    }
+    return length;
+}
+
 class partition_entry;
 class cache_tracker;
 class mutation_cleaner;
@@ -291,7 +306,7 @@ class partition_snapshot : public enable_lw_shared_from_this<partition_snapshot>
     logalloc::region* _region;
     mutation_cleaner* _cleaner;
     cache_tracker* _tracker;
-    boost::intrusive::slist_member_hook<> _cleaner_hook;
+    boost::intrusive::list_member_hook<> _cleaner_hook;
     bool _locked = false;
     friend class partition_entry;
     friend class mutation_cleaner_impl;
@@ -541,6 +556,17 @@ class partition_entry {
     void apply(const schema& s, const mutation_partition& mp, const schema& mp_schema, mutation_application_stats& app_stats);
     void apply(const schema& s, mutation_partition&& mp, const schema& mp_schema, mutation_application_stats& app_stats);
 
+    // Tells whether the entry holds no data and has a single version and no snapshots,
+    // as a memtable entry right after it's created.
+    bool is_empty_and_unshared() const noexcept;
+
+    // Builds the partition represented by mpv right in the version of this entry, instead
+    // of building it in a separate mutation_partition and applying that.
+    // Must be called only when is_empty_and_unshared().
+    // Strong exception guarantees: the entry is left empty if building fails.
+    // Use only on non-evictable entries.
+    void build(const schema& s, mutation_partition_view mpv, mutation_application_stats& app_stats);
+
     // Adds mutation_partition represented by "other" to the one represented
     // by this entry.
     // This entry must be evictable.
@@ -215,51 +215,36 @@ struct querier_utils {
     static void set_inactive_read_handle(querier_base& q, reader_concurrency_semaphore::inactive_read_handle h) noexcept {
         q._reader = std::move(h);
     }
-};
-
-template <typename Querier>
-void querier_cache::insert_querier(
-        utils::UUID key,
-        querier_cache::index& index,
-        querier_cache::stats& stats,
-        Querier&& q,
-        std::chrono::seconds ttl,
-        tracing::trace_state_ptr trace_state) {
-    // FIXME: see #3159
-    // In reverse mode flat_mutation_reader drops any remaining rows of the
-    // current partition when the page ends so it cannot be reused across
-    // pages.
-    if (q.is_reversed()) {
-        (void)with_gate(_closing_gate, [this, q = std::move(q)] () mutable {
-            return q.close().finally([q = std::move(q)] {});
-        });
-        return;
+    static bool is_active(const querier_base& q) noexcept {
+        return std::holds_alternative<flat_mutation_reader_v2>(q._reader);
     }
+    static flat_mutation_reader_v2& reader(querier_base& q) noexcept {
+        return std::get<flat_mutation_reader_v2>(q._reader);
+    }
+    static uint64_t read_ahead_id(const querier_base& q) noexcept {
+        return q._read_ahead_id;
+    }
+    static void start_read_ahead(querier_base& q, uint64_t id, future<> f) noexcept {
+        q._read_ahead_id = id;
+        q._read_ahead = std::move(f);
+    }
+    static void forget_read_ahead(querier_base& q) noexcept {
+        q._read_ahead.reset();
+    }
+};
 
-    ++stats.inserts;
-
-    tracing::trace(trace_state, "Caching querier with key {}", key);
-
+void querier_cache::make_inactive(index& index, index::iterator it, querier_cache::stats& stats, std::chrono::seconds ttl) noexcept {
+    auto& q = *it->second;
     auto& sem = q.permit().semaphore();
 
     auto irh = sem.register_inactive_read(querier_utils::get_reader(q));
     if (!irh) {
+        index.erase(it);
+        --stats.population;
         ++stats.resource_based_evictions;
         return;
     }
   try {
-    auto cleanup_irh = defer([&] () noexcept {
-        sem.unregister_inactive_read(std::move(irh));
-    });
-
-    auto it = index.emplace(key, std::make_unique<Querier>(std::move(q)));
-
-    ++stats.population;
-    auto cleanup_index = defer([&] () noexcept {
-        index.erase(it);
-        --stats.population;
-    });
-
     auto notify_handler = [&stats, &index, it] (reader_concurrency_semaphore::evict_reason reason) {
         index.erase(it);
         switch (reason) {
@@ -276,28 +261,115 @@ void querier_cache::insert_querier(
     };
 
     sem.set_notify_handler(irh, std::move(notify_handler), ttl);
-    querier_utils::set_inactive_read_handle(*it->second, std::move(irh));
-    cleanup_index.cancel();
-    cleanup_irh.cancel();
+    querier_utils::set_inactive_read_handle(q, std::move(irh));
   } catch (...) {
     // It is okay to swallow the exception since
     // we're allowed to drop the reader upon registration
     // due to lack of resources - in which case we already
     // drop the querier.
     qlogger.warn("Failed to insert querier into index: {}. Ignored as if it was evicted upon registration", std::current_exception());
+    sem.unregister_inactive_read(std::move(irh));
+    index.erase(it);
+    --stats.population;
   }
 }
 
+future<> querier_cache::finish_read_ahead(future<> f, index& index, utils::UUID key, uint64_t id, std::chrono::seconds ttl) {
+    const auto queriers = index.equal_range(key);
+    const auto it = std::find_if(queriers.first, queriers.second, [id] (const querier_cache::index::value_type& e) {
+        return querier_utils::is_active(*e.second) && querier_utils::read_ahead_id(*e.second) == id;
+    });
+    if (it == queriers.second) {
+        // Looked up (the next page waits for f) or evicted meanwhile.
+        return f;
+    }
+    if (!f.failed()) {
+        make_inactive(index, it, _stats, ttl);
+        return make_ready_future<>();
+    }
+    qlogger.debug("Read-ahead of cached querier with key {} failed: {}, dropping it", key, f.get_exception());
+    auto q = std::move(it->second);
+    index.erase(it);
+    --_stats.population;
+    // This is its read-ahead, don't wait for it.
+    querier_utils::forget_read_ahead(*q);
+    return q->close().finally([q = std::move(q)] {});
+}
+
+template <typename Querier>
+void querier_cache::insert_querier(
+        utils::UUID key,
+        querier_cache::index& index,
+        querier_cache::stats& stats,
+        Querier&& q,
+        std::chrono::seconds ttl,
+        tracing::trace_state_ptr trace_state,
+        bool read_ahead) {
+    // FIXME: see #3159
+    // In reverse mode flat_mutation_reader drops any remaining rows of the
+    // current partition when the page ends so it cannot be reused across
+    // pages.
+    if (q.is_reversed()) {
+        (void)with_gate(_closing_gate, [this, q = std::move(q)] () mutable {
+            return q.close().finally([q = std::move(q)] {});
+        });
+        return;
+    }
+
+    ++stats.inserts;
+
+    tracing::trace(trace_state, "Caching querier with key {}", key);
+
+    auto& reader = querier_utils::reader(q);
+    read_ahead = read_ahead && !q.ranges().front().is_singular() && !reader.is_buffer_full() && !reader.is_end_of_stream();
+
+    auto qp = std::make_unique<Querier>(std::move(q));
+    index::iterator it;
+    try {
+        it = index.emplace(key, std::move(qp));
+    } catch (...) {
+        qlogger.warn("Failed to insert querier into index: {}. Ignored as if it was evicted upon registration", std::current_exception());
+        ++stats.resource_based_evictions;
+        (void)with_gate(_closing_gate, [qp = std::move(qp)] () mutable {
+            auto& q = *qp;
+            return q.close().finally([qp = std::move(qp)] {});
+        });
+        return;
+    }
+    ++stats.population;
+
+    if (!read_ahead) {
+        make_inactive(index, it, stats, ttl);
+        return;
+    }
+
+    tracing::trace(trace_state, "Reading ahead");
+    ++stats.read_aheads;
+    const auto id = ++_next_read_ahead_id;
+    // The read-ahead may complete (and even drop the querier) right away, so
+    // the querier has to be set up before it starts.
+    promise<> read_ahead_done;
+    querier_utils::start_read_ahead(*it->second, id, read_ahead_done.get_future());
+    auto& cached_reader = querier_utils::reader(*it->second);
+    with_gate(_closing_gate, [this, &index, &cached_reader, key, id, ttl] {
+        return cached_reader.fill_buffer().then_wrapped([this, &index, key, id, ttl] (future<> f) {
+            return finish_read_ahead(std::move(f), index, key, id, ttl);
+        });
+    }).forward_to(std::move(read_ahead_done));
+}
+
 void querier_cache::insert(utils::UUID key, data_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(key, _data_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state));
+    insert_querier(key, _data_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state), _read_ahead);
 }
 
 void querier_cache::insert(utils::UUID key, mutation_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(key, _mutation_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state));
+    insert_querier(key, _mutation_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state), _read_ahead);
 }
 
 void querier_cache::insert(utils::UUID key, shard_mutation_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(key, _shard_mutation_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state));
+    // The reader is handed over to the multishard reader as is, without
+    // waiting for a read-ahead.
+    insert_querier(key, _shard_mutation_querier_index, _stats, std::move(q), _entry_ttl, std::move(trace_state), false);
 }
 
 template <typename Querier>
@@ -322,12 +394,17 @@ std::optional<Querier> querier_cache::lookup_querier(
         throw std::runtime_error("lookup_querier(): found querier is not of the expected type");
     }
     auto& q = *q_ptr;
-    auto reader_opt = q.permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(q));
-    if (!reader_opt) {
-        throw std::runtime_error("lookup_querier(): found querier that is evicted");
+    if (querier_utils::is_active(q)) {
+        // Still reading ahead, consume_page() waits for it.
+        querier_utils::reader(q).set_timeout(timeout);
+    } else {
+        auto reader_opt = q.permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(q));
+        if (!reader_opt) {
+            throw std::runtime_error("lookup_querier(): found querier that is evicted");
+        }
+        reader_opt->set_timeout(timeout);
+        querier_utils::set_reader(q, std::move(*reader_opt));
     }
-    reader_opt->set_timeout(timeout);
-    querier_utils::set_reader(q, std::move(*reader_opt));
     --stats.population;
 
     const auto can_be_used = can_be_used_for_page(q, s, ranges.front(), slice);
@@ -377,6 +454,13 @@ std::optional<shard_mutation_querier> querier_cache::lookup_shard_mutation_queri
             std::move(trace_state), timeout);
 }
 
+future<> querier_base::wait_for_read_ahead() noexcept {
+    if (!_read_ahead) {
+        return make_ready_future<>();
+    }
+    return std::exchange(_read_ahead, std::nullopt).value();
+}
+
 future<> querier_base::close() noexcept {
     struct variant_closer {
         querier_base& q;
@@ -388,7 +472,11 @@ future<> querier_base::close() noexcept {
             return reader_opt ? reader_opt->close() : make_ready_future<>();
         }
     };
-    return std::visit(variant_closer{*this}, _reader);
+    return wait_for_read_ahead().then_wrapped([this] (future<> f) {
+        // The error is reported to the page waiting for the read-ahead, if any.
+        f.ignore_ready_future();
+        return std::visit(variant_closer{*this}, _reader);
+    });
 }
 
 void querier_cache::set_entry_ttl(std::chrono::seconds entry_ttl) {
@@ -402,13 +490,11 @@ future<bool> querier_cache::evict_one() noexcept {
             continue;
         }
         auto it = idx.begin();
-        auto reader_opt = it->second->permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(*it->second));
+        auto q = std::move(it->second);
         idx.erase(it);
         ++_stats.resource_based_evictions;
         --_stats.population;
-        if (reader_opt) {
-            co_await reader_opt->close();
-        }
+        co_await q->close();
         co_return true;
     }
     co_return false;
@@ -419,12 +505,10 @@ future<> querier_cache::evict_all_for_table(const utils::UUID& schema_id) noexce
         auto& idx = *ip;
         for (auto it = idx.begin(); it != idx.end();) {
             if (it->second->schema().id() == schema_id) {
-                auto reader_opt = it->second->permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(*it->second));
+                auto q = std::move(it->second);
                 it = idx.erase(it);
                 --_stats.population;
-                if (reader_opt) {
-                    co_await reader_opt->close();
-                }
+                co_await q->close();
             } else {
                 ++it;
             }
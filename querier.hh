@@ -136,6 +136,15 @@ class querier_base {
     std::unique_ptr<const query::partition_slice> _slice;
     std::variant<flat_mutation_reader_v2, reader_concurrency_semaphore::inactive_read_handle> _reader;
     dht::partition_ranges_view _query_ranges;
+    // The read-ahead started when the querier was cached, see
+    // querier_cache::set_read_ahead().
+    std::optional<future<>> _read_ahead;
+    uint64_t _read_ahead_id = 0;
+
+protected:
+    // Waits for the read-ahead to fill the reader's buffer, if there is one
+    // in progress. Must be called before using the reader.
+    future<> wait_for_read_ahead() noexcept;
 
 public:
     querier_base(reader_permit permit, lw_shared_ptr<const dht::partition_range> range,
@@ -230,13 +239,14 @@ class querier : public querier_base {
         return  _compaction_state->are_limits_reached();
     }
 
+private:
     template <typename Consumer>
     requires CompactedFragmentsConsumer<Consumer>
-    auto consume_page(Consumer&& consumer,
+    auto do_consume_page(Consumer&& consumer,
             uint64_t row_limit,
             uint32_t partition_limit,
             gc_clock::time_point query_time,
-            tracing::trace_state_ptr trace_ptr = {}) {
+            tracing::trace_state_ptr trace_ptr) {
         return ::query::consume_page(std::get<flat_mutation_reader_v2>(_reader), _compaction_state, *_slice, std::move(consumer), row_limit,
                 partition_limit, query_time).then([this, trace_ptr = std::move(trace_ptr)] (auto&& results) {
             _last_ckey = std::get<std::optional<clustering_key>>(std::move(results));
@@ -261,6 +271,23 @@ class querier : public querier_base {
         });
     }
 
+public:
+    template <typename Consumer>
+    requires CompactedFragmentsConsumer<Consumer>
+    auto consume_page(Consumer&& consumer,
+            uint64_t row_limit,
+            uint32_t partition_limit,
+            gc_clock::time_point query_time,
+            tracing::trace_state_ptr trace_ptr = {}) {
+        if (!_read_ahead) {
+            return do_consume_page(std::move(consumer), row_limit, partition_limit, query_time, std::move(trace_ptr));
+        }
+        return wait_for_read_ahead().then([this, consumer = std::move(consumer), row_limit, partition_limit, query_time,
+                trace_ptr = std::move(trace_ptr)] () mutable {
+            return do_consume_page(std::move(consumer), row_limit, partition_limit, query_time, std::move(trace_ptr));
+        });
+    }
+
     virtual position_view current_position() const override {
         const dht::decorated_key* dk = _compaction_state->current_partition();
         const clustering_key_prefix* clustering_key = _last_ckey ? &*_last_ckey : nullptr;
@@ -356,6 +383,14 @@ class shard_mutation_querier : public querier_base {
 /// Keeps the total memory consumption of cached queriers
 /// below max_queriers_memory_usage by evicting older entries upon inserting
 /// new ones if the the memory consupmtion would go above the limit.
+///
+/// Optionally (see set_read_ahead()), the readers of cached data and mutation
+/// queriers scanning partition ranges keep reading between pages, filling
+/// their buffer (bounded by the max buffer size of the reader, and accounted
+/// in their permit), while the client processes the page. The next page is
+/// then served from the buffer. The querier is registered as an inactive read
+/// only once the read-ahead completed, a lookup in the meantime returns it
+/// and its next page waits for the read-ahead.
 class querier_cache {
 public:
     static const std::chrono::seconds default_entry_ttl;
@@ -377,6 +412,8 @@ class querier_cache {
         uint64_t resource_based_evictions = 0;
         // The number of queriers currently in the cache.
         uint64_t population = 0;
+        // The number of inserted queriers which read ahead.
+        uint64_t read_aheads = 0;
     };
 
     using index = std::unordered_multimap<utils::UUID, std::unique_ptr<querier_base>>;
@@ -388,6 +425,8 @@ class querier_cache {
     std::chrono::seconds _entry_ttl;
     stats _stats;
     gate _closing_gate;
+    bool _read_ahead = false;
+    uint64_t _next_read_ahead_id = 0;
 
 private:
     template <typename Querier>
@@ -397,7 +436,14 @@ class querier_cache {
             querier_cache::stats& stats,
             Querier&& q,
             std::chrono::seconds ttl,
-            tracing::trace_state_ptr trace_state);
+            tracing::trace_state_ptr trace_state,
+            bool read_ahead);
+
+    // Registers the reader of the cached querier as an inactive read, drops
+    // the querier if that fails.
+    void make_inactive(index& index, index::iterator it, querier_cache::stats& stats, std::chrono::seconds ttl) noexcept;
+
+    future<> finish_read_ahead(future<> f, index& index, utils::UUID key, uint64_t id, std::chrono::seconds ttl);
 
     template <typename Querier>
     std::optional<Querier> lookup_querier(
@@ -470,6 +516,13 @@ class querier_cache {
     /// Applies only to entries inserted after the change.
     void set_entry_ttl(std::chrono::seconds entry_ttl);
 
+    /// Enable or disable reading ahead between pages
+    ///
+    /// Applies only to entries inserted after the change.
+    void set_read_ahead(bool read_ahead) {
+        _read_ahead = read_ahead;
+    }
+
     /// Evict a querier.
     ///
     /// Return true if a querier was evicted and false otherwise (if the cache
@@ -130,6 +130,32 @@ constexpr auto max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto partition_max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto max_rows_if_set = std::numeric_limits<uint32_t>::max();
 
+// A restriction on the value of a regular, atomic, column, which the
+// coordinator filters the rows of the query with. Rows which don't satisfy
+// it are sent by the replica with their clustering key only, see
+// partition_slice::filters.
+struct column_filter {
+    enum class op : uint8_t {
+        eq,
+        lt,
+        lte,
+        gt,
+        gte,
+        in,
+    };
+    column_id column;
+    op oper;
+    // A single value for all but `in`.
+    std::vector<bytes> values;
+
+    // True iff the (live) value of the column satisfies the filter.
+    bool is_satisfied_by(const abstract_type& type, managed_bytes_view value) const;
+
+    bool operator==(const column_filter&) const = default;
+};
+
+std::ostream& operator<<(std::ostream& out, const column_filter& f);
+
 // Specifies subset of rows, columns and cell attributes to be returned in a query.
 // Can be accessed across cores.
 // Schema-dependent.
@@ -183,6 +209,11 @@ class partition_slice {
     column_id_vector static_columns; // TODO: consider using bitmap
     column_id_vector regular_columns;  // TODO: consider using bitmap
     option_set options;
+    // Restrictions the coordinator will filter the clustering rows with.
+    // The replica doesn't send the cells of rows which fail any of them, it
+    // still sends their keys, so that rows count the same with or without
+    // filters: the pagers, the result merger and digests depend on it.
+    std::vector<column_filter> filters;
 private:
     std::unique_ptr<specific_ranges> _specific_ranges;
     cql_serialization_format _cql_format;
@@ -194,7 +225,8 @@ class partition_slice {
         std::unique_ptr<specific_ranges> specific_ranges,
         cql_serialization_format,
         uint32_t partition_row_limit_low_bits,
-        uint32_t partition_row_limit_high_bits);
+        uint32_t partition_row_limit_high_bits,
+        std::vector<column_filter> filters = {});
     partition_slice(clustering_row_ranges row_ranges, column_id_vector static_columns,
         column_id_vector regular_columns, option_set options,
         std::unique_ptr<specific_ranges> specific_ranges = nullptr,
@@ -297,6 +329,11 @@ class read_command {
     // the remote doesn't send it.
     std::optional<query::max_result_size> max_result_size;
     uint32_t row_limit_high_bits;
+    // The effective service level of the user who issued the read, and its
+    // shares, which select the I/O priority class replicas read sstables
+    // with. Empty for internal reads and users without a service level.
+    sstring service_level;
+    int32_t service_level_shares = 0;
     api::timestamp_type read_timestamp; // not serialized
 public:
     // IDL constructor
@@ -310,7 +347,9 @@ class read_command {
                  utils::UUID query_uuid,
                  query::is_first_page is_first_page,
                  std::optional<query::max_result_size> max_result_size,
-                 uint32_t row_limit_high_bits)
+                 uint32_t row_limit_high_bits,
+                 sstring service_level,
+                 int32_t service_level_shares)
         : cf_id(std::move(cf_id))
         , schema_version(std::move(schema_version))
         , slice(std::move(slice))
@@ -322,6 +361,8 @@ class read_command {
         , is_first_page(is_first_page)
         , max_result_size(max_result_size)
         , row_limit_high_bits(row_limit_high_bits)
+        , service_level(std::move(service_level))
+        , service_level_shares(service_level_shares)
         , read_timestamp(api::new_timestamp())
     { }
 
@@ -364,6 +405,14 @@ class read_command {
 struct forward_request {
     enum class reduction_type {
         count,
+        aggregate,
+    };
+
+    // Describes a reduction_type::aggregate: a native aggregate function
+    // applied to columns of the queried table.
+    struct aggregation_info {
+        sstring function_name;
+        std::vector<sstring> column_names;
     };
 
     // multiple reduction types are needed to support queries like:
@@ -375,17 +424,20 @@ struct forward_request {
 
     db::consistency_level cl;
     lowres_clock::time_point timeout;
+
+    // If engaged, holds an entry for each of reduction_types. The entries of
+    // reduction_type::count are ignored.
+    std::optional<std::vector<aggregation_info>> aggregation_infos;
 };
 
 std::ostream& operator<<(std::ostream& out, const forward_request& r);
 std::ostream& operator<<(std::ostream& out, const forward_request::reduction_type& r);
+std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_info& a);
 
 struct forward_result {
     // vector storing query result for each selected column
     std::vector<bytes_opt> query_results;
 
-    void merge(const forward_result& other, const std::vector<forward_request::reduction_type>& types);
-
     struct printer {
         const std::vector<forward_request::reduction_type>& types;
         const query::forward_result& res;
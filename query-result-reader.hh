@@ -105,6 +105,9 @@ class result_row_view {
 //   -> accept_partition_end()
 //   ...
 //
+// The partition key passed to accept_new_partition() remains valid until
+// the matching accept_partition_end() returns.
+//
 struct result_visitor {
     void accept_new_partition(
         const partition_key& key, // FIXME: use view for the key
@@ -159,9 +162,10 @@ class result_view {
         for (auto&& p : _v.partitions()) {
             auto rows = p.rows();
             auto row_count = rows.size();
+            std::optional<partition_key> key;
             if (slice.options.contains<partition_slice::option::send_partition_key>()) {
-                auto key = *p.key();
-                visitor.accept_new_partition(key, row_count);
+                key = p.key();
+                visitor.accept_new_partition(*key, row_count);
             } else {
                 visitor.accept_new_partition(row_count);
             }
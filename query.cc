@@ -6,7 +6,9 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <algorithm>
 #include <limits>
+#include <boost/range/adaptor/sliced.hpp>
 #include "query-request.hh"
 #include "query-result.hh"
 #include "query-result-writer.hh"
@@ -43,9 +45,39 @@ std::ostream& operator<<(std::ostream& out, const partition_slice& ps) {
     out << ", options=" << format("{:x}", ps.options.mask()); // FIXME: pretty print options
     out << ", cql_format=" << ps.cql_format();
     out << ", partition_row_limit=" << ps.partition_row_limit();
+    if (!ps.filters.empty()) {
+        out << ", filters=[" << join(", ", ps.filters) << "]";
+    }
     return out << "}";
 }
 
+std::ostream& operator<<(std::ostream& out, const column_filter& f) {
+    static constexpr const char* ops[] = { "=", "<", "<=", ">", ">=", "IN" };
+    return out << "{column=" << f.column << ", op=" << ops[static_cast<uint8_t>(f.oper)] << ", values=" << f.values.size() << "}";
+}
+
+bool column_filter::is_satisfied_by(const abstract_type& type, managed_bytes_view value) const {
+    if (oper == op::in) {
+        return std::ranges::any_of(values, [&] (const bytes& v) { return type.equal(value, managed_bytes_view(bytes_view(v))); });
+    }
+    const auto cmp = type.compare(value, managed_bytes_view(bytes_view(values.front())));
+    switch (oper) {
+    case op::eq:
+        return cmp == 0;
+    case op::lt:
+        return cmp < 0;
+    case op::lte:
+        return cmp <= 0;
+    case op::gt:
+        return cmp > 0;
+    case op::gte:
+        return cmp >= 0;
+    case op::in:
+        break;
+    }
+    __builtin_unreachable();
+}
+
 std::ostream& operator<<(std::ostream& out, const read_command& r) {
     return out << "read_command{"
         << "cf_id=" << r.cf_id
@@ -56,6 +88,7 @@ std::ostream& operator<<(std::ostream& out, const read_command& r) {
         << ", partition_limit=" << r.partition_limit
         << ", query_uuid=" << r.query_uuid
         << ", is_first_page=" << r.is_first_page
+        << ", service_level=" << r.service_level
         << ", read_timestamp=" << r.read_timestamp
         << "}";
 }
@@ -66,19 +99,30 @@ std::ostream& operator<<(std::ostream& out, const forward_request::reduction_typ
         case forward_request::reduction_type::count:
             out << "count";
             break;
+        case forward_request::reduction_type::aggregate:
+            out << "aggregate";
+            break;
     }
     return out << "}";
 }
 
+std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_info& a) {
+    return out << "aggregation_info{" << a.function_name << "(" << join(", ", a.column_names) << ")}";
+}
+
 std::ostream& operator<<(std::ostream& out, const forward_request& r) {
     auto ms = std::chrono::time_point_cast<std::chrono::milliseconds>(r.timeout).time_since_epoch().count();
 
-    return out << "forward_request{"
+    out << "forward_request{"
         << "reduction_types=[" << join(",", r.reduction_types) << "]"
         << ", cmd=" << r.cmd
         << ", pr=" << r.pr
         << ", cl=" << r.cl
-        << ", timeout(ms)=" << ms << "}";
+        << ", timeout(ms)=" << ms;
+    if (r.aggregation_infos) {
+        out << ", aggregation_infos=[" << join(",", *r.aggregation_infos) << "]";
+    }
+    return out << "}";
 }
 
 
@@ -186,11 +230,13 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     std::unique_ptr<specific_ranges> specific_ranges,
     cql_serialization_format cql_format,
     uint32_t partition_row_limit_low_bits,
-    uint32_t partition_row_limit_high_bits)
+    uint32_t partition_row_limit_high_bits,
+    std::vector<column_filter> filters)
     : _row_ranges(std::move(row_ranges))
     , static_columns(std::move(static_columns))
     , regular_columns(std::move(regular_columns))
     , options(options)
+    , filters(std::move(filters))
     , _specific_ranges(std::move(specific_ranges))
     , _cql_format(std::move(cql_format))
     , _partition_row_limit_low_bits(partition_row_limit_low_bits)
@@ -234,6 +280,7 @@ partition_slice::partition_slice(const partition_slice& s)
     , static_columns(s.static_columns)
     , regular_columns(s.regular_columns)
     , options(s.options)
+    , filters(s.filters)
     , _specific_ranges(s._specific_ranges ? std::make_unique<specific_ranges>(*s._specific_ranges) : nullptr)
     , _cql_format(s._cql_format)
     , _partition_row_limit_low_bits(s._partition_row_limit_low_bits)
@@ -341,11 +388,90 @@ static void write_partial_partition(ser::writer_of_qr_partition<bytes_ostream>&&
     std::move(rows_wr).end_rows().end_qr_partition();
 }
 
+// A serialized query_result is the frame size, the partition count and the
+// partition frames.
+static constexpr size_t result_header_size = 2 * sizeof(ser::size_type);
+
+// Whether the buffer of the result has nothing after its partitions, so that
+// they can be stitched to those of other results.
+static bool has_only_partitions(const query::result& r) {
+    auto in = ser::as_input_stream(r.buf());
+    if (in.size() < result_header_size) {
+        return false;
+    }
+    auto frame_size = ser::deserialize(in, boost::type<ser::size_type>());
+    auto count = ser::deserialize(in, boost::type<ser::size_type>());
+    size_t end = result_header_size;
+    for (ser::size_type i = 0; i < count; ++i) {
+        auto size = ser::deserialize(in, boost::type<ser::size_type>());
+        in.skip(size - sizeof(ser::size_type));
+        end += size;
+    }
+    return end == frame_size && end == r.buf().size();
+}
+
+foreign_ptr<lw_shared_ptr<query::result>> result_merger::stitch() {
+    uint64_t row_count = 0;
+    uint32_t partition_count = 0;
+    short_read is_short_read;
+    size_t merged = 0;
+    for (auto&& r : _partial) {
+        if (!has_only_partitions(*r)) {
+            return {};
+        }
+        auto [partitions, rows] = result_view(*r).count_partitions_and_rows();
+        row_count += rows;
+        partition_count += partitions;
+        if (row_count > _max_rows || partition_count > _max_partitions) {
+            return {};
+        }
+        ++merged;
+        if (r->is_short_read()) {
+            is_short_read = short_read::yes;
+            break;
+        }
+        if (row_count >= _max_rows || partition_count >= _max_partitions) {
+            break;
+        }
+    }
+
+    bytes_ostream w;
+    auto size_ph = w.write_place_holder<ser::size_type>();
+    auto count_ph = w.write_place_holder<ser::size_type>();
+    for (auto&& r : _partial | boost::adaptors::sliced(0, merged)) {
+        if (r.get_owner_shard() == this_shard_id()) {
+            auto p = r.release();
+            if (p.use_count() == 1) {
+                w.splice(std::move(p->_w), result_header_size);
+                continue;
+            }
+            r = make_foreign(std::move(p));
+        }
+        auto skip = result_header_size;
+        for (bytes_view f : r->buf()) {
+            auto n = std::min(skip, f.size());
+            f.remove_prefix(n);
+            skip -= n;
+            w.write(f);
+        }
+    }
+    auto size_out = size_ph.get_stream();
+    ser::serialize(size_out, ser::size_type(w.size()));
+    auto count_out = count_ph.get_stream();
+    ser::serialize(count_out, ser::size_type(partition_count));
+
+    return make_foreign(make_lw_shared<query::result>(std::move(w), is_short_read, row_count, partition_count));
+}
+
 foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
     if (_partial.size() == 1) {
         return std::move(_partial[0]);
     }
 
+    if (auto r = stitch()) {
+        return r;
+    }
+
     bytes_ostream w;
     auto partitions = ser::writer_of_query_result<bytes_ostream>(w).start_partitions();
     uint64_t row_count = 0;
@@ -388,30 +514,6 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
     return make_foreign(make_lw_shared<query::result>(std::move(w), is_short_read, row_count, partition_count));
 }
 
-static bytes_opt merge_singular_results(bytes_opt r1, bytes_opt r2, forward_request::reduction_type reduction) {
-    switch (reduction) {
-        case forward_request::reduction_type::count: {
-            auto count1 = value_cast<int64_t>(long_type->deserialize(bytes_view(*r1)));
-            auto count2 = value_cast<int64_t>(long_type->deserialize(bytes_view(*r2)));
-            return data_value(count1 + count2).serialize();
-        }
-    }
-    throw std::runtime_error("unknown reduction type");
-}
-
-void forward_result::merge(const forward_result& other, const std::vector<forward_request::reduction_type>& reduction_types) {
-    if (query_results.empty()) {
-        query_results.resize(other.query_results.size());
-    }
-
-    assert(query_results.size() == other.query_results.size());
-    assert(query_results.size() == reduction_types.size());
-
-    for (size_t i = 0; i < query_results.size(); i++) {
-        query_results[i] = merge_singular_results(query_results[i], other.query_results[i], reduction_types[i]);
-    }
-}
-
 std::ostream& operator<<(std::ostream& out, const query::forward_result::printer& p) {
     assert(p.types.size() == p.res.query_results.size());
 
@@ -421,6 +523,15 @@ std::ostream& operator<<(std::ostream& out, const query::forward_result::printer
             case forward_request::reduction_type::count: {
                 auto count = value_cast<int64_t>(long_type->deserialize(bytes_view(*p.res.query_results[i])));
                 out << count;
+                break;
+            }
+            case forward_request::reduction_type::aggregate: {
+                if (auto& v = p.res.query_results[i]) {
+                    out << to_hex(*v);
+                } else {
+                    out << "null";
+                }
+                break;
             }
         }
 
@@ -19,6 +19,10 @@ class result_merger {
     std::vector<foreign_ptr<lw_shared_ptr<query::result>>> _partial;
     const uint64_t _max_rows;
     const uint32_t _max_partitions;
+
+    // Merges the partial results by stitching their buffers together, when
+    // they fit within the limits whole. Returns a null pointer otherwise.
+    foreign_ptr<lw_shared_ptr<query::result>> stitch();
 public:
     explicit result_merger(uint64_t max_rows, uint32_t max_partitions)
             : _max_rows(max_rows)
@@ -36,9 +40,10 @@ class result_merger {
         _partial.emplace_back(std::move(r));
     }
 
-    // FIXME: Eventually we should return a composite_query_result here
-    // which holds the vector of query results and which can be quickly turned
-    // into packet fragments by the transport layer without copying the data.
+    // The partitions of the partial results are only copied into the merged
+    // one when the limits cut a partial result short, or when the merger
+    // doesn't own its buffer alone. Otherwise, the chunks of the partial
+    // buffers are moved to the merged one, all but the first of each.
     foreign_ptr<lw_shared_ptr<query::result>> get();
 };
 
@@ -778,20 +778,9 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 }
             }
 
-            if (batch.log_entries.size()) {
-                auto& entries = batch.log_entries;
-
-                if (last_stable >= entries[0]->idx) {
-                    co_await _persistence->truncate_log(entries[0]->idx);
-                    _stats.truncate_persisted_log++;
-                }
-
-                // Combine saving and truncating into one call?
-                // will require persistence to keep track of last idx
-                co_await _persistence->store_log_entries(entries);
-
-                last_stable = (*entries.crbegin())->idx;
-                _stats.persisted_log_entries += entries.size();
+            if (batch.log_entries.size() && last_stable >= batch.log_entries[0]->idx) {
+                co_await _persistence->truncate_log(batch.log_entries[0]->idx);
+                _stats.truncate_persisted_log++;
             }
 
             // Update RPC server address mappings. Add servers which are joining
@@ -811,16 +800,46 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 }
             }
 
-             // After entries are persisted we can send messages.
-            for (auto&& m : batch.messages) {
-                try {
-                    send_message(m.first, std::move(m.second));
-                } catch(...) {
-                    // Not being able to send a message is not a critical error
-                    logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
+            auto send_messages = [this, &batch] (bool append_requests) {
+                for (auto&& m : batch.messages) {
+                    if (std::holds_alternative<append_request>(m.second) != append_requests) {
+                        continue;
+                    }
+                    try {
+                        send_message(m.first, std::move(m.second));
+                    } catch(...) {
+                        // Not being able to send a message is not a critical error
+                        logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
+                    }
                 }
+            };
+
+            if (batch.log_entries.size()) {
+                auto& entries = batch.log_entries;
+
+                // Combine saving and truncating into one call?
+                // will require persistence to keep track of last idx
+                auto persisted = _persistence->store_log_entries(entries);
+
+                // The leader doesn't have to wait for the entries to be
+                // persisted locally before replicating them (see 10.2.1
+                // in the Raft thesis): they can only be committed, which
+                // counts the leader, after this batch is done with and
+                // its followers persist them before they acknowledge.
+                send_messages(true);
+
+                co_await std::move(persisted);
+
+                last_stable = (*entries.crbegin())->idx;
+                _stats.persisted_log_entries += entries.size();
+            } else {
+                send_messages(true);
             }
 
+            // After entries are persisted we can send the other messages,
+            // replies to the leader in particular.
+            send_messages(false);
+
             if (batch.configuration) {
                 for (const auto& addr: rpc_diff.leaving) {
                     abort_snapshot_transfer(addr.id);
@@ -130,6 +130,12 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     tracing::trace_state_ptr _trace_state;
     mutation_reader::forwarding _fwd_mr;
     bool _range_query;
+    // Populates the cache with probationary entries and doesn't touch the
+    // entries it reads, so that it doesn't push out the entries of other reads.
+    bool _probationary;
+    // Regular columns, by id, whose values the user of the reader can observe.
+    // Empty if all of them are selected. See row::row().
+    std::vector<bool> _regular_column_values_needed;
     // When reader enters a partition, it must be set up for reading that
     // partition from the underlying mutation source (_underlying) in one of two ways:
     //
@@ -164,11 +170,18 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
         , _trace_state(std::move(trace_state))
         , _fwd_mr(fwd_mr)
         , _range_query(!query::is_single_partition(range))
+        , _probationary(_range_query && _cache._tracker.range_scans_probationary())
         , _underlying(_cache, *this)
     {
         if (_slice.options.contains(query::partition_slice::option::reversed)) {
             _native_slice = query::legacy_reverse_slice_to_native_reverse_slice(*_schema, _slice);
         }
+        if (_slice.regular_columns.size() < _schema->regular_columns_count()) {
+            _regular_column_values_needed.resize(_schema->regular_columns_count(), false);
+            for (auto id : _slice.regular_columns) {
+                _regular_column_values_needed[id] = true;
+            }
+        }
         ++_cache._tracker._stats.reads;
         if (!_range_query) {
             _key = range.start()->value().as_decorated_key();
@@ -192,10 +205,12 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     bool is_reversed() const { return _slice.options.contains(query::partition_slice::option::reversed); }
     // Returns a slice in the native format (for reversed reads, in native-reversed format).
     const query::partition_slice& native_slice() const { return is_reversed() ? *_native_slice : _slice; }
+    const std::vector<bool>& regular_column_values_needed() const { return _regular_column_values_needed; }
     const io_priority_class& pc() const { return _pc; }
     tracing::trace_state_ptr trace_state() const { return _trace_state; }
     mutation_reader::forwarding fwd_mr() const { return _fwd_mr; }
     bool is_range_query() const { return _range_query; }
+    bool is_probationary() const { return _probationary; }
     autoupdating_underlying_reader& underlying() { return _underlying; }
     row_cache::phase_type phase() const { return _phase; }
     const dht::decorated_key& key() const { return *_key; }
@@ -9,14 +9,18 @@
 #include <seastar/core/seastar.hh>
 #include <seastar/core/print.hh>
 #include <seastar/util/lazy.hh>
+#include <seastar/util/defer.hh>
 #include <seastar/util/log.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 
+#include <cmath>
+
 #include "reader_concurrency_semaphore.hh"
 #include "utils/exceptions.hh"
 #include "schema.hh"
 #include "utils/human_readable.hh"
+#include "utils/bump_arena.hh"
 
 logger rcslog("reader_concurrency_semaphore");
 
@@ -81,6 +85,24 @@ class reader_permit::impl
     bool _marked_as_blocked = false;
     db::timeout_clock::time_point _timeout;
     query::max_result_size _max_result_size{query::result_memory_limiter::unlimited_result_size};
+    reader_concurrency_semaphore::admission_lane _lane = reader_concurrency_semaphore::admission_lane::regular;
+    ssize_t _max_consumed_memory = 0;
+    reader_permit::read_stats _stats;
+    // Only tracked when the semaphore's count limit is adaptive.
+    std::chrono::steady_clock::time_point _created_at;
+    std::chrono::steady_clock::time_point _admitted_at;
+    bool _was_inactive = false;
+
+    class arena final : public utils::bump_arena {
+        impl& _permit;
+    protected:
+        virtual void on_new_chunk(size_t bytes) override {
+            _permit.consume(reader_resources::with_memory(bytes));
+        }
+    public:
+        explicit arena(impl& permit) : _permit(permit) { }
+    };
+    arena _arena{*this};
 
 private:
     void on_permit_used() {
@@ -125,6 +147,9 @@ class reader_permit::impl
         , _base_resources(base_resources)
         , _timeout(timeout)
     {
+        if (_semaphore.is_count_limit_adaptive()) {
+            _created_at = std::chrono::steady_clock::now();
+        }
         _semaphore.on_permit_created(*this);
     }
     impl(reader_concurrency_semaphore& semaphore, const schema* const schema, sstring&& op_name, reader_resources base_resources, db::timeout_clock::time_point timeout)
@@ -135,13 +160,26 @@ class reader_permit::impl
         , _base_resources(base_resources)
         , _timeout(timeout)
     {
+        if (_semaphore.is_count_limit_adaptive()) {
+            _created_at = std::chrono::steady_clock::now();
+        }
         _semaphore.on_permit_created(*this);
     }
     ~impl() {
+        // Paused reads wait for their next page while admitted, that's not service time.
+        if (_admitted_at != std::chrono::steady_clock::time_point{} && _created_at != std::chrono::steady_clock::time_point{} && !_was_inactive) {
+            _semaphore.on_read_done(_admitted_at - _created_at, std::chrono::steady_clock::now() - _admitted_at);
+        }
+
         if (_base_resources_consumed) {
             signal(_base_resources);
         }
 
+        if (auto footprint = _arena.memory_footprint()) {
+            signal(reader_resources::with_memory(footprint));
+            _arena.clear();
+        }
+
         if (_resources) {
             on_internal_error_noexcept(rcslog, format("reader_permit::impl::~impl(): permit {} detected a leak of {{count={}, memory={}}} resources",
                         description(),
@@ -194,13 +232,17 @@ class reader_permit::impl
     void on_admission() {
         assert(_state != reader_permit::state::active_blocked);
         on_permit_active();
-        consume(_base_resources);
         _base_resources_consumed = true;
+        consume(_base_resources);
+        if (_semaphore.is_count_limit_adaptive()) {
+            _admitted_at = std::chrono::steady_clock::now();
+        }
     }
 
     void on_register_as_inactive() {
         assert(_state == reader_permit::state::active_unused || _state == reader_permit::state::active_used);
         on_permit_inactive(reader_permit::state::inactive);
+        _was_inactive = true;
     }
 
     void on_unregister_as_inactive() {
@@ -220,6 +262,11 @@ class reader_permit::impl
     void consume(reader_resources res) {
         _resources += res;
         _semaphore.consume(res);
+        _max_consumed_memory = std::max(_max_consumed_memory, _resources.memory - (_base_resources_consumed ? _base_resources.memory : 0));
+    }
+
+    ssize_t max_consumed_memory() const {
+        return _max_consumed_memory;
     }
 
     void signal(reader_resources res) {
@@ -321,9 +368,25 @@ class reader_permit::impl
         return _max_result_size;
     }
 
+    std::pmr::memory_resource& get_arena() noexcept {
+        return _arena;
+    }
+
+    reader_permit::read_stats& stats() noexcept {
+        return _stats;
+    }
+
     void set_max_result_size(query::max_result_size s) {
         _max_result_size = std::move(s);
     }
+
+    reader_concurrency_semaphore::admission_lane lane() const {
+        return _lane;
+    }
+
+    void set_lane(reader_concurrency_semaphore::admission_lane lane) {
+        _lane = lane;
+    }
 };
 
 static_assert(std::is_nothrow_copy_constructible_v<reader_permit>);
@@ -388,6 +451,10 @@ reader_resources reader_permit::base_resources() const {
     return _impl->base_resources();
 }
 
+ssize_t reader_permit::max_consumed_memory() const {
+    return _impl->max_consumed_memory();
+}
+
 void reader_permit::release_base_resources() noexcept {
     return _impl->release_base_resources();
 }
@@ -428,6 +495,18 @@ void reader_permit::set_max_result_size(query::max_result_size s) {
     _impl->set_max_result_size(std::move(s));
 }
 
+std::pmr::memory_resource& reader_permit::arena() {
+    return _impl->get_arena();
+}
+
+reader_permit::read_stats& reader_permit::stats() noexcept {
+    return _impl->stats();
+}
+
+const reader_permit::read_stats& reader_permit::stats() const noexcept {
+    return _impl->stats();
+}
+
 std::ostream& operator<<(std::ostream& os, reader_permit::state s) {
     switch (s) {
         case reader_permit::state::waiting:
@@ -545,8 +624,8 @@ static void do_dump_reader_permit_diagnostics(std::ostream& os, const reader_con
 
     fmt::print(os, "Semaphore {} with {}/{} count and {}/{} memory resources: {}, dumping permit diagnostics:\n",
             semaphore.name(),
-            semaphore.initial_resources().count - semaphore.available_resources().count,
-            semaphore.initial_resources().count,
+            semaphore.count_limit() - semaphore.available_resources().count,
+            semaphore.count_limit(),
             semaphore.initial_resources().memory - semaphore.available_resources().memory,
             semaphore.initial_resources().memory,
             problem);
@@ -631,7 +710,9 @@ void reader_concurrency_semaphore::signal(const resources& r) noexcept {
 reader_concurrency_semaphore::reader_concurrency_semaphore(int count, ssize_t memory, sstring name, size_t max_queue_length)
     : _initial_resources(count, memory)
     , _resources(count, memory)
+    , _count_limit(count)
     , _wait_list(expiry_handler(*this))
+    , _fast_wait_list(expiry_handler(*this))
     , _ready_list(max_queue_length)
     , _name(std::move(name))
     , _max_queue_length(max_queue_length)
@@ -663,9 +744,9 @@ reader_concurrency_semaphore::inactive_read_handle reader_concurrency_semaphore:
     permit_impl.on_register_as_inactive();
     // Implies _inactive_reads.empty(), we don't queue new readers before
     // evicting all inactive reads.
-    // Checking the _wait_list covers the count resources only, so check memory
+    // Checking the wait lists covers the count resources only, so check memory
     // separately.
-    if (_wait_list.empty() && _resources.memory > 0) {
+    if (!waiters() && _resources.memory > 0) {
       try {
         auto irp = std::make_unique<inactive_read>(std::move(reader));
         auto& ir = *irp;
@@ -750,6 +831,9 @@ std::runtime_error reader_concurrency_semaphore::stopped_exception() {
 future<> reader_concurrency_semaphore::stop() noexcept {
     assert(!_stopped);
     _stopped = true;
+    if (_limit_controller) {
+        _limit_controller->adjustment_timer.cancel();
+    }
     co_await stop_ext_pre();
     clear_inactive_reads();
     co_await _close_readers_gate.close();
@@ -806,7 +890,7 @@ void reader_concurrency_semaphore::close_reader(flat_mutation_reader_v2 reader)
 bool reader_concurrency_semaphore::has_available_units(const resources& r) const {
     // Special case: when there is no active reader (based on count) admit one
     // regardless of availability of memory.
-    return (bool(_resources) && _resources >= r) || _resources.count == _initial_resources.count;
+    return (bool(_resources) && _resources >= r) || _resources.count == _count_limit;
 }
 
 bool reader_concurrency_semaphore::all_used_permits_are_stalled() const {
@@ -814,7 +898,7 @@ bool reader_concurrency_semaphore::all_used_permits_are_stalled() const {
 }
 
 std::exception_ptr reader_concurrency_semaphore::check_queue_size(std::string_view queue_name) {
-    if ((_wait_list.size() + _ready_list.size()) >= _max_queue_length) {
+    if ((waiters() + _ready_list.size()) >= _max_queue_length) {
         _stats.total_reads_shed_due_to_overload++;
         maybe_dump_reader_permit_diagnostics(*this, _permit_list, fmt::format("{} queue overload", queue_name));
         return std::make_exception_ptr(std::runtime_error(format("{}: {} queue overload", _name, queue_name)));
@@ -826,11 +910,15 @@ future<> reader_concurrency_semaphore::enqueue_waiter(reader_permit permit, read
     if (auto ex = check_queue_size("wait")) {
         return make_exception_future<>(std::move(ex));
     }
+    if (_limit_controller && _resources.count <= 0) {
+        _limit_controller->limit_reached = true;
+    }
     promise<> pr;
     auto fut = pr.get_future();
     permit.on_waiting();
     auto timeout = permit.timeout();
-    _wait_list.push_back(entry(std::move(pr), std::move(permit), std::move(func)), timeout);
+    auto& wait_list = permit._impl->lane() == admission_lane::fast ? _fast_wait_list : _wait_list;
+    wait_list.push_back(entry(std::move(pr), std::move(permit), std::move(func)), timeout);
     ++_stats.reads_enqueued;
     return fut;
 }
@@ -839,7 +927,7 @@ void reader_concurrency_semaphore::evict_readers_in_background() {
     // Evict inactive readers in the background while wait list isn't empty
     // This is safe since stop() closes _gate;
     (void)with_gate(_close_readers_gate, [this] {
-        return do_until([this] { return _wait_list.empty() || _inactive_reads.empty(); }, [this] {
+        return do_until([this] { return !waiters() || _inactive_reads.empty(); }, [this] {
             return detach_inactive_reader(_inactive_reads.front(), evict_reason::permit).close();
         });
     });
@@ -849,7 +937,14 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
     if (!_execution_loop_future) {
         _execution_loop_future.emplace(execution_loop());
     }
-    if (!_wait_list.empty() || !_ready_list.empty()) {
+    // Fast reads only queue behind other fast reads, the regular lane is
+    // given its turn in maybe_admit_waiters(). Fast reads admitted past
+    // waiting regular reads count towards max_consecutive_fast_admissions
+    // too, or a steady stream of them would starve the regular reads.
+    const bool fast = permit._impl->lane() == admission_lane::fast;
+    const bool bypasses_regular_reads = fast && !_wait_list.empty();
+    if (!_fast_wait_list.empty() || (!fast && !_wait_list.empty()) || !_ready_list.empty()
+            || (bypasses_regular_reads && _consecutive_fast_admissions >= max_consecutive_fast_admissions)) {
         return enqueue_waiter(std::move(permit), std::move(func));
     }
 
@@ -867,18 +962,44 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
 
     permit.on_admission();
     ++_stats.reads_admitted;
+    if (fast) {
+        ++_stats.reads_admitted_fast_lane;
+    }
+    if (bypasses_regular_reads) {
+        ++_consecutive_fast_admissions;
+    }
     if (func) {
         return with_ready_permit(std::move(permit), std::move(func));
     }
     return make_ready_future<>();
 }
 
+expiring_fifo<reader_concurrency_semaphore::entry, reader_concurrency_semaphore::expiry_handler, db::timeout_clock>*
+reader_concurrency_semaphore::next_wait_list() noexcept {
+    if (_fast_wait_list.empty()) {
+        return _wait_list.empty() ? nullptr : &_wait_list;
+    }
+    if (!_wait_list.empty() && _consecutive_fast_admissions >= max_consecutive_fast_admissions) {
+        return &_wait_list;
+    }
+    return &_fast_wait_list;
+}
+
 void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
-    while (!_wait_list.empty() && _ready_list.empty() && has_available_units(_wait_list.front().permit.base_resources()) && all_used_permits_are_stalled()) {
-        auto& x = _wait_list.front();
+    auto* wait_list = next_wait_list();
+    while (wait_list && _ready_list.empty() && has_available_units(wait_list->front().permit.base_resources()) && all_used_permits_are_stalled()) {
+        auto& x = wait_list->front();
+        if (wait_list == &_fast_wait_list && !_wait_list.empty()) {
+            ++_consecutive_fast_admissions;
+        } else {
+            _consecutive_fast_admissions = 0;
+        }
         try {
             x.permit.on_admission();
             ++_stats.reads_admitted;
+            if (wait_list == &_fast_wait_list) {
+                ++_stats.reads_admitted_fast_lane;
+            }
             if (x.func) {
                 _ready_list.push(std::move(x));
             } else {
@@ -887,7 +1008,8 @@ void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
         } catch (...) {
             x.pr.set_exception(std::current_exception());
         }
-        _wait_list.pop_front();
+        wait_list->pop_front();
+        wait_list = next_wait_list();
     }
 }
 
@@ -904,6 +1026,73 @@ void reader_concurrency_semaphore::on_permit_destroyed(reader_permit::impl& perm
     --_stats.current_permits;
 }
 
+void reader_concurrency_semaphore::set_count_limit(int limit) noexcept {
+    _resources.count += limit - _count_limit;
+    _count_limit = limit;
+    maybe_admit_waiters();
+}
+
+void reader_concurrency_semaphore::enable_adaptive_count_limit(int min, int max) {
+    _limit_controller = std::make_unique<count_limit_controller>();
+    _limit_controller->min = std::max(min, 1);
+    _limit_controller->max = std::max(max, _limit_controller->min);
+    _limit_controller->adjustment_timer.set_callback([this] { adjust_count_limit(); });
+    set_count_limit(std::clamp(_count_limit, _limit_controller->min, _limit_controller->max));
+    _limit_controller->adjustment_timer.arm_periodic(count_limit_adjustment_period);
+}
+
+void reader_concurrency_semaphore::on_read_done(std::chrono::steady_clock::duration queue_time, std::chrono::steady_clock::duration service_time) noexcept {
+    if (!_limit_controller) {
+        return;
+    }
+    ++_limit_controller->reads;
+    _limit_controller->queue_time += queue_time;
+    _limit_controller->service_time += service_time;
+}
+
+void reader_concurrency_semaphore::adjust_count_limit() noexcept {
+    // Too few reads to tell their latency apart from noise.
+    static constexpr uint64_t min_reads = 16;
+    // How far the service time may grow over the uncontended one before the limit is decreased.
+    static constexpr double tolerated_service_time_growth = 1.1;
+    // The baseline drifts up by this factor per period, so that it doesn't stay stuck at an outlier.
+    static constexpr double base_service_time_drift = 1.01;
+
+    auto& c = *_limit_controller;
+    auto reset = defer([&c] () noexcept {
+        c.reads = 0;
+        c.queue_time = {};
+        c.service_time = {};
+        c.limit_reached = false;
+    });
+    if (c.reads < min_reads) {
+        return;
+    }
+    using seconds = std::chrono::duration<double>;
+    c.last_queue_time = std::chrono::duration_cast<seconds>(c.queue_time).count() / c.reads;
+    c.last_service_time = std::chrono::duration_cast<seconds>(c.service_time).count() / c.reads;
+    if (!c.base_service_time || c.last_service_time < c.base_service_time) {
+        c.base_service_time = c.last_service_time;
+    } else {
+        c.base_service_time = std::min(c.last_service_time, c.base_service_time * base_service_time_drift);
+    }
+
+    double limit = _count_limit;
+    if (c.last_service_time > c.base_service_time * tolerated_service_time_growth) {
+        // Reads take longer than they do without contention, admitting them
+        // sooner would only move their wait from our queue to the disk's.
+        limit *= std::max(c.base_service_time / c.last_service_time, 0.5);
+    } else if (c.limit_reached) {
+        limit += std::max(std::sqrt(limit), 1.0);
+    }
+    auto new_limit = std::clamp(int(limit), c.min, c.max);
+    if (new_limit != _count_limit) {
+        rcslog.debug("Semaphore {}: changing the count limit from {} to {}, service time {:.6f}s (base {:.6f}s), queue time {:.6f}s",
+                _name, _count_limit, new_limit, c.last_service_time, c.base_service_time, c.last_queue_time);
+        set_count_limit(new_limit);
+    }
+}
+
 void reader_concurrency_semaphore::on_permit_used() noexcept {
     ++_stats.used_permits;
 }
@@ -927,16 +1116,18 @@ void reader_concurrency_semaphore::on_permit_unblocked() noexcept {
 }
 
 future<reader_permit> reader_concurrency_semaphore::obtain_permit(const schema* const schema, const char* const op_name, size_t memory,
-        db::timeout_clock::time_point timeout) {
+        db::timeout_clock::time_point timeout, admission_lane lane) {
     auto permit = reader_permit(*this, schema, std::string_view(op_name), {1, static_cast<ssize_t>(memory)}, timeout);
+    permit._impl->set_lane(lane);
     return do_wait_admission(permit).then([permit] () mutable {
         return std::move(permit);
     });
 }
 
 future<reader_permit> reader_concurrency_semaphore::obtain_permit(const schema* const schema, sstring&& op_name, size_t memory,
-        db::timeout_clock::time_point timeout) {
+        db::timeout_clock::time_point timeout, admission_lane lane) {
     auto permit = reader_permit(*this, schema, std::move(op_name), {1, static_cast<ssize_t>(memory)}, timeout);
+    permit._impl->set_lane(lane);
     return do_wait_admission(permit).then([permit] () mutable {
         return std::move(permit);
     });
@@ -951,8 +1142,10 @@ reader_permit reader_concurrency_semaphore::make_tracking_only_permit(const sche
 }
 
 future<> reader_concurrency_semaphore::with_permit(const schema* const schema, const char* const op_name, size_t memory,
-        db::timeout_clock::time_point timeout, read_func func) {
-    return do_wait_admission(reader_permit(*this, schema, std::string_view(op_name), {1, static_cast<ssize_t>(memory)}, timeout), std::move(func));
+        db::timeout_clock::time_point timeout, read_func func, admission_lane lane) {
+    auto permit = reader_permit(*this, schema, std::string_view(op_name), {1, static_cast<ssize_t>(memory)}, timeout);
+    permit._impl->set_lane(lane);
+    return do_wait_admission(std::move(permit), std::move(func));
 }
 
 future<> reader_concurrency_semaphore::with_ready_permit(reader_permit permit, read_func func) {
@@ -969,9 +1162,11 @@ void reader_concurrency_semaphore::broken(std::exception_ptr ex) {
     if (!ex) {
         ex = std::make_exception_ptr(broken_semaphore{});
     }
-    while (!_wait_list.empty()) {
-        _wait_list.front().pr.set_exception(ex);
-        _wait_list.pop_front();
+    for (auto* wait_list : {&_fast_wait_list, &_wait_list}) {
+        while (!wait_list->empty()) {
+            wait_list->front().pr.set_exception(ex);
+            wait_list->pop_front();
+        }
     }
 }
 
@@ -986,12 +1181,20 @@ std::string reader_concurrency_semaphore::dump_diagnostics(unsigned max_lines) c
 class tracking_file_impl : public file_impl {
     file _tracked_file;
     reader_permit _permit;
+    uint64_t reader_permit::read_stats::* _read_us;
+
+    auto account_read_latency() {
+        return [this, start = std::chrono::steady_clock::now()] () noexcept {
+            _permit.stats().*_read_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        };
+    }
 
 public:
-    tracking_file_impl(file file, reader_permit permit)
+    tracking_file_impl(file file, reader_permit permit, tracked_file_kind kind)
         : file_impl(*get_file_impl(file))
         , _tracked_file(std::move(file))
-        , _permit(std::move(permit)) {
+        , _permit(std::move(permit))
+        , _read_us(kind == tracked_file_kind::index ? &reader_permit::read_stats::index_read_us : &reader_permit::read_stats::data_read_us) {
     }
 
     tracking_file_impl(const tracking_file_impl&) = delete;
@@ -1008,11 +1211,19 @@ class tracking_file_impl : public file_impl {
     }
 
     virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->read_dma(pos, buffer, len, pc);
+        return get_file_impl(_tracked_file)->read_dma(pos, buffer, len, pc).then([this, account = account_read_latency()] (size_t read) {
+            account();
+            _permit.stats().disk_bytes_read += read;
+            return read;
+        });
     }
 
     virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->read_dma(pos, iov, pc);
+        return get_file_impl(_tracked_file)->read_dma(pos, iov, pc).then([this, account = account_read_latency()] (size_t read) {
+            account();
+            _permit.stats().disk_bytes_read += read;
+            return read;
+        });
     }
 
     virtual future<> flush(void) override {
@@ -1052,12 +1263,14 @@ class tracking_file_impl : public file_impl {
     }
 
     virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([this, units = _permit.consume_memory(range_size)] (temporary_buffer<uint8_t> buf) {
+        return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([this, units = _permit.consume_memory(range_size), account = account_read_latency()] (temporary_buffer<uint8_t> buf) {
+            account();
+            _permit.stats().disk_bytes_read += buf.size();
             return make_ready_future<temporary_buffer<uint8_t>>(make_tracked_temporary_buffer(std::move(buf), _permit));
         });
     }
 };
 
-file make_tracked_file(file f, reader_permit p) {
-    return file(make_shared<tracking_file_impl>(f, std::move(p)));
+file make_tracked_file(file f, reader_permit p, tracked_file_kind kind) {
+    return file(make_shared<tracking_file_impl>(f, std::move(p), kind));
 }
@@ -12,8 +12,10 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/queue.hh>
+#include <seastar/core/timer.hh>
 #include "reader_permit.hh"
 #include "flat_mutation_reader_v2.hh"
+#include "utils/spill_file.hh"
 
 namespace bi = boost::intrusive;
 
@@ -43,6 +45,23 @@ using namespace seastar;
 /// The semaphore also acts as an execution stage for reads. This
 /// functionality is exposed via \ref with_permit() and \ref
 /// with_ready_permit().
+///
+/// Reads are admitted by the memory they are estimated to cost (see
+/// `replica::table::estimate_read_memory_cost()`), which is consumed as their
+/// base resources. Short reads, e.g. single-partition ones, can be admitted
+/// through the fast lane, which has its own wait queue, served before the
+/// regular one. This way short reads don't wait for scans queued before them.
+/// To avoid starving the regular lane, at most `max_consecutive_fast_admissions`
+/// fast reads are admitted in a row while regular reads are waiting.
+///
+/// The count limit can be tuned from the latency of reads, see
+/// `enable_adaptive_count_limit()`. Every `count_limit_adjustment_period`, the
+/// average service time of the reads done in the period, from admission to the
+/// destruction of their permit, is compared with the service time seen without
+/// contention, like TCP Vegas compares round-trip times. When it has grown, the
+/// reads queue in the disk or the CPU, and the limit is decreased in proportion.
+/// Otherwise, if the limit made reads wait for admission, it is increased by the
+/// square root of its value. The memory limit stays fixed.
 class reader_concurrency_semaphore {
 public:
     using resources = reader_resources;
@@ -57,6 +76,13 @@ class reader_concurrency_semaphore {
 
     using eviction_notify_handler = noncopyable_function<void(evict_reason)>;
 
+    enum class admission_lane {
+        regular,
+        fast, // for short reads, see the class comment
+    };
+
+    static constexpr unsigned max_consecutive_fast_admissions = 16;
+
     struct stats {
         // The number of inactive reads evicted to free up permits.
         uint64_t permit_based_evictions = 0;
@@ -74,6 +100,10 @@ class reader_concurrency_semaphore {
         uint64_t reads_admitted = 0;
         // Total number of reads enqueued to wait for admission.
         uint64_t reads_enqueued = 0;
+        // Total number of reads admitted through the fast lane.
+        uint64_t reads_admitted_fast_lane = 0;
+        // Total number of bytes reads wrote to spill files.
+        uint64_t spilled_bytes = 0;
         // Total number of permits created so far.
         uint64_t total_permits = 0;
         // Current number of permits.
@@ -169,14 +199,40 @@ class reader_concurrency_semaphore {
     };
 
 private:
+    struct count_limit_controller {
+        int min = 1;
+        int max = 1;
+        timer<lowres_clock> adjustment_timer;
+        // Reads done in the current period, and the sums of their times.
+        uint64_t reads = 0;
+        std::chrono::steady_clock::duration queue_time{};
+        std::chrono::steady_clock::duration service_time{};
+        // Whether reads waited for admission because of the count limit.
+        bool limit_reached = false;
+        // The service time without contention, in seconds: the lowest period
+        // average seen, drifting up slowly to follow changes of the workload.
+        double base_service_time = 0;
+        // The averages of the last period with enough reads, in seconds.
+        double last_queue_time = 0;
+        double last_service_time = 0;
+    };
+
     const resources _initial_resources;
     resources _resources;
+    // The count limit, which _resources.count starts from.
+    int _count_limit;
+    std::unique_ptr<count_limit_controller> _limit_controller;
 
     expiring_fifo<entry, expiry_handler, db::timeout_clock> _wait_list;
+    expiring_fifo<entry, expiry_handler, db::timeout_clock> _fast_wait_list;
+    // The number of fast reads admitted in a row while regular reads were waiting.
+    unsigned _consecutive_fast_admissions = 0;
     queue<entry> _ready_list;
 
     sstring _name;
     size_t _max_queue_length = std::numeric_limits<size_t>::max();
+    sstring _spill_directory;
+    utils::spill_disk_budget _spill_budget;
     inactive_reads_type _inactive_reads;
     stats _stats;
     permit_list_type _permit_list;
@@ -200,6 +256,8 @@ class reader_concurrency_semaphore {
     future<> enqueue_waiter(reader_permit permit, read_func func);
     void evict_readers_in_background();
     future<> do_wait_admission(reader_permit permit, read_func func = {});
+    // The wait queue to admit the next waiter from, nullptr if both are empty.
+    expiring_fifo<entry, expiry_handler, db::timeout_clock>* next_wait_list() noexcept;
     void maybe_admit_waiters() noexcept;
 
     void on_permit_created(reader_permit::impl&);
@@ -218,7 +276,15 @@ class reader_concurrency_semaphore {
 
     future<> execution_loop() noexcept;
 
+    bool is_count_limit_adaptive() const noexcept {
+        return bool(_limit_controller);
+    }
+    void on_read_done(std::chrono::steady_clock::duration queue_time, std::chrono::steady_clock::duration service_time) noexcept;
+    void adjust_count_limit() noexcept;
+
 public:
+    static constexpr std::chrono::seconds count_limit_adjustment_period{1};
+
     struct no_limits { };
 
     /// Create a semaphore with the specified limits
@@ -337,8 +403,13 @@ class reader_concurrency_semaphore {
     ///
     /// Some permits cannot be associated with any table, so passing nullptr as
     /// the schema parameter is allowed.
-    future<reader_permit> obtain_permit(const schema* const schema, const char* const op_name, size_t memory, db::timeout_clock::time_point timeout);
-    future<reader_permit> obtain_permit(const schema* const schema, sstring&& op_name, size_t memory, db::timeout_clock::time_point timeout);
+    ///
+    /// The memory is the estimated cost of the read, consumed as the base
+    /// resources of the permit. Pass admission_lane::fast for short reads.
+    future<reader_permit> obtain_permit(const schema* const schema, const char* const op_name, size_t memory, db::timeout_clock::time_point timeout,
+            admission_lane lane = admission_lane::regular);
+    future<reader_permit> obtain_permit(const schema* const schema, sstring&& op_name, size_t memory, db::timeout_clock::time_point timeout,
+            admission_lane lane = admission_lane::regular);
 
     /// Make a tracking only permit
     ///
@@ -375,7 +446,8 @@ class reader_concurrency_semaphore {
     ///
     /// Some permits cannot be associated with any table, so passing nullptr as
     /// the schema parameter is allowed.
-    future<> with_permit(const schema* const schema, const char* const op_name, size_t memory, db::timeout_clock::time_point timeout, read_func func);
+    future<> with_permit(const schema* const schema, const char* const op_name, size_t memory, db::timeout_clock::time_point timeout, read_func func,
+            admission_lane lane = admission_lane::regular);
 
     /// Run the function through the semaphore's execution stage with a pre-admitted permit
     ///
@@ -405,7 +477,7 @@ class reader_concurrency_semaphore {
     void signal(const resources& r) noexcept;
 
     size_t waiters() const {
-        return _wait_list.size();
+        return _wait_list.size() + _fast_wait_list.size();
     }
 
     void broken(std::exception_ptr ex = {});
@@ -416,7 +488,44 @@ class reader_concurrency_semaphore {
     /// Use 0 for unlimited.
     std::string dump_diagnostics(unsigned max_lines = 0) const;
 
+    /// Reads admitted by this semaphore write the state they can't keep
+    /// in memory to this directory, see utils::spill_file, as long as their
+    /// files take less than max_disk_usage bytes. Empty disables spilling.
+    void set_spill_directory(sstring dir, uint64_t max_disk_usage) {
+        _spill_directory = std::move(dir);
+        _spill_budget.set_max(max_disk_usage);
+    }
+
+    const sstring& spill_directory() const {
+        return _spill_directory;
+    }
+
+    utils::spill_disk_budget& spill_budget() noexcept {
+        return _spill_budget;
+    }
+
     void set_max_queue_length(size_t size) {
         _max_queue_length = size;
     }
+
+    /// Changes the number of reads admitted concurrently. Reads already
+    /// admitted beyond a lowered limit are left to complete.
+    void set_count_limit(int limit) noexcept;
+
+    int count_limit() const noexcept {
+        return _count_limit;
+    }
+
+    /// Tunes the count limit between min and max from the latency of reads,
+    /// see the class comment.
+    void enable_adaptive_count_limit(int min, int max);
+
+    /// The average time reads waited for admission, and spent admitted, in
+    /// the last period the adaptive count limit was adjusted in, in seconds.
+    double average_queue_time() const noexcept {
+        return _limit_controller ? _limit_controller->last_queue_time : 0;
+    }
+    double average_service_time() const noexcept {
+        return _limit_controller ? _limit_controller->last_service_time : 0;
+    }
 };
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <seastar/util/optimized_optional.hh>
 #include "seastarx.hh"
 
@@ -91,6 +92,30 @@ class reader_permit {
         evicted,
     };
 
+    /// What the read cost, accumulated over the life of the permit.
+    struct read_stats {
+        uint64_t disk_bytes_read = 0;
+        uint64_t cache_row_hits = 0;
+        uint64_t cache_row_misses = 0;
+        // Time spent waiting for sstable index and data file reads, in
+        // microseconds. Concurrent reads (read-ahead) are all counted.
+        uint64_t index_read_us = 0;
+        uint64_t data_read_us = 0;
+
+        read_stats& operator+=(const read_stats& o) noexcept {
+            disk_bytes_read += o.disk_bytes_read;
+            cache_row_hits += o.cache_row_hits;
+            cache_row_misses += o.cache_row_misses;
+            index_read_us += o.index_read_us;
+            data_read_us += o.data_read_us;
+            return *this;
+        }
+        read_stats operator-(const read_stats& o) const noexcept {
+            return read_stats{disk_bytes_read - o.disk_bytes_read, cache_row_hits - o.cache_row_hits, cache_row_misses - o.cache_row_misses,
+                    index_read_us - o.index_read_us, data_read_us - o.data_read_us};
+        }
+    };
+
     class impl;
 
 private:
@@ -148,6 +173,9 @@ class reader_permit {
 
     reader_resources base_resources() const;
 
+    /// The most memory the read consumed at any one time, besides its base resources.
+    ssize_t max_consumed_memory() const;
+
     void release_base_resources() noexcept;
 
     sstring description() const;
@@ -158,6 +186,16 @@ class reader_permit {
 
     query::max_result_size max_result_size() const;
     void set_max_result_size(query::max_result_size);
+
+    /// A bump arena for the temporaries of the read, freed all at once with
+    /// the permit. The memory it holds is consumed from the permit.
+    /// Deallocating from it is a no-op, so it's only suitable for objects
+    /// which don't churn: don't put anything in it which is repeatedly
+    /// allocated and freed over the life of the read.
+    std::pmr::memory_resource& arena();
+
+    read_stats& stats() noexcept;
+    const read_stats& stats() const noexcept;
 };
 
 using reader_permit_opt = optimized_optional<reader_permit>;
@@ -237,7 +275,11 @@ temporary_buffer<Char> make_tracked_temporary_buffer(temporary_buffer<Char> buf,
             make_deleter(buf.release(), [units = permit.consume_memory(buf.size())] () mutable { units.reset(); }));
 }
 
-file make_tracked_file(file f, reader_permit p);
+enum class tracked_file_kind { data, index };
+
+/// Accounts the memory of the reads of \p f to \p p, and their bytes and
+/// latency to its read_stats.
+file make_tracked_file(file f, reader_permit p, tracked_file_kind kind = tracked_file_kind::data);
 
 template <typename T>
 class tracking_allocator {
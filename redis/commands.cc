@@ -18,6 +18,7 @@
 #include "redis/mutation_utils.hh"
 #include "redis/lolwut.hh"
 #include "redis/keyspace_utils.hh"
+#include <charconv>
 
 namespace redis {
 
@@ -36,20 +37,46 @@ future<redis_message> get(service::storage_proxy& proxy, request& req, redis::re
     });
 }
 
+future<redis_message> mget(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 1) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    return redis::read_multiple_strings(proxy, options, req._args, permit).then([&req] (auto result) {
+        // return nil for each key which does not exist
+        std::vector<bytes_opt> values;
+        values.reserve(req._args.size());
+        for (auto& key : req._args) {
+            auto it = result->find(key);
+            values.push_back(it != result->end() ? bytes_opt(it->second) : bytes_opt());
+        }
+        return redis_message::make_multi_strings_result(values);
+    });
+}
+
+future<redis_message> mset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 2 || req.arguments_size() % 2 != 0) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    std::vector<std::pair<bytes, bytes>> keys_and_data;
+    keys_and_data.reserve(req.arguments_size() / 2);
+    for (size_t i = 0; i < req.arguments_size(); i += 2) {
+        keys_and_data.emplace_back(std::move(req._args[i]), std::move(req._args[i + 1]));
+    }
+    return redis::write_multiple_strings(proxy, options, std::move(keys_and_data), permit).then([] {
+        return redis_message::ok();
+    });
+}
+
 future<redis_message> exists(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() < 1) {
         throw wrong_arguments_exception(1, req.arguments_size(), req._command);
     }
-    return do_with(size_t(0), [&proxy, &options, permit, &req] (size_t& count) {
-        return seastar::do_for_each(req._args, [&proxy, &options, permit, &count] (auto& key) {
-            return redis::read_strings(proxy, options, key, permit).then([&count] (lw_shared_ptr<strings_result> result) {
-                if (result->has_result()) {
-                    count++;
-                }
-            });
-        }).then([&count] () {
-            return redis_message::number(count);
+    return redis::read_multiple_strings(proxy, options, req._args, permit).then([&req] (auto result) {
+        // a key given more than once is counted as many times
+        auto count = std::count_if(req._args.begin(), req._args.end(), [&result] (const bytes& key) {
+            return result->contains(key);
         });
+        return redis_message::number(count);
     });
 }
 
@@ -110,11 +137,40 @@ future<redis_message> hget(service::storage_proxy& proxy, request& req, redis::r
 }
 
 future<redis_message> hset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
-    if (req.arguments_size() != 3) {
+    if (req.arguments_size() < 3 || req.arguments_size() % 2 != 1) {
         throw wrong_number_of_arguments_exception(req._command);
     }
-    return redis::write_hashes(proxy, options, std::move(req._args[0]), std::move(req._args[1]), std::move(req._args[2]), 0, permit).then([] {
-        return redis_message::one();
+    if (req.arguments_size() == 3) {
+        return redis::write_hashes(proxy, options, std::move(req._args[0]), std::move(req._args[1]), std::move(req._args[2]), 0, permit).then([] {
+            return redis_message::one();
+        });
+    }
+    //FIXME: We should return the count of the fields which were actually added.
+    std::vector<std::pair<bytes, bytes>> fields_and_data;
+    fields_and_data.reserve(req.arguments_size() / 2);
+    for (size_t i = 1; i < req.arguments_size(); i += 2) {
+        fields_and_data.emplace_back(std::move(req._args[i]), std::move(req._args[i + 1]));
+    }
+    auto size = fields_and_data.size();
+    return redis::write_multiple_hashes(proxy, options, std::move(req._args[0]), std::move(fields_and_data), permit).then([size] {
+        return redis_message::number(size);
+    });
+}
+
+future<redis_message> hmget(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 2) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    auto fields = std::vector<bytes>(req._args.begin() + 1, req._args.end());
+    return redis::read_hashes(proxy, options, req._args[0], fields, permit).then([fields] (auto result) {
+        // return nil for each field which does not exist
+        std::vector<bytes_opt> values;
+        values.reserve(fields.size());
+        for (auto& field : fields) {
+            auto it = result->find(field);
+            values.push_back(it != result->end() ? bytes_opt(it->second) : bytes_opt());
+        }
+        return redis_message::make_multi_strings_result(values);
     });
 }
 
@@ -184,6 +240,65 @@ future<redis_message> del(service::storage_proxy& proxy, request& req, redis::re
     });
 }
 
+static future<redis_message> push(service::storage_proxy& proxy, request& req, redis::redis_options& options, bool at_head, service_permit permit) {
+    if (req.arguments_size() < 2) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    //FIXME: We should return the length of the list after the push.
+    auto values = std::vector<bytes>(std::make_move_iterator(req._args.begin() + 1), std::make_move_iterator(req._args.end()));
+    auto size = values.size();
+    return redis::push_list(proxy, options, std::move(req._args[0]), std::move(values), at_head, permit).then([size] {
+        return redis_message::number(size);
+    });
+}
+
+future<redis_message> lpush(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    return push(proxy, req, options, true, permit);
+}
+
+future<redis_message> rpush(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    return push(proxy, req, options, false, permit);
+}
+
+// Parses an integer argument, which, unlike with std::stol, has to be
+// all digits, with an optional sign.
+static long parse_integer(const bytes& arg) {
+    auto begin = reinterpret_cast<const char*>(arg.data());
+    auto end = begin + arg.size();
+    long value;
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    if (ec != std::errc() || ptr != end) {
+        throw std::invalid_argument(format("invalid integer: {}", std::string_view(begin, arg.size())));
+    }
+    return value;
+}
+
+future<redis_message> lrange(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() != 3) {
+        throw wrong_arguments_exception(3, req.arguments_size(), req._command);
+    }
+    long start, stop;
+    try {
+        start = parse_integer(req._args[1]);
+        stop = parse_integer(req._args[2]);
+    } catch (...) {
+        throw invalid_arguments_exception(req._command);
+    }
+    // Indexes from the head only need the head of the list, which is a
+    // slice of its rows. Indexes from the tail need all of it.
+    uint64_t row_limit = start >= 0 && stop >= 0 ? uint64_t(stop) + 1 : query::max_rows;
+    return redis::read_list(proxy, options, req._args[0], row_limit, permit).then([start, stop] (auto result) mutable {
+        long size = result->size();
+        start = std::max(start < 0 ? size + start : start, 0L);
+        stop = std::min(stop < 0 ? size + stop : stop, size - 1);
+        std::vector<bytes_opt> values;
+        for (long i = start; i <= stop; ++i) {
+            values.emplace_back(std::move((*result)[i]));
+        }
+        return redis_message::make_multi_strings_result(values);
+    });
+}
+
 future<redis_message> select(service::storage_proxy&, request& req, redis::redis_options& options, service_permit) {
     if (req.arguments_size() != 1) {
         throw wrong_arguments_exception(1, req.arguments_size(), req._command);
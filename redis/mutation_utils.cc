@@ -15,6 +15,8 @@
 #include "redis/options.hh"
 #include "mutation.hh"
 #include "service_permit.hh"
+#include "utils/serialization.hh"
+#include "utils/UUID_gen.hh"
 
 using namespace seastar;
 
@@ -53,6 +55,55 @@ future<> write_hashes(service::storage_proxy& proxy, redis::redis_options& optio
     return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit);
 }
 
+future<> write_multiple_hashes(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<std::pair<bytes, bytes>>&& fields_and_data, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::HASHes);
+    const column_definition& column = *schema->get_column_definition(redis::DATA_COLUMN_NAME);
+    auto m = mutation(schema, partition_key::from_single_value(*schema, key));
+    // Each field is a row of its own, so setting some fields doesn't touch the others
+    for (auto& [field, data] : fields_and_data) {
+        auto ckey = clustering_key::from_single_value(*schema, field);
+        m.set_clustered_cell(ckey, column, make_cell(schema, *(column.type.get()), data));
+    }
+
+    auto write_consistency_level = options.get_write_consistency_level();
+    return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit);
+}
+
+// The position of an element in a list: the elements pushed at the tail get
+// increasing positions, and the ones pushed at the head decreasing ones, both
+// derived from the write timestamp. A timeuuid, unique to the node and shard
+// which generated it, tells apart elements pushed in the same microsecond by
+// different coordinators. The position is encoded so that it sorts as bytes
+// in the order of the list.
+static bytes make_list_position(api::timestamp_type ts, bool at_head) {
+    uint64_t position = uint64_t(at_head ? -ts : ts) ^ (uint64_t(1) << 63);
+    auto id = utils::UUID_gen::get_time_UUID();
+    bytes b(bytes::initialized_later(), sizeof(position) + 2 * sizeof(uint64_t));
+    auto out = reinterpret_cast<char*>(b.begin());
+    write_be(out, position);
+    write_be(out + sizeof(position), uint64_t(id.get_most_significant_bits()));
+    write_be(out + sizeof(position) + sizeof(uint64_t), uint64_t(id.get_least_significant_bits()));
+    return b;
+}
+
+future<> push_list(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<bytes>&& values, bool at_head, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::LISTs);
+    const column_definition& column = *schema->get_column_definition(redis::DATA_COLUMN_NAME);
+    auto m = mutation(schema, partition_key::from_single_value(*schema, key));
+    // api::new_timestamp() is increasing, so each value gets a position
+    // beyond the one of the value before it.
+    for (auto& value : values) {
+        auto ckey = clustering_key::from_single_value(*schema, make_list_position(api::new_timestamp(), at_head));
+        m.set_clustered_cell(ckey, column, make_cell(schema, *(column.type.get()), value));
+    }
+
+    auto write_consistency_level = options.get_write_consistency_level();
+    return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit);
+}
 
 mutation make_mutation(service::storage_proxy& proxy, const redis_options& options, bytes&& key, bytes&& data, long ttl) {
     auto schema = get_schema(proxy, options.get_keyspace_name(), redis::STRINGs);
@@ -71,6 +122,16 @@ future<> write_strings(service::storage_proxy& proxy, redis::redis_options& opti
     return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit);
 }
 
+future<> write_multiple_strings(service::storage_proxy& proxy, redis::redis_options& options, std::vector<std::pair<bytes, bytes>>&& keys_and_data, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+    std::vector<mutation> mutations;
+    mutations.reserve(keys_and_data.size());
+    for (auto& [key, data] : keys_and_data) {
+        mutations.push_back(make_mutation(proxy, options, std::move(key), std::move(data), 0));
+    }
+    auto write_consistency_level = options.get_write_consistency_level();
+    return proxy.mutate(std::move(mutations), write_consistency_level, timeout, nullptr, permit);
+}
 
 mutation make_tombstone(service::storage_proxy& proxy, const redis_options& options, const sstring& cf_name, const bytes& key) {
     auto schema = get_schema(proxy, options.get_keyspace_name(), cf_name);
@@ -21,7 +21,11 @@ namespace redis {
 class redis_options;
 
 future<> write_hashes(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, bytes&& field, bytes&& data, long ttl, service_permit permit);
+future<> write_multiple_hashes(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<std::pair<bytes, bytes>>&& fields_and_data, service_permit permit);
+// Adds the values at the head (or the tail) of a list, in the order given, as if each was pushed on its own.
+future<> push_list(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<bytes>&& values, bool at_head, service_permit permit);
 future<> write_strings(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, bytes&& data, long ttl, service_permit permit);
+future<> write_multiple_strings(service::storage_proxy& proxy, redis::redis_options& options, std::vector<std::pair<bytes, bytes>>&& keys_and_data, service_permit permit);
 future<> delete_objects(service::storage_proxy& proxy, redis::redis_options& options, std::vector<bytes>&& keys, service_permit permit);
 future<> delete_fields(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<bytes>&& fields, service_permit permit);
 
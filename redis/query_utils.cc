@@ -18,6 +18,7 @@
 #include "gc_clock.hh"
 #include "service_permit.hh"
 #include "redis/keyspace_utils.hh"
+#include <unordered_set>
 
 namespace redis {
 
@@ -85,6 +86,65 @@ future<lw_shared_ptr<strings_result>> query_strings(service::storage_proxy& prox
     });
 }
 
+class multiple_strings_result_builder {
+    lw_shared_ptr<std::unordered_map<bytes, bytes>> _data;
+    const query::partition_slice& _partition_slice;
+    const schema_ptr _schema;
+    bytes _key;
+public:
+    multiple_strings_result_builder(lw_shared_ptr<std::unordered_map<bytes, bytes>> data, const schema_ptr schema, const query::partition_slice& ps)
+        : _data(data)
+        , _partition_slice(ps)
+        , _schema(schema)
+    {
+    }
+    void accept_new_partition(const partition_key& key, uint32_t row_count) {
+        _key = key.explode(*_schema).front();
+    }
+    void accept_new_partition(uint32_t row_count) {}
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row) {
+        auto row_iterator = row.iterator();
+        for (auto&& id : _partition_slice.regular_columns) {
+            auto cell = row_iterator.next_atomic_cell();
+            if (cell) {
+                cell->value().with_linearized([this, &col = _schema->regular_column_at(id)] (bytes_view cell_view) {
+                    _data->insert_or_assign(_key, col.type->deserialize_value(cell_view).serialize_nonnull());
+                });
+            }
+        }
+    }
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {}
+    void accept_partition_end(const query::result_row_view& static_row) {}
+};
+
+future<lw_shared_ptr<std::unordered_map<bytes, bytes>>> read_multiple_strings(service::storage_proxy& proxy, const redis_options& options, const std::vector<bytes>& keys, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::STRINGs);
+    auto ps = partition_slice_builder(*schema)
+        .with_option<query::partition_slice::option::send_partition_key>()
+        .build();
+    dht::partition_range_vector partition_ranges;
+    partition_ranges.reserve(keys.size());
+    std::unordered_set<bytes> seen;
+    for (auto& key : keys) {
+        if (!seen.insert(key).second) {
+            continue;
+        }
+        auto pkey = partition_key::from_single_value(*schema, key);
+        partition_ranges.emplace_back(dht::partition_range::make_singular(dht::decorate_key(*schema, std::move(pkey))));
+    }
+    const auto max_result_size = proxy.get_max_result_size(ps);
+    const auto limit = partition_ranges.size();
+    query::read_command cmd(schema->id(), schema->version(), ps, limit, gc_clock::now(), std::nullopt, limit, utils::UUID(), query::is_first_page::no, max_result_size, 0);
+    auto read_consistency_level = options.get_read_consistency_level();
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_read_timeout();
+    return proxy.query(schema, make_lw_shared<query::read_command>(std::move(cmd)), std::move(partition_ranges), read_consistency_level, {timeout, permit, service::client_state::for_internal_calls()}).then([ps, schema] (auto qr) {
+        return query::result_view::do_with(*qr.query_result, [&] (query::result_view v) {
+            auto pd = make_lw_shared<std::unordered_map<bytes, bytes>>();
+            v.consume(ps, multiple_strings_result_builder(pd, schema, ps));
+            return pd;
+        });
+    });
+}
 
 class hashes_result_builder {
     lw_shared_ptr<std::map<bytes, bytes>> _data;
@@ -143,6 +203,28 @@ future<lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy
     return query_hashes(proxy, options, key, permit, schema, ps);
 }
 
+future<lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy& proxy, const redis_options& options, const bytes& key, const std::vector<bytes>& fields, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::HASHes);
+    // The ranges of a slice have to be sorted and disjoint
+    std::vector<clustering_key> ckeys;
+    ckeys.reserve(fields.size());
+    for (auto& field : fields) {
+        ckeys.push_back(clustering_key::from_single_value(*schema, field));
+    }
+    std::sort(ckeys.begin(), ckeys.end(), clustering_key::less_compare(*schema));
+    ckeys.erase(std::unique(ckeys.begin(), ckeys.end(), clustering_key::equality(*schema)), ckeys.end());
+    std::vector<query::clustering_range> clustering_ranges;
+    clustering_ranges.reserve(ckeys.size());
+    for (auto& ckey : ckeys) {
+        clustering_ranges.push_back(query::clustering_range::make_singular(std::move(ckey)));
+    }
+
+    auto ps = partition_slice_builder(*schema)
+        .with_ranges(std::move(clustering_ranges))
+        .build();
+    return query_hashes(proxy, options, key, permit, schema, ps);
+}
+
 future<lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_proxy& proxy, const redis_options& options, const bytes& key, service_permit permit, schema_ptr schema, query::partition_slice ps) {
     const auto max_result_size = proxy.get_max_result_size(ps);
     query::read_command cmd(schema->id(), schema->version(), ps, std::numeric_limits<uint32_t>::max(), gc_clock::now(), std::nullopt, 1, utils::UUID(), query::is_first_page::no, max_result_size, 0);
@@ -161,4 +243,54 @@ future<lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_prox
     });
 }
 
+class list_result_builder {
+    lw_shared_ptr<std::vector<bytes>> _data;
+    const query::partition_slice& _partition_slice;
+    const schema_ptr _schema;
+public:
+    list_result_builder(lw_shared_ptr<std::vector<bytes>> data, const schema_ptr schema, const query::partition_slice& ps)
+        : _data(data)
+        , _partition_slice(ps)
+        , _schema(schema)
+    {
+    }
+    void accept_new_partition(const partition_key& key, uint32_t row_count) {}
+    void accept_new_partition(uint32_t row_count) {}
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row) {
+        auto row_iterator = row.iterator();
+        for (auto&& id : _partition_slice.regular_columns) {
+            auto cell = row_iterator.next_atomic_cell();
+            if (cell) {
+                cell->value().with_linearized([this, &col = _schema->regular_column_at(id)] (bytes_view cell_view) {
+                    _data->push_back(col.type->deserialize_value(cell_view).serialize_nonnull());
+                });
+            }
+        }
+    }
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {}
+    void accept_partition_end(const query::result_row_view& static_row) {}
+};
+
+future<lw_shared_ptr<std::vector<bytes>>> read_list(service::storage_proxy& proxy, const redis_options& options, const bytes& key, uint64_t row_limit, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::LISTs);
+    auto ps = partition_slice_builder(*schema)
+        .with_partition_row_limit(row_limit)
+        .build();
+    const auto max_result_size = proxy.get_max_result_size(ps);
+    query::read_command cmd(schema->id(), schema->version(), ps, row_limit, gc_clock::now(), std::nullopt, 1, utils::UUID(), query::is_first_page::no, max_result_size, 0);
+    auto pkey = partition_key::from_single_value(*schema, key);
+    auto partition_range = dht::partition_range::make_singular(dht::decorate_key(*schema, std::move(pkey)));
+    dht::partition_range_vector partition_ranges;
+    partition_ranges.emplace_back(std::move(partition_range));
+    auto read_consistency_level = options.get_read_consistency_level();
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_read_timeout();
+    return proxy.query(schema, make_lw_shared<query::read_command>(std::move(cmd)), std::move(partition_ranges), read_consistency_level, {timeout, permit, service::client_state::for_internal_calls()}).then([ps, schema] (auto qr) {
+        return query::result_view::do_with(*qr.query_result, [&] (query::result_view v) {
+            auto pd = make_lw_shared<std::vector<bytes>>();
+            v.consume(ps, list_result_builder(pd, schema, ps));
+            return pd;
+        });
+    });
+}
+
 }
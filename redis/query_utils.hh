@@ -13,6 +13,7 @@
 #include "bytes.hh"
 #include "gc_clock.hh"
 #include "query-request.hh"
+#include <unordered_map>
 
 namespace service {
 class storage_proxy;
@@ -37,9 +38,15 @@ struct strings_result {
 
 seastar::future<seastar::lw_shared_ptr<strings_result>> read_strings(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
 seastar::future<seastar::lw_shared_ptr<strings_result>> query_strings(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
+// Reads the strings of all the keys with a single query, the keys which don't exist are missing from the result.
+seastar::future<seastar::lw_shared_ptr<std::unordered_map<bytes, bytes>>> read_multiple_strings(service::storage_proxy&, const redis_options&, const std::vector<bytes>&, service_permit);
 
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, const bytes&, service_permit);
+seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, const std::vector<bytes>&, service_permit);
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
 
+// Reads the first row_limit elements of a list, in order.
+seastar::future<seastar::lw_shared_ptr<std::vector<bytes>>> read_list(service::storage_proxy&, const redis_options&, const bytes&, uint64_t row_limit, service_permit);
+
 }
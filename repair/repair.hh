@@ -99,6 +99,8 @@ class repair_stats {
     uint64_t round_nr_fast_path_already_synced = 0;
     uint64_t round_nr_fast_path_same_combined_hashes= 0;
     uint64_t round_nr_slow_path = 0;
+    // Times the row hashes of a peer were only fetched for the hash sketch buckets which differ
+    uint64_t round_nr_hash_sketch = 0;
 
     uint64_t rpc_call_nr = 0;
 
@@ -314,8 +316,20 @@ enum class repair_row_level_start_status: uint8_t {
     no_such_column_family,
 };
 
+// The combined hash of all the rows of a range on a node, saved by a repair
+// which read the whole range (see range_hash_cache). The
+// row hashes depend on the seed of the repair which computed it.
+struct cached_range_hash {
+    uint64_t seed;
+    repair_hash hash;
+
+    bool operator==(const cached_range_hash&) const = default;
+};
+
 struct repair_row_level_start_response {
     repair_row_level_start_status status;
+    // The node's hash of the range, if its data in the range didn't change since it was computed.
+    std::optional<cached_range_hash> range_hash;
 };
 
 // Return value of the REPAIR_GET_SYNC_BOUNDARY RPC verb
@@ -333,6 +347,12 @@ struct get_sync_boundary_response {
 // Return value of the REPAIR_GET_COMBINED_ROW_HASH RPC verb
 using get_combined_row_hash_response = repair_hash;
 
+// The row hashes of a working row buf, combined per bucket of hash values
+// (hash % repair_hash_sketch_buckets). Nodes whose sketches differ only in a
+// few buckets need to exchange only the row hashes in those buckets.
+using repair_hash_sketch = std::vector<repair_hash>;
+constexpr size_t repair_hash_sketch_buckets = 256;
+
 struct node_repair_meta_id {
     gms::inet_address ip;
     uint32_t repair_meta_id;
@@ -391,6 +411,15 @@ enum class row_level_diff_detect_algorithm : uint8_t {
 
 std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo);
 
+// The hash function the rows and keys are hashed with, chosen by the repair
+// master for all the nodes of the repair.
+enum class repair_hash_algorithm : uint8_t {
+    xxhash64,
+    xxh3,
+};
+
+std::ostream& operator<<(std::ostream& out, repair_hash_algorithm algo);
+
 enum class node_ops_cmd : uint32_t {
      removenode_prepare,
      removenode_heartbeat,
@@ -33,6 +33,7 @@
 #include <boost/intrusive/list.hpp>
 #include "gms/i_endpoint_state_change_subscriber.hh"
 #include "gms/gossiper.hh"
+#include "gms/feature_service.hh"
 #include "repair/row_level.hh"
 #include "mutation_source_metadata.hh"
 #include "utils/stall_free.hh"
@@ -238,15 +239,54 @@ static uint64_t get_random_seed() {
     return random_dist(random_engine);
 }
 
+// Hashes the partition keys and the rows compared by row-level repair, with
+// the seed and the algorithm the repair master chose.
+class repair_hasher {
+    uint64_t _seed;
+    repair_hash_algorithm _algo;
+
+    template <typename Func>
+    repair_hash hash(Func&& feed) const {
+        switch (_algo) {
+        case repair_hash_algorithm::xxh3: {
+            xxh3_hasher h(_seed);
+            feed(h);
+            return repair_hash(h.finalize_uint64());
+        }
+        case repair_hash_algorithm::xxhash64:
+            break;
+        }
+        xx_hasher h(_seed);
+        feed(h);
+        return repair_hash(h.finalize_uint64());
+    }
+public:
+    repair_hasher(uint64_t seed, repair_hash_algorithm algo) noexcept
+        : _seed(seed)
+        , _algo(algo) {
+    }
+
+    repair_hash hash_for_key(const schema& s, const dht::decorated_key& dk) const {
+        return hash([&] (auto& h) {
+            feed_hash(h, dk.key(), s);
+        });
+    }
+
+    repair_hash hash_for_mf(const schema& s, const repair_hash& key_hash, const mutation_fragment& mf) const {
+        return hash([&] (auto& h) {
+            feed_hash(h, mf, s);
+            feed_hash(h, key_hash.hash);
+        });
+    }
+};
+
 class decorated_key_with_hash {
 public:
     dht::decorated_key dk;
     repair_hash hash;
-    decorated_key_with_hash(const schema& s, dht::decorated_key key, uint64_t seed)
-        : dk(key) {
-        xx_hasher h(seed);
-        feed_hash(h, dk.key(), s);
-        hash = repair_hash(h.finalize_uint64());
+    decorated_key_with_hash(const schema& s, dht::decorated_key key, const repair_hasher& hasher)
+        : dk(key)
+        , hash(hasher.hash_for_key(s, dk)) {
     }
 };
 
@@ -341,8 +381,7 @@ using is_local_reader = bool_class<class is_local_reader_tag>;
     dht::partition_range _range;
     // Used to find the range that repair master will work on
     dht::selective_token_range_sharder _sharder;
-    // Seed for the repair row hashing
-    uint64_t _seed;
+    repair_hasher _hasher;
     // Pin the table while the reader is alive.
     // Only needed for local readers, the multishard reader takes care
     // of pinning tables on used shards.
@@ -364,13 +403,13 @@ using is_local_reader = bool_class<class is_local_reader_tag>;
             dht::token_range range,
             const dht::sharder& remote_sharder,
             unsigned remote_shard,
-            uint64_t seed,
+            repair_hasher hasher,
             is_local_reader local_reader)
             : _schema(s)
             , _permit(std::move(permit))
             , _range(dht::to_partition_range(range))
             , _sharder(remote_sharder, range, remote_shard)
-            , _seed(seed)
+            , _hasher(hasher)
             , _local_read_op(local_reader ? std::optional(cf.read_in_progress()) : std::nullopt)
             , _reader(nullptr) {
         if (local_reader) {
@@ -452,7 +491,7 @@ using is_local_reader = bool_class<class is_local_reader_tag>;
     }
 
     void set_current_dk(const dht::decorated_key& key) {
-        _current_dk = make_lw_shared<const decorated_key_with_hash>(*_schema, key, _seed);
+        _current_dk = make_lw_shared<const decorated_key_with_hash>(*_schema, key, _hasher);
     }
 
     void clear_current_dk() {
@@ -646,6 +685,8 @@ class repair_meta {
     // Max rows size can be stored in _row_buf
     size_t _max_row_buf_size;
     uint64_t _seed = 0;
+    repair_hash_algorithm _hash_algo;
+    repair_hasher _hasher;
     repair_master _repair_master;
     gms::inet_address _myip;
     uint32_t _repair_meta_id;
@@ -666,8 +707,19 @@ class repair_meta {
     std::list<repair_row> _row_buf;
     // Contains rows we are working on to sync between peers
     std::list<repair_row> _working_row_buf;
+    // Reads the rows following _row_buf from disk while the rows in
+    // _working_row_buf are being synced, see start_read_ahead()
+    std::optional<future<>> _read_ahead;
+    std::list<repair_row> _read_ahead_rows;
+    size_t _read_ahead_rows_size = 0;
     // Combines all the repair_hash in _working_row_buf
     repair_hash _working_row_buf_combined_hash;
+    // Combines all the repair_hash read from disk, see range_hash_cache
+    repair_hash _range_combined_hash;
+    // The sstables the range was read from, if the reader is local and no memtable had data in the range
+    std::optional<std::vector<int64_t>> _range_data;
+    bool _range_read_whole = false;
+    bool _wrote_rows = false;
     // Tracks the last sync boundary
     std::optional<repair_sync_boundary> _last_sync_boundary;
     // Tracks current sync boundary
@@ -731,6 +783,7 @@ class repair_meta {
             row_level_diff_detect_algorithm algo,
             size_t max_row_buf_size,
             uint64_t seed,
+            repair_hash_algorithm hash_algo,
             repair_master master,
             uint32_t repair_meta_id,
             streaming::stream_reason reason,
@@ -751,6 +804,8 @@ class repair_meta {
             , _algo(algo)
             , _max_row_buf_size(max_row_buf_size)
             , _seed(seed)
+            , _hash_algo(hash_algo)
+            , _hasher(seed, hash_algo)
             , _repair_master(master)
             , _myip(utils::fb_utilities::get_broadcast_address())
             , _repair_meta_id(repair_meta_id)
@@ -767,7 +822,7 @@ class repair_meta {
                     _range,
                     _remote_sharder,
                     _master_node_shard_config.shard,
-                    _seed,
+                    _hasher,
                     repair_reader::is_local_reader(_repair_master || _same_sharding_config)
               )
             , _repair_writer(make_lw_shared<repair_writer>(_schema, _permit, _estimated_partitions, _reason))
@@ -794,6 +849,48 @@ class repair_meta {
             for (auto& node : all_live_peer_nodes) {
                 _all_node_states.push_back(repair_node_state(node));
             }
+            if (_db.local().get_config().repair_skip_unchanged_ranges() && (_repair_master || _same_sharding_config)) {
+                _range_data = range_data_fingerprint(_cf, _range);
+            }
+    }
+
+private:
+    // The generations of the sstables holding the data of the range, in order, or
+    // std::nullopt if some of it is still in memtables.
+    static std::optional<std::vector<int64_t>> range_data_fingerprint(const replica::column_family& cf, const dht::token_range& range) {
+        auto pr = dht::to_partition_range(range);
+        if (cf.memtables_have_data_in(pr)) {
+            return std::nullopt;
+        }
+        auto sstables = cf.select_sstables(pr);
+        std::vector<int64_t> generations;
+        generations.reserve(sstables.size());
+        for (auto& sst : sstables) {
+            generations.push_back(sst->generation());
+        }
+        std::sort(generations.begin(), generations.end());
+        return generations;
+    }
+
+    // Saves the hash of the range if all of it was read, and nothing changed it since.
+    void maybe_save_range_hash() {
+        if (!_range_data || !_range_read_whole || _wrote_rows) {
+            return;
+        }
+        auto current = range_data_fingerprint(_cf, _range);
+        if (current != _range_data) {
+            return;
+        }
+        _rs.range_hashes().save(_schema->id(), _range, std::move(*current), cached_range_hash{_seed, _range_combined_hash});
+    }
+
+public:
+    // The hash saved by an earlier repair of the range, if the data didn't change since.
+    std::optional<cached_range_hash> find_cached_range_hash() {
+        if (!_range_data) {
+            return std::nullopt;
+        }
+        return _rs.range_hashes().find(_schema->id(), _range, *_range_data);
     }
 
 public:
@@ -817,9 +914,13 @@ class repair_meta {
         auto f1 = _sink_source_for_get_full_row_hashes.close();
         auto f2 = _sink_source_for_get_row_diff.close();
         auto f3 = _sink_source_for_put_row_diff.close();
+        auto f4 = std::exchange(_read_ahead, std::nullopt).value_or(make_ready_future<>()).handle_exception([] (std::exception_ptr ep) {
+            rlogger.debug("repair_meta::stop: read ahead failed: {}", ep);
+        });
         rlogger.debug("repair_meta::stop");
+        maybe_save_range_hash();
         // move to background.  waited on via _stop_promise->get_future.
-        (void)when_all_succeed(std::move(gate_future), std::move(f1), std::move(f2), std::move(f3)).discard_result().finally([this] {
+        (void)when_all_succeed(std::move(gate_future), std::move(f1), std::move(f2), std::move(f3), std::move(f4)).discard_result().finally([this] {
             return _repair_writer->wait_for_writer_done().finally([this] {
                 return close().then([this] {
                     return clear_gently();
@@ -862,6 +963,18 @@ class repair_meta {
         });
     }
 
+    static uint32_t hash_sketch_bucket(const repair_hash& h) {
+        return h.hash % repair_hash_sketch_buckets;
+    }
+
+    static repair_hash_sketch make_hash_sketch(const repair_hash_set& hashes) {
+        repair_hash_sketch sketch(repair_hash_sketch_buckets);
+        for (auto& h : hashes) {
+            sketch[hash_sketch_bucket(h)].add(h);
+        }
+        return sketch;
+    }
+
     std::pair<std::optional<repair_sync_boundary>, bool>
     get_common_sync_boundary(bool zero_rows,
             std::vector<repair_sync_boundary>& sync_boundaries,
@@ -975,10 +1088,7 @@ class repair_meta {
     }
 
     repair_hash do_hash_for_mf(const decorated_key_with_hash& dk_with_hash, const mutation_fragment& mf) {
-        xx_hasher h(_seed);
-        feed_hash(h, mf, *_schema);
-        feed_hash(h, dk_with_hash.hash.hash);
-        return repair_hash(h.finalize_uint64());
+        return _hasher.hash_for_mf(*_schema, dk_with_hash.hash, mf);
     }
 
     stop_iteration handle_mutation_fragment(mutation_fragment& mf, size_t& cur_size, size_t& new_rows_size, std::list<repair_row>& cur_rows) {
@@ -994,6 +1104,7 @@ class repair_meta {
             return stop_iteration::no;
         }
         auto hash = do_hash_for_mf(*_repair_reader.get_current_dk(), mf);
+        _range_combined_hash.add(hash);
         repair_row r(freeze(*_schema, mf), position_in_partition(mf.position()), _repair_reader.get_current_dk(), hash, is_dirty_on_master::no);
         rlogger.trace("Reading: r.boundary={}, r.hash={}", r.boundary(), r.hash());
         _metrics.row_from_disk_nr++;
@@ -1018,6 +1129,7 @@ class repair_meta {
                 _gate.check();
                 return _repair_reader.read_mutation_fragment().then([this, &cur_size, &new_rows_size, &cur_rows] (mutation_fragment_opt mfopt) mutable {
                     if (!mfopt) {
+                      _range_read_whole = true;
                       return _repair_reader.on_end_of_stream().then([] {
                         return stop_iteration::yes;
                       });
@@ -1046,11 +1158,41 @@ class repair_meta {
         });
     }
 
+    // Start reading the rows which the next get_sync_boundary() would read,
+    // so that reading them from disk overlaps with syncing the rows in
+    // _working_row_buf, which takes a few round trips between the nodes.
+    // The rows read ahead are only added to _row_buf by get_sync_boundary().
+    void start_read_ahead() {
+        if (_read_ahead || _range_read_whole) {
+            return;
+        }
+        _read_ahead = with_gate(_gate, [this] {
+            return row_buf_size().then([this] (size_t cur_size) {
+                return read_rows_from_disk(cur_size).then_unpack([this] (std::list<repair_row> new_rows, size_t new_rows_size) {
+                    _read_ahead_rows = std::move(new_rows);
+                    _read_ahead_rows_size = new_rows_size;
+                });
+            });
+        });
+    }
+
+    // Wait for the rows read ahead, if any, and return them with their size.
+    future<std::tuple<std::list<repair_row>, size_t>> take_read_ahead_rows() {
+        using value_type = std::tuple<std::list<repair_row>, size_t>;
+        if (!_read_ahead) {
+            return make_ready_future<value_type>(value_type(std::list<repair_row>(), 0));
+        }
+        return std::exchange(_read_ahead, std::nullopt)->then([this] {
+            return value_type(std::move(_read_ahead_rows), std::exchange(_read_ahead_rows_size, 0));
+        });
+    }
+
     // Read rows from disk until _max_row_buf_size of rows are filled into _row_buf.
     // Calculate the combined checksum of the rows
     // Calculate the total size of the rows in _row_buf
     future<get_sync_boundary_response>
     get_sync_boundary(std::optional<repair_sync_boundary> skipped_sync_boundary) {
+      return take_read_ahead_rows().then_unpack([this, skipped_sync_boundary = std::move(skipped_sync_boundary)] (std::list<repair_row> read_ahead_rows, size_t read_ahead_rows_size) mutable {
         auto f = make_ready_future<>();
         if (skipped_sync_boundary) {
             _current_sync_boundary = skipped_sync_boundary;
@@ -1059,11 +1201,15 @@ class repair_meta {
         // Here is the place we update _last_sync_boundary
         rlogger.trace("SET _last_sync_boundary from {} to {}", _last_sync_boundary, _current_sync_boundary);
         _last_sync_boundary = _current_sync_boundary;
-      return f.then([this, sb = std::move(skipped_sync_boundary)] () mutable {
-       return clear_working_row_buf().then([this, sb = sb] () mutable {
-        return row_buf_size().then([this, sb = std::move(sb)] (size_t cur_size) {
-            return read_rows_from_disk(cur_size).then_unpack([this, sb = std::move(sb)] (std::list<repair_row> new_rows, size_t new_rows_size) mutable {
-                size_t new_rows_nr = new_rows.size();
+      return f.then([this, sb = std::move(skipped_sync_boundary), read_ahead_rows = std::move(read_ahead_rows), read_ahead_rows_size] () mutable {
+        // The rows read ahead follow the rows in _row_buf, even the skipped ones
+        size_t read_ahead_rows_nr = read_ahead_rows.size();
+        _row_buf.splice(_row_buf.end(), read_ahead_rows);
+       return clear_working_row_buf().then([this, sb = sb, read_ahead_rows_nr, read_ahead_rows_size] () mutable {
+        return row_buf_size().then([this, sb = std::move(sb), read_ahead_rows_nr, read_ahead_rows_size] (size_t cur_size) {
+            return read_rows_from_disk(cur_size).then_unpack([this, sb = std::move(sb), read_ahead_rows_nr, read_ahead_rows_size] (std::list<repair_row> new_rows, size_t new_rows_size) mutable {
+                size_t new_rows_nr = new_rows.size() + read_ahead_rows_nr;
+                new_rows_size += read_ahead_rows_size;
                 _row_buf.splice(_row_buf.end(), new_rows);
                 return row_buf_csum().then([this, new_rows_size, new_rows_nr, sb = std::move(sb)] (repair_hash row_buf_combined_hash) {
                     return row_buf_size().then([this, new_rows_size, new_rows_nr, row_buf_combined_hash, sb = std::move(sb)] (size_t row_buf_bytes) {
@@ -1080,6 +1226,7 @@ class repair_meta {
         });
        });
       });
+      });
     }
 
     future<> move_row_buf_to_working_row_buf() {
@@ -1187,6 +1334,7 @@ class repair_meta {
         return do_with(std::move(row_diff), [this, update_buf] (std::list<repair_row>& row_diff) {
             return with_semaphore(_repair_writer->sem(), 1, [this, update_buf, &row_diff] {
                 _repair_writer->create_writer(_db, _sys_dist_ks, _view_update_generator);
+                _wrote_rows = true;
                 return repeat([this, update_buf, &row_diff] () mutable {
                     if (row_diff.empty()) {
                         return make_ready_future<stop_iteration>(stop_iteration::yes);
@@ -1257,6 +1405,7 @@ class repair_meta {
                 continue;
             }
             _repair_writer->create_writer(_db, _sys_dist_ks, _view_update_generator);
+            _wrote_rows = true;
             auto mf = r.get_mutation_fragment_ptr();
             const auto& dk = r.get_dk_with_hash()->dk;
             if (last_mf && last_dk &&
@@ -1325,7 +1474,7 @@ class repair_meta {
             return do_for_each(rows, [this, &dk_ptr, &row_list, &last_mf, &cmp] (partition_key_and_mutation_fragments& x) mutable {
                 dht::decorated_key dk = dht::decorate_key(*_schema, x.get_key());
                 if (!(dk_ptr && dk_ptr->dk.equal(*_schema, dk))) {
-                    dk_ptr = make_lw_shared<const decorated_key_with_hash>(*_schema, dk, _seed);
+                    dk_ptr = make_lw_shared<const decorated_key_with_hash>(*_schema, dk, _hasher);
                 }
                 if (_repair_master) {
                     return do_for_each(x.get_mutation_fragments(), [this, &dk_ptr, &row_list] (frozen_mutation_fragment& fmf) mutable {
@@ -1369,13 +1518,14 @@ class repair_meta {
 public:
     // RPC API
     // Return the hashes of the rows in _working_row_buf
+    // If buckets is set, only the hashes in these buckets of the hash sketch are returned.
     future<repair_hash_set>
-    get_full_row_hashes(gms::inet_address remote_node) {
+    get_full_row_hashes(gms::inet_address remote_node, std::optional<std::vector<uint32_t>> buckets = std::nullopt) {
         if (remote_node == _myip) {
-            return get_full_row_hashes_handler();
+            return get_full_row_hashes_handler(std::move(buckets));
         }
         return _messaging.send_repair_get_full_row_hashes(msg_addr(remote_node),
-                _repair_meta_id).then([this, remote_node] (repair_hash_set hashes) {
+                _repair_meta_id, std::move(buckets)).then([this, remote_node] (repair_hash_set hashes) {
             rlogger.debug("Got full hashes from peer={}, nr_hashes={}", remote_node, hashes.size());
             _metrics.rx_hashes_nr += hashes.size();
             stats().rx_hashes_nr += hashes.size();
@@ -1445,45 +1595,68 @@ class repair_meta {
 
     // RPC handler
     future<repair_hash_set>
-    get_full_row_hashes_handler() {
-        return with_gate(_gate, [this] {
-            return working_row_hashes();
+    get_full_row_hashes_handler(std::optional<std::vector<uint32_t>> buckets = std::nullopt) {
+        return with_gate(_gate, [this, buckets = std::move(buckets)] {
+            return working_row_hashes().then([buckets = std::move(buckets)] (repair_hash_set hashes) {
+                if (buckets) {
+                    std::vector<bool> wanted(repair_hash_sketch_buckets);
+                    for (auto b : *buckets) {
+                        wanted.at(b) = true;
+                    }
+                    absl::erase_if(hashes, [&] (const repair_hash& h) { return !wanted[hash_sketch_bucket(h)]; });
+                }
+                return hashes;
+            });
         });
     }
 
     // RPC API
-    // Return the combined hashes of the current working row buf
-    future<get_combined_row_hash_response>
+    // Return the combined hashes of the current working row buf, and its
+    // hash sketch if it's worth it (empty otherwise)
+    future<rpc::tuple<get_combined_row_hash_response, repair_hash_sketch>>
     get_combined_row_hash(std::optional<repair_sync_boundary> common_sync_boundary, gms::inet_address remote_node) {
+        using value_type = rpc::tuple<get_combined_row_hash_response, repair_hash_sketch>;
         if (remote_node == _myip) {
             return get_combined_row_hash_handler(common_sync_boundary);
         }
         return _messaging.send_repair_get_combined_row_hash(msg_addr(remote_node),
-                _repair_meta_id, common_sync_boundary).then([this] (get_combined_row_hash_response resp) {
+                _repair_meta_id, common_sync_boundary).then([this] (rpc::tuple<get_combined_row_hash_response, rpc::optional<repair_hash_sketch>> resp_and_sketch) {
+            auto&& [resp, sketch] = resp_and_sketch;
             stats().rpc_call_nr++;
             stats().rx_hashes_nr++;
             _metrics.rx_hashes_nr++;
-            return resp;
+            return value_type(resp, sketch ? std::move(*sketch) : repair_hash_sketch());
         });
     }
 
     // RPC handler
-    future<get_combined_row_hash_response>
+    future<rpc::tuple<get_combined_row_hash_response, repair_hash_sketch>>
     get_combined_row_hash_handler(std::optional<repair_sync_boundary> common_sync_boundary) {
+        using value_type = rpc::tuple<get_combined_row_hash_response, repair_hash_sketch>;
         // We can not call this function twice. The good thing is we do not use
         // retransmission at messaging_service level, so no message will be retransmited.
         rlogger.trace("Calling get_combined_row_hash_handler");
         return with_gate(_gate, [this, common_sync_boundary = std::move(common_sync_boundary)] () mutable {
             _cf.update_off_strategy_trigger();
-            return request_row_hashes(common_sync_boundary);
+            return request_row_hashes(common_sync_boundary).then([this] (get_combined_row_hash_response resp) {
+                start_read_ahead();
+                // The sketch is only cheaper than the full hashes if there are many more rows than buckets
+                if (_working_row_buf.size() < 4 * repair_hash_sketch_buckets) {
+                    return make_ready_future<value_type>(value_type(resp, repair_hash_sketch()));
+                }
+                return working_row_hashes().then([resp] (repair_hash_set hashes) {
+                    return value_type(resp, make_hash_sketch(hashes));
+                });
+            });
         });
     }
 
     // RPC API
-    future<>
+    // Returns the hash of the range the node saved in an earlier repair, if any.
+    future<std::optional<cached_range_hash>>
     repair_row_level_start(gms::inet_address remote_node, sstring ks_name, sstring cf_name, dht::token_range range, table_schema_version schema_version, streaming::stream_reason reason) {
         if (remote_node == _myip) {
-            return make_ready_future<>();
+            return make_ready_future<std::optional<cached_range_hash>>(find_cached_range_hash());
         }
         stats().rpc_call_nr++;
         // Even though remote partitioner name is ignored in the current version of
@@ -1495,11 +1668,11 @@ class repair_meta {
         return _messaging.send_repair_row_level_start(msg_addr(remote_node),
                 _repair_meta_id, ks_name, cf_name, std::move(range), _algo, _max_row_buf_size, _seed,
                 _master_node_shard_config.shard, _master_node_shard_config.shard_count, _master_node_shard_config.ignore_msb,
-                remote_partitioner_name, std::move(schema_version), reason).then([ks_name, cf_name] (rpc::optional<repair_row_level_start_response> resp) {
+                remote_partitioner_name, std::move(schema_version), reason, _hash_algo).then([ks_name, cf_name] (rpc::optional<repair_row_level_start_response> resp) {
             if (resp && resp->status == repair_row_level_start_status::no_such_column_family) {
-                return make_exception_future<>(replica::no_such_column_family(ks_name, cf_name));
+                return make_exception_future<std::optional<cached_range_hash>>(replica::no_such_column_family(ks_name, cf_name));
             } else {
-                return make_ready_future<>();
+                return make_ready_future<std::optional<cached_range_hash>>(resp ? resp->range_hash : std::nullopt);
             }
         });
     }
@@ -1508,11 +1681,12 @@ class repair_meta {
     static future<repair_row_level_start_response>
     repair_row_level_start_handler(repair_service& repair, gms::inet_address from, uint32_t src_cpu_id, uint32_t repair_meta_id, sstring ks_name, sstring cf_name,
             dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size,
-            uint64_t seed, shard_config master_node_shard_config, table_schema_version schema_version, streaming::stream_reason reason) {
-        rlogger.debug(">>> Started Row Level Repair (Follower): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, schema_version={}, range={}, seed={}, max_row_buf_siz={}",
-            utils::fb_utilities::get_broadcast_address(), from, repair_meta_id, ks_name, cf_name, schema_version, range, seed, max_row_buf_size);
-        return repair.insert_repair_meta(from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, std::move(master_node_shard_config), std::move(schema_version), reason).then([] {
-            return repair_row_level_start_response{repair_row_level_start_status::ok};
+            uint64_t seed, repair_hash_algorithm hash_algo, shard_config master_node_shard_config, table_schema_version schema_version, streaming::stream_reason reason) {
+        rlogger.debug(">>> Started Row Level Repair (Follower): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, schema_version={}, range={}, seed={}, hash_algo={}, max_row_buf_siz={}",
+            utils::fb_utilities::get_broadcast_address(), from, repair_meta_id, ks_name, cf_name, schema_version, range, seed, hash_algo, max_row_buf_size);
+        return repair.insert_repair_meta(from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, hash_algo, std::move(master_node_shard_config), std::move(schema_version), reason).then([&repair, from, repair_meta_id] {
+            auto rm = repair.get_repair_meta(from, repair_meta_id);
+            return repair_row_level_start_response{repair_row_level_start_status::ok, rm->find_cached_range_hash()};
         }).handle_exception_type([] (replica::no_such_column_family&) {
             return repair_row_level_start_response{repair_row_level_start_status::no_such_column_family};
         });
@@ -2211,13 +2385,17 @@ future<> repair_service::init_ms_handlers() {
         });
         return make_ready_future<rpc::sink<repair_hash_with_cmd>>(sink);
     });
-    ms.register_repair_get_full_row_hashes([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id) {
+    ms.register_repair_get_full_row_hashes([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id, rpc::optional<std::vector<uint32_t>> buckets) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
-        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id] (repair_service& local_repair) {
+        std::optional<std::vector<uint32_t>> b;
+        if (buckets) {
+            b = std::move(*buckets);
+        }
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, buckets = std::move(b)] (repair_service& local_repair) mutable {
             auto rm = local_repair.get_repair_meta(from, repair_meta_id);
             rm->set_repair_state_for_local_node(repair_state::get_full_row_hashes_started);
-            return rm->get_full_row_hashes_handler().then([rm] (repair_hash_set hashes) {
+            return rm->get_full_row_hashes_handler(std::move(buckets)).then([rm] (repair_hash_set hashes) {
                 rm->set_repair_state_for_local_node(repair_state::get_full_row_hashes_finished);
                 _metrics.tx_hashes_nr += hashes.size();
                 return hashes;
@@ -2233,7 +2411,7 @@ future<> repair_service::init_ms_handlers() {
             auto rm = local_repair.get_repair_meta(from, repair_meta_id);
             _metrics.tx_hashes_nr++;
             rm->set_repair_state_for_local_node(repair_state::get_combined_row_hash_started);
-            return rm->get_combined_row_hash_handler(std::move(common_sync_boundary)).then([rm] (get_combined_row_hash_response resp) {
+            return rm->get_combined_row_hash_handler(std::move(common_sync_boundary)).then([rm] (rpc::tuple<get_combined_row_hash_response, repair_hash_sketch> resp) {
                 rm->set_repair_state_for_local_node(repair_state::get_combined_row_hash_finished);
                 return resp;
             });
@@ -2296,18 +2474,21 @@ future<> repair_service::init_ms_handlers() {
     });
     ms.register_repair_row_level_start([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring ks_name,
             sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed,
-            unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason) {
+            unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason,
+            rpc::optional<repair_hash_algorithm> hash_algo) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(src_cpu_id % smp::count, [from, src_cpu_id, repair_meta_id, ks_name, cf_name,
-                range, algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, schema_version, reason] (repair_service& local_repair) mutable {
+                range, algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, schema_version, reason, hash_algo] (repair_service& local_repair) mutable {
             if (!local_repair._sys_dist_ks.local_is_initialized() || !local_repair._view_update_generator.local_is_initialized()) {
                 return make_exception_future<repair_row_level_start_response>(std::runtime_error(format("Node {} is not fully initialized for repair, try again later",
                         utils::fb_utilities::get_broadcast_address())));
             }
             streaming::stream_reason r = reason ? *reason : streaming::stream_reason::repair;
+            // Masters which don't send it hash with XXH64.
+            repair_hash_algorithm ha = hash_algo ? *hash_algo : repair_hash_algorithm::xxhash64;
             return repair_meta::repair_row_level_start_handler(local_repair, from, src_cpu_id, repair_meta_id, std::move(ks_name),
-                    std::move(cf_name), std::move(range), algo, max_row_buf_size, seed,
+                    std::move(cf_name), std::move(range), algo, max_row_buf_size, seed, ha,
                     shard_config{remote_shard, remote_shard_count, remote_ignore_msb},
                     schema_version, r);
         });
@@ -2442,6 +2623,9 @@ class row_level_repair {
     // the next repair.
     uint64_t _seed;
 
+    // XXH3 once all the nodes know it.
+    repair_hash_algorithm _hash_algo;
+
     gc_clock::time_point _start_time;
 
 public:
@@ -2457,6 +2641,7 @@ class row_level_repair {
         , _all_live_peer_nodes(sort_peer_nodes(all_live_peer_nodes))
         , _cf(_ri.db.local().find_column_family(_table_id))
         , _seed(get_random_seed())
+        , _hash_algo(_ri.db.local().features().cluster_supports_xxh3_digest() ? repair_hash_algorithm::xxh3 : repair_hash_algorithm::xxhash64)
         , _start_time(gc_clock::now()) {
     }
 
@@ -2553,6 +2738,8 @@ class row_level_repair {
         // moved from the `_row_buf` to `_working_row_buf`.
         std::vector<repair_hash> combined_hashes;
         combined_hashes.resize(master.all_nodes().size());
+        std::vector<repair_hash_sketch> sketches;
+        sketches.resize(master.all_nodes().size());
         parallel_for_each(boost::irange(size_t(0), master.all_nodes().size()), [&, this] (size_t idx) {
             // Request combined hashes from all nodes between (_last_sync_boundary, _current_sync_boundary]
             // Each node will
@@ -2566,10 +2753,12 @@ class row_level_repair {
             // are identical, there is no need to transfer each and every
             // row hashes to the repair master.
             master.all_nodes()[idx].state = repair_state::get_combined_row_hash_started;
-            return master.get_combined_row_hash(_common_sync_boundary, master.all_nodes()[idx].node).then([&, this, idx] (get_combined_row_hash_response resp) {
+            return master.get_combined_row_hash(_common_sync_boundary, master.all_nodes()[idx].node).then([&, this, idx] (rpc::tuple<get_combined_row_hash_response, repair_hash_sketch> resp_and_sketch) {
+                auto&& [resp, sketch] = resp_and_sketch;
                 master.all_nodes()[idx].state = repair_state::get_combined_row_hash_finished;
-                rlogger.debug("Calling master.get_combined_row_hash for node {}, got combined_hash={}", master.all_nodes()[idx].node, resp);
+                rlogger.debug("Calling master.get_combined_row_hash for node {}, got combined_hash={}, sketch={}", master.all_nodes()[idx].node, resp, !sketch.empty());
                 combined_hashes[idx]= std::move(resp);
+                sketches[idx] = std::move(sketch);
             });
         }).get();
 
@@ -2628,8 +2817,35 @@ class row_level_repair {
 
             rlogger.debug("Before master.get_full_row_hashes for node {}, hash_sets={}",
                 node, master.peer_row_hash_sets(node_idx).size());
-            // Ask the peer to send the full list hashes in the working row buf.
-            if (master.use_rpc_stream()) {
+            // If the peer sent the hash sketch of its rows, compare it with the
+            // sketch of the local rows, and fetch only the row hashes in the
+            // buckets which differ: the rows in the other buckets are the
+            // local ones.
+            std::vector<uint32_t> diff_buckets;
+            if (!sketches[node_idx + 1].empty()) {
+                auto local_sketch = repair_meta::make_hash_sketch(master.working_row_hashes().get0());
+                for (uint32_t b = 0; b < local_sketch.size(); ++b) {
+                    if (local_sketch[b] != sketches[node_idx + 1][b]) {
+                        diff_buckets.push_back(b);
+                    }
+                }
+            }
+            if (!diff_buckets.empty() && diff_buckets.size() <= repair_hash_sketch_buckets / 2) {
+                ns.state = repair_state::get_full_row_hashes_started;
+                auto peer_hashes = master.get_full_row_hashes(node, diff_buckets).get0();
+                ns.state = repair_state::get_full_row_hashes_finished;
+                std::vector<bool> differs(repair_hash_sketch_buckets);
+                for (auto b : diff_buckets) {
+                    differs[b] = true;
+                }
+                for (auto& h : master.working_row_hashes().get0()) {
+                    if (!differs[repair_meta::hash_sketch_bucket(h)]) {
+                        peer_hashes.insert(h);
+                    }
+                }
+                master.peer_row_hash_sets(node_idx) = std::move(peer_hashes);
+                master.stats().round_nr_hash_sketch++;
+            } else if (master.use_rpc_stream()) {
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_started;
                 master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_with_rpc_stream(node, node_idx).get0();
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_finished;
@@ -2760,7 +2976,8 @@ class row_level_repair {
 
             auto& mem_sem = _ri.rs.memory_sem();
             auto max = _ri.rs.max_repair_memory();
-            auto wanted = (_all_live_peer_nodes.size() + 1) * tracker::max_repair_memory_per_range();
+            // Each node can hold a row buffer being synced and one being read ahead
+            auto wanted = 2 * (_all_live_peer_nodes.size() + 1) * tracker::max_repair_memory_per_range();
             wanted = std::min(max, wanted);
             rlogger.trace("repair[{}]: Started to get memory budget, wanted={}, available={}, max_repair_memory={}",
                     _ri.id.uuid, wanted, mem_sem.current(), max);
@@ -2778,6 +2995,7 @@ class row_level_repair {
                     algorithm,
                     max_row_buf_size,
                     _seed,
+                    _hash_algo,
                     repair_meta::repair_master::yes,
                     repair_meta_id,
                     _ri.reason,
@@ -2797,11 +3015,13 @@ class row_level_repair {
 
             std::vector<gms::inet_address> nodes_to_stop;
             nodes_to_stop.reserve(master.all_nodes().size());
+            std::vector<std::optional<cached_range_hash>> range_hashes(master.all_nodes().size());
             try {
                 parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
                     const auto& node = ns.node;
                     ns.state = repair_state::row_level_start_started;
-                    return master.repair_row_level_start(node, _ri.keyspace, _cf_name, _range, schema_version, _ri.reason).then([&] () {
+                    return master.repair_row_level_start(node, _ri.keyspace, _cf_name, _range, schema_version, _ri.reason).then([&] (std::optional<cached_range_hash> range_hash) {
+                        range_hashes[&ns - master.all_nodes().data()] = std::move(range_hash);
                         ns.state = repair_state::row_level_start_finished;
                         nodes_to_stop.push_back(node);
                         ns.state = repair_state::get_estimated_partitions_started;
@@ -2822,7 +3042,15 @@ class row_level_repair {
                     });
                 }).get();
 
-                while (true) {
+                // All the nodes hashed the range in the same earlier repair (same seed) to the same
+                // value, and none of them has changed it since: there is nothing to sync.
+                bool in_sync = range_hashes_match(range_hashes);
+                if (in_sync) {
+                    rlogger.debug("repair id {} on shard {}, keyspace={}, cf={}, range={}: data unchanged since it was last repaired, skipping",
+                            _ri.id, this_shard_id(), _ri.keyspace, _cf_name, _range);
+                }
+
+                while (!in_sync) {
                     auto status = negotiate_sync_boundary(master);
                     if (status == op_status::next_round) {
                         continue;
@@ -3077,6 +3305,7 @@ repair_service::insert_repair_meta(
         row_level_diff_detect_algorithm algo,
         uint64_t max_row_buf_size,
         uint64_t seed,
+        repair_hash_algorithm hash_algo,
         shard_config master_node_shard_config,
         table_schema_version schema_version,
         streaming::stream_reason reason) {
@@ -3087,6 +3316,7 @@ repair_service::insert_repair_meta(
             algo,
             max_row_buf_size,
             seed,
+            hash_algo,
             master_node_shard_config,
             schema_version,
             reason] (schema_ptr s) {
@@ -3102,6 +3332,7 @@ repair_service::insert_repair_meta(
                 algo,
                 max_row_buf_size,
                 seed,
+                hash_algo,
                 master_node_shard_config,
                 schema_version,
                 reason] (reader_permit permit) mutable {
@@ -3114,6 +3345,7 @@ repair_service::insert_repair_meta(
                 algo,
                 max_row_buf_size,
                 seed,
+                hash_algo,
                 repair_meta::repair_master::no,
                 repair_meta_id,
                 reason,
@@ -3195,3 +3427,52 @@ future<uint32_t> repair_service::get_next_repair_meta_id() {
         return local_repair._next_repair_meta_id++;
     });
 }
+
+void range_hash_cache::erase(lru_type::iterator it) noexcept {
+    auto table_it = _entries.find(it->table_id);
+    table_it->second.erase(it->range);
+    if (table_it->second.empty()) {
+        _entries.erase(table_it);
+    }
+    _lru.erase(it);
+}
+
+std::optional<cached_range_hash> range_hash_cache::find(utils::UUID table_id, const dht::token_range& range, const sstable_generations& sstables) {
+    auto table_it = _entries.find(table_id);
+    if (table_it == _entries.end()) {
+        return std::nullopt;
+    }
+    auto it = table_it->second.find(range);
+    if (it == table_it->second.end()) {
+        return std::nullopt;
+    }
+    auto lru_it = it->second;
+    if (lru_it->sstables != sstables) {
+        // The data changed, the hash can't be of use anymore.
+        erase(lru_it);
+        return std::nullopt;
+    }
+    _lru.splice(_lru.begin(), _lru, lru_it);
+    return lru_it->hash;
+}
+
+void range_hash_cache::save(utils::UUID table_id, const dht::token_range& range, sstable_generations sstables, cached_range_hash hash) {
+    auto& table_entries = _entries[table_id];
+    if (auto it = table_entries.find(range); it != table_entries.end()) {
+        it->second->hash = hash;
+        it->second->sstables = std::move(sstables);
+        _lru.splice(_lru.begin(), _lru, it->second);
+        return;
+    }
+    _lru.push_front(entry{table_id, range, hash, std::move(sstables)});
+    table_entries.emplace(range, _lru.begin());
+    while (_lru.size() > _max_entries) {
+        erase(std::prev(_lru.end()));
+    }
+}
+
+bool range_hashes_match(const std::vector<std::optional<cached_range_hash>>& hashes) {
+    return !hashes.empty() && hashes.front() && std::all_of(hashes.begin(), hashes.end(), [&] (const std::optional<cached_range_hash>& h) {
+        return h == hashes.front();
+    });
+}
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <list>
 #include <vector>
 #include "gms/inet_address.hh"
 #include "repair/repair.hh"
@@ -75,6 +76,46 @@ class node_ops_metrics {
     float repair_finished_percentage();
 };
 
+// The combined hashes of the ranges of the tables fully read by repairs on
+// a shard, with the generations of the sstables they were read from (when
+// no memtable had data in the range). As long as the same sstables still
+// hold all the data of the range, the rows are those hashed, and a repair in
+// which all the replicas saved the same hash can skip the range.
+//
+// Holds at most max_entries hashes, evicting the least recently used.
+class range_hash_cache {
+public:
+    using sstable_generations = std::vector<int64_t>;
+private:
+    struct entry {
+        utils::UUID table_id;
+        dht::token_range range;
+        cached_range_hash hash;
+        sstable_generations sstables;
+    };
+    using lru_type = std::list<entry>;
+    size_t _max_entries;
+    // Most recently used first.
+    lru_type _lru;
+    std::unordered_map<utils::UUID, std::unordered_map<dht::token_range, lru_type::iterator>> _entries;
+
+    void erase(lru_type::iterator it) noexcept;
+public:
+    explicit range_hash_cache(size_t max_entries) noexcept : _max_entries(max_entries) {}
+
+    // The hash saved for the range, if it was read from the same sstables.
+    std::optional<cached_range_hash> find(utils::UUID table_id, const dht::token_range& range, const sstable_generations& sstables);
+    void save(utils::UUID table_id, const dht::token_range& range, sstable_generations sstables, cached_range_hash hash);
+
+    size_t size() const noexcept {
+        return _lru.size();
+    }
+};
+
+// Whether all the nodes saved the same hash of the range, in the same
+// repair (i.e. with the same seed), so that there is nothing to sync.
+bool range_hashes_match(const std::vector<std::optional<cached_range_hash>>& hashes);
+
 class repair_service : public seastar::peering_sharded_service<repair_service> {
     distributed<gms::gossiper>& _gossiper;
     netw::messaging_service& _messaging;
@@ -97,6 +138,9 @@ class repair_service : public seastar::peering_sharded_service<repair_service> {
     size_t _max_repair_memory;
     seastar::semaphore _memory_sem;
 
+    // Only used with repair_skip_unchanged_ranges.
+    range_hash_cache _range_hashes{100000};
+
     future<> init_ms_handlers();
     future<> uninit_ms_handlers();
 
@@ -209,6 +253,7 @@ class repair_service : public seastar::peering_sharded_service<repair_service> {
             row_level_diff_detect_algorithm algo,
             uint64_t max_row_buf_size,
             uint64_t seed,
+            repair_hash_algorithm hash_algo,
             shard_config master_node_shard_config,
             table_schema_version schema_version,
             streaming::stream_reason reason);
@@ -225,6 +270,10 @@ class repair_service : public seastar::peering_sharded_service<repair_service> {
     future<> remove_repair_meta();
 
     future<uint32_t> get_next_repair_meta_id();
+
+    range_hash_cache& range_hashes() noexcept {
+        return _range_hashes;
+    }
 };
 
 class repair_info;
@@ -32,11 +32,15 @@
 #include <boost/container/static_vector.hpp>
 #include "frozen_mutation.hh"
 #include <seastar/core/do_with.hh>
+#include <seastar/core/sleep.hh>
 #include "service/migration_listener.hh"
 #include "cell_locking.hh"
+#include "counter_cache.hh"
+#include "digest_cache.hh"
 #include "view_info.hh"
 #include "db/schema_tables.hh"
 #include "compaction/compaction_manager.hh"
+#include "exceptions/exceptions.hh"
 #include "gms/feature_service.hh"
 #include "timeout_config.hh"
 #include "service/storage_proxy.hh"
@@ -49,6 +53,7 @@
 #include "db/timeout_clock.hh"
 #include "db/large_data_handler.hh"
 #include "db/data_listeners.hh"
+#include "replica/sstable_placement.hh"
 
 #include "data_dictionary/user_types_metadata.hh"
 #include <seastar/core/shared_ptr_incomplete.hh>
@@ -212,8 +217,14 @@ void database::setup_scylla_memory_diagnostics_producer() {
         writeln("  used:  {}\n", utils::to_hr_size(row_cache_occupancy_stats.used_space()));
         writeln("  free:  {}\n\n", utils::to_hr_size(row_cache_occupancy_stats.free_space()));
 
+        const auto pinned_cache_occupancy_stats = _pinned_row_cache_tracker.region().occupancy();
+        writeln("Pinned cache:\n");
+        writeln("  total: {}\n", utils::to_hr_size(pinned_cache_occupancy_stats.total_space()));
+        writeln("  used:  {}\n", utils::to_hr_size(pinned_cache_occupancy_stats.used_space()));
+        writeln("  free:  {}\n\n", utils::to_hr_size(pinned_cache_occupancy_stats.free_space()));
+
         writeln("Memtables:\n");
-        writeln(" total: {}\n", utils::to_hr_size(lsa_occupancy_stats.total_space() - row_cache_occupancy_stats.total_space()));
+        writeln(" total: {}\n", utils::to_hr_size(lsa_occupancy_stats.total_space() - row_cache_occupancy_stats.total_space() - pinned_cache_occupancy_stats.total_space()));
 
         writeln(" Regular:\n");
         writeln("  real dirty: {}\n", utils::to_hr_size(_dirty_memory_manager.real_dirty_memory()));
@@ -301,6 +312,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
         abort_source& as, sharded<semaphore>& sst_dir_sem, utils::cross_shard_barrier barrier)
     : _stats(make_lw_shared<db_stats>())
     , _cl_stats(std::make_unique<cell_locker_stats>())
+    , _counter_cache_stats(std::make_unique<counter_cache_stats>())
+    , _digest_cache_stats(std::make_unique<digest_cache_stats>())
     , _cfg(cfg)
     // Allow system tables a pool of 10 MB memory to write, but never block on other regions.
     , _system_dirty_memory_manager(*this, 10 << 20, cfg.virtual_dirty_soft_limit(), default_scheduling_group())
@@ -342,8 +355,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
               _cfg.compaction_large_cell_warning_threshold_mb()*1024*1024,
               _cfg.compaction_rows_count_warning_threshold()))
     , _nop_large_data_handler(std::make_unique<db::nop_large_data_handler>())
-    , _user_sstables_manager(std::make_unique<sstables::sstables_manager>(*_large_data_handler, _cfg, feat, _row_cache_tracker))
-    , _system_sstables_manager(std::make_unique<sstables::sstables_manager>(*_nop_large_data_handler, _cfg, feat, _row_cache_tracker))
+    , _user_sstables_manager(std::make_unique<sstables::sstables_manager>(*_large_data_handler, _cfg, feat, _row_cache_tracker, dbcfg.alien_worker))
+    , _system_sstables_manager(std::make_unique<sstables::sstables_manager>(*_nop_large_data_handler, _cfg, feat, _row_cache_tracker, dbcfg.alien_worker))
     , _result_memory_limiter(dbcfg.available_memory / 10)
     , _data_listeners(std::make_unique<db::data_listeners>())
     , _mnotifier(mn)
@@ -359,6 +372,23 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     setup_metrics();
 
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    _row_cache_tracker.set_range_scans_probationary(_cfg.range_scans_probationary_cache_population);
+    _row_cache_tracker.set_partition_row_budget(_cfg.cache_partition_row_budget);
+    _row_cache_tracker.get_lru().set_evict_by_hits_per_byte(_cfg.cache_eviction_by_hits_per_byte());
+    _pinned_row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    _pinned_row_cache_tracker.set_pinned(_cfg.pinned_tables_cache_memory_fraction);
+    _pinned_row_cache_tracker.get_lru().set_evict_by_hits_per_byte(_cfg.cache_eviction_by_hits_per_byte());
+    if (_cfg.enable_reader_spilling()) {
+        _read_concurrency_sem.set_spill_directory(_cfg.reader_spill_directory(), (_cfg.reader_spill_max_disk_size_in_mb() << 20) / smp::count);
+    }
+    if (_cfg.reader_concurrency_adaptive_limit()) {
+        _read_concurrency_sem.enable_adaptive_count_limit(max_count_concurrent_reads / 10, max_count_concurrent_reads * 4);
+        _streaming_concurrency_sem.enable_adaptive_count_limit(max_count_streaming_concurrent_reads / 10, max_count_streaming_concurrent_reads * 4);
+    }
+    _querier_cache.set_read_ahead(_cfg.querier_cache_read_ahead());
+    _hot_partitions = std::make_unique<db::hot_partitions_tracker>(*this, _cfg.hot_partitions_tracking_capacity(),
+            std::chrono::seconds(std::max(_cfg.hot_partitions_window_in_s(), 1u)));
+    _sstable_placement = std::make_unique<sstable_placement>(_cfg.data_file_directories());
 
     setup_scylla_memory_diagnostics_producer();
     if (_dbcfg.sstables_format) {
@@ -474,6 +504,15 @@ database::setup_metrics() {
                                        "High value in this metric may indicate a permanent failure to flush a memtable.")),
     });
 
+    _metrics.add_group("cache", {
+        sm::make_gauge("pinned_bytes_used", [this] { return _pinned_row_cache_tracker.region().occupancy().used_space(); },
+                       sm::description("Current bytes used by the cache of tables with pinned caching, see pinned_tables_cache_memory_fraction.")),
+        sm::make_gauge("pinned_partitions", [this] { return _pinned_row_cache_tracker.partitions(); },
+                       sm::description("Number of partitions in the cache of tables with pinned caching.")),
+        sm::make_derive("pinned_row_evictions", [this] { return _pinned_row_cache_tracker.get_stats().row_evictions; },
+                       sm::description("Number of rows of tables with pinned caching evicted because their cache outgrew pinned_tables_cache_memory_fraction.")),
+    });
+
     _metrics.add_group("database", {
         sm::make_gauge("requests_blocked_memory_current", [this] { return _dirty_memory_manager.region_group().blocked_requests(); },
                        sm::description(
@@ -498,9 +537,16 @@ database::setup_metrics() {
                        sm::description("Counts sstables that survived the clustering key filtering. "
                                        "High value indicates that bloom filter is not very efficient and still have to access a lot of sstables to get data.")),
 
+        sm::make_derive("partition_tombstone_skipped_sstables", _cf_stats.sstables_skipped_by_partition_tombstone,
+                       sm::description("Counts sstables not read in single partition reads because a partition tombstone in a newer sstable covers all their data.")),
+
         sm::make_derive("dropped_view_updates", _cf_stats.dropped_view_updates,
                        sm::description("Counts the number of view updates that have been dropped due to cluster overload. ")),
 
+        sm::make_derive("view_update_reads_skipped", _cf_stats.view_update_reads_skipped,
+                       sm::description("Counts the number of writes whose view updates were generated without reading the base row, "
+                                       "because the base partition was known not to exist.")),
+
        sm::make_derive("view_building_paused", _cf_stats.view_building_paused,
                       sm::description("Counts the number of times view building process was paused (e.g. due to node unavailability). ")),
 
@@ -514,6 +560,12 @@ database::setup_metrics() {
         sm::make_derive("total_writes_timedout", _stats->total_writes_timedout,
                        sm::description("Counts write operations failed due to a timeout. A positive value is a sign of storage being overloaded.")),
 
+        sm::make_derive("total_writes_delayed_by_compaction_backlog", _stats->total_writes_delayed_by_compaction_backlog,
+                       sm::description("Counts write operations delayed because compaction is falling behind, see compaction_backlog_write_delay_threshold.")),
+
+        sm::make_derive("total_writes_rejected_by_compaction_backlog", _stats->total_writes_rejected_by_compaction_backlog,
+                       sm::description("Counts write operations rejected because compaction fell too far behind, see compaction_backlog_write_reject_threshold.")),
+
         sm::make_derive("total_reads", _read_concurrency_sem.get_stats().total_successful_reads,
                        sm::description("Counts the total number of successful user reads on this shard."),
                        {user_label_instance}),
@@ -554,11 +606,14 @@ database::setup_metrics() {
         sm::make_gauge("querier_cache_population", _querier_cache.get_stats().population,
                        sm::description("The number of entries currently in the querier cache.")),
 
+        sm::make_derive("querier_cache_read_aheads", _querier_cache.get_stats().read_aheads,
+                       sm::description("Counts querier cache entries which read ahead into their buffer between pages.")),
+
         sm::make_derive("sstable_read_queue_overloads", _read_concurrency_sem.get_stats().total_reads_shed_due_to_overload,
                        sm::description("Counts the number of times the sstable read queue was overloaded. "
                                        "A non-zero value indicates that we have to drop read requests because they arrive faster than we can serve them.")),
 
-        sm::make_gauge("active_reads", [this] { return max_count_concurrent_reads - _read_concurrency_sem.available_resources().count; },
+        sm::make_gauge("active_reads", [this] { return _read_concurrency_sem.count_limit() - _read_concurrency_sem.available_resources().count; },
                        sm::description("Holds the number of currently active read operations. "),
                        {user_label_instance}),
 
@@ -591,7 +646,19 @@ database::setup_metrics() {
                                        " When the queue is full, excessive reads are shed to avoid overload."),
                        {user_label_instance}),
 
-        sm::make_gauge("active_reads", [this] { return max_count_streaming_concurrent_reads - _streaming_concurrency_sem.available_resources().count; },
+        sm::make_derive("reads_admitted_fast_lane", _read_concurrency_sem.get_stats().reads_admitted_fast_lane,
+                       sm::description("The number of single-partition reads admitted through the fast lane, without waiting for the range scans queued before them."),
+                       {user_label_instance}),
+
+        sm::make_derive("reads_spilled_bytes", _read_concurrency_sem.get_stats().spilled_bytes,
+                       sm::description("The number of bytes reads wrote to the reader_spill_directory, instead of keeping them in memory."),
+                       {user_label_instance}),
+
+        sm::make_gauge("reads_spill_disk_bytes", [this] { return _read_concurrency_sem.spill_budget().used(); },
+                       sm::description("The disk space taken by the files reads currently spill to, out of reader_spill_max_disk_size_in_mb."),
+                       {user_label_instance}),
+
+        sm::make_gauge("active_reads", [this] { return _streaming_concurrency_sem.count_limit() - _streaming_concurrency_sem.available_resources().count; },
                        sm::description("Holds the number of currently active read operations issued on behalf of streaming "),
                        {streaming_label_instance}),
 
@@ -649,6 +716,25 @@ database::setup_metrics() {
                        sm::description("The number of reads shed because the admission queue reached its max capacity."
                                        " When the queue is full, excessive reads are shed to avoid overload."),
                        {system_label_instance}),
+    });
+
+    for (auto& [sem, label] : {std::pair(&_read_concurrency_sem, user_label_instance), std::pair(&_streaming_concurrency_sem, streaming_label_instance)}) {
+        _metrics.add_group("database", {
+            sm::make_gauge("reads_count_limit", [sem] { return sem->count_limit(); },
+                           sm::description("The number of reads admitted concurrently, tuned from their latency when reader_concurrency_adaptive_limit is set."),
+                           {label}),
+
+            sm::make_gauge("reads_average_queue_time", [sem] { return sem->average_queue_time(); },
+                           sm::description("The average time in seconds reads waited for admission, over the last adjustment of the adaptive count limit."),
+                           {label}),
+
+            sm::make_gauge("reads_average_service_time", [sem] { return sem->average_service_time(); },
+                           sm::description("The average time in seconds reads took once admitted, over the last adjustment of the adaptive count limit."),
+                           {label}),
+        });
+    }
+
+    _metrics.add_group("database", {
 
         sm::make_gauge("total_result_bytes", [this] { return get_result_memory_limiter().total_used_memory(); },
                        sm::description("Holds the current amount of memory used for results.")),
@@ -677,10 +763,40 @@ database::setup_metrics() {
         sm::make_queue_length("counter_cell_lock_pending", _cl_stats->operations_waiting_for_lock,
                              sm::description("The number of counter updates waiting for a lock.")),
 
+        sm::make_total_operations("counter_cache_hits", _counter_cache_stats->hits,
+                                 sm::description("The number of counter updates which found the local shards of all their cells in the counter cache, and didn't have to read them.")),
+
+        sm::make_total_operations("counter_cache_misses", _counter_cache_stats->misses,
+                                 sm::description("The number of counter updates which had to read the local shards of their cells.")),
+
+        sm::make_total_operations("counter_cache_evictions", _counter_cache_stats->evictions,
+                                 sm::description("The number of partitions evicted from the counter cache.")),
+
+        sm::make_gauge("counter_cache_bytes", [this] { return _counter_cache_stats->memory_usage; },
+                       sm::description("The memory used by the counter caches of all tables, bounded by counter_cache_size_in_mb split among shards.")),
+
+        sm::make_total_operations("digest_cache_hits", _digest_cache_stats->hits,
+                                 sm::description("The number of digest-only reads answered from the digest cache, without reading the partition.")),
+
+        sm::make_total_operations("digest_cache_misses", _digest_cache_stats->misses,
+                                 sm::description("The number of cacheable digest-only reads which had to read the partition.")),
+
+        sm::make_total_operations("digest_cache_evictions", _digest_cache_stats->evictions,
+                                 sm::description("The number of partitions evicted from the digest cache.")),
+
+        sm::make_gauge("digest_cache_bytes", [this] { return _digest_cache_stats->memory_usage; },
+                       sm::description("The memory used by the digest caches of all tables, bounded by digest_cache_size_in_mb split among shards.")),
+
         sm::make_counter("large_partition_exceeding_threshold", [this] { return _large_data_handler->stats().partitions_bigger_than_threshold; },
             sm::description("Number of large partitions exceeding compaction_large_partition_warning_threshold_mb. "
                 "Large partitions have performance impact and should be avoided, check the documentation for details.")),
 
+        sm::make_gauge("large_partitions_tracked", [this] { return _large_data_handler->large_partitions().partitions().size(); },
+            sm::description("The number of large partitions, written recently, which reads look out for.")),
+
+        sm::make_total_operations("large_partition_reads", [this] { return _large_data_handler->large_partitions().reads(); },
+            sm::description("The number of single-partition reads of tracked large partitions.")),
+
         sm::make_total_operations("total_view_updates_pushed_local", _cf_stats.total_view_updates_pushed_local,
                 sm::description("Total number of view updates generated for tables and applied locally.")),
 
@@ -709,6 +825,19 @@ void database::set_format(sstables::sstable_version_types format) noexcept {
 database::~database() {
 }
 
+std::string_view latency_breakdown::name(stage st) {
+    switch (st) {
+    case stage::read_admission: return "read_admission";
+    case stage::read_sstable_index: return "read_sstable_index";
+    case stage::read_sstable_data: return "read_sstable_data";
+    case stage::read_other: return "read_other";
+    case stage::write_view_update: return "write_view_update";
+    case stage::write_commitlog: return "write_commitlog";
+    case stage::write_memtable: return "write_memtable";
+    }
+    abort();
+}
+
 void database::update_version(const utils::UUID& version) {
     if (_version.get() != version) {
         _schema_change_count++;
@@ -860,11 +989,14 @@ void database::add_column_family(keyspace& ks, schema_ptr schema, column_family:
     schema = local_schema_registry().learn(schema);
     schema->registry_entry()->mark_synced();
 
+    // The cache of a table is bound to its tracker, so changes of caching_options::pinned()
+    // take effect when the table is loaded again.
+    auto& tracker = schema->caching_options().pinned() ? _pinned_row_cache_tracker : _row_cache_tracker;
     lw_shared_ptr<column_family> cf;
     if (cfg.enable_commitlog && _commitlog) {
-       cf = make_lw_shared<column_family>(schema, std::move(cfg), *_commitlog, *_compaction_manager, *_cl_stats, _row_cache_tracker);
+       cf = make_lw_shared<column_family>(schema, std::move(cfg), *_commitlog, *_compaction_manager, *_cl_stats, tracker);
     } else {
-       cf = make_lw_shared<column_family>(schema, std::move(cfg), column_family::no_commitlog(), *_compaction_manager, *_cl_stats, _row_cache_tracker);
+       cf = make_lw_shared<column_family>(schema, std::move(cfg), column_family::no_commitlog(), *_compaction_manager, *_cl_stats, tracker);
     }
     cf->set_durable_writes(ks.metadata()->durable_writes());
 
@@ -914,6 +1046,7 @@ future<> database::remove(const column_family& cf) noexcept {
     auto s = cf.schema();
     auto& ks = find_keyspace(s->ks_name());
     co_await _querier_cache.evict_all_for_table(s->id());
+    _large_data_handler->large_partitions().forget(s->id());
     _column_families.erase(s->id());
     ks.metadata()->remove_column_family(s);
     _ks_cf_to_uuid.erase(std::make_pair(s->ks_name(), s->cf_name()));
@@ -1102,16 +1235,23 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
         cfg.all_datadirs.push_back(column_family_directory(extra, s.cf_name(), s.id()));
     }
     cfg.datadir = cfg.all_datadirs[0];
+    if (!_config.cold_datadir.empty()) {
+        cfg.cold_datadir = column_family_directory(_config.cold_datadir, s.cf_name(), s.id());
+    }
     cfg.enable_disk_reads = _config.enable_disk_reads;
     cfg.enable_disk_writes = _config.enable_disk_writes;
     cfg.enable_commitlog = _config.enable_commitlog;
     cfg.enable_cache = _config.enable_cache;
     cfg.enable_dangerous_direct_import_of_cassandra_counters = _config.enable_dangerous_direct_import_of_cassandra_counters;
     cfg.compaction_enforce_min_threshold = _config.compaction_enforce_min_threshold;
+    cfg.major_compaction_parallelism = _config.major_compaction_parallelism;
+    cfg.compaction_index_cache_prewarm_keys = _config.compaction_index_cache_prewarm_keys;
+    cfg.memtable_flush_writers = _config.memtable_flush_writers;
     cfg.dirty_memory_manager = _config.dirty_memory_manager;
     cfg.streaming_read_concurrency_semaphore = _config.streaming_read_concurrency_semaphore;
     cfg.compaction_concurrency_semaphore = _config.compaction_concurrency_semaphore;
     cfg.cf_stats = _config.cf_stats;
+    cfg.sstable_placement = _config.sstable_placement;
     cfg.enable_incremental_backups = _config.enable_incremental_backups;
     cfg.compaction_scheduling_group = _config.compaction_scheduling_group;
     cfg.memory_compaction_scheduling_group = _config.memory_compaction_scheduling_group;
@@ -1121,7 +1261,10 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.statement_scheduling_group = _config.statement_scheduling_group;
     cfg.enable_metrics_reporting = db_config.enable_keyspace_column_family_metrics();
     cfg.reversed_reads_auto_bypass_cache = db_config.reversed_reads_auto_bypass_cache;
+    cfg.large_partitions_reversed_reads_bypass_cache = db_config.large_partitions_reversed_reads_bypass_cache;
     cfg.enable_optimized_reversed_reads = db_config.enable_optimized_reversed_reads;
+    cfg.cache_cold_entry_compression_period_in_s = db_config.cache_cold_entry_compression_period_in_s;
+    cfg.view_update_skip_read_for_new_partitions = db_config.view_update_skip_read_for_new_partitions;
 
     // avoid self-reporting
     if (is_system_table(s)) {
@@ -1133,6 +1276,10 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.view_update_concurrency_semaphore = _config.view_update_concurrency_semaphore;
     cfg.view_update_concurrency_semaphore_limit = _config.view_update_concurrency_semaphore_limit;
     cfg.data_listeners = &db.data_listeners();
+    cfg.counter_cache_size = size_t(db_config.counter_cache_size_in_mb()) * 1024 * 1024 / smp::count;
+    cfg.counter_cache_stats = &db.get_counter_cache_stats();
+    cfg.digest_cache_size = size_t(db_config.digest_cache_size_in_mb()) * 1024 * 1024 / smp::count;
+    cfg.digest_cache_stats = &db.get_digest_cache_stats();
 
     return cfg;
 }
@@ -1277,6 +1424,20 @@ database::existing_index_names(const sstring& ks_name, const sstring& cf_to_excl
     return names;
 }
 
+// Single-partition reads are short enough to not wait for scans to be admitted.
+static reader_concurrency_semaphore::admission_lane read_admission_lane(const dht::partition_range_vector& ranges) {
+    return ranges.size() == 1 && ranges.front().is_singular()
+            ? reader_concurrency_semaphore::admission_lane::fast
+            : reader_concurrency_semaphore::admission_lane::regular;
+}
+
+size_t database::estimate_read_memory_cost(const table& cf, const query::partition_slice& slice, const dht::partition_range_vector& ranges) const {
+    if (!_cfg.reader_concurrency_estimate_read_cost()) {
+        return cf.estimate_read_memory_cost();
+    }
+    return cf.estimate_read_memory_cost(slice, ranges);
+}
+
 future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>>
 database::query(schema_ptr s, const query::read_command& cmd, query::result_options opts, const dht::partition_range_vector& ranges,
                 tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
@@ -1293,15 +1454,35 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
     lw_shared_ptr<query::result> result;
     std::exception_ptr ex;
 
+    auto* digest_cache = cf.get_digest_cache();
+    std::optional<dht::decorated_key> digest_key;
+    uint64_t digest_generation = 0;
+    if (digest_cache) {
+        digest_key = digest_cache::cacheable_key(cmd, opts, ranges);
+    }
+    if (digest_key) {
+        digest_generation = digest_cache->generation();
+        if (auto cached = digest_cache->get(*digest_key, cmd, opts.digest_algo)) {
+            tracing::trace(trace_state, "Found digest in the digest cache");
+            ++semaphore.get_stats().total_successful_reads;
+            co_return std::tuple(make_lw_shared<query::result>(bytes_ostream(), cached->digest, cached->last_modified,
+                    query::short_read::no, cached->row_count, cached->partition_count), cf.get_global_cache_hit_rate());
+        }
+    }
+
     if (cmd.query_uuid != utils::UUID{} && !cmd.is_first_page) {
         querier_opt = _querier_cache.lookup_data_querier(cmd.query_uuid, *s, ranges.front(), cmd.slice, trace_state, timeout);
     }
 
+    const auto admission_start = std::chrono::steady_clock::now();
     auto read_func = [&, this] (reader_permit permit) {
+        cf.get_stats().latencies[latency_breakdown::stage::read_admission].add(
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - admission_start).count());
         reader_permit::used_guard ug{permit};
         permit.set_max_result_size(max_result_size);
-        return cf.query(std::move(s), std::move(permit), cmd, opts, ranges, trace_state, get_result_memory_limiter(),
-                timeout, &querier_opt).then([&result, ug = std::move(ug)] (lw_shared_ptr<query::result> res) {
+        return cf.query(std::move(s), permit, cmd, opts, ranges, trace_state, get_result_memory_limiter(),
+                timeout, &querier_opt).then([&result, &cf, &ranges, permit, ug = std::move(ug)] (lw_shared_ptr<query::result> res) {
+            cf.update_read_memory_cost(ranges, permit.max_consumed_memory());
             result = std::move(res);
         });
     };
@@ -1312,7 +1493,8 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
         if (querier_opt) {
             co_await semaphore.with_ready_permit(querier_opt->permit(), read_func);
         } else {
-            co_await semaphore.with_permit(s.get(), "data-query", cf.estimate_read_memory_cost(), timeout, read_func);
+            co_await semaphore.with_permit(s.get(), "data-query", estimate_read_memory_cost(cf, cmd.slice, ranges), timeout, read_func,
+                    read_admission_lane(ranges));
         }
 
         if (cmd.query_uuid != utils::UUID{} && querier_opt) {
@@ -1330,6 +1512,10 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
         co_return coroutine::exception(std::move(ex));
     }
 
+    if (digest_key) {
+        digest_cache->put(*digest_key, cmd, opts.digest_algo, *result, digest_generation);
+    }
+
     auto hit_rate = cf.get_global_cache_hit_rate();
     ++semaphore.get_stats().total_successful_reads;
     _stats->short_data_queries += bool(result->is_short_read());
@@ -1353,6 +1539,7 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
     std::optional<query::mutation_querier> querier_opt;
     reconcilable_result result;
     std::exception_ptr ex;
+    const auto ranges = dht::partition_range_vector{range};
 
     if (cmd.query_uuid != utils::UUID{} && !cmd.is_first_page) {
         querier_opt = _querier_cache.lookup_mutation_querier(cmd.query_uuid, *s, range, cmd.slice, trace_state, timeout);
@@ -1361,8 +1548,9 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
     auto read_func = [&, this] (reader_permit permit) {
         reader_permit::used_guard ug{permit};
         permit.set_max_result_size(max_result_size);
-        return cf.mutation_query(std::move(s), std::move(permit), cmd, range,
-                std::move(trace_state), std::move(accounter), timeout, &querier_opt).then([&result, ug = std::move(ug)] (reconcilable_result res) {
+        return cf.mutation_query(std::move(s), permit, cmd, range,
+                std::move(trace_state), std::move(accounter), timeout, &querier_opt).then([&result, &cf, &ranges, permit, ug = std::move(ug)] (reconcilable_result res) {
+            cf.update_read_memory_cost(ranges, permit.max_consumed_memory());
             result = std::move(res);
         });
     };
@@ -1373,7 +1561,8 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
         if (querier_opt) {
             co_await semaphore.with_ready_permit(querier_opt->permit(), read_func);
         } else {
-            co_await semaphore.with_permit(s.get(), "mutation-query", cf.estimate_read_memory_cost(), timeout, read_func);
+            co_await semaphore.with_permit(s.get(), "mutation-query", estimate_read_memory_cost(cf, cmd.slice, ranges), timeout, read_func,
+                    read_admission_lane(ranges));
         }
 
         if (cmd.query_uuid != utils::UUID{} && querier_opt) {
@@ -1514,19 +1703,46 @@ future<mutation> database::do_apply_counter_update(column_family& cf, const froz
 
             // Before counter update is applied it needs to be transformed from
             // deltas to counter shards. To do that, we need to read the current
-            // counter state for each modified cell...
-
-            tracing::trace(trace_state, "Reading counter values from the CF");
-            auto permit = get_reader_concurrency_semaphore().make_tracking_only_permit(m_schema.get(), "counter-read-before-write", timeout);
-            return counter_write_query(m_schema, cf.as_mutation_source(), std::move(permit), m.decorated_key(), slice, trace_state)
-                    .then([this, &cf, &m, m_schema, timeout, trace_state] (auto mopt) {
+            // counter state for each modified cell, unless the counter cache
+            // has our shards of all of them...
+
+            auto local_host_id = db::system_keyspace::get_local_host_id();
+            auto* cache = cf.get_counter_cache();
+            uint64_t generation = 0;
+            mutation_opt cached;
+            if (cache && counter_cache::has_tombstones(m)) {
+                // Deletions aren't cached, applying them invalidates the cache.
+                cache = nullptr;
+            }
+            if (cache) {
+                generation = cache->generation();
+                cached = cache->get(m, counter_id(local_host_id));
+            }
+            auto current_state = [&] {
+                if (cached) {
+                    tracing::trace(trace_state, "Found counter values in the counter cache");
+                    return make_ready_future<mutation_opt>(std::move(cached));
+                }
+                tracing::trace(trace_state, "Reading counter values from the CF");
+                auto permit = get_reader_concurrency_semaphore().make_tracking_only_permit(m_schema.get(), "counter-read-before-write", timeout);
+                return counter_write_query(m_schema, cf.as_mutation_source(), std::move(permit), m.decorated_key(), slice, trace_state);
+            }();
+            return std::move(current_state).then([this, &cf, &m, timeout, trace_state, local_host_id, cache, generation] (mutation_opt mopt) {
                 // ...now, that we got existing state of all affected counter
                 // cells we can look for our shard in each of them, increment
                 // its clock and apply the delta.
-                auto local_host_id = db::system_keyspace::get_local_host_id();
-                transform_counter_updates_to_shards(m, mopt ? &*mopt : nullptr, cf.failed_counter_applies_to_memtable(), std::move(local_host_id));
+                transform_counter_updates_to_shards(m, mopt ? &*mopt : nullptr, cf.failed_counter_applies_to_memtable(), local_host_id);
                 tracing::trace(trace_state, "Applying counter update");
-                return this->apply_with_commitlog(cf, m, timeout);
+                return this->apply_with_commitlog(cf, m, timeout).then_wrapped([&m, local_host_id, cache, generation] (future<> f) {
+                    if (cache) {
+                        if (f.failed()) {
+                            cache->invalidate(m.decorated_key());
+                        } else {
+                            cache->update(m, counter_id(local_host_id), generation);
+                        }
+                    }
+                    return f;
+                });
             }).then([&m] {
                 return std::move(m);
             });
@@ -1750,6 +1966,55 @@ future<> database::apply_with_commitlog(column_family& cf, const mutation& m, db
     }
 }
 
+db::timeout_clock::duration database::compaction_backlog_write_delay(const schema& s) {
+    const float delay_threshold = _cfg.compaction_backlog_write_delay_threshold();
+    const float reject_threshold = _cfg.compaction_backlog_write_reject_threshold();
+    if ((!delay_threshold && !reject_threshold) || is_internal_keyspace(s.ks_name())) {
+        return db::timeout_clock::duration::zero();
+    }
+    // Only user writes are throttled. View updates and hints (applied in the
+    // streaming group, see apply_hint()) are internal writes, which the cluster
+    // needs to converge, and their writers have no way to back off.
+    if (s.is_view() || current_scheduling_group() == _dbcfg.streaming_scheduling_group) {
+        return db::timeout_clock::duration::zero();
+    }
+    auto backlog = _compaction_manager->normalized_backlog();
+    // The backlog of strategies without a tracker is unknown, not infinite.
+    if (compaction_controller::backlog_disabled(backlog)) {
+        return db::timeout_clock::duration::zero();
+    }
+    if (reject_threshold && backlog > reject_threshold) {
+        ++_stats->total_writes_rejected_by_compaction_backlog;
+        throw exceptions::overloaded_exception(format("Compaction backlog {} of {}.{} is above compaction_backlog_write_reject_threshold {}",
+                backlog, s.ks_name(), s.cf_name(), reject_threshold));
+    }
+    if (!delay_threshold || backlog <= delay_threshold) {
+        return db::timeout_clock::duration::zero();
+    }
+    // The delay grows linearly, reaching its maximum at the reject threshold, if set,
+    // or at twice the delay threshold otherwise.
+    auto max_backlog = reject_threshold > delay_threshold ? reject_threshold : 2 * delay_threshold;
+    auto fraction = std::min(1.0, (backlog - delay_threshold) / (max_backlog - delay_threshold));
+    ++_stats->total_writes_delayed_by_compaction_backlog;
+    return std::chrono::duration_cast<db::timeout_clock::duration>(
+            std::chrono::milliseconds(_cfg.compaction_backlog_max_write_delay_in_ms()) * fraction);
+}
+
+std::chrono::milliseconds database::streaming_backlog_delay() const {
+    const float threshold = _cfg.stream_receive_backlog_delay_threshold();
+    if (!threshold) {
+        return std::chrono::milliseconds::zero();
+    }
+    auto backlog = _compaction_manager->normalized_backlog();
+    if (compaction_controller::backlog_disabled(backlog) || backlog <= threshold) {
+        return std::chrono::milliseconds::zero();
+    }
+    // Like compaction_backlog_write_delay(), reaching the maximum at twice the threshold.
+    auto fraction = std::min(1.0, (backlog - threshold) / threshold);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::milliseconds(_cfg.compaction_backlog_max_write_delay_in_ms()) * fraction);
+}
+
 future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::trace_state_ptr tr_state, db::timeout_clock::time_point timeout, db::commitlog::force_sync sync) {
     // I'm doing a nullcheck here since the init code path for db etc
     // is a little in flux and commitlog is created only when db is
@@ -1762,14 +2027,32 @@ future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::tra
 
     sync = sync || db::commitlog::force_sync(s->wait_for_sync_to_commitlog());
 
+    if (auto delay = compaction_backlog_write_delay(*s); delay.count()) {
+        // Don't sleep past the timeout, the write would fail anyway.
+        if (db::timeout_clock::now() + delay >= timeout) {
+            co_await seastar::sleep(std::max(timeout - db::timeout_clock::now(), db::timeout_clock::duration::zero()));
+            throw timed_out_error{};
+        }
+        co_await seastar::sleep(delay);
+    }
+
     // Signal to view building code that a write is in progress,
     // so it knows when new writes start being sent to a new view.
     auto op = cf.write_in_progress();
 
+    using stage = latency_breakdown::stage;
+    auto& latencies = cf.get_stats().latencies;
+    auto stage_start = std::chrono::steady_clock::now();
+    auto end_stage = [&] (stage st) {
+        const auto now = std::chrono::steady_clock::now();
+        latencies[st].add(std::chrono::duration_cast<std::chrono::microseconds>(now - std::exchange(stage_start, now)).count());
+    };
+
     row_locker::lock_holder lock;
     if (!cf.views().empty()) {
         lock = co_await cf.push_view_replica_updates(s, m, timeout, std::move(tr_state), get_reader_concurrency_semaphore());
     }
+    end_stage(stage::write_view_update);
 
     // purposefully manually "inlined" apply_with_commitlog call here to reduce # coroutine
     // frames.
@@ -1786,12 +2069,14 @@ future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::tra
             throw_commitlog_add_error<>(s, m);
         }
     }
+    end_stage(stage::write_commitlog);
     try {
         co_await this->apply_in_memory(m, s, std::move(h), timeout);
     } catch (mutation_reordered_with_truncate_exception&) {
         // This mutation raced with a truncate, so we can just drop it.
         dblog.debug("replay_position reordering detected");
     }
+    end_stage(stage::write_memtable);
 }
 
 template<typename Future>
@@ -1844,6 +2129,9 @@ database::make_keyspace_config(const keyspace_metadata& ksm) {
         for (auto& extra : _cfg.data_file_directories()) {
             cfg.all_datadirs.push_back(format("{}/{}", extra, ksm.name()));
         }
+        if (!_cfg.cold_storage_directory().empty() && !is_system_keyspace(ksm.name())) {
+            cfg.cold_datadir = format("{}/{}", _cfg.cold_storage_directory(), ksm.name());
+        }
         cfg.enable_disk_writes = !_cfg.enable_in_memory_data_store();
         cfg.enable_disk_reads = true; // we allways read from disk
         cfg.enable_commitlog = _cfg.enable_commitlog() && !_cfg.enable_in_memory_data_store();
@@ -1858,10 +2146,14 @@ database::make_keyspace_config(const keyspace_metadata& ksm) {
     }
     cfg.enable_dangerous_direct_import_of_cassandra_counters = _cfg.enable_dangerous_direct_import_of_cassandra_counters();
     cfg.compaction_enforce_min_threshold = _cfg.compaction_enforce_min_threshold;
+    cfg.major_compaction_parallelism = _cfg.major_compaction_parallelism;
+    cfg.compaction_index_cache_prewarm_keys = _cfg.compaction_index_cache_prewarm_keys;
+    cfg.memtable_flush_writers = _cfg.memtable_flush_writers;
     cfg.dirty_memory_manager = &_dirty_memory_manager;
     cfg.streaming_read_concurrency_semaphore = &_streaming_concurrency_sem;
     cfg.compaction_concurrency_semaphore = &_compaction_concurrency_sem;
     cfg.cf_stats = &_cf_stats;
+    cfg.sstable_placement = _sstable_placement.get();
     cfg.enable_incremental_backups = _enable_incremental_backups;
 
     cfg.compaction_scheduling_group = _dbcfg.compaction_scheduling_group;
@@ -2011,6 +2303,7 @@ future<> database::stop() {
     co_await _memtable_controller.shutdown();
     co_await _user_sstables_manager->close();
     co_await _system_sstables_manager->close();
+    co_await _sstable_placement->stop();
     co_await _querier_cache.stop();
     co_await _read_concurrency_sem.stop();
     co_await _streaming_concurrency_sem.stop();
@@ -2096,6 +2389,7 @@ future<> database::truncate(const keyspace& ks, column_family& cf, timestamp_fun
             });
         }).then([this, uuid] {
             drop_repair_history_map_for_table(uuid);
+            _large_data_handler->large_partitions().forget(uuid);
         });
     });
 }
@@ -69,6 +69,10 @@
 
 class cell_locker;
 class cell_locker_stats;
+class counter_cache;
+struct counter_cache_stats;
+class digest_cache;
+struct digest_cache_stats;
 class locked_cell;
 class mutation;
 
@@ -85,6 +89,10 @@ namespace gms {
 class feature_service;
 }
 
+namespace utils {
+class alien_worker;
+}
+
 namespace sstables {
 
 class sstable;
@@ -116,6 +124,7 @@ class config;
 class extensions;
 class rp_handle;
 class data_listeners;
+class hot_partitions_tracker;
 class large_data_handler;
 
 future<> system_keyspace_make(distributed<replica::database>& db, distributed<service::storage_service>& ss, sharded<gms::gossiper>& g, db::config& cfg);
@@ -299,10 +308,17 @@ struct cf_stats {
     int64_t clustering_filter_fast_path_count = 0;
     // how many sstables survived the clustering key checks
     int64_t surviving_sstables_after_clustering_filter = 0;
+    // how many sstables weren't read in single partition reads because a
+    // partition tombstone in a newer sstable covered all their data
+    int64_t sstables_skipped_by_partition_tombstone = 0;
 
     // How many view updates were dropped due to overload.
     int64_t dropped_view_updates = 0;
 
+    // How many times the read-before-write of view updates was skipped
+    // because the base partition was known not to exist.
+    int64_t view_update_reads_skipped = 0;
+
     // How many times view building was paused (e.g. due to node unavailability)
     int64_t view_building_paused = 0;
 
@@ -314,6 +330,7 @@ struct cf_stats {
 };
 
 class table;
+class sstable_placement;
 using column_family = table;
 struct table_stats;
 using column_family_stats = table_stats;
@@ -324,6 +341,59 @@ using enable_backlog_tracker = bool_class<class enable_backlog_tracker_tag>;
 
 extern const ssize_t new_reader_base_cost;
 
+// Where the time of the reads and writes of a table goes, by stage.
+// Every data query adds to all the read stages and every write to all the
+// write stages, so the means of the stages add up to the mean latency.
+// See system.table_latency_breakdown.
+struct latency_breakdown {
+    enum class stage {
+        // Waiting for admission by the reader_concurrency_semaphore.
+        read_admission,
+        // Waiting for sstable index reads.
+        read_sstable_index,
+        // Waiting for sstable data reads.
+        read_sstable_data,
+        // The rest of the query: cache, memtables, merging and building
+        // the result, which are interleaved too finely to time apart.
+        read_other,
+        // Reading the current rows for the view updates.
+        write_view_update,
+        write_commitlog,
+        // Including waiting for dirty memory.
+        write_memtable,
+    };
+    static constexpr size_t nr_stages = size_t(stage::write_memtable) + 1;
+
+    struct stage_stats {
+        uint64_t count = 0;
+        uint64_t total_us = 0;
+        uint64_t max_us = 0;
+
+        void add(uint64_t us) noexcept {
+            ++count;
+            total_us += us;
+            max_us = std::max(max_us, us);
+        }
+        stage_stats& operator+=(const stage_stats& o) noexcept {
+            count += o.count;
+            total_us += o.total_us;
+            max_us = std::max(max_us, o.max_us);
+            return *this;
+        }
+    };
+
+    std::array<stage_stats, nr_stages> stages;
+
+    stage_stats& operator[](stage st) noexcept {
+        return stages[size_t(st)];
+    }
+    const stage_stats& operator[](stage st) const noexcept {
+        return stages[size_t(st)];
+    }
+
+    static std::string_view name(stage st);
+};
+
 struct table_stats {
     /** Number of times flush has resulted in the memtable being switched out. */
     int64_t memtable_switch_count = 0;
@@ -352,7 +422,14 @@ struct table_stats {
     utils::estimated_histogram estimated_sstable_per_read{35};
     utils::timed_rate_moving_average_and_histogram tombstone_scanned;
     utils::timed_rate_moving_average_and_histogram live_scanned;
-    utils::estimated_histogram estimated_coordinator_read;
+    // What the queries of the table cost, see table::query().
+    reader_permit::read_stats query_read_stats;
+    uint64_t query_rows_returned = 0;
+    uint64_t query_bytes_returned = 0;
+    latency_breakdown latencies;
+    // Coordinator read latencies, in microseconds, from 64us to 33s. Decays
+    // fast, see table::get_coordinator_read_latency_percentile().
+    utils::approx_exponential_histogram<64, 33554432, 8> estimated_coordinator_read;
 };
 
 class table : public enable_lw_shared_from_this<table> {
@@ -360,17 +437,25 @@ class table : public enable_lw_shared_from_this<table> {
     struct config {
         std::vector<sstring> all_datadirs;
         sstring datadir;
+        // Where cold sstables are offloaded to, see compaction_type::Offload.
+        // Empty if there is no cold storage.
+        sstring cold_datadir;
         bool enable_disk_writes = true;
         bool enable_disk_reads = true;
         bool enable_cache = true;
         bool enable_commitlog = true;
         bool enable_incremental_backups = false;
         utils::updateable_value<bool> compaction_enforce_min_threshold{false};
+        utils::updateable_value<uint32_t> major_compaction_parallelism{1};
+        utils::updateable_value<uint32_t> compaction_index_cache_prewarm_keys{0};
+        utils::updateable_value<uint32_t> memtable_flush_writers{1};
         bool enable_dangerous_direct_import_of_cassandra_counters = false;
         ::dirty_memory_manager* dirty_memory_manager = &default_dirty_memory_manager;
         reader_concurrency_semaphore* streaming_read_concurrency_semaphore;
         reader_concurrency_semaphore* compaction_concurrency_semaphore;
         replica::cf_stats* cf_stats = nullptr;
+        // Chooses which of all_datadirs new sstables go to, see sstable_placement.
+        replica::sstable_placement* sstable_placement = nullptr;
         seastar::scheduling_group memtable_scheduling_group;
         seastar::scheduling_group memtable_to_cache_scheduling_group;
         seastar::scheduling_group compaction_scheduling_group;
@@ -382,10 +467,20 @@ class table : public enable_lw_shared_from_this<table> {
         db::timeout_semaphore* view_update_concurrency_semaphore;
         size_t view_update_concurrency_semaphore_limit;
         db::data_listeners* data_listeners = nullptr;
+        // Memory for caching the local shards of counter cells, per shard and
+        // shared by the counter caches of all tables through counter_cache_stats.
+        size_t counter_cache_size = 0;
+        counter_cache_stats* counter_cache_stats = nullptr;
+        // Memory for caching the digests of digest-only partition reads, per table.
+        size_t digest_cache_size = 0;
+        digest_cache_stats* digest_cache_stats = nullptr;
         // Not really table-specific (it's a global configuration parameter), but stored here
         // for easy access from `table` member functions:
         utils::updateable_value<bool> reversed_reads_auto_bypass_cache{false};
+        utils::updateable_value<bool> large_partitions_reversed_reads_bypass_cache{true};
         utils::updateable_value<bool> enable_optimized_reversed_reads{true};
+        utils::updateable_value<uint32_t> cache_cold_entry_compression_period_in_s{0};
+        utils::updateable_value<bool> view_update_skip_read_for_new_partitions{true};
         // Can be updated by a schema change:
         bool enable_optimized_twcs_queries{true};
     };
@@ -458,6 +553,8 @@ class table : public enable_lw_shared_from_this<table> {
     std::vector<view_ptr> _views;
 
     std::unique_ptr<cell_locker> _counter_cell_locks; // Memory-intensive; allocate only when needed.
+    std::unique_ptr<counter_cache> _counter_cache; // Only for counter tables, if enabled.
+    std::unique_ptr<digest_cache> _digest_cache; // Only if enabled.
     void set_metrics();
     seastar::metrics::metric_groups _metrics;
 
@@ -470,6 +567,11 @@ class table : public enable_lw_shared_from_this<table> {
     // in dynamically
     std::unordered_map<gms::inet_address, cache_hit_rate> _cluster_cache_hit_rates;
 
+    // Moving averages of the memory consumed by past reads of this table,
+    // see estimate_read_memory_cost(). Zero until the first read completes.
+    size_t _single_partition_read_cost = 0;
+    size_t _range_read_cost = 0;
+
     // Operations like truncate, flush, query, etc, may depend on a column family being alive to
     // complete.  Some of them have their own gate already (like flush), used in specialized wait
     // logic. That is particularly useful if there is a particular
@@ -480,7 +582,7 @@ class table : public enable_lw_shared_from_this<table> {
 
     double _cached_percentile = -1;
     lowres_clock::time_point _percentile_cache_timestamp;
-    std::chrono::milliseconds _percentile_cache_value;
+    std::chrono::microseconds _percentile_cache_value;
 
     // Phaser used to synchronize with in-progress writes. This is useful for code that,
     // after some modification, needs to ensure that news writes will see it before
@@ -505,6 +607,9 @@ class table : public enable_lw_shared_from_this<table> {
     future<> add_sstable_and_update_cache(sstables::shared_sstable sst,
                                           sstables::offstrategy offstrategy = sstables::offstrategy::no);
     future<> add_sstables_and_update_cache(const std::vector<sstables::shared_sstable>& ssts);
+    // If the table has pinned caching, reads the range through the cache, so that
+    // the following reads are served from memory. Loads the table into memory at startup.
+    future<> populate_pinned_cache(dht::partition_range range = query::full_partition_range);
     future<> move_sstables_from_staging(std::vector<sstables::shared_sstable>);
     sstables::shared_sstable make_sstable(sstring dir, int64_t generation, sstables::sstable_version_types v, sstables::sstable_format_types f,
             io_error_handler_gen error_handler_gen);
@@ -544,6 +649,18 @@ class table : public enable_lw_shared_from_this<table> {
     bool cache_enabled() const {
         return _config.enable_cache && _schema->caching_options().enabled();
     }
+    // Whether the table is cached whole, see caching_options::pinned().
+    bool cache_pinned() const {
+        return cache_enabled() && _cache.get_cache_tracker().is_pinned();
+    }
+    // Reads the range of a table with pinned caching in the background, to populate it back into cache.
+    void repopulate_pinned_cache(dht::partition_range range);
+    // Whether the range is a single partition recently written as a large
+    // partition.
+    bool is_known_large_partition(const dht::partition_range& range) const;
+    // Counts a read of the range towards the reads of the large partition,
+    // if it is one. Returns whether it is.
+    bool count_large_partition_read(const dht::partition_range& range);
     void update_stats_for_new_sstable(uint64_t disk_space_used_by_sstable) noexcept;
     future<> do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy);
     // Adds new sstable to the set of sstables
@@ -563,6 +680,12 @@ class table : public enable_lw_shared_from_this<table> {
     void backlog_tracker_adjust_charges(const std::vector<sstables::shared_sstable>& old_sstables, const std::vector<sstables::shared_sstable>& new_sstables);
     lw_shared_ptr<memtable> new_memtable();
     future<stop_iteration> try_flush_memtable_to_sstable(lw_shared_ptr<memtable> memt, sstable_write_permit&& permit);
+    // Whether tombstones written now could already be purged, so that
+    // flushing a memtable should try to drop them.
+    bool tombstones_purgeable_on_flush() const;
+    // The timestamp below which tombstones of the flushed memtable can't
+    // shadow data in any other memtable or sstable of this table.
+    api::timestamp_type max_purgeable_timestamp_for_flush(const memtable& flushed, const dht::decorated_key& dk) const;
     // Caller must keep m alive.
     future<> update_cache(lw_shared_ptr<memtable> m, std::vector<sstables::shared_sstable> ssts);
     struct merge_comparator;
@@ -595,6 +718,12 @@ class table : public enable_lw_shared_from_this<table> {
     // Rebuild sstable set, delete input sstables right away, and update row cache and statistics.
     void on_compaction_completion(sstables::compaction_completion_desc& desc);
 
+    // Loads the index entries of partitions present in the row cache into the index caches
+    // of sstables written by compaction, up to compaction_index_cache_prewarm_keys per sstable.
+    future<> prewarm_index_caches(std::vector<sstables::shared_sstable> sstables);
+    // Starts prewarm_index_caches() in the background, if enabled.
+    void start_prewarming_index_caches(std::vector<sstables::shared_sstable> sstables);
+
     void rebuild_statistics();
 
     // Called on schema change.
@@ -636,12 +765,24 @@ class table : public enable_lw_shared_from_this<table> {
         return _config.datadir;
     }
 
+    const sstring& cold_dir() const {
+        return _config.cold_datadir;
+    }
+
     seastar::gate& async_gate() { return _async_gate; }
 
     uint64_t failed_counter_applies_to_memtable() const {
         return _failed_counter_applies_to_memtable;
     }
 
+    counter_cache* get_counter_cache() noexcept {
+        return _counter_cache.get();
+    }
+
+    digest_cache* get_digest_cache() noexcept {
+        return _digest_cache.get();
+    }
+
     // This function should be called when this column family is ready for writes, IOW,
     // to produce SSTables. Extensive details about why this is important can be found
     // in Scylla's Github Issue #1014
@@ -705,8 +846,11 @@ class table : public enable_lw_shared_from_this<table> {
     //    reader and a _bounded_ amount of writes which arrive later.
     //  - Does not populate the cache
     // Requires ranges to be sorted and disjoint.
+    // Sstables in excluded_sstables are not read, their data is assumed to be
+    // streamed by other means.
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
-            const dht::partition_range_vector& ranges) const;
+            const dht::partition_range_vector& ranges,
+            std::unordered_set<sstables::shared_sstable> excluded_sstables = {}) const;
 
     // Single range overload.
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
@@ -844,6 +988,9 @@ class table : public enable_lw_shared_from_this<table> {
 
     future<> snapshot(database& db, sstring name, bool skip_flush = false);
     future<std::unordered_map<sstring, snapshot_details>> get_snapshot_details();
+    // The directories the files of the snapshot may be in, one per data
+    // directory, the first one holding the manifest. Some may not exist.
+    std::vector<sstring> snapshot_dirs(const sstring& name) const;
 
     /*!
      * \brief write the schema to a 'schema.cql' file at the given directory.
@@ -883,6 +1030,8 @@ class table : public enable_lw_shared_from_this<table> {
     lw_shared_ptr<const sstable_list> get_sstables_including_compacted_undeleted() const;
     const std::vector<sstables::shared_sstable>& compacted_undeleted_sstables() const;
     std::vector<sstables::shared_sstable> select_sstables(const dht::partition_range& range) const;
+    // Whether some memtable of the table, including the ones being flushed, has data in the range.
+    bool memtables_have_data_in(const dht::partition_range& range) const;
     // Return all sstables but those that are off-strategy like the ones in maintenance set and staging dir.
     std::vector<sstables::shared_sstable> in_strategy_sstables() const;
     size_t sstables_count() const;
@@ -1011,7 +1160,7 @@ class table : public enable_lw_shared_from_this<table> {
             std::vector<sstables::shared_sstable>& excluded_sstables) const;
 
     void add_coordinator_read_latency(utils::estimated_histogram::duration latency);
-    std::chrono::milliseconds get_coordinator_read_latency_percentile(double percentile);
+    std::chrono::microseconds get_coordinator_read_latency_percentile(double percentile);
 
     secondary_index::secondary_index_manager& get_index_manager() {
         return _index_manager;
@@ -1039,9 +1188,21 @@ class table : public enable_lw_shared_from_this<table> {
 
     size_t estimate_read_memory_cost() const;
 
+    // Estimates the memory a query will consume, which it is admitted by.
+    // Based on the number of sstables the query has to read, the slice it
+    // reads from each partition, and the memory past similar reads of this
+    // table actually consumed.
+    size_t estimate_read_memory_cost(const query::partition_slice& slice, const dht::partition_range_vector& ranges) const;
+    // Records the memory a query consumed, for the future estimates.
+    void update_read_memory_cost(const dht::partition_range_vector& ranges, size_t consumed_memory);
+
 private:
     future<row_locker::lock_holder> do_push_view_replica_updates(schema_ptr s, mutation m, db::timeout_clock::time_point timeout, mutation_source source,
-            tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts) const;
+            tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts,
+            bool may_skip_read = false) const;
+    // Returns false if the partition is known not to be in the table: it's in none
+    // of the memtables and all the sstables rule it out with their bloom filters.
+    bool may_contain_partition(const dht::decorated_key& dk) const;
     std::vector<view_ptr> affected_views(const schema_ptr& base, const mutation& update) const;
     future<> generate_and_propagate_view_updates(const schema_ptr& base,
             reader_permit permit,
@@ -1084,6 +1245,11 @@ class table : public enable_lw_shared_from_this<table> {
     timer<> _off_strategy_trigger;
     void do_update_off_strategy_trigger();
 
+    // Periodically compresses cold partitions in cache, see row_cache::compress_cold_entries().
+    timer<> _cache_compression_timer;
+    void arm_cache_compression_timer();
+    void compress_cold_cache_entries();
+
 public:
     void update_off_strategy_trigger();
     void enable_off_strategy_trigger();
@@ -1100,17 +1266,22 @@ class keyspace {
     struct config {
         std::vector<sstring> all_datadirs;
         sstring datadir;
+        sstring cold_datadir;
         bool enable_commitlog = true;
         bool enable_disk_reads = true;
         bool enable_disk_writes = true;
         bool enable_cache = true;
         bool enable_incremental_backups = false;
         utils::updateable_value<bool> compaction_enforce_min_threshold{false};
+        utils::updateable_value<uint32_t> major_compaction_parallelism{1};
+        utils::updateable_value<uint32_t> compaction_index_cache_prewarm_keys{0};
+        utils::updateable_value<uint32_t> memtable_flush_writers{1};
         bool enable_dangerous_direct_import_of_cassandra_counters = false;
         ::dirty_memory_manager* dirty_memory_manager = &default_dirty_memory_manager;
         reader_concurrency_semaphore* streaming_read_concurrency_semaphore;
         reader_concurrency_semaphore* compaction_concurrency_semaphore;
         replica::cf_stats* cf_stats = nullptr;
+        replica::sstable_placement* sstable_placement = nullptr;
         seastar::scheduling_group memtable_scheduling_group;
         seastar::scheduling_group memtable_to_cache_scheduling_group;
         seastar::scheduling_group compaction_scheduling_group;
@@ -1207,6 +1378,9 @@ struct database_config {
     seastar::scheduling_group gossip_scheduling_group;
     size_t available_memory;
     std::optional<sstables::sstable_version_types> sstables_format;
+    // Runs the CPU-heavy work of sstable writers, like training compression
+    // dictionaries, off the reactor. Without it, that work is skipped.
+    utils::alien_worker* alien_worker = nullptr;
 };
 
 struct string_pair_eq {
@@ -1256,6 +1430,8 @@ class database {
         uint64_t total_writes = 0;
         uint64_t total_writes_failed = 0;
         uint64_t total_writes_timedout = 0;
+        uint64_t total_writes_delayed_by_compaction_backlog = 0;
+        uint64_t total_writes_rejected_by_compaction_backlog = 0;
         uint64_t total_reads = 0;
         uint64_t total_reads_failed = 0;
 
@@ -1270,6 +1446,8 @@ class database {
 
     lw_shared_ptr<db_stats> _stats;
     std::unique_ptr<cell_locker_stats> _cl_stats;
+    std::unique_ptr<counter_cache_stats> _counter_cache_stats;
+    std::unique_ptr<digest_cache_stats> _digest_cache_stats;
 
     const db::config& _cfg;
 
@@ -1288,6 +1466,8 @@ class database {
     db::timeout_semaphore _view_update_concurrency_sem{max_memory_pending_view_updates()};
 
     cache_tracker _row_cache_tracker;
+    // Caches the tables with caching = {'pinned': 'true'}, see caching_options::pinned().
+    cache_tracker _pinned_row_cache_tracker;
 
     inheriting_concrete_execution_stage<
             future<>,
@@ -1324,6 +1504,8 @@ class database {
 
     friend db::data_listeners;
     std::unique_ptr<db::data_listeners> _data_listeners;
+    std::unique_ptr<db::hot_partitions_tracker> _hot_partitions;
+    std::unique_ptr<sstable_placement> _sstable_placement;
 
     service::migration_notifier& _mnotifier;
     gms::feature_service& _feat;
@@ -1365,7 +1547,12 @@ class database {
 
     friend class db_apply_executor;
     future<> do_apply(schema_ptr, const frozen_mutation&, tracing::trace_state_ptr tr_state, db::timeout_clock::time_point timeout, db::commitlog_force_sync sync);
+    // Returns how long to delay a user write because compaction is
+    // falling behind, or throws overloaded_exception if it fell too far behind.
+    db::timeout_clock::duration compaction_backlog_write_delay(const schema& s);
     future<> apply_with_commitlog(column_family& cf, const mutation& m, db::timeout_clock::time_point timeout);
+    // The memory cost a user read is admitted with, see reader_concurrency_estimate_read_cost.
+    size_t estimate_read_memory_cost(const table& cf, const query::partition_slice& slice, const dht::partition_range_vector& ranges) const;
 
     future<mutation> do_apply_counter_update(column_family& cf, const frozen_mutation& fm, schema_ptr m_schema, db::timeout_clock::time_point timeout,
                                              tracing::trace_state_ptr trace_state);
@@ -1409,6 +1596,7 @@ class database {
     ~database();
 
     cache_tracker& row_cache_tracker() { return _row_cache_tracker; }
+    cache_tracker& pinned_row_cache_tracker() { return _pinned_row_cache_tracker; }
     future<> drop_caches() const;
 
     void update_version(const utils::UUID& version);
@@ -1425,6 +1613,9 @@ class database {
 
     seastar::scheduling_group get_statement_scheduling_group() const { return _dbcfg.statement_scheduling_group; }
     seastar::scheduling_group get_streaming_scheduling_group() const { return _dbcfg.streaming_scheduling_group; }
+    // Returns how long to pause before receiving the next streamed partition
+    // because compaction is falling behind.
+    std::chrono::milliseconds streaming_backlog_delay() const;
 
     compaction_manager& get_compaction_manager() {
         return *_compaction_manager;
@@ -1613,6 +1804,18 @@ class database {
         return *_data_listeners;
     }
 
+    db::hot_partitions_tracker& hot_partitions() const {
+        return *_hot_partitions;
+    }
+
+    counter_cache_stats& get_counter_cache_stats() const {
+        return *_counter_cache_stats;
+    }
+
+    digest_cache_stats& get_digest_cache_stats() const {
+        return *_digest_cache_stats;
+    }
+
     // Get the maximum result size for an unlimited query, appropriate for the
     // query class, which is deduced from the current scheduling group.
     query::max_result_size get_unlimited_query_max_result_size() const;
@@ -563,6 +563,12 @@ future<> distributed_loader::populate_keyspace(distributed<replica::database>& d
                     return distributed_loader::populate_column_family(db, sstdir + "/" + sstables::quarantine_dir, ks_name, cfname, false /* must_exist */);
                 }).then([&db, sstdir, uuid, ks_name, cfname] {
                     return distributed_loader::populate_column_family(db, sstdir, ks_name, cfname);
+                }).then([&db, cf, ksdir, &ks, ks_name, cfname] {
+                    // The cold storage directory is populated along with the first data directory.
+                    if (cf->cold_dir().empty() || ksdir != ks.datadir()) {
+                        return make_ready_future<>();
+                    }
+                    return distributed_loader::populate_column_family(db, cf->cold_dir(), ks_name, cfname, false /* must_exist */);
                 }).handle_exception([ks_name, cfname, sstdir](std::exception_ptr eptr) {
                     std::string msg =
                         format("Exception while populating keyspace '{}' with column family '{}' from file '{}': {}",
@@ -587,12 +593,14 @@ future<> distributed_loader::init_system_keyspace(distributed<replica::database>
             return db::system_keyspace::make(db, ss, g, cfg);
         }).get();
 
+        // The system keyspaces don't depend on each other, populate
+        // them all at once, like the non-system ones.
         const auto& cfg = db.local().get_config();
-        for (auto& data_dir : cfg.data_file_directories()) {
-            for (auto ksname : system_keyspaces) {
-                distributed_loader::populate_keyspace(db, data_dir, sstring(ksname)).get();
-            }
-        }
+        parallel_for_each(cfg.data_file_directories(), [&db] (sstring data_dir) {
+            return parallel_for_each(system_keyspaces, [&db, data_dir] (std::string_view ksname) {
+                return distributed_loader::populate_keyspace(db, data_dir, sstring(ksname));
+            });
+        }).get();
 
         db.invoke_on_all([] (replica::database& db) {
             for (auto ksname : system_keyspaces) {
@@ -687,7 +695,9 @@ future<> distributed_loader::init_non_system_keyspaces(distributed<replica::data
             return parallel_for_each(db.get_non_system_column_families(), [] (lw_shared_ptr<replica::table> table) {
                 // Make sure this is called even if the table is empty
                 table->mark_ready_for_writes();
-                return make_ready_future<>();
+                return table->populate_pinned_cache().handle_exception([table] (std::exception_ptr ep) {
+                    dblog.warn("Failed to load {}.{} into its pinned cache: {}, reads will populate it", table->schema()->ks_name(), table->schema()->cf_name(), ep);
+                });
             });
         }).get();
     });
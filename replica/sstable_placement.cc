@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/seastar.hh>
+
+#include "replica/sstable_placement.hh"
+#include "log.hh"
+
+extern logging::logger dblog;
+
+namespace replica {
+
+sstable_placement::sstable_placement(const std::vector<sstring>& dirs)
+    : _refresh_timer([this] {
+        (void)with_gate(_gate, [this] {
+            return refresh();
+        });
+    })
+{
+    for (auto& d : dirs) {
+        _dirs.push_back(directory{d});
+    }
+    if (_dirs.size() > 1) {
+        _refresh_timer.arm(lowres_clock::now(), refresh_period);
+    }
+}
+
+size_t sstable_placement::choose() noexcept {
+    if (_dirs.size() <= 1) {
+        return 0;
+    }
+    uint64_t max_available = 0;
+    for (auto& d : _dirs) {
+        max_available = std::max(max_available, d.available);
+    }
+    size_t best = 0;
+    bool found = false;
+    for (size_t i = 0; i < _dirs.size(); ++i) {
+        auto& d = _dirs[i];
+        if (d.available < max_available / 2) {
+            continue;
+        }
+        auto& b = _dirs[best];
+        if (!found || d.recent_placements < b.recent_placements
+                || (d.recent_placements == b.recent_placements && d.available > b.available)) {
+            best = i;
+            found = true;
+        }
+    }
+    _dirs[best].recent_placements += 1;
+    return best;
+}
+
+future<> sstable_placement::refresh() {
+    for (auto& d : _dirs) {
+        try {
+            d.available = co_await seastar::fs_avail(d.path);
+        } catch (...) {
+            dblog.warn("Failed to get the free space of data directory {}: {}", d.path, std::current_exception());
+        }
+        d.recent_placements /= 2;
+    }
+}
+
+future<> sstable_placement::stop() {
+    _refresh_timer.cancel();
+    return _gate.close();
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <vector>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+
+#include "seastarx.hh"
+
+namespace replica {
+
+/// \brief Chooses which of the data_file_directories new sstables go to.
+///
+/// With several data directories, each usually on a disk of its own, new
+/// sstables (of flushes and compactions) are spread across them, so the
+/// bandwidth of each disk is used. The next sstable goes to the directory
+/// with the fewest sstables placed in it recently, among those with at least
+/// half the free space of the emptiest one, so a fuller disk is only written
+/// to when it's not the bottleneck. Each shard places its sstables
+/// independently.
+///
+/// The free space is refreshed every refresh_period, when the count of the
+/// recent placements also decays by half.
+class sstable_placement {
+    static constexpr auto refresh_period = std::chrono::seconds(10);
+
+    struct directory {
+        sstring path;
+        uint64_t available = 0;
+        double recent_placements = 0;
+    };
+    std::vector<directory> _dirs;
+    timer<lowres_clock> _refresh_timer;
+    seastar::gate _gate;
+public:
+    explicit sstable_placement(const std::vector<sstring>& dirs);
+
+    /// Returns the index of the directory, in the order of the directories
+    /// the placement was created with, to write the next sstable to.
+    size_t choose() noexcept;
+
+    future<> stop();
+private:
+    future<> refresh();
+};
+
+}
@@ -17,6 +17,8 @@
 #include "service/priority_manager.hh"
 #include "db/schema_tables.hh"
 #include "cell_locking.hh"
+#include "counter_cache.hh"
+#include "digest_cache.hh"
 #include "utils/logalloc.hh"
 #include "checked-file-impl.hh"
 #include "view_info.hh"
@@ -31,6 +33,7 @@
 #include "db/view/view.hh"
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 #include "utils/error_injection.hh"
 #include "utils/histogram_metrics_helper.hh"
 #include "utils/fb_utilities.hh"
@@ -39,6 +42,7 @@
 #include "db/config.hh"
 #include "db/commitlog/commitlog.hh"
 #include "lister.hh"
+#include "replica/sstable_placement.hh"
 
 #include <boost/range/algorithm/remove_if.hpp>
 #include <boost/range/algorithm.hpp>
@@ -52,6 +56,9 @@ static seastar::metrics::label keyspace_label("ks");
 
 using namespace std::chrono_literals;
 
+// Memtables are only split for flush into parts of at least that size.
+static constexpr size_t min_memtable_flush_part_size = 256 << 20;
+
 flat_mutation_reader_v2
 table::make_sstable_reader(schema_ptr s,
                                    reader_permit permit,
@@ -182,7 +189,9 @@ table::make_reader_v2(schema_ptr s,
     }
 
     const auto bypass_cache = slice.options.contains(query::partition_slice::option::bypass_cache);
-    if (cache_enabled() && !bypass_cache && !(reversed && _config.reversed_reads_auto_bypass_cache())) {
+    const bool large = is_known_large_partition(range);
+    if (cache_enabled() && !bypass_cache && !(reversed && (_config.reversed_reads_auto_bypass_cache()
+            || (large && _config.large_partitions_reversed_reads_bypass_cache())))) {
         readers.emplace_back(upgrade_to_v2(_cache.make_reader(s, permit, range, slice, pc, std::move(trace_state), fwd, fwd_mr)));
     } else {
         readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
@@ -201,6 +210,27 @@ table::make_reader_v2(schema_ptr s,
     return rd;
 }
 
+bool table::is_known_large_partition(const dht::partition_range& range) const {
+    const auto& large_partitions = get_sstables_manager().get_large_data_handler().large_partitions();
+    if (large_partitions.empty() || !range.is_singular() || !range.start()->value().has_key()) {
+        return false;
+    }
+    return large_partitions.find(_schema->id(), range.start()->value().token()) != nullptr;
+}
+
+bool table::count_large_partition_read(const dht::partition_range& range) {
+    auto& large_partitions = get_sstables_manager().get_large_data_handler().large_partitions();
+    if (large_partitions.empty() || !range.is_singular() || !range.start()->value().has_key()) {
+        return false;
+    }
+    auto* e = large_partitions.find(_schema->id(), range.start()->value().token());
+    if (!e) {
+        return false;
+    }
+    large_partitions.count_read(*e);
+    return true;
+}
+
 flat_mutation_reader
 table::make_reader(schema_ptr s,
                            reader_permit permit,
@@ -229,18 +259,30 @@ sstables::shared_sstable table::make_streaming_staging_sstable() {
 
 flat_mutation_reader_v2
 table::make_streaming_reader(schema_ptr s, reader_permit permit,
-                           const dht::partition_range_vector& ranges) const {
+                           const dht::partition_range_vector& ranges,
+                           std::unordered_set<sstables::shared_sstable> excluded_sstables) const {
     auto& slice = s->full_slice();
     auto& pc = service::get_local_streaming_priority();
 
-    auto source = mutation_source([this] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
+    auto source = mutation_source([this, excluded_sstables = std::move(excluded_sstables)] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
                                       const io_priority_class& pc, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
         std::vector<flat_mutation_reader_v2> readers;
         readers.reserve(_memtables->size() + 1);
         for (auto&& mt : *_memtables) {
             readers.emplace_back(upgrade_to_v2(mt->make_flat_reader(s, permit, range, slice, pc, trace_state, fwd, fwd_mr)));
         }
-        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+        // The set is filtered for every range, rather than once, so that
+        // sstables which are added in the meantime (e.g. flushed memtables) are read.
+        auto sstables = _sstables;
+        if (!excluded_sstables.empty()) {
+            sstables = make_lw_shared<sstables::sstable_set>(*_sstables);
+            for (auto& sst : excluded_sstables) {
+                if (sstables->all()->contains(sst)) {
+                    sstables->erase(sst);
+                }
+            }
+        }
+        readers.emplace_back(make_sstable_reader(s, permit, std::move(sstables), range, slice, pc, std::move(trace_state), fwd, fwd_mr));
         return make_combined_reader(s, std::move(permit), std::move(readers), fwd, fwd_mr);
     });
 
@@ -349,6 +391,12 @@ sstables::shared_sstable table::make_sstable(sstring dir) {
 }
 
 sstables::shared_sstable table::make_sstable() {
+    if (_config.sstable_placement && _config.all_datadirs.size() > 1) {
+        auto i = _config.sstable_placement->choose();
+        if (i < _config.all_datadirs.size()) {
+            return make_sstable(_config.all_datadirs[i]);
+        }
+    }
     return make_sstable(_config.datadir);
 }
 
@@ -438,7 +486,8 @@ void table::enable_off_strategy_trigger() {
 future<>
 table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy) {
     auto permit = co_await seastar::get_units(_sstable_set_mutation_sem, 1);
-    co_return co_await get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
+    auto range = dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true});
+    co_await get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
         // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
         // atomically load all opened sstables into column family.
         if (!offstrategy) {
@@ -446,7 +495,17 @@ table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::o
         } else {
             add_maintenance_sstable(sst);
         }
-    }), dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true}));
+        if (_counter_cache) {
+            // The sstable may carry deletions of cached counters.
+            _counter_cache->clear();
+        }
+        if (_digest_cache) {
+            _digest_cache->clear();
+        }
+    }), range);
+    if (cache_pinned()) {
+        repopulate_pinned_cache(std::move(range));
+    }
 }
 
 future<>
@@ -632,6 +691,46 @@ table::seal_active_memtable(flush_permit&& permit) {
     // FIXME: provide back-pressure to upper layers
 }
 
+bool table::tombstones_purgeable_on_flush() const {
+    switch (_schema->tombstone_gc_options().mode()) {
+    case tombstone_gc_mode::immediate:
+        return true;
+    case tombstone_gc_mode::timeout:
+        // E.g. system.paxos, whose state is pruned as soon as it is learned.
+        return _schema->gc_grace_seconds().count() == 0;
+    default:
+        return false;
+    }
+}
+
+api::timestamp_type table::max_purgeable_timestamp_for_flush(const memtable& flushed, const dht::decorated_key& dk) const {
+    auto timestamp = api::max_timestamp;
+    for (auto& mt : *_memtables) {
+        if (mt.get() != &flushed) {
+            timestamp = std::min(timestamp, mt->get_min_timestamp());
+        }
+    }
+    std::optional<utils::hashed_key> hk;
+    auto check = [&] (const sstables::shared_sstable& sst) {
+        if (sst->get_stats_metadata().min_timestamp >= timestamp) {
+            return;
+        }
+        if (!hk) {
+            hk = sstables::sstable::make_hashed_key(*_schema, dk.key());
+        }
+        if (sst->filter_has_key(*hk)) {
+            timestamp = std::min(timestamp, sst->get_stats_metadata().min_timestamp);
+        }
+    };
+    for (auto&& sst : _sstables->select(dht::partition_range::make_singular(dk))) {
+        check(sst);
+    }
+    for (auto&& sst : _sstables_compacted_but_not_deleted) {
+        check(sst);
+    }
+    return timestamp;
+}
+
 future<stop_iteration>
 table::try_flush_memtable_to_sstable(lw_shared_ptr<memtable> old, sstable_write_permit&& permit) {
     auto try_flush = [this, old = std::move(old), permit = make_lw_shared(std::move(permit))] () mutable -> future<stop_iteration> {
@@ -651,53 +750,97 @@ table::try_flush_memtable_to_sstable(lw_shared_ptr<memtable> old, sstable_write_
         auto metadata = mutation_source_metadata{};
         metadata.min_timestamp = old->get_min_timestamp();
         metadata.max_timestamp = old->get_max_timestamp();
-        auto estimated_partitions = _compaction_strategy.adjust_partition_estimate(metadata, old->partition_count());
 
-        auto consumer = _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs, metadata, estimated_partitions] (flat_mutation_reader_v2 reader) mutable -> future<> {
-            auto&& priority = service::get_local_memtable_flush_priority();
-            sstables::sstable_writer_config cfg = get_sstables_manager().configure_writer("memtable");
-            cfg.backup = incremental_backups_enabled();
-
-            auto newtab = make_sstable();
-            newtabs.push_back(newtab);
-            tlogger.debug("Flushing to {}", newtab->get_filename());
+        // A large memtable is split by token range, and the parts are written
+        // concurrently, so the flush isn't bound by the speed of one writer.
+        // The parts are disjoint, so unless the strategy splits them further
+        // (by time window), their sstables are a run.
+        auto max_parts = std::max<size_t>(1, old->occupancy().used_space() / min_memtable_flush_part_size);
+        auto ranges = old->split_for_flush(std::min<size_t>(std::max(_config.memtable_flush_writers(), 1u), max_parts));
+        std::optional<utils::UUID> run_identifier;
+        if (ranges.size() > 1 && !_compaction_strategy.use_interposer_consumer()) {
+            run_identifier = utils::make_random_uuid();
+        }
+        auto estimated_partitions = _compaction_strategy.adjust_partition_estimate(metadata, old->partition_count()) / ranges.size();
+
+        // The consumer returned by the strategy may only be used once, so each part gets its own.
+        auto make_consumer = [this, old, permit, &newtabs, metadata, estimated_partitions, run_identifier] {
+            return _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs, estimated_partitions, run_identifier] (flat_mutation_reader_v2 reader) mutable -> future<> {
+                auto&& priority = service::get_local_memtable_flush_priority();
+                sstables::sstable_writer_config cfg = get_sstables_manager().configure_writer("memtable");
+                cfg.backup = incremental_backups_enabled();
+                if (run_identifier) {
+                    cfg.run_identifier = *run_identifier;
+                }
 
-            auto monitor = database_sstable_write_monitor(permit, newtab, _compaction_strategy,
-                old->get_max_timestamp());
+                auto newtab = make_sstable();
+                newtabs.push_back(newtab);
+                tlogger.debug("Flushing to {}", newtab->get_filename());
 
-            co_return co_await write_memtable_to_sstable(downgrade_to_v1(std::move(reader)), *old, newtab, estimated_partitions, monitor, cfg, priority);
-        });
+                auto monitor = database_sstable_write_monitor(permit, newtab, _compaction_strategy,
+                    old->get_max_timestamp());
 
-        flat_mutation_reader reader = old->make_flush_reader(
-            old->schema(),
-            compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout),
-            service::get_local_memtable_flush_priority());
+                co_return co_await write_memtable_to_sstable(downgrade_to_v1(std::move(reader)), *old, newtab, estimated_partitions, monitor, cfg, priority);
+            });
+        };
 
-        if (old->has_any_tombstones()) {
-            reader = make_compacting_reader(
-                upgrade_to_v2(std::move(reader)),
-                gc_clock::now(),
-                [] (const dht::decorated_key&) { return api::min_timestamp; });
-        }
+        auto make_reader = [this, old] (const dht::partition_range& range) {
+            flat_mutation_reader reader = old->make_flush_reader(
+                old->schema(),
+                compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout),
+                service::get_local_memtable_flush_priority(),
+                range);
+
+            if (old->has_any_tombstones()) {
+                std::function<api::timestamp_type(const dht::decorated_key&)> max_purgeable = [] (const dht::decorated_key&) {
+                    return api::min_timestamp;
+                };
+                if (tombstones_purgeable_on_flush()) {
+                    max_purgeable = [this, old] (const dht::decorated_key& dk) {
+                        return max_purgeable_timestamp_for_flush(*old, dk);
+                    };
+                }
+                reader = make_compacting_reader(
+                    upgrade_to_v2(std::move(reader)),
+                    gc_clock::now(),
+                    std::move(max_purgeable));
+            }
+            return reader;
+        };
 
+        std::vector<flat_mutation_reader> readers;
+        readers.reserve(ranges.size());
         std::exception_ptr err;
         try {
-            mutation_fragment* fragment = co_await reader.peek();
-            if (!fragment) {
-                co_await reader.close();
-                _memtables->erase(old);
-                co_return stop_iteration::yes;
+            for (auto& range : ranges) {
+                readers.push_back(make_reader(range));
+                // Parts with nothing to write (e.g. all purged) don't get an sstable.
+                if (!co_await readers.back().peek()) {
+                    co_await readers.back().close();
+                    readers.pop_back();
+                }
             }
         } catch (...) {
             err = std::current_exception();
         }
         if (err) {
             tlogger.error("failed to flush memtable for {}.{}: {}", old->schema()->ks_name(), old->schema()->cf_name(), err);
-            co_await reader.close();
+            co_await parallel_for_each(readers, [] (flat_mutation_reader& reader) { return reader.close(); });
             co_return stop_iteration(_async_gate.is_closed());
         }
+        if (readers.empty()) {
+            _memtables->erase(old);
+            co_return stop_iteration::yes;
+        }
 
-        auto f = consumer(upgrade_to_v2(std::move(reader)));
+        std::vector<reader_consumer_v2> consumers;
+        consumers.reserve(readers.size());
+        for (size_t i = 0; i < readers.size(); ++i) {
+            consumers.push_back(make_consumer());
+        }
+        auto f = parallel_for_each(boost::irange(size_t(0), readers.size()), [&] (size_t i) {
+            return consumers[i](upgrade_to_v2(std::move(readers[i])));
+        });
 
         // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
         // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
@@ -744,6 +887,7 @@ table::stop() {
     if (_async_gate.is_closed()) {
         return make_ready_future<>();
     }
+    _cache_compression_timer.cancel();
     return _async_gate.close().then([this] {
         return await_pending_ops().finally([this] {
             return _memtables->flush().finally([this] {
@@ -777,6 +921,24 @@ void table::set_metrics() {
                 ms::make_counter("memtable_row_hits", _stats.memtable_app_stats.row_hits, ms::description("Number of rows overwritten by write operations in memtables"))(cf)(ks),
                 ms::make_counter("memtable_range_tombstone_reads", _stats.memtable_range_tombstone_reads, ms::description("Number of range tombstones read from memtables"))(cf)(ks),
                 ms::make_counter("memtable_row_tombstone_reads", _stats.memtable_row_tombstone_reads, ms::description("Number of row tombstones read from memtables"))(cf)(ks),
+                ms::make_counter("cache_partition_hits", [this] { return _cache.stats().partition_hits; }, ms::description("Number of partitions needed by reads and found in cache"))(cf)(ks),
+                ms::make_counter("cache_partition_misses", [this] { return _cache.stats().partition_misses; }, ms::description("Number of partitions needed by reads and missing in cache"))(cf)(ks),
+                ms::make_counter("cache_partition_admission_rejections", [this] { return _cache.stats().partition_admission_rejections; },
+                        ms::description("Number of partitions missing in cache which the admission filter did not let reads populate"))(cf)(ks),
+                ms::make_counter("cache_partition_compressions", [this] { return _cache.stats().partition_compressions; },
+                        ms::description("Number of cold partitions compressed in cache"))(cf)(ks),
+                ms::make_counter("cache_partition_expansions", [this] { return _cache.stats().partition_expansions; },
+                        ms::description("Number of compressed partitions in cache expanded back on access"))(cf)(ks),
+                ms::make_counter("query_disk_bytes_read", _stats.query_read_stats.disk_bytes_read,
+                        ms::description("Number of bytes read from sstables by queries of this column family"))(cf)(ks),
+                ms::make_counter("query_cache_row_hits", _stats.query_read_stats.cache_row_hits,
+                        ms::description("Number of rows read by queries of this column family and found in cache"))(cf)(ks),
+                ms::make_counter("query_cache_row_misses", _stats.query_read_stats.cache_row_misses,
+                        ms::description("Number of rows read by queries of this column family and missing in cache"))(cf)(ks),
+                ms::make_counter("query_rows_returned", _stats.query_rows_returned,
+                        ms::description("Number of rows returned by queries of this column family"))(cf)(ks),
+                ms::make_counter("query_bytes_returned", _stats.query_bytes_returned,
+                        ms::description("Number of bytes of results returned by queries of this column family"))(cf)(ks),
                 ms::make_gauge("pending_tasks", ms::description("Estimated number of tasks pending for this column family"), _stats.pending_flushes)(cf)(ks),
                 ms::make_gauge("live_disk_space", ms::description("Live disk space used"), _stats.live_disk_space_used)(cf)(ks),
                 ms::make_gauge("total_disk_space", ms::description("Total disk space used"), _stats.total_disk_space_used)(cf)(ks),
@@ -896,6 +1058,67 @@ table::update_sstable_lists_on_off_strategy_completion(const std::vector<sstable
     rebuild_statistics();
 }
 
+future<> table::prewarm_index_caches(std::vector<sstables::shared_sstable> sstables) {
+    auto max_keys = _config.compaction_index_cache_prewarm_keys();
+    for (auto& sst : sstables) {
+        try {
+            auto range = dht::partition_range::make(sst->get_first_decorated_key(), sst->get_last_decorated_key());
+            auto keys = co_await _cache.get_cached_keys(max_keys, std::move(range));
+            if (!keys.empty()) {
+                // Admitted like the other maintenance reads, so that prewarming
+                // doesn't compete with the user reads it is meant to speed up.
+                auto permit = co_await streaming_read_concurrency_semaphore().obtain_permit(_schema.get(), "prewarm_index_caches",
+                        estimate_read_memory_cost(), db::no_timeout);
+                // The lookups go through the caching index reader, the result itself is of no interest.
+                co_await sst->find_partitions(keys, std::move(permit), service::get_local_compaction_priority());
+                tlogger.debug("Prewarmed index caches of {} with {} partitions", sst->get_filename(), keys.size());
+            }
+        } catch (...) {
+            tlogger.warn("Failed to prewarm index caches of {}: {}", sst->get_filename(), std::current_exception());
+        }
+    }
+}
+
+void table::start_prewarming_index_caches(std::vector<sstables::shared_sstable> sstables) {
+    if (!_config.compaction_index_cache_prewarm_keys() || sstables.empty()) {
+        return;
+    }
+    // Run in background, under _async_gate, so that stop() waits for it.
+    (void)seastar::try_with_gate(_async_gate, [this, sstables = std::move(sstables)] () mutable {
+        return prewarm_index_caches(std::move(sstables));
+    }).handle_exception_type([] (const seastar::gate_closed_exception&) {});
+}
+
+future<> table::populate_pinned_cache(dht::partition_range range) {
+    if (!cache_pinned()) {
+        co_return;
+    }
+    auto permit = co_await streaming_read_concurrency_semaphore().obtain_permit(_schema.get(), "populate_pinned_cache", estimate_read_memory_cost(), db::no_timeout);
+    auto rd = _cache.make_reader(_schema, std::move(permit), range, _schema->full_slice(), service::get_local_streaming_priority());
+    std::exception_ptr ex;
+    try {
+        co_await rd.consume_pausable([] (mutation_fragment) {
+            return stop_iteration::no;
+        });
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await rd.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    tlogger.debug("Populated the pinned cache of {}.{} with {}", _schema->ks_name(), _schema->cf_name(), range);
+}
+
+void table::repopulate_pinned_cache(dht::partition_range range) {
+    // Run in background, under _async_gate, so that stop() waits for it.
+    (void)with_gate(_async_gate, [this, range = std::move(range)] {
+        return populate_pinned_cache(range).handle_exception([this] (std::exception_ptr ep) {
+            tlogger.warn("Populating the pinned cache of {}.{} failed: {}, reads will populate it", _schema->ks_name(), _schema->cf_name(), ep);
+        });
+    }).handle_exception_type([] (const seastar::gate_closed_exception&) {});
+}
+
 // Note: must run in a seastar thread
 void
 table::on_compaction_completion(sstables::compaction_completion_desc& desc) {
@@ -968,6 +1191,10 @@ table::on_compaction_completion(sstables::compaction_completion_desc& desc) {
 
     rebuild_statistics();
 
+    // The cached index pages of the old sstables go away with them, warm up
+    // those of the new sstables for the partitions which are read.
+    start_prewarming_index_caches(desc.new_sstables);
+
     auto f = seastar::try_with_gate(_sstable_deletion_gate, [this, sstables_to_remove = desc.old_sstables] {
        return with_semaphore(_sstable_deletion_sem, 1, [sstables_to_remove = std::move(sstables_to_remove)] {
            return sstables::delete_atomically(std::move(sstables_to_remove));
@@ -990,8 +1217,13 @@ table::compact_sstables(sstables::compaction_descriptor descriptor, sstables::co
         co_return;
     }
 
-    descriptor.creator = [this] (shard_id dummy) {
-        auto sst = make_sstable();
+    // Offload moves the data to cold storage, and the data of sstables already in
+    // cold storage stays there (compacting cold and hot sstables together writes the
+    // output to the data directory, from which the next offload moves it if it's cold).
+    bool cold_output = !_config.cold_datadir.empty() && (descriptor.options.type() == sstables::compaction_type::Offload
+            || (!descriptor.sstables.empty() && std::all_of(descriptor.sstables.begin(), descriptor.sstables.end(), std::mem_fn(&sstables::sstable::in_cold_storage))));
+    descriptor.creator = [this, cold_output] (shard_id dummy) {
+        auto sst = cold_output ? make_sstable(_config.cold_datadir) : make_sstable();
         return sst;
     };
     descriptor.replacer = [this, release_exhausted = descriptor.release_exhausted] (sstables::compaction_completion_desc desc) {
@@ -1065,6 +1297,32 @@ void table::trigger_offstrategy_compaction() {
     });
 }
 
+void table::arm_cache_compression_timer() {
+    // The period is re-read on every arming, so that changes to it take effect
+    // without a restart. While disabled, it is checked once a minute.
+    auto period = _config.cache_cold_entry_compression_period_in_s();
+    _cache_compression_timer.arm(timer<>::clock::now() + (period ? std::chrono::seconds(period) : std::chrono::seconds(60)));
+}
+
+void table::compress_cold_cache_entries() {
+    // Pinned tables are kept in memory as they are, so that their reads don't pay for expanding them.
+    if (!_config.cache_cold_entry_compression_period_in_s() || !cache_enabled() || cache_pinned()) {
+        arm_cache_compression_timer();
+        return;
+    }
+    // Run in background, under _async_gate, so that stop() waits for it.
+    (void)with_gate(_async_gate, [this] {
+        return _cache.compress_cold_entries().then_wrapped([this] (future<> f) {
+            if (f.failed()) {
+                tlogger.warn("Compressing cold cache entries of {}.{} failed: {}, ignoring", _schema->ks_name(), _schema->cf_name(), f.get_exception());
+            }
+            if (!_async_gate.is_closed()) {
+                arm_cache_compression_timer();
+            }
+        });
+    }).handle_exception_type([] (const seastar::gate_closed_exception&) {});
+}
+
 future<bool> table::perform_offstrategy_compaction() {
     // If the user calls trigger_offstrategy_compaction() to trigger
     // off-strategy explicitly, cancel the timeout based automatic trigger.
@@ -1233,6 +1491,12 @@ std::vector<sstables::shared_sstable> table::select_sstables(const dht::partitio
     return _sstables->select(range);
 }
 
+bool table::memtables_have_data_in(const dht::partition_range& range) const {
+    return std::any_of(_memtables->begin(), _memtables->end(), [&range] (const shared_memtable& mt) {
+        return mt->has_partitions_in(range);
+    });
+}
+
 std::vector<sstables::shared_sstable> table::in_strategy_sstables() const {
     auto sstables = _main_sstables->all();
     return boost::copy_range<std::vector<sstables::shared_sstable>>(*sstables
@@ -1297,9 +1561,14 @@ table::table(schema_ptr schema, config config, db::commitlog* cl, compaction_man
     , _compaction_manager(compaction_manager)
     , _index_manager(*this)
     , _counter_cell_locks(_schema->is_counter() ? std::make_unique<cell_locker>(_schema, cl_stats) : nullptr)
+    , _counter_cache(_schema->is_counter() && _config.counter_cache_size && _config.counter_cache_stats
+            ? std::make_unique<counter_cache>(_schema, _config.counter_cache_size, *_config.counter_cache_stats) : nullptr)
+    , _digest_cache(_config.digest_cache_size && _config.digest_cache_stats
+            ? std::make_unique<digest_cache>(_schema, _config.digest_cache_size, *_config.digest_cache_stats) : nullptr)
     , _table_state(std::make_unique<table_state>(*this))
     , _row_locker(_schema)
     , _off_strategy_trigger([this] { trigger_offstrategy_compaction(); })
+    , _cache_compression_timer([this] { compress_cold_cache_entries(); })
 {
     if (!_config.enable_disk_writes) {
         tlogger.warn("Writes disabled, column family no durable.");
@@ -1308,6 +1577,7 @@ table::table(schema_ptr schema, config config, db::commitlog* cl, compaction_man
     _compaction_manager.add(this);
 
     update_optimized_twcs_queries_flag();
+    arm_cache_compression_timer();
 }
 
 partition_presence_checker
@@ -1457,20 +1727,34 @@ future<> table::snapshot(database& db, sstring name, bool skip_flush) {
     auto jsondir = _config.datadir + "/snapshots/" + name;
     tlogger.debug("snapshot {}: skip_flush={}", jsondir, skip_flush);
     auto f = skip_flush ? make_ready_future<>() : flush();
-    return f.then([this, &db, jsondir = std::move(jsondir)]() {
-       return with_semaphore(_sstable_deletion_sem, 1, [this, &db, jsondir = std::move(jsondir)]() {
+    return f.then([this, &db, name, jsondir = std::move(jsondir)]() {
+       return with_semaphore(_sstable_deletion_sem, 1, [this, &db, name, jsondir = std::move(jsondir)]() {
         auto tables = boost::copy_range<std::vector<sstables::shared_sstable>>(*_sstables->all());
-        return do_with(std::move(tables), std::move(jsondir), [this, &db] (std::vector<sstables::shared_sstable>& tables, const sstring& jsondir) {
-            return io_check([&jsondir] { return recursive_touch_directory(jsondir); }).then([this, &db, &jsondir, &tables] {
-                return max_concurrent_for_each(tables, db.get_config().initial_sstable_loading_concurrency(), [&db, &jsondir] (sstables::shared_sstable sstable) {
-                  return with_semaphore(db.get_sharded_sst_dir_semaphore().local(), 1, [&jsondir, sstable] {
-                    return io_check([sstable, &dir = jsondir] {
+        // The sstables are linked into the snapshot directory of the data
+        // directory they are in, since links can't cross file systems. The
+        // manifest and schema are in that of the first data directory.
+        auto snapshot_dir = [name] (const sstables::shared_sstable& sst) {
+            return sst->get_dir() + "/snapshots/" + name;
+        };
+        std::set<sstring> dirs{jsondir};
+        for (auto& sst : tables) {
+            dirs.insert(snapshot_dir(sst));
+        }
+        return do_with(std::move(tables), std::move(jsondir), std::move(dirs), [this, &db, snapshot_dir] (std::vector<sstables::shared_sstable>& tables, const sstring& jsondir, const std::set<sstring>& dirs) {
+            return parallel_for_each(dirs, [] (const sstring& dir) {
+                return io_check([&dir] { return recursive_touch_directory(dir); });
+            }).then([this, &db, &tables, snapshot_dir] {
+                return max_concurrent_for_each(tables, db.get_config().initial_sstable_loading_concurrency(), [&db, snapshot_dir] (sstables::shared_sstable sstable) {
+                  return with_semaphore(db.get_sharded_sst_dir_semaphore().local(), 1, [sstable, dir = snapshot_dir(sstable)] {
+                    return io_check([sstable, &dir] {
                         return sstable->create_links(dir);
                     });
                   });
                 });
-            }).then([&jsondir, &tables] {
-                return io_check(sync_directory, jsondir);
+            }).then([&dirs] {
+                return parallel_for_each(dirs, [] (const sstring& dir) {
+                    return io_check(sync_directory, dir);
+                });
             }).finally([this, &tables, &db, &jsondir] {
                 auto shard = std::hash<sstring>()(jsondir) % smp::count;
                 std::unordered_set<sstring> table_names;
@@ -1541,6 +1825,17 @@ future<bool> table::snapshot_exists(sstring tag) {
     });
 }
 
+std::vector<sstring> table::snapshot_dirs(const sstring& name) const {
+    std::vector<sstring> dirs;
+    for (auto& datadir : _config.all_datadirs) {
+        dirs.push_back(format("{}/{}/{}", datadir, sstables::snapshots_dir, name));
+    }
+    if (!_config.cold_datadir.empty()) {
+        dirs.push_back(format("{}/{}/{}", _config.cold_datadir, sstables::snapshots_dir, name));
+    }
+    return dirs;
+}
+
 future<std::unordered_map<sstring, table::snapshot_details>> table::get_snapshot_details() {
     return seastar::async([this] {
         std::unordered_map<sstring, snapshot_details> all_snapshots;
@@ -1610,6 +1905,12 @@ future<> table::clear() {
         }
     }
     _memtables->clear_and_add();
+    if (_counter_cache) {
+        _counter_cache->clear();
+    }
+    if (_digest_cache) {
+        _digest_cache->clear();
+    }
     return _cache.invalidate(row_cache::external_updater([] { /* There is no underlying mutation source */ }));
 }
 
@@ -1657,8 +1958,14 @@ future<db::replay_position> table::discard_sstables(db_clock::time_point truncat
         }
     };
     auto p = make_lw_shared<pruner>(*this);
-    return _cache.invalidate(row_cache::external_updater([p, truncated_at] {
+    return _cache.invalidate(row_cache::external_updater([this, p, truncated_at] {
         p->prune(truncated_at);
+        if (_counter_cache) {
+            _counter_cache->clear();
+        }
+        if (_digest_cache) {
+            _digest_cache->clear();
+        }
         tlogger.debug("cleaning out row cache");
     })).then([this, p]() mutable {
         rebuild_statistics();
@@ -1683,10 +1990,21 @@ void table::set_schema(schema_ptr s) {
         m->set_schema(s);
     }
 
+    if (s->caching_options().pinned() != _cache.get_cache_tracker().is_pinned()) {
+        tlogger.info("Pinned caching of {}.{} was {}, it will take effect when the node restarts",
+                s->ks_name(), s->cf_name(), s->caching_options().pinned() ? "enabled" : "disabled");
+    }
     _cache.set_schema(s);
     if (_counter_cell_locks) {
         _counter_cell_locks->set_schema(s);
     }
+    if (_counter_cache) {
+        // Column ids may have changed.
+        _counter_cache->clear();
+    }
+    if (_digest_cache) {
+        _digest_cache->clear();
+    }
     _schema = std::move(s);
 
     for (auto&& v : _views) {
@@ -1950,6 +2268,47 @@ size_t table::estimate_read_memory_cost() const {
     return new_reader_base_cost;
 }
 
+// The memory needed to read a partition from a single sstable, i.e. the
+// index and data buffers, and to read a range of partitions from it.
+static constexpr size_t sstable_partition_read_cost = 8 * 1024;
+static constexpr size_t sstable_range_read_cost = 32 * 1024;
+
+static bool is_single_partition_read(const dht::partition_range_vector& ranges) {
+    return ranges.size() == 1 && ranges.front().is_singular();
+}
+
+static bool is_single_row_slice(const schema& s, const query::partition_slice& slice) {
+    const auto& rows = slice.default_row_ranges();
+    return s.clustering_key_size() == 0 || (!rows.empty() && std::all_of(rows.begin(), rows.end(), [] (const query::clustering_range& r) {
+        return r.is_singular();
+    }));
+}
+
+size_t table::estimate_read_memory_cost(const query::partition_slice& slice, const dht::partition_range_vector& ranges) const {
+    size_t cost;
+    size_t past_cost;
+    if (is_single_partition_read(ranges)) {
+        // Reading whole partitions needs more buffers than reading single rows.
+        const auto per_sstable = is_single_row_slice(*_schema, slice) ? sstable_partition_read_cost : 2 * sstable_partition_read_cost;
+        cost = new_reader_base_cost + per_sstable * _sstables->select(ranges.front()).size();
+        past_cost = _single_partition_read_cost;
+    } else {
+        cost = new_reader_base_cost + sstable_range_read_cost * _stats.live_sstable_count;
+        past_cost = _range_read_cost;
+    }
+    if (past_cost) {
+        // What reads actually consumed is the better predictor, but the sstable
+        // count changes faster than it follows.
+        cost = std::max<size_t>(new_reader_base_cost, (cost + 3 * past_cost) / 4);
+    }
+    return std::min(cost, query::result_memory_limiter::maximum_result_size);
+}
+
+void table::update_read_memory_cost(const dht::partition_range_vector& ranges, size_t consumed_memory) {
+    auto& cost = is_single_partition_read(ranges) ? _single_partition_read_cost : _range_read_cost;
+    cost = cost ? (7 * cost + consumed_memory) / 8 : consumed_memory;
+}
+
 void table::set_hit_rate(gms::inet_address addr, cache_temperature rate) {
     auto& e = _cluster_cache_hit_rates[addr];
     e.rate = rate;
@@ -2028,6 +2387,12 @@ void table::do_apply(db::rp_handle&& h, Args&&... args) {
 future<> table::apply(const mutation& m, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
     return dirty_memory_region_group().run_when_memory_available([this, &m, h = std::move(h)] () mutable {
         do_apply(std::move(h), m);
+        if (_counter_cache && counter_cache::has_tombstones(m)) [[unlikely]] {
+            _counter_cache->invalidate(m.decorated_key());
+        }
+        if (_digest_cache) {
+            _digest_cache->invalidate(m.decorated_key());
+        }
     }, timeout);
 }
 
@@ -2040,6 +2405,12 @@ future<> table::apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_hand
 
     return dirty_memory_region_group().run_when_memory_available([this, &m, m_schema = std::move(m_schema), h = std::move(h)]() mutable {
         do_apply(std::move(h), m, m_schema);
+        if (_counter_cache && counter_cache::has_tombstones(m, *m_schema)) [[unlikely]] {
+            _counter_cache->invalidate(m.decorated_key(*_schema));
+        }
+        if (_digest_cache) {
+            _digest_cache->invalidate(m.decorated_key(*_schema));
+        }
     }, timeout);
 }
 
@@ -2144,6 +2515,10 @@ table::query(schema_ptr s,
         _async_gate.leave();
     });
 
+    for (const auto& pr : partition_ranges) {
+        count_large_partition_read(pr);
+    }
+
     const auto short_read_allowed = query::short_read(cmd.slice.options.contains<query::partition_slice::option::allow_short_read>());
     auto accounter = co_await (opts.request == query::result_request::only_digest
              ? memory_limiter.new_digest_read(permit.max_result_size(), short_read_allowed)
@@ -2156,21 +2531,38 @@ table::query(schema_ptr s,
         querier_opt = std::move(*saved_querier);
     }
 
+    // A saved querier brings its own permit along, so the cost of the
+    // query is the sum of what each page added to the permit it used.
+    reader_permit::read_stats read_stats;
+    const auto start = std::chrono::steady_clock::now();
+    auto account_read = defer([&] () noexcept {
+        _stats.query_read_stats += read_stats;
+        _stats.query_rows_returned += qs.builder.row_count();
+        using stage = latency_breakdown::stage;
+        const uint64_t total_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        const auto io_us = read_stats.index_read_us + read_stats.data_read_us;
+        _stats.latencies[stage::read_sstable_index].add(read_stats.index_read_us);
+        _stats.latencies[stage::read_sstable_data].add(read_stats.data_read_us);
+        _stats.latencies[stage::read_other].add(total_us > io_us ? total_us - io_us : 0);
+    });
+
     while (!qs.done()) {
         auto&& range = *qs.current_partition_range++;
 
         if (!querier_opt) {
             querier_opt = query::data_querier(as_mutation_source(), s, permit, range, qs.cmd.slice,
-                    service::get_local_sstable_query_read_priority(), trace_state);
+                    service::get_local_sstable_query_read_priority(qs.cmd.service_level, qs.cmd.service_level_shares), trace_state);
         }
         auto& q = *querier_opt;
 
         std::exception_ptr ex;
+        const auto stats_before = q.permit().stats();
       try {
         co_await q.consume_page(query_result_builder(*s, qs.builder), qs.remaining_rows(), qs.remaining_partitions(), qs.cmd.timestamp, trace_state);
       } catch (...) {
         ex = std::current_exception();
       }
+        read_stats += q.permit().stats() - stats_before;
         if (ex || !qs.done()) {
             co_await q.close();
             querier_opt = {};
@@ -2188,7 +2580,12 @@ table::query(schema_ptr s,
         *saved_querier = std::move(querier_opt);
     }
 
-    co_return make_lw_shared<query::result>(qs.builder.build());
+    tracing::trace(trace_state, "Query read {} bytes from disk, {} rows hit and {} rows missed the cache, returning {} rows",
+            read_stats.disk_bytes_read, read_stats.cache_row_hits, read_stats.cache_row_misses, qs.builder.row_count());
+
+    auto result = make_lw_shared<query::result>(qs.builder.build());
+    _stats.query_bytes_returned += result->buf().size();
+    co_return result;
 }
 
 future<reconcilable_result>
@@ -2204,13 +2601,15 @@ table::mutation_query(schema_ptr s,
         co_return reconcilable_result();
     }
 
+    count_large_partition_read(range);
+
     std::optional<query::mutation_querier> querier_opt;
     if (saved_querier) {
         querier_opt = std::move(*saved_querier);
     }
     if (!querier_opt) {
         querier_opt = query::mutation_querier(as_mutation_source(), s, permit, range, cmd.slice,
-                service::get_local_sstable_query_read_priority(), trace_state);
+                service::get_local_sstable_query_read_priority(cmd.service_level, cmd.service_level_shares), trace_state);
     }
     auto& q = *querier_opt;
 
@@ -2256,12 +2655,21 @@ void table::add_coordinator_read_latency(utils::estimated_histogram::duration la
     _stats.estimated_coordinator_read.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
 }
 
-std::chrono::milliseconds table::get_coordinator_read_latency_percentile(double percentile) {
-    if (_cached_percentile != percentile || lowres_clock::now() - _percentile_cache_timestamp > 1s) {
+std::chrono::microseconds table::get_coordinator_read_latency_percentile(double percentile) {
+    // Refresh often and decay fast, so that speculation follows changes in
+    // latency within a fraction of a second, but keep enough samples for the
+    // high percentiles to mean something on tables with little traffic.
+    static constexpr auto refresh_period = 100ms;
+    static constexpr uint64_t min_samples_to_decay = 1000;
+
+    auto& h = _stats.estimated_coordinator_read;
+    if (_cached_percentile != percentile || lowres_clock::now() - _percentile_cache_timestamp > refresh_period) {
         _percentile_cache_timestamp = lowres_clock::now();
         _cached_percentile = percentile;
-        _percentile_cache_value = std::max(_stats.estimated_coordinator_read.percentile(percentile) / 1000, int64_t(1)) * 1ms;
-        _stats.estimated_coordinator_read *= 0.9; // decay values a little to give new data points more weight
+        _percentile_cache_value = h.count() ? std::max(h.quantile(percentile), uint64_t(1)) * 1us : std::chrono::microseconds(1ms);
+        if (h.count() > min_samples_to_decay) {
+            h *= 0.5;
+        }
     }
     return _percentile_cache_value;
 }
@@ -2372,8 +2780,31 @@ future<row_locker::lock_holder> table::push_view_replica_updates(const schema_pt
     return push_view_replica_updates(s, std::move(m), timeout, std::move(tr_state), sem);
 }
 
+bool table::may_contain_partition(const dht::decorated_key& dk) const {
+    auto pr = dht::partition_range::make_singular(dk);
+    for (auto& mt : *_memtables) {
+        if (mt->contains_partition(dk)) {
+            return true;
+        }
+    }
+    std::optional<utils::hashed_key> hk;
+    for (auto&& sst : _sstables->select(pr)) {
+        if (!sst->partition_key_in_bounds(*_schema, dk.key())) {
+            continue;
+        }
+        if (!hk) {
+            hk = sstables::sstable::make_hashed_key(*_schema, dk.key());
+        }
+        if (sst->filter_has_key(*hk)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 future<row_locker::lock_holder> table::do_push_view_replica_updates(schema_ptr s, mutation m, db::timeout_clock::time_point timeout, mutation_source source,
-        tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts) const {
+        tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts,
+        bool may_skip_read) const {
     if (!_config.view_update_concurrency_semaphore->current()) {
         // We don't have resources to generate view updates for this write. If we reached this point, we failed to
         // throttle the client. The memory queue is already full, waiting on the semaphore would cause this node to
@@ -2420,6 +2851,15 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(schema_ptr s
     future<row_locker::lock_holder> lockf = local_base_lock(base, m.decorated_key(), slice.default_row_ranges(), timeout);
     co_await utils::get_local_injector().inject("table_push_view_replica_updates_timeout", timeout);
     auto lock = co_await std::move(lockf);
+    // Under the lock, a concurrent write to the same rows is either already
+    // in a memtable or waits for us, so if the partition can't be found, there
+    // is nothing to read.
+    if (may_skip_read && _config.view_update_skip_read_for_new_partitions() && !may_contain_partition(m.decorated_key())) {
+        tracing::trace(tr_state, "Base partition doesn't exist yet, view updates do not require read-before-write");
+        ++_config.cf_stats->view_update_reads_skipped;
+        co_await generate_and_propagate_view_updates(base, sem.make_tracking_only_permit(s.get(), "push-view-updates-1", timeout), std::move(views), std::move(m), { }, std::move(tr_state), now);
+        co_return std::move(lock);
+    }
     auto pk = dht::partition_range::make_singular(m.decorated_key());
     auto permit = sem.make_tracking_only_permit(base.get(), "push-view-updates-2", timeout);
     auto reader = source.make_reader(base, permit, pk, slice, io_priority, tr_state, streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
@@ -2435,7 +2875,7 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(schema_ptr s
 future<row_locker::lock_holder> table::push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout,
         tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem) const {
     return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source(),
-            std::move(tr_state), sem, service::get_local_sstable_query_read_priority(), {});
+            std::move(tr_state), sem, service::get_local_sstable_query_read_priority(), {}, true);
 }
 
 future<row_locker::lock_holder>
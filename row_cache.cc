@@ -7,7 +7,9 @@
  */
 
 #include "row_cache.hh"
+#include <lz4.h>
 #include <seastar/core/memory.hh>
+#include <seastar/core/byteorder.hh>
 #include <seastar/core/do_with.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/metrics.hh>
@@ -20,6 +22,7 @@
 #include "dirty_memory_manager.hh"
 #include "cache_flat_mutation_reader.hh"
 #include "real_dirty_memory_accounter.hh"
+#include "frozen_mutation.hh"
 
 namespace cache {
 
@@ -61,6 +64,13 @@ cache_tracker::cache_tracker(mutation_application_stats& app_stats, register_met
         setup_metrics();
     }
 
+    // The index and file pages in the region report their memory usage, the rest is the row cache.
+    _lru.set_memory_usage_function(lru_kind::rows, [this] {
+        auto other_memory_usage = _lru.stats(lru_kind::partition_index).memory_usage + _lru.stats(lru_kind::file_pages).memory_usage;
+        uint64_t used = _region.occupancy().used_space();
+        return used - std::min(used, other_memory_usage);
+    });
+
     _region.make_evictable([this] {
         return with_allocator(_region.allocator(), [this] {
           // Removing a partition may require reading large keys when we rebalance
@@ -74,6 +84,9 @@ cache_tracker::cache_tracker(mutation_application_stats& app_stats, register_met
                 _memtable_cleaner.clear_some();
                 return memory::reclaiming_result::reclaimed_something;
             }
+            if (_pinned_memory_fraction && _region.occupancy().used_space() <= (*_pinned_memory_fraction)() * memory::stats().total_memory()) {
+                return memory::reclaiming_result::reclaimed_nothing;
+            }
             current_tracker = this;
             return _lru.evict();
            } catch (std::bad_alloc&) {
@@ -108,6 +121,8 @@ cache_tracker::setup_metrics() {
         sm::make_derive("dummy_row_hits", sm::description("total number of dummy rows touched by reads in cache"), _stats.dummy_row_hits),
         sm::make_derive("row_misses", sm::description("total number of rows needed by reads and missing in cache"), _stats.row_misses),
         sm::make_derive("row_insertions", sm::description("total number of rows added to cache"), _stats.row_insertions),
+        sm::make_derive("probationary_row_insertions", sm::description("total number of rows added to cache by range scans, which are evicted first unless read again"), _stats.probationary_row_insertions),
+        sm::make_derive("rows_over_partition_budget", sm::description("total number of rows added to cache as probationary because their partition exceeded the partition row budget"), _stats.rows_over_partition_budget),
         sm::make_derive("row_evictions", sm::description("total number of rows evicted from cache"), _stats.row_evictions),
         sm::make_derive("row_removals", sm::description("total number of invalidated rows"), _stats.row_removals),
         sm::make_derive("static_row_insertions", sm::description("total number of static rows added to cache"), _stats.static_row_insertions),
@@ -135,7 +150,36 @@ cache_tracker::setup_metrics() {
             sm::description("total amount of range tombstones processed during read")),
         sm::make_derive("row_tombstone_reads", _stats.row_tombstone_reads,
             sm::description("total amount of row tombstones processed during read")),
+        sm::make_derive("partition_admission_rejections", _stats.partition_admission_rejections,
+            sm::description("number of partitions missing in cache which were not populated, because the admission filter estimated them to be accessed less often than what they would evict")),
+        sm::make_derive("partition_compressions", _stats.partition_compressions,
+            sm::description("number of cold partitions compressed in memory")),
+        sm::make_derive("partition_expansions", _stats.partition_expansions,
+            sm::description("number of compressed partitions expanded back on access")),
+        sm::make_derive("released_snapshots", [this] { return _garbage.stats().released_snapshots + _memtable_cleaner.stats().released_snapshots; },
+            sm::description("number of partition snapshots released by reads and updates")),
+        sm::make_derive("released_snapshot_version_chain_length", [this] {
+                return _garbage.stats().released_snapshot_version_chain_length + _memtable_cleaner.stats().released_snapshot_version_chain_length; },
+            sm::description("sum of the lengths of the partition version chains snapshots were released from, divide by released_snapshots to get the average chain length")),
+        sm::make_derive("long_version_chains", [this] { return _garbage.stats().long_version_chains + _memtable_cleaner.stats().long_version_chains; },
+            sm::description("number of snapshots released from partition version chains long enough to be merged eagerly")),
+        sm::make_derive("eager_version_merges", [this] { return _garbage.stats().eager_version_merges + _memtable_cleaner.stats().eager_version_merges; },
+            sm::description("number of partition version merge steps done eagerly on long version chains, instead of in the background")),
+        sm::make_gauge("pending_snapshot_merges", [this] { return _garbage.pending_snapshots() + _memtable_cleaner.pending_snapshots(); },
+            sm::description("number of released partition snapshots whose versions wait to be merged in the background")),
     });
+
+    static const sm::label kind_label("kind");
+    for (auto [kind, name] : {std::pair(lru_kind::rows, "rows"), std::pair(lru_kind::partition_index, "partition_index"), std::pair(lru_kind::file_pages, "file_pages")}) {
+        _metrics.add_group("cache", {
+            sm::make_gauge("lru_recent_hits", [this, kind] { return _lru.stats(kind).hits; },
+                sm::description("recent hits of the elements of a kind sharing the cache memory, which is evicted from the kind with the fewest recent hits per byte"), {kind_label(name)}),
+            sm::make_gauge("lru_bytes", [this, kind] { return _lru.stats(kind).memory_usage; },
+                sm::description("memory used by the elements of a kind sharing the cache memory"), {kind_label(name)}),
+            sm::make_derive("lru_evictions", [this, kind] { return _lru.stats(kind).evictions; },
+                sm::description("number of elements of a kind sharing the cache memory evicted from it, counted only when evicting by hits per byte"), {kind_label(name)}),
+        });
+    }
 }
 
 void cache_tracker::clear() {
@@ -158,11 +202,11 @@ void cache_tracker::touch(rows_entry& e) {
     // last dummy may not be linked if evicted, but
     // the unlink_from_lru() handles it
     e.unlink_from_lru();
-    _lru.add(e);
+    _lru.add(e, lru_kind::rows);
 }
 
-void cache_tracker::insert(cache_entry& entry) {
-    insert(entry.partition());
+void cache_tracker::insert(cache_entry& entry, probationary p) {
+    insert(entry.partition(), p);
     ++_stats.partition_insertions;
     ++_stats.partitions;
     // partition_range_cursor depends on this to detect invalidation of _end
@@ -181,6 +225,7 @@ void cache_tracker::on_partition_merge() noexcept {
 
 void cache_tracker::on_partition_hit() noexcept {
     ++_stats.partition_hits;
+    _lru.on_hit(lru_kind::rows);
 }
 
 void cache_tracker::on_partition_miss() noexcept {
@@ -213,6 +258,32 @@ void cache_tracker::on_mispopulate() noexcept {
     ++_stats.mispopulations;
 }
 
+// Number of counters of the admission filter sketch, which are halved every 10 times as many accesses.
+static constexpr size_t admission_sketch_size = 1 << 18;
+
+void cache_tracker::on_partition_access(const dht::decorated_key& key) {
+    if (!_admission_sketch) {
+        _admission_sketch = std::make_unique<utils::frequency_sketch>(admission_sketch_size);
+    }
+    _admission_sketch->record(admission_hash(key));
+}
+
+void cache_tracker::on_admission_victim(const dht::decorated_key& key) noexcept {
+    _admission_victim = admission_hash(key);
+}
+
+bool cache_tracker::should_admit(const dht::decorated_key& key) noexcept {
+    // Admit everything until the cache has to evict.
+    if (!_admission_sketch || !_admission_victim) {
+        return true;
+    }
+    if (_admission_sketch->estimate(admission_hash(key)) > _admission_sketch->estimate(*_admission_victim)) {
+        return true;
+    }
+    ++_stats.partition_admission_rejections;
+    return false;
+}
+
 void cache_tracker::on_miss_already_populated() noexcept {
     ++_stats.concurrent_misses_same_key;
 }
@@ -363,22 +434,25 @@ class single_partition_populating_reader final : public flat_mutation_reader::im
         _read_context->enter_partition(_read_context->range().start()->value().as_decorated_key(), src_and_phase.snapshot, phase);
         return _read_context->create_underlying().then([this, phase] {
           return _read_context->underlying().underlying()().then([this, phase] (auto&& mfopt) {
+            bool populate = phase == _cache.phase_of(_read_context->range().start()->value());
+            if (!populate) {
+                _cache._tracker.on_mispopulate();
+            } else {
+                populate = _cache.should_admit(_read_context->key());
+            }
             if (!mfopt) {
-                if (phase == _cache.phase_of(_read_context->range().start()->value())) {
+                if (populate) {
                     _cache._read_section(_cache._tracker.region(), [this] {
                         _cache.find_or_create_missing(_read_context->key());
                     });
-                } else {
-                    _cache._tracker.on_mispopulate();
                 }
                 _end_of_stream = true;
-            } else if (phase == _cache.phase_of(_read_context->range().start()->value())) {
+            } else if (populate) {
                 _reader = _cache._read_section(_cache._tracker.region(), [&] {
                     cache_entry& e = _cache.find_or_create_incomplete(mfopt->as_partition_start(), phase);
                     return e.read(_cache, *_read_context, phase);
                 });
             } else {
-                _cache._tracker.on_mispopulate();
                 _reader = read_directly_from_underlying(*_read_context);
                 this->push_mutation_fragment(std::move(*mfopt));
             }
@@ -436,12 +510,28 @@ void cache_tracker::clear_continuity(cache_entry& ce) noexcept {
     ce.set_continuous(false);
 }
 
-void row_cache::on_partition_hit() {
+void row_cache::on_partition_hit(const dht::decorated_key& key) {
+    ++_stats.partition_hits;
     _tracker.on_partition_hit();
+    if (_schema->caching_options().admission_filter()) {
+        _tracker.on_partition_access(key);
+    }
 }
 
-void row_cache::on_partition_miss() {
+void row_cache::on_partition_miss(const dht::decorated_key& key) {
+    ++_stats.partition_misses;
     _tracker.on_partition_miss();
+    if (_schema->caching_options().admission_filter()) {
+        _tracker.on_partition_access(key);
+    }
+}
+
+bool row_cache::should_admit(const dht::decorated_key& key) {
+    if (!_schema->caching_options().admission_filter() || _tracker.should_admit(key)) {
+        return true;
+    }
+    ++_stats.partition_admission_rejections;
+    return false;
 }
 
 void row_cache::on_row_hit() {
@@ -516,23 +606,26 @@ class range_populating_reader {
                         return make_ready_future<read_result>(read_result(std::nullopt, std::nullopt));
                     });
                 }
-                _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
-                if (_reader.creation_phase() == _cache.phase_of(key)) {
+                _cache.on_partition_miss(key);
+                if (_reader.creation_phase() != _cache.phase_of(key)) {
+                    _cache._tracker.on_mispopulate();
+                } else if (_cache.should_admit(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
-                                                               this->can_set_continuity() ? &*_last_key : nullptr);
+                                                               this->can_set_continuity() ? &*_last_key : nullptr,
+                                                               cache_tracker::probationary(_read_context.is_probationary()));
                         _last_key = row_cache::previous_entry_pointer(key);
                         return make_ready_future<read_result>(
                                 read_result(e.read(_cache, _read_context, _reader.creation_phase()), std::nullopt));
                     });
-                } else {
-                    _cache._tracker.on_mispopulate();
-                    _last_key = row_cache::previous_entry_pointer(key);
-                    return make_ready_future<read_result>(
-                            read_result(read_directly_from_underlying(_read_context), std::move(mfopt)));
                 }
+                // The partition is not populated, so the continuity with the
+                // previous one is lost.
+                _last_key = row_cache::previous_entry_pointer(key);
+                return make_ready_future<read_result>(
+                        read_result(read_directly_from_underlying(_read_context), std::move(mfopt)));
             }
         });
     }
@@ -568,8 +661,9 @@ class scanning_and_populating_reader final : public flat_mutation_reader::impl {
     flat_mutation_reader_opt _reader;
 private:
     flat_mutation_reader read_from_entry(cache_entry& ce) {
+        _cache.on_entry_access(ce);
         _cache.upgrade_entry(ce);
-        _cache.on_partition_hit();
+        _cache.on_partition_hit(ce.key());
         return ce.read(_cache, *_read_context);
     }
 
@@ -743,14 +837,15 @@ row_cache::make_reader(schema_ptr s,
             auto i = _partitions.lower_bound(pos, cmp, hint);
             if (hint.match) {
                 cache_entry& e = *i;
+                on_entry_access(e);
                 upgrade_entry(e);
-                on_partition_hit();
+                on_partition_hit(e.key());
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return make_empty_flat_reader(std::move(s), std::move(permit));
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
-                on_partition_miss();
+                on_partition_miss(pos.as_decorated_key());
                 return make_flat_mutation_reader<single_partition_populating_reader>(*this, make_context());
             }
         });
@@ -827,17 +922,19 @@ cache_entry& row_cache::do_find_or_create_entry(const dht::decorated_key& key,
     });
 }
 
-cache_entry& row_cache::find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous) {
+cache_entry& row_cache::find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous,
+        cache_tracker::probationary p) {
     return do_find_or_create_entry(ps.key(), previous, [&] (auto i, const partitions_type::bound_hint& hint) { // create
         // Create an fully discontinuous, except for the partition tombstone, entry
         mutation_partition mp = mutation_partition::make_incomplete(*_schema, ps.partition_tombstone());
         partitions_type::iterator entry = _partitions.emplace_before(i, ps.key().token().raw(), hint,
                 _schema, ps.key(), std::move(mp));
-        _tracker.insert(*entry);
+        _tracker.insert(*entry, p);
         return entry;
     }, [&] (auto i) { // visit
         _tracker.on_miss_already_populated();
         cache_entry& e = *i;
+        on_entry_access(e);
         e.partition().open_version(*e.schema(), &_tracker, phase).partition().apply(ps.partition_tombstone());
         upgrade_entry(e);
     });
@@ -1020,6 +1117,7 @@ future<> row_cache::update(external_updater eu, memtable& m) {
         //        search it.
         if (cache_i != partitions_end() && hint.match) {
             cache_entry& entry = *cache_i;
+            on_entry_access(entry);
             upgrade_entry(entry);
             assert(entry._schema == _schema);
             _tracker.on_partition_merge();
@@ -1168,6 +1266,42 @@ future<> row_cache::invalidate(external_updater eu, dht::partition_range_vector&
     });
 }
 
+future<std::vector<dht::decorated_key>> row_cache::get_cached_keys(size_t max_keys, dht::partition_range range) {
+    return seastar::async([this, max_keys, range = std::move(range)] {
+        std::vector<dht::decorated_key> keys;
+        std::optional<dht::decorated_key> last;
+        auto end = dht::ring_position_view::for_range_end(range);
+        while (keys.size() < max_keys) {
+            auto done = _read_section(_tracker.region(), [&] {
+                auto cmp = dht::ring_position_comparator(*_schema);
+                auto it = last ? _partitions.upper_bound(*last, cmp)
+                               : _partitions.lower_bound(dht::ring_position_view::for_range_start(range), cmp);
+                auto in_range = [&] {
+                    return it != _partitions.end() && cmp(it->position(), end) < 0;
+                };
+                return with_allocator(standard_allocator(), [&] {
+                    while (in_range() && keys.size() < max_keys) {
+                        if (!it->is_dummy_entry()) {
+                            keys.push_back(it->key());
+                            last = it->key();
+                        }
+                        ++it;
+                        if (need_preempt() && last) {
+                            break;
+                        }
+                    }
+                    return stop_iteration(!in_range());
+                });
+            });
+            if (done == stop_iteration::yes) {
+                break;
+            }
+            seastar::thread::yield();
+        }
+        return keys;
+    });
+}
+
 void row_cache::evict() {
     while (_tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something) {}
 }
@@ -1190,6 +1324,8 @@ cache_entry::cache_entry(cache_entry&& o) noexcept
     : _schema(std::move(o._schema))
     , _key(std::move(o._key))
     , _pe(std::move(o._pe))
+    , _compressed(std::move(o._compressed))
+    , _populated_rows(o._populated_rows)
     , _flags(o._flags)
 {
 }
@@ -1242,6 +1378,9 @@ void rows_entry::on_evicted(cache_tracker& tracker) noexcept {
             partition_entry& pe = partition_entry::container_of(pv);
             if (!pe.is_locked()) {
                 cache_entry& ce = cache_entry::container_of(pe);
+                if (ce.schema()->caching_options().admission_filter()) {
+                    tracker.on_admission_victim(ce.key());
+                }
                 ce.on_evicted(tracker);
             }
         }
@@ -1302,7 +1441,8 @@ const schema_ptr& row_cache::schema() const {
 }
 
 void row_cache::upgrade_entry(cache_entry& e) {
-    if (e._schema != _schema && !e.partition().is_locked()) {
+    // Compressed entries are upgraded after they are expanded, see on_entry_access().
+    if (e._schema != _schema && !e.partition().is_locked() && !e.is_compressed()) {
         auto& r = _tracker.region();
         assert(!r.reclaiming_enabled());
         with_allocator(r.allocator(), [this, &e] {
@@ -1312,6 +1452,111 @@ void row_cache::upgrade_entry(cache_entry& e) {
     }
 }
 
+void row_cache::on_entry_access(cache_entry& e) {
+    e._flags._cold = false;
+    if (!e.is_compressed() || e.partition().is_locked()) {
+        return;
+    }
+    auto& r = _tracker.region();
+    assert(!r.reclaiming_enabled());
+    with_allocator(r.allocator(), [this, &e] {
+        auto m = with_allocator(standard_allocator(), [&] {
+            return e._compressed.with_linearized([&] (bytes_view in) {
+                auto size = read_le<uint32_t>(reinterpret_cast<const char*>(in.data()));
+                bytes_ostream out;
+                auto dst = out.write_place_holder(size);
+                auto ret = LZ4_decompress_safe(reinterpret_cast<const char*>(in.data()) + 4, reinterpret_cast<char*>(dst),
+                        in.size() - 4, size);
+                if (ret < 0 || uint32_t(ret) != size) {
+                    throw std::runtime_error(format("corrupted compressed cache entry for {}", e.key()));
+                }
+                return frozen_mutation(std::move(out)).unfreeze(e._schema);
+            });
+        });
+        auto pe = partition_entry::make_evictable(*e._schema, mutation_partition(*e._schema, m.partition()));
+        e.evict(_tracker);
+        e._pe = std::move(pe);
+        _tracker.insert(e._pe);
+        e._compressed = {};
+    });
+    ++_stats.partition_expansions;
+    ++_tracker._stats.partition_expansions;
+}
+
+bool row_cache::compress_entry(cache_entry& e) {
+    if (e.is_dummy_entry() || e.is_compressed() || e._schema != _schema || !e.is_quiescent()) {
+        return false;
+    }
+    const partition_version& v = *e._pe.version();
+    const mutation_partition& p = v.partition();
+    if (!p.is_fully_continuous()) {
+        return false;
+    }
+    auto blob = with_allocator(standard_allocator(), [&] {
+        auto fm = freeze(mutation(e._schema, e.key(), p));
+        auto in = fm.representation().linearize();
+        bytes out(bytes::initialized_later(), 4 + LZ4_compressBound(in.size()));
+        write_le<uint32_t>(reinterpret_cast<char*>(out.data()), in.size());
+        auto ret = LZ4_compress_default(reinterpret_cast<const char*>(in.data()), reinterpret_cast<char*>(out.data()) + 4,
+                in.size(), out.size() - 4);
+        if (ret == 0) {
+            throw std::runtime_error("LZ4 compression failure: LZ4_compress_default() failed");
+        }
+        out.resize(4 + ret);
+        return out;
+    });
+    // Compression must save at least half of the memory, otherwise the cost
+    // of expanding the partition back is not worth it.
+    if (blob.size() * 2 > v.size_in_allocator(*e._schema, _tracker.allocator())) {
+        return false;
+    }
+    managed_bytes compressed(blob);
+    auto pe = partition_entry::make_evictable(*e._schema, mutation_partition::make_incomplete(*e._schema, p.partition_tombstone()));
+    e.evict(_tracker);
+    e._pe = std::move(pe);
+    _tracker.insert(e._pe);
+    e._compressed = std::move(compressed);
+    ++_stats.partition_compressions;
+    ++_tracker._stats.partition_compressions;
+    return true;
+}
+
+future<> row_cache::compress_cold_entries() {
+    return seastar::async([this] {
+        std::optional<dht::decorated_key> last;
+        while (true) {
+            auto done = _update_section(_tracker.region(), [&] {
+                auto cmp = dht::ring_position_comparator(*_schema);
+                auto it = last ? _partitions.upper_bound(*last, cmp) : _partitions.begin();
+                return with_allocator(_tracker.allocator(), [&] {
+                    while (it != partitions_end()) {
+                        cache_entry& e = *it;
+                        // Like the clock algorithm, an entry is found cold when it was not
+                        // accessed since it was marked by the previous pass.
+                        if (!e._flags._cold) {
+                            e._flags._cold = true;
+                        } else {
+                            compress_entry(e);
+                        }
+                        ++it;
+                        if (need_preempt() && it != partitions_end()) {
+                            with_allocator(standard_allocator(), [&] {
+                                last = std::prev(it)->key();
+                            });
+                            break;
+                        }
+                    }
+                    return stop_iteration(it == partitions_end());
+                });
+            });
+            if (done == stop_iteration::yes) {
+                break;
+            }
+            seastar::thread::yield();
+        }
+    });
+}
+
 std::ostream& operator<<(std::ostream& out, row_cache& rc) {
     rc._read_section(rc._tracker.region(), [&] {
         out << "{row_cache: " << ::join(", ", rc._partitions.begin(), rc._partitions.end()) << "}";
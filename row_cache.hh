@@ -49,6 +49,13 @@ class cache_entry {
     schema_ptr _schema;
     dht::decorated_key _key;
     partition_entry _pe;
+    // When not empty, the contents of the partition, frozen and compressed.
+    // _pe holds only the partition tombstone then. See row_cache::compress_cold_entries().
+    managed_bytes _compressed;
+    // The number of rows reads populated into the partition since it was added
+    // to cache. Row evictions don't decrease it, so it only bounds the number of
+    // cached rows from above. See cache_tracker::set_partition_row_budget().
+    uint32_t _populated_rows = 0;
     // True when we know that there is nothing between this entry and the previous one in cache
     struct {
         bool _continuous : 1;
@@ -56,6 +63,8 @@ class cache_entry {
         bool _head : 1;
         bool _tail : 1;
         bool _train : 1;
+        // Set by row_cache::compress_cold_entries(), cleared on access.
+        bool _cold : 1;
     } _flags{};
     friend class size_calculator;
 
@@ -137,6 +146,18 @@ class cache_entry {
 
     bool is_dummy_entry() const noexcept { return _flags._dummy_entry; }
 
+    bool is_compressed() const noexcept { return !_compressed.empty(); }
+
+    uint32_t populated_rows() const noexcept { return _populated_rows; }
+    void on_row_populated() noexcept {
+        if (_populated_rows != std::numeric_limits<uint32_t>::max()) {
+            ++_populated_rows;
+        }
+    }
+
+    // True iff the partition has a single version, which no reader holds.
+    bool is_quiescent() const noexcept { return !_pe._snapshot && !_pe._version->next(); }
+
     friend std::ostream& operator<<(std::ostream&, cache_entry&);
 };
 
@@ -205,6 +226,11 @@ class row_cache final {
         utils::timed_rate_moving_average misses;
         utils::timed_rate_moving_average reads_with_misses;
         utils::timed_rate_moving_average reads_with_no_misses;
+        uint64_t partition_hits = 0;
+        uint64_t partition_misses = 0;
+        uint64_t partition_admission_rejections = 0;
+        uint64_t partition_compressions = 0;
+        uint64_t partition_expansions = 0;
     };
 private:
     cache_tracker& _tracker;
@@ -255,13 +281,23 @@ class row_cache final {
     logalloc::allocating_section _read_section;
     flat_mutation_reader create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
-    void on_partition_hit();
-    void on_partition_miss();
+    void on_partition_hit(const dht::decorated_key&);
+    void on_partition_miss(const dht::decorated_key&);
+    // Returns true iff the partition, which is missing in cache, should be populated.
+    bool should_admit(const dht::decorated_key&);
     void on_row_hit();
     void on_row_miss();
     void on_static_row_insert();
     void on_mispopulate();
     void upgrade_entry(cache_entry&);
+    // Must be called before the entry is read or updated.
+    // Marks the entry as recently accessed and expands it if it is compressed.
+    // Must be run under reclaim lock.
+    void on_entry_access(cache_entry&);
+    // Replaces the contents of the entry with their compressed form, if the entry
+    // can be compressed and compression saves enough memory. Returns true iff compressed.
+    // Must be run under reclaim lock, in the context of cache's allocator.
+    bool compress_entry(cache_entry&);
     void invalidate_locked(const dht::decorated_key&);
     void clear_now() noexcept;
 
@@ -290,7 +326,8 @@ class row_cache final {
     // The entry which is returned will have the tombstone applied to it.
     //
     // Must be run under reclaim lock
-    cache_entry& find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous = nullptr);
+    cache_entry& find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous = nullptr,
+            cache_tracker::probationary = cache_tracker::probationary::no);
 
     // Creates (or touches) a cache entry for missing partition so that sstables are not
     // poked again for it.
@@ -423,6 +460,20 @@ class row_cache final {
     future<> invalidate(external_updater, const dht::partition_range& = query::full_partition_range);
     future<> invalidate(external_updater, dht::partition_range_vector&&);
 
+    // Returns keys of up to max_keys partitions within range present in cache, in ring order.
+    // The cache is walked incrementally, so the result may not reflect a single
+    // point in time; partitions inserted or evicted in the meantime may or may not be included.
+    future<std::vector<dht::decorated_key>> get_cached_keys(size_t max_keys, dht::partition_range range = query::full_partition_range);
+
+    // Makes a pass over the cache, compressing the partitions which were not accessed
+    // since the previous pass.
+    //
+    // A compressed partition is kept in memory frozen and compressed with LZ4, which takes
+    // several times less memory than the regular representation, and is expanded back on
+    // the next access to it. Only complete partitions with a single version, which are not
+    // being read, are compressed.
+    future<> compress_cold_entries();
+
     // Evicts entries from cache.
     //
     // Note that this does not synchronize with the underlying source,
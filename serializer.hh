@@ -205,6 +205,8 @@ struct serializer;
 
 template<typename T>
 struct integral_serializer {
+    static constexpr size_t fixed_size = sizeof(T);
+
     template<typename Input>
     static T read(Input& v) {
         return deserialize_integral<T>(v);
@@ -220,6 +222,8 @@ struct integral_serializer {
 };
 
 template<> struct serializer<bool> {
+    static constexpr size_t fixed_size = 1;
+
     template <typename Input>
     static bool read(Input& i) {
         return deserialize_integral<uint8_t>(i);
@@ -37,6 +37,18 @@ void safe_serialize_as_uint32(Output& out, uint64_t data) {
     serialize(out, uint32_t(data));
 }
 
+// Serializes an object whose serialized size is known at compile time to be
+// Size, such as the final IDL classes of fixed size members: write_members
+// writes the members to a buffer on the stack, and the output gets it with a
+// single write rather than one per member.
+template<size_t Size, typename Output, typename Func>
+inline void serialize_fixed_size(Output& out, Func&& write_members) {
+    std::array<char, Size> buf;
+    seastar::simple_output_stream members_out(buf.data(), Size);
+    write_members(members_out);
+    out.write(buf.data(), Size);
+}
+
 template<typename T>
 constexpr bool can_serialize_fast() {
     return !std::is_same<T, bool>::value && std::is_integral<T>::value && (sizeof(T) == 1 || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
@@ -190,8 +202,12 @@ struct deserialize_array_helper<false, T> {
     }
     template<typename Input>
     static void skip(Input& in, size_t sz) {
-        while (sz--) {
-            serializer<T>::skip(in);
+        if constexpr (requires { serializer<T>::fixed_size; }) {
+            in.skip(sz * serializer<T>::fixed_size);
+        } else {
+            while (sz--) {
+                serializer<T>::skip(in);
+            }
         }
     }
 };
@@ -498,7 +514,9 @@ class deserialized_bytes_proxy {
 
     [[gnu::always_inline]]
     operator bytes_ostream() && {
-        bytes_ostream v;
+        // Size the stream up front, so that e.g. frozen_mutation doesn't
+        // have to linearize it again with another copy.
+        auto v = bytes_ostream::with_capacity(_stream.size());
         _stream.copy_to(v);
         return v;
     }
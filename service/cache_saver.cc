@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <limits>
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
+#include "service/cache_saver.hh"
+#include "service/priority_manager.hh"
+#include "replica/database.hh"
+#include "checked-file-impl.hh"
+#include "lister.hh"
+#include "log.hh"
+
+namespace service {
+
+static logging::logger cslogger("cache_saver");
+
+static constexpr uint32_t saved_keys_magic = 0x53435243; // "SCRC"
+static constexpr uint32_t saved_keys_version = 1;
+static constexpr std::string_view file_prefix = "RowCache-";
+static constexpr std::string_view file_suffix = ".db";
+// Number of partitions read concurrently by the prewarmer on each shard.
+static constexpr size_t prewarm_concurrency = 4;
+// Keys are saved and prewarmed in chunks of at most this many, so that a
+// large cache is never held in memory as a whole.
+static constexpr size_t keys_per_chunk = 1024;
+
+cache_saver::cache_saver(seastar::sharded<replica::database>& db, config cfg)
+        : _db(db)
+        , _cfg(std::move(cfg))
+{}
+
+sstring cache_saver::file_name(utils::UUID table_id, unsigned shard) {
+    return format("{}{}-{}{}", file_prefix, table_id, shard, file_suffix);
+}
+
+// Parses the name of a file created by file_name().
+static std::optional<std::pair<utils::UUID, unsigned>> parse_file_name(std::string_view name) {
+    if (!name.starts_with(file_prefix) || !name.ends_with(file_suffix)) {
+        return std::nullopt;
+    }
+    name.remove_prefix(file_prefix.size());
+    name.remove_suffix(file_suffix.size());
+    auto sep = name.rfind('-');
+    if (sep == std::string_view::npos) {
+        return std::nullopt;
+    }
+    try {
+        auto id = utils::UUID(sstring_view(name.data(), sep));
+        auto shard = std::stoul(std::string(name.substr(sep + 1)));
+        return std::make_pair(id, unsigned(shard));
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+static future<> write_u32(output_stream<char>& out, uint32_t v) {
+    char buf[sizeof(uint32_t)];
+    write_be<uint32_t>(buf, v);
+    return out.write(buf, sizeof(buf));
+}
+
+// The file holds the magic number and the version, followed by chunks of
+// keys, each a key count followed by that many length-prefixed keys. An
+// empty chunk ends the file.
+future<size_t> cache_saver::write_keys(sstring path, key_source next_keys) {
+    // Write to a temporary file first, so that a crash never leaves a truncated file behind.
+    auto tmp_path = path + ".tmp";
+    auto f = co_await open_checked_file_dma(general_disk_error_handler, tmp_path, open_flags::wo | open_flags::create | open_flags::truncate);
+    auto out = co_await make_file_output_stream(std::move(f));
+    size_t written = 0;
+    std::exception_ptr ex;
+    try {
+        co_await write_u32(out, saved_keys_magic);
+        co_await write_u32(out, saved_keys_version);
+        for (;;) {
+            auto keys = co_await next_keys();
+            co_await write_u32(out, keys.size());
+            if (keys.empty()) {
+                break;
+            }
+            for (auto& dk : keys) {
+                auto rep = dk.key().representation();
+                co_await write_u32(out, rep.size());
+                for (bytes_view frag : fragment_range(rep)) {
+                    co_await out.write(reinterpret_cast<const char*>(frag.data()), frag.size());
+                }
+            }
+            written += keys.size();
+        }
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_await io_check(rename_file, tmp_path, path);
+    co_return written;
+}
+
+future<> cache_saver::read_keys(sstring path, const schema& s, key_consumer consume) {
+    auto f = co_await open_checked_file_dma(general_disk_error_handler, path, open_flags::ro);
+    auto in = make_file_input_stream(std::move(f));
+    auto read_exactly = [&] (size_t n) -> future<temporary_buffer<char>> {
+        auto buf = co_await in.read_exactly(n);
+        if (buf.size() != n) {
+            throw std::runtime_error(format("Saved cache file {} is truncated", path));
+        }
+        co_return buf;
+    };
+    auto read_u32 = [&] () -> future<uint32_t> {
+        auto buf = co_await read_exactly(sizeof(uint32_t));
+        co_return read_be<uint32_t>(buf.get());
+    };
+    std::exception_ptr ex;
+    try {
+        if (co_await read_u32() != saved_keys_magic) {
+            throw std::runtime_error(format("Saved cache file {} has a bad magic number", path));
+        }
+        if (auto version = co_await read_u32(); version != saved_keys_version) {
+            throw std::runtime_error(format("Saved cache file {} has unsupported version {}", path, version));
+        }
+        while (auto count = co_await read_u32()) {
+            std::vector<dht::decorated_key> keys;
+            keys.reserve(std::min<size_t>(count, keys_per_chunk));
+            for (uint32_t i = 0; i < count; ++i) {
+                auto len = co_await read_u32();
+                auto buf = co_await read_exactly(len);
+                auto pk = partition_key::from_bytes(managed_bytes_view(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), len)));
+                keys.push_back(dht::decorate_key(s, std::move(pk)));
+                co_await coroutine::maybe_yield();
+                if (keys.size() == keys_per_chunk) {
+                    co_await consume(std::exchange(keys, {}));
+                }
+            }
+            if (!keys.empty()) {
+                co_await consume(std::move(keys));
+            }
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await in.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+future<> cache_saver::save() {
+    auto max_keys = _cfg.keys_to_save ? size_t(_cfg.keys_to_save) : std::numeric_limits<size_t>::max();
+    std::vector<lw_shared_ptr<replica::table>> tables;
+    for (auto& [id, t] : _db.local().get_column_families()) {
+        if (!replica::is_internal_keyspace(t->schema()->ks_name())) {
+            tables.push_back(t);
+        }
+    }
+    size_t saved = 0;
+    for (auto& t : tables) {
+        if (_as.abort_requested()) {
+            break;
+        }
+        auto path = _cfg.directory + "/" + file_name(t->schema()->id(), this_shard_id());
+        auto remaining = max_keys;
+        auto range = query::full_partition_range;
+        auto written = co_await write_keys(path, [&] () -> future<std::vector<dht::decorated_key>> {
+            if (!remaining || _as.abort_requested()) {
+                co_return std::vector<dht::decorated_key>();
+            }
+            auto keys = co_await t->get_row_cache().get_cached_keys(std::min(remaining, keys_per_chunk), range);
+            remaining -= keys.size();
+            if (!keys.empty()) {
+                range = dht::partition_range::make_starting_with({keys.back(), false});
+            }
+            co_return keys;
+        });
+        if (!written) {
+            co_await io_check(remove_file, path);
+        }
+        saved += written;
+    }
+    co_await io_check(sync_directory, _cfg.directory);
+    if (this_shard_id() == 0) {
+        co_await remove_stale_files();
+    }
+    cslogger.debug("Saved {} row cache keys from {} tables", saved, tables.size());
+}
+
+// Removes files of tables which no longer exist and of shards which are no longer there.
+future<> cache_saver::remove_stale_files() {
+    auto& tables = _db.local().get_column_families();
+    co_await lister::scan_dir(fs::path(_cfg.directory), { directory_entry_type::regular }, [&] (fs::path dir, directory_entry de) -> future<> {
+        auto parsed = parse_file_name(de.name);
+        if (parsed && (parsed->second >= smp::count || !tables.contains(parsed->first))) {
+            co_await io_check(remove_file, (dir / de.name.c_str()).native());
+        }
+    });
+}
+
+future<> cache_saver::prewarm_table(replica::table& t, std::vector<dht::decorated_key> keys) {
+    auto s = t.schema();
+    co_await max_concurrent_for_each(keys, prewarm_concurrency, [&] (const dht::decorated_key& dk) -> future<> {
+        if (_as.abort_requested()) {
+            co_return;
+        }
+        auto permit = co_await t.streaming_read_concurrency_semaphore().obtain_permit(s.get(), "cache_prewarm", t.estimate_read_memory_cost(), db::no_timeout);
+        auto pr = dht::partition_range::make_singular(dk);
+        auto rd = t.make_reader(s, std::move(permit), pr, s->full_slice(), service::get_local_streaming_priority());
+        std::exception_ptr ex;
+        try {
+            co_await rd.consume_pausable([] (mutation_fragment) {
+                return stop_iteration::no;
+            });
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await rd.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    });
+}
+
+future<> cache_saver::prewarm() {
+    if (!co_await file_exists(_cfg.directory)) {
+        co_return;
+    }
+    std::vector<std::pair<utils::UUID, sstring>> files;
+    co_await lister::scan_dir(fs::path(_cfg.directory), { directory_entry_type::regular }, [&] (fs::path dir, directory_entry de) {
+        if (auto parsed = parse_file_name(de.name)) {
+            files.emplace_back(parsed->first, (dir / de.name.c_str()).native());
+        }
+        return make_ready_future<>();
+    });
+    size_t loaded = 0;
+    for (auto& [id, path] : files) {
+        if (_as.abort_requested()) {
+            break;
+        }
+        auto& tables = _db.local().get_column_families();
+        auto it = tables.find(id);
+        if (it == tables.end()) {
+            continue;
+        }
+        auto t = it->second;
+        try {
+            co_await read_keys(path, *t->schema(), [&] (std::vector<dht::decorated_key> keys) -> future<> {
+                std::erase_if(keys, [&] (const dht::decorated_key& dk) {
+                    return dht::shard_of(*t->schema(), dk.token()) != this_shard_id();
+                });
+                loaded += keys.size();
+                co_await prewarm_table(*t, std::move(keys));
+            });
+        } catch (...) {
+            cslogger.warn("Failed to prewarm the cache of {}.{} from {}: {}", t->schema()->ks_name(), t->schema()->cf_name(), path, std::current_exception());
+        }
+    }
+    cslogger.info("Prewarmed the row cache with {} partitions", loaded);
+}
+
+void cache_saver::start() {
+    _done = with_scheduling_group(_cfg.sched_group, [this] () -> future<> {
+        try {
+            co_await prewarm();
+        } catch (...) {
+            cslogger.warn("Failed to prewarm the cache: {}", std::current_exception());
+        }
+        if (_cfg.save_period.count() == 0) {
+            co_return;
+        }
+        try {
+            co_await io_check(recursive_touch_directory, _cfg.directory);
+        } catch (...) {
+            cslogger.warn("Failed to create {}, row cache keys will not be saved: {}", _cfg.directory, std::current_exception());
+            co_return;
+        }
+        while (!_as.abort_requested()) {
+            try {
+                co_await sleep_abortable(_cfg.save_period, _as);
+            } catch (const sleep_aborted&) {
+                break;
+            }
+            try {
+                co_await save();
+            } catch (...) {
+                cslogger.warn("Failed to save the row cache keys: {}", std::current_exception());
+            }
+        }
+    });
+}
+
+future<> cache_saver::stop() {
+    _as.request_abort();
+    return std::move(_done);
+}
+
+}
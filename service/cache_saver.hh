@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "dht/i_partitioner.hh"
+#include "replica/database_fwd.hh"
+#include "schema_fwd.hh"
+#include "utils/UUID.hh"
+
+namespace service {
+
+// Saves keys of partitions present in the row cache to saved_caches_directory
+// and reads them back after a restart, so that a node doesn't have to serve
+// all reads from disk until the cache warms up again.
+//
+// Each shard periodically writes one file per table, holding the partition
+// keys cached on that shard. On startup every shard goes over the files of
+// all shards (the shard count may have changed) and reads the partitions it
+// owns through the regular read path, which populates the row cache as well
+// as the sstable index caches. Prewarming runs in the background, under the
+// given (low priority) scheduling group and the streaming read semaphore.
+class cache_saver : public seastar::peering_sharded_service<cache_saver> {
+public:
+    struct config {
+        seastar::sstring directory;
+        // 0 disables saving.
+        std::chrono::seconds save_period;
+        // Maximum number of keys to save per table and shard, 0 for all.
+        uint32_t keys_to_save;
+        seastar::scheduling_group sched_group;
+    };
+private:
+    seastar::sharded<replica::database>& _db;
+    config _cfg;
+    seastar::abort_source _as;
+    seastar::future<> _done = seastar::make_ready_future<>();
+private:
+    seastar::future<> prewarm_table(replica::table& t, std::vector<dht::decorated_key> keys);
+    seastar::future<> remove_stale_files();
+public:
+    cache_saver(seastar::sharded<replica::database>& db, config cfg);
+
+    // Starts prewarming the cache from saved keys on this shard, followed
+    // by periodic saving, in the background.
+    void start();
+
+    seastar::future<> stop();
+
+    // Saves the keys cached on this shard.
+    seastar::future<> save();
+
+    // Reads partitions saved by any shard which are owned by this shard.
+    seastar::future<> prewarm();
+
+    static seastar::sstring file_name(utils::UUID table_id, unsigned shard);
+
+    // Returns the next keys to write, an empty vector when there are no more.
+    using key_source = seastar::noncopyable_function<seastar::future<std::vector<dht::decorated_key>> ()>;
+    using key_consumer = seastar::noncopyable_function<seastar::future<> (std::vector<dht::decorated_key>)>;
+
+    // Writes the keys returned by next_keys, until it returns none.
+    // Returns the number of keys written.
+    static seastar::future<size_t> write_keys(seastar::sstring path, key_source next_keys);
+    // Passes the keys in the file to consume, in chunks.
+    // Throws std::runtime_error if the file is malformed.
+    static seastar::future<> read_keys(seastar::sstring path, const schema& s, key_consumer consume);
+};
+
+}
@@ -246,10 +246,11 @@ future<> service::client_state::maybe_update_per_service_level_params() {
     if (_sl_controller && _user && _user->name) {
         auto& role_manager = _auth_service->underlying_role_manager();
         auto role_set = co_await role_manager.query_granted(_user->name.value(), auth::recursive_role_query::yes);
-        auto slo_opt = co_await _sl_controller->find_service_level(role_set);
-        if (!slo_opt) {
+        auto sl_opt = co_await _sl_controller->find_effective_service_level(role_set);
+        if (!sl_opt) {
             co_return;
         }
+        auto& slo = sl_opt->slo;
         auto slo_timeout_or = [&] (const lowres_clock::duration& default_timeout) {
             return std::visit(overloaded_functor{
                 [&] (const qos::service_level_options::unset_marker&) -> lowres_clock::duration {
@@ -261,7 +262,7 @@ future<> service::client_state::maybe_update_per_service_level_params() {
                 [&] (const lowres_clock::duration& d) -> lowres_clock::duration {
                     return d;
                 },
-            }, slo_opt->timeout);
+            }, slo.timeout);
         };
         _timeout_config.read_timeout = slo_timeout_or(_default_timeout_config.read_timeout);
         _timeout_config.write_timeout = slo_timeout_or(_default_timeout_config.write_timeout);
@@ -271,6 +272,8 @@ future<> service::client_state::maybe_update_per_service_level_params() {
         _timeout_config.cas_timeout = slo_timeout_or(_default_timeout_config.cas_timeout);
         _timeout_config.other_timeout = slo_timeout_or(_default_timeout_config.other_timeout);
 
-        _workload_type = slo_opt->workload;
+        _workload_type = slo.workload;
+        _service_level_name = std::move(sl_opt->name);
+        _service_level_options = std::move(sl_opt->slo);
     }
 }
@@ -129,6 +129,10 @@ class client_state {
 
     workload_type _workload_type = workload_type::unspecified;
 
+    // The effective service level of the user, see qos::effective_service_level.
+    sstring _service_level_name;
+    qos::service_level_options _service_level_options;
+
 public:
     struct internal_tag {};
     struct external_tag {};
@@ -137,6 +141,15 @@ class client_state {
         return _workload_type;
     }
 
+    // Empty for users without a service level.
+    const sstring& get_service_level_name() const noexcept {
+        return _service_level_name;
+    }
+
+    const qos::service_level_options& get_service_level_options() const noexcept {
+        return _service_level_options;
+    }
+
     auth_state get_auth_state() const noexcept {
         return _auth_state;
     }
@@ -34,6 +34,8 @@
 
 #include "cql3/column_identifier.hh"
 #include "cql3/cql_config.hh"
+#include "cql3/functions/aggregate_function.hh"
+#include "cql3/functions/functions.hh"
 #include "cql3/query_options.hh"
 #include "cql3/result_set.hh"
 #include "cql3/selection/raw_selector.hh"
@@ -141,53 +143,143 @@ future<> forward_service::stop() {
     return uninit_messaging_service();
 }
 
+static const query::forward_request::aggregation_info& get_aggregation_info(const query::forward_request& req, size_t i) {
+    if (!req.aggregation_infos || req.aggregation_infos->size() != req.reduction_types.size()) {
+        throw std::runtime_error("forward_request with aggregates lacks their aggregation_infos");
+    }
+    return (*req.aggregation_infos)[i];
+}
+
+// Returns the native aggregate function described by an aggregation_info.
+static shared_ptr<cql3::functions::aggregate_function> get_aggregate_function(
+    const schema& schema,
+    const query::forward_request::aggregation_info& info
+) {
+    std::vector<data_type> arg_types;
+    for (auto& name : info.column_names) {
+        auto* def = schema.get_column_definition(to_bytes(name));
+        if (!def) {
+            throw std::runtime_error(format("unknown column {} in forward_request aggregation", name));
+        }
+        arg_types.push_back(def->type);
+    }
+    auto fn = dynamic_pointer_cast<cql3::functions::aggregate_function>(
+            cql3::functions::functions::find(cql3::functions::function_name::native_function(info.function_name), arg_types));
+    if (!fn) {
+        throw std::runtime_error(format("unknown aggregate function {} in forward_request", info.function_name));
+    }
+    return fn;
+}
+
 // Due to `cql3::selection::selection` not being serializable, it cannot be
 // stored in `forward_request`. It has to mocked on the receiving node,
 // based on requested reduction types.
 static shared_ptr<cql3::selection::selection> mock_selection(
-    const std::vector<query::forward_request::reduction_type>& reduction_types,
+    const query::forward_request& req,
     schema_ptr schema,
     replica::database& db
 ) {
     std::vector<shared_ptr<cql3::selection::raw_selector>> raw_selectors;
 
-    auto mock_singular_selection = [&] (const query::forward_request::reduction_type& type) {
-        switch (type) {
+    auto mock_singular_selection = [&] (size_t i) {
+        switch (req.reduction_types[i]) {
             case query::forward_request::reduction_type::count: {
                 auto selectable = cql3::selection::make_count_rows_function_expression();
                 auto column_identifier = make_shared<cql3::column_identifier>("count", false);
                 return make_shared<cql3::selection::raw_selector>(selectable, column_identifier);
             }
+            case query::forward_request::reduction_type::aggregate: {
+                auto& info = get_aggregation_info(req, i);
+                std::vector<cql3::expr::expression> args;
+                for (auto& name : info.column_names) {
+                    args.push_back(cql3::expr::unresolved_identifier{::make_shared<cql3::column_identifier::raw>(name, true)});
+                }
+                auto selectable = cql3::expr::function_call{
+                        cql3::functions::function_name::native_function(info.function_name), std::move(args)};
+                auto column_identifier = make_shared<cql3::column_identifier>(info.function_name, false);
+                return make_shared<cql3::selection::raw_selector>(selectable, column_identifier);
+            }
         }
+        throw std::runtime_error("unknown reduction type");
     };
 
-    for (auto const& type : reduction_types) {
-        raw_selectors.emplace_back(mock_singular_selection(type));
+    for (size_t i = 0; i < req.reduction_types.size(); ++i) {
+        raw_selectors.emplace_back(mock_singular_selection(i));
     }
 
     return cql3::selection::selection::from_selectors(db.as_data_dictionary(), schema, std::move(raw_selectors));
 }
 
+// Merges partial results of a forward_request.
+//
+// The supported aggregates can be computed from their partial results
+// by another aggregate: the count of all rows is the sum of partial counts,
+// and the min, max and sum of all rows are respectively the min, max and sum
+// of partial results.
+class forward_aggregates {
+    std::vector<shared_ptr<cql3::functions::aggregate_function>> _reducers;
+public:
+    forward_aggregates(const schema& schema, const query::forward_request& req) {
+        static const auto sum = cql3::functions::function_name::native_function("sum");
+        _reducers.reserve(req.reduction_types.size());
+        for (size_t i = 0; i < req.reduction_types.size(); ++i) {
+            shared_ptr<cql3::functions::function> reducer;
+            switch (req.reduction_types[i]) {
+                case query::forward_request::reduction_type::count:
+                    reducer = cql3::functions::functions::find(sum, {long_type});
+                    break;
+                case query::forward_request::reduction_type::aggregate: {
+                    auto& info = get_aggregation_info(req, i);
+                    auto fn = get_aggregate_function(schema, info);
+                    reducer = info.function_name == "count"
+                            ? cql3::functions::functions::find(sum, {long_type})
+                            : cql3::functions::functions::find(fn->name(), {fn->return_type()});
+                    break;
+                }
+            }
+            _reducers.push_back(dynamic_pointer_cast<cql3::functions::aggregate_function>(reducer));
+            if (!_reducers.back()) {
+                throw std::runtime_error("cannot merge results of forward_request");
+            }
+        }
+    }
+
+    void merge(query::forward_result& result, const query::forward_result& other) const {
+        if (result.query_results.empty()) {
+            result = other;
+            return;
+        }
+        if (result.query_results.size() != _reducers.size() || other.query_results.size() != _reducers.size()) {
+            throw std::runtime_error("forward_result column count does not match requested column count");
+        }
+        auto sf = cql_serialization_format::internal();
+        for (size_t i = 0; i < _reducers.size(); ++i) {
+            auto agg = _reducers[i]->new_aggregate();
+            agg->add_input(sf, {result.query_results[i]});
+            agg->add_input(sf, {other.query_results[i]});
+            result.query_results[i] = agg->compute(sf);
+        }
+    }
+};
+
 future<query::forward_result> forward_service::dispatch_to_shards(
     query::forward_request req,
     std::optional<tracing::trace_info> tr_info
 ) {
     _stats.requests_dispatched_to_own_shards += 1;
 
-    auto result = co_await container().map_reduce0(
+    schema_ptr schema = local_schema_registry().get(req.cmd.schema_version);
+    forward_aggregates aggregates(*schema, req);
+    co_return co_await container().map_reduce0(
         [req, tr_info] (auto& fs) {
             return fs.execute_on_this_shard(req, tr_info);
         },
-        std::optional<query::forward_result>(),
-        [&req] (std::optional<query::forward_result> partial, query::forward_result mapped) -> std::optional<query::forward_result>{
-            if (partial) {
-                mapped.merge(*partial, req.reduction_types);
-            }
-            return {mapped};
+        query::forward_result(),
+        [&aggregates] (query::forward_result partial, query::forward_result mapped) {
+            aggregates.merge(partial, mapped);
+            return partial;
         }
     );
-
-    co_return *result;
 }
 
 // This function executes forward_request on a shard.
@@ -208,11 +300,11 @@ future<query::forward_result> forward_service::execute_on_this_shard(
 
     schema_ptr schema = local_schema_registry().get(req.cmd.schema_version);
 
+    auto selection = mock_selection(req, schema, _db.local());
     auto reduction_types = std::move(req.reduction_types);
     auto timeout = req.timeout;
     auto now = gc_clock::now();
 
-    auto selection = mock_selection(reduction_types, schema, _db.local());
     auto query_state = make_lw_shared<service::query_state>(
         client_state::for_internal_calls(),
         tr_state,
@@ -319,10 +411,11 @@ future<query::forward_result> forward_service::dispatch(query::forward_request r
     tracing::trace(tr_state, "Dispatching forward_request to {} endpoints", vnodes_per_addr.size());
 
     std::optional<tracing::trace_info> tr_info = tracing::make_trace_info(tr_state);
-    std::optional<query::forward_result> result;
+    forward_aggregates aggregates(*schema, req);
+    query::forward_result result;
     // Forward request to each endpoint and merge results.
     co_await parallel_for_each(vnodes_per_addr.begin(), vnodes_per_addr.end(),
-        [this, &req, &result, &tr_state, &tr_info] (auto vnodes_with_addr) -> future<> {
+        [this, &req, &result, &aggregates, &tr_state, &tr_info] (auto vnodes_with_addr) -> future<> {
             auto& addr = vnodes_with_addr.first;
             auto& partition_range = vnodes_with_addr.second;
             auto req_with_modified_pr = req;
@@ -350,22 +443,18 @@ future<query::forward_result> forward_service::dispatch(query::forward_request r
             tracing::trace(tr_state, "Received forward_result={} from {}", partial_result_printer, addr);
             flogger.debug("received forward_result={} from {}", partial_result_printer, addr);
 
-            if (result) {
-                result->merge(partial_result, req.reduction_types);
-            } else {
-                result = partial_result;
-            }
+            aggregates.merge(result, partial_result);
         }
     );
 
     query::forward_result::printer result_printer{
         .types = req.reduction_types,
-        .res = *result
+        .res = result
     };
     tracing::trace(tr_state, "Merged result is {}", result_printer);
     flogger.debug("merged result is {}", result_printer);
 
-    co_return *result;
+    co_return result;
 }
 
 void forward_service::register_metrics() {
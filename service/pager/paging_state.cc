@@ -37,7 +37,8 @@ service::pager::paging_state::paging_state(partition_key pk,
         std::optional<db::read_repair_decision> query_read_repair_decision,
         uint32_t rows_fetched_for_last_partition_low_bits,
         uint32_t rem_high_bits,
-        uint32_t rows_fetched_for_last_partition_high_bits)
+        uint32_t rows_fetched_for_last_partition_high_bits,
+        uint32_t range_read_concurrency)
     : _partition_key(std::move(pk))
     , _clustering_key(std::move(ck))
     , _remaining_low_bits(rem_low_bits)
@@ -46,7 +47,8 @@ service::pager::paging_state::paging_state(partition_key pk,
     , _query_read_repair_decision(query_read_repair_decision)
     , _rows_fetched_for_last_partition_low_bits(rows_fetched_for_last_partition_low_bits)
     , _remaining_high_bits(rem_high_bits)
-    , _rows_fetched_for_last_partition_high_bits(rows_fetched_for_last_partition_high_bits) {
+    , _rows_fetched_for_last_partition_high_bits(rows_fetched_for_last_partition_high_bits)
+    , _range_read_concurrency(range_read_concurrency) {
 }
 
 service::pager::paging_state::paging_state(partition_key pk,
@@ -55,10 +57,11 @@ service::pager::paging_state::paging_state(partition_key pk,
         utils::UUID query_uuid,
         replicas_per_token_range last_replicas,
         std::optional<db::read_repair_decision> query_read_repair_decision,
-        uint64_t rows_fetched_for_last_partition)
+        uint64_t rows_fetched_for_last_partition,
+        uint32_t range_read_concurrency)
     : paging_state(std::move(pk), std::move(ck), static_cast<uint32_t>(rem), query_uuid, std::move(last_replicas), query_read_repair_decision,
             static_cast<uint32_t>(rows_fetched_for_last_partition), static_cast<uint32_t>(rem >> 32),
-            static_cast<uint32_t>(rows_fetched_for_last_partition >> 32)) {
+            static_cast<uint32_t>(rows_fetched_for_last_partition >> 32), range_read_concurrency) {
 }
 
 lw_shared_ptr<service::pager::paging_state> service::pager::paging_state::deserialize(
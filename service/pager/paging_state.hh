@@ -39,6 +39,7 @@ class paging_state final {
     uint32_t _rows_fetched_for_last_partition_low_bits;
     uint32_t _remaining_high_bits;
     uint32_t _rows_fetched_for_last_partition_high_bits;
+    uint32_t _range_read_concurrency;
 
 public:
     paging_state(partition_key pk,
@@ -49,7 +50,8 @@ class paging_state final {
             std::optional<db::read_repair_decision> query_read_repair_decision,
             uint32_t rows_fetched_for_last_partition,
             uint32_t remaining_ext,
-            uint32_t rows_fetched_for_last_partition_high_bits);
+            uint32_t rows_fetched_for_last_partition_high_bits,
+            uint32_t range_read_concurrency = 0);
 
     paging_state(partition_key pk,
             std::optional<clustering_key> ck,
@@ -57,7 +59,8 @@ class paging_state final {
             utils::UUID reader_recall_uuid,
             replicas_per_token_range last_replicas,
             std::optional<db::read_repair_decision> query_read_repair_decision,
-            uint64_t rows_fetched_for_last_partition);
+            uint64_t rows_fetched_for_last_partition,
+            uint32_t range_read_concurrency = 0);
 
     void set_partition_key(partition_key pk) {
         _partition_key = std::move(pk);
@@ -156,6 +159,19 @@ class paging_state final {
         return _query_read_repair_decision;
     }
 
+    /**
+     * The number of vnode ranges a range scan should read concurrently
+     * on the next page.
+     *
+     * Lets a scan continue with the concurrency it ramped up to on the
+     * previous pages, instead of starting with a single range on each page.
+     * 0 means the coordinator should start from scratch, like it always did
+     * with paging states created by older coordinators.
+     */
+    uint32_t get_range_read_concurrency() const {
+        return _range_read_concurrency;
+    }
+
     static lw_shared_ptr<paging_state> deserialize(bytes_opt bytes);
     bytes_opt serialize() const;
 };
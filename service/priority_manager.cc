@@ -6,6 +6,7 @@
  */
 #include "priority_manager.hh"
 #include <seastar/core/reactor.hh>
+#include <seastar/core/print.hh>
 
 namespace service {
 priority_manager& get_local_priority_manager() {
@@ -17,8 +18,36 @@ priority_manager::priority_manager()
     : _commitlog_priority(::io_priority_class::register_one("commitlog", 1000))
     , _mt_flush_priority(::io_priority_class::register_one("memtable_flush", 1000))
     , _streaming_priority(::io_priority_class::register_one("streaming", 200))
-    , _sstable_query_read(::io_priority_class::register_one("query", 1000))
+    , _sstable_query_read(::io_priority_class::register_one("query", query_shares))
     , _compaction_priority(::io_priority_class::register_one("compaction", 1000))
+    , _reader_spill_priority(::io_priority_class::register_one("reader_spill", 200))
 {}
 
+const ::io_priority_class&
+priority_manager::sstable_query_read_priority(const sstring& service_level, int32_t shares) {
+    if (service_level.empty()) {
+        return _sstable_query_read;
+    }
+    if (shares <= 0) {
+        shares = query_shares;
+    }
+    auto it = _service_level_priorities.find(service_level);
+    if (it == _service_level_priorities.end()) {
+        if (_service_level_priorities.size() >= max_service_level_priorities) {
+            return _sstable_query_read;
+        }
+        // Registered with fixed shares, so that all shards register the same
+        // class, and then set to the service level's shares on each shard.
+        auto pc = ::io_priority_class::register_one(format("sl:{}", service_level), query_shares);
+        it = _service_level_priorities.emplace(service_level, service_level_priority{std::move(pc), query_shares}).first;
+    }
+    auto& slp = it->second;
+    // A change during an update is applied by a later read.
+    if (slp.shares != shares && slp.update.available()) {
+        slp.shares = shares;
+        slp.update = slp.pc.update_shares(uint32_t(shares)).handle_exception([] (std::exception_ptr) {});
+    }
+    return slp.pc;
+}
+
 }
@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/sstring.hh>
 
 #include "seastarx.hh"
 
@@ -18,6 +21,21 @@ class priority_manager {
     ::io_priority_class _streaming_priority;
     ::io_priority_class _sstable_query_read;
     ::io_priority_class _compaction_priority;
+    ::io_priority_class _reader_spill_priority;
+
+    // User reads of each service level get an I/O class of their own, so
+    // that the disk is shared between service levels in proportion to their
+    // shares, like the CPU is. Classes can't be unregistered, so at most
+    // max_service_level_priorities are created, and the reads of further
+    // service levels share the query class.
+    static constexpr size_t max_service_level_priorities = 16;
+    static constexpr int32_t query_shares = 1000;
+    struct service_level_priority {
+        ::io_priority_class pc;
+        int32_t shares;
+        future<> update = make_ready_future<>();
+    };
+    std::unordered_map<sstring, service_level_priority> _service_level_priorities;
 
 public:
     const ::io_priority_class&
@@ -40,11 +58,22 @@ class priority_manager {
         return _sstable_query_read;
     }
 
+    // The class of user reads of the service level, with the given shares.
+    // Reads without a service level use sstable_query_read_priority().
+    const ::io_priority_class&
+    sstable_query_read_priority(const sstring& service_level, int32_t shares);
+
     const ::io_priority_class&
     compaction_priority() const {
         return _compaction_priority;
     }
 
+    // Reads writing state which doesn't fit in memory to disk, see utils::spill_file.
+    const ::io_priority_class&
+    reader_spill_priority() const {
+        return _reader_spill_priority;
+    }
+
     priority_manager();
 };
 
@@ -69,8 +98,18 @@ get_local_sstable_query_read_priority() {
     return get_local_priority_manager().sstable_query_read_priority();
 }
 
+const inline ::io_priority_class&
+get_local_sstable_query_read_priority(const sstring& service_level, int32_t shares) {
+    return get_local_priority_manager().sstable_query_read_priority(service_level, shares);
+}
+
 const inline ::io_priority_class&
 get_local_compaction_priority() {
     return get_local_priority_manager().compaction_priority();
 }
+
+const inline ::io_priority_class&
+get_local_reader_spill_priority() {
+    return get_local_priority_manager().reader_spill_priority();
+}
 }
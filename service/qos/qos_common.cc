@@ -11,6 +11,29 @@
 
 namespace qos {
 
+template <typename T>
+static void replace_default(std::variant<service_level_options::unset_marker, service_level_options::delete_marker, T>& value,
+        const std::variant<service_level_options::unset_marker, service_level_options::delete_marker, T>& default_value) {
+    if (std::holds_alternative<service_level_options::unset_marker>(value)) {
+        value = default_value;
+    } else if (std::holds_alternative<service_level_options::delete_marker>(value)) {
+        value = service_level_options::unset_marker{};
+    }
+}
+
+// The most restrictive of two values, where unset means unlimited.
+template <typename T>
+static void merge_min(std::variant<service_level_options::unset_marker, service_level_options::delete_marker, T>& value,
+        const std::variant<service_level_options::unset_marker, service_level_options::delete_marker, T>& other) {
+    auto* v = std::get_if<T>(&value);
+    auto* o = std::get_if<T>(&other);
+    if (!v) {
+        value = other;
+    } else if (o) {
+        value = std::min(*v, *o);
+    }
+}
+
 service_level_options service_level_options::replace_defaults(const service_level_options& default_values) const {
     service_level_options ret = *this;
     std::visit(overloaded_functor {
@@ -37,6 +60,8 @@ service_level_options service_level_options::replace_defaults(const service_leve
         // no-op
         break;
     }
+    replace_default(ret.max_requests_per_second, default_values.max_requests_per_second);
+    replace_default(ret.shares, default_values.shares);
     return ret;
 }
 
@@ -61,6 +86,8 @@ service_level_options service_level_options::merge_with(const service_level_opti
     } else {
         ret.workload = std::min(ret.workload, other.workload);
     }
+    merge_min(ret.max_requests_per_second, other.max_requests_per_second);
+    merge_min(ret.shares, other.shares);
     return ret;
 }
 
@@ -40,6 +40,18 @@ struct service_level_options {
     timeout_type timeout = unset_marker{};
     workload_type workload = workload_type::unspecified;
 
+    // Requests per second, per node, which the users of the service level
+    // may issue together.
+    using rate_limit_type = std::variant<unset_marker, delete_marker, uint64_t>;
+    rate_limit_type max_requests_per_second = unset_marker{};
+
+    // Relative weight of the service level in admitting requests when the
+    // node is saturated, see request_admission_controller.
+    static constexpr int32_t min_shares = 1;
+    static constexpr int32_t max_shares = 1000;
+    using shares_type = std::variant<unset_marker, delete_marker, int32_t>;
+    shares_type shares = unset_marker{};
+
     service_level_options replace_defaults(const service_level_options& other) const;
     // Merges the values of two service level options. The semantics depends
     // on the type of the parameter - e.g. for timeouts, a min value is preferred.
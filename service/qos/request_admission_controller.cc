@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/smp.hh>
+#include "request_admission_controller.hh"
+#include "exceptions/exceptions.hh"
+
+namespace qos {
+
+request_admission_controller::request_admission_controller(utils::updateable_value<uint32_t> max_concurrent_requests)
+    : _max_concurrent_requests(std::move(max_concurrent_requests))
+{}
+
+request_admission_controller::tenant& request_admission_controller::get_tenant(const sstring& tenant_name, const service_level_options& slo) {
+    auto& t = _tenants[tenant_name];
+    // The options may change when the service level is altered and clients
+    // log in again, the last one seen wins.
+    auto* max_rps = std::get_if<uint64_t>(&slo.max_requests_per_second);
+    auto max_requests_per_second = max_rps ? *max_rps : 0;
+    if (max_requests_per_second != t.max_requests_per_second) {
+        t.max_requests_per_second = max_requests_per_second;
+        if (!max_requests_per_second) {
+            t.rate_limiter.reset();
+        } else {
+            auto rate = double(max_requests_per_second) / smp::count;
+            // Allow a second worth of requests in a burst.
+            auto burst = std::max(rate, 1.0);
+            if (t.rate_limiter) {
+                t.rate_limiter->set_rate(rate, burst);
+            } else {
+                t.rate_limiter.emplace(rate, burst);
+            }
+        }
+    }
+    auto* shares = std::get_if<int32_t>(&slo.shares);
+    t.shares = shares ? *shares : service_level_options::max_shares;
+    return t;
+}
+
+bool request_admission_controller::has_capacity() const noexcept {
+    auto max = _max_concurrent_requests();
+    return !max || _in_flight < max;
+}
+
+request_admission_controller::permit request_admission_controller::admit_now(tenant& t) noexcept {
+    _virtual_time = t.virtual_time;
+    t.virtual_time += 1.0 / t.shares;
+    ++_in_flight;
+    return permit(*this);
+}
+
+future<request_admission_controller::permit> request_admission_controller::admit(const sstring& tenant_name, const service_level_options& slo) {
+    auto& t = get_tenant(tenant_name, slo);
+    if (t.rate_limiter && !t.rate_limiter->try_consume()) {
+        ++_stats.rate_limited;
+        return make_exception_future<permit>(exceptions::overloaded_exception(
+                format("request rate limit of service level {} ({} requests per second) exceeded", tenant_name, t.max_requests_per_second)));
+    }
+    // A tenant which was idle doesn't get to use the service it didn't
+    // receive while idle.
+    if (t.waiters.empty()) {
+        t.virtual_time = std::max(t.virtual_time, _virtual_time);
+    }
+    if (!_waiting && has_capacity()) {
+        return make_ready_future<permit>(admit_now(t));
+    }
+    ++_stats.queued;
+    ++_waiting;
+    t.waiters.emplace_back();
+    return t.waiters.back().get_future();
+}
+
+void request_admission_controller::release() noexcept {
+    --_in_flight;
+    while (_waiting && has_capacity()) {
+        tenant* next = nullptr;
+        for (auto& [name, t] : _tenants) {
+            if (!t.waiters.empty() && (!next || t.virtual_time < next->virtual_time)) {
+                next = &t;
+            }
+        }
+        auto pr = std::move(next->waiters.front());
+        next->waiters.pop_front();
+        --_waiting;
+        pr.set_value(admit_now(*next));
+    }
+}
+
+}
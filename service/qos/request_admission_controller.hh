@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+#include <seastar/core/future.hh>
+#include <seastar/core/sstring.hh>
+#include "seastarx.hh"
+#include "qos_common.hh"
+#include "utils/rate_limiter.hh"
+#include "utils/updateable_value.hh"
+
+namespace qos {
+
+struct request_admission_stats {
+    // Requests rejected because their service level's rate limit was reached.
+    uint64_t rate_limited = 0;
+    // Requests which had to wait to be admitted.
+    uint64_t queued = 0;
+};
+
+// Admits the requests a shard serves on behalf of tenants, identified by
+// their effective service level (see service_level_controller::find_effective_service_level()).
+//
+// Each tenant with max_requests_per_second set gets a token bucket, with an
+// equal part of the limit on every shard. Requests beyond it are rejected as
+// overloaded rather than queued, so that a tenant over its limit can't fill
+// the node's queues.
+//
+// When max_concurrent_requests is non-zero, at most that many requests are
+// in progress at once, and the rest wait in per-tenant queues. Whenever a
+// request completes, the next one is taken from the tenant which received
+// the least service relative to its shares (start-time fair queuing), so
+// that a busy tenant can't starve the others when the node is saturated.
+class request_admission_controller {
+public:
+    // Keeps a request admitted until destroyed.
+    class permit {
+        request_admission_controller* _controller = nullptr;
+    public:
+        permit() = default;
+        explicit permit(request_admission_controller& controller) noexcept : _controller(&controller) {}
+        permit(permit&& o) noexcept : _controller(std::exchange(o._controller, nullptr)) {}
+        permit& operator=(permit&& o) noexcept {
+            if (this != &o) {
+                release();
+                _controller = std::exchange(o._controller, nullptr);
+            }
+            return *this;
+        }
+        ~permit() {
+            release();
+        }
+    private:
+        void release() noexcept {
+            if (_controller) {
+                std::exchange(_controller, nullptr)->release();
+            }
+        }
+    };
+private:
+    struct tenant {
+        uint64_t max_requests_per_second = 0;
+        std::optional<utils::token_bucket> rate_limiter;
+        int32_t shares = service_level_options::max_shares;
+        // The service this tenant received, in requests divided by shares.
+        double virtual_time = 0;
+        std::deque<promise<permit>> waiters;
+    };
+
+    utils::updateable_value<uint32_t> _max_concurrent_requests;
+    std::unordered_map<sstring, tenant> _tenants;
+    uint32_t _in_flight = 0;
+    size_t _waiting = 0;
+    // The virtual time of the last admitted request.
+    double _virtual_time = 0;
+    request_admission_stats _stats;
+public:
+    explicit request_admission_controller(utils::updateable_value<uint32_t> max_concurrent_requests);
+
+    // Fails with exceptions::overloaded_exception if the tenant is over its
+    // rate limit.
+    future<permit> admit(const sstring& tenant_name, const service_level_options& slo);
+
+    size_t waiting() const noexcept {
+        return _waiting;
+    }
+
+    const request_admission_stats& stats() const noexcept {
+        return _stats;
+    }
+private:
+    tenant& get_tenant(const sstring& tenant_name, const service_level_options& slo);
+    permit admit_now(tenant& t) noexcept;
+    bool has_capacity() const noexcept;
+    void release() noexcept;
+};
+
+}
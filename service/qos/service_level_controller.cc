@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/coroutine.hh>
 #include "service_level_controller.hh"
 #include "service/priority_manager.hh"
 #include "message/messaging_service.hh"
@@ -185,35 +186,48 @@ future<> service_level_controller::update_service_levels_from_distributed_data()
 }
 
 future<std::optional<service_level_options>> service_level_controller::find_service_level(auth::role_set roles) {
+    return find_effective_service_level(std::move(roles)).then([] (std::optional<effective_service_level> sl) -> std::optional<service_level_options> {
+        if (!sl) {
+            return std::nullopt;
+        }
+        return std::move(sl->slo);
+    });
+}
+
+future<std::optional<effective_service_level>> service_level_controller::find_effective_service_level(auth::role_set roles) {
     auto& role_manager = _auth_service.local().underlying_role_manager();
 
     // converts a list of roles into the chosen service level.
-    return ::map_reduce(roles.begin(), roles.end(), [&role_manager, this] (const sstring& role) {
-        return role_manager.get_attribute(role, "service_level").then_wrapped([this, role] (future<std::optional<sstring>> sl_name_fut) -> std::optional<service_level_options> {
+    auto sls = co_await ::map_reduce(roles.begin(), roles.end(), [&role_manager, this] (const sstring& role) {
+        return role_manager.get_attribute(role, "service_level").then_wrapped([this, role] (future<std::optional<sstring>> sl_name_fut) -> std::map<sstring, service_level_options> {
             try {
                 std::optional<sstring> sl_name = sl_name_fut.get0();
                 if (!sl_name) {
-                    return std::nullopt;
+                    return {};
                 }
                 auto sl_it = _service_levels_db.find(*sl_name);
                 if ( sl_it == _service_levels_db.end()) {
-                    return std::nullopt;
+                    return {};
                 }
-                return sl_it->second.slo;
+                return {{*sl_name, sl_it->second.slo}};
             } catch (...) { // when we fail, we act as if the attribute does not exist so the node
                            // will not be brought down.
-                return std::nullopt;
+                return {};
             }
         });
-    }, std::optional<service_level_options>{}, [this] (std::optional<service_level_options> first, std::optional<service_level_options> second) -> std::optional<service_level_options> {
-        if (!second) {
-            return first;
-        } else if (!first) {
-            return second;
-        } else {
-            return first->merge_with(*second);
-        }
+    }, std::map<sstring, service_level_options>{}, [] (std::map<sstring, service_level_options> first, std::map<sstring, service_level_options> second) {
+        first.merge(std::move(second));
+        return first;
     });
+    if (sls.empty()) {
+        co_return std::nullopt;
+    }
+    auto ret = effective_service_level{sls.begin()->first, sls.begin()->second};
+    for (auto it = std::next(sls.begin()); it != sls.end(); ++it) {
+        ret.name += "," + it->first;
+        ret.slo = ret.slo.merge_with(it->second);
+    }
+    co_return ret;
 }
 
 future<>  service_level_controller::notify_service_level_added(sstring name, service_level sl_data) {
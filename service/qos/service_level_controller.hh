@@ -36,6 +36,13 @@ struct service_level {
      bool is_static;
 };
 
+struct effective_service_level {
+    // The names of the service levels the options were merged from, in
+    // alphabetical order, separated by commas.
+    sstring name;
+    service_level_options slo;
+};
+
 /**
  *  The service_level_controller class is an implementation of the service level
  *  controller design.
@@ -157,6 +164,12 @@ class service_level_controller : public peering_sharded_service<service_level_co
      */
     future<std::optional<service_level_options>> find_service_level(auth::role_set roles);
 
+    /**
+     * Like find_service_level(), but also identifies the service levels the
+     * effective options come from.
+     */
+    future<std::optional<effective_service_level>> find_effective_service_level(auth::role_set roles);
+
     /**
      * Gets the service level data by name.
      * @param service_level_name - the name of the requested service level
@@ -16,9 +16,9 @@
 #include "serializer_impl.hh"
 #include "idl/raft_storage.dist.impl.hh"
 
-#include "cql3/statements/batch_statement.hh"
-#include "cql3/statements/modification_statement.hh"
 #include "cql3/query_processor.hh"
+#include "service/storage_proxy.hh"
+#include "mutation.hh"
 
 #include "gms/inet_address_serializer.hh"
 
@@ -35,11 +35,6 @@ raft_sys_table_storage::raft_sys_table_storage(cql3::query_processor& qp, raft::
     , _dummy_query_state(service::client_state::for_internal_calls(), empty_service_permit())
     , _pending_op_fut(make_ready_future<>())
 {
-    static const auto store_cql = format("INSERT INTO system.{} (group_id, term, \"index\", data) VALUES (?, ?, ?, ?)",
-        db::system_keyspace::RAFT);
-    auto prepared_stmt_ptr = _qp.prepare_internal(store_cql);
-    shared_ptr<cql3::cql_statement> cql_stmt = prepared_stmt_ptr->statement;
-    _store_entry_stmt = dynamic_pointer_cast<cql3::statements::modification_statement>(cql_stmt);
 }
 
 future<> raft_sys_table_storage::store_term_and_vote(raft::term_t term, raft::server_id vote) {
@@ -194,69 +189,31 @@ future<> raft_sys_table_storage::do_store_log_entries(const std::vector<raft::lo
     if (entries.empty()) {
         co_return;
     }
-    std::vector<cql3::statements::batch_statement::single_statement> batch_stmts;
-    // statement values that can be allocated at once (one contiguous allocation)
-    std::vector<std::vector<cql3::raw_value>> stmt_values;
-    // fragmented storage for log_entries data
-    std::vector<fragmented_temporary_buffer> stmt_data_views;
-    // statement value views -- required for `query_options` to consume `fragmented_temporary_buffer::view`
-    std::vector<std::vector<cql3::raw_value_view>> stmt_value_views;
-    const size_t entries_size = entries.size();
-    batch_stmts.reserve(entries_size);
-    stmt_values.reserve(entries_size);
-    stmt_data_views.reserve(entries_size);
-    stmt_value_views.reserve(entries_size);
+    // The entries are applied as a single mutation of the group's partition
+    // directly, instead of going through a CQL batch of inserts: it's what the
+    // batch would have been turned into, only at a fraction of the cost.
+    const schema_ptr s = db::system_keyspace::raft();
+    const column_definition& term_cdef = *s->get_column_definition("term");
+    const column_definition& data_cdef = *s->get_column_definition("data");
+    const auto ts = _dummy_query_state.get_client_state().get_timestamp();
+    mutation m(s, partition_key::from_single_value(*s, timeuuid_type->decompose(_group_id.id)));
 
     for (const raft::log_entry_ptr& eptr : entries) {
-        batch_stmts.emplace_back(cql3::statements::batch_statement::single_statement(_store_entry_stmt, false));
+        auto ck = clustering_key::from_single_value(*s, long_type->decompose(int64_t(eptr->idx)));
+        auto& row = m.partition().clustered_row(*s, ck);
+        row.apply(row_marker(ts));
+        row.cells().apply(term_cdef, atomic_cell::make_live(*term_cdef.type, ts, long_type->decompose(int64_t(eptr->term))));
 
+        // don't linearize the serialized "data", it can be large
         auto data_tmp_buf = fragmented_temporary_buffer::allocate_to_fit(ser::get_sizeof(eptr->data));
         auto data_out_str = data_tmp_buf.get_ostream();
         ser::serialize(data_out_str, eptr->data);
-
-        // don't include serialized "data" here since it will require to linearize the stream
-        std::vector<cql3::raw_value> single_stmt_values;
-        // Silly workaround for https://bugs.llvm.org/show_bug.cgi?id=51515
-        single_stmt_values.reserve(3);
-        single_stmt_values.emplace_back(cql3::raw_value::make_value(timeuuid_type->decompose(_group_id.id)));
-        single_stmt_values.emplace_back(cql3::raw_value::make_value(long_type->decompose(int64_t(eptr->term))));
-        single_stmt_values.emplace_back(cql3::raw_value::make_value(long_type->decompose(int64_t(eptr->idx))));
-
-        stmt_values.emplace_back(std::move(single_stmt_values));
-        stmt_data_views.emplace_back(std::move(data_tmp_buf));
-
-        // allocate value views
-        std::vector<cql3::raw_value_view> value_views;
-        value_views.reserve(4); // 4 is the number of required values for the insertion query 
-        for (const cql3::raw_value& raw : stmt_values.back()) {
-            value_views.push_back(raw.to_view());
-        }
-        value_views.emplace_back(
-            cql3::raw_value_view::make_value(
-                fragmented_temporary_buffer::view(stmt_data_views.back())));
-        stmt_value_views.emplace_back(std::move(value_views));
+        row.cells().apply(data_cdef, atomic_cell::make_live(*data_cdef.type, ts, fragmented_temporary_buffer::view(data_tmp_buf)));
 
         co_await coroutine::maybe_yield();
     }
 
-    auto batch_options = cql3::query_options::make_batch_options(
-        cql3::query_options(
-            cql3::default_cql_config,
-            db::consistency_level::ONE,
-            std::nullopt,
-            std::vector<cql3::raw_value>{},
-            false,
-            cql3::query_options::specific_options::DEFAULT,
-            cql_serialization_format::latest()),
-        std::move(stmt_value_views));
-
-    cql3::statements::batch_statement batch(
-        cql3::statements::batch_statement::type::UNLOGGED,
-        std::move(batch_stmts),
-        cql3::attributes::none(),
-        _qp.get_cql_stats());
-
-    co_await batch.execute(_qp, _dummy_query_state, batch_options);
+    co_await _qp.proxy().mutate_locally(m, tracing::trace_state_ptr(), db::commitlog::force_sync::yes);
 }
 
 future<> raft_sys_table_storage::store_log_entries(const std::vector<raft::log_entry_ptr>& entries) {
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <seastar/core/lowres_clock.hh>
+
+#include "gms/inet_address.hh"
+#include "inet_address_vectors.hh"
+#include "utils/small_vector.hh"
+#include "seastarx.hh"
+
+namespace service {
+
+// Scores replicas by how fast they have been answering the reads of this
+// shard recently, so that reads can be steered away from a replica which is
+// slow right now (e.g. compacting or stalled) long before the failure
+// detector would notice anything.
+//
+// The score of a replica is the exponentially weighted moving average of its
+// response latency, multiplied by one plus the number of requests to it still
+// in flight, so that a replica which stopped responding is penalized before
+// its requests time out. Lower is better. An idle replica which wasn't heard
+// from for reset_interval is forgotten, which lets a replica we avoided
+// recover.
+//
+// The latency of a replica which didn't respond yet, or was forgotten, is
+// unknown. When sorting, it is taken to be the average of the known
+// latencies of the other replicas, so that such a replica (e.g. in a remote
+// DC, which is rarely read from) is neither preferred over the replicas
+// known to be healthy, nor avoided.
+class replica_scorer {
+public:
+    using clock_type = seastar::lowres_clock;
+
+    // Weight of a new latency sample in the moving average.
+    static constexpr double alpha = 0.25;
+    // Scores differing by less than this (in microseconds) are considered
+    // equal, so that noise doesn't make us abandon the proximity order.
+    static constexpr double min_difference = 1000;
+private:
+    struct endpoint_state {
+        double latency = 0; // EWMA, in microseconds
+        uint32_t in_flight = 0;
+        clock_type::time_point last_response;
+    };
+
+    std::unordered_map<gms::inet_address, endpoint_state> _endpoints;
+public:
+    void on_request(gms::inet_address ep) {
+        ++_endpoints[ep].in_flight;
+    }
+
+    void on_response(gms::inet_address ep, std::chrono::microseconds latency) noexcept {
+        auto it = _endpoints.find(ep);
+        if (it == _endpoints.end()) {
+            return;
+        }
+        auto& st = it->second;
+        if (st.in_flight) {
+            --st.in_flight;
+        }
+        auto now = clock_type::now();
+        auto sample = double(latency.count());
+        st.latency = st.last_response == clock_type::time_point() ? sample : alpha * sample + (1 - alpha) * st.latency;
+        st.last_response = now;
+    }
+
+    // The moving average of the latency of the replica, if known.
+    std::optional<double> latency(gms::inet_address ep, clock_type::duration reset_interval) const noexcept {
+        auto it = _endpoints.find(ep);
+        if (it == _endpoints.end()) {
+            return std::nullopt;
+        }
+        auto& st = it->second;
+        if (st.last_response == clock_type::time_point()
+                || (!st.in_flight && clock_type::now() - st.last_response > reset_interval)) {
+            return std::nullopt;
+        }
+        return st.latency;
+    }
+
+    // unknown_latency stands for the latency of a replica whose latency isn't known.
+    double score(gms::inet_address ep, clock_type::duration reset_interval, double unknown_latency) const noexcept {
+        auto it = _endpoints.find(ep);
+        auto in_flight = it == _endpoints.end() ? 0 : it->second.in_flight;
+        return latency(ep, reset_interval).value_or(unknown_latency) * (1 + in_flight);
+    }
+
+    // Reorders eps by score if, at any position, the replica there scores
+    // worse than the one which would take its place by more than
+    // badness_threshold (relative to the latter). Otherwise keeps the given
+    // (proximity) order. Returns true iff the order was changed.
+    bool sort(inet_address_vector_replica_set& eps, double badness_threshold, clock_type::duration reset_interval) const {
+        if (eps.size() < 2) {
+            return false;
+        }
+        double known_latency_sum = 0;
+        size_t known = 0;
+        for (auto& ep : eps) {
+            if (auto l = latency(ep, reset_interval)) {
+                known_latency_sum += *l;
+                ++known;
+            }
+        }
+        auto unknown_latency = known ? known_latency_sum / known : 0;
+        utils::small_vector<std::pair<double, gms::inet_address>, 3> scored;
+        scored.reserve(eps.size());
+        for (auto& ep : eps) {
+            scored.emplace_back(score(ep, reset_interval, unknown_latency), ep);
+        }
+        auto sorted = scored;
+        std::stable_sort(sorted.begin(), sorted.end(), [] (const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        bool bad = false;
+        for (size_t i = 0; i < scored.size(); ++i) {
+            bad |= scored[i].first > sorted[i].first * (1 + badness_threshold) + min_difference;
+        }
+        if (!bad) {
+            return false;
+        }
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            eps[i] = sorted[i].second;
+        }
+        return true;
+    }
+
+    void remove(gms::inet_address ep) noexcept {
+        _endpoints.erase(ep);
+    }
+};
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+
+namespace service {
+
+// Bounds the number of speculative reads relative to the number of reads
+// which may speculate, so that speculation can't more than double the read
+// load when all replicas slow down at once (which is exactly when it would
+// trigger for most reads).
+//
+// A token bucket: each read deposits `ratio` tokens, each speculative retry
+// withdraws one. The bucket is capped, so a quiet period only allows a small
+// burst of retries afterwards.
+class speculative_retry_budget {
+public:
+    static constexpr double ratio = 1.0;
+    static constexpr double max_balance = 100;
+private:
+    double _balance = max_balance;
+public:
+    void deposit() noexcept {
+        _balance = std::min(_balance + ratio, max_balance);
+    }
+
+    bool try_withdraw() noexcept {
+        if (_balance < 1) {
+            return false;
+        }
+        _balance -= 1;
+        return true;
+    }
+};
+
+}
@@ -23,14 +23,17 @@
 #include "supervisor.hh"
 #include "query_result_merger.hh"
 #include <seastar/core/do_with.hh>
+#include <seastar/core/shared_future.hh>
 #include "message/messaging_service.hh"
 #include "gms/failure_detector.hh"
+#include "gms/direct_failure_detector.hh"
 #include "gms/gossiper.hh"
 #include <seastar/core/future-util.hh>
 #include "db/read_repair_decision.hh"
 #include "db/config.hh"
 #include "db/batchlog_manager.hh"
 #include "db/hints/manager.hh"
+#include "db/view/view_update_coalescer.hh"
 #include "db/system_keyspace.hh"
 #include "exceptions/exceptions.hh"
 #include <boost/range/algorithm_ext/push_back.hpp>
@@ -46,6 +49,8 @@
 #include <boost/range/algorithm/heap_algorithm.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/range/algorithm/sort.hpp>
+#include <boost/range/algorithm/max_element.hpp>
+#include <boost/range/irange.hpp>
 #include <boost/range/empty.hpp>
 #include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -74,6 +79,7 @@
 #include "service/paxos/proposal.hh"
 #include "locator/token_metadata.hh"
 #include "seastar/core/coroutine.hh"
+#include <seastar/core/later.hh>
 #include "locator/abstract_replication_strategy.hh"
 #include "service/paxos/cas_request.hh"
 #include "mutation_partition_view.hh"
@@ -94,6 +100,7 @@
 #include "utils/result_loop.hh"
 #include "utils/overloaded_functor.hh"
 #include "utils/result_try.hh"
+#include "utils/hash.hh"
 
 namespace bi = boost::intrusive;
 
@@ -127,6 +134,9 @@ using fbu = utils::fb_utilities;
 
 static inline
 query::digest_algorithm digest_algorithm(service::storage_proxy& proxy) {
+    if (proxy.features().cluster_supports_xxh3_digest()) {
+        return query::digest_algorithm::xxHash3;
+    }
     return proxy.features().cluster_supports_digest_for_null_values()
             ? query::digest_algorithm::xxHash
             : query::digest_algorithm::legacy_xxHash_without_null_digest;
@@ -371,6 +381,7 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
     error _error = error::NONE;
     std::optional<sstring> _message;
     size_t _failed = 0; // only failures that may impact consistency
+    std::unordered_map<gms::inet_address, exceptions::request_failure_reason> _failure_reasons; // of the _failed replicas
     size_t _all_failures = 0; // total amount of failures
     size_t _total_endpoints = 0;
     storage_proxy::write_stats& _stats;
@@ -413,11 +424,11 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
             if (_error == error::TIMEOUT) {
                 _ready.set_value(mutation_write_timeout_exception(get_schema()->ks_name(), get_schema()->cf_name(), _cl, _cl_acks, _total_block_for, _type));
             } else if (_error == error::FAILURE) {
-                if (!_message) {
-                    _ready.set_exception(mutation_write_failure_exception(get_schema()->ks_name(), get_schema()->cf_name(), _cl, _cl_acks, _failed, _total_block_for, _type));
-                } else {
-                    _ready.set_exception(mutation_write_failure_exception(*_message, _cl, _cl_acks, _failed, _total_block_for, _type));
-                }
+                auto ex = !_message
+                        ? mutation_write_failure_exception(get_schema()->ks_name(), get_schema()->cf_name(), _cl, _cl_acks, _failed, _total_block_for, _type)
+                        : mutation_write_failure_exception(*_message, _cl, _cl_acks, _failed, _total_block_for, _type);
+                ex.failure_reasons = std::move(_failure_reasons);
+                _ready.set_exception(std::move(ex));
             }
             if (_cdc_operation_result_tracker) {
                 _cdc_operation_result_tracker->on_mutation_failed();
@@ -458,6 +469,7 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
     bool failure(gms::inet_address from, size_t count, error err, std::optional<sstring> msg) {
         if (waited_for(from)) {
             _failed += count;
+            _failure_reasons.emplace(from, exceptions::request_failure_reason::unknown);
             if (_total_block_for + _failed > _total_endpoints) {
                 _error = err;
                 _message = std::move(msg);
@@ -773,6 +785,7 @@ class datacenter_sync_write_response_handler : public abstract_write_response_ha
 
         dc_resp->second.failures += count;
         _failed += count;
+        _failure_reasons.emplace(from, exceptions::request_failure_reason::unknown);
         if (dc_resp->second.total_block_for + dc_resp->second.failures > dc_resp->second.total_endpoints) {
             _error = err;
             return true;
@@ -1590,6 +1603,22 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of background read repairs"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("deferred_read_repairs", deferred_read_repairs,
+                       sm::description("number of reads which returned their result without waiting for their read repair writes"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("read_repairs_over_budget", read_repairs_over_budget,
+                       sm::description("number of reads which waited for their read repair writes because the memory for asynchronous read repairs was exhausted"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("read_repair_batches", read_repair_batches,
+                       sm::description("number of writes of asynchronous read repairs, each of the repairs queued during a short period"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("dropped_read_repairs", dropped_read_repairs,
+                       sm::description("number of asynchronous read repair mutations which failed to be written"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_total_operations("read_timeouts", read_timeouts._count,
                        sm::description("number of read request failed due to a timeout"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
@@ -1614,6 +1643,14 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of speculative data read requests that were sent"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("speculative_reads_over_budget", speculative_reads_over_budget,
+                       sm::description("number of speculative read requests that were not sent because speculation exhausted its budget"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("range_reads_concurrency_reduced", range_reads_concurrency_reduced,
+                       sm::description("number of times a range scan read fewer ranges concurrently because the replicas were slow to respond"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_histogram("cas_read_latency", sm::description("Transactional read latency histogram"),
                 {storage_proxy_stats::current_scheduling_group_label()},
                 [this]{ return to_metrics_histogram(estimated_cas_read);}),
@@ -1659,6 +1696,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("CAS read rounds issued only if previous value is missing on some replica"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("cas_background_learn", cas_background_learn,
+                       sm::description("number of uncontended CAS operations whose decision was learned after answering the client"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_histogram("cas_read_contention", sm::description("how many contended reads were encountered"),
                        {storage_proxy_stats::current_scheduling_group_label()},
                        [this]{ return cas_read_contention.get_histogram(1, 8);}),
@@ -1721,6 +1762,14 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of operations that crossed a shard boundary"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("cross_shard_write_batches", replica_cross_shard_write_batches,
+                       sm::description("number of messages to other shards carrying batched mutation writes"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("write_ack_batches", replica_write_ack_batches,
+                       sm::description("number of messages to coordinators carrying batched write acknowledgements"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_total_operations("cas_dropped_prune", cas_replica_dropped_prune,
                        sm::description("how many times a coordinator did not perfom prune after cas"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
@@ -1796,6 +1845,427 @@ inline std::ostream& operator<<(std::ostream& os, const hint_wrapper& h) {
 
 using namespace std::literals::chrono_literals;
 
+// Coalesces the mutations applied on other shards of this node into one
+// cross-shard message per destination shard.
+//
+// The mutations of a request, e.g. of an UNLOGGED BATCH or of a BatchWriteItem,
+// are all dispatched from one task, so the mutations queued for a shard are
+// sent when that task yields. This bounds the added latency by the run time
+// of the task, while a batch of many small mutations costs one message per
+// shard instead of one message per mutation.
+class storage_proxy::cross_shard_write_batcher {
+    static constexpr size_t max_batch_size = 128;
+
+    struct write {
+        global_schema_ptr schema;
+        const frozen_mutation* mutation;
+        tracing::global_trace_state_ptr trace_state;
+        db::commitlog::force_sync sync;
+        clock_type::time_point timeout;
+        promise<> done;
+    };
+
+    storage_proxy& _proxy;
+    std::vector<std::vector<write>> _batches;
+public:
+    explicit cross_shard_write_batcher(storage_proxy& proxy)
+        : _proxy(proxy)
+        , _batches(smp::count)
+    {}
+
+    // The mutation must be kept alive until the returned future resolves.
+    future<> add(unsigned shard, const schema_ptr& s, const frozen_mutation& m, tracing::trace_state_ptr tr_state,
+            db::commitlog::force_sync sync, clock_type::time_point timeout) {
+        auto& batch = _batches[shard];
+        if (batch.empty()) {
+            // Send the batch once the current task is done queueing into it.
+            (void)seastar::yield().then([this, shard, p = _proxy.shared_from_this()] {
+                send(shard);
+            });
+        }
+        batch.push_back(write{global_schema_ptr(s), &m, tracing::global_trace_state_ptr(std::move(tr_state)), sync, timeout, {}});
+        auto f = batch.back().done.get_future();
+        if (batch.size() >= max_batch_size) {
+            send(shard);
+        }
+        return f;
+    }
+private:
+    // Runs on the destination shard.
+    static future<std::vector<std::exception_ptr>> apply(replica::database& db, const std::vector<write>& batch) {
+        std::vector<std::exception_ptr> errors(batch.size());
+        co_await parallel_for_each(boost::irange(size_t(0), batch.size()), [&] (size_t i) -> future<> {
+            auto& w = batch[i];
+            try {
+                co_await db.apply(w.schema, *w.mutation, w.trace_state.get(), w.sync, w.timeout);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+        co_return errors;
+    }
+
+    void send(unsigned shard) {
+        auto batch = std::exchange(_batches[shard], {});
+        if (batch.empty()) {
+            return;
+        }
+        // Each write still times out on its own on the destination shard.
+        auto timeout = boost::max_element(batch, [] (const write& a, const write& b) { return a.timeout < b.timeout; })->timeout;
+        ++_proxy.get_stats().replica_cross_shard_write_batches;
+        (void)do_with(std::move(batch), [this, shard, timeout] (std::vector<write>& batch) {
+            return _proxy._db.invoke_on(shard, {_proxy._write_smp_service_group, timeout}, [&batch] (replica::database& db) {
+                return apply(db, batch);
+            }).then_wrapped([&batch] (future<std::vector<std::exception_ptr>> f) {
+                if (f.failed()) {
+                    auto ep = f.get_exception();
+                    for (auto& w : batch) {
+                        w.done.set_exception(ep);
+                    }
+                    return;
+                }
+                auto errors = f.get0();
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    if (errors[i]) {
+                        batch[i].done.set_exception(std::move(errors[i]));
+                    } else {
+                        batch[i].done.set_value();
+                    }
+                }
+            });
+        });
+    }
+};
+
+// Coalesces the acknowledgements of writes this replica sends to the same
+// coordinator shard within write_ack_batching_window_in_us into one
+// MUTATION_DONE_BATCH message, instead of one MUTATION_DONE message each.
+//
+// The window is only started by the first acknowledgement queued for any
+// coordinator, so a replica never holds an acknowledgement for longer than
+// that. A batch is also sent as soon as it holds max_batch_size of them.
+class storage_proxy::write_ack_batcher {
+    static constexpr size_t max_batch_size = 128;
+
+    struct batch {
+        std::vector<response_id_type> response_ids;
+        std::vector<promise<>> sent;
+    };
+
+    storage_proxy& _proxy;
+    std::unordered_map<netw::msg_addr, batch, netw::msg_addr::hash> _batches;
+    timer<> _timer;
+public:
+    explicit write_ack_batcher(storage_proxy& proxy)
+        : _proxy(proxy)
+        , _timer([this] { flush(); })
+    {}
+
+    // Resolves once the acknowledgement was handed to the messaging
+    // service, so that the caller is throttled like for MUTATION_DONE.
+    future<> add(netw::msg_addr reply_to, response_id_type response_id, std::chrono::microseconds window) {
+        auto& b = _batches[reply_to];
+        b.response_ids.push_back(response_id);
+        b.sent.emplace_back();
+        auto f = b.sent.back().get_future();
+        if (b.response_ids.size() >= max_batch_size) {
+            send(reply_to);
+        } else if (!_timer.armed()) {
+            _timer.arm(window);
+        }
+        return f;
+    }
+
+    void flush() {
+        _timer.cancel();
+        while (!_batches.empty()) {
+            send(_batches.begin()->first);
+        }
+    }
+private:
+    void send(netw::msg_addr reply_to) {
+        auto b = std::move(_batches.extract(reply_to).mapped());
+        ++_proxy.get_stats().replica_write_ack_batches;
+        (void)ser::storage_proxy_rpc_verbs::send_mutation_done_batch(&_proxy._messaging, reply_to, reply_to.cpu_id,
+                std::move(b.response_ids), _proxy.get_view_update_backlog()).then_wrapped([sent = std::move(b.sent), p = _proxy.shared_from_this()] (future<> f) mutable {
+            f.ignore_ready_future();
+            for (auto& s : sent) {
+                s.set_value();
+            }
+        });
+    }
+};
+
+// Collects the read repair writes of reads which don't wait for them, see
+// async_read_repair, and sends them together every flush_period.
+//
+// Repairs of the same partition on the same replica which are queued in the
+// same period are merged into one mutation, so a hot partition read often
+// while one of its replicas catches up is repaired once per period instead
+// of once per read, and all the repairs of a period are issued as one write.
+//
+// Queued and in-flight repairs are bounded by async_read_repair_memory_limit_in_mb,
+// when that is exhausted reads fall back to waiting for their repair.
+class storage_proxy::read_repair_batcher {
+    static constexpr auto flush_period = std::chrono::milliseconds(10);
+
+    using diffs_type = std::unordered_map<dht::token, std::unordered_map<gms::inet_address, std::optional<mutation>>>;
+    using key_type = std::pair<utils::UUID, dht::token>;
+
+    storage_proxy& _proxy;
+    std::unordered_map<key_type, std::unordered_map<gms::inet_address, std::optional<mutation>>, utils::tuple_hash> _pending;
+    // Memory of the repairs queued in _pending.
+    size_t _pending_memory = 0;
+    // Memory of the repairs queued or being written.
+    size_t _memory = 0;
+    timer<> _timer;
+public:
+    explicit read_repair_batcher(storage_proxy& proxy)
+        : _proxy(proxy)
+        , _timer([this] { flush(); })
+    {}
+
+    // Takes over the repair of a read, or returns false if that would
+    // exceed the memory budget, in which case diffs is left alone.
+    bool add(diffs_type& diffs) {
+        size_t memory = 0;
+        for (auto& [token, per_endpoint] : diffs) {
+            memory += memory_of(per_endpoint);
+        }
+        size_t limit = size_t(_proxy._db.local().get_config().async_read_repair_memory_limit_in_mb()) * 1024 * 1024;
+        if (_memory + memory > limit) {
+            ++_proxy.get_stats().read_repairs_over_budget;
+            return false;
+        }
+        _memory += memory;
+        ++_proxy.get_stats().deferred_read_repairs;
+        std::vector<std::unordered_map<gms::inet_address, std::optional<mutation>>> conflicting;
+        size_t conflicting_memory = 0;
+        for (auto& [token, per_endpoint] : diffs) {
+            auto s = schema_of(per_endpoint);
+            if (!s) {
+                continue;
+            }
+            auto m_memory = memory_of(per_endpoint);
+            auto& pending = _pending[key_type(s->id(), token)];
+            if (merge(pending, per_endpoint)) {
+                _pending_memory += m_memory;
+            } else {
+                conflicting_memory += m_memory;
+                conflicting.push_back(std::move(per_endpoint));
+            }
+        }
+        diffs.clear();
+        if (!conflicting.empty()) {
+            send(std::move(conflicting), conflicting_memory);
+        }
+        if (!_pending.empty() && !_timer.armed()) {
+            _timer.arm(flush_period);
+        }
+        return true;
+    }
+
+    void flush() {
+        _timer.cancel();
+        if (_pending.empty()) {
+            return;
+        }
+        auto pending = std::exchange(_pending, {});
+        send(boost::copy_range<std::vector<std::unordered_map<gms::inet_address, std::optional<mutation>>>>(
+                pending | boost::adaptors::map_values | boost::adaptors::moved), std::exchange(_pending_memory, 0));
+    }
+private:
+    static size_t memory_of(const std::unordered_map<gms::inet_address, std::optional<mutation>>& per_endpoint) {
+        size_t memory = 0;
+        for (auto& [ep, m] : per_endpoint) {
+            if (m) {
+                memory += sizeof(mutation) + m->partition().external_memory_usage(*m->schema());
+            }
+        }
+        return memory;
+    }
+
+    static schema_ptr schema_of(const std::unordered_map<gms::inet_address, std::optional<mutation>>& per_endpoint) {
+        for (auto& [ep, m] : per_endpoint) {
+            if (m) {
+                return m->schema();
+            }
+        }
+        return nullptr;
+    }
+
+    // Merges the repairs of a partition into those already queued for it.
+    // Returns false, leaving both alone, if they can't be merged because
+    // they are for different partitions with the same token, or were built
+    // with different versions of the schema.
+    static bool merge(std::unordered_map<gms::inet_address, std::optional<mutation>>& pending,
+            std::unordered_map<gms::inet_address, std::optional<mutation>>& diffs) {
+        auto pending_schema = schema_of(pending);
+        if (pending_schema) {
+            auto s = schema_of(diffs);
+            if (s->version() != pending_schema->version()) {
+                return false;
+            }
+            for (auto& [ep, m] : diffs) {
+                auto it = pending.find(ep);
+                if (m && it != pending.end() && it->second && !it->second->decorated_key().equal(*s, m->decorated_key())) {
+                    return false;
+                }
+            }
+        }
+        for (auto& [ep, m] : diffs) {
+            auto& p = pending[ep];
+            if (!m) {
+                continue;
+            }
+            if (p) {
+                p->apply(std::move(*m));
+            } else {
+                p = std::move(m);
+            }
+        }
+        return true;
+    }
+
+    // Releases memory, reserved by add(), once the write is done.
+    void send(std::vector<std::unordered_map<gms::inet_address, std::optional<mutation>>> diffs, size_t memory) {
+        size_t mutations = 0;
+        for (auto& per_endpoint : diffs) {
+            mutations += boost::count_if(per_endpoint | boost::adaptors::map_values, [] (const std::optional<mutation>& m) { return bool(m); });
+        }
+        ++_proxy.get_stats().read_repair_batches;
+        (void)_proxy.mutate_internal(std::move(diffs), db::consistency_level::ONE, false, nullptr, empty_service_permit())
+                .then(utils::result_into_future<result<>>).then_wrapped([this, memory, mutations, p = _proxy.shared_from_this()] (future<> f) {
+            if (f.failed()) {
+                slogger.debug("Failed to write asynchronous read repair: {}", f.get_exception());
+                _proxy.get_stats().dropped_read_repairs += mutations;
+            }
+            _memory -= memory;
+        });
+    }
+};
+
+// Collects the removals of the logged batches which were applied from the
+// batchlog, and sends those queued for the same batchlog endpoint together,
+// with one REMOVE_FROM_BATCHLOG message, every flush_period or as soon as
+// max_pending are queued.
+//
+// The removal of a batch doesn't make it any more durable, so the batch
+// statement doesn't wait for it: its latency is that of the batchlog write
+// and of the batch itself. A removal which is lost only makes the batch be
+// replayed, which is idempotent. Once max_outstanding removals are queued
+// or being sent, though, batches wait for theirs, so that removals don't
+// pile up when the batchlog endpoints can't keep up.
+class storage_proxy::batchlog_removal_batcher {
+    static constexpr auto flush_period = std::chrono::milliseconds(10);
+    static constexpr size_t max_pending = 1024;
+    static constexpr size_t max_outstanding = 16 * max_pending;
+
+    storage_proxy& _proxy;
+    std::unordered_map<gms::inet_address, std::vector<utils::UUID>> _pending;
+    size_t _pending_batches = 0;
+    // Batches whose removal is queued or being sent.
+    size_t _outstanding_batches = 0;
+    // Resolved once the removals in _pending are done.
+    lw_shared_ptr<shared_promise<>> _pending_done = make_lw_shared<shared_promise<>>();
+    timer<> _timer;
+public:
+    explicit batchlog_removal_batcher(storage_proxy& proxy)
+        : _proxy(proxy)
+        , _timer([this] { flush(); })
+    {}
+
+    // Resolves immediately, unless there are too many outstanding removals,
+    // in which case it resolves once the removal of this batch is done.
+    future<> add(const utils::UUID& batch_uuid, const inet_address_vector_replica_set& endpoints) {
+        for (auto& ep : endpoints) {
+            _pending[ep].push_back(batch_uuid);
+        }
+        ++_pending_batches;
+        auto f = ++_outstanding_batches > max_outstanding ? _pending_done->get_shared_future() : make_ready_future<>();
+        if (_pending_batches >= max_pending) {
+            flush();
+        } else if (!_timer.armed()) {
+            _timer.arm(flush_period);
+        }
+        return f;
+    }
+
+    void flush() {
+        _timer.cancel();
+        if (_pending.empty()) {
+            return;
+        }
+        auto pending = std::exchange(_pending, {});
+        auto batches = std::exchange(_pending_batches, 0);
+        auto done = std::exchange(_pending_done, make_lw_shared<shared_promise<>>());
+        auto timestamp = service::client_state(service::client_state::internal_tag()).get_timestamp();
+        auto timeout = clock_type::now() + std::chrono::milliseconds(_proxy._db.local().get_config().write_request_timeout_in_ms());
+        (void)do_with(std::move(pending), [this, timestamp, timeout] (auto& pending) {
+            return parallel_for_each(pending, [this, timestamp, timeout] (auto& ep_and_ids) {
+                return send(ep_and_ids.first, ep_and_ids.second, timestamp, timeout);
+            });
+        }).finally([this, batches, done, p = _proxy.shared_from_this()] {
+            _outstanding_batches -= batches;
+            done->set_value();
+        });
+    }
+
+    // Applies the removals on this node, for the REMOVE_FROM_BATCHLOG verb.
+    static future<> apply_locally(storage_proxy& proxy, const std::vector<utils::UUID>& ids, api::timestamp_type timestamp, clock_type::time_point timeout) {
+        return proxy.mutate_locally(make_removals(proxy, ids, timestamp), nullptr, timeout);
+    }
+private:
+    static std::vector<mutation> make_removals(storage_proxy& proxy, const std::vector<utils::UUID>& ids, api::timestamp_type timestamp) {
+        auto schema = proxy._db.local().find_schema(db::system_keyspace::NAME, db::system_keyspace::BATCHLOG);
+        std::vector<mutation> removals;
+        removals.reserve(ids.size());
+        for (auto& id : ids) {
+            mutation m(schema, partition_key::from_exploded(*schema, {uuid_type->decompose(id)}));
+            m.partition().apply_delete(*schema, clustering_key_prefix::make_empty(), tombstone(timestamp, gc_clock::now()));
+            removals.push_back(std::move(m));
+        }
+        return removals;
+    }
+
+    future<> send(gms::inet_address ep, const std::vector<utils::UUID>& ids, api::timestamp_type timestamp, clock_type::time_point timeout) {
+        ++_proxy._global_stats.batchlog_removal_batches;
+        future<> f = make_ready_future<>();
+        if (ep == utils::fb_utilities::get_broadcast_address()) {
+            f = apply_locally(_proxy, ids, timestamp, timeout);
+        } else if (_proxy._features.cluster_supports_batchlog_removal_batching()) {
+            f = ser::storage_proxy_rpc_verbs::send_remove_from_batchlog(&_proxy._messaging, netw::msg_addr{ep, 0}, timeout, ids, timestamp);
+        } else {
+            f = send_mutations(ep, ids, timestamp, timeout);
+        }
+        return f.handle_exception([this, ep, count = ids.size()] (std::exception_ptr ex) {
+            slogger.error("Failed to remove mutations from batchlog on {}: {}", ep, ex);
+            _proxy._global_stats.failed_batchlog_removals += count;
+        });
+    }
+
+    // Nodes which don't know REMOVE_FROM_BATCHLOG get one write per batch.
+    future<> send_mutations(gms::inet_address ep, const std::vector<utils::UUID>& ids, api::timestamp_type timestamp, clock_type::time_point timeout) {
+        return _proxy.mutate_prepare<>(make_removals(_proxy, ids, timestamp), db::consistency_level::ANY, db::write_type::BATCH_LOG, empty_service_permit(),
+                [this, ep] (const mutation& m, db::consistency_level cl, db::write_type type, service_permit permit) {
+            auto& ks = _proxy._db.local().find_keyspace(m.schema()->ks_name());
+            return _proxy.create_write_response_handler(ks, cl, type, std::make_unique<shared_mutation>(m), inet_address_vector_replica_set{ep}, {}, {}, nullptr, _proxy.get_stats(), std::move(permit));
+        }).then([this, timeout] (unique_response_handler_vector ids) {
+            return _proxy.mutate_begin(std::move(ids), db::consistency_level::ANY, nullptr, timeout);
+        }).then(utils::result_into_future<result<>>);
+    }
+};
+
+future<> storage_proxy::send_mutation_done(netw::msg_addr reply_to, response_id_type response_id, clock_type::time_point timeout) {
+    auto window = std::chrono::microseconds(_db.local().get_config().write_ack_batching_window_in_us());
+    // Don't hold the acknowledgement of a write which is about to time out
+    // on the coordinator, nor send a verb it may not know.
+    if (window.count() && timeout - clock_type::now() > 10 * window && _features.cluster_supports_write_ack_batching()) {
+        return _write_ack_batcher->add(reply_to, response_id, window);
+    }
+    return ser::storage_proxy_rpc_verbs::send_mutation_done(&_messaging, reply_to, reply_to.cpu_id, response_id, get_view_update_backlog());
+}
+
 storage_proxy::~storage_proxy() {}
 storage_proxy::storage_proxy(distributed<replica::database>& db, gms::gossiper& gossiper, storage_proxy::config cfg, db::view::node_update_backlog& max_view_update_backlog,
         scheduling_group_key stats_key, gms::feature_service& feat, const locator::shared_token_metadata& stm, locator::effective_replication_map_factory& erm_factory, netw::messaging_service& ms)
@@ -1820,11 +2290,23 @@ storage_proxy::storage_proxy(distributed<replica::database>& db, gms::gossiper&
     , _connection_dropped([this] (gms::inet_address addr) { connection_dropped(std::move(addr)); })
     , _condrop_registration(_messaging.when_connection_drops(_connection_dropped))
     , _max_view_update_backlog(max_view_update_backlog)
-    , _view_update_handlers_list(std::make_unique<view_update_handlers_list>()) {
+    , _view_update_handlers_list(std::make_unique<view_update_handlers_list>())
+    , _cross_shard_write_batcher(std::make_unique<cross_shard_write_batcher>(*this))
+    , _write_ack_batcher(std::make_unique<write_ack_batcher>(*this))
+    , _read_repair_batcher(std::make_unique<read_repair_batcher>(*this))
+    , _batchlog_removal_batcher(std::make_unique<batchlog_removal_batcher>(*this))
+    , _view_update_coalescer(std::make_unique<db::view::view_update_coalescer>(
+            [this] (gms::inet_address target, frozen_mutation_and_schema mut, allow_hints allow_hints, tracing::trace_state_ptr tr_state) {
+        return send_to_endpoint(std::move(mut), target, {}, db::write_type::VIEW, std::move(tr_state), allow_hints);
+    })) {
     namespace sm = seastar::metrics;
     _metrics.add_group(storage_proxy_stats::COORDINATOR_STATS_CATEGORY, {
         sm::make_queue_length("current_throttled_writes", [this] { return _throttled_writes.size(); },
                        sm::description("number of currently throttled write requests")),
+        sm::make_total_operations("batchlog_removal_batches", _global_stats.batchlog_removal_batches,
+                       sm::description("number of messages removing logged batches from the batchlog of a node, each with the batches completed during a short period")),
+        sm::make_total_operations("failed_batchlog_removals", _global_stats.failed_batchlog_removals,
+                       sm::description("number of logged batches which failed to be removed from the batchlog, and will be replayed")),
     });
 
     slogger.trace("hinted DCs: {}", cfg.hinted_handoff_enabled.to_configuration_string());
@@ -1890,6 +2372,16 @@ storage_proxy::mutate_locally(const schema_ptr& s, const frozen_mutation& m, tra
     });
 }
 
+future<>
+storage_proxy::mutate_locally(const schema_ptr& s, const frozen_mutation& m, tracing::trace_state_ptr tr_state, db::commitlog::force_sync sync, clock_type::time_point timeout) {
+    auto shard = _db.local().shard_of(m);
+    if (shard != this_shard_id() && _db.local().get_config().enable_cross_shard_write_batching()) {
+        ++get_stats().replica_cross_shard_ops;
+        return _cross_shard_write_batcher->add(shard, s, m, std::move(tr_state), sync, timeout);
+    }
+    return mutate_locally(s, m, std::move(tr_state), sync, timeout, _write_smp_service_group);
+}
+
 future<>
 storage_proxy::mutate_locally(std::vector<mutation> mutations, tracing::trace_state_ptr tr_state, clock_type::time_point timeout, smp_service_group smp_grp) {
     return do_with(std::move(mutations), [this, timeout, tr_state = std::move(tr_state), smp_grp] (std::vector<mutation>& pmut) mutable {
@@ -2419,7 +2911,8 @@ storage_proxy::mutate_with_triggers(std::vector<mutation> mutations, db::consist
  * See mutate. Adds additional steps before and after writing a batch.
  * Before writing the batch (but after doing availability check against the FD for the row replicas):
  *      write the entire batch to a batchlog elsewhere in the cluster.
- * After: remove the batchlog entry (after writing hints for the batch rows, if necessary).
+ * After: remove the batchlog entry (after writing hints for the batch rows, if necessary), in the
+ *        background, together with those of the other batches, see batchlog_removal_batcher.
  *
  * @param mutations the Mutations to be applied across the replicas
  * @param consistency_level the consistency level for the operation
@@ -2495,26 +2988,6 @@ storage_proxy::mutate_atomically_result(std::vector<mutation> mutations, db::con
             tracing::trace(_trace_state, "Sending a batchlog write mutation");
             return send_batchlog_mutation(std::move(m));
         };
-        future<> async_remove_from_batchlog() {
-            // delete batch
-            auto schema = _p._db.local().find_schema(db::system_keyspace::NAME, db::system_keyspace::BATCHLOG);
-            auto key = partition_key::from_exploded(*schema, {uuid_type->decompose(_batch_uuid)});
-            auto now = service::client_state(service::client_state::internal_tag()).get_timestamp();
-            mutation m(schema, key);
-            m.partition().apply_delete(*schema, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
-
-            tracing::trace(_trace_state, "Sending a batchlog remove mutation");
-            return send_batchlog_mutation(std::move(m), db::consistency_level::ANY).then_wrapped([] (future<result<>> f) {
-                auto print_exception = [] (const auto& ex) {
-                    slogger.error("Failed to remove mutations from batchlog: {}", ex);
-                };
-                if (f.failed()) {
-                    print_exception(f.get_exception());
-                } else if (result<> res = f.get(); !res) {
-                    print_exception(res.assume_error());
-                }
-            });
-        };
 
         future<result<>> run() {
             return _p.mutate_prepare(_mutations, _cl, db::write_type::BATCH, _trace_state, _permit).then([this] (unique_response_handler_vector ids) {
@@ -2523,7 +2996,10 @@ storage_proxy::mutate_atomically_result(std::vector<mutation> mutations, db::con
                     _p.register_cdc_operation_result_tracker(ids, _cdc_tracker);
                     return _p.mutate_begin(std::move(ids), _cl, _trace_state, _timeout);
                 })).then(utils::result_wrap([this] {
-                    return utils::then_ok_result<result<>>(async_remove_from_batchlog());
+                    tracing::trace(_trace_state, "Queueing a batchlog remove mutation");
+                    return _p._batchlog_removal_batcher->add(_batch_uuid, _batchlog_endpoints).then([] {
+                        return make_ready_future<result<>>(bo::success());
+                    });
                 }));
             });
         }
@@ -2850,6 +3326,7 @@ class abstract_read_resolver {
     timer<storage_proxy::clock_type> _timeout;
     schema_ptr _schema;
     size_t _failed = 0;
+    std::unordered_map<gms::inet_address, exceptions::request_failure_reason> _failure_reasons; // of the _failed replicas
 
     virtual void on_failure(std::exception_ptr ex) = 0;
     virtual void on_timeout() = 0;
@@ -2982,6 +3459,7 @@ class digest_read_resolver : public abstract_read_resolver {
     void on_error(gms::inet_address ep, bool disconnect) override {
         if (waiting_for(ep)) {
             _failed++;
+            _failure_reasons.emplace(ep, exceptions::request_failure_reason::unknown);
         }
         if (disconnect && _block_for == _target_count_for_cl) {
             // if the error is because of a connection disconnect and there is no targets to speculate
@@ -2990,7 +3468,9 @@ class digest_read_resolver : public abstract_read_resolver {
             return;
         }
         if (_block_for + _failed > _target_count_for_cl) {
-            fail_request(std::make_exception_ptr(read_failure_exception(_schema->ks_name(), _schema->cf_name(), _cl, _cl_responses, _failed, _block_for, _data_result)));
+            auto ex = read_failure_exception(_schema->ks_name(), _schema->cf_name(), _cl, _cl_responses, _failed, _block_for, _data_result);
+            ex.failure_reasons = _failure_reasons;
+            fail_request(std::make_exception_ptr(std::move(ex)));
         }
     }
     future<digest_read_result> has_cl() {
@@ -3304,7 +3784,9 @@ class data_read_resolver : public abstract_read_resolver {
         }
     }
     void on_error(gms::inet_address ep, bool disconnect) override {
-        fail_request(std::make_exception_ptr(read_failure_exception(_schema->ks_name(), _schema->cf_name(), _cl, response_count(), 1, _targets_count, response_count() != 0)));
+        auto ex = read_failure_exception(_schema->ks_name(), _schema->cf_name(), _cl, response_count(), 1, _targets_count, response_count() != 0);
+        ex.failure_reasons.emplace(ep, exceptions::request_failure_reason::unknown);
+        fail_request(std::make_exception_ptr(std::move(ex)));
     }
     uint32_t max_live_count() const {
         return _max_live_count;
@@ -3599,8 +4081,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_mutation_data_requests(lw_shared_ptr<query::read_command> cmd, data_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_replica_scorer.on_request(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
+                _proxy->_replica_scorer.on_response(ep, std::chrono::duration_cast<std::chrono::microseconds>(latency_clock::now() - start));
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<1>(v));
@@ -3617,8 +4101,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_replica_scorer.on_request(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
+                _proxy->_replica_scorer.on_response(ep, std::chrono::duration_cast<std::chrono::microseconds>(latency_clock::now() - start));
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<1>(v));
@@ -3636,8 +4122,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            _proxy->_replica_scorer.on_request(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> f) {
+                _proxy->_replica_scorer.on_response(ep, std::chrono::duration_cast<std::chrono::microseconds>(latency_clock::now() - start));
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<2>(v));
@@ -3692,11 +4180,18 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                         && !data_resolver->any_partition_short_read()) {
                     auto result = ::make_foreign(::make_lw_shared<query::result>(
                             to_data_query_result(std::move(*rr_opt), _schema, _cmd->slice, _cmd->get_row_limit(), cmd->partition_limit)));
+                    auto diffs = data_resolver->get_diffs_for_repair();
+                    if (!diffs.empty() && _proxy->_db.local().get_config().async_read_repair() && _proxy->_read_repair_batcher->add(diffs)) {
+                        tracing::trace(_trace_state, "Read repair deferred");
+                        _result_promise.set_value(std::move(result));
+                        on_read_resolved();
+                        return;
+                    }
                     // wait for write to complete before returning result to prevent multiple concurrent read requests to
                     // trigger repair multiple times and to prevent quorum read to return an old value, even after a quorum
                     // another read had returned a newer value (but the newer value had not yet been sent to the other replicas)
                     // Waited on indirectly.
-                    (void)_proxy->schedule_repair(data_resolver->get_diffs_for_repair(), _cl, _trace_state, _permit).then([this, result = std::move(result)] () mutable {
+                    (void)_proxy->schedule_repair(std::move(diffs), _cl, _trace_state, _permit).then([this, result = std::move(result)] () mutable {
                         _result_promise.set_value(std::move(result));
                         on_read_resolved();
                     }).handle_exception([this, exec] (std::exception_ptr eptr) {
@@ -3879,8 +4374,13 @@ class speculating_read_executor : public abstract_read_executor {
 public:
     using abstract_read_executor::abstract_read_executor;
     virtual void make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) override {
+        _proxy->_speculative_retry_budget.deposit();
         _speculate_timer.set_callback([this, resolver, timeout] {
             if (!resolver->is_completed()) { // at the time the callback runs request may be completed already
+                if (!_proxy->_speculative_retry_budget.try_withdraw()) {
+                    _proxy->get_stats().speculative_reads_over_budget++;
+                    return;
+                }
                 resolver->add_wait_targets(1); // we send one more request so wait for it too
                 // FIXME: consider disabling for CL=*ONE
                 auto send_request = [&] (bool has_data) {
@@ -3897,8 +4397,8 @@ class speculating_read_executor : public abstract_read_executor {
         });
         auto& sr = _schema->speculative_retry();
         auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
-            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
-            std::chrono::milliseconds(unsigned(sr.get_value()));
+            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::microseconds(std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2))) :
+            std::chrono::microseconds(std::chrono::milliseconds(unsigned(sr.get_value())));
         _speculate_timer.arm(t);
 
         // if CL + RR result in covering all replicas, getReadExecutor forces AlwaysSpeculating.  So we know
@@ -3963,10 +4463,20 @@ ::shared_ptr<abstract_read_executor> storage_proxy::get_read_executor(lw_shared_
     // orders the list by proximity to the local endpoint.
     is_read_non_local |= !all_replicas.empty() && all_replicas.front() != utils::fb_utilities::get_broadcast_address();
 
+    // Steer the read away from replicas which are slow right now. The
+    // result overrides heat-weighted load balancing, which would otherwise
+    // keep sending a share of the reads to them.
+    const auto& cfg = _db.local().get_config();
+    bool reordered = cfg.dynamic_snitch_badness_threshold() > 0
+            && _replica_scorer.sort(all_replicas, cfg.dynamic_snitch_badness_threshold(), std::chrono::milliseconds(cfg.dynamic_snitch_reset_interval_in_ms()));
+    if (reordered) {
+        tracing::trace(trace_state, "Replicas reordered by latency: {}", all_replicas);
+    }
+
     auto cf = _db.local().find_column_family(schema).shared_from_this();
     inet_address_vector_replica_set target_replicas = db::filter_for_query(cl, ks, all_replicas, preferred_endpoints, repair_decision,
             retry_type == speculative_retry::type::NONE ? nullptr : &extra_replica,
-            _db.local().get_config().cache_hit_rate_read_balancing() ? &*cf : nullptr);
+            cfg.cache_hit_rate_read_balancing() && !reordered ? &*cf : nullptr);
 
     slogger.trace("creating read executor for token {} with all: {} targets: {} rp decision: {}", token, all_replicas, target_replicas, repair_decision);
     tracing::trace(trace_state, "Creating read executor for token {} with all: {} targets: {} repair decision: {}", token, all_replicas, target_replicas, repair_decision);
@@ -4146,6 +4656,46 @@ storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd,
     co_return coordinator_query_result(std::move(result), std::move(used_replicas), repair_decision);
 }
 
+int storage_proxy::clamp_range_read_concurrency(uint64_t concurrency_factor) const {
+    // The concurrency may come from a client-supplied paging state, so it
+    // is always bounded, even if the operator didn't limit it.
+    uint64_t limit = std::numeric_limits<int>::max() / 2;
+    if (auto per_node = _db.local().get_config().max_range_read_concurrency_per_node()) {
+        limit = std::min(limit, uint64_t(per_node) * std::max(size_t(1), get_token_metadata_ptr()->count_normal_token_owners()));
+    }
+    return std::clamp(concurrency_factor, uint64_t(1), limit);
+}
+
+// A round of a range scan which used up more than a quarter of the time left
+// until the timeout means the replicas are overloaded.
+static bool range_read_round_was_slow(storage_proxy::clock_type::time_point round_start, storage_proxy::clock_type::time_point timeout) {
+    auto elapsed = storage_proxy::clock_type::now() - round_start;
+    return elapsed * 4 > timeout - round_start;
+}
+
+// Returns the number of vnode ranges the next round of a range scan reads
+// concurrently. It doubles as long as rounds don't return enough rows, unless
+// the replicas are overloaded, which halves it instead.
+int storage_proxy::next_range_read_concurrency(int concurrency_factor, clock_type::time_point round_start, clock_type::time_point timeout) {
+    if (range_read_round_was_slow(round_start, timeout)) {
+        get_stats().range_reads_concurrency_reduced++;
+        return clamp_range_read_concurrency(concurrency_factor / 2);
+    }
+    return clamp_range_read_concurrency(uint64_t(concurrency_factor) * 2);
+}
+
+uint64_t storage_proxy::range_read_concurrency_for_next_page(int concurrency_factor,
+        uint64_t rows_needed, uint64_t rows_returned, uint64_t partitions_needed, uint64_t partitions_returned) {
+    auto needed_share = [concurrency_factor] (uint64_t needed, uint64_t returned) -> uint64_t {
+        if (returned <= needed) {
+            return concurrency_factor;
+        }
+        return (uint64_t(concurrency_factor) * needed + returned - 1) / returned;
+    };
+    // Reaching either limit fills the page.
+    return std::min(needed_share(rows_needed, rows_returned), needed_share(partitions_needed, partitions_returned));
+}
+
 future<query_partition_key_range_concurrent_result>
 storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::time_point timeout,
         std::vector<foreign_ptr<lw_shared_ptr<query::result>>>&& results,
@@ -4185,6 +4735,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
     // eventualy zero out resulting in an infinite recursion. This line makes sure that concurrency factor is never
     // get stuck on 0 and never increased too much if the number of results remains small.
     concurrency_factor = std::max(size_t(1), ranges.size());
+    const auto round_start = clock_type::now();
 
     while (i != ranges.end()) {
         dht::partition_range& range = *i;
@@ -4309,6 +4860,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
             cl,
             cmd,
             concurrency_factor,
+            round_start,
             timeout,
             remaining_row_count,
             remaining_partition_count,
@@ -4317,8 +4869,12 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
             ranges_per_exec = std::move(ranges_per_exec),
             permit = std::move(permit)] (foreign_ptr<lw_shared_ptr<query::result>>&& result) mutable {
         result->ensure_counts();
-        remaining_row_count -= result->row_count().value();
-        remaining_partition_count -= result->partition_count().value();
+        const auto rows_needed = remaining_row_count;
+        const auto partitions_needed = remaining_partition_count;
+        const auto rows_returned = result->row_count().value();
+        const auto partitions_returned = result->partition_count().value();
+        remaining_row_count -= rows_returned;
+        remaining_partition_count -= partitions_returned;
         results.emplace_back(std::move(result));
         if (ranges_to_vnodes.empty() || !remaining_row_count || !remaining_partition_count) {
             auto used_replicas = replicas_per_token_range();
@@ -4333,12 +4889,24 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
                     used_replicas.emplace(std::move(r), replica_ids);
                 }
             }
-            return make_ready_future<query_partition_key_range_concurrent_result>(query_partition_key_range_concurrent_result{std::move(results), std::move(used_replicas)});
+            // The page is full. Let the next page start with the concurrency
+            // which would have just filled it, which shrinks when this round
+            // read more ranges than needed, and halve it if the replicas
+            // were slow to respond.
+            auto next_concurrency = range_read_concurrency_for_next_page(concurrency_factor,
+                    rows_needed, rows_returned, partitions_needed, partitions_returned);
+            if (range_read_round_was_slow(round_start, timeout)) {
+                p->get_stats().range_reads_concurrency_reduced++;
+                next_concurrency /= 2;
+            }
+            return make_ready_future<query_partition_key_range_concurrent_result>(query_partition_key_range_concurrent_result{std::move(results), std::move(used_replicas),
+                    uint32_t(p->clamp_range_read_concurrency(next_concurrency))});
         } else {
             cmd->set_row_limit(remaining_row_count);
             cmd->partition_limit = remaining_partition_count;
             return p->query_partition_key_range_concurrent(timeout, std::move(results), cmd, cl, std::move(ranges_to_vnodes),
-                    concurrency_factor * 2, std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
+                    p->next_range_read_concurrency(concurrency_factor, round_start, timeout),
+                    std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
         }
     }).handle_exception([p] (std::exception_ptr eptr) {
         p->handle_read_error(eptr, true);
@@ -4359,7 +4927,8 @@ storage_proxy::query_partition_key_range(lw_shared_ptr<query::read_command> cmd,
     query_ranges_to_vnodes_generator ranges_to_vnodes(get_token_metadata_ptr(), schema, std::move(partition_ranges), ks.get_replication_strategy().get_type() == locator::replication_strategy_type::local);
 
     int result_rows_per_range = 0;
-    int concurrency_factor = 1;
+    // Continue a paged scan with the concurrency its previous page ended up with.
+    int concurrency_factor = query_options.range_read_concurrency ? clamp_range_read_concurrency(query_options.range_read_concurrency) : 1;
 
     std::vector<foreign_ptr<lw_shared_ptr<query::result>>> results;
 
@@ -4401,7 +4970,9 @@ storage_proxy::query_partition_key_range(lw_shared_ptr<query::read_command> cmd,
             merger(std::move(r));
         }
 
-        return make_ready_future<coordinator_query_result>(coordinator_query_result(merger.get(), std::move(used_replicas)));
+        coordinator_query_result ret(merger.get(), std::move(used_replicas));
+        ret.range_read_concurrency = result.concurrency_factor;
+        return make_ready_future<coordinator_query_result>(std::move(ret));
     });
 }
 
@@ -4412,6 +4983,11 @@ storage_proxy::query(schema_ptr s,
     db::consistency_level cl,
     storage_proxy::coordinator_query_options query_options)
 {
+    // The replicas read with the I/O class of the user's service level.
+    cmd->service_level = query_options.cstate.get_service_level_name();
+    const auto& sl_shares = query_options.cstate.get_service_level_options().shares;
+    cmd->service_level_shares = std::holds_alternative<int32_t>(sl_shares) ? std::get<int32_t>(sl_shares) : 0;
+
     if (slogger.is_enabled(logging::log_level::trace) || qlogger.is_enabled(logging::log_level::trace)) {
         static thread_local int next_id = 0;
         auto query_id = next_id++;
@@ -4543,7 +5119,9 @@ static read_timeout_exception write_timeout_to_read(schema_ptr s, mutation_write
 }
 
 static read_failure_exception write_failure_to_read(schema_ptr s, mutation_write_failure_exception& ex) {
-    return read_failure_exception(s->ks_name(), s->cf_name(), ex.consistency, ex.received, ex.failures, ex.block_for, false);
+    auto ret = read_failure_exception(s->ks_name(), s->cf_name(), ex.consistency, ex.received, ex.failures, ex.block_for, false);
+    ret.failure_reasons = ex.failure_reasons;
+    return ret;
 }
 
 static mutation_write_timeout_exception read_timeout_to_write(schema_ptr s, read_timeout_exception& ex) {
@@ -4551,7 +5129,9 @@ static mutation_write_timeout_exception read_timeout_to_write(schema_ptr s, read
 }
 
 static mutation_write_failure_exception read_failure_to_write(schema_ptr s, read_failure_exception& ex) {
-    return mutation_write_failure_exception(s->ks_name(), s->cf_name(), ex.consistency, ex.received, ex.failures, ex.block_for, db::write_type::CAS);
+    auto ret = mutation_write_failure_exception(s->ks_name(), s->cf_name(), ex.consistency, ex.received, ex.failures, ex.block_for, db::write_type::CAS);
+    ret.failure_reasons = ex.failure_reasons;
+    return ret;
 }
 
 /**
@@ -4696,7 +5276,30 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
             auto proposal = make_lw_shared<paxos::proposal>(ballot, freeze(*mutation));
 
             bool is_accepted = co_await handler->accept_proposal(proposal);
-            if (is_accepted) {
+            if (is_accepted && contentions == 0 && _db.local().get_config().enable_lwt_background_learn()
+                    && !_background_learn_gate.is_closed()) {
+                // A quorum has accepted the proposal, so it is chosen: any later
+                // Paxos round on this key will find it in system.paxos and finish
+                // it before proceeding. Without contention, let the learn round
+                // complete in the background and answer the client now. The key
+                // stays locked on this shard until the learn is done, so the next
+                // CAS from this coordinator doesn't have to repair it.
+                paxos::paxos_state::logger.debug("CAS[{}] successful, learning {} in the background", handler->id(), proposal->ballot);
+                tracing::trace(handler->tr_state, "CAS successful, learning the decision in the background");
+                ++get_stats().cas_background_learn;
+                (void)with_gate(_background_learn_gate, [handler, proposal = std::move(proposal)] () mutable {
+                    return handler->learn_decision(std::move(proposal));
+                }).then_wrapped([handler, l = std::move(l)] (future<> f) {
+                    if (f.failed()) {
+                        // The decision is still chosen, the next Paxos round on
+                        // the key will commit it.
+                        auto ex = f.get_exception();
+                        tracing::trace(handler->tr_state, "background learn failed: {}", ex);
+                        paxos::paxos_state::logger.warn("CAS[{}] background learn failed: {}", handler->id(), ex);
+                    }
+                });
+                break;
+            } else if (is_accepted) {
                 // The majority (aka a QUORUM) has promised the coordinator to
                 // accept the action associated with the computed ballot.
                 // Apply the mutation.
@@ -4778,9 +5381,22 @@ void storage_proxy::sort_endpoints_by_proximity(inet_address_vector_replica_set&
 inet_address_vector_replica_set storage_proxy::get_live_sorted_endpoints(replica::keyspace& ks, const dht::token& token) const {
     auto eps = get_live_endpoints(ks, token);
     sort_endpoints_by_proximity(eps);
+    // Replicas which stopped answering pings are only read from when the
+    // others don't suffice, until gossip decides whether they are down.
+    if (_direct_fd) {
+        demote_suspected_replicas(eps, [this] (gms::inet_address ep) {
+            return _direct_fd->is_suspected(ep);
+        });
+    }
     return eps;
 }
 
+void storage_proxy::demote_suspected_replicas(inet_address_vector_replica_set& eps, const std::function<bool (gms::inet_address)>& is_suspected) {
+    std::stable_partition(eps.begin(), eps.end(), [&] (gms::inet_address ep) {
+        return !is_suspected(ep);
+    });
+}
+
 inet_address_vector_replica_set storage_proxy::intersection(const inet_address_vector_replica_set& l1, const inet_address_vector_replica_set& l2) {
     inet_address_vector_replica_set inter;
     inter.reserve(l1.size());
@@ -4835,6 +5451,11 @@ future<> storage_proxy::truncate_blocking(sstring keyspace, sstring cfname) {
 
 void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
     auto& ms = _messaging;
+    ser::storage_proxy_rpc_verbs::register_remove_from_batchlog(&ms, [this] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<utils::UUID> ids, api::timestamp_type timestamp) {
+        return do_with(std::move(ids), [this, timestamp, timeout = *t] (const std::vector<utils::UUID>& ids) {
+            return batchlog_removal_batcher::apply_locally(*this, ids, timestamp, timeout);
+        });
+    });
     ser::storage_proxy_rpc_verbs::register_counter_mutation(&ms, [&ms, mm] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<frozen_mutation> fms, db::consistency_level cl, std::optional<tracing::trace_info> trace_info) {
         auto src_addr = netw::messaging_service::get_source(cinfo);
 
@@ -4896,18 +5517,14 @@ void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
                                          .then([&m, &p, timeout, apply_fn = std::move(apply_fn), trace_state_ptr] (schema_ptr s) mutable {
                         return apply_fn(p, trace_state_ptr, std::move(s), m, timeout);
                     });
-                }).then([&p, reply_to, shard, response_id, trace_state_ptr] () {
+                }).then([&p, reply_to, shard, response_id, trace_state_ptr, timeout] () {
                     // We wait for send_mutation_done to complete, otherwise, if reply_to is busy, we will accumulate
                     // lots of unsent responses, which can OOM our shard.
                     //
                     // Usually we will return immediately, since this work only involves appending data to the connection
                     // send buffer.
                     tracing::trace(trace_state_ptr, "Sending mutation_done to /{}", reply_to);
-                    return ser::storage_proxy_rpc_verbs::send_mutation_done(&p->_messaging,
-                            netw::messaging_service::msg_addr{reply_to, shard},
-                            shard,
-                            response_id,
-                            p->get_view_update_backlog()).then_wrapped([] (future<> f) {
+                    return p->send_mutation_done(netw::messaging_service::msg_addr{reply_to, shard}, response_id, timeout).then_wrapped([] (future<> f) {
                         f.ignore_ready_future();
                     });
                 }).handle_exception([reply_to, shard, &p, &errors] (std::exception_ptr eptr) {
@@ -5004,6 +5621,16 @@ void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
             return netw::messaging_service::no_wait();
         });
     });
+    ser::storage_proxy_rpc_verbs::register_mutation_done_batch(&ms, [this] (const rpc::client_info& cinfo, unsigned shard, std::vector<storage_proxy::response_id_type> response_ids, db::view::update_backlog backlog) {
+        auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        get_stats().replica_cross_shard_ops += shard != this_shard_id();
+        return container().invoke_on(shard, _write_ack_smp_service_group, [from, response_ids = std::move(response_ids), backlog] (storage_proxy& sp) {
+            for (auto response_id : response_ids) {
+                sp.got_response(response_id, from, backlog);
+            }
+            return netw::messaging_service::no_wait();
+        });
+    });
     ser::storage_proxy_rpc_verbs::register_mutation_failed(&ms, [this] (const rpc::client_info& cinfo, unsigned shard, storage_proxy::response_id_type response_id, size_t num_failed, rpc::optional<db::view::update_backlog> backlog) {
         auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         get_stats().replica_cross_shard_ops += shard != this_shard_id();
@@ -5217,6 +5844,7 @@ void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
 }
 
 future<> storage_proxy::uninit_messaging_service() {
+    _write_ack_batcher->flush();
     auto& ms = _messaging;
     return ser::storage_proxy_rpc_verbs::unregister(&ms);
 }
@@ -5412,6 +6040,7 @@ void storage_proxy::on_join_cluster(const gms::inet_address& endpoint) {};
 void storage_proxy::on_leave_cluster(const gms::inet_address& endpoint) {
     _hints_manager.drain_for(endpoint);
     _hints_for_views_manager.drain_for(endpoint);
+    _replica_scorer.remove(endpoint);
 }
 
 void storage_proxy::on_up(const gms::inet_address& endpoint) {};
@@ -5443,6 +6072,10 @@ future<> storage_proxy::drain_on_shutdown() {
     //NOTE: the thread is spawned here because there are delicate lifetime issues to consider
     // and writing them down with plain futures is error-prone.
     return async([this] {
+        _read_repair_batcher->flush();
+        _batchlog_removal_batcher->flush();
+        _view_update_coalescer->stop().get();
+        _background_learn_gate.close().get();
         retire_view_response_handlers([] (const abstract_write_response_handler&) { return true; });
         _hints_resource_manager.stop().get();
     });
@@ -42,7 +42,10 @@
 #include "db/hints/host_filter.hh"
 #include "utils/small_vector.hh"
 #include "service/endpoint_lifecycle_subscriber.hh"
+#include "service/replica_scorer.hh"
+#include "service/speculative_retry_budget.hh"
 #include <seastar/core/circular_buffer.hh>
+#include <seastar/core/gate.hh>
 #include "query_ranges_to_vnodes.hh"
 #include "exceptions/exceptions.hh"
 
@@ -67,8 +70,13 @@ namespace cdc {
     class cdc_service;    
 }
 
+namespace db::view {
+class view_update_coalescer;
+}
+
 namespace gms {
 class gossiper;
+class direct_failure_detector;
 class feature_service;
 }
 
@@ -91,6 +99,8 @@ using replicas_per_token_range = std::unordered_map<dht::token_range, std::vecto
 struct query_partition_key_range_concurrent_result {
     std::vector<foreign_ptr<lw_shared_ptr<query::result>>> result;
     replicas_per_token_range replicas;
+    // The concurrency the next round would have used.
+    uint32_t concurrency_factor = 1;
 };
 
 struct view_update_backlog_timestamped {
@@ -105,6 +115,9 @@ struct storage_proxy_coordinator_query_result {
     foreign_ptr<lw_shared_ptr<query::result>> query_result;
     replicas_per_token_range last_replicas;
     db::read_repair_decision read_repair_decision;
+    // For range scans, the number of vnode ranges the next page should start
+    // reading concurrently.
+    uint32_t range_read_concurrency = 0;
 
     storage_proxy_coordinator_query_result(foreign_ptr<lw_shared_ptr<query::result>> query_result,
             replicas_per_token_range last_replicas = {},
@@ -174,19 +187,23 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         tracing::trace_state_ptr trace_state = nullptr;
         replicas_per_token_range preferred_replicas;
         std::optional<db::read_repair_decision> read_repair_decision;
+        // The concurrency a range scan should start with, 0 if unknown.
+        uint32_t range_read_concurrency;
 
         coordinator_query_options(clock_type::time_point timeout,
                 service_permit permit_,
                 client_state& client_state_,
                 tracing::trace_state_ptr trace_state = nullptr,
                 replicas_per_token_range preferred_replicas = { },
-                std::optional<db::read_repair_decision> read_repair_decision = { })
+                std::optional<db::read_repair_decision> read_repair_decision = { },
+                uint32_t range_read_concurrency = 0)
             : _timeout(timeout)
             , permit(std::move(permit_))
             , cstate(client_state_)
             , trace_state(std::move(trace_state))
             , preferred_replicas(std::move(preferred_replicas))
-            , read_repair_decision(read_repair_decision) {
+            , read_repair_decision(read_repair_decision)
+            , range_read_concurrency(range_read_concurrency) {
         }
 
         clock_type::time_point timeout(storage_proxy& sp) const {
@@ -223,6 +240,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
 private:
     distributed<replica::database>& _db;
     gms::gossiper& _gossiper;
+    // Reads avoid the replicas it suspects, when set.
+    const gms::direct_failure_detector* _direct_fd = nullptr;
     const locator::shared_token_metadata& _shared_token_metadata;
     locator::effective_replication_map_factory& _erm_factory;
     smp_service_group _read_smp_service_group;
@@ -267,11 +286,32 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     netw::connection_drop_registration_t _condrop_registration;
     db::view::node_update_backlog& _max_view_update_backlog;
     std::unordered_map<gms::inet_address, view_update_backlog_timestamped> _view_update_backlogs;
+    // Scores replicas by their recent read latency, see dynamic_snitch_badness_threshold.
+    replica_scorer _replica_scorer;
+    speculative_retry_budget _speculative_retry_budget;
 
     //NOTICE(sarna): This opaque pointer is here just to avoid moving write handler class definitions from .cc to .hh. It's slow path.
     class view_update_handlers_list;
     std::unique_ptr<view_update_handlers_list> _view_update_handlers_list;
 
+    class cross_shard_write_batcher;
+    std::unique_ptr<cross_shard_write_batcher> _cross_shard_write_batcher;
+
+    class write_ack_batcher;
+    std::unique_ptr<write_ack_batcher> _write_ack_batcher;
+
+    class read_repair_batcher;
+    std::unique_ptr<read_repair_batcher> _read_repair_batcher;
+
+    class batchlog_removal_batcher;
+    std::unique_ptr<batchlog_removal_batcher> _batchlog_removal_batcher;
+
+    std::unique_ptr<db::view::view_update_coalescer> _view_update_coalescer;
+
+    // Learn rounds of CAS operations completed in the background, see
+    // enable_lwt_background_learn.
+    seastar::gate _background_learn_gate;
+
     /* This is a pointer to the shard-local part of the sharded cdc_service:
      * storage_proxy needs access to cdc_service to augument mutations.
      *
@@ -298,6 +338,7 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     void remove_response_handler(response_id_type id);
     void remove_response_handler_entry(response_handlers_map::iterator entry);
     void got_response(response_id_type id, gms::inet_address from, std::optional<db::view::update_backlog> backlog);
+    future<> send_mutation_done(netw::msg_addr reply_to, response_id_type response_id, clock_type::time_point timeout);
     void got_failure_response(response_id_type id, gms::inet_address from, size_t count, std::optional<db::view::update_backlog> backlog, error err, std::optional<sstring> msg);
     future<result<>> response_wait(response_id_type id, clock_type::time_point timeout);
     ::shared_ptr<abstract_write_response_handler>& get_write_response_handler(storage_proxy::response_id_type id);
@@ -348,6 +389,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             db::consistency_level cl,
             coordinator_query_options optional_params);
     static inet_address_vector_replica_set intersection(const inet_address_vector_replica_set& l1, const inet_address_vector_replica_set& l2);
+    int clamp_range_read_concurrency(uint64_t concurrency_factor) const;
+    int next_range_read_concurrency(int concurrency_factor, clock_type::time_point round_start, clock_type::time_point timeout);
     future<query_partition_key_range_concurrent_result> query_partition_key_range_concurrent(clock_type::time_point timeout,
             std::vector<foreign_ptr<lw_shared_ptr<query::result>>>&& results,
             lw_shared_ptr<query::read_command> cmd,
@@ -463,6 +506,19 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     void init_messaging_service(shared_ptr<migration_manager>);
     future<> uninit_messaging_service();
 
+    // Returns the number of vnode ranges the next page of a range scan should
+    // start reading concurrently, given the concurrency of the round which
+    // filled the current page, and the rows and partitions that round needed
+    // and returned. Assuming they are spread evenly over the ranges, that's
+    // the number of ranges which would have just filled the page.
+    static uint64_t range_read_concurrency_for_next_page(int concurrency_factor,
+            uint64_t rows_needed, uint64_t rows_returned, uint64_t partitions_needed, uint64_t partitions_returned);
+
+    // Moves the replicas which is_suspected returns true for to the end of
+    // eps, keeping the order of the others, so that reads only use them when
+    // the others don't suffice.
+    static void demote_suspected_replicas(inet_address_vector_replica_set& eps, const std::function<bool (gms::inet_address)>& is_suspected);
+
 private:
     // Applies mutation on this node.
     // Resolves with timed_out_error when timeout is reached.
@@ -483,9 +539,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     }
     // Applies mutation on this node.
     // Resolves with timed_out_error when timeout is reached.
-    future<> mutate_locally(const schema_ptr& s, const frozen_mutation& m, tracing::trace_state_ptr tr_state, db::commitlog::force_sync sync, clock_type::time_point timeout = clock_type::time_point::max()) {
-        return mutate_locally(s, m, tr_state, sync, timeout, _write_smp_service_group);
-    }
+    // The mutation must be kept alive until the returned future resolves.
+    // Mutations applied on other shards by the same task are sent to each shard together.
+    future<> mutate_locally(const schema_ptr& s, const frozen_mutation& m, tracing::trace_state_ptr tr_state, db::commitlog::force_sync sync, clock_type::time_point timeout = clock_type::time_point::max());
     // Applies mutations on this node.
     // Resolves with timed_out_error when timeout is reached.
     future<> mutate_locally(std::vector<mutation> mutation, tracing::trace_state_ptr tr_state, clock_type::time_point timeout = clock_type::time_point::max());
@@ -550,6 +606,10 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<> send_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target, inet_address_vector_topology_change pending_endpoints, db::write_type type,
             tracing::trace_state_ptr tr_state, allow_hints allow_hints = allow_hints::yes);
 
+    db::view::view_update_coalescer& get_view_update_coalescer() noexcept {
+        return *_view_update_coalescer;
+    }
+
     // Send a mutation to a specific remote target as a hint.
     // Unlike regular mutations during write operations, hints are sent on the streaming connection
     // and use different RPC verb.
@@ -609,6 +669,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<> stop();
     future<> start_hints_manager();
     void allow_replaying_hints() noexcept;
+    void set_direct_failure_detector(const gms::direct_failure_detector* fd) noexcept {
+        _direct_fd = fd;
+    }
     future<> drain_on_shutdown();
 
     future<> change_hints_host_filter(db::hints::host_filter new_filter);
@@ -104,6 +104,7 @@ struct write_stats {
     uint64_t cas_write_condition_not_met = 0;
     uint64_t cas_write_timeout_due_to_uncertainty = 0;
     uint64_t cas_failed_read_round_optimization = 0;
+    uint64_t cas_background_learn = 0;
     uint16_t cas_now_pruning = 0;
     uint64_t cas_prune = 0;
     uint64_t cas_coordinator_dropped_prune = 0;
@@ -137,6 +138,11 @@ struct stats : public write_stats {
     uint64_t read_repair_repaired_blocking = 0;
     uint64_t read_repair_repaired_background = 0;
     uint64_t global_read_repairs_canceled_due_to_concurrent_write = 0;
+    // Read repairs which weren't waited for, see async_read_repair.
+    uint64_t deferred_read_repairs = 0;
+    uint64_t read_repairs_over_budget = 0;
+    uint64_t read_repair_batches = 0;
+    uint64_t dropped_read_repairs = 0;
 
     // number of mutations received as a coordinator
     uint64_t received_mutations = 0;
@@ -154,6 +160,8 @@ struct stats : public write_stats {
     uint64_t replica_mutation_data_reads = 0;
 
     uint64_t replica_cross_shard_ops = 0;
+    uint64_t replica_cross_shard_write_batches = 0;
+    uint64_t replica_write_ack_batches = 0;
 
     utils::timed_rate_moving_average_and_histogram read;
     utils::timed_rate_moving_average_and_histogram range;
@@ -168,6 +176,8 @@ struct stats : public write_stats {
     uint64_t read_retries = 0; // read is retried with new limit
     uint64_t speculative_digest_reads = 0;
     uint64_t speculative_data_reads = 0;
+    uint64_t speculative_reads_over_budget = 0; // speculative read not sent because of the retry budget
+    uint64_t range_reads_concurrency_reduced = 0; // range scan backed off because replicas were slow
 
     uint64_t cas_read_unfinished_commit = 0;
     uint64_t cas_foreground = 0;
@@ -214,6 +224,11 @@ struct global_write_stats {
  *  Following the convention of stats and write_stats
  */
 struct global_stats : public global_write_stats {
+    // Removals of logged batches from the batchlog, which are sent in the
+    // background for all scheduling groups, see storage_proxy::batchlog_removal_batcher.
+    uint64_t batchlog_removal_batches = 0;
+    uint64_t failed_batchlog_removals = 0;
+
     void register_stats();
 };
 
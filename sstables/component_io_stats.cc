@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/file.hh>
+
+#include "sstables/component_io_stats.hh"
+
+namespace sstables {
+
+std::string_view component_io_stats::name(component c) {
+    switch (c) {
+    case component::data: return "Data";
+    case component::index: return "Index";
+    case component::summary: return "Summary";
+    case component::filter: return "Filter";
+    }
+    abort();
+}
+
+class io_stats_file_impl : public file_impl {
+    file _file;
+    lw_shared_ptr<component_io_stats> _stats;
+    component_io_stats::counters& _counters;
+
+    void account(size_t bytes) noexcept {
+        ++_counters.read_ops;
+        _counters.bytes_read += bytes;
+    }
+public:
+    io_stats_file_impl(file f, lw_shared_ptr<component_io_stats> stats, component_io_stats::counters& c)
+        : file_impl(*get_file_impl(f))
+        , _file(std::move(f))
+        , _stats(std::move(stats))
+        , _counters(c) {
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override {
+        return get_file_impl(_file)->write_dma(pos, buffer, len, pc);
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return get_file_impl(_file)->write_dma(pos, std::move(iov), pc);
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
+        return get_file_impl(_file)->read_dma(pos, buffer, len, pc).then([this] (size_t read) {
+            account(read);
+            return read;
+        });
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return get_file_impl(_file)->read_dma(pos, std::move(iov), pc).then([this] (size_t read) {
+            account(read);
+            return read;
+        });
+    }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
+        return get_file_impl(_file)->dma_read_bulk(offset, range_size, pc).then([this] (temporary_buffer<uint8_t> buf) {
+            account(buf.size());
+            return buf;
+        });
+    }
+
+    virtual future<> flush(void) override {
+        return get_file_impl(_file)->flush();
+    }
+
+    virtual future<struct stat> stat(void) override {
+        return get_file_impl(_file)->stat();
+    }
+
+    virtual future<> truncate(uint64_t length) override {
+        return get_file_impl(_file)->truncate(length);
+    }
+
+    virtual future<> discard(uint64_t offset, uint64_t length) override {
+        return get_file_impl(_file)->discard(offset, length);
+    }
+
+    virtual future<> allocate(uint64_t position, uint64_t length) override {
+        return get_file_impl(_file)->allocate(position, length);
+    }
+
+    virtual future<uint64_t> size(void) override {
+        return get_file_impl(_file)->size();
+    }
+
+    virtual future<> close() override {
+        return get_file_impl(_file)->close();
+    }
+
+    virtual std::unique_ptr<seastar::file_handle_impl> dup() override {
+        return get_file_impl(_file)->dup();
+    }
+
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override {
+        return get_file_impl(_file)->list_directory(std::move(next));
+    }
+};
+
+file make_io_stats_file(file f, lw_shared_ptr<component_io_stats> stats, component_io_stats::counters& c) {
+    return file(make_shared<io_stats_file_impl>(std::move(f), std::move(stats), c));
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <seastar/core/file.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include "seastarx.hh"
+
+namespace sstables {
+
+/// The reads of the components of the sstables of a table, on this shard.
+///
+/// Counted by the file wrapper made by make_io_stats_file(), which the
+/// sstables install when they open their components.
+struct component_io_stats {
+    enum class component { data, index, summary, filter };
+    static constexpr size_t nr_components = size_t(component::filter) + 1;
+
+    struct counters {
+        uint64_t read_ops = 0;
+        uint64_t bytes_read = 0;
+
+        counters& operator+=(const counters& o) noexcept {
+            read_ops += o.read_ops;
+            bytes_read += o.bytes_read;
+            return *this;
+        }
+    };
+
+    // The reads which reached the files of the components. For the index,
+    // these are the misses of the index page cache (cached_file).
+    std::array<counters, nr_components> disk;
+    // The reads of the index, before the index page cache.
+    counters index_cache_requests;
+
+    counters& operator[](component c) noexcept {
+        return disk[size_t(c)];
+    }
+    const counters& operator[](component c) const noexcept {
+        return disk[size_t(c)];
+    }
+
+    component_io_stats& operator+=(const component_io_stats& o) noexcept {
+        for (size_t i = 0; i < nr_components; ++i) {
+            disk[i] += o.disk[i];
+        }
+        index_cache_requests += o.index_cache_requests;
+        return *this;
+    }
+
+    static std::string_view name(component c);
+};
+
+/// Counts the reads of \p f into \p c, which belongs to \p stats.
+file make_io_stats_file(file f, lw_shared_ptr<component_io_stats> stats, component_io_stats::counters& c);
+
+}
@@ -21,6 +21,7 @@
 #include "unimplemented.hh"
 #include "segmented_compress_params.hh"
 #include "utils/class_registrator.hh"
+#include "utils/alien_worker.hh"
 
 namespace sstables {
 
@@ -268,7 +269,11 @@ local_compression::local_compression(const compression& c)
             return std::nullopt;
         });
     }())
-{}
+{
+    if (_compressor && c.dictionary) {
+        _compressor = _compressor->with_dictionary(c.dictionary);
+    }
+}
 
 size_t local_compression::uncompress(const char* input,
                 size_t input_len, char* output, size_t output_len) const {
@@ -344,7 +349,7 @@ class compressed_file_data_source_impl : public data_source_impl {
     uint64_t _end_pos;
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
-                uint64_t pos, size_t len, file_input_stream_options options)
+                uint64_t pos, size_t len, file_input_stream_options options, std::optional<read_ahead_policy> read_ahead)
             : _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_accessor())
             , _compression(*cm)
@@ -368,10 +373,13 @@ class compressed_file_data_source_impl : public data_source_impl {
         // and open a file_input_stream to read that range.
         auto start = _compression_metadata->locate(_beg_pos, _offsets);
         auto end = _compression_metadata->locate(_end_pos - 1, _offsets);
-        _input_stream = make_file_input_stream(std::move(f),
-                start.chunk_start,
-                end.chunk_start + end.chunk_len - start.chunk_start,
-                std::move(options));
+        auto underlying_len = end.chunk_start + end.chunk_len - start.chunk_start;
+        if (read_ahead) {
+            _input_stream = make_adaptive_file_input_stream(std::move(f), start.chunk_start, underlying_len,
+                    options.buffer_size, options.io_priority_class, *read_ahead);
+        } else {
+            _input_stream = make_file_input_stream(std::move(f), start.chunk_start, underlying_len, std::move(options));
+        }
         _underlying_pos = start.chunk_start;
         _pos = _beg_pos;
     }
@@ -444,9 +452,9 @@ requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source : public data_source {
 public:
     compressed_file_data_source(file f, sstables::compression* cm,
-            uint64_t offset, size_t len, file_input_stream_options options)
+            uint64_t offset, size_t len, file_input_stream_options options, std::optional<read_ahead_policy> read_ahead)
         : data_source(std::make_unique<compressed_file_data_source_impl<ChecksumType>>(
-                std::move(f), cm, offset, len, std::move(options)))
+                std::move(f), cm, offset, len, std::move(options), read_ahead))
         {}
 };
 
@@ -454,10 +462,10 @@ template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 inline input_stream<char> make_compressed_file_input_stream(
         file f, sstables::compression *cm, uint64_t offset, size_t len,
-        file_input_stream_options options)
+        file_input_stream_options options, std::optional<read_ahead_policy> read_ahead)
 {
     return input_stream<char>(compressed_file_data_source<ChecksumType>(
-            std::move(f), cm, offset, len, std::move(options)));
+            std::move(f), cm, offset, len, std::move(options), read_ahead));
 }
 
 // For SSTables 2.x (formats 'ka' and 'la'), the full checksum is a combination of checksums of compressed chunks.
@@ -474,23 +482,72 @@ enum class compressed_checksum_mode {
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink_impl : public data_sink_impl {
+    // Dictionaries are trained, on _trainer, from the first chunks of the
+    // file, which are held back until dictionary_sample_size bytes are
+    // collected (or the file ends).
+    static constexpr size_t dictionary_max_size = 32 * 1024;
+    static constexpr size_t dictionary_sample_size = 256 * 1024;
+
     output_stream<char> _out;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::writer _offsets;
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    utils::alien_worker* _trainer;
+    bool _training;
+    std::vector<temporary_buffer<char>> _samples;
+    size_t _sampled = 0;
+private:
+    future<> finish_training() {
+        _training = false;
+        std::vector<bytes_view> samples;
+        samples.reserve(_samples.size());
+        for (auto& b : _samples) {
+            samples.emplace_back(reinterpret_cast<const int8_t*>(b.get()), b.size());
+        }
+        // The samples stay alive, and on this shard, until training is done.
+        return do_with(std::move(samples), [this] (const std::vector<bytes_view>& samples) {
+            return _trainer->submit<bytes>([&samples] {
+                return compressor::train_dictionary(samples, dictionary_max_size);
+            });
+        }).then([this] (bytes raw) {
+            if (!raw.empty()) {
+                auto dict = _compression.compressor()->prepare_dictionary(std::move(raw));
+                _compression = sstables::local_compression(_compression.compressor()->with_dictionary(dict));
+                _compression_metadata->dictionary = std::move(dict);
+            }
+            return do_with(std::exchange(_samples, {}), [this] (std::vector<temporary_buffer<char>>& samples) {
+                return do_for_each(samples, [this] (temporary_buffer<char>& buf) {
+                    return compress_and_write(std::move(buf));
+                });
+            });
+        });
+    }
 public:
-    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc, utils::alien_worker* dictionary_trainer)
             : _out(std::move(out))
             , _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
+            , _trainer(dictionary_trainer)
+            , _training(_trainer && _compression.compressor()->supports_dictionaries())
     {}
 
     virtual future<> put(net::packet data) override { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_training) {
+            _sampled += buf.size();
+            _samples.push_back(std::move(buf));
+            if (_sampled < dictionary_sample_size) {
+                return make_ready_future<>();
+            }
+            return finish_training();
+        }
+        return compress_and_write(std::move(buf));
+    }
+    future<> compress_and_write(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -531,7 +588,10 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         return f.then([compressed = std::move(compressed)] {});
     }
     virtual future<> close() override {
-        return _out.close();
+        auto f = _training ? finish_training() : make_ready_future<>();
+        return f.finally([this] {
+            return _out.close();
+        });
     }
 
     virtual size_t buffer_size() const noexcept override {
@@ -543,16 +603,17 @@ template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink : public data_sink {
 public:
-    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc, utils::alien_worker* dictionary_trainer)
         : data_sink(std::make_unique<compressed_file_data_sink_impl<ChecksumType, mode>>(
-                std::move(out), cm, std::move(lc))) {}
+                std::move(out), cm, std::move(lc), dictionary_trainer)) {}
 };
 
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 inline output_stream<char> make_compressed_file_output_stream(output_stream<char> out,
          sstables::compression* cm,
-         const compression_parameters& cp) {
+         const compression_parameters& cp,
+         utils::alien_worker* dictionary_trainer) {
     // buffer of output stream is set to chunk length, because flush must
     // happen every time a chunk was filled up.
 
@@ -564,26 +625,27 @@ inline output_stream<char> make_compressed_file_output_stream(output_stream<char
     // defaults to 1.0.
     cm->options.elements.push_back({"crc_check_chance", "1.0"});
 
-    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p));
+    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p, dictionary_trainer));
 }
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
         sstables::compression* cm, uint64_t offset, size_t len,
-        class file_input_stream_options options)
+        class file_input_stream_options options, std::optional<read_ahead_policy> read_ahead)
 {
-    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options));
+    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options), read_ahead);
 }
 
 input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
         sstables::compression *cm, uint64_t offset, size_t len,
-        class file_input_stream_options options) {
-    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options));
+        class file_input_stream_options options, std::optional<read_ahead_policy> read_ahead) {
+    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options), read_ahead);
 }
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(output_stream<char> out,
         sstables::compression* cm,
-        const compression_parameters& cp) {
+        const compression_parameters& cp,
+        utils::alien_worker* dictionary_trainer) {
     return make_compressed_file_output_stream<crc32_utils, compressed_checksum_mode::checksum_all>(
-            std::move(out), cm, cp);
+            std::move(out), cm, cp, dictionary_trainer);
 }
 
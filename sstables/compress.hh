@@ -24,6 +24,11 @@
 // LZ4, Snappy, Deflate, and Zstd - the default (and therefore most important) is
 // LZ4. Each compressor is an implementation of the "compressor" class.
 //
+// LZ4 and Zstd chunks may also be compressed against a dictionary trained
+// from the first chunks of the sstable and stored in the CompressionDictionary
+// component. This keeps the compression ratio of small chunks, which are
+// needed for low read amplification, close to the one of large chunks.
+//
 // Each compressed chunk is followed by a 4-byte checksum of the compressed
 // data, using the Adler32 or CRC32 algorithm. In Cassandra, there is a parameter
 // "crc_check_chance" (defaulting to 1.0) which determines the probability
@@ -44,6 +49,7 @@
 
 #include "types.hh"
 #include "sstables/types.hh"
+#include "sstables/read_ahead.hh"
 #include "checksum_utils.hh"
 #include "../compress.hh"
 
@@ -51,6 +57,10 @@ class compression_parameters;
 class compressor;
 using compressor_ptr = shared_ptr<compressor>;
 
+namespace utils {
+class alien_worker;
+}
+
 namespace sstables {
 
 struct compression;
@@ -302,6 +312,10 @@ struct compression {
     uint64_t _compressed_file_length = 0;
     uint32_t _full_checksum = 0;
 public:
+    // The dictionary all chunks are compressed with, if any. Stored in the
+    // CompressionDictionary component and digested once per sstable.
+    compression_dictionary_ptr dictionary;
+
     // Set the compressor algorithm, please check the definition of enum compressor.
     void set_compressor(compressor_ptr c);
     // After changing _compression, update() must be called to update
@@ -369,17 +383,26 @@ compressor_ptr get_sstable_compressor(const compression&);
 // are open streams on it. This should happen naturally on a higher level -
 // as long as we have *sstables* work in progress, we need to keep the whole
 // sstable alive, and the compression metadata is only a part of it.
+// With a read-ahead policy, the compressed chunks are read with adaptive
+// read-ahead (see make_adaptive_file_input_stream()), in buffers of
+// options.buffer_size. Otherwise options configure a file_input_stream.
 input_stream<char> make_compressed_file_k_l_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options,
+                std::optional<read_ahead_policy> read_ahead = {});
 
 input_stream<char> make_compressed_file_m_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options,
+                std::optional<read_ahead_policy> read_ahead = {});
 
+// If dictionary_trainer is set and the compressor supports dictionaries, the
+// first chunks written are used to train a dictionary on it, which is then
+// stored in cm->dictionary and used to compress all chunks.
 output_stream<char> make_compressed_file_m_format_output_stream(output_stream<char> out,
                 sstables::compression* cm,
-                const compression_parameters& cp);
+                const compression_parameters& cp,
+                utils::alien_worker* dictionary_trainer = nullptr);
 
 }
 
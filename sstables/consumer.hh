@@ -22,6 +22,7 @@
 #include "utils/overloaded_functor.hh"
 #include "utils/small_vector.hh"
 
+#include <span>
 #include <variant>
 
 template<typename T>
@@ -254,6 +255,17 @@ class primitive_consumer {
                 prestate::READING_UNSIGNED_VINT,
                 prestate::READING_UNSIGNED_VINT_WITH_LEN>(data, _u64);
     }
+    // Decodes dest.size() consecutive unsigned vints in one go if they are all in data. Returns
+    // false without consuming anything otherwise, and they have to be read one by one.
+    inline bool read_unsigned_vints(temporary_buffer<char>& data, std::span<uint64_t> dest) noexcept {
+        const auto len = unsigned_vint::deserialize_many(
+                bytes_view(reinterpret_cast<const bytes::value_type*>(data.get()), data.size()), dest);
+        if (!len) {
+            return false;
+        }
+        data.trim_front(len);
+        return true;
+    }
     inline read_status read_signed_vint(temporary_buffer<char>& data) {
         return read_vint<
                 signed_vint,
@@ -23,6 +23,7 @@ namespace sstables {
 
 extern seastar::logger sstlog;
 extern thread_local cached_file::metrics index_page_cache_metrics;
+extern thread_local cached_file::metrics cold_data_page_cache_metrics;
 extern thread_local mc::cached_promoted_index::metrics promoted_index_cache_metrics;
 
 // Promoted index information produced by the parser.
@@ -304,7 +305,7 @@ class index_consume_entry_context : public data_consumer::continuous_data_consum
 inline file make_tracked_index_file(sstable& sst, reader_permit permit, tracing::trace_state_ptr trace_state,
                                     use_caching caching) {
     auto f = caching ? sst.index_file() : sst.uncached_index_file();
-    f = make_tracked_file(std::move(f), std::move(permit));
+    f = make_tracked_file(std::move(f), std::move(permit), tracked_file_kind::index);
     if (!trace_state) {
         return f;
     }
@@ -424,8 +425,9 @@ struct index_bound {
 // If eof() then the lower bound cursor is positioned past all partitions in the sstable.
 class index_reader {
     shared_sstable _sstable;
-    reader_permit _permit;
-    const io_priority_class& _pc;
+    // Disengaged (with _sstable) while the reader sits in the pool of its sstable, see recycle().
+    std::optional<reader_permit> _permit;
+    const io_priority_class* _pc;
     tracing::trace_state_ptr _trace_state;
     std::unique_ptr<partition_index_cache> _local_index_cache; // Used when caching is disabled
     partition_index_cache& _index_cache;
@@ -511,7 +513,7 @@ class index_reader {
                 end = summary.entries[summary_idx + 1].position;
             }
 
-            return do_with(std::make_unique<reader>(_sstable, _permit, _pc, _trace_state, position, end, quantity, _use_caching), [this, summary_idx] (auto& entries_reader) {
+            return do_with(std::make_unique<reader>(_sstable, *_permit, *_pc, _trace_state, position, end, quantity, _use_caching), [this, summary_idx] (auto& entries_reader) {
                 return entries_reader->_context.consume_input().then_wrapped([this, summary_idx, &entries_reader] (future<> f) {
                     std::exception_ptr ex;
                     if (f.failed()) {
@@ -741,7 +743,7 @@ class index_reader {
                  use_caching caching)
         : _sstable(std::move(sst))
         , _permit(std::move(permit))
-        , _pc(pc)
+        , _pc(&pc)
         , _trace_state(std::move(trace_state))
         , _local_index_cache(caching ? nullptr
             : std::make_unique<partition_index_cache>(_sstable->manager().get_cache_tracker().get_lru(),
@@ -753,6 +755,35 @@ class index_reader {
         sstlog.trace("index {}: index_reader for {}", fmt::ptr(this), _sstable->get_filename());
     }
 
+    // Makes an index reader for the sstable, reusing a reader from the pool
+    // of the sstable if there is one. Saves point reads, which typically read
+    // a single index page, the cost of setting up a new index reader.
+    static std::unique_ptr<index_reader> make(shared_sstable sst, reader_permit permit, const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state, use_caching caching) {
+        auto& pool = sst->_index_reader_pool;
+        if (!caching || pool.empty()) {
+            return std::make_unique<index_reader>(std::move(sst), std::move(permit), pc, std::move(trace_state), caching);
+        }
+        auto ir = std::move(pool.back());
+        pool.pop_back();
+        sstlog.trace("index {}: reusing index_reader for {}", fmt::ptr(ir.get()), sst->get_filename());
+        sst->get_stats().on_index_reader_reuse();
+        ir->_sstable = std::move(sst);
+        ir->_permit.emplace(std::move(permit));
+        ir->_pc = &pc;
+        ir->_trace_state = std::move(trace_state);
+        return ir;
+    }
+
+    // Closes the reader and puts it back into the pool of its sstable, for
+    // make() to reuse. The reader is destroyed instead when it doesn't use
+    // the shared index cache, or when the pool is full.
+    static future<> close_and_recycle(std::unique_ptr<index_reader> ir) noexcept {
+        return ir->close().then([ir = std::move(ir)] () mutable {
+            recycle(std::move(ir));
+        });
+    }
+
     // Ensures that partition_data_ready() returns true.
     // Can be called only when !eof()
     future<> read_partition_data() {
@@ -800,8 +831,8 @@ class index_reader {
                 index_entry& e = current_partition_entry(bound);
                 promoted_index* pi = e.get_promoted_index().get();
                 if (pi) {
-                    bound.clustered_cursor = pi->make_cursor(_sstable, _permit, _trace_state,
-                        get_file_input_stream_options(_pc), _use_caching);
+                    bound.clustered_cursor = pi->make_cursor(_sstable, *_permit, _trace_state,
+                        get_file_input_stream_options(*_pc), _use_caching);
                 }
             });
             if (!bound.clustered_cursor) {
@@ -1068,6 +1099,25 @@ class index_reader {
 
     const shared_sstable& sstable() const { return _sstable; }
 
+private:
+    // Drops everything tying the (closed) reader to the read which used it,
+    // so that the pooled reader doesn't hold the sstable or the permit alive.
+    static void recycle(std::unique_ptr<index_reader> ir) noexcept {
+        auto sst = std::exchange(ir->_sstable, nullptr);
+        if (!ir->_use_caching || sst->_index_reader_pool.size() >= sstable::max_pooled_index_readers) {
+            return;
+        }
+        ir->_lower_bound = index_bound{};
+        ir->_upper_bound.reset();
+        ir->_permit.reset();
+        ir->_trace_state = nullptr;
+        try {
+            sst->_index_reader_pool.push_back(std::move(ir));
+        } catch (...) {
+            // Not pooling it is always fine.
+        }
+    }
+public:
     future<> close() noexcept {
         // index_bound::close must not fail
         return close(_lower_bound).then([this] {
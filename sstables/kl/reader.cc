@@ -1143,8 +1143,8 @@ class sstable_mutation_reader : public mp_row_consumer_reader_k_l {
     index_reader& get_index_reader() {
         if (!_index_reader) {
             auto caching = use_caching(!_slice.options.contains(query::partition_slice::option::bypass_cache));
-            _index_reader = std::make_unique<index_reader>(_sst, _consumer.permit(), _consumer.io_priority(),
-                                                           _consumer.trace_state(), caching);
+            _index_reader = index_reader::make(_sst, _consumer.permit(), _consumer.io_priority(),
+                                               _consumer.trace_state(), caching);
         }
         return *_index_reader;
     }
@@ -1432,7 +1432,12 @@ class sstable_mutation_reader : public mp_row_consumer_reader_k_l {
         auto close_index_reader = make_ready_future<>();
         if (_index_reader) {
             // move _index_reader to prevent double-close from destructor.
-            close_index_reader = _index_reader->close().finally([_ = std::move(_index_reader)] {});
+            // The index reader is recycled for other reads of the sstable, so
+            // it's closed after the context, which may refer to it.
+            close_index_reader = close_context.finally([ir = std::move(_index_reader)] () mutable {
+                return index_reader::close_and_recycle(std::move(ir));
+            });
+            close_context = make_ready_future<>();
         }
 
         return when_all_succeed(std::move(close_context), std::move(close_index_reader)).discard_result().handle_exception([] (std::exception_ptr ep) {
@@ -113,6 +113,14 @@ class mutation_fragment_filter {
         return _out_of_range;
     }
 
+    // True if the just emitted row with the given key closes the last requested
+    // range and there is no range tombstone to close after it, so the partition
+    // can be finished right away instead of reading the next row to find out.
+    // This is what single-row reads by full primary key come down to.
+    bool is_last_row(const clustering_key& key) const {
+        return !_fwd && !_walker.current_tombstone() && _walker.is_last_row(key);
+    }
+
     std::optional<position_in_partition_view> maybe_skip() {
         if (!is_current_range_changed()) {
             return {};
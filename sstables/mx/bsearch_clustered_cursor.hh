@@ -252,6 +252,22 @@ class cached_promoted_index {
         });
     }
 
+    bool has_block_start(pi_index_type idx) const {
+        auto i = _blocks.find(idx);
+        return i != _blocks.end() && i->start;
+    }
+
+    // Collects the blocks which binary search over [lo, hi) can compare with in its next `levels` steps.
+    static void collect_bisection_points(pi_index_type lo, pi_index_type hi, unsigned levels, std::vector<pi_index_type>& out) {
+        if (!levels || lo >= hi) {
+            return;
+        }
+        auto mid = lo + (hi - lo) / 2;
+        out.push_back(mid);
+        collect_bisection_points(lo, mid, levels - 1, out);
+        collect_bisection_points(mid + 1, hi, levels - 1, out);
+    }
+
     void erase_range(block_set_type::iterator begin, block_set_type::iterator end) {
         while (begin != end) {
             --_metrics.block_count;
@@ -304,6 +320,46 @@ class cached_promoted_index {
         });
     }
 
+    /// \brief Populates the page cache for the next steps of a binary search over blocks [lo, hi).
+    ///
+    /// Each step of a binary search reads the start of one block, and which block it reads
+    /// depends on the outcome of the previous step, so a cold search waits for up to two
+    /// dependent reads per step (the block's offset and its start). If the start of the
+    /// block compared in the next step is not cached, this reads the offsets and then the
+    /// starts of all blocks the next `levels` steps can compare with, each in a single batch.
+    /// The next `levels` steps then don't wait for the disk.
+    future<> prefetch_for_bisection(pi_index_type lo, pi_index_type hi, unsigned levels, tracing::trace_state_ptr trace_state) {
+        if (lo >= hi || has_block_start(lo + (hi - lo) / 2)) {
+            return make_ready_future<>();
+        }
+        std::vector<pi_index_type> idxs;
+        collect_bisection_points(lo, hi, levels, idxs);
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        for (auto idx : idxs) {
+            if (_blocks.find(idx) == _blocks.end()) {
+                auto pos = _promoted_index_start + get_offset_entry_pos(idx);
+                ranges.emplace_back(pos, pos + sizeof(pi_offset_type));
+            }
+        }
+        return _cached_file.prefetch(std::move(ranges), _pc, trace_state).then([this, idxs = std::move(idxs), trace_state] () mutable {
+            return do_with(std::move(idxs), std::vector<std::pair<uint64_t, uint64_t>>(),
+                    [this, trace_state] (std::vector<pi_index_type>& idxs, std::vector<std::pair<uint64_t, uint64_t>>& ranges) {
+                return do_for_each(idxs, [this, &ranges, trace_state] (pi_index_type idx) {
+                    return get_block_only_offset(idx, trace_state).then([this, &ranges] (promoted_index_block* block) {
+                        if (!block->start) {
+                            // Clustering prefixes at the start of a block are usually short, so
+                            // reading the page the block starts in is almost always enough.
+                            auto pos = _promoted_index_start + block->offset;
+                            ranges.emplace_back(pos, pos + 1);
+                        }
+                    });
+                }).then([this, &ranges, trace_state] {
+                    return _cached_file.prefetch(std::move(ranges), _pc, trace_state);
+                });
+            });
+        });
+    }
+
     /// \brief Returns a pointer to promoted_index_block entry which has all the fields valid.
     future<promoted_index_block*> get_block(pi_index_type idx, tracing::trace_state_ptr trace_state) {
         return get_block_only_offset(idx, trace_state).then([this, trace_state] (promoted_index_block* block) {
@@ -359,7 +415,13 @@ class cached_promoted_index {
 ///
 /// N = number of index entries
 ///
+/// The I/O of bisection_lookahead consecutive steps is issued together (see
+/// cached_promoted_index::prefetch_for_bisection()), so a cold lookup waits for
+/// about 2 * log(N) / bisection_lookahead dependent reads.
+///
 class bsearch_clustered_cursor : public clustered_index_cursor {
+    static constexpr unsigned bisection_lookahead = 3;
+
     using pi_offset_type = cached_promoted_index::pi_offset_type;
     using pi_index_type = cached_promoted_index::pi_index_type;
     using promoted_index_block = cached_promoted_index::promoted_index_block;
@@ -419,7 +481,9 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             auto mid = _current_idx + (_upper_idx - _current_idx) / 2;
             tracing::trace(_trace_state, "mc_bsearch_clustered_cursor: bisecting range [{}, {}], mid={}", _current_idx, _upper_idx, mid);
             sstlog.trace("mc_bsearch_clustered_cursor {}: bisecting range [{}, {}], mid={}", fmt::ptr(this), _current_idx, _upper_idx, mid);
-            return _promoted_index.get_block_with_start(mid, _trace_state).then([this, mid, pos] (promoted_index_block* block) {
+            return _promoted_index.prefetch_for_bisection(_current_idx, _upper_idx, bisection_lookahead, _trace_state).then([this, mid] {
+                return _promoted_index.get_block_with_start(mid, _trace_state);
+            }).then([this, mid, pos] (promoted_index_block* block) {
                 position_in_partition::less_compare less(_s);
                 sstlog.trace("mc_bsearch_clustered_cursor {}: compare with [{}] .start={}", fmt::ptr(this), mid, block->start);
                 if (less(pos, *block->start)) {
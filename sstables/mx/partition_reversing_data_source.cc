@@ -403,7 +403,7 @@ class partition_reversing_data_source_impl final : public data_source_impl {
     } _state = state::RANGE_END;
 private:
     input_stream<char> data_stream(size_t start, size_t end) {
-        return _sst->data_stream(start, end - start, _io_priority, _permit, _trace_state, {});
+        return _sst->data_stream(start, end - start, _io_priority, _permit, _trace_state, read_ahead_policy::single_partition());
     }
     future<temporary_buffer<char>> data_read(uint64_t start, uint64_t end) {
         return _sst->data_read(start, end - start, _io_priority, _permit);
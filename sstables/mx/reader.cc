@@ -59,9 +59,19 @@ class mp_row_consumer_m {
 
     std::optional<clustering_row> _in_progress_row;
     std::optional<range_tombstone_change> _stored_tombstone;
+    tombstone _partition_tombstone;
+    // Whether rows shadowed by a tombstone which is at least as recent as
+    // anything else in the sstable are dropped instead of being read.
+    bool _skip_shadowed_rows;
+    const api::timestamp_type _sstable_max_timestamp;
     static_row _in_progress_static_row;
     bool _inside_static_row = false;
 
+    // Columns, by id, whose values the user of the reader can observe.
+    // Empty if all columns are needed. See needs_column_value().
+    std::vector<bool> _regular_column_values_needed;
+    std::vector<bool> _static_column_values_needed;
+
     struct cell {
         column_id id;
         atomic_cell_or_collection val;
@@ -127,15 +137,46 @@ class mp_row_consumer_m {
         return on_range_tombstone_change(std::move(pos), right);
     }
 
+    static std::vector<bool> column_mask(const query::column_id_vector& ids, size_t count) {
+        std::vector<bool> mask(count, false);
+        for (auto id : ids) {
+            mask[id] = true;
+        }
+        return mask;
+    }
+
     const column_definition& get_column_definition(std::optional<column_id> column_id) const {
         auto column_type = _inside_static_row ? column_kind::static_column : column_kind::regular_column;
         return _schema->column_at(column_type, *column_id);
     }
 
+    // Whether t shadows everything the sstable has under it: all writes in
+    // the sstable are at most as recent as its most recent one.
+    bool shadows_sstable(tombstone t) const {
+        return _skip_shadowed_rows && t && t.timestamp >= _sstable_max_timestamp;
+    }
+
+    // The partition tombstone shadows all rows and range tombstones of the
+    // partition, so finish the partition at its first clustering element,
+    // skipping the rest of it with the index.
+    bool maybe_skip_shadowed_partition() {
+        if (!shadows_sstable(_partition_tombstone) || _mf_filter->current_tombstone()) {
+            return false;
+        }
+        sstlog.trace("mp_row_consumer_m {}: partition shadowed by its tombstone {}, skipping it", fmt::ptr(this), _partition_tombstone);
+        _sst->get_stats().on_shadowed_partition_skip();
+        _reader->on_out_of_clustering_range();
+        return true;
+    }
+
     inline proceed on_range_tombstone_change(position_in_partition pos, tombstone t) {
         sstlog.trace("mp_row_consumer_m {}: on_range_tombstone_change({}, {}->{})", fmt::ptr(this), pos,
                      _mf_filter->current_tombstone(), t);
 
+        if (maybe_skip_shadowed_partition()) {
+            return proceed::no;
+        }
+
         mutation_fragment_filter::clustering_result result = _mf_filter->apply(pos, t);
 
         for (auto&& rt : result.rts) {
@@ -171,6 +212,7 @@ class mp_row_consumer_m {
         _is_mutation_end = true;
         _in_progress_row.reset();
         _stored_tombstone.reset();
+        _partition_tombstone = {};
         _mf_filter.reset();
     }
 
@@ -214,8 +256,18 @@ class mp_row_consumer_m {
         , _fwd(fwd)
         , _treat_static_row_as_regular(_schema->is_static_compact_table()
             && (!sst->has_scylla_component() || sst->features().is_enabled(sstable_feature::CorrectStaticCompact))) // See #4139
+        // Reversed reads consume whole rows, even the ones they skip, see consume_row_end().
+        , _skip_shadowed_rows(!_slice.is_reversed() && sst->manager().config().sstable_skip_shadowed_rows())
+        , _sstable_max_timestamp(sst->get_stats_metadata().max_timestamp)
     {
         _cells.reserve(std::max(_schema->static_columns_count(), _schema->regular_columns_count()));
+        // Values of columns outside of the slice are never looked at by queries, but the cells
+        // themselves are still needed to determine row liveness. Reads which populate the cache
+        // must return whole rows, so values are only dropped when the cache is bypassed.
+        if (_slice.options.contains(query::partition_slice::option::bypass_cache) && !_treat_static_row_as_regular) {
+            _regular_column_values_needed = column_mask(_slice.regular_columns, _schema->regular_columns_count());
+            _static_column_values_needed = column_mask(_slice.static_columns, _schema->static_columns_count());
+        }
     }
 
     mp_row_consumer_m(mp_row_consumer_reader_mx* reader,
@@ -226,7 +278,10 @@ class mp_row_consumer_m {
                         streamed_mutation::forwarding fwd,
                         const shared_sstable& sst)
     : mp_row_consumer_m(reader, schema, std::move(permit), schema->full_slice(), pc, std::move(trace_state), fwd, sst)
-    { }
+    {
+        // Used for crawling through all of the sstable's content.
+        _skip_shadowed_rows = false;
+    }
 
     ~mp_row_consumer_m() {}
 
@@ -311,7 +366,8 @@ class mp_row_consumer_m {
         auto pk = partition_key::from_exploded(key.explode(*_schema));
         setup_for_partition(pk);
         auto dk = dht::decorate_key(*_schema, pk);
-        _reader->on_next_partition(std::move(dk), tombstone(deltime));
+        _partition_tombstone = tombstone(deltime);
+        _reader->on_next_partition(std::move(dk), _partition_tombstone);
         return proceed(!_reader->is_buffer_full() && !need_preempt());
     }
 
@@ -321,6 +377,10 @@ class mp_row_consumer_m {
 
         sstlog.trace("mp_row_consumer_m {}: consume_row_start({})", fmt::ptr(this), key);
 
+        if (maybe_skip_shadowed_partition()) {
+            return mp_row_consumer_m::row_processing_result::retry_later;
+        }
+
         _in_progress_row.emplace(std::move(key));
 
         mutation_fragment_filter::clustering_result res = _mf_filter->apply(_in_progress_row->position());
@@ -332,6 +392,12 @@ class mp_row_consumer_m {
 
         switch (res.action) {
         case mutation_fragment_filter::result::emit:
+            if (shadows_sstable(_mf_filter->current_tombstone())) {
+                sstlog.trace("mp_row_consumer_m {}: shadowed by {}, skipping", fmt::ptr(this), _mf_filter->current_tombstone());
+                _sst->get_stats().on_shadowed_row_skip();
+                _in_progress_row.reset();
+                return mp_row_consumer_m::row_processing_result::skip_row;
+            }
             sstlog.trace("mp_row_consumer_m {}: emit", fmt::ptr(this));
             return mp_row_consumer_m::row_processing_result::do_proceed;
         case mutation_fragment_filter::result::ignore:
@@ -383,6 +449,21 @@ class mp_row_consumer_m {
         return mp_row_consumer_m::row_processing_result::do_proceed;
     }
 
+    // Returns false if the value of the cell of the column can be replaced by an empty one,
+    // because it is not going to be observed. The cell's metadata is always needed.
+    bool needs_column_value(const column_translation::column_info& column_info) const {
+        if (!column_info.id) {
+            // Dropped by consume_column() anyway.
+            return false;
+        }
+        if (column_info.is_counter) {
+            // Counter shards are merged by looking at their values.
+            return true;
+        }
+        auto& needed = _inside_static_row ? _static_column_values_needed : _regular_column_values_needed;
+        return needed.empty() || *column_info.id >= needed.size() || needed[*column_info.id];
+    }
+
     proceed consume_column(const column_translation::column_info& column_info,
                                    bytes_view cell_path,
                                    fragmented_temporary_buffer::view value,
@@ -556,8 +637,15 @@ class mp_row_consumer_m {
                     _mf_filter->apply(_in_progress_row->position()).action != mutation_fragment_filter::result::emit) {
                 return proceed(!_reader->is_buffer_full() && !need_preempt());
             }
+            auto last_row = !_slice.is_reversed() && _mf_filter->is_last_row(_in_progress_row->key());
             _reader->push_mutation_fragment(mutation_fragment_v2(
                     *_schema, permit(), *std::exchange(_in_progress_row, {})));
+            if (last_row) {
+                sstlog.trace("mp_row_consumer_m {}: emitted the last requested row, finishing the partition", fmt::ptr(this));
+                _sst->get_stats().on_last_row_finish();
+                _reader->on_out_of_clustering_range();
+                return proceed::no;
+            }
         }
 
         return proceed(!_reader->is_buffer_full() && !need_preempt());
@@ -710,6 +798,9 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
 
     uint64_t _missing_columns_to_read;
 
+    // For decoding the vints of row, cell and range tombstone headers in one go, see read_unsigned_vints().
+    std::array<uint64_t, 4> _vints;
+
     boost::iterator_range<std::vector<std::optional<uint32_t>>::const_iterator> _ck_column_value_fix_lengths;
 
     tombstone _row_tombstone;
@@ -953,7 +1044,11 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                         _flags.has_timestamp(), _flags.has_ttl(), _flags.has_deletion()));
                 }
             } else {
-                if (_flags.has_timestamp()) {
+                if (_flags.has_timestamp() && _flags.has_ttl() && read_unsigned_vints(*_processing_data, std::span(_vints).first(3))) {
+                    _liveness.set_timestamp(parse_timestamp(_header, _vints[0]));
+                    _liveness.set_ttl(parse_ttl(_header, _vints[1]));
+                    _liveness.set_local_deletion_time(parse_expiry(_header, _vints[2]));
+                } else if (_flags.has_timestamp()) {
                     co_yield read_unsigned_vint(*_processing_data);
 
                     _liveness.set_timestamp(parse_timestamp(_header, _u64));
@@ -964,7 +1059,10 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                         _liveness.set_local_deletion_time(parse_expiry(_header, _u64));
                     }
                 }
-                if (_flags.has_deletion()) {
+                if (_flags.has_deletion() && read_unsigned_vints(*_processing_data, std::span(_vints).first(2))) {
+                    _row_tombstone.timestamp = parse_timestamp(_header, _vints[0]);
+                    _row_tombstone.deletion_time = parse_expiry(_header, _vints[1]);
+                } else if (_flags.has_deletion()) {
                     co_yield read_unsigned_vint(*_processing_data);
                     _row_tombstone.timestamp = parse_timestamp(_header, _u64);
                     co_yield read_unsigned_vint(*_processing_data);
@@ -1050,6 +1148,13 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
             co_yield read_8(*_processing_data);
             _column_flags = column_flags_m(_u8);
 
+            if (!_column_flags.use_row_timestamp() && !_column_flags.use_row_ttl() && _column_flags.is_expiring()
+                    && read_unsigned_vints(*_processing_data, std::span(_vints).first(3))) {
+                _column_timestamp = parse_timestamp(_header, _vints[0]);
+                _column_local_deletion_time = parse_expiry(_header, _vints[1]);
+                _column_ttl = parse_ttl(_header, _vints[2]);
+                goto cell_path_label;
+            }
             if (_column_flags.use_row_timestamp()) {
                 _column_timestamp = _liveness.timestamp();
             } else {
@@ -1072,6 +1177,7 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                 co_yield read_unsigned_vint(*_processing_data);
                 _column_ttl = parse_ttl(_header, _u64);
             }
+        cell_path_label:
             if (!is_column_simple()) {
                 co_yield read_unsigned_vint_length_bytes_contiguous(*_processing_data, _cell_path);
             } else {
@@ -1079,6 +1185,18 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
             }
             if (!_column_flags.has_value()) {
                 _column_value = fragmented_temporary_buffer();
+            } else if (!_consumer.needs_column_value(get_column_info())) {
+                // Skip over the value without copying it, the cell is passed on with an empty value.
+                _column_value = fragmented_temporary_buffer();
+                if (auto len = get_column_value_length()) {
+                    _u64 = *len;
+                } else {
+                    co_yield read_unsigned_vint(*_processing_data);
+                }
+                auto maybe_skip_bytes = skip(*_processing_data, _u64);
+                if (std::holds_alternative<skip_bytes>(maybe_skip_bytes)) {
+                    co_yield maybe_skip_bytes;
+                }
             } else {
                 read_status status = read_status::waiting;
                 if (auto len = get_column_value_length()) {
@@ -1121,14 +1239,18 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
             _consuming = true;
             goto column_label;
         range_tombstone_body_label:
-            co_yield read_unsigned_vint(*_processing_data);
-            // Ignore result (marker_body_size or row_body_size)
-            co_yield read_unsigned_vint(*_processing_data);
-            // Ignore result (prev_unfiltered_size)
-            co_yield read_unsigned_vint(*_processing_data);
-            _left_range_tombstone.timestamp = parse_timestamp(_header, _u64);
-            co_yield read_unsigned_vint(*_processing_data);
-            _left_range_tombstone.deletion_time = parse_expiry(_header, _u64);
+            // The first two are marker_body_size or row_body_size and prev_unfiltered_size, which are ignored.
+            if (read_unsigned_vints(*_processing_data, _vints)) {
+                _left_range_tombstone.timestamp = parse_timestamp(_header, _vints[2]);
+                _left_range_tombstone.deletion_time = parse_expiry(_header, _vints[3]);
+            } else {
+                co_yield read_unsigned_vint(*_processing_data);
+                co_yield read_unsigned_vint(*_processing_data);
+                co_yield read_unsigned_vint(*_processing_data);
+                _left_range_tombstone.timestamp = parse_timestamp(_header, _u64);
+                co_yield read_unsigned_vint(*_processing_data);
+                _left_range_tombstone.deletion_time = parse_expiry(_header, _u64);
+            }
             if (!is_boundary_between_adjacent_intervals(_range_tombstone_kind)) {
                 if (!is_bound_kind(_range_tombstone_kind)) {
                     throw sstables::malformed_sstable_exception(
@@ -1320,8 +1442,8 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
     index_reader& get_index_reader() {
         if (!_index_reader) {
             auto caching = use_caching(!_slice.options.contains(query::partition_slice::option::bypass_cache));
-            _index_reader = std::make_unique<index_reader>(_sst, _consumer.permit(), _consumer.io_priority(),
-                                                           _consumer.trace_state(), caching);
+            _index_reader = index_reader::make(_sst, _consumer.permit(), _consumer.io_priority(),
+                                               _consumer.trace_state(), caching);
         }
         return *_index_reader;
     }
@@ -1667,7 +1789,12 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         auto close_index_reader = make_ready_future<>();
         if (_index_reader) {
             // move _index_reader to prevent double-close from destructor.
-            close_index_reader = _index_reader->close().finally([_ = std::move(_index_reader)] {});
+            // The index reader is recycled for other reads of the sstable, so
+            // it's closed after the context, which may refer to it.
+            close_index_reader = close_context.finally([ir = std::move(_index_reader)] () mutable {
+                return index_reader::close_and_recycle(std::move(ir));
+            });
+            close_context = make_ready_future<>();
         }
 
         return when_all_succeed(std::move(close_context), std::move(close_index_reader)).discard_result().handle_exception([] (std::exception_ptr ep) {
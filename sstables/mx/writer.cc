@@ -15,6 +15,7 @@
 #include "sstables/types.hh"
 #include "sstables/mx/types.hh"
 #include "db/config.hh"
+#include "db/extensions.hh"
 #include "atomic_cell.hh"
 #include "utils/exceptions.hh"
 
@@ -588,6 +589,16 @@ class writer : public sstable_writer::writer_impl {
     utils::UUID _run_identifier;
     bool _write_regular_as_static; // See #4139
     scylla_metadata::large_data_stats _large_data_stats;
+    // The smallest and largest partition keys written, in key order.
+    std::optional<partition_key> _min_partition_key;
+    std::optional<partition_key> _max_partition_key;
+    // See expiration_time_bounds, only for tables with a row_expiration.
+    std::optional<row_expiration> _row_expiration;
+    int64_t _min_expiration = std::numeric_limits<int64_t>::max();
+    int64_t _max_expiration = std::numeric_limits<int64_t>::min();
+    // See token_histogram. Partitions come in ring order, so the bucket of
+    // the current one is the last.
+    utils::chunked_vector<token_histogram_bucket> _token_histogram;
 
     void init_file_writers();
 
@@ -779,7 +790,7 @@ class writer : public sstable_writer::writer_impl {
         // exactly what callers used to do anyway.
         estimated_partitions = std::max(uint64_t(1), estimated_partitions);
 
-        _sst.generate_toc(_schema.get_compressor_params().get_compressor(), _schema.bloom_filter_fp_chance());
+        _sst.generate_toc(_schema.get_compressor_params().get_compressor(), _schema.bloom_filter_fp_chance(), cfg.compression_dictionary_trainer != nullptr);
         _sst.write_toc(_pc);
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -787,8 +798,16 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        _sst._components->filter = cfg.split_block_bloom_filter
+                ? utils::i_filter::get_split_block_filter(estimated_partitions, _schema.bloom_filter_fp_chance())
+                : utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
         _pi_write_m.desired_block_size = cfg.promoted_index_block_size;
+        for (auto* ext : _sst.manager().config().extensions().row_expiration_extensions()) {
+            _row_expiration = ext->get_row_expiration(_schema);
+            if (_row_expiration) {
+                break;
+            }
+        }
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
         prepare_summary(_sst._components->summary, estimated_partitions, _schema.min_index_interval());
 
@@ -879,7 +898,8 @@ void writer::init_file_writers() {
             make_compressed_file_m_format_output_stream(
                 std::move(out),
                 &_sst._components->compression,
-                _schema.get_compressor_params()), _sst.filename(component_type::Data));
+                _schema.get_compressor_params(),
+                _sst.has_component(component_type::CompressionDictionary) ? _cfg.compression_dictionary_trainer : nullptr), _sst.filename(component_type::Data));
     }
     auto w = file_writer::make(std::move(_sst._index_file), std::move(options), _sst.filename(component_type::Index));
     _index_writer = std::make_unique<file_writer>(w.get0());
@@ -986,6 +1006,20 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     _sst._components->filter->add(bytes_view(*_partition_key));
     _collector.add_key(bytes_view(*_partition_key));
 
+    auto bucket = token_histogram_bucket_of(dk.token());
+    if (_token_histogram.empty() || _token_histogram.back().index != bucket) {
+        _token_histogram.push_back(token_histogram_bucket{bucket, 0, 0});
+    }
+    ++_token_histogram.back().partitions;
+
+    partition_key::tri_compare pk_cmp(_schema);
+    if (!_min_partition_key || pk_cmp(dk.key(), *_min_partition_key) < 0) {
+        _min_partition_key = dk.key();
+    }
+    if (!_max_partition_key || pk_cmp(dk.key(), *_max_partition_key) > 0) {
+        _max_partition_key = dk.key();
+    }
+
     auto p_key = disk_string_view<uint16_t>();
     p_key.value = bytes_view(*_partition_key);
 
@@ -1341,6 +1375,13 @@ void writer::write_clustered(const clustering_row& clustered_row, uint64_t prev_
 }
 
 stop_iteration writer::consume(clustering_row&& cr) {
+    if (_row_expiration) {
+        if (auto t = _row_expiration->expiration_time(cr.cells())) {
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(t->time_since_epoch()).count();
+            _min_expiration = std::min<int64_t>(_min_expiration, seconds);
+            _max_expiration = std::max<int64_t>(_max_expiration, seconds);
+        }
+    }
     if (_write_regular_as_static) {
         ensure_tombstone_is_written();
         write_static_row(cr.cells(), column_kind::regular_column);
@@ -1440,6 +1481,7 @@ stop_iteration writer::consume_end_of_partition() {
     _c_stats.partition_size = _data_writer->offset() - _c_stats.start_offset;
 
     maybe_record_large_partitions(_sst, *_partition_key, _c_stats.partition_size, _c_stats.rows_count);
+    _token_histogram.back().rows += _c_stats.rows_count;
 
 
     // update is about merging column_stats with the data being stored by collector.
@@ -1478,7 +1520,24 @@ void writer::consume_end_of_stream() {
     auto features = sstable_enabled_features::all();
     run_identifier identifier{_run_identifier};
     std::optional<scylla_metadata::large_data_stats> ld_stats(std::move(_large_data_stats));
-    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin);
+    std::optional<partition_key_bounds> pk_bounds;
+    if (_min_partition_key) {
+        pk_bounds.emplace();
+        pk_bounds->min.value = to_bytes(_min_partition_key->representation());
+        pk_bounds->max.value = to_bytes(_max_partition_key->representation());
+    }
+    std::optional<expiration_time_bounds> exp_bounds;
+    if (_row_expiration) {
+        exp_bounds.emplace();
+        exp_bounds->source.value = to_bytes(_row_expiration->source);
+        exp_bounds->min = _min_expiration;
+        exp_bounds->max = _min_expiration <= _max_expiration ? _max_expiration : _min_expiration;
+    }
+    token_histogram histogram;
+    histogram.bucket_count = token_histogram_bucket_count;
+    histogram.buckets.elements = std::move(_token_histogram);
+    _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin, std::move(pk_bounds),
+            std::move(exp_bounds), std::move(histogram));
     if (!_cfg.leave_unsealed) {
         _sst.seal_sstable(_cfg.backup).get();
     }
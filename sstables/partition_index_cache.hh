@@ -114,7 +114,7 @@ class partition_index_cache {
         entry_ptr& operator=(std::nullptr_t) noexcept {
             if (_ref) {
                 if (_ref.unique()) {
-                    _ref->_parent->_lru.add(*_ref);
+                    _ref->_parent->_lru.add(*_ref, lru_kind::partition_index);
                 }
                 _ref = nullptr;
             }
@@ -192,6 +192,7 @@ class partition_index_cache {
             auto ptr = share(cp);
             if (cp.ready()) {
                 ++_shard_stats.hits;
+                _lru.on_hit(lru_kind::partition_index);
                 return make_ready_future<entry_ptr>(std::move(ptr));
             } else {
                 ++_shard_stats.blocks;
@@ -227,6 +228,7 @@ class partition_index_cache {
                 e.promise()->set_value();
                 e.set_page(std::move(page));
                 _shard_stats.used_bytes += e.size_in_allocator();
+                _lru.on_memory_usage_change(lru_kind::partition_index, e.size_in_allocator());
                 ++_shard_stats.populations;
                 return ptr;
             } catch (...) {
@@ -242,6 +244,7 @@ class partition_index_cache {
 
     void on_evicted(entry& p) {
         _shard_stats.used_bytes -= p.size_in_allocator();
+        _lru.on_memory_usage_change(lru_kind::partition_index, -int64_t(p.size_in_allocator()));
         ++_shard_stats.evictions;
     }
 
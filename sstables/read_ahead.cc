@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <deque>
+
+#include "sstables/read_ahead.hh"
+#include "sstables/stats.hh"
+
+namespace sstables {
+
+class adaptive_file_data_source_impl : public data_source_impl {
+    struct pending_read {
+        uint64_t len;
+        future<temporary_buffer<char>> buf;
+    };
+
+    file _file;
+    const io_priority_class& _pc;
+    // Where the next read is issued from.
+    uint64_t _pos;
+    uint64_t _end;
+    size_t _buffer_size;
+    read_ahead_policy _policy;
+    unsigned _read_ahead;
+    // Buffers returned since the read-ahead was last changed.
+    unsigned _consumed = 0;
+    bool _first_get = true;
+    // In the order of the file.
+    std::deque<pending_read> _pending;
+    future<> _dropped = make_ready_future<>();
+    sstables_stats _stats;
+
+    void issue(bool read_ahead) {
+        auto len = std::min<uint64_t>(_buffer_size, _end - _pos);
+        if (read_ahead) {
+            _stats.on_data_read_ahead(len);
+        }
+        _pending.push_back(pending_read{len, _file.dma_read_bulk<char>(_pos, len, _pc)});
+        _pos += len;
+    }
+
+    void read_ahead() {
+        while (_pending.size() < _read_ahead && _pos < _end) {
+            issue(true);
+        }
+    }
+
+    void on_consumed() noexcept {
+        if (++_consumed >= std::max(_read_ahead, 1u)) {
+            _read_ahead = std::min(_policy.max, std::max(_read_ahead * 2, 1u));
+            _consumed = 0;
+        }
+    }
+
+    void on_skip() noexcept {
+        _read_ahead /= 2;
+        _consumed = 0;
+    }
+
+    // The read is awaited by close(), so the buffer doesn't outlive the file.
+    void drop(pending_read r) {
+        _dropped = _dropped.then([this, buf = std::move(r.buf)] () mutable {
+            return std::move(buf).then([this] (temporary_buffer<char> b) {
+                _stats.on_data_read_ahead_discarded(b.size());
+            }).handle_exception([] (std::exception_ptr) { });
+        });
+    }
+
+    pending_read pop() {
+        auto r = std::move(_pending.front());
+        _pending.pop_front();
+        return r;
+    }
+public:
+    adaptive_file_data_source_impl(file f, uint64_t pos, uint64_t len, size_t buffer_size, const io_priority_class& pc, read_ahead_policy policy)
+        : _file(std::move(f))
+        , _pc(pc)
+        , _pos(pos)
+        , _end(pos + len)
+        , _buffer_size(buffer_size)
+        , _policy(policy)
+        , _read_ahead(std::min(policy.initial, policy.max)) {
+    }
+
+    virtual future<temporary_buffer<char>> get() override {
+        if (!std::exchange(_first_get, false)) {
+            on_consumed();
+        }
+        if (_pending.empty()) {
+            if (_pos >= _end) {
+                return make_ready_future<temporary_buffer<char>>();
+            }
+            issue(false);
+        }
+        auto r = pop();
+        read_ahead();
+        return std::move(r.buf);
+    }
+
+    virtual future<temporary_buffer<char>> skip(uint64_t n) override {
+        on_skip();
+        while (n && !_pending.empty()) {
+            if (n < _pending.front().len) {
+                auto r = pop();
+                _stats.on_data_read_ahead_discarded(n);
+                return std::move(r.buf).then([n] (temporary_buffer<char> b) {
+                    b.trim_front(std::min<uint64_t>(n, b.size()));
+                    return b;
+                });
+            }
+            n -= _pending.front().len;
+            drop(pop());
+        }
+        _pos = std::min(_end, _pos + n);
+        return make_ready_future<temporary_buffer<char>>();
+    }
+
+    virtual future<> close() override {
+        while (!_pending.empty()) {
+            drop(pop());
+        }
+        return std::exchange(_dropped, make_ready_future<>());
+    }
+};
+
+input_stream<char> make_adaptive_file_input_stream(file f, uint64_t pos, uint64_t len, size_t buffer_size,
+        const io_priority_class& pc, read_ahead_policy policy) {
+    return input_stream<char>(data_source(std::make_unique<adaptive_file_data_source_impl>(std::move(f), pos, len, buffer_size, pc, policy)));
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/file.hh>
+#include <seastar/core/iostream.hh>
+
+#include "seastarx.hh"
+
+namespace sstables {
+
+/// How many buffers a data stream reads ahead of its consumer.
+///
+/// A stream starts with `initial` buffers of read-ahead, and doubles it, up to
+/// `max`, each time its consumer came back for as many buffers as were read
+/// ahead, without skipping. Skipping halves it. So point reads don't read
+/// what they won't use, while long sequential reads get deep read-ahead.
+struct read_ahead_policy {
+    unsigned initial;
+    unsigned max;
+
+    static constexpr unsigned default_max = 8;
+
+    // Reads of a single partition often end within the first buffer.
+    static read_ahead_policy single_partition() noexcept { return {0, default_max}; }
+    // Scans are expected to read on.
+    static read_ahead_policy range() noexcept { return {1, default_max}; }
+    // Random access, no read-ahead at all.
+    static read_ahead_policy none() noexcept { return {0, 0}; }
+};
+
+/// Reads [pos, pos + len) of \p f in buffers of buffer_size bytes, reading
+/// ahead according to \p policy.
+input_stream<char> make_adaptive_file_input_stream(file f, uint64_t pos, uint64_t len, size_t buffer_size,
+        const io_priority_class& pc, read_ahead_policy policy);
+
+}
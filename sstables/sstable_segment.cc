@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+
+#include "sstables/sstable_segment.hh"
+#include "sstables/sstables.hh"
+#include "sstables/key.hh"
+#include "sstables/exceptions.hh"
+#include "sstables/sstable_version.hh"
+#include "vint-serialization.hh"
+#include "bytes_ostream.hh"
+#include "checked-file-impl.hh"
+#include "utils/disk-error-handler.hh"
+
+namespace sstables {
+
+// Index entries are sent in chunks of about this size.
+static constexpr size_t index_chunk_size = 128 * 1024;
+
+namespace {
+
+// Reads consecutive index entries of an m-format sstable.
+class index_entry_reader {
+    const sstable& _sst;
+    input_stream<char> _in;
+    uint64_t _pos;
+    uint64_t _end;
+public:
+    struct entry {
+        uint64_t index_position;
+        temporary_buffer<char> key;
+        uint64_t data_position;
+        temporary_buffer<char> promoted_index;
+
+        bytes_view key_bytes() const {
+            return bytes_view(reinterpret_cast<const int8_t*>(key.get()), key.size());
+        }
+    };
+private:
+    static file_input_stream_options options(const io_priority_class& pc) {
+        file_input_stream_options opts;
+        opts.buffer_size = 64 * 1024;
+        opts.read_ahead = 2;
+        opts.io_priority_class = pc;
+        return opts;
+    }
+
+    future<temporary_buffer<char>> read_exactly(size_t n) {
+        auto buf = co_await _in.read_exactly(n);
+        if (buf.size() != n) {
+            throw malformed_sstable_exception(format("index entry at {} is truncated", _pos), _sst.filename(component_type::Index));
+        }
+        _pos += n;
+        co_return buf;
+    }
+
+    future<uint64_t> read_unsigned_vint() {
+        auto first = co_await read_exactly(1);
+        auto len = unsigned_vint::serialized_size_from_first_byte(bytes::value_type(first[0]));
+        bytes b(bytes::initialized_later(), len);
+        b[0] = bytes::value_type(first[0]);
+        if (len > 1) {
+            auto rest = co_await read_exactly(len - 1);
+            std::copy_n(rest.get(), rest.size(), reinterpret_cast<char*>(b.begin() + 1));
+        }
+        co_return unsigned_vint::deserialize(b);
+    }
+public:
+    index_entry_reader(const sstable& sst, file f, uint64_t pos, const io_priority_class& pc)
+        : _sst(sst)
+        , _in(make_file_input_stream(std::move(f), pos, sst.index_size() - pos, options(pc)))
+        , _pos(pos)
+        , _end(sst.index_size())
+    { }
+
+    future<std::optional<entry>> next() {
+        if (_pos >= _end) {
+            co_return std::nullopt;
+        }
+        entry e;
+        e.index_position = _pos;
+        auto key_size = co_await read_exactly(sizeof(uint16_t));
+        e.key = co_await read_exactly(read_be<uint16_t>(key_size.get()));
+        e.data_position = co_await read_unsigned_vint();
+        auto promoted_index_size = co_await read_unsigned_vint();
+        e.promoted_index = co_await read_exactly(promoted_index_size);
+        co_return e;
+    }
+
+    future<> close() {
+        return _in.close();
+    }
+};
+
+}
+
+sstable_segment::sstable_segment(shared_sstable sst, dht::token_range range, uint64_t index_start, uint64_t data_start)
+    : _sst(std::move(sst))
+    , _range(std::move(range))
+    , _index_start(index_start)
+    , _data_start(data_start)
+{ }
+
+bool sstable_segment::is_supported(const sstable& sst) {
+    return sst.get_version() >= sstable_version_types::mc && sst.has_component(component_type::Index);
+}
+
+future<std::optional<sstable_segment>> sstable_segment::find(shared_sstable sst, dht::token_range range, const io_priority_class& pc) {
+    if (!is_supported(*sst)) {
+        co_return std::nullopt;
+    }
+    // Start from the last summary entry which is before the range.
+    uint64_t start = 0;
+    if (range.start()) {
+        auto& entries = sst->get_summary().entries;
+        auto it = std::partition_point(entries.begin(), entries.end(), [&] (const summary_entry& e) {
+            return e.token < range.start()->value();
+        });
+        if (it != entries.begin()) {
+            start = std::prev(it)->position;
+        }
+    }
+    auto& partitioner = sst->get_schema()->get_partitioner();
+    index_entry_reader rd(*sst, sst->_index_file, start, pc);
+    std::optional<sstable_segment> ret;
+    std::exception_ptr ex;
+    try {
+        while (auto e = co_await rd.next()) {
+            auto token = partitioner.get_token(key_view(e->key_bytes()));
+            if (range.before(token, dht::token_comparator())) {
+                continue;
+            }
+            if (!range.after(token, dht::token_comparator())) {
+                ret = sstable_segment(sst, std::move(range), e->index_position, e->data_position);
+            }
+            break;
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await rd.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return ret;
+}
+
+future<uint64_t> sstable_segment::produce_index(component_consumer& out, const io_priority_class& pc) {
+    auto& partitioner = _sst->get_schema()->get_partitioner();
+    index_entry_reader rd(*_sst, _sst->_index_file, _index_start, pc);
+    uint64_t data_end = _sst->data_size();
+    bytes_ostream buf;
+    auto flush = [&] () -> future<> {
+        auto data = buf.linearize();
+        temporary_buffer<char> chunk(reinterpret_cast<const char*>(data.data()), data.size());
+        buf.clear();
+        return out.consume(std::move(chunk));
+    };
+    std::exception_ptr ex;
+    try {
+        while (auto e = co_await rd.next()) {
+            auto token = partitioner.get_token(key_view(e->key_bytes()));
+            if (_range.after(token, dht::token_comparator())) {
+                data_end = e->data_position;
+                break;
+            }
+            auto write_vint = [&] (uint64_t v) {
+                auto p = buf.write_place_holder(unsigned_vint::serialized_size(v));
+                unsigned_vint::serialize(v, p);
+            };
+            auto size = buf.write_place_holder(sizeof(uint16_t));
+            write_be<uint16_t>(reinterpret_cast<char*>(size), e->key.size());
+            buf.write(e->key_bytes());
+            write_vint(e->data_position - _data_start);
+            write_vint(e->promoted_index.size());
+            buf.write(bytes_view(reinterpret_cast<const int8_t*>(e->promoted_index.get()), e->promoted_index.size()));
+            if (buf.size() >= index_chunk_size) {
+                co_await flush();
+            }
+        }
+        if (buf.size()) {
+            co_await flush();
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await rd.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return data_end;
+}
+
+future<> produce_component_file(const sstable& sst, component_type c, component_consumer& out, const io_priority_class& pc) {
+    auto f = co_await open_checked_file_dma(general_disk_error_handler, sst.filename(c), open_flags::ro);
+    file_input_stream_options opts;
+    opts.buffer_size = 128 * 1024;
+    opts.read_ahead = 4;
+    opts.io_priority_class = pc;
+    auto in = make_file_input_stream(f, 0, opts);
+    std::exception_ptr ex;
+    try {
+        while (auto buf = co_await in.read()) {
+            co_await out.consume(std::move(buf));
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await in.close();
+    co_await f.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+future<> sstable_segment::produce(component_consumer& out, reader_permit permit, const io_priority_class& pc) {
+    auto& names = sstable_version_constants::get_component_map(_sst->get_version());
+    std::vector<component_type> components = { component_type::Statistics };
+    bool has_scylla = _sst->has_component(component_type::Scylla);
+    if (has_scylla) {
+        components.push_back(component_type::Scylla);
+    }
+
+    sstring toc;
+    for (auto c : components) {
+        toc += names.at(c) + "\n";
+    }
+    for (auto c : { component_type::Index, component_type::Data, component_type::TOC }) {
+        toc += names.at(c) + "\n";
+    }
+    co_await out.start_component(names.at(component_type::TOC));
+    co_await out.consume(temporary_buffer<char>(toc.data(), toc.size()));
+
+    co_await out.start_component(names.at(component_type::Statistics));
+    co_await produce_component_file(*_sst, component_type::Statistics, out, pc);
+
+    if (has_scylla) {
+        co_await out.start_component(names.at(component_type::Scylla));
+        for (auto& buf : co_await _sst->make_segment_scylla_metadata(_range)) {
+            co_await out.consume(std::move(buf));
+        }
+    }
+
+    co_await out.start_component(names.at(component_type::Index));
+    auto data_end = co_await produce_index(out, pc);
+
+    co_await out.start_component(names.at(component_type::Data));
+    auto in = _sst->data_stream(_data_start, data_end - _data_start, pc, std::move(permit), {}, read_ahead_policy::range());
+    std::exception_ptr ex;
+    try {
+        while (auto buf = co_await in.read()) {
+            co_await out.consume(std::move(buf));
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await in.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+}
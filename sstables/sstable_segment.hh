@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <seastar/core/future.hh>
+#include <seastar/core/io_priority_class.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "sstables/shared_sstable.hh"
+#include "sstables/component_type.hh"
+#include "dht/i_partitioner.hh"
+#include "reader_permit.hh"
+
+namespace sstables {
+
+// Receives the component files of an sstable, one after another.
+class component_consumer {
+public:
+    virtual ~component_consumer() = default;
+    // Starts a new component, name is its file name suffix (e.g. "Data.db").
+    virtual future<> start_component(sstring name) = 0;
+    // Next chunk of the contents of the current component.
+    virtual future<> consume(temporary_buffer<char> data) = 0;
+};
+
+// Passes the contents of a component file of the sstable to out, as they
+// are on disk.
+future<> produce_component_file(const sstable& sst, component_type c, component_consumer& out, const seastar::io_priority_class& pc);
+
+// A contiguous run of partitions of an m-format sstable, the ones within a
+// token range, which can be turned into a standalone sstable without
+// parsing or re-serializing its rows.
+//
+// The standalone sstable is made of:
+//  - Data: the (uncompressed) byte range of the run in the data file,
+//  - Index: the index entries of the run, with data file positions rebased
+//    to the start of the run; promoted indexes are copied as they are,
+//    since their offsets are relative to the partition,
+//  - Statistics: copied from the original sstable. They hold the
+//    serialization header the data depends on, the rest of the statistics
+//    is an overestimate for the run.
+//  - Scylla: the original's, with the sharding metadata recomputed for the
+//    part of the original's token range within the segment's range, so
+//    that the receiver doesn't believe the run spans more shards than it
+//    does.
+//
+// Summary is regenerated from the index when the sstable is loaded. Filter,
+// compression and checksums are left out, so the sstable should be
+// rewritten by compaction soon after it is loaded, which is what
+// off-strategy compaction does with sstables received by streaming.
+class sstable_segment {
+    shared_sstable _sst;
+    dht::token_range _range;
+    // Position of the first index entry of the run.
+    uint64_t _index_start;
+    // Position of the first partition of the run in the data file.
+    uint64_t _data_start;
+private:
+    sstable_segment(shared_sstable sst, dht::token_range range, uint64_t index_start, uint64_t data_start);
+
+    // Writes the index entries of the run to out.
+    // Returns the data file position of the end of the run.
+    future<uint64_t> produce_index(component_consumer& out, const seastar::io_priority_class& pc);
+public:
+    // Returns true iff segments of the sstable can be extracted.
+    static bool is_supported(const sstable& sst);
+
+    // Finds the run of partitions of the sstable within the range.
+    // Returns a disengaged optional if there are no such partitions or
+    // if !is_supported(*sst).
+    static future<std::optional<sstable_segment>> find(shared_sstable sst, dht::token_range range, const seastar::io_priority_class& pc);
+
+    // Passes the components of the standalone sstable to out, TOC first.
+    future<> produce(component_consumer& out, reader_permit permit, const seastar::io_priority_class& pc);
+
+    const shared_sstable& get_sstable() const {
+        return _sst;
+    }
+
+    uint64_t data_start() const {
+        return _data_start;
+    }
+};
+
+}
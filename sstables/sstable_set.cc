@@ -6,17 +6,23 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/util/defer.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 #include <boost/icl/interval_map.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <boost/range/algorithm/sort.hpp>
+#include <boost/range/irange.hpp>
+#include <unordered_map>
 
 #include "compatible_ring_position.hh"
 #include "compaction/compaction_strategy_impl.hh"
 #include "compaction/leveled_compaction_strategy.hh"
 #include "compaction/time_window_compaction_strategy.hh"
+#include "compaction/incremental_compaction_strategy.hh"
 
 #include "sstable_set_impl.hh"
 
@@ -439,6 +445,10 @@ std::unique_ptr<incremental_selector_impl> time_series_sstable_set::make_increme
 // Guarantees that the filter will be called at most once for each sstable;
 // exactly once after all sstables are iterated over.
 //
+// If a maximum lower bound is given, sstables with greater lower bounds cannot contain
+// any of the queried rows. They are dropped as a whole, without calling the filter,
+// as soon as the queue reaches the first of them (they form a suffix of the container).
+//
 // The readers are created lazily on-demand using the supplied factory function.
 //
 // Additionally to the sstable readers, the queue always returns one ``dummy reader''
@@ -459,6 +469,8 @@ class sstable_position_reader_queue : public position_reader_queue {
 
     position_in_partition::tri_compare _cmp;
 
+    std::optional<position_in_partition> _max_lower_bound;
+
     std::function<flat_mutation_reader_v2(sstable&)> _create_reader;
     std::function<bool(const sstable&)> _filter;
 
@@ -477,6 +489,21 @@ class sstable_position_reader_queue : public position_reader_queue {
         return _filter(sst);
     }
 
+    // Advances _it to the first sstable, starting at _it, which is within
+    // _max_lower_bound and passes the filter.
+    void skip_filtered() {
+        while (_it != _end) {
+            if (_max_lower_bound && _cmp(_it->first, *_max_lower_bound) > 0) {
+                _it = _end;
+                break;
+            }
+            if (filter(*_it->second)) {
+                break;
+            }
+            ++_it;
+        }
+    }
+
 public:
     // Assumes that `create_reader` returns readers that emit only fragments from partition `pk`.
     //
@@ -488,21 +515,21 @@ class sstable_position_reader_queue : public position_reader_queue {
             partition_key pk,
             reader_permit permit,
             streamed_mutation::forwarding fwd_sm,
-            bool reversed)
+            bool reversed,
+            std::optional<position_in_partition> max_lower_bound)
         : _query_schema(std::move(query_schema))
         , _sstables(reversed ? set._sstables_reversed : set._sstables)
         , _it(_sstables->begin())
         , _end(_sstables->end())
         , _cmp(*_query_schema)
+        , _max_lower_bound(std::move(max_lower_bound))
         , _create_reader(std::move(create_reader))
         , _filter(std::move(filter))
         , _dummy_reader(upgrade_to_v2(make_flat_mutation_reader_from_mutations(_query_schema,
                 std::move(permit), {mutation(_query_schema, std::move(pk))}, _query_schema->full_slice(), fwd_sm)))
         , _reversed(reversed)
     {
-        while (_it != _end && !this->filter(*_it->second)) {
-            ++_it;
-        }
+        skip_filtered();
     }
 
     virtual ~sstable_position_reader_queue() override = default;
@@ -550,9 +577,7 @@ class sstable_position_reader_queue : public position_reader_queue {
 
         // filter(*_it->second) wasn't called yet since the inner `do..while` above checks _it != next first
         // restore the `_it` invariant before returning
-        while (_it != _end && !filter(*_it->second)) {
-            ++_it;
-        }
+        skip_filtered();
 
         return ret;
     }
@@ -574,10 +599,11 @@ std::unique_ptr<position_reader_queue> time_series_sstable_set::make_position_re
         std::function<flat_mutation_reader_v2(sstable&)> create_reader,
         std::function<bool(const sstable&)> filter,
         partition_key pk, schema_ptr query_schema, reader_permit permit,
-        streamed_mutation::forwarding fwd_sm, bool reversed) const {
+        streamed_mutation::forwarding fwd_sm, bool reversed,
+        std::optional<position_in_partition> max_lower_bound) const {
     return std::make_unique<sstable_position_reader_queue>(*this,
             std::move(query_schema), std::move(create_reader), std::move(filter),
-            std::move(pk), std::move(permit), fwd_sm, reversed);
+            std::move(pk), std::move(permit), fwd_sm, reversed, std::move(max_lower_bound));
 }
 
 std::unique_ptr<incremental_selector_impl> partitioned_sstable_set::make_incremental_selector() const {
@@ -597,6 +623,12 @@ std::unique_ptr<sstable_set_impl> time_window_compaction_strategy::make_sstable_
     return std::make_unique<time_series_sstable_set>(std::move(schema));
 }
 
+std::unique_ptr<sstable_set_impl> incremental_compaction_strategy::make_sstable_set(schema_ptr schema) const {
+    // Fragments of a run are disjoint, so they're kept in the interval map regardless of their level,
+    // allowing reads to skip fragments that don't overlap with the range being read.
+    return std::make_unique<partitioned_sstable_set>(std::move(schema), make_lw_shared<sstable_list>(), false);
+}
+
 sstable_set make_partitioned_sstable_set(schema_ptr schema, lw_shared_ptr<sstable_list> all, bool use_level_metadata) {
     return sstable_set(std::make_unique<partitioned_sstable_set>(schema, std::move(all), use_level_metadata), schema);
 }
@@ -612,6 +644,68 @@ using sstable_reader_factory_type = std::function<flat_mutation_reader_v2(shared
 
 static logging::logger irclogger("incremental_reader_selector");
 
+// Reads the sstables of a run, which don't overlap, one after the other,
+// opening each one only once the read reaches its first partition. So the
+// combined reader reading the run merges a single reader for it, rather
+// than one for each of its sstables.
+class sstable_run_reader_selector : public reader_selector {
+    const dht::partition_range* _pr;
+    // Sorted by their first partition.
+    std::vector<shared_sstable> _sstables;
+    size_t _next = 0;
+    sstable_reader_factory_type _fn;
+
+    // Moves past the sstables which end before the range, and sets the
+    // position at which the next sstable is to be opened.
+    void advance() {
+        dht::ring_position_comparator cmp(*_s);
+        auto start = dht::ring_position_view::for_range_start(*_pr);
+        while (_next < _sstables.size() && cmp(_sstables[_next]->get_last_decorated_key(), start) < 0) {
+            ++_next;
+        }
+        if (_next == _sstables.size() || cmp(_sstables[_next]->get_first_decorated_key(), dht::ring_position_view::for_range_end(*_pr)) > 0) {
+            _selector_position = dht::ring_position_view::max();
+        } else {
+            _selector_position = dht::ring_position_view(_sstables[_next]->get_first_decorated_key());
+        }
+    }
+public:
+    sstable_run_reader_selector(schema_ptr s, std::vector<shared_sstable> sstables, const dht::partition_range& pr, sstable_reader_factory_type fn)
+        : reader_selector(std::move(s), dht::ring_position_view::min())
+        , _pr(&pr)
+        , _sstables(std::move(sstables))
+        , _fn(std::move(fn)) {
+        advance();
+    }
+
+    virtual std::vector<flat_mutation_reader_v2> create_new_readers(const std::optional<dht::ring_position_view>& pos) override {
+        std::vector<flat_mutation_reader_v2> readers;
+        if (!_selector_position.is_max()) {
+            readers.push_back(_fn(_sstables[_next++], *_pr));
+            advance();
+        }
+        return readers;
+    }
+
+    virtual std::vector<flat_mutation_reader_v2> fast_forward_to(const dht::partition_range& pr) override {
+        _pr = &pr;
+        // The open reader, if any, is forwarded by the combined reader.
+        advance();
+        return {};
+    }
+
+    // Whether the sstables, sorted by their first partition, don't overlap.
+    static bool disjoint(const schema& s, const std::vector<shared_sstable>& sstables) {
+        dht::ring_position_comparator cmp(s);
+        for (size_t i = 1; i < sstables.size(); ++i) {
+            if (cmp(sstables[i - 1]->get_last_decorated_key(), sstables[i]->get_first_decorated_key()) >= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
 // Incremental selector implementation for combined_mutation_reader that
 // selects readers on-demand as the read progresses through the token
 // range.
@@ -622,24 +716,70 @@ class incremental_reader_selector : public reader_selector {
     std::optional<sstable_set::incremental_selector> _selector;
     std::unordered_set<int64_t> _read_sstable_gens;
     sstable_reader_factory_type _fn;
+    reader_permit _permit;
+    streamed_mutation::forwarding _fwd;
+    mutation_reader::forwarding _fwd_mr;
 
     flat_mutation_reader_v2 create_reader(shared_sstable sst) {
         tracing::trace(_trace_state, "Reading partition range {} from sstable {}", *_pr, seastar::value_of([&sst] { return sst->get_filename(); }));
         return _fn(sst, *_pr);
     }
 
+    // Creates a reader for each of the sstables, except that the sstables of
+    // a run are read by a single reader, see sstable_run_reader_selector.
+    std::vector<flat_mutation_reader_v2> create_readers(std::vector<shared_sstable> sstables) {
+        std::vector<flat_mutation_reader_v2> readers;
+        if (sstables.size() > 1) {
+            std::unordered_map<utils::UUID, std::vector<shared_sstable>> runs;
+            for (auto& sst : sstables) {
+                runs[sst->run_identifier()].push_back(std::move(sst));
+            }
+            dht::ring_position_less_comparator less(*_s);
+            for (auto& [_, run] : runs) {
+                boost::sort(run, [&less] (const shared_sstable& a, const shared_sstable& b) {
+                    return less(a->get_first_decorated_key(), b->get_first_decorated_key());
+                });
+                if (run.size() > 1 && sstable_run_reader_selector::disjoint(*_s, run)) {
+                    tracing::trace(_trace_state, "Reading partition range {} from a run of {} sstables", *_pr, run.size());
+                    // The run's reader may be closed after this selector is gone.
+                    auto fn = [fn = _fn, trace_state = _trace_state] (shared_sstable& sst, const dht::partition_range& pr) {
+                        tracing::trace(trace_state, "Reading partition range {} from sstable {}", pr, seastar::value_of([&sst] { return sst->get_filename(); }));
+                        return fn(sst, pr);
+                    };
+                    readers.push_back(make_combined_reader(_s, _permit,
+                            std::make_unique<sstable_run_reader_selector>(_s, std::move(run), *_pr, std::move(fn)), _fwd, _fwd_mr));
+                } else {
+                    for (auto& sst : run) {
+                        readers.push_back(create_reader(std::move(sst)));
+                    }
+                }
+            }
+        } else {
+            for (auto& sst : sstables) {
+                readers.push_back(create_reader(std::move(sst)));
+            }
+        }
+        return readers;
+    }
+
 public:
     explicit incremental_reader_selector(schema_ptr s,
             lw_shared_ptr<const sstable_set> sstables,
             const dht::partition_range& pr,
             tracing::trace_state_ptr trace_state,
-            sstable_reader_factory_type fn)
+            sstable_reader_factory_type fn,
+            reader_permit permit,
+            streamed_mutation::forwarding fwd,
+            mutation_reader::forwarding fwd_mr)
         : reader_selector(s, pr.start() ? pr.start()->value() : dht::ring_position_view::min())
         , _pr(&pr)
         , _sstables(std::move(sstables))
         , _trace_state(std::move(trace_state))
         , _selector(_sstables->make_incremental_selector())
-        , _fn(std::move(fn)) {
+        , _fn(std::move(fn))
+        , _permit(std::move(permit))
+        , _fwd(fwd)
+        , _fwd_mr(fwd_mr) {
 
         irclogger.trace("{}: created for range: {} with {} sstables",
                 fmt::ptr(this),
@@ -665,9 +805,8 @@ class incremental_reader_selector : public reader_selector {
             irclogger.trace("{}: {} sstables to consider, advancing selector to {}", fmt::ptr(this), selection.sstables.size(),
                     _selector_position);
 
-            readers = boost::copy_range<std::vector<flat_mutation_reader_v2>>(selection.sstables
-                    | boost::adaptors::filtered([this] (auto& sst) { return _read_sstable_gens.emplace(sst->generation()).second; })
-                    | boost::adaptors::transformed([this] (auto& sst) { return this->create_reader(sst); }));
+            readers = create_readers(boost::copy_range<std::vector<shared_sstable>>(selection.sstables
+                    | boost::adaptors::filtered([this] (auto& sst) { return _read_sstable_gens.emplace(sst->generation()).second; })));
         } while (!_selector_position.is_max() && readers.empty() && (!pos || dht::ring_position_tri_compare(*_s, *pos, _selector_position) >= 0));
 
         irclogger.trace("{}: created {} new readers", fmt::ptr(this), readers.size());
@@ -694,7 +833,8 @@ class incremental_reader_selector : public reader_selector {
 };
 
 // The returned function uses the bloom filter to check whether the given sstable
-// may have a partition given by the ring position `pos`.
+// may have a partition given by the ring position `pos`. Sstables whose partition
+// key bounds exclude the key are dropped before probing the filter.
 //
 // Returning `false` means the sstable doesn't have such a partition.
 // Returning `true` means it may, i.e. we don't know whether or not it does.
@@ -702,9 +842,10 @@ class incremental_reader_selector : public reader_selector {
 // Assumes the given `pos` and `schema` are alive during the function's lifetime.
 static std::predicate<const sstable&> auto
 make_pk_filter(const dht::ring_position& pos, const schema& schema) {
-    return [&pos, key = key::from_partition_key(schema, *pos.key()), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
+    return [&pos, &schema, key = key::from_partition_key(schema, *pos.key()), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
         return cmp(pos, sst.get_first_decorated_key()) >= 0 &&
                cmp(pos, sst.get_last_decorated_key()) <= 0 &&
+               sst.partition_key_in_bounds(schema, *pos.key()) &&
                sst.filter_has_key(key);
     };
 }
@@ -751,6 +892,124 @@ filter_sstable_for_reader_by_ck(std::vector<shared_sstable>&& sstables, replica:
     return std::move(sstables);
 }
 
+// Whether the sstable may have a partition tombstone for the partition read:
+// it has tombstones, and its clustering range doesn't rule out one.
+static bool may_have_partition_tombstone(const sstable& sst) {
+    return sst.get_stats_metadata().estimated_tombstone_drop_time.bin.size() && sst.may_have_partition_tombstones();
+}
+
+// Reads a single partition from sstables, some of which may have a partition
+// tombstone for it. The partition tombstones of those are peeked at, in
+// parallel, before the combined reader is created. The other sstables whose
+// data is all covered by the newest tombstone seen are not read at all, which
+// saves reading the partition from every sstable it was written to before it
+// was deleted.
+//
+// The reader is only used when an sstable other than the oldest may have a
+// partition tombstone, see may_have_partition_tombstone().
+class partition_tombstone_pruning_reader : public flat_mutation_reader_v2::impl {
+public:
+    using reader_factory = noncopyable_function<flat_mutation_reader_v2 (sstable&)>;
+private:
+    std::vector<shared_sstable> _sstables;
+    reader_factory _make_reader;
+    streamed_mutation::forwarding _fwd;
+    replica::cf_stats& _stats;
+    // Readers to combine with those of the sstables.
+    std::vector<flat_mutation_reader_v2> _readers;
+    std::optional<flat_mutation_reader_v2> _reader;
+
+    future<> open() {
+        auto readers = std::exchange(_readers, {});
+        readers.reserve(readers.size() + _sstables.size());
+        std::vector<std::optional<flat_mutation_reader_v2>> sstable_readers(_sstables.size());
+        tombstone covering;
+        const sstable* covering_sstable = nullptr;
+        std::exception_ptr ex;
+        try {
+            co_await parallel_for_each(boost::irange(size_t(0), _sstables.size()), [&] (size_t i) {
+                if (!may_have_partition_tombstone(*_sstables[i])) {
+                    return make_ready_future<>();
+                }
+                sstable_readers[i].emplace(_make_reader(*_sstables[i]));
+                return sstable_readers[i]->peek().then([&, i] (mutation_fragment_v2* mf) {
+                    if (mf && mf->is_partition_start() && mf->as_partition_start().partition_tombstone() > covering) {
+                        covering = mf->as_partition_start().partition_tombstone();
+                        covering_sstable = _sstables[i].get();
+                    }
+                });
+            });
+            for (size_t i = 0; i < _sstables.size(); ++i) {
+                auto& sst = _sstables[i];
+                if (covering && sst.get() != covering_sstable && sst->get_stats_metadata().max_timestamp <= covering.timestamp) {
+                    ++_stats.sstables_skipped_by_partition_tombstone;
+                    continue;
+                }
+                readers.push_back(sstable_readers[i] ? std::move(*std::exchange(sstable_readers[i], std::nullopt)) : _make_reader(*sst));
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        // The readers of the skipped sstables.
+        co_await parallel_for_each(sstable_readers, [] (std::optional<flat_mutation_reader_v2>& rd) {
+            return rd ? rd->close() : make_ready_future<>();
+        });
+        if (ex) {
+            co_await parallel_for_each(readers, [] (flat_mutation_reader_v2& rd) { return rd.close(); });
+            std::rethrow_exception(std::move(ex));
+        }
+        _reader = make_combined_reader(_schema, _permit, std::move(readers), _fwd, mutation_reader::forwarding::no);
+    }
+public:
+    partition_tombstone_pruning_reader(schema_ptr s, reader_permit permit, std::vector<shared_sstable> sstables, reader_factory make_reader,
+            std::vector<flat_mutation_reader_v2> readers, streamed_mutation::forwarding fwd, replica::cf_stats& stats)
+        : impl(std::move(s), std::move(permit))
+        , _sstables(std::move(sstables))
+        , _make_reader(std::move(make_reader))
+        , _fwd(fwd)
+        , _stats(stats)
+        , _readers(std::move(readers)) {
+    }
+
+    virtual future<> fill_buffer() override {
+        if (!_reader) {
+            co_await open();
+        }
+        co_await _reader->fill_buffer();
+        _reader->move_buffer_content_to(*this);
+        _end_of_stream = _reader->is_end_of_stream();
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty() && _reader) {
+            _end_of_stream = false;
+            return _reader->next_partition();
+        }
+        return make_ready_future<>();
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range&) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> fast_forward_to(position_range pr) override {
+        clear_buffer();
+        _end_of_stream = false;
+        if (!_reader) {
+            co_await open();
+        }
+        co_await _reader->fast_forward_to(std::move(pr));
+    }
+
+    virtual future<> close() noexcept override {
+        if (_reader) {
+            return _reader->close();
+        }
+        return parallel_for_each(_readers, [] (flat_mutation_reader_v2& rd) { return rd.close(); });
+    }
+};
+
 std::vector<sstable_run>
 sstable_set_impl::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     throw_with_backtrace<std::bad_function_call>();
@@ -775,14 +1034,11 @@ sstable_set_impl::create_single_key_sstable_reader(
     if (!num_sstables) {
         return make_empty_flat_reader_v2(schema, permit);
     }
-    auto readers = boost::copy_range<std::vector<flat_mutation_reader_v2>>(
-        filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice)
-        | boost::adaptors::transformed([&] (const shared_sstable& sstable) {
-            tracing::trace(trace_state, "Reading key {} from sstable {}", pos, seastar::value_of([&sstable] { return sstable->get_filename(); }));
-            return sstable->make_reader(schema, permit, pr, slice, pc, trace_state, fwd);
-        })
-    );
+    selected_sstables = filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice);
+    auto num_readers = selected_sstables.size();
 
+    std::vector<flat_mutation_reader_v2> readers;
+    readers.reserve(num_readers + 1);
     // If filter_sstable_for_reader_by_ck filtered any sstable that contains the partition
     // we want to emit partition_start/end if no rows were found,
     // to prevent https://github.com/scylladb/scylla/issues/3552.
@@ -791,11 +1047,33 @@ sstable_set_impl::create_single_key_sstable_reader(
     // the partition_start/end pair and append it to the list of readers passed
     // to make_combined_reader to ensure partition_start/end are emitted even if
     // all sstables actually containing the partition were filtered.
-    auto num_readers = readers.size();
     if (num_readers != num_sstables) {
         readers.push_back(upgrade_to_v2(make_flat_mutation_reader_from_mutations(schema, permit, {mutation(schema, *pos.key())}, slice, fwd)));
     }
     sstable_histogram.add(num_readers);
+
+    auto make_reader = [schema, permit, &pr, &slice, &pc, trace_state, fwd, &pos] (sstable& sstable) {
+        tracing::trace(trace_state, "Reading key {} from sstable {}", pos, seastar::value_of([&sstable] { return sstable.get_filename(); }));
+        return sstable.make_reader(schema, permit, pr, slice, pc, trace_state, fwd);
+    };
+
+    // Only sstables newer than the oldest one can make others redundant with
+    // their partition tombstone.
+    auto oldest = std::ranges::min_element(selected_sstables, std::less<>(), [] (const shared_sstable& sst) {
+        return sst->get_stats_metadata().max_timestamp;
+    });
+    bool may_prune = fwd_mr == mutation_reader::forwarding::no
+            && std::any_of(selected_sstables.begin(), selected_sstables.end(), [&] (const shared_sstable& sst) {
+        return sst != *oldest && may_have_partition_tombstone(*sst);
+    });
+    if (may_prune) {
+        return make_flat_mutation_reader_v2<partition_tombstone_pruning_reader>(schema, std::move(permit), std::move(selected_sstables),
+                std::move(make_reader), std::move(readers), fwd, *cf->cf_stats());
+    }
+
+    for (auto& sst : selected_sstables) {
+        readers.push_back(make_reader(*sst));
+    }
     return make_combined_reader(schema, std::move(permit), std::move(readers), fwd, fwd_mr);
 }
 
@@ -821,13 +1099,16 @@ time_series_sstable_set::create_single_key_sstable_reader(
     // 3. The sstables cannot have partition tombstones for the same reason as above.
     //    TWCS sstables will usually pass this condition.
     // 4. The optimized query path must be enabled.
+    // Conditions 1. and 3. only matter for sstables which may contain the queried partition,
+    // so sstables which don't satisfy them are checked against the partition key filter.
     using sst_entry = std::pair<position_in_partition, shared_sstable>;
+    auto pk_filter = make_pk_filter(pos, *schema);
     if (!cf->get_config().enable_optimized_twcs_queries
             || schema->has_static_columns()
             || std::any_of(_sstables->begin(), _sstables->end(),
-                [] (const sst_entry& e) {
-                    return e.second->get_version() < sstable_version_types::md
-                        || e.second->may_have_partition_tombstones();
+                [&pk_filter] (const sst_entry& e) {
+                    return (e.second->get_version() < sstable_version_types::md
+                        || e.second->may_have_partition_tombstones()) && pk_filter(*e.second);
     })) {
         // Some of the conditions were not satisfied so we use the standard query path.
         return sstable_set_impl::create_single_key_sstable_reader(
@@ -835,7 +1116,6 @@ time_series_sstable_set::create_single_key_sstable_reader(
                 pr, slice, pc, std::move(trace_state), fwd_sm, fwd_mr);
     }
 
-    auto pk_filter = make_pk_filter(pos, *schema);
     auto it = std::find_if(_sstables->begin(), _sstables->end(), [&] (const sst_entry& e) { return pk_filter(*e.second); });
     if (it == _sstables->end()) {
         // No sstables contain data for the queried partition.
@@ -849,7 +1129,25 @@ time_series_sstable_set::create_single_key_sstable_reader(
         return sst.make_reader(schema, permit, pr, slice, pc, trace_state, fwd_sm);
     };
 
-    auto ck_filter = [ranges = slice.get_all_ranges()] (const sstable& sst) { return sst.may_contain_rows(ranges); };
+    auto ranges = slice.get_all_ranges();
+    auto reversed = slice.is_reversed();
+
+    // Sstables are ordered by their lower bounds, so in forward reads, the ones with lower bounds
+    // after the end of all queried ranges form a suffix, which the queue can drop without looking
+    // at each of them. This is the common case for time series queries of recent data in
+    // partitions which span many windows.
+    std::optional<position_in_partition> max_lower_bound;
+    if (!reversed) {
+        position_in_partition::less_compare less(*schema);
+        for (auto& r : ranges) {
+            auto end = position_in_partition::for_range_end(r);
+            if (!max_lower_bound || less(*max_lower_bound, end)) {
+                max_lower_bound = std::move(end);
+            }
+        }
+    }
+
+    auto ck_filter = [ranges = std::move(ranges)] (const sstable& sst) { return sst.may_contain_rows(ranges); };
 
     // We're going to pass this filter into sstable_position_reader_queue. The queue guarantees that
     // the filter is going to be called at most once for each sstable and exactly once after
@@ -865,17 +1163,15 @@ time_series_sstable_set::create_single_key_sstable_reader(
                 ++stats.surviving_sstables_after_clustering_filter;
                 return true;
             }
-
             return false;
     };
 
-    auto reversed = slice.is_reversed();
     // Note that `sstable_position_reader_queue` always includes a reader which emits a `partition_start` fragment,
     // guaranteeing that the reader we return emits it as well; this helps us avoid the problem from #3552.
     return make_clustering_combined_reader(
             schema, permit, fwd_sm,
             make_position_reader_queue(
-                std::move(create_reader), std::move(filter), *pos.key(), schema, permit, fwd_sm, reversed));
+                std::move(create_reader), std::move(filter), *pos.key(), schema, permit, fwd_sm, reversed, std::move(max_lower_bound)));
 }
 
 compound_sstable_set::compound_sstable_set(schema_ptr schema, std::vector<lw_shared_ptr<sstable_set>> sets)
@@ -1089,11 +1385,14 @@ sstable_set::make_range_sstable_reader(
             (shared_sstable& sst, const dht::partition_range& pr) mutable {
         return sst->make_reader(s, permit, pr, slice, pc, trace_state, fwd, fwd_mr, monitor_generator(sst));
     };
-    return make_combined_reader(s, std::move(permit), std::make_unique<incremental_reader_selector>(s,
+    return make_combined_reader(s, permit, std::make_unique<incremental_reader_selector>(s,
                     shared_from_this(),
                     pr,
                     std::move(trace_state),
-                    std::move(reader_factory_fn)),
+                    std::move(reader_factory_fn),
+                    permit,
+                    fwd,
+                    fwd_mr),
             fwd,
             fwd_mr);
 }
@@ -1119,11 +1418,14 @@ sstable_set::make_local_shard_sstable_reader(
         auto sst = *sstables->begin();
         return reader_factory_fn(sst, pr);
     }
-    return make_combined_reader(s, std::move(permit), std::make_unique<incremental_reader_selector>(s,
+    return make_combined_reader(s, permit, std::make_unique<incremental_reader_selector>(s,
                     shared_from_this(),
                     pr,
                     std::move(trace_state),
-                    std::move(reader_factory_fn)),
+                    std::move(reader_factory_fn),
+                    permit,
+                    fwd,
+                    fwd_mr),
             fwd,
             fwd_mr);
 }
@@ -128,7 +128,8 @@ class time_series_sstable_set : public sstable_set_impl {
         std::function<bool(const sstable&)> filter,
         partition_key pk, schema_ptr schema, reader_permit permit,
         streamed_mutation::forwarding fwd_sm,
-        bool reversed) const;
+        bool reversed,
+        std::optional<position_in_partition> max_lower_bound = std::nullopt) const;
 
     virtual flat_mutation_reader_v2 create_single_key_sstable_reader(
         replica::column_family*,
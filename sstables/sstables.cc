@@ -831,7 +831,7 @@ future<> sstable::read_toc() noexcept {
 
 }
 
-void sstable::generate_toc(compressor_ptr c, double filter_fp_chance) {
+void sstable::generate_toc(compressor_ptr c, double filter_fp_chance, bool compression_dictionary) {
     // Creating table of components.
     _recognized_components.insert(component_type::TOC);
     _recognized_components.insert(component_type::Statistics);
@@ -846,6 +846,9 @@ void sstable::generate_toc(compressor_ptr c, double filter_fp_chance) {
         _recognized_components.insert(component_type::CRC);
     } else {
         _recognized_components.insert(component_type::CompressionInfo);
+        if (compression_dictionary && c->supports_dictionaries()) {
+            _recognized_components.insert(component_type::CompressionDictionary);
+        }
     }
     _recognized_components.insert(component_type::Scylla);
 }
@@ -985,6 +988,11 @@ future<> sstable::read_simple(T& component, const io_priority_class& pc) {
     auto file_path = filename(Type);
     sstlog.debug(("Reading " + sstable_version_constants::get_component_map(_version).at(Type) + " file {} ").c_str(), file_path);
     return new_sstable_component_file(_read_error_handler, Type, open_flags::ro).then([this, &component] (file fi) {
+        if constexpr (Type == component_type::Summary) {
+            fi = make_io_stats_file(std::move(fi), _io_stats, (*_io_stats)[component_io_stats::component::summary]);
+        } else if constexpr (Type == component_type::Filter) {
+            fi = make_io_stats_file(std::move(fi), _io_stats, (*_io_stats)[component_io_stats::component::filter]);
+        }
         auto fut = fi.size();
         return fut.then([this, &component, fi = std::move(fi)] (uint64_t size) {
             auto r = make_lw_shared<file_random_access_reader>(std::move(fi), size, sstable_buffer_size);
@@ -1056,7 +1064,24 @@ future<> sstable::read_compression(const io_priority_class& pc) {
         return make_ready_future<>();
     }
 
-    return read_simple<component_type::CompressionInfo>(_components->compression, pc);
+    return read_simple<component_type::CompressionInfo>(_components->compression, pc).then([this, &pc] {
+        if (!has_component(component_type::CompressionDictionary)) {
+            return make_ready_future<>();
+        }
+        return do_with(compression_dictionary_data{}, [this, &pc] (compression_dictionary_data& dict) {
+            return read_simple<component_type::CompressionDictionary>(dict, pc).then([this, &dict] {
+                if (dict.data.value.empty()) {
+                    return;
+                }
+                auto c = get_sstable_compressor(_components->compression);
+                if (!c || !c->supports_dictionaries()) {
+                    throw malformed_sstable_exception(format("compressor {} does not support dictionaries",
+                            c ? c->name() : sstring("none")), filename(component_type::CompressionDictionary));
+                }
+                _components->compression.dictionary = c->prepare_dictionary(std::move(dict.data.value));
+            });
+        });
+    });
 }
 
 void sstable::write_compression(const io_priority_class& pc) {
@@ -1065,6 +1090,13 @@ void sstable::write_compression(const io_priority_class& pc) {
     }
 
     write_simple<component_type::CompressionInfo>(_components->compression, pc);
+    if (has_component(component_type::CompressionDictionary)) {
+        compression_dictionary_data dict;
+        if (auto& d = _components->compression.dictionary) {
+            dict.data.value = bytes(d->raw());
+        }
+        write_simple<component_type::CompressionDictionary>(dict, pc);
+    }
 }
 
 void sstable::validate_partitioner() {
@@ -1254,6 +1286,11 @@ future<> sstable::open_data() noexcept {
         if (origin) {
             _origin = sstring(to_sstring_view(bytes_view(origin->value)));
         }
+        auto* pk_bounds = _components->scylla_metadata->data.get<scylla_metadata_type::PartitionKeyBounds, partition_key_bounds>();
+        if (pk_bounds) {
+            _partition_key_bounds.emplace(partition_key::from_bytes(managed_bytes_view(bytes_view(pk_bounds->min.value))),
+                    partition_key::from_bytes(managed_bytes_view(bytes_view(pk_bounds->max.value))));
+        }
     }).then([this] {
         _open_mode.emplace(open_flags::ro);
         _stats.on_open_for_reading();
@@ -1261,12 +1298,28 @@ future<> sstable::open_data() noexcept {
 }
 
 future<> sstable::update_info_for_opened_data() {
+    _data_file = make_io_stats_file(std::move(_data_file), _io_stats, (*_io_stats)[component_io_stats::component::data]);
+    _index_file = make_io_stats_file(std::move(_index_file), _io_stats, (*_io_stats)[component_io_stats::component::index]);
     return _data_file.stat().then([this] (struct stat st) {
         if (this->has_component(component_type::CompressionInfo)) {
             _components->compression.update(st.st_size);
         }
         _data_file_size = st.st_size;
         _data_file_write_time = db_clock::from_time_t(st.st_mtime);
+        // Reads from cold storage are slow, keep what was read in memory,
+        // within the budget of cold pages, so that they don't push the hot
+        // data out of the row cache. The wrapped data file counts the misses
+        // of the cache.
+        if (in_cold_storage()) {
+            assert(!_cached_data_file);
+            _cached_data_file = seastar::make_shared<cached_file>(_data_file,
+                                                                  cold_data_page_cache_metrics,
+                                                                  _manager.get_cold_data_lru(),
+                                                                  _manager.get_cache_tracker().region(),
+                                                                  _data_file_size);
+            _cached_data_file->set_lru_memory_limit(_manager.cold_data_cache_size());
+            _data_file = make_cached_seastar_file(*_cached_data_file);
+        }
     }).then([this] {
         return _index_file.size().then([this] (auto size) {
             _index_file_size = size;
@@ -1276,7 +1329,9 @@ future<> sstable::update_info_for_opened_data() {
                                                                    _manager.get_cache_tracker().get_lru(),
                                                                    _manager.get_cache_tracker().region(),
                                                                    _index_file_size);
-            _index_file = make_cached_seastar_file(*_cached_index_file);
+            // The wrapped index counts the misses of the cache, this one
+            // all the reads.
+            _index_file = make_io_stats_file(make_cached_seastar_file(*_cached_index_file), _io_stats, _io_stats->index_cache_requests);
         });
     }).then([this] {
         if (this->has_component(component_type::Filter)) {
@@ -1330,9 +1385,16 @@ future<> sstable::create_data() noexcept {
 future<> sstable::drop_caches() {
     return _cached_index_file->evict_gently().then([this] {
         return _index_cache->evict_gently();
+    }).then([this] {
+        return _cached_data_file ? _cached_data_file->evict_gently() : make_ready_future<>();
     });
 }
 
+bool sstable::in_cold_storage() const {
+    const auto& dir = _manager.config().cold_storage_directory();
+    return !dir.empty() && _dir.size() > dir.size() && _dir.starts_with(dir) && _dir[dir.size()] == '/';
+}
+
 future<> sstable::read_filter(const io_priority_class& pc) {
     if (!has_component(component_type::Filter)) {
         _components->filter = std::make_unique<utils::filter::always_present_filter>();
@@ -1344,6 +1406,13 @@ future<> sstable::read_filter(const io_priority_class& pc) {
         read_simple<component_type::Filter>(filter, pc).get();
         auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
         large_bitset bs(nr_bits, std::move(filter.buckets.elements));
+        if (filter.hashes == utils::filter::split_block_bloom_filter::on_disk_tag) {
+            if (!nr_bits || nr_bits % utils::filter::split_block_bloom_filter::bits_per_block) {
+                throw malformed_sstable_exception(format("Split block bloom filter has invalid size: {} bits", nr_bits), filename(component_type::Filter));
+            }
+            _components->filter = utils::filter::create_split_block_filter(std::move(bs));
+            return;
+        }
         utils::filter_format format = (_version >= sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
@@ -1356,6 +1425,12 @@ void sstable::write_filter(const io_priority_class& pc) {
         return;
     }
 
+    if (auto f = dynamic_cast<utils::filter::split_block_bloom_filter*>(_components->filter.get())) {
+        auto filter_ref = sstables::filter_ref(utils::filter::split_block_bloom_filter::on_disk_tag, f->bits().get_storage());
+        write_simple<component_type::Filter>(filter_ref, pc);
+        return;
+    }
+
     auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
@@ -1370,19 +1445,20 @@ future<> sstable::load(const io_priority_class& pc) noexcept {
         // read scylla-meta after toc. Might need it to parse
         // rest (hint extensions)
         return read_scylla_metadata(pc).then([this, &pc] {
-            // Read statistics ahead of others - if summary is missing
-            // we'll attempt to re-generate it and we need statistics for that
-            return read_statistics(pc).then([this, &pc] {
-                return seastar::when_all_succeed(
-                        read_compression(pc),
-                        read_filter(pc),
-                        read_summary(pc)).then_unpack([this] {
-                            validate_min_max_metadata();
-                            validate_max_local_deletion_time();
-                            validate_partitioner();
-                            return open_data();
-                        });
-            });
+            // Read statistics ahead of the summary - if summary is missing
+            // we'll attempt to re-generate it and we need statistics for that.
+            // The other components don't depend on them, read them meanwhile.
+            return seastar::when_all_succeed(
+                    read_statistics(pc).then([this, &pc] {
+                        return read_summary(pc);
+                    }),
+                    read_compression(pc),
+                    read_filter(pc)).then_unpack([this] {
+                        validate_min_max_metadata();
+                        validate_max_local_deletion_time();
+                        validate_partitioner();
+                        return open_data();
+                    });
         });
     });
 }
@@ -1469,18 +1545,13 @@ populate_statistics_offsets(sstable_version_types v, statistics& s) {
     }
 }
 
+// Appends the parts of prange owned by shard to sm.
+// Must be called in a seastar thread.
 static
-sharding_metadata
-create_sharding_metadata(schema_ptr schema, const dht::decorated_key& first_key, const dht::decorated_key& last_key, shard_id shard) {
-    auto prange = dht::partition_range::make(dht::ring_position(first_key), dht::ring_position(last_key));
-    auto sm = sharding_metadata();
+void
+add_sharding_metadata(sharding_metadata& sm, schema_ptr schema, const dht::partition_range& prange, shard_id shard) {
     auto&& ranges = dht::split_range_to_single_shard(*schema, prange, shard).get0();
-    if (ranges.empty()) {
-        auto split_ranges_all_shards = dht::split_range_to_shards(prange, *schema);
-        sstlog.warn("create_sharding_metadata: range={} has no intersection with shard={} first_key={} last_key={} ranges_single_shard={} ranges_all_shards={}",
-                prange, shard, first_key, last_key, ranges, split_ranges_all_shards);
-    }
-    sm.token_ranges.elements.reserve(ranges.size());
+    sm.token_ranges.elements.reserve(sm.token_ranges.elements.size() + ranges.size());
     for (auto&& range : std::move(ranges)) {
         if (true) { // keep indentation
             // we know left/right are not infinite
@@ -1495,6 +1566,19 @@ create_sharding_metadata(schema_ptr schema, const dht::decorated_key& first_key,
                 {right_exclusive, right_token.data()}});
         }
     }
+}
+
+static
+sharding_metadata
+create_sharding_metadata(schema_ptr schema, const dht::decorated_key& first_key, const dht::decorated_key& last_key, shard_id shard) {
+    auto prange = dht::partition_range::make(dht::ring_position(first_key), dht::ring_position(last_key));
+    auto sm = sharding_metadata();
+    add_sharding_metadata(sm, schema, prange, shard);
+    if (sm.token_ranges.elements.empty()) {
+        auto split_ranges_all_shards = dht::split_range_to_shards(prange, *schema);
+        sstlog.warn("create_sharding_metadata: range={} has no intersection with shard={} first_key={} last_key={} ranges_all_shards={}",
+                prange, shard, first_key, last_key, split_ranges_all_shards);
+    }
     return sm;
 }
 
@@ -1558,7 +1642,9 @@ sstable::read_scylla_metadata(const io_priority_class& pc) noexcept {
 
 void
 sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, struct run_identifier identifier,
-        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin) {
+        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin, std::optional<partition_key_bounds> pk_bounds,
+        std::optional<expiration_time_bounds> exp_bounds,
+        std::optional<token_histogram> histogram) {
     auto&& first_key = get_first_decorated_key();
     auto&& last_key = get_last_decorated_key();
     auto sm = create_sharding_metadata(_schema, first_key, last_key, shard);
@@ -1584,10 +1670,102 @@ sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, ssta
         o.value = bytes(to_bytes_view(sstring_view(origin)));
         _components->scylla_metadata->data.set<scylla_metadata_type::SSTableOrigin>(std::move(o));
     }
+    if (pk_bounds) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::PartitionKeyBounds>(std::move(*pk_bounds));
+    }
+    if (exp_bounds) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::ExpirationTimeBounds>(std::move(*exp_bounds));
+    }
+    if (histogram) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::TokenHistogram>(std::move(*histogram));
+    }
 
     write_simple<component_type::Scylla>(*_components->scylla_metadata, pc);
 }
 
+future<std::vector<temporary_buffer<char>>>
+sstable::make_segment_scylla_metadata(const dht::token_range& range) const {
+    return seastar::async([this, &range] {
+        auto prange = dht::partition_range::make(dht::ring_position(get_first_decorated_key()), dht::ring_position(get_last_decorated_key()))
+                .intersection(dht::to_partition_range(range), dht::ring_position_comparator(*_schema));
+        auto sm = sharding_metadata();
+        if (prange) {
+            for (auto shard : _shards) {
+                add_sharding_metadata(sm, _schema, *prange, shard);
+            }
+        }
+        if (sm.token_ranges.elements.empty()) {
+            throw std::runtime_error(format("Failed to generate sharding metadata for the segment of {} within {}", get_filename(), range));
+        }
+
+        // Only the sharding metadata differs from this sstable's, the rest
+        // is kept as it is.
+        auto m = *_components->scylla_metadata;
+        m.data.set<scylla_metadata_type::Sharding>(std::move(sm));
+
+        memory_data_sink_buffers bufs;
+        file_writer w(output_stream<char>(data_sink(std::make_unique<memory_data_sink>(bufs)), 4096));
+        write(_version, w, m);
+        w.close();
+        return std::vector<temporary_buffer<char>>(std::make_move_iterator(bufs.buffers().begin()), std::make_move_iterator(bufs.buffers().end()));
+    });
+}
+
+bool sstable::may_have_rows_expiring(std::string_view source, gc_clock::time_point from, gc_clock::time_point to) const {
+    if (!_components->scylla_metadata) {
+        return true;
+    }
+    auto* bounds = _components->scylla_metadata->data.get<scylla_metadata_type::ExpirationTimeBounds, expiration_time_bounds>();
+    if (!bounds || to_sstring_view(bounds->source.value) != source) {
+        return true;
+    }
+    auto seconds = [] (gc_clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+    };
+    return bounds->min <= seconds(to) && bounds->max >= seconds(from);
+}
+
+std::optional<partition_and_row_counts> sstable::estimated_counts_for_range(const dht::token_range& range) const {
+    if (!_components->scylla_metadata) {
+        return std::nullopt;
+    }
+    auto* histogram = _components->scylla_metadata->data.get<scylla_metadata_type::TokenHistogram, token_histogram>();
+    if (!histogram || !histogram->bucket_count) {
+        return std::nullopt;
+    }
+    // Positions in the ring, counted from its start.
+    using uint128_t = unsigned __int128;
+    const uint128_t ring_size = uint128_t(1) << 64;
+    auto position = [&] (const dht::token& t) -> uint128_t {
+        if (t.is_minimum()) {
+            return 0;
+        }
+        if (t.is_maximum()) {
+            return ring_size;
+        }
+        return uint64_t(t.raw()) + (uint64_t(1) << 63);
+    };
+    const uint128_t start = range.start() ? position(range.start()->value()) : 0;
+    const uint128_t end = range.end() ? position(range.end()->value()) : ring_size;
+    const uint128_t width = ring_size / histogram->bucket_count;
+
+    long double partitions = 0;
+    long double rows = 0;
+    for (auto& bucket : histogram->buckets.elements) {
+        const uint128_t bucket_start = bucket.index * width;
+        const uint128_t bucket_end = bucket_start + width;
+        const auto covered_start = std::max(start, bucket_start);
+        const auto covered_end = std::min(end, bucket_end);
+        if (covered_start >= covered_end) {
+            continue;
+        }
+        const long double fraction = (long double)(covered_end - covered_start) / (long double)width;
+        partitions += fraction * bucket.partitions;
+        rows += fraction * bucket.rows;
+    }
+    return partition_and_row_counts{uint64_t(std::llround(partitions)), uint64_t(std::llround(rows))};
+}
+
 bool sstable::may_contain_rows(const query::clustering_row_ranges& ranges) const {
     if (_version < sstables::sstable_version_types::md) {
         return true;
@@ -2214,8 +2392,38 @@ sstable::make_crawling_reader_v1(
     return kl::make_crawling_reader(shared_from_this(), std::move(schema), std::move(permit), pc, std::move(trace_state), monitor);
 }
 
+// Matches "(la|m[cde])-(\\d+)-(\\w+)-(.*)", the names of all but the oldest
+// sstables, without going through std::regex. Directories are scanned on
+// every shard, and their files are many.
+static bool match_la_mx_name(std::string_view name, std::string_view& version, std::string_view& generation,
+        std::string_view& format, std::string_view& component) {
+    if (name.size() < 3 || name[2] != '-'
+            || !(name.starts_with("la") || (name[0] == 'm' && name[1] >= 'c' && name[1] <= 'e'))) {
+        return false;
+    }
+    version = name.substr(0, 2);
+    name.remove_prefix(3);
+    auto is_word = [] (char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    auto generation_end = std::find_if_not(name.begin(), name.end(), [] (char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    if (generation_end == name.begin() || generation_end == name.end() || *generation_end != '-') {
+        return false;
+    }
+    generation = std::string_view(name.begin(), generation_end);
+    name.remove_prefix(generation.size() + 1);
+    auto format_end = std::find_if_not(name.begin(), name.end(), is_word);
+    if (format_end == name.begin() || format_end == name.end() || *format_end != '-') {
+        return false;
+    }
+    format = std::string_view(name.begin(), format_end);
+    name.remove_prefix(format.size() + 1);
+    if (name.find('\n') != std::string_view::npos) {
+        return false;
+    }
+    component = name;
+    return true;
+}
+
 static entry_descriptor make_entry_descriptor(sstring sstdir, sstring fname, sstring* const provided_ks, sstring* const provided_cf) {
-    static std::regex la_mx("(la|m[cde])-(\\d+)-(\\w+)-(.*)");
     static std::regex ka("(\\w+)-(\\w+)-ka-(\\d+)-(.*)");
 
     static std::regex dir(format(".*/([^/]*)/([^/]+)-[\\da-fA-F]+(?:/({}|{}|{}|{})(?:/[^/]+)?)?/?",
@@ -2239,21 +2447,29 @@ static entry_descriptor make_entry_descriptor(sstring sstdir, sstring fname, sst
 
     sstlog.debug("Make descriptor sstdir: {}; fname: {}", sstdir, fname);
     std::string s(fname);
-    if (std::regex_match(s, match, la_mx)) {
-        std::string sdir(sstdir);
-        std::smatch dirmatch;
+    std::string_view version_match, generation_match, format_match, component_match;
+    if (match_la_mx_name(s, version_match, generation_match, format_match, component_match)) {
         if (!ks_cf_provided) {
-            if (std::regex_match(sdir, dirmatch, dir)) {
-                ks = dirmatch[1].str();
-                cf = dirmatch[2].str();
-            } else {
-                throw malformed_sstable_exception(seastar::format("invalid path for file {}: {}. Path doesn't match known pattern.", fname, sstdir));
+            // All the files of a directory are usually described one after
+            // the other, match the directory only when it changes.
+            static thread_local sstring last_dir, last_ks, last_cf;
+            if (sstdir != last_dir) {
+                std::string sdir(sstdir);
+                std::smatch dirmatch;
+                if (!std::regex_match(sdir, dirmatch, dir)) {
+                    throw malformed_sstable_exception(seastar::format("invalid path for file {}: {}. Path doesn't match known pattern.", fname, sstdir));
+                }
+                last_ks = dirmatch[1].str();
+                last_cf = dirmatch[2].str();
+                last_dir = sstdir;
             }
+            ks = last_ks;
+            cf = last_cf;
         }
-        version = from_string(match[1].str());
-        generation = match[2].str();
-        format = sstring(match[3].str());
-        component = sstring(match[4].str());
+        version = from_string(sstring(version_match));
+        generation = sstring(generation_match);
+        format = sstring(format_match);
+        component = sstring(component_match);
     } else if (std::regex_match(s, match, ka)) {
         if (!ks_cf_provided) {
             ks = match[1].str();
@@ -2302,12 +2518,10 @@ component_type sstable::component_from_sstring(version_types v, sstring &s) {
 }
 
 input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-        reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history) {
+        reader_permit permit, tracing::trace_state_ptr trace_state, read_ahead_policy read_ahead) {
     file_input_stream_options options;
     options.buffer_size = sstable_buffer_size;
     options.io_priority_class = pc;
-    options.read_ahead = 4;
-    options.dynamic_adjustments = std::move(history);
 
     file f = make_tracked_file(_data_file, std::move(permit));
     if (trace_state) {
@@ -2318,18 +2532,18 @@ input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_prior
     if (_components->compression) {
         if (_version >= sstable_version_types::mc) {
              return make_compressed_file_m_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), read_ahead);
         } else {
             return make_compressed_file_k_l_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), read_ahead);
         }
     }
 
-    return make_file_input_stream(f, pos, len, std::move(options));
+    return make_adaptive_file_input_stream(f, pos, len, sstable_buffer_size, pc, read_ahead);
 }
 
 future<temporary_buffer<char>> sstable::data_read(uint64_t pos, size_t len, const io_priority_class& pc, reader_permit permit) {
-    return do_with(data_stream(pos, len, pc, std::move(permit), tracing::trace_state_ptr(), {}), [len] (auto& stream) {
+    return do_with(data_stream(pos, len, pc, std::move(permit), tracing::trace_state_ptr(), read_ahead_policy::none()), [len] (auto& stream) {
         return stream.read_exactly(len).finally([&stream] {
             return stream.close();
         });
@@ -2404,6 +2618,21 @@ void sstable::set_sstable_level(uint32_t new_level) {
     s.sstable_level = new_level;
 }
 
+void sstable::set_synthetic_metadata(uint64_t data_size, const partition_key& first, const partition_key& last,
+        stats_metadata stats, utils::UUID run_identifier) {
+    _data_file_size = data_size;
+    _bytes_on_disk = data_size;
+    _data_file_write_time = db_clock::now();
+    _components->statistics.contents[metadata_type::Stats] = std::make_unique<stats_metadata>(std::move(stats));
+    _components->summary.first_key.value = key::from_partition_key(*_schema, first).get_bytes();
+    _components->summary.last_key.value = key::from_partition_key(*_schema, last).get_bytes();
+    _first = {};
+    _last = {};
+    set_first_and_last_keys();
+    set_position_range();
+    _run_identifier = run_identifier;
+}
+
 future<> sstable::mutate_sstable_level(uint32_t new_level) {
     if (!has_component(component_type::Statistics)) {
         return make_ready_future<>();
@@ -2728,6 +2957,71 @@ future<bool> sstable::has_partition_key(const utils::hashed_key& hk, const dht::
     co_return present;
 }
 
+future<std::vector<std::optional<sstable::disk_read_range>>> sstable::find_partitions(const std::vector<dht::decorated_key>& keys) {
+    auto sem = reader_concurrency_semaphore(reader_concurrency_semaphore::no_limits{}, "sstables::find_partitions()");
+    std::exception_ptr ex;
+    std::vector<std::optional<disk_read_range>> ranges;
+    try {
+        ranges = co_await find_partitions(keys, sem.make_tracking_only_permit(_schema.get(), get_filename(), db::no_timeout), default_priority_class());
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await sem.stop();
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+    co_return ranges;
+}
+
+future<std::vector<std::optional<sstable::disk_read_range>>> sstable::find_partitions(const std::vector<dht::decorated_key>& keys, reader_permit permit,
+        const io_priority_class& pc) {
+    shared_sstable s = shared_from_this();
+    std::vector<std::optional<disk_read_range>> ranges(keys.size());
+    std::exception_ptr ex;
+    std::unique_ptr<sstables::index_reader> lh_index_ptr;
+    try {
+        lh_index_ptr = std::make_unique<sstables::index_reader>(s, std::move(permit), pc, tracing::trace_state_ptr(), use_caching::yes);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            const auto& dk = keys[i];
+            if (!filter_has_key(*_schema, dk)) {
+                continue;
+            }
+            // The cursor only moves forward: both the lookup of the key and
+            // of its successor below are non-decreasing in ring order.
+            bool present = co_await lh_index_ptr->advance_lower_and_check_if_present(dk);
+            if (!present) {
+                get_filter_tracker().add_false_positive();
+                continue;
+            }
+            get_filter_tracker().add_true_positive();
+            auto start = lh_index_ptr->data_file_positions().start;
+            co_await lh_index_ptr->advance_to(dht::ring_position_view::for_after_key(dk));
+            ranges[i] = disk_read_range(start, lh_index_ptr->data_file_positions().start);
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (lh_index_ptr) {
+        co_await lh_index_ptr->close();
+    }
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+    co_return ranges;
+}
+
+std::vector<sstable::disk_read_range> sstable::coalesce_read_ranges(std::vector<disk_read_range> ranges, uint64_t max_gap) {
+    std::vector<disk_read_range> result;
+    for (auto& r : ranges) {
+        if (!result.empty() && r.start <= result.back().end + max_gap) {
+            result.back().end = std::max(result.back().end, r.end);
+        } else {
+            result.push_back(r);
+        }
+    }
+    return result;
+}
+
 utils::hashed_key sstable::make_hashed_key(const schema& s, const partition_key& key) {
     return utils::make_hashed_key(static_cast<bytes_view>(key::from_partition_key(s, key)));
 }
@@ -2880,6 +3174,7 @@ future<> replay_pending_delete_log(sstring pending_delete_log) {
 thread_local sstables_stats::stats sstables_stats::_shard_stats;
 thread_local partition_index_cache::stats partition_index_cache::_shard_stats;
 thread_local cached_file::metrics index_page_cache_metrics;
+thread_local cached_file::metrics cold_data_page_cache_metrics;
 thread_local mc::cached_promoted_index::metrics promoted_index_cache_metrics;
 static thread_local seastar::metrics::metric_groups metrics;
 
@@ -2913,6 +3208,15 @@ future<> init_metrics() {
         sm::make_gauge("index_page_cache_bytes_in_std", [] { return index_page_cache_metrics.bytes_in_std; },
             sm::description("Total number of bytes in temporary buffers which live in the std allocator")),
 
+        sm::make_derive("cold_data_page_cache_hits", [] { return cold_data_page_cache_metrics.page_hits; },
+            sm::description("Page cache requests for data files in cold storage which were served from cache")),
+        sm::make_derive("cold_data_page_cache_misses", [] { return cold_data_page_cache_metrics.page_misses; },
+            sm::description("Page cache requests for data files in cold storage which had to read from cold storage")),
+        sm::make_derive("cold_data_page_cache_evictions", [] { return cold_data_page_cache_metrics.page_evictions; },
+            sm::description("Total number of pages of data files in cold storage which have been evicted")),
+        sm::make_gauge("cold_data_page_cache_bytes", [] { return cold_data_page_cache_metrics.cached_bytes; },
+            sm::description("Total number of bytes of data files in cold storage cached in memory")),
+
         sm::make_derive("pi_cache_hits_l0", [] { return promoted_index_cache_metrics.hits_l0; },
             sm::description("Number of requests for promoted index block in state l0 which didn't have to go to the page cache")),
         sm::make_derive("pi_cache_hits_l1", [] { return promoted_index_cache_metrics.hits_l1; },
@@ -2962,6 +3266,14 @@ future<> init_metrics() {
             sm::description("Number of partitions seeked")),
         sm::make_derive("row_reads", [] { return sstables_stats::get_shard_stats().row_reads; },
             sm::description("Number of rows read")),
+        sm::make_derive("index_reader_reuses", [] { return sstables_stats::get_shard_stats().index_reader_reuses; },
+            sm::description("Number of reads which reused a pooled index reader instead of creating a new one")),
+        sm::make_derive("shadowed_row_skips", [] { return sstables_stats::get_shard_stats().shadowed_row_skips; },
+            sm::description("Number of rows skipped without being read because a range tombstone shadowed all of the sstable's data")),
+        sm::make_derive("shadowed_partition_skips", [] { return sstables_stats::get_shard_stats().shadowed_partition_skips; },
+            sm::description("Number of partitions whose rows were skipped because the partition tombstone shadowed all of the sstable's data")),
+        sm::make_derive("last_row_finishes", [] { return sstables_stats::get_shard_stats().last_row_finishes; },
+            sm::description("Number of partitions finished right after their last requested row, without reading further, e.g. by single-row reads")),
 
         sm::make_counter("capped_local_deletion_time", [] { return sstables_stats::get_shard_stats().capped_local_deletion_time; },
             sm::description("Was local deletion time capped at maximum allowed value in Statistics")),
@@ -2985,6 +3297,11 @@ future<> init_metrics() {
         sm::make_derive("total_deleted", [] { return sstables_stats::get_shard_stats().deleted; },
             sm::description("Counter of deleted sstables")),
 
+        sm::make_derive("data_read_ahead_bytes", [] { return sstables_stats::get_shard_stats().data_read_ahead_bytes; },
+            sm::description("Bytes of data files read ahead of the reader")),
+        sm::make_derive("data_read_ahead_bytes_discarded", [] { return sstables_stats::get_shard_stats().data_read_ahead_bytes_discarded; },
+            sm::description("Bytes of data files read but discarded, because the reader skipped over them or stopped before them")),
+
         sm::make_gauge("bloom_filter_memory_size", [] { return utils::filter::bloom_filter::get_shard_stats().memory_size; },
             sm::description("Bloom filter memory usage in bytes.")),
     });
@@ -3027,6 +3344,7 @@ sstable::sstable(schema_ptr schema,
     , _write_error_handler(error_handler_gen(sstable_write_error))
     , _large_data_handler(large_data_handler)
     , _manager(manager)
+    , _io_stats(manager.get_io_stats(_schema->id()))
 {
     manager.add(this);
 }
@@ -3045,6 +3363,7 @@ void sstable::unused() {
 }
 
 future<> sstable::destroy() {
+    _index_reader_pool.clear();
     return close_files().finally([this] {
         return _index_cache->evict_gently().then([this] {
             if (_cached_index_file) {
@@ -3052,6 +3371,12 @@ future<> sstable::destroy() {
             } else {
                 return make_ready_future<>();
             }
+        }).then([this] {
+            if (_cached_data_file) {
+                return _cached_data_file->evict_gently();
+            } else {
+                return make_ready_future<>();
+            }
         });
     });
 }
@@ -3083,6 +3408,7 @@ std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp
     case ct::TemporaryTOC: out << "TemporaryTOC"; break;
     case ct::TemporaryStatistics: out << "TemporaryStatistics"; break;
     case ct::Scylla: out << "Scylla"; break;
+    case ct::CompressionDictionary: out << "CompressionDictionary"; break;
     case ct::Unknown: out << "Unknown"; break;
     }
     return out;
@@ -46,6 +46,8 @@
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
 #include "sstables/open_info.hh"
+#include "sstables/component_io_stats.hh"
+#include "sstables/read_ahead.hh"
 #include "query-request.hh"
 #include "mutation_fragment_stream_validator.hh"
 
@@ -54,6 +56,7 @@
 class sstable_assertions;
 class flat_mutation_reader;
 class cached_file;
+class row;
 
 namespace sstables {
 
@@ -108,12 +111,32 @@ struct sstable_writer_config {
     utils::UUID run_identifier = utils::make_random_uuid();
     size_t summary_byte_cost;
     sstring origin;
+    // Write a split block bloom filter instead of the classic one.
+    // Versions which don't know the split block format can't read such sstables.
+    bool split_block_bloom_filter = false;
+    // Train a dictionary on this worker, store it in the CompressionDictionary
+    // component and compress the data against it.
+    utils::alien_worker* compression_dictionary_trainer = nullptr;
 
 private:
     explicit sstable_writer_config() {}
     friend class sstables_manager;
 };
 
+// The number of buckets of the token_histogram of the sstables written.
+constexpr uint32_t token_histogram_bucket_count = 256;
+
+// The token_histogram bucket of the token, buckets being counted from the
+// start of the ring.
+inline uint32_t token_histogram_bucket_of(const dht::token& t) noexcept {
+    return (uint64_t(t.raw()) + (uint64_t(1) << 63)) / ((uint64_t(1) << 63) / token_histogram_bucket_count * 2);
+}
+
+struct partition_and_row_counts {
+    uint64_t partitions = 0;
+    uint64_t rows = 0;
+};
+
 constexpr const char* staging_dir = "staging";
 constexpr const char* upload_dir = "upload";
 constexpr const char* snapshots_dir = "snapshots";
@@ -142,6 +165,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     sstable(const sstable&) = delete;
     sstable(sstable&&) = delete;
 
+    // The number of closed index readers kept for reuse, see index_reader::make().
+    static constexpr size_t max_pooled_index_readers = 4;
+
     // disk_read_range describes a byte ranges covering part of an sstable
     // row that we need to read from disk. Usually this is the whole byte
     // range covering a single sstable row, but in very large rows we might
@@ -163,6 +189,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     static component_type component_from_sstring(version_types version, sstring& s);
     static version_types version_from_sstring(sstring& s);
     static format_types format_from_sstring(sstring& s);
+    static const sstring& format_to_sstring(format_types f) {
+        return _format_string.at(f);
+    }
     static sstring component_basename(const sstring& ks, const sstring& cf, version_types version, int64_t generation,
                                       format_types format, component_type component);
     static sstring component_basename(const sstring& ks, const sstring& cf, version_types version, int64_t generation,
@@ -338,6 +367,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _version;
     }
 
+    format_types get_format() const {
+        return _format;
+    }
+
     // Returns the total bytes of all components.
     uint64_t bytes_on_disk() const;
 
@@ -404,6 +437,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _dir;
     }
 
+    // Whether the sstable lives under the cold_storage_directory.
+    bool in_cold_storage() const;
+
     const sstring get_temp_dir() const {
         return temp_sst_dir(_dir, _generation);
     }
@@ -503,6 +539,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     file _index_file;
     seastar::shared_ptr<cached_file> _cached_index_file;
     file _data_file;
+    // Caches the pages of the data file of sstables in cold storage.
+    seastar::shared_ptr<cached_file> _cached_data_file;
     uint64_t _data_file_size;
     uint64_t _index_file_size;
     uint64_t _filter_file_size = 0;
@@ -515,8 +553,6 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     utils::UUID _run_identifier;
     utils::observable<sstable&> _on_closed;
 
-    lw_shared_ptr<file_input_stream_history> _single_partition_history = make_lw_shared<file_input_stream_history>();
-    lw_shared_ptr<file_input_stream_history> _partition_range_history = make_lw_shared<file_input_stream_history>();
     lw_shared_ptr<file_input_stream_history> _index_history = make_lw_shared<file_input_stream_history>();
 
     schema_ptr _schema;
@@ -528,6 +564,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     filter_tracker _filter_tracker;
     std::unique_ptr<partition_index_cache> _index_cache;
+    std::vector<std::unique_ptr<index_reader>> _index_reader_pool;
 
     enum class mark_for_deletion {
         implicit = -1,
@@ -543,6 +580,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     db::large_data_handler& _large_data_handler;
     sstables_manager& _manager;
+    lw_shared_ptr<component_io_stats> _io_stats;
 
     sstables_stats _stats;
     manager_link_type _manager_link;
@@ -554,6 +592,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // information in their scylla metadata.
     std::optional<scylla_metadata::large_data_stats> _large_data_stats;
     sstring _origin;
+    // See partition_key_bounds, only for sstables which have them.
+    std::optional<std::pair<partition_key, partition_key>> _partition_key_bounds;
 public:
     const bool has_component(component_type f) const;
     sstables_manager& manager() { return _manager; }
@@ -582,7 +622,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     future<> touch_temp_dir();
     future<> remove_temp_dir();
 
-    void generate_toc(compressor_ptr c, double filter_fp_chance);
+    void generate_toc(compressor_ptr c, double filter_fp_chance, bool compression_dictionary = false);
     void write_toc(const io_priority_class& pc);
     future<> seal_sstable();
 
@@ -590,8 +630,14 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     void write_compression(const io_priority_class& pc);
 
     future<> read_scylla_metadata(const io_priority_class& pc) noexcept;
+    // Serializes the Scylla component of an sstable holding the part of this
+    // sstable's data within range (see sstable_segment), with the sharding
+    // metadata recomputed for that part.
+    future<std::vector<temporary_buffer<char>>> make_segment_scylla_metadata(const dht::token_range& range) const;
     void write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, run_identifier identifier,
-            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin);
+            std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin,
+            std::optional<partition_key_bounds> pk_bounds = {}, std::optional<expiration_time_bounds> exp_bounds = {},
+            std::optional<token_histogram> histogram = {});
 
     future<> read_filter(const io_priority_class& pc);
 
@@ -639,9 +685,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // data incrementally as a stream. Knowing in advance the exact amount
     // of bytes to be read using this stream, we can make better choices
     // about the buffer size to read, and where exactly to stop reading
-    // (even when a large buffer size is used).
+    // (even when a large buffer size is used). How far the stream reads
+    // ahead adapts to how it is consumed, see read_ahead_policy.
     input_stream<char> data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-            reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history);
+            reader_permit permit, tracing::trace_state_ptr trace_state, read_ahead_policy read_ahead);
 
     // Read exactly the specific byte range from the data file (after
     // uncompression, if the file is compressed). This can be used to read
@@ -735,6 +782,22 @@ class sstable : public enable_lw_shared_from_this<sstable> {
      */
     future<bool> has_partition_key(const utils::hashed_key& hk, const dht::decorated_key& dk);
 
+    /*!
+     * \brief look up several partitions with a single index cursor.
+     * keys must be sorted in ring order and distinct. Returns, for each key,
+     * the data file range of its partition, or std::nullopt if the sstable
+     * doesn't contain it. Keys rejected by the filter don't touch the index,
+     * and index pages are read at most once for the whole batch.
+     */
+    future<std::vector<std::optional<disk_read_range>>> find_partitions(const std::vector<dht::decorated_key>& keys);
+    // As above, with the index reads admitted by permit, and done in class pc.
+    future<std::vector<std::optional<disk_read_range>>> find_partitions(const std::vector<dht::decorated_key>& keys, reader_permit permit,
+            const io_priority_class& pc);
+
+    // Merges ranges (sorted by start) separated by at most max_gap bytes,
+    // so that a batch of nearby partitions can be read with fewer I/Os.
+    static std::vector<disk_read_range> coalesce_read_ranges(std::vector<disk_read_range> ranges, uint64_t max_gap);
+
     bool filter_has_key(utils::hashed_key key) const {
         return _components->filter->is_present(key);
     }
@@ -743,6 +806,26 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return filter_has_key(key::from_partition_key(s, key));
     }
 
+    // Returns false if the key is outside the partition key bounds of the sstable,
+    // so it can't be in it. Returns true if it may be, or if the sstable has no bounds.
+    bool partition_key_in_bounds(const schema& s, partition_key_view key) const {
+        if (!_partition_key_bounds) {
+            return true;
+        }
+        partition_key::tri_compare cmp(s);
+        return cmp(key, _partition_key_bounds->first) >= 0 && cmp(key, _partition_key_bounds->second) <= 0;
+    }
+
+    // Returns false if the sstable has no row whose expiration time, taken from \p source
+    // (see row_expiration), is within [from, to]. Returns true if it may have one, or if
+    // the sstable has no expiration_time_bounds taken from \p source.
+    bool may_have_rows_expiring(std::string_view source, gc_clock::time_point from, gc_clock::time_point to) const;
+
+    // Returns the estimated numbers of partitions and rows of the sstable in the range,
+    // from its token_histogram, or std::nullopt if it has none. The counts of a bucket
+    // the range covers in part are scaled by the fraction of its width it covers.
+    std::optional<partition_and_row_counts> estimated_counts_for_range(const dht::token_range& range) const;
+
     static utils::hashed_key make_hashed_key(const schema& s, const partition_key& key);
 
     filter_tracker& get_filter_tracker() { return _filter_tracker; }
@@ -813,6 +896,12 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // This will change sstable level only in memory.
     void set_sstable_level(uint32_t);
 
+    // Makes the sstable, which has no files, describe data it doesn't have.
+    // Meant for simulating compaction strategies, which only look at the
+    // metadata of sstables. Such an sstable cannot be read or written.
+    void set_synthetic_metadata(uint64_t data_size, const partition_key& first, const partition_key& last,
+            stats_metadata stats, utils::UUID run_identifier);
+
     double get_compression_ratio() const;
 
     const sstables::compression& get_compression() const {
@@ -871,6 +960,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     friend class sstable_writer;
     friend class mc::writer;
     friend class index_reader;
+    friend class sstable_segment;
     friend class promoted_index;
     friend class compaction;
     friend class sstables_manager;
@@ -930,4 +1020,24 @@ class file_io_extension {
     }
 };
 
+// Where the rows of a table expire according to their own data, rather than
+// to the TTL of their cells - like the expiration-time attribute of Alternator.
+struct row_expiration {
+    // What the expiration times are taken from, say the name of the column.
+    // Recorded with them, so that they aren't used once the source changes.
+    sstring source;
+    // The expiration time of a clustering row, from its cells, if it has one.
+    noncopyable_function<std::optional<gc_clock::time_point>(const row&)> expiration_time;
+};
+
+// Lets the writer record the earliest and latest expiration times of the rows
+// of an sstable (see expiration_time_bounds), which lets scans for expired rows
+// skip sstables.
+class row_expiration_extension {
+public:
+    virtual ~row_expiration_extension() {}
+    // Returns std::nullopt if the rows of the table don't expire.
+    virtual std::optional<row_expiration> get_row_expiration(const schema&) const = 0;
+};
+
 }
@@ -9,6 +9,7 @@
 #include "log.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/partition_index_cache.hh"
+#include "sstables/index_reader.hh"
 #include "sstables/sstables.hh"
 #include "db/config.hh"
 #include "gms/feature.hh"
@@ -19,8 +20,9 @@ namespace sstables {
 logging::logger smlogger("sstables_manager");
 
 sstables_manager::sstables_manager(
-    db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker& ct)
-    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat), _cache_tracker(ct) {
+    db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker& ct,
+    utils::alien_worker* alien_worker)
+    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat), _alien_worker(alien_worker), _cache_tracker(ct) {
 }
 
 sstables_manager::~sstables_manager() {
@@ -29,10 +31,33 @@ sstables_manager::~sstables_manager() {
     assert(_undergoing_close.empty());
 }
 
+uint64_t sstables_manager::cold_data_cache_size() const noexcept {
+    return (uint64_t(_db_config.cold_storage_page_cache_size_in_mb()) << 20) / smp::count;
+}
+
 const utils::UUID& sstables_manager::get_local_host_id() const {
     return _db_config.host_id;
 }
 
+lw_shared_ptr<component_io_stats> sstables_manager::get_io_stats(const utils::UUID& id) {
+    auto [it, inserted] = _io_stats.try_emplace(id);
+    if (inserted) {
+        it->second = make_lw_shared<component_io_stats>();
+    }
+    return it->second;
+}
+
+void sstables_manager::for_each_io_stats(std::function<void (const utils::UUID&, const component_io_stats&)> func) {
+    for (auto it = _io_stats.begin(); it != _io_stats.end();) {
+        func(it->first, *it->second);
+        if (it->second.owned()) {
+            it = _io_stats.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 shared_sstable sstables_manager::make_sstable(schema_ptr schema,
         sstring dir,
         int64_t generation,
@@ -52,6 +77,15 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    // Nodes which don't know the split block format would take its tag for
+    // the hash count of a classic filter.
+    cfg.split_block_bloom_filter = _db_config.enable_sstable_split_block_bloom_filter()
+            && _features.cluster_supports_split_block_bloom_filter();
+    // Nodes which don't know the CompressionDictionary component would read
+    // the data as if it was compressed without one.
+    if (_db_config.enable_sstable_compression_dictionaries() && _features.cluster_supports_sstable_compression_dictionaries()) {
+        cfg.compression_dictionary_trainer = _alien_worker;
+    }
 
     cfg.origin = std::move(origin);
 
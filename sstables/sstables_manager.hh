@@ -20,9 +20,13 @@
 #include "sstables/sstables.hh"
 #include "sstables/version.hh"
 #include "sstables/component_type.hh"
+#include "sstables/component_io_stats.hh"
 #include "db/cache_tracker.hh"
+#include "utils/lru.hh"
 
 #include <boost/intrusive/list.hpp>
+#include <functional>
+#include <unordered_map>
 
 namespace db {
 
@@ -33,6 +37,8 @@ class config;
 
 namespace gms { class feature_service; }
 
+namespace utils { class alien_worker; }
+
 namespace sstables {
 
 using schema_ptr = lw_shared_ptr<const schema>;
@@ -48,6 +54,8 @@ class sstables_manager {
     db::large_data_handler& _large_data_handler;
     const db::config& _db_config;
     gms::feature_service& _features;
+    // Trains compression dictionaries, if set.
+    utils::alien_worker* _alien_worker;
     // _sstables_format is the format used for writing new sstables.
     // Here we set its default value, but if we discover that all the nodes
     // in the cluster support a newer format, _sstables_format will be set to
@@ -65,8 +73,14 @@ class sstables_manager {
     bool _closing = false;
     promise<> _done;
     cache_tracker& _cache_tracker;
+    // Holds the pages of the data files of the sstables in cold storage, apart from
+    // the cache's LRU, so that they have their own memory budget.
+    lru _cold_data_lru;
+    // Shared by the sstables of each table, so it outlives them.
+    std::unordered_map<utils::UUID, lw_shared_ptr<component_io_stats>> _io_stats;
 public:
-    explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker&);
+    explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker&,
+            utils::alien_worker* alien_worker = nullptr);
     virtual ~sstables_manager();
 
     // Constructs a shared sstable
@@ -82,12 +96,21 @@ class sstables_manager {
     virtual sstable_writer_config configure_writer(sstring origin) const;
     const db::config& config() const { return _db_config; }
     cache_tracker& get_cache_tracker() { return _cache_tracker; }
+    lru& get_cold_data_lru() noexcept { return _cold_data_lru; }
+    // The memory budget of the pages in get_cold_data_lru().
+    uint64_t cold_data_cache_size() const noexcept;
 
     void set_format(sstable_version_types format) noexcept { _format = format; }
     sstables::sstable::version_types get_highest_supported_format() const noexcept { return _format; }
 
     const utils::UUID& get_local_host_id() const;
 
+    // The reads of the components of the sstables of table \p id.
+    lw_shared_ptr<component_io_stats> get_io_stats(const utils::UUID& id);
+    // Calls func(table id, stats) for the tables whose sstables were read
+    // from. Stops tracking the tables which have no sstables left.
+    void for_each_io_stats(std::function<void (const utils::UUID&, const component_io_stats&)> func);
+
     // Wait until all sstables managed by this sstables_manager instance
     // (previously created by make_sstable()) have been disposed of:
     //   - if they were marked for deletion, the files are deleted
@@ -28,6 +28,10 @@ class sstables_stats {
         uint64_t partition_reads = 0;
         uint64_t partition_seeks = 0;
         uint64_t row_reads = 0;
+        uint64_t index_reader_reuses = 0;
+        uint64_t shadowed_row_skips = 0;
+        uint64_t shadowed_partition_skips = 0;
+        uint64_t last_row_finishes = 0;
         uint64_t capped_local_deletion_time = 0;
         uint64_t capped_tombstone_deletion_time = 0;
         uint64_t open_for_reading = 0;
@@ -35,6 +39,8 @@ class sstables_stats {
         uint64_t open_for_writing = 0;
         uint64_t closed_for_writing = 0;
         uint64_t deleted = 0;
+        uint64_t data_read_ahead_bytes = 0;
+        uint64_t data_read_ahead_bytes_discarded = 0;
     } _shard_stats;
 
     stats& _stats = _shard_stats;
@@ -100,6 +106,22 @@ class sstables_stats {
         ++_stats.row_reads;
     }
 
+    inline void on_index_reader_reuse() noexcept {
+        ++_stats.index_reader_reuses;
+    }
+
+    inline void on_shadowed_row_skip() noexcept {
+        ++_stats.shadowed_row_skips;
+    }
+
+    inline void on_shadowed_partition_skip() noexcept {
+        ++_stats.shadowed_partition_skips;
+    }
+
+    inline void on_last_row_finish() noexcept {
+        ++_stats.last_row_finishes;
+    }
+
     inline void on_capped_local_deletion_time() noexcept {
         ++_stats.capped_local_deletion_time;
     }
@@ -125,6 +147,13 @@ class sstables_stats {
     inline void on_delete() noexcept {
         ++_stats.deleted;
     }
+
+    inline void on_data_read_ahead(uint64_t bytes) noexcept {
+        _stats.data_read_ahead_bytes += bytes;
+    }
+    inline void on_data_read_ahead_discarded(uint64_t bytes) noexcept {
+        _stats.data_read_ahead_bytes_discarded += bytes;
+    }
 };
 
 }
@@ -102,6 +102,15 @@ struct filter {
     explicit filter(int hashes, utils::chunked_vector<uint64_t> buckets) : hashes(hashes), buckets({std::move(buckets)}) {}
 };
 
+// Dictionary shared by all compressed chunks of the Data component.
+// Empty if the writer couldn't train a useful one.
+struct compression_dictionary_data {
+    disk_string<uint32_t> data;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(data); }
+};
+
 // Do this so we don't have to copy on write time. We can just keep a reference.
 struct filter_ref {
     uint32_t hashes;
@@ -525,6 +534,11 @@ enum class scylla_metadata_type : uint32_t {
     RunIdentifier = 4,
     LargeDataStats = 5,
     SSTableOrigin = 6,
+    // Numbered apart from the entries above, so that entries added there
+    // never take their identifiers.
+    PartitionKeyBounds = 1000,
+    ExpirationTimeBounds = 1001,
+    TokenHistogram = 1002,
 };
 
 struct run_identifier {
@@ -556,6 +570,56 @@ struct large_data_stats_entry {
     auto describe_type(sstable_version_types v, Describer f) { return f(max_value, threshold, above_threshold); }
 };
 
+// The smallest and the largest partition keys of the sstable, in the order
+// of the keys themselves rather than the ring order, serialized as
+// partition_key. For tables whose partition keys grow with time they
+// fence off sstables which can't have a key much cheaper than the bloom
+// filter, whatever its false-positive chance.
+struct partition_key_bounds {
+    disk_string<uint32_t> min;
+    disk_string<uint32_t> max;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(min, max); }
+};
+
+// The earliest and latest expiration times, in seconds since the epoch, of
+// the rows of the sstable which have one according to the table's
+// row_expiration_extension, and the source they were taken from (see
+// row_expiration). Lets a scan for expired rows skip the sstables which
+// can't have any. Both are std::numeric_limits<int64_t>::max() if no row
+// has an expiration time.
+struct expiration_time_bounds {
+    disk_string<uint16_t> source;
+    int64_t min;
+    int64_t max;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(source, min, max); }
+};
+
+// The partitions of the sstable and their rows, counted by token range. The
+// token ring is split into bucket_count ranges of equal width, and each of
+// the buckets holds the counts of a range which has partitions, in ring
+// order. Lets range size estimates and approximate counts be computed
+// without reading the sstable.
+struct token_histogram_bucket {
+    uint32_t index;
+    uint64_t partitions;
+    uint64_t rows;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(index, partitions, rows); }
+};
+
+struct token_histogram {
+    uint32_t bucket_count;
+    disk_array<uint32_t, token_histogram_bucket> buckets;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(bucket_count, buckets); }
+};
+
 struct scylla_metadata {
     using extension_attributes = disk_hash<uint32_t, disk_string<uint32_t>, disk_string<uint32_t>>;
     using large_data_stats = disk_hash<uint32_t, large_data_type, large_data_stats_entry>;
@@ -567,7 +631,10 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ExtensionAttributes, extension_attributes>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::RunIdentifier, run_identifier>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::LargeDataStats, large_data_stats>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::PartitionKeyBounds, partition_key_bounds>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ExpirationTimeBounds, expiration_time_bounds>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::TokenHistogram, token_histogram>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -7,6 +7,7 @@
  */
 
 #include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/rpc/rpc.hh>
 #include "sstables_loader.hh"
 #include "replica/distributed_loader.hh"
@@ -16,6 +17,13 @@
 #include "streaming/stream_mutation_fragments_cmd.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "message/messaging_service.hh"
+#include "service/storage_proxy.hh"
+#include "db/config.hh"
+#include "mutation.hh"
+#include "flat_mutation_reader.hh"
+#include "service/priority_manager.hh"
+#include "sstables/sstables_manager.hh"
+#include "marshal_exception.hh"
 
 #include <cfloat>
 
@@ -233,6 +241,187 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
     co_return;
 }
 
+namespace {
+
+// Parses the rows of a bulk load one at a time.
+class bulk_load_row_parser {
+    schema_ptr _s;
+    bytes_view _in;
+    api::timestamp_type _ts;
+    cql_serialization_format _sf = cql_serialization_format::internal();
+    std::vector<bytes_view> _components;
+private:
+    // Returns the next value of the row, or std::nullopt if the column is unset.
+    std::optional<bytes_view> read_value(const column_definition& cdef) {
+        if (_in.size() < sizeof(int32_t)) {
+            throw bulk_load_error(format("Bulk load row truncated at the length of column {}", cdef.name_as_text()));
+        }
+        auto len = read_simple<int32_t>(_in);
+        if (len < 0) {
+            return std::nullopt;
+        }
+        if (size_t(len) > _in.size()) {
+            throw bulk_load_error(format("Bulk load value of column {} truncated: expected {} bytes, got {}", cdef.name_as_text(), len, _in.size()));
+        }
+        auto v = _in.substr(0, len);
+        _in.remove_prefix(len);
+        try {
+            cdef.type->validate(v, _sf);
+        } catch (const marshal_exception& e) {
+            throw bulk_load_error(format("Invalid bulk load value of column {}: {}", cdef.name_as_text(), e.what()));
+        }
+        return v;
+    }
+
+    void read_key(const schema::const_iterator_range_type& columns) {
+        _components.clear();
+        for (auto& cdef : columns) {
+            auto v = read_value(cdef);
+            if (!v) {
+                throw bulk_load_error(format("Bulk load row misses a value of key column {}", cdef.name_as_text()));
+            }
+            _components.push_back(*v);
+        }
+    }
+
+    std::optional<atomic_cell> read_cell(const column_definition& cdef) {
+        auto v = read_value(cdef);
+        if (!v) {
+            return std::nullopt;
+        }
+        return atomic_cell::make_live(*cdef.type, _ts, *v);
+    }
+public:
+    bulk_load_row_parser(schema_ptr s, bytes_view in, api::timestamp_type ts)
+        : _s(std::move(s)), _in(in), _ts(ts) {
+        for (auto& cdef : _s->all_columns()) {
+            if (cdef.type->is_multi_cell() || cdef.is_counter()) {
+                throw bulk_load_error(format("Bulk loading table {}.{} is not supported: column {} is a counter or a non-frozen collection",
+                        _s->ks_name(), _s->cf_name(), cdef.name_as_text()));
+            }
+        }
+    }
+
+    bool empty() const {
+        return _in.empty();
+    }
+
+    size_t remaining() const {
+        return _in.size();
+    }
+
+    // Parses the next row into a mutation of its partition.
+    mutation next_row() {
+        read_key(_s->partition_key_columns());
+        auto dk = dht::decorate_key(*_s, partition_key::from_exploded_view(_components));
+        mutation m(_s, std::move(dk));
+
+        read_key(_s->clustering_key_columns());
+        auto ck = clustering_key::from_exploded_view(_components);
+
+        for (auto& cdef : _s->static_columns()) {
+            if (auto cell = read_cell(cdef)) {
+                m.set_static_cell(cdef, std::move(*cell));
+            }
+        }
+        auto& row = m.partition().clustered_row(*_s, std::move(ck));
+        row.apply(row_marker(_ts));
+        for (auto& cdef : _s->regular_columns()) {
+            if (auto cell = read_cell(cdef)) {
+                row.cells().apply(cdef, std::move(*cell));
+            }
+        }
+        return m;
+    }
+};
+
+// Appends the row to the batch, merging it into the last mutation if it
+// belongs to the same partition.
+void append_bulk_load_row(const schema& s, std::vector<mutation>& batch, mutation row) {
+    if (!batch.empty() && batch.back().decorated_key().equal(s, row.decorated_key())) {
+        batch.back().apply(std::move(row));
+    } else {
+        batch.push_back(std::move(row));
+    }
+}
+
+// Sorts the batch in ring order, merging the mutations of the same partition.
+future<> sort_bulk_load_batch(const schema& s, std::vector<mutation>& batch) {
+    std::sort(batch.begin(), batch.end(), [&s] (const mutation& a, const mutation& b) {
+        return a.decorated_key().less_compare(s, b.decorated_key());
+    });
+    std::vector<mutation> sorted;
+    sorted.reserve(batch.size());
+    for (auto& m : batch) {
+        append_bulk_load_row(s, sorted, std::move(m));
+        co_await coroutine::maybe_yield();
+    }
+    batch = std::move(sorted);
+}
+
+}
+
+future<size_t> sstables_loader::bulk_load(sstring ks_name, sstring cf_name, sstring rows, service::storage_proxy& proxy) {
+    auto& table = _db.local().find_column_family(ks_name, cf_name);
+    auto s = table.schema();
+    if (s->is_view()) {
+        throw bulk_load_error(format("Cannot bulk load into materialized view {}.{}", ks_name, cf_name));
+    }
+    bulk_load_row_parser parser(s, bytes_view(reinterpret_cast<const int8_t*>(rows.data()), rows.size()), api::new_timestamp());
+    const bool to_sstables = rows.size() >= bulk_load_sstable_threshold;
+    const size_t batch_size = to_sstables ? bulk_load_sstable_threshold : bulk_load_batch_size;
+    size_t row_count = 0;
+    size_t partition_count = 0;
+    std::vector<mutation> batch;
+    std::vector<sstables::shared_sstable> sstables;
+
+    // The rows are parsed and written in batches of about batch_size bytes
+    // of input, so that only one batch is held as mutations at a time.
+    // Below the threshold, each batch is applied through the storage proxy.
+    // Above it, each batch is sorted and written to its own sstable, and the
+    // sstables are streamed together once all of them are written.
+    auto flush = [&] () -> future<> {
+        if (batch.empty()) {
+            co_return;
+        }
+        auto batch_mutations = std::exchange(batch, {});
+        partition_count += batch_mutations.size();
+        if (!to_sstables) {
+            auto units = co_await get_units(_bulk_load_memory, batch_size);
+            auto timeout = service::storage_proxy::clock_type::now() + std::chrono::milliseconds(_db.local().get_config().write_request_timeout_in_ms());
+            co_await proxy.mutate(std::move(batch_mutations), db::consistency_level::ALL, timeout, nullptr, make_service_permit(std::move(units)));
+            co_return;
+        }
+        co_await sort_bulk_load_batch(*s, batch_mutations);
+        auto estimated_partitions = batch_mutations.size();
+        auto sst = table.make_sstable(table.dir() + "/" + sstables::upload_dir);
+        auto permit = co_await _db.local().obtain_reader_permit(table, "sstables_loader::bulk_load()", db::no_timeout);
+        co_await sst->write_components(make_flat_mutation_reader_from_mutations(s, std::move(permit), std::move(batch_mutations)),
+                estimated_partitions, s, table.get_sstables_manager().configure_writer("bulk_load"), encoding_stats{},
+                service::get_local_streaming_priority());
+        co_await sst->load();
+        sstables.push_back(std::move(sst));
+    };
+
+    auto batch_start = parser.remaining();
+    while (!parser.empty()) {
+        append_bulk_load_row(*s, batch, parser.next_row());
+        ++row_count;
+        if (batch_start - parser.remaining() >= batch_size) {
+            co_await flush();
+            batch_start = parser.remaining();
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_await flush();
+
+    llog.info("bulk_load: ks={}, table={}, rows={}, partitions={}, bytes={}, sstables={}", ks_name, cf_name, row_count, partition_count, rows.size(), sstables.size());
+    if (!sstables.empty()) {
+        co_await load_and_stream(ks_name, cf_name, s->id(), std::move(sstables), false);
+    }
+    co_return row_count;
+}
+
 // For more details, see the commends on column_family::load_new_sstables
 // All the global operations are going to happen here, and just the reloading happens
 // in there.
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <seastar/core/sharded.hh>
+#include <seastar/core/semaphore.hh>
+#include <stdexcept>
 #include "utils/UUID.hh"
 #include "sstables/shared_sstable.hh"
 
@@ -19,6 +21,7 @@ class database;
 }
 
 namespace netw { class messaging_service; }
+namespace service { class storage_proxy; }
 namespace db {
 class system_distributed_keyspace;
 namespace view {
@@ -26,11 +29,24 @@ class view_update_generator;
 }
 }
 
+// Thrown by sstables_loader::bulk_load() for malformed input or tables that
+// cannot be bulk loaded.
+class bulk_load_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 // The handler of the 'storage_service/load_new_ss_tables' endpoint which, in
 // turn, is the target of the 'nodetool refresh' command.
 // Gets sstables from the upload directory and makes them available in the
 // system. Built on top of the distributed_loader functionality.
 class sstables_loader : public seastar::peering_sharded_service<sstables_loader> {
+public:
+    // Bulk loads smaller than this are written through the memtables.
+    static constexpr size_t bulk_load_sstable_threshold = 16 << 20;
+    // The size of the input of each batch of rows applied through the memtables.
+    static constexpr size_t bulk_load_batch_size = 1 << 20;
+private:
     sharded<replica::database>& _db;
     sharded<db::system_distributed_keyspace>& _sys_dist_ks;
     sharded<db::view::view_update_generator>& _view_update_generator;
@@ -44,6 +60,10 @@ class sstables_loader : public seastar::peering_sharded_service<sstables_loader>
     // ever arise.
     bool _loading_new_sstables = false;
 
+    // Bounds the memory of the bulk load batches being applied through the
+    // storage proxy. Each batch holds units of it as its service permit.
+    semaphore _bulk_load_memory{bulk_load_sstable_threshold};
+
     future<> load_and_stream(sstring ks_name, sstring cf_name,
             utils::UUID table_id, std::vector<sstables::shared_sstable> sstables,
             bool primary_replica_only);
@@ -74,4 +94,31 @@ class sstables_loader : public seastar::peering_sharded_service<sstables_loader>
      */
     future<> load_new_sstables(sstring ks_name, sstring cf_name,
             bool load_and_stream, bool primary_replica_only);
+
+
+    /**
+     * Writes rows to the given table, bypassing CQL statement processing.
+     *
+     * The rows are given one after the other, each as the values of all the
+     * columns of the table in schema order: the partition key columns, then
+     * the clustering key, static and regular ones. A value is a 4-byte
+     * big-endian length followed by as many bytes, in the CQL serialization
+     * format of the column's type. A negative length leaves the column unset.
+     * Tables with counters or non-frozen collections aren't supported.
+     *
+     * The rows are parsed and written in batches, so that only one batch is
+     * held in memory as mutations. Up to bulk_load_sstable_threshold bytes,
+     * each batch of bulk_load_batch_size bytes is applied as mutations, which
+     * the storage proxy routes to the replicas owning them at consistency
+     * level ALL. Larger loads are written in batches of
+     * bulk_load_sstable_threshold bytes, each to its own sstable in the upload
+     * directory of the table, which are then streamed to their replicas as
+     * with load_and_stream. If writing or streaming fails, the sstables are
+     * left in the upload directory.
+     *
+     * Throws bulk_load_error if the input is malformed.
+     *
+     * @return the number of rows written.
+     */
+    future<size_t> bulk_load(sstring ks_name, sstring cf_name, sstring rows, service::storage_proxy& proxy);
 };
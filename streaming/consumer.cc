@@ -35,9 +35,9 @@ std::function<future<> (flat_mutation_reader)> make_streaming_consumer(sstring o
             auto& cs = cf->get_compaction_strategy();
             const auto adjusted_estimated_partitions = cs.adjust_partition_estimate(metadata, estimated_partitions);
             auto make_interposer_consumer = [&cs, offstrategy] (const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) mutable {
-                // postpone data segregation to off-strategy compaction if enabled
+                // the strategy decides how much of data segregation to postpone to off-strategy compaction, if enabled
                 if (offstrategy) {
-                    return end_consumer;
+                    return cs.make_offstrategy_interposer_consumer(ms_meta, std::move(end_consumer));
                 }
                 return cs.make_interposer_consumer(ms_meta, std::move(end_consumer));
             };
@@ -54,6 +54,7 @@ future<> stream_manager::start() {
 future<> stream_manager::stop() {
     co_await _gossiper.unregister_(shared_from_this());
     co_await uninit_messaging_service_handler();
+    co_await _receive_sstable_files_gate.close();
 }
 
 void stream_manager::register_sending(shared_ptr<stream_result_future> result) {
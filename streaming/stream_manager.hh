@@ -10,6 +10,9 @@
 
 #pragma once
 #include "streaming/progress_info.hh"
+#include "streaming/stream_reason.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
+#include "bytes.hh"
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/distributed.hh>
 #include "utils/UUID.hh"
@@ -18,8 +21,11 @@
 #include "gms/endpoint_state.hh"
 #include "gms/application_state.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/rpc/rpc_types.hh>
 #include <map>
+#include <optional>
 
 namespace db {
 class system_distributed_keyspace;
@@ -40,6 +46,8 @@ namespace gms {
 class gossiper;
 }
 
+class schema;
+
 namespace streaming {
 
 class stream_session;
@@ -96,6 +104,8 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     uint64_t _total_incoming_bytes{0};
     uint64_t _total_outgoing_bytes{0};
     semaphore _mutation_send_limiter{256};
+    // Held by the receivers of STREAM_SSTABLE_FILES, which run in the background.
+    seastar::gate _receive_sstable_files_gate;
     seastar::metrics::metric_groups _metrics;
 
 public:
@@ -180,6 +190,22 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
 
     void init_messaging_service_handler();
     future<> uninit_messaging_service_handler();
+
+    // Writes the sstable received with STREAM_SSTABLE_FILES and adds it to
+    // the table on its owning shard, and sends the replies to the sender.
+    future<> receive_sstable_files(utils::UUID plan_id, utils::UUID schema_id, utils::UUID cf_id, sstring sstable_version, sstring sstable_format,
+            stream_reason reason, unsigned shard_count, unsigned sharding_ignore_msb, inet_address from,
+            rpc::source<stream_sstable_files_cmd, bytes> source, rpc::sink<int32_t> sink);
+    // Returns 1 without reading anything if the sstable is declined up front,
+    // and otherwise replies 0 before reading it. Returns the final status.
+    future<int32_t> write_sstable_files(utils::UUID plan_id, utils::UUID schema_id, utils::UUID cf_id, sstring sstable_version, sstring sstable_format,
+            stream_reason reason, unsigned shard_count, unsigned sharding_ignore_msb, inet_address from,
+            rpc::source<stream_sstable_files_cmd, bytes>& source, rpc::sink<int32_t>& sink, bool& source_drained);
 };
 
+// Why an sstable written with the given schema version, on a shard of a node
+// with the given sharding, can't be received as files into a table with
+// schema s, or std::nullopt if it can.
+std::optional<sstring> sstable_files_decline_reason(const schema& s, utils::UUID schema_version, unsigned shard_count, unsigned sharding_ignore_msb);
+
 } // namespace streaming
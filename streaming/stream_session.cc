@@ -35,7 +35,12 @@
 #include "../db/view/view_update_generator.hh"
 #include "mutation_source_metadata.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "consumer.hh"
+#include "sstables/sstables.hh"
+#include "checked-file-impl.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
 
 namespace streaming {
 
@@ -92,8 +97,10 @@ void stream_manager::init_messaging_service_handler() {
                 bool got_end_of_stream = false;
             };
             auto cmd_status = make_lw_shared<stream_mutation_fragments_cmd_status>();
-            auto get_next_mutation_fragment = [&sm = container(), source, plan_id, from, s, cmd_status, permit] () mutable {
-                return source().then([&sm, plan_id, from, s, cmd_status, permit] (std::optional<std::tuple<frozen_mutation_fragment, rpc::optional<stream_mutation_fragments_cmd>>> opt) mutable {
+            auto offstrategy = is_offstrategy_supported(reason);
+            using frozen_fragment_opt = std::optional<frozen_mutation_fragment>;
+            auto get_next_mutation_fragment = [&sm = container(), source, plan_id, from, cmd_status, offstrategy] () mutable {
+                return source().then([&sm, plan_id, from, cmd_status, offstrategy] (std::optional<std::tuple<frozen_mutation_fragment, rpc::optional<stream_mutation_fragments_cmd>>> opt) mutable {
                     if (opt) {
                         auto cmd = std::get<1>(*opt);
                         if (cmd) {
@@ -102,36 +109,47 @@ void stream_manager::init_messaging_service_handler() {
                             case stream_mutation_fragments_cmd::mutation_fragment_data:
                                 break;
                             case stream_mutation_fragments_cmd::error:
-                                return make_exception_future<mutation_fragment_opt>(std::runtime_error("Sender failed"));
+                                return make_exception_future<frozen_fragment_opt>(std::runtime_error("Sender failed"));
                             case stream_mutation_fragments_cmd::end_of_stream:
                                 cmd_status->got_end_of_stream = true;
-                                return make_ready_future<mutation_fragment_opt>();
+                                return make_ready_future<frozen_fragment_opt>();
                             default:
-                                return make_exception_future<mutation_fragment_opt>(std::runtime_error("Sender sent wrong cmd"));
+                                return make_exception_future<frozen_fragment_opt>(std::runtime_error("Sender sent wrong cmd"));
                             }
                         }
                         frozen_mutation_fragment& fmf = std::get<0>(*opt);
                         auto sz = fmf.representation().size();
-                        auto mf = fmf.unfreeze(*s, permit);
                         sm.local().update_progress(plan_id, from.addr, progress_info::direction::IN, sz);
-                        return make_ready_future<mutation_fragment_opt>(std::move(mf));
+                        // Data written off-strategy doesn't add to the compaction backlog
+                        if (!offstrategy) {
+                            if (auto delay = sm.local().db().streaming_backlog_delay(); delay.count() && fmf.partition_start_key()) {
+                                // Not reading from the source makes the sender wait too
+                                return sleep(delay).then([fmf = std::move(fmf)] () mutable {
+                                    return frozen_fragment_opt(std::move(fmf));
+                                });
+                            }
+                        }
+                        return make_ready_future<frozen_fragment_opt>(std::move(fmf));
                     } else {
                         // If the sender has sent stream_mutation_fragments_cmd it means it is
                         // a node that understands the new protocol. It must send end_of_stream
                         // before close the stream.
                         if (cmd_status->got_cmd && !cmd_status->got_end_of_stream) {
-                            return make_exception_future<mutation_fragment_opt>(std::runtime_error("Sender did not sent end_of_stream"));
+                            return make_exception_future<frozen_fragment_opt>(std::runtime_error("Sender did not sent end_of_stream"));
                         }
-                        return make_ready_future<mutation_fragment_opt>();
+                        return make_ready_future<frozen_fragment_opt>();
                     }
                 });
             };
+            // The fragments are unfrozen on the shards they are written on. The sender
+            // streams the data of each of its shards separately, so when both nodes shard
+            // alike, all the fragments of a stream go to a single shard.
             //FIXME: discarded future.
-            (void)mutation_writer::distribute_reader_and_consume_on_shards(s,
-                make_generating_reader(s, permit, std::move(get_next_mutation_fragment)),
+            (void)mutation_writer::distribute_frozen_fragments_and_consume_on_shards(s,
+                std::move(get_next_mutation_fragment),
                 make_streaming_consumer("streaming", _db, _sys_dist_ks, _view_update_generator, estimated_partitions, reason, is_offstrategy_supported(reason)),
                 cf.stream_in_progress()
-            ).then_wrapped([s, plan_id, from, sink, estimated_partitions] (future<uint64_t> f) mutable {
+            ).then_wrapped([s, plan_id, from, sink, estimated_partitions, permit] (future<uint64_t> f) mutable {
                 int32_t status = 0;
                 uint64_t received_partitions = 0;
                 if (f.failed()) {
@@ -156,6 +174,25 @@ void stream_manager::init_messaging_service_handler() {
         });
       });
     });
+    ms.register_stream_sstable_files([this] (const rpc::client_info& cinfo, UUID plan_id, UUID schema_id, UUID cf_id, sstring sstable_version, sstring sstable_format, stream_reason reason,
+            unsigned shard_count, unsigned sharding_ignore_msb, rpc::source<stream_sstable_files_cmd, bytes> source) {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.trace("Got stream_sstable_files from {} reason {}", from, int(reason));
+        if (!_sys_dist_ks.local_is_initialized() || !_view_update_generator.local_is_initialized()) {
+            return make_exception_future<rpc::sink<int>>(std::runtime_error(format("Node {} is not fully initialized for streaming, try again later",
+                    utils::fb_utilities::get_broadcast_address())));
+        }
+        if (_receive_sstable_files_gate.is_closed()) {
+            return make_exception_future<rpc::sink<int>>(std::runtime_error(format("Node {} is shutting down", utils::fb_utilities::get_broadcast_address())));
+        }
+        auto sink = _ms.local().make_sink_for_stream_sstable_files(source);
+        // In the background, under the gate, so that stop() waits for it.
+        (void)with_gate(_receive_sstable_files_gate, [=, this] () mutable {
+            return receive_sstable_files(plan_id, schema_id, cf_id, std::move(sstable_version), std::move(sstable_format), reason,
+                    shard_count, sharding_ignore_msb, from.addr, std::move(source), sink);
+        });
+        return make_ready_future<rpc::sink<int>>(sink);
+    });
     ms.register_stream_mutation_done([this] (const rpc::client_info& cinfo, UUID plan_id, dht::token_range_vector ranges, UUID cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] (auto& sm) mutable {
@@ -186,10 +223,197 @@ future<> stream_manager::uninit_messaging_service_handler() {
         ms.unregister_prepare_message(),
         ms.unregister_prepare_done_message(),
         ms.unregister_stream_mutation_fragments(),
+        ms.unregister_stream_sstable_files(),
         ms.unregister_stream_mutation_done(),
         ms.unregister_complete_message()).discard_result();
 }
 
+std::optional<sstring> sstable_files_decline_reason(const schema& s, utils::UUID schema_version, unsigned shard_count, unsigned sharding_ignore_msb) {
+    // The sstable is interpreted with the local schema, so it has to match
+    // the schema it was written with. And it is owned by a single shard of
+    // the sender, which is a single shard here only with the same sharding.
+    // Otherwise, the sender falls back to streaming mutation fragments, which
+    // are upgraded on the fly and split among the shards.
+    if (s.version() != schema_version) {
+        return "schema version mismatch";
+    }
+    auto& sharder = s.get_sharder();
+    if (sharder.shard_count() != shard_count || sharder.sharding_ignore_msb() != sharding_ignore_msb) {
+        return format("sharding mismatch, {} shards and {} ignored msb bits here, {} and {} on the sender",
+                sharder.shard_count(), sharder.sharding_ignore_msb(), shard_count, sharding_ignore_msb);
+    }
+    return std::nullopt;
+}
+
+future<> stream_manager::receive_sstable_files(UUID plan_id, UUID schema_id, UUID cf_id, sstring sstable_version, sstring sstable_format,
+        stream_reason reason, unsigned shard_count, unsigned sharding_ignore_msb, inet_address from,
+        rpc::source<stream_sstable_files_cmd, bytes> source, rpc::sink<int32_t> sink) {
+    bool source_drained = false;
+    int32_t status = -1;
+    try {
+        status = co_await write_sstable_files(plan_id, schema_id, cf_id, std::move(sstable_version), std::move(sstable_format), reason,
+                shard_count, sharding_ignore_msb, from, source, sink, source_drained);
+    } catch (...) {
+        sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (receive phase) for cf_id={}, peer={}: {}",
+                plan_id, cf_id, from, std::current_exception());
+    }
+    try {
+        co_await sink(status);
+    } catch (...) {
+        sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (respond phase) for cf_id={}, peer={}: {}",
+                plan_id, cf_id, from, std::current_exception());
+    }
+    try {
+        co_await sink.close();
+        // After declining up front, the sender closes its sink without sending anything.
+        while (!source_drained && co_await source()) {
+        }
+    } catch (...) {
+        sslog.debug("[Stream #{}] Failed to close STREAM_SSTABLE_FILES from {}: {}", plan_id, from, std::current_exception());
+    }
+}
+
+future<int32_t> stream_manager::write_sstable_files(UUID plan_id, UUID schema_id, UUID cf_id, sstring sstable_version, sstring sstable_format,
+        stream_reason reason, unsigned shard_count, unsigned sharding_ignore_msb, inet_address from,
+        rpc::source<stream_sstable_files_cmd, bytes>& source, rpc::sink<int32_t>& sink, bool& source_drained) {
+    auto cf = _db.local().find_column_family(cf_id).shared_from_this();
+    auto op = cf->stream_in_progress();
+    auto version = sstables::sstable::version_from_sstring(sstable_version);
+    auto format = sstables::sstable::format_from_sstring(sstable_format);
+    // Decline before the sender sends anything.
+    if (auto reason = sstable_files_decline_reason(*cf->schema(), schema_id, shard_count, sharding_ignore_msb)) {
+        sslog.debug("[Stream #{}] Declined sstable files from {} for ks={}, cf={}: {}",
+                plan_id, from, cf->schema()->ks_name(), cf->schema()->cf_name(), *reason);
+        co_return 1;
+    }
+    bool use_view_update_path = co_await db::view::check_needs_view_update_path(_sys_dist_ks.local(), *cf, reason);
+    auto dir = use_view_update_path ? cf->dir() + "/" + sstables::staging_dir : cf->dir();
+    auto gen = cf->calculate_generation_for_new_table();
+    auto sst = cf->make_sstable(dir, gen, version, format);
+    co_await sink(0);
+
+    std::vector<sstring> written;
+    std::optional<output_stream<char>> out;
+    auto close_out = [&out] () -> future<> {
+        if (!out) {
+            return make_ready_future<>();
+        }
+        auto o = std::move(*out);
+        out.reset();
+        return do_with(std::move(o), [] (output_stream<char>& o) {
+            return o.close();
+        });
+    };
+    bool got_end_of_stream = false;
+    std::exception_ptr ex;
+    try {
+        while (auto opt = co_await source()) {
+            auto& [cmd, data] = *opt;
+            switch (cmd) {
+            case stream_sstable_files_cmd::component_start: {
+                co_await close_out();
+                auto name = sstring(reinterpret_cast<const char*>(data.data()), data.size());
+                auto type = sstables::sstable::component_from_sstring(version, name);
+                if (type == sstables::component_type::Unknown) {
+                    throw std::runtime_error(format("Sender sent unknown component {}", name));
+                }
+                if (written.empty() != (type == sstables::component_type::TOC)) {
+                    throw std::runtime_error(format("Sender sent component {} out of order", name));
+                }
+                // The TOC is written as temporary, the sstable is sealed once all components are in.
+                auto path = sst->filename(type == sstables::component_type::TOC ? sstables::component_type::TemporaryTOC : type);
+                auto f = co_await open_checked_file_dma(sstable_write_error_handler, path, open_flags::wo | open_flags::create | open_flags::exclusive);
+                written.push_back(path);
+                file_output_stream_options opts;
+                opts.io_priority_class = service::get_local_streaming_priority();
+                out = co_await make_file_output_stream(std::move(f), opts);
+                break;
+            }
+            case stream_sstable_files_cmd::component_data:
+                update_progress(plan_id, from, progress_info::direction::IN, data.size());
+                if (!out) {
+                    throw std::runtime_error("Sender sent data before starting a component");
+                }
+                co_await out->write(reinterpret_cast<const char*>(data.data()), data.size());
+                break;
+            case stream_sstable_files_cmd::error:
+                throw std::runtime_error("Sender failed");
+            case stream_sstable_files_cmd::end_of_stream:
+                got_end_of_stream = true;
+                break;
+            default:
+                throw std::runtime_error("Sender sent wrong cmd");
+            }
+        }
+        source_drained = true;
+        co_await close_out();
+        if (!got_end_of_stream) {
+            throw std::runtime_error("Sender did not send end_of_stream");
+        }
+        if (written.empty()) {
+            throw std::runtime_error("Sender sent no components");
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        try {
+            co_await close_out();
+        } catch (...) {
+        }
+        // Keep reading until EOS, so that the sender isn't left blocked and the source can be destroyed.
+        if (!source_drained) {
+            try {
+                while (co_await source()) {
+                }
+            } catch (...) {
+            }
+            source_drained = true;
+        }
+        for (auto& path : written) {
+            try {
+                co_await remove_file(path);
+            } catch (...) {
+                sslog.warn("[Stream #{}] Failed to remove {}: {}", plan_id, path, std::current_exception());
+            }
+        }
+        std::rethrow_exception(std::move(ex));
+    }
+    std::vector<unsigned> shards;
+    try {
+        co_await sst->seal_sstable(cf->incremental_backups_enabled());
+        co_await sst->load(service::get_local_streaming_priority());
+        shards = sst->get_shards_for_this_sstable();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex || shards.size() != 1) {
+        // Not expected with the same sharding, but the sstable would have
+        // to be split.
+        sst->mark_for_deletion();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+        sslog.debug("[Stream #{}] Declined sstable {} from {}: owned by {} shards", plan_id, sst->get_filename(), from, shards.size());
+        co_return 1;
+    }
+    auto info = co_await sst->get_open_info();
+    co_await container().invoke_on(shards[0], [cf_id, dir, gen, version, format, info = std::move(info), reason, use_view_update_path] (stream_manager& sm) mutable {
+        auto cf = sm._db.local().find_column_family(cf_id).shared_from_this();
+        auto sst = cf->make_sstable(dir, gen, version, format);
+        return sst->load(std::move(info)).then([cf, sst, reason] {
+            return cf->add_sstable_and_update_cache(sst, is_offstrategy_supported(reason));
+        }).then([&sm, cf, sst, use_view_update_path] {
+            if (!use_view_update_path) {
+                return make_ready_future<>();
+            }
+            return sm._view_update_generator.local().register_staging_sstable(sst, cf);
+        });
+    });
+    sslog.debug("[Stream #{}] Received sstable {} from {}, added on shard {}", plan_id, sst->get_filename(), from, shards[0]);
+    co_return 0;
+}
+
 stream_session::stream_session(stream_manager& mgr, inet_address peer_)
     : peer(peer_)
     , _mgr(mgr)
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace streaming {
+
+// Commands of the STREAM_SSTABLE_FILES verb. Each message carries a command
+// and a payload, whose meaning depends on the command.
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    // Starts a new component file, the payload is the component name (e.g. "Data.db").
+    component_start,
+    // The payload is the next chunk of the current component.
+    component_data,
+    end_of_stream,
+};
+
+}
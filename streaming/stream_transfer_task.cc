@@ -15,6 +15,7 @@
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "mutation_reader.hh"
 #include "flat_mutation_reader.hh"
 #include "mutation_fragment_stream_validator.hh"
@@ -29,8 +30,11 @@
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
+#include "sstables/sstable_segment.hh"
 #include "replica/database.hh"
 #include "gms/feature_service.hh"
+#include "db/config.hh"
+#include <seastar/core/coroutine.hh>
 
 namespace streaming {
 
@@ -57,11 +61,14 @@ struct send_info {
     replica::column_family& cf;
     dht::token_range_vector ranges;
     dht::partition_range_vector prs;
+    // Sstables already sent as whole files, not read by the reader.
+    std::unordered_set<sstables::shared_sstable> sent_sstables;
     flat_mutation_reader reader;
     noncopyable_function<void(size_t)> update;
     send_info(netw::messaging_service& ms_, utils::UUID plan_id_, replica::table& tbl_, reader_permit permit_,
               dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
-              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn)
+              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn,
+              std::unordered_set<sstables::shared_sstable> sent_sstables_ = {})
         : ms(ms_)
         , plan_id(plan_id_)
         , cf_id(tbl_.schema()->id())
@@ -71,7 +78,8 @@ struct send_info {
         , cf(tbl_)
         , ranges(std::move(ranges_))
         , prs(dht::to_partition_ranges(ranges))
-        , reader(downgrade_to_v1(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs)))
+        , sent_sstables(std::move(sent_sstables_))
+        , reader(downgrade_to_v1(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs, sent_sstables)))
         , update(std::move(update_fn))
     {
     }
@@ -96,6 +104,9 @@ struct send_info {
     future<size_t> estimate_partitions() {
         return do_with(cf.get_sstables(), size_t(0), [this] (auto& sstables, size_t& partition_count) {
             return do_for_each(*sstables, [this, &partition_count] (auto& sst) {
+                if (sent_sstables.contains(sst)) {
+                    return make_ready_future<>();
+                }
                 return do_for_each(ranges, [this, &sst, &partition_count] (auto& range) {
                     partition_count += sst->estimated_keys_for_range(range);
                 });
@@ -186,6 +197,209 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  });
 }
 
+// Whole sstables are sent only when the receivers are going to own all of
+// the data, so that they don't have to be split.
+static bool is_file_streaming_supported(stream_reason reason) {
+    switch (reason) {
+    case stream_reason::bootstrap:
+    case stream_reason::decommission:
+    case stream_reason::removenode:
+    case stream_reason::rebuild:
+    case stream_reason::replace:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Segments of sstables are sent only when the receiver compacts the
+// received sstables off-strategy, since segments lack bloom filters and
+// compression. Must match is_offstrategy_supported() in stream_session.cc.
+static bool is_segment_streaming_supported(stream_reason reason) {
+    return reason == stream_reason::bootstrap || reason == stream_reason::replace;
+}
+
+struct file_streaming_candidates {
+    // Contained in one of the ranges, sent as they are.
+    std::vector<sstables::shared_sstable> whole;
+    // Overlapping some of the ranges, the parts within each range are sent
+    // as standalone sstables.
+    std::vector<sstables::shared_sstable> partial;
+};
+
+// Returns the sstables of this shard which can be sent as files: those
+// which are not shared with other shards and which overlap the (sorted and
+// merged) streamed ranges.
+static file_streaming_candidates get_sstables_for_file_streaming(replica::table& tbl, const dht::token_range_vector& ranges, bool segments) {
+    file_streaming_candidates ret;
+    auto sstables = tbl.get_sstables();
+    for (auto& sst : *sstables) {
+        if (sst->is_shared() || sst->requires_view_building()) {
+            continue;
+        }
+        auto first = sst->get_first_decorated_key().token();
+        auto last = sst->get_last_decorated_key().token();
+        if (std::ranges::any_of(ranges, [&] (const dht::token_range& r) {
+                return r.contains(first, dht::token_comparator()) && r.contains(last, dht::token_comparator());
+            })) {
+            auto components = sst->all_components();
+            if (std::ranges::none_of(components, [] (auto& c) { return c.first == sstables::component_type::Unknown; })) {
+                ret.whole.push_back(sst);
+            }
+            continue;
+        }
+        if (segments && sstables::sstable_segment::is_supported(*sst) && std::ranges::any_of(ranges, [&] (const dht::token_range& r) {
+                return r.overlaps(dht::token_range::make({first, true}, {last, true}), dht::token_comparator());
+            })) {
+            ret.partial.push_back(sst);
+        }
+    }
+    return ret;
+}
+
+// Sends the components of an sstable with STREAM_SSTABLE_FILES.
+class sstable_files_sink : public sstables::component_consumer {
+    stream_manager& _sm;
+    utils::UUID _plan_id;
+    gms::inet_address _peer;
+    rpc::sink<stream_sstable_files_cmd, bytes>& _sink;
+public:
+    sstable_files_sink(stream_manager& sm, utils::UUID plan_id, gms::inet_address peer, rpc::sink<stream_sstable_files_cmd, bytes>& sink)
+        : _sm(sm)
+        , _plan_id(plan_id)
+        , _peer(peer)
+        , _sink(sink)
+    { }
+
+    virtual future<> start_component(sstring name) override {
+        return _sink(stream_sstable_files_cmd::component_start, to_bytes(name));
+    }
+
+    virtual future<> consume(temporary_buffer<char> data) override {
+        _sm.update_progress(_plan_id, _peer, streaming::progress_info::direction::OUT, data.size());
+        return _sink(stream_sstable_files_cmd::component_data, bytes(reinterpret_cast<const int8_t*>(data.get()), data.size()));
+    }
+};
+
+// Passes all component files of the sstable to out, TOC first.
+static future<> produce_sstable_files(sstables::shared_sstable sst, sstables::component_consumer& out) {
+    auto components = sst->all_components();
+    std::ranges::stable_partition(components, [] (auto& c) { return c.first == sstables::component_type::TOC; });
+    for (auto& [type, name] : components) {
+        co_await out.start_component(name);
+        co_await sstables::produce_component_file(*sst, type, out, service::get_local_streaming_priority());
+    }
+}
+
+using sstable_files_producer = noncopyable_function<future<> (sstables::component_consumer&)>;
+
+// Sends the components of a single sstable of the same version and format
+// as sst, as generated by produce.
+// Returns false if the peer declined the sstable, in which case its data
+// has to be sent as mutation fragments.
+static future<bool> send_sstable_files(stream_manager& sm, utils::UUID plan_id, netw::messaging_service::msg_addr id, stream_reason reason,
+        replica::table& tbl, sstables::shared_sstable sst, sstable_files_producer produce) {
+    auto& sharder = tbl.schema()->get_sharder();
+    auto [sink, source] = co_await sm.ms().make_sink_and_source_for_stream_sstable_files(tbl.schema()->version(), plan_id, tbl.schema()->id(),
+            sstables::to_string(sst->get_version()), sstables::sstable::format_to_sstring(sst->get_format()), reason,
+            sharder.shard_count(), sharder.sharding_ignore_msb(), id);
+    std::optional<int32_t> status;
+    std::exception_ptr ex;
+    try {
+        // The receiver first tells whether it accepts the sstable at all.
+        if (auto status_opt = co_await source()) {
+            status = std::get<0>(*status_opt);
+        }
+        if (status == 0) {
+            sstable_files_sink out(sm, plan_id, id.addr, sink);
+            co_await produce(out);
+            co_await sink(stream_sstable_files_cmd::end_of_stream, bytes());
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex && status == 0) {
+        // Notify the receiver the sender has failed
+        try {
+            co_await sink(stream_sstable_files_cmd::error, bytes());
+        } catch (...) {
+            sslog.debug("[Stream #{}] Failed to send error to {}: {}", plan_id, id, std::current_exception());
+        }
+    }
+    co_await sink.close();
+    // Read until EOS, so that the source can be destroyed.
+    while (auto status_opt = co_await source()) {
+        status = std::get<0>(*status_opt);
+    }
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    if (!status || *status == -1) {
+        throw std::runtime_error(format("Peer failed to process sstable files peer={}, plan_id={}, cf_id={}, sstable={}",
+                id.addr, plan_id, tbl.schema()->id(), sst->get_filename()));
+    }
+    sslog.debug("[Stream #{}] Sent sstable {} to {}, status={}", plan_id, sst->get_filename(), id, *status);
+    co_return *status == 0;
+}
+
+// Sends the parts of the sstable within each of the ranges as standalone sstables.
+// Returns false if the peer declined any of them.
+static future<bool> send_sstable_segments(stream_manager& sm, utils::UUID plan_id, netw::messaging_service::msg_addr id, stream_reason reason,
+        replica::table& tbl, sstables::shared_sstable sst, const dht::token_range_vector& ranges) {
+    auto& pc = service::get_local_streaming_priority();
+    auto sst_range = dht::token_range::make({sst->get_first_decorated_key().token(), true}, {sst->get_last_decorated_key().token(), true});
+    for (auto& r : ranges) {
+        if (!r.overlaps(sst_range, dht::token_comparator())) {
+            continue;
+        }
+        auto segment = co_await sstables::sstable_segment::find(sst, r, pc);
+        if (!segment) {
+            continue;
+        }
+        auto permit = co_await sm.db().obtain_reader_permit(tbl, "stream-sstable-segment", db::no_timeout);
+        auto accepted = co_await send_sstable_files(sm, plan_id, id, reason, tbl, sst, [&] (sstables::component_consumer& out) {
+            return segment->produce(out, permit, pc);
+        });
+        if (!accepted) {
+            // Receivers decline for reasons which apply to all segments alike.
+            co_return false;
+        }
+    }
+    co_return true;
+}
+
+// Sends the sstables which can be sent as files and returns those accepted
+// by the peer, whose data doesn't have to be sent as mutation fragments.
+static future<std::unordered_set<sstables::shared_sstable>> send_sstables_as_files(stream_manager& sm, utils::UUID plan_id,
+        netw::messaging_service::msg_addr id, stream_reason reason, replica::table& tbl, dht::token_range_vector ranges) {
+    std::unordered_set<sstables::shared_sstable> sent;
+    if (!is_file_streaming_supported(reason) || !sm.db().get_config().stream_entire_sstables()
+            || !sm.db().features().cluster_supports_stream_sstable_files()) {
+        co_return sent;
+    }
+    auto candidates = get_sstables_for_file_streaming(tbl, ranges, is_segment_streaming_supported(reason));
+    if (candidates.whole.empty() && candidates.partial.empty()) {
+        co_return sent;
+    }
+    sslog.info("[Stream #{}] Start sending {} whole and {} partial sstables of ks={}, cf={} as files", plan_id,
+            candidates.whole.size(), candidates.partial.size(), tbl.schema()->ks_name(), tbl.schema()->cf_name());
+    for (auto& sst : candidates.whole) {
+        if (co_await send_sstable_files(sm, plan_id, id, reason, tbl, sst, [sst] (sstables::component_consumer& out) {
+                return produce_sstable_files(sst, out);
+            })) {
+            sent.insert(sst);
+        }
+    }
+    for (auto& sst : candidates.partial) {
+        if (co_await send_sstable_segments(sm, plan_id, id, reason, tbl, sst, ranges)) {
+            sent.insert(sst);
+        }
+    }
+    sslog.info("[Stream #{}] Sent {} out of {} sstables of ks={}, cf={} as files", plan_id, sent.size(),
+            candidates.whole.size() + candidates.partial.size(), tbl.schema()->ks_name(), tbl.schema()->cf_name());
+    co_return sent;
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -197,10 +411,11 @@ future<> stream_transfer_task::execute() {
     auto& sm = session->manager();
     return sm.container().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, reason] (stream_manager& sm) mutable {
         auto& tbl = sm.db().find_column_family(cf_id);
-      return sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason] (reader_permit permit) mutable {
+      return send_sstables_as_files(sm, plan_id, id, reason, tbl, ranges).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason] (std::unordered_set<sstables::shared_sstable> sent_sstables) mutable {
+      return sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason, sent_sstables=std::move(sent_sstables)] (reader_permit permit) mutable {
         auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, [&sm, plan_id, addr = id.addr] (size_t sz) {
             sm.update_progress(plan_id, addr, streaming::progress_info::direction::OUT, sz);
-        });
+        }, std::move(sent_sstables));
         return si->has_relevant_range_on_this_shard().then([si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
             if (!has_relevant_range_on_this_shard) {
                 sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
@@ -212,6 +427,7 @@ future<> stream_transfer_task::execute() {
             return si->reader.close();
         });
       });
+      });
     }).then([this, plan_id, cf_id, id, &sm] {
         sslog.debug("[Stream #{}] SEND STREAM_MUTATION_DONE to {}, cf_id={}", plan_id, id, cf_id);
         return sm.ms().send_stream_mutation_done(id, plan_id, _ranges,
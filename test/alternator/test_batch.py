@@ -249,6 +249,21 @@ def test_batch_get_item_hash(test_table_s):
     got_items = reply['Responses'][test_table_s.name]
     assert multiset(got_items) == multiset(items)
 
+# Test BatchGetItem reading several items of the same partitions, some of
+# them missing, which are read together.
+def test_batch_get_item_same_partition(test_table):
+    p1 = random_string()
+    p2 = random_string()
+    items = [{'p': p, 'c': random_string(), 'val': random_string()} for p in [p1, p2] for i in range(5)]
+    with test_table.batch_writer() as batch:
+        for item in items:
+            batch.put_item(item)
+    keys = [{k: x[k] for k in ('p', 'c')} for x in items]
+    keys += [{'p': p1, 'c': random_string()}, {'p': p2, 'c': random_string()}]
+    reply = test_table.meta.client.batch_get_item(RequestItems = {test_table.name: {'Keys': keys, 'ConsistentRead': True}})
+    got_items = reply['Responses'][test_table.name]
+    assert multiset(got_items) == multiset(items)
+
 # Test what do we get if we try to read two *missing* values in addition to
 # an existing one. It turns out the missing items are simply not returned,
 # with no sign they are missing.
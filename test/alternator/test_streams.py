@@ -1065,6 +1065,37 @@ def test_streams_after_sequence_number(test_table_ss_keys_only, dynamodbstreams)
         time.sleep(0.5)
     pytest.fail("timed out")
 
+# Test that reading the same part of a stream shard again, all at once or a
+# page at a time, returns the same events. Scylla keeps the recent events a
+# stream shard's readers read in memory, and serves them from there when they
+# are read again.
+def test_streams_reread(test_table_ss_keys_only, dynamodbstreams):
+    table, arn = test_table_ss_keys_only
+    iterators = latest_iterators(dynamodbstreams, arn)
+    p = random_string()
+    c = random_string()
+    for i in range(3):
+        table.update_item(Key={'p': p, 'c': c},
+            UpdateExpression='SET x = :val1', ExpressionAttributeValues={':val1': i})
+    timeout = time.time() + 15
+    while time.time() < timeout:
+        for iter in iterators:
+            response = dynamodbstreams.get_records(ShardIterator=iter)
+            if 'Records' in response and len(response['Records']) == 3:
+                sequence_numbers = [r['dynamodb']['SequenceNumber'] for r in response['Records']]
+                response = dynamodbstreams.get_records(ShardIterator=iter)
+                assert [r['dynamodb']['SequenceNumber'] for r in response['Records']] == sequence_numbers
+                for sequence_number in sequence_numbers:
+                    response = dynamodbstreams.get_records(ShardIterator=iter, Limit=1)
+                    assert [r['dynamodb']['SequenceNumber'] for r in response['Records']] == [sequence_number]
+                    assert response['Records'][0]['dynamodb']['Keys'] == {'p': {'S': p}, 'c': {'S': c}}
+                    iter = response['NextShardIterator']
+                response = dynamodbstreams.get_records(ShardIterator=iter)
+                assert response['Records'] == []
+                return
+        time.sleep(0.5)
+    pytest.fail("timed out")
+
 # Test the "TRIM_HORIZON" iterator, which can be used to re-read *all* the
 # previously-read events of the stream shard again.
 # NOTE: This test relies on the test_table_ss_keys_only fixture giving us a
@@ -138,7 +138,7 @@ def test_tag_resource_incorrect(test_table):
 def test_tag_resource_write_isolation_values(scylla_only, test_table):
     got = test_table.meta.client.describe_table(TableName=test_table.name)['Table']
     arn =  got['TableArn']
-    for i in ['f', 'forbid', 'forbid_rmw', 'a', 'always', 'always_use_lwt', 'o', 'only_rmw_uses_lwt', 'u', 'unsafe', 'unsafe_rmw']:
+    for i in ['f', 'forbid', 'forbid_rmw', 'a', 'always', 'always_use_lwt', 'o', 'only_rmw_uses_lwt', 'u', 'unsafe', 'unsafe_rmw', 'l', 'local', 'local_rmw']:
         test_table.meta.client.tag_resource(ResourceArn=arn, Tags=[{'Key':'system:write_isolation', 'Value':i}])
     with pytest.raises(ClientError, match='ValidationException'):
         test_table.meta.client.tag_resource(ResourceArn=arn, Tags=[{'Key':'system:write_isolation', 'Value':'bah'}])
@@ -231,3 +231,41 @@ def test_tag_resource_missing_tags(test_table):
     arn = client.describe_table(TableName=test_table.name)['Table']['TableArn']
     with pytest.raises(ClientError, match='ValidationException'):
         client.tag_resource(ResourceArn=arn)
+
+# Test that attributes promoted to columns of their own with the
+# system:promoted_attributes tag (a Scylla-only feature) behave like all other
+# attributes: they can be written by PutItem and UpdateItem, read back alone
+# or with other attributes, and removed. The tag can't be changed after the
+# table is created.
+def test_promoted_attributes(scylla_only, dynamodb):
+    table = create_test_table(dynamodb,
+        KeySchema=[ { 'AttributeName': 'p', 'KeyType': 'HASH' } ],
+        AttributeDefinitions=[ { 'AttributeName': 'p', 'AttributeType': 'S' } ],
+        Tags=[{'Key': 'system:promoted_attributes', 'Value': 'a b'}])
+    try:
+        table.put_item(Item={'p': 'x', 'a': 1, 'b': {'c': [2, 3]}, 'd': 'hi'})
+        assert table.get_item(Key={'p': 'x'}, ConsistentRead=True)['Item'] == {'p': 'x', 'a': 1, 'b': {'c': [2, 3]}, 'd': 'hi'}
+        assert table.get_item(Key={'p': 'x'}, ProjectionExpression='a', ConsistentRead=True)['Item'] == {'a': 1}
+        assert table.get_item(Key={'p': 'x'}, ProjectionExpression='p, b.c[1]', ConsistentRead=True)['Item'] == {'p': 'x', 'b': {'c': [3]}}
+        table.update_item(Key={'p': 'x'}, UpdateExpression='SET a = a + :one REMOVE b', ExpressionAttributeValues={':one': 1})
+        assert table.get_item(Key={'p': 'x'}, ConsistentRead=True)['Item'] == {'p': 'x', 'a': 2, 'd': 'hi'}
+        assert table.scan(FilterExpression='a = :two', ExpressionAttributeValues={':two': 2}, ProjectionExpression='d')['Items'] == [{'d': 'hi'}]
+        arn = table.meta.client.describe_table(TableName=table.name)['Table']['TableArn']
+        with pytest.raises(ClientError, match='ValidationException'):
+            table.meta.client.tag_resource(ResourceArn=arn, Tags=[{'Key': 'system:promoted_attributes', 'Value': 'a'}])
+        with pytest.raises(ClientError, match='ValidationException'):
+            table.meta.client.untag_resource(ResourceArn=arn, TagKeys=['system:promoted_attributes'])
+    finally:
+        table.delete()
+
+# A key attribute already has a column of its own, and can't be promoted.
+def test_promoted_attributes_key(scylla_only, dynamodb):
+    name = unique_table_name()
+    with pytest.raises(ClientError, match='ValidationException'):
+        dynamodb.create_table(TableName=name,
+            BillingMode='PAY_PER_REQUEST',
+            KeySchema=[{ 'AttributeName': 'p', 'KeyType': 'HASH' }],
+            AttributeDefinitions=[{ 'AttributeName': 'p', 'AttributeType': 'S' }],
+            Tags=[{'Key': 'system:promoted_attributes', 'Value': 'p'}])
+    with pytest.raises(ClientError, match='ResourceNotFoundException'):
+        dynamodb.meta.client.describe_table(TableName=name)
@@ -14,8 +14,10 @@
 #include <stdint.h>
 
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
+#include "test/lib/eventually.hh"
 
 #include <seastar/core/future-util.hh>
 #include <seastar/core/shared_ptr.hh>
@@ -69,3 +71,27 @@ SEASTAR_TEST_CASE(test_execute_batch) {
     });
 }
 
+
+SEASTAR_TEST_CASE(test_batchlog_removals_are_batched) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, r int, PRIMARY KEY (p, c));").get();
+        auto& stats = e.local_qp().proxy().get_global_stats();
+        auto removal_batches = stats.batchlog_removal_batches;
+
+        // Logged batches of two partitions, all completed before the
+        // removals of their batchlog entries are flushed.
+        constexpr int batches = 50;
+        parallel_for_each(boost::irange(0, batches), [&e] (int i) {
+            return e.execute_cql(format("BEGIN BATCH INSERT INTO cf (p, c, r) VALUES ({}, 0, 0); INSERT INTO cf (p, c, r) VALUES ({}, 0, 0); APPLY BATCH;",
+                    2 * i, 2 * i + 1)).discard_result();
+        }).get();
+
+        eventually([&] {
+            BOOST_REQUIRE_EQUAL(e.batchlog_manager().local().count_all_batches().get0(), 0);
+        });
+        BOOST_REQUIRE_GT(stats.batchlog_removal_batches, removal_batches);
+        BOOST_REQUIRE_LT(stats.batchlog_removal_batches - removal_batches, batches);
+        BOOST_REQUIRE_EQUAL(stats.failed_batchlog_removals, 0);
+        assert_that(e.execute_cql("select count(*) from cf;").get0()).is_rows().with_rows({{long_type->decompose(int64_t(2 * batches))}});
+    });
+}
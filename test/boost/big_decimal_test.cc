@@ -203,3 +203,22 @@ BOOST_AUTO_TEST_CASE(test_big_decimal_sub) {
     test_sub("9999999999999999999999999999999999999", "-1.000e0", "10000000000000000000000000000000000000.000");
     test_sub("+10.", "1.e+1", "0");
 }
+
+BOOST_AUTO_TEST_CASE(test_big_decimal_beyond_64_bits) {
+    // Unscaled values and rescalings around the limits of 64-bit arithmetic.
+    test_add("9223372036854775807", "0.1", "9223372036854775807.1");
+    test_add("-9223372036854775808", "-0.1", "-9223372036854775808.1");
+    test_add("9223372036854775807", "1e-18", "9223372036854775807.000000000000000001");
+    test_add("9223372036854775807", "1e-19", "9223372036854775807.0000000000000000001");
+    test_add("9223372036854775808", "0.1", "9223372036854775808.1");
+    test_sub("-9223372036854775808", "9223372036854775807.0", "-18446744073709551615.0");
+
+    test_div("-9223372036854775808", 2, "-4611686018427387904");
+    test_div("9223372036854775807", 2, "4611686018427387904");
+    test_div("18446744073709551615", 2, "9223372036854775808");
+
+    BOOST_REQUIRE(big_decimal("9223372036854775807") < big_decimal("9223372036854775807.000000000000000001"));
+    BOOST_REQUIRE(big_decimal("9223372036854775807") < big_decimal("9223372036854775807.0000000000000000001"));
+    BOOST_REQUIRE(big_decimal("-9223372036854775808.0") < big_decimal("-9223372036854775807"));
+    BOOST_REQUIRE(big_decimal("1.0") == big_decimal("1.000000000000000000000"));
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include "utils/bloom_filter.hh"
+#include "types.hh"
+
+using namespace utils;
+
+static bytes make_key(uint64_t i) {
+    return long_type->decompose(int64_t(i));
+}
+
+static double false_positive_rate(i_filter& f, uint64_t first, uint64_t count) {
+    uint64_t positives = 0;
+    for (uint64_t i = first; i < first + count; ++i) {
+        positives += f.is_present(make_key(i));
+    }
+    return double(positives) / count;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_block_filter_has_no_false_negatives) {
+    constexpr uint64_t n = 100000;
+    auto f = i_filter::get_split_block_filter(n, 0.01);
+    for (uint64_t i = 0; i < n; ++i) {
+        f->add(make_key(i));
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+        BOOST_REQUIRE(f->is_present(make_key(i)));
+        BOOST_REQUIRE(f->is_present(make_hashed_key(make_key(i))));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_block_filter_false_positive_rate) {
+    constexpr uint64_t n = 100000;
+    for (double fp_chance : {0.1, 0.01, 0.001}) {
+        auto f = i_filter::get_split_block_filter(n, fp_chance);
+        for (uint64_t i = 0; i < n; ++i) {
+            f->add(make_key(i));
+        }
+        auto rate = false_positive_rate(*f, n, 10 * n);
+        BOOST_TEST_MESSAGE(format("fp_chance={} rate={}", fp_chance, rate));
+        BOOST_REQUIRE_LE(rate, fp_chance * 1.1);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_block_filter_rebuilt_from_storage) {
+    constexpr uint64_t n = 1000;
+    auto f = i_filter::get_split_block_filter(n, 0.01);
+    for (uint64_t i = 0; i < n; ++i) {
+        f->add(make_key(i));
+    }
+    auto& bits = static_cast<filter::split_block_bloom_filter&>(*f).bits();
+    // What sstable::read_filter() does with the words read from the Filter component.
+    large_bitset copy(bits.size(), utils::chunked_vector<uint64_t>(bits.get_storage()));
+    auto f2 = filter::create_split_block_filter(std::move(copy));
+    for (uint64_t i = 0; i < 2 * n; ++i) {
+        BOOST_REQUIRE_EQUAL(f->is_present(make_key(i)), f2->is_present(make_key(i)));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_block_filter_bounded_like_classic_filter) {
+    constexpr uint64_t n = 1000;
+    // Would take more bits per element than get_filter() allows.
+    auto f = i_filter::get_split_block_filter(n, 0.0001);
+    BOOST_REQUIRE(!dynamic_cast<filter::split_block_bloom_filter*>(f.get()));
+    for (uint64_t i = 0; i < n; ++i) {
+        f->add(make_key(i));
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+        BOOST_REQUIRE(f->is_present(make_key(i)));
+    }
+}
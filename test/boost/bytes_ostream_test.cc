@@ -325,3 +325,56 @@ BOOST_AUTO_TEST_CASE(test_remove_suffix) {
         test(std::max(a, b), std::min(a, b));
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_deserialized_stream_is_linearized) {
+    for (size_t size : {size_t(0), size_t(16), size_t(10'000), size_t(100'000), size_t(1'000'000)}) {
+        auto data = tests::random::get_bytes(size);
+        bytes_ostream out;
+        ser::serialize(out, bytes_view(data));
+        BOOST_REQUIRE(size < 512 || !out.is_linearized());
+
+        auto in = ser::as_input_stream(out);
+        auto result = ser::deserialize(in, boost::type<bytes_ostream>());
+        BOOST_REQUIRE_EQUAL(result.size(), size);
+        BOOST_REQUIRE_EQUAL(result.is_linearized(), size <= bytes_ostream::max_chunk_size());
+        BOOST_REQUIRE(bytes_ostream(result).linearize() == bytes_view(data));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_splice) {
+    auto test = [] (size_t prefix_length, size_t length, size_t skip) {
+        testlog.info("Testing prefix size {}, buffer size {} and skip {}", prefix_length, length, skip);
+
+        auto prefix = tests::random::get_bytes(prefix_length);
+        auto data = tests::random::get_bytes(length);
+
+        bytes_ostream bo;
+        bo.write(prefix);
+        bytes_ostream other;
+        for (size_t i = 0; i < length; i += 1000) {
+            other.write(bytes_view(data).substr(i, 1000));
+        }
+
+        bo.splice(std::move(other), skip);
+        BOOST_REQUIRE_EQUAL(other.size(), 0);
+
+        auto rest = bytes_view(data).substr(std::min(skip, length));
+        BOOST_REQUIRE_EQUAL(bo.size(), prefix_length + rest.size());
+        bo.write(prefix);
+        auto view = bo.linearize();
+        BOOST_REQUIRE(view.substr(0, prefix_length) == bytes_view(prefix));
+        BOOST_REQUIRE(view.substr(prefix_length, rest.size()) == rest);
+        BOOST_REQUIRE(view.substr(prefix_length + rest.size()) == bytes_view(prefix));
+    };
+
+    test(0, 0, 0);
+    test(16, 0, 0);
+    test(0, 16, 0);
+    test(16, 16, 8);
+    test(16, 1'000'000, 0);
+    test(16, 1'000'000, 8);
+    test(1'000'000, 1'000'000, 8);
+    test(16, 1'000'000, 600);
+    test(16, 1'000'000, 999'999);
+    test(16, 1'000'000, 1'000'000);
+}
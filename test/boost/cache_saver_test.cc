@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/fstream.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "service/cache_saver.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/tmpdir.hh"
+
+// Writes the keys in chunks of at most chunk_size.
+static size_t write_keys(sstring path, const std::vector<dht::decorated_key>& keys, size_t chunk_size = 100) {
+    size_t pos = 0;
+    return service::cache_saver::write_keys(path, [&] {
+        auto end = std::min(pos + chunk_size, keys.size());
+        std::vector<dht::decorated_key> chunk(keys.begin() + pos, keys.begin() + end);
+        pos = end;
+        return make_ready_future<std::vector<dht::decorated_key>>(std::move(chunk));
+    }).get0();
+}
+
+static std::vector<dht::decorated_key> read_keys(sstring path, const schema& s) {
+    std::vector<dht::decorated_key> keys;
+    service::cache_saver::read_keys(path, s, [&] (std::vector<dht::decorated_key> chunk) {
+        BOOST_REQUIRE(!chunk.empty());
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(keys));
+        return make_ready_future<>();
+    }).get();
+    return keys;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_saved_keys_round_trip) {
+    tmpdir dir;
+    simple_schema ss;
+    auto s = ss.schema();
+    auto path = (dir.path() / service::cache_saver::file_name(s->id(), 0).c_str()).native();
+
+    for (size_t n : {0, 1, 1000, 5000}) {
+        auto keys = ss.make_pkeys(n);
+        BOOST_REQUIRE_EQUAL(write_keys(path, keys), keys.size());
+        auto read = read_keys(path, *s);
+        BOOST_REQUIRE_EQUAL(read.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            BOOST_REQUIRE(read[i].equal(*s, keys[i]));
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_saved_keys_truncated_file) {
+    tmpdir dir;
+    simple_schema ss;
+    auto s = ss.schema();
+    auto path = (dir.path() / service::cache_saver::file_name(s->id(), 0).c_str()).native();
+
+    write_keys(path, ss.make_pkeys(10));
+    auto f = open_file_dma(path, open_flags::rw).get0();
+    auto size = f.size().get0();
+    f.truncate(size - 1).get();
+    f.close().get();
+
+    BOOST_REQUIRE_THROW(read_keys(path, *s), std::runtime_error);
+}
@@ -258,6 +258,75 @@ SEASTAR_THREAD_TEST_CASE(test_eviction_via_lru) {
     }
 }
 
+SEASTAR_THREAD_TEST_CASE(test_eviction_balances_kinds_by_hits_per_byte) {
+    struct fake_row : public evictable {
+        bool evicted = false;
+        void on_evicted() noexcept override { evicted = true; }
+    };
+
+    auto page = cached_file::page_size;
+    test_file tf = make_test_file(page * 3);
+
+    lru l;
+    cached_file::metrics metrics;
+    logalloc::region region;
+    cached_file cf(tf.f, metrics, l, region, tf.contents.size());
+    BOOST_REQUIRE_EQUAL(tf.contents, read_to_string(cf, 0));
+    BOOST_REQUIRE_EQUAL(page * 3, l.stats(lru_kind::file_pages).memory_usage);
+
+    fake_row row;
+    l.add(row, lru_kind::rows);
+    l.set_memory_usage_function(lru_kind::rows, [page] { return page * 3; });
+    for (int i = 0; i < 10; ++i) {
+        l.on_hit(lru_kind::rows);
+    }
+
+    // The pages had no hits, they go first.
+    l.evict();
+    BOOST_REQUIRE_EQUAL(1, metrics.page_evictions);
+    BOOST_REQUIRE(!row.evicted);
+    BOOST_REQUIRE_EQUAL(page * 2, l.stats(lru_kind::file_pages).memory_usage);
+
+    for (int i = 0; i < 100; ++i) {
+        BOOST_REQUIRE_EQUAL(tf.contents.substr(page, 1), read_to_string(cf, page, 1));
+    }
+
+    // Now the row has fewer hits per byte.
+    l.evict();
+    BOOST_REQUIRE_EQUAL(1, metrics.page_evictions);
+    BOOST_REQUIRE(row.evicted);
+    BOOST_REQUIRE_EQUAL(1, l.stats(lru_kind::rows).evictions);
+    BOOST_REQUIRE_EQUAL(1, l.stats(lru_kind::file_pages).evictions);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_lru_memory_limit) {
+    auto page = cached_file::page_size;
+    test_file tf1 = make_test_file(page * 5);
+    test_file tf2 = make_test_file(page * 2);
+
+    lru l;
+    cached_file::metrics metrics;
+    logalloc::region region;
+    cached_file cf1(tf1.f, metrics, l, region, tf1.contents.size());
+    cached_file cf2(tf2.f, metrics, l, region, tf2.contents.size());
+    cf1.set_lru_memory_limit(page * 3);
+    cf2.set_lru_memory_limit(page * 3);
+
+    BOOST_REQUIRE_EQUAL(tf1.contents, read_to_string(cf1, 0));
+    BOOST_REQUIRE_EQUAL(page * 3, l.stats(lru_kind::file_pages).memory_usage);
+    BOOST_REQUIRE_EQUAL(2, metrics.page_evictions);
+
+    // The limit is shared by the files using the LRU.
+    BOOST_REQUIRE_EQUAL(tf2.contents, read_to_string(cf2, 0));
+    BOOST_REQUIRE_EQUAL(page * 3, l.stats(lru_kind::file_pages).memory_usage);
+    BOOST_REQUIRE_EQUAL(page, cf1.cached_bytes());
+    BOOST_REQUIRE_EQUAL(page * 2, cf2.cached_bytes());
+
+    // Evicted pages are read again.
+    BOOST_REQUIRE_EQUAL(tf1.contents, read_to_string(cf1, 0));
+    BOOST_REQUIRE_EQUAL(page * 3, l.stats(lru_kind::file_pages).memory_usage);
+}
+
 // A file which serves garbage but is very fast.
 class garbage_file_impl : public file_impl {
 private:
@@ -430,3 +499,36 @@ SEASTAR_THREAD_TEST_CASE(test_invalidation) {
     BOOST_REQUIRE_EQUAL(2, metrics.page_populations);
     BOOST_REQUIRE_EQUAL(0, metrics.page_hits);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_prefetch) {
+    auto page_size = cached_file::page_size;
+    test_file tf = make_test_file(page_size * 10);
+
+    cached_file::metrics metrics;
+    logalloc::region region;
+    cached_file cf(tf.f, metrics, cf_lru, region, tf.contents.size());
+
+    // Pages 0-2 are adjacent and read together, 5 and 9 separately.
+    // The last range extends past the end of the file.
+    cf.prefetch({{0, 1}, {page_size, 2 * page_size + 1}, {5 * page_size + 10, 5 * page_size + 20}, {9 * page_size, 100 * page_size}},
+            default_priority_class()).get();
+
+    BOOST_REQUIRE_EQUAL(3, metrics.page_misses);
+    BOOST_REQUIRE_EQUAL(5, metrics.page_populations);
+    BOOST_REQUIRE_EQUAL(page_size * 5, cf.cached_bytes());
+
+    // Prefetching cached pages doesn't read anything.
+    cf.prefetch({{0, 3 * page_size}}, default_priority_class()).get();
+    BOOST_REQUIRE_EQUAL(3, metrics.page_misses);
+
+    for (auto idx : {0, 1, 2, 5, 9}) {
+        BOOST_REQUIRE_EQUAL(tf.contents.substr(idx * page_size, page_size), read_to_string(cf, idx * page_size, page_size));
+    }
+    BOOST_REQUIRE_EQUAL(3, metrics.page_misses);
+    BOOST_REQUIRE_EQUAL(5, metrics.page_hits);
+
+    // All prefetched pages are evictable.
+    cf_lru.evict_all();
+    BOOST_REQUIRE_EQUAL(0, cf.cached_bytes());
+    BOOST_REQUIRE_EQUAL(5, metrics.page_evictions);
+}
@@ -26,6 +26,28 @@ BOOST_AUTO_TEST_CASE(test_caching_options) {
         sstring out_str = co.to_sstring();
         BOOST_REQUIRE_EQUAL(in_str, out_str);
     }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission_filter", "true"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(co.admission_filter());
+        BOOST_REQUIRE(co.enabled());
+        auto out_map = co.to_map();
+        BOOST_REQUIRE(in_map == out_map);
+        BOOST_REQUIRE(co != caching_options::from_map({}));
+    }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"pinned", "true"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(co.pinned());
+        BOOST_REQUIRE(!co.admission_filter());
+        auto out_map = co.to_map();
+        BOOST_REQUIRE(in_map == out_map);
+        BOOST_REQUIRE(co != caching_options::from_map({}));
+    }
+    {
+        BOOST_REQUIRE_THROW(caching_options::from_map({{"pinned", "true"}, {"enabled", "false"}}), std::exception);
+        BOOST_REQUIRE_THROW(caching_options::from_map({{"pinned", "true"}, {"admission_filter", "true"}}), std::exception);
+    }
     {
         sstring in_str = "{\"keys\": \"SOME\", \"rows_per_partition\": \"ALL\"}";
         BOOST_REQUIRE_THROW(caching_options::from_sstring(in_str), std::exception);
@@ -76,3 +76,11 @@ BOOST_AUTO_TEST_CASE(test_libdeflate_matches_zlib) {
 BOOST_AUTO_TEST_CASE(test_default_matches_zlib) {
     test<zlib_crc32_checksummer, crc32_utils>();
 }
+
+BOOST_AUTO_TEST_CASE(test_libdeflate_adler32_matches_zlib) {
+    test<zlib_adler32_checksummer, libdeflate_adler32_checksummer>();
+}
+
+BOOST_AUTO_TEST_CASE(test_default_adler32_matches_zlib) {
+    test<zlib_adler32_checksummer, adler32_utils>();
+}
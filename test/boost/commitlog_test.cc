@@ -9,6 +9,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 
 #include <stdlib.h>
 #include <iostream>
@@ -24,6 +25,7 @@
 #include <seastar/core/scollectd_api.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/seastar.hh>
+#include <seastar/core/byteorder.hh>
 #include <seastar/util/noncopyable_function.hh>
 #include <seastar/util/closeable.hh>
 
@@ -98,6 +100,39 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// check that concurrent batch mode writes share syncs
+SEASTAR_TEST_CASE(test_commitlog_group_commit_batch) {
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.group_commit_max_window_in_us = 10000;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        constexpr int n = 100;
+        auto uuid = utils::UUID_gen::get_time_UUID();
+        std::vector<replay_position> rps;
+        for (int round = 0; round < 3; ++round) {
+            co_await parallel_for_each(boost::irange(0, n), [&] (int) {
+                sstring tmp = "hej bubba cow";
+                return log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [tmp] (db::commitlog::output& dst) {
+                    dst.write(tmp.data(), tmp.size());
+                }).then([&] (replay_position rp) {
+                    rps.push_back(rp);
+                });
+            });
+        }
+        BOOST_REQUIRE_EQUAL(rps.size(), 3 * n);
+        BOOST_REQUIRE_LT(log.get_flush_count(), 3 * n);
+
+        size_t read = 0;
+        for (auto& seg : log.get_active_segment_names()) {
+            co_await db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&read] (db::commitlog::buffer_and_replay_position) {
+                ++read;
+                return make_ready_future<>();
+            });
+        }
+        BOOST_REQUIRE_EQUAL(read, 3 * n);
+    });
+}
+
 // check that an entry marked as sync is immediately flushed to a storage
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_sync){
     commitlog::config cfg;
@@ -412,6 +447,101 @@ SEASTAR_TEST_CASE(test_commitlog_reader){
         });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_compressed_chunks) {
+    for (sstring compression : { "lz4", "zstd" }) {
+        commitlog::config cfg;
+        cfg.commitlog_segment_size_in_mb = 1;
+        cfg.compression = compression;
+        co_await cl_test(cfg, [compression] (commitlog& log) {
+            return seastar::async([&log, compression] {
+                auto uuid = utils::UUID_gen::get_time_UUID();
+                rp_set set;
+                std::unordered_map<replay_position, sstring> written;
+                // Compressible entries, enough of them to fill several chunks.
+                for (int i = 0; i < 200; ++i) {
+                    auto entry = format("{:04} {}", i, sstring(4000, 'a' + i % 26));
+                    auto h = log.add_mutation(uuid, entry.size(), db::commitlog::force_sync::no, [&entry] (db::commitlog::output& dst) {
+                        dst.write(entry.data(), entry.size());
+                    }).get0();
+                    written.emplace(h.rp(), entry);
+                    set.put(std::move(h));
+                }
+                log.sync_all_segments().get();
+
+                std::unordered_map<replay_position, sstring> read;
+                for (auto& seg : log.get_active_segment_names()) {
+                    BOOST_REQUIRE_EQUAL(commitlog::descriptor(seg).ver, commitlog::descriptor::segment_version_3);
+                    db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&read] (db::commitlog::buffer_and_replay_position buf_rp) {
+                        auto&& [buf, rp] = buf_rp;
+                        auto linearization_buffer = bytes_ostream();
+                        auto in = buf.get_istream();
+                        read.emplace(rp, sstring(to_sstring_view(in.read_bytes_view(buf.size_bytes(), linearization_buffer))));
+                        return make_ready_future<>();
+                    }).get();
+                }
+                BOOST_REQUIRE(read == written);
+
+                // The compression header of the first chunk follows the
+                // segment header (5 ints) and the chunk header (2 ints).
+                auto seg = log.get_active_segment_names().front();
+                auto f = open_file_dma(seg, open_flags::ro).get0();
+                auto close_f = deferred_close(f);
+                auto buf = f.dma_read_exactly<char>(0, 4096).get0();
+                auto algorithm = read_be<uint32_t>(buf.get() + 7 * sizeof(uint32_t));
+                BOOST_REQUIRE_EQUAL(algorithm, compression == "lz4" ? 1 : 2);
+            });
+        });
+    }
+}
+
+SEASTAR_TEST_CASE(test_commitlog_overflow_directory) {
+    tmpdir overflow;
+    commitlog::config cfg;
+    cfg.commitlog_segment_size_in_mb = 1;
+    cfg.overflow_location = overflow.path().string();
+    co_await cl_test(cfg, [&overflow] (commitlog& log) {
+        return seastar::async([&log, &overflow] {
+            auto uuid = utils::UUID_gen::get_time_UUID();
+            rp_set set;
+            std::unordered_set<segment_id_type> ids;
+            size_t written = 0;
+            // Keep all entries dirty, so that closed segments have to be kept.
+            while (ids.size() < 3) {
+                sstring entry(64 * 1024, 'x');
+                auto h = log.add_mutation(uuid, entry.size(), db::commitlog::force_sync::no, [&entry] (db::commitlog::output& dst) {
+                    dst.write(entry.data(), entry.size());
+                }).get0();
+                ids.insert(h.rp().id);
+                set.put(std::move(h));
+                ++written;
+            }
+
+            auto dir = overflow.path().string() + "/";
+            auto moved = [&] {
+                auto names = log.get_active_segment_names();
+                return std::count_if(names.begin(), names.end(), [&] (const sstring& name) { return name.starts_with(dir); });
+            };
+            for (int i = 0; i < 1000 && moved() < 2; ++i) {
+                sleep(std::chrono::milliseconds(10)).get();
+            }
+            // The active segment is still written to in the commitlog directory.
+            BOOST_REQUIRE_EQUAL(moved(), 2);
+            BOOST_REQUIRE_EQUAL(log.list_existing_segments(overflow.path().string()).get0().size(), 2);
+
+            // Everything written is still there, wherever the segments are.
+            log.sync_all_segments().get();
+            size_t entries = 0;
+            for (auto& seg : log.get_active_segment_names()) {
+                db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&entries] (db::commitlog::buffer_and_replay_position) {
+                    ++entries;
+                    return make_ready_future<>();
+                }).get();
+            }
+            BOOST_REQUIRE_EQUAL(entries, written);
+        });
+    });
+}
+
 static future<> corrupt_segment(sstring seg, uint64_t off, uint32_t value) {
     return open_file_dma(seg, open_flags::rw).then([off, value](file f) {
         size_t size = align_up<size_t>(off, 4096);
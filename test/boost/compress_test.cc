@@ -10,6 +10,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <fmt/format.h>
+
 #include "sstables/compress.hh"
 
 BOOST_AUTO_TEST_CASE(segmented_offsets_basic_functionality) {
@@ -143,3 +145,65 @@ BOOST_AUTO_TEST_CASE(segmented_offsets_corner_cases) {
     BOOST_REQUIRE(accessor.at(4079) == 4079);
     BOOST_REQUIRE(accessor.at(4080) == 4080);
 }
+
+// Chunks of similar, but not identical, records. None of them compresses
+// well on its own, but they share most of their content.
+static std::vector<bytes> make_dictionary_test_chunks(size_t n, size_t chunk_size) {
+    std::vector<bytes> chunks;
+    size_t record = 0;
+    for (size_t i = 0; i < n; ++i) {
+        std::string chunk;
+        while (chunk.size() < chunk_size) {
+            chunk += fmt::format("{{\"user_id\": {}, \"country\": \"country-{}\", \"status\": \"active\", \"score\": {}}}",
+                    record, record % 17, (record * 7919) % 1000);
+            ++record;
+        }
+        chunk.resize(chunk_size);
+        chunks.emplace_back(reinterpret_cast<const int8_t*>(chunk.data()), chunk.size());
+    }
+    return chunks;
+}
+
+static void test_dictionary_compression(const sstring& name) {
+    auto c = compressor::create({{compression_parameters::SSTABLE_COMPRESSION, name}});
+    BOOST_REQUIRE(c->supports_dictionaries());
+
+    auto chunks = make_dictionary_test_chunks(256, 4096);
+    std::vector<bytes_view> samples(chunks.begin(), chunks.end());
+    auto raw = compressor::train_dictionary(samples, 16 * 1024);
+    BOOST_REQUIRE(!raw.empty());
+    BOOST_REQUIRE_LE(raw.size(), 16 * 1024);
+
+    auto dc = c->with_dictionary(c->prepare_dictionary(std::move(raw)));
+    size_t plain_size = 0;
+    size_t dict_size = 0;
+    for (auto& chunk : chunks) {
+        auto in = reinterpret_cast<const char*>(chunk.data());
+        std::vector<char> out(dc->compress_max_size(chunk.size()));
+        std::vector<char> back(chunk.size());
+
+        plain_size += c->compress(in, chunk.size(), out.data(), out.size());
+
+        auto len = dc->compress(in, chunk.size(), out.data(), out.size());
+        dict_size += len;
+        BOOST_REQUIRE_EQUAL(dc->uncompress(out.data(), len, back.data(), back.size()), chunk.size());
+        BOOST_REQUIRE(std::equal(back.begin(), back.end(), in));
+    }
+    BOOST_TEST_MESSAGE(fmt::format("{}: {} bytes without dictionary, {} bytes with", name, plain_size, dict_size));
+    BOOST_REQUIRE_LT(dict_size, plain_size);
+}
+
+BOOST_AUTO_TEST_CASE(lz4_dictionary_compression) {
+    test_dictionary_compression("LZ4Compressor");
+}
+
+BOOST_AUTO_TEST_CASE(zstd_dictionary_compression) {
+    test_dictionary_compression("ZstdCompressor");
+}
+
+BOOST_AUTO_TEST_CASE(dictionary_training_needs_samples) {
+    auto chunks = make_dictionary_test_chunks(1, 64);
+    std::vector<bytes_view> samples(chunks.begin(), chunks.end());
+    BOOST_REQUIRE(compressor::train_dictionary(samples, 16 * 1024).empty());
+    BOOST_REQUIRE(!compressor::snappy->supports_dictionaries());
+}
@@ -22,6 +22,7 @@
 #include "mutation.hh"
 #include "frozen_mutation.hh"
 #include "mutation_partition_view.hh"
+#include "counter_cache.hh"
 
 void verify_shard_order(counter_cell_view ccv) {
     if (ccv.shards().begin() == ccv.shards().end()) {
@@ -468,6 +469,96 @@ SEASTAR_TEST_CASE(test_transfer_updates_to_shards) {
     });
 }
 
+SEASTAR_TEST_CASE(test_counter_cache) {
+    return seastar::async([] {
+        auto s = get_schema();
+        auto local_id = utils::make_random_uuid();
+
+        auto pk = partition_key::from_single_value(*s, int32_type->decompose(0));
+        auto ck = clustering_key::from_single_value(*s, int32_type->decompose(0));
+        auto& col = *s->get_column_definition(utf8_type->decompose(sstring("c1")));
+        auto& scol = *s->get_column_definition(utf8_type->decompose(sstring("s1")));
+
+        auto make_update = [&] (int64_t delta) {
+            mutation m(s, pk);
+            m.set_clustered_cell(ck, col, atomic_cell::make_live_counter_update(api::new_timestamp(), delta));
+            m.set_static_cell(scol, atomic_cell::make_live_counter_update(api::new_timestamp(), delta));
+            return m;
+        };
+
+        counter_cache_stats stats;
+        counter_cache cache(s, 1024 * 1024, stats);
+
+        auto m1 = make_update(5);
+        auto generation = cache.generation();
+        BOOST_REQUIRE(!cache.get(m1, counter_id(local_id)));
+        transform_counter_updates_to_shards(m1, nullptr, 0, local_id);
+        cache.update(m1, counter_id(local_id), generation);
+
+        // The cached state gives the same result as the applied one would.
+        auto m2 = make_update(9);
+        auto m2_expected = m2;
+        transform_counter_updates_to_shards(m2_expected, &m1, 0, local_id);
+        generation = cache.generation();
+        auto cached = cache.get(m2, counter_id(local_id));
+        BOOST_REQUIRE(cached);
+        transform_counter_updates_to_shards(m2, &*cached, 0, local_id);
+        BOOST_REQUIRE_EQUAL(m2, m2_expected);
+        BOOST_REQUIRE_EQUAL(counter_cell_view(get_counter_cell(m2)).total_value(), 14);
+        BOOST_REQUIRE_EQUAL(counter_cell_view(get_static_counter_cell(m2)).total_value(), 14);
+        cache.update(m2, counter_id(local_id), generation);
+        BOOST_REQUIRE_EQUAL(stats.hits, 1);
+        BOOST_REQUIRE_EQUAL(stats.misses, 1);
+
+        // Updates of cells which aren't cached, and deletions, miss.
+        mutation m3(s, pk);
+        m3.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(1)), col,
+                atomic_cell::make_live_counter_update(api::new_timestamp(), 1));
+        BOOST_REQUIRE(!cache.get(m3, counter_id(local_id)));
+        mutation m4(s, pk);
+        m4.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+        BOOST_REQUIRE(counter_cache::has_tombstones(m4));
+        BOOST_REQUIRE(counter_cache::has_tombstones(freeze(m4), *s));
+        BOOST_REQUIRE(!counter_cache::has_tombstones(freeze(m2), *s));
+        BOOST_REQUIRE(!cache.get(m4, counter_id(local_id)));
+
+        // An update which began before an invalidation doesn't populate the cache.
+        generation = cache.generation();
+        cache.invalidate(m2.decorated_key());
+        BOOST_REQUIRE(!cache.get(make_update(1), counter_id(local_id)));
+        cache.update(m2, counter_id(local_id), generation);
+        BOOST_REQUIRE(!cache.get(make_update(1), counter_id(local_id)));
+        BOOST_REQUIRE_EQUAL(cache.memory_usage(), 0);
+
+        // The cache is bounded.
+        counter_cache small_cache(s, 1, stats);
+        small_cache.update(m2, counter_id(local_id), small_cache.generation());
+        BOOST_REQUIRE_EQUAL(small_cache.memory_usage(), 0);
+        BOOST_REQUIRE_EQUAL(stats.evictions, 1);
+
+        // The budget is shared by the caches of all tables: once it's
+        // exceeded, the cache which grows evicts from itself.
+        counter_cache_stats shared_stats;
+        size_t one_partition;
+        {
+            counter_cache cache(s, 1024 * 1024, shared_stats);
+            cache.update(m2, counter_id(local_id), cache.generation());
+            one_partition = cache.memory_usage();
+            BOOST_REQUIRE_EQUAL(shared_stats.memory_usage, one_partition);
+        }
+        BOOST_REQUIRE_EQUAL(shared_stats.memory_usage, 0);
+        counter_cache table1_cache(s, one_partition, shared_stats);
+        counter_cache table2_cache(s, one_partition, shared_stats);
+        table1_cache.update(m2, counter_id(local_id), table1_cache.generation());
+        table2_cache.update(m2, counter_id(local_id), table2_cache.generation());
+        BOOST_REQUIRE_EQUAL(table2_cache.memory_usage(), 0);
+        BOOST_REQUIRE_EQUAL(table1_cache.memory_usage(), one_partition);
+        BOOST_REQUIRE_EQUAL(shared_stats.memory_usage, one_partition);
+        table1_cache.clear();
+        BOOST_REQUIRE_EQUAL(shared_stats.memory_usage, 0);
+    });
+}
+
 SEASTAR_TEST_CASE(test_sanitize_corrupted_cells) {
     return seastar::async([] {
         auto& gen = seastar::testing::local_random_engine;
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "cql3/fast_parser.hh"
+#include "cql3/column_specification.hh"
+#include "cql3/query_processor.hh"
+#include "cql3/statements/modification_statement.hh"
+#include "cql3/statements/prepared_statement.hh"
+#include "cql3/statements/raw/cf_statement.hh"
+#include "cql3/util.hh"
+#include "exceptions/exceptions.hh"
+#include "service/query_state.hh"
+#include "test/lib/cql_assertions.hh"
+#include "test/lib/cql_test_env.hh"
+#include "transport/messages/result_message.hh"
+#include "types/list.hh"
+
+using namespace cql3;
+
+namespace {
+
+std::unique_ptr<statements::raw::parsed_statement> parse_with_grammar(std::string_view query) {
+    return util::do_with_parser(query, std::mem_fn(&cql3_parser::CqlParser::query));
+}
+
+std::unique_ptr<statements::prepared_statement> prepare(cql_test_env& e, statements::raw::parsed_statement& statement) {
+    dynamic_cast<statements::raw::cf_statement&>(statement).prepare_keyspace("ks");
+    return statement.prepare(e.local_db().as_data_dictionary(), e.local_qp().get_cql_stats());
+}
+
+raw_value int_value(int32_t v) {
+    return raw_value::make_value(int32_type->decompose(v));
+}
+
+// A statement, and the values of its markers if it is to be executed, not only prepared.
+struct test_statement {
+    sstring query;
+    std::optional<std::vector<raw_value>> values;
+};
+
+std::vector<std::vector<bytes_opt>> select_rows(cql_test_env& e, const statements::prepared_statement& p, std::vector<raw_value> values) {
+    query_options options(db::consistency_level::ONE, std::move(values));
+    options.prepare(p.bound_names);
+    service::query_state qs(e.local_client_state(), empty_service_permit());
+    auto msg = p.statement->execute(e.local_qp(), qs, options).get0();
+    auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+    BOOST_REQUIRE(rows);
+    return rows->rs().result_set().rows();
+}
+
+std::vector<mutation> modification_mutations(cql_test_env& e, const statements::prepared_statement& p, std::vector<raw_value> values) {
+    auto statement = dynamic_pointer_cast<statements::modification_statement>(p.statement);
+    BOOST_REQUIRE(statement);
+    query_options options(db::consistency_level::ONE, std::move(values));
+    options.prepare(p.bound_names);
+    service::query_state qs(e.local_client_state(), empty_service_permit());
+    auto timeout = db::timeout_clock::now() + std::chrono::seconds(10);
+    return statement->get_mutations(e.local_qp(), options, timeout, false, 1000, qs).get0();
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_fast_parser_leaves_other_statements_to_grammar) {
+    const char* recognized[] = {
+        "SELECT * FROM t",
+        "select * from ks.t;",
+        "SELECT a, \"B\", \"c\"\"d\" FROM \"T\" WHERE a = 'x''y' AND b IN (1, -2, 3.5) AND c >= ? AND d != :d",
+        "SELECT key, ttl, count FROM t WHERE key = 0xcafe ORDER BY ttl DESC, count PER PARTITION LIMIT 1 LIMIT ? ALLOW FILTERING BYPASS CACHE",
+        "INSERT INTO t (a, b, c, d) VALUES (1, true, null, ?) IF NOT EXISTS USING TTL 10 AND TIMESTAMP :ts",
+        "UPDATE t USING TIMEOUT ? SET a = a + 1, b = b - ?, c = 'z' WHERE k IN ? IF EXISTS",
+        "DELETE a, b FROM t USING TIMESTAMP 1 WHERE k = 1 AND c < 2",
+        "DELETE FROM t WHERE k = 1",
+    };
+    for (auto query : recognized) {
+        BOOST_TEST_INFO(query);
+        BOOST_REQUIRE(fast_parse_statement(query));
+    }
+
+    const char* declined[] = {
+        "SELECT DISTINCT k FROM t",
+        "SELECT JSON * FROM t",
+        "SELECT count(*) FROM t",
+        "SELECT writetime(v) FROM t",
+        "SELECT v AS x FROM t",
+        "SELECT t.v FROM t",
+        "SELECT text FROM t",
+        "SELECT * FROM t WHERE token(k) > 0",
+        "SELECT * FROM t WHERE (c, d) > (1, 2)",
+        "SELECT * FROM t WHERE v CONTAINS 1",
+        "SELECT * FROM t WHERE v LIKE 'a%'",
+        "SELECT * FROM t WHERE m['a'] = 1",
+        "SELECT * FROM t WHERE v = now()",
+        "SELECT * FROM t WHERE v = (int) 1",
+        "SELECT * FROM t WHERE d = 1h",
+        "SELECT * FROM t WHERE d = P1D",
+        "SELECT * FROM t WHERE u = 123e4567-e89b-12d3-a456-426614174000",
+        "SELECT * FROM t WHERE f = 1e5",
+        "SELECT * FROM t WHERE f = NaN",
+        "SELECT * FROM t WHERE v = $$x$$",
+        "SELECT * FROM t WHERE v = '\xc5\xbc\xc3\xb3\xc5\x82w'",
+        "SELECT * FROM t GROUP BY k",
+        "SELECT * FROM t -- a comment",
+        "SELECT * FROM t /* a comment */",
+        "SELECT * FROM t; SELECT * FROM t",
+        "INSERT INTO t JSON '{}'",
+        "INSERT INTO t (k, l) VALUES (1, [1, 2])",
+        "UPDATE t SET v = 1, v = 2 WHERE k = 1",
+        "UPDATE t SET v = w + 1 WHERE k = 1",
+        "UPDATE t SET v = v -1 WHERE k = 1",
+        "UPDATE t SET l = [1] + l WHERE k = 1",
+        "UPDATE t SET m['a'] = 1 WHERE k = 1",
+        "UPDATE t SET v = 1 WHERE k = 1 IF v = 2",
+        "DELETE m['a'] FROM t WHERE k = 1",
+        "BEGIN BATCH INSERT INTO t (k) VALUES (1) APPLY BATCH",
+        "CREATE TABLE t (k int PRIMARY KEY)",
+        "USE ks",
+        // Invalid statements, for the grammar to report.
+        "SELECT * FROM",
+        "SELECT * FROM t WHERE",
+        "SELECT * FROM t WHERE v = 'unterminated",
+        "INSERT INTO t (k) VALUES (1",
+        "SELECT * FROM ?",
+        "SELECT * FROM \"\"",
+    };
+    for (auto query : declined) {
+        BOOST_TEST_INFO(query);
+        BOOST_REQUIRE(!fast_parse_statement(query));
+    }
+
+    BOOST_REQUIRE_THROW(query_processor::parse_statement("SELECT * FROM t WHERE"), exceptions::syntax_exception);
+}
+
+// Differential test: the statements built by the fast parser and by the grammar must prepare to the same
+// bound variables, read the same rows and make the same mutations.
+SEASTAR_TEST_CASE(test_fast_parser_matches_grammar) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (p int, c int, v text, n bigint, f double, b blob, PRIMARY KEY (p, c))").get();
+        e.execute_cql("CREATE TABLE kw (key text PRIMARY KEY, ttl int, \"Quoted\" int)").get();
+        e.execute_cql("CREATE TABLE counters (p int PRIMARY KEY, n counter, m counter)").get();
+        for (int p = 0; p < 3; ++p) {
+            for (int c = 0; c < 4; ++c) {
+                e.execute_cql(format("INSERT INTO t (p, c, v, n, f, b) VALUES ({}, {}, 'v{}', {}, {}.5, 0xcafe0{})", p, c, c % 2, c - 2, c, c)).get();
+            }
+        }
+        e.execute_cql("INSERT INTO kw (key, ttl, \"Quoted\") VALUES ('k', 1, 2)").get();
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (3, 0, 'it''s')").get();
+
+        auto int_list = list_type_impl::get_instance(int32_type, false);
+        std::vector<test_statement> selects = {
+            {"SELECT * FROM t", std::vector<raw_value>{}},
+            {"SELECT p, c, v FROM ks.t WHERE p = 1", std::vector<raw_value>{}},
+            {"select \"p\", V from T where p = 1 and C > 1 and c <= 3;", std::vector<raw_value>{}},
+            {"SELECT c, v FROM t WHERE p = ? AND c >= ? ORDER BY c DESC LIMIT ?", std::vector{int_value(1), int_value(1), int_value(2)}},
+            {"SELECT * FROM t WHERE p IN (0, 2) AND c IN (1, 3)", std::vector<raw_value>{}},
+            {"SELECT * FROM t WHERE p = 0 AND c IN ?", std::vector{raw_value::make_value(*make_list_value(int_list, {0, 2}).serialize())}},
+            {"SELECT p, c FROM t WHERE v = 'it''s' ALLOW FILTERING", std::vector<raw_value>{}},
+            {"SELECT p, c FROM t WHERE p = 1 AND n > -2 AND f < 2.5 ALLOW FILTERING", std::vector<raw_value>{}},
+            {"SELECT c FROM t WHERE p = 2 AND b = 0xcafe02 ALLOW FILTERING", std::vector<raw_value>{}},
+            {"SELECT p, c FROM t PER PARTITION LIMIT 1 LIMIT 3 BYPASS CACHE", std::vector<raw_value>{}},
+            {"SELECT key, ttl FROM kw WHERE key = 'k'", std::vector<raw_value>{}},
+            {"SELECT \"Quoted\" FROM kw WHERE key = :key", std::vector{raw_value::make_value(utf8_type->decompose("k"))}},
+        };
+        std::vector<test_statement> modifications = {
+            {"INSERT INTO t (p, c, v, n, f, b) VALUES (1, 2, 'x', -3, 1.5, 0xff)", std::vector<raw_value>{}},
+            {"INSERT INTO t (p, c, v) VALUES (1, 2, null) USING TIMESTAMP 100 AND TTL 0", std::vector<raw_value>{}},
+            {"UPDATE t USING TIMESTAMP ? SET v = ?, n = 5 WHERE p = ? AND c IN (1, 2)",
+                    std::vector{raw_value::make_value(long_type->decompose(int64_t(7))), raw_value::make_value(utf8_type->decompose("u")), int_value(1)}},
+            {"UPDATE counters SET n = n + 1, m = m - ? WHERE p = 1", std::vector{raw_value::make_value(long_type->decompose(int64_t(3)))}},
+            {"DELETE FROM t WHERE p = 1 AND c = 2", std::vector<raw_value>{}},
+            {"DELETE v, n FROM t USING TIMESTAMP 5 WHERE p = 1 AND c = 1", std::vector<raw_value>{}},
+            {"DELETE FROM t WHERE p IN (1, 2)", std::vector<raw_value>{}},
+            {"DELETE FROM t WHERE p = 1 AND c > 0 AND c <= 2", std::vector<raw_value>{}},
+            // Conditional statements are only prepared.
+            {"insert into ks.t (p, c, v) values (?, ?, :v) if not exists", std::nullopt},
+            {"UPDATE kw USING TTL ? SET ttl = 1, \"Quoted\" = :q WHERE key = 'x' IF EXISTS", std::nullopt},
+            {"DELETE FROM t WHERE p = 1 AND c = 1 IF EXISTS", std::nullopt},
+        };
+
+        auto check = [&] (const test_statement& s, bool is_select) {
+            BOOST_TEST_MESSAGE(s.query);
+            auto fast = fast_parse_statement(s.query);
+            BOOST_REQUIRE(fast);
+            auto fast_prepared = prepare(e, *fast);
+            auto grammar_prepared = prepare(e, *parse_with_grammar(s.query));
+
+            BOOST_REQUIRE(typeid(*fast_prepared->statement) == typeid(*grammar_prepared->statement));
+            BOOST_REQUIRE_EQUAL(fast_prepared->bound_names.size(), grammar_prepared->bound_names.size());
+            for (size_t i = 0; i < fast_prepared->bound_names.size(); ++i) {
+                auto& a = *fast_prepared->bound_names[i];
+                auto& b = *grammar_prepared->bound_names[i];
+                BOOST_REQUIRE_EQUAL(a.name->text(), b.name->text());
+                BOOST_REQUIRE(a.type == b.type);
+                BOOST_REQUIRE_EQUAL(a.cf_name, b.cf_name);
+            }
+            BOOST_REQUIRE(fast_prepared->partition_key_bind_indices == grammar_prepared->partition_key_bind_indices);
+
+            if (!s.values) {
+                return;
+            }
+            if (is_select) {
+                auto rows = select_rows(e, *fast_prepared, *s.values);
+                BOOST_REQUIRE(!rows.empty());
+                BOOST_REQUIRE(rows == select_rows(e, *grammar_prepared, *s.values));
+            } else {
+                // Tombstones carry the local time, in seconds, which may tick between the two.
+                auto same_mutations = [&] {
+                    auto mutations = modification_mutations(e, *fast_prepared, *s.values);
+                    BOOST_REQUIRE(!mutations.empty());
+                    return mutations == modification_mutations(e, *grammar_prepared, *s.values);
+                };
+                BOOST_REQUIRE(same_mutations() || same_mutations());
+            }
+        };
+        for (auto& s : selects) {
+            check(s, true);
+        }
+        for (auto& s : modifications) {
+            check(s, false);
+        }
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_normalize_statement) {
+    auto normalized = normalize_statement("SELECT v FROM ks.\"T\" WHERE p = 1 AND c IN ('a''b', 0xff, -2.5, TRUE) LIMIT 10");
+    BOOST_REQUIRE(normalized);
+    BOOST_REQUIRE_EQUAL(normalized->text, "select v from ks . \"T\" where p = ? and c in ( ? , ? , ? , ? ) limit ?");
+    BOOST_REQUIRE_EQUAL(normalized->constants.size(), 6);
+    BOOST_REQUIRE_EQUAL(normalized->constants[1].partial_type, expr::untyped_constant::string);
+    BOOST_REQUIRE_EQUAL(normalized->constants[1].raw_text, "a'b");
+    BOOST_REQUIRE_EQUAL(normalized->constants[4].partial_type, expr::untyped_constant::boolean);
+    BOOST_REQUIRE_EQUAL(normalized->constants[5].raw_text, "10");
+
+    auto other = normalize_statement("select V from ks.\"T\" where P = 2 and C in ('x', 0x00, 1.0, false) limit 1");
+    BOOST_REQUIRE(other);
+    BOOST_REQUIRE_EQUAL(other->text, normalized->text);
+
+    auto with_null = normalize_statement("INSERT INTO t (k, v) VALUES (1, null) USING TTL 5");
+    BOOST_REQUIRE(with_null);
+    BOOST_REQUIRE_EQUAL(with_null->text, "insert into t ( k , v ) values ( ? , null ) using ttl ?");
+
+    BOOST_REQUIRE(!normalize_statement("SELECT * FROM t WHERE k = ?"));
+    BOOST_REQUIRE(!normalize_statement("SELECT * FROM t WHERE k = :k"));
+    BOOST_REQUIRE(!normalize_statement("SELECT count(*) FROM t"));
+}
+
+SEASTAR_TEST_CASE(test_unprepared_statements_share_plans) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (p int, c int, v text, PRIMARY KEY (p, c))").get();
+        auto& stats = unprepared_statements_cache::shard_stats();
+
+        auto misses = stats.misses;
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (1, 1, 'a')").get();
+        BOOST_REQUIRE_EQUAL(stats.misses, misses + 1);
+        auto hits = stats.hits;
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (2, 2, 'b')").get();
+        e.execute_cql("insert into t (p, c, v) values (2, 3, 'c')").get();
+        BOOST_REQUIRE_EQUAL(stats.hits, hits + 2);
+
+        e.execute_cql("SELECT v FROM t WHERE p = 1").get();
+        hits = stats.hits;
+        assert_that(e.execute_cql("SELECT v FROM t WHERE p = 2").get0()).is_rows().with_rows({
+            {utf8_type->decompose("b")},
+            {utf8_type->decompose("c")},
+        });
+        BOOST_REQUIRE_EQUAL(stats.hits, hits + 1);
+
+        // The constants are still validated against the columns they are compared with.
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT v FROM t WHERE p = 'x'").get(), exceptions::invalid_request_exception);
+
+        // Schema changes invalidate the cached plans.
+        e.execute_cql("SELECT * FROM t WHERE p = 2").get();
+        e.execute_cql("ALTER TABLE t ADD w int").get();
+        misses = stats.misses;
+        assert_that(e.execute_cql("SELECT * FROM t WHERE p = 1").get0()).is_rows().with_rows({
+            {int32_type->decompose(1), int32_type->decompose(1), utf8_type->decompose("a"), std::nullopt},
+        });
+        BOOST_REQUIRE_EQUAL(stats.misses, misses + 1);
+    });
+}
@@ -30,6 +30,9 @@
 #include "compaction/compaction_manager.hh"
 #include "test/lib/exception_utils.hh"
 #include "schema_builder.hh"
+#include "db/large_data_handler.hh"
+#include "sstables/sstables_manager.hh"
+#include "utils/UUID.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -132,6 +135,81 @@ SEASTAR_THREAD_TEST_CASE(test_large_data) {
     }, cfg).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_large_partitions_tracker) {
+    auto s = schema_builder("ks", "tbl")
+            .with_column("a", int32_type, column_kind::partition_key)
+            .build();
+    auto pk = [&] (int32_t a) { return partition_key::from_single_value(*s, int32_type->decompose(a)); };
+    auto token = [&] (int32_t a) { return dht::get_token(*s, pk(a)); };
+
+    db::large_partitions_tracker tracker(2);
+    BOOST_REQUIRE(tracker.empty());
+    tracker.record(*s, pk(1), 100, 10);
+    tracker.record(*s, pk(2), 200, 20);
+    tracker.record(*s, pk(1), 50, 30);
+    auto* e1 = tracker.find(s->id(), token(1));
+    BOOST_REQUIRE(e1);
+    BOOST_REQUIRE_EQUAL(e1->size, 100);
+    BOOST_REQUIRE_EQUAL(e1->rows, 30);
+    BOOST_REQUIRE_EQUAL(e1->first_size, 100);
+
+    // Looking a partition up doesn't count as a read of it.
+    BOOST_REQUIRE_EQUAL(e1->reads, 0);
+    BOOST_REQUIRE_EQUAL(tracker.reads(), 0);
+    tracker.count_read(*e1);
+    BOOST_REQUIRE_EQUAL(e1->reads, 1);
+    BOOST_REQUIRE_EQUAL(tracker.reads(), 1);
+
+    // At capacity, a partition smaller than all the tracked ones is ignored,
+    // and a larger one replaces the smallest.
+    tracker.record(*s, pk(3), 50, 1);
+    BOOST_REQUIRE(!tracker.find(s->id(), token(3)));
+    tracker.record(*s, pk(3), 300, 1);
+    BOOST_REQUIRE(tracker.find(s->id(), token(3)));
+    BOOST_REQUIRE(!tracker.find(s->id(), token(1)));
+    BOOST_REQUIRE(tracker.find(s->id(), token(2)));
+
+    tracker.forget(utils::make_random_uuid());
+    BOOST_REQUIRE_EQUAL(tracker.partitions().size(), 2);
+    tracker.forget(s->id());
+    BOOST_REQUIRE(tracker.empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_large_partitions_tracked_reads) {
+    auto cfg = make_shared<db::config>();
+    cfg->compaction_rows_count_warning_threshold(5);
+    do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table tbl (a int, b int, primary key (a, b))").get();
+        for (int i = 0; i < 10; ++i) {
+            e.execute_cql(format("insert into tbl (a, b) values (1, {});", i)).get();
+        }
+        e.execute_cql("insert into tbl (a, b) values (2, 0);").get();
+        flush(e);
+
+        auto s = e.local_db().find_schema("ks", "tbl");
+        auto tracked_reads = [&] {
+            return e.db().map_reduce0([] (replica::database& db) {
+                return db.get_user_sstables_manager().get_large_data_handler().large_partitions().reads();
+            }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto is_known_large_partition = [&] (int32_t a) {
+            auto dk = dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(a)));
+            return e.db().invoke_on(dht::shard_of(*s, dk.token()), [dk, id = s->id()] (replica::database& db) {
+                return db.find_column_family(id).is_known_large_partition(dht::partition_range::make_singular(dk));
+            }).get0();
+        };
+
+        BOOST_REQUIRE(is_known_large_partition(1));
+        BOOST_REQUIRE(!is_known_large_partition(2));
+        BOOST_REQUIRE_EQUAL(tracked_reads(), 0);
+
+        e.execute_cql("select * from tbl where a = 1;").get();
+        BOOST_REQUIRE_EQUAL(tracked_reads(), 1);
+        e.execute_cql("select * from tbl where a = 2;").get();
+        BOOST_REQUIRE_EQUAL(tracked_reads(), 1);
+    }, cfg).get();
+}
+
 SEASTAR_TEST_CASE(test_insert_large_collection_values) {
     return do_with_cql_env([] (cql_test_env& e) {
         return seastar::async([&e] {
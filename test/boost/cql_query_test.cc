@@ -42,8 +42,11 @@
 #include <regex>
 #include "gms/feature.hh"
 #include "db/query_context.hh"
+#include "cql3/query_processor.hh"
 #include "service/qos/qos_common.hh"
 #include "utils/UUID_gen.hh"
+#include "service/storage_proxy.hh"
+#include "test/lib/eventually.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -91,6 +94,27 @@ SEASTAR_TEST_CASE(test_create_table_with_id_statement) {
     });
 }
 
+SEASTAR_TEST_CASE(test_incremental_compaction_strategy_needs_cluster_feature) {
+    cql_test_config cfg;
+    cfg.disabled_features.insert(sstring(gms::features::INCREMENTAL_COMPACTION_STRATEGY));
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        BOOST_REQUIRE_THROW(
+            e.execute_cql("CREATE TABLE tbl (a int PRIMARY KEY, b int) WITH compaction = {'class': 'IncrementalCompactionStrategy'}").get(),
+            exceptions::configuration_exception);
+        e.execute_cql("CREATE TABLE tbl (a int PRIMARY KEY, b int)").get();
+        BOOST_REQUIRE_THROW(
+            e.execute_cql("ALTER TABLE tbl WITH compaction = {'class': 'IncrementalCompactionStrategy'}").get(),
+            exceptions::configuration_exception);
+    }, std::move(cfg));
+}
+
+SEASTAR_TEST_CASE(test_incremental_compaction_strategy) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("CREATE TABLE tbl (a int PRIMARY KEY, b int) WITH compaction = {'class': 'IncrementalCompactionStrategy'}").get();
+        BOOST_REQUIRE(e.local_db().find_schema("ks", "tbl")->configured_compaction_strategy() == sstables::compaction_strategy_type::incremental);
+    });
+}
+
 SEASTAR_TEST_CASE(test_drop_table_with_si_and_mv) {
     return do_with_cql_env([](cql_test_env& e) {
         return seastar::async([&e] {
@@ -5017,3 +5041,196 @@ SEASTAR_TEST_CASE(test_parallelized_select_count) {
         BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
     });
 }
+
+SEASTAR_TEST_CASE(test_parallelized_select_native_aggregates) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+
+        e.execute_cql("CREATE TABLE tbl (k int, v int, d double, t text, PRIMARY KEY (k));").get();
+        int value_count = 10;
+        for (int i = 0; i < value_count; i++) {
+            e.execute_cql(format("INSERT INTO tbl (k, v, d, t) VALUES ({:d}, {:d}, {:d}.5, '{:d}');", i, i, i, i)).get();
+        }
+        // A row without v, which count(v) must not count.
+        e.execute_cql("INSERT INTO tbl (k) VALUES (100);").get();
+
+        auto require_parallelized = [&] (sstring query, std::vector<bytes_opt> expected) {
+            auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+            auto msg = e.execute_cql(query).get0();
+            assert_that(msg).is_rows().with_rows({expected});
+            BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+        };
+
+        require_parallelized("SELECT count(v) FROM tbl;", {long_type->decompose(int64_t(value_count))});
+        require_parallelized("SELECT min(v), max(v) FROM tbl;", {int32_type->decompose(0), int32_type->decompose(value_count - 1)});
+        require_parallelized("SELECT sum(v) FROM tbl;", {int32_type->decompose(value_count * (value_count - 1) / 2)});
+        require_parallelized("SELECT sum(d) FROM tbl;", {double_type->decompose(value_count * (value_count - 1) / 2 + value_count * 0.5)});
+        require_parallelized("SELECT min(t), max(t) FROM tbl;", {utf8_type->decompose("0"), utf8_type->decompose("9")});
+        require_parallelized("SELECT count(*), count(v), min(v), max(v), sum(v) FROM tbl;", {
+            long_type->decompose(int64_t(value_count + 1)),
+            long_type->decompose(int64_t(value_count)),
+            int32_type->decompose(0),
+            int32_type->decompose(value_count - 1),
+            int32_type->decompose(value_count * (value_count - 1) / 2),
+        });
+
+        // An aggregate over no rows at all.
+        e.execute_cql("CREATE TABLE empty_tbl (k int, v int, PRIMARY KEY (k));").get();
+        require_parallelized("SELECT count(v), min(v), sum(v) FROM empty_tbl;",
+                {long_type->decompose(int64_t(0)), std::nullopt, int32_type->decompose(0)});
+
+        // Aggregates which can't be merged, and queries which need
+        // filtering, are still computed by the coordinator.
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+        assert_that(e.execute_cql("SELECT avg(v) FROM tbl;").get0()).is_rows().with_rows({{int32_type->decompose(4)}});
+        assert_that(e.execute_cql("SELECT max(v) FROM tbl WHERE v < 5 ALLOW FILTERING;").get0()).is_rows().with_rows({{int32_type->decompose(4)}});
+        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_native_aggregates_needs_cluster_feature) {
+    cql_test_config cfg;
+    cfg.disabled_features.insert(sstring(gms::features::PARALLELIZED_NATIVE_AGGREGATES));
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+
+        e.execute_cql("CREATE TABLE tbl (k int, v int, PRIMARY KEY (k));").get();
+        for (int i = 0; i < 10; i++) {
+            e.execute_cql(format("INSERT INTO tbl (k, v) VALUES ({:d}, {:d});", i, i)).get();
+        }
+
+        // Until the whole cluster understands aggregation_infos, only a
+        // bare count(*) is forwarded, as before.
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+        assert_that(e.execute_cql("SELECT max(v) FROM tbl;").get0()).is_rows().with_rows({{int32_type->decompose(9)}});
+        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+        assert_that(e.execute_cql("SELECT count(*) FROM tbl;").get0()).is_rows().with_rows({{long_type->decompose(int64_t(10))}});
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+    }, std::move(cfg));
+}
+
+SEASTAR_TEST_CASE(test_lwt_background_learn) {
+    auto cfg = make_shared<db::config>();
+    cfg->enable_lwt_background_learn.set(true);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto& stats = e.local_qp().proxy().get_stats();
+        auto applied = [] { return std::vector<bytes_opt>{boolean_type->decompose(true)}; };
+
+        e.execute_cql("CREATE TABLE t (k int PRIMARY KEY, v int);").get();
+        auto learned = stats.cas_background_learn;
+        assert_that(e.execute_cql("INSERT INTO t (k, v) VALUES (1, 1) IF NOT EXISTS;").get0()).is_rows().with_rows({applied()});
+        BOOST_REQUIRE_EQUAL(stats.cas_background_learn, learned + 1);
+
+        // The next transaction on the key sees the decision, whether or not
+        // it was learned yet.
+        assert_that(e.execute_cql("UPDATE t SET v = 2 WHERE k = 1 IF v = 1;").get0()).is_rows().with_rows({applied()});
+        BOOST_REQUIRE_EQUAL(stats.cas_background_learn, learned + 2);
+
+        // Non-serial reads see it once it's learned.
+        eventually([&] {
+            assert_that(e.execute_cql("SELECT v FROM t WHERE k = 1;").get0()).is_rows().with_rows({{int32_type->decompose(2)}});
+        });
+    }, cfg);
+}
+
+SEASTAR_TEST_CASE(test_prepared_select_with_bound_partition_key) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("CREATE TABLE tbl (pk1 int, pk2 text, ck int, v int, PRIMARY KEY ((pk1, pk2), ck));").get();
+        for (int i = 0; i < 3; i++) {
+            e.execute_cql(format("INSERT INTO tbl (pk1, pk2, ck, v) VALUES ({0}, '{0}', {0}, {0});", i)).get();
+        }
+        auto select = [&] (const std::string& query, std::vector<cql3::raw_value> values) {
+            auto id = e.prepare(query).get0();
+            return e.execute_prepared(id, std::move(values)).get0();
+        };
+        auto pk1 = [] (int32_t v) { return cql3::raw_value::make_value(int32_type->decompose(v)); };
+        auto pk2 = [] (sstring v) { return cql3::raw_value::make_value(utf8_type->decompose(v)); };
+
+        // Bind markers in an order other than the partition key's.
+        assert_that(select("SELECT v FROM tbl WHERE pk2 = ? AND pk1 = ?", {pk2("1"), pk1(1)}))
+            .is_rows().with_rows({{int32_type->decompose(1)}});
+        assert_that(select("SELECT v FROM tbl WHERE pk1 = ? AND pk2 = ?", {pk1(1), pk2("2")}))
+            .is_rows().with_size(0);
+        assert_that(select("SELECT v FROM tbl WHERE pk1 = ? AND pk2 = ?", {pk1(2), cql3::raw_value::make_null()}))
+            .is_rows().with_size(0);
+        BOOST_REQUIRE_THROW(select("SELECT v FROM tbl WHERE pk1 = ? AND pk2 = ?",
+                {cql3::raw_value::make_value(bytes(1, int8_t(0))), pk2("2")}), exceptions::invalid_request_exception);
+    });
+}
+
+SEASTAR_TEST_CASE(test_prepare_remembered_statement) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int PRIMARY KEY, v int);").get();
+        e.execute_cql("INSERT INTO t (pk, v) VALUES (1, 2);").get();
+
+        // Prepares the statement on this shard only, as a PREPARE does.
+        auto prepare = [&] (const sstring& query) {
+            service::client_state client_state(service::client_state::internal_tag{});
+            client_state.set_raw_keyspace("ks");
+            e.local_qp().prepare(query, client_state, false).get();
+            auto key = cql3::query_processor::compute_id(query, "ks");
+            e.local_qp().remember_prepared(key, query, "ks").get();
+            return key;
+        };
+        auto saved = [&] (const cql3::prepared_cache_key_type& key) {
+            auto msg = e.execute_cql(format("SELECT query_string FROM system.prepared_statements WHERE prepared_id = 0x{}",
+                    to_hex(cql3::prepared_cache_key_type::cql_id(key)))).get0();
+            auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+            return rows->rs().result_set().size() != 0;
+        };
+
+        const sstring query = "SELECT v FROM t WHERE pk = ?";
+        auto key = prepare(query);
+
+        // Every shard can prepare the statement, with the same id.
+        e.qp().invoke_on_all([key] (cql3::query_processor& qp) {
+            return qp.prepare_remembered(key).then([&qp, key] (bool prepared) {
+                BOOST_REQUIRE(prepared);
+                BOOST_REQUIRE(qp.get_prepared(key));
+            });
+        }).get();
+        auto msg = e.execute_prepared(key, {cql3::raw_value::make_value(int32_type->decompose(1))}).get0();
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(2)}});
+
+        // The statements are remembered across restarts.
+        assert_that(e.execute_cql(format("SELECT logged_keyspace, query_string FROM system.prepared_statements WHERE prepared_id = 0x{}",
+                to_hex(cql3::prepared_cache_key_type::cql_id(key)))).get0())
+            .is_rows().with_rows({{utf8_type->decompose("ks"), utf8_type->decompose(query)}});
+
+        // Statements which weren't remembered.
+        BOOST_REQUIRE(!e.local_qp().prepare_remembered(cql3::query_processor::compute_id("SELECT v FROM t", "ks")).get0());
+
+        // Statements which may hold credentials are neither remembered nor saved.
+        auto role_key = prepare("CREATE ROLE r WITH PASSWORD = 'secret' AND LOGIN = true");
+        BOOST_REQUIRE(!saved(role_key));
+        smp::submit_to((this_shard_id() + 1) % smp::count, [&e, role_key] {
+            return e.local_qp().prepare_remembered(role_key).then([] (bool prepared) {
+                BOOST_REQUIRE(!prepared);
+            });
+        }).get();
+
+        // After the table is altered, the statement must be prepared again by
+        // the client, which would otherwise decode the rows with stale metadata.
+        e.execute_cql("ALTER TABLE t ADD w int;").get();
+        e.qp().invoke_on_all([key] (cql3::query_processor& qp) {
+            BOOST_REQUIRE(!qp.get_prepared(key));
+            return qp.prepare_remembered(key).then([&qp, key] (bool prepared) {
+                BOOST_REQUIRE(!prepared);
+                BOOST_REQUIRE(!qp.get_prepared(key));
+            });
+        }).get();
+        BOOST_REQUIRE(!saved(key));
+
+        // Once prepared again, the statement is remembered again.
+        key = prepare(query);
+        e.qp().invoke_on_all([key] (cql3::query_processor& qp) {
+            return qp.prepare_remembered(key).then([] (bool prepared) {
+                BOOST_REQUIRE(prepared);
+            });
+        }).get();
+
+        // Statements of dropped tables can't be prepared anymore.
+        e.execute_cql("DROP TABLE t;").get();
+        BOOST_REQUIRE(!e.local_qp().prepare_remembered(key).get0());
+    });
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "transport/segment.hh"
+#include "exceptions/exceptions.hh"
+#include "utils/buffer_input_stream.hh"
+
+using namespace cql_transport;
+
+namespace {
+
+struct envelope {
+    sstring header;
+    bytes_ostream body;
+};
+
+envelope make_envelope(int i, size_t body_size) {
+    envelope e;
+    e.header = format("header-{:03d}", i);
+    auto body = format("row {} of the result: status=delivered, ts={};", i, 1600000000000 + i);
+    while (e.body.size() < body_size) {
+        auto n = std::min(body.size(), body_size - e.body.size());
+        e.body.write(bytes_view(reinterpret_cast<const int8_t*>(body.data()), n));
+    }
+    return e;
+}
+
+sstring concat(const std::vector<envelope>& envelopes) {
+    sstring ret;
+    for (auto& e : envelopes) {
+        ret += e.header;
+        for (bytes_view f : e.body.fragments()) {
+            ret.append(reinterpret_cast<const char*>(f.data()), f.size());
+        }
+    }
+    return ret;
+}
+
+temporary_buffer<char> concat(const std::vector<temporary_buffer<char>>& segments) {
+    size_t size = 0;
+    for (auto& s : segments) {
+        size += s.size();
+    }
+    temporary_buffer<char> ret(size);
+    auto p = ret.get_write();
+    for (auto& s : segments) {
+        p = std::copy_n(s.get(), s.size(), p);
+    }
+    return ret;
+}
+
+// Reads back the payloads of the segments, with the underlying stream
+// returning them in small chunks.
+sstring read_all(temporary_buffer<char> segments, bool compressed) {
+    auto in = input_stream<char>(make_segment_source(make_buffer_input_stream(std::move(segments), [] { return 1000; }), compressed));
+    sstring ret;
+    for (;;) {
+        auto buf = in.read().get0();
+        if (buf.empty()) {
+            break;
+        }
+        ret.append(buf.get(), buf.size());
+    }
+    in.close().get();
+    return ret;
+}
+
+std::vector<temporary_buffer<char>> write_all(const std::vector<envelope>& envelopes, bool compress) {
+    segment_writer writer(compress);
+    for (auto& e : envelopes) {
+        writer.write(e.header, e.body);
+    }
+    return std::move(writer).finish();
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_round_trip) {
+    for (bool compress : {false, true}) {
+        BOOST_TEST_MESSAGE(format("compress={}", compress));
+
+        // Small envelopes share a segment.
+        std::vector<envelope> small;
+        for (int i = 0; i < 100; ++i) {
+            small.push_back(make_envelope(i, 100));
+        }
+        auto segments = write_all(small, compress);
+        BOOST_REQUIRE_EQUAL(segments.size(), 1);
+        if (compress) {
+            BOOST_REQUIRE_LT(segments.front().size(), concat(small).size() / 2);
+        }
+        BOOST_REQUIRE(read_all(concat(segments), compress) == concat(small));
+
+        // An envelope too large for a segment is split, and doesn't share
+        // segments with the envelopes around it.
+        std::vector<envelope> mixed;
+        mixed.push_back(make_envelope(0, 100));
+        mixed.push_back(make_envelope(1, 3 * segment::max_payload_size));
+        mixed.push_back(make_envelope(2, 100));
+        segments = write_all(mixed, compress);
+        BOOST_REQUIRE_EQUAL(segments.size(), 6);
+        BOOST_REQUIRE(read_all(concat(segments), compress) == concat(mixed));
+
+        BOOST_REQUIRE(write_all({}, compress).empty());
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_corruption) {
+    for (bool compress : {false, true}) {
+        std::vector<envelope> envelopes;
+        envelopes.push_back(make_envelope(0, 1000));
+        auto segments = concat(write_all(envelopes, compress));
+        // Flip a bit of the header, of the payload and of its checksum.
+        for (size_t pos : {size_t(1), segments.size() / 2, segments.size() - 1}) {
+            auto corrupted = segments.clone();
+            corrupted.get_write()[pos] ^= 0x10;
+            BOOST_REQUIRE_THROW(read_all(std::move(corrupted), compress), exceptions::protocol_exception);
+        }
+        // Truncated.
+        BOOST_REQUIRE_THROW(read_all(segments.share(0, segments.size() - 1), compress), exceptions::protocol_exception);
+    }
+}
@@ -15,6 +15,7 @@
 #include "cql3/query_processor.hh"
 
 #include "db/data_listeners.hh"
+#include "db/config.hh"
 
 using namespace std;
 using namespace std::chrono_literals;
@@ -113,3 +114,31 @@ SEASTAR_TEST_CASE(test_dlistener_t2) {
         BOOST_REQUIRE_EQUAL(0, res.write);
     });
 }
+
+SEASTAR_TEST_CASE(test_hot_partitions) {
+    auto db_cfg = make_shared<db::config>();
+    db_cfg->hot_partitions_sample_period.set(1);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t1 (k int, c int, PRIMARY KEY (k, c));").get();
+        e.execute_cql("INSERT INTO t1 (k, c) VALUES (1, 1);").get();
+        e.execute_cql("INSERT INTO t1 (k, c) VALUES (1, 2);").get();
+        e.execute_cql("INSERT INTO t1 (k, c) VALUES (1, 3);").get();
+        e.execute_cql("INSERT INTO t1 (k, c) VALUES (2, 1);").get();
+        e.execute_cql("SELECT * FROM t1 WHERE k = 2;").get();
+
+        // Nothing is reported till the end of the window.
+        assert_that(e.execute_cql("SELECT operation, partition_key, count FROM system.hot_partitions WHERE keyspace_name = 'ks';").get0())
+            .is_rows().is_empty();
+
+        e.db().invoke_on_all([] (replica::database& db) {
+            db.hot_partitions().rotate();
+        }).get();
+
+        assert_that(e.execute_cql("SELECT operation, partition_key, count FROM system.hot_partitions WHERE keyspace_name = 'ks';").get0())
+            .is_rows().with_rows_ignore_order({
+                {utf8_type->decompose("write"), utf8_type->decompose("1"), long_type->decompose(int64_t(3))},
+                {utf8_type->decompose("write"), utf8_type->decompose("2"), long_type->decompose(int64_t(1))},
+                {utf8_type->decompose("read"), utf8_type->decompose("2"), long_type->decompose(int64_t(1))},
+            });
+    }, db_cfg);
+}
@@ -10,12 +10,14 @@
 #include <seastar/core/seastar.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/sleep.hh>
 
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
 
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/result_set_assertions.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/log.hh"
 #include "test/lib/random_utils.hh"
 
@@ -35,6 +37,7 @@
 #include "multishard_mutation_query.hh"
 #include "transport/messages/result_message.hh"
 #include "db/snapshot-ctl.hh"
+#include "digest_cache.hh"
 
 using namespace std::chrono_literals;
 
@@ -93,6 +96,31 @@ SEASTAR_TEST_CASE(test_safety_after_truncate) {
     }, cfg);
 }
 
+SEASTAR_TEST_CASE(test_commitlog_replay_of_many_partitions) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k int, v int, primary key (k));").get();
+        // Enough entries for several replay batches per shard.
+        const int n = 2000;
+        for (int i = 0; i < n; ++i) {
+            e.execute_cql(format("insert into ks.cf (k, v) values ({}, {});", i, i)).get();
+        }
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.find_column_family("ks", "cf").clear();
+        }).get();
+        assert_that(e.execute_cql("select * from ks.cf;").get0()).is_rows().with_size(0);
+
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.commitlog()->sync_all_segments();
+        }).get();
+        auto cl = e.local_db().commitlog();
+        auto rp = db::commitlog_replayer::create_replayer(e.db()).get0();
+        auto paths = cl->list_existing_segments().get0();
+        rp.recover(paths, db::commitlog::descriptor::FILENAME_PREFIX).get();
+
+        assert_that(e.execute_cql("select * from ks.cf;").get0()).is_rows().with_size(n);
+    });
+}
+
 SEASTAR_TEST_CASE(test_querying_with_limits) {
     return do_with_cql_env([](cql_test_env& e) {
         return seastar::async([&] {
@@ -656,6 +684,46 @@ SEASTAR_TEST_CASE(test_snapshot_ctl_true_snapshots_size) {
     });
 }
 
+SEASTAR_TEST_CASE(test_snapshot_ctl_backup_is_incremental) {
+    return do_with_some_data({"cf"}, [] (cql_test_env& e) {
+        sharded<db::snapshot_ctl> sc;
+        sc.start(std::ref(e.db())).get();
+        auto stop_sc = deferred_stop(sc);
+        tmpdir destination;
+
+        auto& cf = e.local_db().find_column_family("ks", "cf");
+        take_snapshot(e, "ks", "cf", "first").get();
+        auto first = sc.local().backup_snapshot("first", {"ks"}, destination.path().string()).get0();
+        BOOST_REQUIRE_GT(first.files_uploaded, 0);
+        BOOST_REQUIRE_GT(first.bytes_uploaded, 0);
+        BOOST_REQUIRE_EQUAL(first.files_skipped, 0);
+
+        auto table_destination = destination.path() / "ks" / fs::path(cf.dir()).filename();
+        BOOST_REQUIRE(file_exists((table_destination / sstables::snapshots_dir / "first" / "manifest.json").native()).get0());
+
+        // Only the new sstables, and the manifest and schema of the second snapshot, are uploaded.
+        e.execute_cql("insert into ks.cf (p1, c1, c2, r1) values ('key2', 1, 2, 3);").get();
+        take_snapshot(e, "ks", "cf", "second").get();
+        auto second = sc.local().backup_snapshot("second", {"ks"}, destination.path().string()).get0();
+        BOOST_REQUIRE_GT(second.files_uploaded, 0);
+        BOOST_REQUIRE_GT(second.files_skipped, 0);
+
+        // Each sstable was uploaded once.
+        auto list_files = [] (fs::path dir) {
+            std::set<sstring> files;
+            lister::scan_dir(dir, { directory_entry_type::regular }, [&files] (fs::path, directory_entry de) {
+                files.insert(de.name);
+                return make_ready_future<>();
+            }).get();
+            return files;
+        };
+        BOOST_REQUIRE(list_files(table_destination) == list_files(fs::path(cf.dir())));
+
+        BOOST_REQUIRE_THROW(sc.local().backup_snapshot("none", {"ks"}, destination.path().string()).get(), std::runtime_error);
+        return make_ready_future<>();
+    });
+}
+
 // toppartitions_query caused a lw_shared_ptr to cross shards when moving results, #5104
 SEASTAR_TEST_CASE(toppartitions_cross_shard_schema_ptr) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
@@ -926,6 +994,89 @@ SEASTAR_TEST_CASE(upgrade_sstables) {
     });
 }
 
+// Test that garbage collection rewrites, on their own, only the sstables which have purgeable data.
+SEASTAR_TEST_CASE(garbage_collection_rewrites_only_sstables_with_purgeable_data) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (p int, c int, v int, primary key (p, c)) with gc_grace_seconds = 0;").get();
+        auto flush = [&e] {
+            e.db().invoke_on_all([] (replica::database& db) {
+                return db.find_column_family("ks", "cf").flush();
+            }).get();
+        };
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.find_column_family("ks", "cf").disable_auto_compaction();
+        }).get();
+
+        e.execute_cql("insert into ks.cf (p, c, v) values (0, 0, 0);").get();
+        flush();
+        for (int p = 1; p <= 4; ++p) {
+            e.execute_cql(format("delete from ks.cf where p = {};", p)).get();
+            flush();
+        }
+        // Let the tombstones become purgeable.
+        sleep(std::chrono::seconds(2)).get();
+
+        auto ok = e.db().map_reduce0([] (replica::database& db) -> future<bool> {
+            auto& cf = db.find_column_family("ks", "cf");
+            // The sstables with deletions only are expected to be rewritten into nothing,
+            // while the one with live data only is expected to be left alone.
+            std::unordered_set<sstables::shared_sstable> expected;
+            for (auto& sst : *cf.get_sstables()) {
+                if (sst->estimate_droppable_tombstone_ratio(gc_clock::now()) == 0) {
+                    expected.insert(sst);
+                }
+            }
+            co_await db.get_compaction_manager().perform_garbage_collection(&cf);
+            auto after = *cf.get_sstables();
+            co_return std::unordered_set<sstables::shared_sstable>(after.begin(), after.end()) == expected;
+        }, true, std::logical_and<bool>()).get0();
+        BOOST_REQUIRE(ok);
+
+        auto msg = e.execute_cql("select * from ks.cf;").get0();
+        assert_that(msg).is_rows().with_size(1);
+    });
+}
+
+// Test that a memtable flush drops purgeable tombstones which can't shadow anything
+// on disk, as for system.paxos.
+SEASTAR_TEST_CASE(memtable_flush_purges_tombstones_of_gc_grace_zero_tables) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (p int, c int, v int, primary key (p, c)) with gc_grace_seconds = 0;").get();
+        auto flush = [&e] {
+            e.db().invoke_on_all([] (replica::database& db) {
+                return db.find_column_family("ks", "cf").flush();
+            }).get();
+        };
+        auto sstable_count = [&e] {
+            return e.db().map_reduce0([] (replica::database& db) {
+                return db.find_column_family("ks", "cf").get_sstables()->size();
+            }, size_t(0), std::plus<size_t>()).get0();
+        };
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.find_column_family("ks", "cf").disable_auto_compaction();
+        }).get();
+
+        // Written and deleted within the same memtable: nothing is left to flush.
+        e.execute_cql("insert into ks.cf (p, c, v) values (0, 0, 0);").get();
+        e.execute_cql("delete from ks.cf where p = 0;").get();
+        // Let the tombstone become purgeable.
+        sleep(std::chrono::seconds(2)).get();
+        flush();
+        BOOST_REQUIRE_EQUAL(sstable_count(), 0);
+
+        // The tombstone shadows data in an sstable, so it has to be written.
+        e.execute_cql("insert into ks.cf (p, c, v) values (1, 0, 0);").get();
+        flush();
+        e.execute_cql("delete from ks.cf where p = 1;").get();
+        sleep(std::chrono::seconds(2)).get();
+        flush();
+        BOOST_REQUIRE_EQUAL(sstable_count(), 2);
+
+        auto msg = e.execute_cql("select * from ks.cf;").get0();
+        assert_that(msg).is_rows().with_size(0);
+    });
+}
+
 SEASTAR_TEST_CASE(populate_from_quarantine_works) {
     auto tmpdir_for_data = make_lw_shared<tmpdir>();
     utils::UUID host_id;
@@ -1037,3 +1188,267 @@ SEASTAR_TEST_CASE(snapshot_with_quarantine_works) {
         BOOST_REQUIRE(expected.empty());
     });
 }
+
+SEASTAR_TEST_CASE(test_digest_cache) {
+    auto cfg = make_shared<db::config>();
+    cfg->digest_cache_size_in_mb.set(1);
+    cfg->auto_snapshot.set(false);
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k int, c int, v int, primary key (k, c));").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "cf");
+        auto& stats = db.get_digest_cache_stats();
+
+        auto pkey = partition_key::from_single_value(*s, int32_type->decompose(0));
+        auto dk = dht::decorate_key(*s, pkey);
+        auto write = [&] (int32_t c, int32_t v) {
+            mutation m(s, pkey);
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(c)), "v", v, api::new_timestamp());
+            db.apply(s, freeze(m), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+        };
+        auto digest = [&] (const query::partition_slice& slice) {
+            auto cmd = query::read_command(s->id(), s->version(), slice, query::max_result_size(std::numeric_limits<size_t>::max()), query::row_limit(1000));
+            auto ranges = dht::partition_range_vector{dht::partition_range::make_singular(dk)};
+            auto result = std::get<0>(db.query(s, cmd, query::result_options::only_digest(query::digest_algorithm::xxHash), ranges, nullptr, db::no_timeout).get0());
+            return *result->digest();
+        };
+        auto full = partition_slice_builder(*s).build();
+        auto first_row = partition_slice_builder(*s)
+                .with_range(query::clustering_range::make_singular(clustering_key::from_single_value(*s, int32_type->decompose(0))))
+                .build();
+
+        write(0, 1);
+        auto d1 = digest(full);
+        BOOST_REQUIRE_EQUAL(stats.misses, 1);
+        BOOST_REQUIRE(digest(full) == d1);
+        BOOST_REQUIRE_EQUAL(stats.hits, 1);
+
+        // Another slice of the same partition has its own digest.
+        auto d2 = digest(first_row);
+        BOOST_REQUIRE_EQUAL(stats.misses, 2);
+        BOOST_REQUIRE(digest(first_row) == d2);
+        BOOST_REQUIRE_EQUAL(stats.hits, 2);
+
+        // A write invalidates the digests of the partition.
+        write(1, 2);
+        auto d3 = digest(full);
+        BOOST_REQUIRE_EQUAL(stats.misses, 3);
+        BOOST_REQUIRE(d3 != d1);
+        BOOST_REQUIRE(digest(full) == d3);
+        BOOST_REQUIRE_EQUAL(stats.hits, 3);
+
+        // So does truncation.
+        db.truncate("ks", "cf", [] { return make_ready_future<db_clock::time_point>(db_clock::now()); }).get();
+        BOOST_REQUIRE(digest(full) != d3);
+        BOOST_REQUIRE_EQUAL(stats.misses, 4);
+
+        // The memory of the caches of all tables is accounted against the
+        // budget of the shard.
+        e.execute_cql("create table ks.cf2 (k int, c int, v int, primary key (k, c));").get();
+        auto s2 = db.find_schema("ks", "cf2");
+        auto cmd2 = query::read_command(s2->id(), s2->version(), partition_slice_builder(*s2).build(),
+                query::max_result_size(std::numeric_limits<size_t>::max()), query::row_limit(1000));
+        auto dk2 = dht::decorate_key(*s2, partition_key::from_single_value(*s2, int32_type->decompose(0)));
+        db.query(s2, cmd2, query::result_options::only_digest(query::digest_algorithm::xxHash),
+                dht::partition_range_vector{dht::partition_range::make_singular(dk2)}, nullptr, db::no_timeout).get();
+        auto& cache1 = *db.find_column_family(s).get_digest_cache();
+        auto& cache2 = *db.find_column_family(s2).get_digest_cache();
+        BOOST_REQUIRE_GT(cache1.memory_usage(), 0);
+        BOOST_REQUIRE_GT(cache2.memory_usage(), 0);
+        BOOST_REQUIRE_EQUAL(stats.memory_usage, cache1.memory_usage() + cache2.memory_usage());
+        db.truncate("ks", "cf", [] { return make_ready_future<db_clock::time_point>(db_clock::now()); }).get();
+        BOOST_REQUIRE_EQUAL(stats.memory_usage, cache2.memory_usage());
+    }, cfg);
+}
+
+SEASTAR_TEST_CASE(test_sstables_spread_across_data_directories) {
+    auto data_dirs = make_lw_shared<std::array<tmpdir, 2>>();
+    auto cfg = make_shared<db::config>();
+    cfg->data_file_directories(std::vector<sstring>({ (*data_dirs)[0].path().string(), (*data_dirs)[1].path().string() }));
+    return do_with_cql_env_thread([data_dirs] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (pk int primary key, v int)").get();
+        // Both sstables are written by the shard of the partition.
+        for (int i = 0; i < 2; ++i) {
+            e.execute_cql(format("insert into ks.cf (pk, v) values (0, {})", i)).get();
+            e.db().invoke_on_all([] (replica::database& db) {
+                return db.find_column_family("ks", "cf").flush();
+            }).get();
+        }
+        auto sstable_dirs = e.db().map_reduce0([] (replica::database& db) {
+            std::set<sstring> dirs;
+            for (auto& sst : *db.find_column_family("ks", "cf").get_sstables()) {
+                dirs.insert(sst->get_dir());
+            }
+            return dirs;
+        }, std::set<sstring>(), [] (std::set<sstring> a, std::set<sstring> b) {
+            a.merge(b);
+            return a;
+        }).get0();
+        BOOST_REQUIRE_EQUAL(sstable_dirs.size(), 2);
+
+        // The sstables are linked into the snapshot directory of their own data directory.
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.find_column_family("ks", "cf").snapshot(db, "test", true);
+        }).get();
+        for (auto& dir : sstable_dirs) {
+            size_t files = 0;
+            lister::scan_dir(fs::path(dir) / sstables::snapshots_dir / "test", { directory_entry_type::regular }, [&files] (fs::path, directory_entry) {
+                ++files;
+                return make_ready_future<>();
+            }).get();
+            BOOST_REQUIRE_GT(files, 0);
+        }
+
+        assert_that(e.execute_cql("select v from ks.cf where pk = 0").get0()).is_rows().with_rows({{int32_type->decompose(1)}});
+    }, cfg);
+}
+
+// Test that offload moves only the sstables with old data to the cold storage
+// directory, and that they can still be read from there.
+SEASTAR_TEST_CASE(test_offload_cold_sstables) {
+    auto cold_dir = make_lw_shared<tmpdir>();
+    auto cfg = make_shared<db::config>();
+    cfg->cold_storage_directory(cold_dir->path().string());
+    return do_with_cql_env_thread([cold_dir] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (pk int, ck int, v int, primary key (pk, ck)) with compaction = "
+                "{'class': 'TimeWindowCompactionStrategy', 'cold_storage_after_seconds': '86400'}").get();
+        e.db().invoke_on_all([] (replica::database& db) {
+            return db.find_column_family("ks", "cf").disable_auto_compaction();
+        }).get();
+        auto flush = [&e] {
+            e.db().invoke_on_all([] (replica::database& db) {
+                return db.find_column_family("ks", "cf").flush();
+            }).get();
+        };
+        // A week old, then current.
+        auto old_timestamp = api::new_timestamp() - std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::days(7)).count();
+        e.execute_cql(format("insert into ks.cf (pk, ck, v) values (0, 0, 0) using timestamp {}", old_timestamp)).get();
+        flush();
+        e.execute_cql("insert into ks.cf (pk, ck, v) values (0, 1, 1)").get();
+        flush();
+
+        e.db().invoke_on_all([] (replica::database& db) {
+            auto& cf = db.find_column_family("ks", "cf");
+            return db.get_compaction_manager().perform_offload(&cf);
+        }).get();
+
+        // The numbers of sstables in cold storage and in the data directory.
+        auto count_sstables = [&e] {
+            return e.db().map_reduce0([] (replica::database& db) {
+                std::pair<size_t, size_t> counts;
+                for (auto& sst : *db.find_column_family("ks", "cf").get_sstables()) {
+                    if (sst->in_cold_storage()) {
+                        BOOST_REQUIRE_LT(sst->get_stats_metadata().max_timestamp, api::new_timestamp() - 86400'000'000);
+                        counts.first++;
+                    } else {
+                        counts.second++;
+                    }
+                }
+                return counts;
+            }, std::pair<size_t, size_t>(), [] (std::pair<size_t, size_t> a, std::pair<size_t, size_t> b) {
+                return std::pair<size_t, size_t>(a.first + b.first, a.second + b.second);
+            }).get0();
+        };
+        BOOST_REQUIRE(count_sstables() == std::pair<size_t, size_t>(1, 1));
+
+        // Rewriting an sstable in cold storage keeps it there.
+        e.db().invoke_on_all([] (replica::database& db) {
+            auto& cf = db.find_column_family("ks", "cf");
+            return db.get_compaction_manager().perform_sstable_upgrade(db, &cf, false);
+        }).get();
+        BOOST_REQUIRE(count_sstables() == std::pair<size_t, size_t>(1, 1));
+
+        assert_that(e.execute_cql("select v from ks.cf where pk = 0").get0()).is_rows().with_rows({
+            {int32_type->decompose(0)},
+            {int32_type->decompose(1)},
+        });
+    }, cfg);
+}
+
+// Test that only user writes are rejected when compaction falls behind, and
+// that view updates and hints, which the cluster needs to converge, still go
+// through.
+SEASTAR_TEST_CASE(test_compaction_backlog_throttles_only_user_writes) {
+    auto cfg = make_shared<db::config>();
+    return do_with_cql_env_thread([cfg] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (pk int, ck int, v int, primary key (pk, ck)) with compaction = {'class': 'SizeTieredCompactionStrategy'}").get();
+        e.execute_cql("create materialized view ks.mv as select * from ks.cf where pk is not null and ck is not null primary key (ck, pk)").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "cf");
+        auto vs = db.find_schema("ks", "mv");
+        auto& cf = db.find_column_family(s);
+        cf.disable_auto_compaction().get();
+
+        auto user_mutation = [&] (int pk) {
+            mutation m(s, partition_key::from_singular(*s, pk));
+            m.set_clustered_cell(clustering_key::from_singular(*s, 0), "v", data_value(pk), api::new_timestamp());
+            return freeze(m);
+        };
+        auto apply = [&] (schema_ptr s, const frozen_mutation& fm) {
+            return db.apply(s, fm, tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout);
+        };
+
+        // Pile up uncompacted sstables until the controller sees a backlog.
+        int pk = 0;
+        for (int i = 0; i < 100 && !(db.get_compaction_manager().normalized_backlog() > 0); ++i) {
+            for (int j = 0; j < 10; ++j) {
+                apply(s, user_mutation(pk++)).get();
+            }
+            cf.flush().get();
+            seastar::sleep(100ms).get();
+        }
+        BOOST_REQUIRE_GT(db.get_compaction_manager().normalized_backlog(), 0);
+        cfg->compaction_backlog_write_reject_threshold.set(std::numeric_limits<float>::min());
+
+        BOOST_REQUIRE_THROW(apply(s, user_mutation(pk++)).get(), exceptions::overloaded_exception);
+
+        mutation vm(vs, partition_key::from_singular(*vs, 0));
+        vm.set_clustered_cell(clustering_key::from_singular(*vs, pk++), "v", data_value(0), api::new_timestamp());
+        apply(vs, freeze(vm)).get();
+
+        db.apply_hint(s, user_mutation(pk++), tracing::trace_state_ptr(), db::no_timeout).get();
+
+        cfg->compaction_backlog_write_reject_threshold.set(0);
+        apply(s, user_mutation(pk++)).get();
+    }, cfg);
+}
+
+SEASTAR_TEST_CASE(test_estimate_read_memory_cost) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k int, c int, v int, primary key (k, c));").get();
+        auto& db = e.local_db();
+        auto& cf = db.find_column_family("ks", "cf");
+        auto s = cf.schema();
+
+        auto pkey = partition_key::from_single_value(*s, int32_type->decompose(0));
+        auto ranges = dht::partition_range_vector{dht::partition_range::make_singular(dht::decorate_key(*s, pkey))};
+        auto full = partition_slice_builder(*s).build();
+        auto one_row = partition_slice_builder(*s)
+                .with_range(query::clustering_range::make_singular(clustering_key::from_single_value(*s, int32_type->decompose(0))))
+                .build();
+
+        // Nothing to read but the memtable.
+        BOOST_REQUIRE_EQUAL(cf.estimate_read_memory_cost(full, ranges), replica::new_reader_base_cost);
+
+        for (int i = 0; i < 4; ++i) {
+            mutation m(s, pkey);
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(i)), "v", i, api::new_timestamp());
+            db.apply(s, freeze(m), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+            cf.flush().get();
+        }
+
+        // Each sstable to read costs, reading single rows less than whole partitions.
+        auto full_cost = cf.estimate_read_memory_cost(full, ranges);
+        auto one_row_cost = cf.estimate_read_memory_cost(one_row, ranges);
+        BOOST_REQUIRE_GT(one_row_cost, replica::new_reader_base_cost);
+        BOOST_REQUIRE_GT(full_cost, one_row_cost);
+
+        // What past reads consumed pulls the estimate towards it, up to the maximum result size.
+        cf.update_read_memory_cost(ranges, 1);
+        BOOST_REQUIRE_LT(cf.estimate_read_memory_cost(full, ranges), full_cost);
+        for (int i = 0; i < 100; ++i) {
+            cf.update_read_memory_cost(ranges, 100 * query::result_memory_limiter::maximum_result_size);
+        }
+        BOOST_REQUIRE_EQUAL(cf.estimate_read_memory_cost(full, ranges), query::result_memory_limiter::maximum_result_size);
+    });
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/test_case.hh>
+
+#include "gms/direct_failure_detector.hh"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using clk = gms::ping_liveness::clk;
+
+const auto ep = gms::inet_address("127.0.0.2");
+// The defaults of direct_failure_detector_ping_interval_in_ms and
+// direct_failure_detector_phi_convict_threshold.
+constexpr auto interval = 100ms;
+constexpr double threshold = 4;
+
+// Feeds answers to pings sent every interval, for a while.
+clk::time_point answer_regularly(gms::ping_liveness& l, clk::time_point now, int answers) {
+    for (int i = 0; i < answers; ++i) {
+        now += interval;
+        l.answered(now);
+        BOOST_REQUIRE(!l.update(now, threshold));
+    }
+    return now;
+}
+
+}
+
+SEASTAR_TEST_CASE(test_ping_liveness_suspects_silent_node) {
+    auto now = clk::now();
+    gms::ping_liveness l(ep, interval, now);
+    BOOST_REQUIRE(!l.suspected());
+    now = answer_regularly(l, now, 50);
+
+    // A few missed pings are no reason for suspicion.
+    BOOST_REQUIRE(!l.update(now + 5 * interval, threshold));
+    BOOST_REQUIRE(!l.suspected());
+
+    // At a phi of 4, about 9 intervals of silence are.
+    BOOST_REQUIRE(l.update(now + 10 * interval, threshold));
+    BOOST_REQUIRE(l.suspected());
+    BOOST_REQUIRE(!l.update(now + 20 * interval, threshold));
+    BOOST_REQUIRE(l.suspected());
+
+    // Lifted as soon as the node answers again.
+    now += 21 * interval;
+    l.answered(now);
+    BOOST_REQUIRE(l.update(now, threshold));
+    BOOST_REQUIRE(!l.suspected());
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_ping_liveness_long_silence_does_not_skew_mean) {
+    auto now = clk::now();
+    gms::ping_liveness l(ep, interval, now);
+    now = answer_regularly(l, now, 50);
+
+    // The interval of the answer ending a long silence isn't counted, so
+    // the node is suspected as quickly as before if it goes silent again.
+    now += 100 * interval;
+    l.answered(now);
+    l.update(now, threshold);
+    now = answer_regularly(l, now, 5);
+    BOOST_REQUIRE(l.update(now + 10 * interval, threshold));
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_ping_liveness_threshold) {
+    auto now = clk::now();
+    gms::ping_liveness l(ep, interval, now);
+    now = answer_regularly(l, now, 50);
+
+    // A higher threshold takes longer silence.
+    BOOST_REQUIRE(!l.update(now + 10 * interval, 8));
+    BOOST_REQUIRE(l.update(now + 20 * interval, 8));
+    return make_ready_future<>();
+}
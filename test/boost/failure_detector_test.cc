@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/test_case.hh>
+
+#include "gms/failure_detector.hh"
+
+using namespace std::chrono_literals;
+
+SEASTAR_TEST_CASE(test_arrival_window_initial_interval) {
+    using clk = gms::arrival_window::clk;
+    gms::arrival_window w(1000, 2000ms, 10000ms, 100ms);
+    auto now = clk::now();
+    w.add(now, gms::inet_address("127.0.0.2"));
+
+    // The initial interval is counted in the same unit as the measured ones.
+    BOOST_REQUIRE_EQUAL(w.mean(), double(std::chrono::duration_cast<clk::duration>(2000ms).count()));
+    // So a second of silence is half the initial interval, not
+    // a million of them.
+    BOOST_REQUIRE_CLOSE(w.phi(now + 1s), 0.5, 0.01);
+
+    // Measured intervals are averaged with it.
+    w.add(now + 1s, gms::inet_address("127.0.0.2"));
+    BOOST_REQUIRE_CLOSE(w.phi(now + 2500ms), 1.0, 0.01);
+    return make_ready_future<>();
+}
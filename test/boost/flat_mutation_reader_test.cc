@@ -875,6 +875,54 @@ SEASTAR_THREAD_TEST_CASE(test_reverse_reader_memory_limit) {
     test_with_partition(false);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_reverse_reader_spills_big_partitions) {
+    simple_schema schema;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    tmpdir spill_dir;
+
+    auto mut = schema.new_mutation("pk1");
+    schema.add_static_row(mut, "s1");
+    const size_t row_size = 10 * 1024;
+    for (uint32_t i = 0; i < 100; ++i) {
+        schema.add_row(mut, schema.make_ckey(i), sstring(row_size, '0'));
+    }
+    schema.delete_range(mut, schema.make_ckey_range(10, 20));
+    schema.delete_range(mut, schema.make_ckey_range(50, 80));
+
+    auto make_reader = [&] {
+        return make_reversing_reader(make_flat_mutation_reader_from_mutations(schema.schema(), semaphore.make_permit(), {mut}),
+                query::max_result_size(size_t(1) << 15, size_t(1) << 18));
+    };
+
+    // The partition is ~1MB, much more than the hard limit, but the reversed
+    // read only has to keep soft_limit worth of it in memory.
+    semaphore.semaphore().set_spill_directory(spill_dir.path().native(), 16 << 20);
+    {
+        auto reverse_reader = make_reader();
+        auto close_reverse_reader = deferred_close(reverse_reader);
+
+        auto reversed = read_mutation_from_flat_mutation_reader(reverse_reader).get0();
+        BOOST_REQUIRE(reversed);
+        BOOST_REQUIRE_EQUAL(*reversed, reverse(mut));
+        BOOST_REQUIRE_GT(semaphore.semaphore().get_stats().spilled_bytes, 100 * row_size - (size_t(1) << 15));
+        BOOST_REQUIRE_GT(semaphore.semaphore().spill_budget().used(), 0);
+    }
+    // The disk space is given back when the read is done.
+    BOOST_REQUIRE_EQUAL(semaphore.semaphore().spill_budget().used(), 0);
+
+    // Without enough disk space, the rows are kept in memory, and the read
+    // fails at the hard limit.
+    semaphore.semaphore().set_spill_directory(spill_dir.path().native(), 64 * 1024);
+    const auto spilled_bytes = semaphore.semaphore().get_stats().spilled_bytes;
+    {
+        auto reverse_reader = make_reader();
+        auto close_reverse_reader = deferred_close(reverse_reader);
+        BOOST_REQUIRE_THROW(read_mutation_from_flat_mutation_reader(reverse_reader).get0(), std::runtime_error);
+    }
+    BOOST_REQUIRE_LE(semaphore.semaphore().get_stats().spilled_bytes - spilled_bytes, 64 * 1024);
+    BOOST_REQUIRE_EQUAL(semaphore.semaphore().spill_budget().used(), 0);
+}
+
 SEASTAR_THREAD_TEST_CASE(test_reverse_reader_reads_in_native_reverse_order) {
     using namespace tests::data_model;
     using key_range = nonwrapping_interval<mutation_description::key>;
@@ -977,3 +1025,71 @@ SEASTAR_THREAD_TEST_CASE(test_reverse_reader_is_mutation_source) {
     };
     run_mutation_source_tests(populate);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_consume_batch_pausable) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    random_mutation_generator gen(random_mutation_generator::generate_counters::no);
+    auto muts = gen(8);
+    auto s = gen.schema();
+
+    // Consume at most 3 fragments of each batch, so batches are also left partially consumed.
+    std::deque<mutation_fragment_v2> fragments;
+    auto rd = make_flat_mutation_reader_from_mutations_v2(s, semaphore.make_permit(), muts);
+    rd.set_max_buffer_size(1024);
+    auto close_rd = deferred_close(rd);
+    size_t batches = 0;
+    rd.consume_batch_pausable([&] (flat_mutation_reader_v2::fragment_batch batch) {
+        ++batches;
+        size_t count = 0;
+        for (auto& mf : batch) {
+            if (count == 3) {
+                break;
+            }
+            fragments.emplace_back(std::move(mf));
+            ++count;
+        }
+        return flat_mutation_reader_v2::consumed_fragments{count, stop_iteration::no};
+    }).get();
+    BOOST_REQUIRE_GT(batches, 1);
+
+    auto assertions = assert_that(make_flat_mutation_reader_from_fragments(s, semaphore.make_permit(), std::move(fragments)));
+    for (const auto& m : muts) {
+        assertions.produces(m);
+    }
+    assertions.produces_end_of_stream();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_consume_stops_in_the_middle_of_partitions) {
+    simple_schema ss;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = ss.schema();
+
+    std::vector<mutation> muts;
+    for (const auto& pk : ss.make_pkeys(4)) {
+        mutation m(s, pk);
+        for (uint32_t ck = 0; ck < 10; ++ck) {
+            ss.add_row(m, ss.make_ckey(ck), "v");
+        }
+        muts.push_back(std::move(m));
+    }
+
+    // Takes the first two rows of each partition.
+    struct consumer {
+        std::vector<unsigned>& rows;
+        void consume_new_partition(const dht::decorated_key&) { rows.push_back(0); }
+        void consume(tombstone) { }
+        stop_iteration consume(static_row&&) { return stop_iteration::no; }
+        stop_iteration consume(clustering_row&&) { return stop_iteration(++rows.back() == 2); }
+        stop_iteration consume(range_tombstone_change&&) { return stop_iteration::no; }
+        stop_iteration consume_end_of_partition() { return stop_iteration::no; }
+        size_t consume_end_of_stream() { return rows.size(); }
+    };
+
+    std::vector<unsigned> rows;
+    auto rd = make_flat_mutation_reader_from_mutations_v2(s, semaphore.make_permit(), muts);
+    auto close_rd = deferred_close(rd);
+    BOOST_REQUIRE_EQUAL(rd.consume(consumer{rows}).get0(), muts.size());
+    for (auto partition_rows : rows) {
+        BOOST_REQUIRE_EQUAL(partition_rows, 2);
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include "query-request.hh"
+#include "schema_builder.hh"
+#include "partition_slice_builder.hh"
+#include "bytes_ostream.hh"
+#include "serializer_impl.hh"
+#include "idl/consistency_level.dist.hh"
+#include "idl/tracing.dist.hh"
+#include "idl/uuid.dist.hh"
+#include "idl/keys.dist.hh"
+#include "idl/token.dist.hh"
+#include "idl/ring_position.dist.hh"
+#include "idl/range.dist.hh"
+#include "idl/read_command.dist.hh"
+#include "idl/forward_request.dist.hh"
+#include "idl/consistency_level.dist.impl.hh"
+#include "idl/tracing.dist.impl.hh"
+#include "idl/uuid.dist.impl.hh"
+#include "idl/keys.dist.impl.hh"
+#include "idl/token.dist.impl.hh"
+#include "idl/ring_position.dist.impl.hh"
+#include "idl/range.dist.impl.hh"
+#include "idl/read_command.dist.impl.hh"
+#include "idl/forward_request.dist.impl.hh"
+
+static query::forward_request make_forward_request(std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos) {
+    auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("v", int32_type)
+            .build();
+    auto cmd = query::read_command(s->id(), s->version(), partition_slice_builder(*s).build(),
+            query::max_result_size(1024 * 1024), query::row_limit(1000));
+    auto reduction_types = std::vector<query::forward_request::reduction_type>{query::forward_request::reduction_type::count};
+    if (aggregation_infos) {
+        reduction_types.push_back(query::forward_request::reduction_type::aggregate);
+    }
+    return query::forward_request{
+        .reduction_types = std::move(reduction_types),
+        .cmd = std::move(cmd),
+        .pr = {dht::partition_range::make_open_ended_both_sides()},
+        .cl = db::consistency_level::QUORUM,
+        .timeout = lowres_clock::time_point(std::chrono::milliseconds(12345)),
+        .aggregation_infos = std::move(aggregation_infos),
+    };
+}
+
+static bytes serialize(const query::forward_request& req) {
+    bytes_ostream out;
+    ser::serialize(out, req);
+    return to_bytes(out.linearize());
+}
+
+static query::forward_request deserialize(bytes_view b) {
+    auto in = ser::as_input_stream(b);
+    return ser::deserialize(in, boost::type<query::forward_request>());
+}
+
+// A node which doesn't know aggregation_infos serializes a forward_request
+// as it is without the field: the size of the struct followed by the older
+// fields.
+static bytes serialize_without_aggregation_infos(const query::forward_request& req) {
+    assert(!req.aggregation_infos);
+    auto b = serialize(req);
+    // Drop the flag of the disengaged optional.
+    b.resize(b.size() - 1);
+    auto size = ser::as_input_stream(bytes_view(b));
+    auto new_size = ser::deserialize(size, boost::type<uint32_t>()) - 1;
+    bytes_ostream size_out;
+    ser::serialize(size_out, new_size);
+    auto size_bytes = size_out.linearize();
+    std::copy(size_bytes.begin(), size_bytes.end(), b.begin());
+    return b;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_forward_request_from_older_node) {
+    auto req = make_forward_request(std::nullopt);
+    auto deserialized = deserialize(serialize_without_aggregation_infos(req));
+
+    BOOST_REQUIRE(deserialized.reduction_types == req.reduction_types);
+    BOOST_REQUIRE_EQUAL(deserialized.cmd.cf_id, req.cmd.cf_id);
+    BOOST_REQUIRE_EQUAL(deserialized.cmd.schema_version, req.cmd.schema_version);
+    BOOST_REQUIRE_EQUAL(deserialized.pr.size(), 1);
+    BOOST_REQUIRE(deserialized.cl == req.cl);
+    BOOST_REQUIRE(deserialized.timeout == req.timeout);
+    BOOST_REQUIRE(!deserialized.aggregation_infos);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_forward_request_to_older_node) {
+    auto infos = std::vector<query::forward_request::aggregation_info>{{}, {"max", {"v"}}};
+    auto req = make_forward_request(infos);
+    auto b = serialize(req);
+
+    // An older node reads the fields it knows, which are laid out as it
+    // would have serialized them, and skips the rest of the struct.
+    auto old_req = req;
+    old_req.aggregation_infos = std::nullopt;
+    auto old_b = serialize_without_aggregation_infos(old_req);
+    BOOST_REQUIRE_GT(b.size(), old_b.size());
+    BOOST_REQUIRE(std::equal(old_b.begin() + sizeof(uint32_t), old_b.end(), b.begin() + sizeof(uint32_t)));
+    auto in = ser::as_input_stream(bytes_view(b));
+    BOOST_REQUIRE_EQUAL(ser::deserialize(in, boost::type<uint32_t>()), b.size());
+
+    auto deserialized = deserialize(b);
+    BOOST_REQUIRE(deserialized.reduction_types == req.reduction_types);
+    BOOST_REQUIRE(deserialized.aggregation_infos);
+    BOOST_REQUIRE_EQUAL(deserialized.aggregation_infos->size(), 2);
+    BOOST_REQUIRE_EQUAL((*deserialized.aggregation_infos)[1].function_name, "max");
+    BOOST_REQUIRE((*deserialized.aggregation_infos)[1].column_names == std::vector<sstring>{"v"});
+}
@@ -8,9 +8,11 @@
 
 #include <boost/test/unit_test.hpp>
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include <seastar/core/smp.hh>
 
 #include "db/hints/sync_point.hh"
+#include "db/hints/resource_manager.hh"
 
 SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
     const unsigned encoded_shard_count = 2;
@@ -65,3 +67,39 @@ SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
 
     return make_ready_future<>();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_hint_send_window) {
+    db::hints::send_window w(4);
+    BOOST_REQUIRE_EQUAL(w.size(), db::hints::send_window::min_size);
+
+    // Grows by one with every hint sent, up to the maximum.
+    for (int i = 0; i < 10; ++i) {
+        w.on_success(0);
+    }
+    BOOST_REQUIRE_EQUAL(w.size(), 4);
+
+    // Backs off while the destination falls behind.
+    w.on_success(0.9);
+    BOOST_REQUIRE_EQUAL(w.size(), 3);
+
+    // Is halved on failures, but never closes.
+    w.on_failure();
+    BOOST_REQUIRE_EQUAL(w.size(), 1);
+    w.on_failure();
+    BOOST_REQUIRE_EQUAL(w.size(), 1);
+
+    // Limits the number of hints in flight.
+    w.on_success(0);
+    auto u1 = w.wait().get0();
+    auto u2 = w.wait().get0();
+    auto f = w.wait();
+    BOOST_REQUIRE(!f.available());
+    w.on_failure();
+    u1.return_all();
+    BOOST_REQUIRE(!f.available());
+    u2.return_all();
+    f.get();
+
+    w.set_max_size(0);
+    BOOST_REQUIRE_EQUAL(w.size(), 1);
+}
@@ -101,6 +101,37 @@ struct empty_struct { };
 
 struct empty_final_struct { };
 
+enum class fixed_size_kind : uint16_t {
+    first,
+    second,
+};
+
+struct fixed_size_final_struct {
+    uint32_t foo;
+    int64_t bar;
+    fixed_size_kind kind;
+    bool flag;
+
+    bool operator==(const fixed_size_final_struct&) const = default;
+};
+
+std::ostream& operator<<(std::ostream& os, const fixed_size_final_struct& v)
+{
+    return os << " { foo: " << v.foo << ", bar: " << v.bar << ", kind: " << int(v.kind) << ", flag: " << v.flag << " }";
+}
+
+struct fixed_size_final_wrapper {
+    fixed_size_final_struct x;
+    uint8_t y;
+
+    bool operator==(const fixed_size_final_wrapper&) const = default;
+};
+
+std::ostream& operator<<(std::ostream& os, const fixed_size_final_wrapper& v)
+{
+    return os << " { x: " << v.x << ", y: " << int(v.y) << " }";
+}
+
 class fragment_generator {
     std::vector<bytes> data;
 public:
@@ -401,6 +432,44 @@ BOOST_AUTO_TEST_CASE(test_empty_struct)
     ser::deserialize(in2, boost::type<empty_final_struct>());
 }
 
+BOOST_AUTO_TEST_CASE(test_fixed_size_final_struct)
+{
+    static_assert(ser::serializer<fixed_size_kind>::fixed_size == 2);
+    static_assert(ser::serializer<fixed_size_final_struct>::fixed_size == 15);
+    static_assert(ser::serializer<fixed_size_final_wrapper>::fixed_size == 16);
+
+    std::vector<fixed_size_final_wrapper> vec = {
+        { { 0xdeadbeef, -1, fixed_size_kind::first, true }, 7 },
+        { { 1, 0x0123456789abcdef, fixed_size_kind::second, false }, 0xff },
+    };
+
+    bytes_ostream buf;
+    ser::serialize(buf, vec);
+    ser::serialize(buf, uint32_t(0xbadc0ffe));
+    BOOST_REQUIRE_EQUAL(buf.size(), 4 + 2 * 16 + 4);
+
+    // The same bytes as if the members were serialized one by one.
+    bytes_ostream expected;
+    ser::serialize(expected, uint32_t(vec.size()));
+    for (auto& w : vec) {
+        ser::serialize(expected, w.x.foo);
+        ser::serialize(expected, w.x.bar);
+        ser::serialize(expected, uint16_t(w.x.kind));
+        ser::serialize(expected, w.x.flag);
+        ser::serialize(expected, w.y);
+    }
+    ser::serialize(expected, uint32_t(0xbadc0ffe));
+    BOOST_REQUIRE_EQUAL(buf.linearize(), expected.linearize());
+
+    auto in1 = ser::as_input_stream(buf.linearize());
+    BOOST_REQUIRE_EQUAL(ser::deserialize(in1, boost::type<std::vector<fixed_size_final_wrapper>>()), vec);
+    BOOST_REQUIRE_EQUAL(ser::deserialize(in1, boost::type<uint32_t>()), 0xbadc0ffe);
+
+    auto in2 = ser::as_input_stream(buf.linearize());
+    ser::skip(in2, boost::type<std::vector<fixed_size_final_wrapper>>());
+    BOOST_REQUIRE_EQUAL(ser::deserialize(in2, boost::type<uint32_t>()), 0xbadc0ffe);
+}
+
 BOOST_AUTO_TEST_CASE(test_just_a_variant)
 {
     bytes_ostream buf;
@@ -640,3 +640,18 @@ SEASTAR_TEST_CASE(test_unpack_decimal){
         assert_that(msg).is_rows().with_rows({{int32_type->decompose(1), lt_val}});
     });
 }
+
+SEASTAR_TEST_CASE(test_json_escaping_and_column_names) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (k int PRIMARY KEY, \"Cap\" text, v text);").get();
+        e.execute_cql("INSERT INTO t JSON '{\"k\": 1, \"\\\"Cap\\\"\": \"x\", \"V\": \"a\\\"b\\\\c\\n\\u0001\"}'").get();
+
+        auto msg = e.execute_cql("SELECT JSON * FROM t WHERE k = 1").get0();
+        assert_that(msg).is_rows().with_rows({
+            {utf8_type->decompose("{\"k\": 1, \"\\\"Cap\\\"\": \"x\", \"v\": \"a\\\"b\\\\c\\n\\u0001\"}")}
+        });
+
+        // Unquoted names are case-insensitive, so they can't name "Cap".
+        BOOST_REQUIRE_THROW(e.execute_cql("INSERT INTO t JSON '{\"k\": 2, \"Cap\": \"x\"}'").get(), exceptions::invalid_request_exception);
+    });
+}
@@ -14,6 +14,8 @@
 #include "schema.hh"
 #include "schema_builder.hh"
 #include "types.hh"
+#include "byte_comparable.hh"
+#include "dht/i_partitioner.hh"
 
 #include "idl/keys.dist.hh"
 #include "serializer_impl.hh"
@@ -188,3 +190,90 @@ BOOST_AUTO_TEST_CASE(test_from_nodetool_style_string) {
     auto key4 = partition_key::from_nodetool_style_string(s2, "value1:value2");
     BOOST_REQUIRE(key3.equal(*s1, key4));
 }
+
+BOOST_AUTO_TEST_CASE(test_byte_comparable_clustering_key_ordering) {
+    auto s_ptr = schema_builder("", "")
+            .with_column("pk", bytes_type, column_kind::partition_key)
+            .with_column("c1", int32_type, column_kind::clustering_key)
+            .with_column("c2", reversed_type_impl::get_instance(utf8_type), column_kind::clustering_key)
+            .with_column("c3", double_type, column_kind::clustering_key)
+            .with_column("c4", bytes_type, column_kind::clustering_key)
+            .build();
+    const schema& s = *s_ptr;
+    BOOST_REQUIRE(byte_comparable::is_clustering_key_byte_comparable(s));
+
+    std::vector<bytes> c1_values{bytes(), int32_type->decompose(std::numeric_limits<int32_t>::min()), int32_type->decompose(int32_t(-1)),
+            int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t(1)), int32_type->decompose(std::numeric_limits<int32_t>::max())};
+    std::vector<bytes> c2_values{bytes(), utf8_type->decompose(sstring("a")), utf8_type->decompose(sstring("ab")),
+            utf8_type->decompose(sstring("b"))};
+    std::vector<bytes> c3_values{bytes(), double_type->decompose(-std::numeric_limits<double>::infinity()), double_type->decompose(-1.5),
+            double_type->decompose(-0.0), double_type->decompose(0.0), double_type->decompose(2.0),
+            double_type->decompose(std::numeric_limits<double>::quiet_NaN())};
+    std::vector<bytes> c4_values{bytes(), to_bytes(std::string("\0", 1)), to_bytes(std::string("\0\0", 2)), to_bytes(std::string("\0\x01", 2)),
+            to_bytes("a"), to_bytes(std::string("a\0", 2)), to_bytes("\xff")};
+
+    std::vector<clustering_key_prefix> keys;
+    keys.push_back(clustering_key_prefix::make_empty());
+    for (auto& v1 : c1_values) {
+        keys.push_back(clustering_key_prefix::from_exploded(s, {v1}));
+        for (auto& v2 : c2_values) {
+            keys.push_back(clustering_key_prefix::from_exploded(s, {v1, v2}));
+            for (auto& v3 : c3_values) {
+                keys.push_back(clustering_key_prefix::from_exploded(s, {v1, v2, v3}));
+                for (auto& v4 : c4_values) {
+                    keys.push_back(clustering_key_prefix::from_exploded(s, {v1, v2, v3, v4}));
+                }
+            }
+        }
+    }
+
+    auto cmp = clustering_key_prefix::tri_compare(s);
+    std::vector<bytes> encoded;
+    for (auto& k : keys) {
+        encoded.push_back(byte_comparable::encode(s, k));
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        for (size_t j = 0; j < keys.size(); ++j) {
+            auto expected = cmp(keys[i], keys[j]);
+            auto actual = byte_comparable::tri_compare()(encoded[i], encoded[j]);
+            if (expected != actual) {
+                BOOST_FAIL(format("{} vs {}: expected {}, got {}", keys[i], keys[j], int(expected < 0) - int(expected > 0), int(actual < 0) - int(actual > 0)));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_byte_comparable_unsupported_types) {
+    auto s_ptr = schema_builder("", "")
+            .with_column("pk", bytes_type, column_kind::partition_key)
+            .with_column("c1", int32_type, column_kind::clustering_key)
+            .with_column("c2", varint_type, column_kind::clustering_key)
+            .build();
+    const schema& s = *s_ptr;
+    BOOST_REQUIRE(!byte_comparable::is_clustering_key_byte_comparable(s));
+    BOOST_REQUIRE_THROW(byte_comparable::encode(s, clustering_key_prefix::make_empty()), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_byte_comparable_decorated_key_ordering) {
+    auto s_ptr = schema_builder("", "")
+            .with_column("pk1", bytes_type, column_kind::partition_key)
+            .with_column("pk2", int32_type, column_kind::partition_key)
+            .build();
+    const schema& s = *s_ptr;
+
+    std::vector<dht::decorated_key> keys;
+    for (int32_t i = 0; i < 100; ++i) {
+        auto pk = partition_key::from_exploded(s, {to_bytes(format("key{}", i % 7)), int32_type->decompose(i)});
+        keys.push_back(dht::decorate_key(s, pk));
+    }
+    // Keys with equal tokens are ordered by their legacy form.
+    auto token = keys.front().token();
+    keys.emplace_back(token, partition_key::from_exploded(s, {to_bytes("a"), int32_type->decompose(int32_t(0))}));
+    keys.emplace_back(token, partition_key::from_exploded(s, {to_bytes("aa"), int32_type->decompose(int32_t(0))}));
+
+    for (auto& k1 : keys) {
+        for (auto& k2 : keys) {
+            BOOST_REQUIRE(k1.tri_compare(s, k2) == byte_comparable::tri_compare()(byte_comparable::encode(s, k1), byte_comparable::encode(s, k2)));
+        }
+    }
+}
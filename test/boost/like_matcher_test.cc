@@ -443,3 +443,30 @@ BOOST_AUTO_TEST_CASE(test_reset) {
     BOOST_TEST(matches(m, u8"alpha"));
     BOOST_TEST(!matches(m, u8"omega"));
 }
+
+BOOST_AUTO_TEST_CASE(test_percent_only_patterns) {
+    // Patterns without '_' are matched without a regex.
+    auto overlapping = matcher(u8"ab%ba");
+    BOOST_TEST(matches(overlapping, u8"abba"));
+    BOOST_TEST(matches(overlapping, u8"abxba"));
+    BOOST_TEST(!matches(overlapping, u8"aba"));
+    BOOST_TEST(!matches(overlapping, u8"ab"));
+
+    auto in_order = matcher(u8"%a%Ш%c%");
+    BOOST_TEST(matches(in_order, u8"aШc"));
+    BOOST_TEST(matches(in_order, u8"xxaxxШШxxcxx"));
+    BOOST_TEST(!matches(in_order, u8"cШa"));
+    BOOST_TEST(!matches(in_order, u8"aШ"));
+
+    auto repeated = matcher(u8"%aa%aa%");
+    BOOST_TEST(matches(repeated, u8"aaaa"));
+    BOOST_TEST(!matches(repeated, u8"aaa"));
+
+    auto escaped = matcher(u8R"(%\_\%%)");
+    BOOST_TEST(matches(escaped, u8"x_%y"));
+    BOOST_TEST(!matches(escaped, u8"xa%y"));
+
+    auto anything = matcher(u8"%%");
+    BOOST_TEST(matches(anything, u8""));
+    BOOST_TEST(matches(anything, u8"abc"));
+}
@@ -95,6 +95,30 @@ SEASTAR_TEST_CASE(test_compaction) {
     });
 }
 
+SEASTAR_TEST_CASE(test_compaction_debt) {
+    return seastar::async([] {
+        region reg;
+
+        with_allocator(reg.allocator(), [&reg] {
+            std::vector<managed_ref<int>> _allocated;
+            for (int i = 0; i < 32 * 1024 * 8; i++) {
+                _allocated.push_back(make_managed<int>());
+            }
+            auto debt_when_full = shard_tracker().compaction_debt(0.85);
+
+            // Free every other object, leaving segments half-occupied.
+            for (size_t i = 0; i < _allocated.size(); i += 2) {
+                _allocated[i] = {};
+            }
+            auto debt = shard_tracker().compaction_debt(0.85);
+            BOOST_REQUIRE_GT(debt, debt_when_full + reg.occupancy().total_space() / 4);
+
+            reg.full_compaction();
+            BOOST_REQUIRE_LT(shard_tracker().compaction_debt(0.85), debt);
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_occupancy) {
     return seastar::async([] {
         region reg;
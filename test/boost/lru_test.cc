@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/test_case.hh>
+
+#include "utils/lru.hh"
+
+namespace {
+
+struct element : public evictable {
+    int id;
+    std::vector<int>* evictions;
+    element(int id, std::vector<int>& evictions) : id(id), evictions(&evictions) {}
+    void on_evicted() noexcept override { evictions->push_back(id); }
+};
+
+}
+
+SEASTAR_TEST_CASE(test_plain_lru_order) {
+    std::vector<int> evictions;
+    element e1(1, evictions), e2(2, evictions), e3(3, evictions), e4(4, evictions);
+    lru l;
+    l.set_evict_by_hits_per_byte(false);
+    l.add(e1, lru_kind::rows);
+    l.add(e2, lru_kind::file_pages);
+    l.add(e3, lru_kind::partition_index);
+    l.add(e4, lru_kind::rows);
+    // Hits and memory usage make no difference.
+    l.set_memory_usage_function(lru_kind::rows, [] { return 1; });
+    l.on_memory_usage_change(lru_kind::file_pages, 1 << 20);
+    l.on_hit(lru_kind::rows);
+    l.touch(e1, lru_kind::rows);
+
+    l.evict_all();
+    BOOST_REQUIRE(evictions == std::vector<int>({2, 3, 4, 1}));
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_evicts_kind_with_fewest_hits_per_byte) {
+    std::vector<int> evictions;
+    element r1(1, evictions), r2(2, evictions), p1(3, evictions), p2(4, evictions), probationary(5, evictions);
+    lru l;
+    uint64_t rows_memory_usage = 100;
+    l.set_memory_usage_function(lru_kind::rows, [&] { return rows_memory_usage; });
+    l.add(r1, lru_kind::rows);
+    l.add(r2, lru_kind::rows);
+    l.add(p1, lru_kind::file_pages);
+    l.add(p2, lru_kind::file_pages);
+    l.add_probationary(probationary);
+    l.on_memory_usage_change(lru_kind::file_pages, 100);
+    for (int i = 0; i < 10; ++i) {
+        l.on_hit(lru_kind::file_pages);
+    }
+    l.on_hit(lru_kind::rows);
+
+    // The probationary segment goes first, whatever the kinds.
+    l.evict();
+    BOOST_REQUIRE(evictions == std::vector<int>({5}));
+
+    // Rows have fewer hits per byte.
+    l.evict();
+    BOOST_REQUIRE(evictions == std::vector<int>({5, 1}));
+    BOOST_REQUIRE_EQUAL(l.stats(lru_kind::rows).evictions, 2);
+
+    // The current memory usage of the rows is used, not the one at the
+    // previous eviction: with little memory, rows are now denser.
+    rows_memory_usage = 1;
+    BOOST_REQUIRE_EQUAL(l.stats(lru_kind::rows).memory_usage, 1);
+    l.evict();
+    BOOST_REQUIRE(evictions == std::vector<int>({5, 1, 3}));
+    BOOST_REQUIRE_EQUAL(l.stats(lru_kind::file_pages).evictions, 1);
+
+    // A kind with nothing left to evict isn't chosen.
+    l.remove(p2);
+    l.evict();
+    BOOST_REQUIRE(evictions == std::vector<int>({5, 1, 3, 2}));
+    BOOST_REQUIRE(l.evict() == lru::reclaiming_result::reclaimed_nothing);
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_hits_decay) {
+    std::vector<int> evictions;
+    element r(1, evictions), p(2, evictions);
+    lru l;
+    l.set_memory_usage_function(lru_kind::rows, [] { return 100; });
+    l.on_memory_usage_change(lru_kind::file_pages, 100);
+    l.add(r, lru_kind::rows);
+    l.add(p, lru_kind::file_pages);
+
+    // Old hits of the rows are outweighed by recent hits of the pages.
+    for (int i = 0; i < 1 << 16; ++i) {
+        l.on_hit(lru_kind::rows);
+    }
+    BOOST_REQUIRE_EQUAL(l.stats(lru_kind::rows).hits, 1 << 15);
+    for (int i = 0; i < 3 << 16; ++i) {
+        l.on_hit(lru_kind::file_pages);
+    }
+    BOOST_REQUIRE_LT(l.stats(lru_kind::rows).hits, l.stats(lru_kind::file_pages).hits);
+
+    l.evict();
+    BOOST_REQUIRE(evictions == std::vector<int>({1}));
+    return make_ready_future<>();
+}
@@ -19,6 +19,7 @@
 
 #include <seastar/core/thread.hh>
 #include "memtable.hh"
+#include "frozen_mutation.hh"
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
 #include "test/lib/mutation_source_test.hh"
@@ -123,6 +124,83 @@ SEASTAR_TEST_CASE(test_memtable_with_many_versions_conforms_to_mutation_source)
     });
 }
 
+SEASTAR_TEST_CASE(test_memtable_with_frozen_mutations_conforms_to_mutation_source) {
+    return seastar::async([] {
+        run_mutation_source_tests([](schema_ptr s, const std::vector<mutation>& partitions) {
+            auto mt = make_lw_shared<memtable>(s);
+
+            for (auto&& m : partitions) {
+                mt->apply(freeze(m), s);
+            }
+
+            logalloc::shard_tracker().full_compaction();
+
+            return mt->as_data_source();
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_applying_frozen_mutations_to_existing_partitions) {
+    return seastar::async([] {
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        for (auto counters : {random_mutation_generator::generate_counters::no, random_mutation_generator::generate_counters::yes}) {
+            random_mutation_generator gen(counters);
+            auto s = gen.schema();
+
+            for (int i = 0; i < 10; ++i) {
+                auto m1 = gen();
+                auto m2 = mutation(s, m1.decorated_key(), gen().partition());
+                auto m3 = mutation(s, m1.decorated_key(), gen().partition());
+
+                // The first one is built in place in the new entry, the others are applied into it.
+                auto mt = make_lw_shared<memtable>(s);
+                mt->apply(freeze(m1), s);
+                mt->apply(freeze(m2), s);
+                mt->apply(freeze(m3), s);
+
+                assert_that(mt->make_flat_reader(s, semaphore.make_permit()))
+                    .produces(m1 + m2 + m3)
+                    .produces_end_of_stream();
+            }
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_overwrites_of_a_row_dont_grow_the_memtable) {
+    return seastar::async([] {
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        schema_ptr s = schema_builder("ks", "cf")
+                .with_column("pk", bytes_type, column_kind::partition_key)
+                .with_column("ck", bytes_type, column_kind::clustering_key)
+                .with_column("col", bytes_type, column_kind::regular_column)
+                .build();
+
+        auto mt = make_lw_shared<memtable>(s);
+        auto pk = partition_key::from_single_value(*s, to_bytes("key"));
+        auto ck = clustering_key::from_single_value(*s, to_bytes("ck"));
+        auto make_write = [&] (api::timestamp_type ts) {
+            mutation m(s, pk);
+            m.set_clustered_cell(ck, to_bytes("col"), data_value(bytes(bytes::initialized_later(), 1024)), ts);
+            return m;
+        };
+
+        mt->apply(freeze(make_write(1)), s);
+        mt->apply(freeze(make_write(2)), s);
+        auto used = mt->occupancy().used_space();
+
+        for (api::timestamp_type ts = 3; ts < 1000; ++ts) {
+            mt->apply(freeze(make_write(ts)), s);
+        }
+        // Older writes are dropped without being copied.
+        mt->apply(freeze(make_write(0)), s);
+        BOOST_REQUIRE_EQUAL(mt->occupancy().used_space(), used);
+
+        assert_that(mt->make_flat_reader(s, semaphore.make_permit()))
+            .produces(make_write(999))
+            .produces_end_of_stream();
+    });
+}
+
 SEASTAR_TEST_CASE(test_memtable_flush_reader) {
     // Memtable flush reader is severly limited, it always assumes that
     // the full partition range is being read and that
@@ -431,6 +509,109 @@ SEASTAR_TEST_CASE(test_segment_migration_during_flush) {
     });
 }
 
+SEASTAR_TEST_CASE(test_flush_reader_of_split_memtable) {
+    return seastar::async([] {
+        schema_ptr s = schema_builder("ks", "cf")
+                .with_column("pk", bytes_type, column_kind::partition_key)
+                .with_column("col", bytes_type, column_kind::regular_column)
+                .build();
+
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        replica::table_stats tbl_stats;
+        dirty_memory_manager mgr;
+
+        auto mt = make_lw_shared<memtable>(s, mgr, tbl_stats);
+        BOOST_REQUIRE_EQUAL(mt->split_for_flush(4).size(), 1);
+
+        std::vector<mutation> ring = make_ring(s, 100);
+        for (auto& m : ring) {
+            mt->apply(m);
+        }
+        BOOST_REQUIRE_EQUAL(mt->split_for_flush(1).size(), 1);
+
+        auto ranges = mt->split_for_flush(4);
+        BOOST_REQUIRE_EQUAL(ranges.size(), 4);
+
+        // Every partition is read by exactly one of the readers, in ring order.
+        size_t next = 0;
+        for (auto& range : ranges) {
+            auto rd = mt->make_flush_reader(s, semaphore.make_permit(), default_priority_class(), range);
+            auto close_rd = deferred_close(rd);
+            size_t partitions = 0;
+            while (auto mfopt = rd().get0()) {
+                if (mfopt->is_partition_start()) {
+                    BOOST_REQUIRE_LT(next, ring.size());
+                    BOOST_REQUIRE(mfopt->as_partition_start().key().equal(*s, ring[next++].decorated_key()));
+                    ++partitions;
+                }
+            }
+            BOOST_REQUIRE_GT(partitions, 0);
+        }
+        BOOST_REQUIRE_EQUAL(next, ring.size());
+    });
+}
+
+SEASTAR_TEST_CASE(test_virtual_dirty_released_during_flush_of_large_partition) {
+    return seastar::async([] {
+        schema_ptr s = schema_builder("ks", "cf")
+                .with_column("pk", bytes_type, column_kind::partition_key)
+                .with_column("ck", bytes_type, column_kind::clustering_key)
+                .with_column("col", bytes_type, column_kind::regular_column)
+                .build();
+
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        replica::table_stats tbl_stats;
+        dirty_memory_manager mgr;
+
+        auto mt = make_lw_shared<memtable>(s, mgr, tbl_stats);
+
+        const int rows = 1000;
+        auto m = make_unique_mutation(s);
+        // Overwrites every other row, to be applied into a separate partition version.
+        auto half = mutation(s, m.decorated_key());
+        for (int i = 0; i < rows; ++i) {
+            auto ck = clustering_key::from_single_value(*s, serialized(make_unique_bytes()));
+            m.set_clustered_cell(ck, to_bytes("col"), data_value(bytes(bytes::initialized_later(), 64)), next_timestamp());
+            if (i % 2) {
+                half.set_clustered_cell(ck, to_bytes("col"), data_value(bytes(bytes::initialized_later(), 64)), next_timestamp());
+            }
+        }
+        mt->apply(m);
+        auto rd_snp = mt->make_flat_reader(s, semaphore.make_permit());
+        auto close_rd_snp = deferred_close(rd_snp);
+        rd_snp.set_max_buffer_size(1);
+        rd_snp.fill_buffer().get();
+        mt->apply(half);
+
+        auto rd = mt->make_flush_reader(s, semaphore.make_permit(), service::get_local_priority_manager().memtable_flush_priority());
+        auto close_rd = deferred_close(rd);
+        rd.set_max_buffer_size(1);
+
+        auto mfopt = rd().get0();
+        BOOST_REQUIRE(mfopt && mfopt->is_partition_start());
+        auto virtual_dirty_at_start = mgr.virtual_dirty_memory();
+        auto virtual_dirty = virtual_dirty_at_start;
+        int rows_read = 0;
+        while ((mfopt = rd().get0()) && !mfopt->is_end_of_partition()) {
+            ++rows_read;
+            BOOST_REQUIRE_LE(mgr.virtual_dirty_memory(), virtual_dirty);
+            virtual_dirty = mgr.virtual_dirty_memory();
+            if (rows_read == rows / 2) {
+                // Memory of the rows is released as they are written, not at the end of the flush.
+                BOOST_REQUIRE_LT(virtual_dirty, virtual_dirty_at_start);
+            }
+        }
+        BOOST_REQUIRE_EQUAL(rows_read, rows);
+        BOOST_REQUIRE(!rd().get0());
+
+        // All the row entries, from both versions, are accounted as flushed.
+        auto flushed = mgr.real_dirty_memory() - mgr.virtual_dirty_memory();
+        BOOST_REQUIRE_GE(flushed, (rows + rows / 2) * sizeof(rows_entry));
+    });
+}
+
 // Reproducer for #2854
 SEASTAR_TEST_CASE(test_fast_forward_to_after_memtable_is_flushed) {
     return seastar::async([] {
@@ -521,6 +702,35 @@ SEASTAR_TEST_CASE(test_exception_safety_of_single_partition_reads) {
     });
 }
 
+SEASTAR_TEST_CASE(test_exception_safety_of_applying_to_existing_partitions) {
+    return seastar::async([] {
+        random_mutation_generator gen(random_mutation_generator::generate_counters::no);
+        auto s = gen.schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        auto m1 = gen();
+        auto m2 = mutation(s, m1.decorated_key(), gen().partition());
+        auto fm2 = freeze(m2);
+
+        auto mt = make_lw_shared<memtable>(s);
+        mt->apply(freeze(m1), s);
+
+        memory::with_allocation_failures([&] {
+            auto check = defer([&] {
+                // A failed write leaves no trace in the memtable.
+                assert_that(mt->make_flat_reader(s, semaphore.make_permit()))
+                    .produces(m1)
+                    .produces_end_of_stream();
+            });
+            mt->apply(fm2, s);
+            check.cancel();
+        });
+        assert_that(mt->make_flat_reader(s, semaphore.make_permit()))
+            .produces(m1 + m2)
+            .produces_end_of_stream();
+    });
+}
+
 SEASTAR_TEST_CASE(test_hash_is_cached) {
     return seastar::async([] {
         auto s = schema_builder("ks", "cf")
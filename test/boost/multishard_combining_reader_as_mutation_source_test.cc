@@ -31,8 +31,9 @@
 // It has to be a container that does not invalidate pointers
 static std::list<dummy_sharder> keep_alive_sharder;
 
-static auto make_populate(bool evict_paused_readers, bool single_fragment_buffer) {
-    return [evict_paused_readers, single_fragment_buffer] (schema_ptr s, const std::vector<mutation>& mutations, gc_clock::time_point) mutable {
+static auto make_populate(bool evict_paused_readers, bool single_fragment_buffer,
+        multishard_parallel_read_ahead parallel_read_ahead = multishard_parallel_read_ahead::no) {
+    return [evict_paused_readers, single_fragment_buffer, parallel_read_ahead] (schema_ptr s, const std::vector<mutation>& mutations, gc_clock::time_point) mutable {
         // We need to group mutations that have the same token so they land on the same shard.
         std::map<dht::token, std::vector<frozen_mutation>> mutations_by_token;
 
@@ -62,7 +63,7 @@ static auto make_populate(bool evict_paused_readers, bool single_fragment_buffer
         }
         keep_alive_sharder.push_back(sharder);
 
-        return mutation_source([&, remote_memtables, evict_paused_readers, single_fragment_buffer] (schema_ptr s,
+        return mutation_source([&, remote_memtables, evict_paused_readers, single_fragment_buffer, parallel_read_ahead] (schema_ptr s,
                 reader_permit permit,
                 const dht::partition_range& range,
                 const query::partition_slice& slice,
@@ -88,7 +89,7 @@ static auto make_populate(bool evict_paused_readers, bool single_fragment_buffer
 
             auto lifecycle_policy = seastar::make_shared<test_reader_lifecycle_policy>(std::move(factory), evict_paused_readers);
             auto mr = make_multishard_combining_reader_v2_for_tests(keep_alive_sharder.back(), std::move(lifecycle_policy), s,
-                    std::move(permit), range, slice, pc, trace_state, fwd_mr);
+                    std::move(permit), range, slice, pc, trace_state, fwd_mr, parallel_read_ahead);
             if (fwd_sm == streamed_mutation::forwarding::yes) {
                 return make_forwardable(std::move(mr));
             }
@@ -122,6 +123,18 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_evict_paused) {
     }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_parallel_read_ahead) {
+    if (smp::count < 2) {
+        std::cerr << "Cannot run test " << get_name() << " with smp::count < 2" << std::endl;
+        return;
+    }
+
+    do_with_cql_env_thread([&] (cql_test_env& env) -> future<> {
+        run_mutation_source_tests(make_populate(true, false, multishard_parallel_read_ahead::yes));
+        return make_ready_future<>();
+    }).get();
+}
+
 // Single fragment buffer tests are extremely slow, so the
 // run_mutation_source_tests execution is split
 
@@ -8,6 +8,7 @@
 
 #define BOOST_TEST_MODULE core
 
+#include <algorithm>
 #include <boost/test/unit_test.hpp>
 
 #include "utils/murmur_hash.hh"
@@ -109,3 +110,21 @@ BOOST_AUTO_TEST_CASE(test_hash_output) {
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_hash_output_of_many_keys) {
+    std::vector<bytes_view> prefixes;
+    for (size_t i = 0; i < full_sequence.size(); ++i) {
+        prefixes.push_back(bytes_view(full_sequence.begin(), i));
+    }
+    // Also in reverse, so keys of different lengths share lanes.
+    for (auto reverse : {false, true}) {
+        if (reverse) {
+            std::reverse(prefixes.begin(), prefixes.end());
+        }
+        std::vector<std::array<uint64_t, 2>> dsts(prefixes.size());
+        utils::murmur_hash::hash3_x64_128(prefixes, seed, dsts);
+        for (size_t i = 0; i < prefixes.size(); ++i) {
+            BOOST_REQUIRE(dsts[i] == prefix_hashes[prefixes[i].size()]);
+        }
+    }
+}
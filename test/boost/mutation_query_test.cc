@@ -21,12 +21,16 @@
 #include "test/lib/result_set_assertions.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
+#include "test/lib/random_utils.hh"
+#include "test/lib/log.hh"
 
 #include "mutation_query.hh"
 #include <seastar/core/do_with.hh>
 #include <seastar/core/thread.hh>
 #include "schema_builder.hh"
 #include "partition_slice_builder.hh"
+#include "query_result_merger.hh"
+#include "serializer_impl.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -557,3 +561,123 @@ SEASTAR_THREAD_TEST_CASE(test_result_size_calculation) {
     BOOST_REQUIRE_EQUAL(digest_only_builder.memory_accounter().used_memory(), result_and_digest_builder.memory_accounter().used_memory());
 }
 
+
+// Appends a field to the query_result serialized in r, like a newer version
+// could, which keeps result_merger from stitching r to the other results, so
+// it copies the partitions of all of them instead.
+static lw_shared_ptr<query::result> with_trailing_field(const query::result& r) {
+    bytes_ostream buf(r.buf());
+    auto b = buf.linearize();
+    auto in = ser::as_input_stream(b);
+    auto frame_size = ser::deserialize(in, boost::type<ser::size_type>());
+    bytes_ostream w;
+    ser::serialize(w, ser::size_type(frame_size + sizeof(uint32_t)));
+    w.write(b.substr(sizeof(ser::size_type)));
+    ser::serialize(w, uint32_t(0));
+    return make_lw_shared<query::result>(std::move(w), r.is_short_read(), *r.row_count(), r.partition_count());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_result_merger) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v", bytes_type, column_kind::regular_column)
+            .build();
+    auto slice = make_full_slice(*s);
+    auto now = gc_clock::now();
+
+    // Rows large enough for the partial results to span several chunks.
+    constexpr int partitions = 20;
+    constexpr int rows_per_partition = 10;
+    std::vector<mutation> mutations;
+    for (int pk = 0; pk < partitions; ++pk) {
+        mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+        for (int ck = 0; ck < rows_per_partition; ++ck) {
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), "v", data_value(tests::random::get_bytes(1000)), 1);
+        }
+        mutations.push_back(std::move(m));
+    }
+    std::sort(mutations.begin(), mutations.end(), mutation_less_cmp());
+
+    auto query_partitions = [&] (size_t count, uint64_t row_limit, uint32_t partition_limit) {
+        auto ms = std::vector<mutation>(mutations.begin(), mutations.begin() + count);
+        auto r = to_data_query_result(mutation_query(s, semaphore.make_permit(), make_source(std::move(ms)), query::full_partition_range, slice,
+                query::max_rows, query::max_partitions, now), s, slice, row_limit, partition_limit);
+        r.ensure_counts();
+        return r;
+    };
+
+    // The partial results of a range scan, each with consecutive partitions.
+    constexpr int partials = 4;
+    constexpr int partitions_per_partial = partitions / partials;
+    std::vector<query::result> partial_results;
+    for (int i = 0; i < partials; ++i) {
+        auto first = mutations.begin() + i * partitions_per_partial;
+        auto r = to_data_query_result(mutation_query(s, semaphore.make_permit(), make_source(std::vector<mutation>(first, first + partitions_per_partial)),
+                query::full_partition_range, slice, query::max_rows, query::max_partitions, now), s, slice, query::max_rows, query::max_partitions);
+        r.ensure_counts();
+        partial_results.push_back(std::move(r));
+    }
+
+    // Merges the partial results through both the path which stitches them
+    // and the one which copies them, and checks that both give the result of
+    // querying all their partitions at once.
+    auto check = [&] (uint64_t row_limit, uint32_t partition_limit, std::optional<int> short_read_partial = {}, bool shared = false) {
+        testlog.info("Merging with row limit {}, partition limit {}, short read in partial {}, shared partials: {}",
+                row_limit, partition_limit, short_read_partial ? *short_read_partial : -1, shared);
+
+        // The partial results the merger doesn't own alone, which must be left alone.
+        std::vector<lw_shared_ptr<query::result>> kept;
+        auto merge = [&] (bool copy) {
+            query::result_merger merger(row_limit, partition_limit);
+            for (int i = 0; i < partials; ++i) {
+                auto sr = query::short_read(short_read_partial == i);
+                auto r = make_lw_shared<query::result>(bytes_ostream(partial_results[i].buf()), sr, *partial_results[i].row_count(),
+                        partial_results[i].partition_count());
+                if (copy && i == 0) {
+                    r = with_trailing_field(*r);
+                }
+                if (shared && !copy) {
+                    kept.push_back(r);
+                }
+                merger(make_foreign(std::move(r)));
+            }
+            return merger.get();
+        };
+        auto stitched = merge(false);
+        auto copied = merge(true);
+
+        auto merged_partitions = short_read_partial ? (*short_read_partial + 1) * partitions_per_partial : partitions;
+        auto expected = query_partitions(merged_partitions, row_limit, partition_limit);
+        auto expected_set = query::result_set::from_raw_result(s, slice, expected);
+        for (auto* r : {&*stitched, &*copied}) {
+            BOOST_REQUIRE_EQUAL(*r->row_count(), *expected.row_count());
+            BOOST_REQUIRE_EQUAL(*r->partition_count(), *expected.partition_count());
+            BOOST_REQUIRE_EQUAL(bool(r->is_short_read()), bool(short_read_partial));
+            BOOST_REQUIRE(query::result_set::from_raw_result(s, slice, *r) == expected_set);
+        }
+        BOOST_REQUIRE(bytes_ostream(stitched->buf()).linearize() == bytes_ostream(copied->buf()).linearize());
+
+        for (size_t i = 0; i < kept.size(); ++i) {
+            BOOST_REQUIRE(bytes_ostream(kept[i]->buf()).linearize() == bytes_ostream(partial_results[i].buf()).linearize());
+        }
+    };
+
+    constexpr uint64_t rows_per_partial = partitions_per_partial * rows_per_partition;
+
+    // The partial results fit whole.
+    check(query::max_rows, query::max_partitions);
+    check(query::max_rows, query::max_partitions, {}, true);
+    // The limits end at the end of a partial result.
+    check(2 * rows_per_partial, query::max_partitions);
+    check(query::max_rows, 2 * partitions_per_partial, {}, true);
+    // The limits cut a partial result short, within a partition and between partitions.
+    check(2 * rows_per_partial + rows_per_partition / 2, query::max_partitions);
+    check(2 * rows_per_partial + rows_per_partition, query::max_partitions, {}, true);
+    check(query::max_rows, partitions_per_partial + 1);
+    // A partial result is short, the following ones are dropped.
+    check(query::max_rows, query::max_partitions, 1);
+    check(query::max_rows, query::max_partitions, 1, true);
+    check(query::max_rows, query::max_partitions, 0);
+}
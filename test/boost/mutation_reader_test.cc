@@ -307,6 +307,77 @@ SEASTAR_THREAD_TEST_CASE(test_combined_reader_range_tombstone_change_merging) {
         output{{rtc(1, 200), rtc(3, 100), rtc(4, {})}});
 }
 
+// Partitions owned by a single reader are moved to the combined reader's buffer
+// in bulk, possibly after some of their fragments went through the regular
+// merge. Range tombstones of such partitions mustn't leak into the next ones.
+SEASTAR_THREAD_TEST_CASE(test_combined_reader_range_tombstone_change_merging_across_single_reader_partitions) {
+    simple_schema s;
+    const auto schema = s.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto permit = semaphore.make_permit();
+    const auto pkeys = s.make_pkeys(4);
+
+    auto rtc = [&] (uint32_t ckey, std::optional<api::timestamp_type> ts) {
+        return range_tombstone_change(
+                position_in_partition::before_key(s.make_ckey(ckey)),
+                ts ? tombstone(*ts, {}) : tombstone());
+    };
+    using partition = std::pair<size_t, std::vector<range_tombstone_change>>;
+    auto make_reader = [&] (std::vector<partition> partitions, size_t max_buffer_size) {
+        std::deque<mutation_fragment_v2> fragments;
+        for (auto& [pkey, rtcs] : partitions) {
+            fragments.emplace_back(*schema, permit, partition_start(pkeys[pkey], {}));
+            for (auto& rtc : rtcs) {
+                fragments.emplace_back(*schema, permit, std::move(rtc));
+            }
+            fragments.emplace_back(*schema, permit, partition_end{});
+        }
+        auto rd = make_flat_mutation_reader_from_fragments(schema, permit, std::move(fragments));
+        rd.set_max_buffer_size(max_buffer_size);
+        return rd;
+    };
+
+    for (size_t max_buffer_size : {1, 100, 200, 400, 800, 1600, 1 << 20}) {
+        testlog.info("max_buffer_size={}", max_buffer_size);
+        std::vector<flat_mutation_reader_v2> readers;
+        // Partitions 0 and 1 belong to a single reader each, partitions 2 and 3 are merged.
+        readers.push_back(make_reader({
+                {0, {rtc(1, 300), rtc(2, 100), rtc(5, {})}},
+                {2, {rtc(1, 100), rtc(3, {})}},
+                {3, {rtc(2, 50), rtc(3, {})}}}, max_buffer_size));
+        readers.push_back(make_reader({
+                {1, {rtc(1, 50), rtc(4, {})}},
+                {2, {rtc(2, 200), rtc(4, {})}},
+                {3, {rtc(1, 100), rtc(4, {})}}}, max_buffer_size));
+        auto combined = make_combined_reader(schema, permit, std::move(readers));
+        combined.set_max_buffer_size(max_buffer_size);
+        auto combined_reader = assert_that(std::move(combined));
+
+        combined_reader.produces_partition_start(pkeys[0]);
+        combined_reader.produces_range_tombstone_change(rtc(1, 300));
+        combined_reader.produces_range_tombstone_change(rtc(2, 100));
+        combined_reader.produces_range_tombstone_change(rtc(5, {}));
+        combined_reader.produces_partition_end();
+
+        combined_reader.produces_partition_start(pkeys[1]);
+        combined_reader.produces_range_tombstone_change(rtc(1, 50));
+        combined_reader.produces_range_tombstone_change(rtc(4, {}));
+        combined_reader.produces_partition_end();
+
+        combined_reader.produces_partition_start(pkeys[2]);
+        combined_reader.produces_range_tombstone_change(rtc(1, 100));
+        combined_reader.produces_range_tombstone_change(rtc(2, 200));
+        combined_reader.produces_range_tombstone_change(rtc(4, {}));
+        combined_reader.produces_partition_end();
+
+        combined_reader.produces_partition_start(pkeys[3]);
+        combined_reader.produces_range_tombstone_change(rtc(1, 100));
+        combined_reader.produces_range_tombstone_change(rtc(4, {}));
+        combined_reader.produces_partition_end();
+        combined_reader.produces_end_of_stream();
+    }
+}
+
 static mutation make_mutation_with_key(schema_ptr s, dht::decorated_key dk) {
     mutation m(s, std::move(dk));
     m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(bytes("v1")), 1);
@@ -32,6 +32,7 @@
 #include "partition_slice_builder.hh"
 #include "test/lib/tmpdir.hh"
 #include "compaction/compaction_manager.hh"
+#include "tombstone_gc.hh"
 
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -2054,6 +2055,22 @@ SEASTAR_THREAD_TEST_CASE(test_cell_external_memory_usage) {
     test_collection(bytes(1024 * 1024, 'a'));
 }
 
+SEASTAR_THREAD_TEST_CASE(test_live_cells_of_fixed_size_types_are_inline) {
+    // A live cell is a flags byte and a timestamp followed by the value,
+    // and those of 8 byte types must fit in managed_bytes without an
+    // external allocation.
+    auto check_inline = [] (data_type dt, data_value v) {
+        auto ac = atomic_cell_or_collection(atomic_cell::make_live(*dt, 1, dt->decompose(v)));
+        BOOST_CHECK_EQUAL(ac.external_memory_usage(*dt), 0);
+    };
+
+    check_inline(boolean_type, true);
+    check_inline(int32_type, int32_t(1));
+    check_inline(long_type, int64_t(1));
+    check_inline(double_type, double(1));
+    check_inline(timestamp_type, db_clock::now());
+}
+
 // external_memory_usage() must be invariant to the merging order,
 // so that accounting of a clustering_row produced by partition_snapshot_flat_reader
 // doesn't give a greater result than what is used by the memtable region, possibly
@@ -2480,6 +2497,39 @@ SEASTAR_THREAD_TEST_CASE(test_appending_hash_row_4567) {
     BOOST_CHECK_EQUAL(compute_legacy_hash(r1, { 0, 1, 2 }), compute_legacy_hash(r2, { 0, 1, 2 }));
 }
 
+// Rows in cache have the hashes of their cells prepared, rows read from
+// sstables don't, and replicas have to agree on the digest either way.
+SEASTAR_THREAD_TEST_CASE(test_appending_hash_row_with_prepared_cell_hashes) {
+    auto s = schema_builder("ks", "cf")
+        .with_column("pk", bytes_type, column_kind::partition_key)
+        .with_column("ck", bytes_type, column_kind::clustering_key)
+        .with_column("r1", bytes_type)
+        .with_column("r2", bytes_type)
+        .build();
+
+    auto make_row = [&] {
+        auto r = row();
+        r.append_cell(0, atomic_cell::make_live(*bytes_type, 1, to_bytes("aaa")));
+        r.append_cell(1, atomic_cell::make_live(*bytes_type, 2, to_bytes("bbb")));
+        return r;
+    };
+
+    auto compute_hash = [&] <typename Hasher> (const row& r) {
+        auto hasher = Hasher{};
+        max_timestamp ts;
+        appending_hash<row>{}(hasher, r, *s, column_kind::regular_column, { 0, 1 }, ts);
+        return hasher.finalize_uint64();
+    };
+
+    auto r1 = make_row();
+    auto r2 = make_row();
+    r2.prepare_hash(*s, column_kind::regular_column);
+
+    BOOST_CHECK_EQUAL(compute_hash.operator()<xx_hasher>(r1), compute_hash.operator()<xx_hasher>(r2));
+    BOOST_CHECK_EQUAL(compute_hash.operator()<xxh3_hasher>(r1), compute_hash.operator()<xxh3_hasher>(r2));
+    BOOST_CHECK_NE(compute_hash.operator()<xx_hasher>(r1), compute_hash.operator()<xxh3_hasher>(r1));
+}
+
 SEASTAR_THREAD_TEST_CASE(test_mutation_consume) {
     std::mt19937 engine(tests::random::get_int<uint32_t>());
 
@@ -2803,3 +2853,41 @@ SEASTAR_THREAD_TEST_CASE(test_compactor_range_tombstone_spanning_many_pages) {
         BOOST_REQUIRE_EQUAL(res_mut, ref_mut);
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_gc_before_cursor) {
+    auto s = schema_builder("ks", "cf")
+        .with_column("pk", int32_type, column_kind::partition_key)
+        .with_column("v", int32_type)
+        .with_tombstone_gc_options(tombstone_gc_options({{"mode", "repair"}, {"propagation_delay_in_seconds", "0"}}))
+        .build();
+    auto drop_history = defer([&s] { drop_repair_history_map_for_table(s->id()); });
+    const auto query_time = gc_clock::now();
+    auto dk = [] (int64_t t) {
+        return dht::decorated_key(dht::token::from_int64(t), partition_key::make_empty());
+    };
+    auto range = [] (int64_t start, int64_t end) {
+        return dht::token_range(dht::token_range::bound(dht::token::from_int64(start), false), dht::token_range::bound(dht::token::from_int64(end), true));
+    };
+
+    gc_before_cursor cursor(*s, query_time);
+    BOOST_REQUIRE(cursor.get(dk(0)) == gc_clock::time_point::min());
+
+    const auto t1 = query_time - std::chrono::hours(2);
+    const auto t2 = query_time - std::chrono::hours(1);
+    update_repair_time(s, range(-100, 0), t1);
+    update_repair_time(s, range(100, 200), t2);
+
+    auto check = [&] {
+        for (int64_t t : {-200, -100, -50, 0, 1, 50, 100, 150, 200, 300}) {
+            BOOST_REQUIRE(cursor.get(dk(t)) == get_gc_before_for_key(s, dk(t), query_time));
+        }
+    };
+    check();
+    BOOST_REQUIRE(cursor.get(dk(-50)) == t1);
+    BOOST_REQUIRE(cursor.get(dk(150)) == t2);
+
+    // The cursor sees the repairs which complete while it's used.
+    update_repair_time(s, range(-100, 200), query_time);
+    check();
+    BOOST_REQUIRE(cursor.get(dk(50)) == query_time);
+}
@@ -7,6 +7,7 @@
  */
 
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -28,6 +29,7 @@
 #include "test/lib/log.hh"
 
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/numeric.hpp>
 
 using namespace mutation_writer;
 
@@ -167,6 +169,59 @@ SEASTAR_TEST_CASE(test_multishard_writer_producer_aborts) {
     });
 }
 
+SEASTAR_TEST_CASE(test_distribute_frozen_fragments) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto test_random_streams = [&e] (random_mutation_generator&& gen, size_t partition_nr, generate_error error = generate_error::no) {
+            auto muts = gen(partition_nr);
+            schema_ptr s = gen.schema();
+            std::vector<size_t> partitions_before(smp::count, 0);
+            std::vector<size_t> partitions_after(smp::count, 0);
+            std::vector<size_t> fragments_after(smp::count, 0);
+            size_t fragments_before = 0;
+            for (auto& m : muts) {
+                partitions_before[s->get_sharder().shard_of(m.token())]++;
+            }
+            auto source_reader = partition_nr > 0 ? make_flat_mutation_reader_from_mutations(s, make_reader_permit(e), muts) : make_empty_flat_reader(s, make_reader_permit(e));
+            auto close_source_reader = deferred_close(source_reader);
+            auto producer = [&] () -> future<std::optional<frozen_mutation_fragment>> {
+                auto mf = co_await source_reader();
+                if (!mf) {
+                    co_return std::nullopt;
+                }
+                ++fragments_before;
+                co_return freeze(*s, *mf);
+            };
+            auto& sharder = s->get_sharder();
+            size_t partitions_received = distribute_frozen_fragments_and_consume_on_shards(s, std::move(producer),
+                [&sharder, &partitions_after, &fragments_after, error] (flat_mutation_reader reader) -> future<> {
+                    auto close_reader = deferred_close(reader);
+                    if (error) {
+                        throw std::runtime_error("Failed to write");
+                    }
+                    while (auto mf = co_await reader()) {
+                        if (mf->is_partition_start()) {
+                            BOOST_REQUIRE_EQUAL(sharder.shard_of(mf->as_partition_start().key().token()), this_shard_id());
+                            partitions_after[this_shard_id()]++;
+                        }
+                        fragments_after[this_shard_id()]++;
+                    }
+                }
+            ).get0();
+            BOOST_REQUIRE_EQUAL(partitions_received, partition_nr);
+            BOOST_REQUIRE_EQUAL(partitions_after, partitions_before);
+            BOOST_REQUIRE_EQUAL(boost::accumulate(fragments_after, size_t(0)), fragments_before);
+        };
+
+        test_random_streams(random_mutation_generator(random_mutation_generator::generate_counters::no, local_shard_only::no), 0);
+        test_random_streams(random_mutation_generator(random_mutation_generator::generate_counters::no, local_shard_only::no), 1);
+        test_random_streams(random_mutation_generator(random_mutation_generator::generate_counters::no, local_shard_only::no), many_partitions());
+        test_random_streams(random_mutation_generator(random_mutation_generator::generate_counters::yes, local_shard_only::no), many_partitions());
+
+        BOOST_REQUIRE_THROW(test_random_streams(random_mutation_generator(random_mutation_generator::generate_counters::no, local_shard_only::no), many_partitions(), generate_error::yes),
+                std::runtime_error);
+    });
+}
+
 namespace {
 
 class test_bucket_writer {
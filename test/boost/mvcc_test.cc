@@ -1454,6 +1454,59 @@ SEASTAR_TEST_CASE(test_versions_are_merged_when_snapshots_go_away) {
     });
 }
 
+SEASTAR_TEST_CASE(test_long_version_chains_are_merged) {
+    return seastar::async([] {
+        logalloc::region r;
+        mutation_cleaner cleaner(r, nullptr, app_stats_for_tests);
+        with_allocator(r.allocator(), [&] {
+            random_mutation_generator gen(random_mutation_generator::generate_counters::no);
+            auto s = gen.schema();
+
+            const unsigned versions = mutation_cleaner_impl::eager_merge_version_chain_length + 2;
+
+            mutation m = gen();
+            m.partition().make_fully_continuous();
+            auto e = partition_entry(mutation_partition(*s, m.partition()));
+            auto expected = mutation_partition(*s, m.partition());
+
+            // Every snapshot pins a version, so each write adds one to the chain.
+            std::vector<partition_snapshot_ptr> snapshots;
+            for (unsigned i = 1; i < versions; ++i) {
+                snapshots.push_back(e.read(r, cleaner, s, nullptr));
+                mutation m2 = gen();
+                m2.partition().make_fully_continuous();
+                {
+                    mutation_application_stats app_stats;
+                    logalloc::reclaim_lock rl(r);
+                    e.apply(*s, m2.partition(), *s, app_stats);
+                }
+                mutation_application_stats app_stats;
+                expected.apply(*s, m2.partition(), *s, app_stats);
+            }
+            BOOST_REQUIRE_EQUAL(versions, boost::size(e.versions()));
+
+            auto stats_before = cleaner.stats();
+
+            // Release the snapshots while preemption is requested, so that merging is deferred.
+            while (!need_preempt()) {}
+            for (auto& snp : snapshots) {
+                snp = {};
+            }
+
+            auto& stats = cleaner.stats();
+            BOOST_REQUIRE_EQUAL(stats.released_snapshots - stats_before.released_snapshots, versions - 1);
+            BOOST_REQUIRE_GE(stats.released_snapshot_version_chain_length - stats_before.released_snapshot_version_chain_length, versions);
+            BOOST_REQUIRE_GE(stats.long_version_chains, stats_before.long_version_chains + 1);
+
+            cleaner.drain().get();
+
+            BOOST_REQUIRE_EQUAL(0, cleaner.pending_snapshots());
+            BOOST_REQUIRE_EQUAL(1, boost::size(e.versions()));
+            assert_that(s, e.squashed(*s)).is_equal_to(expected);
+        });
+    });
+}
+
 // Reproducer of #4030
 SEASTAR_TEST_CASE(test_snapshot_merging_after_container_is_destroyed) {
     return seastar::async([] {
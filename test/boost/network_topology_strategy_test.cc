@@ -616,6 +616,53 @@ SEASTAR_THREAD_TEST_CASE(testCalculateEndpoints) {
     }
 }
 
+// Checks that the sorted tokens, which update_normal_tokens() keeps up to date
+// incrementally, match the tokens of the ring, also in the clones sharing them.
+SEASTAR_THREAD_TEST_CASE(test_update_normal_tokens_keeps_tokens_sorted) {
+    constexpr size_t NODES = 20;
+    constexpr size_t VNODES = 32;
+
+    auto check_sorted = [] (const token_metadata& tm) {
+        auto expected = boost::copy_range<std::vector<token>>(tm.get_token_to_endpoint() | boost::adaptors::map_keys);
+        std::sort(expected.begin(), expected.end());
+        BOOST_REQUIRE(tm.sorted_tokens() == expected);
+    };
+    auto random_tokens = [] {
+        std::unordered_set<token> tokens;
+        while (tokens.size() < VNODES) {
+            tokens.insert(dht::token::get_random_token());
+        }
+        return tokens;
+    };
+
+    token_metadata tm;
+    for (size_t i = 1; i <= NODES; ++i) {
+        tm.update_normal_tokens(random_tokens(), inet_address((127u << 24) | i)).get();
+        check_sorted(tm);
+    }
+    auto clone = tm.clone_async().get0();
+
+    // Move some of the tokens of a node to another one and replace the tokens of another node.
+    auto tokens = tm.get_tokens(inet_address((127u << 24) | 1));
+    auto moved = std::unordered_set<token>(tokens.begin(), tokens.begin() + VNODES / 2);
+    tm.update_normal_tokens({
+        {inet_address((127u << 24) | 1), std::unordered_set<token>(tokens.begin() + VNODES / 2, tokens.end())},
+        {inet_address((127u << 24) | 2), moved},
+        {inet_address((127u << 24) | 3), random_tokens()},
+    }).get();
+    check_sorted(tm);
+    BOOST_REQUIRE_EQUAL(tm.get_tokens(inet_address((127u << 24) | 2)).size(), VNODES / 2);
+
+    tm.remove_endpoint(inet_address((127u << 24) | 4));
+    check_sorted(tm);
+    tm.update_normal_tokens(random_tokens(), inet_address((127u << 24) | 4)).get();
+    check_sorted(tm);
+
+    // The clone is not affected by the changes.
+    check_sorted(clone);
+    BOOST_REQUIRE_EQUAL(clone.sorted_tokens().size(), NODES * VNODES);
+}
+
 SEASTAR_TEST_CASE(test_invalid_dcs) {
     return do_with_cql_env_thread([] (auto& e) {
         for (auto& incorrect : std::vector<std::string>{"3\"", "", "!!!", "abcb", "!3", "-5", "0x123", "999999999999999999999999999999"}) {
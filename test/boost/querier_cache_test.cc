@@ -11,6 +11,7 @@
 #include "test/lib/simple_schema.hh"
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/random_utils.hh"
+#include "test/lib/eventually.hh"
 #include "db/config.hh"
 
 #include <seastar/core/sleep.hh>
@@ -185,6 +186,10 @@ class test_querier_cache {
         return _sem;
     }
 
+    query::querier_cache& get_cache() {
+        return _cache;
+    }
+
     dht::partition_range make_partition_range(bound begin, bound end) const {
         return dht::partition_range::make({_mutations.at(begin.value()).decorated_key(), begin.is_inclusive()},
                 {_mutations.at(end.value()).decorated_key(), end.is_inclusive()});
@@ -724,6 +729,28 @@ SEASTAR_THREAD_TEST_CASE(test_resources_based_cache_eviction) {
     }, std::move(db_cfg_ptr)).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_read_ahead) {
+    test_querier_cache t;
+    t.get_cache().set_read_ahead(true);
+
+    const auto entry = t.produce_first_page_and_save_data_querier();
+    BOOST_REQUIRE_EQUAL(t.get_cache().get_stats().read_aheads, 1);
+
+    // The querier is registered as an inactive read once it's done reading ahead.
+    REQUIRE_EVENTUALLY_EQUAL(t.get_semaphore().get_stats().inactive_reads, 1);
+
+    auto q = t.get_cache().lookup_data_querier(test_querier_cache::make_cache_key(entry.key), *t.get_schema(), entry.expected_range,
+            entry.expected_slice, nullptr, db::no_timeout);
+    BOOST_REQUIRE(q);
+    auto close_q = deferred_close(*q);
+    auto dk_ck = q->consume_page(dummy_result_builder{}, entry.row_limit, std::numeric_limits<uint32_t>::max(), gc_clock::now()).get0();
+    BOOST_REQUIRE(dk_ck.first);
+
+    // Single partition queriers don't read ahead.
+    t.produce_first_page_and_save_data_querier(2, std::size_t(0));
+    BOOST_REQUIRE_EQUAL(t.get_cache().get_stats().read_aheads, 1);
+}
+
 SEASTAR_THREAD_TEST_CASE(test_evict_all_for_table) {
     test_querier_cache t;
 
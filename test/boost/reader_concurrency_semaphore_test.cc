@@ -904,3 +904,128 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_used_blocked) {
         }
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_fast_lane) {
+    using admission_lane = reader_concurrency_semaphore::admission_lane;
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, replica::new_reader_base_cost);
+    auto stop_sem = deferred_stop(semaphore);
+
+    reader_permit_opt permit = semaphore.obtain_permit(nullptr, "scan1", replica::new_reader_base_cost, db::no_timeout).get();
+
+    // Waits behind the admitted scan.
+    auto scan_fut = semaphore.obtain_permit(nullptr, "scan2", replica::new_reader_base_cost, db::no_timeout);
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 1);
+
+    std::vector<future<reader_permit>> fast_futs;
+    for (unsigned i = 0; i < reader_concurrency_semaphore::max_consecutive_fast_admissions + 1; ++i) {
+        fast_futs.emplace_back(semaphore.obtain_permit(nullptr, "point", replica::new_reader_base_cost, db::no_timeout, admission_lane::fast));
+    }
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), fast_futs.size() + 1);
+
+    // Fast reads are admitted before the scan queued before them, but not
+    // more than max_consecutive_fast_admissions of them.
+    for (unsigned i = 0; i < reader_concurrency_semaphore::max_consecutive_fast_admissions; ++i) {
+        permit = {};
+        permit = fast_futs[i].get();
+        BOOST_REQUIRE(!scan_fut.available());
+    }
+    permit = {};
+    permit = scan_fut.get();
+    BOOST_REQUIRE(!fast_futs.back().available());
+    permit = {};
+    permit = fast_futs.back().get();
+
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().reads_admitted_fast_lane, fast_futs.size());
+
+    // The memory consumed on top of the base resources is tracked.
+    {
+        auto res = permit->consume_memory(1024);
+        BOOST_REQUIRE_EQUAL(permit->max_consumed_memory(), 1024);
+    }
+    BOOST_REQUIRE_EQUAL(permit->max_consumed_memory(), 1024);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_permit_arena) {
+    simple_schema s;
+    const auto initial_resources = reader_concurrency_semaphore::resources{10, 1024 * 1024};
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), initial_resources.count, initial_resources.memory);
+    auto stop_sem = deferred_stop(semaphore);
+
+    {
+        auto permit = semaphore.make_tracking_only_permit(s.schema().get(), get_name(), db::no_timeout);
+
+        // The arena costs nothing until it's used.
+        BOOST_REQUIRE_EQUAL(permit.consumed_resources(), reader_resources{});
+
+        std::pmr::vector<int64_t> v(&permit.arena());
+        for (int64_t i = 0; i < 1000; ++i) {
+            v.push_back(i);
+        }
+        BOOST_REQUIRE_EQUAL(v.back(), 999);
+
+        // The memory of the arena is consumed from the permit, and is held
+        // even after the objects allocated from it are gone.
+        const auto consumed = permit.consumed_resources().memory;
+        BOOST_REQUIRE_GE(consumed, ssize_t(v.size() * sizeof(int64_t)));
+        v = std::pmr::vector<int64_t>(&permit.arena());
+        BOOST_REQUIRE_EQUAL(permit.consumed_resources().memory, consumed);
+        BOOST_REQUIRE_EQUAL(semaphore.available_resources().memory, initial_resources.memory - consumed);
+    }
+    // And released all at once with the permit.
+    BOOST_REQUIRE_EQUAL(semaphore.available_resources(), initial_resources);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_set_count_limit) {
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 2, 10 * replica::new_reader_base_cost);
+    auto stop_sem = deferred_stop(semaphore);
+
+    auto permit1 = semaphore.obtain_permit(nullptr, "read1", replica::new_reader_base_cost, db::no_timeout).get();
+    auto permit2 = semaphore.obtain_permit(nullptr, "read2", replica::new_reader_base_cost, db::no_timeout).get();
+
+    // Lowering the limit below the number of admitted reads leaves them be.
+    semaphore.set_count_limit(1);
+    BOOST_REQUIRE_EQUAL(semaphore.count_limit(), 1);
+    BOOST_REQUIRE_EQUAL(semaphore.available_resources().count, -1);
+
+    auto read3_fut = semaphore.obtain_permit(nullptr, "read3", replica::new_reader_base_cost, db::no_timeout);
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 1);
+    {
+        auto released = std::move(permit1);
+    }
+    BOOST_REQUIRE(!read3_fut.available());
+
+    // Raising it admits the waiting read.
+    semaphore.set_count_limit(2);
+    auto permit3 = read3_fut.get();
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 0);
+    BOOST_REQUIRE_EQUAL(semaphore.available_resources().count, 0);
+}
+
+// Fast reads which don't wait can still starve a regular read which waits for
+// memory, unless they count towards max_consecutive_fast_admissions too.
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_fast_lane_is_fair) {
+    using admission_lane = reader_concurrency_semaphore::admission_lane;
+    const auto cost = replica::new_reader_base_cost;
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 100, 4 * cost);
+    auto stop_sem = deferred_stop(semaphore);
+
+    reader_permit_opt big = semaphore.obtain_permit(nullptr, "big", 2 * cost, db::no_timeout).get();
+
+    // Doesn't fit next to the big read, so it waits.
+    auto scan_fut = semaphore.obtain_permit(nullptr, "scan", 3 * cost, db::no_timeout);
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 1);
+
+    // Fast reads do fit, and are admitted past the scan, but only so many times.
+    for (unsigned i = 0; i < reader_concurrency_semaphore::max_consecutive_fast_admissions; ++i) {
+        auto fut = semaphore.obtain_permit(nullptr, "point", cost, db::no_timeout, admission_lane::fast);
+        BOOST_REQUIRE(fut.available());
+        fut.get();
+    }
+    auto fast_fut = semaphore.obtain_permit(nullptr, "point", cost, db::no_timeout, admission_lane::fast);
+    BOOST_REQUIRE(!fast_fut.available());
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 2);
+
+    big = {};
+    reader_permit_opt scan = scan_fut.get();
+    reader_permit_opt fast = fast_fut.get();
+}
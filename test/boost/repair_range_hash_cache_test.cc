@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "repair/row_level.hh"
+#include "utils/UUID_gen.hh"
+
+static dht::token_range make_range(int64_t start, int64_t end) {
+    return dht::token_range::make({dht::token::from_int64(start), false}, {dht::token::from_int64(end), true});
+}
+
+SEASTAR_THREAD_TEST_CASE(test_range_hash_cache_finds_hash_of_unchanged_range) {
+    range_hash_cache cache(10);
+    auto table = utils::UUID_gen::get_time_UUID();
+    auto range = make_range(0, 100);
+    auto hash = cached_range_hash{1, repair_hash(42)};
+
+    BOOST_REQUIRE(!cache.find(table, range, {1, 2}));
+    cache.save(table, range, {1, 2}, hash);
+    BOOST_REQUIRE(cache.find(table, range, {1, 2}) == hash);
+    // Other ranges and tables have no hash.
+    BOOST_REQUIRE(!cache.find(table, make_range(0, 50), {1, 2}));
+    BOOST_REQUIRE(!cache.find(utils::UUID_gen::get_time_UUID(), range, {1, 2}));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_range_hash_cache_forgets_changed_range) {
+    range_hash_cache cache(10);
+    auto table = utils::UUID_gen::get_time_UUID();
+    auto range = make_range(0, 100);
+
+    cache.save(table, range, {1, 2}, cached_range_hash{1, repair_hash(42)});
+    // A new sstable (e.g. written by a flush or a repair), or a compaction.
+    BOOST_REQUIRE(!cache.find(table, range, {1, 2, 3}));
+    BOOST_REQUIRE_EQUAL(cache.size(), 0);
+    // Even once back to the same sstables, the stale hash is gone.
+    BOOST_REQUIRE(!cache.find(table, range, {1, 2}));
+
+    cache.save(table, range, {3}, cached_range_hash{2, repair_hash(43)});
+    BOOST_REQUIRE(!cache.find(table, range, {1, 2}));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_range_hash_cache_evicts_least_recently_used) {
+    range_hash_cache cache(2);
+    auto table = utils::UUID_gen::get_time_UUID();
+    auto r1 = make_range(0, 100);
+    auto r2 = make_range(100, 200);
+    auto r3 = make_range(200, 300);
+
+    cache.save(table, r1, {1}, cached_range_hash{1, repair_hash(1)});
+    cache.save(table, r2, {1}, cached_range_hash{1, repair_hash(2)});
+    // Using r1 makes r2 the least recently used.
+    BOOST_REQUIRE(cache.find(table, r1, {1}));
+    cache.save(table, r3, {1}, cached_range_hash{1, repair_hash(3)});
+
+    BOOST_REQUIRE_EQUAL(cache.size(), 2);
+    BOOST_REQUIRE(cache.find(table, r1, {1}));
+    BOOST_REQUIRE(!cache.find(table, r2, {1}));
+    BOOST_REQUIRE(cache.find(table, r3, {1}));
+
+    // Saving a hash again replaces it, without growing the cache.
+    cache.save(table, r3, {2}, cached_range_hash{2, repair_hash(4)});
+    BOOST_REQUIRE_EQUAL(cache.size(), 2);
+    BOOST_REQUIRE(cache.find(table, r3, {2}) == cached_range_hash({2, repair_hash(4)}));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_range_hashes_match) {
+    auto h = cached_range_hash{1, repair_hash(42)};
+    using hashes = std::vector<std::optional<cached_range_hash>>;
+
+    BOOST_REQUIRE(range_hashes_match(hashes{h, h, h}));
+    // A replica whose data changed has no hash: the range must be repaired.
+    BOOST_REQUIRE(!range_hashes_match(hashes{h, std::nullopt, h}));
+    BOOST_REQUIRE(!range_hashes_match(hashes{std::nullopt, h, h}));
+    BOOST_REQUIRE(!range_hashes_match(hashes{std::nullopt, std::nullopt}));
+    BOOST_REQUIRE(!range_hashes_match(hashes{h, cached_range_hash{1, repair_hash(43)}}));
+    // Hashes computed by different repairs can't be compared.
+    BOOST_REQUIRE(!range_hashes_match(hashes{h, cached_range_hash{2, repair_hash(42)}}));
+    BOOST_REQUIRE(!range_hashes_match(hashes{}));
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "service/replica_scorer.hh"
+
+using namespace std::chrono_literals;
+
+SEASTAR_THREAD_TEST_CASE(test_replica_scorer_keeps_proximity_order_of_healthy_replicas) {
+    service::replica_scorer scorer;
+    const gms::inet_address a("127.0.0.1"), b("127.0.0.2"), c("127.0.0.3");
+
+    // Unknown replicas don't make us reorder.
+    inet_address_vector_replica_set eps{a, b, c};
+    BOOST_REQUIRE(!scorer.sort(eps, 0.2, 60s));
+
+    // Neither do differences within the noise.
+    for (auto [ep, latency] : {std::pair(a, 700us), std::pair(b, 300us), std::pair(c, 500us)}) {
+        scorer.on_request(ep);
+        scorer.on_response(ep, latency);
+    }
+    BOOST_REQUIRE(!scorer.sort(eps, 0.2, 60s));
+    BOOST_REQUIRE(eps == inet_address_vector_replica_set({a, b, c}));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_replica_scorer_avoids_slow_replicas) {
+    service::replica_scorer scorer;
+    const gms::inet_address a("127.0.0.1"), b("127.0.0.2"), c("127.0.0.3");
+
+    for (auto ep : {a, b, c}) {
+        scorer.on_request(ep);
+        scorer.on_response(ep, 500us);
+    }
+    // a becomes slow.
+    for (int i = 0; i < 10; ++i) {
+        scorer.on_request(a);
+        scorer.on_response(a, 50ms);
+    }
+    inet_address_vector_replica_set eps{a, b, c};
+    BOOST_REQUIRE(scorer.sort(eps, 0.2, 60s));
+    BOOST_REQUIRE(eps == inet_address_vector_replica_set({b, c, a}));
+
+    // Requests piling up on b make it worse than c.
+    for (int i = 0; i < 10; ++i) {
+        scorer.on_request(b);
+    }
+    BOOST_REQUIRE(scorer.sort(eps, 0.2, 60s));
+    BOOST_REQUIRE(eps == inet_address_vector_replica_set({c, b, a}));
+
+    // Forgetting an idle replica gives it another chance.
+    scorer.remove(a);
+    eps = {a, c};
+    BOOST_REQUIRE(!scorer.sort(eps, 0.2, 60s));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_replica_scorer_doesnt_prefer_unknown_replicas) {
+    service::replica_scorer scorer;
+    const gms::inet_address a("127.0.0.1"), b("127.0.0.2"), c("127.0.0.3");
+
+    scorer.on_request(a);
+    scorer.on_response(a, 50ms);
+    scorer.on_request(b);
+    scorer.on_response(b, 500us);
+
+    // c was never read from (e.g. it's in a remote DC). It goes after the
+    // healthy replica, but before the slow one.
+    inet_address_vector_replica_set eps{a, b, c};
+    BOOST_REQUIRE(scorer.sort(eps, 0.2, 60s));
+    BOOST_REQUIRE(eps == inet_address_vector_replica_set({b, c, a}));
+
+    // Requests to c which are not answered yet don't make it look fast.
+    for (int i = 0; i < 3; ++i) {
+        scorer.on_request(c);
+    }
+    eps = {c, a, b};
+    BOOST_REQUIRE(scorer.sort(eps, 0.2, 60s));
+    BOOST_REQUIRE(eps == inet_address_vector_replica_set({b, a, c}));
+}
@@ -209,6 +209,13 @@ SEASTAR_THREAD_TEST_CASE(map_entry_eq) {
                 make_map_value(my_map_type, map_type_impl::native_type({{1, 11}, {2, 12}, {3, 13}})));
         require_rows(e, stmt, {{"uno", "tres"}}, {I(11), I(13)}, {{I(1), m1}});
         require_rows(e, stmt, {{"uno", "tres"}}, {I(21), I(99)}, {});
+        // Keys are compared by their type, not their serialized bytes.
+        cquery_nofail(e, "insert into t (p, m) values (4, {-5:41, 10:42})");
+        const auto m4 = my_map_type->decompose(
+                make_map_value(my_map_type, map_type_impl::native_type({{-5, 41}, {10, 42}})));
+        require_rows(e, "select p from t where m[-5]=41 allow filtering", {{I(4), m4}});
+        require_rows(e, "select p from t where m[10]=42 allow filtering", {{I(4), m4}});
+        require_rows(e, "select p from t where m[0]=41 allow filtering", {});
     }).get();
 }
 
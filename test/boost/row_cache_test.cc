@@ -152,6 +152,156 @@ SEASTAR_TEST_CASE(test_cache_works_after_clearing) {
     });
 }
 
+SEASTAR_TEST_CASE(test_get_cached_keys) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<memtable>(s);
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+        BOOST_REQUIRE(cache.get_cached_keys(10).get0().empty());
+
+        std::vector<dht::decorated_key> keys;
+        for (int i = 0; i < 1000; i++) {
+            auto m = make_new_mutation(s);
+            keys.emplace_back(m.decorated_key());
+            cache.populate(m);
+        }
+        std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(s));
+
+        auto all = cache.get_cached_keys(std::numeric_limits<size_t>::max()).get0();
+        BOOST_REQUIRE_EQUAL(all.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            BOOST_REQUIRE(all[i].equal(*s, keys[i]));
+        }
+
+        auto some = cache.get_cached_keys(10).get0();
+        BOOST_REQUIRE_EQUAL(some.size(), 10);
+        BOOST_REQUIRE(some.back().equal(*s, keys[9]));
+
+        auto range = dht::partition_range::make(keys[100], keys[199]);
+        auto in_range = cache.get_cached_keys(std::numeric_limits<size_t>::max(), range).get0();
+        BOOST_REQUIRE_EQUAL(in_range.size(), 100);
+        BOOST_REQUIRE(in_range.front().equal(*s, keys[100]));
+        BOOST_REQUIRE(in_range.back().equal(*s, keys[199]));
+    });
+}
+
+SEASTAR_TEST_CASE(test_values_of_unselected_columns_are_not_copied_out_of_cache) {
+    return seastar::async([] {
+        auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v1", utf8_type)
+            .with_column("v2", utf8_type)
+            .build();
+
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        auto pk = partition_key::from_single_value(*s, int32_type->decompose(0));
+        auto ck0 = clustering_key::from_single_value(*s, int32_type->decompose(0));
+        auto ck1 = clustering_key::from_single_value(*s, int32_type->decompose(1));
+        mutation m(s, pk);
+        m.set_clustered_cell(ck0, "v1", data_value(sstring("a")), 1);
+        m.set_clustered_cell(ck0, "v2", data_value(sstring("b")), 1);
+        m.set_clustered_cell(ck1, "v2", data_value(sstring("c")), 1);
+
+        auto mt = make_lw_shared<memtable>(s);
+        mt->apply(m);
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+        cache.populate(m);
+
+        auto range = dht::partition_range::make_singular(m.decorated_key());
+        auto slice = partition_slice_builder(*s).with_regular_column(to_bytes("v1")).build();
+        auto reader = cache.make_reader(s, semaphore.make_permit(), range, slice);
+        auto close_reader = deferred_close(reader);
+        auto mo = read_mutation_from_flat_mutation_reader(reader).get0();
+        BOOST_REQUIRE(mo);
+
+        auto& v1 = *s->get_column_definition(to_bytes("v1"));
+        auto& v2 = *s->get_column_definition(to_bytes("v2"));
+
+        auto r0 = mo->partition().find_row(*s, ck0);
+        BOOST_REQUIRE(r0);
+        BOOST_REQUIRE(r0->find_cell(v1.id));
+        BOOST_REQUIRE_EQUAL(r0->find_cell(v1.id)->as_atomic_cell(v1).value().linearize(), utf8_type->decompose(sstring("a")));
+
+        // The row has to stay live even if none of its selected cells are.
+        auto r1 = mo->partition().find_row(*s, ck1);
+        BOOST_REQUIRE(r1);
+        BOOST_REQUIRE(r1->find_cell(v2.id));
+        auto c = r1->find_cell(v2.id)->as_atomic_cell(v2);
+        BOOST_REQUIRE(c.is_live());
+        BOOST_REQUIRE(c.value().empty());
+
+        // Reads of all the columns are not affected.
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+            .produces(m)
+            .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_compress_cold_entries) {
+    return seastar::async([] {
+        simple_schema s;
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        cache_tracker tracker;
+        memtable_snapshot_source underlying(s.schema());
+        row_cache cache(s.schema(), snapshot_source([&] { return underlying(); }), tracker);
+
+        auto keys = s.make_pkeys(3);
+        std::vector<mutation> mutations;
+        for (auto& key : keys) {
+            mutation m(s.schema(), key);
+            for (int i = 0; i < 100; ++i) {
+                s.add_row(m, s.make_ckey(i), "value");
+            }
+            underlying.apply(m);
+            cache.populate(m);
+            mutations.push_back(std::move(m));
+        }
+
+        auto read = [&] (const mutation& m) {
+            assert_that(cache.make_reader(s.schema(), semaphore.make_permit(), dht::partition_range::make_singular(m.decorated_key())))
+                .produces(m)
+                .produces_end_of_stream();
+        };
+
+        // The first pass only marks the partitions.
+        cache.compress_cold_entries().get();
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_compressions, 0);
+
+        read(mutations[0]);
+        cache.compress_cold_entries().get();
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_compressions, 2);
+        BOOST_REQUIRE(!cache.lookup(keys[0]).is_compressed());
+        BOOST_REQUIRE(cache.lookup(keys[1]).is_compressed());
+        BOOST_REQUIRE(cache.lookup(keys[2]).is_compressed());
+
+        auto misses = tracker.get_stats().row_misses;
+        read(mutations[1]);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_expansions, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().row_misses, misses);
+
+        // Updates apply to the expanded partition.
+        auto mt = make_lw_shared<memtable>(s.schema());
+        mutation m2(s.schema(), keys[2]);
+        s.add_row(m2, s.make_ckey(1000), "new_value");
+        mt->apply(m2);
+        cache.update(row_cache::external_updater([&] { underlying.apply(m2); }), *mt).get();
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_expansions, 2);
+        read(mutations[2] + m2);
+
+        assert_that(cache.make_reader(s.schema(), semaphore.make_permit()))
+            .produces(mutations[0])
+            .produces(mutations[1])
+            .produces(mutations[2] + m2)
+            .produces_end_of_stream();
+    });
+}
+
 class partition_counting_reader final : public delegating_reader {
     int& _counter;
     bool _count_fill_buffer = true;
@@ -865,8 +1015,168 @@ SEASTAR_TEST_CASE(test_eviction) {
     });
 }
 
+SEASTAR_TEST_CASE(test_admission_filter) {
+    return seastar::async([] {
+        auto s = schema_builder(make_schema())
+                .set_caching_options(caching_options::from_map({{"admission_filter", "true"}}))
+                .build();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto mt = make_lw_shared<memtable>(s);
+        auto m1 = make_new_mutation(s);
+        auto m2 = make_new_mutation(s);
+        mt->apply(m1);
+        mt->apply(m2);
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto read = [&] (const mutation& m) {
+            assert_that(cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(m.decorated_key())))
+                .produces(m)
+                .produces_end_of_stream();
+        };
+
+        // Nothing was evicted yet, so everything is admitted.
+        read(m1);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+
+        // m1 becomes the victim, which was accessed once.
+        tracker.clear();
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 0);
+
+        // m2 is not accessed more often than m1 yet.
+        read(m2);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 0);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_admission_rejections, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_admission_rejections, 1);
+
+        read(m2);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_admission_rejections, 1);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_misses, 3);
+
+        read(m2);
+        BOOST_REQUIRE_EQUAL(cache.stats().partition_hits, 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_pinned_tracker) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<memtable>(s);
+
+        cache_tracker tracker;
+        utils::updateable_value_source<double> memory_fraction(1.0);
+        tracker.set_pinned(utils::updateable_value<double>(memory_fraction));
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        const int partitions = 1000;
+        for (int i = 0; i < partitions; i++) {
+            cache.populate(make_new_mutation(s));
+        }
+
+        while (tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something) ;
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), partitions);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_evictions, 0);
+
+        // Beyond its memory budget, the cache is evicted as usual.
+        memory_fraction.set(0);
+        while (tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something) ;
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 0);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_evictions, partitions);
+    });
+}
+
+SEASTAR_TEST_CASE(test_range_scans_populate_probationary_entries) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto mt = make_lw_shared<memtable>(s);
+        std::vector<mutation> mutations;
+        for (int i = 0; i < 3; ++i) {
+            mutations.push_back(make_new_mutation(s));
+            mt->apply(mutations.back());
+        }
+        std::sort(mutations.begin(), mutations.end(), mutation_decorated_key_less_comparator());
+
+        cache_tracker tracker;
+        tracker.set_range_scans_probationary(utils::updateable_value<bool>(true));
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto& hot = mutations[1];
+        auto read_hot = [&] {
+            assert_that(cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(hot.decorated_key())))
+                .produces(hot)
+                .produces_end_of_stream();
+        };
+
+        read_hot();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().probationary_row_insertions, 0);
+
+        assert_that(cache.make_reader(s, semaphore.make_permit(), query::full_partition_range))
+            .produces(mutations[0])
+            .produces(mutations[1])
+            .produces(mutations[2])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_GT(tracker.get_stats().probationary_row_insertions, 0);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 3);
+
+        // The partitions populated by the scan are evicted first.
+        while (tracker.partitions() > 1) {
+            BOOST_REQUIRE(tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something);
+        }
+        auto misses = tracker.get_stats().partition_misses;
+        read_hot();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_misses, misses);
+    });
+}
+
 #ifndef SEASTAR_DEFAULT_ALLOCATOR // Depends on eviction, which is absent with the std allocator
 
+SEASTAR_TEST_CASE(test_partition_row_budget) {
+    return seastar::async([] {
+        simple_schema s;
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        memtable_snapshot_source underlying(s.schema());
+
+        const uint32_t budget = 10;
+        const uint32_t rows = 3 * budget;
+        auto pk = s.make_pkey(0);
+        mutation m(s.schema(), pk);
+        for (uint32_t i = 0; i < rows; ++i) {
+            s.add_row(m, s.make_ckey(i), "val");
+        }
+        underlying.apply(m);
+
+        cache_tracker tracker;
+        tracker.set_partition_row_budget(utils::updateable_value<uint32_t>(budget));
+        row_cache cache(s.schema(), snapshot_source([&] { return underlying(); }), tracker);
+
+        auto pr = dht::partition_range::make_singular(pk);
+        assert_that(cache.make_reader(s.schema(), semaphore.make_permit(), pr))
+            .produces(m)
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().rows_over_partition_budget, rows - budget);
+        BOOST_REQUIRE_GE(tracker.get_stats().probationary_row_insertions, rows - budget);
+
+        // The rows over the budget are evicted first.
+        for (uint32_t i = 0; i < rows - budget; ++i) {
+            BOOST_REQUIRE(tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something);
+        }
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+
+        auto range = s.make_ckey_range(0, budget - 1);
+        auto slice = partition_slice_builder(*s.schema()).with_range(range).build();
+        auto hits = tracker.get_stats().row_hits;
+        auto misses = tracker.get_stats().row_misses;
+        assert_that(cache.make_reader(s.schema(), semaphore.make_permit(), pr, slice))
+            .produces(m.sliced({range}))
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().row_hits - hits, budget);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().row_misses, misses);
+    });
+}
+
 SEASTAR_TEST_CASE(test_eviction_from_invalidated) {
     return seastar::async([] {
         auto s = make_schema();
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "message/dictionary_compressor.hh"
+#include "utils/alien_worker.hh"
+
+namespace {
+
+template <typename Buf>
+sstring linearize(const Buf& buf, size_t skip = 0) {
+    sstring ret;
+    auto append = [&] (const temporary_buffer<char>& b) {
+        auto n = std::min(skip, b.size());
+        ret.append(b.get() + n, b.size() - n);
+        skip -= n;
+    };
+    if (auto* b = std::get_if<temporary_buffer<char>>(&buf.bufs)) {
+        append(*b);
+    } else {
+        for (auto& b : std::get<std::vector<temporary_buffer<char>>>(buf.bufs)) {
+            append(b);
+        }
+    }
+    return ret;
+}
+
+rpc::snd_buf make_frame(const sstring& data) {
+    return rpc::snd_buf(temporary_buffer<char>(data.data(), data.size()));
+}
+
+// Compresses data on one side of a connection and decompresses it on the
+// other, like the RPC layer does, returning the size of the compressed frame.
+size_t round_trip(rpc::compressor& sender, rpc::compressor& receiver, const sstring& data) {
+    constexpr size_t head_space = 8;
+    auto compressed = sender.compress(head_space, make_frame(data));
+    auto frame = linearize(compressed, head_space);
+    BOOST_REQUIRE_EQUAL(frame.size() + head_space, compressed.size);
+    auto decompressed = receiver.decompress(rpc::rcv_buf(temporary_buffer<char>(frame.data(), frame.size())));
+    BOOST_REQUIRE_EQUAL(decompressed.size, data.size());
+    BOOST_REQUIRE(linearize(decompressed) == data);
+    return frame.size();
+}
+
+sstring make_row(int i) {
+    return format("{{\"keyspace\": \"ks\", \"table\": \"events\", \"pk\": {}, \"ck\": \"session-{}\", \"status\": \"{}\", \"ts\": {}}}",
+            i * 7919 % 100003, i % 97, i % 3 ? "delivered" : "pending", 1600000000000 + i * 13);
+}
+
+// Sends frames until the compressed frames shrink, which they do once
+// the dictionary trained in the background is used.
+void send_until_trained(rpc::compressor& sender, rpc::compressor& receiver) {
+    size_t before = 0;
+    for (int i = 0; i < 100; ++i) {
+        before += round_trip(sender, receiver, make_row(i));
+    }
+    for (int i = 1; i < 1000; ++i) {
+        size_t after = 0;
+        for (int j = 0; j < 100; ++j) {
+            after += round_trip(sender, receiver, make_row(i * 100 + j));
+        }
+        if (after < before * 3 / 4) {
+            return;
+        }
+        // Let the training finish.
+        seastar::sleep(std::chrono::milliseconds(1)).get();
+    }
+    BOOST_FAIL("no dictionary was trained");
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_dictionary_compressor_round_trip) {
+    utils::alien_worker worker(1, 0);
+    netw::dictionary_compressor_factory factory(worker);
+    auto sender = factory.make_compressor();
+    auto receiver = factory.make_compressor();
+
+    // Enough small frames to train a dictionary, which then has to be
+    // shipped to, and used by, the receiver.
+    send_until_trained(*sender, *receiver);
+
+    // Frames spanning many fragments, empty frames, and frames in the other
+    // direction of the same connection.
+    sstring large;
+    for (int i = 0; large.size() < 3 * rpc::snd_buf::chunk_size; ++i) {
+        large += make_row(i);
+    }
+    round_trip(*sender, *receiver, large);
+    round_trip(*sender, *receiver, "");
+    round_trip(*receiver, *sender, make_row(0));
+    factory.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_dictionary_compressor_shard_samples_budget) {
+    // Only room for the samples of one connection at a time.
+    netw::dictionary_compressor_factory::config cfg;
+    cfg.max_shard_samples_size = cfg.max_samples_size;
+    utils::alien_worker worker(1, 0);
+    netw::dictionary_compressor_factory factory(worker, cfg);
+    auto sender1 = factory.make_compressor();
+    auto receiver1 = factory.make_compressor();
+    auto sender2 = factory.make_compressor();
+    auto receiver2 = factory.make_compressor();
+
+    // The second connection gets to sample once the first one trained and
+    // released its samples.
+    send_until_trained(*sender1, *receiver1);
+    send_until_trained(*sender2, *receiver2);
+    factory.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_dictionary_compressor_negotiation) {
+    utils::alien_worker worker(1, 0);
+    netw::dictionary_compressor_factory factory(worker);
+    BOOST_REQUIRE_EQUAL(factory.supported(), netw::dictionary_compressor_factory::name);
+    BOOST_REQUIRE(factory.negotiate(netw::dictionary_compressor_factory::name, true));
+    BOOST_REQUIRE(!factory.negotiate("LZ4", true));
+}
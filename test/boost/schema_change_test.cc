@@ -886,3 +886,29 @@ SEASTAR_TEST_CASE(test_schema_get_reversed) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(test_schema_version_matches_full_digest_after_merges) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto check_version = [&] {
+            auto features = e.local_db().features().cluster_schema_features();
+            auto expected = db::schema_tables::calculate_schema_digest(service::get_storage_proxy(), features).get0();
+            BOOST_REQUIRE_EQUAL(e.local_db().get_version(), expected);
+        };
+
+        e.execute_cql("create keyspace tests with replication = { 'class' : 'SimpleStrategy', 'replication_factor' : 1 };").get();
+        check_version();
+        e.execute_cql("create keyspace tests2 with replication = { 'class' : 'SimpleStrategy', 'replication_factor' : 1 };").get();
+        e.execute_cql("create table tests.t1 (pk int primary key, v int);").get();
+        e.execute_cql("create table tests2.t2 (pk int primary key, v int);").get();
+        check_version();
+        e.execute_cql("alter table tests.t1 add v2 text;").get();
+        check_version();
+        e.execute_cql("create type tests2.ut (a int);").get();
+        e.execute_cql("drop table tests.t1;").get();
+        check_version();
+        e.execute_cql("drop keyspace tests2;").get();
+        check_version();
+        e.execute_cql("create table tests.t3 (pk int primary key, v int);").get();
+        check_version();
+    });
+}
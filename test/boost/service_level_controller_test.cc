@@ -8,6 +8,7 @@
 
 
 #include <boost/test/unit_test.hpp>
+#include <boost/algorithm/cxx11/none_of.hpp>
 #include <stdlib.h>
 #include <iostream>
 
@@ -18,8 +19,10 @@
 #include <algorithm>
 #include "service/qos/service_level_controller.hh"
 #include "service/qos/qos_configuration_change_subscriber.hh"
+#include "service/qos/request_admission_controller.hh"
 #include "auth/service.hh"
 #include "utils/overloaded_functor.hh"
+#include "exceptions/exceptions.hh"
 
 using namespace qos;
 struct add_op {
@@ -111,3 +114,58 @@ SEASTAR_THREAD_TEST_CASE(subscriber_simple) {
     BOOST_REQUIRE_EQUAL(ccss.ops, expected_result);
     sl_controller.stop().get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_request_admission_controller) {
+    utils::updateable_value_source<uint32_t> concurrency(1);
+    request_admission_controller ac{utils::updateable_value<uint32_t>(concurrency)};
+
+    // Service level a gets 1000/300 times the admissions of service level b.
+    service_level_options a_slo;
+    a_slo.shares = 1000;
+    service_level_options b_slo;
+    b_slo.shares = 300;
+
+    auto current = ac.admit("a", a_slo).get0();
+    std::vector<std::pair<char, future<request_admission_controller::permit>>> waiters;
+    for (int i = 0; i < 4; ++i) {
+        waiters.emplace_back('a', ac.admit("a", a_slo));
+    }
+    for (int i = 0; i < 2; ++i) {
+        waiters.emplace_back('b', ac.admit("b", b_slo));
+    }
+    BOOST_REQUIRE_EQUAL(ac.waiting(), 6);
+    BOOST_REQUIRE(boost::algorithm::none_of(waiters, [] (auto& w) { return w.second.available(); }));
+
+    // Releasing a request admits exactly one more, the next one by shares,
+    // not in arrival order.
+    sstring order;
+    std::vector<bool> admitted(waiters.size());
+    for (size_t i = 0; i < waiters.size(); ++i) {
+        current = {};
+        auto n = 0;
+        for (size_t j = 0; j < waiters.size(); ++j) {
+            if (!admitted[j] && waiters[j].second.available()) {
+                admitted[j] = true;
+                order += waiters[j].first;
+                current = waiters[j].second.get0();
+                ++n;
+            }
+        }
+        BOOST_REQUIRE_EQUAL(n, 1);
+    }
+    BOOST_REQUIRE_EQUAL(order, "baaaba");
+    BOOST_REQUIRE_EQUAL(ac.waiting(), 0);
+    BOOST_REQUIRE_EQUAL(ac.stats().queued, 6);
+    current = {};
+
+    // Service levels with a rate limit are rejected beyond it.
+    concurrency.set(0);
+    service_level_options limited_slo;
+    limited_slo.max_requests_per_second = uint64_t(2 * smp::count);
+    ac.admit("c", limited_slo).get();
+    ac.admit("c", limited_slo).get();
+    BOOST_REQUIRE_THROW(ac.admit("c", limited_slo).get(), exceptions::overloaded_exception);
+    BOOST_REQUIRE_EQUAL(ac.stats().rate_limited, 1);
+    // Others aren't affected.
+    ac.admit("a", a_slo).get();
+}
@@ -38,6 +38,7 @@
 #include "compaction/compaction_strategy_impl.hh"
 #include "compaction/date_tiered_compaction_strategy.hh"
 #include "compaction/time_window_compaction_strategy.hh"
+#include "compaction/purge_index.hh"
 #include "test/lib/mutation_assertions.hh"
 #include "counters.hh"
 #include "cell_locking.hh"
@@ -47,6 +48,7 @@
 #include "test/lib/flat_mutation_reader_assertions.hh"
 #include "test/lib/make_random_string.hh"
 #include "test/lib/sstable_run_based_compaction_strategy_for_tests.hh"
+#include "exceptions/exceptions.hh"
 #include "compatible_ring_position.hh"
 #include "mutation_compactor.hh"
 #include "service/priority_manager.hh"
@@ -54,6 +56,7 @@
 #include "mutation_writer/partition_based_splitting_writer.hh"
 #include "compaction/table_state.hh"
 #include "mutation_rebuilder.hh"
+#include "mutation_source_metadata.hh"
 
 #include <stdio.h>
 #include <ftw.h>
@@ -62,6 +65,8 @@
 #include <boost/algorithm/cxx11/all_of.hpp>
 #include <boost/algorithm/cxx11/is_sorted.hpp>
 #include <boost/icl/interval_map.hpp>
+#include <boost/range/adaptor/filtered.hpp>
+#include <boost/range/adaptor/transformed.hpp>
 #include "test/lib/test_services.hh"
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
@@ -1870,6 +1875,113 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(incremental_compaction_strategy_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        constexpr uint64_t mb = 1024 * 1024;
+        auto keys = token_generation_for_current_shard(20);
+        auto strategy_c = make_strategy_control_for_test(false);
+
+        auto test = [&] (std::map<sstring, sstring> options, std::vector<std::pair<size_t, uint64_t>> run_specs, size_t expected_runs) {
+            column_family_for_tests cf(env.manager());
+            auto close_cf = deferred_stop(cf);
+            auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, options);
+
+            // Creates runs of disjoint fragments of the given count and size.
+            unsigned generation = 1;
+            std::vector<std::vector<shared_sstable>> runs;
+            std::vector<shared_sstable> candidates;
+            for (auto& [fragments, fragment_size] : run_specs) {
+                auto run_id = utils::make_random_uuid();
+                auto& run = runs.emplace_back();
+                for (size_t i = 0; i < fragments; i++) {
+                    auto sst = env.make_sstable(cf.schema(), "", generation++, la, big);
+                    sstables::test(sst).set_values_for_leveled_strategy(fragment_size, 0, 0, keys[2 * i].first, keys[2 * i + 1].first);
+                    sstables::test(sst).set_run_identifier(run_id);
+                    column_family_test(cf).add_sstable(sst);
+                    run.push_back(sst);
+                    candidates.push_back(sst);
+                }
+            }
+
+            auto table_s = make_table_state_for_test(cf, env);
+            auto desc = cs.get_sstables_for_compaction(*table_s, *strategy_c, candidates);
+            auto run_ids = boost::copy_range<std::unordered_set<utils::UUID>>(desc.sstables
+                    | boost::adaptors::transformed(std::mem_fn(&sstable::run_identifier)));
+            BOOST_REQUIRE_EQUAL(run_ids.size(), expected_runs);
+            // Runs are compacted whole.
+            for (auto& run : runs) {
+                if (run_ids.contains(run.front()->run_identifier())) {
+                    for (auto& sst : run) {
+                        BOOST_REQUIRE(std::find(desc.sstables.begin(), desc.sstables.end(), sst) != desc.sstables.end());
+                    }
+                }
+            }
+            if (expected_runs) {
+                BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, 100 * mb);
+            }
+
+            // A run some of whose fragments are not candidates isn't compacted.
+            if (!runs.empty() && runs.front().size() > 1) {
+                auto partial = boost::copy_range<std::vector<shared_sstable>>(candidates
+                        | boost::adaptors::filtered([&] (const shared_sstable& sst) { return sst != runs.front().front(); }));
+                auto partial_desc = cs.get_sstables_for_compaction(*table_s, *strategy_c, partial);
+                for (auto& sst : partial_desc.sstables) {
+                    BOOST_REQUIRE(sst->run_identifier() != runs.front().front()->run_identifier());
+                }
+            }
+        };
+
+        std::map<sstring, sstring> options = {{"sstable_size_in_mb", "100"}};
+        // min_threshold runs of similar size, made of different numbers of fragments.
+        test(options, {{2, 100 * mb}, {4, 50 * mb}, {1, 200 * mb}, {2, 100 * mb}}, 4);
+        // Runs of different tiers aren't compacted together without a space amplification goal.
+        test(options, {{10, 100 * mb}, {6, 100 * mb}}, 0);
+
+        options.emplace("space_amplification_goal", "1.5");
+        // 1600MB in total is more than 1.5 times the 1000MB of the largest tier.
+        test(options, {{10, 100 * mb}, {6, 100 * mb}}, 2);
+        // 1400MB in total isn't.
+        test(options, {{10, 100 * mb}, {4, 100 * mb}}, 0);
+
+        BOOST_REQUIRE_THROW(sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, {{"space_amplification_goal", "1"}}),
+                exceptions::configuration_exception);
+        BOOST_REQUIRE_THROW(sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, {{"sstable_size_in_mb", "0"}}),
+                exceptions::configuration_exception);
+    });
+}
+
+SEASTAR_TEST_CASE(purge_index_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "purge_index_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+        auto keys = token_generation_for_current_shard(6);
+        unsigned generation = 1;
+        auto make_sst = [&] (size_t first, size_t last, api::timestamp_type min_timestamp) {
+            auto sst = env.make_sstable(s, "", generation++, la, big);
+            stats_metadata stats = {};
+            stats.min_timestamp = min_timestamp;
+            sstables::test(sst).set_values(keys[first].first, keys[last].first, stats);
+            return sst;
+        };
+
+        sstables::purge_index index;
+        BOOST_REQUIRE(index.empty());
+        BOOST_REQUIRE_EQUAL(index.min_timestamp(keys[0].second), api::max_timestamp);
+
+        index.add(*make_sst(0, 2, 10));
+        index.add(*make_sst(2, 3, 5));
+        index.add(*make_sst(1, 4, 20));
+        BOOST_REQUIRE(!index.empty());
+        BOOST_REQUIRE_EQUAL(index.min_timestamp(keys[0].second), 10);
+        BOOST_REQUIRE_EQUAL(index.min_timestamp(keys[1].second), 10);
+        BOOST_REQUIRE_EQUAL(index.min_timestamp(keys[2].second), 5);
+        BOOST_REQUIRE_EQUAL(index.min_timestamp(keys[3].second), 5);
+        BOOST_REQUIRE_EQUAL(index.min_timestamp(keys[4].second), 20);
+        BOOST_REQUIRE_EQUAL(index.min_timestamp(keys[5].second), api::max_timestamp);
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     return test_env::do_with_async([] (test_env& env) {
         auto tmp = tmpdir();
@@ -2137,6 +2249,74 @@ SEASTAR_TEST_CASE(sstable_cleanup_correctness_test) {
     });
 }
 
+SEASTAR_TEST_CASE(compaction_split_into_sub_ranges_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "compaction_split_into_sub_ranges_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        auto make_insert = [&] (const sstring& key) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::timestamp_type(0));
+            return m;
+        };
+
+        // Overlapping input sstables, each holding every 4th key.
+        auto keys = make_local_keys(10000, s);
+        std::vector<mutation> mutations;
+        std::vector<shared_sstable> ssts;
+        for (size_t i = 0; i < 4; i++) {
+            std::vector<mutation> muts;
+            for (size_t j = i; j < keys.size(); j += 4) {
+                muts.push_back(make_insert(keys[j]));
+            }
+            mutations.insert(mutations.end(), muts.begin(), muts.end());
+            ssts.push_back(make_sstable_containing(sst_gen, std::move(muts)));
+        }
+        std::sort(mutations.begin(), mutations.end(), [&] (const mutation& a, const mutation& b) {
+            return a.decorated_key().less_compare(*s, b.decorated_key());
+        });
+
+        BOOST_REQUIRE(split_into_sub_ranges(ssts, 1).empty());
+        auto sub_ranges = split_into_sub_ranges(ssts, 4);
+        BOOST_REQUIRE_GT(sub_ranges.size(), 1);
+        BOOST_REQUIRE_LE(sub_ranges.size(), 4);
+        BOOST_REQUIRE(!sub_ranges.front().start());
+        BOOST_REQUIRE(!sub_ranges.back().end());
+
+        column_family_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+        auto descriptor = sstables::compaction_descriptor(ssts, cf->get_sstable_set(), default_priority_class());
+        descriptor.sub_ranges = sub_ranges;
+        auto run_identifier = descriptor.run_identifier;
+        auto ret = compact_sstables(std::move(descriptor), *cf, sst_gen).get0();
+
+        // One sstable for each sub-range, together forming a single run.
+        BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), sub_ranges.size());
+        std::sort(ret.new_sstables.begin(), ret.new_sstables.end(), [&] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_first_decorated_key().less_compare(*s, b->get_first_decorated_key());
+        });
+        auto it = mutations.begin();
+        for (size_t i = 0; i < ret.new_sstables.size(); i++) {
+            auto& sst = ret.new_sstables[i];
+            BOOST_REQUIRE(sst->run_identifier() == run_identifier);
+            BOOST_REQUIRE(sub_ranges[i].contains(sst->get_first_decorated_key().token(), dht::token_comparator()));
+            BOOST_REQUIRE(sub_ranges[i].contains(sst->get_last_decorated_key().token(), dht::token_comparator()));
+            auto rd = assert_that(sstable_reader(sst, s, env.make_reader_permit()));
+            while (it != mutations.end() && !sst->get_last_decorated_key().less_compare(*s, it->decorated_key())) {
+                rd.produces(*it++);
+            }
+            rd.produces_end_of_stream();
+        }
+        BOOST_REQUIRE(it == mutations.end());
+    });
+}
+
 std::vector<mutation_fragment_v2> write_corrupt_sstable(test_env& env, sstable& sst, reader_permit permit,
         std::function<void(mutation_fragment_v2&&, bool)> write_to_secondary) {
     auto schema = sst.get_schema();
@@ -3928,6 +4108,37 @@ SEASTAR_TEST_CASE(test_twcs_partition_estimate) {
     });
 }
 
+SEASTAR_TEST_CASE(offstrategy_interposer_consumer_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        using namespace std::chrono;
+        auto window_size = duration_cast<microseconds>(hours(1)).count();
+        // One row in each of three consecutive windows.
+        auto m = mutation(s, ss.make_pkey(0));
+        for (auto i = 0; i < 3; i++) {
+            ss.add_row(m, ss.make_ckey(i), "val", i * window_size);
+        }
+        auto consumed_readers = [&] (sstables::compaction_strategy cs) {
+            size_t readers = 0;
+            auto consumer = cs.make_offstrategy_interposer_consumer(mutation_source_metadata{}, [&] (flat_mutation_reader_v2 rd) -> future<> {
+                readers++;
+                co_await rd.consume_pausable([] (mutation_fragment_v2) { return stop_iteration::no; });
+                co_await rd.close();
+            });
+            consumer(make_flat_mutation_reader_from_mutations_v2(s, env.make_reader_permit(), {m})).get();
+            return readers;
+        };
+
+        // Segregation is postponed to off-strategy compaction by default.
+        BOOST_REQUIRE_EQUAL(consumed_readers(sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {})), 1);
+        // TWCS segregates data by window as it is written.
+        auto twcs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window,
+                {{"compaction_window_size", "1"}, {"compaction_window_unit", "HOURS"}});
+        BOOST_REQUIRE_EQUAL(consumed_readers(twcs), 3);
+    });
+}
+
 SEASTAR_TEST_CASE(stcs_reshape_test) {
     return test_env::do_with_async([] (test_env& env) {
         simple_schema ss;
@@ -4469,6 +4680,157 @@ SEASTAR_TEST_CASE(test_twcs_single_key_reader_filtering) {
     });
 }
 
+// Partition tombstones in sstables which don't contain the queried partition must not prevent the
+// optimized TWCS single key reader from being used, and the sstables after the end of the queried
+// clustering range must be dropped without being checked.
+SEASTAR_TEST_CASE(test_twcs_single_key_reader_skips_windows) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto builder = schema_builder("tests", "twcs_single_key_reader_skips_windows")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type);
+        builder.set_compaction_strategy(sstables::compaction_strategy_type::time_window);
+        auto s = builder.build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)]() {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::sstable::version_types::md, big);
+        };
+
+        auto make_row = [&] (int32_t pk, int32_t ck) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), to_bytes("v"), int32_t(0), api::new_timestamp());
+            return m;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        replica::column_family::config cfg = column_family_test_config(env.manager(), env.semaphore());
+        replica::cf_stats cf_stats{0};
+        cfg.cf_stats = &cf_stats;
+        cfg.datadir = tmp.path().string();
+        auto tracker = make_lw_shared<cache_tracker>();
+        cell_locker_stats cl_stats;
+        replica::column_family cf(s, cfg, replica::column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf.mark_ready_for_writes();
+        cf.start();
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, {});
+        auto set = cs.make_sstable_set(s);
+
+        mutation deleted(s, partition_key::from_single_value(*s, int32_type->decompose(1)));
+        deleted.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+        set.insert(make_sstable_containing(sst_gen, {deleted}));
+        auto sst = make_sstable_containing(sst_gen, {make_row(0, 0)});
+        auto dkey = sst->get_first_decorated_key();
+        set.insert(std::move(sst));
+        for (auto ck : {1, 5, 6}) {
+            set.insert(make_sstable_containing(sst_gen, {make_row(0, ck)}));
+        }
+
+        reader_permit permit = env.make_reader_permit();
+        utils::estimated_histogram eh;
+        auto pr = dht::partition_range::make_singular(dkey);
+
+        auto slice = partition_slice_builder(*s)
+                    .with_range(query::clustering_range {
+                        query::clustering_range::bound { clustering_key_prefix::from_single_value(*s, int32_type->decompose(0)) },
+                        query::clustering_range::bound { clustering_key_prefix::from_single_value(*s, int32_type->decompose(1)) },
+                    }).build();
+
+        auto checked_by_ck = cf_stats.sstables_checked_by_clustering_filter;
+        auto surviving_after_ck = cf_stats.surviving_sstables_after_clustering_filter;
+
+        auto reader = set.create_single_key_sstable_reader(
+                &cf, s, permit, eh, pr, slice, default_priority_class(),
+                tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no,
+                ::mutation_reader::forwarding::no);
+        auto close_reader = deferred_close(reader);
+
+        unsigned rows = 0;
+        while (auto mf = reader().get0()) {
+            rows += mf->is_clustering_row();
+        }
+        BOOST_REQUIRE_EQUAL(rows, 2);
+
+        // The sstable with the partition tombstone (whose clustering range is the full range)
+        // and the ones with ck 0 and 1 are checked, and pass the clustering filter;
+        // the ones with ck 5 and 6 are after the end of the range.
+        // The standard path would have checked the 4 sstables containing partition 0.
+        BOOST_REQUIRE_EQUAL(cf_stats.sstables_checked_by_clustering_filter - checked_by_ck, 3);
+        BOOST_REQUIRE_EQUAL(cf_stats.surviving_sstables_after_clustering_filter - surviving_after_ck, 3);
+    });
+}
+
+// Single partition reads of non-TWCS tables must not read the sstables whose data is
+// all covered by a partition tombstone in a newer sstable.
+SEASTAR_TEST_CASE(test_single_key_reader_skips_sstables_covered_by_partition_tombstone) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "single_key_reader_skips_covered_sstables")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)]() {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::sstable::version_types::md, big);
+        };
+
+        auto pkey = partition_key::from_single_value(*s, int32_type->decompose(0));
+        auto make_row = [&] (int32_t ck) {
+            mutation m(s, pkey);
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), to_bytes("v"), int32_t(0), api::new_timestamp());
+            return m;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        replica::column_family::config cfg = column_family_test_config(env.manager(), env.semaphore());
+        replica::cf_stats cf_stats{0};
+        cfg.cf_stats = &cf_stats;
+        cfg.datadir = tmp.path().string();
+        auto tracker = make_lw_shared<cache_tracker>();
+        cell_locker_stats cl_stats;
+        replica::column_family cf(s, cfg, replica::column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf.mark_ready_for_writes();
+        cf.start();
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto set = cs.make_sstable_set(s);
+
+        set.insert(make_sstable_containing(sst_gen, {make_row(0)}));
+        set.insert(make_sstable_containing(sst_gen, {make_row(1)}));
+        mutation deleted(s, pkey);
+        deleted.partition().apply(tombstone(api::new_timestamp(), gc_clock::now()));
+        auto sst = make_sstable_containing(sst_gen, {deleted});
+        auto dkey = sst->get_first_decorated_key();
+        set.insert(std::move(sst));
+        set.insert(make_sstable_containing(sst_gen, {make_row(2)}));
+
+        reader_permit permit = env.make_reader_permit();
+        utils::estimated_histogram eh;
+        auto pr = dht::partition_range::make_singular(dkey);
+        auto slice = partition_slice_builder(*s).build();
+
+        auto reader = set.create_single_key_sstable_reader(
+                &cf, s, permit, eh, pr, slice, default_priority_class(),
+                tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no,
+                ::mutation_reader::forwarding::no);
+        auto close_reader = deferred_close(reader);
+
+        unsigned rows = 0;
+        bool has_partition_tombstone = false;
+        while (auto mf = reader().get0()) {
+            rows += mf->is_clustering_row();
+            if (mf->is_partition_start()) {
+                has_partition_tombstone = bool(mf->as_partition_start().partition_tombstone());
+            }
+        }
+        BOOST_REQUIRE_EQUAL(rows, 1);
+        BOOST_REQUIRE(has_partition_tombstone);
+        BOOST_REQUIRE_EQUAL(cf_stats.sstables_skipped_by_partition_tombstone, 2);
+    });
+}
+
 SEASTAR_TEST_CASE(max_ongoing_compaction_test) {
     return test_env::do_with_async([] (test_env& env) {
         BOOST_REQUIRE(smp::count == 1);
@@ -2920,6 +2920,36 @@ SEASTAR_TEST_CASE(test_sstable_origin) {
     });
 }
 
+SEASTAR_TEST_CASE(test_sstable_partition_key_bounds) {
+    return test_setup::do_with_tmp_directory([] (test_env& env, sstring tmpdir_path) {
+        simple_schema ss;
+        auto s = ss.schema();
+
+        // Sorted in the order of the keys, not of the ring.
+        auto pkeys = ss.make_pkeys(4);
+        boost::sort(pkeys, [less = partition_key::less_compare(*s)] (const dht::decorated_key& a, const dht::decorated_key& b) {
+            return less(a.key(), b.key());
+        });
+
+        std::vector<mutation> muts;
+        for (const auto& pk : {pkeys[1], pkeys[2]}) {
+            auto mut = mutation(s, pk);
+            ss.add_row(mut, ss.make_ckey(0), "val");
+            muts.push_back(std::move(mut));
+        }
+        boost::sort(muts, mutation_decorated_key_less_comparator{});
+        auto mr = make_flat_mutation_reader_from_mutations(s, env.make_reader_permit(), muts);
+        auto sst = make_sstable_easy(env, fs::path(tmpdir_path), std::move(mr), env.manager().configure_writer(), 1, sstable_version_types::me, 0);
+
+        BOOST_REQUIRE(!sst->partition_key_in_bounds(*s, pkeys[0].key()));
+        BOOST_REQUIRE(sst->partition_key_in_bounds(*s, pkeys[1].key()));
+        BOOST_REQUIRE(sst->partition_key_in_bounds(*s, pkeys[2].key()));
+        BOOST_REQUIRE(!sst->partition_key_in_bounds(*s, pkeys[3].key()));
+
+        return make_ready_future<>();
+    });
+}
+
 SEASTAR_TEST_CASE(compound_sstable_set_basic_test) {
     return test_env::do_with([] (test_env& env) {
         auto s = make_shared_schema({}, some_keyspace, some_column_family,
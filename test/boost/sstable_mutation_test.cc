@@ -12,6 +12,7 @@
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
 #include <seastar/util/closeable.hh>
+#include <seastar/util/defer.hh>
 
 #include "test/boost/sstable_test.hh"
 #include "sstables/key.hh"
@@ -34,6 +35,9 @@
 #include "test/lib/data_model.hh"
 #include "test/lib/random_utils.hh"
 #include "test/lib/log.hh"
+#include "sstables/sstable_segment.hh"
+#include "db/config.hh"
+#include <seastar/core/fstream.hh>
 
 #include <boost/range/algorithm/sort.hpp>
 
@@ -915,6 +919,221 @@ SEASTAR_TEST_CASE(test_has_partition_key) {
     });
 }
 
+SEASTAR_TEST_CASE(test_find_partitions) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            auto dir = tmpdir();
+            simple_schema ss;
+            auto s = ss.schema();
+
+            auto pkeys = ss.make_pkeys(8);
+            auto mt = make_lw_shared<memtable>(s);
+            // Store every other key, the rest must be reported as absent.
+            for (size_t i = 0; i < pkeys.size(); i += 2) {
+                mutation m(s, pkeys[i]);
+                ss.add_row(m, ss.make_ckey(0), "v");
+                mt->apply(std::move(m));
+            }
+
+            auto sst = env.make_sstable(s, dir.path().string(), 1 /* generation */, version, sstables::sstable::format_types::big);
+            write_memtable_to_sstable_for_test(*mt, sst).get();
+            sst->load().get();
+
+            auto ranges = sst->find_partitions(pkeys).get0();
+            BOOST_REQUIRE_EQUAL(ranges.size(), pkeys.size());
+            std::vector<sstables::sstable::disk_read_range> present;
+            for (size_t i = 0; i < pkeys.size(); ++i) {
+                auto hk = sstables::sstable::make_hashed_key(*s, pkeys[i].key());
+                BOOST_REQUIRE_EQUAL(bool(ranges[i]), sst->has_partition_key(hk, pkeys[i]).get0());
+                BOOST_REQUIRE_EQUAL(bool(ranges[i]), i % 2 == 0);
+                if (ranges[i]) {
+                    BOOST_REQUIRE(bool(*ranges[i]));
+                    if (!present.empty()) {
+                        BOOST_REQUIRE_EQUAL(present.back().end, ranges[i]->start);
+                    }
+                    present.push_back(*ranges[i]);
+                }
+            }
+            BOOST_REQUIRE_EQUAL(present.back().end, sst->data_size());
+
+            // Partitions are adjacent, so they coalesce into a single read.
+            auto coalesced = sstables::sstable::coalesce_read_ranges(present, 0);
+            BOOST_REQUIRE_EQUAL(coalesced.size(), 1);
+            BOOST_REQUIRE_EQUAL(coalesced.front().start, present.front().start);
+            BOOST_REQUIRE_EQUAL(coalesced.front().end, present.back().end);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_unselected_column_values_are_not_read) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            auto dir = tmpdir();
+            auto s = schema_builder("ks", "cf")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("s1", utf8_type, column_kind::static_column)
+                .with_column("v1", utf8_type)
+                .with_column("v2", utf8_type)
+                .build();
+            auto& s1 = *s->get_column_definition("s1");
+            auto& v1 = *s->get_column_definition("v1");
+            auto& v2 = *s->get_column_definition("v2");
+
+            auto pk = partition_key::from_single_value(*s, int32_type->decompose(0));
+            auto ck = clustering_key::from_single_value(*s, int32_type->decompose(0));
+            mutation m(s, pk);
+            m.set_static_cell("s1", data_value(make_random_string(1024)), 1);
+            m.set_clustered_cell(ck, "v1", data_value(sstring("v1")), 1);
+            m.set_clustered_cell(ck, "v2", data_value(make_random_string(1024)), 1);
+            auto mt = make_lw_shared<memtable>(s);
+            mt->apply(m);
+            auto sst = make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer(), 1, version);
+
+            auto read = [&] (const query::partition_slice& slice) {
+                auto rd = sst->make_reader(s, env.make_reader_permit(), query::full_partition_range, slice);
+                auto close_rd = deferred_close(rd);
+                auto mo = read_mutation_from_flat_mutation_reader(rd).get0();
+                BOOST_REQUIRE(mo);
+                return std::move(*mo);
+            };
+
+            // Reads which may populate the cache see whole rows.
+            auto cached_slice = partition_slice_builder(*s).with_regular_column("v1").with_no_static_columns().build();
+            BOOST_REQUIRE_EQUAL(read(cached_slice), m);
+
+            auto slice = partition_slice_builder(*s)
+                .with_regular_column("v1")
+                .with_no_static_columns()
+                .with_option<query::partition_slice::option::bypass_cache>()
+                .build();
+            auto res = read(slice);
+            auto row = res.partition().find_row(*s, ck);
+            BOOST_REQUIRE(row);
+
+            auto selected = row->find_cell(v1.id)->as_atomic_cell(v1);
+            BOOST_REQUIRE(selected.value() == managed_bytes(to_bytes("v1")));
+
+            // Unselected cells are kept, so that row liveness is preserved, but without values.
+            auto unselected = row->find_cell(v2.id)->as_atomic_cell(v2);
+            BOOST_REQUIRE(unselected.is_live());
+            BOOST_REQUIRE(unselected.value().empty());
+            auto static_cell = res.partition().static_row().get().find_cell(s1.id)->as_atomic_cell(s1);
+            BOOST_REQUIRE(static_cell.is_live());
+            BOOST_REQUIRE(static_cell.value().empty());
+        }
+    });
+}
+
+namespace {
+
+// Writes the components into files of the sstable of the given generation.
+class component_file_writer : public sstables::component_consumer {
+    sstring _dir;
+    schema_ptr _schema;
+    sstable::version_types _version;
+    int64_t _generation;
+    std::optional<output_stream<char>> _out;
+public:
+    component_file_writer(sstring dir, schema_ptr s, sstable::version_types version, int64_t generation)
+        : _dir(std::move(dir)), _schema(std::move(s)), _version(version), _generation(generation)
+    { }
+
+    virtual future<> start_component(sstring name) override {
+        return seastar::async([this, name = std::move(name)] {
+            close().get();
+            auto path = sstable::filename(_dir, _schema->ks_name(), _schema->cf_name(), _version, _generation, sstable::format_types::big, name);
+            auto f = open_file_dma(path, open_flags::wo | open_flags::create | open_flags::truncate).get0();
+            _out = make_file_output_stream(std::move(f)).get0();
+        });
+    }
+
+    virtual future<> consume(temporary_buffer<char> data) override {
+        return _out->write(data.get(), data.size());
+    }
+
+    future<> close() {
+        if (!_out) {
+            return make_ready_future<>();
+        }
+        return _out->close().then([this] {
+            _out.reset();
+        });
+    }
+};
+
+}
+
+SEASTAR_TEST_CASE(test_sstable_segment) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            auto dir = tmpdir();
+            simple_schema ss;
+            auto s = ss.schema();
+            auto mt = make_lw_shared<memtable>(s);
+            std::vector<mutation> muts;
+            for (auto& pk : ss.make_pkeys(32)) {
+                mutation m(s, pk);
+                for (int i = 0; i < 20; ++i) {
+                    ss.add_row(m, ss.make_ckey(i), make_random_string(32));
+                }
+                mt->apply(m);
+                muts.push_back(std::move(m));
+            }
+            // Small blocks, so that partitions have promoted indexes.
+            auto cfg = env.manager().configure_writer();
+            cfg.promoted_index_block_size = 64;
+            auto sst = make_sstable_easy(env, dir.path(), mt, cfg, 1, version, muts.size());
+            BOOST_REQUIRE(sstables::sstable_segment::is_supported(*sst));
+
+            auto& pc = default_priority_class();
+            auto range = dht::token_range::make({muts[8].token(), true}, {muts[20].token(), true});
+            auto segment = sstables::sstable_segment::find(sst, range, pc).get0();
+            BOOST_REQUIRE(segment);
+            BOOST_REQUIRE_GT(segment->data_start(), 0);
+
+            component_file_writer out(dir.path().native(), s, version, 2);
+            segment->produce(out, env.make_reader_permit(), pc).get();
+            out.close().get();
+
+            auto seg_sst = env.reusable_sst(s, dir.path().native(), 2, version).get0();
+            BOOST_REQUIRE_LT(seg_sst->data_size(), sst->data_size());
+            BOOST_REQUIRE(seg_sst->get_first_decorated_key().equal(*s, muts[8].decorated_key()));
+            BOOST_REQUIRE(seg_sst->get_last_decorated_key().equal(*s, muts[20].decorated_key()));
+
+            // The sharding metadata covers only the segment's part of the
+            // original's token range.
+            auto raw_seg_sst = env.make_sstable(s, dir.path().native(), 2, version);
+            sstables::test(raw_seg_sst).read_toc().get();
+            sstables::test(raw_seg_sst).read_scylla_metadata().get();
+            auto* sm = raw_seg_sst->get_scylla_metadata()->data.get<scylla_metadata_type::Sharding, sharding_metadata>();
+            BOOST_REQUIRE(sm && !sm->token_ranges.elements.empty());
+            for (auto& r : sm->token_ranges.elements) {
+                BOOST_REQUIRE(range.contains(dht::token(dht::token::kind::key, bytes_view(r.left.token)), dht::token_comparator()));
+                BOOST_REQUIRE(range.contains(dht::token(dht::token::kind::key, bytes_view(r.right.token)), dht::token_comparator()));
+            }
+
+            auto rd = assert_that(seg_sst->make_reader(s, env.make_reader_permit(), query::full_partition_range, s->full_slice()));
+            for (size_t i = 8; i <= 20; ++i) {
+                rd.produces(muts[i]);
+            }
+            rd.produces_end_of_stream();
+
+            // Slicing reads go through the copied promoted index.
+            auto ck_range = ss.make_ckey_range(5, 7);
+            auto slice = partition_slice_builder(*s).with_range(ck_range).build();
+            auto pr = dht::partition_range::make_singular(muts[12].decorated_key());
+            assert_that(seg_sst->make_reader(s, env.make_reader_permit(), pr, slice))
+                .produces(muts[12].sliced({ck_range}))
+                .produces_end_of_stream();
+
+            // No partitions within the range.
+            auto before_all = dht::token_range::make_ending_with({muts[0].token(), false});
+            BOOST_REQUIRE(!sstables::sstable_segment::find(sst, before_all, pc).get0());
+        }
+    });
+}
+
 static std::unique_ptr<index_reader> get_index_reader(shared_sstable sst, reader_permit permit) {
     return std::make_unique<index_reader>(sst, std::move(permit), default_priority_class(),
                                           tracing::trace_state_ptr(), use_caching::yes);
@@ -1324,6 +1543,53 @@ SEASTAR_TEST_CASE(test_key_count_estimation) {
     });
 }
 
+SEASTAR_TEST_CASE(test_estimated_counts_for_range) {
+    return test_env::do_with_async([] (test_env& env) {
+        for (const auto version : writable_sstable_versions) {
+            simple_schema ss;
+            auto s = ss.schema();
+
+            int count = 1'000;
+            std::vector<dht::decorated_key> pks = ss.make_pkeys(count);
+            std::vector<mutation> muts;
+            for (auto pk : pks) {
+                mutation m(ss.schema(), pk);
+                ss.add_row(m, ss.make_ckey(1), "v");
+                ss.add_row(m, ss.make_ckey(2), "v");
+                muts.push_back(std::move(m));
+            }
+
+            tmpdir dir;
+            shared_sstable sst = make_sstable(env, s, dir.path().string(), muts, env.manager().configure_writer(), version);
+
+            {
+                auto counts = sst->estimated_counts_for_range(dht::token_range::make_open_ended_both_sides());
+                BOOST_REQUIRE(counts);
+                BOOST_REQUIRE_EQUAL(counts->partitions, count);
+                BOOST_REQUIRE_EQUAL(counts->rows, 2 * count);
+            }
+
+            {
+                // Splitting the ring in two doesn't lose or add anything.
+                auto split = pks[count / 2].token();
+                auto left = sst->estimated_counts_for_range(dht::token_range::make_ending_with({split, true}));
+                auto right = sst->estimated_counts_for_range(dht::token_range::make_starting_with({split, false}));
+                BOOST_REQUIRE(left && right);
+                BOOST_REQUIRE_LE(std::abs(int64_t(left->partitions + right->partitions) - count), 1);
+                BOOST_REQUIRE_LE(std::abs(int64_t(left->rows + right->rows) - 2 * count), 1);
+                BOOST_REQUIRE_LE(std::abs(int64_t(left->partitions) - count / 2), count / 10);
+            }
+
+            {
+                auto r = dht::token_range::make(pks[0].token(), pks[0].token());
+                auto counts = sst->estimated_counts_for_range(r);
+                BOOST_REQUIRE(counts);
+                BOOST_REQUIRE_LE(counts->partitions, 1);
+            }
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_large_index_pages_do_not_cause_large_allocations) {
   return test_env::do_with_async([] (test_env& env) {
     // We create a sequence of partitions such that first we have a partition with a very long key, then
@@ -1584,3 +1850,179 @@ SEASTAR_TEST_CASE(test_static_compact_tables_are_read) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_point_reads_reuse_index_readers) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto pkeys = ss.make_pkeys(4);
+
+        auto mt = make_lw_shared<memtable>(s);
+        std::vector<mutation> muts;
+        for (const auto& pk : pkeys) {
+            mutation m(s, pk);
+            ss.add_row(m, ss.make_ckey(0), "v");
+            mt->apply(m);
+            muts.push_back(std::move(m));
+        }
+
+        tmpdir dir;
+        auto sst = make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer());
+        auto ms = sst->as_mutation_source();
+
+        const auto reuses_before = sstables_stats::get_shard_stats().index_reader_reuses;
+        for (unsigned round = 0; round < 2; ++round) {
+            for (const auto& m : muts) {
+                auto pr = dht::partition_range::make_singular(m.decorated_key());
+                assert_that(ms.make_reader(s, env.make_reader_permit(), pr, s->full_slice()))
+                    .produces(m)
+                    .produces_end_of_stream();
+            }
+        }
+        // Every read but the first one should get the index reader recycled by the one before it.
+        BOOST_REQUIRE_GE(sstables_stats::get_shard_stats().index_reader_reuses - reuses_before, 2 * muts.size() - 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_skipping_rows_shadowed_by_recent_tombstones) {
+    return test_env::do_with_async([] (test_env& env) {
+        test_db_config.sstable_skip_shadowed_rows.set(true);
+        auto reset_config = defer([] { test_db_config.sstable_skip_shadowed_rows.set(false); });
+
+        simple_schema ss;
+        auto s = ss.schema();
+        auto pkeys = ss.make_pkeys(3);
+        const auto rows_timestamp = api::timestamp_type(1);
+        const auto tomb = tombstone(api::timestamp_type(10), gc_clock::now());
+
+        // Rows 0..9, with 3..6 deleted by a range tombstone.
+        mutation m1(s, pkeys[0]);
+        for (uint32_t ck = 0; ck < 10; ++ck) {
+            ss.add_row(m1, ss.make_ckey(ck), "v", rows_timestamp);
+        }
+        auto deleted = query::clustering_range::make(ss.make_ckey(3), ss.make_ckey(6));
+        ss.delete_range(m1, deleted, tomb);
+
+        // A deleted partition.
+        mutation m2(s, pkeys[1]);
+        for (uint32_t ck = 0; ck < 10; ++ck) {
+            ss.add_row(m2, ss.make_ckey(ck), "v", rows_timestamp);
+        }
+        m2.partition().apply(tomb);
+
+        // A partition without tombstones.
+        mutation m3(s, pkeys[2]);
+        for (uint32_t ck = 0; ck < 10; ++ck) {
+            ss.add_row(m3, ss.make_ckey(ck), "v", rows_timestamp);
+        }
+
+        auto mt = make_lw_shared<memtable>(s);
+        mt->apply(m1);
+        mt->apply(m2);
+        mt->apply(m3);
+
+        tmpdir dir;
+        auto sst = make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer());
+
+        auto expected1 = mutation(s, pkeys[0]);
+        for (uint32_t ck = 0; ck < 10; ++ck) {
+            if (ck < 3 || ck > 6) {
+                ss.add_row(expected1, ss.make_ckey(ck), "v", rows_timestamp);
+            }
+        }
+        ss.delete_range(expected1, deleted, tomb);
+        auto expected2 = mutation(s, pkeys[1]);
+        expected2.partition().apply(tomb);
+
+        const auto& stats = sstables_stats::get_shard_stats();
+        const auto row_skips_before = stats.shadowed_row_skips;
+        const auto partition_skips_before = stats.shadowed_partition_skips;
+
+        std::vector<mutation> expected{expected1, expected2, m3};
+        boost::sort(expected, mutation_decorated_key_less_comparator{});
+        auto rd = assert_that(sst->as_mutation_source().make_reader(s, env.make_reader_permit()));
+        for (const auto& m : expected) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+
+        BOOST_REQUIRE_EQUAL(stats.shadowed_row_skips - row_skips_before, 4);
+        BOOST_REQUIRE_EQUAL(stats.shadowed_partition_skips - partition_skips_before, 1);
+
+        // Reads which don't skip return all of the data.
+        test_db_config.sstable_skip_shadowed_rows.set(false);
+        std::vector<mutation> all{m1, m2, m3};
+        boost::sort(all, mutation_decorated_key_less_comparator{});
+        auto rd_all = assert_that(sst->as_mutation_source().make_reader(s, env.make_reader_permit()));
+        for (const auto& m : all) {
+            rd_all.produces(m);
+        }
+        rd_all.produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_single_row_reads_finish_at_the_row) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto pkeys = ss.make_pkeys(3);
+
+        auto mt = make_lw_shared<memtable>(s);
+        std::vector<mutation> muts;
+        for (const auto& pk : pkeys) {
+            mutation m(s, pk);
+            for (uint32_t ck = 0; ck < 10; ++ck) {
+                ss.add_row(m, ss.make_ckey(ck), "v");
+            }
+            mt->apply(m);
+            muts.push_back(std::move(m));
+        }
+        boost::sort(muts, mutation_decorated_key_less_comparator{});
+
+        tmpdir dir;
+        auto sst = make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer());
+
+        const auto& stats = sstables_stats::get_shard_stats();
+        const auto ranges = query::clustering_row_ranges{query::clustering_range::make_singular(ss.make_ckey(5))};
+        auto slice = partition_slice_builder(*s).with_ranges(ranges).build();
+
+        // A read by full primary key.
+        {
+            const auto finishes_before = stats.last_row_finishes;
+            auto pr = dht::partition_range::make_singular(muts[1].decorated_key());
+            auto rd = assert_that(sst->as_mutation_source().make_reader(s, env.make_reader_permit(), pr, slice));
+            rd.produces(muts[1], ranges);
+            rd.produces_end_of_stream();
+            BOOST_REQUIRE_EQUAL(stats.last_row_finishes - finishes_before, 1);
+        }
+
+        // A scan moves on to the next partition after the row.
+        {
+            const auto finishes_before = stats.last_row_finishes;
+            auto rd = assert_that(sst->as_mutation_source().make_reader(s, env.make_reader_permit(), query::full_partition_range, slice));
+            for (const auto& m : muts) {
+                rd.produces(m, ranges);
+            }
+            rd.produces_end_of_stream();
+            BOOST_REQUIRE_EQUAL(stats.last_row_finishes - finishes_before, muts.size());
+        }
+
+        // A range tombstone spanning the row has to be closed after it, which
+        // takes the regular path.
+        {
+            mutation m(s, pkeys[0]);
+            ss.add_row(m, ss.make_ckey(5), "v");
+            ss.delete_range(m, query::clustering_range::make(ss.make_ckey(3), ss.make_ckey(7)), ss.new_tombstone());
+            auto mt = make_lw_shared<memtable>(s);
+            mt->apply(m);
+            auto sst = make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer(), 2);
+
+            const auto finishes_before = stats.last_row_finishes;
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            auto rd = assert_that(sst->as_mutation_source().make_reader(s, env.make_reader_permit(), pr, slice));
+            rd.produces(m, ranges);
+            rd.produces_end_of_stream();
+            BOOST_REQUIRE_EQUAL(stats.last_row_finishes - finishes_before, 0);
+        }
+    });
+}
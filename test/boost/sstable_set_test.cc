@@ -13,6 +13,8 @@
 #include "sstables/sstable_set.hh"
 #include "sstables/sstables.hh"
 #include "test/lib/simple_schema.hh"
+#include "test/lib/flat_mutation_reader_assertions.hh"
+#include "service/priority_manager.hh"
 
 static sstables::sstable_set make_sstable_set(schema_ptr schema, lw_shared_ptr<sstable_list> all = {}, bool use_level_metadata = true) {
     return sstables::sstable_set(std::make_unique<partitioned_sstable_set>(schema, std::move(all), use_level_metadata), schema);
@@ -80,3 +82,63 @@ SEASTAR_TEST_CASE(test_time_series_sstable_set_read_modify_write) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(test_range_reader_reads_run_sequentially) {
+    return test_setup::do_with_tmp_directory([] (test_env& env, sstring tmpdir_path) {
+        simple_schema ss;
+        auto s = ss.schema();
+        fs::path tmp(tmpdir_path);
+        int gen = 1;
+
+        auto pkeys = ss.make_pkeys(6);
+        std::vector<mutation> muts;
+        for (auto& pk : pkeys) {
+            muts.emplace_back(s, pk);
+            ss.add_row(muts.back(), ss.make_ckey(0), "val");
+        }
+        auto make_sstable = [&] (std::vector<mutation> ms, utils::UUID run_id) {
+            sstable_writer_config cfg = env.manager().configure_writer("");
+            cfg.run_identifier = run_id;
+            return make_sstable_easy(env, tmp, make_flat_mutation_reader_from_mutations(s, env.make_reader_permit(), std::move(ms)), cfg, gen++);
+        };
+
+        // A run of three sstables, and an sstable overlapping its second one.
+        auto run_id = utils::make_random_uuid();
+        auto overlapping = mutation(s, pkeys[2]);
+        ss.add_row(overlapping, ss.make_ckey(1), "other");
+        auto all = make_lw_shared<sstable_list>({
+            make_sstable({muts[0], muts[1]}, run_id),
+            make_sstable({muts[2], muts[3]}, run_id),
+            make_sstable({muts[4], muts[5]}, run_id),
+            make_sstable({overlapping}, utils::make_random_uuid()),
+        });
+        auto set = make_lw_shared<sstables::sstable_set>(make_sstable_set(s, std::move(all), false));
+
+        auto read = [&] (const dht::partition_range& pr) {
+            return set->make_range_sstable_reader(s, env.make_reader_permit(), pr, s->full_slice(),
+                    service::get_local_sstable_query_read_priority(), nullptr,
+                    ::streamed_mutation::forwarding::no, ::mutation_reader::forwarding::yes);
+        };
+
+        assert_that(read(query::full_partition_range))
+            .produces(muts[0])
+            .produces(muts[1])
+            .produces(muts[2] + overlapping)
+            .produces(muts[3])
+            .produces(muts[4])
+            .produces(muts[5])
+            .produces_end_of_stream();
+
+        auto pr1 = dht::partition_range::make(dht::ring_position(pkeys[1]), dht::ring_position(pkeys[2]));
+        auto pr2 = dht::partition_range::make_singular(pkeys[5]);
+        assert_that(read(pr1))
+            .produces(muts[1])
+            .produces(muts[2] + overlapping)
+            .produces_end_of_stream()
+            .fast_forward_to(pr2)
+            .produces(muts[5])
+            .produces_end_of_stream();
+
+        return make_ready_future<>();
+    });
+}
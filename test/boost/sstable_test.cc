@@ -29,6 +29,7 @@
 #include "test/lib/test_services.hh"
 #include "cell_locking.hh"
 #include "sstables/sstable_mutation_reader.hh"
+#include "utils/alien_worker.hh"
 
 #include <boost/range/combine.hpp>
 
@@ -832,3 +833,38 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
         expect_eof(in);
     });
 }
+
+SEASTAR_TEST_CASE(test_compressed_stream_with_trained_dictionary) {
+    return seastar::async([] {
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+        });
+
+        // More than the chunks held back for training, so that some are
+        // written after the dictionary is trained.
+        sstring data;
+        for (int i = 0; data.size() < 1024 * 1024; ++i) {
+            data += format("partition {} clustering {} value {} ", i, i % 100, i * 7919 % 1000);
+        }
+
+        utils::alien_worker trainer(1, 0);
+        sstables::compression c;
+        auto os = make_file_output_stream(f, file_output_stream_options()).get0();
+        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp, &trainer);
+        out.write(data.data(), data.size()).get();
+        out.close().get();
+        BOOST_REQUIRE(c.dictionary);
+
+        c.update(seastar::file_size(file_path).get0());
+        f = open_file_dma(file_path, open_flags::ro).get0();
+        auto in = make_compressed_file_m_format_input_stream(f, &c, 0, data.size(), file_input_stream_options());
+        auto b = in.read_exactly(data.size()).get0();
+        BOOST_REQUIRE(std::string_view(b.get(), b.size()) == std::string_view(data));
+        in.close().get();
+    });
+}
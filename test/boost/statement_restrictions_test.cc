@@ -344,6 +344,11 @@ SEASTAR_TEST_CASE(slice_single_column_mixed_order) {
                     singular({I(3), I(1)}), singular({I(3), I(2)}),
                     singular({I(2), I(1)}), singular({I(2), I(2)}),
                     singular({I(1), I(1)}), singular({I(1), I(2)})}));
+        BOOST_CHECK_EQUAL(slice_parse("a in (1,2) and b in (2,1) and c > 5", e), (std::vector{
+                    left_closed_right_open({I(2), I(1)}, {I(2), I(1), I(5)}),
+                    left_closed_right_open({I(2), I(2)}, {I(2), I(2), I(5)}),
+                    left_closed_right_open({I(1), I(1)}, {I(1), I(1), I(5)}),
+                    left_closed_right_open({I(1), I(2)}, {I(1), I(2), I(5)})}));
     });
 }
 
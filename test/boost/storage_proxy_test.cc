@@ -14,7 +14,9 @@
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/result_set_assertions.hh"
+#include "test/lib/cql_assertions.hh"
 #include "service/storage_proxy.hh"
+#include "db/config.hh"
 #include "query_ranges_to_vnodes.hh"
 #include "partition_slice_builder.hh"
 #include "schema_builder.hh"
@@ -104,3 +106,61 @@ SEASTAR_TEST_CASE(test_get_restricted_ranges) {
         });
     });
 }
+
+SEASTAR_TEST_CASE(test_unlogged_batch_across_shards) {
+    // Batched and unbatched cross-shard writes apply the same mutations.
+    for (bool batching : {true, false}) {
+        cql_test_config cfg;
+        cfg.db_config->enable_cross_shard_write_batching(batching);
+        co_await do_with_cql_env_thread([] (cql_test_env& e) {
+            e.execute_cql("CREATE TABLE ks.cf (pk int PRIMARY KEY, v int)").get();
+            sstring batch = "BEGIN UNLOGGED BATCH ";
+            for (int i = 0; i < 300; ++i) {
+                batch += format("INSERT INTO ks.cf (pk, v) VALUES ({}, {}); ", i, i);
+            }
+            e.execute_cql(batch + "APPLY BATCH").get();
+
+            for (int i : {0, 150, 299}) {
+                auto msg = e.execute_cql(format("SELECT v FROM ks.cf WHERE pk = {}", i)).get0();
+                assert_that(msg).is_rows().with_rows({{int32_type->decompose(i)}});
+            }
+            auto msg = e.execute_cql("SELECT count(*) FROM ks.cf").get0();
+            assert_that(msg).is_rows().with_rows({{long_type->decompose(int64_t(300))}});
+        }, cfg);
+    }
+}
+
+SEASTAR_TEST_CASE(test_range_read_concurrency_for_next_page) {
+    auto next = [] (int concurrency, uint64_t rows_needed, uint64_t rows_returned, uint64_t partitions_needed = 1000, uint64_t partitions_returned = 10) {
+        return service::storage_proxy::range_read_concurrency_for_next_page(concurrency, rows_needed, rows_returned, partitions_needed, partitions_returned);
+    };
+    // Exactly filled, or short: keep the concurrency.
+    BOOST_REQUIRE_EQUAL(next(8, 100, 100), 8);
+    BOOST_REQUIRE_EQUAL(next(8, 100, 50), 8);
+    // Reading 64 ranges returned 4 times the rows needed: 16 would have been enough.
+    BOOST_REQUIRE_EQUAL(next(64, 100, 400), 16);
+    // Rounded up, and never below one range.
+    BOOST_REQUIRE_EQUAL(next(64, 100, 399), 17);
+    BOOST_REQUIRE_EQUAL(next(4, 1, 1000), 1);
+    // The partition limit counts as well, reaching either fills the page.
+    BOOST_REQUIRE_EQUAL(next(64, 100, 400, 10, 20), 16);
+    BOOST_REQUIRE_EQUAL(next(64, 100, 200, 10, 40), 16);
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_demote_suspected_replicas) {
+    auto a = gms::inet_address("127.0.0.1"), b = gms::inet_address("127.0.0.2"), c = gms::inet_address("127.0.0.3"), d = gms::inet_address("127.0.0.4");
+    auto demote = [] (inet_address_vector_replica_set eps, std::unordered_set<gms::inet_address> suspected) {
+        service::storage_proxy::demote_suspected_replicas(eps, [&] (gms::inet_address ep) {
+            return suspected.contains(ep);
+        });
+        return eps;
+    };
+    BOOST_REQUIRE(demote({a, b, c, d}, {}) == inet_address_vector_replica_set({a, b, c, d}));
+    // Suspected replicas go last, both groups keep their order, e.g. by proximity.
+    BOOST_REQUIRE(demote({a, b, c, d}, {a}) == inet_address_vector_replica_set({b, c, d, a}));
+    BOOST_REQUIRE(demote({a, b, c, d}, {c, a}) == inet_address_vector_replica_set({b, d, a, c}));
+    // They are kept, for reads which need them.
+    BOOST_REQUIRE(demote({a, b, c}, {a, b, c}) == inet_address_vector_replica_set({a, b, c}));
+    return make_ready_future<>();
+}
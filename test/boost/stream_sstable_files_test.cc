@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "streaming/stream_manager.hh"
+#include "schema_builder.hh"
+
+static schema_ptr make_schema() {
+    return schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("v", int32_type)
+            .build();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_sstable_files_accepted_with_same_schema_and_sharding) {
+    auto s = make_schema();
+    auto& sharder = s->get_sharder();
+    BOOST_REQUIRE(!streaming::sstable_files_decline_reason(*s, s->version(), sharder.shard_count(), sharder.sharding_ignore_msb()));
+}
+
+// The receiver declines these up front, before the sender sends any data.
+SEASTAR_THREAD_TEST_CASE(test_sstable_files_declined_up_front) {
+    auto s = make_schema();
+    auto& sharder = s->get_sharder();
+
+    // Written with another version of the schema.
+    auto altered = schema_builder(s).with_column("w", int32_type).build();
+    BOOST_REQUIRE(streaming::sstable_files_decline_reason(*altered, s->version(), sharder.shard_count(), sharder.sharding_ignore_msb()));
+
+    // Owned by a single shard of a node with another sharding, which may be several shards here.
+    BOOST_REQUIRE(streaming::sstable_files_decline_reason(*s, s->version(), sharder.shard_count() + 1, sharder.sharding_ignore_msb()));
+    BOOST_REQUIRE(streaming::sstable_files_decline_reason(*s, s->version(), sharder.shard_count(), sharder.sharding_ignore_msb() + 1));
+}
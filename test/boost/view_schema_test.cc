@@ -3161,3 +3161,38 @@ SEASTAR_TEST_CASE(test_mv_allow_some_column_drops) {
         BOOST_REQUIRE_THROW(e.execute_cql("alter table cf2 drop d").get(), exceptions::invalid_request_exception);
     });
 }
+
+SEASTAR_TEST_CASE(test_view_update_skips_read_for_new_partitions) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (k int, c int, v int, PRIMARY KEY (k, c))").get();
+        e.execute_cql("CREATE MATERIALIZED VIEW mv AS SELECT * FROM t "
+                      "WHERE k IS NOT NULL AND c IS NOT NULL AND v IS NOT NULL PRIMARY KEY (v, k, c)").get();
+
+        auto reads_skipped = [&] {
+            return e.db().map_reduce0([] (replica::database& local_db) {
+                return local_db.cf_stats()->view_update_reads_skipped;
+            }, int64_t(0), std::plus<int64_t>()).get0();
+        };
+
+        // A new partition needs no read.
+        e.execute_cql("INSERT INTO t (k, c, v) VALUES (1, 1, 10)").get();
+        BOOST_REQUIRE_EQUAL(reads_skipped(), 1);
+
+        // An existing one does, so that the old view row is deleted.
+        e.execute_cql("UPDATE t SET v = 20 WHERE k = 1 AND c = 1").get();
+        BOOST_REQUIRE_EQUAL(reads_skipped(), 1);
+        eventually([&] {
+            auto msg = e.execute_cql("SELECT v, k, c FROM mv").get0();
+            assert_that(msg).is_rows().with_rows({{int32_type->decompose(20), int32_type->decompose(1), int32_type->decompose(1)}});
+        });
+
+        // Also after it's flushed to an sstable.
+        e.db().invoke_on_all([] (replica::database& db) { return db.flush_all_memtables(); }).get();
+        e.execute_cql("UPDATE t SET v = 30 WHERE k = 1 AND c = 1").get();
+        BOOST_REQUIRE_EQUAL(reads_skipped(), 1);
+        eventually([&] {
+            auto msg = e.execute_cql("SELECT v, k, c FROM mv").get0();
+            assert_that(msg).is_rows().with_rows({{int32_type->decompose(30), int32_type->decompose(1), int32_type->decompose(1)}});
+        });
+    });
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "db/view/view_stats.hh"
+#include "db/view/view_update_coalescer.hh"
+#include "replica/database.hh"
+#include "test/lib/simple_schema.hh"
+
+namespace {
+
+struct sent_update {
+    gms::inet_address endpoint;
+    mutation mut;
+};
+
+struct coalescer_test_env {
+    simple_schema ss;
+    db::view::stats stats{"test", seastar::metrics::label("ks")("ks"), seastar::metrics::label("cf")("cf")};
+    replica::cf_stats cf_stats;
+    db::timeout_semaphore sem{1000};
+    std::vector<sent_update> sent;
+
+    frozen_mutation_and_schema make_update(uint32_t pk, uint32_t ck) {
+        auto m = ss.new_mutation(format("pk{:010d}", pk));
+        ss.add_row(m, ss.make_ckey(ck), "v");
+        return frozen_mutation_and_schema{freeze(m), ss.schema()};
+    }
+
+    void add(db::view::view_update_coalescer& coalescer, gms::inet_address endpoint, uint32_t pk, uint32_t ck,
+            std::chrono::microseconds window = std::chrono::hours(1)) {
+        auto mut = make_update(pk, ck);
+        auto token = dht::get_token(*mut.s, mut.fm.key());
+        coalescer.add(endpoint, std::move(mut), token, token, service::allow_hints::yes, nullptr, stats, cf_stats,
+                seastar::consume_units(sem, 10), window);
+    }
+
+    db::view::view_update_coalescer::send_func recorder() {
+        return [this] (gms::inet_address endpoint, frozen_mutation_and_schema mut, service::allow_hints, tracing::trace_state_ptr) {
+            sent.push_back(sent_update{endpoint, mut.fm.unfreeze(mut.s)});
+            return make_ready_future<>();
+        };
+    }
+};
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_coalescer_merges_updates_of_the_same_view_partition) {
+    coalescer_test_env env;
+    db::view::view_update_coalescer coalescer(env.recorder());
+    auto ep1 = gms::inet_address("127.0.0.1");
+    auto ep2 = gms::inet_address("127.0.0.2");
+
+    env.add(coalescer, ep1, 1, 1);
+    env.add(coalescer, ep1, 1, 2);
+    env.add(coalescer, ep2, 1, 1);
+    env.add(coalescer, ep1, 2, 1);
+    BOOST_REQUIRE(env.sent.empty());
+    // The held back updates stay accounted.
+    BOOST_REQUIRE_EQUAL(env.sem.available_units(), 960);
+
+    coalescer.stop().get();
+    BOOST_REQUIRE(!coalescer.accepts_updates());
+    BOOST_REQUIRE_EQUAL(env.sent.size(), 3);
+    BOOST_REQUIRE_EQUAL(env.stats.view_updates_pushed_remote, 3);
+    BOOST_REQUIRE_EQUAL(env.sem.available_units(), 1000);
+    auto merged = std::find_if(env.sent.begin(), env.sent.end(), [&] (const sent_update& u) {
+        return u.endpoint == ep1 && u.mut.key().equal(*env.ss.schema(), env.ss.make_pkey(1).key());
+    });
+    BOOST_REQUIRE(merged != env.sent.end());
+    BOOST_REQUIRE_EQUAL(merged->mut.partition().row_count(), 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_coalescer_flushes_after_window) {
+    coalescer_test_env env;
+    db::view::view_update_coalescer coalescer(env.recorder());
+
+    env.add(coalescer, gms::inet_address("127.0.0.1"), 1, 1, std::chrono::milliseconds(1));
+    while (env.sent.empty()) {
+        seastar::sleep(std::chrono::milliseconds(1)).get();
+    }
+    BOOST_REQUIRE_EQUAL(env.sent.size(), 1);
+    coalescer.stop().get();
+    BOOST_REQUIRE_EQUAL(env.sent.size(), 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_coalescer_stop_waits_for_sends) {
+    coalescer_test_env env;
+    promise<> send_done;
+    db::view::view_update_coalescer coalescer([&] (gms::inet_address, frozen_mutation_and_schema, service::allow_hints, tracing::trace_state_ptr) {
+        return send_done.get_future();
+    });
+
+    env.add(coalescer, gms::inet_address("127.0.0.1"), 1, 1);
+    auto stopped = coalescer.stop();
+    BOOST_REQUIRE(!stopped.available());
+    BOOST_REQUIRE_EQUAL(env.sem.available_units(), 990);
+    send_done.set_value();
+    stopped.get();
+    BOOST_REQUIRE_EQUAL(env.sem.available_units(), 1000);
+}
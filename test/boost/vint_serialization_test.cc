@@ -17,6 +17,7 @@
 #include <array>
 #include <cstdint>
 #include <random>
+#include <vector>
 
 using namespace seastar;
 
@@ -137,3 +138,34 @@ BOOST_AUTO_TEST_CASE(sanity_signed_examples) {
 BOOST_AUTO_TEST_CASE(sanity_signed_sweep) {
     check_roundtrip_sweep<signed_vint>(100'000, random_engine());
 }
+
+BOOST_AUTO_TEST_CASE(unsigned_deserialize_many) {
+    auto& rng = random_engine();
+    // Mostly small values, so that runs of one-byte vints are mixed with longer ones.
+    std::uniform_int_distribution<int> bits_distribution(0, 64);
+    std::uniform_int_distribution<uint64_t> distribution;
+
+    std::vector<uint64_t> values(100);
+    for (auto& v : values) {
+        const auto bits = std::max(bits_distribution(rng) - 32, 0);
+        v = bits ? distribution(rng) >> (64 - bits) : distribution(rng) & 0x7f;
+    }
+
+    bytes serialized(bytes::initialized_later(), values.size() * max_vint_length);
+    size_t size = 0;
+    for (auto v : values) {
+        size += unsigned_vint::serialize(v, serialized.begin() + size);
+    }
+
+    std::vector<uint64_t> decoded(values.size());
+    BOOST_REQUIRE_EQUAL(unsigned_vint::deserialize_many(bytes_view(serialized.data(), size), decoded), size);
+    BOOST_REQUIRE(decoded == values);
+
+    // Trailing bytes past the last vint are left alone.
+    BOOST_REQUIRE_EQUAL(unsigned_vint::deserialize_many(bytes_view(serialized), decoded), size);
+    BOOST_REQUIRE(decoded == values);
+
+    for (size_t truncated = 0; truncated < size; ++truncated) {
+        BOOST_REQUIRE_EQUAL(unsigned_vint::deserialize_many(bytes_view(serialized.data(), truncated), decoded), 0);
+    }
+}
@@ -223,6 +223,9 @@ def run_scylla_cmd(pid, dir):
         # and other modules dependent on it: e.g. service levels
         '--authenticator', 'PasswordAuthenticator',
         '--strict-allow-filtering', 'true',
+        # Off by default, enabled to test the framing of protocol v5 with
+        # a real driver, see test_protocol_v5.py.
+        '--native-transport-enable-protocol-v5', '1',
         ], {})
 
 # Same as run_scylla_cmd, just use SSL encryption for the CQL port (same
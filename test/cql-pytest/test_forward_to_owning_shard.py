@@ -0,0 +1,44 @@
+# Copyright 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+#############################################################################
+# Tests for executing prepared statements on the shard owning their partition
+# (the forward_requests_to_owning_shard option).
+#############################################################################
+
+import pytest
+from contextlib import contextmanager
+from util import new_test_table
+
+@contextmanager
+def config_value(cql, name, value):
+    old = list(cql.execute(f"SELECT value FROM system.config WHERE name = '{name}'"))[0].value
+    cql.execute(f"UPDATE system.config SET value = '{value}' WHERE name = '{name}'")
+    try:
+        yield
+    finally:
+        cql.execute(f"UPDATE system.config SET value = '{old}' WHERE name = '{name}'")
+
+def moved(result):
+    return any('Moving the request to shard' in event.description for event in result.get_query_trace().events)
+
+def test_forward_to_owning_shard(scylla_only, cql, test_keyspace):
+    with new_test_table(cql, test_keyspace, "p int, c int, v int, PRIMARY KEY (p, c)") as table:
+        insert = cql.prepare(f"INSERT INTO {table} (p, c, v) VALUES (?, ?, ?)")
+        # Don't let a shard-aware driver send the requests to the owning shard
+        # itself: without a routing key they arrive on any of the shards.
+        insert.routing_key_indexes = None
+        select = cql.prepare(f"SELECT v FROM {table} WHERE p = ? AND c = ?")
+        keys = range(20)
+
+        # Disabled by default: requests are executed where they arrive.
+        assert not any(moved(cql.execute(insert, [p, 0, p], trace=True)) for p in keys)
+
+        with config_value(cql, 'forward_requests_to_owning_shard', 'true'):
+            # With two shards and 20 keys, some of the requests arrive on the
+            # shard which doesn't own their partition.
+            assert any([moved(cql.execute(insert, [p, 1, p + 1], trace=True)) for p in keys])
+            for p in keys:
+                assert list(cql.execute(select, [p, 0])) == [(p,)]
+                assert list(cql.execute(select, [p, 1])) == [(p + 1,)]
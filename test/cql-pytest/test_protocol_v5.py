@@ -0,0 +1,73 @@
+# Copyright 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+#############################################################################
+# Tests for version 5 of the native protocol, as spoken by the Python driver:
+# the framing of messages in (optionally LZ4-compressed) segments, and the
+# result metadata ids of prepared statements. The server has to allow v5
+# with native_transport_enable_protocol_v5, which test/cql-pytest/run does.
+#############################################################################
+
+import pytest
+import cassandra.cluster
+from cassandra.concurrent import execute_concurrent_with_args
+from contextlib import contextmanager
+from util import new_test_table
+
+@contextmanager
+def cql_v5(cql, compression):
+    cluster = cassandra.cluster.Cluster(
+        contact_points=cql.cluster.contact_points,
+        port=cql.cluster.port,
+        protocol_version=5,
+        compression=compression,
+        auth_provider=cql.cluster.auth_provider,
+        ssl_context=cql.cluster.ssl_context)
+    try:
+        try:
+            session = cluster.connect()
+        except cassandra.cluster.NoHostAvailable as e:
+            if 'protocol version' in str(e).lower():
+                pytest.skip("the server doesn't allow protocol v5")
+            raise
+        assert cluster.protocol_version == 5
+        yield session
+    finally:
+        cluster.shutdown()
+
+@pytest.fixture(params=[False, 'lz4'])
+def compression(request):
+    if request.param == 'lz4':
+        pytest.importorskip('lz4')
+    return request.param
+
+# Many small requests in flight at once, whose responses the server packs
+# together into segments, and a result too large for a single segment.
+def test_v5_requests(cql, test_keyspace, compression):
+    with cql_v5(cql, compression) as session:
+        with new_test_table(session, test_keyspace, "p int, c int, v text, PRIMARY KEY (p, c)") as table:
+            insert = session.prepare(f"INSERT INTO {table} (p, c, v) VALUES (?, ?, ?)")
+            value = 'x' * 1000
+            rows = [(p, c, value) for p in range(2) for c in range(500)]
+            for success, _ in execute_concurrent_with_args(session, insert, rows, concurrency=100):
+                assert success
+            # Each partition is ~500KB, more than a segment's payload.
+            select = session.prepare(f"SELECT c, v FROM {table} WHERE p = ?")
+            select.fetch_size = None
+            for p in range(2):
+                assert list(session.execute(select, [p])) == [(c, value) for c in range(500)]
+            assert list(session.execute(f"SELECT COUNT(*) FROM {table}")) == [(len(rows),)]
+
+# When the columns of the result of a prepared statement change, the server
+# sends the new metadata, which the driver skips otherwise.
+def test_v5_result_metadata_changed(cql, test_keyspace, compression):
+    with cql_v5(cql, compression) as session:
+        with new_test_table(session, test_keyspace, "p int PRIMARY KEY, v int") as table:
+            session.execute(f"INSERT INTO {table} (p, v) VALUES (1, 2)")
+            select = session.prepare(f"SELECT * FROM {table} WHERE p = ?")
+            assert list(session.execute(select, [1])) == [(1, 2)]
+            session.execute(f"ALTER TABLE {table} ADD w int")
+            session.execute(f"UPDATE {table} SET w = 3 WHERE p = 1")
+            row = session.execute(select, [1]).one()
+            assert (row.p, row.v, row.w) == (1, 2, 3)
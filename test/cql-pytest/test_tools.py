@@ -156,3 +156,97 @@ def test_scylla_sstable_dump_merge(scylla_sstable, merge, output_format):
     assert out
     if output_format == "json":
         assert json.loads(out)
+
+
+def test_scylla_sstable_split_by_shard(scylla_sstable, tmp_path):
+    (scylla_path, schema_file, sstables) = scylla_sstable
+
+    subprocess.check_call([scylla_path, "sstable", "split-by-shard", "--schema-file", schema_file, "--shards", "4",
+                           "--output-dir", str(tmp_path)] + sstables)
+
+    output_sstables = glob.glob(os.path.join(tmp_path, '*-Data.db'))
+    assert 0 < len(output_sstables) <= 4
+
+    def dump_merged(sstables):
+        out = subprocess.check_output([scylla_path, "sstable", "dump-data", "--schema-file", schema_file, "--merge"] + sstables)
+        return json.loads(out)
+
+    assert dump_merged(output_sstables) == dump_merged(sstables)
+
+
+@pytest.mark.parametrize("merge", [True, False])
+@pytest.mark.parametrize("compact", [True, False])
+def test_scylla_sstable_rewrite(scylla_sstable, tmp_path, merge, compact):
+    (scylla_path, schema_file, sstables) = scylla_sstable
+
+    args = [scylla_path, "sstable", "rewrite", "--schema-file", schema_file, "--output-dir", str(tmp_path)]
+    if merge:
+        args.append("--merge")
+    if compact:
+        args.append("--compact")
+    subprocess.check_call(args + sstables)
+
+    output_sstables = glob.glob(os.path.join(tmp_path, '*-Data.db'))
+    assert len(output_sstables) == (1 if merge else len(sstables))
+
+    def dump_merged(sstables):
+        out = subprocess.check_output([scylla_path, "sstable", "dump-data", "--schema-file", schema_file, "--merge"] + sstables)
+        return json.loads(out)
+
+    if not compact:
+        assert dump_merged(output_sstables) == dump_merged(sstables)
+
+
+@pytest.fixture(scope="module")
+def scylla_compaction_simulator(request, scylla_only):
+    scylla_path = request.config.getoption('scylla_path')
+    if not scylla_path:
+        pytest.skip('Cannot run tool tests: scylla_path not provided')
+    return [scylla_path, "compaction-simulator"]
+
+
+def compaction_simulator_summary(out):
+    summary = {}
+    for line in out.decode().splitlines():
+        key, sep, value = line.partition(": ")
+        if sep:
+            summary[key] = value
+    return summary
+
+
+def test_scylla_compaction_simulator_is_deterministic(scylla_compaction_simulator):
+    args = scylla_compaction_simulator + ["--strategy", "TimeWindowCompactionStrategy",
+            "--strategy-option", "compaction_window_unit=HOURS", "--strategy-option", "compaction_window_size=1",
+            "--duration", "86400", "--flush-interval", "300", "--ttl", "43200"]
+    out = subprocess.check_output(args)
+
+    print(out)
+
+    assert out == subprocess.check_output(args)
+
+
+# Data expires according to the timestamps of the workload, whatever the
+# wall clock says.
+@pytest.mark.parametrize("with_timestamps", [True, False])
+def test_scylla_compaction_simulator_expiry(scylla_compaction_simulator, tmp_path, with_timestamps):
+    # Flushes long in the past, which would all be expired on arrival if
+    # timestamps were compared with the wall clock.
+    start = 1600000000 * 1000000
+    workload_file = os.path.join(tmp_path, "workload.csv")
+    with open(workload_file, "w") as f:
+        for t in range(60, 660, 60):
+            if with_timestamps:
+                f.write(f"{t},1048576,{start + (t - 60) * 1000000},{start + t * 1000000}\n")
+            else:
+                f.write(f"{t},1048576\n")
+
+    # No compactions, so that only the flushed sstables expire.
+    out = subprocess.check_output(scylla_compaction_simulator + ["--workload-file", workload_file, "--ttl", "150",
+            "--strategy-option", "min_threshold=32", "--strategy-option", "max_threshold=32"])
+
+    print(out)
+
+    summary = compaction_simulator_summary(out)
+    assert summary["compactions"].startswith("0,")
+    # At 600s, data written before 450s is expired: the flushes at 60s to 420s.
+    assert summary["expired sstables"] == "7"
@@ -0,0 +1,27 @@
+# Copyright 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+
+#############################################################################
+# Tests for statements executed without being prepared, whose plans are
+# cached by their normalized text, with the constants taken out.
+#############################################################################
+
+from util import new_test_table
+
+# The plan is shared by the statements which differ only in their constants,
+# but each of them is traced as the client sent it.
+def test_unprepared_statement_traced_as_sent(scylla_only, cql, test_keyspace):
+    with new_test_table(cql, test_keyspace, "p int, c int, v int, PRIMARY KEY (p, c)") as table:
+        for p in range(3):
+            insert = f"INSERT INTO {table} (p, c, v) VALUES ({p}, 0, {p + 10})"
+            trace = cql.execute(insert, trace=True).get_query_trace()
+            assert trace.parameters['query'] == insert
+            assert any(insert in event.description for event in trace.events)
+
+            select = f"SELECT v FROM {table} WHERE p = {p} AND c = 0"
+            result = cql.execute(select, trace=True)
+            assert list(result) == [(p + 10,)]
+            trace = result.get_query_trace()
+            assert trace.parameters['query'] == select
+            assert any(select in event.description for event in trace.events)
@@ -34,6 +34,34 @@ def test_runtime_info(scylla_only, cql):
 def test_versions(scylla_only, cql):
     _check_exists(cql, "versions", ("key", "build_id", "build_mode", "version"))
 
+def test_table_latency_breakdown(scylla_only, cql, test_keyspace):
+    with util.new_test_table(cql, test_keyspace, 'pk int PRIMARY KEY, v int') as table:
+        for i in range(3):
+            cql.execute(f"INSERT INTO {table} (pk, v) VALUES ({i}, {i})")
+        for i in range(2):
+            cql.execute(f"SELECT * FROM {table} WHERE pk = {i}")
+        ks, tbl = table.split('.')
+        res = {r.stage: r for r in cql.execute(f"SELECT stage, count, total_us, mean_us, max_us FROM system.table_latency_breakdown WHERE keyspace_name = '{ks}' AND table_name = '{tbl}'")}
+        assert set(res.keys()) == {'read_admission', 'read_sstable_index', 'read_sstable_data', 'read_other',
+                'write_view_update', 'write_commitlog', 'write_memtable'}
+        for stage, r in res.items():
+            assert r.count == (2 if stage.startswith('read_') else 3)
+            assert r.max_us <= r.total_us
+
+def test_sstable_component_io(scylla_only, cql, test_keyspace):
+    with util.new_test_table(cql, test_keyspace, 'pk int PRIMARY KEY, v int') as table:
+        for i in range(3):
+            cql.execute(f"INSERT INTO {table} (pk, v) VALUES ({i}, {i})")
+        ks, tbl = table.split('.')
+        nodetool.flush(cql, table)
+        for i in range(3):
+            cql.execute(f"SELECT * FROM {table} WHERE pk = {i}")
+        res = {r.component: r for r in cql.execute(f"SELECT component, read_ops, bytes_read, mean_read_size FROM system.sstable_component_io WHERE keyspace_name = '{ks}' AND table_name = '{tbl}'")}
+        assert set(res.keys()) == {'Data', 'Index', 'Summary', 'Filter'}
+        assert res['Summary'].read_ops > 0
+        for r in res.values():
+            assert r.mean_read_size == pytest.approx(r.bytes_read / r.read_ops if r.read_ops else 0)
+
 # Check reading the system.config table, which should list all configuration
 # parameters. As we noticed in issue #10047, each type of configuration
 # parameter can have a different function for printing it out, and some of
@@ -153,6 +153,10 @@ class test {
         return _sst->read_toc();
     }
 
+    future<> read_scylla_metadata() noexcept {
+        return _sst->read_scylla_metadata(default_priority_class());
+    }
+
     auto& get_components() {
         return _sst->_recognized_components;
     }
@@ -11,6 +11,7 @@
 #include <seastar/util/defer.hh>
 #include <seastar/core/app-template.hh>
 #include <seastar/core/thread.hh>
+#include <json/json.h>
 
 #include "partition_slice_builder.hh"
 #include "schema_builder.hh"
@@ -20,6 +21,9 @@
 #include "test/lib/tmpdir.hh"
 #include "sstables/sstables.hh"
 #include "canonical_mutation.hh"
+#include "counters.hh"
+#include "types/map.hh"
+#include "release.hh"
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/test_services.hh"
 #include "test/lib/sstable_test_env.hh"
@@ -134,36 +138,73 @@ sstring random_name(size_t size) {
 }
 
 struct mutation_settings {
+    // One of "blob", "collection" or "counter".
+    sstring column_type;
     size_t column_count;
     size_t column_name_size;
+    size_t collection_size;
     size_t row_count;
     size_t partition_count;
     size_t partition_key_size;
     size_t clustering_key_size;
     size_t data_size;
+
+    size_t rows() const {
+        return partition_count * row_count;
+    }
+
+    size_t cells() const {
+        return rows() * column_count;
+    }
 };
 
+static data_type make_column_type(const mutation_settings& settings) {
+    if (settings.column_type == "blob") {
+        return bytes_type;
+    } else if (settings.column_type == "collection") {
+        return map_type_impl::get_instance(int32_type, bytes_type, true);
+    } else if (settings.column_type == "counter") {
+        return counter_type;
+    }
+    throw std::invalid_argument(format("unknown column type: {}, expected blob, collection or counter", settings.column_type));
+}
+
 static schema_ptr make_schema(const mutation_settings& settings) {
     auto builder = schema_builder("ks", "cf")
         .with_column("pk", bytes_type, column_kind::partition_key)
         .with_column("ck", bytes_type, column_kind::clustering_key);
 
+    auto type = make_column_type(settings);
     for (size_t i = 0; i < settings.column_count; ++i) {
-        builder.with_column(to_bytes(random_name(settings.column_name_size)), bytes_type);
+        builder.with_column(to_bytes(random_name(settings.column_name_size)), type);
     }
 
     return builder.build();
 }
 
+static atomic_cell_or_collection make_cell(const column_definition& col, const mutation_settings& settings) {
+    if (settings.column_type == "collection") {
+        collection_mutation_description cmd;
+        for (size_t i = 0; i < settings.collection_size; ++i) {
+            cmd.cells.emplace_back(int32_type->decompose(int32_t(i)),
+                    atomic_cell::make_live(*bytes_type, 1, random_bytes(settings.data_size), atomic_cell::collection_member::yes));
+        }
+        return cmd.serialize(*col.type);
+    } else if (settings.column_type == "counter") {
+        counter_cell_builder ccb;
+        ccb.add_shard(counter_shard(counter_id::generate_random(), std::rand(), 1));
+        return ccb.build(1);
+    }
+    return atomic_cell::make_live(*bytes_type, 1, bytes_type->decompose(data_value(random_bytes(settings.data_size))));
+}
+
 static mutation make_mutation(schema_ptr s, mutation_settings settings) {
     mutation m(s, partition_key::from_single_value(*s, bytes_type->decompose(data_value(random_bytes(settings.partition_key_size)))));
 
     for (size_t i = 0; i < settings.row_count; ++i) {
         auto ck = clustering_key::from_single_value(*s, bytes_type->decompose(data_value(random_bytes(settings.clustering_key_size))));
         for (auto&& col : s->regular_columns()) {
-            m.set_clustered_cell(ck, col,
-                atomic_cell::make_live(*bytes_type, 1,
-                    bytes_type->decompose(data_value(random_bytes(settings.data_size)))));
+            m.set_clustered_cell(ck, col, make_cell(col, settings));
         }
     }
     return m;
@@ -173,6 +214,7 @@ struct sizes {
     size_t memtable;
     size_t cache;
     std::map<sstables::sstable::version_types, size_t> sstable;
+    // The sizes below are of the first partition only.
     size_t frozen;
     size_t canonical;
     size_t query_result;
@@ -221,18 +263,102 @@ static sizes calculate_sizes(cache_tracker& tracker, const mutation_settings& se
     return result;
 }
 
+static double per(size_t size, size_t count) {
+    return count ? double(size) / count : 0;
+}
+
+static void print_text(const mutation_settings& settings, const sizes& sizes) {
+    std::cout << "mutation footprint:" << "\n";
+    std::cout << " - in cache:     " << sizes.cache << "\n";
+    std::cout << " - in memtable:  " << sizes.memtable << "\n";
+    std::cout << " - in sstable:\n";
+    for (auto v : sizes.sstable) {
+        std::cout << "   " << sstables::to_string(v.first) << ":   " << v.second << "\n";
+    }
+    std::cout << " - frozen:       " << sizes.frozen << "\n";
+    std::cout << " - canonical:    " << sizes.canonical << "\n";
+    std::cout << " - query result: " << sizes.query_result << "\n";
+
+    std::cout << "\n";
+    std::cout << "bytes per partition / row / cell:\n";
+    auto print_per = [&] (const sstring& name, size_t size) {
+        std::cout << format(" - {:<14}{:.1f} / {:.1f} / {:.1f}\n", name + ":",
+                per(size, settings.partition_count), per(size, settings.rows()), per(size, settings.cells()));
+    };
+    print_per("in cache", sizes.cache);
+    print_per("in memtable", sizes.memtable);
+    for (auto v : sizes.sstable) {
+        print_per(format("in sstable {}", sstables::to_string(v.first)), v.second);
+    }
+
+    std::cout << "\n";
+    size_calculator::print_cache_entry_size();
+}
+
+// Prints the results as a single JSON object, so that they can be compared across versions.
+static void print_json(const mutation_settings& settings, const sizes& sizes) {
+    Json::Value root{Json::objectValue};
+    root["version"] = scylla_version();
+
+    Json::Value params{Json::objectValue};
+    params["column_type"] = std::string(settings.column_type);
+    params["column_count"] = Json::UInt64(settings.column_count);
+    params["column_name_size"] = Json::UInt64(settings.column_name_size);
+    params["collection_size"] = Json::UInt64(settings.collection_size);
+    params["row_count"] = Json::UInt64(settings.row_count);
+    params["partition_count"] = Json::UInt64(settings.partition_count);
+    params["partition_key_size"] = Json::UInt64(settings.partition_key_size);
+    params["clustering_key_size"] = Json::UInt64(settings.clustering_key_size);
+    params["data_size"] = Json::UInt64(settings.data_size);
+    root["parameters"] = params;
+
+    auto make_value = [&] (size_t size) {
+        Json::Value v{Json::objectValue};
+        v["bytes"] = Json::UInt64(size);
+        v["bytes_per_partition"] = per(size, settings.partition_count);
+        v["bytes_per_row"] = per(size, settings.rows());
+        v["bytes_per_cell"] = per(size, settings.cells());
+        return v;
+    };
+    Json::Value results{Json::objectValue};
+    results["cache"] = make_value(sizes.cache);
+    results["memtable"] = make_value(sizes.memtable);
+    Json::Value sstable{Json::objectValue};
+    for (auto v : sizes.sstable) {
+        sstable[std::string(sstables::to_string(v.first))] = make_value(v.second);
+    }
+    results["sstable"] = sstable;
+    results["frozen_partition"] = Json::UInt64(sizes.frozen);
+    results["canonical_partition"] = Json::UInt64(sizes.canonical);
+    results["query_result_partition"] = Json::UInt64(sizes.query_result);
+    root["results"] = results;
+
+    Json::Value structs{Json::objectValue};
+    structs["cache_entry"] = Json::UInt64(sizeof(cache_entry));
+    structs["memtable_entry"] = Json::UInt64(sizeof(memtable_entry));
+    structs["rows_entry"] = Json::UInt64(sizeof(rows_entry));
+    structs["mutation_partition"] = Json::UInt64(sizeof(mutation_partition));
+    structs["atomic_cell_or_collection"] = Json::UInt64(sizeof(atomic_cell_or_collection));
+    root["struct_sizes"] = structs;
+
+    std::cout << root << "\n";
+}
+
 int main(int argc, char** argv) {
     namespace bpo = boost::program_options;
     app_template app;
     app.add_options()
         ("verbose", "Enable info-level logging")
+        ("column-type", bpo::value<sstring>()->default_value("blob"), "type of the regular columns: blob, collection (a map<int, blob>) or counter")
         ("column-count", bpo::value<size_t>()->default_value(5), "column count")
         ("column-name-size", bpo::value<size_t>()->default_value(2), "column name size")
+        ("collection-size", bpo::value<size_t>()->default_value(4), "number of elements in each collection cell, for --column-type collection")
         ("row-count", bpo::value<size_t>()->default_value(1), "row count")
         ("partition-count", bpo::value<size_t>()->default_value(1), "partition count")
         ("partition-key-size", bpo::value<size_t>()->default_value(10), "partition key size")
         ("clustering-key-size", bpo::value<size_t>()->default_value(10), "clustering key size")
-        ("data-size", bpo::value<size_t>()->default_value(32), "cell data size");
+        ("data-size", bpo::value<size_t>()->default_value(32), "cell data size, or collection element data size")
+        ("output-format", bpo::value<sstring>()->default_value("text"), "output format: text or json");
 
     return app.run(argc, argv, [&] {
         if (smp::count != 1) {
@@ -243,10 +369,17 @@ int main(int argc, char** argv) {
             logging::logger_registry().set_all_loggers_level(seastar::log_level::warn);
         }
 
+        auto output_format = app.configuration()["output-format"].as<sstring>();
+        if (output_format != "text" && output_format != "json") {
+            throw std::invalid_argument(format("unknown output format: {}, expected text or json", output_format));
+        }
+
         return do_with_cql_env_thread([&](cql_test_env& env) {
             mutation_settings settings;
+            settings.column_type = app.configuration()["column-type"].as<sstring>();
             settings.column_count = app.configuration()["column-count"].as<size_t>();
             settings.column_name_size = app.configuration()["column-name-size"].as<size_t>();
+            settings.collection_size = app.configuration()["collection-size"].as<size_t>();
             settings.row_count = app.configuration()["row-count"].as<size_t>();
             settings.partition_count = app.configuration()["partition-count"].as<size_t>();
             settings.partition_key_size = app.configuration()["partition-key-size"].as<size_t>();
@@ -256,19 +389,11 @@ int main(int argc, char** argv) {
             auto& tracker = env.local_db().find_column_family("system", "local").get_row_cache().get_cache_tracker();
             auto sizes = calculate_sizes(tracker, settings);
 
-            std::cout << "mutation footprint:" << "\n";
-            std::cout << " - in cache:     " << sizes.cache << "\n";
-            std::cout << " - in memtable:  " << sizes.memtable << "\n";
-            std::cout << " - in sstable:\n";
-            for (auto v : sizes.sstable) {
-                std::cout << "   " << sstables::to_string(v.first) << ":   " << v.second << "\n";
+            if (output_format == "json") {
+                print_json(settings, sizes);
+            } else {
+                print_text(settings, sizes);
             }
-            std::cout << " - frozen:       " << sizes.frozen << "\n";
-            std::cout << " - canonical:    " << sizes.canonical << "\n";
-            std::cout << " - query result: " << sizes.query_result << "\n";
-
-            std::cout << "\n";
-            size_calculator::print_cache_entry_size();
         });
     });
 }
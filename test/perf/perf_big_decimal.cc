@@ -10,6 +10,7 @@
 #include <seastar/testing/test_runner.hh>
 
 #include <random>
+#include <vector>
 
 #include "utils/big_decimal.hh"
 #include "test/lib/make_random_string.hh"
@@ -36,3 +37,54 @@ PERF_TEST_F(big_decimal_test, from_string) {
     perf_tests::do_not_optimize(big_decimal{neg_data_fraction_neg_exponent});
 }
 
+
+struct big_decimal_arithmetic_test {
+    // Like the values a SUM or AVG over a decimal column adds up.
+    std::vector<big_decimal> prices;
+    std::vector<big_decimal> wide;
+
+    big_decimal_arithmetic_test() {
+        for (int i = 0; i < 100; ++i) {
+            prices.emplace_back(make_random_numeric_string(6) + "." + make_random_numeric_string(i % 4 + 1));
+            wide.emplace_back(make_random_numeric_string(30) + "." + make_random_numeric_string(i % 4 + 1));
+        }
+    }
+};
+
+PERF_TEST_F(big_decimal_arithmetic_test, sum) {
+    big_decimal sum;
+    for (auto& v : prices) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+    return prices.size();
+}
+
+PERF_TEST_F(big_decimal_arithmetic_test, sum_wide) {
+    big_decimal sum;
+    for (auto& v : wide) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+    return wide.size();
+}
+
+PERF_TEST_F(big_decimal_arithmetic_test, avg) {
+    big_decimal sum;
+    for (auto& v : prices) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum.div(prices.size(), big_decimal::rounding_mode::HALF_EVEN));
+    return prices.size();
+}
+
+PERF_TEST_F(big_decimal_arithmetic_test, max) {
+    const big_decimal* max = &prices.front();
+    for (auto& v : prices) {
+        if (*max < v) {
+            max = &v;
+        }
+    }
+    perf_tests::do_not_optimize(max);
+    return prices.size();
+}
@@ -9,6 +9,7 @@
 #include "sstables/checksum_utils.hh"
 #include "test/lib/make_random_string.hh"
 #include "utils/gz/crc_combine.hh"
+#include "utils/crc.hh"
 
 #include "seastar/include/seastar/testing/perf_tests.hh"
 
@@ -46,10 +47,22 @@ PERF_TEST_F(crc_test, perf_deflate_crc32_checksum) {
 
 PERF_TEST_F(crc_test, perf_adler_checksum) {
     perf_tests::do_not_optimize(
-        adler32_utils::checksum(data.data(), data.size()));
+        zlib_adler32_checksummer::checksum(data.data(), data.size()));
+}
+
+PERF_TEST_F(crc_test, perf_deflate_adler_checksum) {
+    perf_tests::do_not_optimize(
+        libdeflate_adler32_checksummer::checksum(data.data(), data.size()));
 }
 
 PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+// The crc32c of the commitlog
+PERF_TEST_F(crc_test, perf_crc32c_checksum) {
+    utils::crc32 c;
+    c.process(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    perf_tests::do_not_optimize(c.get());
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/range/irange.hpp>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/util/defer.hh>
+
+#include "seastarx.hh"
+#include "db/commitlog/commitlog.hh"
+#include "memtable.hh"
+#include "schema_builder.hh"
+#include "utils/UUID_gen.hh"
+#include "utils/logalloc.hh"
+#include "utils/estimated_histogram.hh"
+#include "test/perf/perf.hh"
+
+// Drives the write path of a single node below the storage proxy: either
+// db::commitlog alone, on the device backing --directory, or memtable apply
+// alone. Every shard runs --concurrency writers for --duration seconds.
+
+using clk = std::chrono::steady_clock;
+
+static thread_local bool cancelled = false;
+
+struct perf_commitlog_config {
+    sstring mode;
+    sstring directory;
+    size_t entry_size;
+    unsigned concurrency;
+    std::chrono::seconds duration;
+    db::commitlog::sync_mode sync_mode;
+    uint64_t segment_size_in_mb;
+    uint64_t sync_period_in_ms;
+    uint64_t group_commit_max_window_in_us;
+};
+
+struct perf_commitlog_result {
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+    // Latency of each entry, in microseconds.
+    utils::estimated_histogram latencies;
+    uint64_t segments_created = 0;
+    uint64_t segments_destroyed = 0;
+    uint64_t flushes = 0;
+    uint64_t max_pending_allocations = 0;
+    uint64_t mallocs = 0;
+
+    perf_commitlog_result& operator+=(const perf_commitlog_result& o) {
+        entries += o.entries;
+        bytes += o.bytes;
+        seconds = std::max(seconds, o.seconds);
+        latencies.merge(o.latencies);
+        segments_created += o.segments_created;
+        segments_destroyed += o.segments_destroyed;
+        flushes += o.flushes;
+        max_pending_allocations = std::max(max_pending_allocations, o.max_pending_allocations);
+        mallocs += o.mallocs;
+        return *this;
+    }
+};
+
+// Runs cfg.concurrency fibers calling write() in a loop until cfg.duration
+// elapses, and records the latency of each call.
+template <typename Func>
+static void run_writers(const perf_commitlog_config& cfg, perf_commitlog_result& res, Func&& write) {
+    const auto mallocs_before = perf_mallocs();
+    const auto start = clk::now();
+    const auto end = start + cfg.duration;
+    parallel_for_each(boost::irange(0u, cfg.concurrency), [&] (unsigned) {
+        return do_until([&] { return cancelled || clk::now() >= end; }, [&] {
+            auto t0 = clk::now();
+            return write().then([&res, &cfg, t0] {
+                res.latencies.add(std::chrono::duration_cast<std::chrono::microseconds>(clk::now() - t0).count());
+                ++res.entries;
+                res.bytes += cfg.entry_size;
+            });
+        });
+    }).get();
+    res.seconds = std::chrono::duration<double>(clk::now() - start).count();
+    res.mallocs = perf_mallocs() - mallocs_before;
+}
+
+static perf_commitlog_result test_commitlog(const perf_commitlog_config& cfg) {
+    perf_commitlog_result res;
+
+    db::commitlog::config cl_cfg;
+    cl_cfg.commit_log_location = cfg.directory;
+    cl_cfg.metrics_category_name = "perf-commitlog";
+    cl_cfg.commitlog_segment_size_in_mb = cfg.segment_size_in_mb;
+    cl_cfg.commitlog_sync_period_in_ms = cfg.sync_period_in_ms;
+    cl_cfg.group_commit_max_window_in_us = cfg.group_commit_max_window_in_us;
+    cl_cfg.mode = cfg.sync_mode;
+    cl_cfg.warn_about_segments_left_on_disk_after_shutdown = false;
+
+    auto log = db::commitlog::create_commitlog(cl_cfg).get0();
+    auto stop_log = defer([&log] {
+        log.shutdown().get();
+        log.clear().get();
+    });
+
+    const auto cf_id = utils::UUID_gen::get_time_UUID();
+    const auto payload = bytes(bytes::initialized_later(), cfg.entry_size);
+
+    run_writers(cfg, res, [&] {
+        return log.add_mutation(cf_id, payload.size(), db::commitlog::force_sync::no, [&payload] (db::commitlog::output& out) {
+            out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+        }).then([&log, &res] (db::rp_handle h) {
+            res.max_pending_allocations = std::max(res.max_pending_allocations, log.get_pending_allocations());
+            // Dropping the handle marks the entry as flushed to sstables,
+            // which lets the segment it's in be recycled.
+        });
+    });
+
+    res.segments_created = log.get_num_segments_created();
+    res.segments_destroyed = log.get_num_segments_destroyed();
+    res.flushes = log.get_flush_count();
+    return res;
+}
+
+static perf_commitlog_result test_memtable(const perf_commitlog_config& cfg) {
+    perf_commitlog_result res;
+
+    auto s = schema_builder("ks", "cf")
+        .with_column("pk", uuid_type, column_kind::partition_key)
+        .with_column("v", bytes_type, column_kind::regular_column)
+        .build();
+    const auto val = data_value(bytes(bytes::initialized_later(), cfg.entry_size));
+    // Memtables are replaced when they reach the size at which the
+    // database would flush them.
+    const size_t memtable_size = memory::stats().total_memory() / 4;
+    auto mt = make_lw_shared<memtable>(s);
+
+    run_writers(cfg, res, [&] {
+        auto pk = partition_key::from_single_value(*s, serialized(utils::UUID_gen::get_time_UUID()));
+        mutation m(s, pk);
+        m.set_clustered_cell(clustering_key::make_empty(), "v", val, api::new_timestamp());
+        mt->apply(m);
+        if (mt->occupancy().total_space() >= memtable_size) {
+            mt = make_lw_shared<memtable>(s);
+        }
+        return make_ready_future<>();
+    });
+    return res;
+}
+
+int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("mode", bpo::value<sstring>()->default_value("commitlog"), "what to test: commitlog or memtable")
+        ("directory", bpo::value<sstring>()->default_value("/var/lib/scylla/perf-commitlog"), "directory in which to store the commitlog segments, on the device to test")
+        ("entry-size", bpo::value<size_t>()->default_value(1024), "size of each entry (or of the cell of each mutation in memtable mode), in bytes")
+        ("concurrency", bpo::value<unsigned>()->default_value(64), "number of concurrent writers per shard")
+        ("duration", bpo::value<unsigned>()->default_value(10), "duration of the test, in seconds")
+        ("sync-mode", bpo::value<sstring>()->default_value("periodic"), "commitlog sync mode: periodic or batch")
+        ("commitlog-segment-size-in-mb", bpo::value<uint64_t>()->default_value(32), "size of the commitlog segments")
+        ("commitlog-sync-period-in-ms", bpo::value<uint64_t>()->default_value(10000), "sync period in periodic mode")
+        ("commitlog-group-commit-max-window-in-us", bpo::value<uint64_t>()->default_value(0), "maximum time a sync waits for concurrent writes to join it in batch mode")
+        ;
+
+    return app.run(argc, argv, [&app] {
+        return seastar::async([&app] {
+            auto& opts = app.configuration();
+            perf_commitlog_config cfg;
+            cfg.mode = opts["mode"].as<sstring>();
+            cfg.directory = opts["directory"].as<sstring>();
+            cfg.entry_size = opts["entry-size"].as<size_t>();
+            cfg.concurrency = opts["concurrency"].as<unsigned>();
+            cfg.duration = std::chrono::seconds(opts["duration"].as<unsigned>());
+            cfg.segment_size_in_mb = opts["commitlog-segment-size-in-mb"].as<uint64_t>();
+            cfg.sync_period_in_ms = opts["commitlog-sync-period-in-ms"].as<uint64_t>();
+            cfg.group_commit_max_window_in_us = opts["commitlog-group-commit-max-window-in-us"].as<uint64_t>();
+
+            auto sync_mode = opts["sync-mode"].as<sstring>();
+            if (sync_mode == "periodic") {
+                cfg.sync_mode = db::commitlog::sync_mode::PERIODIC;
+            } else if (sync_mode == "batch") {
+                cfg.sync_mode = db::commitlog::sync_mode::BATCH;
+            } else {
+                throw std::invalid_argument(format("Invalid sync mode: {}", sync_mode));
+            }
+            if (cfg.mode != "commitlog" && cfg.mode != "memtable") {
+                throw std::invalid_argument(format("Invalid mode: {}", cfg.mode));
+            }
+
+            engine().at_exit([] {
+                return smp::invoke_on_all([] {
+                    cancelled = true;
+                });
+            });
+
+            if (cfg.mode == "commitlog") {
+                recursive_touch_directory(cfg.directory).get();
+            } else {
+                smp::invoke_on_all([] {
+                    return logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory());
+                }).get();
+            }
+
+            std::vector<perf_commitlog_result> results(smp::count);
+            smp::invoke_on_all([&cfg, &results] {
+                return seastar::async([&cfg, &results] {
+                    results[this_shard_id()] = cfg.mode == "commitlog" ? test_commitlog(cfg) : test_memtable(cfg);
+                });
+            }).get();
+
+            perf_commitlog_result total;
+            for (auto& r : results) {
+                total += r;
+            }
+            const auto& h = total.latencies;
+            std::cout << format("{}: {:.0f} entries/s, {:.2f} MB/s, {:.2f} allocations/entry\n", cfg.mode,
+                    total.entries / total.seconds, total.bytes / total.seconds / (1 << 20), double(total.mallocs) / total.entries);
+            std::cout << format("latency [us]: mean {}, 50% {}, 90% {}, 99% {}, 99.9% {}, max {}\n",
+                    h.mean(), h.percentile(0.5), h.percentile(0.9), h.percentile(0.99), h.percentile(0.999), h.max());
+            if (cfg.mode == "commitlog") {
+                std::cout << format("segments: {} created, {} destroyed, {} flushes, {} max pending segment allocations\n",
+                        total.segments_created, total.segments_destroyed, total.flushes, total.max_pending_allocations);
+            }
+        });
+    });
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "seastar/include/seastar/testing/perf_tests.hh"
+
+#include "test/lib/simple_schema.hh"
+#include "test/perf/perf.hh"
+
+#include "frozen_mutation.hh"
+#include "mutation_query.hh"
+#include "partition_slice_builder.hh"
+#include "query-result.hh"
+#include "serializer.hh"
+#include "idl/result.dist.hh"
+#include "idl/frozen_mutation.dist.hh"
+#include "serializer_impl.hh"
+#include "idl/result.dist.impl.hh"
+#include "idl/frozen_mutation.dist.impl.hh"
+
+// The work a coordinator and its replicas do for a CL=QUORUM read or write
+// with RF=3, apart from the replicas reading or writing the data and the
+// network itself. cql_test_env is a single node, so perf_simple_query never
+// exercises any of this.
+
+namespace tests {
+
+class coordinator {
+    simple_schema _schema;
+    perf::reader_concurrency_semaphore_wrapper _semaphore;
+
+    mutation _mutation;
+    ::frozen_mutation _frozen_mutation;
+    bytes_ostream _serialized_mutation;
+    query::partition_slice _slice;
+    query::result _data_result;
+    query::result _digest_result;
+    bytes_ostream _serialized_data_result;
+    bytes_ostream _serialized_digest_result;
+public:
+    // The number of replicas a QUORUM request with RF=3 is sent to, besides
+    // the coordinator itself.
+    static constexpr unsigned remote_replicas = 2;
+
+    coordinator()
+        : _semaphore(__FILE__)
+        , _mutation(_schema.schema(), _schema.make_pkey(0))
+        , _frozen_mutation(_mutation)
+        , _slice(partition_slice_builder(*_schema.schema()).build())
+    {
+        _mutation.apply(_schema.make_row(_semaphore.make_permit(), _schema.make_ckey(0), "value"));
+        _frozen_mutation = freeze(_mutation);
+        ser::serialize(_serialized_mutation, _frozen_mutation);
+        _data_result = run_query(query::result_options{query::result_request::result_and_digest, query::digest_algorithm::xxHash});
+        _digest_result = run_query(query::result_options::only_digest(query::digest_algorithm::xxHash));
+        ser::serialize(_serialized_data_result, _data_result);
+        ser::serialize(_serialized_digest_result, _digest_result);
+    }
+
+    schema_ptr schema() const { return _schema.schema(); }
+    const mutation& get_mutation() const { return _mutation; }
+    const ::frozen_mutation& frozen() const { return _frozen_mutation; }
+    const bytes_ostream& serialized_mutation() const { return _serialized_mutation; }
+    const bytes_ostream& serialized_data_result() const { return _serialized_data_result; }
+    const bytes_ostream& serialized_digest_result() const { return _serialized_digest_result; }
+
+    query::result run_query(query::result_options opts) const {
+        return query_mutation(mutation(_mutation), _slice, query::max_rows, gc_clock::now(), opts);
+    }
+};
+
+// Coordinator: freezing the mutation and serializing it for each remote replica.
+PERF_TEST_F(coordinator, quorum_write_send)
+{
+    auto fm = freeze(get_mutation());
+    for (unsigned i = 0; i < remote_replicas; ++i) {
+        bytes_ostream out;
+        ser::serialize(out, fm);
+        perf_tests::do_not_optimize(out);
+    }
+}
+
+// Replica: deserializing the mutation, before applying it.
+PERF_TEST_F(coordinator, quorum_write_receive)
+{
+    auto in = ser::as_input_stream(serialized_mutation());
+    auto fm = ser::deserialize(in, boost::type<::frozen_mutation>());
+    perf_tests::do_not_optimize(fm);
+}
+
+// Replicas: producing the data result on one and the digest on the other,
+// and serializing them for the coordinator.
+PERF_TEST_F(coordinator, quorum_read_replicas)
+{
+    auto data = run_query(query::result_options{query::result_request::result_and_digest, query::digest_algorithm::xxHash});
+    auto digest = run_query(query::result_options::only_digest(query::digest_algorithm::xxHash));
+    bytes_ostream data_out;
+    bytes_ostream digest_out;
+    ser::serialize(data_out, data);
+    ser::serialize(digest_out, digest);
+    perf_tests::do_not_optimize(data_out);
+    perf_tests::do_not_optimize(digest_out);
+}
+
+// Coordinator: deserializing the replies and matching the digests.
+PERF_TEST_F(coordinator, quorum_read_resolve)
+{
+    auto data_in = ser::as_input_stream(serialized_data_result());
+    auto digest_in = ser::as_input_stream(serialized_digest_result());
+    auto data = ser::deserialize(data_in, boost::type<query::result>());
+    auto digest = ser::deserialize(digest_in, boost::type<query::result>());
+    if (*data.digest() != *digest.digest()) {
+        throw std::runtime_error("digest mismatch");
+    }
+    perf_tests::do_not_optimize(data);
+}
+
+}
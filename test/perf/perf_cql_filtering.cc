@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/app-template.hh>
+
+#include "test/lib/cql_test_env.hh"
+#include "test/perf/perf.hh"
+#include "transport/messages/result_message.hh"
+
+// Times queries which read a single partition and filter its rows, so that
+// the evaluation of the restrictions dominates.
+
+int main(int argc, char* argv[]) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("rows", bpo::value<unsigned>()->default_value(1000), "number of rows in the partition")
+        ("iterations", bpo::value<unsigned>()->default_value(5), "number of timed runs of each query")
+        ;
+
+    return app.run(argc, argv, [&app] {
+        return do_with_cql_env_thread([&app] (cql_test_env& e) {
+            auto rows = app.configuration()["rows"].as<unsigned>();
+            auto iterations = app.configuration()["iterations"].as<unsigned>();
+
+            e.execute_cql("CREATE TABLE t (p int, c int, s text static, v int, t text, d decimal, PRIMARY KEY (p, c));").get();
+            e.execute_cql("INSERT INTO t (p, s) VALUES (0, 'static')").get();
+            auto insert = e.prepare("INSERT INTO t (p, c, v, t, d) VALUES (0, ?, ?, ?, ?)").get0();
+            for (unsigned i = 0; i < rows; ++i) {
+                e.execute_prepared(insert, {
+                    cql3::raw_value::make_value(int32_type->decompose(int32_t(i))),
+                    cql3::raw_value::make_value(int32_type->decompose(int32_t(i % 100))),
+                    cql3::raw_value::make_value(utf8_type->decompose(format("text-{}", i % 10))),
+                    cql3::raw_value::make_value(decimal_type->from_string(format("{}.5", i % 100))),
+                }).get();
+            }
+
+            const char* queries[] = {
+                "SELECT c FROM t WHERE p = 0 AND v = 17 ALLOW FILTERING",
+                "SELECT c FROM t WHERE p = 0 AND v > 10 AND v < 20 ALLOW FILTERING",
+                "SELECT c FROM t WHERE p = 0 AND t IN ('text-1', 'text-5', 'text-7') ALLOW FILTERING",
+                "SELECT c FROM t WHERE p = 0 AND d >= 42 AND v < 50 AND s = 'static' ALLOW FILTERING",
+                "SELECT c FROM t WHERE p = 0 AND c > 10 AND v = 17 ALLOW FILTERING",
+            };
+            for (auto query : queries) {
+                std::cout << "Timing " << query << "...\n";
+                auto id = e.prepare(query).get0();
+                time_it([&] {
+                    e.execute_prepared(id, {}).get();
+                }, iterations, 10);
+            }
+        });
+    });
+}
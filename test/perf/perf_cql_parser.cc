@@ -1,4 +1,3 @@
-
 /*
  * Copyright (C) 2015-present ScyllaDB
  */
@@ -11,6 +10,8 @@
 
 #include "cql3/error_collector.hh"
 #include "cql3/CqlParser.hpp"
+#include "cql3/fast_parser.hh"
+#include "cql3/statements/raw/parsed_statement.hh"
 
 using namespace cql3;
 
@@ -30,4 +31,12 @@ int main(int argc, char* argv[]) {
         parser.set_error_listener(parser_error_collector);
         parser.query();
     });
+
+    std::cout << "Timing CQL statement parsing by the fast parser...\n";
+
+    time_it([&] {
+        if (!fast_parse_statement(query)) {
+            throw std::runtime_error("the fast parser didn't recognize the statement");
+        }
+    });
 }
@@ -7,6 +7,7 @@
  */
 
 #include "utils/murmur_hash.hh"
+#include "xx_hasher.hh"
 #include "test/perf/perf.hh"
 
 volatile uint64_t black_hole;
@@ -35,5 +36,50 @@ int main(int argc, char* argv[]) {
         sink += dst[1];
     });
 
+    // Keys of a typical IN query or batch, of varying sizes.
+    std::vector<bytes> keys;
+    for (int i = 0; i < 64; ++i) {
+        keys.push_back(bytes(bytes::initialized_later(), 8 + i % 32));
+        std::fill(keys.back().begin(), keys.back().end(), int8_t(i));
+    }
+    std::vector<bytes_view> key_views(keys.begin(), keys.end());
+    std::vector<std::array<uint64_t,2>> dsts(keys.size());
+
+    std::cout << "Timing " << keys.size() << " hashes one by one...\n";
+
+    time_it([&] {
+        for (size_t i = 0; i < key_views.size(); ++i) {
+            utils::murmur_hash::hash3_x64_128(key_views[i], seed, dsts[i]);
+        }
+        sink += dsts[0][0];
+    });
+
+    std::cout << "Timing " << keys.size() << " hashes at once...\n";
+
+    time_it([&] {
+        utils::murmur_hash::hash3_x64_128(key_views, seed, dsts);
+        sink += dsts[0][0];
+    });
+
+    // The fields of the cells of a row, fed one by one as by digests and repair.
+    std::vector<bytes> fields;
+    for (int i = 0; i < 64; ++i) {
+        fields.push_back(bytes(bytes::initialized_later(), i % 2 ? 8 : 1 + i % 24));
+        std::fill(fields.back().begin(), fields.back().end(), int8_t(i));
+    }
+
+    auto time_fields = [&] <typename Hasher> (const char* name) {
+        std::cout << "Timing " << fields.size() << " small fields with " << name << "...\n";
+        time_it([&] {
+            Hasher h(seed);
+            for (auto& f : fields) {
+                h.update(reinterpret_cast<const char*>(f.data()), f.size());
+            }
+            sink += h.finalize_uint64();
+        });
+    };
+    time_fields.operator()<xx_hasher>("XXH64");
+    time_fields.operator()<xxh3_hasher>("XXH3");
+
     black_hole = sink;
 }
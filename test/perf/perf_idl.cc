@@ -13,6 +13,11 @@
 
 #include "frozen_mutation.hh"
 #include "mutation_partition_view.hh"
+#include "utils/UUID.hh"
+#include "serializer.hh"
+#include "idl/uuid.dist.hh"
+#include "serializer_impl.hh"
+#include "idl/uuid.dist.impl.hh"
 
 namespace tests {
 
@@ -57,4 +62,42 @@ PERF_TEST_F(frozen_mutation, apply_one_small_row)
     perf_tests::do_not_optimize(m);
 }
 
+class uuids {
+    std::vector<utils::UUID> _uuids;
+    bytes_ostream _serialized;
+public:
+    static constexpr size_t count = 100;
+
+    uuids() {
+        std::generate_n(std::back_inserter(_uuids), count, utils::make_random_uuid);
+        ser::serialize(_serialized, _uuids);
+    }
+
+    const std::vector<utils::UUID>& get() const { return _uuids; }
+    const bytes_ostream& serialized() const { return _serialized; }
+};
+
+PERF_TEST_F(uuids, serialize)
+{
+    bytes_ostream out;
+    ser::serialize(out, get());
+    perf_tests::do_not_optimize(out);
+    return count;
+}
+
+PERF_TEST_F(uuids, deserialize)
+{
+    auto in = ser::as_input_stream(serialized());
+    perf_tests::do_not_optimize(ser::deserialize(in, boost::type<std::vector<utils::UUID>>()));
+    return count;
+}
+
+PERF_TEST_F(uuids, skip)
+{
+    auto in = ser::as_input_stream(serialized());
+    ser::skip(in, boost::type<std::vector<utils::UUID>>());
+    perf_tests::do_not_optimize(in);
+    return count;
+}
+
 }
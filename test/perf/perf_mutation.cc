@@ -1,4 +1,3 @@
-
 /*
  * Copyright (C) 2015-present ScyllaDB
  */
@@ -10,20 +9,75 @@
 #include "replica/database.hh"
 #include "schema_builder.hh"
 #include "test/perf/perf.hh"
+#include "test/lib/reader_concurrency_semaphore.hh"
 #include <seastar/core/app-template.hh>
 #include <seastar/core/reactor.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/closeable.hh>
 
 static atomic_cell make_atomic_cell(data_type dt, bytes value) {
     return atomic_cell::make_live(*dt, 0, value);
 };
 
+// Measures the throughput of inserting many small partitions into a memtable,
+// which is dominated by the partition index, and of scanning them back.
+static void run_partition_index_test(schema_ptr s, const column_definition& col, size_t partition_count, int iterations) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+
+    std::vector<mutation> mutations;
+    mutations.reserve(partition_count);
+    auto c_key = clustering_key::from_exploded(*s, {int32_type->decompose(0)});
+    bytes value = int32_type->decompose(3);
+    for (size_t i = 0; i < partition_count; ++i) {
+        mutation m(s, partition_key::from_exploded(*s, {to_bytes(format("key{}", i))}));
+        m.set_clustered_cell(c_key, col, make_atomic_cell(col.type, value));
+        mutations.push_back(std::move(m));
+    }
+
+    std::cout << format("Timing insertion and scan of {} single row partitions...\n", partition_count);
+
+    for (int i = 0; i < iterations; ++i) {
+        auto mt = make_lw_shared<replica::memtable>(s);
+        auto insert = duration_in_seconds([&] {
+            for (auto& m : mutations) {
+                mt->apply(m);
+                thread::maybe_yield();
+            }
+        });
+
+        size_t scanned = 0;
+        auto rd = mt->make_flat_reader(s, semaphore.make_permit());
+        auto close_rd = deferred_close(rd);
+        auto scan = duration_in_seconds([&] {
+            rd.consume_pausable([&] (mutation_fragment mf) {
+                if (mf.is_partition_start()) {
+                    ++scanned;
+                }
+                return stop_iteration::no;
+            }).get();
+        });
+        if (scanned != partition_count) {
+            throw std::runtime_error(format("scanned {} partitions, expected {}", scanned, partition_count));
+        }
+
+        std::cout << format("insert: {:.2f} partitions/s ({:.1f} ns/partition), scan: {:.2f} partitions/s ({:.1f} ns/partition)\n",
+                partition_count / insert.count(), insert.count() * 1e9 / partition_count,
+                partition_count / scan.count(), scan.count() * 1e9 / partition_count);
+    }
+}
+
 int main(int argc, char* argv[]) {
     namespace bpo = boost::program_options;
     app_template app;
     app.add_options()
-        ("column-count", bpo::value<size_t>()->default_value(1), "column count");
-    return app.run_deprecated(argc, argv, [&] {
+        ("column-count", bpo::value<size_t>()->default_value(1), "column count")
+        ("partitions", bpo::value<size_t>()->default_value(1000000), "number of partitions in the memtable partition index test, 0 to skip it")
+        ("iterations", bpo::value<int>()->default_value(5), "number of iterations of the memtable partition index test");
+    return app.run(argc, argv, [&] {
+      return seastar::async([&] {
         size_t column_count = app.configuration()["column-count"].as<size_t>();
+        size_t partition_count = app.configuration()["partitions"].as<size_t>();
+        int iterations = app.configuration()["iterations"].as<int>();
         auto builder = schema_builder("ks", "cf")
             .with_column("p1", utf8_type, column_kind::partition_key)
             .with_column("c1", int32_type, column_kind::clustering_key);
@@ -35,20 +89,26 @@ int main(int argc, char* argv[]) {
         }
 
         auto s = builder.build();
-        memtable mt(s);
+        {
+            replica::memtable mt(s);
 
-        std::cout << "Timing mutation of single column within one row...\n";
+            std::cout << "Timing mutation of single column within one row...\n";
 
-        auto key = partition_key::from_exploded(*s, {to_bytes("key1")});
-        auto c_key = clustering_key::from_exploded(*s, {int32_type->decompose(2)});
-        bytes value = int32_type->decompose(3);
+            auto key = partition_key::from_exploded(*s, {to_bytes("key1")});
+            auto c_key = clustering_key::from_exploded(*s, {int32_type->decompose(2)});
+            bytes value = int32_type->decompose(3);
 
-        time_it([&] {
-            mutation m(s, key);
-            const column_definition& col = *s->get_column_definition(to_bytes(cnames[std::rand() % column_count]));
-            m.set_clustered_cell(c_key, col, make_atomic_cell(col.type, value));
-            mt.apply(std::move(m));
-        });
-        engine().exit(0);
+            time_it([&] {
+                mutation m(s, key);
+                const column_definition& col = *s->get_column_definition(to_bytes(cnames[std::rand() % column_count]));
+                m.set_clustered_cell(c_key, col, make_atomic_cell(col.type, value));
+                mt.apply(std::move(m));
+            });
+        }
+
+        if (partition_count) {
+            run_partition_index_test(s, *s->get_column_definition(to_bytes(cnames[0])), partition_count, iterations);
+        }
+      });
     });
 }
@@ -31,12 +31,14 @@ class combined {
     std::vector<std::vector<mutation>> _disjoint_interleaved;
     std::vector<std::vector<mutation>> _disjoint_ranges;
     std::vector<std::vector<mutation>> _overlapping_partitions_disjoint_rows;
+    std::vector<mutation> _many_partitions;
 private:
     static std::vector<mutation> create_one_row(simple_schema&, reader_permit);
     static std::vector<mutation> create_single_stream(simple_schema&, reader_permit);
     static std::vector<std::vector<mutation>> create_disjoint_interleaved_streams(simple_schema&, reader_permit);
     static std::vector<std::vector<mutation>> create_disjoint_ranges_streams(simple_schema&, reader_permit);
     static std::vector<std::vector<mutation>> create_overlapping_partitions_disjoint_rows_streams(simple_schema&, reader_permit);
+    static std::vector<mutation> create_many_partitions(simple_schema&, reader_permit);
 protected:
     simple_schema& schema() const { return _schema; }
     reader_permit permit() const { return _permit; }
@@ -52,6 +54,9 @@ class combined {
         return _overlapping_partitions_disjoint_rows;
     }
     future<> consume_all(flat_mutation_reader_v2 mr) const;
+    // Merges the partitions of _many_partitions split into the given number
+    // of sources with disjoint ranges, like compaction of a run of sstables.
+    future<> consume_disjoint_sources(size_t sources) const;
 public:
     combined()
         : _semaphore("combined")
@@ -61,6 +66,7 @@ class combined {
         , _disjoint_interleaved(create_disjoint_interleaved_streams(_schema, _permit))
         , _disjoint_ranges(create_disjoint_ranges_streams(_schema, _permit))
         , _overlapping_partitions_disjoint_rows(create_overlapping_partitions_disjoint_rows_streams(_schema, _permit))
+        , _many_partitions(create_many_partitions(_schema, _permit))
     { }
 };
 
@@ -136,6 +142,32 @@ std::vector<std::vector<mutation>> combined::create_overlapping_partitions_disjo
     return mss;
 }
 
+std::vector<mutation> combined::create_many_partitions(simple_schema& s, reader_permit permit)
+{
+    return boost::copy_range<std::vector<mutation>>(
+        s.make_pkeys(256)
+        | boost::adaptors::transformed([&] (auto& dkey) {
+            auto m = mutation(s.schema(), dkey);
+            for (auto i = 0; i < 4; i++) {
+                m.apply(s.make_row(permit, s.make_ckey(i), "value"));
+            }
+            return m;
+        })
+    );
+}
+
+future<> combined::consume_disjoint_sources(size_t sources) const
+{
+    std::vector<flat_mutation_reader_v2> mrs;
+    mrs.reserve(sources);
+    auto slice = _many_partitions.size() / sources;
+    for (size_t i = 0; i < sources; i++) {
+        auto ms = boost::copy_range<std::vector<mutation>>(_many_partitions | boost::adaptors::sliced(i * slice, (i + 1) * slice));
+        mrs.emplace_back(upgrade_to_v2(make_flat_mutation_reader_from_mutations(schema().schema(), permit(), std::move(ms))));
+    }
+    return consume_all(make_combined_reader(schema().schema(), permit(), std::move(mrs)));
+}
+
 future<> combined::consume_all(flat_mutation_reader_v2 mr) const
 {
     return with_closeable(downgrade_to_v1(std::move(mr)), [] (auto& mr) {
@@ -213,6 +245,26 @@ PERF_TEST_F(combined, overlapping_partitions_disjoint_rows)
     ));
 }
 
+PERF_TEST_F(combined, disjoint_sources_1)
+{
+    return consume_disjoint_sources(1);
+}
+
+PERF_TEST_F(combined, disjoint_sources_4)
+{
+    return consume_disjoint_sources(4);
+}
+
+PERF_TEST_F(combined, disjoint_sources_16)
+{
+    return consume_disjoint_sources(16);
+}
+
+PERF_TEST_F(combined, disjoint_sources_64)
+{
+    return consume_disjoint_sources(64);
+}
+
 struct mutation_bounds {
     mutation m;
     position_in_partition lower;
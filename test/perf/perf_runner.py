@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+# Runs the workloads of a profile with the perf_simple_query benchmark, collects
+# their results into a single JSON file and optionally compares them with the
+# results of an earlier run (the baseline), failing if any of them regressed.
+#
+# A profile is a JSON file of the form:
+#
+#   {
+#       "defaults": { "smp": 1, "memory": "1G", "duration": 5 },
+#       "workloads": [
+#           { "name": "read-cached", "mode": "read", "partitions": 10000 },
+#           { "name": "read-uncached", "mode": "read", "cache": false, "flush": true },
+#           { "name": "write", "mode": "write", "batch_size": 4 },
+#           ...
+#       ]
+#   }
+#
+# See the profiles/ directory for examples and make_args() below for the
+# supported workload parameters. The parameters in "defaults" apply to all
+# workloads which don't override them.
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+# The statistics compared with the baseline, and whether higher is better.
+compared_stats = {
+    'median tps': True,
+    'allocs_per_op': False,
+    'tasks_per_op': False,
+    'instructions_per_op': False,
+}
+
+
+def make_args(workload):
+    args = []
+    for param, flag in [('smp', '--smp'), ('memory', '-m'), ('duration', '--duration'),
+                        ('partitions', '--partitions'), ('concurrency', '--concurrency'),
+                        ('operations_per_shard', '--operations-per-shard'), ('batch_size', '--batch-size'),
+                        ('random_seed', '--random-seed')]:
+        if param in workload:
+            args += [flag, str(workload[param])]
+
+    mode = workload.get('mode', 'read')
+    if mode == 'write':
+        args.append('--write')
+    elif mode == 'delete':
+        args.append('--delete')
+    elif mode != 'read':
+        raise ValueError(f"invalid mode of workload {workload['name']}: {mode}")
+
+    if workload.get('counters', False):
+        args.append('--counters')
+    if workload.get('flush', False):
+        args.append('--flush')
+    if workload.get('query_single_key', False):
+        args.append('--query-single-key')
+    if 'cache' in workload:
+        args += ['--enable-cache', '1' if workload['cache'] else '0']
+    return args + workload.get('extra_args', [])
+
+
+def run_workload(binary, workload):
+    with tempfile.TemporaryDirectory() as tmpdir:
+        result_file = os.path.join(tmpdir, 'result.json')
+        args = [binary] + make_args(workload) + ['--json-result', result_file]
+        print(f"Running {workload['name']}: {' '.join(args)}", file=sys.stderr)
+        subprocess.check_call(args, stdout=sys.stderr)
+        with open(result_file) as f:
+            return json.load(f)
+
+
+def compare(results, baseline, tolerance):
+    regressions = []
+    for name, result in results.items():
+        if name not in baseline:
+            print(f"{name}: not in the baseline, skipping", file=sys.stderr)
+            continue
+        for stat, higher_is_better in compared_stats.items():
+            new = result['stats'][stat]
+            old = baseline[name]['stats'][stat]
+            if old == 0:
+                continue
+            change = (new - old) / old
+            regressed = change < -tolerance if higher_is_better else change > tolerance
+            print(f"{name}: {stat}: {old:.2f} -> {new:.2f} ({change:+.2%}){' REGRESSION' if regressed else ''}")
+            if regressed:
+                regressions.append((name, stat))
+    return regressions
+
+
+def main():
+    cmdline_parser = argparse.ArgumentParser(formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+    cmdline_parser.add_argument('profile', help='JSON file with the workloads to run')
+    cmdline_parser.add_argument('--binary', default='build/release/test/perf/perf_simple_query', help='path of the perf_simple_query binary')
+    cmdline_parser.add_argument('-o', '--output', help='name of the file to write the results to, stdout if not given')
+    cmdline_parser.add_argument('--baseline', help='results of an earlier run to compare the results with')
+    cmdline_parser.add_argument('--tolerance', type=float, default=0.05, help='relative change of a statistic which is considered a regression')
+    cmdline_parser.add_argument('--workload', action='append', help='name of a workload of the profile to run, all of them if not given')
+    args = cmdline_parser.parse_args()
+
+    with open(args.profile) as f:
+        profile = json.load(f)
+
+    results = {}
+    for workload in profile['workloads']:
+        if args.workload and workload['name'] not in args.workload:
+            continue
+        results[workload['name']] = run_workload(args.binary, {**profile.get('defaults', {}), **workload})
+
+    output = json.dumps(results, indent=4)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(output)
+    else:
+        print(output)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        if compare(results, baseline, args.tolerance):
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
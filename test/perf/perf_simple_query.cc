@@ -71,6 +71,7 @@ struct test_config {
     bool counters;
     bool flush_memtables;
     unsigned operations_per_shard = 0;
+    unsigned batch_size = 1;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -97,6 +98,7 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", frontend=" << cfg.frontend
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", batch_size=" << cfg.batch_size
            << "}";
 }
 
@@ -134,16 +136,30 @@ static std::vector<perf_result> test_read(cql_test_env& env, test_config& cfg) {
 }
 
 static std::vector<perf_result> test_write(cql_test_env& env, test_config& cfg) {
-    auto id = env.prepare("UPDATE cf SET "
+    sstring update = "UPDATE cf SET "
                            "\"C0\" = 0x8f75da6b3dcec90c8a404fb9a5f6b0621e62d39c69ba5758e5f41b78311fbb26cc7a,"
                            "\"C1\" = 0xa8761a2127160003033a8f4f3d1069b7833ebe24ef56b3beee728c2b686ca516fa51,"
                            "\"C2\" = 0x583449ce81bfebc2e1a695eb59aad5fcc74d6d7311fc6197b10693e1a161ca2e1c64,"
                            "\"C3\" = 0x62bcb1dbc0ff953abc703bcb63ea954f437064c0c45366799658bd6b91d0f92908d7,"
                            "\"C4\" = 0x222fcbe31ffa1e689540e1499b87fa3f9c781065fccd10e4772b4c7039c2efd0fb27 "
-                           "WHERE \"KEY\" = ?;").get0();
+                           "WHERE \"KEY\" = ?;";
+    if (cfg.batch_size > 1) {
+        // Each operation is an unlogged batch of updates to random partitions,
+        // most of which are owned by other shards.
+        sstring batch = "BEGIN UNLOGGED BATCH ";
+        for (unsigned i = 0; i < cfg.batch_size; ++i) {
+            batch += update + " ";
+        }
+        update = batch + "APPLY BATCH;";
+    }
+    auto id = env.prepare(update).get0();
     return time_parallel([&env, &cfg, id] {
-            bytes key = make_random_key(cfg);
-            return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+            std::vector<cql3::raw_value> keys;
+            keys.reserve(cfg.batch_size);
+            for (unsigned i = 0; i < std::max(cfg.batch_size, 1u); ++i) {
+                keys.push_back(cql3::raw_value::make_value(make_random_key(cfg)));
+            }
+            return env.execute_prepared(id, std::move(keys)).discard_result();
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard);
 }
 
@@ -423,6 +439,7 @@ void write_json_result(std::string result_file, const test_config& cfg, perf_res
     params["partitions"] = cfg.partitions;
     params["cpus"] = smp::count;
     params["duration"] = cfg.duration_in_seconds;
+    params["batch_size"] = cfg.batch_size;
     params["concurrency,partitions,cpus,duration"] = fmt::format("{},{},{},{}", cfg.concurrency, cfg.partitions, smp::count, cfg.duration_in_seconds);
     results["parameters"] = std::move(params);
 
@@ -490,6 +507,8 @@ int main(int argc, char** argv) {
         ("json-result", bpo::value<std::string>(), "name of the json result file")
         ("enable-cache", bpo::value<bool>()->default_value(true), "enable row cache")
         ("alternator", bpo::value<std::string>(), "use alternator frontend instead of CQL with given write isolation")
+        ("batch-size", bpo::value<unsigned>()->default_value(1), "number of partitions written by each operation of the CQL write test, as an unlogged batch")
+        ("cross-shard-write-batching", bpo::value<bool>()->default_value(true), "send the mutations applied on other shards in one message per shard")
         ;
 
     set_abort_on_internal_error(true);
@@ -509,6 +528,10 @@ int main(int argc, char** argv) {
             std::cout << "enable-cache=" << enable_cache << '\n';
             db_cfg->enable_cache(enable_cache);
 
+            const auto cross_shard_write_batching = app.configuration()["cross-shard-write-batching"].as<bool>();
+            std::cout << "cross-shard-write-batching=" << cross_shard_write_batching << '\n';
+            db_cfg->enable_cross_shard_write_batching(cross_shard_write_batching);
+
             cql_test_config cfg(db_cfg);
           return do_with_cql_env_thread([&app] (auto&& env) {
             auto cfg = test_config();
@@ -518,6 +541,7 @@ int main(int argc, char** argv) {
             cfg.query_single_key = app.configuration().contains("query-single-key");
             cfg.counters = app.configuration().contains("counters");
             cfg.flush_memtables = app.configuration().contains("flush");
+            cfg.batch_size = app.configuration()["batch-size"].as<unsigned>();
             if (app.configuration().contains("write")) {
                 cfg.mode = test_config::run_mode::write;
             } else if (app.configuration().contains("delete")) {
@@ -35,13 +35,7 @@ future<> test_write(distributed<perf_sstable_test_env>& dt) {
 }
 
 future<> test_compaction(distributed<perf_sstable_test_env>& dt) {
-    return seastar::async([&dt] {
-        dt.invoke_on_all([] (perf_sstable_test_env &t) {
-            return t.fill_memtable();
-        }).then([&dt] {
-            return time_runs(iterations, parallelism, dt, &perf_sstable_test_env::compaction);
-        }).get();
-    });
+    return time_runs(iterations, parallelism, dt, &perf_sstable_test_env::compaction);
 }
 
 future<> test_index_read(distributed<perf_sstable_test_env>& dt) {
@@ -84,7 +78,10 @@ int main(int argc, char** argv) {
         ("testdir", bpo::value<sstring>()->default_value("/var/lib/scylla/perf-tests"), "directory in which to store the sstables")
         ("compaction-strategy", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy"), "compaction strategy to use, one of "
              "(SizeTieredCompactionStrategy, LeveledCompactionStrategy, DateTieredCompactionStrategy, TimeWindowCompactionStrategy)")
-        ("timestamp-range", bpo::value<api::timestamp_type>()->default_value(0), "Timestamp values to use, chosen uniformly from: [-x, +x]");
+        ("timestamp-range", bpo::value<api::timestamp_type>()->default_value(0), "Timestamp values to use, chosen uniformly from: [-x, +x]")
+        ("overlap", bpo::value<double>()->default_value(1), "fraction of the partitions of each sstable which are also in all the other sstables (valid only for compaction mode)")
+        ("tombstone-ratio", bpo::value<double>()->default_value(0), "fraction of the cells which are written as tombstones (valid only for compaction mode)")
+        ("compressor", bpo::value<sstring>()->default_value(""), "sstable compressor to use, e.g. LZ4Compressor, or none (default compression if not given)");
 
     return app.run_deprecated(argc, argv, [&app] {
         auto test = make_lw_shared<distributed<perf_sstable_test_env>>();
@@ -108,6 +105,9 @@ int main(int argc, char** argv) {
         }
         cfg.compaction_strategy = sstables::compaction_strategy::type(app.configuration()["compaction-strategy"].as<sstring>());
         cfg.timestamp_range = app.configuration()["timestamp-range"].as<api::timestamp_type>();
+        cfg.overlap = app.configuration()["overlap"].as<double>();
+        cfg.tombstone_ratio = app.configuration()["tombstone-ratio"].as<double>();
+        cfg.compressor = app.configuration()["compressor"].as<sstring>();
         return test->start(std::move(cfg)).then([mode, dir, test] {
             engine().at_exit([test] { return test->stop(); });
             if ((mode == test_modes::index_read) ||
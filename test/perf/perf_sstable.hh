@@ -18,6 +18,7 @@
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/test_services.hh"
 #include "test/lib/random_utils.hh"
+#include "test/perf/perf.hh"
 #include <boost/accumulators/framework/accumulator_set.hpp>
 #include <boost/accumulators/framework/features.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -40,6 +41,12 @@ class perf_sstable_test_env {
         sstring dir;
         sstables::compaction_strategy_type compaction_strategy;
         api::timestamp_type timestamp_range;
+        // Compaction mode only: the fraction of the partitions of each sstable
+        // which are also in all the others, the fraction of the cells written
+        // as tombstones and the compressor (default if empty).
+        double overlap = 1;
+        double tombstone_ratio = 0;
+        sstring compressor;
     };
 
 private:
@@ -92,6 +99,11 @@ class perf_sstable_test_env {
             "Perf tests"
         ));
         builder.set_compaction_strategy(type);
+        if (_cfg.compressor == "none") {
+            builder.set_compressor_params(compression_parameters::no_compression());
+        } else if (!_cfg.compressor.empty()) {
+            builder.set_compressor_params(compression_parameters({{compression_parameters::SSTABLE_COMPRESSION, _cfg.compressor}}));
+        }
         return builder.build(schema_builder::compact_storage::no);
     }
 
@@ -111,17 +123,24 @@ class perf_sstable_test_env {
         auto idx = boost::irange(0, int(_cfg.partitions / _cfg.sstables));
         auto local_keys = make_local_keys(int(_cfg.partitions / _cfg.sstables), s, _cfg.key_size);
         return do_for_each(idx.begin(), idx.end(), [this, local_keys = std::move(local_keys)] (auto iteration) {
-            auto key = partition_key::from_deeply_exploded(*s, { local_keys.at(iteration) });
-            auto mut = mutation(this->s, key);
-            for (auto& cdef: this->s->regular_columns()) {
-                const auto ts = _cfg.timestamp_range ? tests::random::get_int<api::timestamp_type>(-_cfg.timestamp_range, _cfg.timestamp_range) : 0;
-                mut.set_clustered_cell(clustering_key::make_empty(), cdef, atomic_cell::make_live(*utf8_type, ts, utf8_type->decompose(this->random_column())));
-            }
-            this->_mt->apply(std::move(mut));
+            this->_mt->apply(make_mutation(local_keys.at(iteration)));
             return make_ready_future<>();
         });
     }
 
+    mutation make_mutation(const sstring& key) {
+        auto mut = mutation(s, partition_key::from_deeply_exploded(*s, { key }));
+        for (auto& cdef: s->regular_columns()) {
+            const auto ts = _cfg.timestamp_range ? tests::random::get_int<api::timestamp_type>(-_cfg.timestamp_range, _cfg.timestamp_range) : 0;
+            if (_cfg.tombstone_ratio > 0 && tests::random::get_real<double>(0, 1) < _cfg.tombstone_ratio) {
+                mut.set_clustered_cell(clustering_key::make_empty(), cdef, atomic_cell::make_dead(ts, gc_clock::now()));
+            } else {
+                mut.set_clustered_cell(clustering_key::make_empty(), cdef, atomic_cell::make_live(*utf8_type, ts, utf8_type->decompose(random_column())));
+            }
+        }
+        return mut;
+    }
+
     future<> load_sstables(unsigned iterations) {
         _sst.push_back(_env.make_sstable(s, this->dir(), 0, sstables::get_highest_sstable_version(), sstable::format_types::big));
         return _sst.back()->load();
@@ -159,20 +178,37 @@ class perf_sstable_test_env {
                     return _env.make_sstable(s, dir(), (*gen)++, sstables::get_highest_sstable_version(), sstable::format_types::big, _cfg.buffer_size);
                 };
 
+                // Each sstable has the first `shared` keys of the pool, which
+                // are in all of them, and `partitions_per_sstable - shared`
+                // keys of its own.
+                const auto partitions_per_sstable = _cfg.partitions / _cfg.sstables;
+                const auto shared = unsigned(partitions_per_sstable * std::clamp(_cfg.overlap, 0.0, 1.0));
+                const auto keys = make_local_keys(shared + (partitions_per_sstable - shared) * _cfg.sstables, s, _cfg.key_size);
+
                 std::vector<shared_sstable> ssts;
+                uint64_t input_size = 0;
                 for (auto i = 0u; i < _cfg.sstables; i++) {
+                    auto mt = make_lw_shared<memtable>(s);
+                    for (auto k = 0u; k < partitions_per_sstable; ++k) {
+                        auto key_idx = k < shared ? k : shared + (partitions_per_sstable - shared) * i + (k - shared);
+                        mt->apply(make_mutation(keys.at(key_idx)));
+                    }
                     auto sst = sst_gen();
-                    write_memtable_to_sstable_for_test(*_mt, sst).get();
+                    write_memtable_to_sstable_for_test(*mt, sst).get();
                     sst->open_data().get();
-                    _mt->revert_flushed_memory();
+                    input_size += sst->data_size();
                     ssts.push_back(std::move(sst));
                 }
+                const auto input_sstables = ssts.size();
 
                 cache_tracker tracker;
                 cell_locker_stats cl_stats;
                 auto cm = make_lw_shared<compaction_manager>();
                 auto cf = make_lw_shared<replica::column_family>(s, column_family_test_config(env.manager(), env.semaphore()), replica::column_family::no_commitlog(), *cm, cl_stats, tracker);
 
+                auto instructions = linux_perf_event::user_instructions_retired();
+                const auto mallocs_before = perf_mallocs();
+                instructions.enable();
                 auto start = perf_sstable_test_env::now();
 
                 auto descriptor = sstables::compaction_descriptor(std::move(ssts), cf->get_sstable_set(), default_priority_class());
@@ -183,8 +219,9 @@ class perf_sstable_test_env {
                 auto cdata = compaction_manager::create_compaction_data();
                 auto ret = sstables::compact_sstables(std::move(descriptor), cdata, cf->as_table_state()).get0();
                 auto end = perf_sstable_test_env::now();
+                instructions.disable();
+                const auto mallocs = perf_mallocs() - mallocs_before;
 
-                auto partitions_per_sstable = _cfg.partitions / _cfg.sstables;
                 if (_cfg.compaction_strategy != sstables::compaction_strategy_type::time_window) {
                     assert(ret.new_sstables.size() == 1);
                 }
@@ -194,6 +231,14 @@ class perf_sstable_test_env {
                 assert(total_keys_written >= partitions_per_sstable);
 
                 auto duration = std::chrono::duration<double>(end - start).count();
+                // Input rows, there is a single row in each partition.
+                const auto rows = double(partitions_per_sstable * input_sstables);
+                // With a single row per partition, a point read has to look at
+                // as many sstables as hold the partition. All the output sstables
+                // of a job may hold any partition, except for TWCS, which splits
+                // by time.
+                std::cout << format("compaction: {:.2f} MB/s, {:.0f} instructions/row, {:.2f} allocations/row, {} -> {} sstables\n",
+                        input_size / duration / (1 << 20), instructions.read() / rows, mallocs / rows, input_sstables, ret.new_sstables.size());
                 return total_keys_written / duration;
             });
         });
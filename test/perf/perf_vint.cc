@@ -9,6 +9,7 @@
 #include "seastar/include/seastar/testing/perf_tests.hh"
 #include <seastar/testing/test_runner.hh>
 
+#include <limits>
 #include <random>
 
 #include "vint-serialization.hh"
@@ -20,12 +21,12 @@ class vint {
     std::vector<uint64_t> _integers;
     bytes _serialized;
 public:
-    vint()
+    explicit vint(uint64_t max = std::numeric_limits<uint64_t>::max())
         : _integers(count)
         , _serialized(bytes::initialized_later{}, count * max_vint_length)
     {
         auto eng = seastar::testing::local_random_engine;
-        auto dist = std::uniform_int_distribution<uint64_t>{};
+        auto dist = std::uniform_int_distribution<uint64_t>{0, max};
         std::generate_n(_integers.begin(), count, [&] { return dist(eng); });
 
         auto dst = _serialized.data();
@@ -36,7 +37,13 @@ class vint {
     }
 
     const std::vector<uint64_t>& integers() const { return _integers; }
-    bytes_view serialized() const { return bytes_view(_serialized.data()); }
+    bytes_view serialized() const { return bytes_view(_serialized); }
+};
+
+// Values like the ones in the row and cell headers of mx sstables, which mostly fit in one byte.
+class small_vint : public vint {
+public:
+    small_vint() : vint(200) { }
 };
 
 PERF_TEST_F(vint, serialize) {
@@ -58,3 +65,27 @@ PERF_TEST_F(vint, deserialize) {
     }
     return count;
 }
+
+PERF_TEST_F(vint, deserialize_many) {
+    std::array<uint64_t, count> output;
+    perf_tests::do_not_optimize(unsigned_vint::deserialize_many(serialized(), output));
+    perf_tests::do_not_optimize(output);
+    return count;
+}
+
+PERF_TEST_F(small_vint, deserialize) {
+    auto src = serialized();
+    for (auto i = 0u; i < count; i++) {
+        auto len = unsigned_vint::serialized_size_from_first_byte(src.front());
+        perf_tests::do_not_optimize(unsigned_vint::deserialize(src));
+        src.remove_prefix(len);
+    }
+    return count;
+}
+
+PERF_TEST_F(small_vint, deserialize_many) {
+    std::array<uint64_t, count> output;
+    perf_tests::do_not_optimize(unsigned_vint::deserialize_many(serialized(), output));
+    perf_tests::do_not_optimize(output);
+    return count;
+}
@@ -35,7 +35,6 @@ def test_hset_hget_delete(redis_host, redis_port):
     assert r.delete(key) == 1
     assert r.hget(key, field) == None 
 
-@pytest.mark.xfail(reason="HSET command does not support multiple key/field")
 def test_hset_multiple_key_field(redis_host, redis_port):
     # This test requires the library to support multiple mappings in one
     # command, or we cannot test this feature. This was added to redis-py
@@ -51,6 +50,22 @@ def test_hset_multiple_key_field(redis_host, redis_port):
     val2 = random_string(10)
 
     assert r.hset(key, None, None, {field: val, field2: val2}) == 2
+    assert r.hget(key, field) == val
+    assert r.hget(key, field2) == val2
+
+def test_hmget(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    field = random_string(10)
+    val = random_string(10)
+    field2 = random_string(10)
+    val2 = random_string(10)
+    missing_field = random_string(10)
+
+    assert r.hset(key, field, val) == 1
+    assert r.hset(key, field2, val2) == 1
+    assert r.hmget(key, [field2, missing_field, field, field2]) == [val2, None, val, val2]
+    r.delete(key)
 
 @pytest.mark.xfail(reason="HSET command does not support return of changes, it always return 1")
 def test_hset_return_changes(redis_host, redis_port):
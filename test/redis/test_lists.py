@@ -0,0 +1,82 @@
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import pytest
+import redis
+import logging
+from util import random_string, connect
+
+logger = logging.getLogger('redis-test')
+
+def test_rpush_lrange(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    vals = [random_string(10) for _ in range(4)]
+    r.delete(key)
+
+    r.rpush(key, vals[0], vals[1])
+    r.rpush(key, vals[2], vals[3])
+    assert r.lrange(key, 0, -1) == vals
+    assert r.lrange(key, 1, 2) == vals[1:3]
+    assert r.lrange(key, -2, -1) == vals[2:]
+    assert r.lrange(key, 5, 10) == []
+    r.delete(key)
+
+def test_lpush_lrange(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    vals = [random_string(10) for _ in range(3)]
+    r.delete(key)
+
+    r.rpush(key, vals[1])
+    r.lpush(key, vals[0])
+    r.rpush(key, vals[2])
+    assert r.lrange(key, 0, -1) == vals
+    r.delete(key)
+
+def test_lrange_nonexistent_key(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    r.delete(key)
+
+    assert r.lrange(key, 0, -1) == []
+
+def test_push_wrong_number_of_arguments(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command("RPUSH testkey")
+    assert "wrong number of arguments for 'rpush' command" in str(excinfo.value)
+
+def test_lrange_invalid_index(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    r.delete(key)
+    r.rpush(key, random_string(10))
+
+    for start, stop in [("0x", "1"), ("0", "1a"), ("", "1"), ("0", " 1")]:
+        with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+            r.execute_command("LRANGE", key, start, stop)
+        assert "invalid argument for 'lrange' command" in str(excinfo.value)
+    r.delete(key)
+
+def test_concurrent_pushes(redis_host, redis_port):
+    key = random_string(10)
+    clients = [connect(redis_host, redis_port) for _ in range(4)]
+    clients[0].delete(key)
+
+    # Values pushed by different connections at the same time, possibly
+    # handled by different shards, must all make it to the list.
+    pipes = [c.pipeline(transaction=False) for c in clients]
+    vals = []
+    for i in range(100):
+        val = random_string(10)
+        vals.append(val)
+        pipes[i % len(pipes)].rpush(key, val)
+    for p in pipes:
+        p.execute()
+    assert sorted(clients[0].lrange(key, 0, -1)) == sorted(vals)
+    clients[0].delete(key)
@@ -231,3 +231,21 @@ def test_strlen_wrongtype(redis_host, redis_port):
         r.strlen(key1)
     except redis.exceptions.ResponseError as ex:
         assert str(ex) == 'WRONGTYPE Operation against a key holding the wrong kind of value'
+
+def test_mset_mget(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    keys = [random_string(10) for _ in range(3)]
+    vals = [random_string(10) for _ in range(3)]
+    missing = random_string(10)
+    r.delete(missing)
+
+    assert r.mset(dict(zip(keys, vals))) == True
+    assert r.mget(keys + [missing, keys[0]]) == vals + [None, vals[0]]
+    for key in keys:
+        r.delete(key)
+
+def test_mset_wrong_number_of_arguments(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    with pytest.raises(redis.exceptions.ResponseError):
+        r.execute_command("MSET", key)
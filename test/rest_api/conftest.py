@@ -41,14 +41,14 @@ class RestApiSession:
         self.port = port
         self.session = requests.Session()
 
-    def send(self, method, path, params={}):
+    def send(self, method, path, params={}, data=None):
         url=f"http://{self.host}:{self.port}/{path}"
         if params:
             sep = '?'
             for key, value in params.items():
                 url += f"{sep}{key}={value}"
                 sep = '&'
-        req = self.session.prepare_request(requests.Request(method, url))
+        req = self.session.prepare_request(requests.Request(method, url, data=data))
         return self.session.send(req)
 
 # "api" fixture: set up client object for communicating with Scylla API.
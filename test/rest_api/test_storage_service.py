@@ -3,6 +3,7 @@
 # SPDX-License-Identifier: AGPL-3.0-or-later
 
 import pytest
+import struct
 import sys
 import requests
 
@@ -95,3 +96,62 @@ def test_storage_service_keyspace_offstrategy_compaction_tables(cql, this_dc, re
             assert resp.status_code == requests.codes.bad_request
 
     cql.execute(f"DROP KEYSPACE {keyspace}")
+
+# Encodes a bulk load row: each value is prefixed by its 4-byte length, and
+# None leaves the column unset.
+def bulk_load_row(*values):
+    row = b''
+    for v in values:
+        if v is None:
+            row += struct.pack('>i', -1)
+        else:
+            row += struct.pack('>i', len(v)) + v
+    return row
+
+def test_storage_service_bulk_load(cql, this_dc, rest_api):
+    keyspace = new_keyspace(cql, this_dc)
+    with new_test_table(cql, keyspace, "p int, c int, v text, PRIMARY KEY (p, c)") as t:
+        test_table = t.split('.')[1]
+        rows = bulk_load_row(struct.pack('>i', 1), struct.pack('>i', 2), b'hello')
+        rows += bulk_load_row(struct.pack('>i', 1), struct.pack('>i', 1), None)
+        rows += bulk_load_row(struct.pack('>i', 0), struct.pack('>i', 3), b'')
+        resp = rest_api.send("POST", f"storage_service/bulk_load/{keyspace}", { "cf": test_table }, rows)
+        resp.raise_for_status()
+        assert resp.json() == 3
+        assert sorted(cql.execute(f"SELECT p, c, v FROM {t}")) == [(0, 3, ''), (1, 1, None), (1, 2, 'hello')]
+
+        # a truncated row
+        resp = rest_api.send("POST", f"storage_service/bulk_load/{keyspace}", { "cf": test_table }, rows[:-1])
+        assert resp.status_code == requests.codes.bad_request
+
+        # an invalid value
+        bad_row = bulk_load_row(struct.pack('>i', 1), b'\x00\x01', b'hello')
+        resp = rest_api.send("POST", f"storage_service/bulk_load/{keyspace}", { "cf": test_table }, bad_row)
+        assert resp.status_code == requests.codes.bad_request
+
+        # non-existing table
+        resp = rest_api.send("POST", f"storage_service/bulk_load/{keyspace}", { "cf": "XXX" }, rows)
+        assert resp.status_code == requests.codes.bad_request
+
+    cql.execute(f"DROP KEYSPACE {keyspace}")
+
+# Loads larger than 16MB are written to sstables and streamed to the replicas
+# instead of being applied through the memtables.
+def test_storage_service_bulk_load_sstables(cql, this_dc, rest_api):
+    keyspace = new_keyspace(cql, this_dc)
+    with new_test_table(cql, keyspace, "p int, c int, v text, PRIMARY KEY (p, c)") as t:
+        test_table = t.split('.')[1]
+        value = b'x' * 1000
+        nrows = 20000
+        # Rows of the same partition are spread over the input, out of order.
+        rows = b''.join(bulk_load_row(struct.pack('>i', i % 100), struct.pack('>i', i), value) for i in reversed(range(nrows)))
+        assert len(rows) >= 16 * 1024 * 1024
+        resp = rest_api.send("POST", f"storage_service/bulk_load/{keyspace}", { "cf": test_table }, rows)
+        resp.raise_for_status()
+        assert resp.json() == nrows
+        assert list(cql.execute(f"SELECT COUNT(*) FROM {t}"))[0][0] == nrows
+        res = list(cql.execute(f"SELECT c, v FROM {t} WHERE p = 7"))
+        assert [r.c for r in res] == list(range(7, nrows, 100))
+        assert all(r.v == value.decode() for r in res)
+
+    cql.execute(f"DROP KEYSPACE {keyspace}")
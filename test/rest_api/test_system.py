@@ -5,3 +5,19 @@
 def test_system_uptime_ms(rest_api):
     resp = rest_api.send('GET', "system/uptime_ms")
     resp.raise_for_status()
+
+def test_system_cpu_profiler(rest_api):
+    resp = rest_api.send('POST', "system/cpu_profiler", {"frequency": "1000"})
+    resp.raise_for_status()
+    try:
+        # Keep the shards busy, so that there is something to sample
+        for _ in range(100):
+            rest_api.send('GET', "system/uptime_ms").raise_for_status()
+        resp = rest_api.send('GET', "system/cpu_profiler", {"reset": "true"})
+        resp.raise_for_status()
+        for line in resp.json():
+            stack, count = line.rsplit(' ', 1)
+            assert int(count) > 0
+            assert ';' in stack
+    finally:
+        rest_api.send('POST', "system/cpu_profiler", {"frequency": "0"}).raise_for_status()
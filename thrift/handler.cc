@@ -1211,23 +1211,25 @@ class thrift_handler : public CassandraCobSvIf {
                 auto& col = _metadata.get_names()[_column_id++];
 
                 Column& c = _columns.emplace_back();
-                c.__set_name(col->name->to_string());
+                c.name = col->name->to_string();
                 if (cell) {
-                    c.__set_value(bytes_to_string(*cell));
+                    c.value = bytes_to_string(*cell);
+                    c.__isset.value = true;
                 }
 
             }
             void end_row() {
                 CqlRow& r = _rows.emplace_back();
                 r.__set_key(std::string());
-                r.__set_columns(std::move(_columns));
+                r.columns = std::move(_columns);
                 _columns = { };
             }
         };
 
         visitor v { {}, rs.get_metadata(), {}, {} };
         rs.visit(v);
-        result.__set_rows(std::move(v._rows));
+        result.rows = std::move(v._rows);
+        result.__isset.rows = true;
         return result;
     }
     static KsDef get_keyspace_definition(const data_dictionary::keyspace& ks) {
@@ -1637,10 +1639,14 @@ class thrift_handler : public CassandraCobSvIf {
         }
         return ranges;
     }
+    // The __set_*() setters generated by thrift take their argument by const
+    // reference and copy it, so the columns of results, which are built for
+    // every cell read, have their fields moved in directly instead.
     static Column make_column(const bytes& col, const query::result_atomic_cell_view& cell) {
         Column ret;
-        ret.__set_name(bytes_to_string(col));
-        ret.__set_value(bytes_to_string(cell.value()));
+        ret.name = bytes_to_string(col);
+        ret.value = bytes_to_string(cell.value());
+        ret.__isset.value = true;
         ret.__set_timestamp(cell.timestamp());
         if (cell.ttl()) {
             ret.__set_ttl(cell.ttl()->count());
@@ -1649,7 +1655,8 @@ class thrift_handler : public CassandraCobSvIf {
     }
     static ColumnOrSuperColumn column_to_column_or_supercolumn(Column&& col) {
         ColumnOrSuperColumn ret;
-        ret.__set_column(std::move(col));
+        ret.column = std::move(col);
+        ret.__isset.column = true;
         return ret;
     }
     static ColumnOrSuperColumn make_column_or_supercolumn(const bytes& col, const query::result_atomic_cell_view& cell) {
@@ -1657,7 +1664,7 @@ class thrift_handler : public CassandraCobSvIf {
     }
     static CounterColumn make_counter_column(const bytes& col, const query::result_atomic_cell_view& cell) {
         CounterColumn ret;
-        ret.__set_name(bytes_to_string(col));
+        ret.name = bytes_to_string(col);
         cell.value().with_linearized([&] (bytes_view value_view) {
             ret.__set_value(value_cast<int64_t>(long_type->deserialize_value(value_view)));
         });
@@ -1665,7 +1672,8 @@ class thrift_handler : public CassandraCobSvIf {
     }
     static ColumnOrSuperColumn counter_column_to_column_or_supercolumn(CounterColumn&& col) {
         ColumnOrSuperColumn ret;
-        ret.__set_counter_column(std::move(col));
+        ret.counter_column = std::move(col);
+        ret.__isset.counter_column = true;
         return ret;
     }
     static ColumnOrSuperColumn make_counter_column_or_supercolumn(const bytes& col, const query::result_atomic_cell_view& cell) {
@@ -1836,16 +1844,12 @@ class thrift_handler : public CassandraCobSvIf {
         v.consume(slice, aggregator);
         auto&& cols = aggregator.release();
         std::vector<KeySlice> ret;
-        std::transform(
-                std::make_move_iterator(cols.begin()),
-                std::make_move_iterator(cols.end()),
-                boost::back_move_inserter(ret),
-                [](auto&& p) {
-            KeySlice ks;
-            ks.__set_key(std::move(p.first));
-            ks.__set_columns(std::move(p.second));
-            return ks;
-        });
+        ret.reserve(cols.size());
+        for (auto&& [key, columns] : cols) {
+            KeySlice& ks = ret.emplace_back();
+            ks.key = std::move(key);
+            ks.columns = std::move(columns);
+        }
         return ret;
     }
     template<typename RangeType, typename Comparator, typename RangeComparator>
@@ -24,6 +24,8 @@ extern logging::logger dblog;
 class repair_history_map {
 public:
     boost::icl::interval_map<dht::token, gc_clock::time_point, boost::icl::partial_absorber, std::less, boost::icl::inplace_max> map;
+    // Bumped by every update of the map, see gc_before_cursor.
+    uint64_t version = 0;
 };
 
 thread_local std::unordered_map<utils::UUID, seastar::lw_shared_ptr<repair_history_map>> repair_history_maps;
@@ -155,6 +157,65 @@ gc_clock::time_point get_gc_before_for_key(schema_ptr s, const dht::decorated_ke
 void update_repair_time(schema_ptr s, const dht::token_range& range, gc_clock::time_point repair_time) {
     auto m = get_or_create_repair_history_map_for_table(s->id());
     m->map += std::make_pair(locator::token_metadata::range_to_interval(range), repair_time);
+    ++m->version;
+}
+
+gc_before_cursor::gc_before_cursor(const schema& s, gc_clock::time_point query_time)
+    : _schema(s)
+{
+    set_query_time(query_time);
+}
+
+gc_before_cursor::~gc_before_cursor() = default;
+
+void gc_before_cursor::set_query_time(gc_clock::time_point query_time) {
+    _query_time = query_time;
+    _range.reset();
+    const auto& options = _schema.tombstone_gc_options();
+    switch (options.mode()) {
+    case tombstone_gc_mode::timeout:
+        _gc_before = saturating_subtract(query_time, _schema.gc_grace_seconds());
+        break;
+    case tombstone_gc_mode::disabled:
+        _gc_before = gc_clock::time_point::min();
+        break;
+    case tombstone_gc_mode::immediate:
+        _gc_before = gc_clock::time_point::max();
+        break;
+    case tombstone_gc_mode::repair:
+        // Doesn't depend on the query time.
+        break;
+    }
+}
+
+gc_clock::time_point gc_before_cursor::get(const dht::decorated_key& dk) {
+    const auto& options = _schema.tombstone_gc_options();
+    if (options.mode() != tombstone_gc_mode::repair) {
+        return _gc_before;
+    }
+    if (!_map) {
+        _map = get_repair_history_map_for_table(_schema.id());
+        if (!_map) {
+            return gc_clock::time_point::min();
+        }
+    }
+    if (_map->version != _map_version) {
+        _map_version = _map->version;
+        _range.reset();
+    }
+    if (_range && _range->contains(dk.token(), dht::tri_compare)) {
+        return _gc_before;
+    }
+    const auto it = _map->map.find(dk.token());
+    if (it == _map->map.end()) {
+        _range.reset();
+        return gc_clock::time_point::min();
+    }
+    _range = locator::token_metadata::interval_to_range(it->first);
+    _gc_before = saturating_subtract(it->second, options.propagation_delay_in_seconds());
+    dblog.trace("Get gc_before for ks={}, table={}, range={}, mode=repair, repair_timestamp={}, gc_before={}",
+            _schema.ks_name(), _schema.cf_name(), *_range, it->second, _gc_before);
+    return _gc_before;
 }
 
 static bool needs_repair_before_gc(const replica::database& db, sstring ks_name) {
@@ -35,4 +35,28 @@ gc_clock::time_point get_gc_before_for_key(schema_ptr s, const dht::decorated_ke
 
 void update_repair_time(schema_ptr s, const dht::token_range& range, gc_clock::time_point repair_time);
 
+class repair_history_map;
+
+/// Returns the gc_before of the partitions of a table like get_gc_before_for_key(),
+/// for readers which visit them in token order, like compaction.
+///
+/// In repair mode, the repaired range of the last partition looked up and its
+/// repair time are kept, so the next partitions in the same range don't look up
+/// the repair history of the table. The range is dropped when the history
+/// changes. In the other modes, gc_before is the same for all the partitions.
+class gc_before_cursor {
+    const schema& _schema;
+    gc_clock::time_point _query_time;
+    lw_shared_ptr<repair_history_map> _map;
+    uint64_t _map_version = 0;
+    std::optional<dht::token_range> _range;
+    gc_clock::time_point _gc_before;
+public:
+    gc_before_cursor(const schema& s, gc_clock::time_point query_time);
+    ~gc_before_cursor();
+
+    void set_query_time(gc_clock::time_point query_time);
+    gc_clock::time_point get(const dht::decorated_key& dk);
+};
+
 void validate_tombstone_gc_options(const tombstone_gc_options* options, const replica::database& db, sstring ks_name);
@@ -10,5 +10,6 @@ namespace tools {
 
 int scylla_types_main(int argc, char** argv);
 int scylla_sstable_main(int argc, char** argv);
+int scylla_compaction_simulator_main(int argc, char** argv);
 
 } // namespace tools
@@ -0,0 +1,656 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <fstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/numeric.hpp>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/closeable.hh>
+
+#include "compaction/compaction_strategy.hh"
+#include "compaction/strategy_control.hh"
+#include "compaction/table_state.hh"
+#include "db/cache_tracker.hh"
+#include "db/config.hh"
+#include "db/large_data_handler.hh"
+#include "gms/feature_service.hh"
+#include "reader_concurrency_semaphore.hh"
+#include "schema_builder.hh"
+#include "sstables/sstables.hh"
+#include "sstables/sstables_manager.hh"
+#include "tools/utils.hh"
+
+using namespace seastar;
+
+namespace bpo = boost::program_options;
+
+namespace {
+
+const auto app_name = "scylla-compaction-simulator";
+
+logging::logger sim_log(app_name);
+
+db::nop_large_data_handler large_data_handler;
+
+constexpr double mib = 1024 * 1024;
+
+// A memtable flush, which creates an sstable.
+struct flush_event {
+    // Seconds since the start of the simulation.
+    double time;
+    uint64_t size;
+    api::timestamp_type min_timestamp;
+    api::timestamp_type max_timestamp;
+};
+
+// A sequence of flushes, and the write timestamp of the start of the
+// workload, which maps simulated time to write timestamps.
+struct workload {
+    std::vector<flush_event> flushes;
+    api::timestamp_type start = 0;
+};
+
+api::timestamp_type to_timestamp(api::timestamp_type start, double time) {
+    return start + api::timestamp_type(time * 1000000);
+}
+
+workload make_synthetic_workload(const bpo::variables_map& cfg) {
+    auto duration = cfg["duration"].as<double>();
+    auto interval = cfg["flush-interval"].as<double>();
+    auto size = uint64_t(cfg["flush-size"].as<double>() * mib);
+    if (interval <= 0) {
+        throw std::invalid_argument("error: --flush-interval must be positive");
+    }
+    workload w;
+    for (double t = interval; t <= duration; t += interval) {
+        w.flushes.push_back(flush_event{t, size, to_timestamp(w.start, t - interval), to_timestamp(w.start, t) - 1});
+    }
+    return w;
+}
+
+// Each line of the file describes a flush as: time,size[,min_timestamp,max_timestamp]
+// where time is in seconds since the start of the workload, size in bytes and the
+// timestamps are write timestamps in microseconds. Lines starting with # are ignored.
+// Flushes without timestamps are assumed to hold the writes since the previous flush.
+//
+// The workload starts at the timestamp implied by the first flush with timestamps,
+// whose max_timestamp is taken to be the write timestamp at the time of the flush,
+// or at timestamp 0 if no flush has timestamps.
+workload load_workload(const sstring& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::invalid_argument(format("error: could not open workload file {}", path));
+    }
+    workload w;
+    // Flushes without timestamps, which are filled in once the start is known.
+    std::vector<size_t> untimed;
+    std::string line;
+    unsigned line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        boost::algorithm::trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> fields;
+        boost::split(fields, line, boost::is_any_of(","));
+        if (fields.size() != 2 && fields.size() != 4) {
+            throw std::invalid_argument(format("error: {}:{}: expected 2 or 4 fields, got {}", path, line_no, fields.size()));
+        }
+        try {
+            flush_event ev;
+            ev.time = std::stod(fields[0]);
+            ev.size = std::stoull(fields[1]);
+            if (fields.size() == 4) {
+                ev.min_timestamp = std::stoll(fields[2]);
+                ev.max_timestamp = std::stoll(fields[3]);
+                if (ev.min_timestamp > ev.max_timestamp) {
+                    throw std::invalid_argument("min_timestamp is greater than max_timestamp");
+                }
+                if (untimed.size() == w.flushes.size()) {
+                    w.start = ev.max_timestamp - to_timestamp(0, ev.time);
+                }
+            } else {
+                untimed.push_back(w.flushes.size());
+            }
+            if (!w.flushes.empty() && ev.time < w.flushes.back().time) {
+                throw std::invalid_argument("flushes are not ordered by time");
+            }
+            w.flushes.push_back(ev);
+        } catch (...) {
+            throw std::invalid_argument(format("error: {}:{}: failed to parse flush: {}", path, line_no, std::current_exception()));
+        }
+    }
+    for (auto i : untimed) {
+        auto& ev = w.flushes[i];
+        ev.min_timestamp = to_timestamp(w.start, i ? w.flushes[i - 1].time : 0);
+        ev.max_timestamp = to_timestamp(w.start, ev.time);
+    }
+    return w;
+}
+
+struct simulation_config {
+    // Fraction of the data of an sstable which is shadowed by newer
+    // sstables when merged with them.
+    double overwrite_ratio = 0;
+    // In seconds, 0 if data doesn't expire.
+    double ttl = 0;
+    // In bytes per second, compactions are instantaneous if 0.
+    double compaction_throughput = 0;
+    double report_interval = 3600;
+};
+
+// Replays flushes through a compaction strategy, using sstables which only
+// have metadata (see sstable::set_synthetic_metadata()).
+//
+// Sstables cover ranges of a fixed set of keys, sorted by token. Flushed
+// sstables cover all keys, the output of a compaction is split, if the
+// strategy asks for it, into sstables covering consecutive ranges of the
+// keys its input covers.
+//
+// Compactions run one at a time. The size of their output is the size of
+// their input, minus the overwritten part of all sstables but the largest.
+// Data expires in simulated time: the simulator drops sstables whose data
+// is all expired, the way strategies drop fully expired sstables, since
+// the strategies themselves look at the wall clock.
+class simulator final : public compaction::table_state, public compaction::strategy_control {
+    schema_ptr _schema;
+    sstables::sstables_manager& _sst_man;
+    reader_permit _permit;
+    mutable sstables::compaction_strategy _strategy;
+    sstables::sstable_set _set;
+    const std::vector<sstables::shared_sstable> _compacted_undeleted;
+    simulation_config _cfg;
+    // Write timestamp of the start of the simulation.
+    api::timestamp_type _start;
+
+    // Sorted by token.
+    std::vector<partition_key> _keys;
+    // Indexes of the first and last keys of sstables in _keys.
+    std::unordered_map<sstables::shared_sstable, std::pair<size_t, size_t>> _key_ranges;
+    int64_t _generation = 0;
+
+    double _now = 0;
+    struct running_compaction {
+        std::vector<sstables::shared_sstable> sstables;
+        int level;
+        uint64_t max_sstable_bytes;
+        utils::UUID run_identifier;
+        double end;
+    };
+    std::optional<running_compaction> _running;
+    std::unordered_set<sstables::shared_sstable> _compacting;
+
+    struct stats {
+        uint64_t flushes = 0;
+        uint64_t flushed_bytes = 0;
+        uint64_t compactions = 0;
+        uint64_t compaction_read_bytes = 0;
+        uint64_t compaction_written_bytes = 0;
+        uint64_t expired_sstables = 0;
+        uint64_t samples = 0;
+        double space_amplification_sum = 0;
+        double space_amplification_max = 0;
+        double read_amplification_sum = 0;
+        double read_amplification_max = 0;
+    } _stats;
+
+    // Compactions started without advancing the simulated time, which bounds instantaneous
+    // compactions, in case the strategy keeps rewriting the same data.
+    unsigned _compactions_at_now = 0;
+    static constexpr unsigned max_compactions_at_once = 10000;
+public:
+    simulator(schema_ptr schema, sstables::sstables_manager& sst_man, reader_permit permit, sstables::compaction_strategy strategy,
+            simulation_config cfg, api::timestamp_type start, unsigned key_count)
+        : _schema(std::move(schema))
+        , _sst_man(sst_man)
+        , _permit(std::move(permit))
+        , _strategy(std::move(strategy))
+        , _set(_strategy.make_sstable_set(_schema))
+        , _cfg(cfg)
+        , _start(start)
+    {
+        std::vector<dht::decorated_key> keys;
+        keys.reserve(key_count);
+        for (unsigned i = 0; i < key_count; ++i) {
+            keys.push_back(dht::decorate_key(*_schema, partition_key::from_single_value(*_schema, int32_type->decompose(int32_t(i)))));
+        }
+        std::sort(keys.begin(), keys.end(), [this] (const dht::decorated_key& a, const dht::decorated_key& b) {
+            return a.less_compare(*_schema, b);
+        });
+        for (auto& dk : keys) {
+            _keys.push_back(dk.key());
+        }
+    }
+
+    // table_state
+    virtual const schema_ptr& schema() const noexcept override {
+        return _schema;
+    }
+    virtual unsigned min_compaction_threshold() const noexcept override {
+        return _schema->min_compaction_threshold();
+    }
+    virtual bool compaction_enforce_min_threshold() const noexcept override {
+        return true;
+    }
+    virtual const sstables::sstable_set& get_sstable_set() const override {
+        return _set;
+    }
+    virtual std::unordered_set<sstables::shared_sstable> fully_expired_sstables(const std::vector<sstables::shared_sstable>& sstables, gc_clock::time_point compaction_time) const override {
+        // Expiration is simulated by the simulator.
+        return {};
+    }
+    virtual const std::vector<sstables::shared_sstable>& compacted_undeleted_sstables() const noexcept override {
+        return _compacted_undeleted;
+    }
+    virtual sstables::compaction_strategy& get_compaction_strategy() const noexcept override {
+        return _strategy;
+    }
+    virtual reader_permit make_compaction_reader_permit() const override {
+        return _permit;
+    }
+    virtual sstables::sstable_writer_config configure_writer(sstring origin) const override {
+        return _sst_man.configure_writer(std::move(origin));
+    }
+    virtual api::timestamp_type min_memtable_timestamp() const override {
+        return api::max_timestamp;
+    }
+
+    // strategy_control
+    virtual bool has_ongoing_compaction(table_state& table_s) const noexcept override {
+        return bool(_running);
+    }
+
+    void run(const std::vector<flush_event>& flushes);
+private:
+    sstables::shared_sstable make_sstable(uint64_t size, size_t first, size_t last, api::timestamp_type min_timestamp, api::timestamp_type max_timestamp,
+            uint32_t level, utils::UUID run_identifier) {
+        auto sst = _sst_man.make_sstable(_schema, "simulation", ++_generation, _sst_man.get_highest_supported_format(), sstables::sstable::format_types::big);
+        sstables::stats_metadata stats = {};
+        stats.min_timestamp = min_timestamp;
+        stats.max_timestamp = max_timestamp;
+        stats.min_local_deletion_time = std::numeric_limits<int32_t>::max();
+        stats.max_local_deletion_time = std::numeric_limits<int32_t>::max();
+        stats.sstable_level = level;
+        sst->set_synthetic_metadata(size, _keys[first], _keys[last], std::move(stats), run_identifier);
+        _key_ranges.emplace(sst, std::make_pair(first, last));
+        return sst;
+    }
+
+    void add(const std::vector<sstables::shared_sstable>& added) {
+        for (auto& sst : added) {
+            _set.insert(sst);
+        }
+    }
+
+    void remove(const std::vector<sstables::shared_sstable>& removed) {
+        for (auto& sst : removed) {
+            _set.erase(sst);
+            _key_ranges.erase(sst);
+            _compacting.erase(sst);
+        }
+    }
+
+    uint64_t merged_size(const std::vector<sstables::shared_sstable>& sstables) const {
+        uint64_t total = 0;
+        uint64_t largest = 0;
+        for (auto& sst : sstables) {
+            total += sst->data_size();
+            largest = std::max(largest, sst->data_size());
+        }
+        return total - uint64_t(_cfg.overwrite_ratio * (total - largest));
+    }
+
+    void flush(const flush_event& ev) {
+        add({ make_sstable(ev.size, 0, _keys.size() - 1, ev.min_timestamp, ev.max_timestamp, 0, utils::make_random_uuid()) });
+        _stats.flushes++;
+        _stats.flushed_bytes += ev.size;
+    }
+
+    void expire() {
+        if (!_cfg.ttl) {
+            return;
+        }
+        auto expiry = to_timestamp(_start, _now - _cfg.ttl);
+        std::vector<sstables::shared_sstable> expired;
+        for (auto& sst : *_set.all()) {
+            if (!_compacting.contains(sst) && sst->get_stats_metadata().max_timestamp < expiry) {
+                expired.push_back(sst);
+            }
+        }
+        if (expired.empty()) {
+            return;
+        }
+        remove(expired);
+        _strategy.notify_completion(expired, {});
+        _stats.expired_sstables += expired.size();
+    }
+
+    void start_compactions() {
+        while (!_running) {
+            std::vector<sstables::shared_sstable> candidates;
+            for (auto& sst : *_set.all()) {
+                if (!_compacting.contains(sst)) {
+                    candidates.push_back(sst);
+                }
+            }
+            auto descriptor = _strategy.get_sstables_for_compaction(*this, *this, std::move(candidates));
+            if (descriptor.sstables.empty()) {
+                return;
+            }
+            if (++_compactions_at_now > max_compactions_at_once) {
+                sim_log.warn("More than {} compactions at {}s, postponing compaction", max_compactions_at_once, _now);
+                return;
+            }
+            uint64_t input_size = 0;
+            for (auto& sst : descriptor.sstables) {
+                _compacting.insert(sst);
+                input_size += sst->data_size();
+            }
+            auto end = _cfg.compaction_throughput ? _now + input_size / _cfg.compaction_throughput : _now;
+            _running = running_compaction{std::move(descriptor.sstables), descriptor.level, descriptor.max_sstable_bytes, descriptor.run_identifier, end};
+            if (end == _now) {
+                complete_compaction();
+            }
+        }
+    }
+
+    void complete_compaction() {
+        auto c = std::move(*_running);
+        _running.reset();
+
+        auto size = merged_size(c.sstables);
+        auto first = _keys.size();
+        size_t last = 0;
+        auto min_timestamp = api::max_timestamp;
+        auto max_timestamp = api::min_timestamp;
+        uint64_t input_size = 0;
+        for (auto& sst : c.sstables) {
+            auto [f, l] = _key_ranges.at(sst);
+            first = std::min(first, f);
+            last = std::max(last, l);
+            min_timestamp = std::min(min_timestamp, sst->get_stats_metadata().min_timestamp);
+            max_timestamp = std::max(max_timestamp, sst->get_stats_metadata().max_timestamp);
+            input_size += sst->data_size();
+        }
+
+        std::vector<sstables::shared_sstable> outputs;
+        if (size) {
+            auto key_count = last - first + 1;
+            auto count = std::clamp<uint64_t>((size + c.max_sstable_bytes - 1) / c.max_sstable_bytes, 1, key_count);
+            for (uint64_t i = 0; i < count; ++i) {
+                outputs.push_back(make_sstable(size / count, first + key_count * i / count, first + key_count * (i + 1) / count - 1,
+                        min_timestamp, max_timestamp, c.level, c.run_identifier));
+            }
+        }
+        remove(c.sstables);
+        add(outputs);
+        _strategy.notify_completion(c.sstables, outputs);
+
+        _stats.compactions++;
+        _stats.compaction_read_bytes += input_size;
+        _stats.compaction_written_bytes += size;
+    }
+
+    double write_amplification() const {
+        return _stats.flushed_bytes ? double(_stats.flushed_bytes + _stats.compaction_written_bytes) / _stats.flushed_bytes : 0;
+    }
+
+    // Disk space used, including the output of the running compaction, over the size of
+    // the data if it was all compacted together.
+    double space_amplification() const {
+        auto all = boost::copy_range<std::vector<sstables::shared_sstable>>(*_set.all());
+        auto compacted = merged_size(all);
+        if (!compacted) {
+            return 0;
+        }
+        uint64_t used = 0;
+        for (auto& sst : all) {
+            used += sst->data_size();
+        }
+        if (_running) {
+            used += merged_size(_running->sstables);
+        }
+        return double(used) / compacted;
+    }
+
+    // Average number of sstables a single partition read has to look at.
+    double read_amplification() const {
+        constexpr size_t samples = 16;
+        size_t total = 0;
+        for (size_t i = 0; i < samples; ++i) {
+            auto key = (2 * i + 1) * _keys.size() / (2 * samples);
+            for (auto& [sst, range] : _key_ranges) {
+                total += range.first <= key && key <= range.second;
+            }
+        }
+        return double(total) / samples;
+    }
+
+    void report() {
+        auto live = boost::accumulate(*_set.all() | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0));
+        auto space_amp = space_amplification();
+        auto read_amp = read_amplification();
+        _stats.samples++;
+        _stats.space_amplification_sum += space_amp;
+        _stats.space_amplification_max = std::max(_stats.space_amplification_max, space_amp);
+        _stats.read_amplification_sum += read_amp;
+        _stats.read_amplification_max = std::max(_stats.read_amplification_max, read_amp);
+        fmt::print("{:>12.0f} {:>9} {:>12.1f} {:>8} {:>8.2f} {:>8.2f} {:>8.2f}\n", _now, _set.all()->size(), live / mib,
+                _strategy.estimated_pending_compactions(*this), write_amplification(), space_amp, read_amp);
+    }
+
+    void print_summary() const {
+        fmt::print("\n");
+        fmt::print("strategy: {}\n", _strategy.name());
+        fmt::print("flushes: {}, {:.1f} MiB\n", _stats.flushes, _stats.flushed_bytes / mib);
+        fmt::print("compactions: {}, read {:.1f} MiB, written {:.1f} MiB\n", _stats.compactions,
+                _stats.compaction_read_bytes / mib, _stats.compaction_written_bytes / mib);
+        fmt::print("expired sstables: {}\n", _stats.expired_sstables);
+        fmt::print("write amplification: {:.2f}\n", write_amplification());
+        if (_stats.samples) {
+            fmt::print("space amplification: average {:.2f}, max {:.2f}\n", _stats.space_amplification_sum / _stats.samples, _stats.space_amplification_max);
+            fmt::print("read amplification: average {:.2f}, max {:.2f}\n", _stats.read_amplification_sum / _stats.samples, _stats.read_amplification_max);
+        }
+    }
+};
+
+void simulator::run(const std::vector<flush_event>& flushes) {
+    fmt::print("{:>12} {:>9} {:>12} {:>8} {:>8} {:>8} {:>8}\n", "time[s]", "sstables", "size[MiB]", "pending", "write", "space", "read");
+    auto next_report = _cfg.report_interval;
+    auto it = flushes.begin();
+    while (it != flushes.end() || _running) {
+        auto next = std::min(it != flushes.end() ? it->time : std::numeric_limits<double>::infinity(),
+                _running ? _running->end : std::numeric_limits<double>::infinity());
+        // The state doesn't change between events.
+        while (_cfg.report_interval > 0 && next_report <= next) {
+            auto now = std::exchange(_now, next_report);
+            report();
+            _now = now;
+            next_report += _cfg.report_interval;
+        }
+        if (next > _now) {
+            _compactions_at_now = 0;
+        }
+        _now = next;
+        if (_running && _running->end <= _now) {
+            complete_compaction();
+        } else {
+            flush(*it++);
+        }
+        expire();
+        start_compactions();
+        seastar::thread::maybe_yield();
+    }
+    report();
+    print_summary();
+}
+
+} // anonymous namespace
+
+namespace tools {
+
+int scylla_compaction_simulator_main(int argc, char** argv) {
+    app_template::seastar_options app_cfg;
+    app_cfg.name = app_name;
+    app_cfg.description =
+R"(scylla-compaction-simulator - a command-line tool to simulate compaction strategies.
+
+Usage: scylla compaction-simulator [--option1] [--option2] ...
+
+Replays a write workload, given as a sequence of memtable flushes, through
+the compaction strategy of choice and reports the resulting write, space and
+read amplification over simulated time. The strategy selects compactions the
+same way it does in scylla, but the sstables only have metadata (size, token
+range, timestamps and level) and compactions are simulated.
+
+The workload is either synthetic, flushing sstables of --flush-size every
+--flush-interval for --duration, or read from --workload-file, which has one
+line per flush in the form: time,size[,min_timestamp,max_timestamp], where
+time is in seconds since the start, size is in bytes and timestamps are write
+timestamps in microseconds. If timestamps are not given, the flush is assumed
+to contain the writes since the previous one.
+
+Simulated time only follows the workload, never the wall clock: the synthetic
+workload starts at write timestamp 0, a workload file at the timestamp implied
+by its first flush with timestamps, whose max_timestamp is taken to be the
+time of the flush. Expiry with --ttl is relative to the same clock.
+
+The periodic reports list:
+* the number of sstables and their total size
+* the number of pending compactions, as estimated by the strategy
+* the write amplification so far: bytes written by flushes and compactions
+  over bytes written by flushes
+* the space amplification: disk space used, including the output of
+  the running compaction, over the size of all data compacted together
+* the read amplification: the average number of sstables a single partition
+  read has to look at
+
+Examples:
+
+# simulate size-tiered compaction with custom buckets for a week
+$ scylla compaction-simulator --strategy SizeTieredCompactionStrategy --strategy-option bucket_low=0.3 --strategy-option bucket_high=2 --duration 604800
+
+# simulate time-window compaction with 6 hour windows, for data with a time to live of 3 days
+$ scylla compaction-simulator --strategy TimeWindowCompactionStrategy --strategy-option compaction_window_unit=HOURS --strategy-option compaction_window_size=6 --ttl 259200 --duration 604800
+)";
+
+    tools::utils::configure_tool_mode(app_cfg, sim_log.name());
+
+    app_template app(std::move(app_cfg));
+
+    app.add_options()
+        ("strategy", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy"), "the compaction strategy class")
+        ("strategy-option", bpo::value<std::vector<sstring>>(), "an option of the compaction strategy, in the form key=value, can be given multiple times;"
+                " min_threshold and max_threshold are applied to the table")
+        ("workload-file", bpo::value<sstring>(), "file describing the flushes of the workload, see above; the synthetic workload is used if not given")
+        ("duration", bpo::value<double>()->default_value(86400), "synthetic workload: simulated time, in seconds")
+        ("flush-interval", bpo::value<double>()->default_value(60), "synthetic workload: time between flushes, in seconds")
+        ("flush-size", bpo::value<double>()->default_value(64), "synthetic workload: size of flushed sstables, in MiB")
+        ("overwrite-ratio", bpo::value<double>()->default_value(0), "fraction of the data of an sstable which is overwritten by newer sstables,"
+                " and dropped when they are compacted together")
+        ("ttl", bpo::value<double>()->default_value(0), "time to live of the data, in seconds, 0 means data never expires")
+        ("compaction-throughput", bpo::value<double>()->default_value(0), "compaction throughput, in MiB/s, 0 means compactions are instantaneous")
+        ("report-interval", bpo::value<double>()->default_value(3600), "simulated time between reports, in seconds")
+        ("keys", bpo::value<unsigned>()->default_value(1024), "number of distinct keys, determines the granularity of the token ranges of sstables")
+        ;
+
+    return app.run(argc, argv, [&app] {
+        return async([&app] {
+            auto& app_config = app.configuration();
+
+            std::map<sstring, sstring> options;
+            if (app_config.contains("strategy-option")) {
+                for (auto& opt : app_config["strategy-option"].as<std::vector<sstring>>()) {
+                    auto pos = opt.find('=');
+                    if (pos == sstring::npos) {
+                        std::cerr << "error: invalid strategy option '" << opt << "', expected key=value\n";
+                        return 1;
+                    }
+                    options.emplace(opt.substr(0, pos), opt.substr(pos + 1));
+                }
+            }
+
+            sstables::compaction_strategy_type type;
+            try {
+                type = sstables::compaction_strategy::type(app_config["strategy"].as<sstring>());
+            } catch (...) {
+                std::cerr << "error: " << std::current_exception() << std::endl;
+                return 1;
+            }
+
+            auto builder = schema_builder("simulation", "table")
+                    .with_column("pk", int32_type, column_kind::partition_key)
+                    .with_column("v", int32_type);
+            builder.set_compaction_strategy(type);
+            try {
+                if (auto it = options.find("min_threshold"); it != options.end()) {
+                    builder.set_min_compaction_threshold(std::stoi(it->second));
+                }
+                if (auto it = options.find("max_threshold"); it != options.end()) {
+                    builder.set_max_compaction_threshold(std::stoi(it->second));
+                }
+            } catch (...) {
+                std::cerr << "error: invalid compaction threshold: " << std::current_exception() << std::endl;
+                return 1;
+            }
+            builder.set_compaction_strategy_options(std::map<sstring, sstring>(options));
+            auto schema = builder.build();
+
+            simulation_config cfg;
+            cfg.overwrite_ratio = app_config["overwrite-ratio"].as<double>();
+            cfg.ttl = app_config["ttl"].as<double>();
+            cfg.compaction_throughput = app_config["compaction-throughput"].as<double>() * mib;
+            cfg.report_interval = app_config["report-interval"].as<double>();
+            if (cfg.overwrite_ratio < 0 || cfg.overwrite_ratio > 1) {
+                std::cerr << "error: --overwrite-ratio must be between 0 and 1\n";
+                return 1;
+            }
+            auto key_count = app_config["keys"].as<unsigned>();
+            if (!key_count) {
+                std::cerr << "error: --keys must be positive\n";
+                return 1;
+            }
+
+            workload w;
+            try {
+                w = app_config.contains("workload-file")
+                        ? load_workload(app_config["workload-file"].as<sstring>())
+                        : make_synthetic_workload(app_config);
+            } catch (...) {
+                std::cerr << std::current_exception() << std::endl;
+                return 1;
+            }
+
+            db::config dbcfg;
+            gms::feature_service feature_service(gms::feature_config_from_db_config(dbcfg));
+            cache_tracker tracker;
+            dbcfg.host_id = ::utils::make_random_uuid();
+            sstables::sstables_manager sst_man(large_data_handler, dbcfg, feature_service, tracker);
+            auto close_sst_man = deferred_close(sst_man);
+
+            reader_concurrency_semaphore rcs_sem(reader_concurrency_semaphore::no_limits{}, app_name);
+            auto stop_semaphore = deferred_stop(rcs_sem);
+            auto permit = rcs_sem.make_tracking_only_permit(schema.get(), app_name, db::no_timeout);
+
+            try {
+                simulator sim(schema, sst_man, permit, sstables::make_compaction_strategy(type, options), cfg, w.start, key_count);
+                sim.run(w.flushes);
+            } catch (...) {
+                std::cerr << "error: simulation failed: " << std::current_exception() << std::endl;
+                return 1;
+            }
+
+            return 0;
+        });
+    });
+}
+
+} // namespace tools
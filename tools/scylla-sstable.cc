@@ -17,8 +17,10 @@
 #include "db/config.hh"
 #include "db/large_data_handler.hh"
 #include "gms/feature_service.hh"
+#include "mutation_writer/shard_based_splitting_writer.hh"
 #include "schema_builder.hh"
 #include "sstables/index_reader.hh"
+#include "sstables/sstable_writer.hh"
 #include "sstables/sstables_manager.hh"
 #include "types/user.hh"
 #include "types/set.hh"
@@ -906,6 +908,94 @@ void validate_operation(schema_ptr schema, reader_permit permit, const std::vect
     });
 }
 
+void split_by_shard_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables, const bpo::variables_map& vm) {
+    if (!vm.count("shards")) {
+        throw std::invalid_argument("error: missing required option for split-by-shard: shards");
+    }
+    const auto shards = vm["shards"].as<unsigned>();
+    if (!shards) {
+        throw std::invalid_argument("error: invalid value for split-by-shard option shards: 0");
+    }
+    const auto ignore_msb_bits = vm["ignore-msb-bits"].as<unsigned>();
+    const auto output_dir = vm["output-dir"].as<std::string>();
+
+    // The sharding metadata of the written sstables is calculated with the
+    // sharder of their schema, so it has to be that of the target node.
+    auto output_schema = schema_builder(schema).with_sharder(shards, ignore_msb_bits).build();
+    const auto& sharder = output_schema->get_sharder();
+
+    auto& sst_man = sstables.front()->manager();
+    const auto cfg = sst_man.configure_writer(app_name);
+
+    uint64_t estimated_partitions = 0;
+    std::vector<flat_mutation_reader_v2> readers;
+    readers.reserve(sstables.size());
+    for (const auto& sst : sstables) {
+        estimated_partitions += sst->get_estimated_key_count();
+        readers.emplace_back(sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice()));
+    }
+    estimated_partitions = std::max(uint64_t(1), estimated_partitions / shards);
+
+    recursive_touch_directory(output_dir).get();
+
+    mutation_writer::segregate_by_shard(make_combined_reader(schema, permit, std::move(readers)), sharder, [&] (flat_mutation_reader_v2 shard_reader) {
+        return async([&, shard_reader = downgrade_to_v1(std::move(shard_reader))] () mutable {
+            auto close_reader = deferred_close(shard_reader);
+            auto* mf = shard_reader.peek().get0();
+            if (!mf) {
+                return;
+            }
+            const auto shard = sharder.shard_of(mf->as_partition_start().key().token());
+            auto sst = sst_man.make_sstable(output_schema, output_dir, shard + 1, sst_man.get_highest_supported_format(), sstables::sstable::format_types::big);
+            sst_log.info("writing the partitions of shard {} into {}", shard, sst->get_filename());
+            shard_reader.consume_in_thread(sst->get_writer(*output_schema, estimated_partitions, cfg, encoding_stats{}, default_priority_class(), shard));
+        });
+    }).get();
+}
+
+void rewrite_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables, const bpo::variables_map& vm) {
+    const auto merge = vm.count("merge");
+    const auto exclude = vm.count("exclude");
+    const auto compact = vm.count("compact");
+    const auto partitions = get_partitions(schema, vm);
+    const auto output_dir = vm["output-dir"].as<std::string>();
+
+    auto& sst_man = sstables.front()->manager();
+    const auto cfg = sst_man.configure_writer(app_name);
+
+    recursive_touch_directory(output_dir).get();
+
+    int64_t generation = 0;
+    consume_sstables(schema, permit, sstables, merge, true, [&] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
+        uint64_t estimated_partitions = 0;
+        if (sst) {
+            estimated_partitions = sst->get_estimated_key_count();
+        } else {
+            for (const auto& sst : sstables) {
+                estimated_partitions += sst->get_estimated_key_count();
+            }
+        }
+
+        auto reader = std::move(rd);
+        if (!partitions.empty()) {
+            reader = make_filtering_reader(std::move(reader), [&partitions, exclude] (const dht::decorated_key& dk) {
+                return partitions.contains(dk) != bool(exclude);
+            });
+        }
+
+        auto out_sst = sst_man.make_sstable(schema, output_dir, ++generation, sst_man.get_highest_supported_format(), sstables::sstable::format_types::big);
+        sst_log.info("writing {} into {}", sst ? sst->get_filename() : "the stream", out_sst->get_filename());
+        if (compact) {
+            // We don't know whether we have all the sstables of the table, so tombstones can't be purged.
+            auto compacting_reader = make_compacting_reader(std::move(reader), gc_clock::now(), [] (const dht::decorated_key&) { return api::min_timestamp; });
+            out_sst->write_components(std::move(compacting_reader), estimated_partitions, schema, cfg, encoding_stats{}).get();
+        } else {
+            out_sst->write_components(downgrade_to_v1(std::move(reader)), estimated_partitions, schema, cfg, encoding_stats{}).get();
+        }
+        return stop_iteration::no;
+    });
+}
+
 void dump_index_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables, const bpo::variables_map&) {
     json_writer writer;
     writer.StartStream();
@@ -1293,6 +1383,9 @@ const char* to_string(sstables::scylla_metadata_type t) {
         case sstables::scylla_metadata_type::RunIdentifier: return "run_identifier";
         case sstables::scylla_metadata_type::LargeDataStats: return "large_data_stats";
         case sstables::scylla_metadata_type::SSTableOrigin: return "sstable_origin";
+        case sstables::scylla_metadata_type::PartitionKeyBounds: return "partition_key_bounds";
+        case sstables::scylla_metadata_type::ExpirationTimeBounds: return "expiration_time_bounds";
+        case sstables::scylla_metadata_type::TokenHistogram: return "token_histogram";
     }
     std::abort();
 }
@@ -1389,6 +1482,43 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
     void operator()(const sstables::scylla_metadata::sstable_origin& val) const {
         _writer.String(disk_string_to_string(val));
     }
+    void operator()(const sstables::partition_key_bounds& val) const {
+        _writer.StartObject();
+        _writer.Key("min");
+        _writer.String(to_hex(val.min.value));
+        _writer.Key("max");
+        _writer.String(to_hex(val.max.value));
+        _writer.EndObject();
+    }
+    void operator()(const sstables::expiration_time_bounds& val) const {
+        _writer.StartObject();
+        _writer.Key("source");
+        _writer.String(disk_string_to_string(val.source));
+        _writer.Key("min");
+        _writer.Int64(val.min);
+        _writer.Key("max");
+        _writer.Int64(val.max);
+        _writer.EndObject();
+    }
+    void operator()(const sstables::token_histogram& val) const {
+        _writer.StartObject();
+        _writer.Key("bucket_count");
+        _writer.Uint(val.bucket_count);
+        _writer.Key("buckets");
+        _writer.StartArray();
+        for (const auto& bucket : val.buckets.elements) {
+            _writer.StartObject();
+            _writer.Key("index");
+            _writer.Uint(bucket.index);
+            _writer.Key("partitions");
+            _writer.Uint64(bucket.partitions);
+            _writer.Key("rows");
+            _writer.Uint64(bucket.rows);
+            _writer.EndObject();
+        }
+        _writer.EndArray();
+        _writer.EndObject();
+    }
 
     template <sstables::scylla_metadata_type E, typename T>
     void operator()(const sstables::disk_tagged_union_member<sstables::scylla_metadata_type, E, T>& m) const {
@@ -1485,6 +1615,11 @@ const std::vector<option> all_options {
     typed_option<>("no-skips", "don't use skips to skip to next partition when the partition filter rejects one, this is slower but works with corrupt index"),
     typed_option<std::string>("bucket", "months", "the unit of time to use as bucket, one of (years, months, weeks, days, hours)"),
     typed_option<std::string>("output-format", "json", "the output-format, one of (text, json)"),
+    typed_option<>("exclude", "drop the partitions given with --partition or --partitions-file instead of keeping only those"),
+    typed_option<>("compact", "compact the data while rewriting it, dropping the data shadowed by tombstones, but not the tombstones themselves"),
+    typed_option<unsigned>("shards", "the number of shards of the node the output is meant for"),
+    typed_option<unsigned>("ignore-msb-bits", 12, "the murmur3_partitioner_ignore_msb_bits setting of the node the output is meant for"),
+    typed_option<std::string>("output-dir", ".", "the directory to write the output sstables to, created if it doesn't exist"),
 };
 
 const std::vector<operation> operations{
@@ -1935,6 +2070,49 @@ well defined internal order.
 )",
             {"merge"},
             validate_operation},
+/* rewrite */
+    {"rewrite",
+            "Rewrite the sstable(s), optionally filtering and compacting the data",
+R"(
+Write the content of each sstable into a new sstable, or with --merge, the
+content of all sstables merged into a single stream into one new sstable.
+The new sstables are written in the latest format, with the compression and
+other parameters of the schema in the schema file, so changing the compression
+options in the schema file and rewriting the sstables re-compresses them.
+
+The partitions to write can be filtered via the --partition and
+--partitions-file options, which expect partition key values in the hexdump
+format. By default only the given partitions are kept, with --exclude they
+are dropped instead.
+
+With --compact, the data is compacted while written, dropping the data which
+is shadowed by tombstones and turning expired cells into tombstones.
+Tombstones themselves are never purged, as the sstables given might not be all
+the sstables of the table.
+
+The output sstables are written to the directory given with --output-dir,
+with generations starting from 1. The directory shouldn't contain sstables of
+the same table already.
+)",
+            {"merge", "partition", "partitions-file", "exclude", "compact", "output-dir"},
+            rewrite_operation},
+/* split-by-shard */
+    {"split-by-shard",
+            "Split the content of the sstable(s) by the shards of a node",
+R"(
+Write the content of the sstables, merged into a single stream, into one
+sstable for each shard of a node with the given shard count (--shards) and
+murmur3_partitioner_ignore_msb_bits (--ignore-msb-bits) setting. The sstables
+written are in the latest format and are owned by exactly one shard each, so
+when they are loaded into that node (e.g. with nodetool refresh), they don't
+need to be resharded first.
+
+The output sstables are written to the directory given with --output-dir, with
+the generation of each being its shard + 1. The directory shouldn't contain
+sstables of the same table already.
+)",
+            {"shards", "ignore-msb-bits", "output-dir"},
+            split_by_shard_operation},
 };
 
 } // anonymous namespace
@@ -2004,6 +2182,12 @@ For more details on an operation, run: scylla sstable {{operation}} --help
 
 # validate the specified sstables
 $ scylla sstable validate /path/to/md-123456-big-Data.db /path/to/md-123457-big-Data.db
+
+# re-compress the specified sstables with the compression parameters in the schema file
+$ scylla sstable rewrite --output-dir=/path/to/output /path/to/md-123456-big-Data.db
+
+# split the specified sstables for a node with 16 shards
+$ scylla sstable split-by-shard --shards=16 --output-dir=/path/to/output /path/to/md-123456-big-Data.db /path/to/md-123457-big-Data.db
 )";
 
     if (found_op) {
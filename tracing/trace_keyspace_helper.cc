@@ -374,7 +374,7 @@ std::vector<cql3::raw_value> trace_keyspace_helper::make_event_mutation_data(one
     std::vector<cql3::raw_value> values({
         cql3::raw_value::make_value(uuid_type->decompose(session_records.session_id)),
         cql3::raw_value::make_value(timeuuid_type->decompose(utils::UUID_gen::get_time_UUID(table_helper::make_monotonic_UUID_tp(backend_state_ptr->last_nanos, record.event_time_point)))),
-        cql3::raw_value::make_value(utf8_type->decompose(record.message)),
+        cql3::raw_value::make_value(utf8_type->decompose(record.get_message())),
         cql3::raw_value::make_value(inet_addr_type->decompose(utils::fb_utilities::get_broadcast_address().addr())),
         cql3::raw_value::make_value(int32_type->decompose(elapsed_to_micros(record.elapsed))),
         cql3::raw_value::make_value(utf8_type->decompose(_local_tracing.get_thread_name())),
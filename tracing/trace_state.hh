@@ -434,7 +434,7 @@ class trace_state final {
      * @note This method is allowed to throw.
      * @param msg the trace message to store
      */
-    void trace_internal(sstring msg);
+    void trace_internal(event_record::message_type msg);
 
     /**
      * Add a single trace entry - a special case for a simple string.
@@ -525,9 +525,10 @@ class trace_state_ptr final {
     }
 };
 
-inline void trace_state::trace_internal(sstring message) {
+inline void trace_state::trace_internal(event_record::message_type message) {
     if (is_in_state(state::inactive)) {
-        throw std::logic_error("trying to use a trace() before begin() for \"" + message + "\" tracepoint");
+        throw std::logic_error("trying to use a trace() before begin() for \"" +
+                event_record(std::move(message), {}, {}).get_message() + "\" tracepoint");
     }
 
     // We don't want the total amount of pending, active and flushing records to
@@ -570,9 +571,26 @@ inline void trace_state::trace_internal(sstring message) {
     }
 }
 
+// Positional parameters of trace events which own their value and are cheap
+// to copy, so that the message can be formatted after the call.
+template <typename T>
+concept trace_lazily_formattable = std::is_arithmetic_v<T> || std::is_enum_v<T>
+        || std::same_as<T, sstring> || std::same_as<T, gms::inet_address> || std::same_as<T, utils::UUID>;
+
 template <typename... A>
 void trace_state::trace(const char* fmt, A&&... a) noexcept {
     try {
+        if constexpr ((trace_lazily_formattable<std::decay_t<A>> && ...)) {
+            // The events of a session which only logs slow queries are
+            // written only if the query turns out to be slow, which most
+            // don't, so don't spend time formatting them till then.
+            if (!full_tracing()) {
+                trace_internal(event_record::message_formatter([fmt, args = std::make_tuple(std::decay_t<A>(std::forward<A>(a))...)] {
+                    return std::apply([fmt] (const auto&... vals) { return seastar::format(fmt, vals...); }, args);
+                }));
+                return;
+            }
+        }
         trace_internal(seastar::format(fmt, std::forward<A>(a)...));
     } catch (...) {
         // Bump up an error counter and ignore
@@ -13,10 +13,12 @@
 #pragma once
 
 #include <vector>
+#include <variant>
 #include <atomic>
 #include <random>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/sstring.hh>
+#include <seastar/util/noncopyable_function.hh>
 #include <seastar/core/metrics_registration.hh>
 #include "gc_clock.hh"
 #include "utils/UUID.hh"
@@ -175,14 +177,25 @@ struct i_tracing_backend_helper {
 };
 
 struct event_record {
-    sstring message;
+    // Builds the message of the event when the record is written, see trace_state::trace().
+    using message_formatter = noncopyable_function<sstring()>;
+    using message_type = std::variant<sstring, message_formatter>;
+
+    message_type message;
     elapsed_clock::duration elapsed;
     i_tracing_backend_helper::wall_clock::time_point event_time_point;
 
-    event_record(sstring message_, elapsed_clock::duration elapsed_, i_tracing_backend_helper::wall_clock::time_point event_time_point_)
+    event_record(message_type message_, elapsed_clock::duration elapsed_, i_tracing_backend_helper::wall_clock::time_point event_time_point_)
         : message(std::move(message_))
         , elapsed(elapsed_)
         , event_time_point(event_time_point_) {}
+
+    sstring get_message() const {
+        if (auto* f = std::get_if<message_formatter>(&message)) {
+            return (*f)();
+        }
+        return std::get<sstring>(message);
+    }
 };
 
 struct session_record {
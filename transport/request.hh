@@ -191,7 +191,10 @@ class request_reader {
         PAGING_STATE,
         SERIAL_CONSISTENCY,
         TIMESTAMP,
-        NAMES_FOR_VALUES
+        NAMES_FOR_VALUES,
+        // Since v5, both unsupported.
+        KEYSPACE,
+        NOW_IN_SECONDS
     };
 
     using options_flag_enum = super_enum<options_flag,
@@ -201,7 +204,9 @@ class request_reader {
         options_flag::PAGING_STATE,
         options_flag::SERIAL_CONSISTENCY,
         options_flag::TIMESTAMP,
-        options_flag::NAMES_FOR_VALUES
+        options_flag::NAMES_FOR_VALUES,
+        options_flag::KEYSPACE,
+        options_flag::NOW_IN_SECONDS
     >;
 public:
     std::unique_ptr<cql3::query_options> read_options(uint8_t version, cql_serialization_format cql_ser_format, const cql3::cql_config& cql_config) {
@@ -213,7 +218,11 @@ class request_reader {
 
         assert(version >= 2);
 
-        auto flags = enum_set<options_flag_enum>::from_mask(read_byte());
+        // v5 extended the flags from a byte to an int.
+        auto flags = enum_set<options_flag_enum>::from_mask(version >= 5 ? read_int() : read_byte());
+        if (flags.contains<options_flag::KEYSPACE>() || flags.contains<options_flag::NOW_IN_SECONDS>()) {
+            throw exceptions::protocol_exception(format("Unsupported query parameters flags: {:#x}", flags.mask()));
+        }
         std::vector<cql3::raw_value_view> values;
         std::vector<sstring_view> names;
 
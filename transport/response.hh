@@ -9,6 +9,7 @@
 #pragma once
 
 #include "server.hh"
+#include "segment.hh"
 #include "utils/reusable_buffer.hh"
 
 namespace cql_transport {
@@ -70,17 +71,32 @@ class response {
     void write_bytes(bytes b);
     void write_short_bytes(bytes b);
     void write_inet(socket_address inet);
+    void write_inetaddr(const net::inet_address& addr);
     void write_consistency(db::consistency_level c);
     void write_string_map(std::map<sstring, sstring> string_map);
     void write_string_multimap(std::multimap<sstring, sstring> string_map);
     void write_value(bytes_opt value);
     void write_value(std::optional<query::result_bytes_view> value);
-    void write(const cql3::metadata& m, bool skip = false);
+    void write(const cql3::metadata& m, bool skip = false, std::optional<bytes_view> new_metadata_id = std::nullopt);
     void write(const cql3::prepared_metadata& m, uint8_t version);
 
     // Make a non-owning scattered_message of the response. Remains valid as long
     // as the response object is alive.
-    scattered_message<char> make_message(uint8_t version, cql_compression compression);
+    scattered_message<char> make_message(uint8_t version, cql_compression compression) {
+        scattered_message<char> msg;
+        append_to(msg, version, compression);
+        return msg;
+    }
+
+    // Like make_message(), but appends the response to msg, so that several
+    // responses can be sent in one write.
+    void append_to(scattered_message<char>& msg, uint8_t version, cql_compression compression);
+
+    // Packs the response into segments, for connections using the
+    // framing of protocol v5, which compresses segments rather than frames.
+    void write_to(segment_writer& writer, uint8_t version) {
+        writer.write(make_frame(version, _body.size()), _body);
+    }
 
     cql_binary_opcode opcode() const {
         return _opcode;
@@ -107,7 +123,7 @@ class response {
     }
 
     sstring make_frame(uint8_t version, size_t length) {
-        if (version > 0x04) {
+        if (version > 0x05) {
             throw exceptions::protocol_exception(format("Invalid or unsupported protocol version: {:d}", version));
         }
 
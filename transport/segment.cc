@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "transport/segment.hh"
+
+#include <seastar/core/coroutine.hh>
+#include <lz4.h>
+
+#include "exceptions/exceptions.hh"
+#include "sstables/checksum_utils.hh"
+
+namespace cql_transport {
+
+namespace segment {
+
+static constexpr size_t uncompressed_header_size = 3;
+static constexpr size_t compressed_header_size = 5;
+static constexpr size_t header_crc_size = 3;
+static constexpr size_t payload_crc_size = 4;
+
+uint32_t crc24(uint64_t data, size_t size) noexcept {
+    constexpr uint32_t init = 0x875060;
+    constexpr uint32_t poly = 0x1974F0B;
+    uint32_t crc = init;
+    while (size--) {
+        crc ^= (data & 0xff) << 16;
+        data >>= 8;
+        for (int i = 0; i < 8; ++i) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= poly;
+            }
+        }
+    }
+    return crc;
+}
+
+uint32_t crc32(const char* data, size_t size) noexcept {
+    // The payload checksum is seeded with these bytes, so that a payload
+    // of zeros doesn't have a checksum of zero.
+    static constexpr char initial_bytes[] = { char(0xFA), char(0x2D), char(0x55), char(0xCA) };
+    auto crc = crc32_utils::checksum(initial_bytes, sizeof(initial_bytes));
+    return crc32_utils::checksum(crc, data, size);
+}
+
+static void put_le(char* p, uint64_t v, size_t size) noexcept {
+    for (size_t i = 0; i < size; ++i) {
+        p[i] = char(v >> (8 * i));
+    }
+}
+
+static uint64_t get_le(const char* p, size_t size) noexcept {
+    uint64_t v = 0;
+    for (size_t i = 0; i < size; ++i) {
+        v |= uint64_t(uint8_t(p[i])) << (8 * i);
+    }
+    return v;
+}
+
+}
+
+void segment_writer::write(std::string_view header, const bytes_ostream& body) {
+    auto size = header.size() + body.size();
+    if (size > segment::max_payload_size - _payload_size) {
+        emit(true);
+    }
+    append(header);
+    for (bytes_view fragment : body.fragments()) {
+        append(std::string_view(reinterpret_cast<const char*>(fragment.data()), fragment.size()));
+    }
+    if (size > segment::max_payload_size) {
+        // The last part of a large envelope, which doesn't fill a segment,
+        // can't be followed by other envelopes.
+        emit(false);
+    }
+}
+
+void segment_writer::reserve(size_t size) {
+    size = std::min(size, segment::max_payload_size);
+    if (size <= _payload.size()) {
+        return;
+    }
+    // Grown geometrically, so that a few small envelopes don't need
+    // a buffer of a whole segment, and many don't need many copies.
+    temporary_buffer<char> payload(std::min(std::max(size, 2 * _payload.size()), segment::max_payload_size));
+    std::copy_n(_payload.get(), _payload_size, payload.get_write());
+    _payload = std::move(payload);
+}
+
+void segment_writer::append(std::string_view data) {
+    while (!data.empty()) {
+        if (_payload_size == segment::max_payload_size) {
+            // Can only happen while writing an envelope too large for a segment.
+            emit(false);
+        }
+        reserve(_payload_size + data.size());
+        auto n = std::min(data.size(), _payload.size() - _payload_size);
+        std::copy_n(data.data(), n, _payload.get_write() + _payload_size);
+        _payload_size += n;
+        data.remove_prefix(n);
+    }
+}
+
+void segment_writer::emit(bool self_contained) {
+    using namespace segment;
+    if (!_payload_size) {
+        return;
+    }
+    auto payload = _payload.get();
+    auto size = _payload_size;
+    _payload_size = 0;
+
+    if (!_compress) {
+        auto header_size = uncompressed_header_size + header_crc_size;
+        temporary_buffer<char> buf(header_size + size + payload_crc_size);
+        auto p = buf.get_write();
+        uint64_t header = size | (uint64_t(self_contained) << 17);
+        put_le(p, header, uncompressed_header_size);
+        put_le(p + uncompressed_header_size, crc24(header, uncompressed_header_size), header_crc_size);
+        std::copy_n(payload, size, p + header_size);
+        put_le(p + header_size + size, crc32(p + header_size, size), payload_crc_size);
+        _segments.push_back(std::move(buf));
+        return;
+    }
+
+    auto header_size = compressed_header_size + header_crc_size;
+    temporary_buffer<char> buf(header_size + std::max<size_t>(LZ4_compressBound(size), size) + payload_crc_size);
+    auto p = buf.get_write();
+#ifdef HAVE_LZ4_COMPRESS_DEFAULT
+    size_t compressed_size = LZ4_compress_default(payload, p + header_size, size, LZ4_compressBound(size));
+#else
+    size_t compressed_size = LZ4_compress(payload, p + header_size, size);
+#endif
+    size_t uncompressed_size = size;
+    if (compressed_size == 0 || compressed_size >= size) {
+        // Incompressible, sent as is, which is marked by an uncompressed size of 0.
+        std::copy_n(payload, size, p + header_size);
+        compressed_size = size;
+        uncompressed_size = 0;
+    }
+    uint64_t header = compressed_size | (uint64_t(uncompressed_size) << 17) | (uint64_t(self_contained) << 34);
+    put_le(p, header, compressed_header_size);
+    put_le(p + compressed_header_size, crc24(header, compressed_header_size), header_crc_size);
+    put_le(p + header_size + compressed_size, crc32(p + header_size, compressed_size), payload_crc_size);
+    buf.trim(header_size + compressed_size + payload_crc_size);
+    _segments.push_back(std::move(buf));
+}
+
+std::vector<temporary_buffer<char>> segment_writer::finish() && {
+    emit(true);
+    return std::move(_segments);
+}
+
+namespace {
+
+class segment_source final : public data_source_impl {
+    input_stream<char> _in;
+    bool _compressed;
+public:
+    segment_source(input_stream<char> in, bool compressed)
+        : _in(std::move(in))
+        , _compressed(compressed)
+    { }
+
+    virtual future<temporary_buffer<char>> get() override {
+        using namespace segment;
+        auto header_size = _compressed ? compressed_header_size : uncompressed_header_size;
+        for (;;) {
+            auto header_buf = co_await _in.read_exactly(header_size + header_crc_size);
+            if (header_buf.empty()) {
+                co_return header_buf;
+            }
+            if (header_buf.size() != header_size + header_crc_size) {
+                throw exceptions::protocol_exception("Truncated segment header");
+            }
+            auto header = get_le(header_buf.get(), header_size);
+            if (get_le(header_buf.get() + header_size, header_crc_size) != crc24(header, header_size)) {
+                throw exceptions::protocol_exception("Segment header checksum mismatch");
+            }
+            size_t size = header & max_payload_size;
+            size_t uncompressed_size = _compressed ? (header >> 17) & max_payload_size : 0;
+
+            auto payload = co_await _in.read_exactly(size + payload_crc_size);
+            if (payload.size() != size + payload_crc_size) {
+                throw exceptions::protocol_exception("Truncated segment payload");
+            }
+            if (get_le(payload.get() + size, payload_crc_size) != crc32(payload.get(), size)) {
+                throw exceptions::protocol_exception("Segment payload checksum mismatch");
+            }
+            payload.trim(size);
+            if (uncompressed_size) {
+                temporary_buffer<char> uncompressed(uncompressed_size);
+                auto ret = LZ4_decompress_safe(payload.get(), uncompressed.get_write(), size, uncompressed_size);
+                if (ret < 0 || size_t(ret) != uncompressed_size) {
+                    throw exceptions::protocol_exception("Segment LZ4 uncompression failure");
+                }
+                payload = std::move(uncompressed);
+            }
+            // An empty buffer would mean the end of the stream.
+            if (!payload.empty()) {
+                co_return payload;
+            }
+        }
+    }
+
+    virtual future<> close() override {
+        return _in.close();
+    }
+};
+
+}
+
+data_source make_segment_source(input_stream<char> in, bool compressed) {
+    return data_source(std::make_unique<segment_source>(std::move(in), compressed));
+}
+
+}
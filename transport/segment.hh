@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "seastarx.hh"
+#include "bytes_ostream.hh"
+
+namespace cql_transport {
+
+// Native protocol v5 wraps the frames (envelopes, as v5 calls them)
+// exchanged after the STARTUP handshake in segments. A segment carries
+// either any number of complete envelopes (it is "self-contained") or a
+// part of a single envelope too large for one segment. Both its header and
+// payload are protected by checksums, and when the connection negotiated
+// compression, the payload is compressed with LZ4 as a whole, so many small
+// envelopes compress much better than each of them would on its own.
+//
+// A segment is laid out as follows, with all integers little endian:
+//
+//  - header, 3 bytes uncompressed or 5 bytes compressed: payload length
+//    (17 bits), uncompressed payload length (17 bits, compressed segments
+//    only, 0 if the payload couldn't be compressed and is sent as is),
+//    self-contained flag (1 bit), padding,
+//  - CRC24 of the header, 3 bytes,
+//  - the payload,
+//  - CRC32 of the payload, 4 bytes.
+namespace segment {
+
+constexpr size_t max_payload_size = (1 << 17) - 1;
+
+uint32_t crc24(uint64_t data, size_t size) noexcept;
+uint32_t crc32(const char* data, size_t size) noexcept;
+
+}
+
+// Packs envelopes into segments.
+//
+// Envelopes written to one writer are packed into as few self-contained
+// segments as possible, so that they can be sent with a single write.
+class segment_writer {
+    bool _compress;
+    temporary_buffer<char> _payload;
+    size_t _payload_size = 0;
+    std::vector<temporary_buffer<char>> _segments;
+public:
+    explicit segment_writer(bool compress) noexcept : _compress(compress) {}
+
+    void write(std::string_view header, const bytes_ostream& body);
+
+    // Returns the segments holding all the envelopes written so far.
+    std::vector<temporary_buffer<char>> finish() &&;
+private:
+    void reserve(size_t size);
+    void append(std::string_view data);
+    void emit(bool self_contained);
+};
+
+// Returns a source of the payloads of the segments read from in, that is,
+// of the envelopes they carry. Fails with exceptions::protocol_exception
+// on a corrupted segment.
+data_source make_segment_source(input_stream<char> in, bool compressed);
+
+}
@@ -38,6 +38,7 @@
 #include "utils/result_combinators.hh"
 
 #include "enum_set.hh"
+#include "hashers.hh"
 #include "service/query_state.hh"
 #include "service/client_state.hh"
 #include "exceptions/exceptions.hh"
@@ -146,15 +147,18 @@ event::event_type parse_event_type(const sstring& value)
 cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& auth_service,
         service::memory_limiter& ml, cql_server_config config, const db::config& db_cfg,
         qos::service_level_controller& sl_controller, gms::gossiper& g)
-    : server("CQLServer", clogger)
+    : server("CQLServer", clogger, db_cfg.max_concurrent_connection_setups_per_shard(),
+            std::chrono::milliseconds(db_cfg.connection_setup_timeout_in_ms()))
     , _query_processor(qp)
     , _config(config)
     , _max_request_size(config.max_request_size)
     , _max_concurrent_requests(db_cfg.max_concurrent_requests_per_shard)
+    , _forward_requests_to_owning_shard(db_cfg.forward_requests_to_owning_shard)
     , _memory_available(ml.get_semaphore())
     , _notifier(std::make_unique<event_notifier>(*this))
     , _auth_service(auth_service)
     , _sl_controller(sl_controller)
+    , _admission_controller(db_cfg.service_levels_fair_queue_concurrency)
     , _gossiper(g)
 {
     namespace sm = seastar::metrics;
@@ -165,6 +169,12 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
 
         sm::make_derive("auth_responses", _stats.auth_responses,
                         sm::description("Counts the total number of received CQL AUTH messages.")),
+
+        sm::make_derive("connection_setups_blocked", _connection_setups_blocked,
+                        sm::description("Counts the new connections which had to wait before being set up, because max_concurrent_connection_setups_per_shard others were being set up.")),
+
+        sm::make_derive("connection_setups_timed_out", _connection_setups_timed_out,
+                        sm::description("Counts the new connections closed because they weren't set up within connection_setup_timeout_in_ms.")),
         
         sm::make_derive("options_requests", _stats.options_requests,
                         sm::description("Counts the total number of received CQL OPTIONS messages.")),
@@ -204,9 +214,20 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
                         sm::description(
                             seastar::format("Holds an incrementing counter with the requests that ever blocked due to reaching the memory quota limit ({}B). "
                                             "The first derivative of this value shows how often we block due to memory exhaustion in the \"CQL transport\" component.", _max_request_size))),
+        sm::make_derive("response_writes", _stats.response_writes,
+                        sm::description("Counts the writes of responses to client connections. Responses which are ready together are sent in one write, "
+                                        "so the ratio of responses_written to this value shows how well responses to pipelined requests are batched.")),
+        sm::make_derive("responses_written", _stats.responses_written,
+                        sm::description("Counts the responses written to client connections.")),
         sm::make_derive("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component.")),
+        sm::make_derive("requests_rate_limited", [this] { return _admission_controller.stats().rate_limited; },
+                        sm::description("Holds an incrementing counter with the requests that were rejected because their service level exceeded its max_requests_per_second.")),
+        sm::make_derive("requests_queued_for_admission", [this] { return _admission_controller.stats().queued; },
+                        sm::description("Holds an incrementing counter with the requests that had to wait for admission (limit configured via service_levels_fair_queue_concurrency).")),
+        sm::make_gauge("requests_waiting_for_admission", [this] { return _admission_controller.waiting(); },
+                        sm::description("Holds the number of requests that are currently waiting for admission (limit configured via service_levels_fair_queue_concurrency).")),
         sm::make_gauge("requests_memory_available", [this] { return _memory_available.current(); },
                         sm::description(
                             seastar::format("Holds the amount of available memory for admitting new requests (max is {}B)."
@@ -291,7 +312,8 @@ cql_server::connection::parse_frame(temporary_buffer<char> buf) const {
         break;
     }
     case 3:
-    case 4: {
+    case 4:
+    case 5: {
         cql_binary_frame_v3 raw = read_unaligned<cql_binary_frame_v3>(buf.get());
         v3 = net::ntoh(raw);
         break;
@@ -318,9 +340,9 @@ cql_server::connection::read_frame() {
             }
             _version = buf[0];
             init_cql_serialization_format();
-            if (_version < 1 || _version > current_version) {
+            if (_version < 1 || _version > _server.max_version()) {
                 auto client_version = _version;
-                _version = current_version;
+                _version = _server.max_version();
                 throw exceptions::protocol_exception(format("Invalid or unsupported protocol version: {:d}", client_version));
             }
 
@@ -360,6 +382,17 @@ cql_server::connection::read_frame() {
     }
 }
 
+// Admits requests which execute statements according to the rate limits
+// and shares of their service level, see qos::request_admission_controller.
+template <typename Process>
+future<cql_server::result_with_foreign_response_ptr>
+cql_server::connection::with_admission(const service::client_state& client_state, Process process) {
+    return _server._admission_controller.admit(client_state.get_service_level_name(), client_state.get_service_level_options()).then(
+            [process = std::move(process)] (qos::request_admission_controller::permit admission) mutable {
+        return process().finally([admission = std::move(admission)] {});
+    });
+}
+
 future<foreign_ptr<std::unique_ptr<cql_server::response>>>
     cql_server::connection::process_request_one(fragmented_temporary_buffer::istream fbuf, uint8_t op, uint16_t stream, service::client_state& client_state, tracing_request_type tracing_request, service_permit permit) {
     using auth_state = service::client_state::auth_state;
@@ -419,10 +452,19 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
         case cql_binary_opcode::STARTUP:       return wrap_in_foreign(process_startup(stream, std::move(in), client_state, trace_state));
         case cql_binary_opcode::AUTH_RESPONSE: return wrap_in_foreign(process_auth_response(stream, std::move(in), client_state, trace_state));
         case cql_binary_opcode::OPTIONS:       return wrap_in_foreign(process_options(stream, std::move(in), client_state, trace_state));
-        case cql_binary_opcode::QUERY:         return process_query(stream, std::move(in), client_state, std::move(permit), trace_state);
+        case cql_binary_opcode::QUERY:
+            return with_admission(client_state, [this, stream, in = std::move(in), &client_state, permit = std::move(permit), trace_state] () mutable {
+                return process_query(stream, std::move(in), client_state, std::move(permit), trace_state);
+            });
         case cql_binary_opcode::PREPARE:       return wrap_in_foreign(process_prepare(stream, std::move(in), client_state, trace_state));
-        case cql_binary_opcode::EXECUTE:       return process_execute(stream, std::move(in), client_state, std::move(permit), trace_state);
-        case cql_binary_opcode::BATCH:         return process_batch(stream, std::move(in), client_state, std::move(permit), trace_state);
+        case cql_binary_opcode::EXECUTE:
+            return with_admission(client_state, [this, stream, in = std::move(in), &client_state, permit = std::move(permit), trace_state] () mutable {
+                return process_execute(stream, std::move(in), client_state, std::move(permit), trace_state);
+            });
+        case cql_binary_opcode::BATCH:
+            return with_admission(client_state, [this, stream, in = std::move(in), &client_state, permit = std::move(permit), trace_state] () mutable {
+                return process_batch(stream, std::move(in), client_state, std::move(permit), trace_state);
+            });
         case cql_binary_opcode::REGISTER:      return wrap_in_foreign(process_register(stream, std::move(in), client_state, trace_state));
         default:                               throw exceptions::protocol_exception(format("Unknown opcode {:d}", int(cqlop)));
         }
@@ -474,13 +516,13 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
             return make_read_timeout_error(stream, ex.code(), ex.what(), ex.consistency, ex.received, ex.block_for, ex.data_present, trace_state);
         }), utils::result_catch<exceptions::read_failure_exception>([&] (const auto& ex) {
             try { ++_server._stats.errors[ex.code()]; } catch(...) {}
-            return make_read_failure_error(stream, ex.code(), ex.what(), ex.consistency, ex.received, ex.failures, ex.block_for, ex.data_present, trace_state);
+            return make_read_failure_error(stream, ex.code(), ex.what(), ex.consistency, ex.received, ex.failures, ex.failure_reasons, ex.block_for, ex.data_present, trace_state);
         }), utils::result_catch<exceptions::mutation_write_timeout_exception>([&] (const auto& ex) {
             try { ++_server._stats.errors[ex.code()]; } catch(...) {}
             return make_mutation_write_timeout_error(stream, ex.code(), ex.what(), ex.consistency, ex.received, ex.block_for, ex.type, trace_state);
         }), utils::result_catch<exceptions::mutation_write_failure_exception>([&] (const auto& ex) {
             try { ++_server._stats.errors[ex.code()]; } catch(...) {}
-            return make_mutation_write_failure_error(stream, ex.code(), ex.what(), ex.consistency, ex.received, ex.failures, ex.block_for, ex.type, trace_state);
+            return make_mutation_write_failure_error(stream, ex.code(), ex.what(), ex.consistency, ex.received, ex.failures, ex.failure_reasons, ex.block_for, ex.type, trace_state);
         }), utils::result_catch<exceptions::already_exists_exception>([&] (const auto& ex) {
             try { ++_server._stats.errors[ex.code()]; } catch(...) {}
             return make_already_exists_error(stream, ex.code(), ex.what(), ex.ks_name, ex.cf_name, trace_state);
@@ -533,6 +575,10 @@ cql_server::connection::connection(cql_server& server, socket_address server_add
 cql_server::connection::~connection() {
 }
 
+bool cql_server::connection::is_established() const {
+    return _client_state.get_auth_state() == service::client_state::auth_state::READY;
+}
+
 void cql_server::connection::on_connection_close()
 {
     _server._notifier->unregister_connection(this);
@@ -668,16 +714,35 @@ future<> cql_server::connection::process_request() {
                 _pending_requests_gate.leave();
             });
             auto istream = buf.get_istream();
-            (void)_process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit)
+            auto processed = _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit)
                     .then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
                 try {
-                    write_response(response_f.get0(), std::move(mem_permit), _compression);
-                    _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
+                    auto response = response_f.get0();
+                    // The memory taken for the request doesn't cover its
+                    // response, which may be much larger, e.g. a page of
+                    // wide rows. Account for the response till it's written,
+                    // so that large responses waiting to be sent hold off
+                    // new requests instead of piling up.
+                    auto response_units = consume_units(_server._memory_available, response->size());
+                    write_response(std::move(response), std::move(mem_permit), _compression);
+                    // The response to the last STARTUP or AUTH_RESPONSE may come
+                    // after the connection went on reading the next request.
+                    if (is_established()) {
+                        setup_done();
+                    }
+                    _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave), response_units = std::move(response_units)] {});
                 } catch (...) {
                     clogger.error("request processing failed: {}", std::current_exception());
                 }
             });
 
+            if (_version >= 5 && !_segment_framing && op == uint8_t(cql_binary_opcode::STARTUP)) {
+                // The client switches to segment framing once it gets the
+                // response to STARTUP, so don't read on until we know
+                // whether we switch too, see write_response().
+                return processed;
+            }
+            (void)processed;
             return make_ready_future<>();
           });
         });
@@ -706,7 +771,8 @@ void on_compression_buffer_use() {
 future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_frame(size_t length, uint8_t flags)
 {
     using namespace compression_buffers;
-    if (flags & cql_frame_flags::compression) {
+    // Since v5, whole segments are compressed, not frames.
+    if ((flags & cql_frame_flags::compression) && _version < 5) {
         if (_compression == cql_compression::lz4) {
             if (length < 4) {
                 throw std::runtime_error(fmt::format("CQL frame truncated: expected to have at least 4 bytes, got {}", length));
@@ -764,7 +830,8 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_st
          std::transform(compression.begin(), compression.end(), compression.begin(), ::tolower);
          if (compression == "lz4") {
              _compression = cql_compression::lz4;
-         } else if (compression == "snappy") {
+         } else if (compression == "snappy" && _version < 5) {
+             // v5 segments are only ever compressed with LZ4.
              _compression = cql_compression::snappy;
          } else {
              throw exceptions::protocol_exception(format("Unknown compression algorithm: {}", compression));
@@ -856,30 +923,36 @@ cql_server::connection::init_cql_serialization_format() {
 
 std::unique_ptr<cql_server::response>
 make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata = false);
+        cql_protocol_version_type version, bool skip_metadata = false, const bytes_opt& result_metadata_id = std::nullopt);
 
 template<typename Process>
 future<cql_server::result_with_foreign_response_ptr>
 cql_server::connection::process_on_shard(::shared_ptr<messages::result_message::bounce_to_shard> bounce_msg, uint16_t stream, fragmented_temporary_buffer::istream is,
         service::client_state& cs, service_permit permit, tracing::trace_state_ptr trace_state, Process process_fn) {
+    // The request's memory stays accounted on this shard by the permit, which
+    // is held here until the request completes. The target shard accounts the
+    // same amount in its own limiter, so that the permit the request carries
+    // there (and which e.g. background writes hold on to) is a real one.
+    auto permit_units = permit.count();
     return _server.container().invoke_on(*bounce_msg->move_to_shard(), _server._config.bounce_request_smp_service_group,
-            [this, is = std::move(is), cs = cs.move_to_other_shard(), stream, permit = std::move(permit), process_fn,
+            [this, is = std::move(is), cs = cs.move_to_other_shard(), stream, permit_units, process_fn,
              gt = tracing::global_trace_state_ptr(std::move(trace_state)),
              cached_vals = std::move(bounce_msg->take_cached_pk_function_calls())] (cql_server& server) {
         service::client_state client_state = cs.get();
         return do_with(bytes_ostream(), std::move(client_state), std::move(cached_vals),
-                [this, &server, is = std::move(is), stream, process_fn,
+                [this, &server, is = std::move(is), stream, permit_units, process_fn,
                  trace_state = tracing::trace_state_ptr(gt)] (bytes_ostream& linearization_buffer,
                     service::client_state& client_state,
                     cql3::computed_function_values& cached_vals) mutable {
             request_reader in(is, linearization_buffer);
+            auto permit = make_service_permit(consume_units(server._memory_available, permit_units));
             return process_fn(client_state, server._query_processor, in, stream, _version, _cql_serialization_format,
-                    /* FIXME */empty_service_permit(), std::move(trace_state), false, std::move(cached_vals)).then([] (auto msg) {
+                    std::move(permit), std::move(trace_state), false, std::move(cached_vals)).then([] (auto msg) {
                 // result here has to be foreign ptr
                 return std::get<cql_server::result_with_foreign_response_ptr>(std::move(msg));
             });
         });
-    });
+    }).finally([permit = std::move(permit)] {});
 }
 
 using process_fn_return_type = std::variant<
@@ -956,38 +1029,73 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
     ++_server._stats.prepare_requests;
 
     auto query = sstring(in.read_long_string_view());
+    if (_version >= 5) {
+        // The only flag defined is for a per-statement keyspace, which we
+        // don't support.
+        if (auto flags = in.read_int()) {
+            throw exceptions::protocol_exception(format("Unsupported PREPARE flags: {:#x}", flags));
+        }
+    }
 
     tracing::add_query(trace_state, query);
     tracing::begin(trace_state, "Preparing CQL3 query", client_state.get_client_address());
 
-    auto cpu_id = this_shard_id();
-    auto cpus = boost::irange(0u, smp::count);
-    return parallel_for_each(cpus.begin(), cpus.end(), [this, query, cpu_id, &client_state] (unsigned int c) mutable {
-        if (c != cpu_id) {
-            return smp::submit_to(c, [this, query, &client_state] () mutable {
-                return _server._query_processor.local().prepare(std::move(query), client_state, false).discard_result();
-            });
-        } else {
-            return make_ready_future<>();
-        }
-    }).then([this, query, stream, &client_state, trace_state] () mutable {
-        tracing::trace(trace_state, "Done preparing on remote shards");
-        return _server._query_processor.local().prepare(std::move(query), client_state, false).then([this, stream, &client_state, trace_state] (auto msg) {
-            tracing::trace(trace_state, "Done preparing on a local shard - preparing a result. ID is [{}]", seastar::value_of([&msg] {
-                return messages::result_message::prepared::cql::get_id(msg);
-            }));
+    // The statement is only prepared on this shard. The other shards prepare
+    // it from the remembered query string when they first execute it.
+    auto& qp = _server._query_processor.local();
+    sstring keyspace = client_state.get_raw_keyspace();
+    return qp.prepare(query, client_state, false).then([this, &qp, query, keyspace = std::move(keyspace), stream, trace_state] (auto msg) mutable {
+        tracing::trace(trace_state, "Done preparing on a local shard - preparing a result. ID is [{}]", seastar::value_of([&msg] {
+            return messages::result_message::prepared::cql::get_id(msg);
+        }));
+        auto key = cql3::prepared_cache_key_type(messages::result_message::prepared::cql::get_id(msg));
+        return qp.remember_prepared(std::move(key), std::move(query), std::move(keyspace)).then([this, msg, stream, trace_state] {
             return make_result(stream, *msg, trace_state, _version);
         });
     });
 }
 
+// Returns the shard owning the partition a prepared statement is restricted
+// to, if its partition key consists of bound values only, so that it can be
+// computed without executing the statement.
+static std::optional<unsigned> owning_shard(cql3::query_processor& qp, const cql3::statements::prepared_statement& prepared,
+        const cql3::query_options& options) {
+    auto& pk_indices = prepared.partition_key_bind_indices;
+    if (pk_indices.empty()) {
+        return std::nullopt;
+    }
+    auto& spec = *prepared.bound_names[pk_indices.front()];
+    auto t = qp.db().try_find_table(spec.ks_name, spec.cf_name);
+    if (!t) {
+        return std::nullopt;
+    }
+    auto schema = t->schema();
+    std::vector<bytes> components;
+    components.reserve(pk_indices.size());
+    for (auto i : pk_indices) {
+        auto value = options.get_value_at(i);
+        if (value.is_null() || value.is_unset_value()) {
+            return std::nullopt;
+        }
+        components.push_back(to_bytes(value));
+    }
+    auto key = partition_key::from_exploded(*schema, components);
+    return schema->get_sharder().shard_of(dht::get_token(*schema, key));
+}
+
 static future<process_fn_return_type>
 process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
-        service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+        service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls,
+        bool forward_to_owning_shard) {
+    auto original_in = in;
     cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
     auto& id = cql3::prepared_cache_key_type::cql_id(cache_key);
     bool needs_authorization = false;
+    bytes_opt result_metadata_id;
+    if (version >= 5) {
+        result_metadata_id = in.read_short_bytes();
+    }
 
     // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
     // look for the prepared statement and then authorize it.
@@ -998,7 +1106,16 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
     }
 
     if (!prepared) {
-        throw exceptions::prepared_query_not_found_exception(id);
+        // Prepared on another shard, or before a restart.
+        return qp.local().prepare_remembered(cache_key).then([&client_state, &qp, in = original_in, stream, version, serialization_format,
+                permit = std::move(permit), trace_state = std::move(trace_state), init_trace, cached_pk_fn_calls = std::move(cached_pk_fn_calls),
+                forward_to_owning_shard, id = id] (bool prepared) mutable {
+            if (!prepared) {
+                throw exceptions::prepared_query_not_found_exception(id);
+            }
+            return process_execute_internal(client_state, qp, in, stream, version, serialization_format, std::move(permit),
+                    std::move(trace_state), init_trace, std::move(cached_pk_fn_calls), forward_to_owning_shard);
+        });
     }
 
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
@@ -1045,16 +1162,30 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
         tracing::add_prepared_query_options(trace_state, options);
     }
 
+    // A request which wasn't sent to the shard owning its partition (by a
+    // driver which isn't shard-aware) is executed on the owning shard, which
+    // saves the coordinator the hop to the replica shard. init_trace is only
+    // set on the shard which received the request, so we move it at most once.
+    if (forward_to_owning_shard && init_trace) {
+        auto shard = owning_shard(qp.local(), *prepared, options);
+        if (shard && *shard != this_shard_id()) {
+            tracing::trace(trace_state, "Moving the request to shard {}", *shard);
+            return make_ready_future<process_fn_return_type>(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(
+                    qp.local().bounce_to_shard(*shard, options.take_cached_pk_function_calls())));
+        }
+    }
+
     tracing::trace(trace_state, "Processing a statement");
     return qp.local().execute_prepared_without_checking_exception_message(std::move(prepared), std::move(cache_key), query_state, options, needs_authorization)
-            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
+            .then([trace_state = query_state.get_trace_state(), skip_metadata, result_metadata_id = std::move(result_metadata_id), q_state = std::move(q_state), stream, version] (auto msg) {
         if (msg->move_to_shard()) {
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else if (msg->is_exception()) {
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata,
+                    result_metadata_id)));
         }
     });
 }
@@ -1062,7 +1193,13 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 future<cql_server::result_with_foreign_response_ptr> cql_server::connection::process_execute(uint16_t stream, request_reader in,
         service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state) {
     ++_server._stats.execute_requests;
-    return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_execute_internal);
+    return process(stream, in, client_state, std::move(permit), std::move(trace_state),
+            [forward = _server._forward_requests_to_owning_shard()] (service::client_state& client_state, distributed<cql3::query_processor>& qp,
+                    request_reader in, uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
+                    service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+        return process_execute_internal(client_state, qp, in, stream, version, serialization_format, std::move(permit),
+                std::move(trace_state), init_trace, std::move(cached_pk_fn_calls), forward);
+    });
 }
 
 static future<process_fn_return_type>
@@ -1072,6 +1209,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
     if (version == 1) {
         throw exceptions::protocol_exception("BATCH messages are not support in version 1 of the protocol");
     }
+    auto original_in = in;
 
     const auto type = in.read_byte();
     const unsigned n = in.read_short();
@@ -1114,7 +1252,16 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
             if (!ps) {
                 ps = qp.local().get_prepared(cache_key);
                 if (!ps) {
-                    throw exceptions::prepared_query_not_found_exception(id);
+                    // Prepared on another shard, or before a restart.
+                    return qp.local().prepare_remembered(cache_key).then([&client_state, &qp, in = original_in, stream, version, serialization_format,
+                            permit = std::move(permit), trace_state = std::move(trace_state), init_trace, cached_pk_fn_calls = std::move(cached_pk_fn_calls),
+                            id = id] (bool prepared) mutable {
+                        if (!prepared) {
+                            throw exceptions::prepared_query_not_found_exception(id);
+                        }
+                        return process_batch_internal(client_state, qp, in, stream, version, serialization_format, std::move(permit),
+                                std::move(trace_state), init_trace, std::move(cached_pk_fn_calls));
+                    });
                 }
                 // authorize a particular prepared statement only once
                 needs_authorization = pending_authorization_entries.emplace(std::move(cache_key), ps->checked_weak_from_this()).second;
@@ -1237,7 +1384,21 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_read_timeout_
     return response;
 }
 
-std::unique_ptr<cql_server::response> cql_server::connection::make_read_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, int32_t blockfor, bool data_present, const tracing::trace_state_ptr& tr_state) const
+void cql_server::connection::write_failures(cql_server::response& response, int32_t numfailures, const failure_reason_map& reasons) const {
+    if (_version < 5) {
+        response.write_int(numfailures);
+    } else {
+        // v5 replaced the number of failures with the reason of the failure
+        // of each replica.
+        response.write_int(reasons.size());
+        for (auto& [ep, reason] : reasons) {
+            response.write_inetaddr(ep.addr());
+            response.write_short(uint16_t(reason));
+        }
+    }
+}
+
+std::unique_ptr<cql_server::response> cql_server::connection::make_read_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, const failure_reason_map& reasons, int32_t blockfor, bool data_present, const tracing::trace_state_ptr& tr_state) const
 {
     if (_version < 4) {
         return make_read_timeout_error(stream, err, std::move(msg), cl, received, blockfor, data_present, tr_state);
@@ -1248,7 +1409,7 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_read_failure_
     response->write_consistency(cl);
     response->write_int(received);
     response->write_int(blockfor);
-    response->write_int(numfailures);
+    write_failures(*response, numfailures, reasons);
     response->write_byte(data_present);
     return response;
 }
@@ -1262,10 +1423,14 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_mutation_writ
     response->write_int(received);
     response->write_int(blockfor);
     response->write_string(format("{}", type));
+    if (_version >= 5 && type == db::write_type::CAS) {
+        // The number of contentions, which we don't track.
+        response->write_short(0);
+    }
     return response;
 }
 
-std::unique_ptr<cql_server::response> cql_server::connection::make_mutation_write_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, int32_t blockfor, db::write_type type, const tracing::trace_state_ptr& tr_state) const
+std::unique_ptr<cql_server::response> cql_server::connection::make_mutation_write_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, const failure_reason_map& reasons, int32_t blockfor, db::write_type type, const tracing::trace_state_ptr& tr_state) const
 {
     if (_version < 4) {
         return make_mutation_write_timeout_error(stream, err, std::move(msg), cl, received, blockfor, type, tr_state);
@@ -1276,7 +1441,7 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_mutation_writ
     response->write_consistency(cl);
     response->write_int(received);
     response->write_int(blockfor);
-    response->write_int(numfailures);
+    write_failures(*response, numfailures, reasons);
     response->write_string(format("{}", type));
     return response;
 }
@@ -1348,7 +1513,9 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_supported(int
     std::multimap<sstring, sstring> opts;
     opts.insert({"CQL_VERSION", cql3::query_processor::CQL_VERSION});
     opts.insert({"COMPRESSION", "lz4"});
-    opts.insert({"COMPRESSION", "snappy"});
+    if (_version < 5) {
+        opts.insert({"COMPRESSION", "snappy"});
+    }
     if (_server._config.allow_shard_aware_drivers) {
         opts.insert({"SCYLLA_SHARD", format("{:d}", this_shard_id())});
         opts.insert({"SCYLLA_NR_SHARDS", format("{:d}", smp::count)});
@@ -1378,16 +1545,38 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_supported(int
     return response;
 }
 
+// Identifies the columns of a result, so that v5 clients, which skip the
+// metadata of the results of prepared statements, learn when it changes.
+static bytes result_metadata_id(const cql3::metadata& m) {
+    md5_hasher h;
+    auto update = [&h] (std::string_view s) {
+        auto size = htonl(s.size());
+        h.update(reinterpret_cast<const char*>(&size), sizeof(size));
+        h.update(s.data(), s.size());
+    };
+    auto names_i = m.get_names().begin();
+    for (uint32_t i = 0; i < m.column_count(); ++i, ++names_i) {
+        auto& name = **names_i;
+        update(name.ks_name);
+        update(name.cf_name);
+        update(name.name->text());
+        update(name.type->name());
+    }
+    return h.finalize();
+}
+
 class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 private:
     uint8_t _version;
     cql_server::response& _response;
     bool _skip_metadata;
+    const bytes_opt& _result_metadata_id;
 public:
-    fmt_visitor(uint8_t version, cql_server::response& response, bool skip_metadata)
+    fmt_visitor(uint8_t version, cql_server::response& response, bool skip_metadata, const bytes_opt& result_metadata_id)
         : _version{version}
         , _response{response}
         , _skip_metadata{skip_metadata}
+        , _result_metadata_id{result_metadata_id}
     { }
 
     virtual void visit(const messages::result_message::void_message&) override {
@@ -1402,6 +1591,9 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
     virtual void visit(const messages::result_message::prepared::cql& m) override {
         _response.write_int(0x0004);
         _response.write_short_bytes(m.get_id());
+        if (_version >= 5) {
+            _response.write_short_bytes(result_metadata_id(*m.result_metadata()));
+        }
         _response.write(m.metadata(), _version);
         if (_version > 1) {
             _response.write(*m.result_metadata());
@@ -1425,7 +1617,18 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
     virtual void visit(const messages::result_message::rows& m) override {
         _response.write_int(0x0002);
         auto& rs = m.rs();
-        _response.write(rs.get_metadata(), _skip_metadata);
+        if (_result_metadata_id) {
+            // Sent by v5 clients executing a prepared statement, which
+            // are to be told when the columns of its result change.
+            auto id = result_metadata_id(rs.get_metadata());
+            if (id != *_result_metadata_id) {
+                _response.write(rs.get_metadata(), false, bytes_view(id));
+            } else {
+                _response.write(rs.get_metadata(), _skip_metadata);
+            }
+        } else {
+            _response.write(rs.get_metadata(), _skip_metadata);
+        }
         auto row_count_plhldr = _response.write_int_placeholder();
 
         class visitor {
@@ -1453,13 +1656,13 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 
 std::unique_ptr<cql_server::response>
 make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata) {
+        cql_protocol_version_type version, bool skip_metadata, const bytes_opt& result_metadata_id) {
     auto response = std::make_unique<cql_server::response>(stream, cql_binary_opcode::RESULT, tr_state);
     if (__builtin_expect(!msg.warnings().empty() && version > 3, false)) {
         response->set_frame_flag(cql_frame_flags::warning);
         response->write_string_list(msg.warnings());
     }
-    cql_server::fmt_visitor fmt{version, *response, skip_metadata};
+    cql_server::fmt_visitor fmt{version, *response, skip_metadata, result_metadata_id};
     msg.accept(fmt);
     return response;
 }
@@ -1495,26 +1698,77 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
 
 void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
 {
-    _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
-        auto message = response->make_message(_version, compression);
-        message.on_delete([response = std::move(response)] { });
-        return _write_buf.write(std::move(message)).then([this] {
-            return _write_buf.flush();
+    if (_segment_framing) {
+        // Responses which complete while the previous ones are being
+        // written are sent together, in as few segments as possible.
+        _unsent_responses.push_back(unsent_response{std::move(response), std::move(permit)});
+        if (_unsent_responses.size() == 1) {
+            _ready_to_respond = _ready_to_respond.then([this] {
+                return write_segments();
+            });
+        }
+        return;
+    }
+    // A v5 client switches to segment framing once it receives either of
+    // these in response to its STARTUP.
+    auto switch_framing = _version >= 5 && (response->opcode() == cql_binary_opcode::READY || response->opcode() == cql_binary_opcode::AUTHENTICATE);
+    // Like segments, responses which complete while the previous ones are
+    // being written are sent together, in one write and flush.
+    _unsent_frames.push_back(unsent_response{std::move(response), std::move(permit), compression});
+    if (_unsent_frames.size() == 1) {
+        _ready_to_respond = _ready_to_respond.then([this] {
+            return write_frames();
         });
-    });
+    }
+    if (switch_framing) {
+        start_segment_framing();
+    }
+}
+
+void cql_server::connection::start_segment_framing() {
+    _segment_framing = true;
+    _read_buf = input_stream<char>(make_segment_source(std::move(_read_buf), _compression == cql_compression::lz4));
+}
+
+future<> cql_server::connection::write_segments() {
+    auto responses = std::exchange(_unsent_responses, {});
+    segment_writer writer(_compression == cql_compression::lz4);
+    for (auto& r : responses) {
+        r.response->write_to(writer, _version);
+    }
+    scattered_message<char> message;
+    for (auto& segment : std::move(writer).finish()) {
+        message.append(std::move(segment));
+    }
+    ++_server._stats.response_writes;
+    _server._stats.responses_written += responses.size();
+    return _write_buf.write(std::move(message)).then([this] {
+        return _write_buf.flush();
+    }).finally([responses = std::move(responses)] {});
 }
 
-scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
+future<> cql_server::connection::write_frames() {
+    auto responses = std::exchange(_unsent_frames, {});
+    scattered_message<char> message;
+    for (auto& r : responses) {
+        r.response->append_to(message, _version, r.compression);
+    }
+    ++_server._stats.response_writes;
+    _server._stats.responses_written += responses.size();
+    return _write_buf.write(std::move(message)).then([this] {
+        return _write_buf.flush();
+    }).finally([responses = std::move(responses)] {});
+}
+
+void cql_server::response::append_to(scattered_message<char>& msg, uint8_t version, cql_compression compression) {
     if (compression != cql_compression::none) {
         compress(compression);
     }
-    scattered_message<char> msg;
     auto frame = make_frame(version, _body.size());
     msg.append(std::move(frame));
     for (auto&& fragment : _body.fragments()) {
         msg.append_static(reinterpret_cast<const char*>(fragment.data()), fragment.size());
     }
-    return msg;
 }
 
 void cql_server::response::compress(cql_compression compression)
@@ -1703,11 +1957,15 @@ void cql_server::response::write_short_bytes(bytes b)
 
 void cql_server::response::write_inet(socket_address inet)
 {
-    auto addr = inet.addr();
+    write_inetaddr(inet.addr());
+    write_int(inet.port());
+}
+
+void cql_server::response::write_inetaddr(const net::inet_address& addr)
+{
     write_byte(uint8_t(addr.size()));
     auto * p = static_cast<const int8_t*>(addr.data());
     _body.write(bytes_view(p, addr.size()));
-    write_int(inet.port());
 }
 
 void cql_server::response::write_consistency(db::consistency_level c)
@@ -1887,7 +2145,7 @@ thread_local const type_codec::type_id_to_type_type type_codec::type_id_to_type
     { inet_addr_type, type_id::INET },
 };
 
-void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
+void cql_server::response::write(const cql3::metadata& m, bool no_metadata, std::optional<bytes_view> new_metadata_id) {
     auto flags = m.flags();
     bool global_tables_spec = m.flags().contains<cql3::metadata::flag::GLOBAL_TABLES_SPEC>();
     bool has_more_pages = m.flags().contains<cql3::metadata::flag::HAS_MORE_PAGES>();
@@ -1895,6 +2153,9 @@ void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
     if (no_metadata) {
         flags.set<cql3::metadata::flag::NO_METADATA>();
     }
+    if (new_metadata_id) {
+        flags.set<cql3::metadata::flag::METADATA_CHANGED>();
+    }
 
     write_int(flags.mask());
     write_int(m.column_count());
@@ -1903,6 +2164,10 @@ void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
         write_value(m.paging_state()->serialize());
     }
 
+    if (new_metadata_id) {
+        write_short_bytes(bytes(*new_metadata_id));
+    }
+
     if (no_metadata) {
         return;
     }
@@ -27,6 +27,7 @@
 #include "utils/updateable_value.hh"
 #include "generic_server.hh"
 #include "service/query_state.hh"
+#include "service/qos/request_admission_controller.hh"
 #include "cql3/query_options.hh"
 #include "transport/messages/result_message.hh"
 
@@ -117,6 +118,7 @@ struct cql_server_config {
     std::optional<uint16_t> shard_aware_transport_port;
     std::optional<uint16_t> shard_aware_transport_port_ssl;
     bool allow_shard_aware_drivers = true;
+    bool allow_protocol_v5 = false;
     smp_service_group bounce_request_smp_service_group = default_smp_service_group();
 };
 
@@ -130,6 +132,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint32_t requests_serving;
         uint64_t requests_blocked_memory;
         uint64_t requests_shed;
+        uint64_t response_writes;
+        uint64_t responses_written;
 
         // cql message stats
         uint64_t startups;
@@ -146,12 +150,20 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
 private:
     class event_notifier;
 
-    static constexpr cql_protocol_version_type current_version = cql_serialization_format::latest_version;
+    // v5 changed the framing and a few messages, but not how values are
+    // serialized, so its serialization format is the same as v4's.
+    static constexpr cql_protocol_version_type current_version = 5;
+
+    // The highest version clients may use, see cql_server_config::allow_protocol_v5.
+    cql_protocol_version_type max_version() const noexcept {
+        return _config.allow_protocol_v5 ? current_version : 4;
+    }
 
     distributed<cql3::query_processor>& _query_processor;
     cql_server_config _config;
     size_t _max_request_size;
     utils::updateable_value<uint32_t> _max_concurrent_requests;
+    utils::updateable_value<bool> _forward_requests_to_owning_shard;
     semaphore& _memory_available;
     seastar::metrics::metric_groups _metrics;
     std::unique_ptr<event_notifier> _notifier;
@@ -159,6 +171,7 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     transport_stats _stats = {};
     auth::service& _auth_service;
     qos::service_level_controller& _sl_controller;
+    qos::request_admission_controller _admission_controller;
     gms::gossiper& _gossiper;
 public:
     cql_server(distributed<cql3::query_processor>& qp, auth::service&,
@@ -176,7 +189,7 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     class fmt_visitor;
     friend class connection;
     friend std::unique_ptr<cql_server::response> make_result(int16_t stream, messages::result_message& msg,
-            const tracing::trace_state_ptr& tr_state, cql_protocol_version_type version, bool skip_metadata);
+            const tracing::trace_state_ptr& tr_state, cql_protocol_version_type version, bool skip_metadata, const bytes_opt& result_metadata_id);
 
     class connection : public generic_server::connection {
         cql_server& _server;
@@ -189,6 +202,19 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         timer<lowres_clock> _shedding_timer;
         bool _shed_incoming_requests = false;
         unsigned _request_cpu = 0;
+        // Set once a v5 connection switched to segment framing, see segment.hh.
+        bool _segment_framing = false;
+        struct unsent_response {
+            foreign_ptr<std::unique_ptr<cql_server::response>> response;
+            service_permit permit;
+            // Only used by write_frames(), segments are compressed as a whole.
+            cql_compression compression = cql_compression::none;
+        };
+        // Responses waiting to be packed into segments by write_segments().
+        std::vector<unsent_response> _unsent_responses;
+        // Responses waiting to be written, before the connection switches to
+        // segment framing, if it ever does, by write_frames().
+        std::vector<unsent_response> _unsent_frames;
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -211,6 +237,7 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         virtual ~connection();
         future<> process_request() override;
         void handle_error(future<>&& f) override;
+        bool is_established() const override;
         void on_connection_close() override;
         static std::tuple<net::inet_address, int, client_type> make_client_key(const service::client_state& cli_state);
         client_data make_client_data() const;
@@ -231,13 +258,17 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         future<std::unique_ptr<cql_server::response>> process_prepare(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
         future<result_with_foreign_response_ptr> process_execute(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state);
         future<result_with_foreign_response_ptr> process_batch(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state);
+        template <typename Process>
+        future<result_with_foreign_response_ptr> with_admission(const service::client_state& client_state, Process process);
         future<std::unique_ptr<cql_server::response>> process_register(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
 
         std::unique_ptr<cql_server::response> make_unavailable_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t required, int32_t alive, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_read_timeout_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t blockfor, bool data_present, const tracing::trace_state_ptr& tr_state) const;
-        std::unique_ptr<cql_server::response> make_read_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, int32_t blockfor, bool data_present, const tracing::trace_state_ptr& tr_state) const;
+        using failure_reason_map = std::unordered_map<gms::inet_address, exceptions::request_failure_reason>;
+        void write_failures(cql_server::response& response, int32_t numfailures, const failure_reason_map& reasons) const;
+        std::unique_ptr<cql_server::response> make_read_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, const failure_reason_map& reasons, int32_t blockfor, bool data_present, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_mutation_write_timeout_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t blockfor, db::write_type type, const tracing::trace_state_ptr& tr_state) const;
-        std::unique_ptr<cql_server::response> make_mutation_write_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, int32_t blockfor, db::write_type type, const tracing::trace_state_ptr& tr_state) const;
+        std::unique_ptr<cql_server::response> make_mutation_write_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, const failure_reason_map& reasons, int32_t blockfor, db::write_type type, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_already_exists_error(int16_t stream, exceptions::exception_code err, sstring msg, sstring ks_name, sstring cf_name, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_unprepared_error(int16_t stream, exceptions::exception_code err, sstring msg, bytes id, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_function_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, sstring ks_name, sstring func_name, std::vector<sstring> args, const tracing::trace_state_ptr& tr_state) const;
@@ -262,6 +293,9 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
                 service_permit permit, tracing::trace_state_ptr trace_state, Process process_fn);
 
         void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none);
+        void start_segment_framing();
+        future<> write_segments();
+        future<> write_frames();
 
         void init_cql_serialization_format();
 
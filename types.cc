@@ -1997,6 +1997,18 @@ data_value deserialize_aux(const tuple_type_impl& t, View v) {
 template<FragmentedView View>
 utils::multiprecision_int deserialize_value(const varint_type_impl&, View v) {
     bool negative = v.current_fragment().front() < 0;
+    if (v.size_bytes() <= sizeof(int64_t)) {
+        // Most varints fit in 64 bits: sign-extend them, rather than shifting
+        // them into a cpp_int byte by byte.
+        int64_t small = negative ? -1 : 0;
+      while (v.size_bytes()) {
+        for (uint8_t b : v.current_fragment()) {
+            small = int64_t(uint64_t(small) << 8 | b);
+        }
+        v.remove_current();
+      }
+        return utils::multiprecision_int(small);
+    }
     utils::multiprecision_int num;
   while (v.size_bytes()) {
     for (uint8_t b : v.current_fragment()) {
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <csignal>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+
+#include "utils/alien_worker.hh"
+
+namespace utils {
+
+alien_worker::alien_worker(unsigned threads, int niceness) {
+    _threads.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        _threads.emplace_back([this, niceness] {
+            // Signals are the reactor's to handle.
+            sigset_t sigs;
+            sigfillset(&sigs);
+            ::pthread_sigmask(SIG_BLOCK, &sigs, nullptr);
+            // The thread inherited the affinity of the shard that started it;
+            // let it run wherever the reactors leave room, as it's niced below them.
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (int cpu = 0; cpu < ::get_nprocs(); ++cpu) {
+                CPU_SET(cpu, &cpus);
+            }
+            ::sched_setaffinity(0, sizeof(cpus), &cpus);
+            // Under Linux, the nice value is per thread.
+            ::setpriority(PRIO_PROCESS, ::syscall(SYS_gettid), niceness);
+            run();
+        });
+    }
+}
+
+alien_worker::~alien_worker() {
+    {
+        std::unique_lock lock(_mutex);
+        _stopping = true;
+    }
+    _cv.notify_all();
+    for (auto& t : _threads) {
+        t.join();
+    }
+}
+
+void alien_worker::push(task t) {
+    {
+        std::unique_lock lock(_mutex);
+        _pending.push_back(std::move(t));
+    }
+    _cv.notify_one();
+}
+
+void alien_worker::run() noexcept {
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [this] { return _stopping || !_pending.empty(); });
+        if (_pending.empty()) {
+            return;
+        }
+        auto t = std::move(_pending.front());
+        _pending.pop_front();
+        lock.unlock();
+        t();
+        lock.lock();
+    }
+}
+
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <seastar/core/alien.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "seastarx.hh"
+
+namespace utils {
+
+/// \brief A fixed pool of OS threads running blocking, CPU-heavy work off the reactor.
+///
+/// submit() queues a function for the next free thread, and resolves the
+/// returned future on the calling shard once it ran. The number of threads
+/// bounds how many such functions run at once, node-wide, however many shards
+/// submit them; the rest wait in the queue.
+///
+/// The functions must not touch any shard's state, and must not be submitted
+/// once the worker started to be destroyed.
+class alien_worker {
+    using task = noncopyable_function<void () noexcept>;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<task> _pending;
+    bool _stopping = false;
+    std::vector<std::thread> _threads;
+
+    void run() noexcept;
+    void push(task t);
+public:
+    /// Starts \p threads threads, running at the given nice(2) level.
+    alien_worker(unsigned threads, int niceness);
+    /// Waits for the queued functions to finish.
+    ~alien_worker();
+
+    alien_worker(const alien_worker&) = delete;
+    alien_worker& operator=(const alien_worker&) = delete;
+
+    template <typename T>
+    future<T> submit(noncopyable_function<T ()> func) {
+        // The promise stays put, on this shard: only a pointer to it crosses threads.
+        auto pr = std::make_unique<promise<T>>();
+        auto fut = pr->get_future();
+        push([func = std::move(func), pr = pr.release(), &alien = engine().alien(), shard = this_shard_id()] () mutable noexcept {
+            std::optional<T> result;
+            std::exception_ptr ex;
+            try {
+                result.emplace(func());
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            seastar::alien::run_on(alien, shard, [pr, result = std::move(result), ex = std::move(ex)] () mutable noexcept {
+                auto p = std::unique_ptr<promise<T>>(pr);
+                if (ex) {
+                    p->set_exception(std::move(ex));
+                } else {
+                    p->set_value(std::move(*result));
+                }
+            });
+        });
+        return fut;
+    }
+};
+
+}
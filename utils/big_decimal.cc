@@ -11,6 +11,8 @@
 #include "marshal_exception.hh"
 #include <seastar/core/print.hh>
 
+#include <limits>
+#include <optional>
 #include <regex>
 
 #ifdef __clang__
@@ -28,6 +30,43 @@ using string_view_workaround = std::string_view;
 
 #endif
 
+namespace {
+
+// Most decimals have unscaled values of up to 64 bits, and are rescaled by
+// small powers of ten. For those, rescaling, adding, comparing and dividing
+// is done in 128-bit arithmetic, which can't overflow, rather than in cpp_int
+// expression templates with their temporaries.
+using int128 = __int128;
+
+constexpr int max_small_rescale = 18;
+
+constexpr int64_t pow10_int64[max_small_rescale + 1] = {
+    1ll, 10ll, 100ll, 1000ll, 10000ll, 100000ll, 1000000ll, 10000000ll, 100000000ll, 1000000000ll,
+    10000000000ll, 100000000000ll, 1000000000000ll, 10000000000000ll, 100000000000000ll,
+    1000000000000000ll, 10000000000000000ll, 100000000000000000ll, 1000000000000000000ll,
+};
+
+std::optional<int64_t> as_int64(const boost::multiprecision::cpp_int& v) {
+    if (v < std::numeric_limits<int64_t>::min() || v > std::numeric_limits<int64_t>::max()) {
+        return std::nullopt;
+    }
+    return v.convert_to<int64_t>();
+}
+
+// x * 10^rescale, if x fits in 64 bits and rescale is small.
+std::optional<int128> small_rescaled(const boost::multiprecision::cpp_int& x, int64_t rescale) {
+    if (rescale > max_small_rescale) {
+        return std::nullopt;
+    }
+    auto small = as_int64(x);
+    if (!small) {
+        return std::nullopt;
+    }
+    return int128(*small) * pow10_int64[rescale];
+}
+
+}
+
 uint64_t from_varint_to_integer(const utils::multiprecision_int& varint) {
     // The behavior CQL expects on overflow is for values to wrap
     // around. For cpp_int conversion functions, the behavior is to
@@ -138,6 +177,11 @@ sstring big_decimal::to_string() const
 std::strong_ordering big_decimal::compare(const big_decimal& other) const
 {
     auto max_scale = std::max(_scale, other._scale);
+    auto small_x = small_rescaled(_unscaled_value, int64_t(max_scale) - _scale);
+    auto small_y = small_x ? small_rescaled(other._unscaled_value, int64_t(max_scale) - other._scale) : std::nullopt;
+    if (small_y) {
+        return *small_x <=> *small_y;
+    }
     boost::multiprecision::cpp_int rescale(10);
     boost::multiprecision::cpp_int x = _unscaled_value * boost::multiprecision::pow(rescale, max_scale - _scale);
     boost::multiprecision::cpp_int y = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
@@ -149,8 +193,15 @@ big_decimal& big_decimal::operator+=(const big_decimal& other)
     if (_scale == other._scale) {
         _unscaled_value += other._unscaled_value;
     } else {
-        boost::multiprecision::cpp_int rescale(10);
         auto max_scale = std::max(_scale, other._scale);
+        auto small_u = small_rescaled(_unscaled_value, int64_t(max_scale) - _scale);
+        auto small_v = small_u ? small_rescaled(other._unscaled_value, int64_t(max_scale) - other._scale) : std::nullopt;
+        if (small_v) {
+            _unscaled_value = *small_u + *small_v;
+            _scale = max_scale;
+            return *this;
+        }
+        boost::multiprecision::cpp_int rescale(10);
         boost::multiprecision::cpp_int u = _unscaled_value * boost::multiprecision::pow(rescale,  max_scale - _scale);
         boost::multiprecision::cpp_int v = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
         _unscaled_value = u + v;
@@ -163,8 +214,15 @@ big_decimal& big_decimal::operator-=(const big_decimal& other) {
     if (_scale == other._scale) {
         _unscaled_value -= other._unscaled_value;
     } else {
-        boost::multiprecision::cpp_int rescale(10);
         auto max_scale = std::max(_scale, other._scale);
+        auto small_u = small_rescaled(_unscaled_value, int64_t(max_scale) - _scale);
+        auto small_v = small_u ? small_rescaled(other._unscaled_value, int64_t(max_scale) - other._scale) : std::nullopt;
+        if (small_v) {
+            _unscaled_value = *small_u - *small_v;
+            _scale = max_scale;
+            return *this;
+        }
+        boost::multiprecision::cpp_int rescale(10);
         boost::multiprecision::cpp_int u = _unscaled_value * boost::multiprecision::pow(rescale,  max_scale - _scale);
         boost::multiprecision::cpp_int v = other._unscaled_value * boost::multiprecision::pow(rescale, max_scale - other._scale);
         _unscaled_value = u - v;
@@ -191,6 +249,16 @@ big_decimal big_decimal::div(const ::uint64_t y, const rounding_mode mode) const
         assert(0);
     }
 
+    if (auto small = as_int64(_unscaled_value); small && y != 0) {
+        const uint64_t a = *small >= 0 ? uint64_t(*small) : -uint64_t(*small);
+        uint64_t q = a / y;
+        const uint64_t r = a % y;
+        if (r > y - r || (r == y - r && q % 2 == 1)) {
+            q += 1;
+        }
+        return big_decimal(_scale, *small >= 0 ? int128(q) : -int128(q));
+    }
+
     // Implementation of Division with Half to Even (aka Bankers) Rounding
     const boost::multiprecision::cpp_int sign = _unscaled_value >= 0 ? +1 : -1;
     const boost::multiprecision::cpp_int a = sign * _unscaled_value;
@@ -20,9 +20,17 @@
 #include <seastar/core/loop.hh>
 #include "utils/large_bitset.hh"
 #include <array>
+#include <cmath>
 #include <cstdlib>
 #include "bloom_filter.hh"
 
+#ifdef __x86_64__
+#include <immintrin.h>
+#define arch_target(name) [[gnu::target(name)]]
+#else
+#define arch_target(name)
+#endif
+
 namespace utils {
 namespace filter {
 
@@ -76,6 +84,90 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+// Odd constants used to derive the eight per-word bit positions from a single
+// 32-bit hash, as in the Parquet split block bloom filter.
+alignas(32) static constexpr uint32_t split_block_salt[8] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+split_block_bloom_filter::split_block_bloom_filter(bitmap&& bs)
+    : _bitset(std::move(bs))
+    , _nr_blocks(_bitset.size() / bits_per_block)
+{
+    assert(_nr_blocks > 0 && _bitset.size() % bits_per_block == 0);
+    bloom_filter::_shard_stats.memory_size += memory_size();
+}
+
+split_block_bloom_filter::~split_block_bloom_filter() noexcept {
+    bloom_filter::_shard_stats.memory_size -= memory_size();
+}
+
+// Returns the index of the first bit of the block for the key, and the 32-bit
+// hash used to select bits within the block.
+static std::pair<size_t, uint32_t> split_block_position(hashed_key hk, uint64_t nr_blocks) {
+    auto h = hk.hash();
+    uint64_t block = (static_cast<unsigned __int128>(h[0]) * nr_blocks) >> 64;
+    return {block * split_block_bloom_filter::bits_per_block, static_cast<uint32_t>(h[1])};
+}
+
+// Bit i of the block's word w is bit 32 * w + i of the block.
+static unsigned split_block_bit(uint32_t h, unsigned word) {
+    return 32 * word + ((h * split_block_salt[word]) >> 27);
+}
+
+void split_block_bloom_filter::add(const bytes_view& key) {
+    auto [first_bit, h] = split_block_position(make_hashed_key(key), _nr_blocks);
+    for (unsigned w = 0; w < 8; ++w) {
+        _bitset.set(first_bit + split_block_bit(h, w));
+    }
+}
+
+using split_block = std::array<uint64_t, split_block_bloom_filter::bits_per_block / 64>;
+
+// Builds are not compiled for AVX2, so pick the probe at run time.
+arch_target("default") static bool split_block_test(const split_block& block, uint32_t h) {
+    for (unsigned w = 0; w < 8; ++w) {
+        auto bit = split_block_bit(h, w);
+        if (!(block[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __x86_64__
+arch_target("avx2") static bool split_block_test(const split_block& block, uint32_t h) {
+    auto bits = _mm256_set_epi64x(block[3], block[2], block[1], block[0]);
+    auto salt = _mm256_load_si256(reinterpret_cast<const __m256i*>(split_block_salt));
+    auto shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(h), salt), 27);
+    auto mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+    // testc returns 1 iff all bits set in mask are also set in bits.
+    return _mm256_testc_si256(bits, mask);
+}
+#endif
+
+bool split_block_bloom_filter::is_present(hashed_key key) {
+    auto [first_bit, h] = split_block_position(key, _nr_blocks);
+    auto& storage = _bitset.get_storage();
+    auto first_word = first_bit / 64;
+    return split_block_test({storage[first_word], storage[first_word + 1], storage[first_word + 2], storage[first_word + 3]}, h);
+}
+
+bool split_block_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+uint64_t split_block_bloom_filter::bits_for(int64_t num_elements, double max_false_pos_prob) {
+    // With eight bits set per key, the false positive rate of a split block
+    // filter with m bits and n keys is approximately (1 - exp(-8n/m))^8.
+    // The approximation ignores the uneven load of blocks and underestimates
+    // the real rate, so leave a 20% margin.
+    auto n = std::max<int64_t>(num_elements, 1);
+    double bits = 1.2 * -8.0 * n / std::log1p(-std::pow(max_false_pos_prob, 1.0 / 8));
+    return align_up<uint64_t>(uint64_t(std::ceil(bits)), bits_per_block);
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
@@ -86,5 +178,14 @@ filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter
     large_bitset bitset(num_bits);
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
+
+filter_ptr create_split_block_filter(large_bitset&& bitset) {
+    return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+}
+
+filter_ptr create_split_block_filter(int64_t num_elements, double max_false_pos_prob) {
+    large_bitset bitset(split_block_bloom_filter::bits_for(num_elements, max_false_pos_prob));
+    return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+}
 }
 }
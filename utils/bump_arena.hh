@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace utils {
+
+/// \brief A bump-pointer memory resource for short-lived objects
+///
+/// Allocates by bumping a pointer through chunks obtained from the
+/// general-purpose allocator. Deallocation is a no-op, the memory is only
+/// returned when the arena is cleared or destroyed, all at once. Meant for
+/// the many small temporaries of an operation with a bounded lifetime (a
+/// read), which would otherwise each be a round-trip to the allocator.
+///
+/// Chunks start small and double in size up to max_chunk_size, so an arena
+/// which is never used costs nothing and one which is used little costs
+/// little. Allocations larger than max_chunk_size get a chunk of their own.
+class bump_arena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t min_chunk_size = 1024;
+    static constexpr size_t max_chunk_size = 64 * 1024;
+private:
+    struct chunk {
+        chunk* next;
+        size_t size;
+
+        std::byte* data() noexcept {
+            return reinterpret_cast<std::byte*>(this + 1);
+        }
+    };
+
+    chunk* _chunks = nullptr;
+    std::byte* _pos = nullptr;
+    std::byte* _end = nullptr;
+    size_t _next_chunk_size = min_chunk_size;
+    size_t _memory_footprint = 0;
+
+private:
+    static std::byte* align_up(std::byte* p, size_t alignment) noexcept {
+        return reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    }
+
+    void new_chunk(size_t bytes, size_t alignment) {
+        auto size = std::max(_next_chunk_size, bytes + alignment);
+        auto c = new (::operator new(sizeof(chunk) + size)) chunk{_chunks, size};
+        _chunks = c;
+        _pos = c->data();
+        _end = _pos + size;
+        _next_chunk_size = std::min(_next_chunk_size * 2, max_chunk_size);
+        _memory_footprint += sizeof(chunk) + size;
+        on_new_chunk(sizeof(chunk) + size);
+    }
+
+protected:
+    /// Called whenever the arena grows by \p bytes, which it
+    /// doesn't give back until clear().
+    virtual void on_new_chunk(size_t bytes) { }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        auto p = align_up(_pos, alignment);
+        if (!_pos || p + bytes > _end) {
+            new_chunk(bytes, alignment);
+            p = align_up(_pos, alignment);
+        }
+        _pos = p + bytes;
+        return p;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override { }
+
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+        return this == &o;
+    }
+
+public:
+    bump_arena() = default;
+    bump_arena(const bump_arena&) = delete;
+    bump_arena& operator=(const bump_arena&) = delete;
+
+    ~bump_arena() {
+        clear();
+    }
+
+    /// Frees all the memory of the arena. Everything allocated
+    /// from it has to be dead by now.
+    void clear() noexcept {
+        while (_chunks) {
+            auto next = _chunks->next;
+            ::operator delete(_chunks, sizeof(chunk) + _chunks->size);
+            _chunks = next;
+        }
+        _pos = _end = nullptr;
+        _next_chunk_size = min_chunk_size;
+        _memory_footprint = 0;
+    }
+
+    /// The memory held by the arena, including the chunk headers.
+    size_t memory_footprint() const noexcept {
+        return _memory_footprint;
+    }
+};
+
+} // namespace utils
@@ -16,8 +16,11 @@
 
 #include <seastar/core/file.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 
 using namespace seastar;
@@ -66,9 +69,11 @@ class cached_file {
         struct cached_page_del {
             void operator()(cached_page* cp) {
                 if (--cp->_use_count == 0) {
-                    cp->parent->_metrics.bytes_in_std -= cp->_buf.size();
+                    auto* parent = cp->parent;
+                    parent->_metrics.bytes_in_std -= cp->_buf.size();
                     cp->_buf = {};
-                    cp->parent->_lru.add(*cp);
+                    parent->_lru.add(*cp, lru_kind::file_pages);
+                    parent->enforce_lru_memory_limit();
                 }
             }
         };
@@ -151,6 +156,7 @@ class cached_file {
 
     const offset_type _size;
     offset_type _cached_bytes = 0;
+    uint64_t _lru_memory_limit = std::numeric_limits<uint64_t>::max();
 
     offset_type _last_page_size;
     page_idx_type _last_page;
@@ -162,6 +168,7 @@ class cached_file {
         auto i = _cache.lower_bound(idx);
         if (i != _cache.end() && i->idx == idx) {
             ++_metrics.page_hits;
+            _lru.on_hit(lru_kind::file_pages);
             tracing::trace(trace_state, "page cache hit: file={}, page={}", _file_name, idx);
             cached_page& cp = *i;
             return make_ready_future<cached_page::ptr_type>(cp.share());
@@ -190,6 +197,7 @@ class cached_file {
                         ++_metrics.page_populations;
                         _metrics.cached_bytes += cp.size_in_allocator();
                         _cached_bytes += cp.size_in_allocator();
+                        _lru.on_memory_usage_change(lru_kind::file_pages, cp.size_in_allocator());
                     }
                     if (!first_page) {
                         first_page = cp.share();
@@ -319,9 +327,16 @@ class cached_file {
         }
     };
 
+    // May evict cp, or pages of the other cached_files sharing the LRU.
+    void enforce_lru_memory_limit() noexcept {
+        while (_lru.stats(lru_kind::file_pages).memory_usage > _lru_memory_limit
+                && _lru.evict() == seastar::memory::reclaiming_result::reclaimed_something) {}
+    }
+
     void on_evicted(cached_page& p) {
         _metrics.cached_bytes -= p.size_in_allocator();
         _cached_bytes -= p.size_in_allocator();
+        _lru.on_memory_usage_change(lru_kind::file_pages, -int64_t(p.size_in_allocator()));
         ++_metrics.page_evictions;
     }
 
@@ -361,6 +376,15 @@ class cached_file {
         _last_page = last_byte_offset / page_size;
     }
 
+    /// \brief Bounds the memory of the pages in the LRU.
+    ///
+    /// Whenever a page becomes evictable, pages are evicted from the LRU until the
+    /// pages in it take at most max_bytes. Only for an LRU which holds nothing else than the
+    /// pages of cached_files with the same limit, and so has its own budget.
+    void set_lru_memory_limit(uint64_t max_bytes) noexcept {
+        _lru_memory_limit = max_bytes;
+    }
+
     cached_file(cached_file&&) = delete; // captured this
     cached_file(const cached_file&) = delete;
 
@@ -422,6 +446,61 @@ class cached_file {
         return stream(*this, pc, std::move(permit), std::move(trace_state), page_idx, offset, size_hint);
     }
 
+    /// \brief Populates the cache with the pages covering the given byte ranges.
+    ///
+    /// Reads of all missing pages are issued at once, with runs of adjacent
+    /// pages coalesced into a single read, so that they are submitted to the
+    /// disk in one batch rather than as a sequence of dependent reads.
+    /// Useful when the caller knows which parts of the file it is going to
+    /// read next, but has to read them one after another.
+    ///
+    /// \param ranges Byte ranges [start, end), relative to the cached file area.
+    ///               Parts beyond the end of the area are ignored.
+    future<> prefetch(std::vector<std::pair<offset_type, offset_type>> ranges,
+                      const io_priority_class& pc,
+                      tracing::trace_state_ptr trace_state = {}) {
+        std::vector<page_idx_type> pages;
+        for (auto [start, end] : ranges) {
+            end = std::min(end, _size);
+            if (start >= end) {
+                continue;
+            }
+            for (auto idx = start / page_size; idx <= (end - 1) / page_size; ++idx) {
+                auto i = _cache.lower_bound(idx);
+                if (i == _cache.end() || i->idx != idx) {
+                    pages.push_back(idx);
+                }
+            }
+        }
+        std::sort(pages.begin(), pages.end());
+        pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+        // Runs of adjacent missing pages, as (first page, page count).
+        std::vector<std::pair<page_idx_type, page_count_type>> runs;
+        for (auto idx : pages) {
+            if (!runs.empty() && runs.back().first + runs.back().second == idx) {
+                ++runs.back().second;
+            } else {
+                runs.emplace_back(idx, 1);
+            }
+        }
+        if (!runs.empty()) {
+            tracing::trace(trace_state, "page cache prefetch: file={}, pages={}, reads={}", _file_name, pages.size(), runs.size());
+        }
+        co_await parallel_for_each(runs, [this, &pc, &trace_state] (std::pair<page_idx_type, page_count_type> run) {
+            return get_page_ptr(run.first, run.second, pc, trace_state).then([this, run] (cached_page::ptr_type) {
+                // Only the first page of a read is handed out, make sure the
+                // others are linked in the LRU too, so that they can be evicted.
+                for (auto idx = run.first + 1; idx < run.first + run.second; ++idx) {
+                    auto i = _cache.lower_bound(idx);
+                    if (i != _cache.end() && i->idx == idx) {
+                        i->share();
+                    }
+                }
+            });
+        });
+    }
+
     /// \brief Returns the number of bytes in the area managed by this instance.
     offset_type size() const {
         return _size;
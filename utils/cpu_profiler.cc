@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/util/backtrace.hh>
+
+#include "utils/cpu_profiler.hh"
+#include "log.hh"
+
+static logging::logger cpulog("cpu_profiler");
+
+namespace utils::cpu_profiler {
+
+static constexpr unsigned max_frequency = 1000;
+static constexpr size_t max_frames = 64;
+// Drained every drain_period, enough for max_frequency with room to spare.
+static constexpr size_t max_pending_samples = 256;
+static constexpr auto drain_period = std::chrono::milliseconds(100);
+// Bounds the memory used by the counts, when the stacks are too diverse.
+static constexpr size_t max_stacks = 10000;
+
+namespace {
+
+struct sample {
+    scheduling_group sg;
+    unsigned nr_frames;
+    std::array<seastar::frame, max_frames> frames;
+};
+
+class profiler {
+    timer_t _timer;
+    unsigned _frequency = 0;
+    // Written by the signal handler, which only interrupts this shard's
+    // thread. _busy keeps it away from the buffer while it's being drained.
+    std::unique_ptr<std::array<sample, max_pending_samples>> _pending;
+    std::atomic<unsigned> _nr_pending = 0;
+    std::atomic<bool> _busy = false;
+    std::atomic<uint64_t> _dropped = 0;
+    std::unordered_map<sstring, uint64_t> _stacks;
+    timer<lowres_clock> _drain_timer;
+public:
+    profiler();
+    ~profiler();
+    void set_frequency(unsigned frequency);
+    unsigned frequency() const noexcept { return _frequency; }
+    uint64_t dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+    void record() noexcept;
+    void drain();
+    std::vector<std::pair<sstring, uint64_t>> folded_stacks(bool reset);
+};
+
+thread_local std::unique_ptr<profiler> local_profiler;
+// What the signal handler records into, set only while the profiler of the
+// thread is fully constructed.
+thread_local std::atomic<profiler*> signal_target = nullptr;
+
+void on_signal(int, siginfo_t*, void*) {
+    if (auto p = signal_target.load(std::memory_order_relaxed)) {
+        p->record();
+    }
+}
+
+void install_signal_handler() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        struct sigaction sa = {};
+        sa.sa_sigaction = on_signal;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (sigaction(SIGPROF, &sa, nullptr) != 0) {
+            throw std::system_error(errno, std::system_category(), "cpu_profiler: sigaction");
+        }
+    });
+    // Reactor threads start with most signals blocked.
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPROF);
+    pthread_sigmask(SIG_UNBLOCK, &set, nullptr);
+}
+
+profiler::profiler()
+        : _pending(std::make_unique<std::array<sample, max_pending_samples>>())
+        , _drain_timer([this] { drain(); }) {
+    install_signal_handler();
+    sigevent sev = {};
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGPROF;
+    sev._sigev_un._tid = syscall(SYS_gettid);
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &_timer) != 0) {
+        throw std::system_error(errno, std::system_category(), "cpu_profiler: timer_create");
+    }
+    signal_target.store(this, std::memory_order_relaxed);
+}
+
+profiler::~profiler() {
+    signal_target.store(nullptr, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    timer_delete(_timer);
+}
+
+void profiler::set_frequency(unsigned frequency) {
+    frequency = std::min(frequency, max_frequency);
+    itimerspec its = {};
+    if (frequency) {
+        const auto period_ns = 1'000'000'000ul / frequency;
+        its.it_interval.tv_sec = period_ns / 1'000'000'000;
+        its.it_interval.tv_nsec = period_ns % 1'000'000'000;
+        its.it_value = its.it_interval;
+    }
+    if (timer_settime(_timer, 0, &its, nullptr) != 0) {
+        throw std::system_error(errno, std::system_category(), "cpu_profiler: timer_settime");
+    }
+    if (frequency && !_drain_timer.armed()) {
+        _drain_timer.arm_periodic(drain_period);
+    } else if (!frequency) {
+        _drain_timer.cancel();
+        drain();
+    }
+    _frequency = frequency;
+}
+
+void profiler::record() noexcept {
+    const auto n = _nr_pending.load(std::memory_order_relaxed);
+    if (_busy.load(std::memory_order_relaxed) || n == max_pending_samples) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto& s = (*_pending)[n];
+    s.sg = current_scheduling_group();
+    s.nr_frames = 0;
+    seastar::backtrace([&s] (seastar::frame f) {
+        if (s.nr_frames < max_frames) {
+            s.frames[s.nr_frames++] = f;
+        }
+    });
+    std::atomic_signal_fence(std::memory_order_release);
+    _nr_pending.store(n + 1, std::memory_order_relaxed);
+}
+
+void profiler::drain() {
+    _busy.store(true, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    const auto n = _nr_pending.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < n; ++i) {
+        auto& s = (*_pending)[i];
+        // Folded stacks start from the root, backtraces from the leaf.
+        sstring stack = s.sg.name();
+        for (auto f = s.nr_frames; f > 0; --f) {
+            auto& frame = s.frames[f - 1];
+            if (frame.so->name.empty()) {
+                stack += format(";0x{:x}", frame.addr);
+            } else {
+                stack += format(";{}+0x{:x}", frame.so->name, frame.addr);
+            }
+        }
+        if (auto it = _stacks.find(stack); it != _stacks.end()) {
+            ++it->second;
+        } else if (_stacks.size() < max_stacks) {
+            _stacks.emplace(std::move(stack), 1);
+        } else {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    _nr_pending.store(0, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    _busy.store(false, std::memory_order_relaxed);
+}
+
+std::vector<std::pair<sstring, uint64_t>> profiler::folded_stacks(bool reset) {
+    drain();
+    std::vector<std::pair<sstring, uint64_t>> ret(_stacks.begin(), _stacks.end());
+    if (reset) {
+        _stacks.clear();
+    }
+    return ret;
+}
+
+profiler& get_local_profiler() {
+    if (!local_profiler) {
+        local_profiler = std::make_unique<profiler>();
+    }
+    return *local_profiler;
+}
+
+} // anonymous namespace
+
+void set_frequency(unsigned frequency) {
+    if (!frequency && !local_profiler) {
+        return;
+    }
+    cpulog.debug("Setting sampling frequency to {} Hz", frequency);
+    get_local_profiler().set_frequency(frequency);
+}
+
+unsigned frequency() noexcept {
+    return local_profiler ? local_profiler->frequency() : 0;
+}
+
+std::vector<std::pair<sstring, uint64_t>> folded_stacks(bool reset) {
+    return local_profiler ? local_profiler->folded_stacks(reset) : std::vector<std::pair<sstring, uint64_t>>();
+}
+
+uint64_t dropped_samples() noexcept {
+    return local_profiler ? local_profiler->dropped() : 0;
+}
+
+}
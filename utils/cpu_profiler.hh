@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <seastar/core/sstring.hh>
+
+#include "seastarx.hh"
+
+namespace utils {
+
+/// \brief A sampling CPU profiler for production nodes
+///
+/// Each shard arms a timer on its thread's CPU time, which sends it SIGPROF
+/// `frequency` times per second of CPU time. The signal handler saves the
+/// backtrace of the interrupted code and its scheduling group into a fixed
+/// buffer, without allocating or taking locks, and the buffer is drained
+/// into per-stack counts in the background.
+///
+/// The stacks are in the folded format of flamegraph.pl, with the scheduling
+/// group as the root frame, the frames as the addresses which
+/// seastar-addr2line decodes, and the number of samples at the end.
+namespace cpu_profiler {
+
+/// Starts sampling the current shard at \p frequency Hz (at most 1000), or
+/// changes the frequency if already started. 0 stops sampling, but keeps the
+/// samples collected so far.
+void set_frequency(unsigned frequency);
+
+unsigned frequency() noexcept;
+
+/// Returns the folded stacks sampled on the current shard so far and their
+/// counts. The samples are dropped if \p reset is set.
+std::vector<std::pair<sstring, uint64_t>> folded_stacks(bool reset);
+
+/// The number of samples which couldn't be recorded, because the buffer was
+/// full or too many distinct stacks were seen.
+uint64_t dropped_samples() noexcept;
+
+}
+
+}
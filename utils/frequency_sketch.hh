@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+// Approximates the recent access frequency of items, identified by their
+// 64-bit hashes, with a count-min sketch of 4-bit counters.
+//
+// Each item maps to 4 counters in different words of the table, and its
+// frequency is estimated as the minimum of the 4 counters, so estimates
+// can only be too high, because of collisions. Counters saturate at 15.
+//
+// To keep the frequencies recent, all counters are halved after every
+// sample_size() recorded accesses.
+class frequency_sketch {
+public:
+    static constexpr unsigned max_frequency = 15;
+private:
+    static constexpr unsigned counters_per_item = 4;
+    static constexpr std::array<uint64_t, counters_per_item> _seeds = {
+        0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full, 0xcbf29ce484222325ull,
+    };
+
+    // Each word holds 16 counters.
+    std::vector<uint64_t> _table;
+    uint64_t _mask;
+    uint64_t _sample_size;
+    uint64_t _additions = 0;
+    uint64_t _resets = 0;
+private:
+    // Returns the word index in the upper 32 bits and the counter index in the lowest 4 bits.
+    static uint64_t spread(uint64_t hash, unsigned i) noexcept {
+        uint64_t h = (hash + _seeds[i]) * _seeds[i];
+        return h ^ (h >> 29);
+    }
+
+    template <typename Func>
+    void for_each_counter(uint64_t hash, Func&& func) {
+        for (unsigned i = 0; i < counters_per_item; ++i) {
+            auto h = spread(hash, i);
+            func(_table[(h >> 32) & _mask], (h & 15) * 4);
+        }
+    }
+
+    static unsigned get(uint64_t word, unsigned shift) noexcept {
+        return (word >> shift) & 15;
+    }
+
+    void reset() noexcept {
+        for (auto& word : _table) {
+            word = (word >> 1) & 0x7777777777777777ull;
+        }
+        _additions /= 2;
+        ++_resets;
+    }
+public:
+    // The table has a power of two words, at least size / 16.
+    explicit frequency_sketch(size_t size) {
+        size_t words = 1;
+        while (words * 16 < size) {
+            words *= 2;
+        }
+        _table.resize(words);
+        _mask = words - 1;
+        _sample_size = words * 16 * 10;
+    }
+
+    // Records an access to the item.
+    void record(uint64_t hash) noexcept {
+        // Conservative update: only the smallest counters are incremented,
+        // which reduces the overestimation due to collisions.
+        auto min = estimate(hash);
+        if (min == max_frequency) {
+            return;
+        }
+        for_each_counter(hash, [min] (uint64_t& word, unsigned shift) {
+            if (get(word, shift) == min) {
+                word += uint64_t(1) << shift;
+            }
+        });
+        if (++_additions >= _sample_size) {
+            reset();
+        }
+    }
+
+    // Returns the estimated number of recent accesses to the item, at most max_frequency.
+    unsigned estimate(uint64_t hash) const noexcept {
+        unsigned min = max_frequency;
+        for (unsigned i = 0; i < counters_per_item; ++i) {
+            auto h = spread(hash, i);
+            min = std::min(min, get(_table[(h >> 32) & _mask], (h & 15) * 4));
+        }
+        return min;
+    }
+
+    uint64_t sample_size() const noexcept {
+        return _sample_size;
+    }
+
+    // Number of times the counters were halved.
+    uint64_t resets() const noexcept {
+        return _resets;
+    }
+};
+
+} // namespace utils
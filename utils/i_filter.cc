@@ -31,6 +31,29 @@ filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_proba
     return filter::create_filter(spec.K, num_elements, spec.buckets_per_element, fformat);
 }
 
+filter_ptr i_filter::get_split_block_filter(int64_t num_elements, double max_false_pos_probability) {
+    assert(seastar::thread::running_in_thread());
+
+    if (max_false_pos_probability > 1.0) {
+        throw std::invalid_argument(format("Invalid probability {:f}: must be lower than 1.0", max_false_pos_probability));
+    }
+
+    if (max_false_pos_probability == 1.0) {
+        return std::make_unique<filter::always_present_filter>();
+    }
+
+    // Bound the size of the filter like get_filter() does, by the bits per
+    // element it's willing to spend, and fall back to a classic filter for
+    // false positive chances a split block filter can't meet within them.
+    int64_t max_bits = int64_t(bloom_calculations::max_buckets_per_element(num_elements)) * std::max<int64_t>(num_elements, 1);
+    if (filter::split_block_bloom_filter::bits_for(num_elements, max_false_pos_probability) > uint64_t(max_bits)) {
+        filterlog.debug("Split block bloom filter can't satisfy {:f} for {} elements, using a classic filter", max_false_pos_probability, num_elements);
+        return get_filter(num_elements, max_false_pos_probability, filter_format::m_format);
+    }
+
+    return filter::create_split_block_filter(num_elements, max_false_pos_probability);
+}
+
 hashed_key make_hashed_key(bytes_view b) {
     std::array<uint64_t, 2> h;
     utils::murmur_hash::hash3_x64_128(b, 0, h);
@@ -56,5 +56,13 @@ struct i_filter {
      *         filter.
      */
     static filter_ptr get_filter(int64_t num_elements, double max_false_pos_prob, filter_format format);
+
+    /**
+     * @return The smallest split block bloom filter that can provide the given
+     *         false positive probability rate for the given number of elements.
+     *         See filter::split_block_bloom_filter. Falls back to get_filter()
+     *         when that would take more bits per element than it allows.
+     */
+    static filter_ptr get_split_block_filter(int64_t num_elements, double max_false_pos_prob);
 };
 }
@@ -12,7 +12,12 @@
 
 #include <boost/regex/icu.hpp>
 #include <boost/locale/encoding.hpp>
+#include <cstring>
+#include <optional>
 #include <string>
+#include <vector>
+
+#include "utils/utf8.hh"
 
 namespace {
 
@@ -75,33 +80,118 @@ wstring regex_from_pattern(bytes_view pattern) {
     return re;
 }
 
+/// The literal parts of a pattern without '_' wildcards, which are separated
+/// by '%' wildcards; nullopt if the pattern has a '_' wildcard.
+///
+/// Such a pattern is matched by searching for the bytes of its parts, with no
+/// regex. As UTF-8 is self-synchronizing, the bytes of a valid part only occur
+/// in valid text at character boundaries.
+std::optional<std::vector<bytes>> literal_parts(bytes_view pattern) {
+    std::vector<bytes> parts;
+    std::vector<int8_t> part;
+    auto end_part = [&] {
+        parts.emplace_back(part.data(), part.size());
+        part.clear();
+    };
+    bool escaping = false;
+    for (auto c : pattern) {
+        if (escaping) {
+            part.push_back(c);
+            escaping = false;
+        } else if (c == '\\') {
+            escaping = true;
+        } else if (c == '_') {
+            return std::nullopt;
+        } else if (c == '%') {
+            end_part();
+        } else {
+            part.push_back(c);
+        }
+    }
+    if (escaping) {
+        // An unescaped backslash at the end matches itself.
+        part.push_back('\\');
+    }
+    end_part();
+    return parts;
+}
+
+bool starts_with(bytes_view text, bytes_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+bool ends_with(bytes_view text, bytes_view suffix) {
+    return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
 } // anonymous namespace
 
 class like_matcher::impl {
     bytes _pattern;
-    boost::u32regex _re; // Performs pattern matching.
+    // Set when the pattern has no '_', see literal_parts().
+    std::optional<std::vector<bytes>> _parts;
+    std::optional<boost::u32regex> _re; // Performs pattern matching otherwise.
   public:
     explicit impl(bytes_view pattern);
     bool operator()(bytes_view text) const;
     void reset(bytes_view pattern);
   private:
-    void init_re() {
-        _re = boost::make_u32regex(regex_from_pattern(_pattern), boost::u32regex::basic | boost::u32regex::optimize);
+    void compile(bytes_view pattern) {
+        // An invalid pattern is left for the regex to reject.
+        auto parts = utils::utf8::validate(pattern) ? literal_parts(pattern) : std::nullopt;
+        std::optional<boost::u32regex> re;
+        if (!parts) {
+            re = boost::make_u32regex(regex_from_pattern(pattern), boost::u32regex::basic | boost::u32regex::optimize);
+        }
+        _pattern = bytes(pattern);
+        _parts = std::move(parts);
+        _re = std::move(re);
     }
+
+    bool match_parts(bytes_view text) const;
 };
 
-like_matcher::impl::impl(bytes_view pattern) : _pattern(pattern) {
-    init_re();
+like_matcher::impl::impl(bytes_view pattern) {
+    compile(pattern);
+}
+
+bool like_matcher::impl::match_parts(bytes_view text) const {
+    auto& parts = *_parts;
+    if (parts.size() == 1) {
+        return text == bytes_view(parts.front());
+    }
+    bytes_view first = parts.front();
+    bytes_view last = parts.back();
+    if (text.size() < first.size() + last.size() || !starts_with(text, first) || !ends_with(text, last)) {
+        return false;
+    }
+    // Taking the leftmost occurrence of each part in between leaves the most
+    // room for the following ones.
+    text = text.substr(first.size(), text.size() - first.size() - last.size());
+    for (size_t i = 1; i + 1 < parts.size(); ++i) {
+        bytes_view part = parts[i];
+        if (part.empty()) {
+            continue;
+        }
+        auto found = static_cast<const int8_t*>(::memmem(text.data(), text.size(), part.data(), part.size()));
+        if (!found) {
+            return false;
+        }
+        text.remove_prefix(found - text.data() + part.size());
+    }
+    return true;
 }
 
 bool like_matcher::impl::operator()(bytes_view text) const {
-    return boost::u32regex_match(text.begin(), text.end(), _re);
+    if (_parts) {
+        return match_parts(text);
+    }
+    return boost::u32regex_match(text.begin(), text.end(), *_re);
 }
 
 void like_matcher::impl::reset(bytes_view pattern) {
     if (pattern != _pattern) {
-        _pattern = bytes(pattern);
-        init_re();
+        compile(pattern);
     }
 }
 
@@ -22,6 +22,8 @@
 #include <seastar/core/metrics.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/abort_source.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/core/with_scheduling_group.hh>
 #include <seastar/util/alloc_failure_injector.hh>
@@ -38,6 +40,7 @@
 
 #include <random>
 #include <chrono>
+#include <sys/mman.h>
 
 using namespace std::chrono_literals;
 
@@ -432,8 +435,57 @@ class background_reclaimer {
     }
 };
 
+// Compacts the sparsest segments of regions whose compactible occupancy is below
+// the target, before allocations need the memory, so that it does not have to be
+// freed by reclaim on the allocation path. Runs in its own scheduling group, and
+// for at most cpu_budget of every period.
+class background_defragmenter {
+    scheduling_group _sg;
+    // Compacts segments until preemption or the deadline. Returns false when there is nothing to compact,
+    // or compaction is disabled.
+    noncopyable_function<bool (clock::time_point deadline)> _defragment;
+    clock::duration _budget;
+    abort_source _as;
+    future<> _done;
+    static constexpr clock::duration period = 100ms;
+private:
+    future<> main_loop() {
+        llogger.debug("background_defragmenter::main_loop: entry");
+        while (!_as.abort_requested()) {
+            auto start = clock::now();
+            auto deadline = start + _budget;
+            bool more = true;
+            while (more && !_as.abort_requested() && clock::now() < deadline) {
+                more = _defragment(deadline);
+                co_await coroutine::maybe_yield();
+            }
+            auto next = start + (more ? period : 10 * period);
+            try {
+                co_await sleep_abortable(std::max(next - clock::now(), clock::duration(0)), _as);
+            } catch (const sleep_aborted&) {
+                break;
+            }
+        }
+        llogger.debug("background_defragmenter::main_loop: exit");
+    }
+public:
+    background_defragmenter(scheduling_group sg, double cpu_budget, noncopyable_function<bool (clock::time_point)> defragment)
+            : _sg(sg)
+            , _defragment(std::move(defragment))
+            , _budget(std::chrono::duration_cast<clock::duration>(period * std::clamp(cpu_budget, 0.0, 1.0)))
+            , _done(with_scheduling_group(_sg, [this] { return main_loop(); })) {
+    }
+    future<> stop() {
+        _as.request_abort();
+        return std::move(_done);
+    }
+};
+
 class tracker::impl {
     std::optional<background_reclaimer> _background_reclaimer;
+    std::optional<background_defragmenter> _background_defragmenter;
+    double _defragmentation_target_occupancy = 0;
+    uint64_t _segments_defragmented = 0;
     std::vector<region::impl*> _regions;
     seastar::metrics::metric_groups _metrics;
     bool _reclaiming_enabled = true;
@@ -461,10 +513,11 @@ class tracker::impl {
     impl();
     ~impl();
     future<> stop() {
+        if (_background_defragmenter) {
+            co_await _background_defragmenter->stop();
+        }
         if (_background_reclaimer) {
-            return _background_reclaimer->stop();
-        } else {
-            return make_ready_future<>();
+            co_await _background_reclaimer->stop();
         }
     }
     void register_region(region::impl*);
@@ -495,6 +548,19 @@ class tracker::impl {
             reclaim(target, is_preemptible::yes);
         });
     }
+    void setup_background_defragmentation(scheduling_group sg, double target_occupancy, double cpu_budget) {
+        assert(!_background_defragmenter);
+        _defragmentation_target_occupancy = target_occupancy;
+        _background_defragmenter.emplace(sg, cpu_budget, [this] (clock::time_point deadline) {
+            return defragment(deadline);
+        });
+    }
+    // Compacts the sparsest segments of regions with compactible occupancy below
+    // the defragmentation target, until preemption or the deadline.
+    // Returns false if there was nothing to compact.
+    bool defragment(clock::time_point deadline);
+    // The amount of memory which compacting all regions to the target occupancy would free.
+    size_t compaction_debt(double target_occupancy) const;
 private:
     // Like compact_and_evict() but assumes that reclaim_lock is held around the operation.
     size_t compact_and_evict_locked(size_t reserve_segments, size_t bytes, is_preemptible preempt);
@@ -657,16 +723,22 @@ struct segment_descriptor : public log_heap_hook<segment_descriptor_hist_options
 
 using segment_descriptor_hist = log_heap<segment_descriptor, segment_descriptor_hist_options>;
 
+static constexpr size_t hugepage_size = 2 * 1024 * 1024;
+static constexpr size_t segments_per_hugepage = hugepage_size / segment::size;
+
 #ifndef SEASTAR_DEFAULT_ALLOCATOR
 class segment_store {
     memory::memory_layout _layout;
     uintptr_t _segments_base; // The address of the first segment
+    uintptr_t _hugepages_base; // The address of the first hugepage
 
 public:
+    static constexpr bool supports_hugepage_chunks = true;
     size_t non_lsa_reserve = 0;
     segment_store()
         : _layout(memory::get_memory_layout())
-        , _segments_base(align_down(_layout.start, (uintptr_t)segment::size)) {
+        , _segments_base(align_down(_layout.start, (uintptr_t)segment::size))
+        , _hugepages_base(align_down(_layout.start, (uintptr_t)hugepage_size)) {
     }
     segment* segment_from_idx(size_t idx) const {
         return reinterpret_cast<segment*>(_segments_base) + idx;
@@ -684,6 +756,19 @@ class segment_store {
     bool can_allocate_more_segments() {
         return memory::stats().free_memory() >= non_lsa_reserve + segment::size;
     }
+    size_t hugepage_idx(size_t seg_idx) const {
+        return (reinterpret_cast<uintptr_t>(segment_from_idx(seg_idx)) - _hugepages_base) / hugepage_size;
+    }
+    // Valid only for hugepages which lie entirely within the shard's memory.
+    size_t first_idx_of_hugepage(size_t hp_idx) const {
+        return (_hugepages_base + hp_idx * hugepage_size - _segments_base) / segment::size;
+    }
+    size_t max_hugepages() const {
+        return (align_up(_layout.end, (uintptr_t)hugepage_size) - _hugepages_base) / hugepage_size;
+    }
+    bool can_allocate_more_hugepages() {
+        return memory::stats().free_memory() >= non_lsa_reserve + hugepage_size;
+    }
 };
 #else
 class segment_store {
@@ -696,6 +781,9 @@ class segment_store {
     }
 
 public:
+    // Segments are not placed in memory by address, so they are grouped
+    // into hugepages by index only, for accounting.
+    static constexpr bool supports_hugepage_chunks = false;
     size_t non_lsa_reserve = 0;
     segment_store() : _segments(max_segments()) {
         _segment_indexes.reserve(max_segments());
@@ -741,6 +829,18 @@ class segment_store {
         auto i = find_empty();
         return i != _segments.end();
     }
+    size_t hugepage_idx(size_t seg_idx) const {
+        return seg_idx / segments_per_hugepage;
+    }
+    size_t first_idx_of_hugepage(size_t hp_idx) const {
+        return hp_idx * segments_per_hugepage;
+    }
+    size_t max_hugepages() const {
+        return max_segments() / segments_per_hugepage + 1;
+    }
+    bool can_allocate_more_hugepages() {
+        return false;
+    }
 };
 #endif
 
@@ -777,6 +877,18 @@ class segment_pool {
     };
 
     size_t _non_lsa_memory_in_use = 0;
+
+    // In hugepage mode, segments are allocated from the seastar allocator in chunks
+    // of segments_per_hugepage segments aligned to a (transparent) huge page. A chunk
+    // is only returned to the seastar allocator as a whole, so LSA memory doesn't share
+    // huge pages with the general purpose allocator. See set_hugepage_mode().
+    bool _hugepage_mode = false;
+    utils::dynamic_bitset _hugepage_chunks; // hugepages allocated as a chunk
+    size_t _hugepage_chunk_count = 0;
+    // Number of segments in use per hugepage, the TLB footprint of LSA data.
+    std::vector<uint8_t> _hugepage_segments_in_use;
+    size_t _hugepages_in_use = 0;
+
     // Invariants - a segment is in one of the following states:
     //   In use by some region
     //     - set in _lsa_owned_segments_bitmap
@@ -809,8 +921,18 @@ class segment_pool {
         return _allocation_enabled && _store.can_allocate_more_segments();
     }
     bool compact_segment(segment* seg);
+    segment* allocate_hugepage_chunk();
+    size_t reclaim_hugepages(size_t target, is_preemptible preempt);
+    void account_segment_use(segment* seg, bool in_use) noexcept;
 public:
     segment_pool();
+    // Enables allocation of segments in hugepage-aligned chunks.
+    // Takes effect only with the seastar allocator. Should be set before prime().
+    void set_hugepage_mode(bool enabled) {
+        _hugepage_mode = enabled && segment_store::supports_hugepage_chunks;
+    }
+    size_t hugepage_chunks() const { return _hugepage_chunk_count; }
+    size_t hugepages_in_use() const { return _hugepages_in_use; }
     void prime(size_t available_memory, size_t min_free_memory);
     segment* new_segment(region::impl* r);
     segment_descriptor& descriptor(segment*);
@@ -877,6 +999,10 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
 
     llogger.debug("Trying to reclaim {} segments", target);
 
+    if (_hugepage_mode) {
+        return reclaim_hugepages(target, preempt);
+    }
+
     // Reclamation. Migrate segments to higher addresses and shrink segment pool.
     size_t reclaimed_segments = 0;
 
@@ -923,6 +1049,121 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
     return reclaimed_segments;
 }
 
+// Like reclaim_segments(), but releases segments of hugepage chunks only once the
+// whole chunk is free. May release more than target segments.
+size_t segment_pool::reclaim_hugepages(size_t target, is_preemptible preempt) {
+    size_t reclaimed_segments = 0;
+    size_t failed_reclaims_allowance = 10;
+
+    auto release = [this] (size_t idx) noexcept {
+        auto seg = segment_from_idx(idx);
+        _lsa_free_segments_bitmap.clear(idx);
+        _lsa_owned_segments_bitmap.clear(idx);
+        _store.free_segment(seg);
+        seg->~segment();
+        --_free_segments;
+    };
+
+    for (size_t src_idx = _lsa_owned_segments_bitmap.find_first_set();
+            reclaimed_segments < target && src_idx != utils::dynamic_bitset::npos
+                    && _free_segments > _current_emergency_reserve_goal;
+            src_idx = _lsa_owned_segments_bitmap.find_next_set(src_idx)) {
+        auto hp_idx = _store.hugepage_idx(src_idx);
+        if (!_hugepage_chunks.test(hp_idx)) {
+            // Allocated on its own, before hugepage mode was enabled or when no chunk could be allocated.
+            auto src = segment_from_idx(src_idx);
+            if (!_lsa_free_segments_bitmap.test(src_idx) && !compact_segment(src)) {
+                if (--failed_reclaims_allowance == 0) {
+                    break;
+                }
+                continue;
+            }
+            release(src_idx);
+            ::free(src);
+            ++reclaimed_segments;
+        } else {
+            auto first_idx = _store.first_idx_of_hugepage(hp_idx);
+            auto end_idx = first_idx + segments_per_hugepage;
+            src_idx = end_idx - 1;
+            auto all_free = [&] {
+                for (auto idx = first_idx; idx != end_idx; ++idx) {
+                    if (!_lsa_free_segments_bitmap.test(idx)) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            for (auto idx = first_idx; idx != end_idx; ++idx) {
+                if (!_lsa_free_segments_bitmap.test(idx) && !compact_segment(segment_from_idx(idx))) {
+                    break;
+                }
+            }
+            // Compaction may have moved data into free segments of the same chunk.
+            if (!all_free()) {
+                if (--failed_reclaims_allowance == 0) {
+                    break;
+                }
+                continue;
+            }
+            if (_free_segments < _current_emergency_reserve_goal + segments_per_hugepage) {
+                break;
+            }
+            auto chunk = segment_from_idx(first_idx);
+            for (auto idx = first_idx; idx != end_idx; ++idx) {
+                release(idx);
+            }
+            ::free(chunk);
+            _hugepage_chunks.clear(hp_idx);
+            --_hugepage_chunk_count;
+            reclaimed_segments += segments_per_hugepage;
+        }
+        if (preempt && need_preempt()) {
+            break;
+        }
+    }
+
+    llogger.debug("Reclaimed {} segments (requested {})", reclaimed_segments, target);
+    return reclaimed_segments;
+}
+
+segment* segment_pool::allocate_hugepage_chunk() {
+    memory::disable_abort_on_alloc_failure_temporarily dfg;
+    auto p = aligned_alloc(hugepage_size, hugepage_size);
+    if (!p) {
+        return nullptr;
+    }
+    // Fails harmlessly when the memory is not eligible for transparent huge pages,
+    // e.g. when it is backed by hugetlbfs already.
+    ::madvise(p, hugepage_size, MADV_HUGEPAGE);
+    auto first = static_cast<segment*>(p);
+    for (size_t i = 0; i < segments_per_hugepage; ++i) {
+        auto seg = new (first + i) segment;
+        poison(seg, sizeof(segment));
+        auto idx = _store.new_idx_for_segment(seg);
+        _lsa_owned_segments_bitmap.set(idx);
+        if (i != 0) {
+            _lsa_free_segments_bitmap.set(idx);
+            ++_free_segments;
+        }
+    }
+    _hugepage_chunks.set(_store.hugepage_idx(_store.idx_from_segment(first)));
+    ++_hugepage_chunk_count;
+    return first;
+}
+
+void segment_pool::account_segment_use(segment* seg, bool in_use) noexcept {
+    auto& count = _hugepage_segments_in_use[_store.hugepage_idx(idx_from_segment(seg))];
+    if (in_use) {
+        if (count++ == 0) {
+            ++_hugepages_in_use;
+        }
+    } else {
+        if (--count == 0) {
+            --_hugepages_in_use;
+        }
+    }
+}
+
 segment* segment_pool::allocate_segment(size_t reserve)
 {
     //
@@ -947,6 +1188,11 @@ segment* segment_pool::allocate_segment(size_t reserve)
             --_free_segments;
             return seg;
         }
+        if (_hugepage_mode && _allocation_enabled && _store.can_allocate_more_hugepages()) {
+            if (auto seg = allocate_hugepage_chunk()) {
+                return seg;
+            }
+        }
         if (can_allocate_more_segments()) {
             memory::disable_abort_on_alloc_failure_temporarily dfg;
             auto p = aligned_alloc(segment::size, segment::size);
@@ -977,6 +1223,7 @@ void segment_pool::refill_emergency_reserve() {
             throw std::bad_alloc();
         }
         ++_segments_in_use;
+        account_segment_use(seg, true);
         free_segment(seg);
     }
 }
@@ -1022,6 +1269,7 @@ segment*
 segment_pool::new_segment(region::impl* r) {
     auto seg = allocate_or_fallback_to_reserve();
     ++_segments_in_use;
+    account_segment_use(seg, true);
     segment_descriptor& desc = descriptor(seg);
     desc.set_free_space(segment::size);
     desc.set_kind(segment_kind::regular);
@@ -1038,12 +1286,15 @@ void segment_pool::free_segment(segment* seg, segment_descriptor& desc) noexcept
     desc._region = nullptr;
     deallocate_segment(seg);
     --_segments_in_use;
+    account_segment_use(seg, false);
 }
 
 segment_pool::segment_pool()
     : _segments(max_segments())
     , _lsa_owned_segments_bitmap(max_segments())
     , _lsa_free_segments_bitmap(max_segments())
+    , _hugepage_chunks(_store.max_hugepages())
+    , _hugepage_segments_in_use(_store.max_hugepages())
 {
 }
 
@@ -1901,6 +2152,10 @@ size_t tracker::reclamation_step() const {
     return _impl->reclamation_step();
 }
 
+size_t tracker::compaction_debt(double target_occupancy) const {
+    return _impl->compaction_debt(target_occupancy);
+}
+
 bool tracker::should_abort_on_bad_alloc() {
     return _impl->should_abort_on_bad_alloc();
 }
@@ -1917,6 +2172,10 @@ void tracker::configure(const config& cfg) {
         _impl->enable_abort_on_bad_alloc();
     }
     _impl->setup_background_reclaim(cfg.background_reclaim_sched_group);
+    if (cfg.defragmentation_target_occupancy > 0) {
+        _impl->setup_background_defragmentation(cfg.background_defragmentation_sched_group,
+                cfg.defragmentation_target_occupancy, cfg.defragmentation_cpu_budget);
+    }
     s_sanitizer_report_backtrace = cfg.sanitizer_report_backtrace;
 }
 
@@ -2204,6 +2463,46 @@ class reclaim_timer {
     }
 };
 
+bool tracker::impl::defragment(clock::time_point deadline) {
+    if (!_reclaiming_enabled) {
+        // Nothing can be compacted for now, back off like when there is
+        // nothing left to compact, rather than spinning until the deadline.
+        return false;
+    }
+    reclaiming_lock rl(*this);
+    segment_pool::reservation_goal open_emergency_pool(shard_segment_pool, 0);
+
+    while (true) {
+        region::impl* sparsest = nullptr;
+        for (region::impl* r : _regions) {
+            if (r->is_compactible() && r->compactible_occupancy().used_fraction() < _defragmentation_target_occupancy
+                    && (!sparsest || r->min_occupancy() < sparsest->min_occupancy())) {
+                sparsest = r;
+            }
+        }
+        if (!sparsest) {
+            return false;
+        }
+        sparsest->compact();
+        ++_segments_defragmented;
+        if (need_preempt() || clock::now() >= deadline) {
+            return true;
+        }
+    }
+}
+
+size_t tracker::impl::compaction_debt(double target_occupancy) const {
+    size_t debt = 0;
+    for (region::impl* r : _regions) {
+        auto occ = r->compactible_occupancy();
+        auto needed = size_t(occ.used_space() / target_occupancy);
+        if (occ.total_space() > needed) {
+            debt += occ.total_space() - needed;
+        }
+    }
+    return debt;
+}
+
 idle_cpu_handler_result tracker::impl::compact_on_idle(work_waiting_on_reactor check_for_work) {
     if (!_reclaiming_enabled) {
         return idle_cpu_handler_result::no_more_work;
@@ -2442,6 +2741,20 @@ tracker::impl::impl() {
         sm::make_gauge("occupancy", [this] { return region_occupancy().used_fraction() * 100; },
                        sm::description("Holds a current portion (in percents) of the used memory.")),
 
+        sm::make_gauge("hugepages_in_use", [] { return shard_segment_pool.hugepages_in_use(); },
+                       sm::description("Holds a current number of 2MB pages with LSA segments in use. The more segments share a page, the fewer TLB entries are needed to access LSA memory.")),
+
+        sm::make_gauge("hugepage_chunks", [] { return shard_segment_pool.hugepage_chunks(); },
+                       sm::description("Holds a current number of hugepage-aligned 2MB chunks of segments allocated with lsa_hugepage_segment_chunks.")),
+
+        sm::make_gauge("compaction_debt_bytes", [this] {
+                           return compaction_debt(_defragmentation_target_occupancy ? _defragmentation_target_occupancy : max_used_space_ratio_for_compaction);
+                       },
+                       sm::description("Holds a current amount of memory which compacting all compactible segments to the defragmentation target occupancy would free.")),
+
+        sm::make_derive("segments_defragmented", [this] { return _segments_defragmented; },
+                        sm::description("Counts a number of segments compacted by the background defragmentation.")),
+
         sm::make_derive("segments_compacted", [] { return shard_segment_pool.statistics().segments_compacted; },
                         sm::description("Counts a number of compacted segments.")),
 
@@ -2695,8 +3008,9 @@ void region_group::on_request_expiry::operator()(std::unique_ptr<allocating_func
     func->fail(std::make_exception_ptr(blocked_requests_timed_out_error{_name}));
 }
 
-future<> prime_segment_pool(size_t available_memory, size_t min_free_memory) {
+future<> prime_segment_pool(size_t available_memory, size_t min_free_memory, bool hugepage_chunks) {
     return smp::invoke_on_all([=] {
+        shard_segment_pool.set_hugepage_mode(hugepage_chunks);
         shard_segment_pool.prime(available_memory, min_free_memory);
     });
 }
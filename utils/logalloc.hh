@@ -423,6 +423,12 @@ class tracker {
         bool sanitizer_report_backtrace = false; // Better reports but slower
         size_t lsa_reclamation_step;
         scheduling_group background_reclaim_sched_group;
+        // When positive, segments of regions whose compactible occupancy is below it
+        // are compacted in the background, in background_defragmentation_sched_group,
+        // for at most defragmentation_cpu_budget (a fraction) of the CPU time.
+        double defragmentation_target_occupancy = 0;
+        double defragmentation_cpu_budget = 0.05;
+        scheduling_group background_defragmentation_sched_group;
     };
 
     void configure(const config& cfg);
@@ -465,6 +471,10 @@ class tracker {
     // Returns amount of allocated memory not managed by LSA
     size_t non_lsa_used_space() const;
 
+    // Returns the amount of memory which compacting all compactible segments
+    // up to target_occupancy would free.
+    size_t compaction_debt(double target_occupancy) const;
+
     impl& get_impl() { return *_impl; }
 
     // Returns the minimum number of segments reclaimed during single reclamation cycle.
@@ -821,7 +831,10 @@ class allocating_section {
     }
 };
 
-future<> prime_segment_pool(size_t available_memory, size_t min_free_memory);
+// When hugepage_chunks is set, segments are allocated in chunks aligned to, and
+// the size of, a 2MB transparent huge page, which are returned to the seastar
+// allocator only as a whole, so that LSA memory is spread over fewer TLB entries.
+future<> prime_segment_pool(size_t available_memory, size_t min_free_memory, bool hugepage_chunks = false);
 
 uint64_t memory_allocated();
 uint64_t memory_freed();
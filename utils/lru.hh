@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <array>
 #include <boost/intrusive/list.hpp>
 #include <seastar/core/memory.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 class evictable {
     friend class lru;
@@ -39,42 +41,166 @@ class evictable {
     }
 };
 
+// The kinds of elements which share an LRU, and so the memory of a cache.
+enum class lru_kind : uint8_t {
+    rows,             // row cache entries
+    partition_index,  // parsed partition index pages, see sstables::partition_index_cache
+    file_pages,       // pages of sstable files, see cached_file
+};
+
+// The LRU is segmented. Elements which are not known to be worth keeping,
+// like the ones populated by scans, can be added to the probationary segment,
+// which is evicted from before the main one. Touching an element moves it
+// to the main segment.
+//
+// Each kind of element has its own main segment. The owners of the elements
+// report the memory they occupy and the hits they get, and eviction takes
+// from the kind whose recent hits per byte are the lowest, so that memory
+// goes to the kind of element which avoids the most misses with it.
+// This can be turned off with set_evict_by_hits_per_byte(), and then all
+// kinds share a single main segment, evicted from in plain LRU order.
 class lru {
 private:
     friend class evictable;
     using lru_type = boost::intrusive::list<evictable,
         boost::intrusive::member_hook<evictable, evictable::lru_link_type, &evictable::_lru_link>,
         boost::intrusive::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
-    lru_type _list;
+public:
+    static constexpr size_t kinds = 3;
+
+    struct kind_stats {
+        // Recent hits, halved every hit_decay_period hits of all kinds.
+        uint64_t hits = 0;
+        uint64_t memory_usage = 0;
+        // Only counted when evicting by hits per byte.
+        uint64_t evictions = 0;
+    };
+private:
+    static constexpr uint64_t hit_decay_period = 1 << 16;
+
+    std::array<lru_type, kinds> _lists;
+    lru_type _probationary_list;
+    std::array<kind_stats, kinds> _stats;
+    std::array<seastar::noncopyable_function<uint64_t()>, kinds> _memory_usage_fns;
+    uint64_t _hits_since_decay = 0;
+    bool _evict_by_hits_per_byte = true;
+
+    static size_t index(lru_kind k) noexcept {
+        return static_cast<size_t>(k);
+    }
+
+    // The kind to evict from next, or kinds if there is nothing to evict.
+    size_t victim_kind() const noexcept {
+        size_t victim = kinds;
+        // Compares hits / bytes, with one added to each, so that kinds without
+        // hits yet are evicted from in order of their memory usage.
+        std::array<uint64_t, kinds> usage;
+        for (size_t i = 0; i < kinds; ++i) {
+            usage[i] = memory_usage(i);
+        }
+        auto denser = [&] (size_t a, size_t b) {
+            return (_stats[a].hits + 1) * (usage[b] + 1) > (_stats[b].hits + 1) * (usage[a] + 1);
+        };
+        for (size_t i = 0; i < kinds; ++i) {
+            if (!_lists[i].empty() && (victim == kinds || denser(victim, i))) {
+                victim = i;
+            }
+        }
+        return victim;
+    }
+
+    uint64_t memory_usage(size_t i) const noexcept {
+        return _memory_usage_fns[i] ? _memory_usage_fns[i]() : _stats[i].memory_usage;
+    }
+
+    lru_type& main_list(lru_kind k) noexcept {
+        return _lists[_evict_by_hits_per_byte ? index(k) : 0];
+    }
 public:
     using reclaiming_result = seastar::memory::reclaiming_result;
 
     ~lru() {
-        _list.clear_and_dispose([] (evictable* e) {
+        _probationary_list.clear_and_dispose([] (evictable* e) {
             e->on_evicted();
         });
+        for (auto& list : _lists) {
+            list.clear_and_dispose([] (evictable* e) {
+                e->on_evicted();
+            });
+        }
     }
 
+    // The element can be in either segment.
     void remove(evictable& e) noexcept {
-        _list.erase(_list.iterator_to(e));
+        e._lru_link.unlink();
+    }
+
+    // Must be called while the LRU is empty.
+    void set_evict_by_hits_per_byte(bool enabled) noexcept {
+        _evict_by_hits_per_byte = enabled;
     }
 
-    void add(evictable& e) noexcept {
-        _list.push_back(e);
+    void add(evictable& e, lru_kind k) noexcept {
+        main_list(k).push_back(e);
     }
 
-    void touch(evictable& e) noexcept {
+    void add_probationary(evictable& e) noexcept {
+        _probationary_list.push_back(e);
+    }
+
+    void touch(evictable& e, lru_kind k) noexcept {
         remove(e);
-        add(e);
+        add(e, k);
+    }
+
+    void on_hit(lru_kind k) noexcept {
+        ++_stats[index(k)].hits;
+        if (++_hits_since_decay >= hit_decay_period) {
+            for (auto& s : _stats) {
+                s.hits /= 2;
+            }
+            _hits_since_decay = 0;
+        }
+    }
+
+    void on_memory_usage_change(lru_kind k, int64_t delta) noexcept {
+        _stats[index(k)].memory_usage += delta;
+    }
+
+    // For owners which measure their memory usage as a whole rather than
+    // reporting its changes. The function is called whenever the memory usage
+    // is needed, so that victims are chosen by the current usage.
+    void set_memory_usage_function(lru_kind k, seastar::noncopyable_function<uint64_t()> fn) noexcept {
+        _memory_usage_fns[index(k)] = std::move(fn);
+    }
+
+    kind_stats stats(lru_kind k) const noexcept {
+        auto s = _stats[index(k)];
+        s.memory_usage = memory_usage(index(k));
+        return s;
     }
 
     // Evicts a single element from the LRU
     reclaiming_result evict() noexcept {
-        if (_list.empty()) {
-            return reclaiming_result::reclaimed_nothing;
+        lru_type* list = &_probationary_list;
+        if (!list->empty()) {
+            // Only rows are probationary.
+            ++_stats[index(lru_kind::rows)].evictions;
+        } else if (!_evict_by_hits_per_byte) {
+            list = &_lists[0];
+            if (list->empty()) {
+                return reclaiming_result::reclaimed_nothing;
+            }
+        } else {
+            auto victim = victim_kind();
+            if (victim == kinds) {
+                return reclaiming_result::reclaimed_nothing;
+            }
+            list = &_lists[victim];
+            ++_stats[victim].evictions;
         }
-        evictable& e = _list.front();
-        _list.pop_front();
+        evictable& e = list->front();
+        list->pop_front();
         e.on_evicted();
         return reclaiming_result::reclaimed_something;
     }
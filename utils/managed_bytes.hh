@@ -72,7 +72,12 @@ struct blob_storage {
 
 // A managed version of "bytes" (can be used with LSA).
 class managed_bytes {
-    static constexpr size_t max_inline_size = 15;
+    // Large enough for the live cells of 8 byte types (flags, timestamp and
+    // value: bigint, timestamp, double...) and for keys made of a
+    // single uuid (length and value), the most common ones, to be stored
+    // without an external allocation, which costs them more than twice
+    // their size with the blob_storage header.
+    static constexpr size_t max_inline_size = 23;
     struct small_blob {
         bytes_view::value_type data[max_inline_size];
         int8_t size; // -1 -> use blob_storage
@@ -35,3 +35,32 @@ future<> utils::rate_limiter::reserve(size_t u) {
         return reserve(r);
     });
 }
+
+utils::token_bucket::token_bucket(double rate, double burst)
+        : _rate(rate)
+        , _burst(burst)
+        , _tokens(burst)
+        , _last_refill(clock_type::now()) {
+}
+
+void utils::token_bucket::refill(clock_type::time_point now) {
+    auto elapsed = std::chrono::duration<double>(now - _last_refill).count();
+    _tokens = std::min(_burst, _tokens + elapsed * _rate);
+    _last_refill = now;
+}
+
+void utils::token_bucket::set_rate(double rate, double burst) {
+    refill(clock_type::now());
+    _rate = rate;
+    _burst = burst;
+    _tokens = std::min(_tokens, _burst);
+}
+
+bool utils::token_bucket::try_consume(double units) {
+    refill(clock_type::now());
+    if (_tokens < units) {
+        return false;
+    }
+    _tokens -= units;
+    return true;
+}
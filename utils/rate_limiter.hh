@@ -32,4 +32,26 @@ class rate_limiter {
     future<> reserve(size_t u);
 };
 
+/**
+ * Token bucket: lets through `rate` units per second on average, and bursts
+ * of up to `burst` units after a quiet period. Unlike rate_limiter it never
+ * waits, callers decide what to do with what doesn't fit.
+ */
+class token_bucket {
+public:
+    using clock_type = lowres_clock;
+private:
+    double _rate;
+    double _burst;
+    double _tokens;
+    clock_type::time_point _last_refill;
+
+    void refill(clock_type::time_point now);
+public:
+    token_bucket(double rate, double burst);
+    // Keeps the tokens accumulated so far, up to the new burst.
+    void set_rate(double rate, double burst);
+    bool try_consume(double units = 1);
+};
+
 }
@@ -9,6 +9,7 @@
 #include "rjson.hh"
 #include <seastar/core/print.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/core/iostream.hh>
 #ifdef SANITIZE
@@ -227,65 +228,130 @@ std::string print(const rjson::value& value, size_t max_nested_level) {
     return std::string(buffer.GetString());
 }
 
-future<> print(const rjson::value& value, seastar::output_stream<char>& os, size_t max_nested_level) {
-    struct os_buffer {
-        seastar::output_stream<char>& _os;
-        temporary_buffer<char> _buf;
-        size_t _pos = 0;
-        future<> _f = make_ready_future<>();
+namespace {
 
-        using Ch = char;
+struct os_buffer {
+    seastar::output_stream<char>& _os;
+    temporary_buffer<char> _buf;
+    size_t _pos = 0;
+    future<> _f = make_ready_future<>();
 
-        void send(bool try_reuse = true) {
-            if (_f.failed()) {
-                _f.get0();
-            }
-            if (!_buf.empty() && _pos > 0) {
-                _buf.trim(_pos);
-                _pos = 0;
-                // Note: we're assuming we're writing to a buffered output_stream (hello http server).
-                // If we were not, or if (http) output_stream supported mixed buffered/packed content
-                // it might be a good idea to instead send our buffer as a packet directly. If so, the
-                // buffer size should probably increase (at least after first send()).
-                _f = _f.then([this, buf = std::move(_buf), &os = _os, try_reuse]() mutable -> future<> {
-                    return os.write(buf.get(), buf.size()).then([this, buf = std::move(buf), try_reuse]() mutable {
-                        // Chances are high we just copied this to output_stream buffer, and got here
-                        // immediately. If so, reuse the buffer.
-                        if (try_reuse && _buf.empty() && _pos == 0) {
-                            _buf = std::move(buf);
-                        }
-                    });
+    using Ch = char;
+
+    void send(bool try_reuse = true) {
+        if (_f.failed()) {
+            _f.get0();
+        }
+        if (!_buf.empty() && _pos > 0) {
+            _buf.trim(_pos);
+            _pos = 0;
+            // Note: we're assuming we're writing to a buffered output_stream (hello http server).
+            // If we were not, or if (http) output_stream supported mixed buffered/packed content
+            // it might be a good idea to instead send our buffer as a packet directly. If so, the
+            // buffer size should probably increase (at least after first send()).
+            _f = _f.then([this, buf = std::move(_buf), &os = _os, try_reuse]() mutable -> future<> {
+                return os.write(buf.get(), buf.size()).then([this, buf = std::move(buf), try_reuse]() mutable {
+                    // Chances are high we just copied this to output_stream buffer, and got here
+                    // immediately. If so, reuse the buffer.
+                    if (try_reuse && _buf.empty() && _pos == 0) {
+                        _buf = std::move(buf);
+                    }
                 });
-            }
+            });
         }
-        void Put(char c) {
-            if (_pos == _buf.size()) {
-                send();
-                if (_buf.empty()) {
-                    _buf = temporary_buffer<char>(512);
-                }
+    }
+    void Put(char c) {
+        if (_pos == _buf.size()) {
+            send();
+            if (_buf.empty()) {
+                _buf = temporary_buffer<char>(512);
             }
-            // Second note: Should consider writing directly to the buffer in output_stream
-            // instead of double buffering. But output_stream for a single char has higher
-            // overhead than the above check + once we hit a non-completed future, we'd have
-            // to revert to this method anyway...
-            *(_buf.get_write() + _pos) = c;
-            ++_pos;
         }
-        void Flush() {
-            send();
+        // Second note: Should consider writing directly to the buffer in output_stream
+        // instead of double buffering. But output_stream for a single char has higher
+        // overhead than the above check + once we hit a non-completed future, we'd have
+        // to revert to this method anyway...
+        *(_buf.get_write() + _pos) = c;
+        ++_pos;
+    }
+    void Flush() {
+        send();
+    }
+    // Waits for everything put so far to be written to the output_stream.
+    future<> drain() {
+        send();
+        return std::exchange(_f, make_ready_future<>());
+    }
+    future<> finish()&& {
+        send(false);
+        return std::move(_f);
+    }
+};
+
+using streamer = rapidjson::Writer<os_buffer, encoding, encoding, allocator>;
+
+// print() to an output_stream descends into the objects and arrays of the value
+// down to this depth, and waits for the output_stream after each of their elements.
+// A large value, like the "Items" of a Query response, is then written with
+// back-pressure and preemption points, rather than in a single task which
+// queues all of it in the output_stream.
+constexpr size_t print_streamed_depth = 2;
+
+future<> print_streamed(const rjson::value& value, os_buffer& osb, size_t max_nested_level, size_t depth) {
+    if (depth == print_streamed_depth || !(value.IsObject() || value.IsArray())) {
+        guarded_yieldable_json_handler<streamer, false, os_buffer> writer(osb, max_nested_level - depth);
+        value.Accept(writer);
+        co_return;
+    }
+    if (depth + 1 > max_nested_level) {
+        throw rjson::error(format("Max nested level reached: {}", max_nested_level));
+    }
+    bool first = true;
+    if (value.IsObject()) {
+        osb.Put('{');
+        for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+            if (!std::exchange(first, false)) {
+                osb.Put(',');
+            }
+            streamer name_writer(osb);
+            it->name.Accept(name_writer);
+            osb.Put(':');
+            co_await print_streamed(it->value, osb, max_nested_level, depth + 1);
+            co_await osb.drain();
+            co_await coroutine::maybe_yield();
         }
-        future<> finish()&& {
-            send(false);
-            return std::move(_f);
+        osb.Put('}');
+    } else {
+        osb.Put('[');
+        for (auto it = value.Begin(); it != value.End(); ++it) {
+            if (!std::exchange(first, false)) {
+                osb.Put(',');
+            }
+            co_await print_streamed(*it, osb, max_nested_level, depth + 1);
+            co_await osb.drain();
+            co_await coroutine::maybe_yield();
         }
-    };
+        osb.Put(']');
+    }
+}
 
+}
+
+future<> print(const rjson::value& value, seastar::output_stream<char>& os, size_t max_nested_level) {
     os_buffer osb{ os };
-    using streamer = rapidjson::Writer<os_buffer, encoding, encoding, allocator>;
-    guarded_yieldable_json_handler<streamer, false, os_buffer> writer(osb, max_nested_level);
-    value.Accept(writer);
-    co_return co_await std::move(osb).finish();
+    std::exception_ptr ex;
+    try {
+        co_await print_streamed(value, osb, max_nested_level, 0);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    // Wait for the pending writes even on failure, they refer to osb.
+    auto f = std::move(osb).finish();
+    if (ex) {
+        co_await std::move(f).handle_exception([] (std::exception_ptr) {});
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return co_await std::move(f);
 }
 
 rjson::malformed_value::malformed_value(std::string_view name, const rjson::value& value)
@@ -146,9 +146,10 @@ std::string print(const rjson::value& value, size_t max_nested_level = default_m
 //  and also copy at least 2n bytes (assuming underlying stream is buffered).
 //  This may or may not be more data copying/overhead than creating a string directly
 //  and printing it, but again, it will guarantee fragmented buffer behaviour).
-// Note: input value must remain valid for the call, but is _not_ required to be valid
-// until future resolves - i.e. the full json -> text conversion is done _before_ 
-// pushing fully to stream. I.e. it is valid to do `return print(rjson::value("... something..."), os);`
+// The elements of the top two levels of objects and arrays (e.g., the items of a
+// Query response) are written one by one, waiting for the stream in between, so a
+// large value is written with back-pressure and preemption points.
+// Note: input value must remain valid until the future resolves.
 seastar::future<> print(const rjson::value& value, seastar::output_stream<char>&, size_t max_nested_level = default_max_nested_level);
 
 // Returns a string_view to the string held in a JSON value (which is
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/align.hh>
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/smp.hh>
+
+#include "utils/spill_file.hh"
+
+namespace utils {
+
+// Each record is preceded by its length.
+static constexpr size_t record_header_size = sizeof(uint64_t);
+
+spill_file::spill_file(file f, spill_disk_budget& budget, const io_priority_class& pc)
+    : _file(std::move(f))
+    , _alignment(_file.disk_write_dma_alignment())
+    , _budget(&budget)
+    , _pc(pc)
+{ }
+
+future<spill_file> spill_file::create(const sstring& directory, spill_disk_budget& budget, const io_priority_class& pc) {
+    static thread_local uint64_t next_id = 0;
+    // Files left behind by a previous run, if any, are just overwritten.
+    auto name = format("{}/spill-{}-{}", directory, this_shard_id(), next_id++);
+    auto f = co_await open_file_dma(name, open_flags::rw | open_flags::create | open_flags::truncate);
+    std::exception_ptr ex;
+    try {
+        co_await remove_file(name);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        co_await f.close();
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return spill_file(std::move(f), budget, pc);
+}
+
+future<uint64_t> spill_file::write(const bytes_ostream& data) {
+    const auto pos = _size;
+    const auto size = align_up<uint64_t>(record_header_size + data.size(), _alignment);
+    auto buf = temporary_buffer<char>::aligned(_alignment, size);
+    auto out = buf.get_write();
+    write_le<uint64_t>(out, data.size());
+    out += record_header_size;
+    for (bytes_view frag : data) {
+        out = std::copy(frag.begin(), frag.end(), out);
+    }
+    std::fill(out, buf.get_write() + size, 0);
+    _size += size;
+    if (_size > _allocated) {
+        _budget->consume(_size - _allocated);
+        _allocated = _size;
+    }
+    auto written = co_await _file.dma_write(pos, buf.get(), size, _pc);
+    if (written != size) {
+        throw std::runtime_error(format("Short write to spill file: {} bytes out of {}", written, size));
+    }
+    co_return pos;
+}
+
+future<spill_file::record> spill_file::read(uint64_t pos) {
+    auto header = co_await _file.dma_read_exactly<char>(pos, record_header_size, _pc);
+    const auto size = read_le<uint64_t>(header.get());
+    auto data = co_await _file.dma_read_exactly<char>(pos + record_header_size, size, _pc);
+    co_return record{std::move(data), pos + align_up<uint64_t>(record_header_size + size, _alignment)};
+}
+
+future<> spill_file::close() noexcept {
+    _budget->release(std::exchange(_allocated, 0));
+    return _file.close().handle_exception([] (std::exception_ptr) { });
+}
+
+}
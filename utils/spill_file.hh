@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/io_priority_class.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "bytes_ostream.hh"
+#include "seastarx.hh"
+
+namespace utils {
+
+/// \brief Bounds the disk space taken by a group of spill files
+///
+/// Writers check has_room() before they start spilling; a file already
+/// being written may go over the limit by its last records.
+class spill_disk_budget {
+    uint64_t _max = 0;
+    uint64_t _used = 0;
+public:
+    void set_max(uint64_t max) noexcept {
+        _max = max;
+    }
+
+    bool has_room(uint64_t size) const noexcept {
+        return _used + size <= _max;
+    }
+
+    void consume(uint64_t size) noexcept {
+        _used += size;
+    }
+
+    void release(uint64_t size) noexcept {
+        _used -= size;
+    }
+
+    uint64_t used() const noexcept {
+        return _used;
+    }
+};
+
+/// \brief A scratch file, for reads to page out in-memory state to
+///
+/// Reads which have to build large state in memory (e.g. reversing the
+/// rows of a wide partition) write (spill) parts of it here instead of
+/// exceeding their memory limit, and read them back when they need them.
+///
+/// The file holds a sequence of records, each written in a single write and
+/// read back in a single read, by the position it was written at. The file
+/// is unlinked as soon as it's created, so it is gone when it's closed, or
+/// when the node crashes.
+///
+/// The disk space the file takes, up to its largest size, is accounted in
+/// the budget until it's closed.
+class spill_file {
+    file _file;
+    uint64_t _size = 0;
+    // The largest size, the file takes as much space on disk.
+    uint64_t _allocated = 0;
+    uint64_t _alignment;
+    spill_disk_budget* _budget;
+    io_priority_class _pc;
+private:
+    spill_file(file f, spill_disk_budget& budget, const io_priority_class& pc);
+public:
+    spill_file(spill_file&&) noexcept = default;
+    spill_file& operator=(spill_file&&) noexcept = default;
+
+    static future<spill_file> create(const sstring& directory, spill_disk_budget& budget, const io_priority_class& pc);
+
+    struct record {
+        temporary_buffer<char> data;
+        // The position of the record written after this one.
+        uint64_t next_pos;
+    };
+
+    /// Appends the record, returns the position to read it back from.
+    future<uint64_t> write(const bytes_ostream& data);
+
+    future<record> read(uint64_t pos);
+
+    /// Drops the records written at and after pos, their space is reused
+    /// by the following writes.
+    void truncate(uint64_t pos) noexcept {
+        _size = pos;
+    }
+
+    uint64_t size() const noexcept {
+        return _size;
+    }
+
+    future<> close() noexcept;
+};
+
+}
@@ -17,6 +17,8 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -144,6 +146,43 @@ uint64_t unsigned_vint::deserialize(bytes_view v) {
     return result;
 }
 
+size_t unsigned_vint::deserialize_many(bytes_view v, std::span<uint64_t> out) noexcept {
+    const auto n = out.size();
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < n) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // Small values, which most of the vints of a row are (deltas of timestamps and deletion
+        // times, ttls, column indexes), take one byte. Look at the high bits of eight bytes at once
+        // and decode all the one-byte vints at the front without looking at them one by one.
+        if (v.size() - pos >= sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, v.data() + pos, sizeof(word));
+            const auto high_bits = word & uint64_t(0x8080808080808080);
+            const auto single_bytes = std::min<size_t>(high_bits ? std::countr_zero(high_bits) / 8 : 8, n - i);
+            for (size_t k = 0; k < single_bytes; ++k) {
+                out[i + k] = uint8_t(word >> (8 * k));
+            }
+            i += single_bytes;
+            pos += single_bytes;
+            if (single_bytes) {
+                continue;
+            }
+        }
+#endif
+        if (pos == v.size()) {
+            return 0;
+        }
+        const auto len = serialized_size_from_first_byte(v[pos]);
+        if (v.size() - pos < len) {
+            return 0;
+        }
+        out[i++] = deserialize(v.substr(pos));
+        pos += len;
+    }
+    return pos;
+}
+
 vint_size_type unsigned_vint::serialized_size_from_first_byte(bytes::value_type first_byte) {
     int8_t first_byte_casted = first_byte;
     return 1 + (first_byte_casted >= 0 ? 0 : count_extra_bytes(first_byte_casted));
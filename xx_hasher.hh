@@ -61,3 +61,46 @@ class legacy_xx_hasher_without_null_digest : public xx_hasher {
 public:
     explicit legacy_xx_hasher_without_null_digest(uint64_t seed = 0) noexcept : xx_hasher(seed) {}
 };
+
+// Hashes with XXH3. Its streaming state keeps a buffer of its own, so the
+// many small updates of cells and keys are copied there and hashed a stripe
+// at a time, rather than each being mixed in on its own like XXH64 does.
+//
+// The digest is the 128-bit XXH3 hash; finalize_uint64() returns its low half.
+class xxh3_hasher {
+    static constexpr size_t digest_size = 16;
+    XXH3_state_t _state;
+
+public:
+    explicit xxh3_hasher(uint64_t seed = 0) noexcept {
+        XXH3_128bits_reset_withSeed(&_state, seed);
+    }
+
+    void update(const char* ptr, size_t length) noexcept {
+        XXH3_128bits_update(&_state, ptr, length);
+    }
+
+    bytes finalize() {
+        bytes digest{bytes::initialized_later(), digest_size};
+        serialize_to(digest.begin());
+        return digest;
+    }
+
+    std::array<uint8_t, digest_size> finalize_array() {
+        std::array<uint8_t, digest_size> digest;
+        serialize_to(digest.begin());
+        return digest;
+    }
+
+    uint64_t finalize_uint64() {
+        return XXH3_128bits_digest(&_state).low64;
+    }
+
+private:
+    template<typename OutIterator>
+    void serialize_to(OutIterator&& out) {
+        auto h = XXH3_128bits_digest(&_state);
+        serialize_int64(out, h.high64);
+        serialize_int64(out, h.low64);
+    }
+};
@@ -12,6 +12,10 @@
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#define ZDICT_STATIC_LINKING_ONLY
+#include "zdict.h"
+
+#include <numeric>
 
 #include "compress.hh"
 #include "utils/class_registrator.hh"
@@ -19,8 +23,44 @@
 static const sstring COMPRESSION_LEVEL = "compression_level";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 
+// Digested dictionary. ZSTD_CDict and ZSTD_DDict are read-only once created,
+// so they can be used by many contexts at the same time.
+class zstd_dictionary : public compression_dictionary {
+    struct cdict_deleter {
+        void operator()(ZSTD_CDict* d) const noexcept {
+            ZSTD_freeCDict(d);
+        }
+    };
+    struct ddict_deleter {
+        void operator()(ZSTD_DDict* d) const noexcept {
+            ZSTD_freeDDict(d);
+        }
+    };
+    std::unique_ptr<ZSTD_CDict, cdict_deleter> _cdict;
+    std::unique_ptr<ZSTD_DDict, ddict_deleter> _ddict;
+public:
+    zstd_dictionary(bytes raw, int compression_level)
+        : compression_dictionary(std::move(raw))
+        , _cdict(ZSTD_createCDict(this->raw().data(), this->raw().size(), compression_level))
+        , _ddict(ZSTD_createDDict(this->raw().data(), this->raw().size()))
+    {
+        if (!_cdict || !_ddict) {
+            throw std::runtime_error("Unable to create ZSTD dictionary");
+        }
+    }
+
+    const ZSTD_CDict* cdict() const {
+        return _cdict.get();
+    }
+
+    const ZSTD_DDict* ddict() const {
+        return _ddict.get();
+    }
+};
+
 class zstd_processor : public compressor {
     int _compression_level = 3;
+    size_t _chunk_len;
 
     // Manages memory for the compression context.
     std::unique_ptr<char[], free_deleter> _cctx_raw;
@@ -31,8 +71,13 @@ class zstd_processor : public compressor {
     std::unique_ptr<char[], free_deleter> _dctx_raw;
     // Decompression context. Observer of _dctx_raw.
     ZSTD_DCtx* _dctx;
+
+    std::shared_ptr<const zstd_dictionary> _dict;
+private:
+    void init_contexts();
 public:
     zstd_processor(const opt_getter&);
+    zstd_processor(const zstd_processor&, std::shared_ptr<const zstd_dictionary>);
 
     size_t uncompress(const char* input, size_t input_len, char* output,
                     size_t output_len) const override;
@@ -42,6 +87,10 @@ class zstd_processor : public compressor {
 
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
+
+    bool supports_dictionaries() const override;
+    compression_dictionary_ptr prepare_dictionary(bytes raw) const override;
+    compressor_ptr with_dictionary(compression_dictionary_ptr dict) const override;
 };
 
 zstd_processor::zstd_processor(const opt_getter& opts)
@@ -67,14 +116,31 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
+    init_contexts();
+}
+
+zstd_processor::zstd_processor(const zstd_processor& base, std::shared_ptr<const zstd_dictionary> dict)
+    : compressor(COMPRESSOR_NAME)
+    , _compression_level(base._compression_level)
+    , _chunk_len(base._chunk_len)
+    , _dict(std::move(dict))
+{
+    init_contexts();
+}
+
+void zstd_processor::init_contexts() {
     // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
+    auto cparams = ZSTD_getCParams(_compression_level, _chunk_len, 0);
     auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
+    if (_dict) {
+        // The context has to be large enough for the parameters the dictionary was digested with.
+        cctx_size = std::max(cctx_size, ZSTD_estimateCCtxSize_usingCParams(ZSTD_getCParamsFromCDict(_dict->cdict())));
+    }
     // According to the ZSTD documentation, pointer to the context buffer must be 8-bytes aligned.
     _cctx_raw = allocate_aligned_buffer<char>(cctx_size, 8);
     _cctx = ZSTD_initStaticCCtx(_cctx_raw.get(), cctx_size);
@@ -85,13 +151,15 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     auto dctx_size = ZSTD_estimateDCtxSize();
     _dctx_raw = allocate_aligned_buffer<char>(dctx_size, 8);
     _dctx = ZSTD_initStaticDCtx(_dctx_raw.get(), dctx_size);
-    if (!_cctx) {
+    if (!_dctx) {
         throw std::runtime_error("Unable to initialize ZSTD decompression context");
     }
 }
 
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
+    auto ret = _dict
+        ? ZSTD_decompress_usingDDict(_dctx, output, output_len, input, input_len, _dict->ddict())
+        : ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD decompression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -100,7 +168,9 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
+    auto ret = _dict
+        ? ZSTD_compress_usingCDict(_cctx, output, output_len, input, input_len, _dict->cdict())
+        : ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -119,5 +189,55 @@ std::map<sstring, sstring> zstd_processor::options() const {
     return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
 }
 
+bool zstd_processor::supports_dictionaries() const {
+    return true;
+}
+
+compression_dictionary_ptr zstd_processor::prepare_dictionary(bytes raw) const {
+    return std::make_shared<const zstd_dictionary>(std::move(raw), _compression_level);
+}
+
+compressor_ptr zstd_processor::with_dictionary(compression_dictionary_ptr dict) const {
+    auto d = std::dynamic_pointer_cast<const zstd_dictionary>(std::move(dict));
+    if (!d) {
+        throw std::invalid_argument("ZSTD compressor requires a dictionary prepared by ZSTD");
+    }
+    return ::make_shared<zstd_processor>(*this, std::move(d));
+}
+
+// The zstd trainer produces dictionaries usable by LZ4 as well, which only
+// uses their raw content (the entropy tables at the front are just ignored
+// as unlikely matches).
+bytes compressor::train_dictionary(const std::vector<bytes_view>& samples, size_t max_size) {
+    bytes buffer(bytes::initialized_later(), std::accumulate(samples.begin(), samples.end(), size_t(0), [] (size_t acc, bytes_view s) {
+        return acc + s.size();
+    }));
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    auto out = buffer.begin();
+    for (auto s : samples) {
+        out = std::copy(s.begin(), s.end(), out);
+        sizes.push_back(s.size());
+    }
+    // Training runs on the writer's shard, so use a single fastCover pass with
+    // fixed parameters instead of ZDICT_trainFromBuffer(), which searches for
+    // the best ones and takes over 100ms for a couple of megabytes of samples.
+    // This takes a few milliseconds for 1MB of samples.
+    ZDICT_fastCover_params_t params = {};
+    params.k = 1024;
+    params.d = 8;
+    params.f = 16;
+    params.splitPoint = 1.0;
+    params.accel = 10;
+    bytes dict(bytes::initialized_later(), max_size);
+    auto ret = ZDICT_trainFromBuffer_fastCover(dict.data(), dict.size(), buffer.data(), sizes.data(), sizes.size(), params);
+    if (ZDICT_isError(ret)) {
+        // Typically not enough samples. Compressing without a dictionary is always correct.
+        return bytes();
+    }
+    dict.resize(ret);
+    return dict;
+}
+
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>
     registrator(COMPRESSOR_NAME);